@@ -0,0 +1,214 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/BinaryJson.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace milvus {
+
+namespace {
+
+template <typename T>
+void
+Append(std::vector<char>& out, T value) {
+    auto data = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), data, data + sizeof(T));
+}
+
+template <typename T>
+void
+Write(std::vector<char>& out, size_t pos, T value) {
+    std::memcpy(out.data() + pos, &value, sizeof(T));
+}
+
+void
+EncodeValue(simdjson::dom::element element, std::vector<char>& out) {
+    auto start = out.size();
+    switch (element.type()) {
+        case simdjson::dom::element_type::NULL_VALUE:
+            out.push_back(BinaryJson::Null);
+            break;
+        case simdjson::dom::element_type::BOOL:
+            out.push_back(element.get_bool().value() ? BinaryJson::True
+                                                     : BinaryJson::False);
+            break;
+        case simdjson::dom::element_type::INT64:
+            out.push_back(BinaryJson::Int64);
+            Append(out, element.get_int64().value());
+            break;
+        case simdjson::dom::element_type::UINT64:
+            out.push_back(BinaryJson::Double);
+            Append(out, double(element.get_uint64().value()));
+            break;
+        case simdjson::dom::element_type::DOUBLE:
+            out.push_back(BinaryJson::Double);
+            Append(out, element.get_double().value());
+            break;
+        case simdjson::dom::element_type::STRING: {
+            auto str = element.get_string().value();
+            out.push_back(BinaryJson::String);
+            Append(out, uint32_t(str.size()));
+            out.insert(out.end(), str.begin(), str.end());
+            break;
+        }
+        case simdjson::dom::element_type::ARRAY: {
+            auto array = element.get_array().value();
+            auto count = uint32_t(array.size());
+            out.push_back(BinaryJson::Array);
+            Append(out, count);
+            auto offsets = out.size();
+            out.resize(offsets + count * sizeof(uint32_t));
+            for (auto child : array) {
+                Write(out, offsets, uint32_t(out.size() - start));
+                offsets += sizeof(uint32_t);
+                EncodeValue(child, out);
+            }
+            break;
+        }
+        case simdjson::dom::element_type::OBJECT: {
+            // the first of the duplicated keys is found, as with simdjson
+            std::vector<std::pair<std::string_view, simdjson::dom::element>>
+                members;
+            for (auto field : element.get_object().value()) {
+                members.emplace_back(field.key, field.value);
+            }
+            std::stable_sort(
+                members.begin(), members.end(), [](auto& a, auto& b) {
+                    return a.first < b.first;
+                });
+            auto count = uint32_t(members.size());
+            out.push_back(BinaryJson::Object);
+            Append(out, count);
+            auto entries = out.size();
+            out.resize(entries + count * 3 * sizeof(uint32_t));
+            for (auto& [key, value] : members) {
+                Write(out, entries, uint32_t(out.size() - start));
+                Write(out, entries + sizeof(uint32_t), uint32_t(key.size()));
+                out.insert(out.end(), key.begin(), key.end());
+                Write(out,
+                      entries + 2 * sizeof(uint32_t),
+                      uint32_t(out.size() - start));
+                entries += 3 * sizeof(uint32_t);
+                EncodeValue(value, out);
+            }
+            break;
+        }
+    }
+}
+
+// the key of a pointer token, ~1 is '/' and ~0 is '~'
+std::string_view
+UnescapeToken(std::string_view token, std::string& buffer) {
+    if (token.find('~') == std::string_view::npos) {
+        return token;
+    }
+    buffer.clear();
+    for (size_t i = 0; i < token.size(); ++i) {
+        if (token[i] == '~' && i + 1 < token.size()) {
+            buffer.push_back(token[i + 1] == '1' ? '/' : '~');
+            ++i;
+        } else {
+            buffer.push_back(token[i]);
+        }
+    }
+    return buffer;
+}
+
+}  // namespace
+
+bool
+BinaryJson::Encode(std::string_view json, std::vector<char>& out) {
+    thread_local simdjson::dom::parser parser;
+    auto doc = parser.parse(json.data(), json.size(), false);
+    if (doc.error()) {
+        return false;
+    }
+    EncodeValue(doc.value(), out);
+    return true;
+}
+
+BinaryJson::Value
+BinaryJson::at_pointer(std::string_view pointer) const {
+    const char* value = data_.data();
+    if (pointer.empty()) {
+        return Value(value);
+    }
+    if (pointer[0] != '/') {
+        return simdjson::INVALID_JSON_POINTER;
+    }
+    std::string buffer;
+    size_t pos = 1;
+    while (true) {
+        auto end = std::min(pointer.find('/', pos), pointer.size());
+        auto token = pointer.substr(pos, end - pos);
+        if (*value == Object) {
+            auto count = Read<uint32_t>(value + 1);
+            auto key = UnescapeToken(token, buffer);
+            auto entry_at = [&](uint32_t i) {
+                return value + 1 + sizeof(uint32_t) + i * 3 * sizeof(uint32_t);
+            };
+            auto key_at = [&](uint32_t i) {
+                auto entry = entry_at(i);
+                return std::string_view(
+                    value + Read<uint32_t>(entry),
+                    Read<uint32_t>(entry + sizeof(uint32_t)));
+            };
+            // the first member not before the key
+            uint32_t lo = 0;
+            uint32_t hi = count;
+            while (lo < hi) {
+                auto mid = lo + (hi - lo) / 2;
+                if (key_at(mid) < key) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            if (lo == count || key_at(lo) != key) {
+                return simdjson::NO_SUCH_FIELD;
+            }
+            value += Read<uint32_t>(entry_at(lo) + 2 * sizeof(uint32_t));
+        } else if (*value == Array) {
+            // a decimal index without leading zeros
+            if (token.empty() || token.size() > 9 ||
+                (token.size() > 1 && token[0] == '0')) {
+                return simdjson::INVALID_JSON_POINTER;
+            }
+            uint32_t index = 0;
+            for (auto c : token) {
+                if (c < '0' || c > '9') {
+                    return simdjson::INVALID_JSON_POINTER;
+                }
+                index = index * 10 + (c - '0');
+            }
+            if (index >= Read<uint32_t>(value + 1)) {
+                return simdjson::INDEX_OUT_OF_BOUNDS;
+            }
+            value += Read<uint32_t>(value + 1 + sizeof(uint32_t) +
+                                    index * sizeof(uint32_t));
+        } else {
+            return simdjson::INCORRECT_TYPE;
+        }
+        if (end == pointer.size()) {
+            return Value(value);
+        }
+        pos = end + 1;
+    }
+}
+
+}  // namespace milvus
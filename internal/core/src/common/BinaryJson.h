@@ -0,0 +1,142 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "simdjson.h"
+
+namespace milvus {
+
+// A json document parsed once into values found by a json pointer without
+// tokenizing it again. Every value is a tag byte and its payload:
+//
+//   Null, False, True:  nothing
+//   Int64, Double:      8 bytes
+//   String:             u32 length, the unescaped bytes
+//   Array:              u32 count, u32 offset of every element
+//   Object:             u32 count, {u32 key offset, u32 key length,
+//                       u32 value offset} of every member sorted by key,
+//                       then the keys and the values
+//
+// where the offsets are from the tag of the array or the object. The
+// integers out of the range of int64 are kept as doubles, as simdjson only
+// reads them as doubles too.
+class BinaryJson {
+ public:
+    enum Tag : uint8_t {
+        Null,
+        False,
+        True,
+        Int64,
+        Double,
+        String,
+        Array,
+        Object,
+    };
+
+    // the value at a pointer, or the error of looking it up
+    class Value {
+     public:
+        Value(simdjson::error_code error) : error_(error) {
+        }
+
+        explicit Value(const char* data) : data_(data) {
+        }
+
+        simdjson::error_code
+        error() const {
+            return error_;
+        }
+
+        Tag
+        tag() const {
+            return static_cast<Tag>(*data_);
+        }
+
+        // the same as simdjson reads the value, the integers are read as
+        // doubles too
+        template <typename T>
+        simdjson::simdjson_result<T>
+        get() const {
+            if (error_) {
+                return error_;
+            }
+            auto tag = this->tag();
+            if constexpr (std::is_same_v<T, bool>) {
+                if (tag == False || tag == True) {
+                    return tag == True;
+                }
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                if (tag == Int64) {
+                    return Read<int64_t>(data_ + 1);
+                }
+            } else if constexpr (std::is_same_v<T, double>) {
+                if (tag == Int64) {
+                    return double(Read<int64_t>(data_ + 1));
+                }
+                if (tag == Double) {
+                    return Read<double>(data_ + 1);
+                }
+            } else if constexpr (std::is_same_v<T, std::string_view>) {
+                if (tag == String) {
+                    return std::string_view(data_ + 1 + sizeof(uint32_t),
+                                            Read<uint32_t>(data_ + 1));
+                }
+            } else {
+                static_assert(!sizeof(T), "unsupported type of json value");
+            }
+            return simdjson::INCORRECT_TYPE;
+        }
+
+     private:
+        simdjson::error_code error_ = simdjson::SUCCESS;
+        const char* data_ = nullptr;
+    };
+
+    explicit BinaryJson(std::string_view data) : data_(data) {
+    }
+
+    // Appends the encoding of the json text to `out`, false with `out`
+    // unchanged if it isn't valid. The text must be followed by
+    // SIMDJSON_PADDING bytes.
+    static bool
+    Encode(std::string_view json, std::vector<char>& out);
+
+    // a missing key is NO_SUCH_FIELD and a missing index
+    // INDEX_OUT_OF_BOUNDS, as with simdjson
+    Value
+    at_pointer(std::string_view pointer) const;
+
+    template <typename T>
+    static T
+    Read(const char* data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+ private:
+    std::string_view data_;
+};
+
+}  // namespace milvus
@@ -0,0 +1,89 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fmt/core.h>
+
+#include <boost_ext/dynamic_bitset_ext.hpp>
+#include <cstdint>
+
+#include "common/Types.h"
+#include "exceptions/EasyAssert.h"
+#include "simd/hook.h"
+
+// The operations the query paths apply to whole bitsets, run on their
+// blocks in place by the simd word kernels. dynamic_bitset keeps the bits
+// past its size zero, none of these set them.
+namespace milvus {
+
+static_assert(sizeof(BitsetType::block_type) == sizeof(uint64_t));
+
+namespace bitset_internal {
+
+inline uint64_t*
+Words(BitsetType& bitset) {
+    return reinterpret_cast<uint64_t*>(boost_ext::get_data(bitset));
+}
+
+inline const uint64_t*
+Words(const BitsetType& bitset) {
+    return reinterpret_cast<const uint64_t*>(boost_ext::get_data(bitset));
+}
+
+inline void
+Apply(simd::BitwiseOp op, BitsetType& dst, const BitsetType& src) {
+    AssertInfo(dst.size() == src.size(),
+               fmt::format("bitsets of different sizes, {} and {}",
+                           dst.size(),
+                           src.size()));
+    simd::BitwiseWords(op, Words(dst), Words(src), dst.num_blocks());
+}
+
+}  // namespace bitset_internal
+
+// dst &= src
+inline void
+BitsetAnd(BitsetType& dst, const BitsetType& src) {
+    bitset_internal::Apply(simd::BitwiseOp::AND, dst, src);
+}
+
+// dst |= src
+inline void
+BitsetOr(BitsetType& dst, const BitsetType& src) {
+    bitset_internal::Apply(simd::BitwiseOp::OR, dst, src);
+}
+
+// dst -= src
+inline void
+BitsetAndNot(BitsetType& dst, const BitsetType& src) {
+    bitset_internal::Apply(simd::BitwiseOp::ANDNOT, dst, src);
+}
+
+inline int64_t
+BitsetCount(const BitsetType& bitset) {
+    return simd::PopcountWords(bitset_internal::Words(bitset),
+                               bitset.num_blocks());
+}
+
+// the first bit set at or after `pos`, bitset.size() if there is none
+inline int64_t
+BitsetFindNext(const BitsetType& bitset, int64_t pos) {
+    return simd::FindNextBit(
+        bitset_internal::Words(bitset), bitset.size(), pos);
+}
+
+}  // namespace milvus
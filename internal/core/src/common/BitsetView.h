@@ -19,6 +19,9 @@
 #include <fmt/core.h>
 
 #include <boost_ext/dynamic_bitset_ext.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <deque>
 
 #include "common/Types.h"
@@ -68,4 +71,41 @@ class BitsetView : public knowhere::BitsetView {
     }
 };
 
+// offsets handed to the visitor of ForEachBitBatch at a time
+constexpr int64_t kBitBatchSize = 1024;
+
+// calls visit(offsets, count) with the positions of the first `num_bits`
+// bits of `data` which equal `value`, ascending, in batches of at most
+// kBitBatchSize. The bits are scanned a 64 bit word at a time and ctz finds
+// the next one, so a run of other bits costs a compare per word.
+template <bool value, typename Visit>
+void
+ForEachBitBatch(const uint8_t* data, int64_t num_bits, Visit&& visit) {
+    int64_t offsets[kBitBatchSize];
+    int64_t count = 0;
+    for (int64_t beg = 0; beg < num_bits; beg += 64) {
+        auto bits = std::min<int64_t>(64, num_bits - beg);
+        uint64_t word = 0;
+        // bytes of a view need not be aligned or a whole number of words
+        std::memcpy(&word, data + beg / 8, (bits + 7) / 8);
+        if constexpr (!value) {
+            word = ~word;
+        }
+        if (bits < 64) {
+            word &= (uint64_t(1) << bits) - 1;
+        }
+        while (word != 0) {
+            offsets[count++] = beg + __builtin_ctzll(word);
+            word &= word - 1;
+            if (count == kBitBatchSize) {
+                visit(static_cast<const int64_t*>(offsets), count);
+                count = 0;
+            }
+        }
+    }
+    if (count > 0) {
+        visit(static_cast<const int64_t*>(offsets), count);
+    }
+}
+
 }  // namespace milvus
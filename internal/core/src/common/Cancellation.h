@@ -0,0 +1,113 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "common/type_c.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+// Set by the caller of a search or retrieve to stop it, explicitly or once
+// its deadline passes. The query polls it between its units of work, a
+// chunk, a morsel or a knowhere call, so a cancelled query gives its
+// threads back within one of them.
+class CancellationToken {
+ public:
+    // `deadline_ms` in milliseconds since the unix epoch, 0 for none
+    explicit CancellationToken(int64_t deadline_ms = 0)
+        : deadline_ms_(deadline_ms) {
+    }
+
+    void
+    Cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool
+    IsCancelled() const {
+        if (cancelled_.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return deadline_ms_ > 0 && NowMs() >= deadline_ms_;
+    }
+
+    int64_t
+    deadline_ms() const {
+        return deadline_ms_;
+    }
+
+ private:
+    static int64_t
+    NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+ private:
+    std::atomic<bool> cancelled_{false};
+    const int64_t deadline_ms_;
+};
+
+namespace detail {
+// the token the query running on the thread is polled by, null for none
+inline thread_local const CancellationToken* active_token = nullptr;
+}  // namespace detail
+
+inline const CancellationToken*
+GetActiveCancellation() {
+    return detail::active_token;
+}
+
+// Makes `token` the one CheckCancelled of the calling thread polls while
+// it lives, so a task carries it over to a worker by passing it
+// GetActiveCancellation(). The token must outlive the scope.
+class CancellationScope {
+ public:
+    explicit CancellationScope(const CancellationToken* token)
+        : previous_(detail::active_token) {
+        detail::active_token = token;
+    }
+
+    ~CancellationScope() {
+        detail::active_token = previous_;
+    }
+
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope&
+    operator=(const CancellationScope&) = delete;
+
+ private:
+    const CancellationToken* previous_;
+};
+
+// throws a SegcoreError of QueryCancelled if the active token of the
+// thread is cancelled, costs the test of a thread local without one
+inline void
+CheckCancelled() {
+    auto token = detail::active_token;
+    if (token != nullptr && token->IsCancelled()) {
+        throw SegcoreError(static_cast<ErrorCodeEnum>(QueryCancelled),
+                           "query is cancelled or past its deadline");
+    }
+}
+
+}  // namespace milvus
@@ -13,7 +13,9 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <memory>
 #include <ostream>
 #include <string_view>
 #include <type_traits>
@@ -23,7 +25,9 @@
 
 #include "common/FieldMeta.h"
 #include "common/LoadInfo.h"
+#include "common/Metrics.h"
 #include "common/Span.h"
+#include "common/StringDictionary.h"
 #include "common/Types.h"
 #include "common/Utils.h"
 #include "exceptions/EasyAssert.h"
@@ -33,6 +37,12 @@
 
 namespace milvus::segcore {
 
+// whether CreateMap of `info` maps a file rather than anonymous memory
+inline bool
+MapsFile(const LoadFieldDataInfo& info) {
+    return info.mmap_dir_path != nullptr;
+}
+
 struct Entry {
     char* data;
     uint32_t length;
@@ -52,7 +62,9 @@ class ColumnBase {
     }
 
     ColumnBase(ColumnBase&& column) noexcept
-        : data_(column.data_), size_(column.size_) {
+        : data_(column.data_),
+          size_(column.size_),
+          mapped_file_(column.mapped_file_) {
         column.data_ = nullptr;
         column.size_ = 0;
     }
@@ -70,9 +82,30 @@ class ColumnBase {
     virtual SpanBase
     span() const = 0;
 
+    // bytes of the column in anonymous memory, with the offsets and views
+    // of variable length columns
+    virtual int64_t
+    resident_bytes() const {
+        return mapped_file_ ? 0 : size_;
+    }
+
+    // bytes of the column mapped from a file, the kernel pages them in on
+    // demand and may drop them under memory pressure
+    int64_t
+    file_bytes() const {
+        return mapped_file_ ? size_ : 0;
+    }
+
+    // whether the column is mapped from a file, its rows may be paged out
+    bool
+    mapped_file() const {
+        return mapped_file_;
+    }
+
  protected:
     char* data_{nullptr};
     uint64_t size_{0};
+    bool mapped_file_{false};
 };
 
 class Column : public ColumnBase {
@@ -82,9 +115,22 @@ class Column : public ColumnBase {
            const LoadFieldDataInfo& info) {
         data_ = static_cast<char*>(CreateMap(segment_id, field_meta, info));
         size_ = field_meta.get_sizeof() * info.row_count;
+        mapped_file_ = MapsFile(info);
         row_count_ = info.row_count;
     }
 
+    // adopts a mapping of row_count rows, e.g. of field datas or from
+    // ColumnCache, `mapped_file` if it maps a file
+    Column(const FieldMeta& field_meta,
+           void* map,
+           int64_t row_count,
+           bool mapped_file) {
+        data_ = static_cast<char*>(map);
+        size_ = field_meta.get_sizeof() * row_count;
+        mapped_file_ = mapped_file;
+        row_count_ = row_count;
+    }
+
     Column(Column&& column) noexcept
         : ColumnBase(std::move(column)), row_count_(column.row_count_) {
         column.row_count_ = 0;
@@ -126,18 +172,43 @@ class VariableColumn : public ColumnBase {
         }
 
         data_ = static_cast<char*>(CreateMap(segment_id, field_meta, info));
+        mapped_file_ = MapsFile(info);
+        construct_views();
+    }
+
+    // adopts a mapping of `size` bytes, the rows of which begin at
+    // `indices`, `mapped_file` if it maps a file
+    VariableColumn(void* map,
+                   size_t size,
+                   std::vector<uint64_t> indices,
+                   bool mapped_file)
+        : indices_(std::move(indices)) {
+        data_ = static_cast<char*>(map);
+        size_ = size;
+        mapped_file_ = mapped_file;
         construct_views();
     }
 
     VariableColumn(VariableColumn&& field) noexcept
-        : indices_(std::move(field.indices_)), views_(std::move(field.views_)) {
+        : indices_(std::move(field.indices_)),
+          views_(std::move(field.views_)),
+          dictionary_(std::move(field.dictionary_)),
+          binary_(std::move(field.binary_)) {
         data_ = field.data();
         size_ = field.size();
+        mapped_file_ = field.mapped_file_;
         field.data_ = nullptr;
     }
 
     ~VariableColumn() override = default;
 
+    int64_t
+    resident_bytes() const override {
+        return ColumnBase::resident_bytes() +
+               indices_.capacity() * sizeof(uint64_t) +
+               views_.capacity() * sizeof(ViewType) + binary_.capacity();
+    }
+
     SpanBase
     span() const override {
         return SpanBase(views_.data(), views_.size(), sizeof(ViewType));
@@ -155,11 +226,80 @@ class VariableColumn : public ColumnBase {
 
     std::string_view
     raw_at(const int i) const {
+        if (dictionary_ != nullptr) {
+            return views_[i];
+        }
         size_t len = (i == indices_.size() - 1) ? size_ - indices_.back()
                                                 : indices_[i + 1] - indices_[i];
         return std::string_view(data_ + indices_[i], len);
     }
 
+    // null unless EncodeDictionary succeeded
+    const StringDictionary*
+    dictionary() const {
+        return dictionary_.get();
+    }
+
+    // Replace the raw strings with a dictionary if every distinct value
+    // repeats on average at least kMinRepeats times and there are at most
+    // max_values of them, the views then point into the dictionary.
+    bool
+    EncodeDictionary(int64_t max_values) {
+        static_assert(std::is_same_v<T, std::string>);
+        constexpr int64_t kMinRepeats = 4;
+        int64_t row_count = views_.size();
+        max_values = std::min(max_values, row_count / kMinRepeats);
+        if (max_values <= 0 || dictionary_ != nullptr) {
+            return false;
+        }
+        auto dictionary =
+            StringDictionary::Build(views_.data(), row_count, max_values);
+        if (dictionary == nullptr) {
+            return false;
+        }
+        auto& values = dictionary->values();
+        auto codes = dictionary->codes();
+        for (int64_t i = 0; i < row_count; ++i) {
+            views_[i] = values[codes[i]];
+        }
+        if (data_ != nullptr && munmap(data_, size_)) {
+            LOG_SEGCORE_WARNING_ << "failed to unmap encoded string field, "
+                                 << "err=" << strerror(errno);
+        }
+        data_ = nullptr;
+        size_ = dictionary->memory_size();
+        mapped_file_ = false;
+        indices_.clear();
+        indices_.shrink_to_fit();
+        dictionary_ = std::move(dictionary);
+        return true;
+    }
+
+    // Keep the BinaryJson encoding of every row next to its text, the
+    // views then look the values up in it rather than parsing the text. A
+    // row which isn't valid json is left to be parsed.
+    void
+    EncodeBinaryJson() {
+        static_assert(std::is_same_v<T, Json>);
+        if (!binary_.empty()) {
+            return;
+        }
+        std::vector<size_t> offsets(views_.size() + 1);
+        for (size_t i = 0; i < views_.size(); ++i) {
+            offsets[i] = binary_.size();
+            BinaryJson::Encode(views_[i].data(), binary_);
+        }
+        offsets.back() = binary_.size();
+        binary_.shrink_to_fit();
+        for (size_t i = 0; i < views_.size(); ++i) {
+            auto data = views_[i].data();
+            views_[i] = Json(data.data(),
+                             data.size(),
+                             std::string_view(binary_.data() + offsets[i],
+                                              offsets[i + 1] - offsets[i]));
+        }
+    }
+
  protected:
     void
     construct_views() {
@@ -176,5 +316,10 @@ class VariableColumn : public ColumnBase {
 
     // Compatible with current Span type
     std::vector<ViewType> views_{};
+
+    std::unique_ptr<StringDictionary> dictionary_{};
+
+    // the BinaryJson encoding of the rows, see EncodeBinaryJson
+    std::vector<char> binary_{};
 };
 }  // namespace milvus::segcore
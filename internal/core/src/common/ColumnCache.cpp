@@ -0,0 +1,200 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/ColumnCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include "fmt/core.h"
+#include "log/Log.h"
+
+namespace milvus {
+
+namespace {
+// suffix of the files being written, they are removed at Init
+constexpr std::string_view TEMP_SUFFIX = ".tmp";
+
+uint64_t
+fnv1a(std::string_view data, uint64_t hash) {
+    for (auto c : data) {
+        hash = (hash ^ uint8_t(c)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+}  // namespace
+
+void
+ColumnCache::Init(const std::string& dir, int64_t disk_budget) {
+    std::lock_guard lck(mutex_);
+    dir_ = dir;
+    disk_budget_ = disk_budget;
+    cached_bytes_ = 0;
+    lru_.clear();
+    entries_.clear();
+    if (disk_budget_ <= 0) {
+        return;
+    }
+
+    std::filesystem::create_directories(dir_);
+    std::vector<std::pair<std::filesystem::file_time_type,
+                          std::filesystem::directory_entry>>
+        files;
+    for (auto& entry : std::filesystem::directory_iterator(dir_)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        auto name = entry.path().filename().string();
+        if (std::string_view(name).find(TEMP_SUFFIX) != std::string::npos) {
+            // left by an interrupted write
+            std::filesystem::remove(entry.path());
+            continue;
+        }
+        files.emplace_back(entry.last_write_time(), entry);
+    }
+    // the most recently used file goes to the front
+    std::sort(files.begin(), files.end(), [](auto& a, auto& b) {
+        return a.first < b.first;
+    });
+    for (auto& [_, entry] : files) {
+        auto key = entry.path().filename().string();
+        auto size = entry.file_size();
+        lru_.push_front(key);
+        entries_[key] = Entry{size, lru_.begin()};
+        cached_bytes_ += size;
+    }
+    evict_locked("");
+    LOG_SEGCORE_INFO_ << "column cache at " << dir_ << " adopts "
+                      << entries_.size() << " files of " << cached_bytes_
+                      << " bytes, disk budget " << disk_budget_;
+}
+
+bool
+ColumnCache::Enabled() const {
+    std::lock_guard lck(mutex_);
+    return disk_budget_ > 0;
+}
+
+std::string
+ColumnCache::Key(const std::vector<std::string>& binlog_paths) {
+    // two differently seeded hashes make collisions negligible, the key
+    // must stay the same across runs so std::hash isn't usable
+    uint64_t high = 0xcbf29ce484222325ULL;
+    uint64_t low = 0x84222325cbf29ce4ULL;
+    for (auto& path : binlog_paths) {
+        auto length = std::to_string(path.size()) + ":";
+        high = fnv1a(path, fnv1a(length, high));
+        low = fnv1a(length, fnv1a(path, low));
+    }
+    return fmt::format("{:016x}{:016x}", high, low);
+}
+
+void*
+ColumnCache::Map(const std::string& key, size_t size, bool populate) {
+    std::lock_guard lck(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.size != size || size == 0) {
+        return nullptr;
+    }
+    auto path = dir_ / key;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        // removed by someone else
+        cached_bytes_ -= it->second.size;
+        lru_.erase(it->second.lru_pos);
+        entries_.erase(it);
+        return nullptr;
+    }
+    int mmap_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate) {
+        mmap_flags |= MAP_POPULATE;
+    }
+#endif
+    auto map = mmap(nullptr, size, PROT_READ, mmap_flags, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        LOG_SEGCORE_WARNING_ << "failed to map cached column " << path
+                             << ", err: " << strerror(errno);
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+    // keep the order of use across restarts
+    std::error_code ec;
+    std::filesystem::last_write_time(
+        path, std::filesystem::file_time_type::clock::now(), ec);
+    return map;
+}
+
+std::filesystem::path
+ColumnCache::WritePath(const std::string& key) {
+    std::lock_guard lck(mutex_);
+    return dir_ / fmt::format("{}.{}{}", key, write_seq_++, TEMP_SUFFIX);
+}
+
+void
+ColumnCache::Commit(const std::string& key,
+                    const std::filesystem::path& written_path,
+                    size_t size) {
+    std::lock_guard lck(mutex_);
+    auto path = dir_ / key;
+    if (std::rename(written_path.c_str(), path.c_str()) != 0) {
+        LOG_SEGCORE_WARNING_ << "failed to cache column " << path
+                             << ", err: " << strerror(errno);
+        std::filesystem::remove(written_path);
+        return;
+    }
+    if (auto it = entries_.find(key); it != entries_.end()) {
+        cached_bytes_ -= it->second.size;
+        lru_.erase(it->second.lru_pos);
+        entries_.erase(it);
+    }
+    lru_.push_front(key);
+    entries_[key] = Entry{size, lru_.begin()};
+    cached_bytes_ += size;
+    evict_locked(key);
+}
+
+int64_t
+ColumnCache::CachedBytes() const {
+    std::lock_guard lck(mutex_);
+    return cached_bytes_;
+}
+
+void
+ColumnCache::evict_locked(const std::string& keep) {
+    while (cached_bytes_ > disk_budget_ && !lru_.empty()) {
+        auto victim = lru_.back();
+        if (victim == keep) {
+            break;
+        }
+        std::error_code ec;
+        std::filesystem::remove(dir_ / victim, ec);
+        cached_bytes_ -= entries_.at(victim).size;
+        entries_.erase(victim);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace milvus
@@ -0,0 +1,95 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace milvus {
+
+// Node wide cache of the mmap files of sealed columns.
+// A file is named by a hash of the binlog paths it's built from, so loading
+// a segment again, e.g. after a restart or a rebalance, maps the existing
+// file instead of fetching and writing the binlogs again. The least
+// recently used files are removed once the disk budget is exceeded; a
+// removed file which is still mapped frees its space when it's unmapped.
+class ColumnCache {
+ public:
+    static ColumnCache&
+    GetInstance() {
+        static ColumnCache instance;
+        return instance;
+    }
+
+    // adopts the files left in `dir` by a previous run,
+    // a zero `disk_budget` disables the cache
+    void
+    Init(const std::string& dir, int64_t disk_budget);
+
+    bool
+    Enabled() const;
+
+    static std::string
+    Key(const std::vector<std::string>& binlog_paths);
+
+    // maps the cached file of `key` read only, nullptr if it isn't cached
+    // or its size isn't `size`; the pages are faulted in if `populate`
+    void*
+    Map(const std::string& key, size_t size, bool populate = true);
+
+    // a unique path to write the file of `key` to before Commit
+    std::filesystem::path
+    WritePath(const std::string& key);
+
+    // moves the written file into the cache and evicts the least recently
+    // used files over the budget
+    void
+    Commit(const std::string& key,
+           const std::filesystem::path& written_path,
+           size_t size);
+
+    int64_t
+    CachedBytes() const;
+
+ private:
+    ColumnCache() = default;
+
+    struct Entry {
+        size_t size;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    void
+    evict_locked(const std::string& keep);
+
+    mutable std::mutex mutex_;
+    std::filesystem::path dir_;
+    int64_t disk_budget_ = 0;
+    int64_t cached_bytes_ = 0;
+    uint64_t write_seq_ = 0;
+    // front is the most recently used
+    std::list<std::string> lru_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace milvus
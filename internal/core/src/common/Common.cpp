@@ -22,6 +22,8 @@ namespace milvus {
 int64_t index_file_slice_size = DEFAULT_INDEX_FILE_SLICE_SIZE;
 int64_t thread_core_coefficient = DEFAULT_THREAD_CORE_COEFFICIENT;
 int cpu_num = DEFAULT_CPU_NUM;
+int64_t index_build_parallelism = DEFAULT_INDEX_BUILD_PARALLELISM;
+int64_t reverse_lookup_cache_factor = DEFAULT_REVERSE_LOOKUP_CACHE_FACTOR;
 
 void
 SetIndexSliceSize(const int64_t size) {
@@ -42,4 +44,23 @@ SetCpuNum(const int num) {
     cpu_num = num;
 }
 
+void
+SetIndexBuildParallelism(const int64_t parallelism) {
+    index_build_parallelism = parallelism;
+    LOG_SEGCORE_DEBUG_ << "set index build parallelism: "
+                       << index_build_parallelism;
+}
+
+int64_t
+GetIndexBuildParallelism() {
+    return index_build_parallelism > 0 ? index_build_parallelism : cpu_num;
+}
+
+void
+SetReverseLookupCacheFactor(const int64_t factor) {
+    reverse_lookup_cache_factor = factor;
+    LOG_SEGCORE_DEBUG_ << "set reverse lookup cache factor: "
+                       << reverse_lookup_cache_factor;
+}
+
 }  // namespace milvus
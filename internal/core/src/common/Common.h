@@ -24,6 +24,8 @@ namespace milvus {
 extern int64_t index_file_slice_size;
 extern int64_t thread_core_coefficient;
 extern int cpu_num;
+extern int64_t index_build_parallelism;
+extern int64_t reverse_lookup_cache_factor;
 
 void
 SetIndexSliceSize(const int64_t size);
@@ -34,4 +36,14 @@ SetThreadCoreCoefficient(const int64_t coefficient);
 void
 SetCpuNum(const int core);
 
+void
+SetIndexBuildParallelism(const int64_t parallelism);
+
+// tasks a scalar index build is split into at most
+int64_t
+GetIndexBuildParallelism();
+
+void
+SetReverseLookupCacheFactor(const int64_t factor);
+
 }  // namespace milvus
@@ -27,6 +27,8 @@ const milvus::PkType INVALID_PK;  // of std::monostate if not set.
 // TODO: default field start id, could get from config.yaml
 const int64_t START_USER_FIELDID = 100;
 const char MAX_LENGTH[] = "max_length";
+// comma separated json pointers of a json field to extract at load time
+const char JSON_KEY_PATHS[] = "json_key_paths";
 
 // const fieldID (rowID and timestamp)
 const milvus::FieldId RowFieldID = milvus::FieldId(0);
@@ -35,16 +37,90 @@ const milvus::FieldId TimestampFieldID = milvus::FieldId(1);
 // fill followed extra info to binlog file
 const char ORIGIN_SIZE_KEY[] = "original_size";
 const char INDEX_BUILD_ID_KEY[] = "indexBuildID";
+// crc32c of the payload of the data event, verified on decode if present
+const char PAYLOAD_CHECKSUM_KEY[] = "payload_crc32c";
+// read by the index file codec of the go side
+const char INDEX_VERSION_KEY[] = "version";
+const char INDEX_ID_KEY[] = "indexID";
+const char INDEX_NAME_KEY[] = "indexName";
+const char INDEX_FILE_KEY[] = "key";
 
 const char INDEX_ROOT_PATH[] = "index_files";
+// records the remote slices of the index files cached in a local index dir
+const char INDEX_CACHE_MANIFEST[] = "index_cache_manifest.json";
 const char RAWDATA_ROOT_PATH[] = "raw_datas";
 
 const int64_t DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT = 67108864;  // bytes
 const int64_t DEFAULT_THREAD_CORE_COEFFICIENT = 50;
+// workers of the pool running requests to the object storage
+const int64_t DEFAULT_REMOTE_IO_THREAD_CORE_COEFFICIENT = 2;
+// open local files LocalChunkManager keeps for positional reads and writes
+const int64_t DEFAULT_LOCAL_FILE_HANDLE_CACHE_SIZE = 64;
 
 const int64_t DEFAULT_INDEX_FILE_SLICE_SIZE = 4;  // megabytes
 
+// remote objects larger than two ranges are read by concurrent ranged GETs
+const uint64_t DEFAULT_REMOTE_READ_RANGE_SIZE = 8 << 20;  // bytes
+const int64_t DEFAULT_REMOTE_READ_MAX_INFLIGHT = 8;
+// ranged binlog reads fetch this many head bytes to parse the event headers
+const int64_t REMOTE_BINLOG_HEAD_PREFETCH_SIZE = 4096;  // bytes
+
 const int DEFAULT_CPU_NUM = 1;
 
+// scalar index builds split into tasks of at least this many rows, over at
+// most the configured build parallelism (0 for the cpu number)
+const int64_t MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK = 65536;
+const int64_t DEFAULT_INDEX_BUILD_PARALLELISM = 0;
+
+// a scalar index decodes all its rows once the batched reverse lookups of
+// output fields read this many times its rows, 0 never decodes them
+const int64_t DEFAULT_REVERSE_LOOKUP_CACHE_FACTOR = 4;
+
+// the node wide DiskANN cache budget is apportioned again from the searches
+// of the indexes at most this often
+const int64_t DEFAULT_DISKANN_CACHE_REBALANCE_INTERVAL_MS = 60000;
+
+// search results of fewer nq are reduced in a single thread
+const int64_t MIN_REDUCE_NQ_PER_TASK = 64;
+// output fields of search results are filled in parallel, over fields and
+// segments, in tasks gathering at least this many bytes
+const int64_t MIN_FILL_TARGET_ENTRY_BYTES_PER_TASK = 256 << 10;
+
+// half float vectors are decoded this many rows at a time for brute force
+const int64_t FP16_DECODE_BLOCK_ROWS = 1024;
+
+// payload values are decoded in place this many rows at a time
+const int64_t PAYLOAD_DECODE_BATCH_ROWS = 65536;
+
+// rows a streaming index build trains on unless the index params say so
+const int64_t DEFAULT_STREAM_BUILD_TRAIN_ROWS = 100000;
+// binlogs an index build downloads ahead of the one being appended
+const int64_t DEFAULT_INDEX_BUILD_BINLOG_INFLIGHT = 4;
+// index files a load downloads and decodes ahead of the one being appended,
+// most are slices of a few megabytes
+const int64_t DEFAULT_INDEX_LOAD_FILE_INFLIGHT = 16;
+
+// scalar fields of at most this many distinct values get a bitmap index
+// unless the index params say otherwise, a bitmap index holds at most the max
+const int64_t DEFAULT_BITMAP_INDEX_CARDINALITY_LIMIT = 64;
+const int64_t BITMAP_INDEX_MAX_CARDINALITY = 256;
+
+// search params to keep at most group_size hits per value of a scalar field
+const char GROUP_BY_FIELD[] = "group_by_field";
+const char GROUP_SIZE[] = "group_size";
+
+// search param to return the execution profile of the query with its results
+const char PROFILE[] = "profile";
+
+// search param to fetch refine_factor x topk hits from a quantized index and
+// rerank them by their exact distances to the raw vectors
+const char REFINE_FACTOR[] = "refine_factor";
+
+// search params leaving the params of an index search to segcore, picked for
+// a recall tier of "low", "medium" or "high" within an optional latency
+// budget in milliseconds per segment
+const char ADAPTIVE_RECALL[] = "adaptive_recall";
+const char LATENCY_BUDGET_MS[] = "latency_budget_ms";
+
 constexpr const char* RADIUS = knowhere::meta::RADIUS;
 constexpr const char* RANGE_FILTER = knowhere::meta::RANGE_FILTER;
@@ -0,0 +1,74 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/CpuGroup.h"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace milvus {
+
+namespace {
+
+struct CpuGroups {
+    std::shared_mutex mutex;
+    std::unordered_map<int64_t, std::unique_ptr<CpuGroup>> groups;
+};
+
+CpuGroups&
+Groups() {
+    static CpuGroups groups;
+    return groups;
+}
+
+}  // namespace
+
+CpuGroup*
+GetCpuGroup(int64_t id) {
+    if (id < 0) {
+        return nullptr;
+    }
+    auto& groups = Groups();
+    {
+        std::shared_lock lck(groups.mutex);
+        auto it = groups.groups.find(id);
+        if (it != groups.groups.end()) {
+            return it->second.get();
+        }
+    }
+    std::unique_lock lck(groups.mutex);
+    auto& group = groups.groups[id];
+    if (group == nullptr) {
+        group = std::make_unique<CpuGroup>(id);
+    }
+    return group.get();
+}
+
+std::vector<const CpuGroup*>
+ListCpuGroups() {
+    auto& groups = Groups();
+    std::shared_lock lck(groups.mutex);
+    std::vector<const CpuGroup*> list;
+    list.reserve(groups.groups.size());
+    for (auto& [id, group] : groups.groups) {
+        list.push_back(group.get());
+    }
+    return list;
+}
+
+}  // namespace milvus
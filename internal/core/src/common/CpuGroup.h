@@ -0,0 +1,160 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include "common/Metrics.h"
+
+namespace milvus {
+
+// The work of a collection or a resource group, set by the caller of a
+// search, a retrieve or a reduce. The workers of the thread pool take the
+// queued tasks of the groups in proportion to their weights, and the cpu
+// time of every thread running for a group is charged to it.
+class CpuGroup {
+ public:
+    static constexpr uint32_t DEFAULT_WEIGHT = 1;
+
+    explicit CpuGroup(int64_t id) : id_(id) {
+    }
+
+    int64_t
+    id() const {
+        return id_;
+    }
+
+    uint32_t
+    weight() const {
+        return weight_.load(std::memory_order_relaxed);
+    }
+
+    // a zero weight is taken as 1
+    void
+    set_weight(uint32_t weight) {
+        weight_.store(std::max<uint32_t>(weight, 1),
+                      std::memory_order_relaxed);
+    }
+
+    // the cpu time of the threads while they ran for the group
+    int64_t
+    cpu_nanos() const {
+        return cpu_nanos_.Value();
+    }
+
+    // the tasks of the group the thread pool ran and the time they waited
+    // in its queue
+    int64_t
+    tasks() const {
+        return tasks_.Value();
+    }
+
+    int64_t
+    wait_nanos() const {
+        return wait_nanos_.Value();
+    }
+
+    void
+    AddCpuNanos(int64_t nanos) {
+        cpu_nanos_.Add(nanos);
+    }
+
+    void
+    AddTask(int64_t wait_nanos) {
+        tasks_.Add(1);
+        wait_nanos_.Add(wait_nanos);
+    }
+
+ private:
+    const int64_t id_;
+    std::atomic<uint32_t> weight_{DEFAULT_WEIGHT};
+    monitor::ShardedValue cpu_nanos_;
+    monitor::ShardedValue tasks_;
+    monitor::ShardedValue wait_nanos_;
+};
+
+// the group of `id`, created with the default weight on the first use and
+// kept for the life of the process, null for a negative id
+CpuGroup*
+GetCpuGroup(int64_t id);
+
+// every group used so far
+std::vector<const CpuGroup*>
+ListCpuGroups();
+
+inline int64_t
+ThreadCpuNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+namespace detail {
+// the group the thread runs for, null for none, and the thread cpu time
+// it was last charged at
+inline thread_local CpuGroup* active_group = nullptr;
+inline thread_local int64_t active_group_since = 0;
+}  // namespace detail
+
+inline CpuGroup*
+GetActiveCpuGroup() {
+    return detail::active_group;
+}
+
+// Makes the calling thread run for `group` while it lives. The cpu time of
+// the thread is charged to the group it runs for whenever that changes, so
+// a nested scope charges its time to its own group only. The tasks the
+// thread submits to the thread pool meanwhile are queued for the group.
+class CpuGroupScope {
+ public:
+    explicit CpuGroupScope(CpuGroup* group)
+        : previous_(detail::active_group) {
+        Switch(group);
+    }
+
+    ~CpuGroupScope() {
+        Switch(previous_);
+    }
+
+    CpuGroupScope(const CpuGroupScope&) = delete;
+    CpuGroupScope&
+    operator=(const CpuGroupScope&) = delete;
+
+ private:
+    static void
+    Switch(CpuGroup* group) {
+        if (group == nullptr && detail::active_group == nullptr) {
+            return;
+        }
+        auto now = ThreadCpuNanos();
+        if (detail::active_group != nullptr) {
+            detail::active_group->AddCpuNanos(now -
+                                              detail::active_group_since);
+        }
+        detail::active_group = group;
+        detail::active_group_since = now;
+    }
+
+ private:
+    CpuGroup* previous_;
+};
+
+}  // namespace milvus
@@ -0,0 +1,118 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace milvus {
+
+// Parks the threads waiting for a condition another thread makes true,
+// e.g. an idle worker waiting for a task, on a futex where there is one.
+// The waiter takes a key with PrepareWait, checks its condition once more
+// and either cancels or waits on the key; the notifier makes the condition
+// true first and then notifies. Either the waiter sees the condition or the
+// notifier sees the waiter and bumps the epoch, so no wakeup is lost, and
+// a notify with no one waiting is a single load.
+class EventCount {
+ public:
+    uint32_t
+    PrepareWait() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_seq_cst);
+    }
+
+    void
+    CancelWait() {
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    // returns once notified after PrepareWait gave `key`
+    void
+    Wait(uint32_t key) {
+#ifdef __linux__
+        while (epoch_.load(std::memory_order_acquire) == key) {
+            syscall(SYS_futex,
+                    reinterpret_cast<uint32_t*>(&epoch_),
+                    FUTEX_WAIT_PRIVATE,
+                    key,
+                    nullptr,
+                    nullptr,
+                    0);
+        }
+#else
+        std::unique_lock lck(mutex_);
+        cond_.wait(lck, [&]() {
+            return epoch_.load(std::memory_order_acquire) != key;
+        });
+#endif
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void
+    NotifyOne() {
+        Notify(1);
+    }
+
+    void
+    NotifyAll() {
+        Notify(INT_MAX);
+    }
+
+ private:
+    void
+    Notify(int count) {
+        if (waiters_.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+#ifdef __linux__
+        epoch_.fetch_add(1, std::memory_order_acq_rel);
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t*>(&epoch_),
+                FUTEX_WAKE_PRIVATE,
+                count,
+                nullptr,
+                nullptr,
+                0);
+#else
+        {
+            std::lock_guard lck(mutex_);
+            epoch_.fetch_add(1, std::memory_order_acq_rel);
+        }
+        if (count == 1) {
+            cond_.notify_one();
+        } else {
+            cond_.notify_all();
+        }
+#endif
+    }
+
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<int32_t> waiters_{0};
+#ifndef __linux__
+    std::mutex mutex_;
+    std::condition_variable cond_;
+#endif
+};
+
+}  // namespace milvus
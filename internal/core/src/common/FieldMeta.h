@@ -19,6 +19,8 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/Types.h"
 #include "exceptions/EasyAssert.h"
@@ -183,6 +185,17 @@ class FieldMeta {
         Assert(datatype_is_string(type_));
     }
 
+    FieldMeta(const FieldName& name,
+              FieldId id,
+              DataType type,
+              std::vector<std::string> json_key_paths)
+        : name_(name),
+          id_(id),
+          type_(type),
+          json_key_paths_(std::move(json_key_paths)) {
+        Assert(type_ == DataType::JSON);
+    }
+
     FieldMeta(const FieldName& name,
               FieldId id,
               DataType type,
@@ -209,6 +222,13 @@ class FieldMeta {
         return string_info_->max_length;
     }
 
+    // json pointers whose values are extracted into typed columns when the
+    // field is loaded into a sealed segment
+    const std::vector<std::string>&
+    get_json_key_paths() const {
+        return json_key_paths_;
+    }
+
     std::optional<knowhere::MetricType>
     get_metric_type() const {
         Assert(datatype_is_vector(type_));
@@ -269,6 +289,7 @@ class FieldMeta {
     DataType type_ = DataType::NONE;
     std::optional<VectorInfo> vector_info_;
     std::optional<StringInfo> string_info_;
+    std::vector<std::string> json_key_paths_;
 };
 
 }  // namespace milvus
@@ -0,0 +1,309 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/FieldSketch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+namespace {
+
+// the kept values shrink by this factor a level below the top
+constexpr double kLevelDecay = 2.0 / 3;
+// most levels a sketch of 2^64 values takes
+constexpr int64_t kMaxLevels = 64;
+
+void
+Append(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+template <typename T>
+void
+AppendValue(std::string& out, const T& value) {
+    Append(out, &value, sizeof(value));
+}
+
+void
+Read(const uint8_t*& data, int64_t& size, void* dst, int64_t length) {
+    AssertInfo(length >= 0 && length <= size, "truncated field sketch");
+    std::memcpy(dst, data, length);
+    data += length;
+    size -= length;
+}
+
+template <typename T>
+T
+ReadValue(const uint8_t*& data, int64_t& size) {
+    T value;
+    Read(data, size, &value, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+void
+HyperLogLog::Merge(const HyperLogLog& other) {
+    for (int64_t i = 0; i < kRegisters; ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+double
+HyperLogLog::Estimate() const {
+    constexpr double m = kRegisters;
+    constexpr double alpha = 0.7213 / (1 + 1.079 / m);
+    double sum = 0;
+    int64_t zeros = 0;
+    for (auto rank : registers_) {
+        sum += std::ldexp(1.0, -int(rank));
+        zeros += rank == 0;
+    }
+    auto estimate = alpha * m * m / sum;
+    // linear counting is exact enough for a few values
+    if (estimate <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / zeros);
+    }
+    return estimate;
+}
+
+int64_t
+QuantileSketch::capacity(size_t level) const {
+    auto depth = int64_t(levels_.size()) - 1 - int64_t(level);
+    auto capacity = std::ceil(kK * std::pow(kLevelDecay, depth));
+    return std::max<int64_t>(int64_t(capacity), 2);
+}
+
+void
+QuantileSketch::update_capacity() {
+    capacity_ = 0;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        capacity_ += capacity(level);
+    }
+}
+
+void
+QuantileSketch::Compress() {
+    while (retained_ > capacity_) {
+        size_t level = 0;
+        while (int64_t(levels_[level].size()) < capacity(level)) {
+            ++level;
+        }
+        if (level + 1 == levels_.size()) {
+            AssertInfo(int64_t(levels_.size()) < kMaxLevels,
+                       "too many levels in quantile sketch");
+            levels_.emplace_back();
+            update_capacity();
+        }
+        auto& values = levels_[level];
+        std::sort(values.begin(), values.end());
+        // an odd one out stays at its level
+        std::optional<double> kept;
+        if (values.size() % 2 == 1) {
+            kept = values.back();
+            values.pop_back();
+        }
+        auto& next = levels_[level + 1];
+        for (size_t i = compactions_++ % 2; i < values.size(); i += 2) {
+            next.push_back(values[i]);
+        }
+        retained_ -= values.size() / 2;
+        values.clear();
+        if (kept.has_value()) {
+            values.push_back(kept.value());
+        }
+    }
+}
+
+void
+QuantileSketch::Merge(const QuantileSketch& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0 || other.min_ < min_) {
+        min_ = other.min_;
+    }
+    if (count_ == 0 || other.max_ > max_) {
+        max_ = other.max_;
+    }
+    if (levels_.size() < other.levels_.size()) {
+        levels_.resize(other.levels_.size());
+        update_capacity();
+    }
+    for (size_t level = 0; level < other.levels_.size(); ++level) {
+        auto& values = other.levels_[level];
+        levels_[level].insert(
+            levels_[level].end(), values.begin(), values.end());
+    }
+    count_ += other.count_;
+    retained_ += other.retained_;
+    Compress();
+}
+
+double
+QuantileSketch::Rank(double value, bool inclusive) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    double weight = 0;
+    double total = 0;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        auto level_weight = std::ldexp(1.0, int(level));
+        for (auto v : levels_[level]) {
+            if (v < value || (inclusive && v == value)) {
+                weight += level_weight;
+            }
+        }
+        total += level_weight * levels_[level].size();
+    }
+    return weight / total;
+}
+
+double
+QuantileSketch::Quantile(double q) const {
+    AssertInfo(count_ > 0, "quantile of an empty sketch");
+    q = std::clamp(q, 0.0, 1.0);
+    if (q == 0) {
+        return min_;
+    }
+    if (q == 1) {
+        return max_;
+    }
+    std::vector<std::pair<double, double>> weighted;
+    weighted.reserve(retained_);
+    double total = 0;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        auto level_weight = std::ldexp(1.0, int(level));
+        for (auto v : levels_[level]) {
+            weighted.emplace_back(v, level_weight);
+        }
+        total += level_weight * levels_[level].size();
+    }
+    std::sort(weighted.begin(), weighted.end());
+    double weight = 0;
+    for (auto& [v, w] : weighted) {
+        weight += w;
+        if (weight >= q * total) {
+            return v;
+        }
+    }
+    return max_;
+}
+
+void
+QuantileSketch::Serialize(std::string& out) const {
+    AppendValue(out, count_);
+    AppendValue(out, min_);
+    AppendValue(out, max_);
+    AppendValue(out, int64_t(levels_.size()));
+    for (auto& values : levels_) {
+        AppendValue(out, int64_t(values.size()));
+        Append(out, values.data(), values.size() * sizeof(double));
+    }
+}
+
+QuantileSketch
+QuantileSketch::Deserialize(const uint8_t*& data, int64_t& size) {
+    QuantileSketch sketch;
+    sketch.count_ = ReadValue<int64_t>(data, size);
+    sketch.min_ = ReadValue<double>(data, size);
+    sketch.max_ = ReadValue<double>(data, size);
+    auto num_levels = ReadValue<int64_t>(data, size);
+    AssertInfo(sketch.count_ >= 0 && num_levels >= 0 &&
+                   num_levels <= kMaxLevels,
+               "invalid quantile sketch");
+    sketch.levels_.resize(num_levels);
+    for (auto& values : sketch.levels_) {
+        auto num_values = ReadValue<int64_t>(data, size);
+        AssertInfo(
+            num_values >= 0 && num_values <= size / int64_t(sizeof(double)),
+            "invalid quantile sketch");
+        values.resize(num_values);
+        Read(data, size, values.data(), num_values * sizeof(double));
+        sketch.retained_ += num_values;
+    }
+    sketch.update_capacity();
+    return sketch;
+}
+
+void
+FieldSketch::Merge(const FieldSketch& other) {
+    AssertInfo(quantiles_.has_value() == other.quantiles_.has_value(),
+               "can't merge the sketches of a numeric and a string field");
+    row_count_ += other.row_count_;
+    distinct_.Merge(other.distinct_);
+    if (quantiles_.has_value()) {
+        quantiles_->Merge(other.quantiles_.value());
+    }
+}
+
+int64_t
+FieldSketch::distinct_count() const {
+    if (row_count_ == 0) {
+        return 0;
+    }
+    auto estimate = int64_t(std::llround(distinct_.Estimate()));
+    return std::clamp<int64_t>(estimate, 1, row_count_);
+}
+
+std::string
+FieldSketch::Serialize() const {
+    std::string out;
+    AppendValue(out, kVersion);
+    AppendValue(out, int32_t(HyperLogLog::kPrecision));
+    AppendValue(out, row_count_);
+    Append(out, distinct_.registers().data(), HyperLogLog::kRegisters);
+    AppendValue(out, uint8_t(quantiles_.has_value()));
+    if (quantiles_.has_value()) {
+        AppendValue(out, QuantileSketch::kK);
+        quantiles_->Serialize(out);
+    }
+    return out;
+}
+
+FieldSketch
+FieldSketch::Deserialize(const void* data, int64_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    auto version = ReadValue<int32_t>(bytes, size);
+    AssertInfo(version == kVersion,
+               "unsupported field sketch version " + std::to_string(version));
+    auto precision = ReadValue<int32_t>(bytes, size);
+    AssertInfo(precision == HyperLogLog::kPrecision,
+               "unsupported hyperloglog precision " +
+                   std::to_string(precision));
+    FieldSketch sketch;
+    sketch.row_count_ = ReadValue<int64_t>(bytes, size);
+    AssertInfo(sketch.row_count_ >= 0, "invalid field sketch");
+    Read(bytes,
+         size,
+         sketch.distinct_.mutable_registers().data(),
+         HyperLogLog::kRegisters);
+    if (ReadValue<uint8_t>(bytes, size) != 0) {
+        auto k = ReadValue<int64_t>(bytes, size);
+        AssertInfo(k == QuantileSketch::kK,
+                   "unsupported quantile sketch k " + std::to_string(k));
+        sketch.quantiles_ = QuantileSketch::Deserialize(bytes, size);
+    }
+    AssertInfo(size == 0, "trailing bytes after field sketch");
+    return sketch;
+}
+
+}  // namespace milvus
@@ -0,0 +1,264 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace milvus {
+
+// HyperLogLog of the hashes of the values of a field, estimates their
+// distinct count within about 1.6%; merged by the max of every register,
+// so the sketches of several segments give the count of their union.
+class HyperLogLog {
+ public:
+    static constexpr int kPrecision = 12;
+    static constexpr int64_t kRegisters = int64_t(1) << kPrecision;
+
+    HyperLogLog() : registers_(kRegisters, 0) {
+    }
+
+    void
+    Add(uint64_t hash) {
+        auto index = hash >> (64 - kPrecision);
+        auto rest = hash << kPrecision;
+        // position of the first set bit, past the end if none is
+        uint8_t rank = rest == 0 ? 64 - kPrecision + 1
+                                 : __builtin_clzll(rest) + 1;
+        if (rank > registers_[index]) {
+            registers_[index] = rank;
+        }
+    }
+
+    void
+    Merge(const HyperLogLog& other);
+
+    double
+    Estimate() const;
+
+    const std::vector<uint8_t>&
+    registers() const {
+        return registers_;
+    }
+
+    std::vector<uint8_t>&
+    mutable_registers() {
+        return registers_;
+    }
+
+ private:
+    std::vector<uint8_t> registers_;
+};
+
+// KLL sketch of numeric values, answers the rank of a value and the value
+// of a quantile within about 1.5% of the count. The values are kept in
+// levels, the ones of level h weigh 2^h; a full level is sorted and every
+// other value of it is promoted, so a merge appends the levels of the other
+// sketch and compacts them the same way.
+class QuantileSketch {
+ public:
+    static constexpr int64_t kK = 200;
+
+    void
+    Add(double value) {
+        if (std::isnan(value)) {
+            return;
+        }
+        if (count_ == 0 || value < min_) {
+            min_ = value;
+        }
+        if (count_ == 0 || value > max_) {
+            max_ = value;
+        }
+        if (levels_.empty()) {
+            levels_.emplace_back();
+            update_capacity();
+        }
+        levels_[0].push_back(value);
+        ++count_;
+        if (++retained_ > capacity_) {
+            Compress();
+        }
+    }
+
+    void
+    Merge(const QuantileSketch& other);
+
+    // fraction of the values below `value`, or at most it if inclusive
+    double
+    Rank(double value, bool inclusive) const;
+
+    // the value of quantile `q` in [0, 1]
+    double
+    Quantile(double q) const;
+
+    int64_t
+    count() const {
+        return count_;
+    }
+
+    double
+    min() const {
+        return min_;
+    }
+
+    double
+    max() const {
+        return max_;
+    }
+
+    int64_t
+    retained() const {
+        return retained_;
+    }
+
+    int64_t
+    memory_bytes() const {
+        int64_t bytes = levels_.capacity() * sizeof(std::vector<double>);
+        for (auto& level : levels_) {
+            bytes += level.capacity() * sizeof(double);
+        }
+        return bytes;
+    }
+
+    void
+    Serialize(std::string& out) const;
+
+    // the sketch serialized at `data`, advanced past it
+    static QuantileSketch
+    Deserialize(const uint8_t*& data, int64_t& size);
+
+ private:
+    // most values kept at level h, the higher levels keep more
+    int64_t
+    capacity(size_t level) const;
+
+    void
+    update_capacity();
+
+    void
+    Compress();
+
+    std::vector<std::vector<double>> levels_;
+    int64_t count_ = 0;
+    int64_t retained_ = 0;
+    // sum of the capacities of the levels
+    int64_t capacity_ = 0;
+    double min_ = 0;
+    double max_ = 0;
+    // alternates the half of a level kept, so the errors cancel
+    uint64_t compactions_ = 0;
+};
+
+// Sketches of the values of a scalar field of a segment: the distinct count
+// of any field, the quantiles of numeric ones. Built when the column is
+// loaded; serialized and merged across segments without the rows, so the
+// cardinality and distribution of a collection are known from them.
+class FieldSketch {
+ public:
+    static constexpr int32_t kVersion = 1;
+
+    template <typename T>
+    static std::unique_ptr<FieldSketch>
+    Build(const T* values, int64_t row_count) {
+        constexpr auto numeric = std::is_arithmetic_v<T>;
+        static_assert(numeric || std::is_same_v<T, std::string_view> ||
+                      std::is_same_v<T, std::string>);
+        auto sketch = std::make_unique<FieldSketch>();
+        sketch->row_count_ = row_count;
+        if constexpr (numeric) {
+            sketch->quantiles_.emplace();
+        }
+        for (int64_t i = 0; i < row_count; ++i) {
+            sketch->distinct_.Add(Hash(values[i]));
+            if constexpr (numeric) {
+                sketch->quantiles_->Add(static_cast<double>(values[i]));
+            }
+        }
+        return sketch;
+    }
+
+    // integers of any width hash alike, as do floats and doubles, so a
+    // sketch of an int32 field merges with one of an int64 field
+    template <typename T>
+    static uint64_t
+    Hash(const T& value) {
+        uint64_t h;
+        if constexpr (std::is_integral_v<T>) {
+            h = uint64_t(int64_t(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            // -0.0 equals 0.0
+            double d = value == 0 ? 0.0 : static_cast<double>(value);
+            std::memcpy(&h, &d, sizeof(h));
+        } else {
+            h = std::hash<std::string_view>()(std::string_view(value));
+        }
+        // splitmix64 finalizer, the registers take the high bits
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    // throws if one has quantiles and the other hasn't
+    void
+    Merge(const FieldSketch& other);
+
+    int64_t
+    row_count() const {
+        return row_count_;
+    }
+
+    // estimated distinct values, at most the rows
+    int64_t
+    distinct_count() const;
+
+    // nullptr for the strings
+    const QuantileSketch*
+    quantiles() const {
+        return quantiles_.has_value() ? &quantiles_.value() : nullptr;
+    }
+
+    int64_t
+    memory_bytes() const {
+        return sizeof(*this) + distinct_.registers().capacity() +
+               (quantiles_.has_value() ? quantiles_->memory_bytes() : 0);
+    }
+
+    std::string
+    Serialize() const;
+
+    // throws if the `size` bytes aren't a sketch of this version
+    static FieldSketch
+    Deserialize(const void* data, int64_t size);
+
+ private:
+    int64_t row_count_ = 0;
+    HyperLogLog distinct_;
+    std::optional<QuantileSketch> quantiles_;
+};
+
+using FieldSketchPtr = std::shared_ptr<const FieldSketch>;
+
+}  // namespace milvus
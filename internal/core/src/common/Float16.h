@@ -0,0 +1,106 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace milvus {
+
+// IEEE 754 half precision float, stored as its bits
+using float16_t = uint16_t;
+
+// round to nearest even, values beyond the half range become infinity
+inline float16_t
+FloatToFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t abs = bits & 0x7fffffff;
+
+    // inf and nan, nan keeps a quiet bit
+    if (abs >= 0x7f800000) {
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+    }
+    // rounds beyond 65504
+    if (abs >= 0x477ff000) {
+        return sign | 0x7c00;
+    }
+    // below 2^-14, the result is subnormal
+    if (abs < 0x38800000) {
+        if (abs < 0x33000000) {
+            return sign;
+        }
+        uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - (abs >> 23);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t tie = 1u << (shift - 1);
+        if (rest > tie || (rest == tie && (half & 1))) {
+            half++;
+        }
+        return sign | half;
+    }
+    uint32_t half = (((abs >> 23) - 112) << 10) | ((abs >> 13) & 0x3ff);
+    uint32_t rest = abs & 0x1fff;
+    // a carry out of the mantissa bumps the exponent, as it should
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return sign | half;
+}
+
+inline float
+Float16ToFloat(float16_t value) {
+    uint32_t sign = uint32_t(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            float result = std::ldexp(float(mantissa), -24);
+            return sign ? -result : result;
+        }
+    } else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline void
+EncodeFloat16(const float* src, int64_t n, float16_t* dst) {
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = FloatToFloat16(src[i]);
+    }
+}
+
+inline void
+DecodeFloat16(const float16_t* src, int64_t n, float* dst) {
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = Float16ToFloat(src[i]);
+    }
+}
+
+}  // namespace milvus
@@ -21,10 +21,12 @@
 #include <boost/algorithm/string/replace.hpp>
 #include <cstddef>
 #include <cstdlib>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <string_view>
 
+#include "common/BinaryJson.h"
 #include "exceptions/EasyAssert.h"
 #include "simdjson.h"
 #include "fmt/core.h"
@@ -59,6 +61,13 @@ class Json {
         : data_(data, len, len + simdjson::SIMDJSON_PADDING) {
     }
 
+    // a view of the text which looks the values up in its BinaryJson
+    // encoding instead of parsing it
+    Json(const char* data, size_t len, std::string_view binary)
+        : data_(data, len, len + simdjson::SIMDJSON_PADDING),
+          binary_(binary) {
+    }
+
     Json(const Json& json) {
         if (json.own_data_.has_value()) {
             own_data_ = simdjson::padded_string(
@@ -66,6 +75,7 @@ class Json {
             data_ = own_data_.value();
         } else {
             data_ = json.data_;
+            binary_ = json.binary_;
         }
     };
     Json(Json&& json) noexcept {
@@ -74,6 +84,7 @@ class Json {
             data_ = own_data_.value();
         } else {
             data_ = json.data_;
+            binary_ = json.binary_;
         }
     }
 
@@ -85,6 +96,7 @@ class Json {
             data_ = own_data_.value();
         } else {
             data_ = json.data_;
+            binary_ = json.binary_;
         }
         return *this;
     }
@@ -93,6 +105,15 @@ class Json {
         return data_;
     }
 
+    // heap bytes of the padded copy of the document this json owns, 0 if
+    // it views memory owned by someone else
+    size_t
+    own_data_size() const {
+        return own_data_.has_value()
+                   ? own_data_->length() + simdjson::SIMDJSON_PADDING
+                   : 0;
+    }
+
     value_result<document>
     doc() const {
         thread_local simdjson::ondemand::parser parser;
@@ -110,6 +131,9 @@ class Json {
 
     bool
     exist(std::string_view pointer) const {
+        if (!binary_.empty()) {
+            return !BinaryJson(binary_).at_pointer(pointer).error();
+        }
         return doc().at_pointer(pointer).error() == simdjson::SUCCESS;
     }
 
@@ -127,9 +151,39 @@ class Json {
     template <typename T>
     value_result<T>
     at(std::string_view pointer) const {
+        if (!binary_.empty()) {
+            return BinaryJson(binary_).at_pointer(pointer).get<T>();
+        }
         return doc().at_pointer(pointer).get<T>();
     }
 
+    // calls visit(i, value) with the value at every pointers[i] in order,
+    // an error if it's missing, until visit returns false; the document is
+    // parsed once for all of them. The value is a BinaryJson::Value if the
+    // json has the encoding, so visit takes both.
+    template <typename Pointers, typename Visit>
+    void
+    visit_pointers(const Pointers& pointers, Visit visit) const {
+        if (!binary_.empty()) {
+            BinaryJson binary(binary_);
+            for (size_t i = 0; i < std::size(pointers); ++i) {
+                auto value = binary.at_pointer(pointers[i]);
+                if (!visit(i, value)) {
+                    return;
+                }
+            }
+            return;
+        }
+        auto doc = this->doc();
+        for (size_t i = 0; i < std::size(pointers); ++i) {
+            value_result<simdjson::ondemand::value> value =
+                doc.at_pointer(pointers[i]);
+            if (!visit(i, value)) {
+                return;
+            }
+        }
+    }
+
     std::string_view
     data() const {
         return data_;
@@ -139,5 +193,7 @@ class Json {
     std::optional<simdjson::padded_string>
         own_data_{};  // this could be empty, then the Json will be just s view on bytes
     simdjson::padded_string_view data_{};
+    // the BinaryJson encoding of a view, empty if there is none
+    std::string_view binary_{};
 };
 }  // namespace milvus
@@ -0,0 +1,139 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/Types.h"
+#include "exceptions/EasyAssert.h"
+#include "fmt/core.h"
+
+namespace milvus {
+
+// A string pattern of a PrefixMatch, a PostfixMatch or a Match, the like
+// of the parser, where % matches any run of characters and \% is a
+// literal %. It's the literals between the wildcards, which a matching
+// string holds in order, the first one at its start unless the pattern
+// starts with a wildcard and the last one at its end unless it ends with
+// one.
+class LikePattern {
+ public:
+    LikePattern(OpType op, std::string_view value) {
+        switch (op) {
+            case OpType::PrefixMatch:
+                literals_.emplace_back(value);
+                anchored_back_ = false;
+                break;
+            case OpType::PostfixMatch:
+                literals_.emplace_back(value);
+                anchored_front_ = false;
+                break;
+            case OpType::Match:
+                parse(value);
+                break;
+            default:
+                PanicInfo(fmt::format("unsupported pattern match op {}",
+                                      static_cast<int>(op)));
+        }
+    }
+
+    bool
+    operator()(std::string_view str) const {
+        if (exact_) {
+            return str == literals_[0];
+        }
+        size_t begin = 0;
+        size_t end = literals_.size();
+        size_t pos = 0;
+        size_t limit = str.size();
+        if (anchored_front_ && end > 0) {
+            auto& first = literals_[0];
+            if (str.substr(0, first.size()) != first) {
+                return false;
+            }
+            pos = first.size();
+            ++begin;
+        }
+        if (anchored_back_ && end > begin) {
+            auto& last = literals_[end - 1];
+            if (limit - pos < last.size() ||
+                str.substr(limit - last.size()) != last) {
+                return false;
+            }
+            limit -= last.size();
+            --end;
+        }
+        // the leftmost match of every literal leaves the most room to the
+        // ones after it
+        auto rest = str.substr(0, limit);
+        for (auto i = begin; i < end; ++i) {
+            auto found = rest.find(literals_[i], pos);
+            if (found == std::string_view::npos) {
+                return false;
+            }
+            pos = found + literals_[i].size();
+        }
+        return true;
+    }
+
+    // the literals between the wildcards in order
+    const std::vector<std::string>&
+    literals() const {
+        return literals_;
+    }
+
+ private:
+    void
+    parse(std::string_view pattern) {
+        std::string literal;
+        exact_ = true;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] == '\\' && i + 1 < pattern.size() &&
+                pattern[i + 1] == '%') {
+                literal.push_back('%');
+                ++i;
+                anchored_back_ = true;
+            } else if (pattern[i] == '%') {
+                if (i == 0) {
+                    anchored_front_ = false;
+                }
+                if (!literal.empty()) {
+                    literals_.push_back(std::move(literal));
+                    literal.clear();
+                }
+                exact_ = false;
+                anchored_back_ = false;
+            } else {
+                literal.push_back(pattern[i]);
+                anchored_back_ = true;
+            }
+        }
+        if (exact_ || !literal.empty()) {
+            literals_.push_back(std::move(literal));
+        }
+    }
+
+    std::vector<std::string> literals_;
+    // a Match without wildcards is an Equal
+    bool exact_ = false;
+    bool anchored_front_ = true;
+    bool anchored_back_ = true;
+};
+
+}  // namespace milvus
@@ -17,11 +17,40 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "Types.h"
 #include "common/CDataType.h"
 
+namespace milvus {
+
+// How the pages of a loaded column are mapped, CreateMap picks one from the
+// field type, see DefaultMmapPolicy, unless the load info sets it
+struct MmapPolicy {
+    enum class Access {
+        Normal,
+        // madvise(MADV_SEQUENTIAL), read ahead aggressively, e.g. for scans
+        Sequential,
+        // madvise(MADV_RANDOM), no read ahead, e.g. for rows read by offset
+        Random,
+    };
+
+    // fault the pages of a mapped file in at load time rather than on the
+    // first access, anonymous maps are written in full at load regardless
+    bool populate = true;
+    // madvise(MADV_HUGEPAGE), back the map with transparent huge pages
+    bool hugepage = false;
+    Access access = Access::Normal;
+    // mlock the pages, so a hot field never waits for a page fault; falls
+    // back to unlocked if RLIMIT_MEMLOCK doesn't allow it
+    bool lock = false;
+};
+
+}  // namespace milvus
+
 // NOTE: field_id can be system field
 // NOTE: Refer to common/SystemProperty.cpp for details
 // TODO: use arrow to pass field data instead of proto
@@ -31,6 +60,44 @@ struct LoadFieldDataInfo {
     const milvus::DataArray* field_data;
     int64_t row_count{-1};
     const char* mmap_dir_path{nullptr};
+    // DefaultMmapPolicy of the field if not set
+    std::optional<milvus::MmapPolicy> mmap_policy;
+};
+
+namespace milvus::storage {
+class FieldDataBase;
+class RemoteChunkManager;
+}  // namespace milvus::storage
+
+// Field data decoded from binlogs, loaded without the DataArray intermediate
+struct FieldDataInfo {
+    int64_t field_id;
+    std::vector<std::shared_ptr<milvus::storage::FieldDataBase>> datas;
+    int64_t row_count{-1};
+    const char* mmap_dir_path{nullptr};
+    // key of the column in ColumnCache, the column is mapped from the cached
+    // file if the key is set and the cache is enabled
+    std::string cache_key;
+    // DefaultMmapPolicy of the field if not set
+    std::optional<milvus::MmapPolicy> mmap_policy;
+};
+
+// Serialized binlogs of a field, owned by the caller, decoded at load time
+struct FieldBinlogsInfo {
+    int64_t field_id;
+    std::vector<const uint8_t*> binlogs;
+    std::vector<int64_t> binlog_sizes;
+    int64_t row_count{-1};
+    const char* mmap_dir_path{nullptr};
+};
+
+// Remote binlogs of a field which is fetched, decoded and cached on its
+// first access instead of at load time
+struct LazyFieldDataInfo {
+    int64_t field_id;
+    std::vector<std::string> binlog_paths;
+    int64_t row_count{-1};
+    std::shared_ptr<milvus::storage::RemoteChunkManager> chunk_manager;
 };
 
 struct LoadDeletedRecordInfo {
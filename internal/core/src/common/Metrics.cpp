@@ -0,0 +1,201 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "common/Metrics.h"
+
+#include <algorithm>
+
+#include "common/CpuGroup.h"
+
+namespace milvus::monitor {
+
+namespace {
+
+void
+AppendHeader(std::string& out,
+             const char* name,
+             const char* help,
+             const char* type) {
+    out += std::string("# HELP ") + name + " " + help + "\n";
+    out += std::string("# TYPE ") + name + " " + type + "\n";
+}
+
+std::string
+Seconds(int64_t nanos) {
+    return std::to_string(nanos / 1e9);
+}
+
+}  // namespace
+
+void
+Counter::Serialize(std::string& out) const {
+    AppendHeader(out, name_, help_, "counter");
+    out += std::string(name_) + " " + std::to_string(Value()) + "\n";
+}
+
+void
+Gauge::Serialize(std::string& out) const {
+    AppendHeader(out, name_, help_, "gauge");
+    out += std::string(name_) + " " + std::to_string(Value()) + "\n";
+}
+
+void
+Histogram::Observe(int64_t nanos) {
+    auto bucket =
+        std::lower_bound(kBounds.begin(), kBounds.end(), nanos) -
+        kBounds.begin();
+    auto& shard = shards_[ThreadShard()];
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum_nanos.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+int64_t
+Histogram::Count() const {
+    int64_t count = 0;
+    for (auto& shard : shards_) {
+        for (auto& bucket : shard.buckets) {
+            count += bucket.load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+void
+Histogram::Serialize(std::string& out) const {
+    std::array<int64_t, kBounds.size() + 1> buckets{};
+    int64_t sum_nanos = 0;
+    for (auto& shard : shards_) {
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        sum_nanos += shard.sum_nanos.load(std::memory_order_relaxed);
+    }
+
+    AppendHeader(out, name_, help_, "histogram");
+    // the buckets of the text format are cumulative
+    int64_t count = 0;
+    for (size_t i = 0; i < kBounds.size(); ++i) {
+        count += buckets[i];
+        out += std::string(name_) + "_bucket{le=\"" + Seconds(kBounds[i]) +
+               "\"} " + std::to_string(count) + "\n";
+    }
+    count += buckets.back();
+    out += std::string(name_) + "_bucket{le=\"+Inf\"} " +
+           std::to_string(count) + "\n";
+    out += std::string(name_) + "_sum " + Seconds(sum_nanos) + "\n";
+    out += std::string(name_) + "_count " + std::to_string(count) + "\n";
+}
+
+Histogram load_field_decode_latency(
+    "milvus_segcore_load_field_decode_seconds",
+    "time to decode the binlogs of a field into field data");
+Histogram load_field_build_latency(
+    "milvus_segcore_load_field_build_seconds",
+    "time to build the column of a sealed segment from its field data");
+Histogram load_index_latency("milvus_segcore_load_index_seconds",
+                             "time to load an index into a sealed segment");
+Histogram index_warmup_latency(
+    "milvus_segcore_index_warmup_seconds",
+    "time to warm up a vector index loaded into a sealed segment");
+Histogram expr_eval_latency(
+    "milvus_segcore_expr_eval_seconds",
+    "time to evaluate the predicate of a query on a segment");
+Histogram reduce_latency(
+    "milvus_segcore_reduce_seconds",
+    "time to reduce, fill and marshal the search results of segments");
+Counter delete_bitmap_cache_hits(
+    "milvus_segcore_delete_bitmap_cache_hits_total",
+    "delete bitmaps taken from the cache of the delete record");
+Counter delete_bitmap_cache_misses(
+    "milvus_segcore_delete_bitmap_cache_misses_total",
+    "delete bitmaps rebuilt as the cached one was stale");
+Counter segment_snapshot_hits(
+    "milvus_segcore_segment_snapshot_hits_total",
+    "segment snapshots shared with a query at the same timestamp");
+Counter segment_snapshot_misses(
+    "milvus_segcore_segment_snapshot_misses_total",
+    "segment snapshots built as none was held or it was stale");
+Counter mmap_file_bytes("milvus_segcore_mmap_file_bytes_total",
+                        "bytes of field data written to mmap files");
+Gauge thread_pool_queued_tasks(
+    "milvus_segcore_thread_pool_queued_tasks",
+    "tasks submitted to the segcore thread pool and not taken yet");
+Gauge field_data_pool_cached_bytes(
+    "milvus_segcore_field_data_pool_cached_bytes",
+    "bytes of the free field data buffers kept for reuse");
+Gauge field_data_pool_used_bytes(
+    "milvus_segcore_field_data_pool_used_bytes",
+    "bytes of the pooled field data buffers in use");
+Counter field_data_pool_hits(
+    "milvus_segcore_field_data_pool_hits_total",
+    "field data buffers reused from the pool");
+Counter field_data_pool_misses(
+    "milvus_segcore_field_data_pool_misses_total",
+    "field data buffers mapped as the pool had none of their size");
+
+namespace {
+
+// the accounting of every cpu group, labeled by its id
+void
+SerializeCpuGroups(std::string& out) {
+    auto groups = ListCpuGroups();
+    if (groups.empty()) {
+        return;
+    }
+    auto append = [&](const char* name,
+                      const char* help,
+                      const auto& value) {
+        AppendHeader(out, name, help, "counter");
+        for (auto group : groups) {
+            out += std::string(name) + "{group=\"" +
+                   std::to_string(group->id()) + "\"} " + value(*group) +
+                   "\n";
+        }
+    };
+    append("milvus_segcore_cpu_group_cpu_seconds_total",
+           "cpu time of the threads running for a cpu group",
+           [](const CpuGroup& group) { return Seconds(group.cpu_nanos()); });
+    append("milvus_segcore_cpu_group_tasks_total",
+           "tasks of a cpu group run by the thread pool",
+           [](const CpuGroup& group) {
+               return std::to_string(group.tasks());
+           });
+    append("milvus_segcore_cpu_group_wait_seconds_total",
+           "time the tasks of a cpu group waited in the thread pool",
+           [](const CpuGroup& group) { return Seconds(group.wait_nanos()); });
+}
+
+}  // namespace
+
+std::string
+SerializeSegcoreMetrics() {
+    std::string out;
+    load_field_decode_latency.Serialize(out);
+    load_field_build_latency.Serialize(out);
+    load_index_latency.Serialize(out);
+    index_warmup_latency.Serialize(out);
+    expr_eval_latency.Serialize(out);
+    reduce_latency.Serialize(out);
+    delete_bitmap_cache_hits.Serialize(out);
+    delete_bitmap_cache_misses.Serialize(out);
+    segment_snapshot_hits.Serialize(out);
+    segment_snapshot_misses.Serialize(out);
+    mmap_file_bytes.Serialize(out);
+    thread_pool_queued_tasks.Serialize(out);
+    field_data_pool_cached_bytes.Serialize(out);
+    field_data_pool_used_bytes.Serialize(out);
+    field_data_pool_hits.Serialize(out);
+    field_data_pool_misses.Serialize(out);
+    SerializeCpuGroups(out);
+    return out;
+}
+
+}  // namespace milvus::monitor
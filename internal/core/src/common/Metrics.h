@@ -0,0 +1,188 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace milvus::monitor {
+
+// Every metric spreads its updates over this many shards, a thread always
+// updates the same shard so concurrent updates rarely touch the same cache
+// line. The shards are merged when the metrics are scraped.
+constexpr int kMetricShards = 16;
+
+inline int
+ThreadShard() {
+    static std::atomic<int> next_shard{0};
+    thread_local int shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+class ShardedValue {
+ public:
+    void
+    Add(int64_t delta) {
+        shards_[ThreadShard()].value.fetch_add(delta,
+                                               std::memory_order_relaxed);
+    }
+
+    int64_t
+    Value() const {
+        int64_t value = 0;
+        for (auto& shard : shards_) {
+            value += shard.value.load(std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+ private:
+    struct alignas(64) Shard {
+        std::atomic<int64_t> value{0};
+    };
+    std::array<Shard, kMetricShards> shards_{};
+};
+
+class Counter {
+ public:
+    constexpr Counter(const char* name, const char* help)
+        : name_(name), help_(help) {
+    }
+
+    void
+    Inc(int64_t delta = 1) {
+        value_.Add(delta);
+    }
+
+    int64_t
+    Value() const {
+        return value_.Value();
+    }
+
+    // appends the metric in the prometheus text format
+    void
+    Serialize(std::string& out) const;
+
+ private:
+    const char* name_;
+    const char* help_;
+    ShardedValue value_;
+};
+
+class Gauge {
+ public:
+    constexpr Gauge(const char* name, const char* help)
+        : name_(name), help_(help) {
+    }
+
+    void
+    Add(int64_t delta) {
+        value_.Add(delta);
+    }
+
+    void
+    Sub(int64_t delta) {
+        value_.Add(-delta);
+    }
+
+    int64_t
+    Value() const {
+        return value_.Value();
+    }
+
+    void
+    Serialize(std::string& out) const;
+
+ private:
+    const char* name_;
+    const char* help_;
+    ShardedValue value_;
+};
+
+// A latency histogram in seconds, all histograms share the same buckets
+class Histogram {
+ public:
+    // upper bounds of the buckets in nanoseconds, a last bucket takes the
+    // rest
+    static constexpr std::array<int64_t, 12> kBounds = {
+        100'000,
+        500'000,
+        1'000'000,
+        5'000'000,
+        10'000'000,
+        50'000'000,
+        100'000'000,
+        500'000'000,
+        1'000'000'000,
+        5'000'000'000,
+        10'000'000'000,
+        60'000'000'000};
+
+    constexpr Histogram(const char* name, const char* help)
+        : name_(name), help_(help) {
+    }
+
+    void
+    Observe(int64_t nanos);
+
+    void
+    ObserveSince(std::chrono::steady_clock::time_point begin) {
+        Observe(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count());
+    }
+
+    int64_t
+    Count() const;
+
+    void
+    Serialize(std::string& out) const;
+
+ private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<int64_t>, kBounds.size() + 1> buckets{};
+        std::atomic<int64_t> sum_nanos{0};
+    };
+
+    const char* name_;
+    const char* help_;
+    std::array<Shard, kMetricShards> shards_{};
+};
+
+// the metrics of segcore itself, the ones of knowhere are kept by its own
+// registry
+extern Histogram load_field_decode_latency;
+extern Histogram load_field_build_latency;
+extern Histogram load_index_latency;
+extern Histogram index_warmup_latency;
+extern Histogram expr_eval_latency;
+extern Histogram reduce_latency;
+extern Counter delete_bitmap_cache_hits;
+extern Counter delete_bitmap_cache_misses;
+extern Counter segment_snapshot_hits;
+extern Counter segment_snapshot_misses;
+extern Counter mmap_file_bytes;
+extern Gauge thread_pool_queued_tasks;
+extern Gauge field_data_pool_cached_bytes;
+extern Gauge field_data_pool_used_bytes;
+extern Counter field_data_pool_hits;
+extern Counter field_data_pool_misses;
+
+// all the metrics above in the prometheus text format
+std::string
+SerializeSegcoreMetrics();
+
+}  // namespace milvus::monitor
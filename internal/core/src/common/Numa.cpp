@@ -0,0 +1,178 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "common/Numa.h"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "log/Log.h"
+
+namespace milvus::numa {
+
+namespace {
+
+// from linux/mempolicy.h, which isn't always installed
+constexpr int MPOL_DEFAULT_POLICY = 0;
+constexpr int MPOL_PREFERRED_POLICY = 1;
+// bits of the node masks passed to the kernel
+constexpr int MAX_NODES = 64;
+
+// parses a sysfs cpu or node list, e.g. "0-3,8,10-11"
+std::vector<int>
+ParseList(const std::string& list) {
+    std::vector<int> result;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        auto dash = range.find('-');
+        auto first = std::stoi(range.substr(0, dash));
+        auto last = dash == std::string::npos
+                        ? first
+                        : std::stoi(range.substr(dash + 1));
+        for (auto i = first; i <= last; ++i) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+std::vector<int>
+ReadList(const std::string& path) {
+    std::ifstream file(path);
+    std::string list;
+    if (!file || !std::getline(file, list)) {
+        return {};
+    }
+    try {
+        return ParseList(list);
+    } catch (std::exception& e) {
+        LOG_SEGCORE_WARNING_ << "failed to parse " << path << ": " << e.what();
+        return {};
+    }
+}
+
+struct Topology {
+    // cpus of every node, indexed by the node id
+    std::vector<std::vector<int>> node_cpus;
+};
+
+const Topology&
+GetTopology() {
+    static const Topology topology = []() {
+        Topology result;
+        auto nodes = ReadList("/sys/devices/system/node/online");
+        for (auto node : nodes) {
+            if (node >= MAX_NODES) {
+                continue;
+            }
+            if (result.node_cpus.size() <= size_t(node)) {
+                result.node_cpus.resize(node + 1);
+            }
+            result.node_cpus[node] =
+                ReadList("/sys/devices/system/node/node" +
+                         std::to_string(node) + "/cpulist");
+        }
+        if (result.node_cpus.empty()) {
+            result.node_cpus.resize(1);
+        }
+        return result;
+    }();
+    return topology;
+}
+
+// whether placing on `node` means anything on this host
+bool
+Placeable(int node) {
+    return node >= 0 && NumNodes() > 1 && !NodeCpus(node).empty();
+}
+
+#ifdef __linux__
+long
+SetMemPolicy(int mode, const unsigned long* mask, unsigned long max_node) {
+    return syscall(SYS_set_mempolicy, mode, mask, max_node);
+}
+#endif
+
+}  // namespace
+
+int
+NumNodes() {
+    return GetTopology().node_cpus.size();
+}
+
+const std::vector<int>&
+NodeCpus(int node) {
+    static const std::vector<int> none;
+    auto& node_cpus = GetTopology().node_cpus;
+    if (node < 0 || size_t(node) >= node_cpus.size()) {
+        return none;
+    }
+    return node_cpus[node];
+}
+
+bool
+PinCurrentThread(int node) {
+    if (!Placeable(node)) {
+        return false;
+    }
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (auto cpu : NodeCpus(node)) {
+        CPU_SET(cpu, &cpus);
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) == 0) {
+        return true;
+    }
+    LOG_SEGCORE_WARNING_ << "failed to pin thread to numa node " << node;
+#endif
+    return false;
+}
+
+ScopedMemoryPolicy::ScopedMemoryPolicy(int node) {
+    if (!Placeable(node)) {
+        return;
+    }
+#ifdef __linux__
+    unsigned long mask = 1UL << node;
+    applied_ = SetMemPolicy(MPOL_PREFERRED_POLICY, &mask, MAX_NODES + 1) == 0;
+    if (!applied_) {
+        static std::once_flag warned;
+        std::call_once(warned, [node]() {
+            LOG_SEGCORE_WARNING_ << "failed to prefer numa node " << node
+                                 << ", memory stays on the default nodes";
+        });
+    }
+#endif
+}
+
+ScopedMemoryPolicy::~ScopedMemoryPolicy() {
+#ifdef __linux__
+    if (applied_) {
+        SetMemPolicy(MPOL_DEFAULT_POLICY, nullptr, 0);
+    }
+#endif
+}
+
+}  // namespace milvus::numa
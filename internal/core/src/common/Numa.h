@@ -0,0 +1,52 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <vector>
+
+namespace milvus::numa {
+
+// Placement of segment data and search threads on the NUMA nodes of the
+// host. Everything is best effort: without NUMA support, on a single node
+// host or for a negative node the calls do nothing.
+
+// the number of online nodes, 1 if the host doesn't tell
+int
+NumNodes();
+
+// the cpus of `node`, empty if it doesn't exist
+const std::vector<int>&
+NodeCpus(int node);
+
+// pins the calling thread to the cpus of `node`, false if it failed
+bool
+PinCurrentThread(int node);
+
+// Makes the pages the calling thread faults in while it lives prefer
+// `node`, e.g. the anonymous maps of loaded columns and the memory of
+// loaded indexes. The pages fall back to other nodes when `node` is full.
+class ScopedMemoryPolicy {
+ public:
+    explicit ScopedMemoryPolicy(int node);
+
+    ~ScopedMemoryPolicy();
+
+    ScopedMemoryPolicy(const ScopedMemoryPolicy&) = delete;
+    ScopedMemoryPolicy&
+    operator=(const ScopedMemoryPolicy&) = delete;
+
+ private:
+    bool applied_ = false;
+};
+
+}  // namespace milvus::numa
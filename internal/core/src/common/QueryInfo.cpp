@@ -0,0 +1,100 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/QueryInfo.h"
+
+#include <fmt/core.h>
+
+#include "common/Consts.h"
+#include "common/RangeSearchHelper.h"
+#include "exceptions/EasyAssert.h"
+#include "knowhere/comp/index_param.h"
+
+namespace milvus {
+
+namespace {
+
+std::optional<float>
+GetNumber(const knowhere::Json& search_params, const char* key) {
+    if (!search_params.contains(key)) {
+        return std::nullopt;
+    }
+    auto& value = search_params[key];
+    AssertInfo(value.is_number(),
+               fmt::format("search param {} must be a number, got {}",
+                           key,
+                           value.dump()));
+    return value.get<float>();
+}
+
+}  // namespace
+
+SearchParamsPtr
+ParseSearchParams(const knowhere::Json& search_params,
+                  int64_t topk,
+                  const MetricType& metric_type) {
+    auto params = std::make_shared<SearchParams>();
+    params->radius_ = GetNumber(search_params, RADIUS);
+    if (params->radius_.has_value()) {
+        params->range_filter_ = GetNumber(search_params, RANGE_FILTER);
+        if (params->range_filter_.has_value()) {
+            CheckRangeSearchParam(params->radius_.value(),
+                                  params->range_filter_.value(),
+                                  metric_type);
+        }
+    }
+    params->search_conf_ = search_params;
+    params->search_conf_[knowhere::meta::TOPK] = topk;
+    params->search_conf_[knowhere::meta::METRIC_TYPE] = metric_type;
+
+    auto& brute_force_conf = params->brute_force_conf_;
+    brute_force_conf[knowhere::meta::TOPK] = topk;
+    brute_force_conf[knowhere::meta::METRIC_TYPE] = metric_type;
+    if (params->radius_.has_value()) {
+        brute_force_conf[RADIUS] = params->radius_.value();
+    }
+    if (params->range_filter_.has_value()) {
+        brute_force_conf[RANGE_FILTER] = params->range_filter_.value();
+    }
+    return params;
+}
+
+RecallTier
+ParseRecallTier(const std::string& tier) {
+    if (tier == "low") {
+        return RecallTier::LOW;
+    }
+    if (tier == "medium") {
+        return RecallTier::MEDIUM;
+    }
+    AssertInfo(tier == "high",
+               fmt::format("recall tier must be one of low, medium and "
+                           "high, got {}",
+                           tier));
+    return RecallTier::HIGH;
+}
+
+SearchParamsPtr
+GetSearchParams(const SearchInfo& search_info) {
+    if (search_info.parsed_params_ != nullptr) {
+        return search_info.parsed_params_;
+    }
+    return ParseSearchParams(search_info.search_params_,
+                             search_info.topk_,
+                             search_info.metric_type_);
+}
+
+}  // namespace milvus
@@ -17,18 +17,85 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 
 #include "common/Types.h"
 #include "knowhere/config.h"
 namespace milvus {
+
+// the search params of a plan parsed and validated once, shared by the
+// searches of all its segments
+struct SearchParams {
+    // bounds of a range search
+    std::optional<float> radius_;
+    std::optional<float> range_filter_;
+    // the search params with the topk and the metric type, the config of
+    // index searches with that metric type
+    knowhere::Json search_conf_;
+    // the topk, the metric type and the range, the config of brute force
+    // searches, knowhere takes the dim from the datasets
+    knowhere::Json brute_force_conf_;
+
+    bool
+    is_range_search() const {
+        return radius_.has_value();
+    }
+};
+
+using SearchParamsPtr = std::shared_ptr<const SearchParams>;
+
+enum class RecallTier {
+    LOW = 0,
+    MEDIUM = 1,
+    HIGH = 2,
+};
+
+// the tier of "low", "medium" or "high"
+RecallTier
+ParseRecallTier(const std::string& tier);
+
+// what an index search tuned by segcore aims at, see AdaptiveSearchTuner
+struct AdaptiveSearchTarget {
+    RecallTier recall_tier_ = RecallTier::MEDIUM;
+    // 0 for none
+    double latency_budget_ms_ = 0;
+};
+
+// parses and validates the search params of a search of `topk` with
+// `metric_type`
+SearchParamsPtr
+ParseSearchParams(const knowhere::Json& search_params,
+                  int64_t topk,
+                  const MetricType& metric_type);
+
 struct SearchInfo {
     int64_t topk_;
     int64_t round_decimal_;
     FieldId field_id_;
     MetricType metric_type_;
     knowhere::Json search_params_;
+    // keep at most group_size_ hits per value of this field, for each nq
+    std::optional<FieldId> group_by_field_id_;
+    int64_t group_size_ = 1;
+    // collect a QueryProfile along the search
+    bool profile_ = false;
+    // search_params_ parsed by the plan parser, null for a search info
+    // built by hand, see GetSearchParams
+    SearchParamsPtr parsed_params_;
+    // an index search fetches refine_factor_ x topk_ hits, reranked by their
+    // exact distances when the raw vectors are at hand
+    int64_t refine_factor_ = 1;
+    // the params of that search, parsed with the plan
+    SearchParamsPtr refine_params_;
+    // set if the params of the index searches are picked per segment
+    std::optional<AdaptiveSearchTarget> adaptive_;
 };
 
+// the params parsed with the plan, or parsed now if there are none
+SearchParamsPtr
+GetSearchParams(const SearchInfo& search_info);
+
 using SearchInfoPtr = std::shared_ptr<SearchInfo>;
 
 }  // namespace milvus
@@ -0,0 +1,43 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "common/QueryProfile.h"
+
+#include "utils/Json.h"
+
+namespace milvus {
+
+std::string
+QueryProfile::ToJson() const {
+    json exprs_json = json::array();
+    for (auto& expr : exprs) {
+        exprs_json.push_back({{"expr", expr.expr},
+                              {"depth", expr.depth},
+                              {"elapsed_ns", expr.elapsed_ns},
+                              {"rows_scanned", expr.rows_scanned},
+                              {"chunks_skipped", expr.chunks_skipped},
+                              {"rows_matched", expr.rows_matched}});
+    }
+    json result = {{"active_count", active_count},
+                   {"predicate_ns", predicate_ns},
+                   {"mvcc_mask_ns", mvcc_mask_ns},
+                   {"delete_mask_ns", delete_mask_ns},
+                   {"vector_search_ns", vector_search_ns},
+                   {"fill_target_entry_ns", fill_target_entry_ns},
+                   {"bitset_density", bitset_density},
+                   {"predicate_cached", predicate_cached},
+                   {"search_path", search_path},
+                   {"search_params", search_params},
+                   {"exprs", std::move(exprs_json)}};
+    return result.dump();
+}
+
+}  // namespace milvus
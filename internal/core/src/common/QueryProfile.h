@@ -0,0 +1,61 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace milvus {
+
+// Execution statistics of one node of a predicate, in the preorder of the
+// expression tree
+struct ExprProfile {
+    std::string expr;
+    // depth of the node in the expression tree, 0 for the root
+    int64_t depth = 0;
+    int64_t elapsed_ns = 0;
+    // rows whose values were evaluated, and chunks decided without looking
+    // at their rows, by a zone map or because none of their rows was a
+    // candidate
+    int64_t rows_scanned = 0;
+    int64_t chunks_skipped = 0;
+    int64_t rows_matched = 0;
+};
+
+// Execution statistics of a query on one segment, collected only when the
+// search params of the plan set "profile"
+struct QueryProfile {
+    int64_t active_count = 0;
+    int64_t predicate_ns = 0;
+    int64_t mvcc_mask_ns = 0;
+    int64_t delete_mask_ns = 0;
+    int64_t vector_search_ns = 0;
+    int64_t fill_target_entry_ns = 0;
+    // the ratio of the rows left to search after filtering and masking
+    double bitset_density = 0;
+    // true if the predicate result came from the expression result cache,
+    // no expression node was evaluated then
+    bool predicate_cached = false;
+    // "brute_force_offsets" when the few rows left were compared directly,
+    // "post_filter" when nearly every row was left and an unfiltered index
+    // search dropped the filtered out hits, otherwise "vector_search"
+    std::string search_path;
+    // the search params the index or brute force search got
+    std::string search_params;
+    std::vector<ExprProfile> exprs;
+
+    std::string
+    ToJson() const;
+};
+
+}  // namespace milvus
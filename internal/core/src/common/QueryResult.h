@@ -27,6 +27,7 @@
 #include <NamedType/named_type.hpp>
 
 #include "common/FieldMeta.h"
+#include "common/QueryProfile.h"
 #include "pb/schema.pb.h"
 
 namespace milvus {
@@ -43,6 +44,15 @@ struct SearchResult {
         return topk_per_nq_prefix_sum_[total_nq_];
     }
 
+    // the primary key at `offset`, reduce reads the typed keys instead
+    PkType
+    get_primary_key(int64_t offset) const {
+        if (pk_type_ == DataType::VARCHAR) {
+            return string_pks_[offset];
+        }
+        return int64_pks_[offset];
+    }
+
  public:
     int64_t total_nq_;
     int64_t unity_topK_;
@@ -52,20 +62,31 @@ struct SearchResult {
     std::vector<float> distances_;
     std::vector<int64_t> seg_offsets_;
 
-    // first fill data during fillPrimaryKey, and then update data after reducing search results
-    std::vector<PkType> primary_keys_;
-    DataType pk_type_;
+    // first fill data during fillPrimaryKey, and then update data after reducing search results,
+    // only the keys of pk_type_ are set: int64_pks_ for INT64, string_pks_ for VARCHAR
+    std::vector<int64_t> int64_pks_;
+    std::vector<std::string> string_pks_;
+    DataType pk_type_ = DataType::NONE;
+
+    // filled during search when the plan groups by a field, same layout as seg_offsets_
+    std::vector<GroupByValueType> group_by_values_;
 
     // fill data during reducing search result
     std::vector<int64_t> result_offsets_;
-    // after reducing search result done, size(distances_) = size(seg_offsets_) = size(primary_keys_) =
-    // size(primary_keys_)
+    // after reducing search result done, size(distances_) = size(seg_offsets_) = number of primary keys
 
     // set output fields data when fill target entity
     std::map<FieldId, std::unique_ptr<milvus::DataArray>> output_fields_data_;
 
     // used for reduce, filter invalid pk, get real topks count
     std::vector<size_t> topk_per_nq_prefix_sum_;
+
+    // set if the plan asked for the profile of the search
+    std::unique_ptr<QueryProfile> profile_;
+
+    // the search params picked for the index search as json, set only if
+    // the plan leaves them to segcore
+    std::string effective_search_params_;
 };
 
 using SearchResultPtr = std::shared_ptr<SearchResult>;
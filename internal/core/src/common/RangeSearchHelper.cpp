@@ -9,7 +9,10 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
-#include <queue>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <vector>
 #include <functional>
 #include <iostream>
@@ -20,7 +23,74 @@
 namespace milvus {
 namespace {
 using ResultPair = std::pair<float, int64_t>;
+
+// below this many results the queries are sorted by the calling thread
+constexpr size_t PARALLEL_SORT_MIN_RESULTS = 64 * 1024;
+
+// writes the topk best results of one query to out_dist/out_id, best first.
+// `heap` keeps the best ones seen so far with the worst of them on top, so a
+// result only costs a comparison once topk ones are kept
+template <typename Better>
+void
+SelectTopk(const float* dist,
+           const int64_t* id,
+           int64_t size,
+           int64_t topk,
+           float* out_dist,
+           int64_t* out_id,
+           std::vector<ResultPair>& heap) {
+    Better better;
+    heap.clear();
+    for (int64_t j = 0; j < size; j++) {
+        auto current = ResultPair(dist[j], id[j]);
+        if (int64_t(heap.size()) < topk) {
+            heap.push_back(current);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(current, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = current;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), better);
+    for (size_t k = 0; k < heap.size(); k++) {
+        out_dist[k] = heap[k].first;
+        out_id[k] = heap[k].second;
+    }
+}
+
+template <typename Better>
+void
+SortRangeSearchResultImpl(const size_t* lims,
+                          const int64_t* id,
+                          const float* dist,
+                          int64_t topk,
+                          int64_t nq,
+                          int64_t* p_id,
+                          float* p_dist) {
+    auto sort_queries = [&](int64_t begin, int64_t end) {
+        std::vector<ResultPair> heap;
+        for (int64_t i = begin; i < end; i++) {
+            SelectTopk<Better>(dist + lims[i],
+                               id + lims[i],
+                               lims[i + 1] - lims[i],
+                               topk,
+                               p_dist + i * topk,
+                               p_id + i * topk,
+                               heap);
+        }
+    };
+    if (lims[nq] - lims[0] < PARALLEL_SORT_MIN_RESULTS) {
+        sort_queries(0, nq);
+        return;
+    }
+    tbb::parallel_for(tbb::blocked_range<int64_t>(0, nq),
+                      [&](const tbb::blocked_range<int64_t>& range) {
+                          sort_queries(range.begin(), range.end());
+                      });
 }
+}  // namespace
+
 DatasetPtr
 SortRangeSearchResult(DatasetPtr data_set,
                       int64_t topk,
@@ -63,38 +133,12 @@ SortRangeSearchResult(DatasetPtr data_set,
          *          |------------+---------------|       max_heap   ascending_order
          *
     */
-    std::function<bool(const ResultPair&, const ResultPair&)> cmp =
-        std::less<>();
     if (IsMetricType(metric_type, knowhere::metric::IP)) {
-        cmp = std::greater<>();
-    }
-    std::priority_queue<ResultPair, std::vector<ResultPair>, decltype(cmp)>
-        sub_result(cmp);
-
-    // The subscript of p_id and p_dist
-    int cnt = 0;
-    for (int i = 0; i < nq; i++) {
-        // if RangeSearch answer size of one nq is less than topk, set the capacity to size
-        int size = lims[i + 1] - lims[i];
-        int capacity = topk > size ? size : topk;
-
-        for (int j = lims[i]; j < lims[i + 1]; j++) {
-            auto current = ResultPair(dist[j], id[j]);
-            if (sub_result.size() == capacity) {
-                if (cmp(sub_result.top(), current)) {
-                    current = sub_result.top();
-                }
-                sub_result.pop();
-            }
-            sub_result.push(current);
-        }
-
-        for (int i = capacity + cnt - 1; i > cnt - 1; i--) {
-            p_dist[i] = sub_result.top().first;
-            p_id[i] = sub_result.top().second;
-            sub_result.pop();
-        }
-        cnt += topk;
+        SortRangeSearchResultImpl<std::greater<>>(
+            lims, id, dist, topk, nq, p_id, p_dist);
+    } else {
+        SortRangeSearchResultImpl<std::less<>>(
+            lims, id, dist, topk, nq, p_id, p_dist);
     }
     return GenResultDataset(nq, topk, p_id, p_dist);
 }
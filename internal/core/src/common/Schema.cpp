@@ -14,8 +14,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <optional>
 #include <string>
+#include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <google/protobuf/text_format.h>
 
@@ -69,6 +71,20 @@ Schema::ParseFrom(const milvus::proto::schema::CollectionSchema& schema_proto) {
             auto max_len =
                 boost::lexical_cast<int64_t>(type_map.at(MAX_LENGTH));
             schema->AddField(name, field_id, data_type, max_len);
+        } else if (data_type == DataType::JSON) {
+            auto type_map = RepeatedKeyValToMap(child.type_params());
+            std::vector<std::string> json_key_paths;
+            if (type_map.count(JSON_KEY_PATHS)) {
+                boost::split(json_key_paths,
+                             type_map.at(JSON_KEY_PATHS),
+                             boost::is_any_of(","));
+                json_key_paths.erase(
+                    std::remove(
+                        json_key_paths.begin(), json_key_paths.end(), ""),
+                    json_key_paths.end());
+            }
+            schema->AddField(
+                name, field_id, data_type, std::move(json_key_paths));
         } else {
             schema->AddField(name, field_id, data_type);
         }
@@ -78,6 +94,10 @@ Schema::ParseFrom(const milvus::proto::schema::CollectionSchema& schema_proto) {
                        "repetitive primary key");
             schema->set_primary_field_id(field_id);
         }
+
+        if (child.is_partition_key()) {
+            schema->set_partition_key_field_id(field_id);
+        }
     }
 
     AssertInfo(schema->get_primary_field_id().has_value(),
@@ -41,6 +41,17 @@ class Schema {
         return field_id;
     }
 
+    FieldId
+    AddDebugField(const std::string& name,
+                  DataType data_type,
+                  std::vector<std::string> json_key_paths) {
+        auto field_id = FieldId(debug_id);
+        debug_id++;
+        this->AddField(
+            FieldName(name), field_id, data_type, std::move(json_key_paths));
+        return field_id;
+    }
+
     // auto gen field_id for convenience
     FieldId
     AddDebugField(const std::string& name,
@@ -72,6 +83,17 @@ class Schema {
         this->AddField(std::move(field_meta));
     }
 
+    // json type
+    void
+    AddField(const FieldName& name,
+             const FieldId id,
+             DataType data_type,
+             std::vector<std::string> json_key_paths) {
+        auto field_meta =
+            FieldMeta(name, id, data_type, std::move(json_key_paths));
+        this->AddField(std::move(field_meta));
+    }
+
     // vector type
     void
     AddField(const FieldName& name,
@@ -88,6 +110,11 @@ class Schema {
         this->primary_field_id_opt_ = field_id;
     }
 
+    void
+    set_partition_key_field_id(FieldId field_id) {
+        this->partition_key_field_id_opt_ = field_id;
+    }
+
     auto
     begin() const {
         return fields_.begin();
@@ -146,6 +173,11 @@ class Schema {
         return primary_field_id_opt_;
     }
 
+    std::optional<FieldId>
+    get_partition_key_field_id() const {
+        return partition_key_field_id_opt_;
+    }
+
  public:
     static std::shared_ptr<Schema>
     ParseFrom(const milvus::proto::schema::CollectionSchema& schema_proto);
@@ -179,6 +211,7 @@ class Schema {
 
     int64_t total_sizeof_ = 0;
     std::optional<FieldId> primary_field_id_opt_;
+    std::optional<FieldId> partition_key_field_id_opt_;
 };
 
 using SchemaPtr = std::shared_ptr<Schema>;
@@ -15,12 +15,18 @@
 // limitations under the License.
 
 #include "common/Slice.h"
+
+#include <cstring>
+
 #include "common/Common.h"
+#include "exceptions/EasyAssert.h"
+#include "fmt/core.h"
 #include "log/Log.h"
 
 namespace milvus {
 
-static const char* INDEX_FILE_SLICE_META = "SLICE_META";
+const char* INDEX_FILE_SLICE_META = "SLICE_META";
+
 static const char* META = "meta";
 static const char* NAME = "name";
 static const char* SLICE_NUM = "slice_num";
@@ -36,12 +42,12 @@ Slice(const std::string& prefix,
         return;
     }
 
+    // the slices are views of the binary, which they keep alive
     int slice_num = 0;
     for (int64_t i = 0; i < data_src->size; ++slice_num) {
         int64_t ri = std::min(i + slice_len, data_src->size);
-        auto size = static_cast<size_t>(ri - i);
-        auto slice_i = std::shared_ptr<uint8_t[]>(new uint8_t[size]);
-        memcpy(slice_i.get(), data_src->data.get() + i, size);
+        auto slice_i = std::shared_ptr<uint8_t[]>(data_src->data,
+                                                  data_src->data.get() + i);
         binarySet.Append(
             prefix + "_" + std::to_string(slice_num), slice_i, ri - i);
         i = ri;
@@ -65,10 +71,26 @@ Assemble(BinarySet& binarySet) {
         std::string prefix = item[NAME];
         int slice_num = item[SLICE_NUM];
         auto total_len = static_cast<size_t>(item[TOTAL_LEN]);
-        auto p_data = std::shared_ptr<uint8_t[]>(new uint8_t[total_len]);
-        int64_t pos = 0;
+        std::vector<BinaryPtr> slices;
+        bool contiguous = true;
+        size_t pos = 0;
         for (auto i = 0; i < slice_num; ++i) {
             auto slice_i_sp = binarySet.Erase(prefix + "_" + std::to_string(i));
+            if (!slices.empty() &&
+                slice_i_sp->data.get() != slices.front()->data.get() + pos) {
+                contiguous = false;
+            }
+            pos += slice_i_sp->size;
+            slices.push_back(std::move(slice_i_sp));
+        }
+        // the slices of a binary sliced in this process are views of it
+        if (contiguous && pos == total_len) {
+            binarySet.Append(prefix, slices.front()->data, total_len);
+            continue;
+        }
+        auto p_data = std::shared_ptr<uint8_t[]>(new uint8_t[total_len]);
+        pos = 0;
+        for (auto& slice_i_sp : slices) {
             memcpy(p_data.get() + pos,
                    slice_i_sp->data.get(),
                    static_cast<size_t>(slice_i_sp->size));
@@ -123,4 +145,60 @@ EraseSliceMeta(BinarySet& binarySet) {
     return binarySet.Erase(INDEX_FILE_SLICE_META);
 }
 
+SliceAssembler::SliceAssembler(const BinaryPtr& slice_meta) {
+    Config meta_data = Config::parse(std::string(
+        reinterpret_cast<char*>(slice_meta->data.get()), slice_meta->size));
+    for (auto& item : meta_data[META]) {
+        Sliced binary;
+        binary.name = item[NAME];
+        binary.slice_num = item[SLICE_NUM];
+        binary.total_len = item[TOTAL_LEN];
+        binary.data =
+            std::shared_ptr<uint8_t[]>(new uint8_t[binary.total_len]);
+        for (int64_t i = 0; i < binary.slice_num; ++i) {
+            slices_[binary.name + "_" + std::to_string(i)] = {
+                binaries_.size(), i};
+        }
+        binaries_.push_back(std::move(binary));
+    }
+}
+
+bool
+SliceAssembler::Place(const std::string& key,
+                      const uint8_t* data,
+                      int64_t size) {
+    auto it = slices_.find(key);
+    if (it == slices_.end()) {
+        return false;
+    }
+    auto [binary_index, slice_index] = it->second;
+    auto& binary = binaries_[binary_index];
+    // every slice but the last is as long as the others, the last one ends
+    // the binary
+    int64_t offset = binary.total_len - size;
+    if (slice_index + 1 < binary.slice_num) {
+        AssertInfo(binary.slice_len == 0 || binary.slice_len == size,
+                   fmt::format("slices of {} have different sizes",
+                               binary.name));
+        binary.slice_len = size;
+        offset = slice_index * size;
+    }
+    AssertInfo(offset >= 0 && offset + size <= binary.total_len,
+               fmt::format("slice {} is out of its binary", key));
+    memcpy(binary.data.get() + offset, data, size);
+    binary.placed_len += size;
+    slices_.erase(it);
+    return true;
+}
+
+void
+SliceAssembler::Finish(BinarySet& binarySet) {
+    for (auto& binary : binaries_) {
+        AssertInfo(binary.placed_len == binary.total_len,
+                   fmt::format("slices of {} are missing", binary.name));
+        binarySet.Append(binary.name, binary.data, binary.total_len);
+    }
+    binaries_.clear();
+}
+
 }  // namespace milvus
@@ -16,10 +16,18 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "common/Types.h"
 
 namespace milvus {
 
+// the key of the binary describing how the others were sliced
+extern const char* INDEX_FILE_SLICE_META;
+
 void
 Assemble(BinarySet& binarySet);
 
@@ -32,4 +40,38 @@ AppendSliceMeta(BinarySet& binarySet, const Config& meta_info);
 BinaryPtr
 EraseSliceMeta(BinarySet& binarySet);
 
+// Assembles the binaries a slice meta describes while their slices are
+// loaded: every slice is copied to its place in one buffer of its binary
+// as it arrives and can be released right away, rather than all of them
+// being kept for Assemble to copy together. The slices may come in any
+// order.
+class SliceAssembler {
+ public:
+    explicit SliceAssembler(const BinaryPtr& slice_meta);
+
+    // false if the key isn't a slice of the meta
+    bool
+    Place(const std::string& key, const uint8_t* data, int64_t size);
+
+    // appends the assembled binaries to the set, all of their slices must
+    // have been placed
+    void
+    Finish(BinarySet& binarySet);
+
+ private:
+    struct Sliced {
+        std::string name;
+        int64_t slice_num = 0;
+        int64_t total_len = 0;
+        // the length of the slices but the last one
+        int64_t slice_len = 0;
+        int64_t placed_len = 0;
+        std::shared_ptr<uint8_t[]> data;
+    };
+
+    std::vector<Sliced> binaries_;
+    // the binary and the index of every slice not placed yet
+    std::unordered_map<std::string, std::pair<size_t, int64_t>> slices_;
+};
+
 }  // namespace milvus
@@ -0,0 +1,107 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace milvus {
+
+// Dictionary encoding of a low cardinality string column, the distinct
+// values in ascending order and the code of every row. Predicates are
+// evaluated once per distinct value and then looked up by code.
+class StringDictionary {
+ public:
+    using Code = uint32_t;
+
+    // nullptr if the rows have more than max_values distinct values
+    static std::unique_ptr<StringDictionary>
+    Build(const std::string_view* rows, int64_t row_count, int64_t max_values) {
+        std::unordered_map<std::string_view, Code> first_codes;
+        std::vector<Code> codes(row_count);
+        for (int64_t i = 0; i < row_count; ++i) {
+            auto [it, inserted] =
+                first_codes.try_emplace(rows[i], Code(first_codes.size()));
+            if (inserted && int64_t(first_codes.size()) > max_values) {
+                return nullptr;
+            }
+            codes[i] = it->second;
+        }
+
+        // renumber the codes in the order of the values, so a range of
+        // values is a range of codes
+        std::vector<std::string_view> distinct(first_codes.size());
+        for (auto& [value, code] : first_codes) {
+            distinct[code] = value;
+        }
+        std::vector<Code> order(distinct.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](Code a, Code b) {
+            return distinct[a] < distinct[b];
+        });
+        auto dictionary = std::unique_ptr<StringDictionary>(new StringDictionary);
+        std::vector<Code> remap(order.size());
+        dictionary->values_.reserve(order.size());
+        for (size_t rank = 0; rank < order.size(); ++rank) {
+            remap[order[rank]] = Code(rank);
+            dictionary->values_.emplace_back(distinct[order[rank]]);
+        }
+        for (auto& code : codes) {
+            code = remap[code];
+        }
+        dictionary->codes_ = std::move(codes);
+        return dictionary;
+    }
+
+    const std::vector<std::string>&
+    values() const {
+        return values_;
+    }
+
+    const Code*
+    codes() const {
+        return codes_.data();
+    }
+
+    int64_t
+    row_count() const {
+        return codes_.size();
+    }
+
+    size_t
+    memory_size() const {
+        size_t size = codes_.size() * sizeof(Code);
+        for (auto& value : values_) {
+            size += sizeof(std::string) + value.capacity();
+        }
+        return size;
+    }
+
+ private:
+    StringDictionary() = default;
+
+    std::vector<std::string> values_;
+    std::vector<Code> codes_;
+};
+
+}  // namespace milvus
@@ -84,4 +84,42 @@ StartSpan(std::string name, TraceContext* parentCtx) {
     return GetTracer()->StartSpan(name, opts);
 }
 
+bool
+IsSampled(const TraceContext* ctx) {
+    return ctx != nullptr && ctx->traceID != nullptr &&
+           ctx->spanID != nullptr && (ctx->flag & kTraceFlagSampled) != 0;
+}
+
+TraceScope::TraceScope(const char* name, TraceContext* ctx) {
+    if (!IsSampled(ctx)) {
+        return;
+    }
+    span_ = StartSpan(name, ctx);
+    previous_ = detail::active_span;
+    detail::active_span = span_.get();
+}
+
+TraceScope::~TraceScope() {
+    if (span_ == nullptr) {
+        return;
+    }
+    span_->End();
+    detail::active_span = previous_;
+}
+
+void
+AutoSpan::Start(const char* name) {
+    trace::StartSpanOptions opts;
+    opts.parent = detail::active_span->GetContext();
+    span_ = GetTracer()->StartSpan(name, opts);
+    previous_ = detail::active_span;
+    detail::active_span = span_.get();
+}
+
+void
+AutoSpan::End() {
+    span_->End();
+    detail::active_span = previous_;
+}
+
 }  // namespace milvus::tracer
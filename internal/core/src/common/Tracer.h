@@ -9,6 +9,9 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#pragma once
+
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -42,4 +45,95 @@ GetTracer();
 std::shared_ptr<trace::Span>
 StartSpan(std::string name, TraceContext* ctx = nullptr);
 
+// the sampled bit of TraceContext::flag, as in the W3C trace context
+constexpr uint8_t kTraceFlagSampled = 0x01;
+
+// the caller decided to sample the trace of `ctx`, segcore never samples
+// on its own: a search without a sampled parent records no span at all
+bool
+IsSampled(const TraceContext* ctx);
+
+namespace detail {
+// the span the AutoSpans of the thread nest in, null when not sampled
+inline thread_local trace::Span* active_span = nullptr;
+}  // namespace detail
+
+inline trace::Span*
+GetActiveSpan() {
+    return detail::active_span;
+}
+
+// Makes `span` the parent of the AutoSpans of the calling thread while it
+// lives, so a task carries the trace over to a worker by passing it
+// GetActiveSpan(). The span must outlive the scope.
+class ActiveSpanScope {
+ public:
+    explicit ActiveSpanScope(trace::Span* span)
+        : previous_(detail::active_span) {
+        detail::active_span = span;
+    }
+
+    ~ActiveSpanScope() {
+        detail::active_span = previous_;
+    }
+
+    ActiveSpanScope(const ActiveSpanScope&) = delete;
+    ActiveSpanScope&
+    operator=(const ActiveSpanScope&) = delete;
+
+ private:
+    trace::Span* previous_;
+};
+
+// The span of a request entering segcore, started only if `ctx` is sampled
+// and made the active span of the thread until it ends with the scope.
+class TraceScope {
+ public:
+    TraceScope(const char* name, TraceContext* ctx);
+
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope&
+    operator=(const TraceScope&) = delete;
+
+ private:
+    std::shared_ptr<trace::Span> span_;
+    trace::Span* previous_ = nullptr;
+};
+
+// A span around a phase of a request, the child of the active span of the
+// thread and the active span itself while it lives. When the request isn't
+// sampled it costs the test of a thread local and nothing else, so it is
+// cheap enough for the per segment phases of a search.
+class AutoSpan {
+ public:
+    explicit AutoSpan(const char* name) {
+        if (__builtin_expect(detail::active_span != nullptr, 0)) {
+            Start(name);
+        }
+    }
+
+    ~AutoSpan() {
+        if (__builtin_expect(span_ != nullptr, 0)) {
+            End();
+        }
+    }
+
+    AutoSpan(const AutoSpan&) = delete;
+    AutoSpan&
+    operator=(const AutoSpan&) = delete;
+
+ private:
+    void
+    Start(const char* name);
+
+    void
+    End();
+
+ private:
+    std::shared_ptr<trace::Span> span_;
+    trace::Span* previous_ = nullptr;
+};
+
 }  // namespace milvus::tracer
@@ -82,12 +82,29 @@ using VectorArray = proto::schema::VectorField;
 using IdArray = proto::schema::IDs;
 using InsertData = proto::segcore::InsertRecord;
 using PkType = std::variant<std::monostate, int64_t, std::string>;
+// group by key of a search hit, bool and integer keys are widened to int64
+using GroupByValueType = std::variant<std::monostate, int64_t, std::string>;
 
 inline bool
 IsPrimaryKeyDataType(DataType data_type) {
     return data_type == DataType::INT64 || data_type == DataType::VARCHAR;
 }
 
+inline bool
+IsGroupByDataType(DataType data_type) {
+    switch (data_type) {
+        case DataType::BOOL:
+        case DataType::INT8:
+        case DataType::INT16:
+        case DataType::INT32:
+        case DataType::INT64:
+        case DataType::VARCHAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
 // NOTE: dependent type
 // used at meta-template programming
 template <class...>
@@ -27,11 +27,13 @@
 #include "common/Consts.h"
 #include "common/FieldMeta.h"
 #include "common/LoadInfo.h"
+#include "common/Metrics.h"
 #include "common/Types.h"
 #include "config/ConfigChunkManager.h"
 #include "exceptions/EasyAssert.h"
 #include "knowhere/dataset.h"
 #include "knowhere/expected.h"
+#include "log/Log.h"
 #include "simdjson.h"
 
 namespace milvus {
@@ -366,100 +368,159 @@ WriteFieldData(int fd, DataType data_type, const DataArray* data, size_t size) {
     }
 }
 
-// CreateMap creates a memory mapping,
-// if mmap enabled, this writes field data to disk and create a map to the file,
-// otherwise this just alloc memory
-inline void*
-CreateMap(int64_t segment_id,
-          const FieldMeta& field_meta,
-          const LoadFieldDataInfo& info) {
-    static int mmap_flags = MAP_PRIVATE;
+// Vectors are scanned in full by brute force searches, so they're read
+// ahead and backed by huge pages. Mapped files of other fields are faulted
+// in on the first access, only the rows a query touches are read, and
+// variable length values, read by offset, skip the read ahead.
+inline MmapPolicy
+DefaultMmapPolicy(const FieldMeta& field_meta) {
+    MmapPolicy policy;
+    auto data_type = field_meta.get_data_type();
+    if (datatype_is_vector(data_type)) {
+        policy.hugepage = true;
+        policy.access = MmapPolicy::Access::Sequential;
+    } else {
+        policy.populate = false;
+        // row ids are only gathered at the offsets of retrieved rows
+        if (datatype_is_variable(data_type) ||
+            field_meta.get_id() == RowFieldID) {
+            policy.access = MmapPolicy::Access::Random;
+        }
+    }
+    return policy;
+}
+
+// the flags to mmap with, `anon` for a map of anonymous memory
+inline int
+MmapFlags(const MmapPolicy& policy, bool anon) {
+    int flags = MAP_PRIVATE;
+    if (anon) {
+        flags |= MAP_ANON;
+    }
 #ifdef MAP_POPULATE
-    // macOS doesn't support MAP_POPULATE
-    mmap_flags |= MAP_POPULATE;
+    // macOS doesn't support MAP_POPULATE; huge pages of an anonymous map
+    // are only faulted in after the madvise, so it's not populated as 4K
+    // pages before
+    if (policy.populate && !(anon && policy.hugepage)) {
+        flags |= MAP_POPULATE;
+    }
 #endif
+    return flags;
+}
 
-    // simdjson requires a padding following the json data
-    size_t padding = field_meta.get_data_type() == DataType::JSON
-                         ? simdjson::SIMDJSON_PADDING
-                         : 0;
-    // Allocate memory
-    if (info.mmap_dir_path == nullptr) {
-        auto data_type = field_meta.get_data_type();
-        auto data_size =
-            GetDataSize(field_meta, info.row_count, info.field_data);
-        if (data_size == 0)
-            return nullptr;
+// applies the rest of `policy` to a map of `size` bytes, before the map is
+// written if it's anonymous; the advice is a hint only, so failures are
+// ignored but the one of mlock, which is logged
+inline void
+AdviseMap(void* map, size_t size, const MmapPolicy& policy) {
+    if (map == nullptr || size == 0) {
+        return;
+    }
+#ifdef MADV_HUGEPAGE
+    if (policy.hugepage) {
+        madvise(map, size, MADV_HUGEPAGE);
+    }
+#endif
+    switch (policy.access) {
+        case MmapPolicy::Access::Sequential:
+            madvise(map, size, MADV_SEQUENTIAL);
+            break;
+        case MmapPolicy::Access::Random:
+            madvise(map, size, MADV_RANDOM);
+            break;
+        default:
+            break;
+    }
+    if (policy.lock && mlock(map, size) != 0) {
+        LOG_SEGCORE_WARNING_ << "failed to lock " << size
+                             << " bytes of map, err: " << strerror(errno);
+    }
+}
 
-        // Use anon mapping so we are able to free these memory with munmap only
-        void* map = mmap(nullptr,
-                         data_size + padding,
-                         PROT_READ | PROT_WRITE,
-                         mmap_flags | MAP_ANON,
-                         -1,
-                         0);
-        AssertInfo(
-            map != MAP_FAILED,
-            fmt::format("failed to create anon map, err: {}", strerror(errno)));
-        FillField(data_type, data_size, info, map);
-        return map;
+// faults in the pages of a file map, if MAP_POPULATE didn't
+inline void
+PopulateMap(void* map, size_t size, const MmapPolicy& policy) {
+#ifndef MAP_POPULATE
+    if (!policy.populate) {
+        return;
     }
+    // Manually access the mapping to populate it
+    const size_t page_size = getpagesize();
+    char* begin = (char*)map;
+    char* end = begin + size;
+    for (char* page = begin; page < end; page += page_size) {
+        char value = page[0];
+    }
+#endif
+}
 
-    auto filepath = std::filesystem::path(info.mmap_dir_path) /
-                    std::to_string(segment_id) / std::to_string(info.field_id);
-    auto dir = filepath.parent_path();
-    std::filesystem::create_directories(dir);
+// maps `size` bytes of anonymous memory, which `fill(map)` writes the field
+// to; anon mapping is used so we are able to free the memory with munmap only
+template <typename Fill>
+inline void*
+CreateAnonMap(size_t size, const MmapPolicy& policy, Fill&& fill) {
+    void* map = mmap(nullptr,
+                     size,
+                     PROT_READ | PROT_WRITE,
+                     MmapFlags(policy, true),
+                     -1,
+                     0);
+    AssertInfo(
+        map != MAP_FAILED,
+        fmt::format("failed to create anon map, err: {}", strerror(errno)));
+    AdviseMap(map, size, policy);
+    fill(map);
+    return map;
+}
 
+// writes a field to the file at `filepath` with `write(fd)`, which returns
+// the bytes written, and maps the file followed by `padding` bytes; the
+// file is unlinked once mapped, so it's removed after we don't need it
+// again, unless `keep_file`
+template <typename Write>
+inline void*
+CreateFileMap(const std::filesystem::path& filepath,
+              size_t padding,
+              const MmapPolicy& policy,
+              bool keep_file,
+              Write&& write) {
+    std::filesystem::create_directories(filepath.parent_path());
     int fd =
         open(filepath.c_str(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR);
     AssertInfo(fd != -1,
                fmt::format("failed to create mmap file {}", filepath.c_str()));
 
-    auto data_type = field_meta.get_data_type();
-    size_t size = field_meta.get_sizeof() * info.row_count;
-    auto written = WriteFieldData(fd, data_type, info.field_data, size);
-    AssertInfo(
-        written == size ||
-            written != -1 && datatype_is_variable(field_meta.get_data_type()),
-        fmt::format(
-            "failed to write data file {}, written {} but total {}, err: {}",
-            filepath.c_str(),
-            written,
-            size,
-            strerror(errno)));
+    size_t written = write(fd);
     int ok = fsync(fd);
     AssertInfo(ok == 0,
                fmt::format("failed to fsync mmap data file {}, err: {}",
                            filepath.c_str(),
                            strerror(errno)));
 
+    void* map = nullptr;
     // Empty field
-    if (written == 0) {
-        return nullptr;
+    if (written > 0) {
+        map = mmap(nullptr,
+                   written + padding,
+                   PROT_READ,
+                   MmapFlags(policy, false),
+                   fd,
+                   0);
+        AssertInfo(map != MAP_FAILED,
+                   fmt::format("failed to create map for data file {}, err: {}",
+                               filepath.c_str(),
+                               strerror(errno)));
+        monitor::mmap_file_bytes.Inc(written);
+        AdviseMap(map, written + padding, policy);
+        PopulateMap(map, written, policy);
     }
-
-    auto map = mmap(nullptr, written + padding, PROT_READ, mmap_flags, fd, 0);
-    AssertInfo(map != MAP_FAILED,
-               fmt::format("failed to create map for data file {}, err: {}",
-                           filepath.c_str(),
-                           strerror(errno)));
-
-#ifndef MAP_POPULATE
-    // Manually access the mapping to populate it
-    const size_t page_size = getpagesize();
-    char* begin = (char*)map;
-    char* end = begin + written;
-    for (char* page = begin; page < end; page += page_size) {
-        char value = page[0];
+    if (!keep_file || map == nullptr) {
+        ok = unlink(filepath.c_str());
+        AssertInfo(ok == 0,
+                   fmt::format("failed to unlink mmap data file {}, err: {}",
+                               filepath.c_str(),
+                               strerror(errno)));
     }
-#endif
-    // unlink this data file so
-    // then it will be auto removed after we don't need it again
-    ok = unlink(filepath.c_str());
-    AssertInfo(ok == 0,
-               fmt::format("failed to unlink mmap data file {}, err: {}",
-                           filepath.c_str(),
-                           strerror(errno)));
     ok = close(fd);
     AssertInfo(ok == 0,
                fmt::format("failed to close data file {}, err: {}",
@@ -468,4 +529,47 @@ CreateMap(int64_t segment_id,
     return map;
 }
 
+// CreateMap creates a memory mapping,
+// if mmap enabled, this writes field data to disk and create a map to the file,
+// otherwise this just alloc memory
+inline void*
+CreateMap(int64_t segment_id,
+          const FieldMeta& field_meta,
+          const LoadFieldDataInfo& info) {
+    auto policy = info.mmap_policy.value_or(DefaultMmapPolicy(field_meta));
+    auto data_type = field_meta.get_data_type();
+
+    // simdjson requires a padding following the json data
+    size_t padding =
+        data_type == DataType::JSON ? simdjson::SIMDJSON_PADDING : 0;
+    // Allocate memory
+    if (info.mmap_dir_path == nullptr) {
+        auto data_size =
+            GetDataSize(field_meta, info.row_count, info.field_data);
+        if (data_size == 0)
+            return nullptr;
+
+        return CreateAnonMap(data_size + padding, policy, [&](void* map) {
+            FillField(data_type, data_size, info, map);
+        });
+    }
+
+    auto filepath = std::filesystem::path(info.mmap_dir_path) /
+                    std::to_string(segment_id) / std::to_string(info.field_id);
+    return CreateFileMap(filepath, padding, policy, false, [&](int fd) {
+        size_t size = field_meta.get_sizeof() * info.row_count;
+        auto written = WriteFieldData(fd, data_type, info.field_data, size);
+        AssertInfo(
+            written == size ||
+                written != -1 && datatype_is_variable(data_type),
+            fmt::format("failed to write data file {}, written {} but total "
+                        "{}, err: {}",
+                        filepath.c_str(),
+                        written,
+                        size,
+                        strerror(errno)));
+        return written;
+    });
+}
+
 }  // namespace milvus
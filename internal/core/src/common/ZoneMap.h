@@ -0,0 +1,197 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "common/Types.h"
+
+namespace milvus {
+
+// how the values of a chunk may match a predicate
+enum class ZoneMatch {
+    None,
+    Some,
+    All,
+};
+
+template <typename T>
+constexpr bool IsZoneMapSupported =
+    (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) ||
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+// integers are widened to int64_t, floating points to double, so a chunk of
+// any numeric field can be checked against a value of the field type
+template <typename T>
+using ZoneValueType = std::conditional_t<
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>,
+    std::string,
+    std::conditional_t<std::is_floating_point_v<T>, double, int64_t>>;
+
+// min/max statistics of the values of one chunk
+template <typename ValueType>
+class ZoneMap {
+ public:
+    bool
+    empty() const {
+        return empty_;
+    }
+
+    const ValueType&
+    min() const {
+        return min_;
+    }
+
+    const ValueType&
+    max() const {
+        return max_;
+    }
+
+    template <typename U>
+    void
+    Update(const U* data, int64_t size) {
+        for (int64_t i = 0; i < size; ++i) {
+            if constexpr (std::is_floating_point_v<U>) {
+                // NaN matches no comparison, a chunk holding one can never
+                // be considered as matching all
+                if (std::isnan(data[i])) {
+                    has_nan_ = true;
+                    continue;
+                }
+            }
+            ValueType value(data[i]);
+            if (empty_) {
+                min_ = value;
+                max_ = std::move(value);
+                empty_ = false;
+            } else if (value < min_) {
+                min_ = std::move(value);
+            } else if (max_ < value) {
+                max_ = std::move(value);
+            }
+        }
+    }
+
+    template <typename U>
+    ZoneMatch
+    MatchUnaryRange(OpType op, const U& raw_val) const {
+        if (empty_) {
+            return has_nan_ && op == OpType::NotEqual ? ZoneMatch::All
+                                                      : ZoneMatch::Some;
+        }
+        ValueType val(raw_val);
+        if (IsNan(val)) {
+            return ZoneMatch::Some;
+        }
+        switch (op) {
+            case OpType::Equal:
+                if (val < min_ || max_ < val) {
+                    return ZoneMatch::None;
+                }
+                return Bounded(min_ == max_);
+            case OpType::NotEqual:
+                if (min_ == max_ && min_ == val && !has_nan_) {
+                    return ZoneMatch::None;
+                }
+                return val < min_ || max_ < val ? ZoneMatch::All
+                                                : ZoneMatch::Some;
+            case OpType::GreaterThan:
+                if (max_ <= val) {
+                    return ZoneMatch::None;
+                }
+                return Bounded(val < min_);
+            case OpType::GreaterEqual:
+                if (max_ < val) {
+                    return ZoneMatch::None;
+                }
+                return Bounded(val <= min_);
+            case OpType::LessThan:
+                if (val <= min_) {
+                    return ZoneMatch::None;
+                }
+                return Bounded(max_ < val);
+            case OpType::LessEqual:
+                if (val < min_) {
+                    return ZoneMatch::None;
+                }
+                return Bounded(max_ <= val);
+            default:
+                return ZoneMatch::Some;
+        }
+    }
+
+    template <typename U>
+    ZoneMatch
+    MatchBinaryRange(const U& raw_lower,
+                     bool lower_inclusive,
+                     const U& raw_upper,
+                     bool upper_inclusive) const {
+        if (empty_) {
+            return ZoneMatch::Some;
+        }
+        ValueType lower(raw_lower);
+        ValueType upper(raw_upper);
+        if (IsNan(lower) || IsNan(upper)) {
+            return ZoneMatch::Some;
+        }
+        if ((lower_inclusive ? max_ < lower : max_ <= lower) ||
+            (upper_inclusive ? upper < min_ : upper <= min_)) {
+            return ZoneMatch::None;
+        }
+        return Bounded((lower_inclusive ? lower <= min_ : lower < min_) &&
+                       (upper_inclusive ? max_ <= upper : max_ < upper));
+    }
+
+ private:
+    static bool
+    IsNan(const ValueType& value) {
+        if constexpr (std::is_floating_point_v<ValueType>) {
+            return std::isnan(value);
+        }
+        return false;
+    }
+
+    // every value which is not NaN matches when `all` holds
+    ZoneMatch
+    Bounded(bool all) const {
+        return all && !has_nan_ ? ZoneMatch::All : ZoneMatch::Some;
+    }
+
+ private:
+    bool empty_ = true;
+    bool has_nan_ = false;
+    ValueType min_{};
+    ValueType max_{};
+};
+
+template <typename T>
+using ZoneMapOf = ZoneMap<ZoneValueType<T>>;
+
+// zone map of a chunk of any supported type, monostate if there is none
+using AnyZoneMap = std::variant<std::monostate,
+                                ZoneMap<int64_t>,
+                                ZoneMap<double>,
+                                ZoneMap<std::string>>;
+
+}  // namespace milvus
@@ -50,7 +50,7 @@ AppendIndexBinary(CBinarySet c_binary_set,
         auto binary_set = (knowhere::BinarySet*)c_binary_set;
         std::string index_key(c_index_key);
         uint8_t* index = (uint8_t*)index_binary;
-        uint8_t* dup = new uint8_t[index_size]();
+        uint8_t* dup = new uint8_t[index_size];
         memcpy(dup, index, index_size);
         std::shared_ptr<uint8_t[]> data(dup);
         binary_set->Append(index_key, data, index_size);
@@ -26,7 +26,7 @@
 #include "common/Tracer.h"
 #include "log/Log.h"
 
-std::once_flag flag1, flag2, flag3, flag4;
+std::once_flag flag1, flag2, flag3, flag4, flag5, flag6, flag7;
 std::once_flag traceFlag;
 
 void
@@ -60,6 +60,36 @@ InitCpuNum(const int value) {
         flag4, [](int value) { milvus::SetCpuNum(value); }, value);
 }
 
+void
+InitIndexBuildParallelism(const int64_t value) {
+    std::call_once(
+        flag5,
+        [](int64_t value) { milvus::SetIndexBuildParallelism(value); },
+        value);
+}
+
+void
+InitReverseLookupCacheFactor(const int64_t value) {
+    std::call_once(
+        flag7,
+        [](int64_t value) { milvus::SetReverseLookupCacheFactor(value); },
+        value);
+}
+
+void
+InitRemoteConnections(const int64_t max_connections,
+                      const int64_t keep_alive_ms) {
+    std::call_once(
+        flag6,
+        [](int64_t max_connections, int64_t keep_alive_ms) {
+            milvus::ChunkMangerConfig::SetRemoteMaxConnections(
+                max_connections);
+            milvus::ChunkMangerConfig::SetRemoteKeepAliveMs(keep_alive_ms);
+        },
+        max_connections,
+        keep_alive_ms);
+}
+
 void
 InitTrace(CTraceConfig* config) {
     auto traceConfig = milvus::tracer::TraceConfig{config->exporter,
@@ -33,9 +33,24 @@ InitThreadCoreCoefficient(const int64_t);
 void
 InitCpuNum(const int);
 
+// 0 builds scalar indexes with as many tasks as cpus
+void
+InitIndexBuildParallelism(const int64_t);
+
+// scalar indexes decode all their rows for output fields once they were
+// looked up this many times their rows, 0 never
+void
+InitReverseLookupCacheFactor(const int64_t);
+
 void
 InitLocalRootPath(const char*);
 
+// the connections of every remote storage client, and the interval of their
+// keep alive probes, 0 disables them
+void
+InitRemoteConnections(const int64_t max_connections,
+                      const int64_t keep_alive_ms);
+
 void
 InitTrace(CTraceConfig* config);
 
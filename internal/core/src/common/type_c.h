@@ -35,6 +35,8 @@ enum ErrorCode {
     Success = 0,
     UnexpectedError = 1,
     IllegalArgument = 5,
+    // a search or retrieve stopped by its CCancellationToken
+    QueryCancelled = 2000,
 };
 
 // pure C don't support that we use schemapb.DataType directly.
@@ -79,6 +81,47 @@ typedef struct CLoadFieldDataInfo {
     const char* mmap_dir_path;
 } CLoadFieldDataInfo;
 
+// the serialized binlogs of a field, owned by the caller
+typedef struct CFieldBinlogs {
+    int64_t field_id;
+    int64_t row_count;
+    const uint8_t* const* binlogs;
+    const int64_t* binlog_sizes;
+    int64_t num_binlogs;
+} CFieldBinlogs;
+
+// a field of a sealed segment to load, from its binlog and index metadata
+typedef struct CFieldLoadResource {
+    int64_t field_id;
+    int64_t row_count;
+    int64_t binlog_bytes;
+    // the memory size of the binlogs, estimated if 0
+    int64_t raw_bytes;
+    bool mmap;
+    // null or empty without an index
+    const char* index_type;
+    int64_t index_bytes;
+    bool index_mmap;
+} CFieldLoadResource;
+
+// the bytes of memory and local disk a load takes at its peak and after it
+typedef struct CLoadResource {
+    int64_t peak_memory_bytes;
+    int64_t steady_memory_bytes;
+    int64_t peak_disk_bytes;
+    int64_t steady_disk_bytes;
+} CLoadResource;
+
+// the binlog a field of a growing segment was flushed to
+typedef struct CFlushedBinlog {
+    int64_t field_id;
+    int64_t rows;
+    int64_t log_size;
+    int64_t memory_size;
+    uint64_t timestamp_from;
+    uint64_t timestamp_to;
+} CFlushedBinlog;
+
 typedef struct CLoadDeletedRecordInfo {
     void* timestamps;
     const uint8_t* primary_keys;
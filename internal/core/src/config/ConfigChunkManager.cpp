@@ -19,6 +19,8 @@
 namespace milvus::ChunkMangerConfig {
 
 std::string LOCAL_ROOT_PATH = "/tmp/milvus";  // NOLINT
+int64_t REMOTE_MAX_CONNECTIONS = 100;
+int64_t REMOTE_KEEP_ALIVE_MS = 30000;
 
 void
 SetLocalRootPath(const std::string_view path_prefix) {
@@ -30,4 +32,24 @@ GetLocalRootPath() {
     return LOCAL_ROOT_PATH;
 }
 
+void
+SetRemoteMaxConnections(const int64_t max_connections) {
+    REMOTE_MAX_CONNECTIONS = max_connections;
+}
+
+int64_t
+GetRemoteMaxConnections() {
+    return REMOTE_MAX_CONNECTIONS;
+}
+
+void
+SetRemoteKeepAliveMs(const int64_t keep_alive_ms) {
+    REMOTE_KEEP_ALIVE_MS = keep_alive_ms;
+}
+
+int64_t
+GetRemoteKeepAliveMs() {
+    return REMOTE_KEEP_ALIVE_MS;
+}
+
 }  // namespace milvus::ChunkMangerConfig
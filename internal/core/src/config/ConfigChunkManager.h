@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace milvus::ChunkMangerConfig {
@@ -26,4 +27,19 @@ SetLocalRootPath(const std::string_view path_prefix);
 std::string
 GetLocalRootPath();
 
+// the connection pool size of every remote storage client
+void
+SetRemoteMaxConnections(const int64_t max_connections);
+
+int64_t
+GetRemoteMaxConnections();
+
+// the interval of the tcp keep alive probes of remote storage connections,
+// 0 disables them
+void
+SetRemoteKeepAliveMs(const int64_t keep_alive_ms);
+
+int64_t
+GetRemoteKeepAliveMs();
+
 }  // namespace milvus::ChunkMangerConfig
@@ -0,0 +1,449 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/Slice.h"
+#include "index/Meta.h"
+
+namespace milvus::index {
+
+// below format will be persistent, bump the version on any change
+constexpr uint32_t BITMAP_INDEX_FORMAT_VERSION = 1;
+
+struct BitmapIndexMeta {
+    uint32_t version;
+    uint32_t cardinality;
+    uint64_t num_rows;
+};
+
+template <typename T>
+inline void
+BitmapIndex<T>::Build(const size_t n, const T* values) {
+    if (is_built_) {
+        return;
+    }
+    AssertInfo(n > 0, "BitmapIndex cannot build null values!");
+    AssertInfo(n <= std::numeric_limits<uint32_t>::max(),
+               "too many rows for a bitmap index: " + std::to_string(n));
+    values_.clear();
+    for (size_t i = 0; i < n; ++i) {
+        auto it = std::lower_bound(values_.begin(), values_.end(), values[i]);
+        if (it != values_.end() && *it == values[i]) {
+            continue;
+        }
+        AssertInfo(int64_t(values_.size()) < BITMAP_INDEX_MAX_CARDINALITY,
+                   "a bitmap index holds at most " +
+                       std::to_string(BITMAP_INDEX_MAX_CARDINALITY) +
+                       " distinct values");
+        values_.insert(it, values[i]);
+    }
+
+    num_rows_ = n;
+    codes_.resize(n);
+    std::vector<int64_t> counts(values_.size());
+    for (size_t i = 0; i < n; ++i) {
+        auto code =
+            std::lower_bound(values_.begin(), values_.end(), values[i]) -
+            values_.begin();
+        codes_[i] = uint8_t(code);
+        ++counts[code];
+    }
+    BuildPostings(counts);
+    is_built_ = true;
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::BuildPostings(const std::vector<int64_t>& counts) {
+    postings_.clear();
+    postings_.resize(counts.size());
+    for (size_t code = 0; code < counts.size(); ++code) {
+        auto& posting = postings_[code];
+        posting.count = counts[code];
+        // a row id takes 32 bits, a bitmap one bit of every row
+        posting.dense = posting.count * 32 > num_rows_;
+        if (posting.dense) {
+            posting.bits.resize(num_rows_);
+        } else {
+            posting.ids.reserve(posting.count);
+        }
+    }
+    for (int64_t i = 0; i < num_rows_; ++i) {
+        auto& posting = postings_[codes_[i]];
+        if (posting.dense) {
+            posting.bits.set(i);
+        } else {
+            posting.ids.push_back(uint32_t(i));
+        }
+    }
+}
+
+template <typename T>
+inline BinarySet
+BitmapIndex<T>::Serialize(const Config& config) {
+    AssertInfo(is_built_, "index has not been built");
+
+    BitmapIndexMeta meta{BITMAP_INDEX_FORMAT_VERSION,
+                         uint32_t(values_.size()),
+                         uint64_t(num_rows_)};
+    std::shared_ptr<uint8_t[]> meta_data(new uint8_t[sizeof(meta)]);
+    memcpy(meta_data.get(), &meta, sizeof(meta));
+
+    // the sorted values, then each posting as its kind, its row count and
+    // the row ids or the bitmap words
+    using Block = BitsetType::block_type;
+    auto num_blocks = (size_t(num_rows_) + BitsetType::bits_per_block - 1) /
+                      BitsetType::bits_per_block;
+    size_t data_size = values_.size() * sizeof(T);
+    for (auto& posting : postings_) {
+        data_size += sizeof(uint8_t) + sizeof(int64_t);
+        data_size += posting.dense ? num_blocks * sizeof(Block)
+                                   : posting.ids.size() * sizeof(uint32_t);
+    }
+    std::shared_ptr<uint8_t[]> data(new uint8_t[data_size]);
+    auto ptr = data.get();
+    memcpy(ptr, values_.data(), values_.size() * sizeof(T));
+    ptr += values_.size() * sizeof(T);
+    std::vector<Block> blocks;
+    for (auto& posting : postings_) {
+        *ptr = uint8_t(posting.dense);
+        ptr += sizeof(uint8_t);
+        memcpy(ptr, &posting.count, sizeof(int64_t));
+        ptr += sizeof(int64_t);
+        if (posting.dense) {
+            blocks.clear();
+            boost::to_block_range(posting.bits, std::back_inserter(blocks));
+            memcpy(ptr, blocks.data(), num_blocks * sizeof(Block));
+            ptr += num_blocks * sizeof(Block);
+        } else {
+            auto ids_size = posting.ids.size() * sizeof(uint32_t);
+            memcpy(ptr, posting.ids.data(), ids_size);
+            ptr += ids_size;
+        }
+    }
+
+    BinarySet res_set;
+    res_set.Append(BITMAP_INDEX_META, meta_data, sizeof(meta));
+    res_set.Append(BITMAP_INDEX_DATA, data, data_size);
+    milvus::Disassemble(res_set);
+    return res_set;
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::Load(const BinarySet& index_binary, const Config& config) {
+    milvus::Assemble(const_cast<BinarySet&>(index_binary));
+    auto meta_data = index_binary.GetByName(BITMAP_INDEX_META);
+    AssertInfo(meta_data != nullptr &&
+                   size_t(meta_data->size) >= sizeof(BitmapIndexMeta),
+               "bitmap index meta is missing");
+    BitmapIndexMeta meta;
+    memcpy(&meta, meta_data->data.get(), sizeof(meta));
+    AssertInfo(meta.version == BITMAP_INDEX_FORMAT_VERSION,
+               "unsupported bitmap index version: " +
+                   std::to_string(meta.version));
+
+    using Block = BitsetType::block_type;
+    auto index_data = index_binary.GetByName(BITMAP_INDEX_DATA);
+    auto ptr = index_data->data.get();
+    auto end = ptr + index_data->size;
+    auto read = [&](void* dst, size_t size) {
+        AssertInfo(size_t(end - ptr) >= size, "bitmap index data is truncated");
+        memcpy(dst, ptr, size);
+        ptr += size;
+    };
+
+    num_rows_ = int64_t(meta.num_rows);
+    auto num_blocks = (size_t(num_rows_) + BitsetType::bits_per_block - 1) /
+                      BitsetType::bits_per_block;
+    values_.resize(meta.cardinality);
+    read(values_.data(), values_.size() * sizeof(T));
+    postings_.clear();
+    postings_.resize(meta.cardinality);
+    codes_.resize(num_rows_);
+    std::vector<Block> blocks(num_blocks);
+    for (size_t code = 0; code < postings_.size(); ++code) {
+        auto& posting = postings_[code];
+        uint8_t dense;
+        read(&dense, sizeof(uint8_t));
+        read(&posting.count, sizeof(int64_t));
+        posting.dense = dense != 0;
+        if (posting.dense) {
+            read(blocks.data(), num_blocks * sizeof(Block));
+            posting.bits.resize(num_rows_);
+            boost::from_block_range(blocks.begin(), blocks.end(), posting.bits);
+            for (auto pos = posting.bits.find_first(); pos != BitsetType::npos;
+                 pos = posting.bits.find_next(pos)) {
+                codes_[pos] = uint8_t(code);
+            }
+        } else {
+            posting.ids.resize(posting.count);
+            read(posting.ids.data(), posting.ids.size() * sizeof(uint32_t));
+            for (auto id : posting.ids) {
+                AssertInfo(id < num_rows_, "bitmap index row id out of range");
+                codes_[id] = uint8_t(code);
+            }
+        }
+    }
+    is_built_ = true;
+}
+
+template <typename T>
+inline auto
+BitmapIndex<T>::ValueBounds(const T value, const OpType op) const
+    -> std::pair<size_t, size_t> {
+    auto lower = [&]() -> size_t {
+        return std::lower_bound(values_.begin(), values_.end(), value) -
+               values_.begin();
+    };
+    auto upper = [&]() -> size_t {
+        return std::upper_bound(values_.begin(), values_.end(), value) -
+               values_.begin();
+    };
+    switch (op) {
+        case OpType::LessThan:
+            return {0, lower()};
+        case OpType::LessEqual:
+            return {0, upper()};
+        case OpType::GreaterThan:
+            return {upper(), values_.size()};
+        case OpType::GreaterEqual:
+            return {lower(), values_.size()};
+        default:
+            throw std::invalid_argument(std::string("Invalid OperatorType: ") +
+                                        std::to_string((int)op) + "!");
+    }
+}
+
+template <typename T>
+inline auto
+BitmapIndex<T>::ValueBounds(T lower_bound_value,
+                            bool lb_inclusive,
+                            T upper_bound_value,
+                            bool ub_inclusive) const
+    -> std::pair<size_t, size_t> {
+    if (lower_bound_value > upper_bound_value ||
+        (lower_bound_value == upper_bound_value &&
+         !(lb_inclusive && ub_inclusive))) {
+        return {0, 0};
+    }
+    auto lb = ValueBounds(lower_bound_value,
+                          lb_inclusive ? OpType::GreaterEqual
+                                       : OpType::GreaterThan)
+                  .first;
+    auto ub = ValueBounds(upper_bound_value,
+                          ub_inclusive ? OpType::LessEqual : OpType::LessThan)
+                  .second;
+    return {lb, std::max(lb, ub)};
+}
+
+template <typename T>
+inline std::vector<size_t>
+BitmapIndex<T>::ValueCodes(const size_t n, const T* values) const {
+    std::vector<size_t> codes;
+    for (size_t i = 0; i < n; ++i) {
+        auto it = std::lower_bound(values_.begin(), values_.end(), values[i]);
+        if (it != values_.end() && *it == values[i]) {
+            codes.push_back(it - values_.begin());
+        }
+    }
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    return codes;
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::UnionPosting(size_t code, BitsetType& bitset) const {
+    auto& posting = postings_[code];
+    if (posting.dense) {
+        bitset |= posting.bits;
+        return;
+    }
+    for (auto id : posting.ids) {
+        bitset.set(id);
+    }
+}
+
+template <typename T>
+inline BitsetType
+BitmapIndex<T>::UnionRange(size_t begin, size_t end) const {
+    BitsetType bitset(num_rows_);
+    int64_t count = 0;
+    for (auto code = begin; code < end; ++code) {
+        count += postings_[code].count;
+    }
+    if (count * 2 <= num_rows_) {
+        for (auto code = begin; code < end; ++code) {
+            UnionPosting(code, bitset);
+        }
+        return bitset;
+    }
+    for (size_t code = 0; code < begin; ++code) {
+        UnionPosting(code, bitset);
+    }
+    for (auto code = end; code < postings_.size(); ++code) {
+        UnionPosting(code, bitset);
+    }
+    bitset.flip();
+    return bitset;
+}
+
+template <typename T>
+inline const TargetBitmap
+BitmapIndex<T>::In(const size_t n, const T* values) {
+    return UnpackTargetBitmap(InBits(n, values));
+}
+
+template <typename T>
+inline const TargetBitmap
+BitmapIndex<T>::NotIn(const size_t n, const T* values) {
+    return UnpackTargetBitmap(NotInBits(n, values));
+}
+
+template <typename T>
+inline const TargetBitmap
+BitmapIndex<T>::Range(const T value, const OpType op) {
+    return UnpackTargetBitmap(RangeBits(value, op));
+}
+
+template <typename T>
+inline const TargetBitmap
+BitmapIndex<T>::Range(T lower_bound_value,
+                      bool lb_inclusive,
+                      T upper_bound_value,
+                      bool ub_inclusive) {
+    return UnpackTargetBitmap(RangeBits(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive));
+}
+
+template <typename T>
+inline BitsetType
+BitmapIndex<T>::InBits(const size_t n, const T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    BitsetType bitset(num_rows_);
+    for (auto code : ValueCodes(n, values)) {
+        UnionPosting(code, bitset);
+    }
+    return bitset;
+}
+
+template <typename T>
+inline BitsetType
+BitmapIndex<T>::NotInBits(const size_t n, const T* values) {
+    auto bitset = InBits(n, values);
+    bitset.flip();
+    return bitset;
+}
+
+template <typename T>
+inline BitsetType
+BitmapIndex<T>::RangeBits(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [begin, end] = ValueBounds(value, op);
+    return UnionRange(begin, end);
+}
+
+template <typename T>
+inline BitsetType
+BitmapIndex<T>::RangeBits(T lower_bound_value,
+                          bool lb_inclusive,
+                          T upper_bound_value,
+                          bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [begin, end] = ValueBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    return UnionRange(begin, end);
+}
+
+template <typename T>
+inline int64_t
+BitmapIndex<T>::CountIn(const size_t n, const T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    int64_t count = 0;
+    for (auto code : ValueCodes(n, values)) {
+        count += postings_[code].count;
+    }
+    return count;
+}
+
+template <typename T>
+inline int64_t
+BitmapIndex<T>::CountRange(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [begin, end] = ValueBounds(value, op);
+    int64_t count = 0;
+    for (auto code = begin; code < end; ++code) {
+        count += postings_[code].count;
+    }
+    return count;
+}
+
+template <typename T>
+inline int64_t
+BitmapIndex<T>::CountRange(T lower_bound_value,
+                           bool lb_inclusive,
+                           T upper_bound_value,
+                           bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [begin, end] = ValueBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    int64_t count = 0;
+    for (auto code = begin; code < end; ++code) {
+        count += postings_[code].count;
+    }
+    return count;
+}
+
+template <typename T>
+inline T
+BitmapIndex<T>::Reverse_Lookup(size_t offset) const {
+    AssertInfo(offset < codes_.size(), "out of range of total count");
+    AssertInfo(is_built_, "index has not been built");
+    return values_[codes_[offset]];
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::ReverseLookupAll(T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    for (size_t i = 0; i < codes_.size(); ++i) {
+        values[i] = values_[codes_[i]];
+    }
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::ReverseLookupBatch(const int64_t* offsets,
+                                   int64_t n,
+                                   T* values) const {
+    AssertInfo(is_built_, "index has not been built");
+    for (int64_t i = 0; i < n; ++i) {
+        AssertInfo(offsets[i] >= 0 && size_t(offsets[i]) < codes_.size(),
+                   "out of range of total count");
+        values[i] = values_[codes_[offsets[i]]];
+    }
+}
+
+}  // namespace milvus::index
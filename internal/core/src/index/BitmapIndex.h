@@ -0,0 +1,205 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "common/Consts.h"
+#include "index/ScalarIndex.h"
+
+namespace milvus::index {
+
+// Index of a low-cardinality field, one posting of rows per distinct value.
+// A posting is a sorted array of row ids, or a bitmap over all rows once
+// that is smaller, so predicates are unions of a few postings.
+template <typename T>
+class BitmapIndex : public ScalarIndex<T> {
+ public:
+    BitmapIndex() = default;
+
+    BinarySet
+    Serialize(const Config& config) override;
+
+    void
+    Load(const BinarySet& index_binary, const Config& config = {}) override;
+
+    int64_t
+    Count() override {
+        return num_rows_;
+    }
+
+    void
+    Build(size_t n, const T* values) override;
+
+    const TargetBitmap
+    In(size_t n, const T* values) override;
+
+    const TargetBitmap
+    NotIn(size_t n, const T* values) override;
+
+    const TargetBitmap
+    Range(T value, OpType op) override;
+
+    const TargetBitmap
+    Range(T lower_bound_value,
+          bool lb_inclusive,
+          T upper_bound_value,
+          bool ub_inclusive) override;
+
+    BitsetType
+    InBits(size_t n, const T* values) override;
+
+    BitsetType
+    NotInBits(size_t n, const T* values) override;
+
+    BitsetType
+    RangeBits(T value, OpType op) override;
+
+    BitsetType
+    RangeBits(T lower_bound_value,
+              bool lb_inclusive,
+              T upper_bound_value,
+              bool ub_inclusive) override;
+
+    int64_t
+    CountIn(size_t n, const T* values) override;
+
+    int64_t
+    CountRange(T value, OpType op) override;
+
+    int64_t
+    CountRange(T lower_bound_value,
+               bool lb_inclusive,
+               T upper_bound_value,
+               bool ub_inclusive) override;
+
+    T
+    Reverse_Lookup(size_t offset) const override;
+
+    void
+    ReverseLookupAll(T* values) override;
+
+    int64_t
+    Size() override {
+        return num_rows_;
+    }
+
+    int64_t
+    ByteSize() override {
+        int64_t bytes = values_.capacity() * sizeof(T) + codes_.capacity();
+        for (auto& posting : postings_) {
+            bytes += sizeof(Posting) +
+                     posting.ids.capacity() * sizeof(uint32_t) +
+                     posting.bits.size() / 8;
+        }
+        return bytes;
+    }
+
+ public:
+    size_t
+    Cardinality() const {
+        return values_.size();
+    }
+
+    bool
+    IsBuilt() const {
+        return is_built_;
+    }
+
+ protected:
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       int64_t n,
+                       T* values) const override;
+
+ private:
+    struct Posting {
+        int64_t count = 0;
+        bool dense = false;
+        std::vector<uint32_t> ids;  // if !dense
+        BitsetType bits;            // if dense
+    };
+
+    // [begin, end) of the codes of values_ the range matches
+    std::pair<size_t, size_t>
+    ValueBounds(T value, OpType op) const;
+
+    std::pair<size_t, size_t>
+    ValueBounds(T lower_bound_value,
+                bool lb_inclusive,
+                T upper_bound_value,
+                bool ub_inclusive) const;
+
+    // distinct codes of the values which are in values_
+    std::vector<size_t>
+    ValueCodes(size_t n, const T* values) const;
+
+    void
+    UnionPosting(size_t code, BitsetType& bitset) const;
+
+    // union of the postings in [begin, end), a wide range is written as the
+    // complement of the rest
+    BitsetType
+    UnionRange(size_t begin, size_t end) const;
+
+    // fill the postings from codes_ and the row count of each value
+    void
+    BuildPostings(const std::vector<int64_t>& counts);
+
+ private:
+    bool is_built_ = false;
+    int64_t num_rows_ = 0;
+    FixedVector<T> values_;          // sorted distinct values
+    std::vector<Posting> postings_;  // posting of each value
+    std::vector<uint8_t> codes_;     // value code of each row
+};
+
+template <typename T>
+using BitmapIndexPtr = std::unique_ptr<BitmapIndex<T>>;
+
+// whether n values have at most limit distinct ones
+template <typename T>
+inline bool
+HasLowCardinality(size_t n, const T* values, size_t limit) {
+    std::vector<T> distinct;
+    for (size_t i = 0; i < n; ++i) {
+        auto it = std::lower_bound(distinct.begin(), distinct.end(), values[i]);
+        if (it != distinct.end() && *it == values[i]) {
+            continue;
+        }
+        if (distinct.size() == limit) {
+            return false;
+        }
+        distinct.insert(it, values[i]);
+    }
+    return true;
+}
+
+}  // namespace milvus::index
+
+#include "index/BitmapIndex-inl.h"
+
+namespace milvus::index {
+template <typename T>
+inline BitmapIndexPtr<T>
+CreateBitmapIndex() {
+    return std::make_unique<BitmapIndex<T>>();
+}
+}  // namespace milvus::index
@@ -0,0 +1,175 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "index/DiskAnnCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace milvus::index {
+
+namespace {
+
+// the weight of the searches of the last interval in the rate of a lease
+constexpr double kRateDecay = 0.5;
+
+int64_t
+steady_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+DiskAnnCacheLease::~DiskAnnCacheLease() {
+    manager_->release(this);
+}
+
+int64_t
+DiskAnnCacheLease::target() const {
+    std::lock_guard lck(manager_->mutex_);
+    return target_;
+}
+
+void
+DiskAnnCacheLease::RecordSearch(int64_t nq) {
+    searches_.fetch_add(nq, std::memory_order_relaxed);
+    manager_->maybe_rebalance();
+}
+
+void
+DiskAnnCacheManager::SetBudget(int64_t budget, int64_t rebalance_interval_ms) {
+    std::lock_guard lck(mutex_);
+    budget_ = std::max<int64_t>(budget, 0);
+    interval_ms_ = rebalance_interval_ms > 0
+                       ? rebalance_interval_ms
+                       : DEFAULT_DISKANN_CACHE_REBALANCE_INTERVAL_MS;
+    apportion_locked();
+}
+
+int64_t
+DiskAnnCacheManager::Budget() const {
+    std::lock_guard lck(mutex_);
+    return budget_;
+}
+
+int64_t
+DiskAnnCacheManager::GrantedBytes() const {
+    std::lock_guard lck(mutex_);
+    return granted_bytes_;
+}
+
+int64_t
+DiskAnnCacheManager::NumIndexes() const {
+    std::lock_guard lck(mutex_);
+    return leases_.size();
+}
+
+std::unique_ptr<DiskAnnCacheLease>
+DiskAnnCacheManager::Acquire(int64_t requested) {
+    std::unique_ptr<DiskAnnCacheLease> lease(
+        new DiskAnnCacheLease(this, std::max<int64_t>(requested, 0)));
+    std::lock_guard lck(mutex_);
+    // a new index weighs as much as the average loaded one until its own
+    // searches are counted
+    double rates = 0;
+    for (auto other : leases_) {
+        rates += other->rate_;
+    }
+    lease->rate_ = leases_.empty() ? 0 : rates / leases_.size();
+    leases_.insert(lease.get());
+    apportion_locked();
+    lease->granted_ =
+        budget_ > 0 ? std::min(lease->target_,
+                               std::max<int64_t>(budget_ - granted_bytes_, 0))
+                    : lease->requested_;
+    granted_bytes_ += lease->granted_;
+    return lease;
+}
+
+void
+DiskAnnCacheManager::release(DiskAnnCacheLease* lease) {
+    std::lock_guard lck(mutex_);
+    leases_.erase(lease);
+    granted_bytes_ -= lease->granted_;
+    apportion_locked();
+}
+
+void
+DiskAnnCacheManager::Rebalance() {
+    last_rebalance_ms_ = steady_ms();
+    std::lock_guard lck(mutex_);
+    for (auto lease : leases_) {
+        auto searches = lease->searches_.exchange(0);
+        lease->rate_ = kRateDecay * searches + (1 - kRateDecay) * lease->rate_;
+    }
+    apportion_locked();
+}
+
+void
+DiskAnnCacheManager::maybe_rebalance() {
+    auto now = steady_ms();
+    auto last = last_rebalance_ms_.load(std::memory_order_relaxed);
+    if (now - last < interval_ms_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (last_rebalance_ms_.compare_exchange_strong(last, now)) {
+        Rebalance();
+    }
+}
+
+void
+DiskAnnCacheManager::apportion_locked() {
+    if (budget_ <= 0) {
+        for (auto lease : leases_) {
+            lease->target_ = lease->requested_;
+        }
+        return;
+    }
+    // shares in proportion to the rates, a lease never searched weighs as
+    // one search; the leases whose share covers what they ask for take
+    // that, and the rest is shared again among the others
+    auto weight = [](const DiskAnnCacheLease* lease) {
+        return lease->rate_ + 1;
+    };
+    std::vector<DiskAnnCacheLease*> open(leases_.begin(), leases_.end());
+    auto remaining = double(budget_);
+    while (!open.empty()) {
+        double weights = 0;
+        for (auto lease : open) {
+            weights += weight(lease);
+        }
+        auto capped = std::partition(open.begin(), open.end(), [&](auto l) {
+            return remaining * weight(l) / weights < l->requested_;
+        });
+        if (capped == open.end()) {
+            for (auto lease : open) {
+                lease->target_ = int64_t(remaining * weight(lease) / weights);
+            }
+            break;
+        }
+        for (auto it = capped; it != open.end(); ++it) {
+            (*it)->target_ = (*it)->requested_;
+            remaining -= (*it)->requested_;
+        }
+        open.erase(capped, open.end());
+    }
+}
+
+}  // namespace milvus::index
@@ -0,0 +1,139 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "common/Consts.h"
+
+namespace milvus::index {
+
+class DiskAnnCacheManager;
+
+// The cache a DiskANN index is granted by the DiskAnnCacheManager, held
+// while the index is loaded.
+class DiskAnnCacheLease {
+ public:
+    ~DiskAnnCacheLease();
+
+    DiskAnnCacheLease(const DiskAnnCacheLease&) = delete;
+    DiskAnnCacheLease&
+    operator=(const DiskAnnCacheLease&) = delete;
+
+    int64_t
+    requested() const {
+        return requested_;
+    }
+
+    // the bytes the index was loaded with
+    int64_t
+    granted() const {
+        return granted_;
+    }
+
+    // the share of the budget at the last rebalance, what a reload of the
+    // index would be granted
+    int64_t
+    target() const;
+
+    void
+    RecordSearch(int64_t nq);
+
+ private:
+    friend class DiskAnnCacheManager;
+
+    DiskAnnCacheLease(DiskAnnCacheManager* manager, int64_t requested)
+        : manager_(manager), requested_(requested) {
+    }
+
+    DiskAnnCacheManager* manager_;
+    const int64_t requested_;
+    int64_t granted_ = 0;
+    // guarded by the mutex of the manager
+    int64_t target_ = 0;
+    // the decayed searches per rebalance interval
+    double rate_ = 0;
+    std::atomic<int64_t> searches_{0};
+};
+
+// Node wide budget of the in memory caches of the DiskANN indexes.
+// Every index asks for the cache its load config sizes, and is granted a
+// share of the budget in proportion to how often it's searched, capped by
+// what it asks for. The shares are rebalanced from the searches as they
+// arrive, at most once an interval. Knowhere sizes the cache of an index
+// when it loads, so a rebalance never resizes a loaded one; it moves the
+// budget the cold indexes release to the indexes loaded or reloaded after.
+class DiskAnnCacheManager {
+ public:
+    static DiskAnnCacheManager&
+    GetInstance() {
+        static DiskAnnCacheManager instance;
+        return instance;
+    }
+
+    // a zero budget grants every index the cache it asks for
+    void
+    SetBudget(int64_t budget, int64_t rebalance_interval_ms);
+
+    int64_t
+    Budget() const;
+
+    // the bytes granted to the loaded indexes
+    int64_t
+    GrantedBytes() const;
+
+    int64_t
+    NumIndexes() const;
+
+    // registers an index asking for `requested` bytes of cache, it's
+    // granted its share of the budget, at most what's left of it
+    std::unique_ptr<DiskAnnCacheLease>
+    Acquire(int64_t requested);
+
+    void
+    Rebalance();
+
+ private:
+    friend class DiskAnnCacheLease;
+
+    DiskAnnCacheManager() = default;
+
+    void
+    release(DiskAnnCacheLease* lease);
+
+    void
+    maybe_rebalance();
+
+    // recomputes the targets of the leases from their rates
+    void
+    apportion_locked();
+
+ private:
+    mutable std::mutex mutex_;
+    int64_t budget_ = 0;
+    int64_t granted_bytes_ = 0;
+    std::atomic<int64_t> interval_ms_{
+        DEFAULT_DISKANN_CACHE_REBALANCE_INTERVAL_MS};
+    std::atomic<int64_t> last_rebalance_ms_{0};
+    std::unordered_set<DiskAnnCacheLease*> leases_;
+};
+
+}  // namespace milvus::index
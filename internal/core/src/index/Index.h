@@ -44,6 +44,12 @@ class IndexBase {
     virtual int64_t
     Count() = 0;
 
+    // bytes of memory the index holds, 0 if the index can't tell
+    virtual int64_t
+    ByteSize() {
+        return 0;
+    }
+
  protected:
     IndexType index_type_ = "";
 };
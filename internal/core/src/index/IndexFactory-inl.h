@@ -15,8 +15,12 @@
 // limitations under the License.
 
 #include <string>
+#include "index/BitmapIndex.h"
+#include "index/Meta.h"
 #include "index/ScalarIndexSort.h"
+#include "index/StringIndexInverted.h"
 #include "index/StringIndexMarisa.h"
+#include "index/StringIndexNgram.h"
 #include "index/BoolIndex.h"
 
 namespace milvus::index {
@@ -24,6 +28,9 @@ namespace milvus::index {
 template <typename T>
 inline ScalarIndexPtr<T>
 IndexFactory::CreateScalarIndex(const IndexType& index_type) {
+    if (index_type == BITMAP_INDEX_TYPE) {
+        return CreateBitmapIndex<T>();
+    }
     return CreateScalarIndexSort<T>();
 }
 
@@ -36,6 +43,12 @@ IndexFactory::CreateScalarIndex(const IndexType& index_type) {
 template <>
 inline ScalarIndexPtr<std::string>
 IndexFactory::CreateScalarIndex(const IndexType& index_type) {
+    if (index_type == INVERTED_INDEX_TYPE) {
+        return CreateStringIndexInverted();
+    }
+    if (index_type == NGRAM_INDEX_TYPE) {
+        return CreateStringIndexNgram();
+    }
 #if defined(__linux__) || defined(__APPLE__)
     return CreateStringIndexMarisa();
 #else
@@ -92,6 +92,15 @@ IndexFactory::CreateVectorIndex(const CreateIndexInfo& create_index_info,
     }
 #endif
 
+#ifndef MILVUS_GPU_VERSION
+    if (is_in_gpu_list(index_type)) {
+        throw std::invalid_argument(
+            std::string("gpu index isn't supported by this build: ") +
+            index_type);
+    }
+#endif
+
+    // a gpu index is a mem index whose knowhere index lives on the device
     if (is_in_nm_list(index_type)) {
         return std::make_unique<VectorMemNMIndex>(index_type, metric_type);
     }
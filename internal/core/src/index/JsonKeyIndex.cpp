@@ -0,0 +1,67 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "index/JsonKeyIndex.h"
+
+#include <utility>
+
+namespace milvus::index {
+
+JsonKeyIndex::JsonKeyIndex(std::string pointer,
+                           const Json* rows,
+                           int64_t row_count)
+    : pointer_(std::move(pointer)),
+      kinds_(row_count, ValueKind::Missing),
+      values_(row_count) {
+    // read the values through Json::at in the order the filters try the
+    // types, so that the index gives the same answers as parsing the rows
+    for (int64_t i = 0; i < row_count; ++i) {
+        auto& row = rows[i];
+        if (!row.exist(pointer_)) {
+            continue;
+        }
+        if (auto x = row.at<int64_t>(pointer_); !x.error()) {
+            kinds_[i] = ValueKind::Int64;
+            values_[i].i = x.value();
+        } else if (auto x = row.at<double>(pointer_); !x.error()) {
+            kinds_[i] = ValueKind::Double;
+            values_[i].d = x.value();
+        } else if (auto x = row.at<bool>(pointer_); !x.error()) {
+            kinds_[i] = ValueKind::Bool;
+            values_[i].b = x.value();
+        } else if (auto x = row.at<std::string_view>(pointer_); !x.error()) {
+            if (string_ends_.empty()) {
+                string_ends_.resize(row_count);
+            }
+            kinds_[i] = ValueKind::String;
+            values_[i].i = chars_.size();
+            chars_.append(x.value());
+            string_ends_[i] = chars_.size();
+        } else {
+            kinds_[i] = ValueKind::Other;
+        }
+    }
+}
+
+int64_t
+JsonKeyIndex::Size() const {
+    return pointer_.size() + kinds_.size() * sizeof(ValueKind) +
+           values_.size() * sizeof(Value) +
+           string_ends_.size() * sizeof(int64_t) + chars_.size();
+}
+
+}  // namespace milvus::index
@@ -0,0 +1,119 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "common/Json.h"
+
+namespace milvus::index {
+
+// The value of one json pointer of every row of a json field, extracted when
+// the field is loaded. Filters on the pointer read these typed columns
+// instead of parsing the json document of each row.
+class JsonKeyIndex {
+ public:
+    enum class ValueKind : uint8_t {
+        // the pointer doesn't exist in the row
+        Missing = 0,
+        // object, array or null
+        Other,
+        Bool,
+        Int64,
+        Double,
+        String,
+    };
+
+    JsonKeyIndex(std::string pointer, const Json* rows, int64_t row_count);
+
+    const std::string&
+    pointer() const {
+        return pointer_;
+    }
+
+    int64_t
+    Count() const {
+        return kinds_.size();
+    }
+
+    // memory held by the index in bytes
+    int64_t
+    Size() const;
+
+    ValueKind
+    kind(int64_t offset) const {
+        return kinds_[offset];
+    }
+
+    bool
+    Exists(int64_t offset) const {
+        return kinds_[offset] != ValueKind::Missing;
+    }
+
+    // calls `func` with the value at `offset` read as T, the same way
+    // Json::at<T> would read it, returns `missing` if it can't be read as T
+    template <typename T, typename Func>
+    bool
+    Visit(int64_t offset, Func&& func, bool missing) const {
+        auto kind = kinds_[offset];
+        if constexpr (std::is_same_v<T, bool>) {
+            return kind == ValueKind::Bool ? func(values_[offset].b) : missing;
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return kind == ValueKind::Int64 ? func(values_[offset].i) : missing;
+        } else if constexpr (std::is_same_v<T, double>) {
+            if (kind == ValueKind::Int64) {
+                return func(double(values_[offset].i));
+            }
+            return kind == ValueKind::Double ? func(values_[offset].d)
+                                             : missing;
+        } else {
+            static_assert(std::is_same_v<T, std::string_view>,
+                          "unsupported json key index value type");
+            return kind == ValueKind::String ? func(string_at(offset))
+                                             : missing;
+        }
+    }
+
+ private:
+    std::string_view
+    string_at(int64_t offset) const {
+        auto begin = values_[offset].i;
+        return {chars_.data() + begin, size_t(string_ends_[offset] - begin)};
+    }
+
+ private:
+    union Value {
+        bool b;
+        int64_t i;
+        double d;
+    };
+
+    std::string pointer_;
+    std::vector<ValueKind> kinds_;
+    // for String rows, the begin of the string in chars_
+    std::vector<Value> values_;
+    // end of the string of each row in chars_, empty if no row is a string
+    std::vector<int64_t> string_ends_;
+    std::string chars_;
+};
+
+}  // namespace milvus::index
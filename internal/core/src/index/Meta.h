@@ -26,16 +26,42 @@ constexpr const char* LOWER_BOUND_INCLUSIVE = "lower_bound_inclusive";
 constexpr const char* UPPER_BOUND_VALUE = "upper_bound_value";
 constexpr const char* UPPER_BOUND_INCLUSIVE = "upper_bound_inclusive";
 constexpr const char* PREFIX_VALUE = "prefix_value";
+// the value of a PostfixMatch or the pattern of a Match
+constexpr const char* PATTERN_VALUE = "pattern_value";
 // below configurations will be persistent, do not edit them.
 constexpr const char* MARISA_TRIE_INDEX = "marisa_trie_index";
 constexpr const char* MARISA_STR_IDS = "marisa_trie_str_ids";
+constexpr const char* SORTED_INDEX_DATA = "sorted_index_data";
+constexpr const char* BITMAP_INDEX_META = "bitmap_index_meta";
+constexpr const char* BITMAP_INDEX_DATA = "bitmap_index_data";
+constexpr const char* INVERTED_INDEX_TERMS = "inverted_index_terms";
+constexpr const char* INVERTED_INDEX_COUNTS = "inverted_index_counts";
+constexpr const char* INVERTED_INDEX_POSTINGS = "inverted_index_postings";
 
 constexpr const char* INDEX_TYPE = "index_type";
 constexpr const char* METRIC_TYPE = "metric_type";
+// load a memory index from this file mapped instead of the binary set
+constexpr const char* MMAP_FILE_PATH = "mmap_filepath";
+constexpr const char* ENABLE_MMAP = "enable_mmap";
+// rows a streaming build trains the index on before adding the rest
+constexpr const char* STREAM_BUILD_TRAIN_ROWS = "stream_build_train_rows";
+// the device a vector index is built on, "cpu" or "gpu", cpu by default
+constexpr const char* BUILD_DEVICE = "build_device";
+constexpr const char* BUILD_DEVICE_CPU = "cpu";
+constexpr const char* BUILD_DEVICE_GPU = "gpu";
+// queries a loaded vector index is searched with before it serves any, so
+// its pages are faulted in; overrides the segcore config
+constexpr const char* WARMUP_QUERIES = "warmup_queries";
+// most distinct values a scalar field may have to get a bitmap index
+constexpr const char* BITMAP_CARDINALITY_LIMIT = "bitmap_cardinality_limit";
 
 // scalar index type
 constexpr const char* ASCENDING_SORT = "STL_SORT";
 constexpr const char* MARISA_TRIE = "Trie";
+constexpr const char* BITMAP_INDEX_TYPE = "BITMAP";
+constexpr const char* INVERTED_INDEX_TYPE = "INVERTED";
+// an inverted index of strings with the trigrams of its terms
+constexpr const char* NGRAM_INDEX_TYPE = "NGRAM";
 
 // index meta
 constexpr const char* COLLECTION_ID = "collection_id";
@@ -45,6 +71,7 @@ constexpr const char* FIELD_ID = "field_id";
 constexpr const char* INDEX_BUILD_ID = "index_build_id";
 constexpr const char* INDEX_ID = "index_id";
 constexpr const char* INDEX_VERSION = "index_version";
+constexpr const char* INDEX_NAME = "index_name";
 
 // DiskAnn build params
 constexpr const char* DISK_ANN_PREFIX_PATH = "index_prefix";
@@ -62,6 +89,10 @@ constexpr const char* DISK_ANN_LOAD_THREAD_NUM = "num_load_thread";
 constexpr const char* DISK_ANN_SEARCH_CACHE_BUDGET = "search_cache_budget_gb";
 constexpr const char* DISK_ANN_PREPARE_WARM_UP = "warm_up";
 constexpr const char* DISK_ANN_PREPARE_USE_BFS_CACHE = "use_bfs_cache";
+// keeps the rows beside the built index, for GetVector to read them without
+// going through the graph
+constexpr const char* DISK_ANN_RAW_VECTOR_SIDECAR = "raw_vector_sidecar";
+constexpr const char* DISK_ANN_RAW_VECTOR_FILE = "raw_vectors";
 
 // DiskAnn query params
 constexpr const char* DISK_ANN_QUERY_LIST = "search_list";
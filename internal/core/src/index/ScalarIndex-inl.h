@@ -18,10 +18,123 @@
 #include <string>
 #include <vector>
 
+#include "common/Common.h"
 #include "index/Meta.h"
 #include "knowhere/dataset.h"
 
 namespace milvus::index {
+inline BitsetType
+PackTargetBitmap(const TargetBitmap& bitmap) {
+    BitsetType res(bitmap.size());
+    for (size_t i = 0; i < bitmap.size(); ++i) {
+        if (bitmap[i]) {
+            res.set(i);
+        }
+    }
+    return res;
+}
+
+inline TargetBitmap
+UnpackTargetBitmap(const BitsetType& bitset) {
+    TargetBitmap res(bitset.size());
+    for (auto pos = bitset.find_first(); pos != BitsetType::npos;
+         pos = bitset.find_next(pos)) {
+        res[pos] = true;
+    }
+    return res;
+}
+
+template <typename T>
+void
+ScalarIndex<T>::ReverseLookupAll(T* values) {
+    auto n = Count();
+    for (int64_t i = 0; i < n; ++i) {
+        values[i] = Reverse_Lookup(i);
+    }
+}
+
+template <typename T>
+void
+ScalarIndex<T>::ReverseLookupBatch(const int64_t* offsets,
+                                   int64_t n,
+                                   T* values) const {
+    for (int64_t i = 0; i < n; ++i) {
+        values[i] = Reverse_Lookup(offsets[i]);
+    }
+}
+
+template <typename T>
+std::shared_ptr<const T[]>
+ScalarIndex<T>::decoded_rows(int64_t n) const {
+    auto decoded = std::atomic_load(&decoded_);
+    auto factor = reverse_lookup_cache_factor;
+    if (decoded != nullptr || factor <= 0) {
+        return decoded;
+    }
+    // Count and ReverseLookupAll leave the index as it is
+    auto self = const_cast<ScalarIndex<T>*>(this);
+    auto count = self->Count();
+    auto rows = looked_up_rows_.fetch_add(n, std::memory_order_relaxed) + n;
+    if (count == 0 || rows < factor * count) {
+        return nullptr;
+    }
+    std::lock_guard lck(decoded_mutex_);
+    decoded = std::atomic_load(&decoded_);
+    if (decoded == nullptr) {
+        std::shared_ptr<T[]> column(new T[count]);
+        self->ReverseLookupAll(column.get());
+        decoded_count_ = count;
+        decoded = std::move(column);
+        std::atomic_store(&decoded_, decoded);
+    }
+    return decoded;
+}
+
+template <typename T>
+void
+ScalarIndex<T>::ReverseLookup(const int64_t* offsets,
+                              int64_t n,
+                              T* values) const {
+    auto decoded = decoded_rows(n);
+    if (decoded == nullptr) {
+        ReverseLookupBatch(offsets, n, values);
+        return;
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        AssertInfo(offsets[i] >= 0 && offsets[i] < decoded_count_,
+                   "out of range of total count");
+        values[i] = decoded[offsets[i]];
+    }
+}
+
+template <typename T>
+BitsetType
+ScalarIndex<T>::InBits(size_t n, const T* values) {
+    return PackTargetBitmap(In(n, values));
+}
+
+template <typename T>
+BitsetType
+ScalarIndex<T>::NotInBits(size_t n, const T* values) {
+    return PackTargetBitmap(NotIn(n, values));
+}
+
+template <typename T>
+BitsetType
+ScalarIndex<T>::RangeBits(T value, OpType op) {
+    return PackTargetBitmap(Range(value, op));
+}
+
+template <typename T>
+BitsetType
+ScalarIndex<T>::RangeBits(T lower_bound_value,
+                          bool lb_inclusive,
+                          T upper_bound_value,
+                          bool ub_inclusive) {
+    return PackTargetBitmap(Range(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive));
+}
+
 template <typename T>
 const TargetBitmap
 ScalarIndex<T>::Query(const DatasetPtr& dataset) {
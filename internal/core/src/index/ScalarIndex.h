@@ -17,9 +17,12 @@
 #pragma once
 
 #include <boost/dynamic_bitset.hpp>
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "common/Types.h"
 #include "exceptions/EasyAssert.h"
@@ -60,14 +63,103 @@ class ScalarIndex : public IndexBase {
           T upper_bound_value,
           bool ub_inclusive) = 0;
 
+    // Same as In, NotIn and Range but the result is packed into bits.
+    // The defaults convert the TargetBitmap, indexes which can scatter into
+    // the packed bitset directly should override them.
+    virtual BitsetType
+    InBits(size_t n, const T* values);
+
+    virtual BitsetType
+    NotInBits(size_t n, const T* values);
+
+    virtual BitsetType
+    RangeBits(T value, OpType op);
+
+    virtual BitsetType
+    RangeBits(T lower_bound_value,
+              bool lb_inclusive,
+              T upper_bound_value,
+              bool ub_inclusive);
+
+    // Number of rows In and Range would match, used to estimate how
+    // selective a predicate is. -1 if the index can't count them without
+    // evaluating the predicate.
+    virtual int64_t
+    CountIn(size_t n, const T* values) {
+        return -1;
+    }
+
+    virtual int64_t
+    CountRange(T value, OpType op) {
+        return -1;
+    }
+
+    virtual int64_t
+    CountRange(T lower_bound_value,
+               bool lb_inclusive,
+               T upper_bound_value,
+               bool ub_inclusive) {
+        return -1;
+    }
+
+    // The row holding the smallest value, or the largest if `largest`, of
+    // the first excluded.size() rows which aren't set in `excluded`, NaN
+    // aside. -1 if every row is excluded or the index can't find it without
+    // reading the value of every row.
+    virtual int64_t
+    ExtremeOffset(const BitsetType& excluded, bool largest) const {
+        return -1;
+    }
+
+    // Appends the rows of the first excluded.size() which aren't set in
+    // `excluded` to `offsets` in the order of their values, descending if
+    // `descending`, rows of equal values by offset and NaN aside, until it
+    // holds `limit` of them. False if the index can't order them without
+    // reading the value of every row.
+    virtual bool
+    OrderedOffsets(const BitsetType& excluded,
+                   bool descending,
+                   int64_t limit,
+                   std::vector<int64_t>& offsets) const {
+        return false;
+    }
+
     virtual T
     Reverse_Lookup(size_t offset) const = 0;
 
+    // Reverse_Lookup of every row, written to values[0, Count())
+    virtual void
+    ReverseLookupAll(T* values);
+
+    // Reverse_Lookup of the rows at offsets[0, n), written to values[0, n),
+    // for the output fields served from the index. Once these have read
+    // reverse_lookup_cache_factor times the rows of the index, every row is
+    // decoded by ReverseLookupAll and kept to serve the following ones.
+    void
+    ReverseLookup(const int64_t* offsets, int64_t n, T* values) const;
+
     virtual const TargetBitmap
     Query(const DatasetPtr& dataset);
 
     virtual int64_t
     Size() = 0;
+
+ protected:
+    // ReverseLookup without the decoded rows, the default looks the rows up
+    // one by one
+    virtual void
+    ReverseLookupBatch(const int64_t* offsets, int64_t n, T* values) const;
+
+ private:
+    // the decoded rows, null until the lookups read enough of them
+    std::shared_ptr<const T[]>
+    decoded_rows(int64_t n) const;
+
+ private:
+    mutable std::atomic<int64_t> looked_up_rows_{0};
+    mutable std::mutex decoded_mutex_;
+    mutable std::shared_ptr<const T[]> decoded_;
+    mutable int64_t decoded_count_ = 0;
 };
 
 template <typename T>
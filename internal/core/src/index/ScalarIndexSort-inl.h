@@ -15,18 +15,104 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <pb/schema.pb.h>
+#include <type_traits>
 #include <vector>
 #include <string>
 #include "knowhere/log.h"
 #include "Meta.h"
+#include "common/Common.h"
 #include "common/Utils.h"
 #include "common/Slice.h"
+#include "index/SortedIndexCodec.h"
+#include "index/Utils.h"
 
 namespace milvus::index {
 
+// stable LSD radix sort of integer keys, a byte at a time. Passes where all
+// keys share the byte are skipped, so small values take fewer passes.
+template <typename T>
+inline void
+RadixSortIndexStructures(IndexStructure<T>* first, IndexStructure<T>* last) {
+    using U = std::make_unsigned_t<T>;
+    // flip the sign bit so negative values order before the others
+    constexpr U sign_bit = std::is_signed_v<T> ? U(U(1) << (sizeof(T) * 8 - 1))
+                                               : U(0);
+    auto n = size_t(last - first);
+    std::vector<IndexStructure<T>> buffer(n);
+    auto src = first;
+    auto dst = buffer.data();
+    for (size_t shift = 0; shift < sizeof(T) * 8; shift += 8) {
+        auto digit = [&](const IndexStructure<T>& s) {
+            return size_t(U(U(s.a_) ^ sign_bit) >> shift) & 0xff;
+        };
+        size_t counts[257] = {0};
+        for (size_t i = 0; i < n; ++i) {
+            ++counts[digit(src[i]) + 1];
+        }
+        if (counts[digit(src[0]) + 1] == n) {
+            continue;
+        }
+        for (size_t d = 1; d < 257; ++d) {
+            counts[d] += counts[d - 1];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            dst[counts[digit(src[i])]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != first) {
+        std::copy(src, src + n, first);
+    }
+}
+
+// sort ranges of the data in parallel and merge them pairwise, integer keys
+// are radix sorted
+template <typename T>
+inline void
+ParallelSortIndexStructures(std::vector<IndexStructure<T>>& data) {
+    auto n = data.size();
+    auto num_ranges = std::max<size_t>(
+        1,
+        std::min<size_t>(GetIndexBuildParallelism(),
+                         n / MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK));
+    auto step = (n + num_ranges - 1) / num_ranges;
+    std::vector<size_t> bounds;
+    for (size_t begin = 0; begin < n; begin += step) {
+        bounds.push_back(begin);
+    }
+    bounds.push_back(n);
+    num_ranges = bounds.size() - 1;
+
+    ParallelForRanges(num_ranges, 1, [&](size_t begin, size_t end) {
+        for (auto r = begin; r < end; ++r) {
+            auto first = data.data() + bounds[r];
+            auto last = data.data() + bounds[r + 1];
+            if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+                RadixSortIndexStructures(first, last);
+            } else {
+                std::sort(first, last);
+            }
+        }
+    });
+    for (size_t width = 1; width < num_ranges; width *= 2) {
+        auto num_merges = (num_ranges + 2 * width - 1) / (2 * width);
+        ParallelForRanges(num_merges, 1, [&](size_t begin, size_t end) {
+            for (auto m = begin; m < end; ++m) {
+                auto mid = std::min(num_ranges, (2 * m + 1) * width);
+                auto last = std::min(num_ranges, (2 * m + 2) * width);
+                std::inplace_merge(data.begin() + bounds[2 * m * width],
+                                   data.begin() + bounds[mid],
+                                   data.begin() + bounds[last]);
+            }
+        });
+    }
+}
+
 template <typename T>
 inline ScalarIndexSort<T>::ScalarIndexSort() : is_built_(false), data_() {
 }
@@ -47,16 +133,21 @@ ScalarIndexSort<T>::Build(const size_t n, const T* values) {
         throw std::invalid_argument(
             "ScalarIndexSort cannot build null values!");
     }
-    data_.reserve(n);
+    data_.resize(n);
     idx_to_offsets_.resize(n);
-    T* p = const_cast<T*>(values);
-    for (size_t i = 0; i < n; ++i) {
-        data_.emplace_back(IndexStructure(*p++, i));
-    }
-    std::sort(data_.begin(), data_.end());
-    for (size_t i = 0; i < data_.size(); ++i) {
-        idx_to_offsets_[data_[i].idx_] = i;
-    }
+    ParallelForRanges(
+        n, MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                data_[i] = IndexStructure<T>(values[i], i);
+            }
+        });
+    ParallelSortIndexStructures(data_);
+    ParallelForRanges(
+        n, MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                idx_to_offsets_[data_[i].idx_] = i;
+            }
+        });
     is_built_ = true;
 }
 
@@ -65,6 +156,14 @@ inline BinarySet
 ScalarIndexSort<T>::Serialize(const Config& config) {
     AssertInfo(is_built_, "index has not been built");
 
+    if constexpr (std::is_arithmetic_v<T>) {
+        auto [index_data, index_data_size] = EncodeSortedIndex(data_);
+        BinarySet res_set;
+        res_set.Append(SORTED_INDEX_DATA, index_data, index_data_size);
+        milvus::Disassemble(res_set);
+        return res_set;
+    }
+
     auto index_data_size = data_.size() * sizeof(IndexStructure<T>);
     std::shared_ptr<uint8_t[]> index_data(new uint8_t[index_data_size]);
     memcpy(index_data.get(), data_.data(), index_data_size);
@@ -85,8 +184,15 @@ ScalarIndexSort<T>::Serialize(const Config& config) {
 template <typename T>
 inline void
 ScalarIndexSort<T>::Load(const BinarySet& index_binary, const Config& config) {
-    size_t index_size;
     milvus::Assemble(const_cast<BinarySet&>(index_binary));
+    if constexpr (std::is_arithmetic_v<T>) {
+        if (index_binary.Contains(SORTED_INDEX_DATA)) {
+            LoadCompact(index_binary);
+            return;
+        }
+    }
+
+    size_t index_size;
     auto index_length = index_binary.GetByName("index_length");
     memcpy(&index_size, index_length->data.get(), (size_t)index_length->size);
 
@@ -100,6 +206,34 @@ ScalarIndexSort<T>::Load(const BinarySet& index_binary, const Config& config) {
     is_built_ = true;
 }
 
+template <typename T>
+inline void
+ScalarIndexSort<T>::LoadCompact(const BinarySet& index_binary) {
+    auto index_data = index_binary.GetByName(SORTED_INDEX_DATA);
+    auto buf = index_data->data.get();
+    auto size = index_data->size;
+    auto header = ReadSortedIndexHeader(buf, size);
+
+    // blocks are independent, decode them in parallel straight into data_
+    data_.resize(header.num_rows);
+    idx_to_offsets_.resize(header.num_rows);
+    auto min_blocks =
+        MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK / SORTED_INDEX_BLOCK_SIZE;
+    ParallelForRanges(
+        header.num_blocks, min_blocks, [&](size_t begin, size_t end) {
+            DecodeSortedIndexBlocks(buf, size, begin, end, data_.data());
+        });
+    ParallelForRanges(
+        data_.size(),
+        MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK,
+        [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                idx_to_offsets_[data_[i].idx_] = i;
+            }
+        });
+    is_built_ = true;
+}
+
 template <typename T>
 inline const TargetBitmap
 ScalarIndexSort<T>::In(const size_t n, const T* values) {
@@ -145,10 +279,9 @@ ScalarIndexSort<T>::NotIn(const size_t n, const T* values) {
 }
 
 template <typename T>
-inline const TargetBitmap
-ScalarIndexSort<T>::Range(const T value, const OpType op) {
-    AssertInfo(is_built_, "index has not been built");
-    TargetBitmap bitset(data_.size());
+inline auto
+ScalarIndexSort<T>::RangeBounds(const T value, const OpType op) const
+    -> std::pair<ConstIterator, ConstIterator> {
     auto lb = data_.begin();
     auto ub = data_.end();
     switch (op) {
@@ -172,24 +305,20 @@ ScalarIndexSort<T>::Range(const T value, const OpType op) {
             throw std::invalid_argument(std::string("Invalid OperatorType: ") +
                                         std::to_string((int)op) + "!");
     }
-    for (; lb < ub; ++lb) {
-        bitset[lb->idx_] = true;
-    }
-    return bitset;
+    return {lb, ub};
 }
 
 template <typename T>
-inline const TargetBitmap
-ScalarIndexSort<T>::Range(T lower_bound_value,
-                          bool lb_inclusive,
-                          T upper_bound_value,
-                          bool ub_inclusive) {
-    AssertInfo(is_built_, "index has not been built");
-    TargetBitmap bitset(data_.size());
+inline auto
+ScalarIndexSort<T>::RangeBounds(T lower_bound_value,
+                                bool lb_inclusive,
+                                T upper_bound_value,
+                                bool ub_inclusive) const
+    -> std::pair<ConstIterator, ConstIterator> {
     if (lower_bound_value > upper_bound_value ||
         (lower_bound_value == upper_bound_value &&
          !(lb_inclusive && ub_inclusive))) {
-        return bitset;
+        return {data_.end(), data_.end()};
     }
     auto lb = data_.begin();
     auto ub = data_.end();
@@ -207,12 +336,198 @@ ScalarIndexSort<T>::Range(T lower_bound_value,
         ub = std::lower_bound(
             data_.begin(), data_.end(), IndexStructure<T>(upper_bound_value));
     }
+    return {lb, std::max(lb, ub)};
+}
+
+template <typename T>
+inline BitsetType
+ScalarIndexSort<T>::ScatterBits(ConstIterator lb, ConstIterator ub) const {
+    BitsetType bitset(data_.size());
+    if (size_t(ub - lb) * 2 <= data_.size()) {
+        for (; lb < ub; ++lb) {
+            bitset.set(lb->idx_);
+        }
+        return bitset;
+    }
+    bitset.set();
+    for (auto it = data_.begin(); it < lb; ++it) {
+        bitset.reset(it->idx_);
+    }
+    for (auto it = ub; it < data_.end(); ++it) {
+        bitset.reset(it->idx_);
+    }
+    return bitset;
+}
+
+template <typename T>
+inline const TargetBitmap
+ScalarIndexSort<T>::Range(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    TargetBitmap bitset(data_.size());
+    auto [lb, ub] = RangeBounds(value, op);
+    for (; lb < ub; ++lb) {
+        bitset[lb->idx_] = true;
+    }
+    return bitset;
+}
+
+template <typename T>
+inline const TargetBitmap
+ScalarIndexSort<T>::Range(T lower_bound_value,
+                          bool lb_inclusive,
+                          T upper_bound_value,
+                          bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    TargetBitmap bitset(data_.size());
+    auto [lb, ub] = RangeBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
     for (; lb < ub; ++lb) {
         bitset[lb->idx_] = true;
     }
     return bitset;
 }
 
+template <typename T>
+inline BitsetType
+ScalarIndexSort<T>::InBits(const size_t n, const T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    BitsetType bitset(data_.size());
+    for (size_t i = 0; i < n; ++i) {
+        auto [lb, ub] = std::equal_range(
+            data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
+        for (; lb < ub; ++lb) {
+            bitset.set(lb->idx_);
+        }
+    }
+    return bitset;
+}
+
+template <typename T>
+inline BitsetType
+ScalarIndexSort<T>::NotInBits(const size_t n, const T* values) {
+    auto bitset = InBits(n, values);
+    bitset.flip();
+    return bitset;
+}
+
+template <typename T>
+inline BitsetType
+ScalarIndexSort<T>::RangeBits(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [lb, ub] = RangeBounds(value, op);
+    return ScatterBits(lb, ub);
+}
+
+template <typename T>
+inline BitsetType
+ScalarIndexSort<T>::RangeBits(T lower_bound_value,
+                              bool lb_inclusive,
+                              T upper_bound_value,
+                              bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [lb, ub] = RangeBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    return ScatterBits(lb, ub);
+}
+
+template <typename T>
+inline int64_t
+ScalarIndexSort<T>::CountIn(const size_t n, const T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    std::vector<T> distinct(values, values + n);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                   distinct.end());
+    int64_t count = 0;
+    for (auto& value : distinct) {
+        auto [lb, ub] = std::equal_range(
+            data_.begin(), data_.end(), IndexStructure<T>(value));
+        count += ub - lb;
+    }
+    return count;
+}
+
+template <typename T>
+inline int64_t
+ScalarIndexSort<T>::CountRange(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [lb, ub] = RangeBounds(value, op);
+    return ub - lb;
+}
+
+template <typename T>
+inline int64_t
+ScalarIndexSort<T>::CountRange(T lower_bound_value,
+                               bool lb_inclusive,
+                               T upper_bound_value,
+                               bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    auto [lb, ub] = RangeBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    return ub - lb;
+}
+
+template <typename T>
+inline int64_t
+ScalarIndexSort<T>::ExtremeOffset(const BitsetType& excluded,
+                                  bool largest) const {
+    AssertInfo(is_built_, "index has not been built");
+    auto first_included = [&](auto begin, auto end) -> int64_t {
+        for (auto it = begin; it != end; ++it) {
+            if constexpr (std::is_floating_point_v<T>) {
+                if (std::isnan(it->a_)) {
+                    continue;
+                }
+            }
+            if (it->idx_ < excluded.size() && !excluded[it->idx_]) {
+                return it->idx_;
+            }
+        }
+        return -1;
+    };
+    return largest ? first_included(data_.rbegin(), data_.rend())
+                   : first_included(data_.begin(), data_.end());
+}
+
+template <typename T>
+inline bool
+ScalarIndexSort<T>::OrderedOffsets(const BitsetType& excluded,
+                                   bool descending,
+                                   int64_t limit,
+                                   std::vector<int64_t>& offsets) const {
+    AssertInfo(is_built_, "index has not been built");
+    auto collect = [&](auto begin, auto end) {
+        // the rows of one value, sorted by offset
+        std::vector<int64_t> run;
+        auto it = begin;
+        while (it != end && int64_t(offsets.size()) < limit) {
+            if constexpr (std::is_floating_point_v<T>) {
+                if (std::isnan(it->a_)) {
+                    ++it;
+                    continue;
+                }
+            }
+            run.clear();
+            for (auto run_begin = it; it != end && it->a_ == run_begin->a_;
+                 ++it) {
+                if (it->idx_ < excluded.size() && !excluded[it->idx_]) {
+                    run.push_back(it->idx_);
+                }
+            }
+            std::sort(run.begin(), run.end());
+            auto take =
+                std::min<int64_t>(run.size(), limit - int64_t(offsets.size()));
+            offsets.insert(offsets.end(), run.begin(), run.begin() + take);
+        }
+    };
+    if (descending) {
+        collect(data_.rbegin(), data_.rend());
+    } else {
+        collect(data_.begin(), data_.end());
+    }
+    return true;
+}
+
 template <typename T>
 inline T
 ScalarIndexSort<T>::Reverse_Lookup(size_t idx) const {
@@ -222,4 +537,44 @@ ScalarIndexSort<T>::Reverse_Lookup(size_t idx) const {
     auto offset = idx_to_offsets_[idx];
     return data_[offset].a_;
 }
+
+template <typename T>
+inline void
+ScalarIndexSort<T>::ReverseLookupAll(T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    // one sequential pass over the sorted pairs instead of a random access
+    // through idx_to_offsets_ per row
+    for (const auto& elem : data_) {
+        values[elem.idx_] = elem.a_;
+    }
+}
+
+template <typename T>
+inline void
+ScalarIndexSort<T>::ReverseLookupBatch(const int64_t* offsets,
+                                       int64_t n,
+                                       T* values) const {
+    AssertInfo(is_built_, "index has not been built");
+    auto lookup = [&](int64_t i) {
+        auto offset = offsets[i];
+        AssertInfo(offset >= 0 && size_t(offset) < idx_to_offsets_.size(),
+                   "out of range of total count");
+        values[i] = data_[idx_to_offsets_[offset]].a_;
+    };
+    if (std::is_sorted(offsets, offsets + n)) {
+        for (int64_t i = 0; i < n; ++i) {
+            lookup(i);
+        }
+        return;
+    }
+    // visit the offsets ascending, idx_to_offsets_ is read in one pass
+    std::vector<int64_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return offsets[a] < offsets[b];
+    });
+    for (auto i : order) {
+        lookup(i);
+    }
+}
 }  // namespace milvus::index
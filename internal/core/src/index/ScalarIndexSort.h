@@ -43,6 +43,20 @@ class ScalarIndexSort : public ScalarIndex<T> {
         return data_.size();
     }
 
+    int64_t
+    ByteSize() override {
+        int64_t bytes = data_.capacity() * sizeof(IndexStructure<T>) +
+                        idx_to_offsets_.capacity() * sizeof(int32_t);
+        if constexpr (std::is_same_v<T, std::string>) {
+            for (auto& value : data_) {
+                if (value.a_.capacity() > std::string().capacity()) {
+                    bytes += value.a_.capacity() + 1;
+                }
+            }
+        }
+        return bytes;
+    }
+
     void
     Build(size_t n, const T* values) override;
 
@@ -61,9 +75,50 @@ class ScalarIndexSort : public ScalarIndex<T> {
           T upper_bound_value,
           bool ub_inclusive) override;
 
+    BitsetType
+    InBits(size_t n, const T* values) override;
+
+    BitsetType
+    NotInBits(size_t n, const T* values) override;
+
+    BitsetType
+    RangeBits(T value, OpType op) override;
+
+    BitsetType
+    RangeBits(T lower_bound_value,
+              bool lb_inclusive,
+              T upper_bound_value,
+              bool ub_inclusive) override;
+
+    int64_t
+    CountIn(size_t n, const T* values) override;
+
+    int64_t
+    CountRange(T value, OpType op) override;
+
+    int64_t
+    CountRange(T lower_bound_value,
+               bool lb_inclusive,
+               T upper_bound_value,
+               bool ub_inclusive) override;
+
+    // the values are sorted, so it walks in from the end it looks for and
+    // stops at the first row which isn't excluded
+    int64_t
+    ExtremeOffset(const BitsetType& excluded, bool largest) const override;
+
+    bool
+    OrderedOffsets(const BitsetType& excluded,
+                   bool descending,
+                   int64_t limit,
+                   std::vector<int64_t>& offsets) const override;
+
     T
     Reverse_Lookup(size_t offset) const override;
 
+    void
+    ReverseLookupAll(T* values) override;
+
     int64_t
     Size() override {
         return (int64_t)data_.size();
@@ -80,6 +135,34 @@ class ScalarIndexSort : public ScalarIndex<T> {
         return is_built_;
     }
 
+ protected:
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       int64_t n,
+                       T* values) const override;
+
+ private:
+    using ConstIterator =
+        typename std::vector<IndexStructure<T>>::const_iterator;
+
+    std::pair<ConstIterator, ConstIterator>
+    RangeBounds(T value, OpType op) const;
+
+    std::pair<ConstIterator, ConstIterator>
+    RangeBounds(T lower_bound_value,
+                bool lb_inclusive,
+                T upper_bound_value,
+                bool ub_inclusive) const;
+
+    // load the compact format of SortedIndexCodec.h
+    void
+    LoadCompact(const BinarySet& index_binary);
+
+    // set the bits of rows in [lb, ub), a wide range is written as the
+    // complement of the rest to halve the random writes
+    BitsetType
+    ScatterBits(ConstIterator lb, ConstIterator ub) const;
+
  private:
     bool is_built_;
     Config config_;
@@ -0,0 +1,246 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "exceptions/EasyAssert.h"
+#include "index/IndexStructure.h"
+
+namespace milvus::index {
+
+// Compact serialized format of the sorted (value, row) pairs of a
+// ScalarIndexSort of arithmetic values:
+//
+//   header | block bases | block bit widths | block word offsets |
+//   packed words | row ids
+//
+// The values are cut into blocks of SORTED_INDEX_BLOCK_SIZE. Integer values
+// are stored frame of reference: the block base, its first and smallest
+// value, then the differences to it bit packed with the width of the largest
+// one. Floating point values are stored as they are. Row ids are 32 bits.
+constexpr uint32_t SORTED_INDEX_FORMAT_VERSION = 1;
+constexpr uint32_t SORTED_INDEX_BLOCK_SIZE = 1024;
+
+struct SortedIndexHeader {
+    uint32_t version;
+    uint32_t block_size;
+    uint64_t num_rows;
+    uint64_t num_blocks;
+};
+
+namespace sorted_index_internal {
+
+template <typename T>
+constexpr bool kFrameOfReference =
+    std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+template <typename T>
+inline uint64_t
+Delta(T value, T base) {
+    using U = std::make_unsigned_t<T>;
+    return uint64_t(U(U(value) - U(base)));
+}
+
+inline uint8_t
+BitWidth(uint64_t value) {
+    uint8_t width = 0;
+    while (width < 64 && (value >> width) != 0) {
+        ++width;
+    }
+    return width;
+}
+
+inline uint64_t
+WordsOf(uint64_t count, uint8_t width) {
+    return (count * width + 63) / 64;
+}
+
+struct Layout {
+    uint64_t bases;
+    uint64_t widths;
+    uint64_t offsets;
+    uint64_t words;
+    uint64_t row_ids;
+    uint64_t size;
+};
+
+template <typename T>
+inline Layout
+LayoutOf(uint64_t num_rows, uint64_t num_blocks, uint64_t num_words) {
+    auto align = [](uint64_t n) { return (n + 7) / 8 * 8; };
+    Layout layout;
+    layout.bases = sizeof(SortedIndexHeader);
+    layout.widths = align(layout.bases + num_blocks * sizeof(T));
+    layout.offsets = align(layout.widths + num_blocks);
+    layout.words = layout.offsets + (num_blocks + 1) * sizeof(uint64_t);
+    layout.row_ids = layout.words + num_words * sizeof(uint64_t);
+    layout.size = layout.row_ids + num_rows * sizeof(uint32_t);
+    return layout;
+}
+
+}  // namespace sorted_index_internal
+
+template <typename T>
+inline std::pair<std::shared_ptr<uint8_t[]>, int64_t>
+EncodeSortedIndex(const std::vector<IndexStructure<T>>& data) {
+    using namespace sorted_index_internal;
+    static_assert(std::is_arithmetic_v<T>);
+    uint64_t num_rows = data.size();
+    uint64_t num_blocks =
+        (num_rows + SORTED_INDEX_BLOCK_SIZE - 1) / SORTED_INDEX_BLOCK_SIZE;
+
+    std::vector<uint8_t> widths(num_blocks);
+    std::vector<uint64_t> offsets(num_blocks + 1, 0);
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        auto begin = b * SORTED_INDEX_BLOCK_SIZE;
+        auto end =
+            std::min<uint64_t>(begin + SORTED_INDEX_BLOCK_SIZE, num_rows);
+        if constexpr (kFrameOfReference<T>) {
+            // sorted, so the last difference is the largest
+            widths[b] = BitWidth(Delta(data[end - 1].a_, data[begin].a_));
+        } else {
+            widths[b] = sizeof(T) * 8;
+        }
+        offsets[b + 1] = offsets[b] + WordsOf(end - begin, widths[b]);
+    }
+
+    auto layout = LayoutOf<T>(num_rows, num_blocks, offsets[num_blocks]);
+    std::shared_ptr<uint8_t[]> buf(new uint8_t[layout.size]);
+    std::memset(buf.get(), 0, layout.size);
+    SortedIndexHeader header{SORTED_INDEX_FORMAT_VERSION,
+                             SORTED_INDEX_BLOCK_SIZE,
+                             num_rows,
+                             num_blocks};
+    std::memcpy(buf.get(), &header, sizeof(header));
+    std::memcpy(buf.get() + layout.widths, widths.data(), num_blocks);
+    std::memcpy(buf.get() + layout.offsets,
+                offsets.data(),
+                offsets.size() * sizeof(uint64_t));
+
+    auto words = reinterpret_cast<uint64_t*>(buf.get() + layout.words);
+    auto row_ids = reinterpret_cast<uint32_t*>(buf.get() + layout.row_ids);
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        auto begin = b * SORTED_INDEX_BLOCK_SIZE;
+        auto end =
+            std::min<uint64_t>(begin + SORTED_INDEX_BLOCK_SIZE, num_rows);
+        auto base = data[begin].a_;
+        std::memcpy(buf.get() + layout.bases + b * sizeof(T), &base, sizeof(T));
+        auto block_words = words + offsets[b];
+        auto width = widths[b];
+        for (uint64_t i = begin; i < end; ++i) {
+            row_ids[i] = uint32_t(data[i].idx_);
+            uint64_t bits = 0;
+            if constexpr (kFrameOfReference<T>) {
+                bits = Delta(data[i].a_, base);
+            } else {
+                std::memcpy(&bits, &data[i].a_, sizeof(T));
+            }
+            if (width == 0) {
+                continue;
+            }
+            auto pos = (i - begin) * width;
+            auto shift = pos % 64;
+            block_words[pos / 64] |= bits << shift;
+            if (shift + width > 64) {
+                block_words[pos / 64 + 1] |= bits >> (64 - shift);
+            }
+        }
+    }
+    return {buf, int64_t(layout.size)};
+}
+
+inline SortedIndexHeader
+ReadSortedIndexHeader(const uint8_t* buf, int64_t size) {
+    AssertInfo(size >= int64_t(sizeof(SortedIndexHeader)),
+               "sorted index data too short");
+    SortedIndexHeader header;
+    std::memcpy(&header, buf, sizeof(header));
+    AssertInfo(header.version == SORTED_INDEX_FORMAT_VERSION,
+               "unsupported sorted index format version " +
+                   std::to_string(header.version));
+    return header;
+}
+
+// decode the blocks [block_begin, block_end) into `data`, which holds
+// num_rows of the header
+template <typename T>
+inline void
+DecodeSortedIndexBlocks(const uint8_t* buf,
+                        int64_t size,
+                        uint64_t block_begin,
+                        uint64_t block_end,
+                        IndexStructure<T>* data) {
+    using namespace sorted_index_internal;
+    auto header = ReadSortedIndexHeader(buf, size);
+    std::vector<uint64_t> offsets(header.num_blocks + 1);
+    auto offsets_pos = LayoutOf<T>(0, header.num_blocks, 0).offsets;
+    std::memcpy(offsets.data(),
+                buf + offsets_pos,
+                offsets.size() * sizeof(uint64_t));
+    auto layout = LayoutOf<T>(
+        header.num_rows, header.num_blocks, offsets[header.num_blocks]);
+    AssertInfo(layout.size == uint64_t(size), "corrupted sorted index data");
+
+    auto words = buf + layout.words;
+    auto row_ids = buf + layout.row_ids;
+    for (auto b = block_begin; b < block_end; ++b) {
+        auto begin = b * header.block_size;
+        auto end = std::min<uint64_t>(begin + header.block_size,
+                                      header.num_rows);
+        T base;
+        std::memcpy(&base, buf + layout.bases + b * sizeof(T), sizeof(T));
+        auto width = buf[layout.widths + b];
+        auto block_words = words + offsets[b] * sizeof(uint64_t);
+        auto word_at = [&](uint64_t w) {
+            uint64_t word;
+            std::memcpy(&word, block_words + w * sizeof(uint64_t), 8);
+            return word;
+        };
+        auto mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        for (auto i = begin; i < end; ++i) {
+            uint64_t bits = 0;
+            if (width != 0) {
+                auto pos = (i - begin) * width;
+                auto shift = pos % 64;
+                bits = word_at(pos / 64) >> shift;
+                if (shift + width > 64) {
+                    bits |= word_at(pos / 64 + 1) << (64 - shift);
+                }
+                bits &= mask;
+            }
+            if constexpr (kFrameOfReference<T>) {
+                using U = std::make_unsigned_t<T>;
+                data[i].a_ = T(U(U(base) + U(bits)));
+            } else {
+                std::memcpy(&data[i].a_, &bits, sizeof(T));
+            }
+            uint32_t row_id;
+            std::memcpy(&row_id, row_ids + i * sizeof(uint32_t), 4);
+            data[i].idx_ = int32_t(row_id);
+        }
+    }
+}
+
+}  // namespace milvus::index
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include "common/LikePattern.h"
 #include "index/Meta.h"
 #include "index/ScalarIndex.h"
 
@@ -36,11 +37,34 @@ class StringIndex : public ScalarIndex<std::string> {
             auto prefix = dataset->Get<std::string>(PREFIX_VALUE);
             return PrefixMatch(prefix);
         }
+        if (op == OpType::PostfixMatch || op == OpType::Match) {
+            auto pattern = dataset->Get<std::string>(PATTERN_VALUE);
+            return PatternMatch(LikePattern(op, pattern));
+        }
         return ScalarIndex<std::string>::Query(dataset);
     }
 
     virtual const TargetBitmap
     PrefixMatch(const std::string_view prefix) = 0;
+
+    // number of rows PrefixMatch would match, -1 if unknown
+    virtual int64_t
+    CountPrefixMatch(const std::string_view prefix) {
+        return -1;
+    }
+
+    // the rows matching the pattern of a PostfixMatch or a Match, the
+    // default reads every row back to test it
+    virtual const TargetBitmap
+    PatternMatch(const LikePattern& pattern) {
+        std::vector<std::string> values(Count());
+        ReverseLookupAll(values.data());
+        TargetBitmap bitset(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            bitset[i] = pattern(values[i]);
+        }
+        return bitset;
+    }
 };
 using StringIndexPtr = std::unique_ptr<StringIndex>;
 }  // namespace milvus::index
@@ -0,0 +1,468 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "index/StringIndexInverted.h"
+#include "index/Meta.h"
+#include "common/Utils.h"
+#include "common/Slice.h"
+
+namespace milvus::index {
+
+namespace {
+// rows of a posting of wide ranges are set by a scan of the row terms
+constexpr int64_t POSTING_SCAN_RATIO = 8;
+}  // namespace
+
+void
+StringIndexInverted::Build(size_t n, const std::string* values) {
+    if (built_) {
+        throw std::runtime_error("index has been built");
+    }
+    AssertInfo(n <= std::numeric_limits<uint32_t>::max(),
+               "too many rows for an inverted index: " + std::to_string(n));
+
+    // number the distinct strings in the order they show up first, then
+    // renumber them by their sorted order
+    std::unordered_map<std::string_view, uint32_t> first_ids;
+    row_terms_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto [it, _] = first_ids.emplace(values[i], first_ids.size());
+        row_terms_[i] = it->second;
+    }
+    std::vector<std::string_view> keys(first_ids.size());
+    for (auto& [key, id] : first_ids) {
+        keys[id] = key;
+    }
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return keys[a] < keys[b];
+    });
+    std::vector<uint32_t> renumber(keys.size());
+    terms_.clear();
+    terms_.reserve(keys.size());
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        renumber[order[rank]] = rank;
+        terms_.emplace_back(keys[order[rank]]);
+    }
+    for (auto& term : row_terms_) {
+        term = renumber[term];
+    }
+
+    fill_dictionary();
+    fill_postings();
+    built_ = true;
+}
+
+void
+StringIndexInverted::fill_dictionary() {
+    term_ids_.clear();
+    term_ids_.reserve(terms_.size());
+    for (size_t id = 0; id < terms_.size(); ++id) {
+        term_ids_.emplace(terms_[id], id);
+    }
+}
+
+void
+StringIndexInverted::fill_postings() {
+    auto num_terms = terms_.size();
+    posting_counts_.assign(num_terms, 0);
+    for (auto term : row_terms_) {
+        ++posting_counts_[term];
+    }
+
+    // counting sort of the rows by term, then each posting is encoded as the
+    // deltas of its ascending rows
+    std::vector<size_t> cursors(num_terms + 1, 0);
+    std::partial_sum(
+        posting_counts_.begin(), posting_counts_.end(), cursors.begin() + 1);
+    std::vector<uint32_t> rows(row_terms_.size());
+    for (size_t row = 0; row < row_terms_.size(); ++row) {
+        rows[cursors[row_terms_[row]]++] = row;
+    }
+
+    postings_.clear();
+    posting_begins_.resize(num_terms + 1);
+    size_t row_begin = 0;
+    for (size_t id = 0; id < num_terms; ++id) {
+        posting_begins_[id] = postings_.size();
+        uint32_t last = 0;
+        for (size_t i = 0; i < posting_counts_[id]; ++i) {
+            auto row = rows[row_begin + i];
+            append_varint(postings_, row - last);
+            last = row;
+        }
+        row_begin += posting_counts_[id];
+    }
+    posting_begins_[num_terms] = postings_.size();
+    postings_.shrink_to_fit();
+}
+
+BinarySet
+StringIndexInverted::Serialize(const Config& config) {
+    AssertInfo(built_, "index has not been built");
+
+    size_t terms_len = 0;
+    for (auto& term : terms_) {
+        terms_len += sizeof(uint32_t) + term.size();
+    }
+    std::shared_ptr<uint8_t[]> terms(new uint8_t[terms_len]);
+    auto ptr = terms.get();
+    for (auto& term : terms_) {
+        uint32_t len = term.size();
+        memcpy(ptr, &len, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
+        memcpy(ptr, term.data(), len);
+        ptr += len;
+    }
+
+    auto counts_len = posting_counts_.size() * sizeof(uint32_t);
+    std::shared_ptr<uint8_t[]> counts(new uint8_t[counts_len]);
+    memcpy(counts.get(), posting_counts_.data(), counts_len);
+
+    std::shared_ptr<uint8_t[]> postings(new uint8_t[postings_.size()]);
+    memcpy(postings.get(), postings_.data(), postings_.size());
+
+    BinarySet res_set;
+    res_set.Append(INVERTED_INDEX_TERMS, terms, terms_len);
+    res_set.Append(INVERTED_INDEX_COUNTS, counts, counts_len);
+    res_set.Append(INVERTED_INDEX_POSTINGS, postings, postings_.size());
+
+    milvus::Disassemble(res_set);
+
+    return res_set;
+}
+
+void
+StringIndexInverted::Load(const BinarySet& set, const Config& config) {
+    milvus::Assemble(const_cast<BinarySet&>(set));
+
+    auto terms = set.GetByName(INVERTED_INDEX_TERMS);
+    auto ptr = terms->data.get();
+    auto end = ptr + terms->size;
+    terms_.clear();
+    while (ptr < end) {
+        uint32_t len;
+        AssertInfo(size_t(end - ptr) >= sizeof(uint32_t),
+                   "inverted index terms are truncated");
+        memcpy(&len, ptr, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
+        AssertInfo(size_t(end - ptr) >= len,
+                   "inverted index terms are truncated");
+        terms_.emplace_back(reinterpret_cast<const char*>(ptr), len);
+        ptr += len;
+    }
+
+    auto counts = set.GetByName(INVERTED_INDEX_COUNTS);
+    AssertInfo(size_t(counts->size) == terms_.size() * sizeof(uint32_t),
+               "inverted index terms and postings don't match");
+    posting_counts_.resize(terms_.size());
+    memcpy(posting_counts_.data(), counts->data.get(), counts->size);
+
+    auto postings = set.GetByName(INVERTED_INDEX_POSTINGS);
+    postings_.assign(postings->data.get(),
+                     postings->data.get() + postings->size);
+
+    // the row terms are not stored, every posting is decoded once for them
+    auto num_rows = std::accumulate(
+        posting_counts_.begin(), posting_counts_.end(), size_t(0));
+    row_terms_.resize(num_rows);
+    posting_begins_.resize(terms_.size() + 1);
+    const uint8_t* pos = postings_.data();
+    for (size_t id = 0; id < terms_.size(); ++id) {
+        posting_begins_[id] = pos - postings_.data();
+        uint32_t row = 0;
+        for (size_t i = 0; i < posting_counts_[id]; ++i) {
+            row += read_varint(pos);
+            AssertInfo(row < num_rows, "inverted index row out of range");
+            row_terms_[row] = id;
+        }
+    }
+    posting_begins_[terms_.size()] = pos - postings_.data();
+    AssertInfo(posting_begins_[terms_.size()] == postings_.size(),
+               "inverted index postings are corrupted");
+
+    fill_dictionary();
+    built_ = true;
+}
+
+int64_t
+StringIndexInverted::lookup(const std::string_view str) const {
+    auto it = term_ids_.find(str);
+    if (it == term_ids_.end()) {
+        return -1;
+    }
+    return it->second;
+}
+
+std::vector<size_t>
+StringIndexInverted::lookup_all(size_t n, const std::string* values) const {
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < n; ++i) {
+        auto id = lookup(values[i]);
+        if (id >= 0) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+void
+StringIndexInverted::fill_posting(size_t term_id,
+                                  TargetBitmap& bitset,
+                                  bool value) const {
+    const uint8_t* pos = postings_.data() + posting_begins_[term_id];
+    uint32_t row = 0;
+    for (size_t i = 0; i < posting_counts_[term_id]; ++i) {
+        row += read_varint(pos);
+        bitset[row] = value;
+    }
+}
+
+int64_t
+StringIndexInverted::count_term_range(size_t begin, size_t end) const {
+    int64_t count = 0;
+    for (auto id = begin; id < end; ++id) {
+        count += posting_counts_[id];
+    }
+    return count;
+}
+
+void
+StringIndexInverted::fill_term_range(size_t begin,
+                                     size_t end,
+                                     TargetBitmap& bitset) const {
+    auto count = count_term_range(begin, end);
+    if (count * POSTING_SCAN_RATIO > int64_t(row_terms_.size())) {
+        for (size_t row = 0; row < row_terms_.size(); ++row) {
+            auto term = row_terms_[row];
+            bitset[row] = term >= begin && term < end;
+        }
+        return;
+    }
+    for (auto id = begin; id < end; ++id) {
+        fill_posting(id, bitset, true);
+    }
+}
+
+void
+StringIndexInverted::fill_terms(const std::vector<size_t>& term_ids,
+                                TargetBitmap& bitset) const {
+    int64_t count = 0;
+    for (auto id : term_ids) {
+        count += posting_counts_[id];
+    }
+    if (count * POSTING_SCAN_RATIO > int64_t(row_terms_.size())) {
+        std::vector<bool> matched(terms_.size());
+        for (auto id : term_ids) {
+            matched[id] = true;
+        }
+        for (size_t row = 0; row < row_terms_.size(); ++row) {
+            bitset[row] = matched[row_terms_[row]];
+        }
+        return;
+    }
+    for (auto id : term_ids) {
+        fill_posting(id, bitset, true);
+    }
+}
+
+size_t
+StringIndexInverted::term_rank(const std::string_view value,
+                               bool inclusive) const {
+    auto it = inclusive
+                  ? std::upper_bound(terms_.begin(), terms_.end(), value)
+                  : std::lower_bound(terms_.begin(), terms_.end(), value);
+    return it - terms_.begin();
+}
+
+std::pair<size_t, size_t>
+StringIndexInverted::term_range(const std::string& value, OpType op) const {
+    switch (op) {
+        case OpType::LessThan:
+            return {0, term_rank(value, false)};
+        case OpType::LessEqual:
+            return {0, term_rank(value, true)};
+        case OpType::GreaterThan:
+            return {term_rank(value, true), terms_.size()};
+        case OpType::GreaterEqual:
+            return {term_rank(value, false), terms_.size()};
+        default:
+            throw std::invalid_argument(std::string("Invalid OperatorType: ") +
+                                        std::to_string((int)op) + "!");
+    }
+}
+
+std::pair<size_t, size_t>
+StringIndexInverted::term_range(const std::string& lower_bound_value,
+                                bool lb_inclusive,
+                                const std::string& upper_bound_value,
+                                bool ub_inclusive) const {
+    if (lower_bound_value.compare(upper_bound_value) > 0 ||
+        (lower_bound_value.compare(upper_bound_value) == 0 &&
+         !(lb_inclusive && ub_inclusive))) {
+        return {0, 0};
+    }
+    auto begin = term_rank(lower_bound_value, !lb_inclusive);
+    auto end = term_rank(upper_bound_value, ub_inclusive);
+    return {begin, std::max(begin, end)};
+}
+
+std::pair<size_t, size_t>
+StringIndexInverted::prefix_range(const std::string_view prefix) const {
+    // the terms with the prefix follow each other in the sorted terms
+    auto begin = std::lower_bound(terms_.begin(), terms_.end(), prefix);
+    auto end = std::partition_point(begin, terms_.end(), [&](auto& term) {
+        return milvus::PrefixMatch(term, prefix);
+    });
+    return {begin - terms_.begin(), end - terms_.begin()};
+}
+
+const TargetBitmap
+StringIndexInverted::In(size_t n, const std::string* values) {
+    AssertInfo(built_, "index has not been built");
+    TargetBitmap bitset(Count());
+    for (auto id : lookup_all(n, values)) {
+        fill_posting(id, bitset, true);
+    }
+    return bitset;
+}
+
+const TargetBitmap
+StringIndexInverted::NotIn(size_t n, const std::string* values) {
+    AssertInfo(built_, "index has not been built");
+    TargetBitmap bitset(Count(), true);
+    for (auto id : lookup_all(n, values)) {
+        fill_posting(id, bitset, false);
+    }
+    return bitset;
+}
+
+const TargetBitmap
+StringIndexInverted::Range(std::string value, OpType op) {
+    AssertInfo(built_, "index has not been built");
+    TargetBitmap bitset(Count());
+    auto [begin, end] = term_range(value, op);
+    fill_term_range(begin, end, bitset);
+    return bitset;
+}
+
+const TargetBitmap
+StringIndexInverted::Range(std::string lower_bound_value,
+                           bool lb_inclusive,
+                           std::string upper_bound_value,
+                           bool ub_inclusive) {
+    AssertInfo(built_, "index has not been built");
+    TargetBitmap bitset(Count());
+    auto [begin, end] = term_range(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    fill_term_range(begin, end, bitset);
+    return bitset;
+}
+
+const TargetBitmap
+StringIndexInverted::PrefixMatch(const std::string_view prefix) {
+    AssertInfo(built_, "index has not been built");
+    TargetBitmap bitset(Count());
+    auto [begin, end] = prefix_range(prefix);
+    fill_term_range(begin, end, bitset);
+    return bitset;
+}
+
+const TargetBitmap
+StringIndexInverted::PatternMatch(const LikePattern& pattern) {
+    AssertInfo(built_, "index has not been built");
+    std::vector<size_t> matched;
+    for (size_t id = 0; id < terms_.size(); ++id) {
+        if (pattern(terms_[id])) {
+            matched.push_back(id);
+        }
+    }
+    TargetBitmap bitset(Count());
+    fill_terms(matched, bitset);
+    return bitset;
+}
+
+int64_t
+StringIndexInverted::CountIn(size_t n, const std::string* values) {
+    AssertInfo(built_, "index has not been built");
+    int64_t count = 0;
+    for (auto id : lookup_all(n, values)) {
+        count += posting_counts_[id];
+    }
+    return count;
+}
+
+int64_t
+StringIndexInverted::CountRange(std::string value, OpType op) {
+    AssertInfo(built_, "index has not been built");
+    auto [begin, end] = term_range(value, op);
+    return count_term_range(begin, end);
+}
+
+int64_t
+StringIndexInverted::CountRange(std::string lower_bound_value,
+                                bool lb_inclusive,
+                                std::string upper_bound_value,
+                                bool ub_inclusive) {
+    AssertInfo(built_, "index has not been built");
+    auto [begin, end] = term_range(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    return count_term_range(begin, end);
+}
+
+int64_t
+StringIndexInverted::CountPrefixMatch(const std::string_view prefix) {
+    AssertInfo(built_, "index has not been built");
+    auto [begin, end] = prefix_range(prefix);
+    return count_term_range(begin, end);
+}
+
+std::string
+StringIndexInverted::Reverse_Lookup(size_t offset) const {
+    AssertInfo(offset < row_terms_.size(), "out of range of total count");
+    return terms_[row_terms_[offset]];
+}
+
+void
+StringIndexInverted::ReverseLookupAll(std::string* values) {
+    AssertInfo(built_, "index has not been built");
+    for (size_t row = 0; row < row_terms_.size(); ++row) {
+        values[row] = terms_[row_terms_[row]];
+    }
+}
+
+void
+StringIndexInverted::ReverseLookupBatch(const int64_t* offsets,
+                                        int64_t n,
+                                        std::string* values) const {
+    AssertInfo(built_, "index has not been built");
+    for (int64_t i = 0; i < n; ++i) {
+        AssertInfo(offsets[i] >= 0 && size_t(offsets[i]) < row_terms_.size(),
+                   "out of range of total count");
+        values[i] = terms_[row_terms_[offsets[i]]];
+    }
+}
+
+}  // namespace milvus::index
@@ -0,0 +1,200 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "index/StringIndex.h"
+
+namespace milvus::index {
+
+// Term dictionary of the distinct strings, each with a posting list of the
+// rows holding it. A term filter hashes its values into the dictionary and
+// only walks the postings of the matches.
+class StringIndexInverted : public StringIndex {
+ public:
+    StringIndexInverted() = default;
+
+    int64_t
+    Size() override {
+        return Count();
+    }
+
+    BinarySet
+    Serialize(const Config& config) override;
+
+    void
+    Load(const BinarySet& set, const Config& config = {}) override;
+
+    int64_t
+    Count() override {
+        return row_terms_.size();
+    }
+
+    void
+    Build(size_t n, const std::string* values) override;
+
+    const TargetBitmap
+    In(size_t n, const std::string* values) override;
+
+    const TargetBitmap
+    NotIn(size_t n, const std::string* values) override;
+
+    const TargetBitmap
+    Range(std::string value, OpType op) override;
+
+    const TargetBitmap
+    Range(std::string lower_bound_value,
+          bool lb_inclusive,
+          std::string upper_bound_value,
+          bool ub_inclusive) override;
+
+    const TargetBitmap
+    PrefixMatch(const std::string_view prefix) override;
+
+    int64_t
+    CountIn(size_t n, const std::string* values) override;
+
+    int64_t
+    CountRange(std::string value, OpType op) override;
+
+    int64_t
+    CountRange(std::string lower_bound_value,
+               bool lb_inclusive,
+               std::string upper_bound_value,
+               bool ub_inclusive) override;
+
+    int64_t
+    CountPrefixMatch(const std::string_view prefix) override;
+
+    // tests every term rather than every row
+    const TargetBitmap
+    PatternMatch(const LikePattern& pattern) override;
+
+    std::string
+    Reverse_Lookup(size_t offset) const override;
+
+    void
+    ReverseLookupAll(std::string* values) override;
+
+    size_t
+    NumTerms() const {
+        return terms_.size();
+    }
+
+ protected:
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       int64_t n,
+                       std::string* values) const override;
+
+    static void
+    append_varint(std::vector<uint8_t>& buf, uint32_t value) {
+        while (value >= 0x80) {
+            buf.push_back(uint8_t(value | 0x80));
+            value >>= 7;
+        }
+        buf.push_back(uint8_t(value));
+    }
+
+    static uint32_t
+    read_varint(const uint8_t*& ptr) {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            auto byte = *ptr++;
+            value |= uint32_t(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    // terms_ indexed by term, and the postings from row_terms_
+    void
+    fill_dictionary();
+
+    void
+    fill_postings();
+
+    // term id of str, -1 if str is not a term
+    int64_t
+    lookup(const std::string_view str) const;
+
+    // distinct term ids of the values which are terms
+    std::vector<size_t>
+    lookup_all(size_t n, const std::string* values) const;
+
+    // number of terms less than value, or not greater than it if inclusive
+    size_t
+    term_rank(const std::string_view value, bool inclusive) const;
+
+    // [begin, end) of the terms a range or a prefix matches
+    std::pair<size_t, size_t>
+    term_range(const std::string& value, OpType op) const;
+
+    std::pair<size_t, size_t>
+    term_range(const std::string& lower_bound_value,
+               bool lb_inclusive,
+               const std::string& upper_bound_value,
+               bool ub_inclusive) const;
+
+    std::pair<size_t, size_t>
+    prefix_range(const std::string_view prefix) const;
+
+    // set the rows of the terms in [begin, end), walking their postings or
+    // scanning the row terms when the terms cover many rows
+    void
+    fill_term_range(size_t begin, size_t end, TargetBitmap& bitset) const;
+
+    void
+    fill_posting(size_t term_id, TargetBitmap& bitset, bool value) const;
+
+    // set the rows of the term ids, walking their postings or scanning
+    // the row terms as fill_term_range does
+    void
+    fill_terms(const std::vector<size_t>& term_ids,
+               TargetBitmap& bitset) const;
+
+    int64_t
+    count_term_range(size_t begin, size_t end) const;
+
+ protected:
+    std::vector<std::string> terms_;  // sorted distinct strings
+    std::unordered_map<std::string_view, uint32_t> term_ids_;
+    // rows of each term, ascending, as varint deltas in
+    // postings_[posting_begins_[id], posting_begins_[id + 1])
+    std::vector<uint32_t> posting_counts_;
+    std::vector<size_t> posting_begins_;
+    std::vector<uint8_t> postings_;
+    std::vector<uint32_t> row_terms_;  // used to retrieve.
+    bool built_ = false;
+};
+
+using StringIndexInvertedPtr = std::unique_ptr<StringIndexInverted>;
+
+inline StringIndexPtr
+CreateStringIndexInverted() {
+    return std::make_unique<StringIndexInverted>();
+}
+
+}  // namespace milvus::index
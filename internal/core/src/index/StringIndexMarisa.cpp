@@ -20,6 +20,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <string_view>
+#include <unordered_set>
 
 #include "index/StringIndexMarisa.h"
 #include "index/Utils.h"
@@ -42,11 +47,27 @@ StringIndexMarisa::Build(size_t n, const std::string* values) {
         throw std::runtime_error("index has been built");
     }
 
+    // the distinct keys are collected by shards in parallel and merged, so
+    // the key set holds every key once instead of once per row
+    std::mutex shards_mutex;
+    std::vector<std::unordered_set<std::string_view>> shards;
+    ParallelForRanges(
+        n, MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            std::unordered_set<std::string_view> keys;
+            for (auto i = begin; i < end; ++i) {
+                keys.emplace(values[i].c_str());
+            }
+            std::lock_guard<std::mutex> lck(shards_mutex);
+            shards.emplace_back(std::move(keys));
+        });
+    for (size_t i = 1; i < shards.size(); ++i) {
+        shards[0].merge(shards[i]);
+    }
+
     marisa::Keyset keyset;
-    {
-        // fill key set.
-        for (size_t i = 0; i < n; i++) {
-            keyset.push_back(values[i].c_str());
+    if (!shards.empty()) {
+        for (auto& key : shards[0]) {
+            keyset.push_back(key.data(), key.size());
         }
     }
 
@@ -134,10 +155,7 @@ StringIndexMarisa::In(size_t n, const std::string* values) {
         auto str = values[i];
         auto str_id = lookup(str);
         if (valid_str_id(str_id)) {
-            auto offsets = str_ids_to_offsets_[str_id];
-            for (auto offset : offsets) {
-                bitset[offset] = true;
-            }
+            fill_postings(str_id, bitset, true);
         }
     }
     return bitset;
@@ -150,10 +168,7 @@ StringIndexMarisa::NotIn(size_t n, const std::string* values) {
         auto str = values[i];
         auto str_id = lookup(str);
         if (valid_str_id(str_id)) {
-            auto offsets = str_ids_to_offsets_[str_id];
-            for (auto offset : offsets) {
-                bitset[offset] = false;
-            }
+            fill_postings(str_id, bitset, false);
         }
     }
     return bitset;
@@ -161,35 +176,24 @@ StringIndexMarisa::NotIn(size_t n, const std::string* values) {
 
 const TargetBitmap
 StringIndexMarisa::Range(std::string value, OpType op) {
-    auto count = Count();
-    TargetBitmap bitset(count);
-    marisa::Agent agent;
-    for (size_t offset = 0; offset < count; ++offset) {
-        agent.set_query(str_ids_[offset]);
-        trie_.reverse_lookup(agent);
-        std::string raw_data(agent.key().ptr(), agent.key().length());
-        bool set = false;
-        switch (op) {
-            case OpType::LessThan:
-                set = raw_data.compare(value) < 0;
-                break;
-            case OpType::LessEqual:
-                set = raw_data.compare(value) <= 0;
-                break;
-            case OpType::GreaterThan:
-                set = raw_data.compare(value) > 0;
-                break;
-            case OpType::GreaterEqual:
-                set = raw_data.compare(value) >= 0;
-                break;
-            default:
-                throw std::invalid_argument(
-                    std::string("Invalid OperatorType: ") +
-                    std::to_string((int)op) + "!");
-        }
-        if (set) {
-            bitset[offset] = true;
-        }
+    TargetBitmap bitset(Count());
+    auto num_keys = sorted_str_ids_.size();
+    switch (op) {
+        case OpType::LessThan:
+            fill_rank_range(0, key_rank(value, false), bitset);
+            break;
+        case OpType::LessEqual:
+            fill_rank_range(0, key_rank(value, true), bitset);
+            break;
+        case OpType::GreaterThan:
+            fill_rank_range(key_rank(value, true), num_keys, bitset);
+            break;
+        case OpType::GreaterEqual:
+            fill_rank_range(key_rank(value, false), num_keys, bitset);
+            break;
+        default:
+            throw std::invalid_argument(std::string("Invalid OperatorType: ") +
+                                        std::to_string((int)op) + "!");
     }
     return bitset;
 }
@@ -199,33 +203,15 @@ StringIndexMarisa::Range(std::string lower_bound_value,
                          bool lb_inclusive,
                          std::string upper_bound_value,
                          bool ub_inclusive) {
-    auto count = Count();
-    TargetBitmap bitset(count);
+    TargetBitmap bitset(Count());
     if (lower_bound_value.compare(upper_bound_value) > 0 ||
         (lower_bound_value.compare(upper_bound_value) == 0 &&
          !(lb_inclusive && ub_inclusive))) {
         return bitset;
     }
-    marisa::Agent agent;
-    for (size_t offset = 0; offset < count; ++offset) {
-        agent.set_query(str_ids_[offset]);
-        trie_.reverse_lookup(agent);
-        std::string raw_data(agent.key().ptr(), agent.key().length());
-        bool set = true;
-        if (lb_inclusive) {
-            set &= raw_data.compare(lower_bound_value) >= 0;
-        } else {
-            set &= raw_data.compare(lower_bound_value) > 0;
-        }
-        if (ub_inclusive) {
-            set &= raw_data.compare(upper_bound_value) <= 0;
-        } else {
-            set &= raw_data.compare(upper_bound_value) < 0;
-        }
-        if (set) {
-            bitset[offset] = true;
-        }
-    }
+    fill_rank_range(key_rank(lower_bound_value, !lb_inclusive),
+                    key_rank(upper_bound_value, ub_inclusive),
+                    bitset);
     return bitset;
 }
 
@@ -234,33 +220,124 @@ StringIndexMarisa::PrefixMatch(std::string_view prefix) {
     TargetBitmap bitset(str_ids_.size());
     auto matched = prefix_match(prefix);
     for (const auto str_id : matched) {
-        auto offsets = str_ids_to_offsets_[str_id];
-        for (auto offset : offsets) {
-            bitset[offset] = true;
-        }
+        fill_postings(str_id, bitset, true);
     }
     return bitset;
 }
 
+int64_t
+StringIndexMarisa::CountIn(size_t n, const std::string* values) {
+    std::set<size_t> str_ids;
+    for (size_t i = 0; i < n; i++) {
+        auto str_id = lookup(values[i]);
+        if (valid_str_id(str_id)) {
+            str_ids.insert(str_id);
+        }
+    }
+    int64_t count = 0;
+    for (auto str_id : str_ids) {
+        count += posting_size(str_id);
+    }
+    return count;
+}
+
+int64_t
+StringIndexMarisa::CountPrefixMatch(std::string_view prefix) {
+    int64_t count = 0;
+    for (const auto str_id : prefix_match(prefix)) {
+        count += posting_size(str_id);
+    }
+    return count;
+}
+
 void
 StringIndexMarisa::fill_str_ids(size_t n, const std::string* values) {
     str_ids_.resize(n);
-    for (size_t i = 0; i < n; i++) {
-        auto str = values[i];
-        auto str_id = lookup(str);
-        assert(valid_str_id(str_id));
-        str_ids_[i] = str_id;
-    }
+    ParallelForRanges(
+        n, MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto str_id = lookup(values[i]);
+                assert(valid_str_id(str_id));
+                str_ids_[i] = str_id;
+            }
+        });
 }
 
 void
 StringIndexMarisa::fill_offsets() {
+    auto num_keys = trie_.num_keys();
+
+    // counting sort of the offsets by str id
+    posting_begins_.assign(num_keys + 1, 0);
+    for (auto str_id : str_ids_) {
+        ++posting_begins_[str_id + 1];
+    }
+    std::partial_sum(posting_begins_.begin(),
+                     posting_begins_.end(),
+                     posting_begins_.begin());
+    std::vector<size_t> cursors(posting_begins_.begin(),
+                                posting_begins_.end() - 1);
+    postings_.resize(str_ids_.size());
     for (size_t offset = 0; offset < str_ids_.size(); offset++) {
-        auto str_id = str_ids_[offset];
-        if (str_ids_to_offsets_.find(str_id) == str_ids_to_offsets_.end()) {
-            str_ids_to_offsets_[str_id] = std::vector<size_t>{};
+        postings_[cursors[str_ids_[offset]]++] = offset;
+    }
+
+    std::vector<std::string> keys(num_keys);
+    marisa::Agent agent;
+    for (size_t str_id = 0; str_id < num_keys; ++str_id) {
+        keys[str_id] = key_of(agent, str_id);
+    }
+    sorted_str_ids_.resize(num_keys);
+    std::iota(sorted_str_ids_.begin(), sorted_str_ids_.end(), 0);
+    std::sort(sorted_str_ids_.begin(),
+              sorted_str_ids_.end(),
+              [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+}
+
+std::string_view
+StringIndexMarisa::key_of(marisa::Agent& agent, size_t str_id) const {
+    agent.set_query(str_id);
+    trie_.reverse_lookup(agent);
+    return {agent.key().ptr(), agent.key().length()};
+}
+
+size_t
+StringIndexMarisa::key_rank(const std::string& value, bool inclusive) const {
+    marisa::Agent agent;
+    auto before_end = [&](size_t str_id) {
+        auto cmp = key_of(agent, str_id).compare(value);
+        return inclusive ? cmp <= 0 : cmp < 0;
+    };
+    // keys before the rank satisfy before_end, the others do not
+    size_t lo = 0;
+    size_t hi = sorted_str_ids_.size();
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (before_end(sorted_str_ids_[mid])) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
-        str_ids_to_offsets_[str_id].push_back(offset);
+    }
+    return lo;
+}
+
+void
+StringIndexMarisa::fill_rank_range(size_t begin,
+                                   size_t end,
+                                   TargetBitmap& bitset) const {
+    for (auto rank = begin; rank < end; ++rank) {
+        fill_postings(sorted_str_ids_[rank], bitset, true);
+    }
+}
+
+void
+StringIndexMarisa::fill_postings(size_t str_id,
+                                 TargetBitmap& bitset,
+                                 bool value) const {
+    for (auto i = posting_begins_[str_id]; i < posting_begins_[str_id + 1];
+         ++i) {
+        bitset[postings_[i]] = value;
     }
 }
 
@@ -296,6 +373,29 @@ StringIndexMarisa::Reverse_Lookup(size_t offset) const {
     return std::string(agent.key().ptr(), agent.key().length());
 }
 
+void
+StringIndexMarisa::ReverseLookupBatch(const int64_t* offsets,
+                                      int64_t n,
+                                      std::string* values) const {
+    // (str id, position), rows of the same key look it up once
+    std::vector<std::pair<size_t, int64_t>> keys(n);
+    for (int64_t i = 0; i < n; ++i) {
+        AssertInfo(offsets[i] >= 0 && size_t(offsets[i]) < str_ids_.size(),
+                   "out of range of total count");
+        keys[i] = {str_ids_[offsets[i]], i};
+    }
+    std::sort(keys.begin(), keys.end());
+    marisa::Agent agent;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto [str_id, pos] = keys[i];
+        if (i > 0 && keys[i - 1].first == str_id) {
+            values[pos] = values[keys[i - 1].second];
+        } else {
+            values[pos] = key_of(agent, str_id);
+        }
+    }
+}
+
 #endif
 
 }  // namespace milvus::index
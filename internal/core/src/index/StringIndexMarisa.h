@@ -22,7 +22,6 @@
 #include "index/StringIndex.h"
 #include <string>
 #include <vector>
-#include <map>
 #include <memory>
 
 namespace milvus::index {
@@ -45,6 +44,14 @@ class StringIndexMarisa : public StringIndex {
         return str_ids_.size();
     }
 
+    int64_t
+    ByteSize() override {
+        return trie_.io_size() +
+               (str_ids_.capacity() + posting_begins_.capacity() +
+                postings_.capacity() + sorted_str_ids_.capacity()) *
+                   sizeof(size_t);
+    }
+
     void
     Build(size_t n, const std::string* values) override;
 
@@ -66,9 +73,22 @@ class StringIndexMarisa : public StringIndex {
     const TargetBitmap
     PrefixMatch(const std::string_view prefix) override;
 
+    int64_t
+    CountIn(size_t n, const std::string* values) override;
+
+    int64_t
+    CountPrefixMatch(const std::string_view prefix) override;
+
     std::string
     Reverse_Lookup(size_t offset) const override;
 
+ protected:
+    // looks every distinct key up once, in the order of the key ids
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       int64_t n,
+                       std::string* values) const override;
+
  private:
     void
     fill_str_ids(size_t n, const std::string* values);
@@ -83,11 +103,35 @@ class StringIndexMarisa : public StringIndex {
     std::vector<size_t>
     prefix_match(const std::string_view prefix);
 
+    std::string_view
+    key_of(marisa::Agent& agent, size_t str_id) const;
+
+    // number of keys less than value, or not greater than it if inclusive
+    size_t
+    key_rank(const std::string& value, bool inclusive) const;
+
+    // set the offsets of the keys ranked in [begin, end)
+    void
+    fill_rank_range(size_t begin, size_t end, TargetBitmap& bitset) const;
+
+    void
+    fill_postings(size_t str_id, TargetBitmap& bitset, bool value) const;
+
+    size_t
+    posting_size(size_t str_id) const {
+        return posting_begins_[str_id + 1] - posting_begins_[str_id];
+    }
+
  private:
     Config config_;
     marisa::Trie trie_;
     std::vector<size_t> str_ids_;  // used to retrieve.
-    std::map<size_t, std::vector<size_t>> str_ids_to_offsets_;
+    // offsets of every str id, ascending, postings_[posting_begins_[id],
+    // posting_begins_[id + 1]) belong to str id `id`
+    std::vector<size_t> posting_begins_;
+    std::vector<size_t> postings_;
+    // str ids sorted by their keys, the trie assigns ids in its own order
+    std::vector<size_t> sorted_str_ids_;
     bool built_ = false;
 };
 
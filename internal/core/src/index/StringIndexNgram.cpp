@@ -0,0 +1,158 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "index/StringIndexNgram.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace milvus::index {
+
+namespace {
+
+// appends the trigrams of the bytes of str to grams
+void
+append_grams(std::string_view str, std::vector<uint32_t>& grams) {
+    for (size_t i = 0; i + 3 <= str.size(); ++i) {
+        grams.push_back(uint32_t(uint8_t(str[i])) << 16 |
+                        uint32_t(uint8_t(str[i + 1])) << 8 |
+                        uint32_t(uint8_t(str[i + 2])));
+    }
+}
+
+}  // namespace
+
+void
+StringIndexNgram::Build(size_t n, const std::string* values) {
+    StringIndexInverted::Build(n, values);
+    fill_grams();
+}
+
+void
+StringIndexNgram::Load(const BinarySet& set, const Config& config) {
+    StringIndexInverted::Load(set, config);
+    fill_grams();
+}
+
+void
+StringIndexNgram::fill_grams() {
+    // every (gram, term) once, sorted by gram then term
+    std::vector<std::pair<uint32_t, uint32_t>> entries;
+    std::vector<uint32_t> grams;
+    for (size_t id = 0; id < terms_.size(); ++id) {
+        grams.clear();
+        append_grams(terms_[id], grams);
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        for (auto gram : grams) {
+            entries.emplace_back(gram, id);
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    grams_.clear();
+    gram_counts_.clear();
+    gram_begins_.clear();
+    gram_postings_.clear();
+    uint32_t last = 0;
+    for (auto& [gram, id] : entries) {
+        if (grams_.empty() || grams_.back() != gram) {
+            grams_.push_back(gram);
+            gram_counts_.push_back(0);
+            gram_begins_.push_back(gram_postings_.size());
+            last = 0;
+        }
+        append_varint(gram_postings_, id - last);
+        ++gram_counts_.back();
+        last = id;
+    }
+    gram_begins_.push_back(gram_postings_.size());
+    grams_.shrink_to_fit();
+    gram_counts_.shrink_to_fit();
+    gram_begins_.shrink_to_fit();
+    gram_postings_.shrink_to_fit();
+}
+
+std::optional<std::vector<size_t>>
+StringIndexNgram::candidate_terms(const LikePattern& pattern) const {
+    std::vector<uint32_t> grams;
+    for (auto& literal : pattern.literals()) {
+        append_grams(literal, grams);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    if (grams.empty()) {
+        return std::nullopt;
+    }
+
+    // intersect the postings from the shortest one
+    std::vector<size_t> indexes;
+    for (auto gram : grams) {
+        auto it = std::lower_bound(grams_.begin(), grams_.end(), gram);
+        if (it == grams_.end() || *it != gram) {
+            return std::vector<size_t>{};
+        }
+        indexes.push_back(it - grams_.begin());
+    }
+    std::sort(indexes.begin(), indexes.end(), [&](size_t a, size_t b) {
+        return gram_counts_[a] < gram_counts_[b];
+    });
+    auto decode = [&](size_t index) {
+        std::vector<size_t> ids(gram_counts_[index]);
+        const uint8_t* pos = gram_postings_.data() + gram_begins_[index];
+        size_t id = 0;
+        for (auto& x : ids) {
+            id += read_varint(pos);
+            x = id;
+        }
+        return ids;
+    };
+    auto candidates = decode(indexes[0]);
+    std::vector<size_t> intersection;
+    for (size_t i = 1; i < indexes.size() && !candidates.empty(); ++i) {
+        auto ids = decode(indexes[i]);
+        intersection.clear();
+        std::set_intersection(candidates.begin(),
+                              candidates.end(),
+                              ids.begin(),
+                              ids.end(),
+                              std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+    return candidates;
+}
+
+const TargetBitmap
+StringIndexNgram::PatternMatch(const LikePattern& pattern) {
+    AssertInfo(built_, "index has not been built");
+    auto candidates = candidate_terms(pattern);
+    if (!candidates.has_value()) {
+        return StringIndexInverted::PatternMatch(pattern);
+    }
+    // the trigrams only narrow the terms, the pattern decides
+    std::vector<size_t> matched;
+    for (auto id : candidates.value()) {
+        if (pattern(terms_[id])) {
+            matched.push_back(id);
+        }
+    }
+    TargetBitmap bitset(Count());
+    fill_terms(matched, bitset);
+    return bitset;
+}
+
+}  // namespace milvus::index
@@ -0,0 +1,77 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "index/StringIndexInverted.h"
+
+namespace milvus::index {
+
+// An inverted index which also keeps the trigrams of its terms, each with a
+// posting list of the terms holding it. The pattern of a PostfixMatch or a
+// Match only tests the terms holding every trigram of its literals, rather
+// than every term. The trigrams aren't stored, the index serializes the
+// same as StringIndexInverted and Load builds them from the terms.
+class StringIndexNgram : public StringIndexInverted {
+ public:
+    StringIndexNgram() = default;
+
+    void
+    Load(const BinarySet& set, const Config& config = {}) override;
+
+    void
+    Build(size_t n, const std::string* values) override;
+
+    const TargetBitmap
+    PatternMatch(const LikePattern& pattern) override;
+
+    size_t
+    NumGrams() const {
+        return grams_.size();
+    }
+
+ private:
+    void
+    fill_grams();
+
+    // the ascending ids of the terms holding every trigram of the literals
+    // of the pattern, none if they have no trigram
+    std::optional<std::vector<size_t>>
+    candidate_terms(const LikePattern& pattern) const;
+
+ private:
+    // sorted distinct trigrams, their three bytes in the low bits
+    std::vector<uint32_t> grams_;
+    // terms of each gram, ascending, as varint deltas in
+    // gram_postings_[gram_begins_[i], gram_begins_[i + 1])
+    std::vector<uint32_t> gram_counts_;
+    std::vector<size_t> gram_begins_;
+    std::vector<uint8_t> gram_postings_;
+};
+
+using StringIndexNgramPtr = std::unique_ptr<StringIndexNgram>;
+
+inline StringIndexPtr
+CreateStringIndexNgram() {
+    return std::make_unique<StringIndexNgram>();
+}
+
+}  // namespace milvus::index
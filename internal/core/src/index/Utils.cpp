@@ -22,6 +22,11 @@
 
 #include "index/Utils.h"
 #include "index/Meta.h"
+#include <exception>
+#include <future>
+#include "common/Common.h"
+#include "common/FieldMeta.h"
+#include "storage/ThreadPool.h"
 #include <google/protobuf/text_format.h>
 #include "exceptions/EasyAssert.h"
 #include "knowhere/comp/index_param.h"
@@ -59,6 +64,29 @@ DISK_LIST() {
     return ret;
 }
 
+std::vector<IndexType>
+GPU_LIST() {
+    static std::vector<IndexType> ret{
+        "GPU_IVF_FLAT",
+        "GPU_IVF_PQ",
+    };
+    return ret;
+}
+
+// index types whose knowhere index takes rows added after it was built
+std::vector<IndexType>
+INCREMENTAL_BUILD_LIST() {
+    static std::vector<IndexType> ret{
+        knowhere::IndexEnum::INDEX_FAISS_IDMAP,
+        knowhere::IndexEnum::INDEX_FAISS_IVFSQ8,
+        knowhere::IndexEnum::INDEX_FAISS_IVFPQ,
+        knowhere::IndexEnum::INDEX_HNSW,
+        knowhere::IndexEnum::INDEX_FAISS_BIN_IDMAP,
+        knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT,
+    };
+    return ret;
+}
+
 std::vector<std::tuple<IndexType, MetricType>>
 unsupported_index_combinations() {
     static std::vector<std::tuple<IndexType, MetricType>> ret{
@@ -83,6 +111,16 @@ is_in_disk_list(const IndexType& index_type) {
     return is_in_list<IndexType>(index_type, DISK_LIST);
 }
 
+bool
+is_in_gpu_list(const IndexType& index_type) {
+    return is_in_list<IndexType>(index_type, GPU_LIST);
+}
+
+bool
+is_in_incremental_build_list(const IndexType& index_type) {
+    return is_in_list<IndexType>(index_type, INCREMENTAL_BUILD_LIST);
+}
+
 bool
 is_unsupported(const IndexType& index_type, const MetricType& metric_type) {
     return is_in_list<std::tuple<IndexType, MetricType>>(
@@ -90,6 +128,79 @@ is_unsupported(const IndexType& index_type, const MetricType& metric_type) {
         unsupported_index_combinations);
 }
 
+IndexType
+RecommendScalarIndexType(DataType data_type, const FieldSketch& sketch) {
+    // the rows a string repeats over on average for the postings of the
+    // inverted index to be smaller than the trie
+    constexpr int64_t kInvertedMinRowsPerValue = 8;
+    auto distinct = sketch.distinct_count();
+    switch (data_type) {
+        case DataType::BOOL:
+            return BITMAP_INDEX_TYPE;
+        case DataType::INT8:
+        case DataType::INT16:
+        case DataType::INT32:
+        case DataType::INT64:
+        case DataType::FLOAT:
+        case DataType::DOUBLE:
+            return distinct <= DEFAULT_BITMAP_INDEX_CARDINALITY_LIMIT
+                       ? BITMAP_INDEX_TYPE
+                       : ASCENDING_SORT;
+        case DataType::STRING:
+        case DataType::VARCHAR:
+            return distinct * kInvertedMinRowsPerValue <= sketch.row_count()
+                       ? INVERTED_INDEX_TYPE
+                       : MARISA_TRIE;
+        default:
+            PanicInfo(fmt::format("no scalar index of data type {}",
+                                  datatype_name(data_type)));
+    }
+}
+
+void
+ParallelForRanges(size_t n,
+                  size_t min_range,
+                  const std::function<void(size_t, size_t)>& func) {
+    auto num_ranges = std::min<size_t>(
+        GetIndexBuildParallelism(), n / std::max<size_t>(min_range, 1));
+    if (num_ranges <= 1) {
+        func(0, n);
+        return;
+    }
+
+    auto& pool = ThreadPool::GetInstance();
+    auto step = (n + num_ranges - 1) / num_ranges;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = step; begin < n; begin += step) {
+        auto end = std::min(begin + step, n);
+        futures.emplace_back(
+            pool.Submit([&func, begin, end]() { func(begin, end); }));
+    }
+    // the first range runs here, the caller may be a pool worker itself
+    std::exception_ptr error;
+    try {
+        func(0, step);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // wait all ranges before rethrowing, they reference `func`
+    for (auto& future : futures) {
+        future.wait();
+    }
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
 bool
 CheckKeyInConfig(const Config& cfg, const std::string& key) {
     return cfg.contains(key);
@@ -183,6 +294,14 @@ GetIndexMetaFromConfig(const Config& config) {
     AssertInfo(build_id.has_value(), "build id not exist in index config");
     index_meta.build_id = std::stol(build_id.value());
 
+    auto index_id = index::GetValueFromConfig<std::string>(config, INDEX_ID);
+    if (index_id.has_value()) {
+        index_meta.index_id = std::stol(index_id.value());
+    }
+    index_meta.index_name =
+        index::GetValueFromConfig<std::string>(config, INDEX_NAME)
+            .value_or("");
+
     return index_meta;
 }
 
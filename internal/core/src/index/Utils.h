@@ -25,7 +25,9 @@
 #include <tuple>
 #include <map>
 #include <string>
+#include <functional>
 
+#include "common/FieldSketch.h"
 #include "common/Types.h"
 #include "index/IndexInfo.h"
 #include "storage/Types.h"
@@ -60,9 +62,30 @@ is_in_nm_list(const IndexType& index_type);
 bool
 is_in_disk_list(const IndexType& index_type);
 
+// index types searched on the device, built only with MILVUS_GPU_VERSION
+bool
+is_in_gpu_list(const IndexType& index_type);
+
+bool
+is_in_incremental_build_list(const IndexType& index_type);
+
 bool
 is_unsupported(const IndexType& index_type, const MetricType& metric_type);
 
+// the scalar index the field of the sketched values is best served by: a
+// bitmap of a few distinct values, an inverted index of strings repeated
+// over many rows, else the sorted or trie index a field gets by default
+IndexType
+RecommendScalarIndexType(DataType data_type, const FieldSketch& sketch);
+
+// split [0, n) into ranges of at least `min_range` items, at most the index
+// build parallelism of them, and run `func(begin, end)` on every range in
+// the shared thread pool. Returns once all ranges are done.
+void
+ParallelForRanges(size_t n,
+                  size_t min_range,
+                  const std::function<void(size_t, size_t)>& func);
+
 bool
 CheckKeyInConfig(const Config& cfg, const std::string& key);
 
@@ -16,6 +16,10 @@
 
 #include "index/VectorDiskIndex.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
 #include "common/Utils.h"
 #include "config/ConfigKnowhere.h"
 #include "index/Meta.h"
@@ -33,6 +37,8 @@ namespace milvus::index {
 #define kSearchListMaxValue2 65535  // used for topk > 20
 #define kPrepareDim 100
 #define kPrepareRows 1
+// rows of the sidecar at most this many bytes apart are read as one range
+#define kRawVectorReadGap 4096
 
 template <typename T>
 VectorDiskAnnIndex<T>::VectorDiskAnnIndex(
@@ -46,9 +52,12 @@ VectorDiskAnnIndex<T>::VectorDiskAnnIndex(
     auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
 
     // As we have guarded dup-load in QueryNode,
-    // this assertion failed only if the Milvus rebooted in the same pod,
-    // need to remove these files then re-load the segment
-    if (local_chunk_manager.Exist(local_index_path_prefix)) {
+    // this assertion failed only if the Milvus rebooted in the same pod.
+    // Files of a finished load are listed in the cache manifest and reused
+    // by CacheIndexToDisk, anything else is removed and re-loaded
+    if (local_chunk_manager.Exist(local_index_path_prefix) &&
+        !local_chunk_manager.Exist(local_index_path_prefix +
+                                   INDEX_CACHE_MANIFEST)) {
         local_chunk_manager.RemoveDir(local_index_path_prefix);
     }
 
@@ -71,6 +80,22 @@ VectorDiskAnnIndex<T>::Load(const BinarySet& binary_set /* not used */,
                "index file paths is empty when load disk ann index data");
     file_manager_->CacheIndexToDisk(index_files.value());
 
+    auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
+    auto raw_vector_path =
+        file_manager_->GetLocalIndexObjectPrefix() + DISK_ANN_RAW_VECTOR_FILE;
+    raw_vector_path_.clear();
+    if (local_chunk_manager.Exist(raw_vector_path)) {
+        uint32_t header[2];
+        local_chunk_manager.Read(raw_vector_path, 0, header, sizeof(header));
+        raw_vector_rows_ = header[0];
+        raw_vector_dim_ = header[1];
+        AssertInfo(local_chunk_manager.Size(raw_vector_path) ==
+                       sizeof(header) + uint64_t(raw_vector_rows_) *
+                                            raw_vector_dim_ * sizeof(float),
+                   "size of the raw vector file mismatched");
+        raw_vector_path_ = raw_vector_path;
+    }
+
     // todo : replace by index::load function later
     knowhere::DataSetPtr qs = std::make_unique<knowhere::DataSet>();
     qs->SetRows(kPrepareRows);
@@ -87,14 +112,59 @@ template <typename T>
 void
 VectorDiskAnnIndex<T>::BuildWithDataset(const DatasetPtr& dataset,
                                         const Config& config) {
+    AppendBuildData(dataset, config);
+    FinishBuild(config);
+}
+
+template <typename T>
+std::string
+VectorDiskAnnIndex<T>::GetLocalRawDataPath() const {
+    return file_manager_->GetLocalRawDataObjectPrefix() + "raw_data";
+}
+
+template <typename T>
+void
+VectorDiskAnnIndex<T>::AppendBuildData(const DatasetPtr& dataset,
+                                       const Config& config) {
+    auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
+    auto local_data_path = GetLocalRawDataPath();
+
+    auto dim = uint32_t(milvus::GetDatasetDim(dataset));
+    if (build_data_offset_ == 0) {
+        if (!local_chunk_manager.Exist(local_data_path)) {
+            local_chunk_manager.CreateFile(local_data_path);
+        }
+        // the row number is written by FinishBuild
+        uint32_t num = 0;
+        local_chunk_manager.Write(
+            local_data_path, build_data_offset_, &num, sizeof(num));
+        build_data_offset_ += sizeof(num);
+        local_chunk_manager.Write(
+            local_data_path, build_data_offset_, &dim, sizeof(dim));
+        build_data_offset_ += sizeof(dim);
+        build_data_dim_ = dim;
+    }
+    AssertInfo(build_data_dim_ == dim, "dim of the build data changed");
+
+    auto num = uint32_t(milvus::GetDatasetRows(dataset));
+    auto data_size = uint64_t(num) * dim * sizeof(float);
+    auto raw_data = const_cast<void*>(milvus::GetDatasetTensor(dataset));
+    local_chunk_manager.Write(
+        local_data_path, build_data_offset_, raw_data, data_size);
+    build_data_offset_ += data_size;
+    build_data_rows_ += num;
+}
+
+template <typename T>
+void
+VectorDiskAnnIndex<T>::FinishBuild(const Config& config) {
+    AssertInfo(build_data_rows_ > 0, "no data to build the index on");
     auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
     knowhere::Json build_config;
     build_config.update(config);
     // set data path
     auto segment_id = file_manager_->GetFileDataMeta().segment_id;
-    auto field_id = file_manager_->GetFileDataMeta().field_id;
-    auto local_data_path =
-        storage::GenFieldRawDataPathPrefix(segment_id, field_id) + "raw_data";
+    auto local_data_path = GetLocalRawDataPath();
     build_config[DISK_ANN_RAW_DATA_PATH] = local_data_path;
 
     auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
@@ -106,28 +176,28 @@ VectorDiskAnnIndex<T>::BuildWithDataset(const DatasetPtr& dataset,
                "param " + std::string(DISK_ANN_BUILD_THREAD_NUM) + "is empty");
     build_config[DISK_ANN_THREADS_NUM] = std::atoi(num_threads.value().c_str());
 
-    if (!local_chunk_manager.Exist(local_data_path)) {
-        local_chunk_manager.CreateFile(local_data_path);
-    }
-
-    int64_t offset = 0;
-    auto num = uint32_t(milvus::GetDatasetRows(dataset));
-    local_chunk_manager.Write(local_data_path, offset, &num, sizeof(num));
-    offset += sizeof(num);
-
-    auto dim = uint32_t(milvus::GetDatasetDim(dataset));
-    local_chunk_manager.Write(local_data_path, offset, &dim, sizeof(dim));
-    offset += sizeof(dim);
-
-    auto data_size = num * dim * sizeof(float);
-    auto raw_data = const_cast<void*>(milvus::GetDatasetTensor(dataset));
-    local_chunk_manager.Write(local_data_path, offset, raw_data, data_size);
+    auto num = uint32_t(build_data_rows_);
+    local_chunk_manager.Write(local_data_path, 0, &num, sizeof(num));
 
     knowhere::DataSet* ds_ptr = nullptr;
     index_.Build(*ds_ptr, build_config);
 
+    auto sidecar = build_config.value(DISK_ANN_RAW_VECTOR_SIDECAR, Config());
+    if ((sidecar.is_boolean() && sidecar.get<bool>()) ||
+        (sidecar.is_string() && sidecar.get<std::string>() == "true")) {
+        // the raw data file is the sidecar already, it's uploaded with the
+        // files of the index
+        auto raw_vector_path =
+            local_index_path_prefix + DISK_ANN_RAW_VECTOR_FILE;
+        std::filesystem::rename(local_data_path, raw_vector_path);
+        AssertInfo(file_manager_->AddFile(raw_vector_path),
+                   "failed to add the raw vector file to the index");
+    }
+
     local_chunk_manager.RemoveDir(
         storage::GetSegmentRawDataPathPrefix(segment_id));
+    build_data_offset_ = 0;
+    build_data_rows_ = 0;
     // TODO ::
     // SetDim(index_->Dim());
 }
@@ -141,11 +211,13 @@ VectorDiskAnnIndex<T>::Query(const DatasetPtr dataset,
                "Metric type of field index isn't the same with search info");
     auto num_queries = dataset->GetRows();
     auto topk = search_info.topk_;
+    if (cache_lease_ != nullptr) {
+        cache_lease_->RecordSearch(num_queries);
+    }
 
-    knowhere::Json search_config = search_info.search_params_;
-
-    search_config[knowhere::meta::TOPK] = topk;
-    search_config[knowhere::meta::METRIC_TYPE] = GetMetricType();
+    auto params = GetSearchParams(search_info);
+    // the disk index adds its own keys, so it searches with a copy
+    knowhere::Json search_config = params->search_conf_;
 
     // set search list size
     auto search_list_size = GetValueFromConfig<uint32_t>(
@@ -173,18 +245,7 @@ VectorDiskAnnIndex<T>::Query(const DatasetPtr dataset,
     search_config[DISK_ANN_PQ_CODE_BUDGET] = 0.0;
 
     auto final = [&] {
-        auto radius =
-            GetValueFromConfig<float>(search_info.search_params_, RADIUS);
-        if (radius.has_value()) {
-            search_config[RADIUS] = radius.value();
-            auto range_filter = GetValueFromConfig<float>(
-                search_info.search_params_, RANGE_FILTER);
-            if (range_filter.has_value()) {
-                search_config[RANGE_FILTER] = range_filter.value();
-                CheckRangeSearchParam(search_config[RADIUS],
-                                      search_config[RANGE_FILTER],
-                                      GetMetricType());
-            }
+        if (params->is_range_search()) {
             auto res = index_.RangeSearch(*dataset, search_config, bitset);
 
             if (!res.has_value()) {
@@ -233,12 +294,78 @@ VectorDiskAnnIndex<T>::Query(const DatasetPtr dataset,
 template <typename T>
 const bool
 VectorDiskAnnIndex<T>::HasRawData() const {
-    return index_.HasRawData(GetMetricType());
+    return !raw_vector_path_.empty() || index_.HasRawData(GetMetricType());
+}
+
+template <typename T>
+std::vector<uint8_t>
+VectorDiskAnnIndex<T>::read_raw_vectors(const DatasetPtr& dataset) const {
+    auto rows = dataset->GetRows();
+    auto ids = dataset->GetIds();
+    auto row_size = uint64_t(raw_vector_dim_) * sizeof(float);
+
+    // the rows in the order of their offsets, the ones close to each other
+    // are read as a single range
+    std::vector<int64_t> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return ids[a] < ids[b];
+    });
+    // [first row, last row] of the ranges
+    std::vector<std::pair<int64_t, int64_t>> spans;
+    for (auto i : order) {
+        auto id = ids[i];
+        AssertInfo(id >= 0 && id < int64_t(raw_vector_rows_),
+                   "out of range of the raw vectors");
+        if (!spans.empty() &&
+            (id - spans.back().second - 1) * int64_t(row_size) <=
+                kRawVectorReadGap) {
+            spans.back().second = id;
+        } else {
+            spans.emplace_back(id, id);
+        }
+    }
+
+    uint64_t total = 0;
+    for (auto& [first, last] : spans) {
+        total += uint64_t(last - first + 1) * row_size;
+    }
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[total]);
+    std::vector<storage::LocalFileRange> ranges;
+    ranges.reserve(spans.size());
+    uint64_t pos = 0;
+    for (auto& [first, last] : spans) {
+        auto len = uint64_t(last - first + 1) * row_size;
+        ranges.push_back(
+            {2 * sizeof(uint32_t) + first * row_size, buf.get() + pos, len});
+        pos += len;
+    }
+    auto sizes = storage::LocalChunkManager::GetInstance().ReadBatch(
+        raw_vector_path_, ranges);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        AssertInfo(sizes[i] == ranges[i].len,
+                   "raw vector file is shorter than its header says");
+    }
+
+    std::vector<uint8_t> raw_data(rows * row_size);
+    size_t span = 0;
+    for (auto i : order) {
+        while (ids[i] > spans[span].second) {
+            ++span;
+        }
+        auto src = static_cast<uint8_t*>(ranges[span].buf) +
+                   (ids[i] - spans[span].first) * row_size;
+        memcpy(raw_data.data() + i * row_size, src, row_size);
+    }
+    return raw_data;
 }
 
 template <typename T>
 const std::vector<uint8_t>
 VectorDiskAnnIndex<T>::GetVector(const DatasetPtr dataset) const {
+    if (!raw_vector_path_.empty()) {
+        return read_raw_vectors(dataset);
+    }
     auto res = index_.GetVectorByIds(*dataset);
     if (!res.has_value()) {
         PanicCodeInfo(
@@ -279,9 +406,14 @@ VectorDiskAnnIndex<T>::update_load_json(const Config& config) {
     auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
     load_config[DISK_ANN_PREFIX_PATH] = local_index_path_prefix;
 
-    // set base info
-    load_config[DISK_ANN_PREPARE_WARM_UP] = false;
-    load_config[DISK_ANN_PREPARE_USE_BFS_CACHE] = false;
+    // set base info, a warmed up index caches the nodes near the entry
+    // point and runs the warmup queries of knowhere while it loads
+    auto warmup_queries =
+        GetValueFromConfig<std::string>(config, WARMUP_QUERIES);
+    auto warm_up = warmup_queries.has_value() &&
+                   std::stoll(warmup_queries.value()) > 0;
+    load_config[DISK_ANN_PREPARE_WARM_UP] = warm_up;
+    load_config[DISK_ANN_PREPARE_USE_BFS_CACHE] = warm_up;
 
     // set threads number
     auto num_threads =
@@ -290,6 +422,16 @@ VectorDiskAnnIndex<T>::update_load_json(const Config& config) {
                "param " + std::string(DISK_ANN_LOAD_THREAD_NUM) + "is empty");
     load_config[DISK_ANN_THREADS_NUM] = std::atoi(num_threads.value().c_str());
 
+    // the cache the config sizes is granted from the node wide budget
+    if (load_config.contains(DISK_ANN_SEARCH_CACHE_BUDGET)) {
+        auto& budget = load_config[DISK_ANN_SEARCH_CACHE_BUDGET];
+        auto gb = budget.is_string() ? std::stod(budget.get<std::string>())
+                                     : budget.get<double>();
+        cache_lease_ = DiskAnnCacheManager::GetInstance().Acquire(
+            int64_t(gb * (1 << 30)));
+        budget = double(cache_lease_->granted()) / (1 << 30);
+    }
+
     // update search_beamwidth
     auto beamwidth =
         GetValueFromConfig<std::string>(load_config, DISK_ANN_QUERY_BEAMWIDTH);
@@ -17,8 +17,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "index/DiskAnnCache.h"
 #include "index/VectorIndex.h"
 #include "storage/DiskFileManagerImpl.h"
 
@@ -48,6 +50,12 @@ class VectorDiskAnnIndex : public VectorIndex {
         return index_.Count();
     }
 
+    // the part of the index kept in memory, the rest is read from disk
+    int64_t
+    ByteSize() override {
+        return index_.Size();
+    }
+
     void
     Load(const BinarySet& binary_set /* not used */,
          const Config& config = {}) override;
@@ -56,6 +64,14 @@ class VectorDiskAnnIndex : public VectorIndex {
     BuildWithDataset(const DatasetPtr& dataset,
                      const Config& config = {}) override;
 
+    // the batches are spilled to the local raw data file that the index is
+    // built from, so only one batch is in memory at a time
+    void
+    AppendBuildData(const DatasetPtr& dataset, const Config& config) override;
+
+    void
+    FinishBuild(const Config& config) override;
+
     std::unique_ptr<SearchResult>
     Query(const DatasetPtr dataset,
           const SearchInfo& search_info,
@@ -74,10 +90,28 @@ class VectorDiskAnnIndex : public VectorIndex {
     knowhere::Json
     update_load_json(const Config& config);
 
+    std::string
+    GetLocalRawDataPath() const;
+
+    // GetVector of the rows of the sidecar file, read as one batch
+    std::vector<uint8_t>
+    read_raw_vectors(const DatasetPtr& dataset) const;
+
  private:
     knowhere::Index<knowhere::IndexNode> index_;
     std::shared_ptr<storage::DiskFileManagerImpl> file_manager_;
     uint32_t search_beamwidth_ = 8;
+    // the share of the node wide cache budget the index is loaded with
+    std::unique_ptr<DiskAnnCacheLease> cache_lease_;
+    // the raw vector sidecar of the loaded index, an empty path if it has
+    // none; its rows follow a header of the row number and the dim
+    std::string raw_vector_path_;
+    uint32_t raw_vector_rows_ = 0;
+    uint32_t raw_vector_dim_ = 0;
+    // state of the raw data file of a streaming build
+    uint64_t build_data_offset_ = 0;
+    uint64_t build_data_rows_ = 0;
+    uint32_t build_data_dim_ = 0;
 };
 
 template <typename T>
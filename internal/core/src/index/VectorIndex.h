@@ -51,6 +51,25 @@ class VectorIndex : public IndexBase {
         PanicInfo("vector index don't support add with dataset");
     }
 
+    // streaming build: the rows are handed in batch by batch and the index
+    // is completed by FinishBuild, so the caller never holds all of them
+    virtual void
+    AppendBuildData(const DatasetPtr& dataset, const Config& config) {
+        PanicInfo("vector index don't support streaming build");
+    }
+
+    virtual void
+    FinishBuild(const Config& config) {
+        PanicInfo("vector index don't support streaming build");
+    }
+
+    // the binaries of the index before Serialize slices them for the
+    // storage, the large ones are written to it in slices as they are
+    virtual BinarySet
+    SerializeUnsliced(const Config& config) {
+        return Serialize(config);
+    }
+
     virtual std::unique_ptr<SearchResult>
     Query(const DatasetPtr dataset,
           const SearchInfo& search_info,
@@ -16,7 +16,14 @@
 
 #include "index/VectorMemIndex.h"
 
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
 #include "index/Meta.h"
 #include "index/Utils.h"
 #include "exceptions/EasyAssert.h"
@@ -43,19 +50,34 @@ VectorMemIndex::VectorMemIndex(const IndexType& index_type,
 
 BinarySet
 VectorMemIndex::Serialize(const Config& config) {
+    auto ret = SerializeUnsliced(config);
+    milvus::Disassemble(ret);
+
+    return ret;
+}
+
+BinarySet
+VectorMemIndex::SerializeUnsliced(const Config& config) {
     knowhere::BinarySet ret;
     auto stat = index_.Serialize(ret);
     if (stat != knowhere::Status::success)
         PanicCodeInfo(ErrorCodeEnum::UnexpectedError,
                       "failed to serialize index, " + MatchKnowhereError(stat));
-    milvus::Disassemble(ret);
-
     return ret;
 }
 
 void
 VectorMemIndex::Load(const BinarySet& binary_set, const Config& config) {
     milvus::Assemble(const_cast<BinarySet&>(binary_set));
+    auto mmap_filepath =
+        GetValueFromConfig<std::string>(config, MMAP_FILE_PATH);
+    // knowhere maps a file holding a single binary only
+    if (mmap_filepath.has_value() && binary_set.binary_map_.size() == 1) {
+        LoadWithMmap(const_cast<BinarySet&>(binary_set),
+                     mmap_filepath.value(),
+                     config);
+        return;
+    }
     auto stat = index_.Deserialize(binary_set);
     if (stat != knowhere::Status::success)
         PanicCodeInfo(
@@ -64,6 +86,67 @@ VectorMemIndex::Load(const BinarySet& binary_set, const Config& config) {
     SetDim(index_.Dim());
 }
 
+void
+VectorMemIndex::LoadWithMmap(BinarySet& binary_set,
+                             const std::string& filepath,
+                             const Config& config) {
+    auto path = std::filesystem::path(filepath);
+    std::filesystem::create_directories(path.parent_path());
+    int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR);
+    AssertInfo(fd != -1,
+               fmt::format("failed to create mmap file {}, err: {}",
+                           path.c_str(),
+                           strerror(errno)));
+
+    auto& binary = binary_set.binary_map_.begin()->second;
+    auto data = reinterpret_cast<const char*>(binary->data.get());
+    int64_t written = 0;
+    while (written < binary->size) {
+        auto n = write(fd, data + written, binary->size - written);
+        if (n <= 0) {
+            auto err = errno;
+            close(fd);
+            PanicInfo(fmt::format("failed to write mmap file {}, err: {}",
+                                  path.c_str(),
+                                  strerror(err)));
+        }
+        written += n;
+    }
+    // the fd is closed before panicking, nothing else would close it
+    auto ok = fsync(fd);
+    if (ok != 0) {
+        auto err = errno;
+        close(fd);
+        PanicInfo(fmt::format("failed to fsync mmap file {}, err: {}",
+                              path.c_str(),
+                              strerror(err)));
+    }
+    ok = close(fd);
+    AssertInfo(ok == 0,
+               fmt::format("failed to close mmap file {}, err: {}",
+                           path.c_str(),
+                           strerror(errno)));
+    // the file holds the index now, free the copy in memory before knowhere
+    // maps it so the two never exist at once
+    binary->data.reset();
+    binary->size = 0;
+
+    knowhere::Json load_config = config;
+    load_config[ENABLE_MMAP] = true;
+    auto stat = index_.DeserializeFromFile(path.string(), load_config);
+    // the mapping keeps the data, the file is removed once it is unmapped
+    ok = unlink(path.c_str());
+    AssertInfo(ok == 0,
+               fmt::format("failed to unlink mmap file {}, err: {}",
+                           path.c_str(),
+                           strerror(errno)));
+    if (stat != knowhere::Status::success)
+        PanicCodeInfo(ErrorCodeEnum::UnexpectedError,
+                      "failed to Deserialize index from file, " +
+                          MatchKnowhereError(stat));
+    SetDim(index_.Dim());
+}
+
 void
 VectorMemIndex::BuildWithDataset(const DatasetPtr& dataset,
                                  const Config& config) {
@@ -95,6 +178,59 @@ VectorMemIndex::AddWithDataset(const DatasetPtr& dataset,
     rc.ElapseFromBegin("Done");
 }
 
+void
+VectorMemIndex::AppendBuildData(const DatasetPtr& dataset,
+                                const Config& config) {
+    if (stream_build_trained_) {
+        AddWithDataset(dataset, config);
+        return;
+    }
+
+    auto rows = dataset->GetRows();
+    auto dim = dataset->GetDim();
+    AssertInfo(pending_build_rows_ == 0 || pending_build_dim_ == dim,
+               "dim of the build data changed");
+    auto row_size =
+        is_in_bin_list(GetIndexType()) ? dim / 8 : dim * sizeof(float);
+    auto data = static_cast<const uint8_t*>(dataset->GetTensor());
+    pending_build_data_.insert(
+        pending_build_data_.end(), data, data + rows * row_size);
+    pending_build_rows_ += rows;
+    pending_build_dim_ = dim;
+
+    if (!is_in_incremental_build_list(GetIndexType())) {
+        return;
+    }
+    auto train_rows = DEFAULT_STREAM_BUILD_TRAIN_ROWS;
+    auto train_rows_str =
+        GetValueFromConfig<std::string>(config, STREAM_BUILD_TRAIN_ROWS);
+    if (train_rows_str.has_value()) {
+        train_rows = std::stoll(train_rows_str.value());
+    }
+    if (pending_build_rows_ >= train_rows) {
+        BuildWithPendingData(config);
+    }
+}
+
+void
+VectorMemIndex::FinishBuild(const Config& config) {
+    if (!stream_build_trained_) {
+        AssertInfo(pending_build_rows_ > 0, "no data to build the index on");
+        BuildWithPendingData(config);
+    }
+    stream_build_trained_ = false;
+}
+
+void
+VectorMemIndex::BuildWithPendingData(const Config& config) {
+    auto dataset = knowhere::GenDataSet(
+        pending_build_rows_, pending_build_dim_, pending_build_data_.data());
+    BuildWithDataset(dataset, config);
+    stream_build_trained_ = true;
+    pending_build_rows_ = 0;
+    std::vector<uint8_t>().swap(pending_build_data_);
+}
+
 std::unique_ptr<SearchResult>
 VectorMemIndex::Query(const DatasetPtr dataset,
                       const SearchInfo& search_info,
@@ -103,19 +239,18 @@ VectorMemIndex::Query(const DatasetPtr dataset,
     //               "Metric type of field index isn't the same with search info");
 
     auto num_queries = dataset->GetRows();
-    knowhere::Json search_conf = search_info.search_params_;
     auto topk = search_info.topk_;
+    // the params parsed with the plan unless the metric type of the index
+    // differs, they are passed to knowhere without a copy
+    auto params = GetSearchParams(search_info);
+    if (search_info.metric_type_ != GetMetricType()) {
+        params = ParseSearchParams(
+            search_info.search_params_, topk, GetMetricType());
+    }
+    auto& search_conf = params->search_conf_;
     // TODO :: check dim of search data
     auto final = [&] {
-        search_conf[knowhere::meta::TOPK] = topk;
-        search_conf[knowhere::meta::METRIC_TYPE] = GetMetricType();
-        auto index_type = GetIndexType();
-        if (CheckKeyInConfig(search_conf, RADIUS)) {
-            if (CheckKeyInConfig(search_conf, RANGE_FILTER)) {
-                CheckRangeSearchParam(search_conf[RADIUS],
-                                      search_conf[RANGE_FILTER],
-                                      GetMetricType());
-            }
+        if (params->is_range_search()) {
             auto res = index_.RangeSearch(*dataset, search_conf, bitset);
             if (!res.has_value()) {
                 PanicCodeInfo(ErrorCodeEnum::UnexpectedError,
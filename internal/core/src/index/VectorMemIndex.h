@@ -34,6 +34,12 @@ class VectorMemIndex : public VectorIndex {
     BinarySet
     Serialize(const Config& config) override;
 
+    BinarySet
+    SerializeUnsliced(const Config& config) override;
+
+    // With MMAP_FILE_PATH in config the index is written to that file,
+    // the binaries are released and knowhere maps the file, so the index
+    // is backed by the page cache instead of anonymous memory.
     void
     Load(const BinarySet& binary_set, const Config& config = {}) override;
 
@@ -44,11 +50,25 @@ class VectorMemIndex : public VectorIndex {
     void
     AddWithDataset(const DatasetPtr& dataset, const Config& config) override;
 
+    // the batches are kept until STREAM_BUILD_TRAIN_ROWS rows arrived, the
+    // index is built on them and the later batches are added to it. Index
+    // types not taking adds keep all the batches until FinishBuild.
+    void
+    AppendBuildData(const DatasetPtr& dataset, const Config& config) override;
+
+    void
+    FinishBuild(const Config& config) override;
+
     int64_t
     Count() override {
         return index_.Count();
     }
 
+    int64_t
+    ByteSize() override {
+        return index_.Size() + pending_build_data_.capacity();
+    }
+
     std::unique_ptr<SearchResult>
     Query(const DatasetPtr dataset,
           const SearchInfo& search_info,
@@ -60,9 +80,25 @@ class VectorMemIndex : public VectorIndex {
     const std::vector<uint8_t>
     GetVector(const DatasetPtr dataset) const override;
 
+ private:
+    void
+    LoadWithMmap(BinarySet& binary_set,
+                 const std::string& filepath,
+                 const Config& config);
+
+    void
+    BuildWithPendingData(const Config& config);
+
  protected:
     Config config_;
     knowhere::Index<knowhere::IndexNode> index_;
+
+ private:
+    // batches of a streaming build not in the index yet
+    std::vector<uint8_t> pending_build_data_;
+    int64_t pending_build_rows_ = 0;
+    int64_t pending_build_dim_ = 0;
+    bool stream_build_trained_ = false;
 };
 
 using VectorMemIndexPtr = std::unique_ptr<VectorMemIndex>;
@@ -28,18 +28,19 @@ namespace milvus::index {
 
 BinarySet
 VectorMemNMIndex::Serialize(const Config& config) {
-    knowhere::BinarySet ret;
-    auto stat = index_.Serialize(ret);
-    if (stat != knowhere::Status::success)
-        PanicCodeInfo(ErrorCodeEnum::UnexpectedError,
-                      "failed to serialize index, " + MatchKnowhereError(stat));
+    auto ret = SerializeUnsliced(config);
+    milvus::Disassemble(ret);
+
+    return ret;
+}
 
+BinarySet
+VectorMemNMIndex::SerializeUnsliced(const Config& config) {
+    auto ret = VectorMemIndex::SerializeUnsliced(config);
     auto deleter = [&](uint8_t*) {};  // avoid repeated deconstruction
     auto raw_data = std::shared_ptr<uint8_t[]>(
-        static_cast<uint8_t*>(raw_data_.data()), deleter);
-    ret.Append(RAW_DATA, raw_data, raw_data_.size());
-    milvus::Disassemble(ret);
-
+        const_cast<uint8_t*>(raw_data_), deleter);
+    ret.Append(RAW_DATA, raw_data, raw_data_size_);
     return ret;
 }
 
@@ -52,6 +53,14 @@ VectorMemNMIndex::BuildWithDataset(const DatasetPtr& dataset,
     rc.ElapseFromBegin("Done");
 }
 
+void
+VectorMemNMIndex::BuildWithBorrowedDataset(const DatasetPtr& dataset,
+                                           const Config& config) {
+    VectorMemIndex::BuildWithDataset(dataset, config);
+    raw_data_ = static_cast<const uint8_t*>(dataset->GetTensor());
+    raw_data_size_ = dataset->GetRows() * row_size();
+}
+
 void
 VectorMemNMIndex::AddWithDataset(const DatasetPtr& /*dataset*/,
                                  const Config& /*config*/) {
@@ -61,6 +70,12 @@ void
 VectorMemNMIndex::Load(const BinarySet& binary_set, const Config& config) {
     VectorMemIndex::Load(binary_set, config);
     if (binary_set.Contains(RAW_DATA)) {
+        // knowhere reads the vectors from the binary, it's kept to serve
+        // GetVector as well
+        auto binary = binary_set.GetByName(RAW_DATA);
+        loaded_raw_data_ = binary->data;
+        raw_data_ = loaded_raw_data_.get();
+        raw_data_size_ = binary->size;
         std::call_once(raw_data_loaded_, [&]() {
             LOG_SEGCORE_INFO_ << "NM index load raw data done!";
         });
@@ -79,20 +94,40 @@ VectorMemNMIndex::Query(const DatasetPtr dataset,
     return VectorMemIndex::Query(dataset, search_info, bitset);
 }
 
-void
-VectorMemNMIndex::store_raw_data(const DatasetPtr& dataset) {
-    auto index_type = GetIndexType();
-    auto tensor = dataset->GetTensor();
+const bool
+VectorMemNMIndex::HasRawData() const {
+    return raw_data_ != nullptr || VectorMemIndex::HasRawData();
+}
+
+const std::vector<uint8_t>
+VectorMemNMIndex::GetVector(const DatasetPtr dataset) const {
+    if (raw_data_ == nullptr) {
+        return VectorMemIndex::GetVector(dataset);
+    }
+    auto ids = dataset->GetIds();
     auto row_num = dataset->GetRows();
-    auto dim = dataset->GetDim();
-    int64_t data_size;
-    if (is_in_bin_list(index_type)) {
-        data_size = dim / 8 * row_num;
-    } else {
-        data_size = dim * row_num * sizeof(float);
+    auto size = row_size();
+    std::vector<uint8_t> raw_data(row_num * size);
+    for (int64_t i = 0; i < row_num; ++i) {
+        AssertInfo((ids[i] + 1) * size <= raw_data_size_,
+                   "vector id out of range");
+        memcpy(raw_data.data() + i * size, raw_data_ + ids[i] * size, size);
     }
-    raw_data_.resize(data_size);
-    memcpy(raw_data_.data(), tensor, data_size);
+    return raw_data;
+}
+
+void
+VectorMemNMIndex::store_raw_data(const DatasetPtr& dataset) {
+    auto tensor = static_cast<const uint8_t*>(dataset->GetTensor());
+    owned_raw_data_.assign(tensor, tensor + dataset->GetRows() * row_size());
+    raw_data_ = owned_raw_data_.data();
+    raw_data_size_ = owned_raw_data_.size();
+}
+
+int64_t
+VectorMemNMIndex::row_size() const {
+    auto dim = GetDim();
+    return is_in_bin_list(GetIndexType()) ? dim / 8 : dim * sizeof(float);
 }
 
 void
@@ -105,9 +140,9 @@ VectorMemNMIndex::LoadRawData() {
 
     auto bptr = std::make_shared<knowhere::Binary>();
     auto deleter = [&](uint8_t*) {};  // avoid repeated deconstruction
-    bptr->data = std::shared_ptr<uint8_t[]>(
-        static_cast<uint8_t*>(raw_data_.data()), deleter);
-    bptr->size = raw_data_.size();
+    bptr->data = std::shared_ptr<uint8_t[]>(const_cast<uint8_t*>(raw_data_),
+                                            deleter);
+    bptr->size = raw_data_size_;
     bs.Append(RAW_DATA, bptr);
     stat = index_.Deserialize(bs);
     if (stat != knowhere::Status::success)
@@ -37,10 +37,19 @@ class VectorMemNMIndex : public VectorMemIndex {
     BinarySet
     Serialize(const Config& config) override;
 
+    BinarySet
+    SerializeUnsliced(const Config& config) override;
+
     void
     BuildWithDataset(const DatasetPtr& dataset,
                      const Config& config = {}) override;
 
+    // builds the index on vectors the caller keeps, which must outlive the
+    // index, instead of a copy of them
+    void
+    BuildWithBorrowedDataset(const DatasetPtr& dataset,
+                             const Config& config = {});
+
     void
     AddWithDataset(const DatasetPtr& dataset, const Config& config) override;
 
@@ -52,6 +61,14 @@ class VectorMemNMIndex : public VectorMemIndex {
           const SearchInfo& search_info,
           const BitsetView& bitset) override;
 
+    // the raw vectors kept for knowhere serve the vectors of the rows, so
+    // a segment doesn't have to keep them a second time
+    const bool
+    HasRawData() const override;
+
+    const std::vector<uint8_t>
+    GetVector(const DatasetPtr dataset) const override;
+
  private:
     void
     store_raw_data(const DatasetPtr& dataset);
@@ -59,8 +76,16 @@ class VectorMemNMIndex : public VectorMemIndex {
     void
     LoadRawData();
 
+    int64_t
+    row_size() const;
+
  private:
-    std::vector<uint8_t> raw_data_;
+    // the raw vectors: owned_raw_data_ when they're copied at build, the
+    // binary of a loaded index or vectors borrowed from the caller
+    const uint8_t* raw_data_ = nullptr;
+    int64_t raw_data_size_ = 0;
+    std::vector<uint8_t> owned_raw_data_;
+    std::shared_ptr<uint8_t[]> loaded_raw_data_;
     std::once_flag raw_data_loaded_;
 };
 
@@ -0,0 +1,130 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "indexbuilder/BuildScheduler.h"
+
+#include <algorithm>
+#include <string>
+
+#include "common/FieldMeta.h"
+#include "exceptions/EasyAssert.h"
+#include "index/Meta.h"
+#include "index/Utils.h"
+#include "knowhere/comp/index_param.h"
+
+namespace milvus::indexbuilder {
+
+namespace {
+
+int64_t
+GetIntParam(const Config& config, const std::string& key, int64_t value) {
+    auto param = index::GetValueFromConfig<std::string>(config, key);
+    return param.has_value() ? std::stoll(param.value()) : value;
+}
+
+}  // namespace
+
+int64_t
+EstimateBuildMemory(const Config& config,
+                    DataType data_type,
+                    int64_t num_rows) {
+    auto index_type = index::GetIndexTypeFromConfig(config);
+    auto dim = index::GetDimFromConfig(config);
+    auto row_bytes = int64_t(datatype_sizeof(data_type, dim));
+    auto raw_bytes = num_rows * row_bytes;
+    // faiss k-means samples at most 256 rows per centroid
+    auto nlist = GetIntParam(config, knowhere::indexparam::NLIST, 1024);
+    auto train_bytes = std::min(num_rows, nlist * 256) * row_bytes +
+                       nlist * dim * int64_t(sizeof(float));
+
+    // the build gets a copy of the raw vectors besides those of the caller
+    int64_t index_bytes = raw_bytes;
+    if (index_type == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT ||
+        index_type == knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT) {
+        index_bytes = train_bytes + raw_bytes + num_rows * sizeof(int64_t);
+    } else if (index_type == knowhere::IndexEnum::INDEX_FAISS_IVFSQ8) {
+        index_bytes = train_bytes + num_rows * (dim + sizeof(int64_t));
+    } else if (index_type == knowhere::IndexEnum::INDEX_FAISS_IVFPQ) {
+        auto m = GetIntParam(config, knowhere::indexparam::M, dim);
+        auto nbits = GetIntParam(config, knowhere::indexparam::NBITS, 8);
+        // the codebooks are trained on the residuals of the sample
+        index_bytes = 2 * train_bytes + (1 << nbits) * dim * sizeof(float) +
+                      num_rows * (m * nbits / 8 + sizeof(int64_t));
+    } else if (index_type == knowhere::IndexEnum::INDEX_HNSW) {
+        auto m = GetIntParam(config, knowhere::indexparam::HNSW_M, 16);
+        // 2M links of the bottom layer, the upper ones take a 1/M of it
+        index_bytes = raw_bytes + num_rows * (2 * m + m / 2 + 4) *
+                                      int64_t(sizeof(int32_t));
+    } else if (index_type == knowhere::IndexEnum::INDEX_DISKANN) {
+        // the build keeps within its dram budget besides the raw vectors
+        // it writes to the disk
+        auto budget = index::GetValueFromConfig<std::string>(
+            config, index::DISK_ANN_BUILD_DRAM_BUDGET);
+        index_bytes = budget.has_value()
+                          ? int64_t(std::stod(budget.value()) * (1 << 30))
+                          : 2 * raw_bytes;
+    } else if (index::is_in_gpu_list(index_type)) {
+        // built on the device, the host keeps the raw vectors to upload
+        index_bytes = raw_bytes;
+    }
+    return raw_bytes + index_bytes;
+}
+
+void
+BuildScheduler::SetBudget(int64_t budget_bytes) {
+    AssertInfo(budget_bytes >= 0, "invalid index build memory budget");
+    {
+        std::lock_guard lck(mutex_);
+        budget_ = budget_bytes;
+    }
+    released_.notify_all();
+}
+
+BuildScheduler::Ticket
+BuildScheduler::Admit(int64_t bytes) {
+    std::unique_lock lck(mutex_);
+    auto ticket = next_++;
+    released_.wait(lck, [&] {
+        return ticket == serving_ &&
+               (budget_ == 0 || running_ == 0 || used_ + bytes <= budget_);
+    });
+    ++serving_;
+    ++running_;
+    used_ += bytes;
+    lck.unlock();
+    // the next one in line may fit as well
+    released_.notify_all();
+    return Ticket(this, bytes);
+}
+
+void
+BuildScheduler::Release(int64_t bytes) {
+    {
+        std::lock_guard lck(mutex_);
+        --running_;
+        used_ -= bytes;
+    }
+    released_.notify_all();
+}
+
+int64_t
+BuildScheduler::Used() const {
+    std::lock_guard lck(mutex_);
+    return used_;
+}
+
+int64_t
+BuildScheduler::Queued() const {
+    std::lock_guard lck(mutex_);
+    return int64_t(next_ - serving_);
+}
+
+}  // namespace milvus::indexbuilder
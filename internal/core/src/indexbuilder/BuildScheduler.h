@@ -0,0 +1,96 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "common/Types.h"
+
+namespace milvus::indexbuilder {
+
+// the peak bytes building a vector index of the type, dim and params of
+// `config` on `num_rows` rows takes: the raw vectors the index copies, the
+// training buffers and the index itself
+int64_t
+EstimateBuildMemory(const Config& config,
+                    DataType data_type,
+                    int64_t num_rows);
+
+// Node wide admission of index builds against a memory budget. A build
+// waits until its estimated peak fits in what the running ones leave of
+// the budget, the waiting ones are admitted first come first served. A
+// build larger than the whole budget runs once it is alone.
+class BuildScheduler {
+ public:
+    // the bytes admitted by a build, released when it's destroyed
+    class Ticket {
+     public:
+        Ticket(BuildScheduler* scheduler, int64_t bytes)
+            : scheduler_(scheduler), bytes_(bytes) {
+        }
+
+        Ticket(const Ticket&) = delete;
+
+        Ticket&
+        operator=(const Ticket&) = delete;
+
+        ~Ticket() {
+            scheduler_->Release(bytes_);
+        }
+
+     private:
+        BuildScheduler* scheduler_;
+        int64_t bytes_;
+    };
+
+    static BuildScheduler&
+    GetInstance() {
+        static BuildScheduler instance;
+        return instance;
+    }
+
+    // 0 to admit every build at once
+    void
+    SetBudget(int64_t budget_bytes);
+
+    // waits until a build of `bytes` at peak may run
+    Ticket
+    Admit(int64_t bytes);
+
+    // the bytes of the running builds
+    int64_t
+    Used() const;
+
+    // the builds waiting to be admitted
+    int64_t
+    Queued() const;
+
+ private:
+    BuildScheduler() = default;
+
+    void
+    Release(int64_t bytes);
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    int64_t budget_ = 0;
+    int64_t used_ = 0;
+    int64_t running_ = 0;
+    // tickets of the waiting builds in arrival order, next_ is the next
+    // one handed out and serving_ the one admitted next
+    uint64_t next_ = 0;
+    uint64_t serving_ = 0;
+};
+
+}  // namespace milvus::indexbuilder
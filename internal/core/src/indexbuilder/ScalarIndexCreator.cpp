@@ -10,12 +10,15 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include "indexbuilder/ScalarIndexCreator.h"
+#include "common/Consts.h"
+#include "index/BitmapIndex.h"
 #include "index/IndexFactory.h"
 #include "index/IndexInfo.h"
 #include "index/Meta.h"
 #include "index/Utils.h"
 #include "pb/index_cgo_msg.pb.h"
 
+#include <algorithm>
 #include <string>
 
 namespace milvus::indexbuilder {
@@ -40,9 +43,14 @@ ScalarIndexCreator::ScalarIndexCreator(DataType dtype,
         config_[param.key()] = param.value();
     }
 
+    create_index(index_type());
+}
+
+void
+ScalarIndexCreator::create_index(const std::string& index_type) {
     milvus::index::CreateIndexInfo index_info;
     index_info.field_type = dtype_;
-    index_info.index_type = index_type();
+    index_info.index_type = index_type;
     index_ =
         index::IndexFactory::GetInstance().CreateIndex(index_info, nullptr);
 }
@@ -51,6 +59,9 @@ void
 ScalarIndexCreator::Build(const milvus::DatasetPtr& dataset) {
     auto size = dataset->GetRows();
     auto data = dataset->GetTensor();
+    if (use_bitmap_index(size, data)) {
+        create_index(index::BITMAP_INDEX_TYPE);
+    }
     index_->BuildWithRawData(size, data);
 }
 
@@ -61,13 +72,62 @@ ScalarIndexCreator::Serialize() {
 
 void
 ScalarIndexCreator::Load(const milvus::BinarySet& binary_set) {
+    // the build may have picked a bitmap index on its own
+    if (binary_set.Contains(index::BITMAP_INDEX_META)) {
+        create_index(index::BITMAP_INDEX_TYPE);
+    }
     index_->Load(binary_set);
 }
 
 std::string
 ScalarIndexCreator::index_type() {
-    // TODO
-    return "sort";
+    auto index_type =
+        index::GetValueFromConfig<std::string>(config_, index::INDEX_TYPE);
+    return index_type.value_or("sort");
+}
+
+bool
+ScalarIndexCreator::use_bitmap_index(size_t n, const void* data) {
+    // only the default index gives way, not one asked for by its type
+    auto type = index_type();
+    if (type != "sort" && type != index::ASCENDING_SORT) {
+        return false;
+    }
+    int64_t limit = DEFAULT_BITMAP_INDEX_CARDINALITY_LIMIT;
+    auto limit_param = index::GetValueFromConfig<std::string>(
+        config_, index::BITMAP_CARDINALITY_LIMIT);
+    if (limit_param.has_value()) {
+        limit = std::stoll(limit_param.value());
+    }
+    limit = std::min(limit, BITMAP_INDEX_MAX_CARDINALITY);
+    if (limit <= 0) {
+        return false;
+    }
+
+    switch (dtype_) {
+        case DataType::BOOL:
+            return limit >= 2;
+        case DataType::INT8:
+            return index::HasLowCardinality(
+                n, static_cast<const int8_t*>(data), limit);
+        case DataType::INT16:
+            return index::HasLowCardinality(
+                n, static_cast<const int16_t*>(data), limit);
+        case DataType::INT32:
+            return index::HasLowCardinality(
+                n, static_cast<const int32_t*>(data), limit);
+        case DataType::INT64:
+            return index::HasLowCardinality(
+                n, static_cast<const int64_t*>(data), limit);
+        case DataType::FLOAT:
+            return index::HasLowCardinality(
+                n, static_cast<const float*>(data), limit);
+        case DataType::DOUBLE:
+            return index::HasLowCardinality(
+                n, static_cast<const double*>(data), limit);
+        default:
+            return false;
+    }
 }
 
 }  // namespace milvus::indexbuilder
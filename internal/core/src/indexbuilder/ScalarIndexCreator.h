@@ -39,6 +39,14 @@ class ScalarIndexCreator : public IndexCreatorBase {
     std::string
     index_type();
 
+    void
+    create_index(const std::string& index_type);
+
+    // whether to build a bitmap index instead of the requested default one,
+    // the field has few distinct values
+    bool
+    use_bitmap_index(size_t n, const void* data);
+
  private:
     index::IndexBasePtr index_ = nullptr;
     Config config_;
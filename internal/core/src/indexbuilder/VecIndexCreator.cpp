@@ -9,13 +9,20 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <map>
 
+#include "common/Common.h"
+#include "common/Consts.h"
 #include "exceptions/EasyAssert.h"
+#include "indexbuilder/BuildScheduler.h"
 #include "indexbuilder/VecIndexCreator.h"
 #include "index/Utils.h"
 #include "index/IndexFactory.h"
+#include "log/Log.h"
 #include "pb/index_cgo_msg.pb.h"
+#include "storage/MinioChunkManager.h"
+#include "storage/Util.h"
 
 #ifdef BUILD_DISK_ANN
 #include "storage/DiskFileManagerImpl.h"
@@ -27,7 +34,7 @@ VecIndexCreator::VecIndexCreator(DataType data_type,
                                  const char* serialized_type_params,
                                  const char* serialized_index_params,
                                  const storage::StorageConfig& storage_config)
-    : data_type_(data_type) {
+    : data_type_(data_type), storage_config_(storage_config) {
     proto::indexcgo::TypeParams type_params_;
     proto::indexcgo::IndexParams index_params_;
     milvus::index::ParseFromString(type_params_,
@@ -49,6 +56,7 @@ VecIndexCreator::VecIndexCreator(DataType data_type,
     index_info.field_type = data_type_;
     index_info.index_type = index::GetIndexTypeFromConfig(config_);
     index_info.metric_type = index::GetMetricTypeFromConfig(config_);
+    CheckBuildDevice(index_info.index_type);
 
     std::shared_ptr<storage::FileManagerImpl> file_manager = nullptr;
 #ifdef BUILD_DISK_ANN
@@ -67,21 +75,124 @@ VecIndexCreator::VecIndexCreator(DataType data_type,
                "[VecIndexCreator]Index is null after create index");
 }
 
+void
+VecIndexCreator::CheckBuildDevice(const IndexType& index_type) {
+    auto on_gpu = index::is_in_gpu_list(index_type);
+    auto build_device =
+        index::GetValueFromConfig<std::string>(config_, index::BUILD_DEVICE)
+            .value_or(on_gpu ? index::BUILD_DEVICE_GPU
+                             : index::BUILD_DEVICE_CPU);
+    AssertInfo(build_device == index::BUILD_DEVICE_CPU ||
+                   build_device == index::BUILD_DEVICE_GPU,
+               "invalid build device " + build_device);
+    // not a knowhere param
+    config_.erase(index::BUILD_DEVICE);
+    if (build_device == index::BUILD_DEVICE_GPU) {
+#ifndef MILVUS_GPU_VERSION
+        PanicInfo("gpu index build isn't supported by this build");
+#endif
+        // knowhere trains the cpu index types on the cpu only, their
+        // gpu counterparts serialize into an index of their own format
+        if (!on_gpu) {
+            LOG_SEGCORE_WARNING_ << "no gpu build of index type "
+                                 << index_type << ", built on the cpu";
+        }
+    } else {
+        AssertInfo(!on_gpu,
+                   "index type " + index_type + " is built on the gpu");
+    }
+}
+
 int64_t
 VecIndexCreator::dim() {
     return index::GetDimFromConfig(config_);
 }
 
+int64_t
+VecIndexCreator::EstimateBuildMemory(int64_t num_rows) const {
+    return indexbuilder::EstimateBuildMemory(config_, data_type_, num_rows);
+}
+
 void
 VecIndexCreator::Build(const milvus::DatasetPtr& dataset) {
+    auto ticket = BuildScheduler::GetInstance().Admit(
+        EstimateBuildMemory(dataset->GetRows()));
     index_->BuildWithDataset(dataset, config_);
 }
 
+void
+VecIndexCreator::AppendBuildData(const milvus::DatasetPtr& dataset) {
+    auto vector_index = dynamic_cast<index::VectorIndex*>(index_.get());
+    vector_index->AppendBuildData(dataset, config_);
+    appended_rows_ += dataset->GetRows();
+}
+
+void
+VecIndexCreator::AppendBuildData(const storage::FieldDataPtr& field_data) {
+    AssertInfo(field_data->get_dim() == dim(),
+               "dim of the field data doesn't match the index");
+    auto dataset = knowhere::GenDataSet(
+        field_data->get_num_rows(), field_data->get_dim(), field_data->Data());
+    AppendBuildData(dataset);
+}
+
+void
+VecIndexCreator::FinishBuild() {
+    // the appended rows are already copied, the training and the index
+    // are what's admitted
+    auto ticket = BuildScheduler::GetInstance().Admit(
+        EstimateBuildMemory(appended_rows_));
+    auto vector_index = dynamic_cast<index::VectorIndex*>(index_.get());
+    vector_index->FinishBuild(config_);
+}
+
+void
+VecIndexCreator::BuildWithBinlogs(
+    const std::vector<std::string>& remote_files) {
+    AssertInfo(!remote_files.empty(), "no binlog to build the index on");
+    auto rcm = std::make_unique<storage::MinioChunkManager>(storage_config_);
+    storage::DownloadAndDecodeRemoteFiles(
+        rcm.get(),
+        remote_files,
+        DEFAULT_INDEX_BUILD_BINLOG_INFLIGHT,
+        [&](const storage::FieldDataPtr& field_data) {
+            AppendBuildData(field_data);
+        });
+    FinishBuild();
+}
+
 milvus::BinarySet
 VecIndexCreator::Serialize() {
     return index_->Serialize(config_);
 }
 
+milvus::BinarySet
+VecIndexCreator::Upload() {
+    auto vector_index = dynamic_cast<index::VectorIndex*>(index_.get());
+    AssertInfo(!index::is_in_disk_list(vector_index->GetIndexType()),
+               "disk indexes upload their files while they are built");
+    auto field_meta = index::GetFieldDataMetaFromConfig(config_);
+    auto index_meta = index::GetIndexMetaFromConfig(config_);
+    auto binary_set = vector_index->SerializeUnsliced(config_);
+    auto rcm = std::make_unique<storage::MinioChunkManager>(storage_config_);
+    auto remote_paths_to_size = storage::PutIndexData(
+        rcm.get(),
+        binary_set,
+        storage::GenRemoteIndexPathPrefix(
+            storage_config_.remote_root_path, field_meta, index_meta),
+        field_meta,
+        index_meta,
+        std::max<int64_t>(
+            1, DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT /
+                   (index_file_slice_size << 20)));
+
+    milvus::BinarySet ret;
+    for (auto& [path, size] : remote_paths_to_size) {
+        ret.Append(path, nullptr, size);
+    }
+    return ret;
+}
+
 void
 VecIndexCreator::Load(const milvus::BinarySet& binary_set) {
     index_->Load(binary_set, config_);
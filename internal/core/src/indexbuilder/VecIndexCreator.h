@@ -19,6 +19,7 @@
 #include "indexbuilder/IndexCreatorBase.h"
 #include "index/VectorIndex.h"
 #include "index/IndexInfo.h"
+#include "storage/FieldData.h"
 #include "storage/Types.h"
 
 namespace milvus::indexbuilder {
@@ -34,15 +35,42 @@ class VecIndexCreator : public IndexCreatorBase {
     void
     Build(const milvus::DatasetPtr& dataset) override;
 
+    // streaming build, the vectors are appended batch by batch and the
+    // index is completed by FinishBuild
+    void
+    AppendBuildData(const milvus::DatasetPtr& dataset);
+
+    void
+    AppendBuildData(const storage::FieldDataPtr& field_data);
+
+    void
+    FinishBuild();
+
+    // download and decode the binlogs of the field and stream them into
+    // the index, the raw vectors never leave segcore
+    void
+    BuildWithBinlogs(const std::vector<std::string>& remote_files);
+
     milvus::BinarySet
     Serialize() override;
 
+    // writes the binaries of the index straight to the remote storage as
+    // index files, only a bounded number of them encoded at a time, and
+    // returns the remote paths of the files with their sizes and no data
+    milvus::BinarySet
+    Upload();
+
     void
     Load(const milvus::BinarySet& binary_set) override;
 
     int64_t
     dim();
 
+    // the peak bytes of building the index on `num_rows` rows, what the
+    // build is admitted with by the BuildScheduler
+    int64_t
+    EstimateBuildMemory(int64_t num_rows) const;
+
     std::unique_ptr<SearchResult>
     Query(const milvus::DatasetPtr& dataset,
           const SearchInfo& search_info,
@@ -53,9 +81,16 @@ class VecIndexCreator : public IndexCreatorBase {
     CleanLocalData();
 
  private:
+    // checks the build device of the index params against the index type
+    void
+    CheckBuildDevice(const IndexType& index_type);
+
     milvus::index::IndexBasePtr index_ = nullptr;
     Config config_;
     DataType data_type_;
+    // the rows a streaming build has been appended
+    int64_t appended_rows_ = 0;
+    storage::StorageConfig storage_config_;
 };
 
 }  // namespace milvus::indexbuilder
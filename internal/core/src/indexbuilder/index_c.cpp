@@ -10,12 +10,14 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <string>
+#include <vector>
 
 #ifdef __linux__
 #include <malloc.h>
 #endif
 
 #include "exceptions/EasyAssert.h"
+#include "indexbuilder/BuildScheduler.h"
 #include "indexbuilder/VecIndexCreator.h"
 #include "indexbuilder/index_c.h"
 #include "indexbuilder/IndexFactory.h"
@@ -132,6 +134,136 @@ BuildBinaryVecIndex(CIndex index, int64_t data_size, const uint8_t* vectors) {
     return status;
 }
 
+CStatus
+EstimateVecIndexBuildMemory(CIndex index, int64_t num_rows, int64_t* bytes) {
+    auto status = CStatus();
+    try {
+        AssertInfo(index,
+                   "failed to estimate index build, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        AssertInfo(cIndex, "not a vector index");
+        *bytes = cIndex->EstimateBuildMemory(num_rows);
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
+CStatus
+GetIndexBuildQueue(int64_t* used_bytes, int64_t* queued) {
+    auto& scheduler = milvus::indexbuilder::BuildScheduler::GetInstance();
+    *used_bytes = scheduler.Used();
+    *queued = scheduler.Queued();
+    auto status = CStatus();
+    status.error_code = Success;
+    status.error_msg = "";
+    return status;
+}
+
+CStatus
+AppendFloatVecIndexData(CIndex index,
+                        int64_t float_value_num,
+                        const float* vectors) {
+    auto status = CStatus();
+    try {
+        AssertInfo(
+            index,
+            "failed to append float vector data, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        auto dim = cIndex->dim();
+        auto row_nums = float_value_num / dim;
+        auto ds = knowhere::GenDataSet(row_nums, dim, vectors);
+        cIndex->AppendBuildData(ds);
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
+CStatus
+AppendBinaryVecIndexData(CIndex index,
+                         int64_t data_size,
+                         const uint8_t* vectors) {
+    auto status = CStatus();
+    try {
+        AssertInfo(
+            index,
+            "failed to append binary vector data, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        auto dim = cIndex->dim();
+        auto row_nums = (data_size * 8) / dim;
+        auto ds = knowhere::GenDataSet(row_nums, dim, vectors);
+        cIndex->AppendBuildData(ds);
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
+CStatus
+FinishVecIndexBuild(CIndex index) {
+    auto status = CStatus();
+    try {
+        AssertInfo(
+            index,
+            "failed to finish vector index build, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        cIndex->FinishBuild();
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
+CStatus
+BuildVecIndexWithBinlogs(CIndex index,
+                         const char* const* binlog_paths,
+                         int64_t num_binlogs) {
+    auto status = CStatus();
+    try {
+        AssertInfo(
+            index,
+            "failed to build index with binlogs, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        std::vector<std::string> remote_files(binlog_paths,
+                                              binlog_paths + num_binlogs);
+        cIndex->BuildWithBinlogs(remote_files);
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
 // field_data:
 //  1, serialized proto::schema::BoolArray, if type is bool;
 //  2, serialized proto::schema::StringArray, if type is string;
@@ -180,6 +312,29 @@ SerializeIndexToBinarySet(CIndex index, CBinarySet* c_binary_set) {
     return status;
 }
 
+CStatus
+SerializeIndexToRemote(CIndex index, CBinarySet* c_binary_set) {
+    auto status = CStatus();
+    try {
+        AssertInfo(index,
+                   "failed to upload index to remote, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        AssertInfo(cIndex, "not a vector index");
+        auto binary =
+            std::make_unique<knowhere::BinarySet>(cIndex->Upload());
+        *c_binary_set = binary.release();
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
 CStatus
 LoadIndexFromBinarySet(CIndex index, CBinarySet c_binary_set) {
     auto status = CStatus();
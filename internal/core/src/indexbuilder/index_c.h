@@ -36,6 +36,38 @@ BuildFloatVecIndex(CIndex index, int64_t float_value_num, const float* vectors);
 CStatus
 BuildBinaryVecIndex(CIndex index, int64_t data_size, const uint8_t* vectors);
 
+// the peak memory building the vector index on `num_rows` rows takes, the
+// builds wait until it fits in the memory budget of the node
+CStatus
+EstimateVecIndexBuildMemory(CIndex index, int64_t num_rows, int64_t* bytes);
+
+// the bytes of the running builds and the number of the waiting ones
+CStatus
+GetIndexBuildQueue(int64_t* used_bytes, int64_t* queued);
+
+// streaming build: the vectors are appended batch by batch, e.g. one binlog
+// at a time, and the index is completed by FinishVecIndexBuild. The batches
+// are copied, so they can be released once appended.
+CStatus
+AppendFloatVecIndexData(CIndex index,
+                        int64_t float_value_num,
+                        const float* vectors);
+
+CStatus
+AppendBinaryVecIndexData(CIndex index,
+                         int64_t data_size,
+                         const uint8_t* vectors);
+
+CStatus
+FinishVecIndexBuild(CIndex index);
+
+// build the vector index on the remote binlogs of the field, they are read
+// with the storage config the index was created with
+CStatus
+BuildVecIndexWithBinlogs(CIndex index,
+                         const char* const* binlog_paths,
+                         int64_t num_binlogs);
+
 // field_data:
 //  1, serialized proto::schema::BoolArray, if type is bool;
 //  2, serialized proto::schema::StringArray, if type is string;
@@ -47,6 +79,14 @@ BuildScalarIndex(CIndex c_index, int64_t size, const void* field_data);
 CStatus
 SerializeIndexToBinarySet(CIndex index, CBinarySet* c_binary_set);
 
+// writes the vector index to the remote storage the index was created
+// with, under the path of its build, instead of returning its binaries.
+// The index params must name the collection, partition, segment, field,
+// build and version of the index. The binary set holds the remote paths
+// of the files and their sizes, without data.
+CStatus
+SerializeIndexToRemote(CIndex index, CBinarySet* c_binary_set);
+
 CStatus
 LoadIndexFromBinarySet(CIndex index, CBinarySet c_binary_set);
 
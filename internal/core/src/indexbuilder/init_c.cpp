@@ -11,6 +11,7 @@
 
 #include <string.h>
 #include "config/ConfigKnowhere.h"
+#include "indexbuilder/BuildScheduler.h"
 #include "indexbuilder/init_c.h"
 
 void
@@ -27,3 +28,9 @@ IndexBuilderSetSimdType(const char* value) {
     ret[real_type.length()] = 0;
     return ret;
 }
+
+void
+IndexBuilderSetMemoryBudget(int64_t budget_bytes) {
+    milvus::indexbuilder::BuildScheduler::GetInstance().SetBudget(
+        budget_bytes);
+}
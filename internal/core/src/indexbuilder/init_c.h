@@ -15,6 +15,8 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+
 void
 IndexBuilderInit(const char*);
 
@@ -22,6 +24,11 @@ IndexBuilderInit(const char*);
 char*
 IndexBuilderSetSimdType(const char*);
 
+// the bytes the concurrent index builds of the node may take at peak, 0
+// for no limit
+void
+IndexBuilderSetMemoryBudget(int64_t);
+
 #ifdef __cplusplus
 };
 #endif
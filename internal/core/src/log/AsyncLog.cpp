@@ -0,0 +1,225 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/AsyncLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "log/Log.h"
+
+namespace milvus::log {
+
+namespace {
+
+// how long the flusher sleeps once the buffer is empty
+constexpr auto kFlushInterval = std::chrono::milliseconds(10);
+
+std::atomic<int64_t> site_rate_limit{kDefaultSiteRateLimit};
+
+google::LogSeverity
+ToSeverity(Level level) {
+    switch (level) {
+        case Level::WARNING:
+            return google::GLOG_WARNING;
+        case Level::ERROR:
+            return google::GLOG_ERROR;
+        case Level::FATAL:
+            return google::GLOG_FATAL;
+        default:
+            return google::GLOG_INFO;
+    }
+}
+
+int64_t
+NowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+void
+SetSiteRateLimit(int64_t limit) {
+    site_rate_limit.store(std::max<int64_t>(limit, 0),
+                          std::memory_order_relaxed);
+}
+
+int64_t
+GetSiteRateLimit() {
+    return site_rate_limit.load(std::memory_order_relaxed);
+}
+
+bool
+LogSite::Admit(Level level) {
+    auto limit = GetSiteRateLimit();
+    if (level == Level::FATAL || limit == 0) {
+        return true;
+    }
+    auto now = NowSeconds();
+    auto second = second_.load(std::memory_order_relaxed);
+    if (second != now &&
+        second_.compare_exchange_strong(
+            second, now, std::memory_order_relaxed)) {
+        count_.store(0, std::memory_order_relaxed);
+    }
+    if (count_.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+AsyncLogger&
+AsyncLogger::GetInstance() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+AsyncLogger::AsyncLogger() : slots_(new Slot[kSlots]) {
+    static_assert((kSlots & (kSlots - 1)) == 0);
+    for (size_t i = 0; i < kSlots; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    flusher_ = std::thread(&AsyncLogger::Run, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    flusher_.join();
+    Flush();
+}
+
+bool
+AsyncLogger::Append(Level level,
+                    const char* file,
+                    int line,
+                    std::string_view message) {
+    auto pos = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos & (kSlots - 1)];
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the flusher hasn't written out the slot of a lap before
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->level = level;
+    slot->file = file;
+    slot->line = line;
+    slot->size = std::min(message.size(), kMaxMessageSize);
+    memcpy(slot->text, message.data(), slot->size);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+size_t
+AsyncLogger::Drain() {
+    size_t drained = 0;
+    for (;; ++drained) {
+        auto& slot = slots_[tail_ & (kSlots - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            break;
+        }
+        google::LogMessage(slot.file, slot.line, ToSeverity(slot.level))
+                .stream()
+            << std::string_view(slot.text, slot.size);
+        slot.sequence.store(tail_ + kSlots, std::memory_order_release);
+        ++tail_;
+    }
+    auto dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+        LOG(WARNING) << "[SEGCORE] the log buffer was full, dropped "
+                     << dropped - reported_dropped_ << " messages";
+        reported_dropped_ = dropped;
+    }
+    return drained;
+}
+
+void
+AsyncLogger::Flush() {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    Drain();
+}
+
+void
+AsyncLogger::Run() {
+    SetThreadName("log_flusher");
+    for (;;) {
+        size_t drained;
+        {
+            std::lock_guard<std::mutex> lock(drain_mutex_);
+            drained = Drain();
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        if (stop_) {
+            return;
+        }
+        if (drained == 0) {
+            wake_.wait_for(lock, kFlushInterval, [this] { return stop_; });
+        }
+    }
+}
+
+AsyncLogMessage::AsyncLogMessage(const char* file,
+                                 int line,
+                                 Level level,
+                                 const char* module,
+                                 const char* function,
+                                 LogSite& site)
+    : file_(file),
+      line_(line),
+      level_(level),
+      site_(site),
+      buffer_(text_, sizeof(text_)),
+      stream_(&buffer_) {
+    stream_ << "[" << module << "][" << function << "][" << GetThreadName()
+            << "] ";
+}
+
+AsyncLogMessage::~AsyncLogMessage() {
+    auto suppressed = site_.TakeSuppressed();
+    if (suppressed > 0) {
+        stream_ << " (" << suppressed << " suppressed)";
+    }
+    std::string_view message(text_, buffer_.size());
+    if (level_ == Level::FATAL) {
+        auto& logger = AsyncLogger::GetInstance();
+        logger.Flush();
+        google::LogMessageFatal(file_, line_).stream() << message;
+    }
+    AsyncLogger::GetInstance().Append(level_, file_, line_, message);
+}
+
+}  // namespace milvus::log
@@ -0,0 +1,215 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+
+#include "glog/logging.h"
+
+// The segcore log macros don't write to glog on the calling thread. A
+// message is formatted into a fixed buffer on the stack, copied into a slot
+// of a lock free ring buffer, and written out through glog by a flusher
+// thread, so a search thread never waits on the glog mutex or the disk. A
+// full buffer drops the message rather than block. Every call site admits
+// at most a limited number of messages per second, and the levels below
+// SEGCORE_LOG_MIN_LEVEL are compiled out. FATAL flushes the buffer and
+// aborts on the calling thread.
+
+// 0 TRACE, 1 DEBUG, 2 INFO, 3 WARNING, 4 ERROR, 5 FATAL
+#ifndef SEGCORE_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define SEGCORE_LOG_MIN_LEVEL 2
+#else
+#define SEGCORE_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+namespace milvus::log {
+
+enum class Level {
+    TRACE = 0,
+    DEBUG = 1,
+    INFO = 2,
+    WARNING = 3,
+    ERROR = 4,
+    FATAL = 5,
+};
+
+// the messages a call site admits per second by default
+constexpr int64_t kDefaultSiteRateLimit = 100;
+
+// Admits a message of some call site limited per second, approximately:
+// racing callers may admit a few more at the turn of a second.
+class LogSite {
+ public:
+    constexpr LogSite() = default;
+
+    bool
+    Admit(Level level);
+
+    // the messages not admitted since the last admitted one
+    int64_t
+    TakeSuppressed() {
+        return suppressed_.exchange(0, std::memory_order_relaxed);
+    }
+
+ private:
+    std::atomic<int64_t> second_{0};
+    std::atomic<int64_t> count_{0};
+    std::atomic<int64_t> suppressed_{0};
+};
+
+// the messages per second every call site admits, 0 for unlimited
+void
+SetSiteRateLimit(int64_t limit);
+
+int64_t
+GetSiteRateLimit();
+
+class AsyncLogger {
+ public:
+    // the bytes of a message, the rest of a longer one is cut off
+    static constexpr size_t kMaxMessageSize = 480;
+    // slots of the ring buffer, a power of two
+    static constexpr size_t kSlots = 4096;
+
+    static AsyncLogger&
+    GetInstance();
+
+    ~AsyncLogger();
+
+    // copies the message into a free slot, never blocks; returns false if
+    // the buffer is full and the message is dropped
+    bool
+    Append(Level level, const char* file, int line, std::string_view message);
+
+    // writes out all the messages appended before it on the calling thread
+    void
+    Flush();
+
+    // the messages dropped so far as the buffer was full
+    int64_t
+    dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    AsyncLogger();
+
+    struct Slot {
+        // the position the slot is written at next, plus one once the
+        // message of that position is in
+        std::atomic<uint64_t> sequence;
+        Level level;
+        const char* file;
+        int line;
+        uint32_t size;
+        char text[kMaxMessageSize];
+    };
+
+    // writes out the messages in the buffer, must hold drain_mutex_
+    size_t
+    Drain();
+
+    void
+    Run();
+
+ private:
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    // only touched under drain_mutex_
+    alignas(64) uint64_t tail_ = 0;
+    std::mutex drain_mutex_;
+    std::atomic<int64_t> dropped_{0};
+    int64_t reported_dropped_ = 0;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread flusher_;
+};
+
+// A stream into a buffer on the stack, appended to the AsyncLogger as it
+// goes out of scope. Writes past the buffer are cut off.
+class AsyncLogMessage {
+ public:
+    // starts with the "[module][function][thread name] " prefix of the
+    // segcore logs
+    AsyncLogMessage(const char* file,
+                    int line,
+                    Level level,
+                    const char* module,
+                    const char* function,
+                    LogSite& site);
+
+    ~AsyncLogMessage();
+
+    std::ostream&
+    stream() {
+        return stream_;
+    }
+
+ private:
+    class Buffer : public std::streambuf {
+     public:
+        Buffer(char* begin, size_t size) {
+            setp(begin, begin + size);
+        }
+
+        size_t
+        size() const {
+            return pptr() - pbase();
+        }
+    };
+
+ private:
+    const char* file_;
+    int line_;
+    Level level_;
+    LogSite& site_;
+    char text_[AsyncLogger::kMaxMessageSize];
+    Buffer buffer_;
+    std::ostream stream_;
+};
+
+}  // namespace milvus::log
+
+// Logs through the AsyncLogger if the call site admits it. The loops run
+// the statement once at most, they give the site a static state while the
+// macro stays a single statement that takes `<<`.
+#define SEGCORE_ASYNC_LOG_(level, module)                            \
+    for (bool segcore_log_once_ = true; segcore_log_once_;           \
+         segcore_log_once_ = false)                                  \
+        for (static ::milvus::log::LogSite segcore_log_site_;        \
+             segcore_log_once_ && segcore_log_site_.Admit(level);    \
+             segcore_log_once_ = false)                              \
+    ::milvus::log::AsyncLogMessage(                                  \
+        __FILE__, __LINE__, level, module, __FUNCTION__, segcore_log_site_) \
+        .stream()
+
+// a disabled level compiles its arguments but never evaluates them
+#define SEGCORE_ELIDED_LOG_ \
+    while (false) LOG(INFO)
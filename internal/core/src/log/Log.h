@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include "glog/logging.h"
+#include "log/AsyncLog.h"
 
 // namespace milvus {
 
@@ -54,12 +55,36 @@
            __FUNCTION__,        \
            GetThreadName().c_str())
 
-#define LOG_SEGCORE_TRACE_ DLOG(INFO) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_DEBUG_ DLOG(INFO) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_INFO_ LOG(INFO) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_WARNING_ LOG(WARNING) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_ERROR_ LOG(ERROR) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_FATAL_ LOG(FATAL) << SEGCORE_MODULE_FUNCTION
+// written by the AsyncLogger off the calling thread, see log/AsyncLog.h
+#define SEGCORE_LOG_(level) \
+    SEGCORE_ASYNC_LOG_(::milvus::log::Level::level, SEGCORE_MODULE_NAME)
+
+#if SEGCORE_LOG_MIN_LEVEL <= 0
+#define LOG_SEGCORE_TRACE_ SEGCORE_LOG_(TRACE)
+#else
+#define LOG_SEGCORE_TRACE_ SEGCORE_ELIDED_LOG_
+#endif
+#if SEGCORE_LOG_MIN_LEVEL <= 1
+#define LOG_SEGCORE_DEBUG_ SEGCORE_LOG_(DEBUG)
+#else
+#define LOG_SEGCORE_DEBUG_ SEGCORE_ELIDED_LOG_
+#endif
+#if SEGCORE_LOG_MIN_LEVEL <= 2
+#define LOG_SEGCORE_INFO_ SEGCORE_LOG_(INFO)
+#else
+#define LOG_SEGCORE_INFO_ SEGCORE_ELIDED_LOG_
+#endif
+#if SEGCORE_LOG_MIN_LEVEL <= 3
+#define LOG_SEGCORE_WARNING_ SEGCORE_LOG_(WARNING)
+#else
+#define LOG_SEGCORE_WARNING_ SEGCORE_ELIDED_LOG_
+#endif
+#if SEGCORE_LOG_MIN_LEVEL <= 4
+#define LOG_SEGCORE_ERROR_ SEGCORE_LOG_(ERROR)
+#else
+#define LOG_SEGCORE_ERROR_ SEGCORE_ELIDED_LOG_
+#endif
+#define LOG_SEGCORE_FATAL_ SEGCORE_LOG_(FATAL)
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 #define SERVER_MODULE_NAME "SERVER"
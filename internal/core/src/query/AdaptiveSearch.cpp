@@ -0,0 +1,195 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "query/AdaptiveSearch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/Utils.h"
+#include "index/Meta.h"
+#include "knowhere/comp/index_param.h"
+
+namespace milvus::query {
+
+namespace {
+
+// the weight of the latest search in the moving average
+constexpr double kFeedbackWeight = 0.1;
+// the filter raises the share of the index visited at most this much
+constexpr double kMaxFilterBoost = 8;
+// nlist of an IVF index loaded without its build params
+constexpr int64_t kDefaultNlist = 128;
+constexpr int64_t kMaxEf = 4096;
+// the limits VectorDiskIndex enforces on the search list
+constexpr int64_t kSearchListLimit = 200;
+constexpr int64_t kMaxSearchList = 65535;
+
+// the lists an IVF search probes per thousand
+int64_t
+ProbePermille(RecallTier tier) {
+    switch (tier) {
+        case RecallTier::LOW:
+            return 10;
+        case RecallTier::MEDIUM:
+            return 40;
+        default:
+            return 100;
+    }
+}
+
+// the candidates a graph search keeps, the ef or the search list
+int64_t
+GraphCandidates(RecallTier tier) {
+    switch (tier) {
+        case RecallTier::LOW:
+            return 32;
+        case RecallTier::MEDIUM:
+            return 64;
+        default:
+            return 160;
+    }
+}
+
+bool
+IsIvf(const IndexType& index_type) {
+    return index_type == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFPQ ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFSQ8 ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT;
+}
+
+// the value of a knob, the least it may be scaled down to by the budget
+// and the most it may be raised to
+struct Knob {
+    const char* key = nullptr;
+    int64_t value = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    // the effort of a unit of the knob
+    double unit_effort = 0;
+};
+
+}  // namespace
+
+AdaptiveSearchParams
+AdaptiveSearchTuner::Pick(
+    const IndexType& index_type,
+    const std::map<std::string, std::string>& index_params,
+    const SearchInfo& search_info,
+    int64_t row_count,
+    double pass_ratio,
+    int64_t num_queries) const {
+    AdaptiveSearchParams picked;
+    picked.search_params = search_info.search_params_;
+    if (!search_info.adaptive_.has_value()) {
+        return picked;
+    }
+    auto& target = search_info.adaptive_.value();
+    auto tier = target.recall_tier_;
+    auto topk = search_info.topk_;
+    // the fewer rows pass the filter, the more of the index the hits are
+    // spread over
+    auto boost = std::min(1 / std::sqrt(std::max(pass_ratio, 1e-6)),
+                          kMaxFilterBoost);
+    auto rows = double(std::max<int64_t>(row_count, 2));
+
+    Knob knob;
+    if (IsIvf(index_type)) {
+        auto nlist = kDefaultNlist;
+        if (auto it = index_params.find(knowhere::indexparam::NLIST);
+            it != index_params.end()) {
+            nlist = std::max<int64_t>(std::stoll(it->second), 1);
+        }
+        auto probes = [&](RecallTier tier) {
+            return std::clamp<int64_t>(
+                upper_div(nlist * ProbePermille(tier), 1000), 1, nlist);
+        };
+        knob.key = knowhere::indexparam::NPROBE;
+        knob.min = probes(RecallTier::LOW);
+        knob.max = nlist;
+        knob.value = std::clamp<int64_t>(
+            static_cast<int64_t>(std::ceil(probes(tier) * boost)),
+            knob.min,
+            knob.max);
+        knob.unit_effort = rows / nlist;
+    } else if (index_type == knowhere::IndexEnum::INDEX_HNSW ||
+               index_type == knowhere::IndexEnum::INDEX_DISKANN) {
+        auto is_hnsw = index_type == knowhere::IndexEnum::INDEX_HNSW;
+        knob.key = is_hnsw ? knowhere::indexparam::EF
+                           : index::DISK_ANN_QUERY_LIST;
+        knob.min = std::max(topk, GraphCandidates(RecallTier::LOW));
+        knob.max = is_hnsw ? std::max(topk, kMaxEf)
+                           : std::min(std::max(topk * 10, kSearchListLimit),
+                                      kMaxSearchList);
+        knob.min = std::min(knob.min, knob.max);
+        knob.value = std::clamp<int64_t>(
+            static_cast<int64_t>(std::ceil(GraphCandidates(tier) * boost)),
+            knob.min,
+            knob.max);
+        // a graph search visits about its candidates per level
+        knob.unit_effort = std::log2(rows);
+    } else {
+        return picked;
+    }
+
+    auto ms_per_effort = MsPerEffort(index_type);
+    if (target.latency_budget_ms_ > 0 && ms_per_effort > 0) {
+        auto expected_ms =
+            knob.value * knob.unit_effort * num_queries * ms_per_effort;
+        if (expected_ms > target.latency_budget_ms_) {
+            knob.value = std::max<int64_t>(
+                knob.min,
+                static_cast<int64_t>(knob.value * target.latency_budget_ms_ /
+                                     expected_ms));
+        }
+    }
+    picked.search_params[knob.key] = knob.value;
+    picked.effort = knob.value * knob.unit_effort * num_queries;
+    return picked;
+}
+
+void
+AdaptiveSearchTuner::Observe(const IndexType& index_type,
+                             double effort,
+                             double elapsed_ms) {
+    if (effort <= 0) {
+        return;
+    }
+    auto sample = elapsed_ms / effort;
+    std::lock_guard lck(mutex_);
+    auto [it, inserted] = ms_per_effort_.emplace(index_type, sample);
+    if (!inserted) {
+        it->second += kFeedbackWeight * (sample - it->second);
+    }
+}
+
+double
+AdaptiveSearchTuner::MsPerEffort(const IndexType& index_type) const {
+    std::lock_guard lck(mutex_);
+    auto it = ms_per_effort_.find(index_type);
+    return it == ms_per_effort_.end() ? 0 : it->second;
+}
+
+void
+AdaptiveSearchTuner::Reset() {
+    std::lock_guard lck(mutex_);
+    ms_per_effort_.clear();
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,81 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/QueryInfo.h"
+#include "common/Types.h"
+#include "knowhere/config.h"
+
+namespace milvus::query {
+
+// the params picked for an index search, with the work they are expected to
+// cost: the rows or graph nodes visited over all the queries
+struct AdaptiveSearchParams {
+    knowhere::Json search_params;
+    double effort = 0;
+};
+
+// Picks the params of an index search from the recall tier and latency
+// budget of a plan: the nprobe of IVF indexes, the ef of HNSW and the
+// search_list of DiskANN. The tier sets the share of the index visited,
+// raised when a selective filter leaves fewer hits per list or neighborhood.
+// The budget scales it down by the latency per unit of work the previous
+// searches of the index type saw, to no less than the low tier. Other index
+// types keep the params of the plan.
+class AdaptiveSearchTuner {
+ public:
+    static AdaptiveSearchTuner&
+    GetInstance() {
+        static AdaptiveSearchTuner tuner;
+        return tuner;
+    }
+
+    // the params for searching an index of `row_count` rows loaded with
+    // `index_params`, `pass_ratio` of which pass the filter
+    AdaptiveSearchParams
+    Pick(const IndexType& index_type,
+         const std::map<std::string, std::string>& index_params,
+         const SearchInfo& search_info,
+         int64_t row_count,
+         double pass_ratio,
+         int64_t num_queries) const;
+
+    // feeds back a search of `effort` which took `elapsed_ms`
+    void
+    Observe(const IndexType& index_type, double effort, double elapsed_ms);
+
+    // the moving average of the latency per unit of effort of the index
+    // type, 0 before its first search
+    double
+    MsPerEffort(const IndexType& index_type) const;
+
+    void
+    Reset();
+
+ private:
+    mutable std::mutex mutex_;
+    std::unordered_map<IndexType, double> ms_per_effort_;
+};
+
+}  // namespace milvus::query
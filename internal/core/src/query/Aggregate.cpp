@@ -0,0 +1,187 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "query/Aggregate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <type_traits>
+
+#include "common/BitsetOps.h"
+#include "common/ZoneMap.h"
+#include "index/ScalarIndex.h"
+#include "query/FieldValues.h"
+
+namespace milvus::query {
+
+namespace {
+
+// integers are aggregated as int64_t, floating points as double
+template <typename T>
+using AggregateValue =
+    std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+
+// the smallest value of the rows which aren't excluded, or the largest.
+// A single index over all the rows walks its sorted values, without any
+// exclusion the zone maps answer for the chunks they cover whole, the
+// rest of the rows are scanned.
+template <typename T>
+std::optional<AggregateValue<T>>
+ExtremeValue(const segcore::SegmentInternalInterface& segment,
+             FieldId field_id,
+             const BitsetType& excluded,
+             bool largest) {
+    using Value = AggregateValue<T>;
+    auto row_count = int64_t(excluded.size());
+    auto size_per_chunk = segment.size_per_chunk();
+    if (row_count <= size_per_chunk && segment.num_chunk_index(field_id) > 0) {
+        auto& index = segment.chunk_scalar_index<T>(field_id, 0);
+        auto offset = index.ExtremeOffset(excluded, largest);
+        if (offset >= 0) {
+            return Value(index.Reverse_Lookup(offset));
+        }
+    }
+
+    std::optional<Value> result;
+    auto update = [&](Value value) {
+        if constexpr (std::is_floating_point_v<Value>) {
+            if (std::isnan(value)) {
+                return;
+            }
+        }
+        if (!result.has_value() ||
+            (largest ? result.value() < value : value < result.value())) {
+            result = value;
+        }
+    };
+    if (!excluded.none()) {
+        ForEachIncludedValue<T>(
+            segment, field_id, excluded, [&](int64_t, T value) {
+                update(value);
+            });
+        return result;
+    }
+    auto segment_rows = segment.get_row_count();
+    for (int64_t beg = 0; beg < row_count; beg += size_per_chunk) {
+        auto chunk_id = beg / size_per_chunk;
+        auto end = std::min(row_count, beg + size_per_chunk);
+        // the zone map covers the rows written to the chunk so far
+        if (std::min(segment_rows, beg + size_per_chunk) == end) {
+            if (auto zone = segment.chunk_zone_map<T>(field_id, chunk_id)) {
+                if (!zone->empty()) {
+                    update(largest ? zone->max() : zone->min());
+                }
+                continue;
+            }
+        }
+        ChunkValues<T> values(segment, field_id, chunk_id);
+        for (int64_t i = 0; i < end - beg; ++i) {
+            values.visit(i, update);
+        }
+    }
+    return result;
+}
+
+template <typename Value>
+DataArray
+WrapAggregate(const Aggregate& aggregate, const std::optional<Value>& value) {
+    DataArray arr;
+    if (aggregate.op_ != AggregateOp::Count) {
+        arr.set_field_id(aggregate.field_id_.get());
+    }
+    auto scalars = arr.mutable_scalars();
+    if constexpr (std::is_floating_point_v<Value>) {
+        arr.set_type(proto::schema::DataType::Double);
+        if (value.has_value()) {
+            scalars->mutable_double_data()->add_data(value.value());
+        }
+    } else {
+        arr.set_type(proto::schema::DataType::Int64);
+        if (value.has_value()) {
+            scalars->mutable_long_data()->add_data(value.value());
+        }
+    }
+    return arr;
+}
+
+template <typename T>
+DataArray
+AggregateField(const segcore::SegmentInternalInterface& segment,
+               const Aggregate& aggregate,
+               const BitsetType& excluded) {
+    using Value = AggregateValue<T>;
+    auto field_id = aggregate.field_id_;
+    if (aggregate.op_ == AggregateOp::Sum) {
+        Value sum = 0;
+        ForEachIncludedValue<T>(segment,
+                                field_id,
+                                excluded,
+                                [&](int64_t, T value) { sum += value; });
+        return WrapAggregate(aggregate, std::optional<Value>(sum));
+    }
+    std::optional<Value> value;
+    if (BitsetCount(excluded) < int64_t(excluded.size())) {
+        value = ExtremeValue<T>(segment,
+                                field_id,
+                                excluded,
+                                aggregate.op_ == AggregateOp::Max);
+    }
+    return WrapAggregate(aggregate, value);
+}
+
+}  // namespace
+
+bool
+IsAggregatable(AggregateOp op, DataType data_type) {
+    if (op == AggregateOp::Count) {
+        return true;
+    }
+    return datatype_is_integer(data_type) || datatype_is_floating(data_type);
+}
+
+DataArray
+AggregateRows(const segcore::SegmentInternalInterface& segment,
+              const Aggregate& aggregate,
+              const BitsetType& excluded) {
+    if (aggregate.op_ == AggregateOp::Count) {
+        return WrapAggregate(
+            aggregate,
+            std::optional<int64_t>(excluded.size() - BitsetCount(excluded)));
+    }
+    auto data_type =
+        segment.get_schema()[aggregate.field_id_].get_data_type();
+    switch (data_type) {
+        case DataType::INT8:
+            return AggregateField<int8_t>(segment, aggregate, excluded);
+        case DataType::INT16:
+            return AggregateField<int16_t>(segment, aggregate, excluded);
+        case DataType::INT32:
+            return AggregateField<int32_t>(segment, aggregate, excluded);
+        case DataType::INT64:
+            return AggregateField<int64_t>(segment, aggregate, excluded);
+        case DataType::FLOAT:
+            return AggregateField<float>(segment, aggregate, excluded);
+        case DataType::DOUBLE:
+            return AggregateField<double>(segment, aggregate, excluded);
+        default:
+            PanicInfo(fmt::format("can't aggregate a field of type {}",
+                                  datatype_name(data_type)));
+    }
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,41 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "common/Types.h"
+#include "query/PlanNode.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::query {
+
+// whether `op` can aggregate a field of `data_type`: Count any, Min, Max
+// and Sum only the numeric ones
+bool
+IsAggregatable(AggregateOp op, DataType data_type);
+
+// `aggregate` over the first excluded.size() rows of `segment` which aren't
+// set in `excluded`, as a column of one value: Int64 for Count and the
+// integer fields, Double for the floating point ones. It's the partial
+// aggregate of the segment, Min and Max of no rows leave it empty and both
+// skip NaN.
+DataArray
+AggregateRows(const segcore::SegmentInternalInterface& segment,
+              const Aggregate& aggregate,
+              const BitsetType& excluded);
+
+}  // namespace milvus::query
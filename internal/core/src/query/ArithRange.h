@@ -0,0 +1,164 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+#include "common/Types.h"
+
+namespace milvus::query {
+
+// the field values x with `x arith_op operand == value`, as an inclusive
+// range, in exact integer arithmetic
+struct ArithInverse {
+    int64_t lower;
+    int64_t upper;
+
+    bool
+    empty() const {
+        return lower > upper;
+    }
+};
+
+// inverts `x arith_op operand == value` over the integers in [min, max],
+// so it can be answered by a range compare on the field itself, nullopt for
+// the operations that don't invert to a range: mod and a zero divisor
+inline std::optional<ArithInverse>
+InvertArithEqual(ArithOpType arith_op,
+                 int64_t operand,
+                 int64_t value,
+                 int64_t min,
+                 int64_t max) {
+    using Wide = __int128;
+    Wide lower, upper;
+    switch (arith_op) {
+        case ArithOpType::Add: {
+            lower = upper = Wide(value) - operand;
+            break;
+        }
+        case ArithOpType::Sub: {
+            lower = upper = Wide(value) + operand;
+            break;
+        }
+        case ArithOpType::Mul: {
+            if (operand == 0) {
+                lower = value == 0 ? min : 1;
+                upper = value == 0 ? max : 0;
+            } else if (Wide(value) % operand != 0) {
+                lower = 1;
+                upper = 0;
+            } else {
+                lower = upper = Wide(value) / operand;
+            }
+            break;
+        }
+        case ArithOpType::Div: {
+            if (operand == 0) {
+                return std::nullopt;
+            }
+            // division truncates toward zero, so x / d == q is x / -d == -q
+            Wide d = operand, q = value;
+            if (d < 0) {
+                d = -d;
+                q = -q;
+            }
+            lower = q > 0 ? q * d : q * d - (d - 1);
+            upper = q < 0 ? q * d : q * d + (d - 1);
+            break;
+        }
+        default: {
+            return std::nullopt;
+        }
+    }
+    lower = std::max(lower, Wide(min));
+    upper = std::min(upper, Wide(max));
+    if (lower > upper) {
+        return ArithInverse{1, 0};
+    }
+    return ArithInverse{int64_t(lower), int64_t(upper)};
+}
+
+// remainder of the division by a divisor only known at run time, with a
+// multiply and shift in place of the hardware divide (Hacker's Delight,
+// 10-1); truncating like `%`, the remainder has the sign of the dividend
+class FastMod {
+ public:
+    explicit FastMod(int64_t divisor) : divisor_(divisor) {
+        uint64_t abs_divisor =
+            divisor < 0 ? 0 - uint64_t(divisor) : uint64_t(divisor);
+        trivial_ = abs_divisor == 1;
+        if (abs_divisor < 2) {
+            return;
+        }
+        constexpr uint64_t two63 = uint64_t(1) << 63;
+        uint64_t t = two63 + (uint64_t(divisor) >> 63);
+        uint64_t anc = t - 1 - t % abs_divisor;
+        int p = 63;
+        uint64_t q1 = two63 / anc, r1 = two63 - q1 * anc;
+        uint64_t q2 = two63 / abs_divisor, r2 = two63 - q2 * abs_divisor;
+        uint64_t delta;
+        do {
+            ++p;
+            q1 *= 2;
+            r1 *= 2;
+            if (r1 >= anc) {
+                ++q1;
+                r1 -= anc;
+            }
+            q2 *= 2;
+            r2 *= 2;
+            if (r2 >= abs_divisor) {
+                ++q2;
+                r2 -= abs_divisor;
+            }
+            delta = abs_divisor - r2;
+        } while (q1 < delta || (q1 == delta && r1 == 0));
+        magic_ = int64_t(q2 + 1);
+        if (divisor < 0) {
+            magic_ = int64_t(0 - uint64_t(magic_));
+        }
+        shift_ = p - 64;
+    }
+
+    // the divisor is not zero
+    int64_t
+    operator()(int64_t n) const {
+        if (trivial_) {
+            return 0;
+        }
+        auto q = int64_t((__int128(magic_) * n) >> 64);
+        if (divisor_ > 0 && magic_ < 0) {
+            q += n;
+        } else if (divisor_ < 0 && magic_ > 0) {
+            q -= n;
+        }
+        q >>= shift_;
+        q += int64_t(uint64_t(q) >> 63);
+        return int64_t(uint64_t(n) - uint64_t(q) * uint64_t(divisor_));
+    }
+
+ private:
+    int64_t divisor_;
+    int64_t magic_ = 0;
+    int shift_ = 0;
+    bool trivial_ = false;
+};
+
+}  // namespace milvus::query
@@ -0,0 +1,88 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "query/BinaryBruteForce.h"
+
+#include <algorithm>
+
+#include "common/Consts.h"
+#include "common/Utils.h"
+#include "simd/hook.h"
+
+namespace milvus::query {
+
+bool
+BinaryBruteForce::Supports(const FieldMeta& field,
+                           const SearchInfo& search_info) {
+    auto& metric_type = search_info.metric_type_;
+    return field.get_data_type() == DataType::VECTOR_BINARY &&
+           (IsMetricType(metric_type, knowhere::metric::HAMMING) ||
+            IsMetricType(metric_type, knowhere::metric::JACCARD)) &&
+           !search_info.search_params_.contains(RADIUS);
+}
+
+BinaryBruteForce::BinaryBruteForce(const uint8_t* queries,
+                                   int64_t num_queries,
+                                   int64_t dim,
+                                   int64_t topk,
+                                   const MetricType& metric_type)
+    : num_queries_(num_queries),
+      code_size_(dim / 8),
+      topk_(topk),
+      metric_(IsMetricType(metric_type, knowhere::metric::JACCARD)
+                  ? simd::BinaryMetric::JACCARD
+                  : simd::BinaryMetric::HAMMING),
+      queries_(queries),
+      distances_(num_queries * kRowBlock),
+      heaps_(num_queries, topk, false) {
+}
+
+void
+BinaryBruteForce::Add(const uint8_t* rows,
+                      int64_t size,
+                      int64_t offset,
+                      const BitsetView& bitset) {
+    if (topk_ <= 0) {
+        return;
+    }
+    for (int64_t block = 0; block < size; block += kRowBlock) {
+        auto block_size = std::min(kRowBlock, size - block);
+        simd::BinaryDistances(metric_,
+                              queries_,
+                              num_queries_,
+                              rows + block * code_size_,
+                              block_size,
+                              code_size_,
+                              distances_.data());
+        for (int64_t r = 0; r < block_size; ++r) {
+            if (!bitset.empty() && bitset.test(block + r)) {
+                continue;
+            }
+            for (int64_t q = 0; q < num_queries_; ++q) {
+                heaps_.Push(
+                    q, {distances_[q * block_size + r], offset + block + r});
+            }
+        }
+    }
+}
+
+void
+BinaryBruteForce::Finish(SubSearchResult& result) {
+    heaps_.Finish(result);
+}
+
+}  // namespace milvus::query
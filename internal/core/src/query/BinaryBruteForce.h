@@ -0,0 +1,76 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/FieldMeta.h"
+#include "common/QueryInfo.h"
+#include "query/SubSearchResult.h"
+#include "query/TopkHeaps.h"
+#include "simd/common.h"
+
+namespace milvus::query {
+
+// exact HAMMING/JACCARD top-k of a batch of binary queries over the rows of
+// a segment, fed in chunks. The distances of all the queries to a block of
+// rows come from the popcount kernels of simd::BinaryDistances, the top-k
+// heap of each query persists across the chunks, so there is no per chunk
+// result to merge. The queries must outlive it.
+class BinaryBruteForce {
+ public:
+    static constexpr int64_t kRowBlock = 256;
+
+    // binary vectors with the HAMMING or JACCARD metric, and not a range
+    // search
+    static bool
+    Supports(const FieldMeta& field, const SearchInfo& search_info);
+
+    BinaryBruteForce(const uint8_t* queries,
+                     int64_t num_queries,
+                     int64_t dim,
+                     int64_t topk,
+                     const MetricType& metric_type);
+
+    // searches `size` rows, the first of them at segment offset `offset`,
+    // skipping those with their bit set in `bitset`
+    void
+    Add(const uint8_t* rows,
+        int64_t size,
+        int64_t offset,
+        const BitsetView& bitset);
+
+    // writes the top-k of every query, best first, the slots of queries
+    // with fewer hits keep their initial values
+    void
+    Finish(SubSearchResult& result);
+
+ private:
+    int64_t num_queries_;
+    int64_t code_size_;
+    int64_t topk_;
+    simd::BinaryMetric metric_;
+    const uint8_t* queries_;
+    // the distances of every query to the block of rows being searched
+    std::vector<float> distances_;
+    TopkHeaps heaps_;
+};
+
+}  // namespace milvus::query
@@ -0,0 +1,203 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "query/BlockedBruteForce.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "common/Consts.h"
+#include "common/Utils.h"
+
+namespace milvus::query {
+
+namespace {
+
+// eight floats, lowered to the vector registers of the target
+typedef float Float8 __attribute__((vector_size(32)));
+
+static_assert(BlockedBruteForce::kRowTile == 8 &&
+              BlockedBruteForce::kQueryTile == 8);
+
+// inner products of `kQueries` queries, `dim` apart, with the kRowTile rows
+// of a dimension major tile, accumulated in dimension order in a block of
+// registers, one per query
+template <int64_t kQueries>
+void
+TileProducts(const float* queries,
+             const float* tile,
+             int64_t dim,
+             float* products) {
+    Float8 acc[kQueries] = {};
+    for (int64_t d = 0; d < dim; ++d) {
+        Float8 column;
+        memcpy(&column, tile + d * BlockedBruteForce::kRowTile, sizeof(column));
+        for (int64_t q = 0; q < kQueries; ++q) {
+            acc[q] += queries[q * dim + d] * column;
+        }
+    }
+    memcpy(products, acc, sizeof(acc));
+}
+
+// a whole tile of queries, or the largest power of two of the ones left,
+// returns how many queries it computed
+int64_t
+TileProducts(const float* queries,
+             int64_t num_queries,
+             const float* tile,
+             int64_t dim,
+             float* products) {
+    if (num_queries >= 8) {
+        TileProducts<8>(queries, tile, dim, products);
+        return 8;
+    }
+    if (num_queries >= 4) {
+        TileProducts<4>(queries, tile, dim, products);
+        return 4;
+    }
+    if (num_queries >= 2) {
+        TileProducts<2>(queries, tile, dim, products);
+        return 2;
+    }
+    TileProducts<1>(queries, tile, dim, products);
+    return 1;
+}
+
+}  // namespace
+
+bool
+BlockedBruteForce::Supports(const FieldMeta& field,
+                            const SearchInfo& search_info) {
+    auto& metric_type = search_info.metric_type_;
+    return field.get_data_type() == DataType::VECTOR_FLOAT &&
+           IsFloatMetricType(metric_type) &&
+           !search_info.search_params_.contains(RADIUS);
+}
+
+void
+BlockedBruteForce::SquaredNorms(const float* rows,
+                                int64_t size,
+                                int64_t dim,
+                                float* norms) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * dim;
+        float norm = 0;
+        for (int64_t d = 0; d < dim; ++d) {
+            norm += row[d] * row[d];
+        }
+        norms[i] = norm;
+    }
+}
+
+BlockedBruteForce::BlockedBruteForce(const float* queries,
+                                     int64_t num_queries,
+                                     int64_t dim,
+                                     int64_t topk,
+                                     const MetricType& metric_type)
+    : num_queries_(num_queries),
+      dim_(dim),
+      topk_(topk),
+      is_ip_(PositivelyRelated(metric_type)),
+      is_cosine_(IsMetricType(metric_type, knowhere::metric::COSINE)),
+      queries_(queries),
+      query_norms_(num_queries),
+      packed_(kRowBlock * dim),
+      block_norms_(kRowBlock),
+      heaps_(num_queries, topk, is_ip_) {
+    SquaredNorms(queries, num_queries, dim, query_norms_.data());
+}
+
+float
+BlockedBruteForce::Distance(float product,
+                            float query_norm,
+                            float row_norm) const {
+    if (is_cosine_) {
+        auto norms = std::sqrt(query_norm) * std::sqrt(row_norm);
+        return norms > 0 ? product / norms : 0.0f;
+    }
+    if (is_ip_) {
+        return product;
+    }
+    // rounding may take the distance of close vectors below zero
+    return std::max(query_norm + row_norm - 2 * product, 0.0f);
+}
+
+void
+BlockedBruteForce::Add(const float* rows,
+                       int64_t size,
+                       int64_t offset,
+                       const BitsetView& bitset,
+                       const float* norms) {
+    if (topk_ <= 0) {
+        return;
+    }
+    float products[kQueryTile * kRowTile];
+    for (int64_t block = 0; block < size; block += kRowBlock) {
+        auto block_size = std::min(kRowBlock, size - block);
+        auto num_tiles = upper_div(block_size, kRowTile);
+        // the tail of the last tile is zeros, its distances are dropped
+        std::fill_n(packed_.data(), num_tiles * kRowTile * dim_, 0.0f);
+        for (int64_t i = 0; i < block_size; ++i) {
+            const float* row = rows + (block + i) * dim_;
+            float* tile = packed_.data() + (i / kRowTile) * kRowTile * dim_;
+            for (int64_t d = 0; d < dim_; ++d) {
+                tile[d * kRowTile + i % kRowTile] = row[d];
+            }
+        }
+        const float* row_norms = block_norms_.data();
+        if (norms != nullptr) {
+            row_norms = norms + block;
+        } else {
+            SquaredNorms(
+                rows + block * dim_, block_size, dim_, block_norms_.data());
+        }
+
+        for (int64_t q = 0; q < num_queries_;) {
+            int64_t tile_queries = 0;
+            for (int64_t t = 0; t < num_tiles; ++t) {
+                const float* tile = packed_.data() + t * kRowTile * dim_;
+                auto queries = queries_ + q * dim_;
+                tile_queries = TileProducts(
+                    queries, num_queries_ - q, tile, dim_, products);
+                auto tile_begin = block + t * kRowTile;
+                auto tile_rows = std::min(kRowTile, size - tile_begin);
+                for (int64_t r = 0; r < tile_rows; ++r) {
+                    if (!bitset.empty() && bitset.test(tile_begin + r)) {
+                        continue;
+                    }
+                    auto row_norm = row_norms[tile_begin - block + r];
+                    for (int64_t i = 0; i < tile_queries; ++i) {
+                        auto distance = Distance(products[i * kRowTile + r],
+                                                 query_norms_[q + i],
+                                                 row_norm);
+                        heaps_.Push(q + i,
+                                    {distance, offset + tile_begin + r});
+                    }
+                }
+            }
+            q += tile_queries;
+        }
+    }
+}
+
+void
+BlockedBruteForce::Finish(SubSearchResult& result) {
+    heaps_.Finish(result);
+}
+
+}  // namespace milvus::query
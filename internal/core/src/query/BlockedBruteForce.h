@@ -0,0 +1,99 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/FieldMeta.h"
+#include "common/QueryInfo.h"
+#include "query/SubSearchResult.h"
+#include "query/TopkHeaps.h"
+
+namespace milvus::query {
+
+// exact L2/IP/COSINE top-k of a batch of float queries over the rows of a
+// segment, fed in chunks. Rows are packed a block at a time into tiles laid
+// out dimension major, every tile of queries runs against the block while
+// it is in cache, and a register block of queries x rows accumulates the
+// inner products over the dimensions, vectorized across the rows. L2 is
+// |q|^2 + |x|^2 - 2 q.x and COSINE q.x / (|q| |x|), with the norms of the
+// queries computed once and those of the rows taken from the segment. The
+// top-k heap of each query persists across the chunks, so there is no per
+// chunk result to merge. The queries must outlive it.
+class BlockedBruteForce {
+ public:
+    static constexpr int64_t kQueryTile = 8;
+    static constexpr int64_t kRowTile = 8;
+    static constexpr int64_t kRowBlock = 256;
+
+    // float vectors with the L2, IP or COSINE metric, and not a range search
+    static bool
+    Supports(const FieldMeta& field, const SearchInfo& search_info);
+
+    // the squared norms of `size` rows into `norms`, segments keep them
+    // with their float vectors for Add
+    static void
+    SquaredNorms(const float* rows, int64_t size, int64_t dim, float* norms);
+
+    BlockedBruteForce(const float* queries,
+                      int64_t num_queries,
+                      int64_t dim,
+                      int64_t topk,
+                      const MetricType& metric_type);
+
+    // searches `size` rows, the first of them at segment offset `offset`,
+    // skipping those with their bit set in `bitset`. `norms` are the squared
+    // norms of the rows, computed a block at a time if null
+    void
+    Add(const float* rows,
+        int64_t size,
+        int64_t offset,
+        const BitsetView& bitset,
+        const float* norms = nullptr);
+
+    // writes the top-k of every query, best first, the slots of queries
+    // with fewer hits keep their initial values
+    void
+    Finish(SubSearchResult& result);
+
+ private:
+    // the distance of a query to a row from their inner product and their
+    // squared norms
+    float
+    Distance(float product, float query_norm, float row_norm) const;
+
+ private:
+    int64_t num_queries_;
+    int64_t dim_;
+    int64_t topk_;
+    // larger distances are better, IP and COSINE
+    bool is_ip_;
+    bool is_cosine_;
+    const float* queries_;
+    // squared norms of the queries
+    std::vector<float> query_norms_;
+    // the block of rows being searched, tile after tile
+    std::vector<float> packed_;
+    // squared norms of the block when Add isn't given them
+    std::vector<float> block_norms_;
+    TopkHeaps heaps_;
+};
+
+}  // namespace milvus::query
@@ -0,0 +1,373 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "query/CanMatch.h"
+
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "index/ScalarIndex.h"
+#include "query/ExprImpl.h"
+
+namespace milvus::query {
+
+namespace {
+
+ZoneMatch
+Not(ZoneMatch match) {
+    switch (match) {
+        case ZoneMatch::None:
+            return ZoneMatch::All;
+        case ZoneMatch::All:
+            return ZoneMatch::None;
+        default:
+            return ZoneMatch::Some;
+    }
+}
+
+ZoneMatch
+And(ZoneMatch left, ZoneMatch right) {
+    if (left == ZoneMatch::None || right == ZoneMatch::None) {
+        return ZoneMatch::None;
+    }
+    if (left == ZoneMatch::All && right == ZoneMatch::All) {
+        return ZoneMatch::All;
+    }
+    return ZoneMatch::Some;
+}
+
+ZoneMatch
+Or(ZoneMatch left, ZoneMatch right) {
+    return Not(And(Not(left), Not(right)));
+}
+
+ZoneMatch
+Xor(ZoneMatch left, ZoneMatch right) {
+    if (left == ZoneMatch::Some || right == ZoneMatch::Some) {
+        return ZoneMatch::Some;
+    }
+    return left == right ? ZoneMatch::None : ZoneMatch::All;
+}
+
+// the match of the rows of the field from the match zone_func makes of the
+// min/max of every chunk, Some if a chunk has no zone map
+template <typename T, typename ZoneFunc>
+ZoneMatch
+MatchZones(const segcore::SegmentInternalInterface& segment,
+           FieldId field_id,
+           ZoneFunc zone_func) {
+    if constexpr (!IsZoneMapSupported<T>) {
+        return ZoneMatch::Some;
+    } else {
+        auto num_chunk = segment.num_chunk_data(field_id);
+        std::optional<ZoneMatch> match;
+        for (int64_t chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+            auto zone_map = segment.chunk_zone_map<T>(field_id, chunk_id);
+            if (!zone_map.has_value()) {
+                return ZoneMatch::Some;
+            }
+            auto chunk_match = zone_func(zone_map.value());
+            if (chunk_match == ZoneMatch::Some ||
+                (match.has_value() && match.value() != chunk_match)) {
+                return ZoneMatch::Some;
+            }
+            match = chunk_match;
+        }
+        return match.value_or(ZoneMatch::Some);
+    }
+}
+
+// the match of the rows of the field from the rows its scalar index counts
+// with count_func, Some if the index doesn't cover every row of the segment
+// or can't count them
+template <typename T, typename CountFunc>
+ZoneMatch
+MatchIndex(const segcore::SegmentInternalInterface& segment,
+           FieldId field_id,
+           CountFunc count_func) {
+    using Index = index::ScalarIndex<T>;
+    auto num_chunk = segment.num_chunk_index(field_id);
+    int64_t matched = 0;
+    int64_t total = 0;
+    for (int64_t chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+        const Index& indexing =
+            segment.chunk_scalar_index<T>(field_id, chunk_id);
+        // NOTE: knowhere is not const-ready
+        auto index = const_cast<Index*>(&indexing);
+        auto count = count_func(index);
+        if (count < 0) {
+            return ZoneMatch::Some;
+        }
+        matched += count;
+        total += index->Count();
+    }
+    // growing segments index the full chunks only
+    if (num_chunk == 0 || total < segment.get_row_count()) {
+        return ZoneMatch::Some;
+    }
+    if (matched == 0) {
+        return ZoneMatch::None;
+    }
+    return matched == total ? ZoneMatch::All : ZoneMatch::Some;
+}
+
+// None if no row of the pk or partition key field has any of the n values,
+// from the bloom filters of their keys
+template <typename T>
+ZoneMatch
+MatchKeys(const segcore::SegmentInternalInterface& segment,
+          FieldId field_id,
+          const T* values,
+          size_t n) {
+    if constexpr (std::is_same_v<T, int64_t> ||
+                  std::is_same_v<T, std::string>) {
+        std::vector<PkType> keys(values, values + n);
+        if (segment.get_schema().get_primary_field_id() == field_id) {
+            return segment.may_contain_pks(keys.data(), keys.size())
+                       ? ZoneMatch::Some
+                       : ZoneMatch::None;
+        }
+        if (auto stats = segment.partition_key_stats(field_id)) {
+            for (auto& key : keys) {
+                if (stats->may_contain(key)) {
+                    return ZoneMatch::Some;
+                }
+            }
+            return ZoneMatch::None;
+        }
+    }
+    return ZoneMatch::Some;
+}
+
+template <typename T>
+ZoneMatch
+MatchUnaryRange(const UnaryRangeExpr& expr_raw,
+                const segcore::SegmentInternalInterface& segment) {
+    auto& expr = static_cast<const UnaryRangeExprImpl<T>&>(expr_raw);
+    auto op = expr.op_type_;
+    auto field_id = expr.column_.field_id;
+    auto match = ZoneMatch::Some;
+    if constexpr (IsZoneMapSupported<T>) {
+        auto value = ZoneValueType<T>(expr.value_);
+        match = MatchZones<T>(
+            segment, field_id, [&](const ZoneMapOf<T>& zone_map) {
+                return zone_map.MatchUnaryRange(op, value);
+            });
+    }
+    if (match == ZoneMatch::Some) {
+        match = MatchIndex<T>(
+            segment, field_id, [&](index::ScalarIndex<T>* index) -> int64_t {
+                switch (op) {
+                    case OpType::Equal:
+                        return index->CountIn(1, &expr.value_);
+                    case OpType::NotEqual: {
+                        auto count = index->CountIn(1, &expr.value_);
+                        return count < 0 ? count : index->Count() - count;
+                    }
+                    case OpType::GreaterThan:
+                    case OpType::GreaterEqual:
+                    case OpType::LessThan:
+                    case OpType::LessEqual:
+                        return index->CountRange(expr.value_, op);
+                    default:
+                        return -1;
+                }
+            });
+    }
+    if (match == ZoneMatch::Some && op == OpType::Equal) {
+        match = MatchKeys<T>(segment, field_id, &expr.value_, 1);
+    }
+    return match;
+}
+
+template <typename T>
+ZoneMatch
+MatchBinaryRange(const BinaryRangeExpr& expr_raw,
+                 const segcore::SegmentInternalInterface& segment) {
+    auto& expr = static_cast<const BinaryRangeExprImpl<T>&>(expr_raw);
+    auto field_id = expr.column_.field_id;
+    auto match = ZoneMatch::Some;
+    if constexpr (IsZoneMapSupported<T>) {
+        auto lower = ZoneValueType<T>(expr.lower_value_);
+        auto upper = ZoneValueType<T>(expr.upper_value_);
+        match = MatchZones<T>(
+            segment, field_id, [&](const ZoneMapOf<T>& zone_map) {
+                return zone_map.MatchBinaryRange(lower,
+                                                 expr.lower_inclusive_,
+                                                 upper,
+                                                 expr.upper_inclusive_);
+            });
+    }
+    if (match == ZoneMatch::Some) {
+        match = MatchIndex<T>(
+            segment, field_id, [&](index::ScalarIndex<T>* index) {
+                return index->CountRange(expr.lower_value_,
+                                         expr.lower_inclusive_,
+                                         expr.upper_value_,
+                                         expr.upper_inclusive_);
+            });
+    }
+    return match;
+}
+
+template <typename T>
+ZoneMatch
+MatchTerm(const TermExpr& expr_raw,
+          const segcore::SegmentInternalInterface& segment) {
+    auto& expr = static_cast<const TermExprImpl<T>&>(expr_raw);
+    auto& terms = expr.terms_;
+    auto field_id = expr.column_.field_id;
+    if (terms.empty()) {
+        return ZoneMatch::None;
+    }
+    auto match = ZoneMatch::Some;
+    if constexpr (IsZoneMapSupported<T>) {
+        match = MatchZones<T>(
+            segment, field_id, [&](const ZoneMapOf<T>& zone_map) {
+                auto any = ZoneMatch::None;
+                for (auto& term : terms) {
+                    any = Or(any,
+                             zone_map.MatchUnaryRange(
+                                 OpType::Equal, ZoneValueType<T>(term)));
+                    if (any == ZoneMatch::All) {
+                        break;
+                    }
+                }
+                return any;
+            });
+    }
+    // terms of bool are packed in std::vector<bool>
+    if constexpr (!std::is_same_v<T, bool>) {
+        if (match == ZoneMatch::Some) {
+            match = MatchIndex<T>(
+                segment, field_id, [&](index::ScalarIndex<T>* index) {
+                    return index->CountIn(terms.size(), terms.data());
+                });
+        }
+        if (match == ZoneMatch::Some) {
+            match = MatchKeys<T>(segment, field_id, terms.data(), terms.size());
+        }
+    }
+    return match;
+}
+
+template <template <typename> class Func, typename ExprType>
+ZoneMatch
+DispatchMatch(const ExprType& expr,
+              const segcore::SegmentInternalInterface& segment) {
+    if (!expr.column_.nested_path.empty()) {
+        return ZoneMatch::Some;
+    }
+    switch (expr.column_.data_type) {
+        case DataType::BOOL:
+            return Func<bool>::apply(expr, segment);
+        case DataType::INT8:
+            return Func<int8_t>::apply(expr, segment);
+        case DataType::INT16:
+            return Func<int16_t>::apply(expr, segment);
+        case DataType::INT32:
+            return Func<int32_t>::apply(expr, segment);
+        case DataType::INT64:
+            return Func<int64_t>::apply(expr, segment);
+        case DataType::FLOAT:
+            return Func<float>::apply(expr, segment);
+        case DataType::DOUBLE:
+            return Func<double>::apply(expr, segment);
+        case DataType::VARCHAR:
+            return Func<std::string>::apply(expr, segment);
+        default:
+            // json values are typed per expr, nothing is known about them
+            return ZoneMatch::Some;
+    }
+}
+
+template <typename T>
+struct UnaryRangeFunc {
+    static ZoneMatch
+    apply(const UnaryRangeExpr& expr,
+          const segcore::SegmentInternalInterface& segment) {
+        return MatchUnaryRange<T>(expr, segment);
+    }
+};
+
+template <typename T>
+struct BinaryRangeFunc {
+    static ZoneMatch
+    apply(const BinaryRangeExpr& expr,
+          const segcore::SegmentInternalInterface& segment) {
+        return MatchBinaryRange<T>(expr, segment);
+    }
+};
+
+template <typename T>
+struct TermFunc {
+    static ZoneMatch
+    apply(const TermExpr& expr,
+          const segcore::SegmentInternalInterface& segment) {
+        return MatchTerm<T>(expr, segment);
+    }
+};
+
+}  // namespace
+
+ZoneMatch
+MatchSegment(const Expr& expr,
+             const segcore::SegmentInternalInterface& segment) {
+    if (auto e = dynamic_cast<const LogicalUnaryExpr*>(&expr)) {
+        return Not(MatchSegment(*e->child_, segment));
+    }
+    if (auto e = dynamic_cast<const LogicalBinaryExpr*>(&expr)) {
+        using LogicalOp = LogicalBinaryExpr::OpType;
+        auto left = MatchSegment(*e->left_, segment);
+        // the right side needn't be looked at if the left one decides
+        switch (e->op_type_) {
+            case LogicalOp::LogicalAnd:
+                if (left == ZoneMatch::None) {
+                    return left;
+                }
+                return And(left, MatchSegment(*e->right_, segment));
+            case LogicalOp::LogicalOr:
+                if (left == ZoneMatch::All) {
+                    return left;
+                }
+                return Or(left, MatchSegment(*e->right_, segment));
+            case LogicalOp::LogicalMinus:
+                if (left == ZoneMatch::None) {
+                    return left;
+                }
+                return And(left, Not(MatchSegment(*e->right_, segment)));
+            case LogicalOp::LogicalXor:
+                return Xor(left, MatchSegment(*e->right_, segment));
+            default:
+                return ZoneMatch::Some;
+        }
+    }
+    if (auto e = dynamic_cast<const TermExpr*>(&expr)) {
+        return DispatchMatch<TermFunc>(*e, segment);
+    }
+    if (auto e = dynamic_cast<const UnaryRangeExpr*>(&expr)) {
+        return DispatchMatch<UnaryRangeFunc>(*e, segment);
+    }
+    if (auto e = dynamic_cast<const BinaryRangeExpr*>(&expr)) {
+        return DispatchMatch<BinaryRangeFunc>(*e, segment);
+    }
+    // arith, exists and compare exprs aren't decided from the statistics
+    return ZoneMatch::Some;
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,42 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "common/ZoneMap.h"
+#include "query/Expr.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::query {
+
+// How the rows of the segment may match an expr, decided from the
+// statistics the segment keeps without reading a row: the min/max of the
+// chunks of the fields, the counts of their scalar indexes, the keys of a
+// partition key field and the range and bloom filter of the pks. None and
+// All are proven, Some is anything which can't be decided.
+ZoneMatch
+MatchSegment(const Expr& expr,
+             const segcore::SegmentInternalInterface& segment);
+
+// false only if no row of the segment can match the filter
+inline bool
+CanMatch(const std::optional<ExprPtr>& predicate,
+         const segcore::SegmentInternalInterface& segment) {
+    return !predicate.has_value() || predicate.value() == nullptr ||
+           MatchSegment(*predicate.value(), segment) != ZoneMatch::None;
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,593 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "query/ExprCost.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include "common/FieldSketch.h"
+#include "common/ZoneMap.h"
+#include "index/ScalarIndex.h"
+#include "index/StringIndex.h"
+#include "query/ExprImpl.h"
+
+namespace milvus::query {
+
+namespace {
+
+// guesses for the fields which have no statistics
+constexpr double kEqualSelectivity = 0.1;
+constexpr double kRangeSelectivity = 1.0 / 3;
+constexpr double kDefaultSelectivity = 0.5;
+
+// error of the ranks of the quantile sketches
+constexpr double kSketchRankError = 2.0 / QuantileSketch::kK;
+
+// relative cost of scanning a column, per row
+double
+ColumnCost(const ColumnInfo& column) {
+    switch (column.data_type) {
+        case DataType::JSON:
+            // parses the document of every row
+            return 16;
+        case DataType::STRING:
+        case DataType::VARCHAR:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+double
+LeafCost(const ColumnInfo& column,
+         const segcore::SegmentInternalInterface& segment) {
+    if (column.data_type != DataType::JSON &&
+        segment.num_chunk_index(column.field_id) > 0) {
+        // looked up in the index, only the bitset is filled per row
+        return 0.5;
+    }
+    return ColumnCost(column);
+}
+
+double
+DefaultSelectivity(OpType op) {
+    switch (op) {
+        case OpType::Equal:
+        case OpType::PrefixMatch:
+        case OpType::PostfixMatch:
+            return kEqualSelectivity;
+        case OpType::NotEqual:
+            return 1 - kEqualSelectivity;
+        case OpType::GreaterThan:
+        case OpType::GreaterEqual:
+        case OpType::LessThan:
+        case OpType::LessEqual:
+            return kRangeSelectivity;
+        default:
+            return kDefaultSelectivity;
+    }
+}
+
+// fraction of the indexed rows counted by count_func, nullopt if the field
+// has no index or the index can't count them
+template <typename T, typename CountFunc>
+std::optional<double>
+IndexSelectivity(const segcore::SegmentInternalInterface& segment,
+                 FieldId field_id,
+                 CountFunc count_func) {
+    using Index = index::ScalarIndex<T>;
+    auto num_chunk = segment.num_chunk_index(field_id);
+    int64_t matched = 0;
+    int64_t total = 0;
+    for (auto chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+        const Index& indexing =
+            segment.chunk_scalar_index<T>(field_id, chunk_id);
+        // NOTE: knowhere is not const-ready
+        auto index = const_cast<Index*>(&indexing);
+        auto count = count_func(index);
+        if (count < 0) {
+            return std::nullopt;
+        }
+        matched += count;
+        total += index->Count();
+    }
+    if (total == 0) {
+        return std::nullopt;
+    }
+    return static_cast<double>(matched) / total;
+}
+
+// fraction of the rows matched, estimated by sketch_func from the sketch of
+// the raw data of the field, nullopt if it has none or sketch_func can't
+template <typename SketchFunc>
+std::optional<double>
+SketchSelectivity(const segcore::SegmentInternalInterface& segment,
+                  FieldId field_id,
+                  SketchFunc sketch_func) {
+    auto sketch = segment.field_sketch(field_id);
+    if (sketch == nullptr || sketch->row_count() == 0) {
+        return std::nullopt;
+    }
+    return sketch_func(*sketch);
+}
+
+// a value repeated over many rows stands out of the quantiles, any other
+// takes an even share of the rows; a share of the ranks below their error
+// is a value the sketch happened to keep
+template <typename ValueType>
+double
+SketchEqualFraction(const FieldSketch& sketch, const ValueType& value) {
+    auto fraction = 1.0 / sketch.distinct_count();
+    if constexpr (std::is_arithmetic_v<ValueType>) {
+        auto quantiles = sketch.quantiles();
+        if (quantiles != nullptr && quantiles->count() > 0) {
+            auto v = static_cast<double>(value);
+            if (v < quantiles->min() || v > quantiles->max()) {
+                return 0;
+            }
+            auto mass = quantiles->Rank(v, true) - quantiles->Rank(v, false);
+            if (mass > kSketchRankError) {
+                return std::max(fraction, mass);
+            }
+        }
+    }
+    return fraction;
+}
+
+// fraction of a numeric field below `value`, or at most it if inclusive,
+// nullopt for the strings
+template <typename ValueType>
+std::optional<double>
+SketchFractionBelow(const FieldSketch& sketch,
+                    const ValueType& value,
+                    bool inclusive) {
+    if constexpr (std::is_arithmetic_v<ValueType>) {
+        if (auto quantiles = sketch.quantiles()) {
+            return quantiles->Rank(static_cast<double>(value), inclusive);
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename ValueType>
+std::optional<double>
+UnarySketchFraction(const FieldSketch& sketch,
+                    OpType op,
+                    const ValueType& value) {
+    switch (op) {
+        case OpType::Equal:
+            return SketchEqualFraction(sketch, value);
+        case OpType::NotEqual:
+            return 1 - SketchEqualFraction(sketch, value);
+        case OpType::LessThan:
+            return SketchFractionBelow(sketch, value, false);
+        case OpType::LessEqual:
+            return SketchFractionBelow(sketch, value, true);
+        case OpType::GreaterThan:
+            if (auto below = SketchFractionBelow(sketch, value, true)) {
+                return 1 - below.value();
+            }
+            return std::nullopt;
+        case OpType::GreaterEqual:
+            if (auto below = SketchFractionBelow(sketch, value, false)) {
+                return 1 - below.value();
+            }
+            return std::nullopt;
+        default:
+            return std::nullopt;
+    }
+}
+
+// fraction of the rows matched, weighting the estimate of each chunk made by
+// zone_func from its min/max, nullopt if any chunk has no zone map
+template <typename T, typename ZoneFunc>
+std::optional<double>
+ZoneSelectivity(const segcore::SegmentInternalInterface& segment,
+                FieldId field_id,
+                int64_t row_count,
+                ZoneFunc zone_func) {
+    if constexpr (!IsZoneMapSupported<T>) {
+        return std::nullopt;
+    } else {
+        auto num_chunk = segment.num_chunk_data(field_id);
+        auto size_per_chunk = segment.size_per_chunk();
+        double matched = 0;
+        int64_t total = 0;
+        for (auto chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+            auto rows =
+                std::min(size_per_chunk, row_count - chunk_id * size_per_chunk);
+            if (rows <= 0) {
+                break;
+            }
+            auto zone_map = segment.chunk_zone_map<T>(field_id, chunk_id);
+            if (!zone_map.has_value()) {
+                return std::nullopt;
+            }
+            matched += rows * zone_func(zone_map.value());
+            total += rows;
+        }
+        if (total == 0) {
+            return std::nullopt;
+        }
+        return matched / total;
+    }
+}
+
+// fraction of [min, max] below `value`, assuming the values of the chunk are
+// uniformly distributed
+template <typename ValueType>
+double
+FractionBelow(const ZoneMap<ValueType>& zone_map, const ValueType& value) {
+    auto min = static_cast<double>(zone_map.min());
+    auto max = static_cast<double>(zone_map.max());
+    if (max <= min) {
+        return value < zone_map.min() ? 0 : 1;
+    }
+    auto fraction = (static_cast<double>(value) - min) / (max - min);
+    return std::clamp(fraction, 0.0, 1.0);
+}
+
+template <typename ValueType>
+double
+EqualFraction(const ZoneMap<ValueType>& zone_map) {
+    if constexpr (std::is_integral_v<ValueType>) {
+        auto width = static_cast<double>(zone_map.max()) -
+                     static_cast<double>(zone_map.min());
+        return 1 / (width + 1);
+    }
+    return kEqualSelectivity;
+}
+
+template <typename ValueType>
+double
+UnaryZoneFraction(const ZoneMap<ValueType>& zone_map,
+                  OpType op,
+                  const ValueType& value) {
+    switch (zone_map.MatchUnaryRange(op, value)) {
+        case ZoneMatch::None:
+            return 0;
+        case ZoneMatch::All:
+            return 1;
+        default:
+            break;
+    }
+    if constexpr (std::is_arithmetic_v<ValueType>) {
+        if (!zone_map.empty()) {
+            switch (op) {
+                case OpType::Equal:
+                    return EqualFraction(zone_map);
+                case OpType::NotEqual:
+                    return 1 - EqualFraction(zone_map);
+                case OpType::LessThan:
+                case OpType::LessEqual:
+                    return FractionBelow(zone_map, value);
+                case OpType::GreaterThan:
+                case OpType::GreaterEqual:
+                    return 1 - FractionBelow(zone_map, value);
+                default:
+                    break;
+            }
+        }
+    }
+    return DefaultSelectivity(op);
+}
+
+template <typename ValueType>
+double
+BinaryZoneFraction(const ZoneMap<ValueType>& zone_map,
+                   const ValueType& lower,
+                   bool lower_inclusive,
+                   const ValueType& upper,
+                   bool upper_inclusive) {
+    switch (zone_map.MatchBinaryRange(
+        lower, lower_inclusive, upper, upper_inclusive)) {
+        case ZoneMatch::None:
+            return 0;
+        case ZoneMatch::All:
+            return 1;
+        default:
+            break;
+    }
+    if constexpr (std::is_arithmetic_v<ValueType>) {
+        if (!zone_map.empty()) {
+            return std::max(FractionBelow(zone_map, upper) -
+                                FractionBelow(zone_map, lower),
+                            0.0);
+        }
+    }
+    return kRangeSelectivity;
+}
+
+template <typename T>
+double
+UnaryRangeSelectivity(const UnaryRangeExpr& expr_raw,
+                      const segcore::SegmentInternalInterface& segment,
+                      int64_t row_count) {
+    auto& expr = static_cast<const UnaryRangeExprImpl<T>&>(expr_raw);
+    auto op = expr.op_type_;
+    auto field_id = expr.column_.field_id;
+    auto index_func = [&](index::ScalarIndex<T>* index) -> int64_t {
+        switch (op) {
+            case OpType::Equal:
+                return index->CountIn(1, &expr.value_);
+            case OpType::NotEqual: {
+                auto count = index->CountIn(1, &expr.value_);
+                return count < 0 ? count : index->Count() - count;
+            }
+            case OpType::GreaterThan:
+            case OpType::GreaterEqual:
+            case OpType::LessThan:
+            case OpType::LessEqual:
+                return index->CountRange(expr.value_, op);
+            case OpType::PrefixMatch:
+                if constexpr (std::is_same_v<T, std::string>) {
+                    if (auto string_index =
+                            dynamic_cast<index::StringIndex*>(index)) {
+                        return string_index->CountPrefixMatch(expr.value_);
+                    }
+                }
+                return -1;
+            default:
+                return -1;
+        }
+    };
+    if (auto selectivity =
+            IndexSelectivity<T>(segment, field_id, index_func)) {
+        return selectivity.value();
+    }
+    auto sketch_func = [&](const FieldSketch& sketch) {
+        return UnarySketchFraction(sketch, op, expr.value_);
+    };
+    if (auto selectivity =
+            SketchSelectivity(segment, field_id, sketch_func)) {
+        return selectivity.value();
+    }
+    if constexpr (IsZoneMapSupported<T>) {
+        auto value = ZoneValueType<T>(expr.value_);
+        auto zone_func = [&](const ZoneMapOf<T>& zone_map) {
+            return UnaryZoneFraction(zone_map, op, value);
+        };
+        if (auto selectivity =
+                ZoneSelectivity<T>(segment, field_id, row_count, zone_func)) {
+            return selectivity.value();
+        }
+    }
+    return DefaultSelectivity(op);
+}
+
+template <typename T>
+double
+BinaryRangeSelectivity(const BinaryRangeExpr& expr_raw,
+                       const segcore::SegmentInternalInterface& segment,
+                       int64_t row_count) {
+    auto& expr = static_cast<const BinaryRangeExprImpl<T>&>(expr_raw);
+    auto field_id = expr.column_.field_id;
+    auto index_func = [&](index::ScalarIndex<T>* index) {
+        return index->CountRange(expr.lower_value_,
+                                 expr.lower_inclusive_,
+                                 expr.upper_value_,
+                                 expr.upper_inclusive_);
+    };
+    if (auto selectivity =
+            IndexSelectivity<T>(segment, field_id, index_func)) {
+        return selectivity.value();
+    }
+    auto sketch_func =
+        [&](const FieldSketch& sketch) -> std::optional<double> {
+        auto upper = SketchFractionBelow(
+            sketch, expr.upper_value_, expr.upper_inclusive_);
+        auto lower = SketchFractionBelow(
+            sketch, expr.lower_value_, !expr.lower_inclusive_);
+        if (!upper.has_value() || !lower.has_value()) {
+            return std::nullopt;
+        }
+        return std::max(upper.value() - lower.value(), 0.0);
+    };
+    if (auto selectivity =
+            SketchSelectivity(segment, field_id, sketch_func)) {
+        return selectivity.value();
+    }
+    if constexpr (IsZoneMapSupported<T>) {
+        auto lower = ZoneValueType<T>(expr.lower_value_);
+        auto upper = ZoneValueType<T>(expr.upper_value_);
+        auto zone_func = [&](const ZoneMapOf<T>& zone_map) {
+            return BinaryZoneFraction(zone_map,
+                                      lower,
+                                      expr.lower_inclusive_,
+                                      upper,
+                                      expr.upper_inclusive_);
+        };
+        if (auto selectivity =
+                ZoneSelectivity<T>(segment, field_id, row_count, zone_func)) {
+            return selectivity.value();
+        }
+    }
+    return kRangeSelectivity;
+}
+
+template <typename T>
+double
+TermSelectivity(const TermExpr& expr_raw,
+                const segcore::SegmentInternalInterface& segment,
+                int64_t row_count) {
+    auto& expr = static_cast<const TermExprImpl<T>&>(expr_raw);
+    auto& terms = expr.terms_;
+    // terms of bool are packed in std::vector<bool>
+    if constexpr (!std::is_same_v<T, bool>) {
+        auto index_func = [&](index::ScalarIndex<T>* index) {
+            return index->CountIn(terms.size(), terms.data());
+        };
+        if (auto selectivity = IndexSelectivity<T>(
+                segment, expr.column_.field_id, index_func)) {
+            return selectivity.value();
+        }
+    }
+    auto sketch_func = [&](const FieldSketch& sketch) {
+        double fraction = 0;
+        for (const auto& term : terms) {
+            fraction += SketchEqualFraction(sketch, T(term));
+        }
+        return std::optional<double>(std::min(fraction, 1.0));
+    };
+    if (auto selectivity = SketchSelectivity(
+            segment, expr.column_.field_id, sketch_func)) {
+        return selectivity.value();
+    }
+    if constexpr (IsZoneMapSupported<T>) {
+        auto zone_func = [&](const ZoneMapOf<T>& zone_map) {
+            double fraction = 0;
+            for (auto& term : terms) {
+                fraction += UnaryZoneFraction(
+                    zone_map, OpType::Equal, ZoneValueType<T>(term));
+            }
+            return std::min(fraction, 1.0);
+        };
+        if (auto selectivity = ZoneSelectivity<T>(
+                segment, expr.column_.field_id, row_count, zone_func)) {
+            return selectivity.value();
+        }
+    }
+    return std::min(terms.size() * kEqualSelectivity, 1.0);
+}
+
+template <template <typename> class Func, typename ExprType>
+double
+DispatchSelectivity(const ExprType& expr,
+                    const segcore::SegmentInternalInterface& segment,
+                    int64_t row_count,
+                    double default_selectivity) {
+    switch (expr.column_.data_type) {
+        case DataType::BOOL:
+            return Func<bool>::apply(expr, segment, row_count);
+        case DataType::INT8:
+            return Func<int8_t>::apply(expr, segment, row_count);
+        case DataType::INT16:
+            return Func<int16_t>::apply(expr, segment, row_count);
+        case DataType::INT32:
+            return Func<int32_t>::apply(expr, segment, row_count);
+        case DataType::INT64:
+            return Func<int64_t>::apply(expr, segment, row_count);
+        case DataType::FLOAT:
+            return Func<float>::apply(expr, segment, row_count);
+        case DataType::DOUBLE:
+            return Func<double>::apply(expr, segment, row_count);
+        case DataType::VARCHAR:
+            return Func<std::string>::apply(expr, segment, row_count);
+        default:
+            // json values are typed per expr, nothing is known about them
+            return default_selectivity;
+    }
+}
+
+template <typename T>
+struct UnaryRangeFunc {
+    static double
+    apply(const UnaryRangeExpr& expr,
+          const segcore::SegmentInternalInterface& segment,
+          int64_t row_count) {
+        return UnaryRangeSelectivity<T>(expr, segment, row_count);
+    }
+};
+
+template <typename T>
+struct BinaryRangeFunc {
+    static double
+    apply(const BinaryRangeExpr& expr,
+          const segcore::SegmentInternalInterface& segment,
+          int64_t row_count) {
+        return BinaryRangeSelectivity<T>(expr, segment, row_count);
+    }
+};
+
+template <typename T>
+struct TermFunc {
+    static double
+    apply(const TermExpr& expr,
+          const segcore::SegmentInternalInterface& segment,
+          int64_t row_count) {
+        return TermSelectivity<T>(expr, segment, row_count);
+    }
+};
+
+ExprCost
+ComposeCost(LogicalBinaryExpr::OpType op,
+            const ExprCost& left,
+            const ExprCost& right) {
+    using LogicalOp = LogicalBinaryExpr::OpType;
+    auto sl = left.selectivity;
+    auto sr = right.selectivity;
+    switch (op) {
+        case LogicalOp::LogicalAnd:
+            // the visitor evaluates the cheaper order
+            return {std::min(PipelineCost(op, left, right),
+                             PipelineCost(op, right, left)),
+                    sl * sr};
+        case LogicalOp::LogicalOr:
+            return {std::min(PipelineCost(op, left, right),
+                             PipelineCost(op, right, left)),
+                    sl + sr - sl * sr};
+        case LogicalOp::LogicalMinus:
+            return {PipelineCost(op, left, right), sl * (1 - sr)};
+        default:
+            return {PipelineCost(op, left, right), sl + sr - 2 * sl * sr};
+    }
+}
+
+}  // namespace
+
+ExprCost
+EstimateExprCost(const Expr& expr,
+                 const segcore::SegmentInternalInterface& segment,
+                 int64_t row_count) {
+    if (auto e = dynamic_cast<const LogicalUnaryExpr*>(&expr)) {
+        auto child = EstimateExprCost(*e->child_, segment, row_count);
+        return {child.cost, 1 - child.selectivity};
+    }
+    if (auto e = dynamic_cast<const LogicalBinaryExpr*>(&expr)) {
+        return ComposeCost(e->op_type_,
+                           EstimateExprCost(*e->left_, segment, row_count),
+                           EstimateExprCost(*e->right_, segment, row_count));
+    }
+    if (auto e = dynamic_cast<const TermExpr*>(&expr)) {
+        return {LeafCost(e->column_, segment),
+                DispatchSelectivity<TermFunc>(
+                    *e, segment, row_count, kEqualSelectivity)};
+    }
+    if (auto e = dynamic_cast<const UnaryRangeExpr*>(&expr)) {
+        return {LeafCost(e->column_, segment),
+                DispatchSelectivity<UnaryRangeFunc>(
+                    *e, segment, row_count, DefaultSelectivity(e->op_type_))};
+    }
+    if (auto e = dynamic_cast<const BinaryRangeExpr*>(&expr)) {
+        return {LeafCost(e->column_, segment),
+                DispatchSelectivity<BinaryRangeFunc>(
+                    *e, segment, row_count, kRangeSelectivity)};
+    }
+    if (auto e = dynamic_cast<const BinaryArithOpEvalRangeExpr*>(&expr)) {
+        return {2 * ColumnCost(e->column_), DefaultSelectivity(e->op_type_)};
+    }
+    if (auto e = dynamic_cast<const ExistsExpr*>(&expr)) {
+        return {ColumnCost(e->column_), kDefaultSelectivity};
+    }
+    // compare expr reads two columns through boost::variant
+    return {4, kDefaultSelectivity};
+}
+
+}  // namespace milvus::query
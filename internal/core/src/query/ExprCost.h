@@ -0,0 +1,60 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "query/Expr.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::query {
+
+// estimated cost of evaluating an expr, per row, and the fraction of the
+// rows it matches
+struct ExprCost {
+    double cost;
+    double selectivity;
+};
+
+// estimates an expr from the statistics of the segment: counts of its scalar
+// indexes, then the sketches of its raw data, then min/max of its chunks,
+// then fixed guesses per operator
+ExprCost
+EstimateExprCost(const Expr& expr,
+                 const segcore::SegmentInternalInterface& segment,
+                 int64_t row_count);
+
+// cost of evaluating `first` on all rows and `second` only on the rows whose
+// result it can still change
+inline double
+PipelineCost(LogicalBinaryExpr::OpType op,
+             const ExprCost& first,
+             const ExprCost& second) {
+    using OpType = LogicalBinaryExpr::OpType;
+    switch (op) {
+        case OpType::LogicalAnd:
+        case OpType::LogicalMinus:
+            return first.cost + first.selectivity * second.cost;
+        case OpType::LogicalOr:
+            return first.cost + (1 - first.selectivity) * second.cost;
+        default:
+            return first.cost + second.cost;
+    }
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,122 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "boost_ext/dynamic_bitset_ext.hpp"
+#include "common/BitsetView.h"
+#include "index/ScalarIndex.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::query {
+
+// The values of one chunk of a scalar field, read from its raw data if the
+// segment keeps it and from its scalar index otherwise. A VARCHAR field is
+// read with T = std::string, the strings of raw data come as views.
+template <typename T>
+class ChunkValues {
+ public:
+    ChunkValues(const segcore::SegmentInternalInterface& segment,
+                FieldId field_id,
+                int64_t chunk_id) {
+        if (chunk_id < segment.num_chunk_data(field_id)) {
+            if constexpr (!std::is_same_v<T, std::string>) {
+                data_ = segment.chunk_data<T>(field_id, chunk_id).data();
+            } else {
+                views_ =
+                    segment.chunk_data<std::string_view>(field_id, chunk_id)
+                        .data();
+            }
+        } else {
+            AssertInfo(chunk_id < segment.num_chunk_index(field_id),
+                       "chunk has neither raw data nor index");
+            index_ = &segment.chunk_scalar_index<T>(field_id, chunk_id);
+        }
+    }
+
+    // calls visit(value) with the value of the row
+    template <typename Visit>
+    void
+    visit(int64_t offset_in_chunk, Visit&& visit) const {
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (views_ != nullptr) {
+                visit(views_[offset_in_chunk]);
+                return;
+            }
+        } else {
+            if (data_ != nullptr) {
+                visit(data_[offset_in_chunk]);
+                return;
+            }
+        }
+        visit(index_->Reverse_Lookup(offset_in_chunk));
+    }
+
+ private:
+    const T* data_ = nullptr;
+    const std::string_view* views_ = nullptr;
+    const index::ScalarIndex<T>* index_ = nullptr;
+};
+
+// calls visit(offset, value) for every row of the first excluded.size()
+// which isn't set in `excluded`, ascending: chunk by chunk when nothing is
+// excluded, by the offsets of the unset bits otherwise
+template <typename T, typename Visit>
+void
+ForEachIncludedValue(const segcore::SegmentInternalInterface& segment,
+                     FieldId field_id,
+                     const BitsetType& excluded,
+                     Visit&& visit) {
+    auto row_count = int64_t(excluded.size());
+    auto size_per_chunk = segment.size_per_chunk();
+    if (excluded.none()) {
+        for (int64_t beg = 0; beg < row_count; beg += size_per_chunk) {
+            ChunkValues<T> values(segment, field_id, beg / size_per_chunk);
+            auto size = std::min(size_per_chunk, row_count - beg);
+            for (int64_t i = 0; i < size; ++i) {
+                values.visit(
+                    i, [&](const auto& value) { visit(beg + i, value); });
+            }
+        }
+        return;
+    }
+    int64_t chunk_id = -1;
+    std::optional<ChunkValues<T>> values;
+    ForEachBitBatch<false>(
+        reinterpret_cast<const uint8_t*>(boost_ext::get_data(excluded)),
+        row_count,
+        [&](const int64_t* offsets, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                auto offset = offsets[i];
+                if (offset / size_per_chunk != chunk_id) {
+                    chunk_id = offset / size_per_chunk;
+                    values.emplace(segment, field_id, chunk_id);
+                }
+                values->visit(offset - chunk_id * size_per_chunk,
+                              [&](const auto& value) { visit(offset, value); });
+            }
+        });
+}
+
+}  // namespace milvus::query
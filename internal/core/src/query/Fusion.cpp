@@ -0,0 +1,101 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "query/Fusion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include "common/Consts.h"
+#include "common/Utils.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::query {
+
+float
+NormalizeDistance(float distance, const MetricType& metric_type) {
+    if (IsMetricType(metric_type, knowhere::metric::COSINE)) {
+        return (1 + distance) / 2;
+    }
+    if (PositivelyRelated(metric_type)) {
+        return 0.5 + std::atan(distance) / M_PI;
+    }
+    return 1 - 2 * std::atan(distance) / M_PI;
+}
+
+SearchResult
+FuseSearchResults(const std::vector<SearchResult>& results,
+                  const std::vector<MetricType>& metric_types,
+                  const FusionInfo& fusion) {
+    AssertInfo(!results.empty(), "no search result to fuse");
+    AssertInfo(metric_types.size() == results.size(),
+               "a metric type for every search result is expected");
+    AssertInfo(fusion.weights_.empty() ||
+                   fusion.weights_.size() == results.size(),
+               "a weight for every search result is expected");
+    auto nq = results[0].total_nq_;
+    for (auto& result : results) {
+        AssertInfo(result.total_nq_ == nq,
+                   "the fused searches must have the same queries");
+    }
+    auto topk = fusion.topk_ > 0 ? fusion.topk_ : results[0].unity_topK_;
+
+    SearchResult fused;
+    fused.total_nq_ = nq;
+    fused.unity_topK_ = topk;
+    fused.segment_ = results[0].segment_;
+    fused.seg_offsets_.assign(nq * topk, INVALID_SEG_OFFSET);
+    fused.distances_.assign(nq * topk, std::numeric_limits<float>::lowest());
+
+    std::unordered_map<int64_t, float> scores;
+    std::vector<std::pair<float, int64_t>> ranked;
+    for (int64_t q = 0; q < nq; ++q) {
+        scores.clear();
+        for (size_t i = 0; i < results.size(); ++i) {
+            auto& result = results[i];
+            auto weight = fusion.weights_.empty() ? 1.0f : fusion.weights_[i];
+            auto k = result.unity_topK_;
+            for (int64_t rank = 0; rank < k; ++rank) {
+                auto offset = result.seg_offsets_[q * k + rank];
+                if (offset == INVALID_SEG_OFFSET) {
+                    break;
+                }
+                auto score =
+                    fusion.type_ == FusionType::RRF
+                        ? 1.0f / (fusion.rrf_k_ + rank + 1)
+                        : NormalizeDistance(result.distances_[q * k + rank],
+                                            metric_types[i]);
+                scores[offset] += weight * score;
+            }
+        }
+        ranked.clear();
+        for (auto& [offset, score] : scores) {
+            ranked.emplace_back(-score, offset);
+        }
+        auto n = std::min<int64_t>(topk, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end());
+        for (int64_t j = 0; j < n; ++j) {
+            fused.seg_offsets_[q * topk + j] = ranked[j].second;
+            fused.distances_[q * topk + j] = -ranked[j].first;
+        }
+    }
+    return fused;
+}
+
+}  // namespace milvus::query
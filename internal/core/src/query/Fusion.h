@@ -0,0 +1,58 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/QueryResult.h"
+#include "common/Types.h"
+
+namespace milvus::query {
+
+enum class FusionType {
+    // sum over the fields of weight / (rrf_k + rank), the rank from 1
+    RRF = 0,
+    // sum over the fields of weight * the distance normalized into [0, 1],
+    // higher for closer rows whatever the metric
+    Weighted = 1,
+};
+
+struct FusionInfo {
+    FusionType type_ = FusionType::RRF;
+    int64_t rrf_k_ = 60;
+    // one per field, every field weighs 1 if empty
+    std::vector<float> weights_;
+    // rows of each query fused, the topk of the first search if not
+    // positive
+    int64_t topk_ = 0;
+};
+
+// the distance of `metric_type` mapped into [0, 1], higher for closer rows
+float
+NormalizeDistance(float distance, const MetricType& metric_type);
+
+// The topk rows of each query by their fused score over `results`, the
+// searches of the same queries on the vector fields of a segment with the
+// metrics `metric_types`. The distances of the result are the scores, so
+// higher is better, and rows of equal scores come by offset.
+SearchResult
+FuseSearchResults(const std::vector<SearchResult>& results,
+                  const std::vector<MetricType>& metric_types,
+                  const FusionInfo& fusion);
+
+}  // namespace milvus::query
@@ -0,0 +1,142 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "query/OrderBy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "index/ScalarIndex.h"
+#include "query/FieldValues.h"
+
+namespace milvus::query {
+
+namespace {
+
+template <typename T>
+std::vector<int64_t>
+OrderedOffsetsOf(const segcore::SegmentInternalInterface& segment,
+                 const OrderBy& order_by,
+                 int64_t limit,
+                 const BitsetType& excluded) {
+    std::vector<int64_t> offsets;
+    auto field_id = order_by.field_id_;
+    auto descending = order_by.descending_;
+    if (int64_t(excluded.size()) <= segment.size_per_chunk() &&
+        segment.num_chunk_index(field_id) > 0) {
+        auto& index = segment.chunk_scalar_index<T>(field_id, 0);
+        if (index.OrderedOffsets(excluded, descending, limit, offsets)) {
+            return offsets;
+        }
+    }
+
+    // strings are compared as views and kept as copies
+    constexpr bool is_string = std::is_same_v<T, std::string>;
+    using View = std::conditional_t<is_string, std::string_view, T>;
+    using Entry = std::pair<T, int64_t>;
+    auto before = [descending](
+                      View a, int64_t a_offset, View b, int64_t b_offset) {
+        if (a != b) {
+            return descending ? b < a : a < b;
+        }
+        return a_offset < b_offset;
+    };
+    // the top of the heap is the last row kept
+    auto heap_less = [&](const Entry& a, const Entry& b) {
+        return before(a.first, a.second, b.first, b.second);
+    };
+    std::vector<Entry> heap;
+    heap.reserve(std::min<int64_t>(limit, excluded.size()));
+    ForEachIncludedValue<T>(
+        segment, field_id, excluded, [&](int64_t offset, const auto& value) {
+            View view(value);
+            if constexpr (std::is_floating_point_v<T>) {
+                if (std::isnan(view)) {
+                    return;
+                }
+            }
+            if (int64_t(heap.size()) < limit) {
+                heap.emplace_back(T(view), offset);
+                std::push_heap(heap.begin(), heap.end(), heap_less);
+                return;
+            }
+            // the offsets come ascending, a later row of an equal value
+            // never replaces a kept one
+            auto& last = heap.front();
+            if (!before(view, offset, last.first, last.second)) {
+                return;
+            }
+            std::pop_heap(heap.begin(), heap.end(), heap_less);
+            heap.back() = Entry(T(view), offset);
+            std::push_heap(heap.begin(), heap.end(), heap_less);
+        });
+    std::sort_heap(heap.begin(), heap.end(), heap_less);
+    offsets.reserve(heap.size());
+    for (auto& entry : heap) {
+        offsets.push_back(entry.second);
+    }
+    return offsets;
+}
+
+}  // namespace
+
+bool
+IsOrderable(DataType data_type) {
+    return datatype_is_integer(data_type) ||
+           datatype_is_floating(data_type) || data_type == DataType::VARCHAR;
+}
+
+std::vector<int64_t>
+OrderedOffsets(const segcore::SegmentInternalInterface& segment,
+               const OrderBy& order_by,
+               int64_t limit,
+               const BitsetType& excluded) {
+    if (limit <= 0) {
+        return {};
+    }
+    auto data_type = segment.get_schema()[order_by.field_id_].get_data_type();
+    switch (data_type) {
+        case DataType::INT8:
+            return OrderedOffsetsOf<int8_t>(segment, order_by, limit, excluded);
+        case DataType::INT16:
+            return OrderedOffsetsOf<int16_t>(
+                segment, order_by, limit, excluded);
+        case DataType::INT32:
+            return OrderedOffsetsOf<int32_t>(
+                segment, order_by, limit, excluded);
+        case DataType::INT64:
+            return OrderedOffsetsOf<int64_t>(
+                segment, order_by, limit, excluded);
+        case DataType::FLOAT:
+            return OrderedOffsetsOf<float>(segment, order_by, limit, excluded);
+        case DataType::DOUBLE:
+            return OrderedOffsetsOf<double>(
+                segment, order_by, limit, excluded);
+        case DataType::VARCHAR:
+            return OrderedOffsetsOf<std::string>(
+                segment, order_by, limit, excluded);
+        default:
+            PanicInfo(fmt::format("can't order by a field of type {}",
+                                  datatype_name(data_type)));
+    }
+}
+
+}  // namespace milvus::query
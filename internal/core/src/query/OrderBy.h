@@ -0,0 +1,45 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/Types.h"
+#include "query/PlanNode.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::query {
+
+// whether a field of `data_type` can order a retrieve, the numeric and the
+// VARCHAR ones can
+bool
+IsOrderable(DataType data_type);
+
+// The first `limit` rows in the order of `order_by` of the first
+// excluded.size() rows of `segment` which aren't set in `excluded`, rows of
+// equal values by offset and the rows of NaN left out. A ScalarIndexSort
+// over all the rows is walked in its order until enough rows are found,
+// otherwise the rows go through a heap which keeps the first `limit`.
+std::vector<int64_t>
+OrderedOffsets(const segcore::SegmentInternalInterface& segment,
+               const OrderBy& order_by,
+               int64_t limit,
+               const BitsetType& excluded);
+
+}  // namespace milvus::query
@@ -206,6 +206,11 @@ Parser::ParseVecNode(const Json& out_body) {
     vec_node->search_info_.search_params_ = vec_info.at("params");
     vec_node->search_info_.field_id_ = field_id;
     vec_node->search_info_.round_decimal_ = vec_info.at("round_decimal");
+    auto& search_info = vec_node->search_info_;
+    search_info.parsed_params_ =
+        ParseSearchParams(search_info.search_params_,
+                          search_info.topk_,
+                          search_info.metric_type_);
     vec_node->placeholder_tag_ = vec_info.at("query");
     auto tag = vec_node->placeholder_tag_;
     AssertInfo(!tag2field_.count(tag), "duplicated placeholder tag");
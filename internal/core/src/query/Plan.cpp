@@ -14,6 +14,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <limits>
+
 #include "Parser.h"
 #include "Plan.h"
 #include "PlanProto.h"
@@ -31,35 +36,81 @@ ParsePlaceholderGroup(const Plan* plan,
         placeholder_group_blob.size());
 }
 
+namespace {
+using WireFormatLite = google::protobuf::internal::WireFormatLite;
+
+// calls `on_field(field_number, data, size)` for the length delimited
+// fields of the serialized message in [data, data + size), skipping the
+// others, so the bytes of a field are read in place
+template <typename FieldFunc>
+void
+ForEachDelimitedField(const uint8_t* data, int64_t size, FieldFunc on_field) {
+    AssertInfo(size <= std::numeric_limits<int>::max(),
+               "placeholder group is too large");
+    google::protobuf::io::CodedInputStream input(data, int(size));
+    while (auto tag = input.ReadTag()) {
+        if (WireFormatLite::GetTagWireType(tag) !=
+            WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+            AssertInfo(WireFormatLite::SkipField(&input, tag),
+                       "invalid placeholder group");
+            continue;
+        }
+        uint32_t length;
+        AssertInfo(input.ReadVarint32(&length) &&
+                       input.CurrentPosition() + int64_t(length) <= size,
+                   "invalid placeholder group");
+        on_field(WireFormatLite::GetTagFieldNumber(tag),
+                 data + input.CurrentPosition(),
+                 length);
+        input.Skip(int(length));
+    }
+    AssertInfo(input.ConsumedEntireMessage(), "invalid placeholder group");
+}
+}  // namespace
+
+// The group is decoded from the wire format in place: parsing it into the
+// protobuf message would copy every query vector into a string before it's
+// copied into the aligned blob of its placeholder.
 std::unique_ptr<PlaceholderGroup>
 ParsePlaceholderGroup(const Plan* plan,
                       const uint8_t* blob,
                       const int64_t blob_len) {
     namespace set = milvus::proto::common;
     auto result = std::make_unique<PlaceholderGroup>();
-    set::PlaceholderGroup ph_group;
-    auto ok = ph_group.ParseFromArray(blob, blob_len);
-    Assert(ok);
-    for (auto& info : ph_group.placeholders()) {
+    ForEachDelimitedField(blob, blob_len, [&](int field, auto data, auto size) {
+        if (field != set::PlaceholderGroup::kPlaceholdersFieldNumber) {
+            return;
+        }
         Placeholder element;
-        element.tag_ = info.tag();
+        element.num_of_queries_ = 0;
+        element.line_sizeof_ = 0;
+        ForEachDelimitedField(data, size, [&](int field, auto line, auto len) {
+            if (field == set::PlaceholderValue::kTagFieldNumber) {
+                element.tag_.assign(reinterpret_cast<const char*>(line), len);
+            } else if (field == set::PlaceholderValue::kValuesFieldNumber) {
+                if (element.num_of_queries_ == 0) {
+                    element.line_sizeof_ = len;
+                }
+                Assert(element.line_sizeof_ == len);
+                ++element.num_of_queries_;
+            }
+        });
         Assert(plan->tag2field_.count(element.tag_));
         auto field_id = plan->tag2field_.at(element.tag_);
         auto& field_meta = plan->schema_[field_id];
-        element.num_of_queries_ = info.values_size();
         AssertInfo(element.num_of_queries_, "must have queries");
         Assert(element.num_of_queries_ > 0);
-        element.line_sizeof_ = info.values().Get(0).size();
         AssertInfo(field_meta.get_sizeof() == element.line_sizeof_,
                    "vector dimension mismatch");
         auto& target = element.blob_;
         target.reserve(element.line_sizeof_ * element.num_of_queries_);
-        for (auto& line : info.values()) {
-            Assert(element.line_sizeof_ == line.size());
-            target.insert(target.end(), line.begin(), line.end());
-        }
+        ForEachDelimitedField(data, size, [&](int field, auto line, auto len) {
+            if (field == set::PlaceholderValue::kValuesFieldNumber) {
+                target.insert(target.end(), line, line + len);
+            }
+        });
         result->emplace_back(std::move(element));
-    }
+    });
     return result;
 }
 
@@ -78,7 +129,10 @@ CreateSearchPlanByExpr(const Schema& schema,
     // Note: serialized_expr_plan is of binary format
     proto::plan::PlanNode plan_node;
     plan_node.ParseFromArray(serialized_expr_plan, size);
-    return ProtoParser(schema).CreatePlan(plan_node);
+    auto plan = ProtoParser(schema).CreatePlan(plan_node);
+    plan->serialized_plan_.assign(
+        static_cast<const char*>(serialized_expr_plan), size);
+    return plan;
 }
 
 std::unique_ptr<RetrievePlan>
@@ -87,7 +141,10 @@ CreateRetrievePlanByExpr(const Schema& schema,
                          const int64_t size) {
     proto::plan::PlanNode plan_node;
     plan_node.ParseFromArray(serialized_expr_plan, size);
-    return ProtoParser(schema).CreateRetrievePlan(plan_node);
+    auto plan = ProtoParser(schema).CreateRetrievePlan(plan_node);
+    plan->serialized_plan_.assign(
+        static_cast<const char*>(serialized_expr_plan), size);
+    return plan;
 }
 
 int64_t
@@ -53,6 +53,8 @@ struct Plan {
     std::unique_ptr<VectorPlanNode> plan_node_;
     std::map<std::string, FieldId> tag2field_;  // PlaceholderName -> FieldId
     std::vector<FieldId> target_entries_;
+    // the serialized plan it's created from, empty if it isn't known
+    std::string serialized_plan_;
     void
     check_identical(Plan& other);
 
@@ -89,6 +91,8 @@ struct RetrievePlan {
     const Schema& schema_;
     std::unique_ptr<RetrievePlanNode> plan_node_;
     std::vector<FieldId> field_ids_;
+    // the serialized plan it's created from, empty if it isn't known
+    std::string serialized_plan_;
 };
 
 using PlanPtr = std::unique_ptr<Plan>;
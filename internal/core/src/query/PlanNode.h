@@ -36,6 +36,9 @@ using PlanNodePtr = std::unique_ptr<PlanNode>;
 
 struct VectorPlanNode : PlanNode {
     std::optional<ExprPtr> predicate_;
+    // the serialized predicate, identifies its result in the expr result
+    // cache of sealed segments, empty if it isn't known
+    std::string predicate_key_;
     SearchInfo search_info_;
     std::string placeholder_tag_;
 };
@@ -52,13 +55,42 @@ struct BinaryVectorANNS : VectorPlanNode {
     accept(PlanNodeVisitor&) override;
 };
 
+enum class AggregateOp {
+    Count,
+    Min,
+    Max,
+    Sum,
+};
+
+// an aggregate over the retrieved rows, the field is unused by Count
+struct Aggregate {
+    AggregateOp op_;
+    FieldId field_id_;
+};
+
+// the rows are retrieved in the order of a scalar field
+struct OrderBy {
+    FieldId field_id_;
+    bool descending_ = false;
+};
+
 struct RetrievePlanNode : PlanNode {
  public:
     void
     accept(PlanNodeVisitor&) override;
 
     std::optional<ExprPtr> predicate_;
+    // see VectorPlanNode::predicate_key_
+    std::string predicate_key_;
     bool is_count;
+    // at most this many rows are retrieved, no limit unless it's positive
+    int64_t limit_ = -1;
+    // each is computed over the rows and returned as a column of one value
+    // instead of the rows, unless there is none
+    std::vector<Aggregate> aggregates_;
+    // the first limit_ rows in this order are retrieved, all of them if
+    // there is no limit
+    std::optional<OrderBy> order_by_;
 };
 
 }  // namespace milvus::query
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "ExprImpl.h"
+#include "common/Consts.h"
 #include "common/VectorTrait.h"
 #include "exceptions/EasyAssert.h"
 #include "generated/ExtractInfoExprVisitor.h"
@@ -154,6 +155,70 @@ ExtractBinaryArithOpEvalRangeExprImpl(
         getValue(expr_proto.value()));
 }
 
+void
+ProtoParser::ParseGroupBy(SearchInfo& search_info) {
+    auto& search_params = search_info.search_params_;
+    if (!search_params.contains(GROUP_BY_FIELD)) {
+        return;
+    }
+    auto field_id = FieldId(search_params[GROUP_BY_FIELD].get<int64_t>());
+    auto& field_meta = schema[field_id];
+    AssertInfo(IsGroupByDataType(field_meta.get_data_type()),
+               "unsupported group by field data type: " +
+                   datatype_name(field_meta.get_data_type()));
+    search_info.group_by_field_id_ = field_id;
+    if (search_params.contains(GROUP_SIZE)) {
+        search_info.group_size_ = search_params[GROUP_SIZE].get<int64_t>();
+    }
+    AssertInfo(search_info.group_size_ > 0,
+               "group size must be greater than 0, group size = " +
+                   std::to_string(search_info.group_size_));
+    search_params.erase(GROUP_BY_FIELD);
+    search_params.erase(GROUP_SIZE);
+}
+
+void
+ProtoParser::ParseRefine(SearchInfo& search_info) {
+    auto& search_params = search_info.search_params_;
+    if (!search_params.contains(REFINE_FACTOR)) {
+        return;
+    }
+    auto& value = search_params[REFINE_FACTOR];
+    AssertInfo(value.is_number_integer(),
+               "refine factor must be an integer, got " + value.dump());
+    search_info.refine_factor_ = value.get<int64_t>();
+    AssertInfo(search_info.refine_factor_ > 0,
+               "refine factor must be greater than 0, refine factor = " +
+                   std::to_string(search_info.refine_factor_));
+    search_params.erase(REFINE_FACTOR);
+}
+
+void
+ProtoParser::ParseAdaptive(SearchInfo& search_info) {
+    auto& search_params = search_info.search_params_;
+    if (!search_params.contains(ADAPTIVE_RECALL)) {
+        AssertInfo(!search_params.contains(LATENCY_BUDGET_MS),
+                   std::string(LATENCY_BUDGET_MS) + " needs " +
+                       ADAPTIVE_RECALL);
+        return;
+    }
+    auto& recall = search_params[ADAPTIVE_RECALL];
+    AssertInfo(recall.is_string(),
+               "recall tier must be a string, got " + recall.dump());
+    AdaptiveSearchTarget target;
+    target.recall_tier_ = ParseRecallTier(recall.get<std::string>());
+    if (search_params.contains(LATENCY_BUDGET_MS)) {
+        auto& budget = search_params[LATENCY_BUDGET_MS];
+        AssertInfo(budget.is_number() && budget.get<double>() > 0,
+                   "latency budget must be a positive number, got " +
+                       budget.dump());
+        target.latency_budget_ms_ = budget.get<double>();
+    }
+    search_params.erase(ADAPTIVE_RECALL);
+    search_params.erase(LATENCY_BUDGET_MS);
+    search_info.adaptive_ = target;
+}
+
 std::unique_ptr<VectorPlanNode>
 ProtoParser::PlanNodeFromProto(const planpb::PlanNode& plan_node_proto) {
     // TODO: add more buffs
@@ -177,6 +242,23 @@ ProtoParser::PlanNodeFromProto(const planpb::PlanNode& plan_node_proto) {
     search_info.topk_ = query_info_proto.topk();
     search_info.round_decimal_ = query_info_proto.round_decimal();
     search_info.search_params_ = json::parse(query_info_proto.search_params());
+    ParseGroupBy(search_info);
+    if (search_info.search_params_.contains(PROFILE)) {
+        search_info.profile_ = search_info.search_params_[PROFILE].get<bool>();
+        search_info.search_params_.erase(PROFILE);
+    }
+    ParseRefine(search_info);
+    ParseAdaptive(search_info);
+    // validated here once rather than by the search of every segment
+    search_info.parsed_params_ = ParseSearchParams(search_info.search_params_,
+                                                   search_info.topk_,
+                                                   search_info.metric_type_);
+    if (search_info.refine_factor_ > 1) {
+        search_info.refine_params_ = ParseSearchParams(
+            search_info.search_params_,
+            search_info.topk_ * search_info.refine_factor_,
+            search_info.metric_type_);
+    }
 
     auto plan_node = [&]() -> std::unique_ptr<VectorPlanNode> {
         if (anns_proto.is_binary()) {
@@ -187,6 +269,9 @@ ProtoParser::PlanNodeFromProto(const planpb::PlanNode& plan_node_proto) {
     }();
     plan_node->placeholder_tag_ = anns_proto.placeholder_tag();
     plan_node->predicate_ = std::move(expr_opt);
+    if (anns_proto.has_predicates()) {
+        plan_node->predicate_key_ = anns_proto.predicates().SerializeAsString();
+    }
     plan_node->search_info_ = std::move(search_info);
     return plan_node;
 }
@@ -205,6 +290,7 @@ ProtoParser::RetrievePlanNodeFromProto(
                 return ParseExpr(predicate_proto);
             }();
             node->predicate_ = std::move(expr_opt);
+            node->predicate_key_ = predicate_proto.SerializeAsString();
         } else {
             auto& query = plan_node_proto.query();
             if (query.has_predicates()) {
@@ -213,6 +299,7 @@ ProtoParser::RetrievePlanNodeFromProto(
                     return ParseExpr(predicate_proto);
                 }();
                 node->predicate_ = std::move(expr_opt);
+                node->predicate_key_ = predicate_proto.SerializeAsString();
             }
             node->is_count = query.is_count();
         }
@@ -57,6 +57,18 @@ class ProtoParser {
     ExprPtr
     ParseExpr(const proto::plan::Expr& expr_pb);
 
+    // move the group by options out of the search params, the index never sees them
+    void
+    ParseGroupBy(SearchInfo& search_info);
+
+    // move the refine factor out of the search params
+    void
+    ParseRefine(SearchInfo& search_info);
+
+    // move the recall tier and the latency budget out of the search params
+    void
+    ParseAdaptive(SearchInfo& search_info);
+
     std::unique_ptr<VectorPlanNode>
     PlanNodeFromProto(const proto::plan::PlanNode& plan_node_proto);
 
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "common/Cancellation.h"
 #include "common/Consts.h"
 #include "common/RangeSearchHelper.h"
 #include "common/Utils.h"
@@ -39,8 +40,9 @@ SubSearchResult
 BruteForceSearch(const dataset::SearchDataset& dataset,
                  const void* chunk_data_raw,
                  int64_t chunk_rows,
-                 const knowhere::Json& conf,
+                 const SearchParams& params,
                  const BitsetView& bitset) {
+    CheckCancelled();
     SubSearchResult sub_result(dataset.num_queries,
                                dataset.topk,
                                dataset.metric_type,
@@ -53,22 +55,12 @@ BruteForceSearch(const dataset::SearchDataset& dataset,
         auto base_dataset =
             knowhere::GenDataSet(chunk_rows, dim, chunk_data_raw);
         auto query_dataset = knowhere::GenDataSet(nq, dim, dataset.query_data);
-        auto config = knowhere::Json{
-            {knowhere::meta::METRIC_TYPE, dataset.metric_type},
-            {knowhere::meta::DIM, dim},
-            {knowhere::meta::TOPK, topk},
-        };
+        auto& config = params.brute_force_conf_;
 
         sub_result.mutable_seg_offsets().resize(nq * topk);
         sub_result.mutable_distances().resize(nq * topk);
 
-        if (conf.contains(RADIUS)) {
-            config[RADIUS] = conf[RADIUS].get<float>();
-            if (conf.contains(RANGE_FILTER)) {
-                config[RANGE_FILTER] = conf[RANGE_FILTER].get<float>();
-                CheckRangeSearchParam(
-                    config[RADIUS], config[RANGE_FILTER], dataset.metric_type);
-            }
+        if (params.is_range_search()) {
             auto res = knowhere::BruteForce::RangeSearch(
                 base_dataset, query_dataset, config, bitset);
 
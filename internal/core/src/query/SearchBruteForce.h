@@ -23,11 +23,13 @@ void
 CheckBruteForceSearchParam(const FieldMeta& field,
                            const SearchInfo& search_info);
 
+// searches `chunk_rows` rows with the params parsed for the search of
+// `dataset`
 SubSearchResult
 BruteForceSearch(const dataset::SearchDataset& dataset,
                  const void* chunk_data_raw,
                  int64_t chunk_rows,
-                 const knowhere::Json& conf,
+                 const SearchParams& params,
                  const BitsetView& bitset);
 
 }  // namespace milvus::query
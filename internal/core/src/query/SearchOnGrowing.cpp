@@ -9,16 +9,71 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <cstddef>
+#include <utility>
+#include <vector>
+
 #include "common/BitsetView.h"
+#include "common/Cancellation.h"
 #include "common/QueryInfo.h"
 #include "SearchOnGrowing.h"
+#include "query/BinaryBruteForce.h"
+#include "query/BlockedBruteForce.h"
 #include "query/SearchBruteForce.h"
 #include "query/SearchOnIndex.h"
+#include "query/SketchBruteForce.h"
+#include "segcore/SegcoreConfig.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::query {
 
+namespace {
+// drops the hits of rows at or after `end`, keeping the order of the rest
 void
+DropOffsetsFrom(SubSearchResult& result, int64_t end, float init_value) {
+    auto topk = result.get_topk();
+    auto seg_offsets = result.get_seg_offsets();
+    auto distances = result.get_distances();
+    for (int64_t q = 0; q < result.get_num_queries(); ++q) {
+        auto begin = q * topk;
+        int64_t kept = 0;
+        for (int64_t k = 0; k < topk; ++k) {
+            auto offset = seg_offsets[begin + k];
+            if (offset != INVALID_SEG_OFFSET && offset < end) {
+                seg_offsets[begin + kept] = offset;
+                distances[begin + kept] = distances[begin + k];
+                ++kept;
+            }
+        }
+        for (; kept < topk; ++kept) {
+            seg_offsets[begin + kept] = INVALID_SEG_OFFSET;
+            distances[begin + kept] = init_value;
+        }
+    }
+}
+
+// distances a thread computes at least before the brute force search of a
+// growing segment takes one more
+constexpr int64_t kMinDistancesPerThread = 1 << 20;
+
+// the threads to brute force search `chunks` chunks with `distances`
+// distances to compute, at most a thread per chunk
+int64_t
+SearchParallelism(int64_t chunks, int64_t distances) {
+    auto& config = segcore::SegcoreConfig::default_config();
+    auto parallelism = std::min({config.get_growing_search_parallelism(),
+                                 chunks,
+                                 distances / kMinDistancesPerThread});
+    return std::max<int64_t>(parallelism, 1);
+}
+}  // namespace
+
+// searches the interim index of the field into `results`, returns the
+// number of leading rows it covered, the rest are left to brute force. The
+// index may be built behind the inserts, so it covers the rows up to its
+// cursor, read before the search so rows added meanwhile are dropped.
+int64_t
 FloatSegmentIndexSearch(const segcore::SegmentGrowingImpl& segment,
                         const SearchInfo& info,
                         const void* query_data,
@@ -28,30 +83,44 @@ FloatSegmentIndexSearch(const segcore::SegmentGrowingImpl& segment,
                         SubSearchResult& results) {
     auto& schema = segment.get_schema();
     auto& indexing_record = segment.get_indexing_record();
-    auto& record = segment.get_insert_record();
 
     auto vecfield_id = info.field_id_;
     auto& field = schema[vecfield_id];
 
-    AssertInfo(field.get_data_type() == DataType::VECTOR_FLOAT,
-               "[FloatSearch]Field data type isn't VECTOR_FLOAT");
+    if (!indexing_record.is_in(vecfield_id) ||
+        field.get_data_type() != DataType::VECTOR_FLOAT) {
+        return 0;
+    }
     dataset::SearchDataset search_dataset{info.metric_type_,
                                           num_queries,
                                           info.topk_,
                                           info.round_decimal_,
                                           field.get_dim(),
                                           query_data};
-    if (indexing_record.is_in(vecfield_id)) {
-        const auto& field_indexing =
-            indexing_record.get_vec_field_indexing(vecfield_id);
-
-        auto indexing = field_indexing.get_segment_indexing();
-        SearchInfo search_conf = field_indexing.get_search_params(info);
-        auto vec_index = dynamic_cast<index::VectorIndex*>(indexing);
-        auto result =
-            SearchOnIndex(search_dataset, *vec_index, search_conf, bitset);
+    const auto& field_indexing =
+        indexing_record.get_vec_field_indexing(vecfield_id);
+    auto lck = field_indexing.lock_for_search();
+    auto indexed = field_indexing.get_index_cursor();
+    if (indexed == 0) {
+        return 0;
+    }
+
+    CheckCancelled();
+    auto indexing = field_indexing.get_segment_indexing();
+    SearchInfo search_conf = field_indexing.get_search_params(info);
+    auto vec_index = dynamic_cast<index::VectorIndex*>(indexing);
+    auto result =
+        SearchOnIndex(search_dataset, *vec_index, search_conf, bitset);
+    // the inserts keep the rows only in the index, it has all of them
+    if (indexing_record.HasRawData(vecfield_id)) {
         results.merge(result);
+        return ins_barrier;
     }
+    indexed = std::min<int64_t>(indexed, ins_barrier);
+    DropOffsetsFrom(
+        result, indexed, SubSearchResult::init_value(info.metric_type_));
+    results.merge(result);
+    return indexed;
 }
 
 void
@@ -87,54 +156,206 @@ SearchOnGrowing(const segcore::SegmentGrowingImpl& segment,
     dataset::SearchDataset search_dataset{
         metric_type, num_queries, topk, round_decimal, dim, query_data};
 
-    if (segment.get_indexing_record().SyncDataWithIndex(field.get_id())) {
-        FloatSegmentIndexSearch(segment,
-                                info,
-                                query_data,
-                                num_queries,
-                                active_count,
-                                bitset,
-                                final_qr);
-        results.distances_ = std::move(final_qr.mutable_distances());
-        results.seg_offsets_ = std::move(final_qr.mutable_seg_offsets());
-        results.unity_topK_ = topk;
-        results.total_nq_ = num_queries;
-    } else {
-        int32_t current_chunk_id = 0;
-        // step 3: brute force search where small indexing is unavailable
+    auto indexed = FloatSegmentIndexSearch(segment,
+                                           info,
+                                           query_data,
+                                           num_queries,
+                                           active_count,
+                                           bitset,
+                                           final_qr);
+    if (indexed < active_count) {
+        // step 3: brute force search of the rows not in the small index
+        SubSearchResult brute_qr(
+            num_queries, topk, metric_type, round_decimal);
         auto vec_ptr = record.get_field_data_base(vecfield_id);
         auto vec_size_per_chunk = vec_ptr->get_size_per_chunk();
+        auto first_chunk = indexed / vec_size_per_chunk;
         auto max_chunk = upper_div(active_count, vec_size_per_chunk);
+        auto fp16_ptr =
+            dynamic_cast<const segcore::ConcurrentFloat16Vector*>(vec_ptr);
+
+        // calls func(rows, offset, size) on the rows [begin, end), a chunk
+        // at a time, half float chunks are decoded a block of rows at a time
+        auto for_each_block = [&](int64_t begin, int64_t end, auto&& func) {
+            std::vector<float> decoded;
+            for (auto chunk_id = begin / vec_size_per_chunk;
+                 chunk_id * vec_size_per_chunk < end;
+                 ++chunk_id) {
+                CheckCancelled();
+                auto chunk_begin = chunk_id * vec_size_per_chunk;
+                auto element_begin = std::max(chunk_begin, begin);
+                auto element_end =
+                    std::min(end, chunk_begin + vec_size_per_chunk);
+                if (fp16_ptr == nullptr) {
+                    auto rows = static_cast<const char*>(
+                                    vec_ptr->get_chunk_data(chunk_id)) +
+                                (element_begin - chunk_begin) *
+                                    field.get_sizeof();
+                    func(rows, element_begin, element_end - element_begin);
+                    continue;
+                }
+                for (auto block = element_begin; block < element_end;
+                     block += FP16_DECODE_BLOCK_ROWS) {
+                    auto size =
+                        std::min(element_end - block, FP16_DECODE_BLOCK_ROWS);
+                    decoded.resize(size * dim);
+                    fp16_ptr->decode_rows(block, size, decoded.data());
+                    func(decoded.data(), block, size);
+                }
+            }
+        };
+
+        // the chunks are split into parts of whole chunks searched on
+        // their own threads into their own results, merged in the order
+        // of the parts so ties are broken as by a single pass
+        auto num_parts = SearchParallelism(max_chunk - first_chunk,
+                                           (active_count - indexed) *
+                                               num_queries);
+        auto part_rows = [&](int64_t part) {
+            auto chunks = max_chunk - first_chunk;
+            auto begin = first_chunk + chunks * part / num_parts;
+            auto end = first_chunk + chunks * (part + 1) / num_parts;
+            return std::make_pair(
+                std::max(indexed, begin * vec_size_per_chunk),
+                std::min(active_count, end * vec_size_per_chunk));
+        };
+        // calls search_part(part, begin, end) for every part
+        auto search_parts = [&](auto&& search_part) {
+            ThreadPool::GetInstance().ParallelFor(
+                num_parts, num_parts - 1, [&](int64_t part) {
+                    auto [begin, end] = part_rows(part);
+                    search_part(part, begin, end);
+                });
+        };
+        std::vector<SubSearchResult> part_qrs;
+        auto init_part_qrs = [&]() {
+            part_qrs.reserve(num_parts);
+            for (int64_t part = 0; part < num_parts; ++part) {
+                part_qrs.emplace_back(
+                    num_queries, topk, metric_type, round_decimal);
+            }
+        };
+
+        // with the sketches of the rows kept at insert, float L2/IP/COSINE
+        // ranks the rows of a part by them and reads the rows of the best
+        // ones only
+        auto sketches_ptr = record.get_vector_sketches(vecfield_id);
+        auto sketch_factor =
+            segment.get_segcore_config().get_brute_force_sketch_factor();
+        if (sketches_ptr != nullptr && sketch_factor > 0 &&
+            BlockedBruteForce::Supports(field, info)) {
+            auto float_ptr = record.get_field_data<FloatVector>(vecfield_id);
+            init_part_qrs();
+            search_parts([&](int64_t part, int64_t begin, int64_t end) {
+                SketchBruteForce brute_force(
+                    static_cast<const float*>(query_data),
+                    num_queries,
+                    dim,
+                    topk,
+                    metric_type,
+                    sketch_factor * topk);
+                for (auto offset = begin; offset < end;) {
+                    CheckCancelled();
+                    auto chunk_end =
+                        (offset / vec_size_per_chunk + 1) * vec_size_per_chunk;
+                    auto size = std::min(end, chunk_end) - offset;
+                    brute_force.AddSketches(sketches_ptr->get_element(offset),
+                                            size,
+                                            offset,
+                                            bitset.subview(offset, size));
+                    offset += size;
+                }
+                brute_force.Finish(part_qrs[part], [&](int64_t offset) {
+                    return float_ptr->get_element(offset);
+                });
+            });
+            brute_qr.merge_many(part_qrs);
+            brute_qr.round_values();
+        } else if (BlockedBruteForce::Supports(field, info)) {
+            // float L2/IP/COSINE searches all the chunks of a part in one
+            // pass, without a dataset, a config and a merge per chunk, with
+            // the norms of the rows computed at insert if they are kept
+            auto norms_ptr = record.get_vector_norms(vecfield_id);
+            init_part_qrs();
+            search_parts([&](int64_t part, int64_t begin, int64_t end) {
+                BlockedBruteForce brute_force(
+                    static_cast<const float*>(query_data),
+                    num_queries,
+                    dim,
+                    topk,
+                    metric_type);
+                auto add = [&](const void* rows, int64_t offset, int64_t size) {
+                    const float* norms = nullptr;
+                    if (norms_ptr != nullptr) {
+                        norms = norms_ptr->get_element(offset);
+                    }
+                    brute_force.Add(static_cast<const float*>(rows),
+                                    size,
+                                    offset,
+                                    bitset.subview(offset, size),
+                                    norms);
+                };
+                for_each_block(begin, end, add);
+                brute_force.Finish(part_qrs[part]);
+            });
+            brute_qr.merge_many(part_qrs);
+            brute_qr.round_values();
+        } else if (BinaryBruteForce::Supports(field, info)) {
+            init_part_qrs();
+            search_parts([&](int64_t part, int64_t begin, int64_t end) {
+                BinaryBruteForce brute_force(
+                    static_cast<const uint8_t*>(query_data),
+                    num_queries,
+                    dim,
+                    topk,
+                    metric_type);
+                auto add = [&](const void* rows, int64_t offset, int64_t size) {
+                    brute_force.Add(static_cast<const uint8_t*>(rows),
+                                    size,
+                                    offset,
+                                    bitset.subview(offset, size));
+                };
+                for_each_block(begin, end, add);
+                brute_force.Finish(part_qrs[part]);
+            });
+            brute_qr.merge_many(part_qrs);
+            brute_qr.round_values();
+        } else {
+            // a result per block, collected by part and merged in order
+            auto params = GetSearchParams(info);
+            std::vector<std::vector<SubSearchResult>> block_qrs(num_parts);
+            search_parts([&](int64_t part, int64_t begin, int64_t end) {
+                auto search = [&](const void* rows,
+                                  int64_t offset,
+                                  int64_t size) {
+                    auto sub_view = bitset.subview(offset, size);
+                    auto sub_qr = BruteForceSearch(
+                        search_dataset, rows, size, *params, sub_view);
 
-        for (int chunk_id = current_chunk_id; chunk_id < max_chunk;
-             ++chunk_id) {
-            auto chunk_data = vec_ptr->get_chunk_data(chunk_id);
-
-            auto element_begin = chunk_id * vec_size_per_chunk;
-            auto element_end =
-                std::min(active_count, (chunk_id + 1) * vec_size_per_chunk);
-            auto size_per_chunk = element_end - element_begin;
-
-            auto sub_view = bitset.subview(element_begin, size_per_chunk);
-            auto sub_qr = BruteForceSearch(search_dataset,
-                                           chunk_data,
-                                           size_per_chunk,
-                                           info.search_params_,
-                                           sub_view);
-
-            // convert chunk uid to segment uid
-            for (auto& x : sub_qr.mutable_seg_offsets()) {
-                if (x != -1) {
-                    x += chunk_id * vec_size_per_chunk;
+                    // convert block uid to segment uid
+                    for (auto& x : sub_qr.mutable_seg_offsets()) {
+                        if (x != -1) {
+                            x += offset;
+                        }
+                    }
+                    block_qrs[part].push_back(std::move(sub_qr));
+                };
+                for_each_block(begin, end, search);
+            });
+            std::vector<SubSearchResult> sub_qrs;
+            for (auto& qrs : block_qrs) {
+                for (auto& qr : qrs) {
+                    sub_qrs.push_back(std::move(qr));
                 }
             }
-            final_qr.merge(sub_qr);
+            brute_qr.merge_many(sub_qrs);
         }
-        results.distances_ = std::move(final_qr.mutable_distances());
-        results.seg_offsets_ = std::move(final_qr.mutable_seg_offsets());
-        results.unity_topK_ = topk;
-        results.total_nq_ = num_queries;
+        final_qr.merge(brute_qr);
     }
+    results.distances_ = std::move(final_qr.mutable_distances());
+    results.seg_offsets_ = std::move(final_qr.mutable_seg_offsets());
+    results.unity_topK_ = topk;
+    results.total_nq_ = num_queries;
 }
 
 }  // namespace milvus::query
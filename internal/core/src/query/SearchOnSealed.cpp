@@ -9,13 +9,21 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <chrono>
 #include <cmath>
 #include <string>
 
+#include "common/Cancellation.h"
+#include "common/Consts.h"
 #include "common/QueryInfo.h"
+#include "query/AdaptiveSearch.h"
+#include "query/BinaryBruteForce.h"
+#include "query/BlockedBruteForce.h"
 #include "query/SearchBruteForce.h"
 #include "query/SearchOnSealed.h"
+#include "query/SketchBruteForce.h"
 #include "query/helper.h"
+#include "segcore/SegcoreConfig.h"
 
 namespace milvus::query {
 
@@ -40,17 +48,37 @@ SearchOnSealedIndex(const Schema& schema,
     AssertInfo(field_indexing->metric_type_ == search_info.metric_type_,
                "Metric type of field index isn't the same with search info");
 
-    auto final = [&] {
-        auto ds = knowhere::GenDataSet(num_queries, dim, query_data);
-
-        auto conf = search_info.search_params_;
-        conf[knowhere::meta::TOPK] = search_info.topk_;
-        conf[knowhere::meta::METRIC_TYPE] = field_indexing->metric_type_;
-        auto vec_index =
-            dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
+    CheckCancelled();
+    auto vec_index =
+        dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
+    auto ds = knowhere::GenDataSet(num_queries, dim, query_data);
+    std::unique_ptr<SearchResult> final;
+    if (search_info.adaptive_.has_value()) {
+        // the params are picked for this segment and the rows its filter
+        // leaves, the latency of the search tunes the next picks
+        auto pass_ratio =
+            bitset.empty() ? 1.0 : 1.0 - double(bitset.count()) / bitset.size();
+        auto& tuner = AdaptiveSearchTuner::GetInstance();
         auto index_type = vec_index->GetIndexType();
-        return vec_index->Query(ds, search_info, bitset);
-    }();
+        auto picked = tuner.Pick(index_type,
+                                 field_indexing->index_params_,
+                                 search_info,
+                                 vec_index->Count(),
+                                 pass_ratio,
+                                 num_queries);
+        SearchInfo tuned_info = search_info;
+        tuned_info.search_params_ = std::move(picked.search_params);
+        tuned_info.parsed_params_ = ParseSearchParams(
+            tuned_info.search_params_, topk, search_info.metric_type_);
+        auto begin = std::chrono::steady_clock::now();
+        final = vec_index->Query(ds, tuned_info, bitset);
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - begin;
+        tuner.Observe(index_type, picked.effort, elapsed.count());
+        result.effective_search_params_ = tuned_info.search_params_.dump();
+    } else {
+        final = vec_index->Query(ds, search_info, bitset);
+    }
 
     auto ids = final->seg_offsets_.data();
     float* distances = final->distances_.data();
@@ -71,15 +99,69 @@ SearchOnSealedIndex(const Schema& schema,
     std::copy_n(distances, total_num, result.distances_.data());
 }
 
+void
+RefineSearchResult(const Schema& schema,
+                   const SearchInfo& search_info,
+                   const void* query_data,
+                   int64_t num_queries,
+                   const void* gathered_data,
+                   SearchResult& result) {
+    auto& field = schema[search_info.field_id_];
+    AssertInfo(field.get_data_type() == DataType::VECTOR_FLOAT,
+               "only float vectors are refined");
+    auto dim = field.get_dim();
+    auto topk = search_info.topk_;
+    auto fetched = result.unity_topK_;
+    auto& metric_type = search_info.metric_type_;
+    auto round_decimal = search_info.round_decimal_;
+    auto queries = static_cast<const float*>(query_data);
+    auto rows = static_cast<const float*>(gathered_data);
+
+    SubSearchResult refined(num_queries, topk, metric_type, round_decimal);
+    BitsetType invalid(fetched);
+    for (int64_t q = 0; q < num_queries; ++q) {
+        auto offsets = result.seg_offsets_.data() + q * fetched;
+        invalid.reset();
+        for (int64_t k = 0; k < fetched; ++k) {
+            if (offsets[k] == INVALID_SEG_OFFSET) {
+                invalid.set(k);
+            }
+        }
+        // the hits of the query are the rows of its own brute force search
+        BlockedBruteForce brute_force(
+            queries + q * dim, 1, dim, topk, metric_type);
+        brute_force.Add(
+            rows + q * fetched * dim, fetched, 0, BitsetView(invalid));
+        SubSearchResult query_qr(1, topk, metric_type, round_decimal);
+        brute_force.Finish(query_qr);
+        for (int64_t k = 0; k < topk; ++k) {
+            auto hit = query_qr.get_seg_offsets()[k];
+            if (hit == INVALID_SEG_OFFSET) {
+                continue;
+            }
+            refined.get_seg_offsets()[q * topk + k] = offsets[hit];
+            refined.get_distances()[q * topk + k] =
+                query_qr.get_distances()[k];
+        }
+    }
+    refined.round_values();
+    result.seg_offsets_ = std::move(refined.mutable_seg_offsets());
+    result.distances_ = std::move(refined.mutable_distances());
+    result.unity_topK_ = topk;
+}
+
 void
 SearchOnSealed(const Schema& schema,
                const void* vec_data,
+               const float* vec_norms,
+               const uint8_t* vec_sketches,
                const SearchInfo& search_info,
                const void* query_data,
                int64_t num_queries,
                int64_t row_count,
                const BitsetView& bitset,
                SearchResult& result) {
+    CheckCancelled();
     auto field_id = search_info.field_id_;
     auto& field = schema[field_id];
 
@@ -91,8 +173,80 @@ SearchOnSealed(const Schema& schema,
                                           query_data};
 
     CheckBruteForceSearchParam(field, search_info);
+    if (BinaryBruteForce::Supports(field, search_info)) {
+        SubSearchResult sub_qr(num_queries,
+                               dataset.topk,
+                               dataset.metric_type,
+                               dataset.round_decimal);
+        BinaryBruteForce brute_force(static_cast<const uint8_t*>(query_data),
+                                     num_queries,
+                                     dataset.dim,
+                                     dataset.topk,
+                                     dataset.metric_type);
+        brute_force.Add(
+            static_cast<const uint8_t*>(vec_data), row_count, 0, bitset);
+        brute_force.Finish(sub_qr);
+        sub_qr.round_values();
+        result.distances_ = std::move(sub_qr.mutable_distances());
+        result.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
+        result.unity_topK_ = dataset.topk;
+        result.total_nq_ = dataset.num_queries;
+        return;
+    }
+    // ranks the rows by their sketches if they are kept and many more than
+    // the candidates, see SketchBruteForce
+    auto& config = segcore::SegcoreConfig::default_config();
+    auto sketch_factor = config.get_brute_force_sketch_factor();
+    if (vec_sketches != nullptr && sketch_factor > 0 &&
+        row_count > sketch_factor * dataset.topk &&
+        BlockedBruteForce::Supports(field, search_info)) {
+        SubSearchResult sub_qr(num_queries,
+                               dataset.topk,
+                               dataset.metric_type,
+                               dataset.round_decimal);
+        SketchBruteForce brute_force(static_cast<const float*>(query_data),
+                                     num_queries,
+                                     dataset.dim,
+                                     dataset.topk,
+                                     dataset.metric_type,
+                                     sketch_factor * dataset.topk);
+        brute_force.AddSketches(vec_sketches, row_count, 0, bitset);
+        auto rows = static_cast<const float*>(vec_data);
+        brute_force.Finish(sub_qr, [&](int64_t offset) {
+            return rows + offset * dataset.dim;
+        });
+        sub_qr.round_values();
+        result.distances_ = std::move(sub_qr.mutable_distances());
+        result.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
+        result.unity_topK_ = dataset.topk;
+        result.total_nq_ = dataset.num_queries;
+        return;
+    }
+    if (BlockedBruteForce::Supports(field, search_info)) {
+        SubSearchResult sub_qr(num_queries,
+                               dataset.topk,
+                               dataset.metric_type,
+                               dataset.round_decimal);
+        BlockedBruteForce brute_force(static_cast<const float*>(query_data),
+                                      num_queries,
+                                      dataset.dim,
+                                      dataset.topk,
+                                      dataset.metric_type);
+        brute_force.Add(static_cast<const float*>(vec_data),
+                        row_count,
+                        0,
+                        bitset,
+                        vec_norms);
+        brute_force.Finish(sub_qr);
+        sub_qr.round_values();
+        result.distances_ = std::move(sub_qr.mutable_distances());
+        result.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
+        result.unity_topK_ = dataset.topk;
+        result.total_nq_ = dataset.num_queries;
+        return;
+    }
     auto sub_qr = BruteForceSearch(
-        dataset, vec_data, row_count, search_info.search_params_, bitset);
+        dataset, vec_data, row_count, *GetSearchParams(search_info), bitset);
 
     result.distances_ = std::move(sub_qr.mutable_distances());
     result.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
@@ -100,4 +254,31 @@ SearchOnSealed(const Schema& schema,
     result.total_nq_ = dataset.num_queries;
 }
 
+void
+SearchOnOffsets(const Schema& schema,
+                const void* gathered_data,
+                const int64_t* seg_offsets,
+                int64_t count,
+                const SearchInfo& search_info,
+                const void* query_data,
+                int64_t num_queries,
+                SearchResult& result) {
+    SearchOnSealed(schema,
+                   gathered_data,
+                   nullptr,
+                   nullptr,
+                   search_info,
+                   query_data,
+                   num_queries,
+                   count,
+                   nullptr,
+                   result);
+    // positions in the gathered rows back to segment offsets
+    for (auto& offset : result.seg_offsets_) {
+        if (offset != INVALID_SEG_OFFSET) {
+            offset = seg_offsets[offset];
+        }
+    }
+}
+
 }  // namespace milvus::query
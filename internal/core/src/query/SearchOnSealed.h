@@ -27,9 +27,25 @@ SearchOnSealedIndex(const Schema& schema,
                     const BitsetView& view,
                     SearchResult& result);
 
+// reranks the hits of an index search which fetched more than topk hits per
+// query by their exact distances, keeping the best topk of each query.
+// `gathered_data` holds the raw float vectors of the hits in the order of
+// the seg offsets of `result`, the rows of invalid hits are ignored
+void
+RefineSearchResult(const Schema& schema,
+                   const SearchInfo& search_info,
+                   const void* query_data,
+                   int64_t num_queries,
+                   const void* gathered_data,
+                   SearchResult& result);
+
+// brute force search over the `row_count` raw vectors of a sealed segment,
+// `vec_norms` are the squared norms of float vectors, null if not kept
 void
 SearchOnSealed(const Schema& schema,
                const void* vec_data,
+               const float* vec_norms,
+               const uint8_t* vec_sketches,
                const SearchInfo& search_info,
                const void* query_data,
                int64_t num_queries,
@@ -37,4 +53,16 @@ SearchOnSealed(const Schema& schema,
                const BitsetView& bitset,
                SearchResult& result);
 
+// brute force search over `count` vectors gathered from the rows at
+// `seg_offsets`, the result holds the segment offsets of the hits
+void
+SearchOnOffsets(const Schema& schema,
+                const void* gathered_data,
+                const int64_t* seg_offsets,
+                int64_t count,
+                const SearchInfo& search_info,
+                const void* query_data,
+                int64_t num_queries,
+                SearchResult& result);
+
 }  // namespace milvus::query
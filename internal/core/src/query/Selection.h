@@ -0,0 +1,112 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "boost_ext/dynamic_bitset_ext.hpp"
+#include "common/BitsetOps.h"
+#include "common/Types.h"
+
+namespace milvus::query {
+
+// rows which survive the filter of a search or a query, kept by their
+// cardinality: a dense bitset with the filtered out rows set, or when few
+// rows survive, their sorted offsets, which is smaller than the bitset and
+// lets the search visit just those rows
+class Selection {
+ public:
+    // the offsets take less memory than the bitset below one survivor per
+    // 64 rows
+    static constexpr int64_t kSparseRatio = 64;
+
+    // `filtered` has a bit set for every row filtered out, up to
+    // `sparse_limit` surviving rows are kept as offsets whatever the ratio
+    explicit Selection(BitsetType&& filtered, int64_t sparse_limit = 0)
+        : size_(filtered.size()), count_(size_ - BitsetCount(filtered)) {
+        if (count_ * kSparseRatio > size_ && count_ > sparse_limit) {
+            bitset_ = std::move(filtered);
+            return;
+        }
+        sparse_ = true;
+        if (count_ == 0) {
+            return;
+        }
+        static_assert(sizeof(BitSetBlockType) == sizeof(uint64_t));
+        auto words = reinterpret_cast<const uint64_t*>(
+            boost_ext::get_data(filtered));
+        offsets_.reserve(count_);
+        for (size_t i = 0; i < filtered.num_blocks(); ++i) {
+            auto word = ~words[i];
+            while (word != 0) {
+                auto offset = int64_t(i * 64 + __builtin_ctzll(word));
+                if (offset >= size_) {
+                    break;
+                }
+                offsets_.push_back(offset);
+                word &= word - 1;
+            }
+        }
+    }
+
+    bool
+    is_sparse() const {
+        return sparse_;
+    }
+
+    // rows the filter ran over
+    int64_t
+    size() const {
+        return size_;
+    }
+
+    // rows which survive
+    int64_t
+    count() const {
+        return count_;
+    }
+
+    // sorted offsets of the surviving rows, only kept when sparse
+    const std::vector<int64_t>&
+    offsets() const {
+        return offsets_;
+    }
+
+    // the dense form, rebuilt from the offsets when sparse
+    const BitsetType&
+    bitset() {
+        if (sparse_ && static_cast<int64_t>(bitset_.size()) != size_) {
+            bitset_.resize(size_, true);
+            for (auto offset : offsets_) {
+                bitset_.reset(offset);
+            }
+        }
+        return bitset_;
+    }
+
+ private:
+    int64_t size_;
+    int64_t count_;
+    bool sparse_ = false;
+    BitsetType bitset_;
+    std::vector<int64_t> offsets_;
+};
+
+}  // namespace milvus::query
@@ -0,0 +1,136 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "query/SketchBruteForce.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/Consts.h"
+#include "common/Utils.h"
+#include "query/BlockedBruteForce.h"
+#include "query/TopkHeaps.h"
+
+namespace milvus::query {
+
+void
+SketchBruteForce::Encode(const float* rows,
+                         int64_t size,
+                         int64_t dim,
+                         uint8_t* sketches) {
+    auto code_size = CodeSize(dim);
+    std::fill_n(sketches, size * code_size, 0);
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * dim;
+        auto sketch = sketches + i * code_size;
+        for (int64_t d = 0; d < dim; ++d) {
+            sketch[d / 8] |= uint8_t(row[d] > 0) << (d % 8);
+        }
+    }
+}
+
+std::vector<uint8_t>
+SketchBruteForce::Sketches(const float* rows, int64_t size, int64_t dim) {
+    std::vector<uint8_t> sketches(size * CodeSize(dim));
+    Encode(rows, size, dim, sketches.data());
+    return sketches;
+}
+
+SketchBruteForce::SketchBruteForce(const float* queries,
+                                   int64_t num_queries,
+                                   int64_t dim,
+                                   int64_t topk,
+                                   const MetricType& metric_type,
+                                   int64_t candidates)
+    : num_queries_(num_queries),
+      dim_(dim),
+      topk_(topk),
+      candidates_(std::max(candidates, topk)),
+      is_ip_(PositivelyRelated(metric_type)),
+      is_cosine_(IsMetricType(metric_type, knowhere::metric::COSINE)),
+      queries_(queries),
+      query_norms_(num_queries),
+      query_sketches_(Sketches(queries, num_queries, dim)),
+      first_pass_(query_sketches_.data(),
+                  num_queries,
+                  CodeSize(dim) * 8,
+                  candidates_,
+                  knowhere::metric::HAMMING) {
+    BlockedBruteForce::SquaredNorms(
+        queries, num_queries, dim, query_norms_.data());
+}
+
+void
+SketchBruteForce::AddSketches(const uint8_t* sketches,
+                              int64_t size,
+                              int64_t offset,
+                              const BitsetView& bitset) {
+    first_pass_.Add(sketches, size, offset, bitset);
+}
+
+float
+SketchBruteForce::Distance(const float* query,
+                           float query_norm,
+                           const float* row) const {
+    float product = 0;
+    float row_norm = 0;
+    for (int64_t d = 0; d < dim_; ++d) {
+        product += query[d] * row[d];
+        row_norm += row[d] * row[d];
+    }
+    // as BlockedBruteForce, so both passes rank the rows alike
+    if (is_cosine_) {
+        auto norms = std::sqrt(query_norm) * std::sqrt(row_norm);
+        return norms > 0 ? product / norms : 0.0f;
+    }
+    if (is_ip_) {
+        return product;
+    }
+    return std::max(query_norm + row_norm - 2 * product, 0.0f);
+}
+
+void
+SketchBruteForce::Finish(SubSearchResult& result,
+                         const std::function<const float*(int64_t)>& row) {
+    if (topk_ <= 0) {
+        return;
+    }
+    SubSearchResult candidates(
+        num_queries_, candidates_, knowhere::metric::HAMMING, -1);
+    first_pass_.Finish(candidates);
+
+    TopkHeaps heaps(num_queries_, topk_, is_ip_);
+    std::vector<int64_t> offsets;
+    for (int64_t q = 0; q < num_queries_; ++q) {
+        auto begin = candidates.get_seg_offsets() + q * candidates_;
+        offsets.assign(begin, begin + candidates_);
+        offsets.erase(
+            std::remove(offsets.begin(), offsets.end(), INVALID_SEG_OFFSET),
+            offsets.end());
+        // the rows in offset order, to read them forward
+        std::sort(offsets.begin(), offsets.end());
+        for (auto offset : offsets) {
+            heaps.Push(q,
+                       {Distance(queries_ + q * dim_,
+                                 query_norms_[q],
+                                 row(offset)),
+                        offset});
+        }
+    }
+    heaps.Finish(result);
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,95 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/FieldMeta.h"
+#include "common/QueryInfo.h"
+#include "query/BinaryBruteForce.h"
+#include "query/SubSearchResult.h"
+
+namespace milvus::query {
+
+// A two pass brute force search of float vectors. The first pass ranks the
+// rows by the hamming distance of their sketches, a sign bit per dimension,
+// to those of the queries and keeps `candidates` rows per query, the second
+// computes the distances of those only. The sketches are a 32nd of the
+// rows, so most of the rows are never read.
+class SketchBruteForce {
+ public:
+    // bytes of the sketch of a row of `dim` dimensions
+    static int64_t
+    CodeSize(int64_t dim) {
+        return (dim + 7) / 8;
+    }
+
+    // the sketches of `size` rows into `sketches`, CodeSize(dim) bytes a
+    // row, with the bit of every positive value set
+    static void
+    Encode(const float* rows, int64_t size, int64_t dim, uint8_t* sketches);
+
+    // for the searches BlockedBruteForce supports, `candidates` is at
+    // least topk
+    SketchBruteForce(const float* queries,
+                     int64_t num_queries,
+                     int64_t dim,
+                     int64_t topk,
+                     const MetricType& metric_type,
+                     int64_t candidates);
+
+    // ranks `size` rows by their sketches, the first of them at segment
+    // offset `offset`, skipping those with their bit set in `bitset`
+    void
+    AddSketches(const uint8_t* sketches,
+                int64_t size,
+                int64_t offset,
+                const BitsetView& bitset);
+
+    // computes the distances of the candidates of every query to their
+    // rows, `row(offset)` is the row at a segment offset, and writes the
+    // top-k of every query as BlockedBruteForce::Finish
+    void
+    Finish(SubSearchResult& result,
+           const std::function<const float*(int64_t)>& row);
+
+ private:
+    static std::vector<uint8_t>
+    Sketches(const float* rows, int64_t size, int64_t dim);
+
+    float
+    Distance(const float* query, float query_norm, const float* row) const;
+
+ private:
+    int64_t num_queries_;
+    int64_t dim_;
+    int64_t topk_;
+    int64_t candidates_;
+    bool is_ip_;
+    bool is_cosine_;
+    const float* queries_;
+    // squared norms of the queries
+    std::vector<float> query_norms_;
+    // initialized before first_pass_, which reads them
+    std::vector<uint8_t> query_sketches_;
+    BinaryBruteForce first_pass_;
+};
+
+}  // namespace milvus::query
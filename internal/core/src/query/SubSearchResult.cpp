@@ -9,6 +9,7 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <cmath>
 
 #include "exceptions/EasyAssert.h"
@@ -27,6 +28,9 @@ SubSearchResult::merge_impl(const SubSearchResult& right) {
     AssertInfo(is_desc == PositivelyRelated(metric_type_),
                "[SubSearchResult]Metric type isn't desc");
 
+    std::vector<float> buf_distances(topk_);
+    std::vector<int64_t> buf_ids(topk_);
+
     for (int64_t qn = 0; qn < num_queries_; ++qn) {
         auto offset = qn * topk_;
 
@@ -36,9 +40,6 @@ SubSearchResult::merge_impl(const SubSearchResult& right) {
         auto right_ids = right.get_ids() + offset;
         auto right_distances = right.get_distances() + offset;
 
-        std::vector<float> buf_distances(topk_);
-        std::vector<int64_t> buf_ids(topk_);
-
         auto lit = 0;  // left iter
         auto rit = 0;  // right iter
 
@@ -73,6 +74,92 @@ SubSearchResult::merge_impl(const SubSearchResult& right) {
     }
 }
 
+template <bool is_desc>
+void
+SubSearchResult::merge_many_impl(
+    const std::vector<SubSearchResult>& sub_results) {
+    AssertInfo(is_desc == PositivelyRelated(metric_type_),
+               "[SubSearchResult]Metric type isn't desc");
+    for (auto& sub_result : sub_results) {
+        AssertInfo(num_queries_ == sub_result.num_queries_,
+                   "[SubSearchResult]Nq check failed");
+        AssertInfo(topk_ == sub_result.topk_,
+                   "[SubSearchResult]Topk check failed");
+        AssertInfo(metric_type_ == sub_result.metric_type_,
+                   "[SubSearchResult]Metric type check failed");
+    }
+
+    // source 0 is this result, source i + 1 is sub_results[i]
+    auto num_sources = int64_t(sub_results.size()) + 1;
+    std::vector<const int64_t*> src_ids(num_sources);
+    std::vector<const float*> src_distances(num_sources);
+    std::vector<int64_t> cursors(num_sources);
+    std::vector<int64_t> heap;
+    heap.reserve(num_sources);
+    std::vector<float> buf_distances(topk_);
+    std::vector<int64_t> buf_ids(topk_);
+
+    // heap top is the best head, the lower source wins a tie
+    auto worse = [&](int64_t a, int64_t b) {
+        auto a_v = src_distances[a][cursors[a]];
+        auto b_v = src_distances[b][cursors[b]];
+        if (a_v != b_v) {
+            return is_desc ? (a_v < b_v) : (a_v > b_v);
+        }
+        return a > b;
+    };
+
+    for (int64_t qn = 0; qn < num_queries_; ++qn) {
+        auto offset = qn * topk_;
+        heap.clear();
+        for (int64_t src = 0; src < num_sources; ++src) {
+            auto& result = src == 0 ? *this : sub_results[src - 1];
+            src_ids[src] = result.get_ids() + offset;
+            src_distances[src] = result.get_distances() + offset;
+            cursors[src] = 0;
+            // valid results are sorted in front of the invalid ones
+            if (topk_ > 0 && src_ids[src][0] != INVALID_SEG_OFFSET) {
+                heap.push_back(src);
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), worse);
+
+        int64_t buf_iter = 0;
+        for (; buf_iter < topk_ && !heap.empty(); ++buf_iter) {
+            std::pop_heap(heap.begin(), heap.end(), worse);
+            auto src = heap.back();
+            auto& cursor = cursors[src];
+            buf_distances[buf_iter] = src_distances[src][cursor];
+            buf_ids[buf_iter] = src_ids[src][cursor];
+            ++cursor;
+            if (cursor < topk_ && src_ids[src][cursor] != INVALID_SEG_OFFSET) {
+                std::push_heap(heap.begin(), heap.end(), worse);
+            } else {
+                heap.pop_back();
+            }
+        }
+        std::fill(buf_distances.begin() + buf_iter,
+                  buf_distances.end(),
+                  init_value(metric_type_));
+        std::fill(buf_ids.begin() + buf_iter, buf_ids.end(), INVALID_SEG_OFFSET);
+
+        std::copy_n(buf_distances.data(), topk_, this->get_distances() + offset);
+        std::copy_n(buf_ids.data(), topk_, this->get_seg_offsets() + offset);
+    }
+}
+
+void
+SubSearchResult::merge_many(const std::vector<SubSearchResult>& sub_results) {
+    if (sub_results.empty()) {
+        return;
+    }
+    if (PositivelyRelated(metric_type_)) {
+        this->merge_many_impl<true>(sub_results);
+    } else {
+        this->merge_many_impl<false>(sub_results);
+    }
+}
+
 void
 SubSearchResult::merge(const SubSearchResult& sub_result) {
     AssertInfo(metric_type_ == sub_result.metric_type_,
@@ -97,11 +97,20 @@ class SubSearchResult {
     void
     merge(const SubSearchResult& sub_result);
 
+    // merge all the sub results into this one in a single k-way pass,
+    // ties go to the earlier result like a chain of merge() calls
+    void
+    merge_many(const std::vector<SubSearchResult>& sub_results);
+
  private:
     template <bool is_desc>
     void
     merge_impl(const SubSearchResult& sub_result);
 
+    template <bool is_desc>
+    void
+    merge_many_impl(const std::vector<SubSearchResult>& sub_results);
+
  private:
     int64_t num_queries_;
     int64_t topk_;
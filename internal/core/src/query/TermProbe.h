@@ -0,0 +1,151 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace milvus::query {
+
+// `in` lists up to this size are compared against the data with one SIMD
+// broadcast compare per term
+constexpr size_t kTermBroadcastLimit = 8;
+// up to this size a branchless search over the sorted terms, beyond it a
+// hash set
+constexpr size_t kTermSearchLimit = 256;
+
+// index of the last element of `sorted` not greater than `x`, 0 if there is
+// none, the loop has a fixed trip count and no data dependent branch
+template <typename T>
+inline size_t
+BranchlessSearch(const T* sorted, size_t n, T x) {
+    const T* base = sorted;
+    while (n > 1) {
+        auto half = n / 2;
+        base += base[half] <= x ? half : 0;
+        n -= half;
+    }
+    return base - sorted;
+}
+
+// open addressing set of the terms of a large `in` list, probed without the
+// node allocations and pointer chasing of std::unordered_set
+template <typename T>
+class FlatTermSet {
+ public:
+    // `terms` are distinct
+    explicit FlatTermSet(const std::vector<T>& terms) {
+        int bits = 1;
+        while ((size_t(1) << bits) < terms.size() * 2) {
+            ++bits;
+        }
+        shift_ = 64 - bits;
+        mask_ = (size_t(1) << bits) - 1;
+        slots_.resize(mask_ + 1);
+        used_.resize(mask_ + 1, false);
+        for (auto& term : terms) {
+            auto slot = Slot(term);
+            while (used_[slot]) {
+                slot = (slot + 1) & mask_;
+            }
+            slots_[slot] = term;
+            used_[slot] = true;
+        }
+    }
+
+    bool
+    contains(T x) const {
+        for (auto slot = Slot(x); used_[slot]; slot = (slot + 1) & mask_) {
+            if (slots_[slot] == x) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+ private:
+    // fibonacci hashing spreads the consecutive values of ids over the slots
+    size_t
+    Slot(T x) const {
+        return (uint64_t(std::hash<T>{}(x)) * 0x9E3779B97F4A7C15ull) >> shift_;
+    }
+
+ private:
+    std::vector<T> slots_;
+    std::vector<bool> used_;
+    size_t mask_ = 0;
+    int shift_ = 0;
+};
+
+// membership test of the terms of a numeric `in` list, the strategy is picked
+// by the number of distinct terms
+template <typename T>
+class TermProbe {
+    static_assert(std::is_arithmetic_v<T>);
+
+ public:
+    template <typename Iter>
+    TermProbe(Iter begin, Iter end) {
+        for (auto it = begin; it != end; ++it) {
+            T value = *it;
+            if constexpr (std::is_floating_point_v<T>) {
+                // NaN equals nothing
+                if (std::isnan(value)) {
+                    continue;
+                }
+            }
+            values_.push_back(value);
+        }
+        std::sort(values_.begin(), values_.end());
+        values_.erase(std::unique(values_.begin(), values_.end()),
+                      values_.end());
+        if (values_.size() > kTermSearchLimit) {
+            hash_set_ = std::make_unique<FlatTermSet<T>>(values_);
+        }
+    }
+
+    // sorted distinct terms
+    const std::vector<T>&
+    values() const {
+        return values_;
+    }
+
+    bool
+    contains(T x) const {
+        if (hash_set_ != nullptr) {
+            return hash_set_->contains(x);
+        }
+        if (values_.empty()) {
+            return false;
+        }
+        return values_[BranchlessSearch(values_.data(), values_.size(), x)] ==
+               x;
+    }
+
+ private:
+    std::vector<T> values_;
+    std::unique_ptr<FlatTermSet<T>> hash_set_;
+};
+
+}  // namespace milvus::query
@@ -0,0 +1,102 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "query/SubSearchResult.h"
+
+namespace milvus::query {
+
+// The top-k hits of a batch of queries, topk slots per query kept as a
+// heap whose front is the worst hit, so a hit worse than it is dropped
+// right away. Filled across the chunks of a segment by the brute force
+// searches, there is no per chunk result to merge.
+class TopkHeaps {
+ public:
+    struct Hit {
+        float distance;
+        int64_t offset;
+    };
+
+    // larger distances are better with `larger_is_better`, IP and COSINE
+    TopkHeaps(int64_t num_queries, int64_t topk, bool larger_is_better)
+        : num_queries_(num_queries),
+          topk_(topk),
+          larger_is_better_(larger_is_better),
+          heaps_(num_queries * topk),
+          heap_sizes_(num_queries, 0) {
+    }
+
+    // the closer hit, ties go to the lower offset
+    bool
+    Better(const Hit& a, const Hit& b) const {
+        if (a.distance != b.distance) {
+            return larger_is_better_ ? a.distance > b.distance
+                                     : a.distance < b.distance;
+        }
+        return a.offset < b.offset;
+    }
+
+    void
+    Push(int64_t query, const Hit& hit) {
+        auto better = [this](const Hit& a, const Hit& b) {
+            return Better(a, b);
+        };
+        auto heap = heaps_.data() + query * topk_;
+        auto& size = heap_sizes_[query];
+        if (size < topk_) {
+            heap[size++] = hit;
+            std::push_heap(heap, heap + size, better);
+        } else if (better(hit, heap[0])) {
+            std::pop_heap(heap, heap + size, better);
+            heap[size - 1] = hit;
+            std::push_heap(heap, heap + size, better);
+        }
+    }
+
+    // writes the top-k of every query, best first, the slots of queries
+    // with fewer hits keep their initial values
+    void
+    Finish(SubSearchResult& result) {
+        auto better = [this](const Hit& a, const Hit& b) {
+            return Better(a, b);
+        };
+        auto seg_offsets = result.get_seg_offsets();
+        auto distances = result.get_distances();
+        for (int64_t q = 0; q < num_queries_; ++q) {
+            auto heap = heaps_.data() + q * topk_;
+            auto size = heap_sizes_[q];
+            std::sort_heap(heap, heap + size, better);
+            for (int64_t k = 0; k < size; ++k) {
+                seg_offsets[q * topk_ + k] = heap[k].offset;
+                distances[q * topk_ + k] = heap[k].distance;
+            }
+        }
+    }
+
+ private:
+    int64_t num_queries_;
+    int64_t topk_;
+    bool larger_is_better_;
+    std::vector<Hit> heaps_;
+    std::vector<int64_t> heap_sizes_;
+};
+
+}  // namespace milvus::query
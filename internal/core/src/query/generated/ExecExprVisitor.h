@@ -17,6 +17,11 @@
 #include <type_traits>
 #include <utility>
 #include <deque>
+#include <map>
+#include <memory>
+#include <typeindex>
+#include <vector>
+#include "common/QueryProfile.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "query/ExprImpl.h"
 #include "ExprVisitor.h"
@@ -26,6 +31,75 @@ namespace milvus::query {
 void
 AppendOneChunk(BitsetType& result, const FixedVector<bool>& chunk_res);
 
+// assembles the per chunk results of an expression into one bitset while
+// they are produced, the bitset is reserved for all the rows and the chunks
+// are evaluated into one scratch buffer, so no chunk allocates
+class ChunkResultAssembler {
+ public:
+    explicit ChunkResultAssembler(int64_t row_count) {
+        result_.reserve(row_count);
+    }
+
+    // cleared buffer of `size` rows for the next chunk, valid until the next
+    // call to scratch
+    FixedVector<bool>&
+    scratch(int64_t size) {
+        scratch_.assign(size, false);
+        return scratch_;
+    }
+
+    void
+    append(const FixedVector<bool>& chunk_res) {
+        AppendOneChunk(result_, chunk_res);
+    }
+
+    // a chunk whose rows are all `value`
+    void
+    append(int64_t size, bool value) {
+        result_.resize(result_.size() + size, value);
+    }
+
+    BitsetType
+    finish() {
+        return std::move(result_);
+    }
+
+ private:
+    BitsetType result_;
+    FixedVector<bool> scratch_;
+};
+
+// The raw chunks of a field, resolved on their first access through the
+// virtual chunk_data and kept as plain pointers, so the scans of all the
+// leaves reading the field index a base pointer per chunk; a sealed field
+// is a single chunk. Not thread safe, resolved on the evaluating thread
+// before the morsels run.
+template <typename T>
+class ColumnAccessor {
+ public:
+    ColumnAccessor(const segcore::SegmentInternalInterface& segment,
+                   FieldId field_id)
+        : segment_(segment), field_id_(field_id) {
+    }
+
+    const T*
+    chunk(int64_t chunk_id) {
+        if (chunk_id >= int64_t(chunks_.size())) {
+            chunks_.resize(chunk_id + 1, nullptr);
+        }
+        auto& data = chunks_[chunk_id];
+        if (data == nullptr) {
+            data = segment_.chunk_data<T>(field_id_, chunk_id).data();
+        }
+        return data;
+    }
+
+ private:
+    const segcore::SegmentInternalInterface& segment_;
+    FieldId field_id_;
+    std::vector<const T*> chunks_;
+};
+
 class ExecExprVisitor : public ExprVisitor {
  public:
     void
@@ -62,6 +136,9 @@ class ExecExprVisitor : public ExprVisitor {
     BitsetType
     call_child(Expr& expr) {
         Assert(!bitset_opt_.has_value());
+        if (profile_ != nullptr) {
+            return ProfileChild(expr);
+        }
         expr.accept(*this);
         Assert(bitset_opt_.has_value());
         auto res = std::move(bitset_opt_);
@@ -69,12 +146,55 @@ class ExecExprVisitor : public ExprVisitor {
         return std::move(res.value());
     }
 
+    // evaluates `expr` only on the rows set in `candidates`, the results of
+    // the other rows are unspecified
+    BitsetType
+    call_child(Expr& expr, const BitsetType* candidates) {
+        auto saved_candidates = candidates_;
+        candidates_ = candidates;
+        auto res = call_child(expr);
+        candidates_ = saved_candidates;
+        return res;
+    }
+
+    // append an ExprProfile of every node evaluated to `profile->exprs`
+    void
+    set_profile(QueryProfile* profile) {
+        profile_ = profile;
+    }
+
  public:
-    template <typename T, typename IndexFunc, typename ElementFunc>
+    // `zone_func(const ZoneMapOf<T>&) -> ZoneMatch` decides the chunks
+    // whose min/max show that none or all of their rows match
+    template <typename T,
+              typename IndexFunc,
+              typename ElementFunc,
+              typename ZoneFunc = std::nullptr_t>
     auto
     ExecRangeVisitorImpl(FieldId field_id,
                          IndexFunc func,
-                         ElementFunc element_func) -> BitsetType;
+                         ElementFunc element_func,
+                         ZoneFunc zone_func = nullptr) -> BitsetType;
+
+    // Evaluates raw data chunks with a kernel which writes packed bits,
+    // `kernel_func(const T* data, int64_t size, uint64_t* dst)`, index
+    // chunks with an `index_func` which returns a BitsetType.
+    template <typename T,
+              typename IndexFunc,
+              typename KernelFunc,
+              typename ZoneFunc = std::nullptr_t>
+    auto
+    ExecRangeVisitorImplPacked(FieldId field_id,
+                               IndexFunc index_func,
+                               KernelFunc kernel_func,
+                               ZoneFunc zone_func = nullptr) -> BitsetType;
+
+    // the rows within a range of a field the segment is sorted by, a run
+    // found by binary search between the rows `below(x)` the range and the
+    // rows `above(x)` it; nullopt if the segment isn't sorted by the field
+    template <typename T, typename BelowFunc, typename AboveFunc>
+    std::optional<BitsetType>
+    ExecSortedRangeImpl(FieldId field_id, BelowFunc below, AboveFunc above);
 
     template <typename T, typename IndexFunc, typename ElementFunc>
     auto
@@ -82,6 +202,23 @@ class ExecExprVisitor : public ExprVisitor {
                              IndexFunc index_func,
                              ElementFunc element_func) -> BitsetType;
 
+    template <typename RowFunc>
+    auto
+    ExecJsonKeyIndexImpl(const index::JsonKeyIndex& key_index,
+                         RowFunc row_func) -> BitsetType;
+
+    // a chain of && or || over comparisons of the pointers of one json
+    // field, each row parsed once for all of them; nullopt for other exprs
+    std::optional<BitsetType>
+    ExecJsonPredicates(LogicalBinaryExpr& expr);
+
+    template <typename GetType, typename CmpFunc>
+    auto
+    ExecJsonRangeVisitorImpl(FieldId field_id,
+                             const std::string& pointer,
+                             CmpFunc cmp,
+                             bool missing) -> BitsetType;
+
     template <typename T>
     auto
     ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw) -> BitsetType;
@@ -147,11 +284,52 @@ class ExecExprVisitor : public ExprVisitor {
                         const DataType& right_field_type,
                         CmpFunc cmp_func);
 
+    // the rows whose partition key is one of `keys`, answered from the
+    // partition key stats of the segment, nullopt if they can't tell
+    std::optional<BitsetType>
+    ExecPartitionKeyFilter(FieldId field_id, const std::vector<PkType>& keys);
+
+    // the accessor of the chunks of `field_id` as T, shared by the
+    // expressions of this evaluation
+    template <typename T>
+    ColumnAccessor<T>&
+    column_accessor(FieldId field_id);
+
+ private:
+    BitsetType
+    ProfileChild(Expr& expr);
+
+    // account the rows of a chunk evaluated, or chunks decided without
+    // looking at their rows, to the node being profiled
+    void
+    ProfileScanned(int64_t rows) {
+        if (profile_ != nullptr && profile_expr_ >= 0) {
+            profile_->exprs[profile_expr_].rows_scanned += rows;
+        }
+    }
+
+    void
+    ProfileSkipped(int64_t chunks = 1) {
+        if (profile_ != nullptr && profile_expr_ >= 0) {
+            profile_->exprs[profile_expr_].chunks_skipped += chunks;
+        }
+    }
+
  private:
     const segcore::SegmentInternalInterface& segment_;
     Timestamp timestamp_;
     int64_t row_count_;
 
     BitsetTypeOpt bitset_opt_;
+    // rows whose results are still needed, nullptr for all rows
+    const BitsetType* candidates_ = nullptr;
+
+    std::map<std::pair<int64_t, std::type_index>, std::shared_ptr<void>>
+        column_accessors_;
+
+    QueryProfile* profile_ = nullptr;
+    // index in profile_->exprs of the node being evaluated
+    int64_t profile_expr_ = -1;
+    int64_t profile_depth_ = 0;
 };
 }  // namespace milvus::query
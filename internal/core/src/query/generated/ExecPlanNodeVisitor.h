@@ -33,15 +33,18 @@ class ExecPlanNodeVisitor : public PlanNodeVisitor {
  public:
     ExecPlanNodeVisitor(const segcore::SegmentInterface& segment,
                         Timestamp timestamp,
-                        const PlaceholderGroup* placeholder_group)
+                        const PlaceholderGroup* placeholder_group,
+                        const segcore::SegmentSnapshot* snapshot = nullptr)
         : segment_(segment),
           timestamp_(timestamp),
-          placeholder_group_(placeholder_group) {
+          placeholder_group_(placeholder_group),
+          snapshot_(snapshot) {
     }
 
     ExecPlanNodeVisitor(const segcore::SegmentInterface& segment,
-                        Timestamp timestamp)
-        : segment_(segment), timestamp_(timestamp) {
+                        Timestamp timestamp,
+                        const segcore::SegmentSnapshot* snapshot = nullptr)
+        : segment_(segment), timestamp_(timestamp), snapshot_(snapshot) {
         placeholder_group_ = nullptr;
     }
 
@@ -56,6 +59,20 @@ class ExecPlanNodeVisitor : public PlanNodeVisitor {
         return ret;
     }
 
+    // the rows of the segment the search of `node` leaves out, those not
+    // matching its predicate or not visible at timestamp_
+    BitsetType
+    ExcludedRows(VectorPlanNode& node,
+                 int64_t active_count,
+                 QueryProfile* profile);
+
+    // the searches skip their predicate and masks and leave out `excluded`
+    // instead, computed once for the searches of several vector fields
+    void
+    set_excluded_rows(const BitsetType* excluded) {
+        excluded_ = excluded;
+    }
+
     RetrieveResult
     get_retrieve_result(PlanNode& node) {
         assert(!retrieve_result_opt_.has_value());
@@ -77,6 +94,9 @@ class ExecPlanNodeVisitor : public PlanNodeVisitor {
     const segcore::SegmentInterface& segment_;
     Timestamp timestamp_;
     const PlaceholderGroup* placeholder_group_;
+    // the rows visible at timestamp_, masked by the visitor if nullptr
+    const segcore::SegmentSnapshot* snapshot_;
+    const BitsetType* excluded_ = nullptr;
 
     SearchResultOpt search_result_opt_;
     RetrieveResultOpt retrieve_result_opt_;
@@ -11,27 +11,46 @@
 
 #include "query/generated/ExecExprVisitor.h"
 
+#include <boost/core/demangle.hpp>
 #include <boost/variant.hpp>
 #include <boost/utility/binary.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <ctime>
 #include <deque>
+#include <functional>
+#include <limits>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <typeinfo>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "arrow/type_fwd.h"
+#include "boost_ext/dynamic_bitset_ext.hpp"
+#include "common/BitsetOps.h"
+#include "common/Cancellation.h"
 #include "common/Json.h"
+#include "common/LikePattern.h"
 #include "common/Types.h"
+#include "common/ZoneMap.h"
 #include "exceptions/EasyAssert.h"
 #include "pb/plan.pb.h"
+#include "query/ArithRange.h"
+#include "query/ExprCost.h"
 #include "query/ExprImpl.h"
 #include "query/Relational.h"
+#include "query/TermProbe.h"
 #include "query/Utils.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/SegmentGrowingImpl.h"
+#include "simd/hook.h"
 #include "simdjson/error.h"
+#include "storage/ThreadPool.h"
 #include "query/PlanProto.h"
 namespace milvus::query {
 // THIS CONTAINS EXTRA BODY FOR VISITOR
@@ -57,12 +76,37 @@ class ExecExprVisitor : ExprVisitor {
         return std::move(res.value());
     }
 
+    // evaluates `expr` only on the rows set in `candidates`, the results of
+    // the other rows are unspecified
+    BitsetType
+    call_child(Expr& expr, const BitsetType* candidates) {
+        auto saved_candidates = candidates_;
+        candidates_ = candidates;
+        auto res = call_child(expr);
+        candidates_ = saved_candidates;
+        return res;
+    }
+
  public:
-    template <typename T, typename IndexFunc, typename ElementFunc>
+    template <typename T,
+              typename IndexFunc,
+              typename ElementFunc,
+              typename ZoneFunc = std::nullptr_t>
     auto
     ExecRangeVisitorImpl(FieldId field_id,
                          IndexFunc func,
-                         ElementFunc element_func) -> BitsetType;
+                         ElementFunc element_func,
+                         ZoneFunc zone_func = nullptr) -> BitsetType;
+
+    template <typename T,
+              typename IndexFunc,
+              typename KernelFunc,
+              typename ZoneFunc = std::nullptr_t>
+    auto
+    ExecRangeVisitorImplPacked(FieldId field_id,
+                               IndexFunc index_func,
+                               KernelFunc kernel_func,
+                               ZoneFunc zone_func = nullptr) -> BitsetType;
 
     template <typename T>
     auto
@@ -95,9 +139,58 @@ class ExecExprVisitor : ExprVisitor {
     int64_t row_count_;
     Timestamp timestamp_;
     BitsetTypeOpt bitset_opt_;
+    // rows whose results are still needed, nullptr for all rows
+    const BitsetType* candidates_ = nullptr;
 };
 }  // namespace impl
 
+template <typename T>
+ColumnAccessor<T>&
+ExecExprVisitor::column_accessor(FieldId field_id) {
+    auto& accessor =
+        column_accessors_[{field_id.get(), std::type_index(typeid(T))}];
+    if (accessor == nullptr) {
+        accessor = std::make_shared<ColumnAccessor<T>>(segment_, field_id);
+    }
+    return *static_cast<ColumnAccessor<T>*>(accessor.get());
+}
+
+BitsetType
+ExecExprVisitor::ProfileChild(Expr& expr) {
+    auto index = static_cast<int64_t>(profile_->exprs.size());
+    auto& name = profile_->exprs.emplace_back().expr;
+    name = boost::core::demangle(typeid(expr).name());
+    if (auto pos = name.rfind("::", name.find('<')); pos != std::string::npos) {
+        name = name.substr(pos + 2);
+    }
+    profile_->exprs[index].depth = profile_depth_;
+
+    auto saved_expr = profile_expr_;
+    profile_expr_ = index;
+    ++profile_depth_;
+    auto begin = std::chrono::steady_clock::now();
+    expr.accept(*this);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+    --profile_depth_;
+    profile_expr_ = saved_expr;
+
+    AssertInfo(bitset_opt_.has_value(),
+               "[ExecExprVisitor]Bitset doesn't have value after accept");
+    auto res = std::move(bitset_opt_.value());
+    bitset_opt_ = std::nullopt;
+    auto& profile = profile_->exprs[index];
+    profile.elapsed_ns = elapsed;
+    profile.rows_matched = BitsetCount(res);
+    // the evaluators which don't account their chunks scan every row
+    auto is_leaf = index + 1 == static_cast<int64_t>(profile_->exprs.size());
+    if (is_leaf && profile.rows_scanned == 0 && profile.chunks_skipped == 0) {
+        profile.rows_scanned = row_count_;
+    }
+    return res;
+}
+
 void
 ExecExprVisitor::visit(LogicalUnaryExpr& expr) {
     using OpType = LogicalUnaryExpr::OpType;
@@ -120,18 +213,69 @@ ExecExprVisitor::visit(LogicalUnaryExpr& expr) {
 void
 ExecExprVisitor::visit(LogicalBinaryExpr& expr) {
     using OpType = LogicalBinaryExpr::OpType;
-    auto left = call_child(*expr.left_);
-    auto right = call_child(*expr.right_);
+    // comparisons of several pointers of one json field share the parse of
+    // every row
+    if (auto res = ExecJsonPredicates(expr)) {
+        bitset_opt_ = std::move(res);
+        return;
+    }
+    auto op = expr.op_type_;
+    auto pipeline =
+        segcore::SegcoreConfig::default_config().get_enable_expr_pipeline();
+    auto first = expr.left_.get();
+    auto second = expr.right_.get();
+    if (pipeline && (op == OpType::LogicalAnd || op == OpType::LogicalOr)) {
+        // the child which leaves the second one the fewest rows for its cost
+        // runs first
+        auto first_cost = EstimateExprCost(*first, segment_, row_count_);
+        auto second_cost = EstimateExprCost(*second, segment_, row_count_);
+        if (PipelineCost(op, second_cost, first_cost) <
+            PipelineCost(op, first_cost, second_cost)) {
+            std::swap(first, second);
+        }
+    }
+
+    auto left = call_child(*first, candidates_);
+    // the second child is only evaluated on the rows whose result it can
+    // still change
+    std::optional<BitsetType> right_candidates;
+    if (pipeline) {
+        switch (op) {
+            case OpType::LogicalAnd:
+            case OpType::LogicalMinus:
+                right_candidates = left;
+                break;
+            case OpType::LogicalOr:
+                right_candidates = ~left;
+                break;
+            default:
+                break;
+        }
+    }
+    if (right_candidates.has_value()) {
+        if (candidates_ != nullptr) {
+            BitsetAnd(*right_candidates, *candidates_);
+        }
+        if (right_candidates->none()) {
+            // no row the second child could change
+            bitset_opt_ = std::move(left);
+            return;
+        }
+    }
+    auto right = call_child(*second,
+                            right_candidates.has_value()
+                                ? &right_candidates.value()
+                                : candidates_);
     AssertInfo(left.size() == right.size(),
                "[ExecExprVisitor]Left size not equal to right size");
     auto res = std::move(left);
-    switch (expr.op_type_) {
+    switch (op) {
         case OpType::LogicalAnd: {
-            res &= right;
+            BitsetAnd(res, right);
             break;
         }
         case OpType::LogicalOr: {
-            res |= right;
+            BitsetOr(res, right);
             break;
         }
         case OpType::LogicalXor: {
@@ -139,7 +283,7 @@ ExecExprVisitor::visit(LogicalBinaryExpr& expr) {
             break;
         }
         case OpType::LogicalMinus: {
-            res -= right;
+            BitsetAndNot(res, right);
             break;
         }
         default: {
@@ -229,33 +373,172 @@ AppendOneChunk(BitsetType& result, const FixedVector<bool>& chunk_res) {
     return;
 }
 
-BitsetType
-AssembleChunk(const std::vector<FixedVector<bool>>& results) {
-    BitsetType assemble_result;
-    for (auto& result : results) {
-        AppendOneChunk(assemble_result, result);
+// first candidate in [begin, end), end if there is none
+static int64_t
+NextCandidate(const BitsetType& candidates, int64_t begin, int64_t end) {
+    return std::min(BitsetFindNext(candidates, begin), end);
+}
+
+// whether any row in [begin, end) still needs its result
+static bool
+HasCandidate(const BitsetType* candidates, int64_t begin, int64_t end) {
+    return candidates == nullptr ||
+           NextCandidate(*candidates, begin, end) < end;
+}
+
+// calls `func` with each offset in [begin, end) that still needs its result
+template <typename Func>
+static void
+ForEachCandidate(const BitsetType* candidates,
+                 int64_t begin,
+                 int64_t end,
+                 Func func) {
+    if (candidates == nullptr) {
+        for (auto offset = begin; offset < end; ++offset) {
+            func(offset);
+        }
+        return;
+    }
+    for (auto offset = NextCandidate(*candidates, begin, end); offset < end;
+         offset = NextCandidate(*candidates, offset + 1, end)) {
+        func(offset);
     }
-    return assemble_result;
 }
 
-template <typename T, typename IndexFunc, typename ElementFunc>
+// calls func(begin, end) over the rows [0, size) of a chunk, in morsels of
+// expr_morsel_rows rows run on up to expr_parallelism threads. The morsels
+// are a whole number of words, so each writes its own words of a packed
+// result
+template <typename Func>
+static void
+ForEachMorsel(int64_t size, Func func) {
+    auto& config = segcore::SegcoreConfig::default_config();
+    int64_t word_bits = simd::BITS_PER_WORD;
+    auto morsel_rows =
+        std::max<int64_t>(config.get_expr_morsel_rows() / word_bits, 1) *
+        word_bits;
+    auto num_morsels = upper_div(size, morsel_rows);
+    auto parallelism = std::min(config.get_expr_parallelism(), num_morsels);
+    if (parallelism <= 1) {
+        func(int64_t(0), size);
+        return;
+    }
+    ThreadPool::GetInstance().ParallelFor(
+        num_morsels, parallelism - 1, [&](int64_t morsel) {
+            CheckCancelled();
+            auto begin = morsel * morsel_rows;
+            func(begin, std::min(begin + morsel_rows, size));
+        });
+}
+
+// the results of row_func(offset) for the candidate rows of [0, size)
+// packed straight into the words of the bitset, for the contiguous rows of
+// a single chunk, e.g. a sealed column or its mmap, so no bool vector is
+// filled and assembled. The other rows are left unset. Each morsel writes
+// its own words unless `serial`
+template <typename RowFunc>
+static BitsetType
+PackRows(const BitsetType* candidates,
+         int64_t size,
+         bool serial,
+         RowFunc row_func) {
+    static_assert(sizeof(BitSetBlockType) == sizeof(uint64_t));
+    BitsetType result(size);
+    if (size == 0) {
+        return result;
+    }
+    auto words = reinterpret_cast<uint64_t*>(boost_ext::get_data(result));
+    auto pack = [&](int64_t begin, int64_t end) {
+        int64_t word_bits = simd::BITS_PER_WORD;
+        for (auto base = begin; base < end; base += word_bits) {
+            uint64_t word = 0;
+            ForEachCandidate(candidates,
+                             base,
+                             std::min(base + word_bits, end),
+                             [&](int64_t offset) {
+                                 word |= uint64_t(bool(row_func(offset)))
+                                         << (offset - base);
+                             });
+            words[base / word_bits] = word;
+        }
+    };
+    if (serial) {
+        pack(0, size);
+    } else {
+        ForEachMorsel(size, pack);
+    }
+    return result;
+}
+
+// chunks [0, IndexedChunks) are looked up in their chunk index; a growing
+// segment only indexes full chunks, whose rows an older query may not see
+static int64_t
+IndexedChunks(const segcore::SegmentInternalInterface& segment,
+              FieldId field_id,
+              int64_t row_count) {
+    auto indexed = segment.num_chunk_index(field_id);
+    auto size_per_chunk = segment.size_per_chunk();
+    if (indexed == 0 || size_per_chunk == 0) {
+        return indexed;
+    }
+    return std::min(indexed, row_count / size_per_chunk);
+}
+
+// matches a chunk against its zone map, Some if it can't be decided
+template <typename T, typename ZoneFunc>
+static ZoneMatch
+MatchChunkZone(const segcore::SegmentInternalInterface& segment,
+               FieldId field_id,
+               int64_t chunk_id,
+               ZoneFunc& zone_func) {
+    if constexpr (std::is_same_v<ZoneFunc, std::nullptr_t> ||
+                  !IsZoneMapSupported<T>) {
+        return ZoneMatch::Some;
+    } else {
+        auto zone_map = segment.chunk_zone_map<T>(field_id, chunk_id);
+        if (!zone_map.has_value()) {
+            return ZoneMatch::Some;
+        }
+        return zone_func(zone_map.value());
+    }
+}
+
+template <typename T,
+          typename IndexFunc,
+          typename ElementFunc,
+          typename ZoneFunc>
 auto
 ExecExprVisitor::ExecRangeVisitorImpl(FieldId field_id,
                                       IndexFunc index_func,
-                                      ElementFunc element_func) -> BitsetType {
+                                      ElementFunc element_func,
+                                      ZoneFunc zone_func) -> BitsetType {
     auto& schema = segment_.get_schema();
     auto& field_meta = schema[field_id];
-    auto indexing_barrier = segment_.num_chunk_index(field_id);
+    auto indexing_barrier = IndexedChunks(segment_, field_id, row_count_);
     auto size_per_chunk = segment_.size_per_chunk();
     auto num_chunk = upper_div(row_count_, size_per_chunk);
-    std::vector<FixedVector<bool>> results;
-    results.reserve(num_chunk);
+    ChunkResultAssembler results(row_count_);
 
     typedef std::
         conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
             IndexInnerType;
     using Index = index::ScalarIndex<IndexInnerType>;
     for (auto chunk_id = 0; chunk_id < indexing_barrier; ++chunk_id) {
+        CheckCancelled();
+        auto chunk_begin = chunk_id * size_per_chunk;
+        if (!HasCandidate(
+                candidates_, chunk_begin, chunk_begin + size_per_chunk)) {
+            results.append(size_per_chunk, false);
+            ProfileSkipped();
+            continue;
+        }
+        auto match = MatchChunkZone<T>(segment_, field_id, chunk_id, zone_func);
+        if (match != ZoneMatch::Some) {
+            results.append(size_per_chunk, match == ZoneMatch::All);
+            ProfileSkipped();
+            continue;
+        }
+        ProfileScanned(size_per_chunk);
         const Index& indexing =
             segment_.chunk_scalar_index<IndexInnerType>(field_id, chunk_id);
         // NOTE: knowhere is not const-ready
@@ -263,27 +546,254 @@ ExecExprVisitor::ExecRangeVisitorImpl(FieldId field_id,
         auto data = index_func(const_cast<Index*>(&indexing));
         AssertInfo(data.size() == size_per_chunk,
                    "[ExecExprVisitor]Data size not equal to size_per_chunk");
-        results.emplace_back(std::move(data));
+        results.append(data);
     }
     for (auto chunk_id = indexing_barrier; chunk_id < num_chunk; ++chunk_id) {
+        CheckCancelled();
         auto this_size = chunk_id == num_chunk - 1
                              ? row_count_ - chunk_id * size_per_chunk
                              : size_per_chunk;
-        FixedVector<bool> chunk_res(this_size);
-        auto chunk = segment_.chunk_data<T>(field_id, chunk_id);
-        const T* data = chunk.data();
-        // Can use CPU SIMD optimazation to speed up
-        for (int index = 0; index < this_size; ++index) {
-            chunk_res[index] = element_func(data[index]);
+        auto chunk_begin = chunk_id * size_per_chunk;
+        if (!HasCandidate(candidates_, chunk_begin, chunk_begin + this_size)) {
+            results.append(this_size, false);
+            ProfileSkipped();
+            continue;
+        }
+        auto match = MatchChunkZone<T>(segment_, field_id, chunk_id, zone_func);
+        if (match != ZoneMatch::Some) {
+            results.append(this_size, match == ZoneMatch::All);
+            ProfileSkipped();
+            continue;
+        }
+        ProfileScanned(this_size);
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            // evaluate once per distinct value, the rows look up their code
+            if (auto dictionary =
+                    segment_.chunk_string_dictionary(field_id, chunk_id)) {
+                auto& chunk_res = results.scratch(this_size);
+                auto& values = dictionary->values();
+                std::vector<uint8_t> matched(values.size());
+                for (size_t code = 0; code < values.size(); ++code) {
+                    matched[code] = element_func(std::string_view(values[code]));
+                }
+                auto codes = dictionary->codes();
+                ForEachCandidate(candidates_,
+                                 chunk_begin,
+                                 chunk_begin + this_size,
+                                 [&](int64_t offset) {
+                                     auto index = offset - chunk_begin;
+                                     chunk_res[index] = matched[codes[index]];
+                                 });
+                results.append(chunk_res);
+                continue;
+            }
+        }
+        const T* data = column_accessor<T>(field_id).chunk(chunk_id);
+        if (num_chunk == 1) {
+            constexpr bool serial = std::is_same_v<T, milvus::Json>;
+            return PackRows(candidates_, row_count_, serial, [&](int64_t i) {
+                return element_func(data[i]);
+            });
+        }
+        auto& chunk_res = results.scratch(this_size);
+        auto eval = [&](int64_t begin, int64_t end) {
+            ForEachCandidate(candidates_,
+                             chunk_begin + begin,
+                             chunk_begin + end,
+                             [&](int64_t offset) {
+                                 auto index = offset - chunk_begin;
+                                 chunk_res[index] = element_func(data[index]);
+                             });
+        };
+        // json rows are parsed on the calling thread only
+        if constexpr (std::is_same_v<T, milvus::Json>) {
+            eval(0, this_size);
+        } else {
+            ForEachMorsel(this_size, eval);
         }
-        results.emplace_back(std::move(chunk_res));
+        results.append(chunk_res);
     }
-    auto final_result = AssembleChunk(results);
+    auto final_result = results.finish();
     AssertInfo(final_result.size() == row_count_,
                "[ExecExprVisitor]Final result size not equal to row count");
     return final_result;
 }
 
+// types which have dedicated comparison kernels in simd/hook.h
+template <typename T>
+constexpr bool IsSimdKernelType =
+    std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+static std::optional<simd::CompareType>
+ToSimdCompareType(OpType op) {
+    switch (op) {
+        case OpType::Equal:
+            return simd::CompareType::EQ;
+        case OpType::NotEqual:
+            return simd::CompareType::NE;
+        case OpType::GreaterThan:
+            return simd::CompareType::GT;
+        case OpType::GreaterEqual:
+            return simd::CompareType::GE;
+        case OpType::LessThan:
+            return simd::CompareType::LT;
+        case OpType::LessEqual:
+            return simd::CompareType::LE;
+        default:
+            return std::nullopt;
+    }
+}
+
+// OR `size` packed bits of `src` into `dst`, starting at bit `offset`.
+static void
+OrPackedBits(uint64_t* dst,
+             int64_t offset,
+             const uint64_t* src,
+             int64_t size) {
+    auto shift = offset % simd::BITS_PER_WORD;
+    dst += offset / simd::BITS_PER_WORD;
+    auto n_src_words = simd::WordCount(size);
+    auto n_dst_words = simd::WordCount(shift + size);
+    for (size_t i = 0; i < n_src_words; ++i) {
+        dst[i] |= src[i] << shift;
+        if (shift != 0 && i + 1 < n_dst_words) {
+            dst[i + 1] |= src[i] >> (simd::BITS_PER_WORD - shift);
+        }
+    }
+}
+
+// set the first `size` bits of `dst`, leaving the rest of the last word zero
+static void
+SetPackedBits(uint64_t* dst, int64_t size) {
+    auto n_full_words = size / simd::BITS_PER_WORD;
+    std::fill_n(dst, n_full_words, ~uint64_t(0));
+    if (auto tail = size % simd::BITS_PER_WORD; tail != 0) {
+        dst[n_full_words] = (uint64_t(1) << tail) - 1;
+    }
+}
+
+template <typename T,
+          typename IndexFunc,
+          typename KernelFunc,
+          typename ZoneFunc>
+auto
+ExecExprVisitor::ExecRangeVisitorImplPacked(FieldId field_id,
+                                            IndexFunc index_func,
+                                            KernelFunc kernel_func,
+                                            ZoneFunc zone_func)
+    -> BitsetType {
+    static_assert(sizeof(BitSetBlockType) == sizeof(uint64_t));
+    auto indexing_barrier = IndexedChunks(segment_, field_id, row_count_);
+    auto size_per_chunk = segment_.size_per_chunk();
+    auto num_chunk = upper_div(row_count_, size_per_chunk);
+    BitsetType final_result(row_count_);
+    if (row_count_ == 0) {
+        return final_result;
+    }
+
+    // chunks are written at their final offset, straight into the blocks of
+    // the result when the offset is word aligned
+    auto result_words =
+        reinterpret_cast<uint64_t*>(boost_ext::get_data(final_result));
+    std::vector<uint64_t> buffer;
+    auto write_chunk = [&](int64_t offset, int64_t size, auto&& fill) {
+        if (offset % simd::BITS_PER_WORD == 0) {
+            fill(result_words + offset / simd::BITS_PER_WORD);
+            return;
+        }
+        buffer.assign(simd::WordCount(size), 0);
+        fill(buffer.data());
+        OrPackedBits(result_words, offset, buffer.data(), size);
+    };
+    // chunks whose zone map matches none of the rows are left zero
+    auto write_by_zone = [&](int64_t chunk_id, int64_t size) {
+        auto match = MatchChunkZone<T>(segment_, field_id, chunk_id, zone_func);
+        if (match == ZoneMatch::All) {
+            write_chunk(chunk_id * size_per_chunk, size, [&](uint64_t* dst) {
+                SetPackedBits(dst, size);
+            });
+        }
+        return match != ZoneMatch::Some;
+    };
+
+    typedef std::
+        conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
+            IndexInnerType;
+    using Index = index::ScalarIndex<IndexInnerType>;
+    for (auto chunk_id = 0; chunk_id < indexing_barrier; ++chunk_id) {
+        CheckCancelled();
+        auto chunk_begin = chunk_id * size_per_chunk;
+        if (!HasCandidate(
+                candidates_, chunk_begin, chunk_begin + size_per_chunk) ||
+            write_by_zone(chunk_id, size_per_chunk)) {
+            ProfileSkipped();
+            continue;
+        }
+        ProfileScanned(size_per_chunk);
+        const Index& indexing =
+            segment_.chunk_scalar_index<IndexInnerType>(field_id, chunk_id);
+        // NOTE: knowhere is not const-ready
+        // This is a dirty workaround
+        BitsetType data = index_func(const_cast<Index*>(&indexing));
+        AssertInfo(data.size() == size_per_chunk,
+                   "[ExecExprVisitor]Data size not equal to size_per_chunk");
+        write_chunk(
+            chunk_id * size_per_chunk, data.size(), [&](uint64_t* dst) {
+                memcpy(dst,
+                       boost_ext::get_data(data),
+                       data.num_blocks() * sizeof(uint64_t));
+            });
+    }
+    for (auto chunk_id = indexing_barrier; chunk_id < num_chunk; ++chunk_id) {
+        CheckCancelled();
+        auto this_size = chunk_id == num_chunk - 1
+                             ? row_count_ - chunk_id * size_per_chunk
+                             : size_per_chunk;
+        auto chunk_begin = chunk_id * size_per_chunk;
+        if (!HasCandidate(candidates_, chunk_begin, chunk_begin + this_size) ||
+            write_by_zone(chunk_id, this_size)) {
+            ProfileSkipped();
+            continue;
+        }
+        ProfileScanned(this_size);
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            // the kernel runs once per distinct value, the rows look up
+            // their code
+            if (auto dictionary =
+                    segment_.chunk_string_dictionary(field_id, chunk_id)) {
+                auto& values = dictionary->values();
+                std::vector<std::string_view> views(values.begin(),
+                                                    values.end());
+                std::vector<uint64_t> matched(simd::WordCount(views.size()));
+                kernel_func(views.data(), views.size(), matched.data());
+                auto codes = dictionary->codes();
+                write_chunk(chunk_begin, this_size, [&](uint64_t* dst) {
+                    for (int64_t i = 0; i < this_size; ++i) {
+                        auto code = codes[i];
+                        auto bit = (matched[code / simd::BITS_PER_WORD] >>
+                                    (code % simd::BITS_PER_WORD)) &
+                                   1;
+                        dst[i / simd::BITS_PER_WORD] |=
+                            bit << (i % simd::BITS_PER_WORD);
+                    }
+                });
+                continue;
+            }
+        }
+        const T* data = column_accessor<T>(field_id).chunk(chunk_id);
+        write_chunk(chunk_id * size_per_chunk, this_size, [&](uint64_t* dst) {
+            ForEachMorsel(this_size, [&](int64_t begin, int64_t end) {
+                kernel_func(data + begin,
+                            end - begin,
+                            dst + begin / simd::BITS_PER_WORD);
+            });
+        });
+    }
+    return final_result;
+}
+
 template <typename T, typename IndexFunc, typename ElementFunc>
 auto
 ExecExprVisitor::ExecDataRangeVisitorImpl(FieldId field_id,
@@ -298,27 +808,49 @@ ExecExprVisitor::ExecDataRangeVisitorImpl(FieldId field_id,
     auto data_barrier = segment_.num_chunk_data(field_id);
     AssertInfo(std::max(data_barrier, indexing_barrier) == num_chunk,
                "max(data_barrier, index_barrier) not equal to num_chunk");
-    std::vector<FixedVector<bool>> results;
-    results.reserve(num_chunk);
+    ChunkResultAssembler results(row_count_);
 
     // for growing segment, indexing_barrier will always less than data_barrier
     // so growing segment will always execute expr plan using raw data
     // if sealed segment has loaded raw data on this field, then index_barrier = 0 and data_barrier = 1
     // in this case, sealed segment execute expr plan using raw data
     for (auto chunk_id = 0; chunk_id < data_barrier; ++chunk_id) {
+        CheckCancelled();
         auto this_size = chunk_id == num_chunk - 1
                              ? row_count_ - chunk_id * size_per_chunk
                              : size_per_chunk;
-        FixedVector<bool> result(this_size);
-        auto chunk = segment_.chunk_data<T>(field_id, chunk_id);
-        const T* data = chunk.data();
-        for (int index = 0; index < this_size; ++index) {
-            result[index] = element_func(data[index]);
+        auto chunk_begin = chunk_id * size_per_chunk;
+        if (!HasCandidate(candidates_, chunk_begin, chunk_begin + this_size)) {
+            results.append(this_size, false);
+            continue;
+        }
+        const T* data = column_accessor<T>(field_id).chunk(chunk_id);
+        if (num_chunk == 1) {
+            constexpr bool serial = std::is_same_v<T, milvus::Json>;
+            return PackRows(candidates_, row_count_, serial, [&](int64_t i) {
+                return element_func(data[i]);
+            });
+        }
+        auto& result = results.scratch(this_size);
+        auto eval = [&](int64_t begin, int64_t end) {
+            ForEachCandidate(candidates_,
+                             chunk_begin + begin,
+                             chunk_begin + end,
+                             [&](int64_t offset) {
+                                 auto index = offset - chunk_begin;
+                                 result[index] = element_func(data[index]);
+                             });
+        };
+        // json rows are parsed on the calling thread only
+        if constexpr (std::is_same_v<T, milvus::Json>) {
+            eval(0, this_size);
+        } else {
+            ForEachMorsel(this_size, eval);
         }
         AssertInfo(result.size() == this_size,
                    "[ExecExprVisitor]Chunk result size not equal to "
                    "expected size");
-        results.emplace_back(std::move(result));
+        results.append(result);
     }
 
     // if sealed segment has loaded scalar index for this field, then index_barrier = 1 and data_barrier = 0
@@ -329,22 +861,52 @@ ExecExprVisitor::ExecDataRangeVisitorImpl(FieldId field_id,
     using Index = index::ScalarIndex<IndexInnerType>;
     for (auto chunk_id = data_barrier; chunk_id < indexing_barrier;
          ++chunk_id) {
+        CheckCancelled();
         auto& indexing =
             segment_.chunk_scalar_index<IndexInnerType>(field_id, chunk_id);
         auto this_size = const_cast<Index*>(&indexing)->Count();
-        FixedVector<bool> result(this_size);
-        for (int offset = 0; offset < this_size; ++offset) {
-            result[offset] = index_func(const_cast<Index*>(&indexing), offset);
-        }
-        results.emplace_back(std::move(result));
+        auto& result = results.scratch(this_size);
+        auto chunk_begin = chunk_id * size_per_chunk;
+        ForEachCandidate(candidates_,
+                         chunk_begin,
+                         chunk_begin + this_size,
+                         [&](int64_t offset) {
+                             auto index = offset - chunk_begin;
+                             result[index] = index_func(
+                                 const_cast<Index*>(&indexing), index);
+                         });
+        results.append(result);
     }
 
-    auto final_result = AssembleChunk(results);
+    auto final_result = results.finish();
     AssertInfo(final_result.size() == row_count_,
                "[ExecExprVisitor]Final result size not equal to row count");
     return final_result;
 }
 
+template <typename T, typename BelowFunc, typename AboveFunc>
+std::optional<BitsetType>
+ExecExprVisitor::ExecSortedRangeImpl(FieldId field_id,
+                                     BelowFunc below,
+                                     AboveFunc above) {
+    if (!segment_.is_sorted_by(field_id)) {
+        return std::nullopt;
+    }
+    auto span = segment_.chunk_data<T>(field_id, 0);
+    auto data = span.data();
+    auto end = data + std::min(span.row_count(), row_count_);
+    auto first = std::partition_point(data, end, below);
+    auto last = std::partition_point(
+        first, end, [&](MayConstRef<T> x) { return !above(x); });
+    BitsetType res(row_count_);
+    if (first < last) {
+        res.set(first - data, last - first, true);
+    }
+    // a binary search decides the whole segment
+    ProfileSkipped(upper_div(row_count_, segment_.size_per_chunk()));
+    return res;
+}
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "Simplify"
 template <typename T>
@@ -360,46 +922,143 @@ ExecExprVisitor::ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
     auto op = expr.op_type_;
     auto val = IndexInnerType(expr.value_);
     auto field_id = expr.column_.field_id;
+    auto zone_func = [&](const auto& zone_map) {
+        return zone_map.MatchUnaryRange(op, val);
+    };
+    auto none = [](MayConstRef<T>) { return false; };
+    std::optional<BitsetType> sorted;
+    switch (op) {
+        case OpType::Equal:
+            sorted = ExecSortedRangeImpl<T>(
+                field_id,
+                [&](MayConstRef<T> x) { return x < val; },
+                [&](MayConstRef<T> x) { return val < x; });
+            break;
+        case OpType::GreaterEqual:
+            sorted = ExecSortedRangeImpl<T>(
+                field_id, [&](MayConstRef<T> x) { return x < val; }, none);
+            break;
+        case OpType::GreaterThan:
+            sorted = ExecSortedRangeImpl<T>(
+                field_id, [&](MayConstRef<T> x) { return !(val < x); }, none);
+            break;
+        case OpType::LessEqual:
+            sorted = ExecSortedRangeImpl<T>(
+                field_id, none, [&](MayConstRef<T> x) { return val < x; });
+            break;
+        case OpType::LessThan:
+            sorted = ExecSortedRangeImpl<T>(
+                field_id, none, [&](MayConstRef<T> x) { return !(x < val); });
+            break;
+        default:
+            break;
+    }
+    if (sorted.has_value()) {
+        return std::move(sorted.value());
+    }
+    if constexpr (IsSimdKernelType<T>) {
+        auto cmp_type = ToSimdCompareType(op);
+        if (cmp_type.has_value()) {
+            auto index_func = [&](Index* index) {
+                switch (op) {
+                    case OpType::Equal:
+                        return index->InBits(1, &val);
+                    case OpType::NotEqual:
+                        return index->NotInBits(1, &val);
+                    default:
+                        return index->RangeBits(val, op);
+                }
+            };
+            auto kernel_func = [cmp = cmp_type.value(), val](
+                                   const T* data, int64_t size, uint64_t* dst) {
+                simd::CompareVal(cmp, data, size, val, dst);
+            };
+            return ExecRangeVisitorImplPacked<T>(
+                field_id, index_func, kernel_func, zone_func);
+        }
+    }
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        auto cmp_type = ToSimdCompareType(op);
+        if (cmp_type.has_value() || op == OpType::PrefixMatch) {
+            auto index_func = [&](Index* index) {
+                switch (op) {
+                    case OpType::Equal:
+                        return index->InBits(1, &val);
+                    case OpType::NotEqual:
+                        return index->NotInBits(1, &val);
+                    case OpType::PrefixMatch: {
+                        auto dataset = std::make_unique<Dataset>();
+                        dataset->Set(milvus::index::OPERATOR_TYPE, op);
+                        dataset->Set(milvus::index::PREFIX_VALUE, val);
+                        return index::PackTargetBitmap(
+                            index->Query(std::move(dataset)));
+                    }
+                    default:
+                        return index->RangeBits(val, op);
+                }
+            };
+            // the views of a chunk are compared by their first 16 bytes in
+            // batches rather than one by one
+            auto kernel_func = [&](const std::string_view* data,
+                                   int64_t size,
+                                   uint64_t* dst) {
+                if (op == OpType::PrefixMatch) {
+                    simd::PrefixMatchStrings(data, size, val, dst);
+                } else {
+                    simd::CompareStrings(
+                        cmp_type.value(), data, size, val, dst);
+                }
+            };
+            return ExecRangeVisitorImplPacked<T>(
+                field_id, index_func, kernel_func, zone_func);
+        }
+    }
     switch (op) {
         case OpType::Equal: {
             auto index_func = [&](Index* index) { return index->In(1, &val); };
             auto elem_func = [&](MayConstRef<T> x) { return (x == val); };
-            return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
+            return ExecRangeVisitorImpl<T>(
+                field_id, index_func, elem_func, zone_func);
         }
         case OpType::NotEqual: {
             auto index_func = [&](Index* index) {
                 return index->NotIn(1, &val);
             };
             auto elem_func = [&](MayConstRef<T> x) { return (x != val); };
-            return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
+            return ExecRangeVisitorImpl<T>(
+                field_id, index_func, elem_func, zone_func);
         }
         case OpType::GreaterEqual: {
             auto index_func = [&](Index* index) {
                 return index->Range(val, OpType::GreaterEqual);
             };
             auto elem_func = [&](MayConstRef<T> x) { return (x >= val); };
-            return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
+            return ExecRangeVisitorImpl<T>(
+                field_id, index_func, elem_func, zone_func);
         }
         case OpType::GreaterThan: {
             auto index_func = [&](Index* index) {
                 return index->Range(val, OpType::GreaterThan);
             };
             auto elem_func = [&](MayConstRef<T> x) { return (x > val); };
-            return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
+            return ExecRangeVisitorImpl<T>(
+                field_id, index_func, elem_func, zone_func);
         }
         case OpType::LessEqual: {
             auto index_func = [&](Index* index) {
                 return index->Range(val, OpType::LessEqual);
             };
             auto elem_func = [&](MayConstRef<T> x) { return (x <= val); };
-            return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
+            return ExecRangeVisitorImpl<T>(
+                field_id, index_func, elem_func, zone_func);
         }
         case OpType::LessThan: {
             auto index_func = [&](Index* index) {
                 return index->Range(val, OpType::LessThan);
             };
             auto elem_func = [&](MayConstRef<T> x) { return (x < val); };
-            return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
+            return ExecRangeVisitorImpl<T>(
+                field_id, index_func, elem_func, zone_func);
         }
         case OpType::PrefixMatch: {
             auto index_func = [&](Index* index) {
@@ -413,7 +1072,24 @@ ExecExprVisitor::ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
             };
             return ExecRangeVisitorImpl<T>(field_id, index_func, elem_func);
         }
-        // TODO: PostfixMatch
+        case OpType::PostfixMatch:
+        case OpType::Match: {
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                // an ngram index only tests the strings holding the
+                // trigrams of the pattern
+                LikePattern pattern(op, val);
+                auto index_func = [&](Index* index) {
+                    auto dataset = std::make_unique<Dataset>();
+                    dataset->Set(milvus::index::OPERATOR_TYPE, op);
+                    dataset->Set(milvus::index::PATTERN_VALUE, val);
+                    return index->Query(std::move(dataset));
+                };
+                auto elem_func = [&](MayConstRef<T> x) { return pattern(x); };
+                return ExecRangeVisitorImpl<T>(
+                    field_id, index_func, elem_func);
+            }
+            PanicInfo("unsupported range node");
+        }
         default: {
             PanicInfo("unsupported range node");
         }
@@ -421,98 +1097,310 @@ ExecExprVisitor::ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
 }
 #pragma clang diagnostic pop
 
+namespace {
+
+using JsonValue = value_result<simdjson::ondemand::value>;
+
+// `cmp` of the GetType read from a json value, `missing` if it's absent or
+// has another type; int64 values are compared against the json numbers
+// which aren't integers as doubles
+template <typename GetType, typename CmpFunc>
+auto
+JsonValueTest(CmpFunc cmp, bool missing) {
+    return [cmp, missing](auto& value) {
+        if (value.error()) {
+            return missing;
+        }
+        auto x = value.template get<GetType>();
+        if (x.error()) {
+            if constexpr (std::is_same_v<GetType, int64_t>) {
+                // a failed read doesn't consume the value
+                auto y = value.template get<double>();
+                return y.error() ? missing : bool(cmp(y.value()));
+            }
+            return missing;
+        }
+        return bool(cmp(x.value()));
+    };
+}
+
+// a JsonValueTest of the values parsed from the text of the rows, or read
+// from their BinaryJson encoding
+struct JsonTest {
+    JsonTest() = default;
+
+    template <typename Test>
+    JsonTest(Test test) : text(test), binary(test) {
+    }
+
+    bool
+    operator()(JsonValue& value) const {
+        return text(value);
+    }
+
+    bool
+    operator()(BinaryJson::Value& value) const {
+        return binary(value);
+    }
+
+    std::function<bool(JsonValue&)> text;
+    std::function<bool(BinaryJson::Value&)> binary;
+};
+
+// a comparison of the value at one pointer of a json field, evaluated with
+// the other ones on the same field within a single parse of every row
+struct JsonPredicate {
+    FieldId field_id;
+    std::string pointer;
+    JsonTest test;
+};
+
+template <typename ExprValueType>
+std::optional<JsonPredicate>
+MakeJsonPredicate(const UnaryRangeExpr& expr_raw) {
+    using GetType =
+        std::conditional_t<std::is_same_v<ExprValueType, std::string>,
+                           std::string_view,
+                           ExprValueType>;
+    auto& expr =
+        static_cast<const UnaryRangeExprImpl<ExprValueType>&>(expr_raw);
+    auto val = expr.value_;
+    JsonPredicate pred{expr.column_.field_id,
+                       milvus::Json::pointer(expr.column_.nested_path)};
+    switch (expr.op_type_) {
+        case OpType::Equal:
+            pred.test = JsonValueTest<GetType>(
+                [val](auto value) { return value == val; }, false);
+            break;
+        case OpType::NotEqual:
+            pred.test = JsonValueTest<GetType>(
+                [val](auto value) { return value != val; }, true);
+            break;
+        case OpType::GreaterEqual:
+            pred.test = JsonValueTest<GetType>(
+                [val](auto value) { return value >= val; }, false);
+            break;
+        case OpType::GreaterThan:
+            pred.test = JsonValueTest<GetType>(
+                [val](auto value) { return value > val; }, false);
+            break;
+        case OpType::LessEqual:
+            pred.test = JsonValueTest<GetType>(
+                [val](auto value) { return value <= val; }, false);
+            break;
+        case OpType::LessThan:
+            pred.test = JsonValueTest<GetType>(
+                [val](auto value) { return value < val; }, false);
+            break;
+        default:
+            return std::nullopt;
+    }
+    return pred;
+}
+
+template <typename ExprValueType>
+std::optional<JsonPredicate>
+MakeJsonPredicate(const BinaryRangeExpr& expr_raw) {
+    using GetType =
+        std::conditional_t<std::is_same_v<ExprValueType, std::string>,
+                           std::string_view,
+                           ExprValueType>;
+    auto& expr =
+        static_cast<const BinaryRangeExprImpl<ExprValueType>&>(expr_raw);
+    auto lower = expr.lower_value_;
+    auto upper = expr.upper_value_;
+    auto lower_inclusive = expr.lower_inclusive_;
+    auto upper_inclusive = expr.upper_inclusive_;
+    auto cmp = [=](auto value) {
+        return (lower_inclusive ? lower <= value : lower < value) &&
+               (upper_inclusive ? value <= upper : value < upper);
+    };
+    return JsonPredicate{expr.column_.field_id,
+                         milvus::Json::pointer(expr.column_.nested_path),
+                         JsonValueTest<GetType>(cmp, false)};
+}
+
+template <typename RangeExpr>
+std::optional<JsonPredicate>
+MakeJsonPredicateOf(const RangeExpr& expr) {
+    switch (expr.val_case_) {
+        case proto::plan::GenericValue::ValCase::kBoolVal:
+            return MakeJsonPredicate<bool>(expr);
+        case proto::plan::GenericValue::ValCase::kInt64Val:
+            return MakeJsonPredicate<int64_t>(expr);
+        case proto::plan::GenericValue::ValCase::kFloatVal:
+            return MakeJsonPredicate<double>(expr);
+        case proto::plan::GenericValue::ValCase::kStringVal:
+            return MakeJsonPredicate<std::string>(expr);
+        default:
+            return std::nullopt;
+    }
+}
+
+// appends the comparisons of a chain of `op` to `preds`, false if any leaf
+// of the chain isn't a comparison of a json pointer
+bool
+CollectJsonPredicates(const Expr& expr,
+                      LogicalBinaryExpr::OpType op,
+                      std::vector<JsonPredicate>& preds) {
+    if (auto logical = dynamic_cast<const LogicalBinaryExpr*>(&expr)) {
+        return logical->op_type_ == op &&
+               CollectJsonPredicates(*logical->left_, op, preds) &&
+               CollectJsonPredicates(*logical->right_, op, preds);
+    }
+    std::optional<JsonPredicate> pred;
+    if (auto unary = dynamic_cast<const UnaryRangeExpr*>(&expr)) {
+        if (unary->column_.data_type == DataType::JSON) {
+            pred = MakeJsonPredicateOf(*unary);
+        }
+    } else if (auto binary = dynamic_cast<const BinaryRangeExpr*>(&expr)) {
+        if (binary->column_.data_type == DataType::JSON) {
+            pred = MakeJsonPredicateOf(*binary);
+        }
+    }
+    if (!pred.has_value()) {
+        return false;
+    }
+    preds.push_back(std::move(pred.value()));
+    return true;
+}
+
+}  // namespace
+
+std::optional<BitsetType>
+ExecExprVisitor::ExecJsonPredicates(LogicalBinaryExpr& expr) {
+    using OpType = LogicalBinaryExpr::OpType;
+    auto op = expr.op_type_;
+    std::vector<JsonPredicate> preds;
+    if ((op != OpType::LogicalAnd && op != OpType::LogicalOr) ||
+        !CollectJsonPredicates(expr, op, preds)) {
+        return std::nullopt;
+    }
+    auto field_id = preds[0].field_id;
+    std::vector<std::string> pointers;
+    for (auto& pred : preds) {
+        // a key index answers its pointer without parsing the rows
+        if (pred.field_id != field_id ||
+            segment_.json_key_index(field_id, pred.pointer) != nullptr) {
+            return std::nullopt;
+        }
+        pointers.push_back(pred.pointer);
+    }
+
+    // the comparisons run in order until one decides the row
+    auto decisive = op == OpType::LogicalOr;
+    using Index = index::ScalarIndex<milvus::Json>;
+    auto index_func = [](Index* index) { return TargetBitmap{}; };
+    auto elem_func = [&](const milvus::Json& json) {
+        bool res = !decisive;
+        json.visit_pointers(pointers, [&](size_t i, auto& value) {
+            if (preds[i].test(value) == decisive) {
+                res = decisive;
+                return false;
+            }
+            return true;
+        });
+        return res;
+    };
+    return ExecRangeVisitorImpl<milvus::Json>(field_id, index_func, elem_func);
+}
+
+template <typename RowFunc>
+auto
+ExecExprVisitor::ExecJsonKeyIndexImpl(const index::JsonKeyIndex& key_index,
+                                      RowFunc row_func) -> BitsetType {
+    AssertInfo(key_index.Count() >= row_count_,
+               "[ExecExprVisitor]Json key index doesn't cover all rows");
+    return PackRows(candidates_, row_count_, true, row_func);
+}
+
+template <typename GetType, typename CmpFunc>
+auto
+ExecExprVisitor::ExecJsonRangeVisitorImpl(FieldId field_id,
+                                          const std::string& pointer,
+                                          CmpFunc cmp,
+                                          bool missing) -> BitsetType {
+    // int64 values are compared against the json numbers that aren't
+    // integers as doubles
+    if (auto key_index = segment_.json_key_index(field_id, pointer)) {
+        return ExecJsonKeyIndexImpl(*key_index, [&](int64_t offset) {
+            if constexpr (std::is_same_v<GetType, int64_t>) {
+                if (key_index->kind(offset) ==
+                    index::JsonKeyIndex::ValueKind::Double) {
+                    return key_index->Visit<double>(offset, cmp, missing);
+                }
+            }
+            return key_index->Visit<GetType>(offset, cmp, missing);
+        });
+    }
+
+    using Index = index::ScalarIndex<milvus::Json>;
+    auto index_func = [=](Index* index) { return TargetBitmap{}; };
+    auto test = JsonValueTest<GetType>(cmp, missing);
+    auto elem_func = [&](const milvus::Json& json) {
+        bool res = missing;
+        json.visit_pointers(std::array{std::string_view(pointer)},
+                            [&](size_t, auto& value) {
+                                res = test(value);
+                                return false;
+                            });
+        return res;
+    };
+    return ExecRangeVisitorImpl<milvus::Json>(field_id, index_func, elem_func);
+}
+
 template <typename ExprValueType>
 auto
 ExecExprVisitor::ExecUnaryRangeVisitorDispatcherJson(UnaryRangeExpr& expr_raw)
     -> BitsetType {
-    using Index = index::ScalarIndex<milvus::Json>;
     auto& expr = static_cast<UnaryRangeExprImpl<ExprValueType>&>(expr_raw);
 
     auto op = expr.op_type_;
     auto val = expr.value_;
     auto pointer = milvus::Json::pointer(expr.column_.nested_path);
     auto field_id = expr.column_.field_id;
-    auto index_func = [=](Index* index) { return TargetBitmap{}; };
     using GetType =
         std::conditional_t<std::is_same_v<ExprValueType, std::string>,
                            std::string_view,
                            ExprValueType>;
 
-#define UnaryRangeJSONCompare(cmp)                            \
-    do {                                                      \
-        auto x = json.template at<GetType>(pointer);          \
-        if (x.error()) {                                      \
-            if constexpr (std::is_same_v<GetType, int64_t>) { \
-                auto x = json.template at<double>(pointer);   \
-                return !x.error() && (cmp);                   \
-            }                                                 \
-            return false;                                     \
-        }                                                     \
-        return (cmp);                                         \
-    } while (false)
-
-#define UnaryRangeJSONCompareNotEqual(cmp)                    \
-    do {                                                      \
-        auto x = json.template at<GetType>(pointer);          \
-        if (x.error()) {                                      \
-            if constexpr (std::is_same_v<GetType, int64_t>) { \
-                auto x = json.template at<double>(pointer);   \
-                return x.error() || (cmp);                    \
-            }                                                 \
-            return true;                                      \
-        }                                                     \
-        return (cmp);                                         \
-    } while (false)
-
     switch (op) {
         case OpType::Equal: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompare(x.value() == val);
-            };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            auto cmp = [&](auto value) { return value == val; };
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, false);
         }
         case OpType::NotEqual: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompareNotEqual(x.value() != val);
-            };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            auto cmp = [&](auto value) { return value != val; };
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, true);
         }
         case OpType::GreaterEqual: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompare(x.value() >= val);
-            };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            auto cmp = [&](auto value) { return value >= val; };
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, false);
         }
         case OpType::GreaterThan: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompare(x.value() > val);
-            };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            auto cmp = [&](auto value) { return value > val; };
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, false);
         }
         case OpType::LessEqual: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompare(x.value() <= val);
-            };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            auto cmp = [&](auto value) { return value <= val; };
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, false);
         }
         case OpType::LessThan: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompare(x.value() < val);
-            };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            auto cmp = [&](auto value) { return value < val; };
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, false);
         }
         case OpType::PrefixMatch: {
-            auto elem_func = [&](const milvus::Json& json) {
-                UnaryRangeJSONCompare(Match(ExprValueType(x.value()), val, op));
+            auto cmp = [&](auto value) {
+                return Match(ExprValueType(value), val, op);
             };
-            return ExecRangeVisitorImpl<milvus::Json>(
-                field_id, index_func, elem_func);
+            return ExecJsonRangeVisitorImpl<GetType>(
+                field_id, pointer, cmp, false);
         }
         // TODO: PostfixMatch
         default: {
@@ -521,6 +1409,57 @@ ExecExprVisitor::ExecUnaryRangeVisitorDispatcherJson(UnaryRangeExpr& expr_raw)
     }
 }
 
+// dst = src arith_op operand over a chunk, one loop per operation so the
+// arithmetic of the floating types is vectorized, the integers only come
+// here for mod, which doesn't invert to a range
+template <typename T>
+static void
+ArithChunk(
+    ArithOpType arith_op, const T* src, int64_t size, T operand, T* dst) {
+    switch (arith_op) {
+        case ArithOpType::Add: {
+            for (int64_t i = 0; i < size; ++i) {
+                dst[i] = static_cast<T>(src[i] + operand);
+            }
+            break;
+        }
+        case ArithOpType::Sub: {
+            for (int64_t i = 0; i < size; ++i) {
+                dst[i] = static_cast<T>(src[i] - operand);
+            }
+            break;
+        }
+        case ArithOpType::Mul: {
+            for (int64_t i = 0; i < size; ++i) {
+                dst[i] = static_cast<T>(src[i] * operand);
+            }
+            break;
+        }
+        case ArithOpType::Div: {
+            for (int64_t i = 0; i < size; ++i) {
+                dst[i] = static_cast<T>(src[i] / operand);
+            }
+            break;
+        }
+        case ArithOpType::Mod: {
+            if constexpr (std::is_integral_v<T>) {
+                FastMod mod(operand);
+                for (int64_t i = 0; i < size; ++i) {
+                    dst[i] = static_cast<T>(mod(src[i]));
+                }
+            } else {
+                for (int64_t i = 0; i < size; ++i) {
+                    dst[i] = static_cast<T>(fmod(src[i], operand));
+                }
+            }
+            break;
+        }
+        default: {
+            PanicInfo("unsupported arithmetic operation");
+        }
+    }
+}
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "Simplify"
 template <typename T>
@@ -535,6 +1474,75 @@ ExecExprVisitor::ExecBinaryArithOpEvalRangeVisitorDispatcher(
     auto val = expr.value_;
     auto& nested_path = expr.column_.nested_path;
 
+    if constexpr (IsSimdKernelType<T>) {
+        auto field_id = expr.column_.field_id;
+        auto cmp_type = ToSimdCompareType(op);
+        bool is_equal = op == OpType::Equal || op == OpType::NotEqual;
+        if constexpr (std::is_integral_v<T>) {
+            // `a + 3 == 10` is `a == 7` over the integers, the range of `a`
+            // is answered by the index or the range kernel with no
+            // arithmetic per row
+            auto inverse = is_equal ? InvertArithEqual(
+                                          arith_op,
+                                          right_operand,
+                                          val,
+                                          std::numeric_limits<T>::min(),
+                                          std::numeric_limits<T>::max())
+                                    : std::nullopt;
+            if (inverse.has_value()) {
+                BitsetType result(row_count_);
+                if (!inverse->empty()) {
+                    auto lower = static_cast<T>(inverse->lower);
+                    auto upper = static_cast<T>(inverse->upper);
+                    auto index_func = [=](Index* index) {
+                        return index->RangeBits(lower, true, upper, true);
+                    };
+                    auto kernel_func =
+                        [=](const T* data, int64_t size, uint64_t* dst) {
+                            simd::BetweenVal(
+                                data, size, lower, true, upper, true, dst);
+                        };
+                    auto zone_func = [=](const auto& zone_map) {
+                        return zone_map.MatchBinaryRange(
+                            lower, true, upper, true);
+                    };
+                    result = ExecRangeVisitorImplPacked<T>(
+                        field_id, index_func, kernel_func, zone_func);
+                }
+                if (op == OpType::NotEqual) {
+                    result.flip();
+                }
+                return result;
+            }
+            // mod and zero divisors are left to the row by row path
+            is_equal = is_equal && arith_op == ArithOpType::Mod &&
+                       right_operand != 0;
+        }
+        if (is_equal && cmp_type.has_value()) {
+            // the arithmetic over the whole chunk, then the packed compare
+            std::vector<T> arith_buffer;
+            auto kernel_func = [&](const T* data, int64_t size, uint64_t* dst) {
+                arith_buffer.resize(size);
+                ArithChunk(
+                    arith_op, data, size, right_operand, arith_buffer.data());
+                simd::CompareVal(
+                    cmp_type.value(), arith_buffer.data(), size, val, dst);
+            };
+            auto index_func = [&](Index* index) {
+                std::vector<T> values(index->Count());
+                index->ReverseLookupAll(values.data());
+                BitsetType bits(values.size());
+                kernel_func(
+                    values.data(),
+                    values.size(),
+                    reinterpret_cast<uint64_t*>(boost_ext::get_data(bits)));
+                return bits;
+            };
+            return ExecRangeVisitorImplPacked<T>(
+                field_id, index_func, kernel_func);
+        }
+    }
+
     switch (op) {
         case OpType::Equal: {
             switch (arith_op) {
@@ -887,30 +1895,57 @@ ExecExprVisitor::ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw)
     auto index_func = [&](Index* index) {
         return index->Range(val1, lower_inclusive, val2, upper_inclusive);
     };
+    auto zone_func = [&](const auto& zone_map) {
+        return zone_map.MatchBinaryRange(
+            val1, lower_inclusive, val2, upper_inclusive);
+    };
+    auto sorted = ExecSortedRangeImpl<T>(
+        expr.column_.field_id,
+        [&](MayConstRef<T> x) {
+            return lower_inclusive ? x < val1 : !(val1 < x);
+        },
+        [&](MayConstRef<T> x) {
+            return upper_inclusive ? val2 < x : !(x < val2);
+        });
+    if (sorted.has_value()) {
+        return std::move(sorted.value());
+    }
+    if constexpr (IsSimdKernelType<T>) {
+        auto kernel_func = [=](const T* data, int64_t size, uint64_t* dst) {
+            simd::BetweenVal(
+                data, size, val1, lower_inclusive, val2, upper_inclusive, dst);
+        };
+        auto packed_index_func = [&](Index* index) {
+            return index->RangeBits(
+                val1, lower_inclusive, val2, upper_inclusive);
+        };
+        return ExecRangeVisitorImplPacked<T>(
+            expr.column_.field_id, packed_index_func, kernel_func, zone_func);
+    }
     if (lower_inclusive && upper_inclusive) {
         auto elem_func = [val1, val2](MayConstRef<T> x) {
             return (val1 <= x && x <= val2);
         };
         return ExecRangeVisitorImpl<T>(
-            expr.column_.field_id, index_func, elem_func);
+            expr.column_.field_id, index_func, elem_func, zone_func);
     } else if (lower_inclusive && !upper_inclusive) {
         auto elem_func = [val1, val2](MayConstRef<T> x) {
             return (val1 <= x && x < val2);
         };
         return ExecRangeVisitorImpl<T>(
-            expr.column_.field_id, index_func, elem_func);
+            expr.column_.field_id, index_func, elem_func, zone_func);
     } else if (!lower_inclusive && upper_inclusive) {
         auto elem_func = [val1, val2](MayConstRef<T> x) {
             return (val1 < x && x <= val2);
         };
         return ExecRangeVisitorImpl<T>(
-            expr.column_.field_id, index_func, elem_func);
+            expr.column_.field_id, index_func, elem_func, zone_func);
     } else {
         auto elem_func = [val1, val2](MayConstRef<T> x) {
             return (val1 < x && x < val2);
         };
         return ExecRangeVisitorImpl<T>(
-            expr.column_.field_id, index_func, elem_func);
+            expr.column_.field_id, index_func, elem_func, zone_func);
     }
 }
 #pragma clang diagnostic pop
@@ -919,7 +1954,6 @@ template <typename ExprValueType>
 auto
 ExecExprVisitor::ExecBinaryRangeVisitorDispatcherJson(BinaryRangeExpr& expr_raw)
     -> BitsetType {
-    using Index = index::ScalarIndex<milvus::Json>;
     using GetType =
         std::conditional_t<std::is_same_v<ExprValueType, std::string>,
                            std::string_view,
@@ -932,51 +1966,59 @@ ExecExprVisitor::ExecBinaryRangeVisitorDispatcherJson(BinaryRangeExpr& expr_raw)
     ExprValueType val2 = expr.upper_value_;
     auto pointer = milvus::Json::pointer(expr.column_.nested_path);
 
-    // no json index now
-    auto index_func = [=](Index* index) { return TargetBitmap{}; };
-
-#define BinaryRangeJSONCompare(cmp)                           \
-    do {                                                      \
-        auto x = json.template at<GetType>(pointer);          \
-        if (x.error()) {                                      \
-            if constexpr (std::is_same_v<GetType, int64_t>) { \
-                auto x = json.template at<double>(pointer);   \
-                if (!x.error()) {                             \
-                    auto value = x.value();                   \
-                    return (cmp);                             \
-                }                                             \
-            }                                                 \
-            return false;                                     \
-        }                                                     \
-        auto value = x.value();                               \
-        return (cmp);                                         \
-    } while (false)
+    auto field_id = expr.column_.field_id;
 
     if (lower_inclusive && upper_inclusive) {
-        auto elem_func = [&](const milvus::Json& json) {
-            BinaryRangeJSONCompare(val1 <= value && value <= val2);
-        };
-        return ExecRangeVisitorImpl<milvus::Json>(
-            expr.column_.field_id, index_func, elem_func);
+        auto cmp = [&](auto value) { return val1 <= value && value <= val2; };
+        return ExecJsonRangeVisitorImpl<GetType>(
+            field_id, pointer, cmp, false);
     } else if (lower_inclusive && !upper_inclusive) {
-        auto elem_func = [&](const milvus::Json& json) {
-            BinaryRangeJSONCompare(val1 <= value && value < val2);
-        };
-        return ExecRangeVisitorImpl<milvus::Json>(
-            expr.column_.field_id, index_func, elem_func);
+        auto cmp = [&](auto value) { return val1 <= value && value < val2; };
+        return ExecJsonRangeVisitorImpl<GetType>(
+            field_id, pointer, cmp, false);
     } else if (!lower_inclusive && upper_inclusive) {
-        auto elem_func = [&](const milvus::Json& json) {
-            BinaryRangeJSONCompare(val1 < value && value <= val2);
-        };
-        return ExecRangeVisitorImpl<milvus::Json>(
-            expr.column_.field_id, index_func, elem_func);
+        auto cmp = [&](auto value) { return val1 < value && value <= val2; };
+        return ExecJsonRangeVisitorImpl<GetType>(
+            field_id, pointer, cmp, false);
     } else {
-        auto elem_func = [&](const milvus::Json& json) {
-            BinaryRangeJSONCompare(val1 < value && value < val2);
-        };
-        return ExecRangeVisitorImpl<milvus::Json>(
-            expr.column_.field_id, index_func, elem_func);
+        auto cmp = [&](auto value) { return val1 < value && value < val2; };
+        return ExecJsonRangeVisitorImpl<GetType>(
+            field_id, pointer, cmp, false);
+    }
+}
+
+std::optional<BitsetType>
+ExecExprVisitor::ExecPartitionKeyFilter(FieldId field_id,
+                                        const std::vector<PkType>& keys) {
+    auto stats = segment_.partition_key_stats(field_id);
+    if (stats == nullptr) {
+        return std::nullopt;
     }
+    BitsetType res(row_count_);
+    for (auto& key : keys) {
+        if (!stats->may_contain(key)) {
+            continue;
+        }
+        auto ranges = stats->ranges(key);
+        if (ranges == nullptr) {
+            return std::nullopt;
+        }
+        for (auto [begin, end] : *ranges) {
+            if (begin >= row_count_) {
+                break;
+            }
+            res.set(begin, std::min(end, row_count_) - begin, true);
+        }
+    }
+    // the stats decide the whole segment
+    ProfileSkipped(upper_div(row_count_, segment_.size_per_chunk()));
+    return res;
+}
+
+template <typename T>
+static std::vector<PkType>
+PartitionKeysOf(const std::vector<T>& values) {
+    return std::vector<PkType>(values.begin(), values.end());
 }
 
 void
@@ -984,6 +2026,22 @@ ExecExprVisitor::visit(UnaryRangeExpr& expr) {
     auto& field_meta = segment_.get_schema()[expr.column_.field_id];
     AssertInfo(expr.column_.data_type == field_meta.get_data_type(),
                "[ExecExprVisitor]DataType of expr isn't field_meta data type");
+    if (expr.op_type_ == OpType::Equal) {
+        std::optional<BitsetType> pruned;
+        if (expr.column_.data_type == DataType::INT64) {
+            auto& impl = static_cast<UnaryRangeExprImpl<int64_t>&>(expr);
+            pruned = ExecPartitionKeyFilter(expr.column_.field_id,
+                                            {PkType(impl.value_)});
+        } else if (expr.column_.data_type == DataType::VARCHAR) {
+            auto& impl = static_cast<UnaryRangeExprImpl<std::string>&>(expr);
+            pruned = ExecPartitionKeyFilter(expr.column_.field_id,
+                                            {PkType(impl.value_)});
+        }
+        if (pruned.has_value()) {
+            bitset_opt_ = std::move(pruned);
+            return;
+        }
+    }
     BitsetType res;
     switch (expr.column_.data_type) {
         case DataType::BOOL: {
@@ -1015,11 +2073,7 @@ ExecExprVisitor::visit(UnaryRangeExpr& expr) {
             break;
         }
         case DataType::VARCHAR: {
-            if (segment_.type() == SegmentType::Growing) {
-                res = ExecUnaryRangeVisitorDispatcher<std::string>(expr);
-            } else {
-                res = ExecUnaryRangeVisitorDispatcher<std::string_view>(expr);
-            }
+            res = ExecUnaryRangeVisitorDispatcher<std::string_view>(expr);
             break;
         }
         case DataType::JSON: {
@@ -1154,11 +2208,7 @@ ExecExprVisitor::visit(BinaryRangeExpr& expr) {
             break;
         }
         case DataType::VARCHAR: {
-            if (segment_.type() == SegmentType::Growing) {
-                res = ExecBinaryRangeVisitorDispatcher<std::string>(expr);
-            } else {
-                res = ExecBinaryRangeVisitorDispatcher<std::string_view>(expr);
-            }
+            res = ExecBinaryRangeVisitorDispatcher<std::string_view>(expr);
             break;
         }
         case DataType::JSON: {
@@ -1225,11 +2275,14 @@ ExecExprVisitor::ExecCompareRightType(const T* left_raw_data,
 
     TargetBitmap result(size);
     const U* right_raw_data =
-        segment_.chunk_data<U>(right_field_id, current_chunk_id).data();
+        column_accessor<U>(right_field_id).chunk(current_chunk_id);
 
-    for (int i = 0; i < size; ++i) {
-        result[i] = cmp_func(left_raw_data[i], right_raw_data[i]);
-    }
+    auto chunk_begin = current_chunk_id * size_per_chunk;
+    ForEachCandidate(
+        candidates_, chunk_begin, chunk_begin + size, [&](int64_t offset) {
+            auto i = offset - chunk_begin;
+            result[i] = cmp_func(left_raw_data[i], right_raw_data[i]);
+        });
 
     return result;
 }
@@ -1242,13 +2295,13 @@ ExecExprVisitor::ExecCompareLeftType(const FieldId& left_field_id,
                                      CmpFunc cmp_func) {
     auto size_per_chunk = segment_.size_per_chunk();
     auto num_chunks = upper_div(row_count_, size_per_chunk);
-    std::vector<FixedVector<bool>> results;
-    results.reserve(num_chunks);
+    ChunkResultAssembler results(row_count_);
 
     for (int64_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+        CheckCancelled();
         FixedVector<bool> result;
         const T* left_raw_data =
-            segment_.chunk_data<T>(left_field_id, chunk_id).data();
+            column_accessor<T>(left_field_id).chunk(chunk_id);
 
         switch (right_field_type) {
             case DataType::BOOL:
@@ -1282,9 +2335,9 @@ ExecExprVisitor::ExecCompareLeftType(const FieldId& left_field_id,
             default:
                 PanicInfo("unsupported left datatype of compare expr");
         }
-        results.push_back(result);
+        results.append(result);
     }
-    auto final_result = AssembleChunk(results);
+    auto final_result = results.finish();
     AssertInfo(final_result.size() == row_count_,
                "[ExecExprVisitor]Size of results not equal row count");
     return final_result;
@@ -1335,6 +2388,160 @@ ExecExprVisitor::ExecCompareExprDispatcherForNonIndexedSegment(
     }
 }
 
+// values of a chunk, decoded in bulk into `buffer` when the segment only
+// keeps the scalar index of the field
+template <typename T>
+static const T*
+ChunkValues(const segcore::SegmentInternalInterface& segment,
+            FieldId field_id,
+            int64_t chunk_id,
+            std::vector<T>& buffer) {
+    if (chunk_id < segment.num_chunk_data(field_id)) {
+        return segment.chunk_data<T>(field_id, chunk_id).data();
+    }
+    using Index = index::ScalarIndex<T>;
+    const Index& indexing = segment.chunk_scalar_index<T>(field_id, chunk_id);
+    // NOTE: knowhere is not const-ready
+    auto index = const_cast<Index*>(&indexing);
+    buffer.resize(index->Count());
+    index->ReverseLookupAll(buffer.data());
+    return buffer.data();
+}
+
+template <typename To, typename From>
+static const To*
+WidenValues(const From* values, int64_t size, std::vector<To>& buffer) {
+    if constexpr (std::is_same_v<To, From>) {
+        return values;
+    } else {
+        buffer.assign(values, values + size);
+        return buffer.data();
+    }
+}
+
+// compares two numeric columns with the packed kernels, both widened to the
+// type the scalar comparison of their values would convert them to
+template <typename T, typename U>
+static BitsetType
+CompareColumnsPacked(const segcore::SegmentInternalInterface& segment,
+                     int64_t row_count,
+                     const BitsetType* candidates,
+                     const CompareExpr& expr,
+                     simd::CompareType cmp_type) {
+    static_assert(sizeof(BitSetBlockType) == sizeof(uint64_t));
+    using CommonType = std::common_type_t<T, U>;
+    auto size_per_chunk = segment.size_per_chunk();
+    auto num_chunk = upper_div(row_count, size_per_chunk);
+    BitsetType final_result(row_count);
+    if (row_count == 0) {
+        return final_result;
+    }
+    auto result_words =
+        reinterpret_cast<uint64_t*>(boost_ext::get_data(final_result));
+    std::vector<T> left_values;
+    std::vector<U> right_values;
+    std::vector<CommonType> left_common;
+    std::vector<CommonType> right_common;
+    std::vector<uint64_t> buffer;
+    for (int64_t chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+        CheckCancelled();
+        auto chunk_begin = chunk_id * size_per_chunk;
+        auto size = std::min(size_per_chunk, row_count - chunk_begin);
+        if (!HasCandidate(candidates, chunk_begin, chunk_begin + size)) {
+            continue;
+        }
+        auto left = WidenValues<CommonType>(
+            ChunkValues<T>(segment, expr.left_field_id_, chunk_id, left_values),
+            size,
+            left_common);
+        auto right = WidenValues<CommonType>(
+            ChunkValues<U>(
+                segment, expr.right_field_id_, chunk_id, right_values),
+            size,
+            right_common);
+        // chunks are written at their final offset, as in
+        // ExecRangeVisitorImplPacked
+        if (chunk_begin % simd::BITS_PER_WORD == 0) {
+            simd::CompareColumn(cmp_type,
+                                left,
+                                right,
+                                size,
+                                result_words +
+                                    chunk_begin / simd::BITS_PER_WORD);
+            continue;
+        }
+        buffer.assign(simd::WordCount(size), 0);
+        simd::CompareColumn(cmp_type, left, right, size, buffer.data());
+        OrPackedBits(result_words, chunk_begin, buffer.data(), size);
+    }
+    return final_result;
+}
+
+template <typename T>
+static std::optional<BitsetType>
+CompareColumnsPackedRight(const segcore::SegmentInternalInterface& segment,
+                          int64_t row_count,
+                          const BitsetType* candidates,
+                          const CompareExpr& expr,
+                          simd::CompareType cmp_type) {
+    switch (expr.right_data_type_) {
+        case DataType::INT8:
+            return CompareColumnsPacked<T, int8_t>(
+                segment, row_count, candidates, expr, cmp_type);
+        case DataType::INT16:
+            return CompareColumnsPacked<T, int16_t>(
+                segment, row_count, candidates, expr, cmp_type);
+        case DataType::INT32:
+            return CompareColumnsPacked<T, int32_t>(
+                segment, row_count, candidates, expr, cmp_type);
+        case DataType::INT64:
+            return CompareColumnsPacked<T, int64_t>(
+                segment, row_count, candidates, expr, cmp_type);
+        case DataType::FLOAT:
+            return CompareColumnsPacked<T, float>(
+                segment, row_count, candidates, expr, cmp_type);
+        case DataType::DOUBLE:
+            return CompareColumnsPacked<T, double>(
+                segment, row_count, candidates, expr, cmp_type);
+        default:
+            return std::nullopt;
+    }
+}
+
+// nullopt if the columns or the operator have no packed kernel
+static std::optional<BitsetType>
+CompareColumnsPacked(const segcore::SegmentInternalInterface& segment,
+                     int64_t row_count,
+                     const BitsetType* candidates,
+                     const CompareExpr& expr) {
+    auto cmp_type = ToSimdCompareType(expr.op_type_);
+    if (!cmp_type.has_value()) {
+        return std::nullopt;
+    }
+    switch (expr.left_data_type_) {
+        case DataType::INT8:
+            return CompareColumnsPackedRight<int8_t>(
+                segment, row_count, candidates, expr, cmp_type.value());
+        case DataType::INT16:
+            return CompareColumnsPackedRight<int16_t>(
+                segment, row_count, candidates, expr, cmp_type.value());
+        case DataType::INT32:
+            return CompareColumnsPackedRight<int32_t>(
+                segment, row_count, candidates, expr, cmp_type.value());
+        case DataType::INT64:
+            return CompareColumnsPackedRight<int64_t>(
+                segment, row_count, candidates, expr, cmp_type.value());
+        case DataType::FLOAT:
+            return CompareColumnsPackedRight<float>(
+                segment, row_count, candidates, expr, cmp_type.value());
+        case DataType::DOUBLE:
+            return CompareColumnsPackedRight<double>(
+                segment, row_count, candidates, expr, cmp_type.value());
+        default:
+            return std::nullopt;
+    }
+}
+
 template <typename Op>
 auto
 ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
@@ -1371,6 +2578,13 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
         "max(right_data_barrier, right_indexing_barrier) not equal to "
         "num_chunk");
 
+    // numeric columns, raw or decoded from their index, are compared by the
+    // packed kernels
+    if (auto res =
+            CompareColumnsPacked(segment_, row_count_, candidates_, expr)) {
+        return std::move(res.value());
+    }
+
     // For segment both fields has no index, can use SIMD to speed up.
     // Avoiding too much call stack that blocks SIMD.
     if (left_indexing_barrier == 0 && right_indexing_barrier == 0 &&
@@ -1380,9 +2594,16 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
 
     // TODO: refactoring the code that contains too much call stack.
     for (int64_t chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+        CheckCancelled();
         auto size = chunk_id == num_chunk - 1
                         ? row_count_ - chunk_id * size_per_chunk
                         : size_per_chunk;
+        if (!HasCandidate(candidates_,
+                          chunk_id * size_per_chunk,
+                          chunk_id * size_per_chunk + size)) {
+            bitsets.emplace_back(size);
+            continue;
+        }
         auto getChunkData =
             [&, chunk_id](DataType type, FieldId field_id, int64_t data_barrier)
             -> std::function<const number(int)> {
@@ -1508,23 +2729,14 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                 }
                 case DataType::VARCHAR: {
                     if (chunk_id < data_barrier) {
-                        if (segment_.type() == SegmentType::Growing) {
-                            auto chunk_data =
-                                segment_
-                                    .chunk_data<std::string>(field_id, chunk_id)
-                                    .data();
-                            return [chunk_data](int i) -> const number {
-                                return chunk_data[i];
-                            };
-                        } else {
-                            auto chunk_data = segment_
-                                                  .chunk_data<std::string_view>(
-                                                      field_id, chunk_id)
-                                                  .data();
-                            return [chunk_data](int i) -> const number {
-                                return std::string(chunk_data[i]);
-                            };
-                        }
+                        auto chunk_data =
+                            segment_
+                                .chunk_data<std::string_view>(field_id,
+                                                              chunk_id)
+                                .data();
+                        return [chunk_data](int i) -> const number {
+                            return std::string(chunk_data[i]);
+                        };
                     } else {
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing =
@@ -1545,11 +2757,14 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
             expr.right_data_type_, expr.right_field_id_, right_data_barrier);
 
         BitsetType bitset(size);
-        for (int i = 0; i < size; ++i) {
-            bool is_in = boost::apply_visitor(
-                Relational<decltype(op)>{}, left(i), right(i));
-            bitset[i] = is_in;
-        }
+        auto chunk_begin = chunk_id * size_per_chunk;
+        ForEachCandidate(
+            candidates_, chunk_begin, chunk_begin + size, [&](int64_t offset) {
+                auto i = offset - chunk_begin;
+                bool is_in = boost::apply_visitor(
+                    Relational<decltype(op)>{}, left(i), right(i));
+                bitset[i] = is_in;
+            });
         bitsets.emplace_back(std::move(bitset));
     }
     auto final_result = Assemble(bitsets);
@@ -1615,68 +2830,40 @@ ExecExprVisitor::visit(CompareExpr& expr) {
 template <typename T>
 auto
 ExecExprVisitor::ExecTermVisitorImpl(TermExpr& expr_raw) -> BitsetType {
-    auto& expr = static_cast<TermExprImpl<T>&>(expr_raw);
-    auto& schema = segment_.get_schema();
-    auto primary_filed_id = schema.get_primary_field_id();
-    auto field_id = expr_raw.column_.field_id;
-    auto& field_meta = schema[field_id];
-
-    bool use_pk_index = false;
-    if (primary_filed_id.has_value()) {
-        use_pk_index = primary_filed_id.value() == field_id &&
-                       IsPrimaryKeyDataType(field_meta.get_data_type());
-    }
-
-    if (use_pk_index) {
-        auto id_array = std::make_unique<IdArray>();
-        switch (field_meta.get_data_type()) {
-            case DataType::INT64: {
-                auto dst_ids = id_array->mutable_int_id();
-                for (const auto& id : expr.terms_) {
-                    dst_ids->add_data((int64_t&)id);
-                }
-                break;
-            }
-            case DataType::VARCHAR: {
-                auto dst_ids = id_array->mutable_str_id();
-                for (const auto& id : expr.terms_) {
-                    dst_ids->add_data((std::string&)id);
-                }
-                break;
-            }
-            default: {
-                PanicInfo("unsupported type");
+    typedef std::
+        conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
+            IndexInnerType;
+    if constexpr (std::is_same_v<IndexInnerType, int64_t> ||
+                  std::is_same_v<IndexInnerType, std::string>) {
+        auto& expr = static_cast<TermExprImpl<IndexInnerType>&>(expr_raw);
+        auto& schema = segment_.get_schema();
+        auto primary_filed_id = schema.get_primary_field_id();
+        auto field_id = expr_raw.column_.field_id;
+        auto& field_meta = schema[field_id];
+
+        bool use_pk_index = false;
+        if (primary_filed_id.has_value()) {
+            use_pk_index = primary_filed_id.value() == field_id &&
+                           IsPrimaryKeyDataType(field_meta.get_data_type());
+        }
+        if (use_pk_index) {
+            // the rows are looked up in the pk offset map, nothing is scanned
+            std::vector<PkType> pks(expr.terms_.begin(), expr.terms_.end());
+            auto seg_offsets = segment_.search_pks(pks, timestamp_);
+            BitsetType bitset(row_count_);
+            for (const auto& offset : seg_offsets) {
+                auto _offset = (int64_t)offset.get();
+                bitset[_offset] = true;
             }
+            AssertInfo(bitset.size() == row_count_,
+                       "[ExecExprVisitor]Size of results not equal row count");
+            return bitset;
         }
-
-        auto [uids, seg_offsets] = segment_.search_ids(*id_array, timestamp_);
-        BitsetType bitset(row_count_);
-        for (const auto& offset : seg_offsets) {
-            auto _offset = (int64_t)offset.get();
-            bitset[_offset] = true;
-        }
-        AssertInfo(bitset.size() == row_count_,
-                   "[ExecExprVisitor]Size of results not equal row count");
-        return bitset;
     }
 
     return ExecTermVisitorImplTemplate<T>(expr_raw);
 }
 
-template <>
-auto
-ExecExprVisitor::ExecTermVisitorImpl<std::string>(TermExpr& expr_raw)
-    -> BitsetType {
-    return ExecTermVisitorImplTemplate<std::string>(expr_raw);
-}
-
-template <>
-auto
-ExecExprVisitor::ExecTermVisitorImpl<std::string_view>(TermExpr& expr_raw)
-    -> BitsetType {
-    return ExecTermVisitorImplTemplate<std::string_view>(expr_raw);
-}
-
 template <typename T>
 auto
 ExecExprVisitor::ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> BitsetType {
@@ -1688,19 +2875,69 @@ ExecExprVisitor::ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> BitsetType {
     const std::vector<IndexInnerType> terms(expr.terms_.begin(),
                                             expr.terms_.end());
     auto n = terms.size();
-    std::unordered_set<T> term_set(expr.terms_.begin(), expr.terms_.end());
 
     auto index_func = [&terms, n](Index* index) {
         return index->In(n, terms.data());
     };
-    auto elem_func = [&terms, &term_set](MayConstRef<T> x) {
-        //// terms has already been sorted.
-        // return std::binary_search(terms.begin(), terms.end(), x);
-        return term_set.find(x) != term_set.end();
-    };
 
-    return ExecRangeVisitorImpl<T>(
-        expr.column_.field_id, index_func, elem_func);
+    if constexpr (IsSimdKernelType<T>) {
+        TermProbe<T> probe(terms.begin(), terms.end());
+        auto& values = probe.values();
+        auto zone_func = [&values](const auto& zone_map) {
+            auto match = ZoneMatch::None;
+            for (auto& value : values) {
+                auto value_match =
+                    zone_map.MatchUnaryRange(OpType::Equal, value);
+                if (value_match == ZoneMatch::All) {
+                    return ZoneMatch::All;
+                }
+                if (value_match == ZoneMatch::Some) {
+                    match = ZoneMatch::Some;
+                }
+            }
+            return match;
+        };
+        if (values.size() <= kTermBroadcastLimit) {
+            auto packed_index_func = [&terms, n](Index* index) {
+                return index->InBits(n, terms.data());
+            };
+            auto kernel_func = [&values](
+                                   const T* data, int64_t size, uint64_t* dst) {
+                auto n_words = simd::WordCount(size);
+                if (values.empty()) {
+                    std::fill_n(dst, n_words, 0);
+                    return;
+                }
+                simd::CompareVal(
+                    simd::CompareType::EQ, data, size, values[0], dst);
+                std::vector<uint64_t> words(n_words);
+                for (size_t i = 1; i < values.size(); ++i) {
+                    simd::CompareVal(simd::CompareType::EQ,
+                                     data,
+                                     size,
+                                     values[i],
+                                     words.data());
+                    simd::BitwiseWords(
+                        simd::BitwiseOp::OR, dst, words.data(), n_words);
+                }
+            };
+            return ExecRangeVisitorImplPacked<T>(expr.column_.field_id,
+                                                 packed_index_func,
+                                                 kernel_func,
+                                                 zone_func);
+        }
+        auto elem_func = [&probe](T x) { return probe.contains(x); };
+        return ExecRangeVisitorImpl<T>(
+            expr.column_.field_id, index_func, elem_func, zone_func);
+    } else {
+        std::unordered_set<T> term_set(expr.terms_.begin(),
+                                       expr.terms_.end());
+        auto elem_func = [&term_set](MayConstRef<T> x) {
+            return term_set.find(x) != term_set.end();
+        };
+        return ExecRangeVisitorImpl<T>(
+            expr.column_.field_id, index_func, elem_func);
+    }
 }
 
 // TODO: bool is so ugly here.
@@ -1754,11 +2991,21 @@ ExecExprVisitor::ExecTermVisitorImplTemplateJson(TermExpr& expr_raw)
             expr.column_.field_id, index_func, elem_func);
     }
 
+    using GetType =
+        std::conditional_t<std::is_same_v<ExprValueType, std::string>,
+                           std::string_view,
+                           ExprValueType>;
+    if (auto key_index =
+            segment_.json_key_index(expr.column_.field_id, pointer)) {
+        auto cmp = [&term_set](auto value) {
+            return term_set.find(ExprValueType(value)) != term_set.end();
+        };
+        return ExecJsonKeyIndexImpl(*key_index, [&](int64_t offset) {
+            return key_index->Visit<GetType>(offset, cmp, false);
+        });
+    }
+
     auto elem_func = [&term_set, &pointer](const milvus::Json& json) {
-        using GetType =
-            std::conditional_t<std::is_same_v<ExprValueType, std::string>,
-                               std::string_view,
-                               ExprValueType>;
         auto x = json.template at<GetType>(pointer);
         if (x.error()) {
             return false;
@@ -1776,6 +3023,20 @@ ExecExprVisitor::visit(TermExpr& expr) {
     AssertInfo(expr.column_.data_type == field_meta.get_data_type(),
                "[ExecExprVisitor]DataType of expr isn't field_meta "
                "data type ");
+    std::optional<BitsetType> pruned;
+    if (expr.column_.data_type == DataType::INT64) {
+        auto& impl = static_cast<TermExprImpl<int64_t>&>(expr);
+        pruned = ExecPartitionKeyFilter(expr.column_.field_id,
+                                        PartitionKeysOf(impl.terms_));
+    } else if (expr.column_.data_type == DataType::VARCHAR) {
+        auto& impl = static_cast<TermExprImpl<std::string>&>(expr);
+        pruned = ExecPartitionKeyFilter(expr.column_.field_id,
+                                        PartitionKeysOf(impl.terms_));
+    }
+    if (pruned.has_value()) {
+        bitset_opt_ = std::move(pruned);
+        return;
+    }
     BitsetType res;
     switch (expr.column_.data_type) {
         case DataType::BOOL: {
@@ -1807,11 +3068,7 @@ ExecExprVisitor::visit(TermExpr& expr) {
             break;
         }
         case DataType::VARCHAR: {
-            if (segment_.type() == SegmentType::Growing) {
-                res = ExecTermVisitorImpl<std::string>(expr);
-            } else {
-                res = ExecTermVisitorImpl<std::string_view>(expr);
-            }
+            res = ExecTermVisitorImpl<std::string_view>(expr);
             break;
         }
         case DataType::JSON: {
@@ -1855,6 +3112,13 @@ ExecExprVisitor::visit(ExistsExpr& expr) {
     auto pointer = milvus::Json::pointer(expr.column_.nested_path);
     switch (expr.column_.data_type) {
         case DataType::JSON: {
+            if (auto key_index =
+                    segment_.json_key_index(expr.column_.field_id, pointer)) {
+                res = ExecJsonKeyIndexImpl(*key_index, [&](int64_t offset) {
+                    return key_index->Exists(offset);
+                });
+                break;
+            }
             using Index = index::ScalarIndex<milvus::Json>;
             auto index_func = [&](Index* index) { return TargetBitmap{}; };
             auto elem_func = [&](const milvus::Json& json) {
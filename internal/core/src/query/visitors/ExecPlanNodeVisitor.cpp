@@ -11,11 +11,27 @@
 
 #include "query/generated/ExecPlanNodeVisitor.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "boost_ext/dynamic_bitset_ext.hpp"
+#include "common/BitsetOps.h"
+#include "common/BitsetView.h"
+#include "common/Consts.h"
+#include "common/QueryInfo.h"
+#include "common/Tracer.h"
+#include "query/Aggregate.h"
+#include "query/CanMatch.h"
+#include "query/OrderBy.h"
 #include "query/PlanImpl.h"
+#include "query/Selection.h"
 #include "query/SubSearchResult.h"
 #include "query/generated/ExecExprVisitor.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/SegmentGrowing.h"
 #include "utils/Json.h"
 #include "log/Log.h"
@@ -54,11 +70,22 @@ class ExecPlanNodeVisitor : PlanNodeVisitor {
     const segcore::SegmentInterface& segment_;
     Timestamp timestamp_;
     const PlaceholderGroup& placeholder_group_;
+    const segcore::SegmentSnapshot* snapshot_;
 
     SearchResultOpt search_result_opt_;
 };
 }  // namespace impl
 
+static int64_t
+elapsed_ns(std::chrono::steady_clock::time_point& begin) {
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - begin)
+            .count();
+    begin = now;
+    return elapsed;
+}
+
 static SearchResult
 empty_search_result(int64_t num_queries, SearchInfo& search_info) {
     SearchResult final_result;
@@ -73,6 +100,196 @@ empty_search_result(int64_t num_queries, SearchInfo& search_info) {
     return final_result;
 }
 
+static int64_t
+get_active_count(const segcore::SegmentInternalInterface& segment,
+                 const segcore::SegmentSnapshot* snapshot,
+                 Timestamp timestamp) {
+    if (snapshot != nullptr) {
+        return snapshot->active_count();
+    }
+    return segment.get_active_count(timestamp);
+}
+
+// rows the predicate of a retrieve with a limit is first evaluated over
+constexpr int64_t kRetrieveLimitWindow = 64 * 1024;
+
+// the first `limit_` of the `active_count` rows visible at `timestamp`
+// which match the predicate of `node`, ascending. The predicate is
+// evaluated over a prefix of the rows which doubles until enough of them
+// match, so a small limit stops early, and the rows evaluated add up to at
+// most twice the prefix needed.
+static std::vector<int64_t>
+retrieve_limited_offsets(const segcore::SegmentInternalInterface& segment,
+                         RetrievePlanNode& node,
+                         const segcore::SegmentSnapshot* snapshot,
+                         int64_t active_count,
+                         Timestamp timestamp) {
+    auto limit = node.limit_;
+    std::vector<int64_t> offsets;
+    offsets.reserve(std::min(limit, active_count));
+    // the rows before `begin` are collected already, it stays a multiple
+    // of the window so the scan starts at a whole byte
+    int64_t begin = 0;
+    auto window = std::min(active_count, kRetrieveLimitWindow);
+    const std::string no_key;
+    while (true) {
+        // the result of a prefix isn't cached under the key of the predicate
+        auto& key = window == active_count ? node.predicate_key_ : no_key;
+        auto bitset = segment.exec_predicate(
+            *node.predicate_.value(), key, window, timestamp, nullptr);
+        bitset.flip();
+        if (snapshot == nullptr) {
+            segment.mask_with_timestamps(bitset, timestamp);
+            segment.mask_with_delete(bitset, active_count, timestamp);
+        }
+        auto data =
+            reinterpret_cast<const uint8_t*>(boost_ext::get_data(bitset));
+        ForEachBitBatch<false>(
+            data + begin / 8,
+            window - begin,
+            [&](const int64_t* batch, int64_t count) {
+                for (int64_t i = 0;
+                     i < count && int64_t(offsets.size()) < limit;
+                     ++i) {
+                    auto offset = begin + batch[i];
+                    if (snapshot == nullptr ||
+                        !snapshot->invisible()[offset]) {
+                        offsets.push_back(offset);
+                    }
+                }
+            });
+        if (int64_t(offsets.size()) >= limit || window == active_count) {
+            return offsets;
+        }
+        begin = window;
+        window = std::min(active_count, window * 2);
+    }
+}
+
+// hits a post-filtered search fetches over the topk divided by the density,
+// some queries find more filtered out hits than the average
+constexpr double kPostFilterOverFetch = 1.1;
+
+// searches the index without the filter for enough hits that the topk of
+// each query survive `filtered`, which leaves `density` of the rows, and
+// drops the filtered out ones. False if a query is left with fewer than the
+// topk, `result` is left alone then.
+static bool
+post_filter_search(const segcore::SegmentInternalInterface& segment,
+                   const SearchInfo& search_info,
+                   const void* src_data,
+                   int64_t num_queries,
+                   Timestamp timestamp,
+                   const BitsetType& filtered,
+                   double density,
+                   SearchResult& result) {
+    auto topk = search_info.topk_;
+    auto fetch_topk =
+        density < 1
+            ? int64_t(std::ceil(topk * kPostFilterOverFetch / density)) + 1
+            : topk;
+    SearchInfo fetch_info = search_info;
+    fetch_info.topk_ = fetch_topk;
+    fetch_info.parsed_params_ = ParseSearchParams(
+        search_info.search_params_, fetch_topk, search_info.metric_type_);
+    if (search_info.refine_factor_ > 1) {
+        fetch_info.refine_params_ =
+            ParseSearchParams(search_info.search_params_,
+                              fetch_topk * search_info.refine_factor_,
+                              search_info.metric_type_);
+    }
+    SearchResult fetched;
+    segment.vector_search(fetch_info,
+                          src_data,
+                          num_queries,
+                          timestamp,
+                          BitsetView(),
+                          fetched);
+
+    auto size = static_cast<int64_t>(filtered.size());
+    std::vector<int64_t> seg_offsets(num_queries * topk);
+    std::vector<float> distances(num_queries * topk);
+    for (int64_t i = 0; i < num_queries; ++i) {
+        int64_t kept = 0;
+        for (int64_t j = 0; j < fetch_topk && kept < topk; ++j) {
+            auto offset = fetched.seg_offsets_[i * fetch_topk + j];
+            if (offset == INVALID_SEG_OFFSET || offset >= size ||
+                filtered[offset]) {
+                continue;
+            }
+            seg_offsets[i * topk + kept] = offset;
+            distances[i * topk + kept] = fetched.distances_[i * fetch_topk + j];
+            ++kept;
+        }
+        if (kept < topk) {
+            return false;
+        }
+    }
+    result.total_nq_ = num_queries;
+    result.unity_topK_ = topk;
+    result.seg_offsets_ = std::move(seg_offsets);
+    result.distances_ = std::move(distances);
+    result.effective_search_params_ =
+        std::move(fetched.effective_search_params_);
+    return true;
+}
+
+BitsetType
+ExecPlanNodeVisitor::ExcludedRows(VectorPlanNode& node,
+                                  int64_t active_count,
+                                  QueryProfile* profile) {
+    auto segment =
+        dynamic_cast<const segcore::SegmentInternalInterface*>(&segment_);
+    AssertInfo(segment, "support SegmentSmallIndex Only");
+    auto begin = std::chrono::steady_clock::now();
+    BitsetType bitset_holder;
+    if (!CanMatch(node.predicate_, *segment) ||
+        segment->is_expired(timestamp_)) {
+        // the statistics of the segment rule out every row, or the ttl of
+        // the collection expired them all, nor are the masks of any use
+        // then
+        bitset_holder.resize(active_count, true);
+        if (profile) {
+            profile->predicate_ns = elapsed_ns(begin);
+        }
+        return bitset_holder;
+    }
+    if (node.predicate_.has_value()) {
+        bitset_holder = segment->exec_predicate(*node.predicate_.value(),
+                                                node.predicate_key_,
+                                                active_count,
+                                                timestamp_,
+                                                profile);
+        bitset_holder.flip();
+    } else {
+        bitset_holder.resize(active_count);
+    }
+    if (profile) {
+        profile->predicate_ns = elapsed_ns(begin);
+    }
+    if (snapshot_ != nullptr) {
+        // both masks come with the snapshot, counted as the mvcc one
+        BitsetOr(bitset_holder, snapshot_->invisible());
+        if (profile) {
+            profile->mvcc_mask_ns = elapsed_ns(begin);
+        }
+    } else {
+        {
+            tracer::AutoSpan span("mask_with_timestamps");
+            segment->mask_with_timestamps(bitset_holder, timestamp_);
+        }
+        if (profile) {
+            profile->mvcc_mask_ns = elapsed_ns(begin);
+        }
+
+        segment->mask_with_delete(bitset_holder, active_count, timestamp_);
+        if (profile) {
+            profile->delete_mask_ns = elapsed_ns(begin);
+        }
+    }
+    return bitset_holder;
+}
+
 template <typename VectorType>
 void
 ExecPlanNodeVisitor::VectorVisitorImpl(VectorPlanNode& node) {
@@ -88,43 +305,115 @@ ExecPlanNodeVisitor::VectorVisitorImpl(VectorPlanNode& node) {
 
     // TODO: add API to unify row_count
     // auto row_count = segment->get_row_count();
-    auto active_count = segment->get_active_count(timestamp_);
+    auto active_count = get_active_count(*segment, snapshot_, timestamp_);
+
+    // phases are timed when the plan asks for the profile, it goes with
+    // the result even if the search is cut short
+    std::unique_ptr<QueryProfile> profile;
+    if (node.search_info_.profile_) {
+        profile = std::make_unique<QueryProfile>();
+        profile->active_count = active_count;
+        profile->search_params = node.search_info_.search_params_.dump();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    auto finish = [&](SearchResult result) {
+        result.profile_ = std::move(profile);
+        search_result_opt_ = std::move(result);
+    };
 
     // skip all calculation
     if (active_count == 0) {
-        search_result_opt_ =
-            empty_search_result(num_queries, node.search_info_);
+        finish(empty_search_result(num_queries, node.search_info_));
         return;
     }
 
-    std::unique_ptr<BitsetType> bitset_holder;
-    if (node.predicate_.has_value()) {
-        bitset_holder = std::make_unique<BitsetType>(
-            ExecExprVisitor(*segment, active_count, timestamp_)
-                .call_child(*node.predicate_.value()));
-        bitset_holder->flip();
+    BitsetType bitset_holder;
+    if (excluded_ != nullptr) {
+        AssertInfo(int64_t(excluded_->size()) == active_count,
+                   "excluded rows mismatch the active count");
+        bitset_holder = *excluded_;
     } else {
-        bitset_holder = std::make_unique<BitsetType>(active_count, false);
+        bitset_holder = ExcludedRows(node, active_count, profile.get());
     }
-    segment->mask_with_timestamps(*bitset_holder, timestamp_);
-
-    segment->mask_with_delete(*bitset_holder, active_count, timestamp_);
+    begin = std::chrono::steady_clock::now();
 
     // if bitset_holder is all 1's, we got empty result
-    if (bitset_holder->all()) {
-        search_result_opt_ =
-            empty_search_result(num_queries, node.search_info_);
+    Selection selection(
+        std::move(bitset_holder),
+        segcore::SegcoreConfig::default_config().get_brute_force_threshold());
+    if (profile) {
+        profile->bitset_density = double(selection.count()) / active_count;
+    }
+    if (selection.count() == 0) {
+        finish(empty_search_result(num_queries, node.search_info_));
+        return;
+    }
+    // so few rows left that computing their distances beats the filtered
+    // search, which still walks the whole index or segment, the segment
+    // turns it down if it can't gather the vectors or the index search
+    // still pays off
+    tracer::AutoSpan search_span("vector_search");
+    if (selection.is_sparse() &&
+        segment->vector_search_offsets(node.search_info_,
+                                       src_data,
+                                       num_queries,
+                                       selection.offsets(),
+                                       search_result)) {
+        if (profile) {
+            profile->vector_search_ns = elapsed_ns(begin);
+            profile->search_path = "brute_force_offsets";
+        }
+        finish(std::move(search_result));
+        return;
+    }
+    // so many rows left that checking the bitset within the index costs
+    // more than it saves, the index is searched without it for a few more
+    // hits and the filtered out ones are dropped, unless so many of them
+    // come up that a query is left short
+    auto& search_info = node.search_info_;
+    auto density = double(selection.count()) / active_count;
+    if (density >= segcore::SegcoreConfig::default_config()
+                       .get_post_filter_density() &&
+        selection.count() >= search_info.topk_ &&
+        !search_info.group_by_field_id_.has_value() &&
+        !GetSearchParams(search_info)->is_range_search() &&
+        segment->type() == SegmentType::Sealed &&
+        segment->HasIndex(search_info.field_id_) &&
+        post_filter_search(*segment,
+                           search_info,
+                           src_data,
+                           num_queries,
+                           timestamp_,
+                           selection.bitset(),
+                           density,
+                           search_result)) {
+        if (profile) {
+            profile->vector_search_ns = elapsed_ns(begin);
+            profile->search_path = "post_filter";
+            if (!search_result.effective_search_params_.empty()) {
+                profile->search_params =
+                    search_result.effective_search_params_;
+            }
+        }
+        finish(std::move(search_result));
         return;
     }
-    BitsetView final_view = *bitset_holder;
+    BitsetView final_view = selection.bitset();
     segment->vector_search(node.search_info_,
                            src_data,
                            num_queries,
                            timestamp_,
                            final_view,
                            search_result);
+    if (profile) {
+        profile->vector_search_ns = elapsed_ns(begin);
+        profile->search_path = "vector_search";
+        if (!search_result.effective_search_params_.empty()) {
+            profile->search_params = search_result.effective_search_params_;
+        }
+    }
 
-    search_result_opt_ = std::move(search_result);
+    finish(std::move(search_result));
 }
 
 std::unique_ptr<RetrieveResult>
@@ -146,52 +435,112 @@ ExecPlanNodeVisitor::visit(RetrievePlanNode& node) {
     AssertInfo(segment, "Support SegmentSmallIndex Only");
     RetrieveResult retrieve_result;
 
-    auto active_count = segment->get_active_count(timestamp_);
+    auto active_count = get_active_count(*segment, snapshot_, timestamp_);
+    // the aggregates of no rows are still returned
+    auto aggregated = node.is_count || !node.aggregates_.empty();
+    auto aggregate = [&](const BitsetType& excluded) {
+        for (auto& item : node.aggregates_) {
+            retrieve_result.field_data_.push_back(
+                AggregateRows(*segment, item, excluded));
+        }
+        retrieve_result_opt_ = std::move(retrieve_result);
+    };
+
+    // the statistics of the segment rule out every row, or the ttl expired
+    // them, which is answered as if the segment had none
+    if (active_count > 0 && (!CanMatch(node.predicate_, *segment) ||
+                             segment->is_expired(timestamp_))) {
+        active_count = 0;
+    }
 
-    if (active_count == 0 && !node.is_count) {
+    if (active_count == 0 && !aggregated) {
         retrieve_result_opt_ = std::move(retrieve_result);
         return;
     }
 
+    if (active_count == 0 && !node.aggregates_.empty()) {
+        aggregate(BitsetType());
+        return;
+    }
+
     if (active_count == 0 && node.is_count) {
         retrieve_result = *(wrap_num_entities(0));
         retrieve_result_opt_ = std::move(retrieve_result);
         return;
     }
 
+    if (node.limit_ > 0 && !aggregated && !node.order_by_.has_value() &&
+        node.predicate_.has_value() && node.predicate_.value() != nullptr) {
+        retrieve_result.result_offsets_ = retrieve_limited_offsets(
+            *segment, node, snapshot_, active_count, timestamp_);
+        retrieve_result_opt_ = std::move(retrieve_result);
+        return;
+    }
+
     BitsetType bitset_holder;
     // For case that retrieve by expression, bitset will be allocated when expression is being executed.
-    if (node.is_count) {
+    if (aggregated || node.order_by_.has_value()) {
         bitset_holder.resize(active_count);
     }
 
     if (node.predicate_.has_value() && node.predicate_.value() != nullptr) {
-        bitset_holder = ExecExprVisitor(*segment, active_count, timestamp_)
-                            .call_child(*(node.predicate_.value()));
+        bitset_holder = segment->exec_predicate(*node.predicate_.value(),
+                                                node.predicate_key_,
+                                                active_count,
+                                                timestamp_,
+                                                nullptr);
         bitset_holder.flip();
     }
 
-    segment->mask_with_timestamps(bitset_holder, timestamp_);
+    if (snapshot_ != nullptr) {
+        // the bitset is only empty when there is neither a predicate nor
+        // an aggregate nor an order, which leaves no rows either way
+        if (!bitset_holder.empty()) {
+            BitsetOr(bitset_holder, snapshot_->invisible());
+        }
+    } else {
+        {
+            tracer::AutoSpan span("mask_with_timestamps");
+            segment->mask_with_timestamps(bitset_holder, timestamp_);
+        }
 
-    segment->mask_with_delete(bitset_holder, active_count, timestamp_);
+        segment->mask_with_delete(bitset_holder, active_count, timestamp_);
+    }
     // if bitset_holder is all 1's, we got empty result
-    if (bitset_holder.all() && !node.is_count) {
+    if (bitset_holder.all() && !aggregated) {
         retrieve_result_opt_ = std::move(retrieve_result);
         return;
     }
 
+    if (!node.aggregates_.empty()) {
+        aggregate(bitset_holder);
+        return;
+    }
+
     if (node.is_count) {
-        auto cnt = bitset_holder.size() - bitset_holder.count();
+        auto cnt = bitset_holder.size() - BitsetCount(bitset_holder);
         retrieve_result = *(wrap_num_entities(cnt));
         retrieve_result_opt_ = std::move(retrieve_result);
         return;
     }
 
+    if (node.order_by_.has_value()) {
+        auto limit = node.limit_ > 0 ? node.limit_ : active_count;
+        retrieve_result.result_offsets_ = OrderedOffsets(
+            *segment, node.order_by_.value(), limit, bitset_holder);
+        retrieve_result_opt_ = std::move(retrieve_result);
+        return;
+    }
+
+    // the offsets come ascending, so the fields are gathered in row order
     BitsetView final_view = bitset_holder;
-    auto seg_offsets = segment->search_ids(final_view, timestamp_);
-    retrieve_result.result_offsets_.assign(
-        (int64_t*)seg_offsets.data(),
-        (int64_t*)seg_offsets.data() + seg_offsets.size());
+    auto& result_offsets = retrieve_result.result_offsets_;
+    result_offsets.reserve(bitset_holder.size() - BitsetCount(bitset_holder));
+    segment->search_ids(
+        final_view, timestamp_, [&](const int64_t* offsets, int64_t count) {
+            result_offsets.insert(
+                result_offsets.end(), offsets, offsets + count);
+        });
     retrieve_result_opt_ = std::move(retrieve_result);
 }
 
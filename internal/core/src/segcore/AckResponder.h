@@ -12,9 +12,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <mutex>
-#include <set>
-#include <shared_mutex>
+#include <unordered_map>
 
 namespace milvus::segcore {
 
@@ -40,41 +40,104 @@ example() {
 }
 #endif
 
+// Completed segments are published into a ring of slots hashed by their
+// begin, and the ack advances by CAS whenever the slot of the current ack
+// holds a segment. Only a segment whose slot is still taken by another
+// pending segment goes to a mutex guarded overflow map.
+//
+// Publishing a segment and then reading the ack, against moving the ack and
+// then reading the slot, is a store-load handshake on both sides, so these
+// accesses are seq_cst: at least one side sees the other and advances.
 class AckResponder {
  public:
+    AckResponder() = default;
+    AckResponder(const AckResponder&) = delete;
+    AckResponder&
+    operator=(const AckResponder&) = delete;
+
     // specify that segment [seg_begin, seg_end) has been processed
     // WARN: segments shouldn't overlap
     void
     AddSegment(int64_t seg_begin, int64_t seg_end) {
-        std::lock_guard lck(mutex_);
-        fetch_and_flip(seg_end);
-        auto old_begin = fetch_and_flip(seg_begin);
-        if (old_begin) {
-            minimum_ = *acks_.begin();
+        if (seg_begin >= seg_end) {
+            return;
+        }
+        auto& slot = slots_[slot_index(seg_begin)];
+        auto expected = EMPTY;
+        if (slot.begin.compare_exchange_strong(expected, seg_begin)) {
+            // readers only take the slot once end is set
+            slot.end.store(seg_end, std::memory_order_seq_cst);
+        } else {
+            std::lock_guard lck(overflow_mutex_);
+            overflow_.emplace(seg_begin, seg_end);
+            overflow_count_.fetch_add(1);
         }
+        advance();
     }
 
     // return ack
     int64_t
     GetAck() const {
-        return minimum_;
+        return minimum_.load(std::memory_order_acquire);
     }
 
  private:
-    bool
-    fetch_and_flip(int64_t endpoint) {
-        if (acks_.count(endpoint)) {
-            acks_.erase(endpoint);
-            return true;
-        } else {
-            acks_.insert(endpoint);
-            return false;
+    static constexpr int64_t EMPTY = -1;
+    static constexpr int RING_BITS = 8;
+
+    struct Slot {
+        std::atomic<int64_t> begin{EMPTY};
+        std::atomic<int64_t> end{EMPTY};
+    };
+
+    static size_t
+    slot_index(int64_t begin) {
+        // begins are often multiples of the batch size, spread them
+        return (static_cast<uint64_t>(begin) * 0x9E3779B97F4A7C15ULL) >>
+               (64 - RING_BITS);
+    }
+
+    // moves the ack over every published segment starting at it
+    void
+    advance() {
+        while (true) {
+            auto ack = minimum_.load(std::memory_order_seq_cst);
+            auto& slot = slots_[slot_index(ack)];
+            if (slot.begin.load(std::memory_order_seq_cst) == ack) {
+                auto end = slot.end.load(std::memory_order_seq_cst);
+                if (end == EMPTY) {
+                    // the publisher advances once it has set end
+                    return;
+                }
+                if (minimum_.compare_exchange_strong(ack, end)) {
+                    slot.end.store(EMPTY, std::memory_order_relaxed);
+                    slot.begin.store(EMPTY, std::memory_order_release);
+                }
+                continue;
+            }
+            if (overflow_count_.load() == 0) {
+                return;
+            }
+            // the segment starting at ack is unique, only the thread which
+            // erases it may move the ack
+            std::lock_guard lck(overflow_mutex_);
+            auto it = overflow_.find(ack);
+            if (it == overflow_.end()) {
+                return;
+            }
+            auto end = it->second;
+            overflow_.erase(it);
+            overflow_count_.fetch_sub(1);
+            minimum_.store(end, std::memory_order_seq_cst);
         }
     }
 
  private:
-    std::shared_mutex mutex_;
-    std::set<int64_t> acks_ = {0};
+    Slot slots_[1 << RING_BITS];
     std::atomic<int64_t> minimum_ = 0;
+
+    std::mutex overflow_mutex_;
+    std::unordered_map<int64_t, int64_t> overflow_;
+    std::atomic<int64_t> overflow_count_ = 0;
 };
 }  // namespace milvus::segcore
@@ -0,0 +1,156 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "segcore/ChunkArena.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#include "exceptions/EasyAssert.h"
+#include "log/Log.h"
+
+namespace milvus::segcore {
+
+namespace {
+size_t
+align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+ChunkArena::ChunkArena(bool use_hugepage,
+                       size_t slab_size,
+                       std::string mmap_dir)
+    : use_hugepage_(use_hugepage),
+      slab_size_(align_up(slab_size, HUGE_PAGE_SIZE)),
+      mmap_dir_(std::move(mmap_dir)) {
+    AssertInfo(slab_size > 0, "invalid arena slab size");
+    if (!mmap_dir_.empty()) {
+        std::filesystem::create_directories(mmap_dir_);
+    }
+}
+
+ChunkArena::~ChunkArena() {
+    for (auto& slab : slabs_) {
+        munmap(slab.data, slab.size);
+    }
+    for (auto& slab : large_slabs_) {
+        munmap(slab.data, slab.size);
+    }
+    if (!mmap_dir_.empty()) {
+        std::error_code ec;
+        std::filesystem::remove_all(mmap_dir_, ec);
+        if (ec) {
+            LOG_SEGCORE_WARNING_ << "failed to remove chunk arena dir "
+                                 << mmap_dir_ << ": " << ec.message();
+        }
+    }
+}
+
+ChunkArena::Slab
+ChunkArena::map_slab(size_t bytes) {
+    auto size = std::max(slab_size_, align_up(bytes, HUGE_PAGE_SIZE));
+    if (!mmap_dir_.empty()) {
+        auto path = std::filesystem::path(mmap_dir_) /
+                    ("slab_" + std::to_string(num_files_++));
+        auto fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        AssertInfo(fd != -1,
+                   "failed to create chunk arena file " + path.string() +
+                       ": " + strerror(errno));
+        if (ftruncate(fd, size) != 0) {
+            auto err = errno;
+            close(fd);
+            unlink(path.c_str());
+            PanicInfo("failed to resize chunk arena file " + path.string() +
+                      ": " + strerror(err));
+        }
+        auto data =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        unlink(path.c_str());
+        if (data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return {static_cast<char*>(data), size};
+    }
+    auto data = mmap(nullptr,
+                     size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1,
+                     0);
+    if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (use_hugepage_ && madvise(data, size, MADV_HUGEPAGE) != 0) {
+        LOG_SEGCORE_WARNING_ << "failed to advise hugepage for chunk arena: "
+                             << strerror(errno);
+    }
+#endif
+    return {static_cast<char*>(data), size};
+}
+
+void*
+ChunkArena::allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    std::lock_guard lck(mutex_);
+    if (bytes > slab_size_ / 2) {
+        // large chunks get a slab of their own, keep bumping in the
+        // current one
+        auto slab = map_slab(bytes);
+        reserved_ += slab.size;
+        large_slabs_.push_back(slab);
+        allocated_ += bytes;
+        return slab.data;
+    }
+    auto offset = align_up(offset_, alignment);
+    if (slabs_.empty() || offset + bytes > slabs_.back().size) {
+        // the tail of the current slab is given up, it is smaller than
+        // the requested bytes
+        slabs_.push_back(map_slab(bytes));
+        reserved_ += slabs_.back().size;
+        offset = 0;
+    }
+    auto ptr = slabs_.back().data + offset;
+    offset_ = offset + bytes;
+    allocated_ += bytes;
+    return ptr;
+}
+
+size_t
+ChunkArena::allocated_bytes() const {
+    std::lock_guard lck(mutex_);
+    return allocated_;
+}
+
+size_t
+ChunkArena::reserved_bytes() const {
+    std::lock_guard lck(mutex_);
+    return reserved_;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,154 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace milvus::segcore {
+
+// A bump allocator for the chunks of one segment. Memory is taken from the
+// system in large anonymous mappings (slabs) and is only given back when the
+// arena is destroyed, so all chunks of a segment live in a few contiguous
+// regions instead of one heap allocation each.
+//
+// With a mmap_dir the slabs are shared mappings of files created in it
+// instead, the page cache then buffers the chunks and the kernel may write
+// them back and drop them under memory pressure. The files are unlinked
+// once mapped, so they go away with the mappings even if the process dies.
+class ChunkArena {
+ public:
+    static constexpr size_t DEFAULT_SLAB_SIZE = 32 << 20;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+    explicit ChunkArena(bool use_hugepage = false,
+                        size_t slab_size = DEFAULT_SLAB_SIZE,
+                        std::string mmap_dir = "");
+
+    ChunkArena(const ChunkArena&) = delete;
+    ChunkArena&
+    operator=(const ChunkArena&) = delete;
+
+    ~ChunkArena();
+
+    void*
+    allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // bytes handed out to chunks
+    size_t
+    allocated_bytes() const;
+
+    // bytes mapped from the system
+    size_t
+    reserved_bytes() const;
+
+    // whether the slabs are mapped from files
+    bool
+    file_backed() const {
+        return !mmap_dir_.empty();
+    }
+
+ private:
+    struct Slab {
+        char* data;
+        size_t size;
+    };
+
+    Slab
+    map_slab(size_t bytes);
+
+ private:
+    const bool use_hugepage_;
+    const size_t slab_size_;
+    // removed with the arena, empty for anonymous slabs
+    const std::string mmap_dir_;
+
+    mutable std::mutex mutex_;
+    std::vector<Slab> slabs_;
+    // slabs holding a single large chunk
+    std::vector<Slab> large_slabs_;
+    // bump pointer into the last slab
+    size_t offset_ = 0;
+    size_t allocated_ = 0;
+    // names the slab files
+    size_t num_files_ = 0;
+    size_t reserved_ = 0;
+};
+
+using ChunkArenaPtr = std::shared_ptr<ChunkArena>;
+
+// Stateful allocator for chunk containers. Each allocation keeps the arena
+// alive, deallocation is a no-op since the arena frees everything at once.
+// Without an arena it falls back to the global heap.
+template <typename T>
+class ArenaAllocator {
+ public:
+    using value_type = T;
+
+    ArenaAllocator() = default;
+
+    explicit ArenaAllocator(ChunkArenaPtr arena) : arena_(std::move(arena)) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)  // NOLINT
+        : arena_(other.arena()) {
+    }
+
+    T*
+    allocate(size_t n) {
+        if (arena_ == nullptr) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(T* ptr, size_t n) {
+        if (arena_ == nullptr) {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    }
+
+    const ChunkArenaPtr&
+    arena() const {
+        return arena_;
+    }
+
+    template <typename U>
+    bool
+    operator==(const ArenaAllocator<U>& other) const {
+        return arena_ == other.arena();
+    }
+
+    template <typename U>
+    bool
+    operator!=(const ArenaAllocator<U>& other) const {
+        return arena_ != other.arena();
+    }
+
+ private:
+    ChunkArenaPtr arena_;
+};
+
+}  // namespace milvus::segcore
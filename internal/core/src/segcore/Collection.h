@@ -16,6 +16,8 @@
 
 #include "common/Schema.h"
 #include "common/IndexMeta.h"
+#include "segcore/CollectionTtl.h"
+#include "segcore/DeleteBuffer.h"
 
 namespace milvus::segcore {
 
@@ -45,11 +47,24 @@ class Collection {
         return collection_name_;
     }
 
+    // shared by the segments created from the collection
+    const DeleteBufferPtr&
+    get_delete_buffer() {
+        return delete_buffer_;
+    }
+
+    const CollectionTtlPtr&
+    get_ttl() {
+        return ttl_;
+    }
+
  private:
     std::string collection_name_;
     std::string schema_proto_;
     SchemaPtr schema_;
     IndexMetaPtr index_meta_;
+    DeleteBufferPtr delete_buffer_ = std::make_shared<DeleteBuffer>();
+    CollectionTtlPtr ttl_ = std::make_shared<CollectionTtl>();
 };
 
 using CollectionPtr = std::unique_ptr<Collection>;
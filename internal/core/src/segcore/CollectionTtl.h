@@ -0,0 +1,63 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// The time to live of the rows of a collection, shared by its segments. A
+// row is expired for a query once its insert timestamp is more than the
+// ttl older than the query timestamp, compared by their physical times;
+// the expired rows are masked next to the ones newer than the query until
+// compaction drops them.
+class CollectionTtl {
+ public:
+    // the logical bits of a hybrid timestamp below its physical
+    // milliseconds
+    static constexpr int kLogicalBits = 18;
+
+    // 0 disables it
+    void
+    set_ttl_ms(int64_t ttl_ms) {
+        ttl_ms_.store(std::max<int64_t>(ttl_ms, 0), std::memory_order_relaxed);
+    }
+
+    int64_t
+    ttl_ms() const {
+        return ttl_ms_.load(std::memory_order_relaxed);
+    }
+
+    // the rows older than it are expired at `timestamp`, 0 if none is
+    Timestamp
+    expire_timestamp(Timestamp timestamp) const {
+        auto ttl_ms = this->ttl_ms();
+        auto physical = int64_t(timestamp >> kLogicalBits);
+        if (ttl_ms == 0 || physical <= ttl_ms) {
+            return 0;
+        }
+        auto logical = timestamp & ((Timestamp(1) << kLogicalBits) - 1);
+        return (Timestamp(physical - ttl_ms) << kLogicalBits) | logical;
+    }
+
+ private:
+    std::atomic<int64_t> ttl_ms_{0};
+};
+
+using CollectionTtlPtr = std::shared_ptr<CollectionTtl>;
+
+}  // namespace milvus::segcore
@@ -10,6 +10,10 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include "segcore/ConcurrentVector.h"
+
+#include <string>
+#include <vector>
+
 #include "common/Types.h"
 #include "common/Utils.h"
 #include "nlohmann/json.hpp"
@@ -17,6 +21,35 @@
 
 namespace milvus::segcore {
 
+namespace {
+
+// the bytes of the rows of a repeated string or bytes field
+template <typename Strings>
+std::vector<std::string_view>
+RowBytes(const Strings& strings) {
+    std::vector<std::string_view> rows;
+    rows.reserve(strings.size());
+    for (auto& str : strings) {
+        rows.emplace_back(str);
+    }
+    return rows;
+}
+
+// the bytes of the rows of a varchar or json column
+std::vector<std::string_view>
+RowBytes(const InsertColumn& column, ssize_t count) {
+    auto bytes = static_cast<const char*>(column.data);
+    std::vector<std::string_view> rows;
+    rows.reserve(count);
+    for (ssize_t i = 0; i < count; ++i) {
+        rows.emplace_back(bytes + column.offsets[i],
+                          column.offsets[i + 1] - column.offsets[i]);
+    }
+    return rows;
+}
+
+}  // namespace
+
 void
 VectorBase::set_data_raw(ssize_t element_offset,
                          ssize_t element_count,
@@ -69,20 +102,55 @@ VectorBase::set_data_raw(ssize_t element_offset,
                 element_offset, FIELD_DATA(data, double).data(), element_count);
         }
         case DataType::VARCHAR: {
-            auto& field_data = FIELD_DATA(data, string);
-            std::vector<std::string> data_raw(field_data.begin(),
-                                              field_data.end());
-            return set_data_raw(element_offset, data_raw.data(), element_count);
+            auto rows = RowBytes(FIELD_DATA(data, string));
+            return static_cast<ConcurrentVector<std::string>*>(this)->set_rows(
+                element_offset, rows.data(), element_count);
         }
         case DataType::JSON: {
-            auto& json_data = FIELD_DATA(data, json);
-            std::vector<Json> data_raw{};
-            data_raw.reserve(json_data.size());
-            for (auto& json_bytes : json_data) {
-                data_raw.emplace_back(simdjson::padded_string(json_bytes));
-            }
+            auto rows = RowBytes(FIELD_DATA(data, json));
+            return static_cast<ConcurrentVector<Json>*>(this)->set_rows(
+                element_offset, rows.data(), element_count);
+        }
+        default: {
+            PanicInfo(fmt::format("unsupported datatype {}",
+                                  field_meta.get_data_type()));
+        }
+    }
+}
 
-            return set_data_raw(element_offset, data_raw.data(), element_count);
+void
+VectorBase::set_data_raw(ssize_t element_offset,
+                         ssize_t element_count,
+                         const InsertColumn& column,
+                         const FieldMeta& field_meta) {
+    AssertInfo(column.data != nullptr || element_count == 0,
+               "empty column of field " +
+                   std::to_string(column.field_id.get()));
+    switch (field_meta.get_data_type()) {
+        case DataType::VARCHAR: {
+            AssertInfo(column.offsets != nullptr,
+                       "varchar column without offsets");
+            auto rows = RowBytes(column, element_count);
+            return static_cast<ConcurrentVector<std::string>*>(this)->set_rows(
+                element_offset, rows.data(), element_count);
+        }
+        case DataType::JSON: {
+            AssertInfo(column.offsets != nullptr,
+                       "json column without offsets");
+            auto rows = RowBytes(column, element_count);
+            return static_cast<ConcurrentVector<Json>*>(this)->set_rows(
+                element_offset, rows.data(), element_count);
+        }
+        case DataType::BOOL:
+        case DataType::INT8:
+        case DataType::INT16:
+        case DataType::INT32:
+        case DataType::INT64:
+        case DataType::FLOAT:
+        case DataType::DOUBLE:
+        case DataType::VECTOR_FLOAT:
+        case DataType::VECTOR_BINARY: {
+            return set_data_raw(element_offset, column.data, element_count);
         }
         default: {
             PanicInfo(fmt::format("unsupported datatype {}",
@@ -139,28 +207,14 @@ VectorBase::fill_chunk_data(ssize_t element_count,
                                    element_count);
         }
         case DataType::VARCHAR: {
-            auto vec = static_cast<ConcurrentVector<std::string>*>(this);
-            auto count = FIELD_DATA(data, string).size();
-            vec->grow_on_demand(count);
-            auto& chunk = vec->get_chunk(0);
-
-            size_t index = 0;
-            for (auto& str : FIELD_DATA(data, string)) {
-                chunk[index++] = str;
-            }
-            return;
+            auto rows = RowBytes(FIELD_DATA(data, string));
+            return static_cast<ConcurrentVector<std::string>*>(this)
+                ->fill_rows(rows.data(), rows.size());
         }
         case DataType::JSON: {
-            auto vec = static_cast<ConcurrentVector<Json>*>(this);
-            auto count = FIELD_DATA(data, json).size();
-            vec->grow_on_demand(count);
-            auto& chunk = vec->get_chunk(0);
-
-            size_t index = 0;
-            for (auto& str : FIELD_DATA(data, json)) {
-                chunk[index++] = Json(simdjson::padded_string(str));
-            }
-            return;
+            auto rows = RowBytes(FIELD_DATA(data, json));
+            return static_cast<ConcurrentVector<Json>*>(this)->fill_rows(
+                rows.data(), rows.size());
         }
         default: {
             PanicInfo("unsupported");
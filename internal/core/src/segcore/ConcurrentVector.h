@@ -11,12 +11,16 @@
 
 #pragma once
 
+#include <boost/container/vector.hpp>
 #include <fmt/core.h>
 #include <tbb/concurrent_vector.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstring>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
@@ -26,69 +30,170 @@
 #include <vector>
 
 #include "common/FieldMeta.h"
+#include "common/Float16.h"
 #include "common/Json.h"
 #include "common/Span.h"
 #include "common/Types.h"
 #include "common/Utils.h"
+#include "common/ZoneMap.h"
 #include "exceptions/EasyAssert.h"
+#include "segcore/ChunkArena.h"
 
 namespace milvus::segcore {
 
+// A growable vector whose elements never move once constructed.
+// Elements live in segments of doubling capacity, indexed by a fixed table
+// of atomic pointers, so readers never take a lock: a reader which observed
+// `size()` > index through the acquire load may access the element directly.
+// Writers serialize on growth.
 template <typename Type>
 class ThreadSafeVector {
  public:
+    ThreadSafeVector() = default;
+    ThreadSafeVector(const ThreadSafeVector&) = delete;
+    ThreadSafeVector&
+    operator=(const ThreadSafeVector&) = delete;
+
+    ~ThreadSafeVector() {
+        clear();
+    }
+
     template <typename... Args>
     void
     emplace_to_at_least(int64_t size, Args... args) {
-        if (size <= size_) {
+        if (size <= size_.load(std::memory_order_acquire)) {
             return;
         }
         std::lock_guard lck(mutex_);
-        while (vec_.size() < size) {
-            vec_.emplace_back(std::forward<Args...>(args...));
-            ++size_;
+        auto current = size_.load(std::memory_order_relaxed);
+        while (current < size) {
+            auto [segment_id, offset] = locate(current);
+            auto& slot = segments_[segment_id];
+            auto segment = slot.load(std::memory_order_relaxed);
+            if (segment == nullptr) {
+                segment = allocator_.allocate(segment_capacity(segment_id));
+                slot.store(segment, std::memory_order_release);
+            }
+            new (segment + offset) Type(args...);
+            ++current;
+            // publish the element only after it has been constructed
+            size_.store(current, std::memory_order_release);
         }
     }
+
     const Type&
     operator[](int64_t index) const {
-        AssertInfo(index < size_,
-                   fmt::format(
-                       "index out of range, index={}, size_={}", index, size_));
-        std::shared_lock lck(mutex_);
-        return vec_[index];
+        return at(index);
     }
 
     Type&
     operator[](int64_t index) {
-        AssertInfo(index < size_,
-                   fmt::format(
-                       "index out of range, index={}, size_={}", index, size_));
-        std::shared_lock lck(mutex_);
-        return vec_[index];
+        return at(index);
     }
 
     int64_t
     size() const {
-        return size_;
+        return size_.load(std::memory_order_acquire);
     }
 
+    // NOTE: not safe against concurrent readers, same as destruction
     void
     clear() {
         std::lock_guard lck(mutex_);
-        size_ = 0;
-        vec_.clear();
+        auto size = size_.load(std::memory_order_relaxed);
+        for (int64_t i = 0; i < size; ++i) {
+            at(i).~Type();
+        }
+        for (int64_t i = 0; i < MAX_SEGMENTS; ++i) {
+            auto segment = segments_[i].load(std::memory_order_relaxed);
+            if (segment != nullptr) {
+                allocator_.deallocate(segment, segment_capacity(i));
+                segments_[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        size_.store(0, std::memory_order_release);
+    }
+
+ private:
+    // with B = FIRST_SEGMENT_BITS, segment 0 holds [0, 2^B) and
+    // segment k > 0 holds [2^(B+k-1), 2^(B+k))
+    static constexpr int64_t FIRST_SEGMENT_BITS = 3;
+    static constexpr int64_t MAX_SEGMENTS = 64 - FIRST_SEGMENT_BITS;
+
+    static int64_t
+    segment_capacity(int64_t segment_id) {
+        return segment_id == 0
+                   ? int64_t(1) << FIRST_SEGMENT_BITS
+                   : int64_t(1) << (FIRST_SEGMENT_BITS + segment_id - 1);
+    }
+
+    static std::pair<int64_t, int64_t>
+    locate(int64_t index) {
+        auto high = static_cast<uint64_t>(index) >> FIRST_SEGMENT_BITS;
+        if (high == 0) {
+            return {0, index};
+        }
+        int64_t segment_id = 64 - __builtin_clzll(high);
+        return {segment_id, index - segment_capacity(segment_id)};
+    }
+
+    Type&
+    at(int64_t index) const {
+        AssertInfo(index < size(),
+                   fmt::format("index out of range, index={}, size_={}",
+                               index,
+                               size()));
+        auto [segment_id, offset] = locate(index);
+        return segments_[segment_id].load(std::memory_order_acquire)[offset];
     }
 
  private:
     std::atomic<int64_t> size_ = 0;
-    std::deque<Type> vec_;
-    mutable std::shared_mutex mutex_;
+    std::atomic<Type*> segments_[MAX_SEGMENTS] = {};
+    std::allocator<Type> allocator_;
+    std::mutex mutex_;
+};
+
+// heap bytes a value owns beyond its sizeof
+template <typename Type>
+inline int64_t
+PayloadBytes(const Type& value) {
+    if constexpr (std::is_same_v<Type, std::string>) {
+        // short strings are stored inline
+        return value.capacity() > std::string().capacity()
+                   ? value.capacity() + 1
+                   : 0;
+    } else if constexpr (std::is_same_v<Type, Json>) {
+        return value.own_data_size();
+    } else if constexpr (std::is_same_v<Type, PkType>) {
+        if (auto str = std::get_if<std::string>(&value)) {
+            return PayloadBytes(*str);
+        }
+        return 0;
+    } else {
+        return 0;
+    }
+}
+
+// The values of one field of an insert in their raw layout, which needs
+// no decoding: fixed width values and the rows of vectors are packed as
+// the vector of the field keeps them, float rows for float16 vectors too.
+// Varchar and json rows are bytes, row i is [offsets[i], offsets[i + 1])
+// of data.
+struct InsertColumn {
+    FieldId field_id;
+    const void* data = nullptr;
+    const int64_t* offsets = nullptr;
 };
 
 class VectorBase {
  public:
     explicit VectorBase(int64_t size_per_chunk)
-        : size_per_chunk_(size_per_chunk) {
+        : size_per_chunk_(size_per_chunk),
+          chunk_shift_(size_per_chunk > 0 &&
+                               (size_per_chunk & (size_per_chunk - 1)) == 0
+                           ? __builtin_ctzll(size_per_chunk)
+                           : -1) {
     }
     virtual ~VectorBase() = default;
 
@@ -106,6 +211,14 @@ class VectorBase {
                  const DataArray* data,
                  const FieldMeta& field_meta);
 
+    // fixed width and vector columns are copied into the chunks as they
+    // are, only varchar and json rows are built one by one
+    void
+    set_data_raw(ssize_t element_offset,
+                 ssize_t element_count,
+                 const InsertColumn& column,
+                 const FieldMeta& field_meta);
+
     virtual void
     fill_chunk_data(const void* source, ssize_t element_count) = 0;
 
@@ -122,6 +235,18 @@ class VectorBase {
         return size_per_chunk_;
     }
 
+    // {chunk id, offset in the chunk} of the element `element_offset`, a
+    // shift and a mask when the chunks hold a power of two elements
+    std::pair<int64_t, int64_t>
+    locate(int64_t element_offset) const {
+        if (chunk_shift_ >= 0) {
+            return {element_offset >> chunk_shift_,
+                    element_offset & (size_per_chunk_ - 1)};
+        }
+        return {element_offset / size_per_chunk_,
+                element_offset % size_per_chunk_};
+    }
+
     virtual const void*
     get_chunk_data(ssize_t chunk_index) const = 0;
 
@@ -131,15 +256,27 @@ class VectorBase {
     virtual bool
     empty() = 0;
 
+    // bytes of the chunks and the heap payloads of their elements
+    virtual int64_t
+    memory_size() const = 0;
+
+    // min/max of the values written to the chunk so far
+    virtual AnyZoneMap
+    get_zone_map(int64_t chunk_id) const {
+        return {};
+    }
+
  protected:
     const int64_t size_per_chunk_;
+    // log2 of size_per_chunk_, -1 if it is not a power of two
+    const int chunk_shift_;
 };
 
 template <typename Type, bool is_scalar = false>
 class ConcurrentVectorImpl : public VectorBase {
  public:
     // constants
-    using Chunk = FixedVector<Type>;
+    using Chunk = boost::container::vector<Type, ArenaAllocator<Type>>;
     ConcurrentVectorImpl(ConcurrentVectorImpl&&) = delete;
     ConcurrentVectorImpl(const ConcurrentVectorImpl&) = delete;
 
@@ -156,21 +293,28 @@ class ConcurrentVectorImpl : public VectorBase {
                                               BinaryVector>>;
 
  public:
-    explicit ConcurrentVectorImpl(ssize_t dim, int64_t size_per_chunk)
-        : VectorBase(size_per_chunk), Dim(is_scalar ? 1 : dim) {
+    // chunks are allocated from `arena` if given, from the heap otherwise
+    explicit ConcurrentVectorImpl(ssize_t dim,
+                                  int64_t size_per_chunk,
+                                  ChunkArenaPtr arena = nullptr)
+        : VectorBase(size_per_chunk),
+          Dim(is_scalar ? 1 : dim),
+          allocator_(std::move(arena)) {
         // Assert(is_scalar ? dim == 1 : dim != 1);
     }
 
     void
     grow_to_at_least(int64_t element_count) override {
         auto chunk_count = upper_div(element_count, size_per_chunk_);
-        chunks_.emplace_to_at_least(chunk_count, Dim * size_per_chunk_);
+        chunks_.emplace_to_at_least(
+            chunk_count, Dim * size_per_chunk_, allocator_);
     }
 
     void
     grow_on_demand(int64_t element_count) {
         auto chunk_count = upper_div(element_count, size_per_chunk_);
-        chunks_.emplace_to_at_least(chunk_count, Dim * element_count);
+        chunks_.emplace_to_at_least(
+            chunk_count, Dim * element_count, allocator_);
     }
 
     Span<TraitType>
@@ -201,7 +345,7 @@ class ConcurrentVectorImpl : public VectorBase {
             return;
         }
         AssertInfo(chunks_.size() == 0, "no empty concurrent vector");
-        chunks_.emplace_to_at_least(1, Dim * element_count);
+        chunks_.emplace_to_at_least(1, Dim * element_count, allocator_);
         set_data(0, static_cast<const Type*>(source), element_count);
     }
 
@@ -221,8 +365,7 @@ class ConcurrentVectorImpl : public VectorBase {
     set_data(ssize_t element_offset,
              const Type* source,
              ssize_t element_count) {
-        auto chunk_id = element_offset / size_per_chunk_;
-        auto chunk_offset = element_offset % size_per_chunk_;
+        auto [chunk_id, chunk_offset] = locate(element_offset);
         ssize_t source_offset = 0;
         // first partition:
         if (chunk_offset + element_count <= size_per_chunk_) {
@@ -271,8 +414,7 @@ class ConcurrentVectorImpl : public VectorBase {
     // just for fun, don't use it directly
     const Type*
     get_element(ssize_t element_index) const {
-        auto chunk_id = element_index / size_per_chunk_;
-        auto chunk_offset = element_index % size_per_chunk_;
+        auto [chunk_id, chunk_offset] = locate(element_index);
         return get_chunk(chunk_id).data() + chunk_offset * Dim;
     }
 
@@ -280,8 +422,7 @@ class ConcurrentVectorImpl : public VectorBase {
     operator[](ssize_t element_index) const {
         AssertInfo(Dim == 1,
                    fmt::format("The value of Dim is not 1, Dim={}", Dim));
-        auto chunk_id = element_index / size_per_chunk_;
-        auto chunk_offset = element_index % size_per_chunk_;
+        auto [chunk_id, chunk_offset] = locate(element_index);
         return get_chunk(chunk_id)[chunk_offset];
     }
 
@@ -301,12 +442,64 @@ class ConcurrentVectorImpl : public VectorBase {
         return true;
     }
 
+    int64_t
+    memory_size() const override {
+        int64_t size = 0;
+        for (size_t i = 0; i < chunks_.size(); i++) {
+            size += get_chunk(i).capacity() * sizeof(Type);
+        }
+        return size + payload_bytes_.load(std::memory_order_relaxed);
+    }
+
+    // frees the first `chunk_count` chunks and keeps their ids, the caller
+    // guarantees no reader touches their elements anymore
+    void
+    release_chunks(int64_t chunk_count) {
+        chunk_count = std::min<int64_t>(chunk_count, chunks_.size());
+        for (int64_t i = 0; i < chunk_count; ++i) {
+            auto& chunk = chunks_[i];
+            chunk.clear();
+            chunk.shrink_to_fit();
+        }
+    }
+
     void
     clear() {
+        payload_bytes_ = 0;
         chunks_.clear();
+        std::lock_guard lck(zone_mutex_);
+        zone_maps_.clear();
+    }
+
+    AnyZoneMap
+    get_zone_map(int64_t chunk_id) const override {
+        if constexpr (has_zone_map) {
+            std::shared_lock lck(zone_mutex_);
+            if (chunk_id < int64_t(zone_maps_.size())) {
+                return zone_maps_[chunk_id];
+            }
+        }
+        return {};
+    }
+
+    // must be called before the rows are visible to readers
+    void
+    update_zone_map(ssize_t chunk_id, const Type* data, ssize_t count) {
+        if constexpr (has_zone_map) {
+            std::lock_guard lck(zone_mutex_);
+            if (int64_t(zone_maps_.size()) <= chunk_id) {
+                zone_maps_.resize(chunk_id + 1);
+            }
+            zone_maps_[chunk_id].Update(data, count);
+        }
     }
 
  private:
+    static constexpr bool has_zone_map = is_scalar && IsZoneMapSupported<Type>;
+    static constexpr bool has_payload = std::is_same_v<Type, std::string> ||
+                                        std::is_same_v<Type, Json> ||
+                                        std::is_same_v<Type, PkType>;
+
     void
     fill_chunk(ssize_t chunk_id,
                ssize_t chunk_offset,
@@ -328,21 +521,188 @@ class ConcurrentVectorImpl : public VectorBase {
         std::copy_n(source + source_offset * Dim,
                     element_count * Dim,
                     ptr + chunk_offset * Dim);
+        if constexpr (has_payload) {
+            int64_t bytes = 0;
+            for (ssize_t i = 0; i < element_count; ++i) {
+                bytes += PayloadBytes(ptr[chunk_offset + i]);
+            }
+            payload_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        update_zone_map(chunk_id, source + source_offset, element_count);
     }
 
     const ssize_t Dim;
 
  private:
+    ArenaAllocator<Type> allocator_;
     ThreadSafeVector<Chunk> chunks_;
+    // heap bytes of the strings and json documents copied into the chunks
+    std::atomic<int64_t> payload_bytes_ = 0;
+
+    mutable std::shared_mutex zone_mutex_;
+    std::vector<ZoneMapOf<Type>> zone_maps_;
 };
 
 template <typename Type>
 class ConcurrentVector : public ConcurrentVectorImpl<Type, true> {
  public:
     static_assert(IsScalar<Type> || std::is_same_v<Type, PkType>);
-    explicit ConcurrentVector(int64_t size_per_chunk)
+    explicit ConcurrentVector(int64_t size_per_chunk,
+                              ChunkArenaPtr arena = nullptr)
         : ConcurrentVectorImpl<Type, true>::ConcurrentVectorImpl(
-              1, size_per_chunk) {
+              1, size_per_chunk, std::move(arena)) {
+    }
+};
+
+// the element of the chunks of a growing VARCHAR or JSON column
+template <typename Type>
+using VariableView = std::
+    conditional_t<std::is_same_v<Type, std::string>, std::string_view, Type>;
+
+// Growing VARCHAR and JSON columns. The bytes of the rows are copied into
+// append-only blocks of the column, and the chunks keep views of them the
+// way sealed VariableColumn serves its rows, rather than a heap allocation
+// per row: std::string_view for VARCHAR, Json views followed by the padding
+// simdjson reads past a document for JSON. The rows of a write are copied
+// together under a lock, set_data_raw still takes std::string or Json rows.
+template <typename Type>
+class ConcurrentVariableVector
+    : public ConcurrentVectorImpl<VariableView<Type>, true> {
+    using View = VariableView<Type>;
+    using Base = ConcurrentVectorImpl<View, true>;
+    static constexpr bool is_json = std::is_same_v<Type, Json>;
+    static constexpr size_t PADDING = is_json ? simdjson::SIMDJSON_PADDING : 0;
+
+ public:
+    static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+    explicit ConcurrentVariableVector(int64_t size_per_chunk,
+                                      ChunkArenaPtr arena = nullptr)
+        : Base(1, size_per_chunk, arena), arena_(std::move(arena)) {
+    }
+
+    void
+    set_data_raw(ssize_t element_offset,
+                 const void* source,
+                 ssize_t element_count) override {
+        auto rows = row_bytes(static_cast<const Type*>(source), element_count);
+        set_rows(element_offset, rows.data(), element_count);
+    }
+
+    // same as set_data_raw, from the bytes of the rows
+    void
+    set_rows(ssize_t element_offset,
+             const std::string_view* rows,
+             ssize_t element_count) {
+        if (element_count == 0) {
+            return;
+        }
+        auto views = copy_rows(rows, element_count);
+        Base::set_data_raw(element_offset, views.data(), element_count);
+    }
+
+    void
+    fill_chunk_data(const void* source, ssize_t element_count) override {
+        auto rows = row_bytes(static_cast<const Type*>(source), element_count);
+        fill_rows(rows.data(), element_count);
+    }
+
+    // same as fill_chunk_data, from the bytes of the rows
+    void
+    fill_rows(const std::string_view* rows, ssize_t element_count) {
+        if (element_count == 0) {
+            return;
+        }
+        auto views = copy_rows(rows, element_count);
+        Base::fill_chunk_data(views.data(), element_count);
+    }
+
+    int64_t
+    memory_size() const override {
+        std::lock_guard lck(blocks_mutex_);
+        return Base::memory_size() + block_bytes_;
+    }
+
+ private:
+    static std::vector<std::string_view>
+    row_bytes(const Type* rows, ssize_t count) {
+        std::vector<std::string_view> bytes;
+        bytes.reserve(count);
+        for (ssize_t i = 0; i < count; ++i) {
+            bytes.emplace_back(rows[i]);
+        }
+        return bytes;
+    }
+
+    std::vector<View>
+    copy_rows(const std::string_view* rows, ssize_t count) {
+        size_t bytes = PADDING;
+        for (ssize_t i = 0; i < count; ++i) {
+            bytes += rows[i].size();
+        }
+        auto pos = allocate(bytes);
+        std::vector<View> views;
+        views.reserve(count);
+        for (ssize_t i = 0; i < count; ++i) {
+            auto size = rows[i].size();
+            if (size > 0) {
+                std::memcpy(pos, rows[i].data(), size);
+            }
+            views.emplace_back(pos, size);
+            pos += size;
+        }
+        if constexpr (is_json) {
+            std::memset(pos, 0, PADDING);
+        }
+        return views;
+    }
+
+    // bumps the last block, a write larger than a block gets its own
+    char*
+    allocate(size_t bytes) {
+        std::lock_guard lck(blocks_mutex_);
+        if (block_left_ < bytes) {
+            auto size = std::max(bytes, BLOCK_SIZE);
+            if (arena_ != nullptr) {
+                block_ = static_cast<char*>(arena_->allocate(size, 1));
+            } else {
+                blocks_.emplace_back(new char[size]);
+                block_ = blocks_.back().get();
+            }
+            block_left_ = size;
+            block_bytes_ += size;
+        }
+        auto pos = block_;
+        block_ += bytes;
+        block_left_ -= bytes;
+        return pos;
+    }
+
+    ChunkArenaPtr arena_;
+    mutable std::mutex blocks_mutex_;
+    // without an arena
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* block_ = nullptr;
+    size_t block_left_ = 0;
+    int64_t block_bytes_ = 0;
+};
+
+template <>
+class ConcurrentVector<std::string>
+    : public ConcurrentVariableVector<std::string> {
+ public:
+    explicit ConcurrentVector(int64_t size_per_chunk,
+                              ChunkArenaPtr arena = nullptr)
+        : ConcurrentVariableVector(size_per_chunk, std::move(arena)) {
+    }
+};
+
+template <>
+class ConcurrentVector<Json> : public ConcurrentVariableVector<Json> {
+ public:
+    explicit ConcurrentVector(int64_t size_per_chunk,
+                              ChunkArenaPtr arena = nullptr)
+        : ConcurrentVariableVector(size_per_chunk, std::move(arena)) {
     }
 };
 
@@ -350,9 +710,11 @@ template <>
 class ConcurrentVector<FloatVector>
     : public ConcurrentVectorImpl<float, false> {
  public:
-    ConcurrentVector(int64_t dim, int64_t size_per_chunk)
+    ConcurrentVector(int64_t dim,
+                     int64_t size_per_chunk,
+                     ChunkArenaPtr arena = nullptr)
         : ConcurrentVectorImpl<float, false>::ConcurrentVectorImpl(
-              dim, size_per_chunk) {
+              dim, size_per_chunk, std::move(arena)) {
     }
 };
 
@@ -360,8 +722,11 @@ template <>
 class ConcurrentVector<BinaryVector>
     : public ConcurrentVectorImpl<uint8_t, false> {
  public:
-    explicit ConcurrentVector(int64_t dim, int64_t size_per_chunk)
-        : binary_dim_(dim), ConcurrentVectorImpl(dim / 8, size_per_chunk) {
+    explicit ConcurrentVector(int64_t dim,
+                              int64_t size_per_chunk,
+                              ChunkArenaPtr arena = nullptr)
+        : binary_dim_(dim),
+          ConcurrentVectorImpl(dim / 8, size_per_chunk, std::move(arena)) {
         AssertInfo(dim % 8 == 0,
                    fmt::format("dim is not a multiple of 8, dim={}", dim));
     }
@@ -370,4 +735,138 @@ class ConcurrentVector<BinaryVector>
     int64_t binary_dim_;
 };
 
+// float vectors kept as half floats, in half the memory of
+// ConcurrentVector<FloatVector>. Rows are converted on write and decoded by
+// the readers, get_chunk_data returns the raw float16_t rows.
+class ConcurrentFloat16Vector : public VectorBase {
+ public:
+    using Chunk =
+        boost::container::vector<float16_t, ArenaAllocator<float16_t>>;
+
+    ConcurrentFloat16Vector(int64_t dim,
+                            int64_t size_per_chunk,
+                            ChunkArenaPtr arena = nullptr)
+        : VectorBase(size_per_chunk), dim_(dim), allocator_(std::move(arena)) {
+    }
+
+    void
+    grow_to_at_least(int64_t element_count) override {
+        auto chunk_count = upper_div(element_count, size_per_chunk_);
+        chunks_.emplace_to_at_least(
+            chunk_count, dim_ * size_per_chunk_, allocator_);
+    }
+
+    void
+    set_data_raw(ssize_t element_offset,
+                 const void* source,
+                 ssize_t element_count) override {
+        if (element_count == 0) {
+            return;
+        }
+        grow_to_at_least(element_offset + element_count);
+        set_data(element_offset,
+                 static_cast<const float*>(source),
+                 element_count);
+    }
+
+    void
+    fill_chunk_data(const void* source, ssize_t element_count) override {
+        if (element_count == 0) {
+            return;
+        }
+        AssertInfo(chunks_.size() == 0, "no empty concurrent vector");
+        chunks_.emplace_to_at_least(1, dim_ * element_count, allocator_);
+        EncodeFloat16(static_cast<const float*>(source),
+                      element_count * dim_,
+                      chunks_[0].data());
+    }
+
+    SpanBase
+    get_span_base(int64_t chunk_id) const override {
+        PanicInfo("float16 vector has no float span");
+    }
+
+    const void*
+    get_chunk_data(ssize_t chunk_index) const override {
+        return chunks_[chunk_index].data();
+    }
+
+    ssize_t
+    num_chunk() const override {
+        return chunks_.size();
+    }
+
+    bool
+    empty() override {
+        for (size_t i = 0; i < chunks_.size(); i++) {
+            if (chunks_[i].size() > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int64_t
+    memory_size() const override {
+        int64_t size = 0;
+        for (size_t i = 0; i < chunks_.size(); i++) {
+            size += chunks_[i].capacity() * sizeof(float16_t);
+        }
+        return size;
+    }
+
+    int64_t
+    get_dim() const {
+        return dim_;
+    }
+
+    // decode rows [element_offset, element_offset + element_count), which
+    // must not cross a chunk
+    void
+    decode_rows(int64_t element_offset,
+                int64_t element_count,
+                float* output) const {
+        auto [chunk_id, chunk_offset] = locate(element_offset);
+        AssertInfo(chunk_offset + element_count <= size_per_chunk_,
+                   "decoded rows cross a chunk");
+        auto& chunk = chunks_[chunk_id];
+        DecodeFloat16(
+            chunk.data() + chunk_offset * dim_, element_count * dim_, output);
+    }
+
+    // output[i] = row seg_offsets[i], rows at INVALID_SEG_OFFSET are skipped
+    void
+    gather_rows(const int64_t* seg_offsets,
+                int64_t count,
+                float* output) const {
+        for (int64_t i = 0; i < count; ++i) {
+            if (seg_offsets[i] != INVALID_SEG_OFFSET) {
+                decode_rows(seg_offsets[i], 1, output + i * dim_);
+            }
+        }
+    }
+
+ private:
+    void
+    set_data(ssize_t element_offset,
+             const float* source,
+             ssize_t element_count) {
+        while (element_count > 0) {
+            auto [chunk_id, chunk_offset] = locate(element_offset);
+            auto count = std::min<ssize_t>(element_count,
+                                           size_per_chunk_ - chunk_offset);
+            auto& chunk = chunks_[chunk_id];
+            EncodeFloat16(
+                source, count * dim_, chunk.data() + chunk_offset * dim_);
+            source += count * dim_;
+            element_offset += count;
+            element_count -= count;
+        }
+    }
+
+    const int64_t dim_;
+    ArenaAllocator<float16_t> allocator_;
+    ThreadSafeVector<Chunk> chunks_;
+};
+
 }  // namespace milvus::segcore
@@ -0,0 +1,145 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/DeleteBuffer.h"
+
+#include <numeric>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// a batch of the entries, sorted by timestamp
+std::shared_ptr<const DeleteBuffer::Batch>
+MakeBatch(std::vector<std::pair<Timestamp, PkType>> entries) {
+    std::sort(entries.begin(), entries.end());
+    auto batch = std::make_shared<DeleteBuffer::Batch>();
+    batch->pks.reserve(entries.size());
+    batch->timestamps.reserve(entries.size());
+    batch->min_pk = entries.front().second;
+    batch->max_pk = entries.front().second;
+    batch->memory_bytes =
+        entries.size() * (sizeof(PkType) + sizeof(Timestamp));
+    for (auto& [timestamp, pk] : entries) {
+        if (pk < batch->min_pk) {
+            batch->min_pk = pk;
+        }
+        if (batch->max_pk < pk) {
+            batch->max_pk = pk;
+        }
+        if (auto str = std::get_if<std::string>(&pk)) {
+            batch->memory_bytes += PayloadBytes(*str);
+        }
+        batch->timestamps.push_back(timestamp);
+        batch->pks.push_back(std::move(pk));
+    }
+    return batch;
+}
+
+}  // namespace
+
+void
+DeleteBuffer::push(const PkType* pks,
+                   const Timestamp* timestamps,
+                   int64_t size) {
+    if (size == 0) {
+        return;
+    }
+    AssertInfo(pks[0].index() != 0, "deleted pk is empty");
+    std::vector<std::pair<Timestamp, PkType>> entries(size);
+    for (int64_t i = 0; i < size; ++i) {
+        entries[i] = {timestamps[i], pks[i]};
+    }
+    auto batch = MakeBatch(std::move(entries));
+
+    std::lock_guard lck(mutex_);
+    auto& batches = snapshot_->batches;
+    AssertInfo(batches.empty() ||
+                   batches.front()->pks.front().index() == pks[0].index(),
+               "the deleted pks of a collection have different types");
+    auto snapshot = std::make_shared<Snapshot>(*snapshot_);
+    snapshot->batches.push_back(std::move(batch));
+    snapshot_ = std::move(snapshot);
+}
+
+int64_t
+DeleteBuffer::compact(Timestamp oldest_query_ts) {
+    std::lock_guard lck(mutex_);
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->epoch = snapshot_->epoch + 1;
+    std::unordered_map<PkType, Timestamp> last_deletes;
+    int64_t size = 0;
+    for (auto& batch : snapshot_->batches) {
+        auto barrier = batch->barrier(oldest_query_ts);
+        for (int64_t i = 0; i < barrier; ++i) {
+            auto& last = last_deletes[batch->pks[i]];
+            last = std::max(last, batch->timestamps[i]);
+        }
+        auto count = int64_t(batch->pks.size());
+        if (barrier == 0) {
+            snapshot->batches.push_back(batch);
+        } else if (barrier < count) {
+            std::vector<std::pair<Timestamp, PkType>> rest;
+            rest.reserve(count - barrier);
+            for (auto i = barrier; i < count; ++i) {
+                rest.emplace_back(batch->timestamps[i], batch->pks[i]);
+            }
+            snapshot->batches.push_back(MakeBatch(std::move(rest)));
+        }
+        size += count - barrier;
+    }
+    if (!last_deletes.empty()) {
+        std::vector<std::pair<Timestamp, PkType>> folded;
+        folded.reserve(last_deletes.size());
+        for (auto& [pk, last] : last_deletes) {
+            folded.emplace_back(last, pk);
+        }
+        size += folded.size();
+        snapshot->batches.insert(snapshot->batches.begin(),
+                                 MakeBatch(std::move(folded)));
+    }
+    snapshot_ = std::move(snapshot);
+    return size;
+}
+
+std::pair<int64_t, int64_t>
+DeleteBuffer::barrier(Timestamp timestamp) const {
+    auto current = snapshot();
+    int64_t entries = 0;
+    for (auto& batch : current->batches) {
+        entries += batch->barrier(timestamp);
+    }
+    return {current->epoch, entries};
+}
+
+int64_t
+DeleteBuffer::size() const {
+    auto current = snapshot();
+    return std::accumulate(
+        current->batches.begin(),
+        current->batches.end(),
+        int64_t(0),
+        [](int64_t sum, auto& batch) { return sum + batch->pks.size(); });
+}
+
+int64_t
+DeleteBuffer::memory_bytes() const {
+    auto current = snapshot();
+    return std::accumulate(
+        current->batches.begin(),
+        current->batches.end(),
+        int64_t(0),
+        [](int64_t sum, auto& batch) { return sum + batch->memory_bytes; });
+}
+
+}  // namespace milvus::segcore
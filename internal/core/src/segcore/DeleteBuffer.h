@@ -0,0 +1,190 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/Types.h"
+#include "segcore/InsertRecord.h"
+
+namespace milvus::segcore {
+
+// The deletes of a collection, stored once for all of its segments rather
+// than in the DeletedRecord of every segment which may hold their pks. The
+// segments attached to it mask the rows these deletes hide next to those of
+// their own record, see DeleteBufferBitmap. A batch is sorted by timestamp,
+// the batches may arrive out of order, e.g. from different channels.
+class DeleteBuffer {
+ public:
+    struct Batch {
+        // sorted by timestamp
+        std::vector<PkType> pks;
+        std::vector<Timestamp> timestamps;
+        PkType min_pk;
+        PkType max_pk;
+        int64_t memory_bytes = 0;
+
+        // the number of entries not after `timestamp`
+        int64_t
+        barrier(Timestamp timestamp) const {
+            return std::upper_bound(
+                       timestamps.begin(), timestamps.end(), timestamp) -
+                   timestamps.begin();
+        }
+    };
+
+    // the batches at some point, as long as the epoch is the same a later
+    // snapshot has the same batches followed by newer ones
+    struct Snapshot {
+        int64_t epoch = 0;
+        std::vector<std::shared_ptr<const Batch>> batches;
+    };
+
+    // the pks of a buffer all have the same type
+    void
+    push(const PkType* pks, const Timestamp* timestamps, int64_t size);
+
+    std::shared_ptr<const Snapshot>
+    snapshot() const {
+        std::lock_guard lck(mutex_);
+        return snapshot_;
+    }
+
+    // Folds the entries not after `oldest_query_ts` into one batch of the
+    // last delete of each of their pks, which hides the same rows from the
+    // queries left. Starts a new epoch, returns the number of entries.
+    int64_t
+    compact(Timestamp oldest_query_ts);
+
+    // the epoch and the number of entries not after `timestamp`, the rows
+    // the buffer hides at `timestamp` are the same as long as they are
+    std::pair<int64_t, int64_t>
+    barrier(Timestamp timestamp) const;
+
+    int64_t
+    size() const;
+
+    int64_t
+    memory_bytes() const;
+
+ private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const Snapshot> snapshot_ = std::make_shared<Snapshot>();
+};
+
+using DeleteBufferPtr = std::shared_ptr<DeleteBuffer>;
+
+// The rows of a segment hidden by the deletes of a DeleteBuffer, cached for
+// the timestamp of the last query and updated with the entries after it.
+// As with get_deleted_bitmap, the rows inserted after the cache was built
+// are only checked against the newer entries.
+class DeleteBufferBitmap {
+ public:
+    template <bool is_sealed>
+    void
+    mask(const DeleteBuffer& buffer,
+         const InsertRecord<is_sealed>& insert_record,
+         BitsetType& bitset,
+         int64_t insert_barrier,
+         Timestamp timestamp);
+
+ private:
+    std::mutex mutex_;
+    int64_t epoch_ = -1;
+    // the entries of every batch applied to bitmap_
+    std::vector<int64_t> barriers_;
+    BitsetType bitmap_;
+};
+
+template <bool is_sealed>
+void
+DeleteBufferBitmap::mask(const DeleteBuffer& buffer,
+                         const InsertRecord<is_sealed>& insert_record,
+                         BitsetType& bitset,
+                         int64_t insert_barrier,
+                         Timestamp timestamp) {
+    auto snapshot = buffer.snapshot();
+    auto& batches = snapshot->batches;
+    if (batches.empty() || insert_barrier == 0) {
+        return;
+    }
+    std::vector<int64_t> barriers(batches.size());
+    for (size_t i = 0; i < batches.size(); ++i) {
+        barriers[i] = batches[i]->barrier(timestamp);
+    }
+
+    std::lock_guard lck(mutex_);
+    // an older query, or compacted batches, can't be applied on top
+    auto rebuild = snapshot->epoch != epoch_;
+    for (size_t i = 0; !rebuild && i < barriers_.size(); ++i) {
+        rebuild = barriers[i] < barriers_[i];
+    }
+    if (rebuild) {
+        epoch_ = snapshot->epoch;
+        barriers_.clear();
+        bitmap_.clear();
+    }
+    barriers_.resize(batches.size(), 0);
+    if (int64_t(bitmap_.size()) < insert_barrier) {
+        bitmap_.resize(insert_barrier);
+    }
+
+    // the last delete of every pk of the new entries, batches outside of
+    // the pk range of the segment are skipped whole
+    std::unordered_map<PkType, Timestamp> last_deletes;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        auto& batch = *batches[i];
+        if (barriers[i] > barriers_[i] &&
+            insert_record.may_contain_pk_range(batch.min_pk, batch.max_pk)) {
+            for (auto j = barriers_[i]; j < barriers[i]; ++j) {
+                auto& last = last_deletes[batch.pks[j]];
+                last = std::max(last, batch.timestamps[j]);
+            }
+        }
+        barriers_[i] = barriers[i];
+    }
+    if (!last_deletes.empty()) {
+        std::vector<PkType> pks;
+        std::vector<Timestamp> timestamps;
+        pks.reserve(last_deletes.size());
+        timestamps.reserve(last_deletes.size());
+        for (auto& [pk, last] : last_deletes) {
+            pks.push_back(pk);
+            timestamps.push_back(last);
+        }
+        std::vector<OffsetMap::PkOffset> pk_offsets;
+        insert_record.search_pks(
+            pks.data(), pks.size(), int64_t(bitmap_.size()), pk_offsets);
+        for (auto& [pk_index, offset] : pk_offsets) {
+            // a row inserted after the delete of its pk stays
+            if (insert_record.timestamp_at(offset) < timestamps[pk_index]) {
+                bitmap_.set(offset);
+            }
+        }
+    }
+
+    if (bitmap_.size() == bitset.size()) {
+        bitset |= bitmap_;
+    } else {
+        auto part = bitmap_;
+        part.resize(bitset.size());
+        bitset |= part;
+    }
+}
+
+}  // namespace milvus::segcore
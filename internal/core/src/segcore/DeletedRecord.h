@@ -11,21 +11,34 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <utility>
+#include <vector>
 
 #include "AckResponder.h"
 #include "common/Schema.h"
 #include "segcore/Record.h"
+#include "segcore/SegmentedBitmap.h"
 #include "ConcurrentVector.h"
 
 namespace milvus::segcore {
 
+// Deletes of a segment, ordered by timestamp. The pks are kept typed: an
+// int64 pk is stored as is and a string pk as the address of its bytes in
+// blocks owned by the record, so no entry owns a heap string. Once no query
+// older than some timestamp is left, the entries up to it are folded into
+// the cached bitmap by compact() and their storage is released.
 struct DeletedRecord {
     struct TmpBitmap {
         // Just for query
         int64_t del_barrier = 0;
-        BitsetTypePtr bitmap_ptr;
+        // shares unmodified blocks with the entry it was cloned from
+        SegmentedBitmap bitmap;
 
         std::shared_ptr<TmpBitmap>
         clone(int64_t capacity);
@@ -35,7 +48,189 @@ struct DeletedRecord {
         : lru_(std::make_shared<TmpBitmap>()),
           timestamps_(deprecated_size_per_chunk),
           pks_(deprecated_size_per_chunk) {
-        lru_->bitmap_ptr = std::make_shared<BitsetType>();
+    }
+
+    // fills the reserved entries [offset, offset + size) and acks them, the
+    // timestamps must be sorted, the pks of a record all have the same type
+    void
+    push(int64_t offset,
+         const PkType* pks,
+         const Timestamp* timestamps,
+         int64_t size) {
+        if (size == 0) {
+            return;
+        }
+        auto pk_index = static_cast<int>(pks[0].index());
+        AssertInfo(pk_index != 0, "deleted pk is empty");
+        auto expected = 0;
+        if (!pk_index_.compare_exchange_strong(expected, pk_index)) {
+            AssertInfo(expected == pk_index,
+                       "the deleted pks of a segment have different types");
+        }
+
+        std::vector<int64_t> encoded(size);
+        if (pk_index == int64_index) {
+            for (int64_t i = 0; i < size; ++i) {
+                encoded[i] = std::get<int64_t>(pks[i]);
+            }
+        } else {
+            int64_t bytes = 0;
+            for (int64_t i = 0; i < size; ++i) {
+                bytes +=
+                    sizeof(uint32_t) + std::get<std::string>(pks[i]).size();
+            }
+            std::unique_ptr<char[]> block(new char[bytes]);
+            auto pos = block.get();
+            for (int64_t i = 0; i < size; ++i) {
+                auto& str = std::get<std::string>(pks[i]);
+                auto length = static_cast<uint32_t>(str.size());
+                encoded[i] = reinterpret_cast<intptr_t>(pos);
+                std::memcpy(pos, &length, sizeof(length));
+                std::memcpy(pos + sizeof(length), str.data(), length);
+                pos += sizeof(length) + length;
+            }
+            std::lock_guard lck(blocks_mutex_);
+            string_bytes_ += bytes;
+            string_blocks_.push_back({offset + size, bytes, std::move(block)});
+        }
+        pks_.set_data_raw(offset, encoded.data(), size);
+        timestamps_.set_data_raw(offset, timestamps, size);
+        ack_responder_.AddSegment(offset, offset + size);
+    }
+
+    // makes this empty record a copy of `other`, of a segment with the same
+    // rows at the same offsets: the compacted entries are taken as the
+    // bitmap they were folded into, the cached bitmap is shared
+    void
+    copy_from(const DeletedRecord& other) {
+        AssertInfo(reserved.load() == 0 && ack_responder_.GetAck() == 0,
+                   "copy into a deleted record which is not empty");
+        auto other_lck = other.lock_entries();
+        auto compacted = other.compacted_count();
+        auto end = other.ack_responder_.GetAck();
+        std::vector<PkType> pks;
+        std::vector<Timestamp> timestamps;
+        pks.reserve(end - compacted);
+        timestamps.reserve(end - compacted);
+        for (auto i = compacted; i < end; ++i) {
+            pks.push_back(other.get_pk(i));
+            timestamps.push_back(other.timestamps_[i]);
+        }
+
+        std::unique_lock lck(compact_mutex_);
+        reserved.store(end);
+        pk_index_.store(other.pk_index_.load());
+        if (compacted > 0) {
+            compacted_last_ts_ = other.compacted_last_ts_;
+            compacted_.store(compacted, std::memory_order_release);
+            ack_responder_.AddSegment(0, compacted);
+        }
+        {
+            std::shared_lock other_lru_lck(other.shared_mutex_);
+            std::lock_guard lru_lck(shared_mutex_);
+            lru_ = other.lru_;
+        }
+        push(compacted, pks.data(), timestamps.data(), end - compacted);
+        auto chunks = compacted / deprecated_size_per_chunk;
+        timestamps_.release_chunks(chunks);
+        pks_.release_chunks(chunks);
+    }
+
+    // the entries before compacted_count() must not be read, see compact()
+    PkType
+    get_pk(int64_t index) const {
+        auto value = pks_[index];
+        if (pk_index_.load(std::memory_order_acquire) == int64_index) {
+            return value;
+        }
+        auto pos = reinterpret_cast<const char*>(value);
+        uint32_t length;
+        std::memcpy(&length, pos, sizeof(length));
+        return std::string(pos + sizeof(length), length);
+    }
+
+    Timestamp
+    get_timestamp(int64_t index) const {
+        return timestamps_[index];
+    }
+
+    // the number of acked entries not after `timestamp`, at least the
+    // compacted ones
+    int64_t
+    get_barrier(Timestamp timestamp) const {
+        auto lck = lock_entries();
+        int64_t beg = compacted_.load(std::memory_order_relaxed);
+        int64_t end = ack_responder_.GetAck();
+        while (beg < end) {
+            auto mid = (beg + end) / 2;
+            if (timestamps_[mid] <= timestamp) {
+                beg = mid + 1;
+            } else {
+                end = mid;
+            }
+        }
+        return beg;
+    }
+
+    // the timestamp of the last acked entry, 0 if there is none
+    Timestamp
+    last_timestamp() const {
+        auto lck = lock_entries();
+        auto n = ack_responder_.GetAck();
+        if (n == 0) {
+            return 0;
+        }
+        if (n == compacted_.load(std::memory_order_relaxed)) {
+            return compacted_last_ts_;
+        }
+        return timestamps_[n - 1];
+    }
+
+    // held while reading entries, so that compact() doesn't release them
+    std::shared_lock<std::shared_mutex>
+    lock_entries() const {
+        return std::shared_lock(compact_mutex_);
+    }
+
+    int64_t
+    compacted_count() const {
+        return compacted_.load(std::memory_order_acquire);
+    }
+
+    // Makes `entry`, the bitmap of the entries before its del_barrier, the
+    // final one. No query may be older than the last of these entries
+    // afterwards, and every insert older than it must have been applied
+    // when the bitmap was built. Releases the chunks and string blocks
+    // which only hold compacted entries.
+    void
+    compact(std::shared_ptr<TmpBitmap> entry) {
+        std::unique_lock lck(compact_mutex_);
+        auto del_barrier = entry->del_barrier;
+        if (del_barrier <= compacted_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        compacted_last_ts_ = timestamps_[del_barrier - 1];
+        {
+            std::lock_guard lru_lck(shared_mutex_);
+            if (lru_->del_barrier < del_barrier) {
+                lru_ = std::move(entry);
+            }
+        }
+        compacted_.store(del_barrier, std::memory_order_release);
+
+        auto chunks = del_barrier / deprecated_size_per_chunk;
+        timestamps_.release_chunks(chunks);
+        pks_.release_chunks(chunks);
+        std::lock_guard blocks_lck(blocks_mutex_);
+        auto it = std::partition(string_blocks_.begin(),
+                                 string_blocks_.end(),
+                                 [&](const StringBlock& block) {
+                                     return block.end > del_barrier;
+                                 });
+        for (auto cur = it; cur != string_blocks_.end(); ++cur) {
+            string_bytes_ -= cur->bytes;
+        }
+        string_blocks_.erase(it, string_blocks_.end());
     }
 
     auto
@@ -44,57 +239,100 @@ struct DeletedRecord {
         return lru_;
     }
 
+    // On a cache hit the cached entry itself is returned, it is never
+    // modified after being published. Otherwise returns a copy-on-write
+    // clone which only pays for the blocks the caller modifies.
     std::shared_ptr<TmpBitmap>
     clone_lru_entry(int64_t insert_barrier,
                     int64_t del_barrier,
                     int64_t& old_del_barrier,
                     bool& hit_cache) {
         std::shared_lock lck(shared_mutex_);
-        auto res = lru_->clone(insert_barrier);
         old_del_barrier = lru_->del_barrier;
-
-        if (lru_->bitmap_ptr->size() == insert_barrier &&
+        if (lru_->bitmap.size() == insert_barrier &&
             lru_->del_barrier == del_barrier) {
             hit_cache = true;
-        } else {
-            res->del_barrier = del_barrier;
+            return lru_;
         }
 
+        auto res = lru_->clone(insert_barrier);
+        res->del_barrier = del_barrier;
         return res;
     }
 
+    // bytes of the deleted pks and timestamps and of the cached bitmap
+    int64_t
+    memory_bytes() const {
+        int64_t bytes = timestamps_.memory_size() + pks_.memory_size();
+        {
+            std::lock_guard lck(blocks_mutex_);
+            bytes += string_bytes_;
+        }
+        std::shared_lock lck(shared_mutex_);
+        return bytes + lru_->bitmap.memory_bytes();
+    }
+
     void
     insert_lru_entry(std::shared_ptr<TmpBitmap> new_entry, bool force = false) {
         std::lock_guard lck(shared_mutex_);
         if (new_entry->del_barrier <= lru_->del_barrier) {
-            if (!force ||
-                new_entry->bitmap_ptr->size() <= lru_->bitmap_ptr->size()) {
+            if (!force || new_entry->bitmap.size() <= lru_->bitmap.size()) {
                 // DO NOTHING
                 return;
             }
         }
+        if (new_entry->del_barrier < compacted_count()) {
+            return;
+        }
         lru_ = std::move(new_entry);
     }
 
  public:
     std::atomic<int64_t> reserved = 0;
     AckResponder ack_responder_;
-    ConcurrentVector<Timestamp> timestamps_;
-    ConcurrentVector<PkType> pks_;
 
  private:
+    // the index of int64_t in PkType
+    static constexpr int int64_index = 1;
+
+    // the string pks of the entries before `end`
+    struct StringBlock {
+        int64_t end;
+        int64_t bytes;
+        std::unique_ptr<char[]> data;
+    };
+
+    ConcurrentVector<Timestamp> timestamps_;
+    // int64 pks, or addresses of a uint32 length followed by the bytes
+    ConcurrentVector<int64_t> pks_;
+    // the PkType index of the pks, 0 before the first push
+    std::atomic<int> pk_index_ = 0;
+
+    mutable std::mutex blocks_mutex_;
+    std::vector<StringBlock> string_blocks_;
+    int64_t string_bytes_ = 0;
+
+    // entries before `compacted_` are folded into the cached bitmap
+    mutable std::shared_mutex compact_mutex_;
+    std::atomic<int64_t> compacted_ = 0;
+    Timestamp compacted_last_ts_ = 0;
+
     std::shared_ptr<TmpBitmap> lru_;
-    std::shared_mutex shared_mutex_;
+    mutable std::shared_mutex shared_mutex_;
 };
 
+inline int64_t
+get_barrier(const DeletedRecord& record, Timestamp timestamp) {
+    return record.get_barrier(timestamp);
+}
+
 inline auto
 DeletedRecord::TmpBitmap::clone(int64_t capacity)
     -> std::shared_ptr<TmpBitmap> {
     auto res = std::make_shared<TmpBitmap>();
     res->del_barrier = this->del_barrier;
-    res->bitmap_ptr = std::make_shared<BitsetType>();
-    *(res->bitmap_ptr) = *(this->bitmap_ptr);
-    res->bitmap_ptr->resize(capacity, false);
+    res->bitmap = this->bitmap;
+    res->bitmap.resize(capacity);
     return res;
 }
 
@@ -0,0 +1,117 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "segcore/ExprResultCache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+std::optional<BitsetType>
+ExprResultCache::Get(int64_t generation,
+                     const std::string& key,
+                     int64_t row_count) {
+    std::lock_guard lck(mutex_);
+    if (generation != generation_) {
+        return std::nullopt;
+    }
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.row_count != row_count) {
+        return std::nullopt;
+    }
+    auto& entry = it->second;
+    lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+    if (entry.bits.has_value()) {
+        return entry.bits;
+    }
+    BitsetType result(row_count);
+    if (entry.inverted) {
+        result.set();
+    }
+    for (auto offset : entry.offsets) {
+        result[offset] = !entry.inverted;
+    }
+    return result;
+}
+
+void
+ExprResultCache::Put(int64_t generation,
+                     const std::string& key,
+                     const BitsetType& result,
+                     int64_t capacity) {
+    AssertInfo(result.size() <= std::numeric_limits<uint32_t>::max(),
+               "too many rows to cache the expr result");
+    Entry entry;
+    entry.row_count = result.size();
+    auto set_count = int64_t(result.count());
+    entry.inverted = set_count * 2 > entry.row_count;
+    auto offset_count =
+        entry.inverted ? entry.row_count - set_count : set_count;
+    auto offsets_size = offset_count * int64_t(sizeof(uint32_t));
+    auto bits_size =
+        int64_t(result.num_blocks() * sizeof(BitsetType::block_type));
+    if (offsets_size < bits_size) {
+        auto bits = entry.inverted ? ~result : result;
+        entry.offsets.reserve(offset_count);
+        for (auto i = bits.find_first(); i != BitsetType::npos;
+             i = bits.find_next(i)) {
+            entry.offsets.push_back(i);
+        }
+    } else {
+        entry.bits = result;
+    }
+    entry.size = int64_t(sizeof(Entry) + key.size()) +
+                 std::min(offsets_size, bits_size);
+    if (entry.size > capacity) {
+        return;
+    }
+
+    std::lock_guard lck(mutex_);
+    if (generation != generation_) {
+        // computed before a load
+        return;
+    }
+    auto [it, inserted] = entries_.try_emplace(key);
+    if (!inserted) {
+        return;
+    }
+    lru_.push_front(&it->first);
+    entry.lru_pos = lru_.begin();
+    cached_bytes_ += entry.size;
+    it->second = std::move(entry);
+    while (cached_bytes_ > capacity) {
+        auto victim = entries_.find(*lru_.back());
+        cached_bytes_ -= victim->second.size;
+        lru_.pop_back();
+        entries_.erase(victim);
+    }
+}
+
+void
+ExprResultCache::Clear(int64_t generation) {
+    std::lock_guard lck(mutex_);
+    generation_ = generation;
+    cached_bytes_ = 0;
+    lru_.clear();
+    entries_.clear();
+}
+
+int64_t
+ExprResultCache::CachedBytes() const {
+    std::lock_guard lck(mutex_);
+    return cached_bytes_;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,73 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// LRU cache of the predicate results of a sealed segment, keyed by the
+// serialized predicate. An entry keeps the offsets of its set or of its
+// unset bits when that's smaller than the bitset, so selective filters,
+// the common case, take a few bytes. Entries are tagged with the load
+// generation of the segment, a result computed before a load is never
+// served after it.
+class ExprResultCache {
+ public:
+    // the result of `key` over `row_count` rows, nullopt if it isn't cached
+    std::optional<BitsetType>
+    Get(int64_t generation, const std::string& key, int64_t row_count);
+
+    // evicts the least recently used results over `capacity` bytes
+    void
+    Put(int64_t generation,
+        const std::string& key,
+        const BitsetType& result,
+        int64_t capacity);
+
+    // drops all the results, only results of `generation` are cached next
+    void
+    Clear(int64_t generation);
+
+    int64_t
+    CachedBytes() const;
+
+ private:
+    struct Entry {
+        int64_t row_count;
+        // offsets of the set bits, of the unset ones if inverted, unless
+        // the bitset is smaller
+        bool inverted;
+        std::vector<uint32_t> offsets;
+        std::optional<BitsetType> bits;
+        int64_t size;
+        std::list<const std::string*>::iterator lru_pos;
+    };
+
+    mutable std::mutex mutex_;
+    int64_t generation_ = 0;
+    int64_t cached_bytes_ = 0;
+    // keys of entries_, the most recently used first
+    std::list<const std::string*> lru_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,180 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/Column.h"
+#include "common/ColumnCache.h"
+#include "common/FieldMeta.h"
+#include "common/LoadInfo.h"
+#include "common/Utils.h"
+#include "exceptions/EasyAssert.h"
+#include "fmt/core.h"
+#include "storage/FieldData.h"
+
+// The columns of a FieldDataInfo are built here, so common/Column.h only
+// adopts the mappings and doesn't depend on storage
+namespace milvus::segcore {
+
+// Calls func(data, size) with the raw bytes of the field datas in order
+template <typename Func>
+inline void
+ForEachFieldDataBuffer(const FieldDataInfo& info, Func&& func) {
+    for (auto& data : info.datas) {
+        if (!datatype_is_variable(data->get_data_type())) {
+            func(static_cast<const char*>(data->Data()), data->Size());
+            continue;
+        }
+        for (ssize_t i = 0; i < data->get_num_rows(); ++i) {
+            func(static_cast<const char*>(data->RawValue(i)),
+                 data->get_element_size(i));
+        }
+    }
+}
+
+inline bool
+MapsFile(const FieldDataInfo& info) {
+    return info.mmap_dir_path != nullptr ||
+           (!info.cache_key.empty() && ColumnCache::GetInstance().Enabled());
+}
+
+// Same as CreateMap of DataArray, the field datas are copied into the
+// memory or written to the mmap file just once
+inline void*
+MapFieldDatas(int64_t segment_id,
+              const FieldMeta& field_meta,
+              const FieldDataInfo& info) {
+    auto policy = info.mmap_policy.value_or(DefaultMmapPolicy(field_meta));
+
+    size_t data_size = 0;
+    for (auto& data : info.datas) {
+        data_size += data->Size();
+    }
+    if (data_size == 0) {
+        return nullptr;
+    }
+    // simdjson requires a padding following the json data
+    size_t padding = field_meta.get_data_type() == DataType::JSON
+                         ? simdjson::SIMDJSON_PADDING
+                         : 0;
+
+    auto& cache = ColumnCache::GetInstance();
+    auto cached = !info.cache_key.empty() && cache.Enabled();
+    if (cached) {
+        if (auto map = cache.Map(info.cache_key, data_size, policy.populate);
+            map != nullptr) {
+            AdviseMap(map, data_size, policy);
+            PopulateMap(map, data_size, policy);
+            return map;
+        }
+    }
+
+    if (info.mmap_dir_path == nullptr && !cached) {
+        return CreateAnonMap(data_size + padding, policy, [&](void* map) {
+            auto dst = static_cast<char*>(map);
+            ForEachFieldDataBuffer(info, [&](const char* data, size_t size) {
+                memcpy(dst, data, size);
+                dst += size;
+            });
+        });
+    }
+
+    auto filepath =
+        cached ? cache.WritePath(info.cache_key)
+               : std::filesystem::path(info.mmap_dir_path) /
+                     std::to_string(segment_id) /
+                     std::to_string(info.field_id);
+    auto map = CreateFileMap(filepath, padding, policy, cached, [&](int fd) {
+        // variable length elements are small, batch them to save syscalls
+        constexpr size_t write_batch_size = 1 << 20;
+        std::string pending;
+        size_t written = 0;
+        auto flush = [&](const char* data, size_t size) {
+            while (size > 0) {
+                auto n = write(fd, data, size);
+                AssertInfo(n > 0,
+                           fmt::format("failed to write data file {}, err: {}",
+                                       filepath.c_str(),
+                                       strerror(errno)));
+                data += n;
+                size -= n;
+                written += n;
+            }
+        };
+        ForEachFieldDataBuffer(info, [&](const char* data, size_t size) {
+            if (size >= write_batch_size) {
+                flush(pending.data(), pending.size());
+                pending.clear();
+                flush(data, size);
+                return;
+            }
+            pending.append(data, size);
+            if (pending.size() >= write_batch_size) {
+                flush(pending.data(), pending.size());
+                pending.clear();
+            }
+        });
+        flush(pending.data(), pending.size());
+        AssertInfo(written == data_size,
+                   fmt::format("failed to write data file {}, written {} but "
+                               "total {}",
+                               filepath.c_str(),
+                               written,
+                               data_size));
+        return written;
+    });
+    if (cached) {
+        // the file outlives the segment, a later load maps it again
+        cache.Commit(info.cache_key, filepath, data_size);
+    }
+    return map;
+}
+
+inline std::unique_ptr<Column>
+MakeColumn(int64_t segment_id,
+           const FieldMeta& field_meta,
+           const FieldDataInfo& info) {
+    auto map = MapFieldDatas(segment_id, field_meta, info);
+    return std::make_unique<Column>(
+        field_meta, map, info.row_count, MapsFile(info));
+}
+
+template <typename T>
+inline std::unique_ptr<VariableColumn<T>>
+MakeVariableColumn(int64_t segment_id,
+                   const FieldMeta& field_meta,
+                   const FieldDataInfo& info) {
+    size_t size = 0;
+    std::vector<uint64_t> indices;
+    indices.reserve(info.row_count);
+    for (auto& data : info.datas) {
+        for (ssize_t i = 0; i < data->get_num_rows(); ++i) {
+            indices.push_back(size);
+            size += data->get_element_size(i);
+        }
+    }
+    return std::make_unique<VariableColumn<T>>(
+        MapFieldDatas(segment_id, field_meta, info),
+        size,
+        std::move(indices),
+        MapsFile(info));
+}
+
+}  // namespace milvus::segcore
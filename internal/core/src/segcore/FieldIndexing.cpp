@@ -9,8 +9,11 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
+#include "index/BitmapIndex.h"
 #include "index/ScalarIndexSort.h"
 #include "index/StringIndexSort.h"
 
@@ -21,6 +24,26 @@
 
 namespace milvus::segcore {
 
+namespace {
+// rows [begin, begin + count) of one chunk of a float vector field, half
+// float rows are decoded into `buffer`
+const float*
+ChunkRows(const VectorBase* vec_base,
+          int64_t dim,
+          int64_t begin,
+          int64_t count,
+          std::vector<float>& buffer) {
+    if (auto fp16 = dynamic_cast<const ConcurrentFloat16Vector*>(vec_base)) {
+        buffer.resize(count * dim);
+        fp16->decode_rows(begin, count, buffer.data());
+        return buffer.data();
+    }
+    auto [chunk_id, chunk_offset] = vec_base->locate(begin);
+    auto chunk = vec_base->get_chunk_data(chunk_id);
+    return static_cast<const float*>(chunk) + chunk_offset * dim;
+}
+}  // namespace
+
 VectorFieldIndexing::VectorFieldIndexing(const FieldMeta& field_meta,
                                          const FieldIndexMeta& field_index_meta,
                                          int64_t segment_max_row_count,
@@ -51,7 +74,9 @@ VectorFieldIndexing::BuildIndexRange(int64_t ack_beg,
             knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, knowhere::metric::L2);
         auto dataset = knowhere::GenDataSet(
             source->get_size_per_chunk(), dim, chunk.data());
-        indexing->BuildWithDataset(dataset, conf);
+        // the chunks stay until the segment is released, the index reads
+        // the vectors from them
+        indexing->BuildWithBorrowedDataset(dataset, conf);
         data_[chunk_id] = std::move(indexing);
     }
 }
@@ -82,9 +107,8 @@ VectorFieldIndexing::AppendSegmentIndex(int64_t reserved_offset,
 
     auto dim = field_meta_.get_dim();
     auto conf = get_build_params();
-    auto source = dynamic_cast<const ConcurrentVector<FloatVector>*>(vec_base);
-
-    auto per_chunk = source->get_size_per_chunk();
+    auto per_chunk = vec_base->get_size_per_chunk();
+    std::vector<float> buffer;
     //append vector [vector_id_beg, vector_id_end] into index
     //build index [vector_id_beg, build_threshold) when index not exist
     if (!index_.get()) {
@@ -99,7 +123,7 @@ VectorFieldIndexing::AppendSegmentIndex(int64_t reserved_offset,
         std::unique_ptr<float[]> vec_data;
         //all train data in one chunk
         if (chunk_id_beg == chunk_id_end) {
-            data_addr = vec_base->get_chunk_data(chunk_id_beg);
+            data_addr = ChunkRows(vec_base, dim, vector_id_beg, vec_num, buffer);
         } else {
             //merge data from multiple chunks together
             vec_data = std::make_unique<float[]>(vec_num * dim);
@@ -113,8 +137,11 @@ VectorFieldIndexing::AppendSegmentIndex(int64_t reserved_offset,
                         ? vector_id_end - chunk_id * per_chunk + 1
                         : per_chunk;
                 std::memcpy(vec_data.get() + offset * dim,
-                            (const float*)vec_base->get_chunk_data(chunk_id) +
-                                chunk_offset * dim,
+                            ChunkRows(vec_base,
+                                      dim,
+                                      chunk_id * per_chunk + chunk_offset,
+                                      chunk_copysz,
+                                      buffer),
                             chunk_copysz * dim * sizeof(float));
                 offset += chunk_copysz;
             }
@@ -125,8 +152,9 @@ VectorFieldIndexing::AppendSegmentIndex(int64_t reserved_offset,
         auto indexing = std::make_unique<index::VectorMemIndex>(
             config_->GetIndexType(), config_->GetMetricType());
         indexing->BuildWithDataset(dataset, conf);
-        index_cur_.fetch_add(vec_num);
+        // searches only look at the index once the cursor moves
         index_ = std::move(indexing);
+        index_cur_.fetch_add(vec_num);
     }
     //append rest data when index exist
     idx_t vector_id_beg = index_cur_.load();
@@ -140,7 +168,12 @@ VectorFieldIndexing::AppendSegmentIndex(int64_t reserved_offset,
         return;
     }
 
-    if (sync_with_index.load()) {
+    // an index not taking concurrent adds waits for the searches
+    std::unique_lock lck(index_mutex_, std::defer_lock);
+    if (!config_->SupportsConcurrentAdd()) {
+        lck.lock();
+    }
+    if (sync_with_index.load() && data_source != nullptr) {
         auto dataset = knowhere::GenDataSet(vec_num, dim, data_source);
         index_->AddWithDataset(dataset, conf);
         index_cur_.fetch_add(vec_num);
@@ -156,8 +189,11 @@ VectorFieldIndexing::AppendSegmentIndex(int64_t reserved_offset,
             auto dataset = knowhere::GenDataSet(
                 chunk_sz,
                 dim,
-                (const float*)source->get_chunk_data(chunk_id) +
-                    chunk_offset * dim);
+                ChunkRows(vec_base,
+                          dim,
+                          chunk_id * per_chunk + chunk_offset,
+                          chunk_sz,
+                          buffer));
             index_->AddWithDataset(dataset, conf);
             index_cur_.fetch_add(chunk_sz);
         }
@@ -180,7 +216,7 @@ VectorFieldIndexing::get_search_params(const SearchInfo& searchInfo) const {
 }
 
 idx_t
-VectorFieldIndexing::get_index_cursor() {
+VectorFieldIndexing::get_index_cursor() const {
     return index_cur_.load();
 }
 bool
@@ -188,6 +224,21 @@ VectorFieldIndexing::sync_data_with_index() const {
     return sync_with_index.load();
 }
 
+int64_t
+VectorFieldIndexing::memory_bytes() const {
+    int64_t bytes = 0;
+    for (auto& index : data_) {
+        if (index != nullptr) {
+            bytes += index->ByteSize();
+        }
+    }
+    auto lck = lock_for_search();
+    if (index_ != nullptr) {
+        bytes += index_->ByteSize();
+    }
+    return bytes;
+}
+
 template <typename T>
 void
 ScalarFieldIndexing<T>::BuildIndexRange(int64_t ack_beg,
@@ -203,7 +254,17 @@ ScalarFieldIndexing<T>::BuildIndexRange(int64_t ack_beg,
         // build index for chunk
         // TODO
         if constexpr (std::is_same_v<T, std::string>) {
+            // the chunk keeps views of the strings
+            std::vector<std::string> strings(chunk.begin(), chunk.end());
             auto indexing = index::CreateStringIndexSort();
+            indexing->Build(strings.size(), strings.data());
+            data_[chunk_id] = std::move(indexing);
+        } else if (index::HasLowCardinality(
+                       vec_base->get_size_per_chunk(),
+                       chunk.data(),
+                       DEFAULT_BITMAP_INDEX_CARDINALITY_LIMIT)) {
+            // a few distinct values, predicates are unions of postings
+            auto indexing = index::CreateBitmapIndex<T>();
             indexing->Build(vec_base->get_size_per_chunk(), chunk.data());
             data_[chunk_id] = std::move(indexing);
         } else {
@@ -230,6 +291,14 @@ CreateIndex(const FieldMeta& field_meta,
             PanicInfo("unsupported");
         }
     }
+    auto indexing = CreateScalarIndex(field_meta, segcore_config);
+    AssertInfo(indexing != nullptr, "unsupported");
+    return indexing;
+}
+
+std::unique_ptr<FieldIndexing>
+CreateScalarIndex(const FieldMeta& field_meta,
+                  const SegcoreConfig& segcore_config) {
     switch (field_meta.get_data_type()) {
         case DataType::BOOL:
             return std::make_unique<ScalarFieldIndexing<bool>>(field_meta,
@@ -256,7 +325,7 @@ CreateIndex(const FieldMeta& field_meta,
             return std::make_unique<ScalarFieldIndexing<std::string>>(
                 field_meta, segcore_config);
         default:
-            PanicInfo("unsupported");
+            return nullptr;
     }
 }
 
@@ -11,9 +11,12 @@
 
 #pragma once
 
+#include <chrono>
 #include <optional>
 #include <map>
 #include <memory>
+#include <shared_mutex>
+#include <vector>
 
 #include <tbb/concurrent_vector.h>
 #include <index/Index.h>
@@ -48,6 +51,8 @@ class FieldIndexing {
                     int64_t ack_end,
                     const VectorBase* vec_base) = 0;
 
+    // adds the rows up to reserved_offset + size to the segment index, the
+    // rows of data_source or, if null, of vec_base
     virtual void
     AppendSegmentIndex(int64_t reserved_offset,
                        int64_t size,
@@ -66,13 +71,19 @@ class FieldIndexing {
     virtual bool
     sync_data_with_index() const = 0;
 
+    // the index can return the raw data of the rows it holds
+    virtual bool
+    has_raw_data() const {
+        return false;
+    }
+
     const FieldMeta&
     get_field_meta() {
         return field_meta_;
     }
 
     virtual idx_t
-    get_index_cursor() = 0;
+    get_index_cursor() const = 0;
 
     int64_t
     get_size_per_chunk() const {
@@ -85,6 +96,10 @@ class FieldIndexing {
     virtual index::IndexBase*
     get_segment_indexing() const = 0;
 
+    // bytes held by the chunk and segment indexes built so far
+    virtual int64_t
+    memory_bytes() const = 0;
+
  protected:
     // additional info
     const FieldMeta& field_meta_;
@@ -117,7 +132,7 @@ class ScalarFieldIndexing : public FieldIndexing {
         PanicInfo("scalar index don't support get data from index");
     }
     idx_t
-    get_index_cursor() override {
+    get_index_cursor() const override {
         return 0;
     }
 
@@ -143,6 +158,17 @@ class ScalarFieldIndexing : public FieldIndexing {
         return nullptr;
     }
 
+    int64_t
+    memory_bytes() const override {
+        int64_t bytes = 0;
+        for (auto& index : data_) {
+            if (index != nullptr) {
+                bytes += index->ByteSize();
+            }
+        }
+        return bytes;
+    }
+
  private:
     tbb::concurrent_vector<index::ScalarIndexPtr<T>> data_;
 };
@@ -189,11 +215,30 @@ class VectorFieldIndexing : public FieldIndexing {
         return index_.get();
     }
 
+    int64_t
+    memory_bytes() const override;
+
     bool
     sync_data_with_index() const override;
 
+    bool
+    has_raw_data() const override {
+        return config_->HasRawData();
+    }
+
+    // held while searching the segment index, adds to an index not taking
+    // concurrent adds wait for it
+    std::shared_lock<std::shared_mutex>
+    lock_for_search() const {
+        if (config_->SupportsConcurrentAdd()) {
+            return {};
+        }
+        return std::shared_lock(index_mutex_);
+    }
+
+    // rows [0, cursor) are in the segment index
     idx_t
-    get_index_cursor() override;
+    get_index_cursor() const override;
 
     knowhere::Json
     get_build_params() const;
@@ -206,6 +251,7 @@ class VectorFieldIndexing : public FieldIndexing {
     std::atomic<bool> sync_with_index;
     std::unique_ptr<VecIndexConfig> config_;
     std::unique_ptr<index::VectorIndex> index_;
+    mutable std::shared_mutex index_mutex_;
     tbb::concurrent_vector<std::unique_ptr<index::VectorIndex>> data_;
 };
 
@@ -215,6 +261,11 @@ CreateIndex(const FieldMeta& field_meta,
             int64_t segment_max_row_count,
             const SegcoreConfig& segcore_config);
 
+// chunk indexes of a scalar field, nullptr for the types without one
+std::unique_ptr<FieldIndexing>
+CreateScalarIndex(const FieldMeta& field_meta,
+                  const SegcoreConfig& segcore_config);
+
 class IndexingRecord {
  public:
     explicit IndexingRecord(const Schema& schema,
@@ -237,6 +288,13 @@ class IndexingRecord {
                 if (field_meta.get_data_type() == DataType::VECTOR_BINARY) {
                     continue;
                 }
+                // an interim index with the raw data would keep a float copy
+                // of the half float vectors
+                if (segcore_config_.get_enable_growing_fp16_vector() &&
+                    VecIndexConfig::IndexHasRawData(
+                        VecIndexConfig::GetInterimIndexType(segcore_config_))) {
+                    continue;
+                }
                 //Small-Index disabled, create index for vector filed only
                 if (index_meta_->GetIndexMaxRowCount() > 0 &&
                     index_meta_->HasFiled(field_id)) {
@@ -248,10 +306,106 @@ class IndexingRecord {
                                     segcore_config_));
                 }
             }
+            if (!field_meta.is_vector() &&
+                segcore_config_.get_growing_chunk_freeze_ms() >= 0) {
+                if (auto indexing =
+                        CreateScalarIndex(field_meta, segcore_config_)) {
+                    chunk_indexings_.try_emplace(field_id,
+                                                 std::move(indexing));
+                }
+            }
         }
         assert(offset_id == schema_.size());
     }
 
+    // Freezes the chunks whose rows are all acked and which have been full
+    // for growing_chunk_freeze_ms: every hot scalar field of them gets a
+    // chunk index, which filters then use instead of the raw data. Same as
+    // the sealed indexes, these never change. A field turning hot later
+    // gets the indexes of all frozen chunks. Returns the number of frozen
+    // chunks.
+    int64_t
+    FreezeChunks(const InsertRecord<false>& record) {
+        std::lock_guard lck(mutex_);
+        auto frozen = frozen_chunks_.load(std::memory_order_relaxed);
+        if (chunk_indexings_.empty()) {
+            return frozen;
+        }
+        auto full_chunks = record.ack_responder_.GetAck() /
+                           segcore_config_.get_chunk_rows();
+        auto now = std::chrono::steady_clock::now();
+        // a chunk counts as full since the first call which found it full
+        while (int64_t(full_since_.size()) < full_chunks) {
+            full_since_.push_back(now);
+        }
+        auto freeze_after = std::chrono::milliseconds(
+            segcore_config_.get_growing_chunk_freeze_ms());
+        auto end = frozen;
+        while (end < full_chunks && now - full_since_[end] >= freeze_after) {
+            ++end;
+        }
+        for (auto& [field_id, chunk_indexing] : chunk_indexings_) {
+            auto field_frozen =
+                chunk_indexing.frozen.load(std::memory_order_relaxed);
+            if (field_frozen >= end || !is_hot(chunk_indexing)) {
+                continue;
+            }
+            chunk_indexing.indexing->BuildIndexRange(
+                field_frozen, end, record.get_field_data_base(field_id));
+            chunk_indexing.frozen.store(end, std::memory_order_release);
+        }
+        frozen_chunks_.store(end, std::memory_order_release);
+        return end;
+    }
+
+    // FreezeChunks has work once `full_chunks` are full
+    bool
+    FreezePending(int64_t full_chunks) const {
+        auto frozen = frozen_chunks_.load(std::memory_order_acquire);
+        if (full_chunks > frozen) {
+            return !chunk_indexings_.empty();
+        }
+        for (auto& [field_id, chunk_indexing] : chunk_indexings_) {
+            if (chunk_indexing.frozen.load(std::memory_order_acquire) <
+                    frozen &&
+                is_hot(chunk_indexing)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // counts a filter reading the field, with growing_chunk_index_min_filters
+    // set only the fields read by as many filters get chunk indexes
+    void
+    record_filter(FieldId field_id) const {
+        auto it = chunk_indexings_.find(field_id);
+        if (it != chunk_indexings_.end()) {
+            it->second.filters.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // [0, num_frozen_chunks) of the field have a chunk index
+    int64_t
+    num_frozen_chunks(FieldId field_id) const {
+        auto it = chunk_indexings_.find(field_id);
+        if (it == chunk_indexings_.end()) {
+            return 0;
+        }
+        return it->second.frozen.load(std::memory_order_acquire);
+    }
+
+    bool
+    has_chunk_indexing(FieldId field_id) const {
+        return chunk_indexings_.count(field_id);
+    }
+
+    const FieldIndexing&
+    get_chunk_indexing(FieldId field_id) const {
+        Assert(chunk_indexings_.count(field_id));
+        return *chunk_indexings_.at(field_id).indexing;
+    }
+
     // concurrent, reentrant
     template <bool is_sealed>
     void
@@ -260,6 +414,21 @@ class IndexingRecord {
                    FieldId fieldId,
                    const DataArray* stream_data,
                    const InsertRecord<is_sealed>& record) {
+        AppendingIndex(reserved_offset,
+                       size,
+                       fieldId,
+                       stream_data->vectors().float_vector().data().data(),
+                       record);
+    }
+
+    // same as above, from the raw float rows of the insert
+    template <bool is_sealed>
+    void
+    AppendingIndex(int64_t reserved_offset,
+                   int64_t size,
+                   FieldId fieldId,
+                   const float* stream_data,
+                   const InsertRecord<is_sealed>& record) {
         if (is_in(fieldId)) {
             auto& indexing = field_indexings_.at(fieldId);
             if (indexing->get_field_meta().is_vector() &&
@@ -268,14 +437,43 @@ class IndexingRecord {
                 reserved_offset + size >= indexing->get_build_threshold()) {
                 auto vec_base = record.get_field_data_base(fieldId);
                 indexing->AppendSegmentIndex(
-                    reserved_offset,
-                    size,
-                    vec_base,
-                    stream_data->vectors().float_vector().data().data());
+                    reserved_offset, size, vec_base, stream_data);
             }
         }
     }
 
+    // catches the segment indexes up with the acked rows of `record`, run
+    // in the background when growing_index_async_build is set, so the
+    // inserts do not pay for it; the searches brute force the rows after
+    // the index cursor
+    void
+    BuildIndexes(const InsertRecord<false>& record) {
+        auto ack = record.ack_responder_.GetAck();
+        for (auto& [field_id, indexing] : field_indexings_) {
+            if (indexing->get_field_meta().get_data_type() ==
+                    DataType::VECTOR_FLOAT &&
+                ack >= indexing->get_build_threshold() &&
+                ack > indexing->get_index_cursor()) {
+                indexing->AppendSegmentIndex(
+                    0, ack, record.get_field_data_base(field_id), nullptr);
+            }
+        }
+    }
+
+    // some segment index is behind the first `ack` rows
+    bool
+    IndexBehind(int64_t ack) const {
+        for (auto& [field_id, indexing] : field_indexings_) {
+            if (indexing->get_field_meta().get_data_type() ==
+                    DataType::VECTOR_FLOAT &&
+                ack >= indexing->get_build_threshold() &&
+                ack > indexing->get_index_cursor()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     void
     GetDataFromIndex(FieldId fieldId,
                      const int64_t* seg_offsets,
@@ -302,6 +500,16 @@ class IndexingRecord {
         }
         return false;
     }
+
+    // the index holds the raw data of all inserted rows, which are then
+    // neither kept in the insert record nor read from it. An index built
+    // in the background lags behind, the record keeps all the rows then.
+    bool
+    HasRawData(FieldId fieldId) const {
+        return !segcore_config_.get_growing_index_async_build() &&
+               SyncDataWithIndex(fieldId) &&
+               get_field_indexing(fieldId).has_raw_data();
+    }
     // concurrent
     int64_t
     get_finished_ack() const {
@@ -352,6 +560,33 @@ class IndexingRecord {
  private:
     // field_offset => indexing
     std::map<FieldId, std::unique_ptr<FieldIndexing>> field_indexings_;
+
+    struct ChunkIndexing {
+        explicit ChunkIndexing(std::unique_ptr<FieldIndexing> indexing)
+            : indexing(std::move(indexing)) {
+        }
+
+        std::unique_ptr<FieldIndexing> indexing;
+        // [0, frozen) have a chunk index
+        std::atomic<int64_t> frozen = 0;
+        // filters which read the field so far
+        mutable std::atomic<int64_t> filters = 0;
+    };
+
+    bool
+    is_hot(const ChunkIndexing& chunk_indexing) const {
+        auto min_filters =
+            segcore_config_.get_growing_chunk_index_min_filters();
+        return min_filters <= 0 ||
+               chunk_indexing.filters.load(std::memory_order_relaxed) >=
+                   min_filters;
+    }
+
+    // chunk indexes of the scalar fields, built by FreezeChunks
+    std::map<FieldId, ChunkIndexing> chunk_indexings_;
+    // the chunks [0, frozen_chunks_) are old enough to be indexed
+    std::atomic<int64_t> frozen_chunks_ = 0;
+    std::vector<std::chrono::steady_clock::time_point> full_since_;
 };
 
 }  // namespace milvus::segcore
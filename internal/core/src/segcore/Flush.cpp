@@ -0,0 +1,172 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/Flush.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "common/Consts.h"
+#include "common/Json.h"
+#include "exceptions/EasyAssert.h"
+#include "storage/InsertData.h"
+#include "storage/PayloadWriter.h"
+#include "storage/ThreadPool.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// the encoded payload of the first `rows` rows of `vec`, and the bytes of
+// their values
+std::pair<std::vector<uint8_t>, int64_t>
+EncodeColumn(const VectorBase& vec,
+             DataType data_type,
+             int64_t dim,
+             int64_t rows) {
+    auto writer = datatype_is_vector(data_type)
+                      ? std::make_unique<storage::PayloadWriter>(data_type,
+                                                                 dim)
+                      : std::make_unique<storage::PayloadWriter>(data_type);
+    int64_t bytes = 0;
+    auto size_per_chunk = vec.get_size_per_chunk();
+    for (int64_t begin = 0; begin < rows; begin += size_per_chunk) {
+        auto chunk_rows = std::min(size_per_chunk, rows - begin);
+        auto data = vec.get_chunk_data(begin / size_per_chunk);
+        switch (data_type) {
+            case DataType::VARCHAR: {
+                auto strs = static_cast<const std::string_view*>(data);
+                for (int64_t i = 0; i < chunk_rows; ++i) {
+                    writer->add_one_string_payload(strs[i].data(),
+                                                   strs[i].size());
+                    bytes += strs[i].size();
+                }
+                break;
+            }
+            case DataType::JSON: {
+                auto jsons = static_cast<const Json*>(data);
+                for (int64_t i = 0; i < chunk_rows; ++i) {
+                    auto json = jsons[i].data();
+                    writer->add_one_binary_payload(
+                        reinterpret_cast<const uint8_t*>(json.data()),
+                        json.size());
+                    bytes += json.size();
+                }
+                break;
+            }
+            default: {
+                auto payload = storage::Payload{
+                    data_type,
+                    static_cast<const uint8_t*>(data),
+                    chunk_rows,
+                    static_cast<int>(dim)};
+                writer->add_payload(payload);
+                bytes += chunk_rows * datatype_sizeof(data_type, dim);
+            }
+        }
+    }
+    writer->finish();
+    return {writer->get_payload_buffer(), bytes};
+}
+
+}  // namespace
+
+FlushResult
+FlushGrowingSegment(const SegmentGrowingImpl& segment,
+                    const FlushInfo& info,
+                    storage::RemoteChunkManager* chunk_manager) {
+    AssertInfo(chunk_manager != nullptr, "chunk manager is null");
+    auto& insert_record = segment.get_insert_record();
+    auto row_count = info.row_count;
+    AssertInfo(row_count > 0 && row_count <= segment.get_row_count(),
+               fmt::format("can't flush {} rows of a segment of {} rows",
+                           row_count,
+                           segment.get_row_count()));
+
+    // the time range of the rows is the one of every binlog
+    auto timestamp_from = std::numeric_limits<Timestamp>::max();
+    Timestamp timestamp_to = 0;
+    auto& timestamps = insert_record.timestamps_;
+    auto ts_per_chunk = timestamps.get_size_per_chunk();
+    for (int64_t begin = 0; begin < row_count; begin += ts_per_chunk) {
+        auto chunk = static_cast<const Timestamp*>(
+            timestamps.get_chunk_data(begin / ts_per_chunk));
+        auto [min, max] = std::minmax_element(
+            chunk, chunk + std::min(ts_per_chunk, row_count - begin));
+        timestamp_from = std::min(timestamp_from, *min);
+        timestamp_to = std::max(timestamp_to, *max);
+    }
+
+    auto& schema = segment.get_schema();
+    FlushResult result;
+    auto& binlogs = result.binlogs;
+    binlogs.resize(info.fields.size());
+    auto& pool = ThreadPool::GetInstance();
+    pool.ParallelFor(
+        info.fields.size(), pool.GetThreadNum(), [&](int64_t i) {
+            auto field_id = info.fields[i].field_id;
+            const VectorBase* vec = nullptr;
+            auto data_type = DataType::INT64;
+            int64_t dim = 1;
+            if (field_id == RowFieldID) {
+                vec = &insert_record.row_ids_;
+            } else if (field_id == TimestampFieldID) {
+                vec = &timestamps;
+            } else {
+                auto& field_meta = schema[field_id];
+                data_type = field_meta.get_data_type();
+                if (field_meta.is_vector()) {
+                    dim = field_meta.get_dim();
+                }
+                vec = insert_record.get_field_data_base(field_id);
+                // the binlogs keep the vectors as they were inserted
+                AssertInfo(
+                    dynamic_cast<const ConcurrentFloat16Vector*>(vec) ==
+                        nullptr,
+                    fmt::format("the vectors of field {} are kept as "
+                                "float16, they can't be flushed",
+                                field_id.get()));
+            }
+            auto [payload, bytes] =
+                EncodeColumn(*vec, data_type, dim, row_count);
+            auto binlog = storage::SerializeRemoteInsertFile(
+                {info.collection_id,
+                 info.partition_id,
+                 segment.get_segment_id(),
+                 field_id.get()},
+                data_type,
+                timestamp_from,
+                timestamp_to,
+                std::move(payload),
+                bytes);
+            chunk_manager->Write(
+                info.fields[i].path, binlog.data(), binlog.size());
+            binlogs[i] = {field_id,
+                          row_count,
+                          int64_t(binlog.size()),
+                          bytes,
+                          timestamp_from,
+                          timestamp_to};
+        });
+
+    if (!info.stats_path.empty()) {
+        auto stats = insert_record.serialize_pk_stats(row_count);
+        chunk_manager->Write(info.stats_path, stats.data(), stats.size());
+        result.stats_log_size = stats.size();
+    }
+    return result;
+}
+
+}  // namespace milvus::segcore
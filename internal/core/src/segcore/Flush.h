@@ -0,0 +1,70 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/Types.h"
+#include "segcore/SegmentGrowingImpl.h"
+#include "storage/ChunkManager.h"
+
+namespace milvus::segcore {
+
+// where the binlog of a field of a growing segment is flushed to
+struct FlushFieldInfo {
+    FieldId field_id;
+    std::string path;
+};
+
+struct FlushInfo {
+    int64_t collection_id;
+    int64_t partition_id;
+    // the first `row_count` rows are flushed, at most the inserted ones
+    int64_t row_count;
+    // the row ids and timestamps among them
+    std::vector<FlushFieldInfo> fields;
+    // where the stats log of the pks is written, none if empty
+    std::string stats_path;
+};
+
+// the binlog written for a field
+struct FlushedBinlog {
+    FieldId field_id;
+    int64_t rows;
+    // bytes of the binlog and of the values in it
+    int64_t log_size;
+    int64_t memory_size;
+    Timestamp timestamp_from;
+    Timestamp timestamp_to;
+};
+
+struct FlushResult {
+    // in the order of the fields of the flush info
+    std::vector<FlushedBinlog> binlogs;
+    // bytes of the stats log, 0 if none was written
+    int64_t stats_log_size = 0;
+};
+
+// Writes a binlog per field of the rows of a growing segment. The fields
+// are encoded in parallel, the payload of each one is written from the
+// chunks of the segment as they are, and the binlogs are uploaded through
+// `chunk_manager`. The stats log holds the pk statistics the segment kept
+// as it was inserted into, they cover the rows inserted after the flushed
+// ones as well.
+FlushResult
+FlushGrowingSegment(const SegmentGrowingImpl& segment,
+                    const FlushInfo& info,
+                    storage::RemoteChunkManager* chunk_manager);
+
+}  // namespace milvus::segcore
@@ -0,0 +1,245 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/Consts.h"
+#include "exceptions/EasyAssert.h"
+#include "segcore/ConcurrentVector.h"
+
+// Row gathers used by bulk_subscript. The result of a retrieve is a batch
+// of scattered offsets, the loops prefetch the rows a fixed distance ahead
+// so their cache misses overlap, and look the chunks of a growing column
+// up once instead of for every row. Rows at INVALID_SEG_OFFSET are left as
+// they are in `dst`, `dst[i] = value` may be a raw pointer or a protobuf
+// repeated field.
+namespace milvus::segcore {
+
+constexpr int64_t GATHER_PREFETCH_DISTANCE = 16;
+
+// dst[i] = src[offsets[i]]
+template <typename T, typename Dst>
+void
+GatherRows(const T* src, const int64_t* offsets, int64_t count, Dst&& dst) {
+    for (int64_t i = 0; i < count; ++i) {
+        if (i + GATHER_PREFETCH_DISTANCE < count) {
+            auto ahead = offsets[i + GATHER_PREFETCH_DISTANCE];
+            if (ahead != INVALID_SEG_OFFSET) {
+                __builtin_prefetch(src + ahead);
+            }
+        }
+        auto offset = offsets[i];
+        if (offset != INVALID_SEG_OFFSET) {
+            dst[i] = src[offset];
+        }
+    }
+}
+
+// copies rows of `row_bytes` bytes, for vectors
+inline void
+GatherRows(const char* src,
+           int64_t row_bytes,
+           const int64_t* offsets,
+           int64_t count,
+           char* dst) {
+    for (int64_t i = 0; i < count; ++i) {
+        if (i + GATHER_PREFETCH_DISTANCE < count) {
+            auto ahead = offsets[i + GATHER_PREFETCH_DISTANCE];
+            if (ahead != INVALID_SEG_OFFSET) {
+                __builtin_prefetch(src + ahead * row_bytes);
+            }
+        }
+        auto offset = offsets[i];
+        if (offset != INVALID_SEG_OFFSET) {
+            memcpy(dst + i * row_bytes, src + offset * row_bytes, row_bytes);
+        }
+    }
+}
+
+// Columns mapped from files fault the page of each row in when it's first
+// touched, so a gather of a cold column waits for one read after another.
+// The mapped gathers sort the rows by offset, madvise(MADV_WILLNEED) the
+// pages they touch in a batch so the kernel reads them concurrently, and
+// copy the rows in offset order, ascending through the file.
+
+// pages at most this far apart are advised together, one read of the gap
+// costs less than another syscall
+constexpr int64_t GATHER_WILLNEED_MAX_GAP_PAGES = 8;
+
+// (offset, i) of the valid offsets, ascending by offset
+inline std::vector<std::pair<int64_t, int64_t>>
+SortedGatherRows(const int64_t* offsets, int64_t count) {
+    std::vector<std::pair<int64_t, int64_t>> rows;
+    rows.reserve(count);
+    for (int64_t i = 0; i < count; ++i) {
+        if (offsets[i] != INVALID_SEG_OFFSET) {
+            rows.emplace_back(offsets[i], i);
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+// asks the kernel to read the pages of the map at `map` holding the byte
+// ranges [begin, end), ascending by begin; it's a hint, so failures are
+// ignored
+inline void
+AdviseWillNeed(const char* map,
+               const std::vector<std::pair<int64_t, int64_t>>& ranges) {
+    static const int64_t page_size = getpagesize();
+    int64_t begin = 0;
+    int64_t end = 0;
+    auto advise = [&]() {
+        if (begin < end) {
+            madvise(const_cast<char*>(map) + begin, end - begin, MADV_WILLNEED);
+        }
+    };
+    for (auto [range_begin, range_end] : ranges) {
+        auto page_begin = range_begin / page_size * page_size;
+        auto page_end = (range_end + page_size - 1) / page_size * page_size;
+        if (begin < end &&
+            page_begin <= end + GATHER_WILLNEED_MAX_GAP_PAGES * page_size) {
+            end = std::max(end, page_end);
+            continue;
+        }
+        advise();
+        begin = page_begin;
+        end = page_end;
+    }
+    advise();
+}
+
+// GatherRows of a column mapped from a file
+template <typename T, typename Dst>
+void
+GatherMappedRows(const T* src,
+                 const int64_t* offsets,
+                 int64_t count,
+                 Dst&& dst) {
+    auto rows = SortedGatherRows(offsets, count);
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    ranges.reserve(rows.size());
+    for (auto [offset, i] : rows) {
+        ranges.emplace_back(offset * sizeof(T), (offset + 1) * sizeof(T));
+    }
+    AdviseWillNeed(reinterpret_cast<const char*>(src), ranges);
+    for (auto [offset, i] : rows) {
+        dst[i] = src[offset];
+    }
+}
+
+// GatherRows of rows of `row_bytes` bytes of a column mapped from a file
+inline void
+GatherMappedRows(const char* src,
+                 int64_t row_bytes,
+                 const int64_t* offsets,
+                 int64_t count,
+                 char* dst) {
+    auto rows = SortedGatherRows(offsets, count);
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    ranges.reserve(rows.size());
+    for (auto [offset, i] : rows) {
+        ranges.emplace_back(offset * row_bytes, (offset + 1) * row_bytes);
+    }
+    AdviseWillNeed(src, ranges);
+    for (auto [offset, i] : rows) {
+        memcpy(dst + i * row_bytes, src + offset * row_bytes, row_bytes);
+    }
+}
+
+// Resolves the chunk of each row of a chunked column with the chunk base
+// pointers taken once; `row_elements` elements of T make up a row.
+template <typename T>
+class ChunkedRows {
+ public:
+    explicit ChunkedRows(const VectorBase& vec, int64_t row_elements = 1)
+        : vec_(vec), row_elements_(row_elements) {
+        auto num_chunk = vec.num_chunk();
+        chunks_.reserve(num_chunk);
+        for (int64_t i = 0; i < num_chunk; ++i) {
+            chunks_.push_back(static_cast<const T*>(vec.get_chunk_data(i)));
+        }
+    }
+
+    const T*
+    row(int64_t offset) const {
+        auto [chunk_id, chunk_offset] = vec_.locate(offset);
+        AssertInfo(chunk_id < int64_t(chunks_.size()),
+                   "row offset out of range");
+        return chunks_[chunk_id] + chunk_offset * row_elements_;
+    }
+
+ private:
+    const VectorBase& vec_;
+    const int64_t row_elements_;
+    std::vector<const T*> chunks_;
+};
+
+// dst[i] = vec[offsets[i]] of a scalar ConcurrentVector
+template <typename T, typename Dst>
+void
+GatherChunkedRows(const VectorBase& vec,
+                  const int64_t* offsets,
+                  int64_t count,
+                  Dst&& dst) {
+    ChunkedRows<T> rows(vec);
+    for (int64_t i = 0; i < count; ++i) {
+        if (i + GATHER_PREFETCH_DISTANCE < count) {
+            auto ahead = offsets[i + GATHER_PREFETCH_DISTANCE];
+            if (ahead != INVALID_SEG_OFFSET) {
+                __builtin_prefetch(rows.row(ahead));
+            }
+        }
+        auto offset = offsets[i];
+        if (offset != INVALID_SEG_OFFSET) {
+            dst[i] = *rows.row(offset);
+        }
+    }
+}
+
+// copies rows of `row_bytes` bytes of a vector ConcurrentVector
+inline void
+GatherChunkedRows(const VectorBase& vec,
+                  int64_t row_bytes,
+                  const int64_t* offsets,
+                  int64_t count,
+                  char* dst) {
+    ChunkedRows<char> rows(vec, row_bytes);
+    for (int64_t i = 0; i < count; ++i) {
+        if (i + GATHER_PREFETCH_DISTANCE < count) {
+            auto ahead = offsets[i + GATHER_PREFETCH_DISTANCE];
+            if (ahead != INVALID_SEG_OFFSET) {
+                __builtin_prefetch(rows.row(ahead));
+            }
+        }
+        auto offset = offsets[i];
+        if (offset != INVALID_SEG_OFFSET) {
+            memcpy(dst + i * row_bytes, rows.row(offset), row_bytes);
+        }
+    }
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,536 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/GrowingSnapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "common/Float16.h"
+#include "common/Json.h"
+#include "exceptions/EasyAssert.h"
+#include "utils/Json.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int64_t SNAPSHOT_VERSION = 1;
+constexpr const char* META_FILE = "meta.json";
+constexpr const char* POSITION_FILE = "position";
+constexpr const char* ROW_IDS_FILE = "row_ids";
+constexpr const char* TIMESTAMPS_FILE = "timestamps";
+constexpr const char* DELETE_PKS_FILE = "deletes.pks";
+constexpr const char* DELETE_TIMESTAMPS_FILE = "deletes.timestamps";
+
+fs::path
+OffsetsPath(const fs::path& path) {
+    return path.string() + ".offsets";
+}
+
+// syncs the entries of a directory, so the files created or renamed in it
+// are kept through a crash
+void
+SyncDirectory(const fs::path& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY);
+    AssertInfo(fd != -1,
+               fmt::format("failed to open snapshot directory {}, err: {}",
+                           path.c_str(),
+                           strerror(errno)));
+    auto synced = fsync(fd) == 0;
+    auto err = errno;
+    close(fd);
+    AssertInfo(synced,
+               fmt::format("failed to fsync snapshot directory {}, err: {}",
+                           path.c_str(),
+                           strerror(err)));
+}
+
+// a file written through a buffer and synced once finished
+class SnapshotWriter {
+ public:
+    explicit SnapshotWriter(fs::path path) : path_(std::move(path)) {
+        fd_ = open(path_.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+        AssertInfo(fd_ != -1,
+                   fmt::format("failed to create snapshot file {}, err: {}",
+                               path_.c_str(),
+                               strerror(errno)));
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter&
+    operator=(const SnapshotWriter&) = delete;
+
+    ~SnapshotWriter() {
+        if (fd_ != -1) {
+            close(fd_);
+        }
+    }
+
+    void
+    Append(const void* data, size_t size) {
+        if (buffer_.size() + size > BUFFER_SIZE) {
+            Flush();
+        }
+        if (size >= BUFFER_SIZE) {
+            Write(data, size);
+            return;
+        }
+        auto bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+
+    void
+    Finish() {
+        Flush();
+        AssertInfo(fsync(fd_) == 0,
+                   fmt::format("failed to fsync snapshot file {}, err: {}",
+                               path_.c_str(),
+                               strerror(errno)));
+        close(fd_);
+        fd_ = -1;
+    }
+
+ private:
+    static constexpr size_t BUFFER_SIZE = 4 << 20;
+
+    void
+    Flush() {
+        Write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    void
+    Write(const void* data, size_t size) {
+        auto pos = static_cast<const char*>(data);
+        while (size > 0) {
+            auto written = write(fd_, pos, size);
+            if (written == -1 && errno == EINTR) {
+                continue;
+            }
+            AssertInfo(written > 0,
+                       fmt::format("failed to write snapshot file {}, err: {}",
+                                   path_.c_str(),
+                                   strerror(errno)));
+            pos += written;
+            size -= written;
+        }
+    }
+
+    fs::path path_;
+    int fd_ = -1;
+    std::vector<char> buffer_;
+};
+
+// a snapshot file mapped read only
+class SnapshotFile {
+ public:
+    explicit SnapshotFile(const fs::path& path) {
+        auto fd = open(path.c_str(), O_RDONLY);
+        AssertInfo(fd != -1,
+                   fmt::format("failed to open snapshot file {}, err: {}",
+                               path.c_str(),
+                               strerror(errno)));
+        struct stat st;
+        auto ok = fstat(fd, &st) == 0;
+        size_ = ok ? st.st_size : 0;
+        if (ok && size_ > 0) {
+            data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = data_ != MAP_FAILED;
+            if (!ok) {
+                data_ = nullptr;
+            }
+        }
+        auto err = errno;
+        close(fd);
+        AssertInfo(ok,
+                   fmt::format("failed to map snapshot file {}, err: {}",
+                               path.c_str(),
+                               strerror(err)));
+        if (data_ != nullptr) {
+            madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile&
+    operator=(const SnapshotFile&) = delete;
+
+    ~SnapshotFile() {
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+    }
+
+    template <typename T = void>
+    const T*
+    data() const {
+        return static_cast<const T*>(data_);
+    }
+
+    size_t
+    size() const {
+        return size_;
+    }
+
+ private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Writes the first `rows` rows of `vec` in the layout of an InsertColumn,
+// the offsets of varchar and json rows to OffsetsPath(path).
+void
+WriteColumn(const VectorBase& vec,
+            DataType data_type,
+            int64_t dim,
+            int64_t rows,
+            const fs::path& path) {
+    SnapshotWriter writer(path);
+    std::optional<SnapshotWriter> offsets_writer;
+    int64_t offset = 0;
+    if (datatype_is_variable(data_type)) {
+        offsets_writer.emplace(OffsetsPath(path));
+        offsets_writer->Append(&offset, sizeof(offset));
+    }
+    auto append_row = [&](std::string_view row) {
+        writer.Append(row.data(), row.size());
+        offset += row.size();
+        offsets_writer->Append(&offset, sizeof(offset));
+    };
+    auto fp16 = dynamic_cast<const ConcurrentFloat16Vector*>(&vec) != nullptr;
+    std::vector<float> floats;
+    auto size_per_chunk = vec.get_size_per_chunk();
+    for (int64_t begin = 0; begin < rows; begin += size_per_chunk) {
+        auto chunk_rows = std::min(size_per_chunk, rows - begin);
+        auto data = vec.get_chunk_data(begin / size_per_chunk);
+        if (data_type == DataType::VARCHAR) {
+            auto strs = static_cast<const std::string_view*>(data);
+            for (int64_t i = 0; i < chunk_rows; ++i) {
+                append_row(strs[i]);
+            }
+        } else if (data_type == DataType::JSON) {
+            auto jsons = static_cast<const Json*>(data);
+            for (int64_t i = 0; i < chunk_rows; ++i) {
+                append_row(jsons[i].data());
+            }
+        } else if (fp16) {
+            // the insert columns of float16 vectors are float rows
+            floats.resize(chunk_rows * dim);
+            DecodeFloat16(static_cast<const float16_t*>(data),
+                          chunk_rows * dim,
+                          floats.data());
+            writer.Append(floats.data(), floats.size() * sizeof(float));
+        } else {
+            writer.Append(data, chunk_rows * datatype_sizeof(data_type, dim));
+        }
+    }
+    writer.Finish();
+    if (offsets_writer.has_value()) {
+        offsets_writer->Finish();
+    }
+}
+
+// the bytes of a column of `rows` rows of `data_type`, checked against the
+// files, the offsets file of varchar and json columns
+void
+CheckColumn(const SnapshotFile& file,
+            const SnapshotFile* offsets,
+            DataType data_type,
+            int64_t dim,
+            int64_t rows,
+            const fs::path& path) {
+    if (offsets != nullptr) {
+        AssertInfo(offsets->size() == (rows + 1) * sizeof(int64_t) &&
+                       offsets->data<int64_t>()[rows] == file.size(),
+                   fmt::format("corrupted snapshot file {}", path.c_str()));
+        return;
+    }
+    AssertInfo(file.size() == rows * datatype_sizeof(data_type, dim),
+               fmt::format("corrupted snapshot file {}", path.c_str()));
+}
+
+}  // namespace
+
+GrowingSnapshotInfo
+SaveGrowingSnapshot(const SegmentGrowingImpl& segment,
+                    const std::string& dir,
+                    const std::string& position) {
+    auto& schema = segment.get_schema();
+    auto& insert_record = segment.get_insert_record();
+    auto& deleted_record = segment.get_deleted_record();
+    // the acked rows and deletes are never modified again
+    GrowingSnapshotInfo info;
+    info.segment_id = segment.get_segment_id();
+    info.row_count = segment.get_row_count();
+    info.position = position;
+
+    auto target = fs::path(dir).lexically_normal();
+    if (target.filename().empty()) {
+        target = target.parent_path();
+    }
+    auto parent = target.has_parent_path() ? target.parent_path()
+                                           : fs::path(".");
+    // the previous snapshot stays until this one is complete
+    auto path = fs::path(target.string() + ".saving");
+    fs::remove_all(path);
+    fs::create_directories(path);
+
+    json fields = json::array();
+    WriteColumn(insert_record.row_ids_,
+                DataType::INT64,
+                1,
+                info.row_count,
+                path / ROW_IDS_FILE);
+    WriteColumn(insert_record.timestamps_,
+                DataType::INT64,
+                1,
+                info.row_count,
+                path / TIMESTAMPS_FILE);
+    for (auto& [field_id, field_meta] : schema.get_fields()) {
+        AssertInfo(!segment.get_indexing_record().HasRawData(field_id),
+                   fmt::format("the rows of field {} are only kept by its "
+                               "index, they can't be written",
+                               field_id.get()));
+        auto data_type = field_meta.get_data_type();
+        auto dim = field_meta.is_vector() ? field_meta.get_dim() : 1;
+        WriteColumn(*insert_record.get_field_data_base(field_id),
+                    data_type,
+                    dim,
+                    info.row_count,
+                    path / std::to_string(field_id.get()));
+        fields.push_back({{"field_id", field_id.get()},
+                          {"data_type", static_cast<int>(data_type)},
+                          {"dim", dim}});
+    }
+
+    {
+        auto lck = deleted_record.lock_entries();
+        AssertInfo(deleted_record.compacted_count() == 0,
+                   "the deletes of the segment are compacted, they can't be "
+                   "written");
+        info.delete_count = deleted_record.ack_responder_.GetAck();
+        SnapshotWriter timestamps(path / DELETE_TIMESTAMPS_FILE);
+        SnapshotWriter pks(path / DELETE_PKS_FILE);
+        std::optional<SnapshotWriter> pk_offsets;
+        int64_t offset = 0;
+        for (int64_t i = 0; i < info.delete_count; ++i) {
+            auto timestamp = deleted_record.get_timestamp(i);
+            timestamps.Append(&timestamp, sizeof(timestamp));
+            auto pk = deleted_record.get_pk(i);
+            if (auto str = std::get_if<std::string>(&pk)) {
+                if (!pk_offsets.has_value()) {
+                    pk_offsets.emplace(OffsetsPath(path / DELETE_PKS_FILE));
+                    pk_offsets->Append(&offset, sizeof(offset));
+                }
+                pks.Append(str->data(), str->size());
+                offset += str->size();
+                pk_offsets->Append(&offset, sizeof(offset));
+            } else {
+                auto value = std::get<int64_t>(pk);
+                pks.Append(&value, sizeof(value));
+            }
+        }
+        timestamps.Finish();
+        pks.Finish();
+        if (pk_offsets.has_value()) {
+            pk_offsets->Finish();
+        }
+    }
+
+    // the position may be any bytes, it isn't kept in the json
+    SnapshotWriter position_writer(path / POSITION_FILE);
+    position_writer.Append(position.data(), position.size());
+    position_writer.Finish();
+
+    json meta = {{"version", SNAPSHOT_VERSION},
+                 {"segment_id", info.segment_id},
+                 {"row_count", info.row_count},
+                 {"delete_count", info.delete_count},
+                 {"fields", std::move(fields)}};
+    auto meta_str = meta.dump();
+    SnapshotWriter meta_writer(path / META_FILE);
+    meta_writer.Append(meta_str.data(), meta_str.size());
+    meta_writer.Finish();
+    SyncDirectory(path);
+
+    // swapped with the previous snapshot, which is removed after
+    if (fs::exists(target)) {
+        AssertInfo(renameat2(AT_FDCWD,
+                             path.c_str(),
+                             AT_FDCWD,
+                             target.c_str(),
+                             RENAME_EXCHANGE) == 0,
+                   fmt::format("failed to replace snapshot {}, err: {}",
+                               target.c_str(),
+                               strerror(errno)));
+        SyncDirectory(parent);
+        fs::remove_all(path);
+    } else {
+        fs::rename(path, target);
+        SyncDirectory(parent);
+    }
+    return info;
+}
+
+GrowingSnapshotInfo
+RestoreGrowingSnapshot(SegmentGrowingImpl& segment, const std::string& dir) {
+    AssertInfo(segment.get_row_count() == 0 &&
+                   segment.get_deleted_count() == 0,
+               "restore a snapshot into a segment which is not empty");
+    fs::path path(dir);
+    AssertInfo(fs::exists(path / META_FILE),
+               fmt::format("no snapshot in {}", dir));
+    json meta;
+    {
+        std::ifstream in(path / META_FILE);
+        meta = json::parse(in);
+    }
+    AssertInfo(meta.at("version").get<int64_t>() == SNAPSHOT_VERSION,
+               fmt::format("unsupported snapshot version {}",
+                           meta.at("version").dump()));
+    GrowingSnapshotInfo info;
+    info.segment_id = meta.at("segment_id").get<int64_t>();
+    info.row_count = meta.at("row_count").get<int64_t>();
+    info.delete_count = meta.at("delete_count").get<int64_t>();
+    AssertInfo(info.segment_id == segment.get_segment_id(),
+               fmt::format("the snapshot is of segment {}, not {}",
+                           info.segment_id,
+                           segment.get_segment_id()));
+    {
+        SnapshotFile position(path / POSITION_FILE);
+        info.position.assign(position.data<char>(), position.size());
+    }
+
+    auto& schema = segment.get_schema();
+    auto& fields = meta.at("fields");
+    AssertInfo(fields.size() == schema.size(),
+               "the snapshot doesn't match the schema of the segment");
+    if (info.row_count > 0) {
+        SnapshotFile row_ids(path / ROW_IDS_FILE);
+        SnapshotFile timestamps(path / TIMESTAMPS_FILE);
+        CheckColumn(row_ids,
+                    nullptr,
+                    DataType::INT64,
+                    1,
+                    info.row_count,
+                    path / ROW_IDS_FILE);
+        CheckColumn(timestamps,
+                    nullptr,
+                    DataType::INT64,
+                    1,
+                    info.row_count,
+                    path / TIMESTAMPS_FILE);
+
+        std::vector<std::unique_ptr<SnapshotFile>> files;
+        std::vector<InsertColumn> columns;
+        for (auto& field : fields) {
+            auto field_id = FieldId(field.at("field_id").get<int64_t>());
+            auto& field_meta = schema[field_id];
+            auto data_type = field_meta.get_data_type();
+            auto dim = field_meta.is_vector() ? field_meta.get_dim() : 1;
+            AssertInfo(
+                field.at("data_type").get<int>() ==
+                        static_cast<int>(data_type) &&
+                    field.at("dim").get<int64_t>() == dim,
+                fmt::format("field {} of the snapshot doesn't match the "
+                            "schema of the segment",
+                            field_id.get()));
+            auto field_path = path / std::to_string(field_id.get());
+            auto& file = files.emplace_back(
+                std::make_unique<SnapshotFile>(field_path));
+            const SnapshotFile* offsets = nullptr;
+            if (datatype_is_variable(data_type)) {
+                offsets = files
+                              .emplace_back(std::make_unique<SnapshotFile>(
+                                  OffsetsPath(field_path)))
+                              .get();
+            }
+            // float16 vectors are written as float rows, the size of the
+            // rows of the float vector field
+            CheckColumn(*file,
+                        offsets,
+                        data_type,
+                        dim,
+                        info.row_count,
+                        field_path);
+            columns.push_back(
+                {field_id,
+                 file->data(),
+                 offsets != nullptr ? offsets->data<int64_t>() : nullptr});
+        }
+        auto offset = segment.PreInsert(info.row_count);
+        AssertInfo(offset == 0, "restore into a segment with reserved rows");
+        segment.InsertColumns(offset,
+                              info.row_count,
+                              row_ids.data<int64_t>(),
+                              timestamps.data<Timestamp>(),
+                              columns);
+    }
+
+    if (info.delete_count > 0) {
+        SnapshotFile timestamps(path / DELETE_TIMESTAMPS_FILE);
+        SnapshotFile pks(path / DELETE_PKS_FILE);
+        AssertInfo(
+            timestamps.size() == info.delete_count * sizeof(Timestamp),
+            "corrupted snapshot file of the deleted timestamps");
+        IdArray ids;
+        auto pk_field_id = schema.get_primary_field_id();
+        AssertInfo(pk_field_id.has_value(), "the schema has no pk field");
+        if (schema[pk_field_id.value()].get_data_type() == DataType::VARCHAR) {
+            SnapshotFile offsets(OffsetsPath(path / DELETE_PKS_FILE));
+            CheckColumn(pks,
+                        &offsets,
+                        DataType::VARCHAR,
+                        1,
+                        info.delete_count,
+                        path / DELETE_PKS_FILE);
+            auto begins = offsets.data<int64_t>();
+            for (int64_t i = 0; i < info.delete_count; ++i) {
+                ids.mutable_str_id()->add_data(pks.data<char>() + begins[i],
+                                               begins[i + 1] - begins[i]);
+            }
+        } else {
+            CheckColumn(pks,
+                        nullptr,
+                        DataType::INT64,
+                        1,
+                        info.delete_count,
+                        path / DELETE_PKS_FILE);
+            auto data = ids.mutable_int_id()->mutable_data();
+            data->Reserve(info.delete_count);
+            for (int64_t i = 0; i < info.delete_count; ++i) {
+                data->Add(pks.data<int64_t>()[i]);
+            }
+        }
+        segment.LoadDeletedRecord(
+            {timestamps.data(), &ids, info.delete_count});
+    }
+    return info;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,56 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "segcore/SegmentGrowingImpl.h"
+
+namespace milvus::segcore {
+
+// what a snapshot holds of its segment
+struct GrowingSnapshotInfo {
+    int64_t segment_id = -1;
+    // the acked rows and deletes when it was taken
+    int64_t row_count = 0;
+    int64_t delete_count = 0;
+    // where the replay of the channel resumes after a restore, opaque to
+    // segcore, e.g. the serialized position of the last applied message
+    std::string position;
+};
+
+// Writes the acked rows and deletes of a growing segment to the local
+// directory `dir`, replacing what it held. Every column is a file in the
+// layout of an InsertColumn: fixed width values and vector rows packed as
+// the chunks keep them, float rows for float16 vectors, and the bytes of
+// varchar and json rows with a file of int64 offsets. The meta file is
+// written last, a directory without it is no snapshot. The files are
+// written and synced in a sibling directory which then takes the place of
+// `dir` in one rename, so a crash while saving leaves the previous
+// snapshot as it was.
+//
+// The interim index isn't written, it is built again from the restored
+// rows. The deletes of a segment whose deleted record was compacted can't
+// be written, they are folded into a bitmap.
+GrowingSnapshotInfo
+SaveGrowingSnapshot(const SegmentGrowingImpl& segment,
+                    const std::string& dir,
+                    const std::string& position);
+
+// Fills an empty growing segment of the same schema from the snapshot in
+// `dir`. The files are mapped and their columns inserted as they are, with
+// no decoding; they aren't needed once this returns.
+GrowingSnapshotInfo
+RestoreGrowingSnapshot(SegmentGrowingImpl& segment, const std::string& dir);
+
+}  // namespace milvus::segcore
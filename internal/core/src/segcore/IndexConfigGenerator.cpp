@@ -10,6 +10,9 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include "IndexConfigGenerator.h"
+
+#include <algorithm>
+
 #include "log/Log.h"
 
 namespace milvus::segcore {
@@ -21,7 +24,7 @@ VecIndexConfig::VecIndexConfig(const int64_t max_index_row_cout,
     origin_index_type_ = index_meta_.GetIndexType();
     metric_type_ = index_meta_.GeMetricType();
 
-    index_type_ = support_index_types[0];
+    index_type_ = GetInterimIndexType(config_);
     build_params_[knowhere::meta::METRIC_TYPE] = metric_type_;
     build_params_[knowhere::indexparam::NLIST] =
         std::to_string(config_.get_nlist());
@@ -35,6 +38,22 @@ VecIndexConfig::VecIndexConfig(const int64_t max_index_row_cout,
                       << " metric_type_: " << metric_type_;
 }
 
+knowhere::IndexType
+VecIndexConfig::GetInterimIndexType(const SegcoreConfig& config) {
+    auto& index_type = config.get_interim_index_type();
+    if (std::find(support_index_types.begin(),
+                  support_index_types.end(),
+                  index_type) == support_index_types.end()) {
+        if (!index_type.empty()) {
+            LOG_SEGCORE_WARNING_ << "unsupported interim index type "
+                                 << index_type << ", use "
+                                 << support_index_types[0];
+        }
+        return support_index_types[0];
+    }
+    return index_type;
+}
+
 int64_t
 VecIndexConfig::GetBuildThreshold() const noexcept {
     assert(VecIndexConfig::index_build_ratio.count(index_type_));
@@ -64,6 +83,8 @@ VecIndexConfig::GetSearchConf(const SearchInfo& searchInfo) {
     SearchInfo searchParam(searchInfo);
     searchParam.metric_type_ = metric_type_;
     searchParam.search_params_ = search_params_;
+    // the params of the plan don't apply to the interim index
+    searchParam.parsed_params_ = nullptr;
     return searchParam;
 }
 
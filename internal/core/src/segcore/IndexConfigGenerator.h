@@ -28,12 +28,26 @@ enum class IndexConfigLevel {
 
 class VecIndexConfig {
     inline static const std::vector<std::string> support_index_types = {
-        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC};
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC,
+        knowhere::IndexEnum::INDEX_FAISS_IVFSQ8};
 
     inline static const std::map<std::string, double> index_build_ratio = {
-        {knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC, 0.1}};
+        {knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC, 0.1},
+        {knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, 0.1}};
 
  public:
+    // interim index type of the config, the first supported one if it
+    // names none of them
+    static knowhere::IndexType
+    GetInterimIndexType(const SegcoreConfig& config);
+
+    // IVF_FLAT_CC keeps the raw vectors and takes adds during searches,
+    // IVF_SQ8 only keeps their codes and needs adds to be exclusive
+    static bool
+    IndexHasRawData(const knowhere::IndexType& index_type) {
+        return index_type == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC;
+    }
+
     VecIndexConfig(const int64_t max_index_row_count,
                    const FieldIndexMeta& index_meta_,
                    const SegcoreConfig& config);
@@ -47,6 +61,16 @@ class VecIndexConfig {
     knowhere::MetricType
     GetMetricType() noexcept;
 
+    bool
+    HasRawData() const noexcept {
+        return IndexHasRawData(index_type_);
+    }
+
+    bool
+    SupportsConcurrentAdd() const noexcept {
+        return index_type_ == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC;
+    }
+
     knowhere::Json
     GetBuildBaseParams();
 
@@ -12,9 +12,14 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -22,19 +27,39 @@
 #include "TimestampIndex.h"
 #include "common/Schema.h"
 #include "common/Types.h"
+#include "query/BlockedBruteForce.h"
+#include "query/SketchBruteForce.h"
 #include "segcore/AckResponder.h"
 #include "segcore/ConcurrentVector.h"
+#include "segcore/PkBloomFilter.h"
+#include "segcore/PkStats.h"
 #include "segcore/Record.h"
 
 namespace milvus::segcore {
 
 class OffsetMap {
  public:
+    // {index of the pk in a batch, row offset}
+    using PkOffset = std::pair<int64_t, int64_t>;
+
     virtual ~OffsetMap() = default;
 
     virtual std::vector<int64_t>
     find(const PkType& pk) const = 0;
 
+    // appends every offset of pks[i] as {i, offset} to `result`, ordered by
+    // i, so callers reusing `result` do not allocate per lookup
+    virtual void
+    find_many(const PkType* pks,
+              int64_t n,
+              std::vector<PkOffset>& result) const {
+        for (int64_t i = 0; i < n; ++i) {
+            for (auto offset : find(pks[i])) {
+                result.emplace_back(i, offset);
+            }
+        }
+    }
+
     virtual void
     insert(const PkType& pk, int64_t offset) = 0;
 
@@ -43,21 +68,113 @@ class OffsetMap {
 
     virtual bool
     empty() const = 0;
+
+    // bytes held by the map, string keys included
+    virtual int64_t
+    memory_size() const = 0;
 };
 
+template <typename T>
+inline int64_t
+VectorBytes(const std::vector<T>& vec) {
+    int64_t bytes = vec.capacity() * sizeof(T);
+    if constexpr (std::is_same_v<T, std::string>) {
+        for (auto& str : vec) {
+            bytes += PayloadBytes(str);
+        }
+    }
+    return bytes;
+}
+
+// Open addressing pk index of growing segments. A slot holds the key and a
+// single offset inline, only pks inserted more than once get a vector of
+// offsets in overflow_. String keys are views of copies in a segment owned
+// arena, so the table needs no allocation per pk.
 template <typename T>
 class OffsetHashMap : public OffsetMap {
+    static constexpr bool is_string = std::is_same_v<T, std::string>;
+    using Key = std::conditional_t<is_string, std::string_view, T>;
+
  public:
+    static constexpr int64_t MIN_CAPACITY = 1024;
+
+    explicit OffsetHashMap(ChunkArenaPtr arena = nullptr)
+        : slots_(MIN_CAPACITY) {
+        if constexpr (is_string) {
+            string_arena_ = arena != nullptr
+                                ? std::move(arena)
+                                : std::make_shared<ChunkArena>(
+                                      false, ChunkArena::HUGE_PAGE_SIZE);
+        }
+    }
+
     std::vector<int64_t>
     find(const PkType& pk) const override {
-        auto offset_vector = map_.find(std::get<T>(pk));
-        return offset_vector != map_.end() ? offset_vector->second
-                                           : std::vector<int64_t>();
+        std::vector<int64_t> offset_vector;
+        const Key& key = std::get<T>(pk);
+        auto slot = find_slot(key, hash(key));
+        if (slot != nullptr) {
+            append_offsets(*slot, [&](int64_t offset) {
+                offset_vector.push_back(offset);
+            });
+        }
+        return offset_vector;
+    }
+
+    void
+    find_many(const PkType* pks,
+              int64_t n,
+              std::vector<PkOffset>& result) const override {
+        // hash a batch ahead and prefetch its home slots, so the cache
+        // misses of a batch overlap
+        constexpr int64_t BATCH = 16;
+        uint64_t hashes[BATCH];
+        for (int64_t begin = 0; begin < n; begin += BATCH) {
+            auto end = std::min(n, begin + BATCH);
+            for (auto i = begin; i < end; ++i) {
+                hashes[i - begin] = hash(std::get<T>(pks[i]));
+                __builtin_prefetch(&slots_[hashes[i - begin] & mask()]);
+            }
+            for (auto i = begin; i < end; ++i) {
+                auto slot =
+                    find_slot(std::get<T>(pks[i]), hashes[i - begin]);
+                if (slot != nullptr) {
+                    append_offsets(*slot, [&](int64_t offset) {
+                        result.emplace_back(i, offset);
+                    });
+                }
+            }
+        }
     }
 
     void
     insert(const PkType& pk, int64_t offset) override {
-        map_[std::get<T>(pk)].emplace_back(offset);
+        // keep the load factor at most 3/4
+        if ((size_ + 1) * 4 > int64_t(slots_.size()) * 3) {
+            rehash(slots_.size() * 2);
+        }
+        const Key& key = std::get<T>(pk);
+        auto h = hash(key);
+        for (auto i = h & mask();; i = (i + 1) & mask()) {
+            auto& slot = slots_[i];
+            if (slot.value == EMPTY) {
+                slot.key = store_key(key);
+                slot.value = offset;
+                ++size_;
+                return;
+            }
+            if (slot.key == key) {
+                if (slot.value >= 0) {
+                    // the second offset of a pk moves both to overflow_
+                    auto first = slot.value;
+                    slot.value = OVERFLOW_BASE - int64_t(overflow_.size());
+                    overflow_.push_back({first, offset});
+                } else {
+                    overflow_[OVERFLOW_BASE - slot.value].push_back(offset);
+                }
+                return;
+            }
+        }
     }
 
     void
@@ -68,63 +185,393 @@ class OffsetHashMap : public OffsetMap {
 
     bool
     empty() const override {
-        return map_.empty();
+        return size_ == 0;
+    }
+
+    int64_t
+    memory_size() const override {
+        int64_t bytes = VectorBytes(slots_) + key_bytes_;
+        bytes += overflow_.capacity() * sizeof(overflow_[0]);
+        for (auto& offsets : overflow_) {
+            bytes += VectorBytes(offsets);
+        }
+        return bytes;
+    }
+
+ private:
+    static constexpr int64_t EMPTY = -1;
+    // value <= OVERFLOW_BASE refers to overflow_[OVERFLOW_BASE - value]
+    static constexpr int64_t OVERFLOW_BASE = -2;
+
+    struct Slot {
+        Key key{};
+        int64_t value = EMPTY;
+    };
+
+    static uint64_t
+    hash(const Key& key) {
+        if constexpr (is_string) {
+            return std::hash<std::string_view>()(key);
+        } else {
+            // sequential ids would fill runs of neighbouring slots
+            uint64_t h = uint64_t(key) * 0x9E3779B97F4A7C15ULL;
+            return h ^ (h >> 32);
+        }
+    }
+
+    uint64_t
+    mask() const {
+        return slots_.size() - 1;
+    }
+
+    const Slot*
+    find_slot(const Key& key, uint64_t h) const {
+        for (auto i = h & mask();; i = (i + 1) & mask()) {
+            auto& slot = slots_[i];
+            if (slot.value == EMPTY) {
+                return nullptr;
+            }
+            if (slot.key == key) {
+                return &slot;
+            }
+        }
+    }
+
+    template <typename Func>
+    void
+    append_offsets(const Slot& slot, Func func) const {
+        if (slot.value >= 0) {
+            func(slot.value);
+            return;
+        }
+        for (auto offset : overflow_[OVERFLOW_BASE - slot.value]) {
+            func(offset);
+        }
+    }
+
+    Key
+    store_key(const Key& key) {
+        if constexpr (is_string) {
+            auto data =
+                static_cast<char*>(string_arena_->allocate(key.size(), 1));
+            std::copy(key.begin(), key.end(), data);
+            key_bytes_ += key.size();
+            return Key(data, key.size());
+        } else {
+            return key;
+        }
+    }
+
+    // the keys keep pointing into the arena, only the slots move
+    void
+    rehash(int64_t capacity) {
+        std::vector<Slot> slots(capacity);
+        std::swap(slots, slots_);
+        for (auto& slot : slots) {
+            if (slot.value == EMPTY) {
+                continue;
+            }
+            auto i = hash(slot.key) & mask();
+            while (slots_[i].value != EMPTY) {
+                i = (i + 1) & mask();
+            }
+            slots_[i] = slot;
+        }
     }
 
  private:
-    std::unordered_map<T, std::vector<int64_t>> map_;
+    // power of two
+    std::vector<Slot> slots_;
+    int64_t size_ = 0;
+    std::vector<std::vector<int64_t>> overflow_;
+    ChunkArenaPtr string_arena_;
+    // bytes of the string keys copied into the arena
+    int64_t key_bytes_ = 0;
 };
 
+// Read-only pk index of sealed segments, built once by seal().
+// The distinct keys are kept sorted with their offsets in separate arrays.
+// A lookup descends an Eytzinger (BFS) ordered sample of every
+// BLOCK_SIZE-th key, which stays in cache, then searches a single block.
+// Batched lookups sort the probes and gallop forward through the keys.
+// Unique int64 keys covering a dense range are addressed directly instead.
 template <typename T>
-class OffsetOrderedArray : public OffsetMap {
+class OffsetSortedIndex : public OffsetMap {
  public:
+    static constexpr int64_t BLOCK_SIZE = 16;
+    // direct addressing is used if the key range is at most this many
+    // times the number of keys
+    static constexpr int64_t MAX_DIRECT_RANGE_RATIO = 2;
+
     std::vector<int64_t>
     find(const PkType& pk) const override {
-        if (!is_sealed)
-            PanicInfo("OffsetOrderedArray could not search before seal");
-
-        const T& target = std::get<T>(pk);
-        auto it =
-            std::lower_bound(array_.begin(),
-                             array_.end(),
-                             target,
-                             [](const std::pair<T, int64_t>& elem,
-                                const T& value) { return elem.first < value; });
-
+        AssertInfo(is_sealed_,
+                   "OffsetSortedIndex could not search before seal");
         std::vector<int64_t> offset_vector;
-        for (; it != array_.end() && it->first == target; ++it) {
-            offset_vector.push_back(it->second);
+        const T& key = std::get<T>(pk);
+        if (!direct_.empty()) {
+            auto offset = direct_find(key);
+            if (offset >= 0) {
+                offset_vector.push_back(offset);
+            }
+            return offset_vector;
+        }
+        auto [begin, end] = offset_range(key, lower_bound(key));
+        for (auto i = begin; i < end; ++i) {
+            offset_vector.push_back(offsets_[i]);
         }
-
         return offset_vector;
     }
 
+    void
+    find_many(const PkType* pks,
+              int64_t n,
+              std::vector<PkOffset>& result) const override {
+        AssertInfo(is_sealed_,
+                   "OffsetSortedIndex could not search before seal");
+        if (!direct_.empty()) {
+            for (int64_t i = 0; i < n; ++i) {
+                auto offset = direct_find(std::get<T>(pks[i]));
+                if (offset >= 0) {
+                    result.emplace_back(i, offset);
+                }
+            }
+            return;
+        }
+        // merge the sorted probes with the sorted keys
+        std::vector<int64_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+            return std::get<T>(pks[a]) < std::get<T>(pks[b]);
+        });
+        auto result_begin = result.size();
+        int64_t rank = 0;
+        for (auto i : order) {
+            const T& key = std::get<T>(pks[i]);
+            rank = gallop(key, rank);
+            auto [begin, end] = offset_range(key, rank);
+            for (auto j = begin; j < end; ++j) {
+                result.emplace_back(i, offsets_[j]);
+            }
+        }
+        std::sort(result.begin() + result_begin, result.end());
+    }
+
     void
     insert(const PkType& pk, int64_t offset) override {
-        if (is_sealed)
-            PanicInfo("OffsetOrderedArray could not insert after seal");
-        array_.push_back(std::make_pair(std::get<T>(pk), offset));
+        AssertInfo(!is_sealed_,
+                   "OffsetSortedIndex could not insert after seal");
+        pending_.emplace_back(std::get<T>(pk), offset);
     }
 
     void
     seal() override {
-        sort(array_.begin(), array_.end());
-        is_sealed = true;
+        std::sort(pending_.begin(), pending_.end());
+        auto unique = std::adjacent_find(pending_.begin(),
+                                         pending_.end(),
+                                         [](auto& a, auto& b) {
+                                             return a.first == b.first;
+                                         }) == pending_.end();
+        if constexpr (std::is_same_v<T, int64_t>) {
+            if (unique && !pending_.empty() &&
+                try_build_direct(int64_t(pending_.size()))) {
+                pending_ = {};
+                is_sealed_ = true;
+                return;
+            }
+        }
+        offsets_.reserve(pending_.size());
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            // the previous key was moved to keys_
+            if (keys_.empty() || pending_[i].first != keys_.back()) {
+                if (!unique) {
+                    starts_.push_back(offsets_.size());
+                }
+                keys_.push_back(std::move(pending_[i].first));
+            }
+            offsets_.push_back(pending_[i].second);
+        }
+        if (!unique) {
+            starts_.push_back(offsets_.size());
+        }
+        pending_ = {};
+        build_tree();
+        is_sealed_ = true;
     }
 
     bool
     empty() const override {
-        return array_.empty();
+        return is_sealed_ ? keys_.empty() && direct_.empty()
+                          : pending_.empty();
+    }
+
+    int64_t
+    memory_size() const override {
+        int64_t bytes = VectorBytes(pending_);
+        if constexpr (std::is_same_v<T, std::string>) {
+            for (auto& [key, offset] : pending_) {
+                bytes += PayloadBytes(key);
+            }
+        }
+        return bytes + VectorBytes(keys_) + VectorBytes(offsets_) +
+               VectorBytes(starts_) + VectorBytes(tree_) +
+               VectorBytes(tree_block_) + VectorBytes(direct_);
+    }
+
+ private:
+    // [begin, end) in offsets_ of key, found at `rank` by lower_bound
+    std::pair<int64_t, int64_t>
+    offset_range(const T& key, int64_t rank) const {
+        if (rank == int64_t(keys_.size()) || keys_[rank] != key) {
+            return {0, 0};
+        }
+        if (starts_.empty()) {
+            return {rank, rank + 1};
+        }
+        return {starts_[rank], starts_[rank + 1]};
+    }
+
+    // first rank whose key is not less than `key`
+    int64_t
+    lower_bound(const T& key) const {
+        if (keys_.empty()) {
+            return 0;
+        }
+        // descend to the first block whose first key is greater than `key`,
+        // 1-based BFS index k encodes the path, the answer is where the
+        // last left turn happened
+        size_t k = 1;
+        while (k < tree_.size()) {
+            k = 2 * k + !(key < tree_[k]);
+        }
+        k >>= __builtin_ffsll(~k);
+        // the key can only be in the block before that one
+        int64_t num_blocks = tree_.size() - 1;
+        auto block = k == 0 ? num_blocks - 1
+                            : std::max<int64_t>(tree_block_[k] - 1, 0);
+        auto begin = keys_.begin() + block * BLOCK_SIZE;
+        auto end = keys_.begin() + std::min<int64_t>((block + 1) * BLOCK_SIZE,
+                                                     keys_.size());
+        return std::lower_bound(begin, end, key) - keys_.begin();
+    }
+
+    // lower_bound for a key which is not less than the keys before `from`
+    int64_t
+    gallop(const T& key, int64_t from) const {
+        int64_t size = keys_.size();
+        int64_t step = 1;
+        auto lo = from;
+        auto hi = from;
+        while (hi < size && keys_[hi] < key) {
+            lo = hi + 1;
+            hi = std::min(size, hi + step);
+            step *= 2;
+        }
+        return std::lower_bound(keys_.begin() + lo, keys_.begin() + hi, key) -
+               keys_.begin();
+    }
+
+    // lays the first key of every block out in BFS order, 1-based
+    void
+    build_tree() {
+        auto num_blocks = (int64_t(keys_.size()) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        tree_.resize(num_blocks + 1);
+        tree_block_.resize(num_blocks + 1);
+        int64_t block = 0;
+        // in-order traversal of the implicit tree visits blocks in order
+        std::function<void(size_t)> fill = [&](size_t k) {
+            if (k > size_t(num_blocks)) {
+                return;
+            }
+            fill(2 * k);
+            tree_[k] = keys_[block * BLOCK_SIZE];
+            tree_block_[k] = block++;
+            fill(2 * k + 1);
+        };
+        fill(1);
+    }
+
+    bool
+    try_build_direct(int64_t num_keys) {
+        auto min = pending_.front().first;
+        auto max = pending_.back().first;
+        // unsigned to not overflow on keys of both signs
+        auto range = uint64_t(max) - uint64_t(min);
+        if (range >= uint64_t(num_keys * MAX_DIRECT_RANGE_RATIO)) {
+            return false;
+        }
+        direct_.assign(range + 1, -1);
+        for (auto& [key, offset] : pending_) {
+            direct_[uint64_t(key) - uint64_t(min)] = offset;
+        }
+        direct_min_ = min;
+        return true;
+    }
+
+    int64_t
+    direct_find(const T& key) const {
+        if constexpr (std::is_same_v<T, int64_t>) {
+            // keys below direct_min_ wrap around to large values
+            auto index = uint64_t(key) - uint64_t(direct_min_);
+            if (index >= direct_.size()) {
+                return -1;
+            }
+            return direct_[index];
+        } else {
+            return -1;
+        }
     }
 
  private:
-    bool is_sealed = false;
-    std::vector<std::pair<T, int64_t>> array_;
+    bool is_sealed_ = false;
+    std::vector<std::pair<T, int64_t>> pending_;
+
+    // sorted distinct keys
+    std::vector<T> keys_;
+    // offsets grouped by key, starts_[i] is where the offsets of keys_[i]
+    // begin; starts_ is empty if keys are unique, offsets_[i] then belongs
+    // to keys_[i]
+    std::vector<int64_t> offsets_;
+    std::vector<int64_t> starts_;
+    // first key of every block in BFS order, index 0 unused
+    std::vector<T> tree_;
+    std::vector<int64_t> tree_block_;
+
+    // offset of key at direct_[key - direct_min_], -1 if absent
+    std::vector<int64_t> direct_;
+    int64_t direct_min_ = 0;
 };
 
+// rows of a chunk of a vector field with `row_bytes` bytes per row, the
+// largest power of two whose rows fit `chunk_bytes`, at most
+// `size_per_chunk`; `size_per_chunk` if `chunk_bytes` is 0
+inline int64_t
+VectorChunkRows(int64_t row_bytes,
+                int64_t size_per_chunk,
+                int64_t chunk_bytes) {
+    if (chunk_bytes <= 0 || row_bytes <= 0 ||
+        chunk_bytes / row_bytes >= size_per_chunk) {
+        return size_per_chunk;
+    }
+    int64_t rows = 1;
+    while (rows * 2 * row_bytes <= chunk_bytes) {
+        rows *= 2;
+    }
+    return rows;
+}
+
 template <bool is_sealed = false>
 struct InsertRecord {
+    // chunks of all fields are allocated from it, null to use the heap
+    ChunkArenaPtr arena_;
+    // those of the vector fields instead if not null, e.g. an arena mapped
+    // from files
+    ChunkArenaPtr vector_arena_;
+
+    // the timestamps of a growing segment
     ConcurrentVector<Timestamp> timestamps_;
+    // those of a sealed one, loaded once
+    PackedTimestamps packed_timestamps_;
     ConcurrentVector<idx_t> row_ids_;
 
     // used for preInsert of growing segment
@@ -136,9 +583,28 @@ struct InsertRecord {
 
     // pks to row offset
     std::unique_ptr<OffsetMap> pk2offset_;
+    // checked before pk2offset_, null if disabled
+    std::unique_ptr<PkBloomFilter> pk_filter_;
 
-    InsertRecord(const Schema& schema, int64_t size_per_chunk)
-        : row_ids_(size_per_chunk), timestamps_(size_per_chunk) {
+    InsertRecord(const Schema& schema,
+                 int64_t size_per_chunk,
+                 ChunkArenaPtr arena = nullptr,
+                 bool enable_pk_filter = true,
+                 bool fp16_float_vectors = false,
+                 int64_t vector_chunk_bytes = 0,
+                 ChunkArenaPtr vector_arena = nullptr,
+                 bool vector_sketches = false)
+        : arena_(std::move(arena)),
+          vector_arena_(vector_arena != nullptr ? std::move(vector_arena)
+                                                : arena_),
+          timestamps_(size_per_chunk, arena_),
+          row_ids_(size_per_chunk, arena_) {
+        // a sealed segment builds its filter in seal_pks with the exact
+        // number of pks
+        if (enable_pk_filter && !is_sealed) {
+            pk_filter_ = std::make_unique<PkBloomFilter>();
+        }
+        enable_pk_filter_ = enable_pk_filter;
         std::optional<FieldId> pk_field_id = schema.get_primary_field_id();
 
         for (auto& field : schema) {
@@ -150,7 +616,7 @@ struct InsertRecord {
                     case DataType::INT64: {
                         if (is_sealed)
                             pk2offset_ =
-                                std::make_unique<OffsetOrderedArray<int64_t>>();
+                                std::make_unique<OffsetSortedIndex<int64_t>>();
                         else
                             pk2offset_ =
                                 std::make_unique<OffsetHashMap<int64_t>>();
@@ -159,10 +625,11 @@ struct InsertRecord {
                     case DataType::VARCHAR: {
                         if (is_sealed)
                             pk2offset_ = std::make_unique<
-                                OffsetOrderedArray<std::string>>();
+                                OffsetSortedIndex<std::string>>();
                         else
                             pk2offset_ =
-                                std::make_unique<OffsetHashMap<std::string>>();
+                                std::make_unique<OffsetHashMap<std::string>>(
+                                    arena_);
                         break;
                     }
                     default: {
@@ -171,14 +638,46 @@ struct InsertRecord {
                 }
             }
             if (field_meta.is_vector()) {
+                // only the vector fields, the filters evaluate the scalar
+                // fields chunk by chunk on the same row ranges
+                auto dim = field_meta.get_dim();
+                auto chunk_rows = [&](int64_t row_bytes) {
+                    return is_sealed ? size_per_chunk
+                                     : VectorChunkRows(row_bytes,
+                                                       size_per_chunk,
+                                                       vector_chunk_bytes);
+                };
                 if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
-                    this->append_field_data<FloatVector>(
-                        field_id, field_meta.get_dim(), size_per_chunk);
+                    if (fp16_float_vectors && !is_sealed) {
+                        fields_data_.emplace(
+                            field_id,
+                            std::make_unique<ConcurrentFloat16Vector>(
+                                dim,
+                                chunk_rows(dim * sizeof(float16_t)),
+                                vector_arena_));
+                        vector_fields_.push_back(field_id);
+                        continue;
+                    }
+                    auto rows = chunk_rows(dim * sizeof(float));
+                    this->append_field_data<FloatVector>(field_id, dim, rows);
+                    if (!is_sealed) {
+                        vector_norms_.emplace(
+                            field_id,
+                            std::make_unique<ConcurrentVector<float>>(
+                                rows, arena_));
+                    }
+                    if (!is_sealed && vector_sketches) {
+                        auto code_size = query::SketchBruteForce::CodeSize(dim);
+                        vector_sketches_.emplace(
+                            field_id,
+                            std::make_unique<ConcurrentVector<BinaryVector>>(
+                                code_size * 8, rows, arena_));
+                    }
                     continue;
                 } else if (field_meta.get_data_type() ==
                            DataType::VECTOR_BINARY) {
                     this->append_field_data<BinaryVector>(
-                        field_id, field_meta.get_dim(), size_per_chunk);
+                        field_id, dim, chunk_rows(dim / 8));
                     continue;
                 } else {
                     PanicInfo("unsupported");
@@ -234,13 +733,25 @@ struct InsertRecord {
         }
     }
 
+    Timestamp
+    timestamp_at(int64_t offset) const {
+        if constexpr (is_sealed) {
+            return packed_timestamps_[offset];
+        } else {
+            return timestamps_[offset];
+        }
+    }
+
     std::vector<SegOffset>
     search_pk(const PkType& pk, Timestamp timestamp) const {
         std::shared_lock lck(shared_mutex_);
         std::vector<SegOffset> res_offsets;
+        if (!may_contain_pk(pk)) {
+            return res_offsets;
+        }
         auto offset_iter = pk2offset_->find(pk);
         for (auto offset : offset_iter) {
-            if (timestamps_[offset] <= timestamp) {
+            if (timestamp_at(offset) <= timestamp) {
                 res_offsets.emplace_back(offset);
             }
         }
@@ -251,6 +762,9 @@ struct InsertRecord {
     search_pk(const PkType& pk, int64_t insert_barrier) const {
         std::shared_lock lck(shared_mutex_);
         std::vector<SegOffset> res_offsets;
+        if (!may_contain_pk(pk)) {
+            return res_offsets;
+        }
         auto offset_iter = pk2offset_->find(pk);
         for (auto offset : offset_iter) {
             if (offset < insert_barrier) {
@@ -260,10 +774,97 @@ struct InsertRecord {
         return res_offsets;
     }
 
+    // batched search_pk, appends {index in pks, offset} to `result`
+    void
+    search_pks(const PkType* pks,
+               int64_t n,
+               Timestamp timestamp,
+               std::vector<OffsetMap::PkOffset>& result) const {
+        std::shared_lock lck(shared_mutex_);
+        auto begin = result.size();
+        find_many(pks, n, result);
+        auto end = std::remove_if(
+            result.begin() + begin, result.end(), [&](auto& pk_offset) {
+                return timestamp_at(pk_offset.second) > timestamp;
+            });
+        result.erase(end, result.end());
+    }
+
+    void
+    search_pks(const PkType* pks,
+               int64_t n,
+               int64_t insert_barrier,
+               std::vector<OffsetMap::PkOffset>& result) const {
+        std::shared_lock lck(shared_mutex_);
+        auto begin = result.size();
+        find_many(pks, n, result);
+        auto end = std::remove_if(
+            result.begin() + begin, result.end(), [&](auto& pk_offset) {
+                return pk_offset.second >= insert_barrier;
+            });
+        result.erase(end, result.end());
+    }
+
     void
     insert_pk(const PkType& pk, int64_t offset) {
         std::lock_guard lck(shared_mutex_);
         pk2offset_->insert(pk, offset);
+        // the loaded stats already cover the pk
+        if (pk_stats_loaded_) {
+            return;
+        }
+        if (!min_pk_.has_value() || pk < *min_pk_) {
+            min_pk_ = pk;
+        }
+        if (!max_pk_.has_value() || *max_pk_ < pk) {
+            max_pk_ = pk;
+        }
+        if (pk_filter_ != nullptr) {
+            pk_filter_->add(pk);
+        } else if (is_sealed && enable_pk_filter_) {
+            pk_hashes_.push_back(PkBloomFilter::hash(pk));
+        }
+    }
+
+    // the stats log of the pks inserted so far, of `num_rows` rows
+    std::vector<uint8_t>
+    serialize_pk_stats(int64_t num_rows) const {
+        std::shared_lock lck(shared_mutex_);
+        return SerializePkStats(num_rows, min_pk_, max_pk_, pk_filter_.get());
+    }
+
+    // takes the range and the filter of the pks of a sealed segment from
+    // its stats log instead of collecting them as the pks are loaded
+    void
+    load_pk_stats(PkStats stats) {
+        std::lock_guard lck(shared_mutex_);
+        min_pk_ = std::move(stats.min_pk);
+        max_pk_ = std::move(stats.max_pk);
+        if (enable_pk_filter_) {
+            pk_filter_ = std::move(stats.filter);
+        }
+        pk_hashes_ = {};
+        pk_stats_loaded_ = true;
+    }
+
+    // whether some pk of [min_pk, max_pk] may have been inserted
+    bool
+    may_contain_pk_range(const PkType& min_pk, const PkType& max_pk) const {
+        std::shared_lock lck(shared_mutex_);
+        return !min_pk_.has_value() ||
+               !(max_pk < *min_pk_ || *max_pk_ < min_pk);
+    }
+
+    // false if none of the n pks may have been inserted
+    bool
+    may_contain_any_pk(const PkType* pks, int64_t n) const {
+        std::shared_lock lck(shared_mutex_);
+        for (int64_t i = 0; i < n; ++i) {
+            if (may_contain_pk(pks[i])) {
+                return true;
+            }
+        }
+        return false;
     }
 
     bool
@@ -272,10 +873,133 @@ struct InsertRecord {
         return pk2offset_->empty();
     }
 
+    // bytes of the pk to offset map and the bloom filter
+    int64_t
+    pk_memory_bytes() const {
+        std::shared_lock lck(shared_mutex_);
+        int64_t bytes = pk2offset_ != nullptr ? pk2offset_->memory_size() : 0;
+        if (pk_filter_ != nullptr) {
+            bytes += pk_filter_->memory_bytes();
+        }
+        return bytes + VectorBytes(pk_hashes_);
+    }
+
     void
     seal_pks() {
         std::lock_guard lck(shared_mutex_);
         pk2offset_->seal();
+        if (enable_pk_filter_ && !pk_stats_loaded_) {
+            pk_filter_ = std::make_unique<PkBloomFilter>(pk_hashes_.size());
+            for (auto h : pk_hashes_) {
+                pk_filter_->add_hash(h);
+            }
+            pk_hashes_ = {};
+        }
+    }
+
+    // bytes of the chunks of the field, 0 if they aren't kept
+    int64_t
+    field_memory_bytes(FieldId field_id) const {
+        auto it = fields_data_.find(field_id);
+        if (it == fields_data_.end()) {
+            return 0;
+        }
+        auto bytes = it->second->memory_size();
+        if (auto norms = get_vector_norms(field_id); norms != nullptr) {
+            bytes += norms->memory_size();
+        }
+        if (auto sketches = get_vector_sketches(field_id);
+            sketches != nullptr) {
+            bytes += sketches->memory_size();
+        }
+        return bytes;
+    }
+
+    // the bytes of field_memory_bytes mapped from files, the chunks of the
+    // vector fields with a file backed vector arena
+    int64_t
+    field_file_bytes(FieldId field_id) const {
+        auto it = fields_data_.find(field_id);
+        if (it == fields_data_.end() || vector_arena_ == nullptr ||
+            !vector_arena_->file_backed() ||
+            std::find(vector_fields_.begin(),
+                      vector_fields_.end(),
+                      field_id) == vector_fields_.end()) {
+            return 0;
+        }
+        return it->second->memory_size();
+    }
+
+    // squared norms of the rows of a float vector field of a growing
+    // segment, chunked as the rows, null if they aren't kept
+    const ConcurrentVector<float>*
+    get_vector_norms(FieldId field_id) const {
+        auto it = vector_norms_.find(field_id);
+        return it == vector_norms_.end() ? nullptr : it->second.get();
+    }
+
+    // computes the norms of the rows [offset, offset + size) of a float
+    // vector field of `dim` once the rows are set, a no-op for other fields
+    void
+    fill_vector_norms(FieldId field_id,
+                      int64_t dim,
+                      int64_t offset,
+                      int64_t size) {
+        auto it = vector_norms_.find(field_id);
+        if (it == vector_norms_.end() || size == 0) {
+            return;
+        }
+        auto vec = get_field_data<FloatVector>(field_id);
+        auto size_per_chunk = vec->get_size_per_chunk();
+        std::vector<float> norms(size);
+        for (int64_t begin = offset; begin < offset + size;) {
+            auto chunk_end = (begin / size_per_chunk + 1) * size_per_chunk;
+            auto end = std::min(offset + size, chunk_end);
+            query::BlockedBruteForce::SquaredNorms(
+                vec->get_element(begin),
+                end - begin,
+                dim,
+                norms.data() + begin - offset);
+            begin = end;
+        }
+        it->second->set_data_raw(offset, norms.data(), size);
+    }
+
+    // the sign sketches of the rows of a float vector field of a growing
+    // segment, chunked as the rows, null if they aren't kept
+    const ConcurrentVector<BinaryVector>*
+    get_vector_sketches(FieldId field_id) const {
+        auto it = vector_sketches_.find(field_id);
+        return it == vector_sketches_.end() ? nullptr : it->second.get();
+    }
+
+    // computes the sketches of the rows [offset, offset + size) of a float
+    // vector field of `dim` once the rows are set, a no-op if they aren't
+    // kept
+    void
+    fill_vector_sketches(FieldId field_id,
+                         int64_t dim,
+                         int64_t offset,
+                         int64_t size) {
+        auto it = vector_sketches_.find(field_id);
+        if (it == vector_sketches_.end() || size == 0) {
+            return;
+        }
+        auto vec = get_field_data<FloatVector>(field_id);
+        auto size_per_chunk = vec->get_size_per_chunk();
+        auto code_size = query::SketchBruteForce::CodeSize(dim);
+        std::vector<uint8_t> sketches(size * code_size);
+        for (int64_t begin = offset; begin < offset + size;) {
+            auto chunk_end = (begin / size_per_chunk + 1) * size_per_chunk;
+            auto end = std::min(offset + size, chunk_end);
+            query::SketchBruteForce::Encode(
+                vec->get_element(begin),
+                end - begin,
+                dim,
+                sketches.data() + (begin - offset) * code_size);
+            begin = end;
+        }
+        it->second->set_data_raw(offset, sketches.data(), size);
     }
 
     // get field data without knowing the type
@@ -313,8 +1037,9 @@ struct InsertRecord {
     void
     append_field_data(FieldId field_id, int64_t size_per_chunk) {
         static_assert(IsScalar<Type>);
-        fields_data_.emplace(
-            field_id, std::make_unique<ConcurrentVector<Type>>(size_per_chunk));
+        fields_data_.emplace(field_id,
+                             std::make_unique<ConcurrentVector<Type>>(
+                                 size_per_chunk, arena_));
     }
 
     // append a column of vector type
@@ -324,18 +1049,83 @@ struct InsertRecord {
         static_assert(std::is_base_of_v<VectorTrait, VectorType>);
         fields_data_.emplace(field_id,
                              std::make_unique<ConcurrentVector<VectorType>>(
-                                 dim, size_per_chunk));
+                                 dim, size_per_chunk, vector_arena_));
+        vector_fields_.push_back(field_id);
     }
 
     void
     drop_field_data(FieldId field_id) {
         fields_data_.erase(field_id);
+        vector_norms_.erase(field_id);
+        vector_sketches_.erase(field_id);
+    }
+
+ private:
+    // false if the pk is out of the range of the pks or rejected by the
+    // filter, under shared_mutex_
+    bool
+    may_contain_pk(const PkType& pk) const {
+        if (min_pk_.has_value() && (pk < *min_pk_ || *max_pk_ < pk)) {
+            return false;
+        }
+        return pk_filter_ == nullptr || pk_filter_->may_contain(pk);
+    }
+
+    // pk2offset_->find_many on the pks which pass may_contain_pk
+    void
+    find_many(const PkType* pks,
+              int64_t n,
+              std::vector<OffsetMap::PkOffset>& result) const {
+        if (pk_filter_ == nullptr && !min_pk_.has_value()) {
+            pk2offset_->find_many(pks, n, result);
+            return;
+        }
+        std::vector<int64_t> candidates;
+        for (int64_t i = 0; i < n; ++i) {
+            if (may_contain_pk(pks[i])) {
+                candidates.push_back(i);
+            }
+        }
+        if (int64_t(candidates.size()) == n) {
+            pk2offset_->find_many(pks, n, result);
+            return;
+        }
+        std::vector<PkType> candidate_pks;
+        candidate_pks.reserve(candidates.size());
+        for (auto i : candidates) {
+            candidate_pks.push_back(pks[i]);
+        }
+        auto begin = result.size();
+        pk2offset_->find_many(
+            candidate_pks.data(), candidate_pks.size(), result);
+        for (auto iter = result.begin() + begin; iter != result.end();
+             ++iter) {
+            iter->first = candidates[iter->first];
+        }
     }
 
  private:
     //    std::vector<std::unique_ptr<VectorBase>> fields_data_;
     std::unordered_map<FieldId, std::unique_ptr<VectorBase>> fields_data_{};
+    // the fields whose chunks are allocated from vector_arena_
+    std::vector<FieldId> vector_fields_;
+    // see get_vector_norms
+    std::unordered_map<FieldId, std::unique_ptr<ConcurrentVector<float>>>
+        vector_norms_{};
+    // see get_vector_sketches
+    std::unordered_map<FieldId,
+                       std::unique_ptr<ConcurrentVector<BinaryVector>>>
+        vector_sketches_{};
     mutable std::shared_mutex shared_mutex_{};
+
+    bool enable_pk_filter_ = true;
+    // pk hashes of a sealed segment collected until seal_pks
+    std::vector<uint64_t> pk_hashes_;
+    // the range of the pks, unset before the first one
+    std::optional<PkType> min_pk_;
+    std::optional<PkType> max_pk_;
+    // the range and the filter are of a stats log
+    bool pk_stats_loaded_ = false;
 };
 
 }  // namespace milvus::segcore
@@ -0,0 +1,228 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/LoadResource.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "common/SystemProperty.h"
+#include "index/Utils.h"
+#include "query/SketchBruteForce.h"
+#include "segcore/PkBloomFilter.h"
+#include "segcore/SegcoreConfig.h"
+#include "segcore/TimestampIndex.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// the timestamps are packed in at most a value a row, the index keeps the
+// bounds of every block
+LoadResource
+EstimateSystemLoadResource(const FieldLoadResourceInfo& info) {
+    LoadResource resource;
+    auto rows = info.row_count;
+    auto bytes = rows * int64_t(sizeof(int64_t));
+    auto decoded = info.binlog_bytes + std::max(info.raw_bytes, bytes);
+    if (FieldId(info.field_id) == TimestampFieldID) {
+        auto blocks = rows / TimestampIndex::kBlockSize + 1;
+        resource.steady_memory_bytes =
+            bytes + blocks * 3 * int64_t(sizeof(Timestamp));
+        // the timestamps are concatenated before they are packed
+        resource.peak_memory_bytes =
+            resource.steady_memory_bytes + decoded + bytes;
+        return resource;
+    }
+    if (info.mmap) {
+        resource.steady_disk_bytes = bytes;
+    } else {
+        resource.steady_memory_bytes = bytes;
+    }
+    resource.peak_memory_bytes = resource.steady_memory_bytes + decoded;
+    resource.peak_disk_bytes = resource.steady_disk_bytes;
+    return resource;
+}
+
+}  // namespace
+
+LoadResource
+EstimateIndexLoadResource(const std::string& index_type,
+                          int64_t index_bytes,
+                          bool mmap) {
+    LoadResource resource;
+    if (index_bytes <= 0) {
+        return resource;
+    }
+    if (index::is_in_disk_list(index_type)) {
+        resource.peak_disk_bytes = index_bytes;
+        resource.steady_disk_bytes = index_bytes;
+        return resource;
+    }
+    if (mmap) {
+        resource.peak_memory_bytes = index_bytes;
+        resource.peak_disk_bytes = index_bytes;
+        resource.steady_disk_bytes = index_bytes;
+        return resource;
+    }
+    resource.peak_memory_bytes = 2 * index_bytes;
+    resource.steady_memory_bytes = index_bytes;
+    return resource;
+}
+
+LoadResource
+EstimateFieldLoadResource(const Schema& schema,
+                          const FieldLoadResourceInfo& info) {
+    auto index = EstimateIndexLoadResource(
+        info.index_type, info.index_bytes, info.index_mmap);
+    if (info.binlog_bytes <= 0 && info.raw_bytes <= 0) {
+        return index;
+    }
+    auto field_id = FieldId(info.field_id);
+    if (SystemProperty::Instance().IsSystem(field_id)) {
+        auto resource = EstimateSystemLoadResource(info);
+        resource += index;
+        return resource;
+    }
+
+    auto& field_meta = schema[field_id];
+    auto data_type = field_meta.get_data_type();
+    auto rows = info.row_count;
+    auto variable = datatype_is_variable(data_type);
+    // the binlogs of variable length values hold little more than them
+    auto raw = info.raw_bytes > 0 ? info.raw_bytes
+               : variable         ? info.binlog_bytes
+                                  : rows * int64_t(field_meta.get_sizeof());
+
+    LoadResource resource;
+    if (info.mmap) {
+        resource.steady_disk_bytes = raw;
+    } else {
+        resource.steady_memory_bytes = raw;
+    }
+    // the decoded values are held with the binlogs until the column has
+    // copied them, strings one std::string a row
+    auto transient = info.binlog_bytes + raw;
+    if (variable) {
+        resource.steady_memory_bytes +=
+            rows * int64_t(sizeof(std::string_view));
+        transient += rows * int64_t(sizeof(std::string));
+    }
+
+    if (schema.get_primary_field_id() == field_id) {
+        // the sorted keys and offsets, built from as many pending pairs
+        auto entry = data_type == DataType::INT64
+                         ? int64_t(2 * sizeof(int64_t))
+                         : int64_t(sizeof(std::string) + sizeof(int64_t));
+        auto pk_map = rows * entry + (variable ? raw : 0);
+        resource.steady_memory_bytes +=
+            pk_map + rows * PkBloomFilter::BITS_PER_KEY / 8;
+        transient += pk_map;
+    }
+    if (data_type == DataType::VECTOR_FLOAT) {
+        resource.steady_memory_bytes += rows * int64_t(sizeof(float));
+        if (SegcoreConfig::default_config().get_brute_force_sketch_factor() >
+            0) {
+            resource.steady_memory_bytes +=
+                rows * query::SketchBruteForce::CodeSize(field_meta.get_dim());
+        }
+    }
+
+    resource.peak_memory_bytes = resource.steady_memory_bytes + transient;
+    resource.peak_disk_bytes = resource.steady_disk_bytes;
+    resource += index;
+    return resource;
+}
+
+LoadResource
+EstimateLoadResource(const Schema& schema,
+                     const std::vector<FieldLoadResourceInfo>& infos) {
+    LoadResource resource;
+    for (auto& info : infos) {
+        resource += EstimateFieldLoadResource(schema, info);
+    }
+    return resource;
+}
+
+LoadResourceLease::~LoadResourceLease() {
+    manager_->release(resource_);
+}
+
+void
+LoadResourceManager::SetBudget(int64_t memory_bytes, int64_t disk_bytes) {
+    {
+        std::lock_guard lck(mutex_);
+        memory_budget_ = std::max<int64_t>(memory_bytes, 0);
+        disk_budget_ = std::max<int64_t>(disk_bytes, 0);
+    }
+    released_.notify_all();
+}
+
+bool
+LoadResourceManager::HasBudget() const {
+    std::lock_guard lck(mutex_);
+    return memory_budget_ > 0 || disk_budget_ > 0;
+}
+
+int64_t
+LoadResourceManager::InFlightMemoryBytes() const {
+    std::lock_guard lck(mutex_);
+    return memory_in_flight_;
+}
+
+int64_t
+LoadResourceManager::InFlightDiskBytes() const {
+    std::lock_guard lck(mutex_);
+    return disk_in_flight_;
+}
+
+int64_t
+LoadResourceManager::NumLoads() const {
+    std::lock_guard lck(mutex_);
+    return loads_;
+}
+
+bool
+LoadResourceManager::fits_locked(const LoadResource& resource) const {
+    if (loads_ == 0) {
+        return true;
+    }
+    auto memory_fits =
+        memory_budget_ <= 0 ||
+        memory_in_flight_ + resource.peak_memory_bytes <= memory_budget_;
+    auto disk_fits = disk_budget_ <= 0 ||
+                     disk_in_flight_ + resource.peak_disk_bytes <= disk_budget_;
+    return memory_fits && disk_fits;
+}
+
+std::unique_ptr<LoadResourceLease>
+LoadResourceManager::Acquire(const LoadResource& resource) {
+    std::unique_lock lck(mutex_);
+    released_.wait(lck, [&] { return fits_locked(resource); });
+    memory_in_flight_ += resource.peak_memory_bytes;
+    disk_in_flight_ += resource.peak_disk_bytes;
+    ++loads_;
+    return std::unique_ptr<LoadResourceLease>(
+        new LoadResourceLease(this, resource));
+}
+
+void
+LoadResourceManager::release(const LoadResource& resource) {
+    {
+        std::lock_guard lck(mutex_);
+        memory_in_flight_ -= resource.peak_memory_bytes;
+        disk_in_flight_ -= resource.peak_disk_bytes;
+        --loads_;
+    }
+    released_.notify_all();
+}
+
+}  // namespace milvus::segcore
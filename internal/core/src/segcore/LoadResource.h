@@ -0,0 +1,170 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/Schema.h"
+
+namespace milvus::segcore {
+
+// A field of a sealed segment to load, as described by its binlog and
+// index metadata before anything is downloaded
+struct FieldLoadResourceInfo {
+    int64_t field_id = 0;
+    int64_t row_count = 0;
+    // bytes of the serialized binlogs of the raw data, 0 if it isn't loaded
+    int64_t binlog_bytes = 0;
+    // the memory size of the binlogs, the bytes of the values decoded from
+    // them; estimated from the schema and the binlog bytes if 0
+    int64_t raw_bytes = 0;
+    // the column is mapped from a file in the mmap dir
+    bool mmap = false;
+    // the type and the bytes of the index files of the field, if it has an
+    // index to load
+    std::string index_type;
+    int64_t index_bytes = 0;
+    // the index is mapped from a file in the mmap dir
+    bool index_mmap = false;
+};
+
+// Bytes of memory and local disk a load takes at its peak, while the
+// binlogs or the index files and what is decoded from them are held next
+// to what is built, and once it's done
+struct LoadResource {
+    int64_t peak_memory_bytes = 0;
+    int64_t steady_memory_bytes = 0;
+    int64_t peak_disk_bytes = 0;
+    int64_t steady_disk_bytes = 0;
+
+    LoadResource&
+    operator+=(const LoadResource& other) {
+        peak_memory_bytes += other.peak_memory_bytes;
+        steady_memory_bytes += other.steady_memory_bytes;
+        peak_disk_bytes += other.peak_disk_bytes;
+        steady_disk_bytes += other.steady_disk_bytes;
+        return *this;
+    }
+};
+
+// the raw column of the field with the views of its variable length
+// values, the pk map, the timestamp index, the norms and sketches of float
+// vectors and the decoded binlogs they are built from, and its index
+LoadResource
+EstimateFieldLoadResource(const Schema& schema,
+                          const FieldLoadResourceInfo& info);
+
+// an index of `index_bytes` bytes of files, the files are held until the
+// index has loaded them; disk indexes are cached to the local disk and
+// take the memory the DiskAnnCacheManager grants them
+LoadResource
+EstimateIndexLoadResource(const std::string& index_type,
+                          int64_t index_bytes,
+                          bool mmap);
+
+// the fields may be loaded at the same time, the peak of the segment is
+// the sum of theirs
+LoadResource
+EstimateLoadResource(const Schema& schema,
+                     const std::vector<FieldLoadResourceInfo>& infos);
+
+class LoadResourceManager;
+
+// The peak resources of a load admitted by the LoadResourceManager, held
+// while the load runs.
+class LoadResourceLease {
+ public:
+    ~LoadResourceLease();
+
+    LoadResourceLease(const LoadResourceLease&) = delete;
+    LoadResourceLease&
+    operator=(const LoadResourceLease&) = delete;
+
+    const LoadResource&
+    resource() const {
+        return resource_;
+    }
+
+ private:
+    friend class LoadResourceManager;
+
+    LoadResourceLease(LoadResourceManager* manager,
+                      const LoadResource& resource)
+        : manager_(manager), resource_(resource) {
+    }
+
+    LoadResourceManager* manager_;
+    const LoadResource resource_;
+};
+
+// Node wide budget of the memory and disk the loads of sealed segments
+// take at their peak. A load waits until its peak fits the budget next to
+// the peaks of the loads running, one over the budget by itself runs once
+// no other does, so the concurrency of the loads follows their footprint
+// instead of their count. What the loaded segments keep is charged to the
+// budget only while they load.
+class LoadResourceManager {
+ public:
+    static LoadResourceManager&
+    GetInstance() {
+        static LoadResourceManager instance;
+        return instance;
+    }
+
+    // a zero budget admits every load at once
+    void
+    SetBudget(int64_t memory_bytes, int64_t disk_bytes);
+
+    bool
+    HasBudget() const;
+
+    // the peak bytes of the loads running and their number
+    int64_t
+    InFlightMemoryBytes() const;
+
+    int64_t
+    InFlightDiskBytes() const;
+
+    int64_t
+    NumLoads() const;
+
+    // waits until the load fits the budget
+    std::unique_ptr<LoadResourceLease>
+    Acquire(const LoadResource& resource);
+
+ private:
+    friend class LoadResourceLease;
+
+    LoadResourceManager() = default;
+
+    void
+    release(const LoadResource& resource);
+
+    bool
+    fits_locked(const LoadResource& resource) const;
+
+ private:
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    int64_t memory_budget_ = 0;
+    int64_t disk_budget_ = 0;
+    int64_t memory_in_flight_ = 0;
+    int64_t disk_in_flight_ = 0;
+    int64_t loads_ = 0;
+};
+
+}  // namespace milvus::segcore
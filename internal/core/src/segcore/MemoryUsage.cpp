@@ -0,0 +1,57 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/MemoryUsage.h"
+
+#include "utils/Json.h"
+
+namespace milvus::segcore {
+
+int64_t
+MemoryUsage::resident_bytes() const {
+    auto bytes = system + pk_map + deletes + caches;
+    for (auto& [field_id, usage] : fields) {
+        bytes += usage.raw + usage.index + usage.stats;
+    }
+    return bytes;
+}
+
+int64_t
+MemoryUsage::mmap_file_bytes() const {
+    int64_t bytes = 0;
+    for (auto& [field_id, usage] : fields) {
+        bytes += usage.mmap_file;
+    }
+    return bytes;
+}
+
+std::string
+MemoryUsage::ToJson() const {
+    json fields_json = json::object();
+    for (auto& [field_id, usage] : fields) {
+        fields_json[std::to_string(field_id)] = {
+            {"raw", usage.raw},
+            {"mmap_file", usage.mmap_file},
+            {"index", usage.index},
+            {"stats", usage.stats}};
+    }
+    json result = {{"resident_bytes", resident_bytes()},
+                   {"mmap_file_bytes", mmap_file_bytes()},
+                   {"system", system},
+                   {"pk_map", pk_map},
+                   {"deletes", deletes},
+                   {"caches", caches},
+                   {"arena", arena},
+                   {"fields", std::move(fields_json)}};
+    return result.dump();
+}
+
+}  // namespace milvus::segcore
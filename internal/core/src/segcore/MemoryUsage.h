@@ -0,0 +1,63 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace milvus::segcore {
+
+// Memory held for one field of a segment in bytes
+struct FieldMemoryUsage {
+    // raw data in anonymous memory, with the offsets, views and heap
+    // payloads of variable length values
+    int64_t raw = 0;
+    // raw data mapped from files, the kernel pages it in on demand and may
+    // drop it under memory pressure, so it isn't counted as resident
+    int64_t mmap_file = 0;
+    // loaded indexes, and the interim indexes of growing segments
+    int64_t index = 0;
+    // zone maps, partition key stats and json key indexes
+    int64_t stats = 0;
+};
+
+// Memory held by a segment, broken down by field and structure, as
+// measured from the structures rather than estimated from the schema
+struct MemoryUsage {
+    // the row id column of a sealed segment is the one of field 0
+    std::map<int64_t, FieldMemoryUsage> fields;
+    // timestamps, row ids and the timestamp index, but the row ids of
+    // sealed segments
+    int64_t system = 0;
+    // the pk to offset map and the pk bloom filter
+    int64_t pk_map = 0;
+    // deleted pks and timestamps and the cached delete bitmap
+    int64_t deletes = 0;
+    // cached predicate results
+    int64_t caches = 0;
+    // the bytes jemalloc holds allocated in the arena of the segment, its
+    // exact footprint, -1 without an arena
+    int64_t arena = -1;
+
+    // every byte but the ones mapped from files
+    int64_t
+    resident_bytes() const;
+
+    int64_t
+    mmap_file_bytes() const;
+
+    std::string
+    ToJson() const;
+};
+
+}  // namespace milvus::segcore
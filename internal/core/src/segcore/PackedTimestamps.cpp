@@ -0,0 +1,106 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/PackedTimestamps.h"
+
+#include <algorithm>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+void
+PackedTimestamps::build(const Timestamp* timestamps, int64_t size) {
+    clear();
+    auto num_blocks = (size + kBlockSize - 1) / kBlockSize;
+    bases_.resize(num_blocks);
+    bits_.resize(num_blocks);
+    word_offsets_.resize(num_blocks);
+    for (int64_t block_id = 0; block_id < num_blocks; ++block_id) {
+        auto beg = block_id * kBlockSize;
+        auto end = std::min(size, beg + kBlockSize);
+        auto [min_v, max_v] =
+            std::minmax_element(timestamps + beg, timestamps + end);
+        auto range = *max_v - *min_v;
+        int bits = 0;
+        while (bits < 64 && (range >> bits) != 0) {
+            ++bits;
+        }
+        bases_[block_id] = *min_v;
+        bits_[block_id] = bits;
+        word_offsets_[block_id] = words_.size();
+        if (bits == 0) {
+            continue;
+        }
+        auto offset = words_.size();
+        words_.resize(offset + ((end - beg) * bits + 63) / 64, 0);
+        auto words = words_.data() + offset;
+        for (int64_t i = 0; i < end - beg; ++i) {
+            auto value = timestamps[beg + i] - *min_v;
+            auto pos = i * bits;
+            auto shift = pos % 64;
+            words[pos / 64] |= value << shift;
+            if (shift + bits > 64) {
+                words[pos / 64 + 1] |= value >> (64 - shift);
+            }
+        }
+    }
+    words_.shrink_to_fit();
+    size_ = size;
+}
+
+void
+PackedTimestamps::clear() {
+    size_ = 0;
+    bases_.clear();
+    bits_.clear();
+    word_offsets_.clear();
+    words_.clear();
+}
+
+void
+PackedTimestamps::decode(int64_t beg, int64_t end, Timestamp* output) const {
+    AssertInfo(beg <= end && end <= size_ &&
+                   (beg == end || beg / kBlockSize == (end - 1) / kBlockSize),
+               "decoded rows must lie in one block");
+    if (beg == end) {
+        return;
+    }
+    auto block_id = beg / kBlockSize;
+    auto base = bases_[block_id];
+    auto bits = bits_[block_id];
+    if (bits == 0) {
+        std::fill(output, output + end - beg, base);
+        return;
+    }
+    auto words = words_.data() + word_offsets_[block_id];
+    auto mask = bits < 64 ? (uint64_t(1) << bits) - 1 : ~uint64_t(0);
+    for (auto i = beg % kBlockSize; i < (end - 1) % kBlockSize + 1; ++i) {
+        auto pos = i * bits;
+        auto shift = pos % 64;
+        auto value = words[pos / 64] >> shift;
+        if (shift + bits > 64) {
+            value |= words[pos / 64 + 1] << (64 - shift);
+        }
+        *output++ = base + (value & mask);
+    }
+}
+
+void
+PackedTimestamps::gather(const int64_t* offsets,
+                         int64_t count,
+                         Timestamp* output) const {
+    for (int64_t i = 0; i < count; ++i) {
+        output[i] = (*this)[offsets[i]];
+    }
+}
+
+}  // namespace milvus::segcore
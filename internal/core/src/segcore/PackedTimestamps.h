@@ -0,0 +1,92 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// The timestamps of a sealed segment, frame of reference coded per block
+// of kBlockSize rows: the offsets of a block from its min are packed in as
+// few bits as its range needs, compacted segments mostly take a few bits
+// per row rather than 64. Random access decodes one value, the blocks the
+// MVCC mask can't decide from their bounds are decoded whole.
+class PackedTimestamps {
+ public:
+    // the rows of a block, those of a TimestampIndex block
+    static constexpr int64_t kBlockSize = 4096;
+
+    void
+    build(const Timestamp* timestamps, int64_t size);
+
+    void
+    clear();
+
+    bool
+    empty() const {
+        return size_ == 0;
+    }
+
+    int64_t
+    size() const {
+        return size_;
+    }
+
+    Timestamp
+    operator[](int64_t offset) const {
+        auto block_id = offset / kBlockSize;
+        auto bits = bits_[block_id];
+        if (bits == 0) {
+            return bases_[block_id];
+        }
+        auto pos = (offset % kBlockSize) * bits;
+        auto words = words_.data() + word_offsets_[block_id] + pos / 64;
+        auto shift = pos % 64;
+        auto value = words[0] >> shift;
+        if (shift + bits > 64) {
+            value |= words[1] << (64 - shift);
+        }
+        if (bits < 64) {
+            value &= (uint64_t(1) << bits) - 1;
+        }
+        return bases_[block_id] + value;
+    }
+
+    // decodes the rows [beg, end) of one block into `output`
+    void
+    decode(int64_t beg, int64_t end, Timestamp* output) const;
+
+    void
+    gather(const int64_t* offsets, int64_t count, Timestamp* output) const;
+
+    int64_t
+    memory_bytes() const {
+        return words_.capacity() * sizeof(uint64_t) +
+               bases_.capacity() * sizeof(Timestamp) +
+               word_offsets_.capacity() * sizeof(int64_t) + bits_.capacity();
+    }
+
+ private:
+    int64_t size_ = 0;
+    // the min of every block
+    std::vector<Timestamp> bases_;
+    // the bits of the offsets of every block, 0 if all its rows are equal
+    std::vector<uint8_t> bits_;
+    // where the words of every block start
+    std::vector<int64_t> word_offsets_;
+    std::vector<uint64_t> words_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,142 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/Types.h"
+#include "segcore/PkBloomFilter.h"
+
+namespace milvus::segcore {
+
+// Partition key values of a sealed segment, built when the column is
+// loaded. A segment holding a few keys knows each of them with the offset
+// ranges of its rows, so a filter on the key is answered from the ranges.
+// With more keys only a Bloom filter of them is kept, which still tells the
+// keys the segment doesn't hold.
+class PartitionKeyStats {
+ public:
+    using Range = std::pair<int64_t, int64_t>;
+
+    // most keys kept with their ranges
+    static constexpr int64_t MAX_VALUES = 1024;
+    // most ranges kept over all the keys, unclustered rows give many
+    static constexpr int64_t MAX_RANGES = 16 * 1024;
+
+    template <typename T>
+    static std::unique_ptr<PartitionKeyStats>
+    Build(const T* values, int64_t row_count) {
+        static_assert(std::is_same_v<T, int64_t> ||
+                      std::is_same_v<T, std::string_view>);
+        std::unique_ptr<PartitionKeyStats> stats(new PartitionKeyStats());
+        int64_t range_count = 0;
+        for (int64_t i = 0; i < row_count;) {
+            auto begin = i;
+            while (i < row_count && values[i] == values[begin]) {
+                ++i;
+            }
+            if (++range_count > MAX_RANGES) {
+                break;
+            }
+            auto& ranges = stats->ranges_[key(values[begin])];
+            ranges.emplace_back(begin, i);
+            if (int64_t(stats->ranges_.size()) > MAX_VALUES) {
+                break;
+            }
+        }
+        if (range_count <= MAX_RANGES &&
+            int64_t(stats->ranges_.size()) <= MAX_VALUES) {
+            return stats;
+        }
+
+        stats->ranges_.clear();
+        stats->filter_.emplace(row_count);
+        for (int64_t i = 0; i < row_count; ++i) {
+            if (i == 0 || values[i] != values[i - 1]) {
+                stats->filter_->add(key(values[i]));
+            }
+        }
+        return stats;
+    }
+
+    // false if no row has the key
+    bool
+    may_contain(const PkType& value) const {
+        if (filter_.has_value()) {
+            return filter_->may_contain(value);
+        }
+        return ranges_.count(value) > 0;
+    }
+
+    // the ascending offset ranges of the rows having the key, nullptr if
+    // they aren't known or no row has it
+    const std::vector<Range>*
+    ranges(const PkType& value) const {
+        auto it = ranges_.find(value);
+        return it == ranges_.end() ? nullptr : &it->second;
+    }
+
+    // whether the ranges of every key are known
+    bool
+    has_ranges() const {
+        return !filter_.has_value();
+    }
+
+    // bytes of the ranges or the filter, hash map nodes included
+    int64_t
+    memory_bytes() const {
+        if (filter_.has_value()) {
+            return filter_->memory_bytes();
+        }
+        int64_t bytes = ranges_.bucket_count() * sizeof(void*);
+        for (auto& [key, ranges] : ranges_) {
+            bytes += sizeof(std::pair<const PkType, std::vector<Range>>) +
+                     sizeof(void*) + ranges.capacity() * sizeof(Range);
+            if (auto str = std::get_if<std::string>(&key)) {
+                bytes += str->capacity();
+            }
+        }
+        return bytes;
+    }
+
+ private:
+    PartitionKeyStats() = default;
+
+    static PkType
+    key(int64_t value) {
+        return value;
+    }
+
+    static PkType
+    key(std::string_view value) {
+        return std::string(value);
+    }
+
+    std::unordered_map<PkType, std::vector<Range>> ranges_;
+    std::optional<PkBloomFilter> filter_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,231 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "common/Types.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+// Split block Bloom filter over the pks of one segment. Every key sets one
+// bit in each of the 8 words of a single 32 byte block, so a probe touches
+// one cache line. There are no false negatives, a negative answer lets a
+// pk lookup skip the segment.
+//
+// The filter grows in stages: once the last stage holds its capacity a new
+// one of twice the capacity is appended, so keys can be added without
+// knowing the final count, a filter built with the exact count has a single
+// stage.
+class PkBloomFilter {
+ public:
+    static constexpr int64_t BITS_PER_KEY = 12;
+    static constexpr int64_t MIN_CAPACITY = 4096;
+
+    explicit PkBloomFilter(int64_t capacity = MIN_CAPACITY)
+        : next_capacity_(std::max(capacity, MIN_CAPACITY)) {
+    }
+
+    static uint64_t
+    hash(const PkType& pk) {
+        uint64_t h;
+        if (auto value = std::get_if<int64_t>(&pk)) {
+            h = uint64_t(*value);
+        } else {
+            h = std::hash<std::string_view>()(std::get<std::string>(pk));
+        }
+        // splitmix64 finalizer, spreads sequential ids over all blocks
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    void
+    add(const PkType& pk) {
+        add_hash(hash(pk));
+    }
+
+    void
+    add_hash(uint64_t h) {
+        if (stages_.empty() || stages_.back().size == stages_.back().capacity) {
+            stages_.emplace_back(next_capacity_);
+            next_capacity_ *= 2;
+        }
+        auto& stage = stages_.back();
+        auto& block = stage.block(h);
+        auto mask = make_mask(h);
+        for (int i = 0; i < WORDS_PER_BLOCK; ++i) {
+            block.words[i] |= mask.words[i];
+        }
+        ++stage.size;
+    }
+
+    bool
+    may_contain(const PkType& pk) const {
+        return may_contain_hash(hash(pk));
+    }
+
+    bool
+    may_contain_hash(uint64_t h) const {
+        auto mask = make_mask(h);
+        for (auto& stage : stages_) {
+            auto& block = stage.block(h);
+            bool contain = true;
+            for (int i = 0; i < WORDS_PER_BLOCK; ++i) {
+                contain &= (block.words[i] & mask.words[i]) != 0;
+            }
+            if (contain) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int64_t
+    size() const {
+        int64_t size = 0;
+        for (auto& stage : stages_) {
+            size += stage.size;
+        }
+        return size;
+    }
+
+    int64_t
+    memory_bytes() const {
+        int64_t bytes = 0;
+        for (auto& stage : stages_) {
+            bytes += stage.blocks.size() * sizeof(Block);
+        }
+        return bytes;
+    }
+
+    // appends the filter to `out`, read back by deserialize
+    void
+    serialize(std::vector<uint8_t>& out) const {
+        auto append = [&](const void* data, size_t size) {
+            auto bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        };
+        int64_t num_stages = stages_.size();
+        append(&next_capacity_, sizeof(next_capacity_));
+        append(&num_stages, sizeof(num_stages));
+        for (auto& stage : stages_) {
+            int64_t num_blocks = stage.blocks.size();
+            append(&stage.capacity, sizeof(stage.capacity));
+            append(&stage.size, sizeof(stage.size));
+            append(&num_blocks, sizeof(num_blocks));
+            append(stage.blocks.data(), num_blocks * sizeof(Block));
+        }
+    }
+
+    // the filter serialized at `data`, advanced past it, throws if the `size`
+    // bytes end before it does
+    static PkBloomFilter
+    deserialize(const uint8_t*& data, int64_t& size) {
+        auto read = [&](void* dst, int64_t length) {
+            AssertInfo(length >= 0 && length <= size,
+                       "truncated pk bloom filter");
+            std::memcpy(dst, data, length);
+            data += length;
+            size -= length;
+        };
+        PkBloomFilter filter;
+        int64_t num_stages;
+        read(&filter.next_capacity_, sizeof(filter.next_capacity_));
+        read(&num_stages, sizeof(num_stages));
+        AssertInfo(num_stages >= 0 && num_stages <= 64,
+                   "invalid pk bloom filter");
+        for (int64_t i = 0; i < num_stages; ++i) {
+            int64_t capacity, stage_size, num_blocks;
+            read(&capacity, sizeof(capacity));
+            read(&stage_size, sizeof(stage_size));
+            read(&num_blocks, sizeof(num_blocks));
+            AssertInfo(capacity > 0 && num_blocks > 0 &&
+                           num_blocks <= size / int64_t(sizeof(Block)),
+                       "invalid pk bloom filter");
+            auto& stage = filter.stages_.emplace_back(capacity);
+            stage.size = stage_size;
+            stage.blocks.resize(num_blocks);
+            read(stage.blocks.data(), num_blocks * sizeof(Block));
+        }
+        return filter;
+    }
+
+ private:
+    static constexpr int WORDS_PER_BLOCK = 8;
+
+    struct alignas(32) Block {
+        uint32_t words[WORDS_PER_BLOCK] = {};
+    };
+
+    struct Stage {
+        explicit Stage(int64_t capacity)
+            : blocks(std::max<int64_t>(
+                  capacity * BITS_PER_KEY / (8 * sizeof(Block)), 1)),
+              capacity(capacity) {
+        }
+
+        // the high half of the hash picks the block, without a modulo
+        const Block&
+        block(uint64_t h) const {
+            return blocks[((h >> 32) * blocks.size()) >> 32];
+        }
+
+        Block&
+        block(uint64_t h) {
+            return blocks[((h >> 32) * blocks.size()) >> 32];
+        }
+
+        std::vector<Block> blocks;
+        int64_t capacity;
+        int64_t size = 0;
+    };
+
+    // the low half of the hash picks one bit in every word
+    static Block
+    make_mask(uint64_t h) {
+        static constexpr uint32_t salts[WORDS_PER_BLOCK] = {0x47b6137bU,
+                                                            0x44974d91U,
+                                                            0x8824ad5bU,
+                                                            0xa2b7289dU,
+                                                            0x705495c7U,
+                                                            0x2df1424bU,
+                                                            0x9efc4947U,
+                                                            0x5c6bfb31U};
+        Block mask;
+        auto key = uint32_t(h);
+        for (int i = 0; i < WORDS_PER_BLOCK; ++i) {
+            mask.words[i] = 1U << ((key * salts[i]) >> 27);
+        }
+        return mask;
+    }
+
+ private:
+    std::vector<Stage> stages_;
+    int64_t next_capacity_;
+};
+
+}  // namespace milvus::segcore
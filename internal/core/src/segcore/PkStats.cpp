@@ -0,0 +1,164 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "segcore/PkStats.h"
+
+#include <cstring>
+#include <string>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// "PKST", followed by the version
+constexpr uint32_t PK_STATS_MAGIC = 0x54534b50;
+constexpr uint32_t PK_STATS_VERSION = 1;
+
+// the PkType index of no pk, an int64 and a string one
+constexpr uint8_t NO_PK = 0;
+constexpr uint8_t INT64_PK = 1;
+constexpr uint8_t STRING_PK = 2;
+
+void
+Append(std::vector<uint8_t>& out, const void* data, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void
+AppendPk(std::vector<uint8_t>& out, const std::optional<PkType>& pk) {
+    uint8_t tag = NO_PK;
+    if (pk.has_value()) {
+        tag = std::holds_alternative<int64_t>(*pk) ? INT64_PK : STRING_PK;
+    }
+    Append(out, &tag, sizeof(tag));
+    if (tag == INT64_PK) {
+        Append(out, &std::get<int64_t>(*pk), sizeof(int64_t));
+    } else if (tag == STRING_PK) {
+        auto& str = std::get<std::string>(*pk);
+        uint32_t length = str.size();
+        Append(out, &length, sizeof(length));
+        Append(out, str.data(), length);
+    }
+}
+
+class Reader {
+ public:
+    Reader(const uint8_t* data, int64_t size) : data_(data), size_(size) {
+    }
+
+    void
+    read(void* dst, int64_t length) {
+        AssertInfo(length >= 0 && length <= size_, "truncated pk stats");
+        std::memcpy(dst, data_, length);
+        data_ += length;
+        size_ -= length;
+    }
+
+    template <typename T>
+    T
+    read() {
+        T value;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    std::optional<PkType>
+    read_pk() {
+        auto tag = read<uint8_t>();
+        switch (tag) {
+            case NO_PK:
+                return std::nullopt;
+            case INT64_PK:
+                return PkType(read<int64_t>());
+            case STRING_PK: {
+                auto length = read<uint32_t>();
+                AssertInfo(length <= size_, "truncated pk stats");
+                std::string str(reinterpret_cast<const char*>(data_),
+                                length);
+                data_ += length;
+                size_ -= length;
+                return PkType(std::move(str));
+            }
+            default:
+                PanicInfo("invalid pk stats");
+        }
+    }
+
+    const uint8_t*&
+    data() {
+        return data_;
+    }
+
+    int64_t&
+    size() {
+        return size_;
+    }
+
+ private:
+    const uint8_t* data_;
+    int64_t size_;
+};
+
+}  // namespace
+
+// magic | version | num_rows | min pk | max pk | has filter | filter
+std::vector<uint8_t>
+SerializePkStats(int64_t num_rows,
+                 const std::optional<PkType>& min_pk,
+                 const std::optional<PkType>& max_pk,
+                 const PkBloomFilter* filter) {
+    std::vector<uint8_t> out;
+    Append(out, &PK_STATS_MAGIC, sizeof(PK_STATS_MAGIC));
+    Append(out, &PK_STATS_VERSION, sizeof(PK_STATS_VERSION));
+    Append(out, &num_rows, sizeof(num_rows));
+    AppendPk(out, min_pk);
+    AppendPk(out, max_pk);
+    uint8_t has_filter = filter != nullptr;
+    Append(out, &has_filter, sizeof(has_filter));
+    if (filter != nullptr) {
+        filter->serialize(out);
+    }
+    return out;
+}
+
+PkStats
+DeserializePkStats(const uint8_t* data, int64_t size) {
+    AssertInfo(data != nullptr, "pk stats is null");
+    Reader reader(data, size);
+    AssertInfo(reader.read<uint32_t>() == PK_STATS_MAGIC,
+               "not a pk stats log");
+    auto version = reader.read<uint32_t>();
+    AssertInfo(version == PK_STATS_VERSION,
+               "unsupported pk stats version " + std::to_string(version));
+    PkStats stats;
+    stats.num_rows = reader.read<int64_t>();
+    stats.min_pk = reader.read_pk();
+    stats.max_pk = reader.read_pk();
+    AssertInfo(stats.min_pk.has_value() == stats.max_pk.has_value(),
+               "invalid pk stats");
+    if (reader.read<uint8_t>() != 0) {
+        stats.filter = std::make_unique<PkBloomFilter>(
+            PkBloomFilter::deserialize(reader.data(), reader.size()));
+    }
+    AssertInfo(reader.size() == 0, "trailing bytes in pk stats");
+    return stats;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,54 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "common/Types.h"
+#include "segcore/PkBloomFilter.h"
+
+namespace milvus::segcore {
+
+// The statistics of the pks of a segment: their range and their bloom
+// filter. A growing segment keeps them up to date as rows are inserted,
+// they are written to a stats log with its binlogs when it is flushed and
+// loaded back with the sealed segment, so they are never rebuilt from the
+// pks.
+struct PkStats {
+    // the rows the statistics were collected from
+    int64_t num_rows = 0;
+    // unset if there is no row
+    std::optional<PkType> min_pk;
+    std::optional<PkType> max_pk;
+    // null if the segment had no filter
+    std::unique_ptr<PkBloomFilter> filter;
+};
+
+std::vector<uint8_t>
+SerializePkStats(int64_t num_rows,
+                 const std::optional<PkType>& min_pk,
+                 const std::optional<PkType>& max_pk,
+                 const PkBloomFilter* filter);
+
+PkStats
+DeserializePkStats(const uint8_t* data, int64_t size);
+
+}  // namespace milvus::segcore
@@ -0,0 +1,121 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "segcore/PlanCache.h"
+
+#include <functional>
+
+#include "query/Plan.h"
+
+namespace milvus::segcore {
+
+size_t
+PlanCache::KeyHash::operator()(const Key& key) const {
+    auto hash = std::hash<std::string>{}(key.second);
+    hash ^= std::hash<const Schema*>{}(key.first) + 0x9e3779b97f4a7c15ULL +
+            (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+void
+PlanCache::SetCapacity(int64_t capacity) {
+    std::lock_guard lck(mutex_);
+    capacity_.store(capacity);
+    EvictLocked();
+}
+
+query::Plan*
+PlanCache::Acquire(const SchemaPtr& schema,
+                   const void* serialized_plan,
+                   int64_t size) {
+    if (capacity_.load(std::memory_order_relaxed) <= 0) {
+        return query::CreateSearchPlanByExpr(*schema, serialized_plan, size)
+            .release();
+    }
+
+    Key key(schema.get(),
+            std::string(static_cast<const char*>(serialized_plan), size));
+    std::shared_ptr<query::Plan> plan;
+    {
+        std::lock_guard lck(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+            plan = it->second.plan;
+            auto& handle = handles_[plan.get()];
+            if (handle.refs++ == 0) {
+                handle.plan = plan;
+                handle.schema = schema;
+            }
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return plan.get();
+        }
+    }
+
+    // created unlocked, a concurrent miss of the same plan may create it too
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    plan = query::CreateSearchPlanByExpr(*schema, serialized_plan, size);
+    std::lock_guard lck(mutex_);
+    auto [it, inserted] = entries_.try_emplace(std::move(key));
+    if (inserted) {
+        lru_.push_front(&it->first);
+        it->second = Entry{schema, plan, lru_.begin()};
+    }
+    auto& handle = handles_[plan.get()];
+    handle.plan = plan;
+    handle.schema = schema;
+    handle.refs = 1;
+    EvictLocked();
+    return plan.get();
+}
+
+bool
+PlanCache::Release(const query::Plan* plan) {
+    std::lock_guard lck(mutex_);
+    auto it = handles_.find(plan);
+    if (it == handles_.end()) {
+        return false;
+    }
+    if (--it->second.refs == 0) {
+        handles_.erase(it);
+    }
+    return true;
+}
+
+std::string
+PlanCache::Metrics() const {
+    std::string metrics;
+    auto add = [&](const char* name, const char* help, int64_t value) {
+        metrics += std::string("# HELP ") + name + " " + help + "\n";
+        metrics += std::string("# TYPE ") + name + " counter\n";
+        metrics += std::string(name) + " " + std::to_string(value) + "\n";
+    };
+    add("milvus_segcore_plan_cache_hits_total",
+        "search plans taken from the plan cache",
+        Hits());
+    add("milvus_segcore_plan_cache_misses_total",
+        "search plans parsed as they were not in the plan cache",
+        Misses());
+    return metrics;
+}
+
+void
+PlanCache::EvictLocked() {
+    auto capacity = capacity_.load(std::memory_order_relaxed);
+    while (!lru_.empty() && int64_t(entries_.size()) > capacity) {
+        auto it = entries_.find(*lru_.back());
+        lru_.pop_back();
+        entries_.erase(it);
+    }
+}
+
+}  // namespace milvus::segcore
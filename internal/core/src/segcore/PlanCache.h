@@ -0,0 +1,110 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "common/Schema.h"
+#include "query/PlanImpl.h"
+
+namespace milvus::segcore {
+
+// Node wide LRU cache of the search plans created from serialized plans.
+// A query is searched on every segment of a collection, each search
+// creating its plan from the same bytes, so the plans are shared instead of
+// parsed again. Cached plans are immutable, every Acquire of one takes a
+// reference that Release gives back, and a plan evicted while it is in use
+// lives until its last reference is released.
+class PlanCache {
+ public:
+    static PlanCache&
+    GetInstance() {
+        static PlanCache instance;
+        return instance;
+    }
+
+    // the number of plans kept, a zero capacity disables the cache
+    void
+    SetCapacity(int64_t capacity);
+
+    // the plan of `serialized_plan` on `schema`, taken from the cache or
+    // created; it's given back by Release
+    query::Plan*
+    Acquire(const SchemaPtr& schema,
+            const void* serialized_plan,
+            int64_t size);
+
+    // gives back a plan of Acquire, false if `plan` isn't one of the cache,
+    // the caller deletes it then
+    bool
+    Release(const query::Plan* plan);
+
+    int64_t
+    Hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    int64_t
+    Misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    // hits and misses in the prometheus text format
+    std::string
+    Metrics() const;
+
+ private:
+    PlanCache() = default;
+
+    using Key = std::pair<const Schema*, std::string>;
+
+    struct KeyHash {
+        size_t
+        operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        // keeps the schema the plan refers to
+        SchemaPtr schema;
+        std::shared_ptr<query::Plan> plan;
+        std::list<const Key*>::iterator lru_pos;
+    };
+
+    struct Handle {
+        SchemaPtr schema;
+        std::shared_ptr<query::Plan> plan;
+        int64_t refs = 0;
+    };
+
+    void
+    EvictLocked();
+
+    std::atomic<int64_t> capacity_ = 0;
+    std::atomic<int64_t> hits_ = 0;
+    std::atomic<int64_t> misses_ = 0;
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+    // most recently used first
+    std::list<const Key*> lru_;
+    // the plans acquired and not released yet
+    std::unordered_map<const query::Plan*, Handle> handles_;
+};
+
+}  // namespace milvus::segcore
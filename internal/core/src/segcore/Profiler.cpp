@@ -0,0 +1,161 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/Profiler.h"
+
+#include <dlfcn.h>
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include "exceptions/EasyAssert.h"
+#include "log/Log.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+using ProfilerStartFn = int (*)(const char*);
+using ProfilerStopFn = void (*)();
+
+template <typename Fn>
+Fn
+LookUp(const char* name) {
+    auto fn = reinterpret_cast<Fn>(dlsym(RTLD_DEFAULT, name));
+    AssertInfo(fn != nullptr,
+               fmt::format("{} isn't in the process, the node runs "
+                           "without the library providing it",
+                           name));
+    return fn;
+}
+
+template <typename T>
+T
+ReadMallctl(MallctlFn mallctl, const char* name) {
+    T value{};
+    size_t size = sizeof(value);
+    auto ret = mallctl(name, &value, &size, nullptr, 0);
+    AssertInfo(ret == 0,
+               fmt::format("failed to read {}: {}", name, strerror(ret)));
+    return value;
+}
+
+}  // namespace
+
+CpuProfiler::~CpuProfiler() {
+    Stop();
+}
+
+void
+CpuProfiler::Start(const std::string& path, int64_t seconds) {
+    auto profiler_start = LookUp<ProfilerStartFn>("ProfilerStart");
+    LookUp<ProfilerStopFn>("ProfilerStop");
+    std::lock_guard lck(mutex_);
+    AssertInfo(!running_, "a cpu profile is already running");
+    // the timer of the last profile is done with it
+    if (timer_.joinable()) {
+        timer_.join();
+    }
+    AssertInfo(profiler_start(path.c_str()) != 0,
+               fmt::format("failed to start the cpu profile into {}", path));
+    running_ = true;
+    stop_requested_ = false;
+    timer_ = std::thread([this, seconds] { Run(seconds); });
+    LOG_SEGCORE_INFO_ << "cpu profile started into " << path << " for "
+                      << seconds << "s";
+}
+
+bool
+CpuProfiler::Stop() {
+    std::thread timer;
+    {
+        std::lock_guard lck(mutex_);
+        if (!running_) {
+            return false;
+        }
+        stop_requested_ = true;
+        timer = std::move(timer_);
+    }
+    stopped_.notify_all();
+    if (timer.joinable()) {
+        timer.join();
+    }
+    return true;
+}
+
+bool
+CpuProfiler::Running() const {
+    std::lock_guard lck(mutex_);
+    return running_;
+}
+
+void
+CpuProfiler::Run(int64_t seconds) {
+    auto profiler_stop = LookUp<ProfilerStopFn>("ProfilerStop");
+    std::unique_lock lck(mutex_);
+    auto requested = [this] { return stop_requested_; };
+    if (seconds > 0) {
+        stopped_.wait_for(lck, std::chrono::seconds(seconds), requested);
+    } else {
+        stopped_.wait(lck, requested);
+    }
+    profiler_stop();
+    running_ = false;
+    LOG_SEGCORE_INFO_ << "cpu profile stopped";
+}
+
+MallctlFn
+JemallocMallctl() {
+    static auto mallctl =
+        reinterpret_cast<MallctlFn>(dlsym(RTLD_DEFAULT, "mallctl"));
+    return mallctl;
+}
+
+void
+DumpHeapProfile(const std::string& path) {
+    auto mallctl = LookUp<MallctlFn>("mallctl");
+    AssertInfo(ReadMallctl<bool>(mallctl, "opt.prof"),
+               "jemalloc doesn't profile the heap, the node must run with "
+               "MALLOC_CONF=prof:true");
+    auto file = path.c_str();
+    auto ret = mallctl("prof.dump", nullptr, nullptr, &file, sizeof(file));
+    AssertInfo(ret == 0,
+               fmt::format("failed to dump the heap profile into {}: {}",
+                           path,
+                           strerror(ret)));
+}
+
+JemallocStats
+GetJemallocStats() {
+    auto mallctl = LookUp<MallctlFn>("mallctl");
+    // the stats are a snapshot taken at an epoch
+    uint64_t epoch = 1;
+    size_t size = sizeof(epoch);
+    mallctl("epoch", &epoch, &size, &epoch, size);
+
+    JemallocStats stats;
+    stats.allocated = ReadMallctl<size_t>(mallctl, "stats.allocated");
+    stats.active = ReadMallctl<size_t>(mallctl, "stats.active");
+    stats.resident = ReadMallctl<size_t>(mallctl, "stats.resident");
+    stats.mapped = ReadMallctl<size_t>(mallctl, "stats.mapped");
+    stats.retained = ReadMallctl<size_t>(mallctl, "stats.retained");
+    stats.metadata = ReadMallctl<size_t>(mallctl, "stats.metadata");
+    stats.narenas = ReadMallctl<unsigned>(mallctl, "arenas.narenas");
+    if (stats.active > 0) {
+        stats.fragmentation =
+            double(stats.active - stats.allocated) / stats.active;
+    }
+    return stats;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,94 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace milvus::segcore {
+
+// Profiling of a running node. The gperftools cpu profiler and jemalloc
+// are looked up in the process when they're used, segcore doesn't link
+// them: the calls fail if the node wasn't started with them, e.g. through
+// LD_PRELOAD, and heap profiles need jemalloc to run with prof:true.
+
+struct JemallocStats {
+    // bytes allocated by the application
+    int64_t allocated = 0;
+    // bytes of the pages holding allocations
+    int64_t active = 0;
+    // bytes of the pages mapped and resident
+    int64_t resident = 0;
+    int64_t mapped = 0;
+    // bytes of the unused pages kept mapped for reuse
+    int64_t retained = 0;
+    // bytes of jemalloc's own metadata
+    int64_t metadata = 0;
+    int64_t narenas = 0;
+    // the share of the active pages not allocated, 0 when nothing is
+    double fragmentation = 0;
+};
+
+class CpuProfiler {
+ public:
+    static CpuProfiler&
+    GetInstance() {
+        static CpuProfiler instance;
+        return instance;
+    }
+
+    // profiles the process into `path` for `seconds`, until Stop() for a
+    // non positive duration, one profile at a time
+    void
+    Start(const std::string& path, int64_t seconds);
+
+    // stops the running profile and writes it, false if none is running
+    bool
+    Stop();
+
+    bool
+    Running() const;
+
+ private:
+    CpuProfiler() = default;
+
+    ~CpuProfiler();
+
+    void
+    Run(int64_t seconds);
+
+    mutable std::mutex mutex_;
+    std::condition_variable stopped_;
+    bool running_ = false;
+    bool stop_requested_ = false;
+    // stops the profile once it's due or asked to
+    std::thread timer_;
+};
+
+using MallctlFn = int (*)(const char*, void*, size_t*, void*, size_t);
+
+// the mallctl of the jemalloc in the process, nullptr if it has none
+MallctlFn
+JemallocMallctl();
+
+// writes a jemalloc heap profile to `path`
+void
+DumpHeapProfile(const std::string& path);
+
+JemallocStats
+GetJemallocStats();
+
+}  // namespace milvus::segcore
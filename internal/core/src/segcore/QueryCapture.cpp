@@ -0,0 +1,215 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "segcore/QueryCapture.h"
+
+#include <cstring>
+
+#include "exceptions/EasyAssert.h"
+#include "log/Log.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// every record is its kind, the segment id, the timestamp, the arrival
+// and the latency, the plan, and the placeholders of a search, each a
+// tag, the number of queries, their size and their blob; integers are
+// native, strings are a length and their bytes
+const char capture_magic[8] = {'M', 'Q', 'C', 'A', 'P', 'T', '0', '1'};
+
+template <typename T>
+void
+Put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void
+PutBytes(std::string& out, const char* data, size_t size) {
+    Put<uint64_t>(out, size);
+    out.append(data, size);
+}
+
+template <typename T>
+bool
+Get(std::ifstream& in, T& value) {
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template <typename Container>
+bool
+GetBytes(std::ifstream& in, Container& bytes) {
+    uint64_t size = 0;
+    if (!Get(in, size)) {
+        return false;
+    }
+    bytes.resize(size);
+    return static_cast<bool>(in.read(bytes.data(), size));
+}
+
+}  // namespace
+
+QueryCapture::~QueryCapture() {
+    Stop();
+}
+
+void
+QueryCapture::Start(const std::string& path, int64_t sample_every) {
+    std::lock_guard lck(mutex_);
+    sample_every_.store(0);
+    if (out_.is_open()) {
+        out_.close();
+    }
+    if (path.empty() || sample_every < 1) {
+        return;
+    }
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    AssertInfo(out_.is_open(), "failed to open query capture file " + path);
+    out_.write(capture_magic, sizeof(capture_magic));
+    start_ = std::chrono::steady_clock::now();
+    seen_.store(0);
+    captured_.store(0);
+    sample_every_.store(sample_every);
+    LOG_SEGCORE_INFO_ << "capturing one in " << sample_every
+                      << " queries to " << path;
+}
+
+void
+QueryCapture::Stop() {
+    std::lock_guard lck(mutex_);
+    sample_every_.store(0);
+    if (out_.is_open()) {
+        out_.close();
+    }
+}
+
+bool
+QueryCapture::Sample() {
+    auto sample_every = sample_every_.load(std::memory_order_relaxed);
+    if (sample_every <= 0) {
+        return false;
+    }
+    return seen_.fetch_add(1, std::memory_order_relaxed) % sample_every == 0;
+}
+
+void
+QueryCapture::CaptureSearch(int64_t segment_id,
+                            const query::Plan* plan,
+                            const query::PlaceholderGroup* placeholder_group,
+                            Timestamp timestamp,
+                            int64_t latency_us) {
+    if (plan->serialized_plan_.empty() || !Sample()) {
+        return;
+    }
+    CapturedQuery query;
+    query.kind = CapturedQuery::Search;
+    query.segment_id = segment_id;
+    query.timestamp = timestamp;
+    query.latency_us = latency_us;
+    query.plan = plan->serialized_plan_;
+    query.placeholder_group = *placeholder_group;
+    Write(query);
+}
+
+void
+QueryCapture::CaptureRetrieve(int64_t segment_id,
+                              const query::RetrievePlan* plan,
+                              Timestamp timestamp,
+                              int64_t latency_us) {
+    if (plan->serialized_plan_.empty() || !Sample()) {
+        return;
+    }
+    CapturedQuery query;
+    query.kind = CapturedQuery::Retrieve;
+    query.segment_id = segment_id;
+    query.timestamp = timestamp;
+    query.latency_us = latency_us;
+    query.plan = plan->serialized_plan_;
+    Write(query);
+}
+
+void
+QueryCapture::Write(const CapturedQuery& query) {
+    std::lock_guard lck(mutex_);
+    if (!out_.is_open()) {
+        return;
+    }
+    auto arrival_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - start_)
+                          .count() -
+                      query.latency_us;
+    std::string record;
+    Put<uint8_t>(record, query.kind);
+    Put(record, query.segment_id);
+    Put(record, query.timestamp);
+    Put(record, arrival_us);
+    Put(record, query.latency_us);
+    PutBytes(record, query.plan.data(), query.plan.size());
+    Put<uint64_t>(record, query.placeholder_group.size());
+    for (auto& placeholder : query.placeholder_group) {
+        PutBytes(record, placeholder.tag_.data(), placeholder.tag_.size());
+        Put(record, placeholder.num_of_queries_);
+        Put(record, placeholder.line_sizeof_);
+        PutBytes(record, placeholder.blob_.data(), placeholder.blob_.size());
+    }
+    out_.write(record.data(), record.size());
+    if (!out_.good()) {
+        LOG_SEGCORE_WARNING_ << "failed to write the query capture, stopped";
+        sample_every_.store(0);
+        out_.close();
+        return;
+    }
+    captured_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<CapturedQuery>
+QueryCapture::Read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    AssertInfo(in.is_open(), "failed to open query capture file " + path);
+    char magic[sizeof(capture_magic)];
+    AssertInfo(in.read(magic, sizeof(magic)) &&
+                   std::memcmp(magic, capture_magic, sizeof(magic)) == 0,
+               path + " isn't a query capture file");
+
+    std::vector<CapturedQuery> queries;
+    uint8_t kind = 0;
+    while (Get(in, kind)) {
+        CapturedQuery query;
+        AssertInfo(kind == CapturedQuery::Search ||
+                       kind == CapturedQuery::Retrieve,
+                   "invalid query kind in " + path);
+        query.kind = static_cast<CapturedQuery::Kind>(kind);
+        uint64_t num_placeholders = 0;
+        auto ok = Get(in, query.segment_id) && Get(in, query.timestamp) &&
+                  Get(in, query.arrival_us) && Get(in, query.latency_us) &&
+                  GetBytes(in, query.plan) && Get(in, num_placeholders);
+        for (uint64_t i = 0; ok && i < num_placeholders; ++i) {
+            query::Placeholder placeholder;
+            ok = GetBytes(in, placeholder.tag_) &&
+                 Get(in, placeholder.num_of_queries_) &&
+                 Get(in, placeholder.line_sizeof_) &&
+                 GetBytes(in, placeholder.blob_);
+            query.placeholder_group.push_back(std::move(placeholder));
+        }
+        // a capture stopped by the process exiting may end in the middle
+        // of a record
+        if (!ok) {
+            LOG_SEGCORE_WARNING_ << "truncated record at the end of " << path;
+            break;
+        }
+        queries.push_back(std::move(query));
+    }
+    return queries;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,116 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/Types.h"
+#include "query/PlanImpl.h"
+
+namespace milvus::segcore {
+
+// A search or retrieve as it reached segcore: the serialized plan, the
+// queries and the timestamp, of the segment it ran on, and how long it
+// took.
+struct CapturedQuery {
+    enum Kind : uint8_t {
+        Search = 0,
+        Retrieve = 1,
+    };
+
+    Kind kind = Search;
+    int64_t segment_id = 0;
+    Timestamp timestamp = 0;
+    // since the capture started
+    int64_t arrival_us = 0;
+    int64_t latency_us = 0;
+    // of a search plan or a retrieve plan
+    std::string plan;
+    // empty for a retrieve
+    query::PlaceholderGroup placeholder_group;
+};
+
+// Node wide sampling of the searches and retrieves of the segment C API to
+// a file, so they can be replayed offline against the same segments with
+// the replay bench. One in `sample_every` queries is written, those with
+// plans which aren't serialized are skipped; a write failing stops it.
+class QueryCapture {
+ public:
+    static QueryCapture&
+    GetInstance() {
+        static QueryCapture instance;
+        return instance;
+    }
+
+    // starts writing to `path`, truncated, replacing the current capture,
+    // an empty path or a sample rate under 1 stops it
+    void
+    Start(const std::string& path, int64_t sample_every);
+
+    void
+    Stop();
+
+    bool
+    Enabled() const {
+        return sample_every_.load(std::memory_order_relaxed) > 0;
+    }
+
+    void
+    CaptureSearch(int64_t segment_id,
+                  const query::Plan* plan,
+                  const query::PlaceholderGroup* placeholder_group,
+                  Timestamp timestamp,
+                  int64_t latency_us);
+
+    void
+    CaptureRetrieve(int64_t segment_id,
+                    const query::RetrievePlan* plan,
+                    Timestamp timestamp,
+                    int64_t latency_us);
+
+    // the queries written
+    int64_t
+    Captured() const {
+        return captured_.load(std::memory_order_relaxed);
+    }
+
+    // the queries of a capture file, in the order they were written
+    static std::vector<CapturedQuery>
+    Read(const std::string& path);
+
+ private:
+    QueryCapture() = default;
+
+    ~QueryCapture();
+
+    bool
+    Sample();
+
+    void
+    Write(const CapturedQuery& query);
+
+    std::atomic<int64_t> sample_every_ = 0;
+    std::atomic<int64_t> seen_ = 0;
+    std::atomic<int64_t> captured_ = 0;
+    std::mutex mutex_;
+    std::ofstream out_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace milvus::segcore
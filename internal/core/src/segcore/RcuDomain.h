@@ -0,0 +1,153 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace milvus::segcore {
+
+// Deferred reclamation of the data a writer unpublished while readers may
+// still use it. A reader holds a guard of Read() for as long as it uses
+// the published data, a writer publishes the new data first and retires
+// the old one, which is released once all the readers which entered
+// before are done. Neither side ever waits on the other: the retired data
+// is released by the last of those readers on its way out, or by a later
+// retire.
+//
+// The readers are counted in two slots, the one of the current period
+// and the one of the previous. Retiring flips the period, so the readers
+// which may still see the retired data are all in the slot of the
+// previous one once it has been flipped.
+class RcuDomain {
+ public:
+    class ReadGuard {
+     public:
+        explicit ReadGuard(const RcuDomain* domain)
+            : domain_(domain), slot_(domain->Enter()) {
+        }
+
+        ReadGuard(ReadGuard&& other) noexcept
+            : domain_(std::exchange(other.domain_, nullptr)),
+              slot_(other.slot_) {
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+
+        ReadGuard&
+        operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() {
+            if (domain_ != nullptr) {
+                domain_->Exit(slot_);
+            }
+        }
+
+     private:
+        const RcuDomain* domain_;
+        int slot_;
+    };
+
+    RcuDomain() = default;
+
+    RcuDomain(const RcuDomain&) = delete;
+
+    RcuDomain&
+    operator=(const RcuDomain&) = delete;
+
+    // read sections nest, the threads a reader hands work to are covered
+    // by its guard as long as it waits for them
+    ReadGuard
+    Read() const {
+        return ReadGuard(this);
+    }
+
+    // releases `data`, already unpublished, once no reader can see it
+    void
+    Retire(std::shared_ptr<const void> data) const {
+        {
+            std::lock_guard lck(mutex_);
+            retired_.push_back(std::move(data));
+            pending_.store(true);
+        }
+        Reclaim();
+    }
+
+ private:
+    int
+    Enter() const {
+        while (true) {
+            auto period = period_.load();
+            auto slot = static_cast<int>(period & 1);
+            readers_[slot].fetch_add(1);
+            // a reader counted in the slot of a flipped period may have
+            // missed an unpublish, it enters again
+            if (period_.load() == period) {
+                return slot;
+            }
+            readers_[slot].fetch_sub(1);
+        }
+    }
+
+    void
+    Exit(int slot) const {
+        readers_[slot].fetch_sub(1);
+        if (pending_.load()) {
+            Reclaim();
+        }
+    }
+
+    // the data is released outside the lock, by whoever gets it first
+    void
+    Reclaim() const {
+        std::vector<std::shared_ptr<const void>> released;
+        {
+            std::unique_lock lck(mutex_, std::try_to_lock);
+            if (!lck.owns_lock()) {
+                return;
+            }
+            auto previous = [&] {
+                return static_cast<int>(1 - (period_.load() & 1));
+            };
+            if (!waiting_.empty() && readers_[previous()].load() == 0) {
+                released.swap(waiting_);
+            }
+            if (waiting_.empty() && !retired_.empty()) {
+                waiting_.swap(retired_);
+                period_.fetch_add(1);
+                if (readers_[previous()].load() == 0) {
+                    std::move(waiting_.begin(),
+                              waiting_.end(),
+                              std::back_inserter(released));
+                    waiting_.clear();
+                }
+            }
+            pending_.store(!waiting_.empty() || !retired_.empty());
+        }
+    }
+
+    mutable std::atomic<uint64_t> period_ = 0;
+    mutable std::atomic<int64_t> readers_[2] = {0, 0};
+    mutable std::atomic<bool> pending_ = false;
+    mutable std::mutex mutex_;
+    // retired before the last flip, released once its previous slot drains
+    mutable std::vector<std::shared_ptr<const void>> waiting_;
+    // retired after it
+    mutable std::vector<std::shared_ptr<const void>> retired_;
+};
+
+}  // namespace milvus::segcore
@@ -14,32 +14,65 @@
 #include <log/Log.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <future>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "SegmentInterface.h"
 #include "Utils.h"
-#include "pkVisitor.h"
+#include "common/Cancellation.h"
+#include "common/Common.h"
+#include "common/Metrics.h"
+#include "common/Tracer.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::segcore {
 
+namespace {
+
+int64_t
+ElapsedNanos(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - begin)
+        .count();
+}
+
+}  // namespace
+
 void
-ReduceHelper::Initialize() {
-    AssertInfo(search_results_.size() > 0, "empty search result");
+ReduceHelper::InitializeSlices() {
     AssertInfo(slice_nqs_.size() > 0, "empty slice_nqs");
     AssertInfo(slice_nqs_.size() == slice_topKs_.size(),
                "unaligned slice_nqs and slice_topKs");
-
-    total_nq_ = search_results_[0]->total_nq_;
-    num_segments_ = search_results_.size();
     num_slices_ = slice_nqs_.size();
+    auto& search_info = plan_->plan_node_->search_info_;
+    if (search_info.group_by_field_id_.has_value()) {
+        group_size_ = search_info.group_size_;
+    }
 
     // prefix sum, get slices offsets
-    AssertInfo(num_slices_ > 0, "empty slice_nqs is not allowed");
     slice_nqs_prefix_sum_.resize(num_slices_ + 1);
     std::partial_sum(slice_nqs_.begin(),
                      slice_nqs_.end(),
                      slice_nqs_prefix_sum_.begin() + 1);
+}
+
+void
+ReduceHelper::Initialize() {
+    AssertInfo(search_results_.size() > 0, "empty search result");
+    InitializeSlices();
+
+    total_nq_ = search_results_[0]->total_nq_;
+    auto segment =
+        static_cast<const SegmentInterface*>(search_results_[0]->segment_);
+    if (segment != nullptr) {
+        cpu_group_ = GetCpuGroup(segment->get_cpu_group());
+    }
+    num_segments_ = search_results_.size();
     AssertInfo(slice_nqs_prefix_sum_[num_slices_] == total_nq_,
                "illegal req sizes, slice_nqs_prefix_sum_[last] = " +
                    std::to_string(slice_nqs_prefix_sum_[num_slices_]) +
@@ -50,26 +83,214 @@ ReduceHelper::Initialize() {
     for (auto& search_record : final_search_records_) {
         search_record.resize(total_nq_);
     }
+    final_search_ranks_.resize(num_segments_);
+    for (auto& search_rank : final_search_ranks_) {
+        search_rank.resize(total_nq_);
+    }
 }
 
 void
 ReduceHelper::Reduce() {
+    AssertInfo(!streaming_, "a streaming reduce is ended by Finish");
+    tracer::AutoSpan span("reduce");
+    CheckCancelled();
     FillPrimaryKey();
+    CheckCancelled();
+    auto begin = std::chrono::steady_clock::now();
     ReduceResultData();
     RefreshSearchResult();
-    FillEntryData();
+    phase_times_.reduce_result_data = ElapsedNanos(begin);
+}
+
+void
+ReduceHelper::Push(SearchResult* search_result) {
+    AssertInfo(streaming_, "results are only pushed to a streaming reduce");
+    AssertInfo(search_result != nullptr, "search result must not be null");
+    AssertInfo(search_result->total_nq_ == total_nq_,
+               "illegal nq of a pushed search result, nq = " +
+                   std::to_string(search_result->total_nq_) +
+                   ", total_nq = " + std::to_string(total_nq_));
+    CheckCancelled();
+    // the pks are filled out of the lock, by the thread of the segment
+    auto begin = std::chrono::steady_clock::now();
+    FilterInvalidSearchResult(search_result);
+    auto filter_nanos = ElapsedNanos(begin);
+    if (search_result->get_total_result_count() > 0) {
+        auto segment = static_cast<SegmentInterface*>(search_result->segment_);
+        segment->FillPrimaryKeys(plan_, *search_result);
+    }
+    auto fill_nanos = ElapsedNanos(begin) - filter_nanos;
+
+    std::lock_guard lck(stream_mutex_);
+    phase_times_.filter_invalid_search_result += filter_nanos;
+    phase_times_.fill_primary_key += fill_nanos;
+    if (cpu_group_ == nullptr && search_result->segment_ != nullptr) {
+        cpu_group_ = GetCpuGroup(
+            static_cast<const SegmentInterface*>(search_result->segment_)
+                ->get_cpu_group());
+    }
+    if (search_result->get_total_result_count() == 0) {
+        return;
+    }
+    AssertInfo(search_results_.empty() ||
+                   search_results_[0]->pk_type_ == search_result->pk_type_,
+               "the pushed search results must have the same pk type");
+    auto merge_begin = std::chrono::steady_clock::now();
+    auto index = int64_t(search_results_.size());
+    search_results_.push_back(search_result);
+    num_segments_ = search_results_.size();
+
+    // nq are independent, merged in parallel when there are enough
+    auto is_varchar = search_result->pk_type_ == DataType::VARCHAR;
+    auto num_tasks = std::max<int64_t>(
+        std::min<int64_t>(cpu_num, total_nq_ / MIN_REDUCE_NQ_PER_TASK), 1);
+    auto step = (total_nq_ + num_tasks - 1) / num_tasks;
+    ThreadPool::GetInstance().ParallelFor(
+        num_tasks, num_tasks - 1, [&](int64_t task) {
+            auto nq_begin = std::min(task * step, total_nq_);
+            auto nq_end = std::min(nq_begin + step, total_nq_);
+            if (is_varchar) {
+                MergeStreamHits<std::string_view>(index, nq_begin, nq_end);
+            } else {
+                MergeStreamHits<int64_t>(index, nq_begin, nq_end);
+            }
+        });
+    phase_times_.reduce_result_data += ElapsedNanos(merge_begin);
+}
+
+template <typename PK>
+void
+ReduceHelper::MergeStreamHits(int64_t index, int64_t nq_begin, int64_t nq_end) {
+    auto search_result = search_results_[index];
+    auto pk_at = [this](int64_t segment_index, int64_t offset) {
+        return PrimaryKeyAt<PK>(*search_results_[segment_index], offset);
+    };
+    // the order of SearchResultLoserTree, larger distances first and close
+    // ones by pk
+    auto before = [](float a, const PK& a_pk, float b, const PK& b_pk) {
+        if (std::fabs(a - b) < 0.000001f) {
+            return a_pk < b_pk;
+        }
+        return a > b;
+    };
+
+    std::vector<StreamHit> merged;
+    std::unordered_set<PK> pk_set;
+    std::unordered_map<milvus::GroupByValueType, int64_t> group_counts;
+    auto slice_index = std::upper_bound(slice_nqs_prefix_sum_.begin(),
+                                        slice_nqs_prefix_sum_.end(),
+                                        nq_begin) -
+                       slice_nqs_prefix_sum_.begin() - 1;
+    for (int64_t qi = nq_begin; qi < nq_end; qi++) {
+        while (qi >= slice_nqs_prefix_sum_[slice_index + 1]) {
+            slice_index++;
+        }
+        auto topk = slice_topKs_[slice_index];
+        auto& hits = stream_hits_[qi];
+        auto offset = search_result->topk_per_nq_prefix_sum_[qi];
+        auto offset_end = search_result->topk_per_nq_prefix_sum_[qi + 1];
+        if (offset == offset_end) {
+            continue;
+        }
+
+        // a hit past the top-k of the results merged so far stays past it
+        // as more are merged, so merging the top-k of both is enough
+        merged.clear();
+        pk_set.clear();
+        group_counts.clear();
+        size_t kept = 0;
+        while (int64_t(merged.size()) < topk &&
+               (kept < hits.size() || offset < offset_end)) {
+            StreamHit hit;
+            if (offset < offset_end &&
+                (kept == hits.size() ||
+                 before(search_result->distances_[offset],
+                        pk_at(index, offset),
+                        hits[kept].distance,
+                        pk_at(hits[kept].segment_index, hits[kept].offset)))) {
+                hit = {search_result->distances_[offset], index, offset++};
+            } else {
+                hit = hits[kept++];
+            }
+            auto pk = pk_at(hit.segment_index, hit.offset);
+            if (!pk_set.insert(pk).second) {
+                continue;
+            }
+            // skip the hit of a group already holding group_size_ hits
+            if (group_size_ > 0 &&
+                group_counts[search_results_[hit.segment_index]
+                                 ->group_by_values_.at(hit.offset)]++ >=
+                    group_size_) {
+                continue;
+            }
+            merged.push_back(hit);
+        }
+        hits.swap(merged);
+    }
+}
+
+void
+ReduceHelper::Finish() {
+    AssertInfo(streaming_, "only a streaming reduce is ended by Finish");
+    tracer::AutoSpan span("reduce");
+    CheckCancelled();
+    auto begin = std::chrono::steady_clock::now();
+    final_search_records_.assign(num_segments_,
+                                 std::vector<std::vector<int64_t>>(total_nq_));
+    final_search_ranks_.assign(num_segments_,
+                               std::vector<std::vector<int64_t>>(total_nq_));
+    for (int64_t qi = 0; qi < total_nq_; qi++) {
+        auto& hits = stream_hits_[qi];
+        for (size_t rank = 0; rank < hits.size(); rank++) {
+            auto& hit = hits[rank];
+            final_search_records_[hit.segment_index][qi].push_back(hit.offset);
+            final_search_ranks_[hit.segment_index][qi].push_back(rank);
+        }
+    }
+    stream_hits_.clear();
+    FillResultOffsets();
+    RefreshSearchResult();
+    phase_times_.reduce_result_data += ElapsedNanos(begin);
 }
 
 void
 ReduceHelper::Marshal() {
+    tracer::AutoSpan span("marshal");
+    CheckCancelled();
+    auto begin = std::chrono::steady_clock::now();
+    AssertInfo(entry_data_filled_ || plan_->target_entries_.empty(),
+               "output fields must be filled before marshal");
     // get search result data blobs of slices
     search_result_data_blobs_ =
         std::make_unique<milvus::segcore::SearchResultDataBlobs>();
-    search_result_data_blobs_->blobs.resize(num_slices_);
+    std::vector<std::unique_ptr<milvus::proto::schema::SearchResultData>>
+        slices(num_slices_);
+    auto& offsets = search_result_data_blobs_->offsets;
+    offsets.resize(num_slices_ + 1, 0);
+    for (int i = 0; i < num_slices_; i++) {
+        slices[i] = GetSearchResultDataSlice(i);
+        // ByteSizeLong caches the sizes used by SerializeWithCachedSizesToArray
+        offsets[i + 1] = offsets[i] + slices[i]->ByteSizeLong();
+    }
+
+    // serialize every slice in place, no per slice buffer to copy around
+    search_result_data_blobs_->buffer =
+        std::unique_ptr<char[]>(new char[std::max<int64_t>(offsets.back(), 1)]);
+    auto buffer =
+        reinterpret_cast<uint8_t*>(search_result_data_blobs_->buffer.get());
     for (int i = 0; i < num_slices_; i++) {
-        auto proto = GetSearchResultDataSlice(i);
-        search_result_data_blobs_->blobs[i] = proto;
+        auto end =
+            slices[i]->SerializeWithCachedSizesToArray(buffer + offsets[i]);
+        AssertInfo(end == buffer + offsets[i + 1],
+                   "wrong serialized size of search result data slice " +
+                       std::to_string(i));
+        slices[i].reset();
     }
+    phase_times_.marshal = ElapsedNanos(begin);
+    monitor::reduce_latency.Observe(
+        phase_times_.filter_invalid_search_result +
+        phase_times_.fill_primary_key + phase_times_.reduce_result_data +
+        phase_times_.fill_entry_data + phase_times_.marshal);
 }
 
 void
@@ -88,6 +309,8 @@ ReduceHelper::FilterInvalidSearchResult(SearchResult* search_result) {
     uint32_t valid_index = 0;
     auto& offsets = search_result->seg_offsets_;
     auto& distances = search_result->distances_;
+    auto& group_by_values = search_result->group_by_values_;
+    auto has_group_by = !group_by_values.empty();
     for (auto i = 0; i < nq; ++i) {
         for (auto j = 0; j < topK; ++j) {
             auto index = i * topK + j;
@@ -95,12 +318,19 @@ ReduceHelper::FilterInvalidSearchResult(SearchResult* search_result) {
                 real_topks[i]++;
                 offsets[valid_index] = offsets[index];
                 distances[valid_index] = distances[index];
+                if (has_group_by) {
+                    group_by_values[valid_index] =
+                        std::move(group_by_values[index]);
+                }
                 valid_index++;
             }
         }
     }
     offsets.resize(valid_index);
     distances.resize(valid_index);
+    if (has_group_by) {
+        group_by_values.resize(valid_index);
+    }
 
     search_result->topk_per_nq_prefix_sum_.resize(nq + 1);
     std::partial_sum(real_topks.begin(),
@@ -113,8 +343,12 @@ ReduceHelper::FillPrimaryKey() {
     std::vector<SearchResult*> valid_search_results;
     // get primary keys for duplicates removal
     uint32_t valid_index = 0;
+    auto begin = std::chrono::steady_clock::now();
+    int64_t filter_nanos = 0;
     for (auto& search_result : search_results_) {
+        auto filter_begin = std::chrono::steady_clock::now();
         FilterInvalidSearchResult(search_result);
+        filter_nanos += ElapsedNanos(filter_begin);
         if (search_result->get_total_result_count() > 0) {
             auto segment =
                 static_cast<SegmentInterface*>(search_result->segment_);
@@ -124,6 +358,8 @@ ReduceHelper::FillPrimaryKey() {
     }
     search_results_.resize(valid_index);
     num_segments_ = search_results_.size();
+    phase_times_.filter_invalid_search_result = filter_nanos;
+    phase_times_.fill_primary_key = ElapsedNanos(begin) - filter_nanos;
 }
 
 void
@@ -136,23 +372,39 @@ ReduceHelper::RefreshSearchResult() {
             for (int j = 0; j < total_nq_; j++) {
                 size += final_search_records_[i][j].size();
             }
-            std::vector<milvus::PkType> primary_keys(size);
+            auto is_varchar = search_result->pk_type_ == DataType::VARCHAR;
+            std::vector<int64_t> int64_pks(is_varchar ? 0 : size);
+            std::vector<std::string> string_pks(is_varchar ? size : 0);
             std::vector<float> distances(size);
             std::vector<int64_t> seg_offsets(size);
+            auto has_group_by = !search_result->group_by_values_.empty();
+            std::vector<milvus::GroupByValueType> group_by_values(
+                has_group_by ? size : 0);
 
             uint32_t index = 0;
             for (int j = 0; j < total_nq_; j++) {
                 for (auto offset : final_search_records_[i][j]) {
-                    primary_keys[index] = search_result->primary_keys_[offset];
+                    if (is_varchar) {
+                        string_pks[index] =
+                            std::move(search_result->string_pks_[offset]);
+                    } else {
+                        int64_pks[index] = search_result->int64_pks_[offset];
+                    }
                     distances[index] = search_result->distances_[offset];
                     seg_offsets[index] = search_result->seg_offsets_[offset];
+                    if (has_group_by) {
+                        group_by_values[index] = std::move(
+                            search_result->group_by_values_[offset]);
+                    }
                     index++;
                     real_topks[j]++;
                 }
             }
-            search_result->primary_keys_.swap(primary_keys);
+            search_result->int64_pks_.swap(int64_pks);
+            search_result->string_pks_.swap(string_pks);
             search_result->distances_.swap(distances);
             search_result->seg_offsets_.swap(seg_offsets);
+            search_result->group_by_values_.swap(group_by_values);
         }
         std::partial_sum(real_topks.begin(),
                          real_topks.end(),
@@ -162,24 +414,77 @@ ReduceHelper::RefreshSearchResult() {
 
 void
 ReduceHelper::FillEntryData() {
-    for (auto search_result : search_results_) {
+    tracer::AutoSpan span("fill_entry_data");
+    auto begin = std::chrono::steady_clock::now();
+    // the workers fill their segments within the trace and the
+    // cancellation of the caller
+    auto parent_span = tracer::GetActiveSpan();
+    auto token = GetActiveCancellation();
+    auto fill = [this, parent_span, token](SearchResult* search_result) {
+        tracer::ActiveSpanScope span_scope(parent_span);
+        CancellationScope cancellation_scope(token);
+        CheckCancelled();
         auto segment = static_cast<milvus::segcore::SegmentInterface*>(
             search_result->segment_);
         segment->FillTargetEntry(plan_, *search_result);
+    };
+
+    // segments are filled in parallel when there is enough to gather, each
+    // of them may split its fields further
+    int64_t rows = 0;
+    for (auto search_result : search_results_) {
+        rows += search_result->seg_offsets_.size();
+    }
+    auto bytes =
+        EstimateTargetEntryBytes(plan_->schema_, plan_->target_entries_, rows);
+    if (search_results_.size() <= 1 ||
+        bytes < 2 * MIN_FILL_TARGET_ENTRY_BYTES_PER_TASK) {
+        for (auto search_result : search_results_) {
+            fill(search_result);
+        }
+        entry_data_filled_ = true;
+        phase_times_.fill_entry_data = ElapsedNanos(begin);
+        return;
     }
-}
 
-int64_t
-ReduceHelper::ReduceSearchResultForOneNQ(int64_t qi,
-                                         int64_t topk,
-                                         int64_t& offset) {
-    while (!heap_.empty()) {
-        heap_.pop();
+    auto& pool = ThreadPool::GetInstance();
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < search_results_.size(); ++i) {
+        futures.push_back(pool.Submit(fill, search_results_[i]));
     }
-    pk_set_.clear();
-    pairs_.clear();
+    std::exception_ptr error;
+    try {
+        fill(search_results_[0]);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // wait all tasks before rethrowing, they reference the search results
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    entry_data_filled_ = true;
+    phase_times_.fill_entry_data = ElapsedNanos(begin);
+}
 
-    pairs_.reserve(num_segments_);
+template <typename PK>
+int64_t
+ReduceHelper::ReduceSearchResultForOneNQ(MergeContext<PK>& ctx,
+                                         int64_t qi,
+                                         int64_t topk) {
+    ctx.pk_set_.clear();
+    ctx.group_counts_.clear();
+    ctx.pairs_.clear();
+
+    ctx.pairs_.reserve(num_segments_);
     for (int i = 0; i < num_segments_; i++) {
         auto search_result = search_results_[i];
         auto offset_beg = search_result->topk_per_nq_prefix_sum_[qi];
@@ -187,48 +492,69 @@ ReduceHelper::ReduceSearchResultForOneNQ(int64_t qi,
         if (offset_beg == offset_end) {
             continue;
         }
-        auto primary_key = search_result->primary_keys_[offset_beg];
+        auto primary_key = PrimaryKeyAt<PK>(*search_result, offset_beg);
         auto distance = search_result->distances_[offset_beg];
 
-        pairs_.emplace_back(
+        ctx.pairs_.emplace_back(
             primary_key, distance, search_result, i, offset_beg, offset_end);
-        heap_.push(&pairs_.back());
     }
 
     // nq has no results for all segments
-    if (heap_.size() == 0) {
+    if (ctx.pairs_.size() == 0) {
         return 0;
     }
+    ctx.tree_.Build(ctx.pairs_);
 
     int64_t dup_cnt = 0;
-    auto start = offset;
-    while (offset - start < topk && !heap_.empty()) {
-        auto pilot = heap_.top();
-        heap_.pop();
+    int64_t rank = 0;
+    while (rank < topk) {
+        auto pilot = ctx.tree_.Top();
+        if (pilot == nullptr) {
+            break;
+        }
 
         auto index = pilot->segment_index_;
         auto pk = pilot->primary_key_;
-        // no valid search result for this nq, break to next
-        if (pk == INVALID_PK) {
-            break;
-        }
         // remove duplicates
-        if (pk_set_.count(pk) == 0) {
-            pilot->search_result_->result_offsets_.push_back(offset++);
-            final_search_records_[index][qi].push_back(pilot->offset_);
-            pk_set_.insert(pk);
+        if (ctx.pk_set_.count(pk) == 0) {
+            // skip entity of a group already holding group_size_ hits
+            if (group_size_ == 0 ||
+                ctx.group_counts_[pilot->search_result_->group_by_values_.at(
+                    pilot->offset_)]++ < group_size_) {
+                final_search_ranks_[index][qi].push_back(rank++);
+                final_search_records_[index][qi].push_back(pilot->offset_);
+            }
+            ctx.pk_set_.insert(pk);
         } else {
             // skip entity with same primary key
             dup_cnt++;
         }
         pilot->advance();
-        if (pilot->primary_key_ != INVALID_PK) {
-            heap_.push(pilot);
-        }
+        ctx.tree_.Replay();
     }
     return dup_cnt;
 }
 
+template <typename PK>
+int64_t
+ReduceHelper::ReduceSearchResultForNQRange(int64_t nq_begin, int64_t nq_end) {
+    MergeContext<PK> ctx;
+    int64_t skip_dup_cnt = 0;
+    auto slice_index = std::upper_bound(slice_nqs_prefix_sum_.begin(),
+                                        slice_nqs_prefix_sum_.end(),
+                                        nq_begin) -
+                       slice_nqs_prefix_sum_.begin() - 1;
+    for (int64_t qi = nq_begin; qi < nq_end; qi++) {
+        CheckCancelled();
+        while (qi >= slice_nqs_prefix_sum_[slice_index + 1]) {
+            slice_index++;
+        }
+        skip_dup_cnt +=
+            ReduceSearchResultForOneNQ(ctx, qi, slice_topKs_[slice_index]);
+    }
+    return skip_dup_cnt;
+}
+
 void
 ReduceHelper::ReduceResultData() {
     for (int i = 0; i < num_segments_; i++) {
@@ -240,29 +566,83 @@ ReduceHelper::ReduceResultData() {
                    "incorrect search result distance size");
         AssertInfo(search_result->seg_offsets_.size() == result_count,
                    "incorrect search result seg offset size");
-        AssertInfo(search_result->primary_keys_.size() == result_count,
+        auto pk_count = search_result->pk_type_ == DataType::VARCHAR
+                            ? search_result->string_pks_.size()
+                            : search_result->int64_pks_.size();
+        AssertInfo(pk_count == result_count,
                    "incorrect search result primary key size");
     }
 
+    // the segments of a collection share the pk type
+    auto is_varchar = num_segments_ > 0 &&
+                      search_results_[0]->pk_type_ == DataType::VARCHAR;
+    auto reduce_range = [this, is_varchar](int64_t nq_begin, int64_t nq_end) {
+        if (is_varchar) {
+            return ReduceSearchResultForNQRange<std::string_view>(nq_begin,
+                                                                  nq_end);
+        }
+        return ReduceSearchResultForNQRange<int64_t>(nq_begin, nq_end);
+    };
+
+    // nq are independent, reduce them in parallel when there are enough
     int64_t skip_dup_cnt = 0;
+    auto num_tasks =
+        std::min<int64_t>(cpu_num, total_nq_ / MIN_REDUCE_NQ_PER_TASK);
+    if (num_segments_ > 1 && num_tasks > 1) {
+        auto& pool = ThreadPool::GetInstance();
+        auto step = (total_nq_ + num_tasks - 1) / num_tasks;
+        auto token = GetActiveCancellation();
+        std::vector<std::future<int64_t>> futures;
+        for (int64_t nq_begin = 0; nq_begin < total_nq_; nq_begin += step) {
+            auto nq_end = std::min(nq_begin + step, total_nq_);
+            futures.emplace_back(
+                pool.Submit([&reduce_range, token, nq_begin, nq_end]() {
+                    CancellationScope cancellation_scope(token);
+                    return reduce_range(nq_begin, nq_end);
+                }));
+        }
+        // wait all tasks before rethrowing, they reference this helper
+        for (auto& future : futures) {
+            future.wait();
+        }
+        for (auto& future : futures) {
+            skip_dup_cnt += future.get();
+        }
+    } else {
+        skip_dup_cnt = reduce_range(0, total_nq_);
+    }
+    FillResultOffsets();
+
+    if (skip_dup_cnt > 0) {
+        LOG_SEGCORE_DEBUG_ << "skip duplicated search result, count = "
+                           << skip_dup_cnt;
+    }
+}
+
+void
+ReduceHelper::FillResultOffsets() {
     for (int64_t slice_index = 0; slice_index < num_slices_; slice_index++) {
         auto nq_begin = slice_nqs_prefix_sum_[slice_index];
         auto nq_end = slice_nqs_prefix_sum_[slice_index + 1];
 
-        // reduce search results
+        // result offsets are counted from the beginning of each slice
         int64_t offset = 0;
         for (int64_t qi = nq_begin; qi < nq_end; qi++) {
-            skip_dup_cnt += ReduceSearchResultForOneNQ(
-                qi, slice_topKs_[slice_index], offset);
+            int64_t nq_count = 0;
+            for (int i = 0; i < num_segments_; i++) {
+                auto& ranks = final_search_ranks_[i][qi];
+                for (auto rank : ranks) {
+                    search_results_[i]->result_offsets_.push_back(offset +
+                                                                  rank);
+                }
+                nq_count += ranks.size();
+            }
+            offset += nq_count;
         }
     }
-    if (skip_dup_cnt > 0) {
-        LOG_SEGCORE_DEBUG_ << "skip duplicated search result, count = "
-                           << skip_dup_cnt;
-    }
 }
 
-std::vector<char>
+std::unique_ptr<milvus::proto::schema::SearchResultData>
 ReduceHelper::GetSearchResultDataSlice(int slice_index) {
     auto nq_begin = slice_nqs_prefix_sum_[slice_index];
     auto nq_end = slice_nqs_prefix_sum_[slice_index + 1];
@@ -342,17 +722,14 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
                         search_result_data->mutable_ids()
                             ->mutable_int_id()
                             ->mutable_data()
-                            ->Set(loc,
-                                  std::visit(Int64PKVisitor{},
-                                             search_result->primary_keys_[ki]));
+                            ->Set(loc, search_result->int64_pks_[ki]);
                         break;
                     }
                     case milvus::DataType::VARCHAR: {
                         *search_result_data->mutable_ids()
                              ->mutable_str_id()
                              ->mutable_data()
-                             ->Mutable(loc) = std::visit(
-                            StrPKVisitor{}, search_result->primary_keys_[ki]);
+                             ->Mutable(loc) = search_result->string_pks_[ki];
                         break;
                     }
                     default: {
@@ -386,12 +763,7 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
             field_data.release());
     }
 
-    // SearchResultData to blob
-    auto size = search_result_data->ByteSizeLong();
-    auto buffer = std::vector<char>(size);
-    search_result_data->SerializePartialToArray(buffer.data(), size);
-
-    return buffer;
+    return search_result_data;
 }
 
 }  // namespace milvus::segcore
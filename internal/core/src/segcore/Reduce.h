@@ -14,26 +14,45 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <vector>
-#include <queue>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "utils/Status.h"
 #include "common/type_c.h"
+#include "common/CpuGroup.h"
 #include "common/QueryResult.h"
 #include "query/PlanImpl.h"
 #include "ReduceStructure.h"
 
 namespace milvus::segcore {
 
-// SearchResultDataBlobs contains the marshal blobs of many `milvus::proto::schema::SearchResultData`
+// SearchResultDataBlobs contains the marshal blobs of many `milvus::proto::schema::SearchResultData`,
+// all slices are serialized back to back into one buffer, blob i is [offsets[i], offsets[i + 1])
 struct SearchResultDataBlobs {
-    std::vector<std::vector<char>> blobs;
+    std::unique_ptr<char[]> buffer;
+    std::vector<int64_t> offsets;
+
+    int64_t
+    size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    const char*
+    blob_data(int64_t index) const {
+        return buffer.get() + offsets[index];
+    }
+
+    int64_t
+    blob_size(int64_t index) const {
+        return offsets[index + 1] - offsets[index];
+    }
 };
 
 class ReduceHelper {
  public:
-    explicit ReduceHelper(std::vector<SearchResult*>& search_results,
+    explicit ReduceHelper(const std::vector<SearchResult*>& search_results,
                           milvus::query::Plan* plan,
                           int64_t* slice_nqs,
                           int64_t* slice_topKs,
@@ -45,9 +64,42 @@ class ReduceHelper {
         Initialize();
     }
 
+    // a streaming reduce: the results are pushed as their segments are
+    // searched and merged into the running top-k of every nq right away,
+    // Finish leaves the helper as Reduce does
+    explicit ReduceHelper(milvus::query::Plan* plan,
+                          int64_t* slice_nqs,
+                          int64_t* slice_topKs,
+                          int64_t slice_num)
+        : plan_(plan),
+          slice_nqs_(slice_nqs, slice_nqs + slice_num),
+          slice_topKs_(slice_topKs, slice_topKs + slice_num),
+          streaming_(true) {
+        InitializeSlices();
+        total_nq_ = slice_nqs_prefix_sum_[num_slices_];
+        num_segments_ = 0;
+        stream_hits_.resize(total_nq_);
+    }
+
+    // merge the segment results on (pk, distance, seg offset) only, the
+    // losers are dropped before any output field is fetched
     void
     Reduce();
 
+    // merges the result of one more segment, which must outlive the helper,
+    // may be called from several threads at once
+    void
+    Push(SearchResult* search_result);
+
+    // ends a streaming reduce once every result is pushed, only the record
+    // of the hits kept is left to do
+    void
+    Finish();
+
+    // fetch the output fields of the reduced results, call after Reduce
+    void
+    FillEntryData();
+
     void
     Marshal();
 
@@ -56,10 +108,40 @@ class ReduceHelper {
         return search_result_data_blobs_.release();
     }
 
+    // wall time spent in each phase, in nanoseconds
+    struct PhaseTimes {
+        int64_t filter_invalid_search_result = 0;
+        int64_t fill_primary_key = 0;
+        int64_t reduce_result_data = 0;
+        int64_t fill_entry_data = 0;
+        int64_t marshal = 0;
+    };
+
+    const PhaseTimes&
+    phase_times() const {
+        return phase_times_;
+    }
+
+    // the cpu group of the segments searched, null for none
+    CpuGroup*
+    cpu_group() const {
+        return cpu_group_;
+    }
+
  private:
     void
     Initialize();
 
+    // the slices and the group size, shared by both reduces
+    void
+    InitializeSlices();
+
+    // merges the hits of search_results_[index] into stream_hits_ of the
+    // nq in [nq_begin, nq_end)
+    template <typename PK>
+    void
+    MergeStreamHits(int64_t index, int64_t nq_begin, int64_t nq_end);
+
     void
     FilterInvalidSearchResult(SearchResult* search_result);
 
@@ -69,18 +151,35 @@ class ReduceHelper {
     void
     RefreshSearchResult();
 
-    void
-    FillEntryData();
+    // Used for merge results, each reducing thread owns one, typed on the
+    // pk: int64_t, or std::string_view of the keys kept by the results
+    template <typename PK>
+    struct MergeContext {
+        std::vector<SearchResultPair<PK>> pairs_;
+        SearchResultLoserTree<SearchResultPair<PK>> tree_;
+        std::unordered_set<PK> pk_set_;
+        // hits taken of each group, at most topk entries
+        std::unordered_map<milvus::GroupByValueType, int64_t> group_counts_;
+    };
+
+    template <typename PK>
+    int64_t
+    ReduceSearchResultForOneNQ(MergeContext<PK>& ctx,
+                               int64_t qi,
+                               int64_t topk);
 
+    // reduce nq in [nq_begin, nq_end), returns the skipped duplicates count
+    template <typename PK>
     int64_t
-    ReduceSearchResultForOneNQ(int64_t qi,
-                               int64_t topk,
-                               int64_t& result_offset);
+    ReduceSearchResultForNQRange(int64_t nq_begin, int64_t nq_end);
 
     void
     ReduceResultData();
 
-    std::vector<char>
+    void
+    FillResultOffsets();
+
+    std::unique_ptr<milvus::proto::schema::SearchResultData>
     GetSearchResultDataSlice(int slice_index_);
 
  private:
@@ -89,26 +188,38 @@ class ReduceHelper {
     int64_t total_nq_;
     int64_t num_segments_;
     int64_t num_slices_;
+    // max hits of each group for one nq, 0 if the plan doesn't group by
+    int64_t group_size_ = 0;
 
     milvus::query::Plan* plan_;
-    std::vector<SearchResult*>& search_results_;
+    std::vector<SearchResult*> search_results_;
+    bool entry_data_filled_ = false;
 
     std::vector<int64_t> slice_nqs_prefix_sum_;
 
     // dim0: num_segments_; dim1: total_nq_; dim2: offset
     std::vector<std::vector<std::vector<int64_t>>> final_search_records_;
+    // same layout as final_search_records_, the rank of each record in
+    // the merged result of its nq
+    std::vector<std::vector<std::vector<int64_t>>> final_search_ranks_;
 
     // output
     std::unique_ptr<SearchResultDataBlobs> search_result_data_blobs_;
 
-    // Used for merge results,
-    // define these here to avoid allocating them for each query
-    std::vector<SearchResultPair> pairs_;
-    std::priority_queue<SearchResultPair*,
-                        std::vector<SearchResultPair*>,
-                        SearchResultPairComparator>
-        heap_;
-    std::unordered_set<milvus::PkType> pk_set_;
+    PhaseTimes phase_times_;
+    CpuGroup* cpu_group_ = nullptr;
+
+    // a hit of the running top-k of an nq of a streaming reduce
+    struct StreamHit {
+        float distance;
+        int64_t segment_index;
+        int64_t offset;
+    };
+    bool streaming_ = false;
+    // serializes the merges of the pushed results
+    std::mutex stream_mutex_;
+    // dim0: total_nq_, the hits kept so far, best first
+    std::vector<std::vector<StreamHit>> stream_hits_;
 };
 
 }  // namespace milvus::segcore
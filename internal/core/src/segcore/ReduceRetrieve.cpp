@@ -0,0 +1,214 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/ReduceRetrieve.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "common/SystemProperty.h"
+#include "common/Tracer.h"
+#include "segcore/Utils.h"
+#include "storage/ThreadPool.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// a row the merge keeps, the index of its segment and of the row among
+// the ones retrieved from it
+struct MergedRow {
+    int64_t segment;
+    int64_t row;
+};
+
+template <typename PK>
+std::vector<PK>
+GetPks(const DataArray& pks) {
+    std::vector<PK> keys;
+    if constexpr (std::is_same_v<PK, int64_t>) {
+        auto& data = pks.scalars().long_data().data();
+        keys.assign(data.begin(), data.end());
+    } else {
+        auto& data = pks.scalars().string_data().data();
+        keys.reserve(data.size());
+        for (auto& key : data) {
+            keys.emplace_back(key);
+        }
+    }
+    return keys;
+}
+
+// `keys` gets the pks of the rows of every segment, the string ones view
+// the pks of `rows`
+template <typename PK>
+std::vector<MergedRow>
+MergeByPk(const std::vector<RetrievedRows>& rows,
+          int64_t limit,
+          std::vector<std::vector<PK>>& keys) {
+    auto num_segments = rows.size();
+    keys.resize(num_segments);
+    // the rows of every segment by pk, the rows come ascending by offset
+    // and are often ascending by pk as well
+    std::vector<std::vector<int64_t>> orders(num_segments);
+    for (size_t i = 0; i < num_segments; ++i) {
+        auto& segment_keys = keys[i];
+        segment_keys = GetPks<PK>(*rows[i].pks);
+        auto& order = orders[i];
+        order.resize(segment_keys.size());
+        std::iota(order.begin(), order.end(), 0);
+        if (!std::is_sorted(segment_keys.begin(), segment_keys.end())) {
+            std::stable_sort(
+                order.begin(), order.end(), [&](int64_t a, int64_t b) {
+                    return segment_keys[a] < segment_keys[b];
+                });
+        }
+    }
+
+    // a cursor per segment with rows left, the least pk on top
+    using Cursor = std::pair<PK, int64_t>;
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>>
+        heap;
+    std::vector<size_t> positions(num_segments, 0);
+    auto push = [&](int64_t segment) {
+        auto pos = positions[segment];
+        if (pos < orders[segment].size()) {
+            heap.emplace(keys[segment][orders[segment][pos]], segment);
+        }
+    };
+    for (size_t i = 0; i < num_segments; ++i) {
+        push(i);
+    }
+
+    std::vector<MergedRow> merged;
+    while (!heap.empty() && (limit <= 0 || int64_t(merged.size()) < limit)) {
+        auto pk = heap.top().first;
+        // the rows of the pk, of any segment, are dropped for the latest
+        MergedRow latest{-1, -1};
+        Timestamp latest_ts = 0;
+        while (!heap.empty() && heap.top().first == pk) {
+            auto segment = heap.top().second;
+            heap.pop();
+            auto row = orders[segment][positions[segment]++];
+            auto ts = rows[segment].timestamps[row];
+            if (latest.segment < 0 || ts > latest_ts) {
+                latest = {segment, row};
+                latest_ts = ts;
+            }
+            push(segment);
+        }
+        merged.push_back(latest);
+    }
+    return merged;
+}
+
+}  // namespace
+
+std::unique_ptr<proto::segcore::RetrieveResults>
+ReduceRetrieveResults(const std::vector<const SegmentInterface*>& segments,
+                      const query::RetrievePlan* plan,
+                      Timestamp timestamp) {
+    AssertInfo(plan, "empty plan");
+    AssertInfo(!segments.empty(), "no segment to retrieve");
+    auto pk_field_id = plan->schema_.get_primary_field_id();
+    AssertInfo(pk_field_id.has_value(), "schema has no primary key");
+    auto num_segments = int64_t(segments.size());
+    std::vector<const SegmentInternalInterface*> internals(num_segments);
+    for (int64_t i = 0; i < num_segments; ++i) {
+        internals[i] =
+            dynamic_cast<const SegmentInternalInterface*>(segments[i]);
+        AssertInfo(internals[i] != nullptr, "segment conversion failed");
+    }
+
+    auto& pool = ThreadPool::GetInstance();
+    std::vector<RetrievedRows> rows(num_segments);
+    {
+        tracer::AutoSpan span("retrieve_segments");
+        pool.ParallelFor(num_segments, num_segments - 1, [&](int64_t i) {
+            rows[i] = internals[i]->RetrieveRows(plan, timestamp);
+        });
+    }
+
+    auto results = std::make_unique<proto::segcore::RetrieveResults>();
+    auto limit = plan->plan_node_->limit_;
+    std::vector<MergedRow> merged;
+    switch (plan->schema_[pk_field_id.value()].get_data_type()) {
+        case DataType::INT64: {
+            std::vector<std::vector<int64_t>> keys;
+            merged = MergeByPk(rows, limit, keys);
+            auto ids = results->mutable_ids()->mutable_int_id()->mutable_data();
+            ids->Reserve(merged.size());
+            for (auto& row : merged) {
+                ids->Add(keys[row.segment][row.row]);
+            }
+            break;
+        }
+        case DataType::VARCHAR: {
+            std::vector<std::vector<std::string_view>> keys;
+            merged = MergeByPk(rows, limit, keys);
+            auto ids = results->mutable_ids()->mutable_str_id()->mutable_data();
+            ids->Reserve(merged.size());
+            for (auto& row : merged) {
+                ids->Add(std::string(keys[row.segment][row.row]));
+            }
+            break;
+        }
+        default: {
+            PanicInfo("unsupported data type");
+        }
+    }
+
+    // the kept rows of every segment in the order of the merge, and where
+    // every merged row is among them
+    std::vector<std::vector<int64_t>> offsets(num_segments);
+    std::vector<std::pair<int64_t, int64_t>> positions;
+    positions.reserve(merged.size());
+    for (auto& row : merged) {
+        auto& segment_offsets = offsets[row.segment];
+        positions.emplace_back(row.segment, segment_offsets.size());
+        segment_offsets.push_back(rows[row.segment].offsets[row.row]);
+    }
+    std::vector<proto::segcore::RetrieveResults> gathered(num_segments);
+    {
+        tracer::AutoSpan span("fill_retrieve_fields");
+        pool.ParallelFor(num_segments, num_segments - 1, [&](int64_t i) {
+            if (!offsets[i].empty()) {
+                internals[i]->FillRetrieveFields(
+                    plan, offsets[i].data(), offsets[i].size(), gathered[i]);
+            }
+        });
+    }
+
+    std::vector<std::pair<DataArray*, int64_t>> sources(merged.size());
+    auto& field_ids = plan->field_ids_;
+    for (size_t f = 0; f < field_ids.size(); ++f) {
+        for (size_t i = 0; i < merged.size(); ++i) {
+            auto [segment, index] = positions[i];
+            sources[i] = {gathered[segment].mutable_fields_data(f), index};
+        }
+        auto field_id = field_ids[f];
+        auto field_data =
+            SystemProperty::Instance().IsSystem(field_id)
+                ? MergeDataArray(
+                      sources,
+                      FieldMeta(FieldName("system"), field_id, DataType::INT64))
+                : MergeDataArray(sources, plan->schema_[field_id]);
+        results->mutable_fields_data()->AddAllocated(field_data.release());
+    }
+    return results;
+}
+
+}  // namespace milvus::segcore
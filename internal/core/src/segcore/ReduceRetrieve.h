@@ -0,0 +1,36 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/Types.h"
+#include "pb/segcore.pb.h"
+#include "query/PlanImpl.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::segcore {
+
+// Retrieves `segments` with one plan and merges their rows the way the
+// proxy expects them: ascending by pk, each pk once from its row with the
+// latest timestamp, and no more than the limit of the plan. The segments
+// are retrieved concurrently for the offsets, pks and timestamps of their
+// rows only, merged k-way by pk, and the output fields are gathered for
+// just the rows kept. The offsets of the result are left empty, its rows
+// are of several segments.
+std::unique_ptr<proto::segcore::RetrieveResults>
+ReduceRetrieveResults(const std::vector<const SegmentInterface*>& segments,
+                      const query::RetrievePlan* plan,
+                      Timestamp timestamp);
+
+}  // namespace milvus::segcore
@@ -11,8 +11,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "common/Consts.h"
 #include "common/Types.h"
@@ -20,15 +24,36 @@
 
 using milvus::SearchResult;
 
+// the primary key at `offset` of a result, an int64 or a view of the string
+// kept by the result
+template <typename PK>
+PK
+PrimaryKeyAt(const SearchResult& result, int64_t offset);
+
+template <>
+inline int64_t
+PrimaryKeyAt<int64_t>(const SearchResult& result, int64_t offset) {
+    return result.int64_pks_[offset];
+}
+
+template <>
+inline std::string_view
+PrimaryKeyAt<std::string_view>(const SearchResult& result, int64_t offset) {
+    return result.string_pks_[offset];
+}
+
+// The cursor of reduce over the results of one segment for one nq, typed
+// on the pk so comparing and hashing it doesn't go through a variant.
+template <typename PK>
 struct SearchResultPair {
-    milvus::PkType primary_key_;
+    PK primary_key_;
     float distance_;
     milvus::SearchResult* search_result_;
     int64_t segment_index_;
     int64_t offset_;
     int64_t offset_rb_;  // right bound
 
-    SearchResultPair(milvus::PkType primary_key,
+    SearchResultPair(PK primary_key,
                      float distance,
                      SearchResult* result,
                      int64_t index,
@@ -50,22 +75,98 @@ struct SearchResultPair {
         return distance_ > other.distance_;
     }
 
+    bool
+    exhausted() const {
+        return offset_ >= offset_rb_;
+    }
+
     void
     advance() {
         offset_++;
         if (offset_ < offset_rb_) {
-            primary_key_ = search_result_->primary_keys_.at(offset_);
-            distance_ = search_result_->distances_.at(offset_);
+            primary_key_ = PrimaryKeyAt<PK>(*search_result_, offset_);
+            distance_ = search_result_->distances_[offset_];
         } else {
-            primary_key_ = INVALID_PK;
+            primary_key_ = PK();
             distance_ = std::numeric_limits<float>::min();
         }
     }
 };
 
-struct SearchResultPairComparator {
+// Tournament tree of losers over the per segment result cursors, the
+// winner is the pair which should be taken next. Replaying after the
+// winner advanced costs log2(k) comparisons against the stored losers,
+// while a binary heap needs about two comparisons per level.
+template <typename Pair>
+class SearchResultLoserTree {
+ public:
+    void
+    Build(std::vector<Pair>& pairs) {
+        players_.clear();
+        for (auto& pair : pairs) {
+            players_.push_back(&pair);
+        }
+        auto n = int64_t(players_.size());
+        losers_.assign(std::max<int64_t>(n, 1), -1);
+        if (n == 0) {
+            return;
+        }
+        // leaves are [n, 2n), internal node i plays 2i and 2i + 1
+        winners_.resize(2 * n);
+        for (int64_t i = 0; i < n; i++) {
+            winners_[n + i] = i;
+        }
+        for (int64_t node = n - 1; node >= 1; node--) {
+            auto lhs = winners_[2 * node];
+            auto rhs = winners_[2 * node + 1];
+            if (Beats(lhs, rhs)) {
+                winners_[node] = lhs;
+                losers_[node] = rhs;
+            } else {
+                winners_[node] = rhs;
+                losers_[node] = lhs;
+            }
+        }
+        losers_[0] = n == 1 ? 0 : winners_[1];
+    }
+
+    // nullptr once every cursor is exhausted
+    Pair*
+    Top() const {
+        if (players_.empty()) {
+            return nullptr;
+        }
+        auto pilot = players_[losers_[0]];
+        return pilot->exhausted() ? nullptr : pilot;
+    }
+
+    // must be called after the winner returned by Top() advanced
+    void
+    Replay() {
+        auto n = int64_t(players_.size());
+        auto winner = losers_[0];
+        for (auto node = (winner + n) / 2; node >= 1; node /= 2) {
+            if (Beats(losers_[node], winner)) {
+                std::swap(losers_[node], winner);
+            }
+        }
+        losers_[0] = winner;
+    }
+
+ private:
     bool
-    operator()(const SearchResultPair* lhs, const SearchResultPair* rhs) const {
-        return *rhs > *lhs;
+    Beats(int64_t lhs, int64_t rhs) const {
+        auto l = players_[lhs];
+        auto r = players_[rhs];
+        if (l->exhausted() || r->exhausted()) {
+            return !l->exhausted();
+        }
+        return *l > *r;
     }
+
+ private:
+    std::vector<Pair*> players_;
+    // losers_[0] holds the winner
+    std::vector<int64_t> losers_;
+    std::vector<int64_t> winners_;
 };
@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <memory>
 #include <shared_mutex>
+#include <string>
 #include <utility>
 #include <tbb/concurrent_hash_map.h>
 
@@ -27,18 +28,31 @@ namespace milvus::segcore {
 struct SealedIndexingEntry {
     MetricType metric_type_;
     index::IndexBasePtr indexing_;
+    // the params the index is loaded with, e.g. its nlist
+    std::map<std::string, std::string> index_params_;
 };
 
-using SealedIndexingEntryPtr = std::unique_ptr<SealedIndexingEntry>;
+using SealedIndexingEntryPtr = std::shared_ptr<const SealedIndexingEntry>;
 
 struct SealedIndexingRecord {
+    SealedIndexingRecord() = default;
+
+    // the copies share the entries, which aren't changed once appended
+    SealedIndexingRecord(const SealedIndexingRecord& other) {
+        std::shared_lock lck(other.mutex_);
+        field_indexings_ = other.field_indexings_;
+    }
+
     void
-    append_field_indexing(FieldId field_id,
-                          const MetricType& metric_type,
-                          index::IndexBasePtr indexing) {
-        auto ptr = std::make_unique<SealedIndexingEntry>();
+    append_field_indexing(
+        FieldId field_id,
+        const MetricType& metric_type,
+        index::IndexBasePtr indexing,
+        std::map<std::string, std::string> index_params = {}) {
+        auto ptr = std::make_shared<SealedIndexingEntry>();
         ptr->indexing_ = std::move(indexing);
         ptr->metric_type_ = metric_type;
+        ptr->index_params_ = std::move(index_params);
         std::unique_lock lck(mutex_);
         field_indexings_[field_id] = std::move(ptr);
     }
@@ -0,0 +1,177 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "segcore/SearchCoalescer.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include "common/Cancellation.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+size_t
+SearchCoalescer::KeyHash::operator()(const Key& key) const {
+    auto hash = std::hash<std::string>{}(key.plan);
+    hash ^= std::hash<const void*>{}(key.segment) + 0x9e3779b97f4a7c15ULL +
+            (hash << 6) + (hash >> 2);
+    hash ^= std::hash<Timestamp>{}(key.timestamp) + 0x9e3779b97f4a7c15ULL +
+            (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+void
+SearchCoalescer::SetWindow(int64_t window_us, int64_t max_nq) {
+    AssertInfo(window_us >= 0 && max_nq > 0,
+               "invalid search coalescing window or max nq");
+    max_nq_.store(max_nq);
+    window_us_.store(window_us);
+}
+
+std::unique_ptr<SearchResult>
+SearchCoalescer::Search(const void* segment,
+                        const query::Plan* plan,
+                        const query::PlaceholderGroup* placeholder_group,
+                        Timestamp timestamp,
+                        const SearchFn& search) {
+    auto window_us = window_us_.load(std::memory_order_relaxed);
+    auto max_nq = max_nq_.load(std::memory_order_relaxed);
+    // a profile is of one search, and a plan which can't be identified
+    // can't be matched with others
+    if (window_us <= 0 || plan->serialized_plan_.empty() ||
+        plan->plan_node_->search_info_.profile_ ||
+        placeholder_group->size() != 1 ||
+        placeholder_group->at(0).num_of_queries_ >= max_nq) {
+        return search(placeholder_group);
+    }
+    auto nq = placeholder_group->at(0).num_of_queries_;
+
+    Key key{segment, timestamp, plan->serialized_plan_};
+    std::shared_ptr<Batch> batch;
+    {
+        std::unique_lock lck(mutex_);
+        auto it = open_.find(key);
+        if (it != open_.end() && it->second->nq + nq <= max_nq) {
+            batch = it->second;
+            auto index = batch->requests.size();
+            batch->requests.push_back(placeholder_group);
+            batch->nq += nq;
+            merged_.fetch_add(1, std::memory_order_relaxed);
+            batch->finished.wait(lck, [&] { return batch->done; });
+            if (batch->error) {
+                std::rethrow_exception(batch->error);
+            }
+            return std::move(batch->results[index]);
+        }
+        // a full batch is replaced, it runs as it is
+        batch = std::make_shared<Batch>();
+        batch->requests.push_back(placeholder_group);
+        batch->nq = nq;
+        open_[key] = batch;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(window_us));
+    {
+        std::lock_guard lck(mutex_);
+        auto it = open_.find(key);
+        if (it != open_.end() && it->second == batch) {
+            open_.erase(it);
+        }
+    }
+    // no search joins the batch from here on
+    if (batch->requests.size() == 1) {
+        return search(placeholder_group);
+    }
+
+    std::vector<std::unique_ptr<SearchResult>> results;
+    std::exception_ptr error;
+    try {
+        results = SearchBatch(*batch, search);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    std::unique_ptr<SearchResult> result;
+    {
+        std::lock_guard lck(mutex_);
+        batch->results = std::move(results);
+        batch->error = error;
+        batch->done = true;
+        if (!error) {
+            result = std::move(batch->results[0]);
+        }
+    }
+    batch->finished.notify_all();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+std::vector<std::unique_ptr<SearchResult>>
+SearchCoalescer::SearchBatch(const Batch& batch, const SearchFn& search) {
+    query::PlaceholderGroup merged(1);
+    auto& placeholder = merged[0];
+    auto& first = batch.requests[0]->at(0);
+    placeholder.tag_ = first.tag_;
+    placeholder.line_sizeof_ = first.line_sizeof_;
+    placeholder.num_of_queries_ = 0;
+    for (auto request : batch.requests) {
+        auto& queries = request->at(0);
+        AssertInfo(queries.tag_ == first.tag_ &&
+                       queries.line_sizeof_ == first.line_sizeof_,
+                   "merged searches have different placeholders");
+        placeholder.blob_.insert(placeholder.blob_.end(),
+                                 queries.blob_.begin(),
+                                 queries.blob_.end());
+        placeholder.num_of_queries_ += queries.num_of_queries_;
+    }
+
+    std::unique_ptr<SearchResult> result;
+    {
+        // the batch runs for all its searches, the one running it being
+        // cancelled doesn't stop it
+        CancellationScope cancellation_scope(nullptr);
+        result = search(&merged);
+    }
+
+    // the hits of every query are a slice of topk of the merged ones
+    auto topk = result->unity_topK_;
+    std::vector<std::unique_ptr<SearchResult>> results;
+    results.reserve(batch.requests.size());
+    int64_t begin = 0;
+    for (auto request : batch.requests) {
+        auto nq = request->at(0).num_of_queries_;
+        auto from = begin * topk;
+        auto to = (begin + nq) * topk;
+        auto part = std::make_unique<SearchResult>();
+        part->total_nq_ = nq;
+        part->unity_topK_ = topk;
+        part->segment_ = result->segment_;
+        part->seg_offsets_.assign(result->seg_offsets_.begin() + from,
+                                  result->seg_offsets_.begin() + to);
+        part->distances_.assign(result->distances_.begin() + from,
+                                result->distances_.begin() + to);
+        if (!result->group_by_values_.empty()) {
+            part->group_by_values_.assign(
+                result->group_by_values_.begin() + from,
+                result->group_by_values_.begin() + to);
+        }
+        part->effective_search_params_ = result->effective_search_params_;
+        results.push_back(std::move(part));
+        begin += nq;
+    }
+    return results;
+}
+
+}  // namespace milvus::segcore
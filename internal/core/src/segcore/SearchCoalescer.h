@@ -0,0 +1,118 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/QueryResult.h"
+#include "common/Types.h"
+#include "query/PlanImpl.h"
+
+namespace milvus::segcore {
+
+// Node wide micro batching of concurrent searches of one segment with the
+// same plan at the same timestamp. The first such search waits a short
+// window for others to come, then runs all their queries as one search,
+// so the filter is evaluated once and the index searched with a batch,
+// and splits the result back per search. The searches merged into it wait
+// for it to finish and get its error if it fails.
+class SearchCoalescer {
+ public:
+    // searches the rows of `segment` visible at the timestamp with the
+    // plan, for the queries of the placeholder group it's given
+    using SearchFn = std::function<std::unique_ptr<SearchResult>(
+        const query::PlaceholderGroup* placeholder_group)>;
+
+    static SearchCoalescer&
+    GetInstance() {
+        static SearchCoalescer instance;
+        return instance;
+    }
+
+    // a search waits up to `window_us` microseconds for others to merge
+    // with, up to `max_nq` queries in all, a zero window disables it
+    void
+    SetWindow(int64_t window_us, int64_t max_nq);
+
+    bool
+    Enabled() const {
+        return window_us_.load(std::memory_order_relaxed) > 0;
+    }
+
+    // the result of `search` for `placeholder_group`, run alone or merged
+    // with the concurrent searches of the same key
+    std::unique_ptr<SearchResult>
+    Search(const void* segment,
+           const query::Plan* plan,
+           const query::PlaceholderGroup* placeholder_group,
+           Timestamp timestamp,
+           const SearchFn& search);
+
+    // the searches which ran as part of another one
+    int64_t
+    Merged() const {
+        return merged_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    SearchCoalescer() = default;
+
+    struct Key {
+        const void* segment;
+        Timestamp timestamp;
+        // the serialized plan
+        std::string plan;
+
+        bool
+        operator==(const Key& other) const {
+            return segment == other.segment &&
+                   timestamp == other.timestamp && plan == other.plan;
+        }
+    };
+
+    struct KeyHash {
+        size_t
+        operator()(const Key& key) const;
+    };
+
+    struct Batch {
+        // the first one is of the search running them all
+        std::vector<const query::PlaceholderGroup*> requests;
+        int64_t nq = 0;
+        bool done = false;
+        std::vector<std::unique_ptr<SearchResult>> results;
+        std::exception_ptr error;
+        std::condition_variable finished;
+    };
+
+    static std::vector<std::unique_ptr<SearchResult>>
+    SearchBatch(const Batch& batch, const SearchFn& search);
+
+    std::atomic<int64_t> window_us_ = 0;
+    std::atomic<int64_t> max_nq_ = 64;
+    std::atomic<int64_t> merged_ = 0;
+    std::mutex mutex_;
+    // the batches still taking searches
+    std::unordered_map<Key, std::shared_ptr<Batch>, KeyHash> open_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,107 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "segcore/SearchIterator.h"
+
+#include <algorithm>
+
+#include "common/Utils.h"
+#include "exceptions/EasyAssert.h"
+#include "query/Plan.h"
+
+namespace milvus::segcore {
+
+SearchIterator::SearchIterator(const SegmentInterface& segment,
+                               const query::Plan& plan,
+                               const query::PlaceholderGroup& placeholder_group,
+                               Timestamp timestamp)
+    : segment_(segment),
+      schema_(plan.schema_),
+      serialized_plan_(plan.serialized_plan_),
+      placeholder_group_(placeholder_group),
+      timestamp_(timestamp),
+      positively_related_(
+          PositivelyRelated(plan.plan_node_->search_info_.metric_type_)) {
+    AssertInfo(!serialized_plan_.empty(),
+               "search iterator needs a plan created from a serialized plan");
+    AssertInfo(query::GetNumOfQueries(&placeholder_group_) == 1,
+               "search iterator supports one query only");
+    AssertInfo(!plan.plan_node_->search_info_.group_by_field_id_.has_value(),
+               "search iterator doesn't support group by");
+}
+
+void
+SearchIterator::Fetch(int64_t topk) {
+    proto::plan::PlanNode plan_node;
+    AssertInfo(plan_node.ParseFromString(serialized_plan_),
+               "failed to parse the plan of the search iterator");
+    plan_node.mutable_vector_anns()->mutable_query_info()->set_topk(topk);
+    auto serialized = plan_node.SerializeAsString();
+    auto plan = query::CreateSearchPlanByExpr(
+        schema_, serialized.data(), serialized.size());
+    auto result = segment_.Search(plan.get(), &placeholder_group_, timestamp_);
+
+    pending_.clear();
+    int64_t valid = 0;
+    for (size_t i = 0; i < result->seg_offsets_.size(); ++i) {
+        auto offset = result->seg_offsets_[i];
+        if (offset == INVALID_SEG_OFFSET) {
+            break;
+        }
+        ++valid;
+        auto distance = result->distances_[i];
+        if (returned_.count(offset) > 0 ||
+            (!returned_.empty() && better(distance, last_distance_))) {
+            continue;
+        }
+        pending_.emplace_back(distance, offset);
+    }
+    fetched_topk_ = topk;
+    exhausted_ = valid < topk;
+}
+
+std::unique_ptr<SearchResult>
+SearchIterator::Next(int64_t page_size) {
+    AssertInfo(page_size > 0, "page size must be positive");
+    while (int64_t(pending_.size()) < page_size && !exhausted_) {
+        auto topk = std::max(fetched_topk_ * 2,
+                             int64_t(returned_.size()) + page_size);
+        auto row_count = segment_.get_row_count();
+        if (topk >= row_count) {
+            if (row_count > 0) {
+                Fetch(row_count);
+            }
+            exhausted_ = true;
+        } else {
+            Fetch(topk);
+        }
+    }
+
+    auto size = std::min(int64_t(pending_.size()), page_size);
+    auto result = std::make_unique<SearchResult>();
+    result->total_nq_ = 1;
+    result->unity_topK_ = size;
+    result->segment_ = (void*)&segment_;
+    result->distances_.reserve(size);
+    result->seg_offsets_.reserve(size);
+    for (int64_t i = 0; i < size; ++i) {
+        auto [distance, offset] = pending_.front();
+        pending_.pop_front();
+        result->distances_.push_back(distance);
+        result->seg_offsets_.push_back(offset);
+        returned_.insert(offset);
+        last_distance_ = distance;
+    }
+    return result;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,79 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include "common/QueryResult.h"
+#include "query/PlanImpl.h"
+#include "segcore/SegmentInterface.h"
+
+namespace milvus::segcore {
+
+// Pages through the results of one query on a segment, best first.
+// The segment is searched with a topk that doubles whenever the fetched
+// results run out, so fetching pages up to offset + limit costs about as
+// much as one search for offset + limit, instead of one per page. Results
+// are returned once, and never better than the last returned one, so a
+// page after a deeper refetch continues where the previous one ended.
+// The segment must outlive the iterator.
+class SearchIterator {
+ public:
+    SearchIterator(const SegmentInterface& segment,
+                   const query::Plan& plan,
+                   const query::PlaceholderGroup& placeholder_group,
+                   Timestamp timestamp);
+
+    // the next `page_size` results, fewer once the segment has no more
+    std::unique_ptr<SearchResult>
+    Next(int64_t page_size);
+
+    // whether larger distances are better
+    bool
+    PositivelyRelated() const {
+        return positively_related_;
+    }
+
+ private:
+    // searches with `topk` and keeps what is left to return
+    void
+    Fetch(int64_t topk);
+
+    bool
+    better(float lhs, float rhs) const {
+        return positively_related_ ? lhs > rhs : lhs < rhs;
+    }
+
+ private:
+    const SegmentInterface& segment_;
+    const Schema& schema_;
+    std::string serialized_plan_;
+    query::PlaceholderGroup placeholder_group_;
+    Timestamp timestamp_;
+    bool positively_related_;
+
+    // distance and offset of the results fetched but not returned, best
+    // first
+    std::deque<std::pair<float, int64_t>> pending_;
+    std::unordered_set<int64_t> returned_;
+    float last_distance_ = 0;
+    int64_t fetched_topk_ = 0;
+    bool exhausted_ = false;
+};
+
+}  // namespace milvus::segcore
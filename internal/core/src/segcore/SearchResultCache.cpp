@@ -0,0 +1,165 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include "segcore/SearchResultCache.h"
+
+#include <functional>
+#include <utility>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+namespace {
+void
+AppendSized(std::string& key, const void* data, size_t size) {
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(static_cast<const char*>(data), size);
+}
+
+// bytes held by a cached result, the containers count at their size
+int64_t
+EntrySize(const SearchResultCache::Key& key, const SearchResult& result) {
+    return sizeof(SearchResultCache::Key) + sizeof(SearchResult) +
+           key.request.size() + result.distances_.size() * sizeof(float) +
+           result.seg_offsets_.size() * sizeof(int64_t) +
+           result.group_by_values_.size() * sizeof(GroupByValueType) +
+           result.effective_search_params_.size();
+}
+}  // namespace
+
+size_t
+SearchResultCache::KeyHash::operator()(const Key& key) const {
+    auto hash = std::hash<std::string>{}(key.request);
+    for (auto value : {key.segment_uid,
+                       key.generation,
+                       key.del_barrier,
+                       key.buffer_epoch,
+                       key.buffer_barrier}) {
+        hash ^= std::hash<int64_t>{}(value) + 0x9e3779b97f4a7c15ULL +
+                (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+void
+SearchResultCache::SetCapacity(int64_t capacity_bytes) {
+    std::lock_guard lck(mutex_);
+    capacity_bytes_.store(capacity_bytes);
+    EvictLocked();
+}
+
+int64_t
+SearchResultCache::NewSegmentUid() {
+    static std::atomic<int64_t> next_uid = 0;
+    return next_uid.fetch_add(1);
+}
+
+std::string
+SearchResultCache::RequestKey(
+    const query::Plan* plan,
+    const query::PlaceholderGroup* placeholder_group) {
+    if (plan->serialized_plan_.empty()) {
+        return {};
+    }
+    std::string key;
+    AssertInfo(placeholder_group, "empty placeholder group");
+    auto& serialized_plan = plan->serialized_plan_;
+    AppendSized(key, serialized_plan.data(), serialized_plan.size());
+    for (auto& placeholder : *placeholder_group) {
+        AppendSized(key, placeholder.tag_.data(), placeholder.tag_.size());
+        AppendSized(key, placeholder.blob_.data(), placeholder.blob_.size());
+    }
+    return key;
+}
+
+std::unique_ptr<SearchResult>
+SearchResultCache::Get(const Key& key) {
+    std::shared_ptr<const SearchResult> cached;
+    {
+        std::lock_guard lck(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return nullptr;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+        cached = it->second.result;
+    }
+    auto result = std::make_unique<SearchResult>();
+    result->total_nq_ = cached->total_nq_;
+    result->unity_topK_ = cached->unity_topK_;
+    result->distances_ = cached->distances_;
+    result->seg_offsets_ = cached->seg_offsets_;
+    result->group_by_values_ = cached->group_by_values_;
+    result->effective_search_params_ = cached->effective_search_params_;
+    return result;
+}
+
+void
+SearchResultCache::Put(Key key, const SearchResult& result) {
+    auto cached = std::make_shared<SearchResult>();
+    cached->total_nq_ = result.total_nq_;
+    cached->unity_topK_ = result.unity_topK_;
+    cached->segment_ = nullptr;
+    cached->distances_ = result.distances_;
+    cached->seg_offsets_ = result.seg_offsets_;
+    cached->group_by_values_ = result.group_by_values_;
+    cached->effective_search_params_ = result.effective_search_params_;
+    auto size = EntrySize(key, *cached);
+    if (size > capacity_bytes_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::lock_guard lck(mutex_);
+    auto [it, inserted] = entries_.try_emplace(std::move(key));
+    if (!inserted) {
+        // cached by a concurrent search of the same request
+        return;
+    }
+    lru_.push_front(&it->first);
+    it->second = Entry{std::move(cached), size, lru_.begin()};
+    cached_bytes_ += size;
+    EvictLocked();
+}
+
+void
+SearchResultCache::Erase(int64_t segment_uid) {
+    std::lock_guard lck(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->first.segment_uid != segment_uid) {
+            ++it;
+            continue;
+        }
+        cached_bytes_ -= it->second.size;
+        lru_.erase(it->second.lru_pos);
+        it = entries_.erase(it);
+    }
+}
+
+int64_t
+SearchResultCache::CachedBytes() const {
+    std::lock_guard lck(mutex_);
+    return cached_bytes_;
+}
+
+void
+SearchResultCache::EvictLocked() {
+    auto capacity = capacity_bytes_.load(std::memory_order_relaxed);
+    while (!lru_.empty() && cached_bytes_ > capacity) {
+        auto it = entries_.find(*lru_.back());
+        cached_bytes_ -= it->second.size;
+        lru_.pop_back();
+        entries_.erase(it);
+    }
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,122 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/QueryResult.h"
+#include "query/PlanImpl.h"
+
+namespace milvus::segcore {
+
+// Node wide LRU cache of the search results of sealed segments.
+// A sealed segment only changes by deletes and loads, so a result stays
+// valid while the segment keeps its generation, bumped by every load and
+// drop, and the query sees the same deletes. The least recently used
+// results are dropped once the memory budget is exceeded.
+class SearchResultCache {
+ public:
+    struct Key {
+        // SearchResultCache::NewSegmentUid of the segment
+        int64_t segment_uid;
+        int64_t generation;
+        // deletes visible to the query, of the segment and of the
+        // collection delete buffer, see DeleteBuffer::barrier
+        int64_t del_barrier;
+        int64_t buffer_epoch;
+        int64_t buffer_barrier;
+        // serialized plan and placeholder group, see RequestKey
+        std::string request;
+
+        bool
+        operator==(const Key& other) const {
+            return segment_uid == other.segment_uid &&
+                   generation == other.generation &&
+                   del_barrier == other.del_barrier &&
+                   buffer_epoch == other.buffer_epoch &&
+                   buffer_barrier == other.buffer_barrier &&
+                   request == other.request;
+        }
+    };
+
+    static SearchResultCache&
+    GetInstance() {
+        static SearchResultCache instance;
+        return instance;
+    }
+
+    // a zero capacity disables the cache and drops the cached results
+    void
+    SetCapacity(int64_t capacity_bytes);
+
+    bool
+    Enabled() const {
+        return capacity_bytes_.load(std::memory_order_relaxed) > 0;
+    }
+
+    // a process unique id, segment ids may be reused by reloads
+    static int64_t
+    NewSegmentUid();
+
+    // the request part of the key, empty if the plan can't be identified
+    static std::string
+    RequestKey(const query::Plan* plan,
+               const query::PlaceholderGroup* placeholder_group);
+
+    // a copy of the cached result, nullptr if it isn't cached
+    std::unique_ptr<SearchResult>
+    Get(const Key& key);
+
+    // caches the search output of `result`, before any reduce step
+    void
+    Put(Key key, const SearchResult& result);
+
+    // drops the results of the segment
+    void
+    Erase(int64_t segment_uid);
+
+    int64_t
+    CachedBytes() const;
+
+ private:
+    SearchResultCache() = default;
+
+    struct KeyHash {
+        size_t
+        operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        std::shared_ptr<const SearchResult> result;
+        int64_t size;
+        std::list<const Key*>::iterator lru_pos;
+    };
+
+    void
+    EvictLocked();
+
+    std::atomic<int64_t> capacity_bytes_ = 0;
+    mutable std::mutex mutex_;
+    int64_t cached_bytes_ = 0;
+    // keys of entries_, the most recently used first
+    std::list<const Key*> lru_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+};
+
+}  // namespace milvus::segcore
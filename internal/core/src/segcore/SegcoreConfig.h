@@ -14,6 +14,7 @@
 #include <map>
 #include <string>
 
+#include "common/Consts.h"
 #include "common/Types.h"
 #include "index/Utils.h"
 #include "exceptions/EasyAssert.h"
@@ -73,8 +74,384 @@ class SegcoreConfig {
         return enable_growing_segment_index_;
     }
 
+    void
+    set_enable_chunk_arena(bool enable_chunk_arena) {
+        enable_chunk_arena_ = enable_chunk_arena;
+    }
+
+    bool
+    get_enable_chunk_arena() const {
+        return enable_chunk_arena_;
+    }
+
+    void
+    set_chunk_arena_hugepage(bool chunk_arena_hugepage) {
+        chunk_arena_hugepage_ = chunk_arena_hugepage;
+    }
+
+    bool
+    get_chunk_arena_hugepage() const {
+        return chunk_arena_hugepage_;
+    }
+
+    void
+    set_enable_pk_filter(bool enable_pk_filter) {
+        enable_pk_filter_ = enable_pk_filter;
+    }
+
+    bool
+    get_enable_pk_filter() const {
+        return enable_pk_filter_;
+    }
+
+    void
+    set_enable_expr_pipeline(bool enable_expr_pipeline) {
+        enable_expr_pipeline_ = enable_expr_pipeline;
+    }
+
+    bool
+    get_enable_expr_pipeline() const {
+        return enable_expr_pipeline_;
+    }
+
+    void
+    set_brute_force_threshold(int64_t brute_force_threshold) {
+        brute_force_threshold_ = brute_force_threshold;
+    }
+
+    int64_t
+    get_brute_force_threshold() const {
+        return brute_force_threshold_;
+    }
+
+    void
+    set_brute_force_density(double brute_force_density) {
+        brute_force_density_ = brute_force_density;
+    }
+
+    double
+    get_brute_force_density() const {
+        return brute_force_density_;
+    }
+
+    void
+    set_post_filter_density(double post_filter_density) {
+        post_filter_density_ = post_filter_density;
+    }
+
+    double
+    get_post_filter_density() const {
+        return post_filter_density_;
+    }
+
+    void
+    set_dictionary_max_values(int64_t dictionary_max_values) {
+        dictionary_max_values_ = dictionary_max_values;
+    }
+
+    int64_t
+    get_dictionary_max_values() const {
+        return dictionary_max_values_;
+    }
+
+    void
+    set_enable_json_binary(bool enable_json_binary) {
+        enable_json_binary_ = enable_json_binary;
+    }
+
+    bool
+    get_enable_json_binary() const {
+        return enable_json_binary_;
+    }
+
+    void
+    set_enable_growing_fp16_vector(bool enable_growing_fp16_vector) {
+        enable_growing_fp16_vector_ = enable_growing_fp16_vector;
+    }
+
+    bool
+    get_enable_growing_fp16_vector() const {
+        return enable_growing_fp16_vector_;
+    }
+
+    void
+    set_growing_mmap_dir_path(const std::string& growing_mmap_dir_path) {
+        growing_mmap_dir_path_ = growing_mmap_dir_path;
+    }
+
+    const std::string&
+    get_growing_mmap_dir_path() const {
+        return growing_mmap_dir_path_;
+    }
+
+    void
+    set_interim_index_type(const std::string& interim_index_type) {
+        interim_index_type_ = interim_index_type;
+    }
+
+    const std::string&
+    get_interim_index_type() const {
+        return interim_index_type_;
+    }
+
+    void
+    set_expr_result_cache_size(int64_t expr_result_cache_size) {
+        expr_result_cache_size_ = expr_result_cache_size;
+    }
+
+    int64_t
+    get_expr_result_cache_size() const {
+        return expr_result_cache_size_;
+    }
+
+    void
+    set_expr_result_cache_min_eval_us(int64_t expr_result_cache_min_eval_us) {
+        expr_result_cache_min_eval_us_ = expr_result_cache_min_eval_us;
+    }
+
+    int64_t
+    get_expr_result_cache_min_eval_us() const {
+        return expr_result_cache_min_eval_us_;
+    }
+
+    void
+    set_index_warmup_queries(int64_t index_warmup_queries) {
+        index_warmup_queries_ = index_warmup_queries;
+    }
+
+    int64_t
+    get_index_warmup_queries() const {
+        return index_warmup_queries_;
+    }
+
+    void
+    set_numa_aware(bool numa_aware) {
+        numa_aware_ = numa_aware;
+    }
+
+    bool
+    get_numa_aware() const {
+        return numa_aware_;
+    }
+
+    void
+    set_segment_arena(bool segment_arena) {
+        segment_arena_ = segment_arena;
+    }
+
+    bool
+    get_segment_arena() const {
+        return segment_arena_;
+    }
+
+    void
+    set_growing_chunk_freeze_ms(int64_t growing_chunk_freeze_ms) {
+        growing_chunk_freeze_ms_ = growing_chunk_freeze_ms;
+    }
+
+    int64_t
+    get_growing_chunk_freeze_ms() const {
+        return growing_chunk_freeze_ms_;
+    }
+
+    void
+    set_growing_chunk_index_min_filters(int64_t min_filters) {
+        growing_chunk_index_min_filters_ = min_filters;
+    }
+
+    int64_t
+    get_growing_chunk_index_min_filters() const {
+        return growing_chunk_index_min_filters_;
+    }
+
+    void
+    set_growing_index_async_build(bool growing_index_async_build) {
+        growing_index_async_build_ = growing_index_async_build;
+    }
+
+    bool
+    get_growing_index_async_build() const {
+        return growing_index_async_build_;
+    }
+
+    void
+    set_vector_chunk_bytes(int64_t vector_chunk_bytes) {
+        vector_chunk_bytes_ = vector_chunk_bytes;
+    }
+
+    int64_t
+    get_vector_chunk_bytes() const {
+        return vector_chunk_bytes_;
+    }
+
+    void
+    set_index_load_inflight(int64_t index_load_inflight) {
+        index_load_inflight_ = index_load_inflight;
+    }
+
+    int64_t
+    get_index_load_inflight() const {
+        return index_load_inflight_;
+    }
+
+    void
+    set_growing_search_parallelism(int64_t growing_search_parallelism) {
+        growing_search_parallelism_ = growing_search_parallelism;
+    }
+
+    int64_t
+    get_growing_search_parallelism() const {
+        return growing_search_parallelism_;
+    }
+
+    void
+    set_expr_parallelism(int64_t expr_parallelism) {
+        expr_parallelism_ = expr_parallelism;
+    }
+
+    int64_t
+    get_expr_parallelism() const {
+        return expr_parallelism_;
+    }
+
+    void
+    set_expr_morsel_rows(int64_t expr_morsel_rows) {
+        expr_morsel_rows_ = expr_morsel_rows;
+    }
+
+    int64_t
+    get_expr_morsel_rows() const {
+        return expr_morsel_rows_;
+    }
+
+    void
+    set_gpu_search_min_nq(int64_t gpu_search_min_nq) {
+        gpu_search_min_nq_ = gpu_search_min_nq;
+    }
+
+    int64_t
+    get_gpu_search_min_nq() const {
+        return gpu_search_min_nq_;
+    }
+
+    void
+    set_brute_force_sketch_factor(int64_t brute_force_sketch_factor) {
+        brute_force_sketch_factor_ = brute_force_sketch_factor;
+    }
+
+    int64_t
+    get_brute_force_sketch_factor() const {
+        return brute_force_sketch_factor_;
+    }
+
+    void
+    set_enable_field_sketch(bool enable_field_sketch) {
+        enable_field_sketch_ = enable_field_sketch;
+    }
+
+    bool
+    get_enable_field_sketch() const {
+        return enable_field_sketch_;
+    }
+
+    void
+    set_mmap_gather_willneed_min_rows(int64_t min_rows) {
+        mmap_gather_willneed_min_rows_ = min_rows;
+    }
+
+    int64_t
+    get_mmap_gather_willneed_min_rows() const {
+        return mmap_gather_willneed_min_rows_;
+    }
+
  private:
     bool enable_growing_segment_index_ = false;
+    // allocate the chunks of a growing segment from a per-segment arena
+    bool enable_chunk_arena_ = true;
+    bool chunk_arena_hugepage_ = false;
+    // check a Bloom filter of the pks before looking them up
+    bool enable_pk_filter_ = true;
+    // evaluate the children of logical exprs cheapest first, each only on
+    // the rows the previous ones left undecided
+    bool enable_expr_pipeline_ = true;
+    // a search whose filter leaves at most this many rows computes their
+    // distances directly instead of a filtered search over the index
+    int64_t brute_force_threshold_ = 1024;
+    // or at most this ratio of the rows of an indexed segment, the
+    // filtered search of graph indexes degrades below it
+    double brute_force_density_ = 0.01;
+    // an index search whose filter leaves at least this ratio of the rows
+    // fetches more hits without the filter and drops the filtered out ones,
+    // above 1 to disable
+    double post_filter_density_ = 0.95;
+    // sealed string columns with at most this many distinct values keep a
+    // dictionary and codes instead of the raw strings, 0 to disable
+    int64_t dictionary_max_values_ = 4096;
+    // sealed json columns keep a BinaryJson encoding of their rows next to
+    // the text, the queries look their values up without parsing them
+    bool enable_json_binary_ = false;
+    // growing segments keep float vectors as half floats, searched by brute
+    // force without an interim index
+    bool enable_growing_fp16_vector_ = false;
+    // the vector chunks of a growing segment are mapped from files in
+    // {growing_mmap_dir_path_}/{segment_id}, in anonymous memory if empty
+    std::string growing_mmap_dir_path_;
+    // index type of the growing segment interim index, IVF_FLAT_CC if empty
+    std::string interim_index_type_;
+    // bytes of predicate results each sealed segment keeps for repeated
+    // filters, 0 to disable, only predicates which took at least
+    // expr_result_cache_min_eval_us_ to evaluate are kept
+    int64_t expr_result_cache_size_ = 0;
+    int64_t expr_result_cache_min_eval_us_ = 100;
+    // queries a loaded vector index is searched with before the segment
+    // reports it ready, 0 to disable
+    int64_t index_warmup_queries_ = 0;
+    // place the data of every sealed segment on one NUMA node, chosen by
+    // its segment id unless the C API picks one
+    bool numa_aware_ = false;
+    // every sealed segment is loaded into a jemalloc arena of its own,
+    // purged when it's released
+    bool segment_arena_ = false;
+    // a chunk of a growing segment which has been full for this long gets
+    // an index on every scalar field, filters use it instead of the raw
+    // data, negative to disable
+    int64_t growing_chunk_freeze_ms_ = -1;
+    // only the fields read by this many filters of a growing segment get
+    // the indexes of its frozen chunks, 0 for all the scalar fields
+    int64_t growing_chunk_index_min_filters_ = 0;
+    // the chunks of the vector fields of a growing segment hold the power
+    // of two rows fitting these bytes, at most chunk_rows_, 0 to disable
+    int64_t vector_chunk_bytes_ = 0;
+    // the interim indexes of growing segments take the inserted rows in the
+    // background instead of on the insert path
+    bool growing_index_async_build_ = true;
+    // index files an index load downloads and decodes at the same time
+    int64_t index_load_inflight_ = DEFAULT_INDEX_LOAD_FILE_INFLIGHT;
+    // threads, the calling one included, a filter of a query may use to
+    // evaluate a chunk of a segment, split into morsels of
+    // expr_morsel_rows_ rows; 1 to evaluate on the calling thread only
+    int64_t expr_parallelism_ = 1;
+    int64_t expr_morsel_rows_ = 64 * 1024;
+    // threads, the calling one included, a search may use to brute force
+    // the chunks of a growing segment, only taken by searches with enough
+    // distances to compute; 1 to search on the calling thread only
+    int64_t growing_search_parallelism_ = 4;
+    // a search of fewer queries than this over a gpu index of a sealed
+    // segment brute forces its raw vectors on the cpu if they are loaded,
+    // the launch and the transfers outweigh the search then; 0 to disable
+    int64_t gpu_search_min_nq_ = 0;
+    // the float vector fields of the segments created or loaded meanwhile
+    // keep a sign bit per dimension of their rows, a brute force search
+    // ranks the rows by those first and computes the distances of this
+    // many times topk rows per query only; 0 to disable
+    int64_t brute_force_sketch_factor_ = 0;
+    // the scalar fields loaded into sealed segments meanwhile keep a
+    // hyperloglog of their values, and a kll sketch if they are numeric
+    bool enable_field_sketch_ = true;
+    // a gather of at least this many rows of a column mapped from a file
+    // sorts them by offset and madvise(MADV_WILLNEED)s their pages first,
+    // so the reads of a cold column overlap; 0 to disable
+    int64_t mmap_gather_willneed_min_rows_ = 16;
     int64_t chunk_rows_ = 32 * 1024;
     int64_t nlist_ = 100;
     int64_t nprobe_ = 4;
@@ -0,0 +1,115 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/SegmentArena.h"
+
+#include <fmt/core.h>
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "log/Log.h"
+#include "segcore/Profiler.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// the arenas of the released segments, jemalloc never frees an arena
+// index, so they are handed to the next segments
+std::mutex free_mutex;
+std::vector<unsigned> free_arenas;
+
+}  // namespace
+
+std::shared_ptr<SegmentArena>
+SegmentArena::Create() {
+    auto mallctl = JemallocMallctl();
+    if (mallctl == nullptr) {
+        return nullptr;
+    }
+    {
+        std::lock_guard lck(free_mutex);
+        if (!free_arenas.empty()) {
+            auto index = free_arenas.back();
+            free_arenas.pop_back();
+            return std::make_shared<SegmentArena>(index);
+        }
+    }
+    unsigned index = 0;
+    size_t size = sizeof(index);
+    auto ret = mallctl("arenas.create", &index, &size, nullptr, 0);
+    if (ret != 0) {
+        LOG_SEGCORE_WARNING_ << "failed to create a jemalloc arena: "
+                             << strerror(ret);
+        return nullptr;
+    }
+    return std::make_shared<SegmentArena>(index);
+}
+
+SegmentArena::~SegmentArena() {
+    auto mallctl = JemallocMallctl();
+    auto purge = fmt::format("arena.{}.purge", index_);
+    auto ret = mallctl(purge.c_str(), nullptr, nullptr, nullptr, 0);
+    if (ret != 0) {
+        LOG_SEGCORE_WARNING_ << "failed to purge jemalloc arena " << index_
+                             << ": " << strerror(ret);
+    }
+    std::lock_guard lck(free_mutex);
+    free_arenas.push_back(index_);
+}
+
+int64_t
+SegmentArena::allocated_bytes() const {
+    auto mallctl = JemallocMallctl();
+    uint64_t epoch = 1;
+    size_t size = sizeof(epoch);
+    mallctl("epoch", &epoch, &size, &epoch, size);
+    int64_t bytes = 0;
+    for (auto kind : {"small", "large"}) {
+        auto name = fmt::format("stats.arenas.{}.{}.allocated", index_, kind);
+        size_t allocated = 0;
+        size = sizeof(allocated);
+        if (mallctl(name.c_str(), &allocated, &size, nullptr, 0) == 0) {
+            bytes += allocated;
+        }
+    }
+    return bytes;
+}
+
+SegmentArena::Scope::Scope(const SegmentArena* arena) {
+    if (arena == nullptr) {
+        return;
+    }
+    auto mallctl = JemallocMallctl();
+    auto index = arena->index_;
+    size_t size = sizeof(previous_);
+    if (mallctl("thread.arena", &previous_, &size, &index, sizeof(index)) !=
+        0) {
+        return;
+    }
+    applied_ = true;
+    // the cached small allocations of the arena before are not handed out
+    mallctl("thread.tcache.flush", nullptr, nullptr, nullptr, 0);
+}
+
+SegmentArena::Scope::~Scope() {
+    if (!applied_) {
+        return;
+    }
+    auto mallctl = JemallocMallctl();
+    mallctl("thread.tcache.flush", nullptr, nullptr, nullptr, 0);
+    mallctl("thread.arena", nullptr, nullptr, &previous_, sizeof(previous_));
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,65 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace milvus::segcore {
+
+// A jemalloc arena of the memory of one segment. The threads loading the
+// segment allocate from it within a Scope, so its columns, pk map, delete
+// record and indexes don't share pages with other segments, and the pages
+// they leave are purged as soon as the segment is released instead of
+// decaying for as long as jemalloc keeps dirty pages. The arena is reused
+// by a later segment, the allocations outliving the segment stay valid.
+class SegmentArena {
+ public:
+    // nullptr if the process has no jemalloc or it has no arena left
+    static std::shared_ptr<SegmentArena>
+    Create();
+
+    explicit SegmentArena(unsigned index) : index_(index) {
+    }
+
+    ~SegmentArena();
+
+    SegmentArena(const SegmentArena&) = delete;
+    SegmentArena&
+    operator=(const SegmentArena&) = delete;
+
+    // the bytes allocated from the arena and not freed yet
+    int64_t
+    allocated_bytes() const;
+
+    // the calling thread allocates from `arena` while it lives, nothing
+    // changes for a null arena
+    class Scope {
+     public:
+        explicit Scope(const SegmentArena* arena);
+
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope&
+        operator=(const Scope&) = delete;
+
+     private:
+        bool applied_ = false;
+        unsigned previous_ = 0;
+    };
+
+ private:
+    const unsigned index_;
+};
+
+}  // namespace milvus::segcore
@@ -19,6 +19,7 @@
 #include "common/Types.h"
 #include "query/Plan.h"
 #include "query/deprecated/GeneralQuery.h"
+#include "segcore/ConcurrentVector.h"
 #include "segcore/SegmentInterface.h"
 
 namespace milvus::segcore {
@@ -35,6 +36,25 @@ class SegmentGrowing : public SegmentInternalInterface {
            const Timestamp* timestamps,
            const InsertData* insert_data) = 0;
 
+    // same as Insert, from a column of every field in its raw layout
+    // rather than a protobuf InsertData, see InsertColumn
+    virtual void
+    InsertColumns(int64_t reserved_offset,
+                  int64_t size,
+                  const int64_t* row_ids,
+                  const Timestamp* timestamps,
+                  const std::vector<InsertColumn>& columns) = 0;
+
+    // same as Insert, and the older rows of the pks of insert_data are
+    // deleted at the timestamps of the new rows, in delete entries it
+    // reserves itself
+    virtual void
+    Upsert(int64_t reserved_offset,
+           int64_t size,
+           const int64_t* row_ids,
+           const Timestamp* timestamps,
+           const InsertData* insert_data) = 0;
+
     SegmentType
     type() const override {
         return SegmentType::Growing;
@@ -10,19 +10,26 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <algorithm>
+#include <exception>
+#include <future>
 #include <numeric>
 #include <queue>
+#include <string>
 #include <thread>
+#include <utility>
 #include <boost/iterator/counting_iterator.hpp>
 #include <type_traits>
 
 #include "common/Consts.h"
 #include "common/Types.h"
+#include "log/Log.h"
 #include "nlohmann/json.hpp"
 #include "query/PlanNode.h"
 #include "query/SearchOnSealed.h"
+#include "segcore/Gather.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "segcore/Utils.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::segcore {
 
@@ -42,19 +49,17 @@ void
 SegmentGrowingImpl::mask_with_delete(BitsetType& bitset,
                                      int64_t ins_barrier,
                                      Timestamp timestamp) const {
+    mask_with_delete_buffer(bitset, ins_barrier, timestamp, insert_record_);
     auto del_barrier = get_barrier(get_deleted_record(), timestamp);
     if (del_barrier == 0) {
         return;
     }
     auto bitmap_holder = get_deleted_bitmap(
         del_barrier, ins_barrier, deleted_record_, insert_record_, timestamp);
-    if (!bitmap_holder || !bitmap_holder->bitmap_ptr) {
+    if (!bitmap_holder) {
         return;
     }
-    auto& delete_bitset = *bitmap_holder->bitmap_ptr;
-    AssertInfo(delete_bitset.size() == bitset.size(),
-               "Deleted bitmap size not equal to filtered bitmap size");
-    bitset |= delete_bitset;
+    bitmap_holder->bitmap.or_to(bitset);
 }
 
 void
@@ -63,6 +68,34 @@ SegmentGrowingImpl::Insert(int64_t reserved_offset,
                            const int64_t* row_ids,
                            const Timestamp* timestamps_raw,
                            const InsertData* insert_data) {
+    std::vector<PkType> pks;
+    insert_rows(
+        reserved_offset, size, row_ids, timestamps_raw, insert_data, pks);
+}
+
+void
+SegmentGrowingImpl::Upsert(int64_t reserved_offset,
+                           int64_t size,
+                           const int64_t* row_ids,
+                           const Timestamp* timestamps_raw,
+                           const InsertData* insert_data) {
+    std::vector<PkType> pks;
+    insert_rows(
+        reserved_offset, size, row_ids, timestamps_raw, insert_data, pks);
+    // the pks are decoded once for both, and the older rows are looked up
+    // when the deletes are applied. A delete doesn't hide the row of its
+    // own timestamp, so the new rows stay visible
+    auto delete_offset = PreDelete(size);
+    deleted_record_.push(delete_offset, pks.data(), timestamps_raw, size);
+}
+
+void
+SegmentGrowingImpl::insert_rows(int64_t reserved_offset,
+                                int64_t size,
+                                const int64_t* row_ids,
+                                const Timestamp* timestamps_raw,
+                                const InsertData* insert_data,
+                                std::vector<PkType>& pks) {
     AssertInfo(insert_data->num_rows() == size,
                "Entities_raw count not equal to insert size");
     //    AssertInfo(insert_data->fields_data_size() == schema_->size(),
@@ -86,14 +119,21 @@ SegmentGrowingImpl::Insert(int64_t reserved_offset,
     for (auto [field_id, field_meta] : schema_->get_fields()) {
         AssertInfo(field_id_to_offset.count(field_id), "Cannot find field_id");
         auto data_offset = field_id_to_offset[field_id];
-        if (!indexing_record_.SyncDataWithIndex(field_id)) {
+        if (!indexing_record_.HasRawData(field_id)) {
             insert_record_.get_field_data_base(field_id)->set_data_raw(
                 reserved_offset,
                 size,
                 &insert_data->fields_data(data_offset),
                 field_meta);
+            if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+                insert_record_.fill_vector_norms(
+                    field_id, field_meta.get_dim(), reserved_offset, size);
+                insert_record_.fill_vector_sketches(
+                    field_id, field_meta.get_dim(), reserved_offset, size);
+            }
         }
-        if (segcore_config_.get_enable_growing_segment_index()) {
+        if (segcore_config_.get_enable_growing_segment_index() &&
+            !segcore_config_.get_growing_index_async_build()) {
             indexing_record_.AppendingIndex(
                 reserved_offset,
                 size,
@@ -106,16 +146,197 @@ SegmentGrowingImpl::Insert(int64_t reserved_offset,
     // step 4: set pks to offset
     auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
     AssertInfo(field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
-    std::vector<PkType> pks(size);
+    pks.resize(size);
     ParsePksFromFieldData(
         pks, insert_data->fields_data(field_id_to_offset[field_id]));
     for (int i = 0; i < size; ++i) {
         insert_record_.insert_pk(pks[i], reserved_offset + i);
     }
 
-    // step 5: update small indexes
+    ack_insert(reserved_offset, size);
+}
+
+void
+SegmentGrowingImpl::InsertColumns(int64_t reserved_offset,
+                                  int64_t size,
+                                  const int64_t* row_ids,
+                                  const Timestamp* timestamps_raw,
+                                  const std::vector<InsertColumn>& columns) {
+    std::unordered_map<FieldId, const InsertColumn*> field_columns;
+    for (auto& column : columns) {
+        AssertInfo(!field_columns.count(column.field_id),
+                   "duplicate field data");
+        field_columns.emplace(column.field_id, &column);
+    }
+    std::vector<FieldId> field_ids;
+    for (auto& [field_id, field_meta] : schema_->get_fields()) {
+        AssertInfo(field_columns.count(field_id), "Cannot find field_id");
+        field_ids.push_back(field_id);
+    }
+
+    insert_record_.timestamps_.set_data_raw(
+        reserved_offset, timestamps_raw, size);
+    insert_record_.row_ids_.set_data_raw(reserved_offset, row_ids, size);
+
+    auto fill_field = [&](FieldId field_id) {
+        auto& field_meta = (*schema_)[field_id];
+        auto& column = *field_columns.at(field_id);
+        if (!indexing_record_.HasRawData(field_id)) {
+            insert_record_.get_field_data_base(field_id)->set_data_raw(
+                reserved_offset, size, column, field_meta);
+            if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+                insert_record_.fill_vector_norms(
+                    field_id, field_meta.get_dim(), reserved_offset, size);
+                insert_record_.fill_vector_sketches(
+                    field_id, field_meta.get_dim(), reserved_offset, size);
+            }
+        }
+        if (segcore_config_.get_enable_growing_segment_index() &&
+            !segcore_config_.get_growing_index_async_build() &&
+            field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+            indexing_record_.AppendingIndex(
+                reserved_offset,
+                size,
+                field_id,
+                static_cast<const float*>(column.data),
+                insert_record_);
+        }
+    };
+    // every field is copied into its own vector, so the fields of a large
+    // insert are filled concurrently, the caller filling the first one
+    constexpr int64_t parallel_fill_rows = 4096;
+    if (size < parallel_fill_rows || field_ids.size() < 2) {
+        for (auto field_id : field_ids) {
+            fill_field(field_id);
+        }
+    } else {
+        auto& pool = ThreadPool::GetInstance();
+        std::vector<std::future<void>> futures;
+        futures.reserve(field_ids.size() - 1);
+        for (size_t i = 1; i < field_ids.size(); ++i) {
+            futures.push_back(pool.Submit(fill_field, field_ids[i]));
+        }
+        // wait all tasks before rethrowing, they reference this frame
+        std::exception_ptr error;
+        try {
+            fill_field(field_ids[0]);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (auto& future : futures) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    auto pk_field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
+    AssertInfo(pk_field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
+    auto& pk_column = *field_columns.at(pk_field_id);
+    switch ((*schema_)[pk_field_id].get_data_type()) {
+        case DataType::INT64: {
+            auto pks = static_cast<const int64_t*>(pk_column.data);
+            for (int64_t i = 0; i < size; ++i) {
+                insert_record_.insert_pk(pks[i], reserved_offset + i);
+            }
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto bytes = static_cast<const char*>(pk_column.data);
+            auto offsets = pk_column.offsets;
+            for (int64_t i = 0; i < size; ++i) {
+                std::string pk(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+                insert_record_.insert_pk(std::move(pk), reserved_offset + i);
+            }
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key type");
+        }
+    }
+
+    ack_insert(reserved_offset, size);
+}
+
+void
+SegmentGrowingImpl::ack_insert(int64_t reserved_offset, int64_t size) {
+    // update small indexes
     insert_record_.ack_responder_.AddSegment(reserved_offset,
                                              reserved_offset + size);
+
+    // index the scalar fields of the chunks filled by now
+    if (segcore_config_.get_growing_chunk_freeze_ms() >= 0) {
+        schedule_freeze();
+    }
+
+    // add the acked rows to the interim indexes
+    if (segcore_config_.get_enable_growing_segment_index() &&
+        segcore_config_.get_growing_index_async_build()) {
+        schedule_index_build();
+    }
+}
+
+SegmentGrowingImpl::~SegmentGrowingImpl() {
+    {
+        std::lock_guard lck(freeze_mutex_);
+        if (freeze_future_.valid()) {
+            freeze_future_.wait();
+        }
+    }
+    std::lock_guard lck(index_build_mutex_);
+    if (index_build_future_.valid()) {
+        index_build_future_.wait();
+    }
+}
+
+void
+SegmentGrowingImpl::schedule_freeze() {
+    auto full_chunks = insert_record_.ack_responder_.GetAck() /
+                       segcore_config_.get_chunk_rows();
+    if (!indexing_record_.FreezePending(full_chunks) ||
+        freezing_.exchange(true)) {
+        return;
+    }
+    std::lock_guard lck(freeze_mutex_);
+    freeze_future_ =
+        ThreadPool::GetInstance().Submit(TaskPriority::LOW, [this]() {
+            try {
+                indexing_record_.FreezeChunks(insert_record_);
+            } catch (std::exception& e) {
+                LOG_SEGCORE_WARNING_ << "failed to freeze the chunks of "
+                                        "growing segment "
+                                     << id_ << ": " << e.what();
+            }
+            freezing_.store(false);
+        });
+}
+
+void
+SegmentGrowingImpl::schedule_index_build() {
+    if (!indexing_record_.IndexBehind(
+            insert_record_.ack_responder_.GetAck()) ||
+        index_building_.exchange(true)) {
+        return;
+    }
+    std::lock_guard lck(index_build_mutex_);
+    index_build_future_ =
+        ThreadPool::GetInstance().Submit(TaskPriority::LOW, [this]() {
+            try {
+                indexing_record_.BuildIndexes(insert_record_);
+            } catch (std::exception& e) {
+                LOG_SEGCORE_WARNING_ << "failed to build the interim index "
+                                        "of growing segment "
+                                     << id_ << ": " << e.what();
+            }
+            index_building_.store(false);
+        });
 }
 
 Status
@@ -145,23 +366,38 @@ SegmentGrowingImpl::Delete(int64_t reserved_begin,
     }
 
     // step 2: fill delete record
-    deleted_record_.timestamps_.set_data_raw(
-        reserved_begin, sort_timestamps.data(), size);
-    deleted_record_.pks_.set_data_raw(reserved_begin, sort_pks.data(), size);
-    deleted_record_.ack_responder_.AddSegment(reserved_begin,
-                                              reserved_begin + size);
+    deleted_record_.push(
+        reserved_begin, sort_pks.data(), sort_timestamps.data(), size);
     return Status::OK();
 }
 
 int64_t
 SegmentGrowingImpl::GetMemoryUsageInBytes() const {
-    int64_t total_bytes = 0;
-    auto chunk_rows = segcore_config_.get_chunk_rows();
-    int64_t ins_n = upper_align(insert_record_.reserved, chunk_rows);
-    total_bytes += ins_n * (schema_->get_total_sizeof() + 16 + 1);
-    int64_t del_n = upper_align(deleted_record_.reserved, chunk_rows);
-    total_bytes += del_n * (16 * 2);
-    return total_bytes;
+    return GetMemoryUsage().resident_bytes();
+}
+
+MemoryUsage
+SegmentGrowingImpl::GetMemoryUsage() const {
+    MemoryUsage usage;
+    for (auto& [field_id, field_meta] : *schema_) {
+        auto& field = usage.fields[field_id.get()];
+        field.mmap_file = insert_record_.field_file_bytes(field_id);
+        field.raw = insert_record_.field_memory_bytes(field_id) -
+                    field.mmap_file;
+        if (indexing_record_.is_in(field_id)) {
+            field.index =
+                indexing_record_.get_field_indexing(field_id).memory_bytes();
+        }
+        if (indexing_record_.has_chunk_indexing(field_id)) {
+            field.index +=
+                indexing_record_.get_chunk_indexing(field_id).memory_bytes();
+        }
+    }
+    usage.system = insert_record_.timestamps_.memory_size() +
+                   insert_record_.row_ids_.memory_size();
+    usage.pk_map = insert_record_.pk_memory_bytes();
+    usage.deletes = deleted_record_.memory_bytes();
+    return usage;
 }
 
 void
@@ -182,10 +418,15 @@ SegmentGrowingImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
 
     // step 2: fill pks and timestamps
     auto reserved_begin = deleted_record_.reserved.fetch_add(size);
-    deleted_record_.pks_.set_data_raw(reserved_begin, pks.data(), size);
-    deleted_record_.timestamps_.set_data_raw(reserved_begin, timestamps, size);
-    deleted_record_.ack_responder_.AddSegment(reserved_begin,
-                                              reserved_begin + size);
+    deleted_record_.push(reserved_begin, pks.data(), timestamps, size);
+}
+
+int64_t
+SegmentGrowingImpl::CompactDeletedRecord(Timestamp oldest_query_ts) {
+    return compact_deleted_record(deleted_record_,
+                                  insert_record_,
+                                  insert_record_.ack_responder_.GetAck(),
+                                  oldest_query_ts);
 }
 
 SpanBase
@@ -194,6 +435,13 @@ SegmentGrowingImpl::chunk_data_impl(FieldId field_id, int64_t chunk_id) const {
     return vec->get_span_base(chunk_id);
 }
 
+AnyZoneMap
+SegmentGrowingImpl::chunk_zone_map_impl(FieldId field_id,
+                                        int64_t chunk_id) const {
+    auto vec = get_insert_record().get_field_data_base(field_id);
+    return vec->get_zone_map(chunk_id);
+}
+
 int64_t
 SegmentGrowingImpl::num_chunk() const {
     auto size = get_insert_record().ack_responder_.GetAck();
@@ -227,6 +475,44 @@ SegmentGrowingImpl::vector_search(SearchInfo& search_info,
     }
 }
 
+bool
+SegmentGrowingImpl::vector_search_offsets(
+    SearchInfo& search_info,
+    const void* query_data,
+    int64_t query_count,
+    const std::vector<int64_t>& seg_offsets,
+    SearchResult& output) const {
+    auto field_id = search_info.field_id_;
+    auto& field_meta = schema_->operator[](field_id);
+    auto vec_ptr = insert_record_.get_field_data_base(field_id);
+    auto count = static_cast<int64_t>(seg_offsets.size());
+    std::vector<char> gathered(count * field_meta.get_sizeof());
+    if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+        bulk_subscript_impl<FloatVector>(field_id,
+                                         field_meta.get_sizeof(),
+                                         *vec_ptr,
+                                         seg_offsets.data(),
+                                         count,
+                                         gathered.data());
+    } else {
+        bulk_subscript_impl<BinaryVector>(field_id,
+                                          field_meta.get_sizeof(),
+                                          *vec_ptr,
+                                          seg_offsets.data(),
+                                          count,
+                                          gathered.data());
+    }
+    query::SearchOnOffsets(*schema_,
+                           gathered.data(),
+                           seg_offsets.data(),
+                           count,
+                           search_info,
+                           query_data,
+                           query_count,
+                           output);
+    return true;
+}
+
 std::unique_ptr<DataArray>
 SegmentGrowingImpl::bulk_subscript(FieldId field_id,
                                    const int64_t* seg_offsets,
@@ -234,89 +520,112 @@ SegmentGrowingImpl::bulk_subscript(FieldId field_id,
     // TODO: support more types
     auto vec_ptr = insert_record_.get_field_data_base(field_id);
     auto& field_meta = schema_->operator[](field_id);
+    // rows are gathered into the preallocated data of the result
     if (field_meta.is_vector()) {
-        aligned_vector<char> output(field_meta.get_sizeof() * count);
+        auto data_array = CreateVectorDataArray(count, field_meta);
+        auto output = GetMutableVectorData(data_array.get(), field_meta);
         if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
             bulk_subscript_impl<FloatVector>(field_id,
                                              field_meta.get_sizeof(),
                                              *vec_ptr,
                                              seg_offsets,
                                              count,
-                                             output.data());
+                                             output);
         } else if (field_meta.get_data_type() == DataType::VECTOR_BINARY) {
             bulk_subscript_impl<BinaryVector>(field_id,
                                               field_meta.get_sizeof(),
                                               *vec_ptr,
                                               seg_offsets,
                                               count,
-                                              output.data());
+                                              output);
         } else {
             PanicInfo("logical error");
         }
-        return CreateVectorDataArrayFrom(output.data(), count, field_meta);
+        return data_array;
     }
 
     AssertInfo(!field_meta.is_vector(),
                "Scalar field meta type is vector type");
+    auto data_array = CreateScalarDataArray(count, field_meta);
+    auto scalars = data_array->mutable_scalars();
     switch (field_meta.get_data_type()) {
         case DataType::BOOL: {
-            FixedVector<bool> output(count);
             bulk_subscript_impl<bool>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_bool_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT8: {
-            FixedVector<bool> output(count);
-            bulk_subscript_impl<int8_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            bulk_subscript_impl<int8_t, int32_t>(
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_int_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT16: {
-            FixedVector<int16_t> output(count);
-            bulk_subscript_impl<int16_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            bulk_subscript_impl<int16_t, int32_t>(
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_int_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT32: {
-            FixedVector<int32_t> output(count);
             bulk_subscript_impl<int32_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_int_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT64: {
-            FixedVector<int64_t> output(count);
             bulk_subscript_impl<int64_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_long_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::FLOAT: {
-            FixedVector<float> output(count);
             bulk_subscript_impl<float>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_float_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::DOUBLE: {
-            FixedVector<double> output(count);
             bulk_subscript_impl<double>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                *vec_ptr,
+                seg_offsets,
+                count,
+                scalars->mutable_double_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::VARCHAR: {
-            FixedVector<std::string> output(count);
-            bulk_subscript_impl<std::string>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            GatherChunkedRows<std::string_view>(
+                *vec_ptr,
+                seg_offsets,
+                count,
+                *scalars->mutable_string_data()->mutable_data());
+            break;
         }
         case DataType::JSON: {
-            FixedVector<std::string> output(count);
-            bulk_subscript_impl<Json, std::string>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            GatherChunkedRows<Json>(
+                *vec_ptr,
+                seg_offsets,
+                count,
+                *scalars->mutable_json_data()->mutable_data());
+            break;
         }
         default: {
             PanicInfo("unsupported type");
         }
     }
+    return data_array;
 }
 
 template <typename T>
@@ -328,25 +637,27 @@ SegmentGrowingImpl::bulk_subscript_impl(FieldId field_id,
                                         int64_t count,
                                         void* output_raw) const {
     static_assert(IsVector<T>);
+    if constexpr (std::is_same_v<T, FloatVector>) {
+        auto fp16_ptr = dynamic_cast<const ConcurrentFloat16Vector*>(&vec_raw);
+        if (fp16_ptr != nullptr) {
+            fp16_ptr->gather_rows(
+                seg_offsets, count, reinterpret_cast<float*>(output_raw));
+            return;
+        }
+    }
     auto vec_ptr = dynamic_cast<const ConcurrentVector<T>*>(&vec_raw);
     AssertInfo(vec_ptr, "Pointer of vec_raw is nullptr");
-    auto& vec = *vec_ptr;
-    std::vector<uint8_t> empty(element_sizeof, 0);
 
-    if (indexing_record_.SyncDataWithIndex(field_id)) {
+    if (indexing_record_.HasRawData(field_id)) {
         indexing_record_.GetDataFromIndex(
             field_id, seg_offsets, count, element_sizeof, output_raw);
     } else {
-        auto output_base = reinterpret_cast<char*>(output_raw);
-        for (int i = 0; i < count; ++i) {
-            auto dst = output_base + i * element_sizeof;
-            auto offset = seg_offsets[i];
-            const uint8_t* src =
-                (offset == INVALID_SEG_OFFSET
-                     ? empty.data()
-                     : (const uint8_t*)vec.get_element(offset));
-            memcpy(dst, src, element_sizeof);
-        }
+        // rows at INVALID_SEG_OFFSET keep the zeros of the output
+        GatherChunkedRows(*vec_ptr,
+                          element_sizeof,
+                          seg_offsets,
+                          count,
+                          reinterpret_cast<char*>(output_raw));
     }
 }
 
@@ -359,14 +670,8 @@ SegmentGrowingImpl::bulk_subscript_impl(const VectorBase& vec_raw,
     static_assert(IsScalar<S>);
     auto vec_ptr = dynamic_cast<const ConcurrentVector<S>*>(&vec_raw);
     AssertInfo(vec_ptr, "Pointer of vec_raw is nullptr");
-    auto& vec = *vec_ptr;
-    auto output = reinterpret_cast<T*>(output_raw);
-    for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        if (offset != INVALID_SEG_OFFSET) {
-            output[i] = vec[offset];
-        }
-    }
+    GatherChunkedRows<S>(
+        *vec_ptr, seg_offsets, count, reinterpret_cast<T*>(output_raw));
 }
 
 void
@@ -392,15 +697,15 @@ std::vector<SegOffset>
 SegmentGrowingImpl::search_ids(const BitsetType& bitset,
                                Timestamp timestamp) const {
     std::vector<SegOffset> res_offsets;
-
-    for (int i = 0; i < bitset.size(); i++) {
-        if (bitset[i]) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                res_offsets.push_back(offset);
+    search_visible_ids<true>(
+        reinterpret_cast<const uint8_t*>(boost_ext::get_data(bitset)),
+        bitset.size(),
+        timestamp,
+        [&](const int64_t* offsets, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                res_offsets.emplace_back(offsets[i]);
             }
-        }
-    }
+        });
     return res_offsets;
 }
 
@@ -408,14 +713,69 @@ std::vector<SegOffset>
 SegmentGrowingImpl::search_ids(const BitsetView& bitset,
                                Timestamp timestamp) const {
     std::vector<SegOffset> res_offsets;
+    search_ids(bitset, timestamp, [&](const int64_t* offsets, int64_t count) {
+        for (int64_t i = 0; i < count; ++i) {
+            res_offsets.emplace_back(offsets[i]);
+        }
+    });
+    return res_offsets;
+}
+
+void
+SegmentGrowingImpl::search_ids(const BitsetView& bitset,
+                               Timestamp timestamp,
+                               const OffsetBatchConsumer& consume) const {
+    search_visible_ids<false>(bitset.data(), bitset.size(), timestamp, consume);
+}
 
-    for (int i = 0; i < bitset.size(); ++i) {
-        if (!bitset.test(i)) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                res_offsets.push_back(offset);
+template <bool value>
+void
+SegmentGrowingImpl::search_visible_ids(
+    const uint8_t* data,
+    int64_t num_bits,
+    Timestamp timestamp,
+    const OffsetBatchConsumer& consume) const {
+    // the chunks whose zone map is not after the timestamp are visible as a
+    // whole, only the offsets in the others look their timestamps up
+    auto& timestamps = insert_record_.timestamps_;
+    int64_t chunk_id = -1;
+    const Timestamp* chunk_data = nullptr;
+    bool chunk_visible = false;
+    int64_t visible[kBitBatchSize];
+    ForEachBitBatch<value>(
+        data, num_bits, [&](const int64_t* offsets, int64_t count) {
+            int64_t num_visible = 0;
+            for (int64_t i = 0; i < count; ++i) {
+                auto [id, offset_in_chunk] = timestamps.locate(offsets[i]);
+                if (id != chunk_id) {
+                    chunk_id = id;
+                    chunk_data = static_cast<const Timestamp*>(
+                        timestamps.get_chunk_data(id));
+                    auto zone = timestamps.get_zone_map(id);
+                    auto ts_zone = std::get_if<ZoneMap<int64_t>>(&zone);
+                    chunk_visible = ts_zone != nullptr && !ts_zone->empty() &&
+                                    ts_zone->min() >= 0 &&
+                                    Timestamp(ts_zone->max()) <= timestamp;
+                }
+                if (chunk_visible || chunk_data[offset_in_chunk] <= timestamp) {
+                    visible[num_visible++] = offsets[i];
+                }
             }
-        }
+            if (num_visible > 0) {
+                consume(visible, num_visible);
+            }
+        });
+}
+
+std::vector<SegOffset>
+SegmentGrowingImpl::search_pks(const std::vector<PkType>& pks,
+                               Timestamp timestamp) const {
+    std::vector<OffsetMap::PkOffset> pk_offsets;
+    insert_record_.search_pks(pks.data(), pks.size(), timestamp, pk_offsets);
+    std::vector<SegOffset> res_offsets;
+    res_offsets.reserve(pk_offsets.size());
+    for (auto& [pk_index, offset] : pk_offsets) {
+        res_offsets.emplace_back(offset);
     }
     return res_offsets;
 }
@@ -434,26 +794,26 @@ SegmentGrowingImpl::search_ids(const IdArray& id_array,
 
     auto res_id_arr = std::make_unique<IdArray>();
     std::vector<SegOffset> res_offsets;
-    for (auto pk : pks) {
-        auto segOffsets = insert_record_.search_pk(pk, timestamp);
-        for (auto offset : segOffsets) {
-            switch (data_type) {
-                case DataType::INT64: {
-                    res_id_arr->mutable_int_id()->add_data(
-                        std::get<int64_t>(pk));
-                    break;
-                }
-                case DataType::VARCHAR: {
-                    res_id_arr->mutable_str_id()->add_data(
-                        std::get<std::string>(pk));
-                    break;
-                }
-                default: {
-                    PanicInfo("unsupported type");
-                }
+    std::vector<OffsetMap::PkOffset> pk_offsets;
+    insert_record_.search_pks(pks.data(), pks.size(), timestamp, pk_offsets);
+    res_offsets.reserve(pk_offsets.size());
+    for (auto& [pk_index, offset] : pk_offsets) {
+        auto& pk = pks[pk_index];
+        switch (data_type) {
+            case DataType::INT64: {
+                res_id_arr->mutable_int_id()->add_data(std::get<int64_t>(pk));
+                break;
+            }
+            case DataType::VARCHAR: {
+                res_id_arr->mutable_str_id()->add_data(
+                    std::get<std::string>(pk));
+                break;
+            }
+            default: {
+                PanicInfo("unsupported type");
             }
-            res_offsets.push_back(offset);
         }
+        res_offsets.emplace_back(offset);
     }
     return {std::move(res_id_arr), std::move(res_offsets)};
 }
@@ -478,7 +838,67 @@ SegmentGrowingImpl::get_active_count(Timestamp ts) const {
 void
 SegmentGrowingImpl::mask_with_timestamps(BitsetType& bitset_chunk,
                                          Timestamp timestamp) const {
-    // DO NOTHING
+    // rows are mostly appended in timestamp order, so the zone maps of the
+    // timestamps let almost every chunk be skipped, only the chunks which
+    // straddle the query timestamp or the expire timestamp of the ttl are
+    // compared row by row
+    auto& timestamps = insert_record_.timestamps_;
+    auto size = int64_t(bitset_chunk.size());
+    auto size_per_chunk = timestamps.get_size_per_chunk();
+    auto expire = expire_timestamp(timestamp);
+    for (int64_t chunk_id = 0; chunk_id * size_per_chunk < size; ++chunk_id) {
+        auto beg = chunk_id * size_per_chunk;
+        auto end = std::min(size, beg + size_per_chunk);
+        auto zone = timestamps.get_zone_map(chunk_id);
+        auto ts_zone = std::get_if<ZoneMap<int64_t>>(&zone);
+        auto none_newer = false;
+        auto none_expired = expire == 0;
+        // the zone map widens timestamps to int64_t, it is exact as long as
+        // no timestamp has the sign bit set
+        if (ts_zone != nullptr && !ts_zone->empty() && ts_zone->min() >= 0) {
+            auto min = Timestamp(ts_zone->min());
+            auto max = Timestamp(ts_zone->max());
+            none_newer = max <= timestamp;
+            none_expired = none_expired || min >= expire;
+            if (none_newer && none_expired) {
+                continue;
+            }
+            if (min > timestamp || max < expire) {
+                bitset_chunk.set(beg, end - beg, true);
+                continue;
+            }
+        }
+        auto chunk_data =
+            static_cast<const Timestamp*>(timestamps.get_chunk_data(chunk_id));
+        if (!none_newer) {
+            TimestampIndex::MaskNewerTimestamps(
+                timestamp, chunk_data, beg, end, bitset_chunk);
+        }
+        if (!none_expired) {
+            TimestampIndex::MaskOlderTimestamps(
+                expire, chunk_data, beg, end, bitset_chunk);
+        }
+    }
+}
+
+bool
+SegmentGrowingImpl::is_expired(Timestamp timestamp) const {
+    auto expire = expire_timestamp(timestamp);
+    auto size = get_row_count();
+    if (expire == 0 || size == 0) {
+        return false;
+    }
+    auto& timestamps = insert_record_.timestamps_;
+    auto size_per_chunk = timestamps.get_size_per_chunk();
+    for (int64_t chunk_id = 0; chunk_id * size_per_chunk < size; ++chunk_id) {
+        auto zone = timestamps.get_zone_map(chunk_id);
+        auto ts_zone = std::get_if<ZoneMap<int64_t>>(&zone);
+        if (ts_zone == nullptr || ts_zone->empty() || ts_zone->min() < 0 ||
+            Timestamp(ts_zone->max()) >= expire) {
+            return false;
+        }
+    }
+    return true;
 }
 
 }  // namespace milvus::segcore
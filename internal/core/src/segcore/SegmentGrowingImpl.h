@@ -11,8 +11,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <deque>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <tbb/concurrent_priority_queue.h>
@@ -49,6 +53,20 @@ class SegmentGrowingImpl : public SegmentGrowing {
            const Timestamp* timestamps,
            const InsertData* insert_data) override;
 
+    void
+    InsertColumns(int64_t reserved_offset,
+                  int64_t size,
+                  const int64_t* row_ids,
+                  const Timestamp* timestamps,
+                  const std::vector<InsertColumn>& columns) override;
+
+    void
+    Upsert(int64_t reserved_offset,
+           int64_t size,
+           const int64_t* row_ids,
+           const Timestamp* timestamps,
+           const InsertData* insert_data) override;
+
     int64_t
     PreDelete(int64_t size) override;
 
@@ -62,9 +80,15 @@ class SegmentGrowingImpl : public SegmentGrowing {
     int64_t
     GetMemoryUsageInBytes() const override;
 
+    MemoryUsage
+    GetMemoryUsage() const override;
+
     void
     LoadDeletedRecord(const LoadDeletedRecordInfo& info) override;
 
+    int64_t
+    CompactDeletedRecord(Timestamp oldest_query_ts) override;
+
     std::string
     debug() const override;
 
@@ -102,19 +126,27 @@ class SegmentGrowingImpl : public SegmentGrowing {
     // return count of index that has index, i.e., [0, num_chunk_index) have built index
     int64_t
     num_chunk_index(FieldId field_id) const final {
-        return indexing_record_.get_finished_ack();
+        // asked by the filters on the field
+        indexing_record_.record_filter(field_id);
+        return indexing_record_.num_frozen_chunks(field_id);
     }
 
-    // count of chunk that has raw data
+    // count of chunk that has raw data, the chunks of a vector field may
+    // hold fewer rows than size_per_chunk()
     int64_t
     num_chunk_data(FieldId field_id) const final {
         auto size = get_insert_record().ack_responder_.GetAck();
-        return upper_div(size, segcore_config_.get_chunk_rows());
+        auto vec = get_insert_record().get_field_data_base(field_id);
+        return upper_div(size, vec->get_size_per_chunk());
     }
 
     // deprecated
     const index::IndexBase*
     chunk_index_impl(FieldId field_id, int64_t chunk_id) const final {
+        if (indexing_record_.has_chunk_indexing(field_id)) {
+            return indexing_record_.get_chunk_indexing(field_id)
+                .get_chunk_indexing(chunk_id);
+        }
         return indexing_record_.get_field_indexing(field_id).get_chunk_indexing(
             chunk_id);
     }
@@ -124,6 +156,11 @@ class SegmentGrowingImpl : public SegmentGrowing {
         return segcore_config_.get_chunk_rows();
     }
 
+    const SegcoreConfig&
+    get_segcore_config() const {
+        return segcore_config_;
+    }
+
  public:
     int64_t
     get_row_count() const override {
@@ -138,6 +175,11 @@ class SegmentGrowingImpl : public SegmentGrowing {
     int64_t
     get_active_count(Timestamp ts) const override;
 
+    int64_t
+    get_delete_barrier(Timestamp ts) const override {
+        return get_barrier(deleted_record_, ts);
+    }
+
     // for scalar vectors
     template <typename S, typename T = S>
     void
@@ -179,15 +221,32 @@ class SegmentGrowingImpl : public SegmentGrowing {
         : segcore_config_(segcore_config),
           schema_(std::move(schema)),
           index_meta_(indexMeta),
-          insert_record_(*schema_, segcore_config.get_chunk_rows()),
+          insert_record_(
+              *schema_,
+              segcore_config.get_chunk_rows(),
+              segcore_config.get_enable_chunk_arena()
+                  ? std::make_shared<ChunkArena>(
+                        segcore_config.get_chunk_arena_hugepage())
+                  : nullptr,
+              segcore_config.get_enable_pk_filter(),
+              segcore_config.get_enable_growing_fp16_vector(),
+              segcore_config.get_vector_chunk_bytes(),
+              CreateVectorArena(segcore_config, segment_id),
+              segcore_config.get_brute_force_sketch_factor() > 0),
           indexing_record_(*schema_, index_meta_, segcore_config_),
           id_(segment_id) {
     }
 
+    // waits for the chunks being frozen and the interim index being built
+    ~SegmentGrowingImpl() override;
+
     void
     mask_with_timestamps(BitsetType& bitset_chunk,
                          Timestamp timestamp) const override;
 
+    bool
+    is_expired(Timestamp timestamp) const override;
+
     void
     vector_search(SearchInfo& search_info,
                   const void* query_data,
@@ -196,6 +255,13 @@ class SegmentGrowingImpl : public SegmentGrowing {
                   const BitsetView& bitset,
                   SearchResult& output) const override;
 
+    bool
+    vector_search_offsets(SearchInfo& search_info,
+                          const void* query_data,
+                          int64_t query_count,
+                          const std::vector<int64_t>& seg_offsets,
+                          SearchResult& output) const override;
+
  public:
     void
     mask_with_delete(BitsetType& bitset,
@@ -205,12 +271,26 @@ class SegmentGrowingImpl : public SegmentGrowing {
     std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
     search_ids(const IdArray& id_array, Timestamp timestamp) const override;
 
+    std::vector<SegOffset>
+    search_pks(const std::vector<PkType>& pks,
+               Timestamp timestamp) const override;
+
+    bool
+    may_contain_pks(const PkType* pks, int64_t n) const override {
+        return insert_record_.may_contain_any_pk(pks, n);
+    }
+
     std::vector<SegOffset>
     search_ids(const BitsetType& view, Timestamp timestamp) const override;
 
     std::vector<SegOffset>
     search_ids(const BitsetView& view, Timestamp timestamp) const override;
 
+    void
+    search_ids(const BitsetView& view,
+               Timestamp timestamp,
+               const OffsetBatchConsumer& consume) const override;
+
     bool
     HasIndex(FieldId field_id) const override {
         return true;
@@ -233,12 +313,61 @@ class SegmentGrowingImpl : public SegmentGrowing {
     SpanBase
     chunk_data_impl(FieldId field_id, int64_t chunk_id) const override;
 
+    AnyZoneMap
+    chunk_zone_map_impl(FieldId field_id, int64_t chunk_id) const override;
+
     void
     check_search(const query::Plan* plan) const override {
         Assert(plan);
     }
 
  private:
+    // the arena of the vector chunks, mapped from files in a directory of
+    // the segment, null without a growing mmap dir
+    static ChunkArenaPtr
+    CreateVectorArena(const SegcoreConfig& config, int64_t segment_id) {
+        auto& dir = config.get_growing_mmap_dir_path();
+        if (dir.empty()) {
+            return nullptr;
+        }
+        auto path = std::filesystem::path(dir) / std::to_string(segment_id);
+        return std::make_shared<ChunkArena>(
+            false, ChunkArena::DEFAULT_SLAB_SIZE, path.string());
+    }
+
+    // the offsets of the bits of `data` equal to `value` whose rows are
+    // visible at `timestamp`
+    template <bool value>
+    void
+    search_visible_ids(const uint8_t* data,
+                       int64_t num_bits,
+                       Timestamp timestamp,
+                       const OffsetBatchConsumer& consume) const;
+
+    // Insert, the pks of the rows are left in `pks`
+    void
+    insert_rows(int64_t reserved_offset,
+                int64_t size,
+                const int64_t* row_ids,
+                const Timestamp* timestamps,
+                const InsertData* insert_data,
+                std::vector<PkType>& pks);
+
+    // acks the rows [reserved_offset, reserved_offset + size) once all
+    // their fields and pks are in, and schedules the background work
+    void
+    ack_insert(int64_t reserved_offset, int64_t size);
+
+    // freezes the chunks old enough in the background, see
+    // IndexingRecord::FreezeChunks
+    void
+    schedule_freeze();
+
+    // catches the interim indexes up with the inserted rows in the
+    // background, see IndexingRecord::BuildIndexes
+    void
+    schedule_index_build();
+
     SegcoreConfig segcore_config_;
     SchemaPtr schema_;
     IndexMetaPtr index_meta_;
@@ -254,6 +383,16 @@ class SegmentGrowingImpl : public SegmentGrowing {
     mutable DeletedRecord deleted_record_;
 
     int64_t id_;
+
+    // at most one freeze runs at a time
+    std::atomic<bool> freezing_ = false;
+    std::mutex freeze_mutex_;
+    std::future<void> freeze_future_;
+
+    // at most one interim index build runs at a time
+    std::atomic<bool> index_building_ = false;
+    std::mutex index_build_mutex_;
+    std::future<void> index_build_future_;
 };
 
 const static IndexMetaPtr empty_index_meta =
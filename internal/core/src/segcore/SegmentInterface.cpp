@@ -11,12 +11,29 @@
 
 #include "SegmentInterface.h"
 
+#include <chrono>
 #include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include "Utils.h"
+#include "common/Cancellation.h"
+#include "common/Consts.h"
+#include "common/Metrics.h"
 #include "common/SystemProperty.h"
+#include "common/Tracer.h"
+#include "common/Utils.h"
 #include "common/Types.h"
+#include "query/CanMatch.h"
+#include "query/generated/ExecExprVisitor.h"
 #include "query/generated/ExecPlanNodeVisitor.h"
+#include "segcore/SearchCoalescer.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::segcore {
 
@@ -24,12 +41,12 @@ void
 SegmentInternalInterface::FillPrimaryKeys(const query::Plan* plan,
                                           SearchResult& results) const {
     std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
     AssertInfo(plan, "empty plan");
     auto size = results.distances_.size();
     AssertInfo(results.seg_offsets_.size() == size,
                "Size of result distances is not equal to size of ids");
-    Assert(results.primary_keys_.size() == 0);
-    results.primary_keys_.resize(size);
+    Assert(results.int64_pks_.empty() && results.string_pks_.empty());
 
     auto pk_field_id_opt = get_schema().get_primary_field_id();
     AssertInfo(pk_field_id_opt.has_value(),
@@ -41,24 +58,118 @@ SegmentInternalInterface::FillPrimaryKeys(const query::Plan* plan,
         bulk_subscript(pk_field_id, results.seg_offsets_.data(), size);
     results.pk_type_ = DataType(field_data->type());
 
-    ParsePksFromFieldData(results.primary_keys_, *field_data.get());
+    // the keys are taken out of the field data as they are, the strings
+    // are moved rather than copied
+    switch (results.pk_type_) {
+        case DataType::INT64: {
+            auto& pks = field_data->scalars().long_data().data();
+            results.int64_pks_.assign(pks.begin(), pks.end());
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto pks = field_data->mutable_scalars()
+                           ->mutable_string_data()
+                           ->mutable_data();
+            results.string_pks_.reserve(pks->size());
+            for (auto& pk : *pks) {
+                results.string_pks_.push_back(std::move(pk));
+            }
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key type");
+        }
+    }
 }
 
 void
 SegmentInternalInterface::FillTargetEntry(const query::Plan* plan,
                                           SearchResult& results) const {
+    tracer::AutoSpan span("FillTargetEntry");
     std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
     AssertInfo(plan, "empty plan");
     auto size = results.distances_.size();
     AssertInfo(results.seg_offsets_.size() == size,
                "Size of result distances is not equal to size of ids");
 
+    // accounted to the profile of the results if they carry one
+    auto begin = std::chrono::steady_clock::now();
+    auto profile = [&]() {
+        if (results.profile_ != nullptr) {
+            results.profile_->fill_target_entry_ns +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+        }
+    };
+
     // fill other entries except primary key by result_offset
-    for (auto field_id : plan->target_entries_) {
-        auto field_data =
-            bulk_subscript(field_id, results.seg_offsets_.data(), size);
-        results.output_fields_data_[field_id] = std::move(field_data);
+    auto& fields = plan->target_entries_;
+    auto bytes = EstimateTargetEntryBytes(get_schema(), fields, size);
+    auto num_tasks = std::min<int64_t>(
+        fields.size(), bytes / MIN_FILL_TARGET_ENTRY_BYTES_PER_TASK);
+    if (num_tasks <= 1) {
+        for (auto field_id : fields) {
+            auto field_data =
+                bulk_subscript(field_id, results.seg_offsets_.data(), size);
+            results.output_fields_data_[field_id] = std::move(field_data);
+        }
+        profile();
+        return;
+    }
+
+    // fields are gathered independently, the calling thread takes a share
+    std::vector<std::unique_ptr<DataArray>> field_datas(fields.size());
+    auto fill = [&](int64_t task) {
+        for (auto i = task; i < int64_t(fields.size()); i += num_tasks) {
+            field_datas[i] =
+                bulk_subscript(fields[i], results.seg_offsets_.data(), size);
+        }
+    };
+    auto& pool = ThreadPool::GetInstance();
+    std::vector<std::future<void>> futures;
+    for (int64_t task = 1; task < num_tasks; ++task) {
+        futures.push_back(pool.Submit(fill, task));
+    }
+    std::exception_ptr error;
+    try {
+        fill(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // wait all tasks before rethrowing, they reference the results
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
     }
+    for (size_t i = 0; i < fields.size(); ++i) {
+        results.output_fields_data_[fields[i]] = std::move(field_datas[i]);
+    }
+    profile();
+}
+
+BitsetType
+SegmentInternalInterface::exec_predicate(query::Expr& expr,
+                                         const std::string& key,
+                                         int64_t active_count,
+                                         Timestamp timestamp,
+                                         QueryProfile* profile) const {
+    tracer::AutoSpan span("expr_eval");
+    auto begin = std::chrono::steady_clock::now();
+    query::ExecExprVisitor visitor(*this, active_count, timestamp);
+    visitor.set_profile(profile);
+    auto result = visitor.call_child(expr);
+    monitor::expr_eval_latency.ObserveSince(begin);
+    return result;
 }
 
 std::unique_ptr<SearchResult>
@@ -66,23 +177,237 @@ SegmentInternalInterface::Search(
     const query::Plan* plan,
     const query::PlaceholderGroup* placeholder_group,
     Timestamp timestamp) const {
+    auto& coalescer = SearchCoalescer::GetInstance();
+    if (coalescer.Enabled()) {
+        return coalescer.Search(
+            this,
+            plan,
+            placeholder_group,
+            timestamp,
+            [&](const query::PlaceholderGroup* group) {
+                return SearchAt(plan, group, timestamp, nullptr);
+            });
+    }
+    return SearchAt(plan, placeholder_group, timestamp, nullptr);
+}
+
+std::unique_ptr<SearchResult>
+SegmentInternalInterface::Search(
+    const query::Plan* plan,
+    const query::PlaceholderGroup* placeholder_group,
+    const SegmentSnapshot& snapshot) const {
+    return SearchAt(plan, placeholder_group, snapshot.timestamp(), &snapshot);
+}
+
+std::unique_ptr<SearchResult>
+SegmentInternalInterface::SearchAt(
+    const query::Plan* plan,
+    const query::PlaceholderGroup* placeholder_group,
+    Timestamp timestamp,
+    const SegmentSnapshot* snapshot) const {
     std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
     check_search(plan);
-    query::ExecPlanNodeVisitor visitor(*this, timestamp, placeholder_group);
+    query::ExecPlanNodeVisitor visitor(
+        *this, timestamp, placeholder_group, snapshot);
     auto results = std::make_unique<SearchResult>();
     *results = visitor.get_moved_result(*plan->plan_node_);
     results->segment_ = (void*)this;
+    auto& search_info = plan->plan_node_->search_info_;
+    if (search_info.group_by_field_id_.has_value()) {
+        GroupSearchResult(search_info, *results);
+    }
     return results;
 }
 
+std::unique_ptr<SearchResult>
+SegmentInternalInterface::MultiVectorSearch(
+    const std::vector<const query::Plan*>& plans,
+    const std::vector<const query::PlaceholderGroup*>& placeholder_groups,
+    const query::FusionInfo& fusion,
+    Timestamp timestamp) const {
+    AssertInfo(!plans.empty() && plans.size() == placeholder_groups.size(),
+               "a placeholder group for every plan is expected");
+    auto& node = *plans[0]->plan_node_;
+    std::vector<MetricType> metric_types;
+    for (auto plan : plans) {
+        auto& other = *plan->plan_node_;
+        auto same_filter =
+            other.predicate_.has_value() == node.predicate_.has_value() &&
+            other.predicate_key_ == node.predicate_key_;
+        AssertInfo(same_filter,
+                   "the plans of a multi vector search must share the filter");
+        AssertInfo(!other.search_info_.group_by_field_id_.has_value(),
+                   "a multi vector search can't group by a field");
+        metric_types.push_back(other.search_info_.metric_type_);
+    }
+
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    for (auto plan : plans) {
+        check_search(plan);
+    }
+    auto active_count = get_active_count(timestamp);
+    BitsetType excluded;
+    if (active_count > 0) {
+        query::ExecPlanNodeVisitor visitor(
+            *this, timestamp, placeholder_groups[0]);
+        excluded = visitor.ExcludedRows(node, active_count, nullptr);
+    }
+
+    int64_t num_plans = plans.size();
+    std::vector<SearchResult> results(num_plans);
+    {
+        tracer::AutoSpan span("multi_vector_search");
+        ThreadPool::GetInstance().ParallelFor(
+            num_plans, num_plans - 1, [&](int64_t i) {
+                query::ExecPlanNodeVisitor visitor(
+                    *this, timestamp, placeholder_groups[i]);
+                visitor.set_excluded_rows(&excluded);
+                results[i] = visitor.get_moved_result(*plans[i]->plan_node_);
+            });
+    }
+    auto fused = std::make_unique<SearchResult>(
+        query::FuseSearchResults(results, metric_types, fusion));
+    fused->segment_ = (void*)this;
+    return fused;
+}
+
+void
+SegmentInternalInterface::GroupSearchResult(const SearchInfo& search_info,
+                                            SearchResult& results) const {
+    auto& offsets = results.seg_offsets_;
+    auto& distances = results.distances_;
+    auto topk = results.unity_topK_;
+    AssertInfo(offsets.size() == results.total_nq_ * topk,
+               "wrong seg offsets size, size = " +
+                   std::to_string(offsets.size()) + ", expected size = " +
+                   std::to_string(results.total_nq_ * topk));
+    results.group_by_values_.assign(offsets.size(), GroupByValueType{});
+
+    std::vector<int64_t> valid_offsets;
+    valid_offsets.reserve(offsets.size());
+    for (auto offset : offsets) {
+        if (offset != INVALID_SEG_OFFSET) {
+            valid_offsets.push_back(offset);
+        }
+    }
+    if (valid_offsets.empty()) {
+        return;
+    }
+    auto field_data = bulk_subscript(search_info.group_by_field_id_.value(),
+                                     valid_offsets.data(),
+                                     valid_offsets.size());
+    std::vector<GroupByValueType> values(valid_offsets.size());
+    ParseGroupByValuesFromFieldData(values, *field_data);
+
+    std::unordered_map<GroupByValueType, int64_t> group_counts;
+    int64_t value_index = 0;
+    for (int64_t i = 0; i < results.total_nq_; i++) {
+        group_counts.clear();
+        auto begin = i * topk;
+        auto kept = begin;
+        for (auto j = begin; j < begin + topk; j++) {
+            if (offsets[j] == INVALID_SEG_OFFSET) {
+                continue;
+            }
+            auto& value = values[value_index++];
+            auto& count = group_counts[value];
+            if (count >= search_info.group_size_) {
+                continue;
+            }
+            count++;
+            offsets[kept] = offsets[j];
+            distances[kept] = distances[j];
+            results.group_by_values_[kept] = std::move(value);
+            kept++;
+        }
+        for (; kept < begin + topk; kept++) {
+            offsets[kept] = INVALID_SEG_OFFSET;
+            results.group_by_values_[kept] = GroupByValueType{};
+        }
+    }
+}
+
+SegmentSnapshotPtr
+SegmentInternalInterface::AcquireSnapshot(Timestamp timestamp) const {
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    // rows and deletes only ever come in, a snapshot is still valid as long
+    // as no row or delete up to its timestamp came after it was built
+    auto active_count = get_active_count(timestamp);
+    auto del_barrier = get_delete_barrier(timestamp);
+    auto buffer_barrier = get_delete_buffer_barrier(timestamp);
+    {
+        std::lock_guard guard(snapshot_mutex_);
+        auto iter = snapshots_.find(timestamp);
+        if (iter != snapshots_.end()) {
+            auto snapshot = iter->second.lock();
+            if (snapshot != nullptr &&
+                snapshot->active_count() == active_count &&
+                snapshot->del_barrier() == del_barrier &&
+                snapshot->buffer_barrier() == buffer_barrier) {
+                monitor::segment_snapshot_hits.Inc();
+                return snapshot;
+            }
+        }
+    }
+    monitor::segment_snapshot_misses.Inc();
+
+    // built outside snapshot_mutex_, acquires racing on a new timestamp may
+    // each build one and the last one is kept
+    BitsetType invisible(active_count);
+    mask_with_timestamps(invisible, timestamp);
+    mask_with_delete(invisible, active_count, timestamp);
+    auto snapshot = std::make_shared<const SegmentSnapshot>(
+        timestamp,
+        active_count,
+        del_barrier,
+        buffer_barrier,
+        std::move(invisible));
+
+    std::lock_guard guard(snapshot_mutex_);
+    for (auto iter = snapshots_.begin(); iter != snapshots_.end();) {
+        if (iter->second.expired()) {
+            iter = snapshots_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    snapshots_[timestamp] = snapshot;
+    return snapshot;
+}
+
 std::unique_ptr<proto::segcore::RetrieveResults>
 SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
                                    Timestamp timestamp) const {
+    return RetrieveAt(plan, timestamp, nullptr);
+}
+
+std::unique_ptr<proto::segcore::RetrieveResults>
+SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
+                                   const SegmentSnapshot& snapshot) const {
+    return RetrieveAt(plan, snapshot.timestamp(), &snapshot);
+}
+
+std::unique_ptr<proto::segcore::RetrieveResults>
+SegmentInternalInterface::RetrieveAt(const query::RetrievePlan* plan,
+                                     Timestamp timestamp,
+                                     const SegmentSnapshot* snapshot) const {
     std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
     auto results = std::make_unique<proto::segcore::RetrieveResults>();
-    query::ExecPlanNodeVisitor visitor(*this, timestamp);
+    query::ExecPlanNodeVisitor visitor(*this, timestamp, snapshot);
     auto retrieve_results = visitor.get_retrieve_result(*plan->plan_node_);
     retrieve_results.segment_ = (void*)this;
+    CheckCancelled();
+
+    if (!plan->plan_node_->aggregates_.empty()) {
+        for (auto& field_data : retrieve_results.field_data_) {
+            *results->add_fields_data() = std::move(field_data);
+        }
+        return results;
+    }
 
     if (plan->plan_node_->is_count) {
         AssertInfo(retrieve_results.field_data_.size() == 1,
@@ -93,21 +418,90 @@ SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
 
     results->mutable_offset()->Add(retrieve_results.result_offsets_.begin(),
                                    retrieve_results.result_offsets_.end());
+    FillRetrieveFieldsImpl(plan,
+                           retrieve_results.result_offsets_.data(),
+                           retrieve_results.result_offsets_.size(),
+                           *results);
+    return results;
+}
+
+bool
+SegmentInternalInterface::CanMatch(const query::Plan* plan) const {
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    return query::CanMatch(plan->plan_node_->predicate_, *this);
+}
+
+bool
+SegmentInternalInterface::CanMatch(const query::RetrievePlan* plan) const {
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    return query::CanMatch(plan->plan_node_->predicate_, *this);
+}
+
+bool
+SegmentInternalInterface::IsExpired(Timestamp timestamp) const {
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    return is_expired(timestamp);
+}
+
+RetrievedRows
+SegmentInternalInterface::RetrieveRows(const query::RetrievePlan* plan,
+                                       Timestamp timestamp) const {
+    auto& node = *plan->plan_node_;
+    AssertInfo(!node.is_count && node.aggregates_.empty() &&
+                   !node.order_by_.has_value(),
+               "the rows of a count, an aggregate or an ordered retrieve "
+               "aren't merged by pk");
+    auto pk_field_id = plan->schema_.get_primary_field_id();
+    AssertInfo(pk_field_id.has_value(), "schema has no primary key");
 
-    auto fields_data = results->mutable_fields_data();
-    auto ids = results->mutable_ids();
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    query::ExecPlanNodeVisitor visitor(*this, timestamp, nullptr);
+    auto retrieve_results = visitor.get_retrieve_result(node);
+    CheckCancelled();
+
+    RetrievedRows rows;
+    rows.offsets = std::move(retrieve_results.result_offsets_);
+    auto size = int64_t(rows.offsets.size());
+    rows.pks = bulk_subscript(pk_field_id.value(), rows.offsets.data(), size);
+    rows.timestamps.resize(size);
+    bulk_subscript(SystemFieldType::Timestamp,
+                   rows.offsets.data(),
+                   size,
+                   rows.timestamps.data());
+    return rows;
+}
+
+void
+SegmentInternalInterface::FillRetrieveFields(
+    const query::RetrievePlan* plan,
+    const int64_t* offsets,
+    int64_t size,
+    proto::segcore::RetrieveResults& results) const {
+    std::shared_lock lck(mutex_);
+    auto rcu_guard = rcu_.Read();
+    FillRetrieveFieldsImpl(plan, offsets, size, results);
+}
+
+void
+SegmentInternalInterface::FillRetrieveFieldsImpl(
+    const query::RetrievePlan* plan,
+    const int64_t* offsets,
+    int64_t size,
+    proto::segcore::RetrieveResults& results) const {
+    auto fields_data = results.mutable_fields_data();
+    auto ids = results.mutable_ids();
     auto pk_field_id = plan->schema_.get_primary_field_id();
     for (auto field_id : plan->field_ids_) {
         if (SystemProperty::Instance().IsSystem(field_id)) {
             auto system_type =
                 SystemProperty::Instance().GetSystemFieldType(field_id);
 
-            auto size = retrieve_results.result_offsets_.size();
             FixedVector<int64_t> output(size);
-            bulk_subscript(system_type,
-                           retrieve_results.result_offsets_.data(),
-                           size,
-                           output.data());
+            bulk_subscript(system_type, offsets, size, output.data());
 
             auto data_array = std::make_unique<DataArray>();
             data_array->set_field_id(field_id.get());
@@ -123,9 +517,7 @@ SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
 
         auto& field_meta = plan->schema_[field_id];
 
-        auto col = bulk_subscript(field_id,
-                                  retrieve_results.result_offsets_.data(),
-                                  retrieve_results.result_offsets_.size());
+        auto col = bulk_subscript(field_id, offsets, size);
         auto col_data = col.release();
         fields_data->AddAllocated(col_data);
         if (pk_field_id.has_value() && pk_field_id.value() == field_id) {
@@ -151,7 +543,6 @@ SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
             }
         }
     }
-    return results;
 }
 
 int64_t
@@ -178,4 +569,80 @@ SegmentInternalInterface::get_real_count() const {
     return res->fields_data()[0].scalars().long_data().data(0);
 }
 
+std::vector<std::unique_ptr<SearchResult>>
+SearchSegments(const std::vector<const SegmentInterface*>& segments,
+               const query::Plan* plan,
+               const query::PlaceholderGroup* placeholder_group,
+               Timestamp timestamp,
+               const std::function<void(SearchResult*)>& on_result) {
+    AssertInfo(plan, "empty plan");
+    auto negate =
+        !PositivelyRelated(plan->plan_node_->search_info_.metric_type_);
+    std::vector<std::unique_ptr<SearchResult>> results(segments.size());
+    // a segment placed on a NUMA node is searched by the workers of its
+    // node, resolved before submitting anything so nothing is left running
+    // on a failure
+    std::vector<ThreadPool*> pools(segments.size(), nullptr);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        AssertInfo(segments[i], "empty segment");
+        auto node = segments[i]->get_numa_node();
+        if (node >= 0) {
+            pools[i] = &ThreadPool::GetNodeInstance(node);
+        }
+    }
+    // the segments are searched within the trace and the cancellation of
+    // the caller
+    auto parent_span = tracer::GetActiveSpan();
+    auto token = GetActiveCancellation();
+    auto search = [&](size_t i) {
+        tracer::ActiveSpanScope span_scope(parent_span);
+        CancellationScope cancellation_scope(token);
+        tracer::AutoSpan span("search_segment");
+        results[i] = segments[i]->Search(plan, placeholder_group, timestamp);
+        if (negate) {
+            for (auto& dis : results[i]->distances_) {
+                dis *= -1;
+            }
+        }
+        if (on_result) {
+            on_result(results[i].get());
+        }
+    };
+
+    // the caller searches the first unplaced segment itself rather than
+    // idling
+    std::optional<size_t> own;
+    std::vector<std::future<void>> futures;
+    futures.reserve(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (pools[i] == nullptr && !own.has_value()) {
+            own = i;
+            continue;
+        }
+        auto pool = pools[i] != nullptr ? pools[i] : &ThreadPool::GetInstance();
+        futures.push_back(pool->Submit(search, i));
+    }
+    std::exception_ptr error;
+    try {
+        if (own.has_value()) {
+            search(own.value());
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return results;
+}
+
 }  // namespace milvus::segcore
@@ -11,28 +11,45 @@
 
 #pragma once
 
+#include <atomic>
 #include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <index/ScalarIndex.h>
 
+#include "CollectionTtl.h"
+#include "DeleteBuffer.h"
 #include "DeletedRecord.h"
 #include "FieldIndexing.h"
+#include "MemoryUsage.h"
+#include "PartitionKeyStats.h"
+#include "RcuDomain.h"
+#include "SegmentArena.h"
+#include "SegmentSnapshot.h"
+#include "common/FieldSketch.h"
 #include "common/Schema.h"
 #include "common/Span.h"
 #include "common/SystemProperty.h"
+#include "common/StringDictionary.h"
 #include "common/Types.h"
+#include "common/ZoneMap.h"
 #include "common/LoadInfo.h"
 #include "common/BitsetView.h"
 #include "common/QueryResult.h"
 #include "common/QueryInfo.h"
+#include "query/Fusion.h"
 #include "query/Plan.h"
 #include "query/PlanNode.h"
 #include "pb/schema.pb.h"
 #include "pb/segcore.pb.h"
 #include "index/IndexInfo.h"
+#include "index/JsonKeyIndex.h"
 
 namespace milvus::segcore {
 
@@ -55,10 +72,28 @@ class SegmentInterface {
     virtual std::unique_ptr<proto::segcore::RetrieveResults>
     Retrieve(const query::RetrievePlan* Plan, Timestamp timestamp) const = 0;
 
-    // TODO: memory use is not correct when load string or load string index
+    // the rows visible at `timestamp`, queries at the same timestamp pass
+    // it to Search and Retrieve rather than masking the rows again; the
+    // snapshot of a timestamp is shared while any handle to it is held
+    virtual SegmentSnapshotPtr
+    AcquireSnapshot(Timestamp timestamp) const = 0;
+
+    virtual std::unique_ptr<SearchResult>
+    Search(const query::Plan* Plan,
+           const query::PlaceholderGroup* placeholder_group,
+           const SegmentSnapshot& snapshot) const = 0;
+
+    virtual std::unique_ptr<proto::segcore::RetrieveResults>
+    Retrieve(const query::RetrievePlan* Plan,
+             const SegmentSnapshot& snapshot) const = 0;
+
+    // the resident bytes of GetMemoryUsage
     virtual int64_t
     GetMemoryUsageInBytes() const = 0;
 
+    virtual MemoryUsage
+    GetMemoryUsage() const = 0;
+
     virtual int64_t
     get_row_count() const = 0;
 
@@ -83,6 +118,12 @@ class SegmentInterface {
     virtual void
     LoadDeletedRecord(const LoadDeletedRecordInfo& info) = 0;
 
+    // folds the deletes up to `oldest_query_ts` into a bitmap and releases
+    // them, no query older than it may come afterwards, returns the number
+    // of deletes folded so far
+    virtual int64_t
+    CompactDeletedRecord(Timestamp oldest_query_ts) = 0;
+
     virtual int64_t
     get_segment_id() const = 0;
 
@@ -91,18 +132,79 @@ class SegmentInterface {
 
     virtual bool
     HasRawData(int64_t field_id) const = 0;
+
+    // the NUMA node the data of the segment is placed on, -1 for none
+    virtual int
+    get_numa_node() const {
+        return -1;
+    }
+
+    // the cpu group the queries of the segment run for, -1 for none
+    virtual int64_t
+    get_cpu_group() const {
+        return -1;
+    }
+};
+
+// the rows of a segment a retrieve selects, ascending, with their pks and
+// timestamps
+struct RetrievedRows {
+    std::vector<int64_t> offsets;
+    std::unique_ptr<DataArray> pks;
+    std::vector<Timestamp> timestamps;
 };
 
 // internal API for DSL calculation
 // only for implementation
 class SegmentInternalInterface : public SegmentInterface {
  public:
+    // attaches the deletes of the collection, masked next to those of the
+    // deleted record of the segment, before the segment is queried
+    void
+    set_delete_buffer(DeleteBufferPtr delete_buffer) {
+        delete_buffer_ = std::move(delete_buffer);
+    }
+
+    // attaches the ttl of the collection, the rows it expires are masked
+    // with the ones newer than the query
+    void
+    set_ttl(CollectionTtlPtr ttl) {
+        ttl_ = std::move(ttl);
+    }
+
+    void
+    set_cpu_group(int64_t group) {
+        cpu_group_.store(group, std::memory_order_relaxed);
+    }
+
+    int64_t
+    get_cpu_group() const override {
+        return cpu_group_.load(std::memory_order_relaxed);
+    }
+
     template <typename T>
     Span<T>
     chunk_data(FieldId field_id, int64_t chunk_id) const {
         return static_cast<Span<T>>(chunk_data_impl(field_id, chunk_id));
     }
 
+    // min/max of the chunk data, nullopt if the segment keeps none
+    template <typename T>
+    std::optional<ZoneMapOf<T>>
+    chunk_zone_map(FieldId field_id, int64_t chunk_id) const {
+        auto zone_map = chunk_zone_map_impl(field_id, chunk_id);
+        if (auto ptr = std::get_if<ZoneMapOf<T>>(&zone_map)) {
+            return std::move(*ptr);
+        }
+        return std::nullopt;
+    }
+
+    // dictionary of a string chunk, null if the chunk isn't encoded
+    const StringDictionary*
+    chunk_string_dictionary(FieldId field_id, int64_t chunk_id) const {
+        return chunk_string_dictionary_impl(field_id, chunk_id);
+    }
+
     template <typename T>
     const index::ScalarIndex<T>&
     chunk_scalar_index(FieldId field_id, int64_t chunk_id) const {
@@ -119,6 +221,17 @@ class SegmentInternalInterface : public SegmentInterface {
            const query::PlaceholderGroup* placeholder_group,
            Timestamp timestamp) const override;
 
+    // searches each plan, on the vector field it names, with the queries
+    // of its placeholder group and fuses the results into one top-k. The
+    // plans must share the filter, which is evaluated and masked once for
+    // all of them, and the searches run in parallel.
+    std::unique_ptr<SearchResult>
+    MultiVectorSearch(
+        const std::vector<const query::Plan*>& plans,
+        const std::vector<const query::PlaceholderGroup*>& placeholder_groups,
+        const query::FusionInfo& fusion,
+        Timestamp timestamp) const;
+
     void
     FillPrimaryKeys(const query::Plan* plan,
                     SearchResult& results) const override;
@@ -131,6 +244,45 @@ class SegmentInternalInterface : public SegmentInterface {
     Retrieve(const query::RetrievePlan* plan,
              Timestamp timestamp) const override;
 
+    SegmentSnapshotPtr
+    AcquireSnapshot(Timestamp timestamp) const override;
+
+    std::unique_ptr<SearchResult>
+    Search(const query::Plan* plan,
+           const query::PlaceholderGroup* placeholder_group,
+           const SegmentSnapshot& snapshot) const override;
+
+    std::unique_ptr<proto::segcore::RetrieveResults>
+    Retrieve(const query::RetrievePlan* plan,
+             const SegmentSnapshot& snapshot) const override;
+
+    // false only if the statistics of the segment prove that no row
+    // matches the filter of the plan, see query::MatchSegment; the search
+    // and the retrieve return no rows for such a segment without
+    // evaluating the filter
+    bool
+    CanMatch(const query::Plan* plan) const;
+
+    bool
+    CanMatch(const query::RetrievePlan* plan) const;
+
+    // is_expired within the locks of the segment
+    bool
+    IsExpired(Timestamp timestamp) const;
+
+    // the rows a retrieve selects without any of its output fields, for
+    // the rows of segments to be merged before they are gathered
+    RetrievedRows
+    RetrieveRows(const query::RetrievePlan* plan, Timestamp timestamp) const;
+
+    // appends the output fields of `plan` at the `size` rows at `offsets`
+    // to `results`, and their pks to its ids
+    void
+    FillRetrieveFields(const query::RetrievePlan* plan,
+                       const int64_t* offsets,
+                       int64_t size,
+                       proto::segcore::RetrieveResults& results) const;
+
     virtual bool
     HasIndex(FieldId field_id) const = 0;
 
@@ -143,6 +295,13 @@ class SegmentInternalInterface : public SegmentInterface {
     int64_t
     get_real_count() const override;
 
+    // the jemalloc arena the data of the segment is allocated from, null
+    // for none
+    const std::shared_ptr<SegmentArena>&
+    get_arena() const {
+        return arena_;
+    }
+
  public:
     virtual void
     vector_search(SearchInfo& search_info,
@@ -152,6 +311,17 @@ class SegmentInternalInterface : public SegmentInterface {
                   const BitsetView& bitset,
                   SearchResult& output) const = 0;
 
+    // brute force search over just the rows at `seg_offsets`, for filters
+    // which leave too few rows for the filtered search to pay off, false if
+    // the vectors of the field can't be gathered or an index search over
+    // this many rows is still cheaper
+    virtual bool
+    vector_search_offsets(SearchInfo& search_info,
+                          const void* query_data,
+                          int64_t query_count,
+                          const std::vector<int64_t>& seg_offsets,
+                          SearchResult& output) const = 0;
+
     virtual void
     mask_with_delete(BitsetType& bitset,
                      int64_t ins_barrier,
@@ -165,10 +335,54 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual int64_t
     num_chunk_data(FieldId field_id) const = 0;
 
+    // values of `pointer` in the json field, extracted at load time,
+    // nullptr if the pointer isn't indexed
+    virtual const index::JsonKeyIndex*
+    json_key_index(FieldId field_id, const std::string& pointer) const {
+        return nullptr;
+    }
+
+    // false if none of the n pks was inserted, from the range and the
+    // bloom filter of the pks
+    virtual bool
+    may_contain_pks(const PkType* pks, int64_t n) const {
+        return true;
+    }
+
+    // values of the partition key field with their offset ranges, nullptr
+    // if they aren't collected
+    virtual const PartitionKeyStats*
+    partition_key_stats(FieldId field_id) const {
+        return nullptr;
+    }
+
+    // distinct count and quantiles of the raw data of a scalar field,
+    // nullptr if they aren't built
+    virtual FieldSketchPtr
+    field_sketch(FieldId field_id) const {
+        return nullptr;
+    }
+
+    // whether the rows are ascending by the raw data of the field, so the
+    // rows within a range of it are contiguous
+    virtual bool
+    is_sorted_by(FieldId field_id) const {
+        return false;
+    }
+
+    // masks the rows newer than `timestamp` and the ones the ttl of the
+    // collection expired at it
     virtual void
     mask_with_timestamps(BitsetType& bitset_chunk,
                          Timestamp timestamp) const = 0;
 
+    // every row of the segment is expired at `timestamp`, which leaves the
+    // segment out of the queries at it
+    virtual bool
+    is_expired(Timestamp timestamp) const {
+        return false;
+    }
+
     // count of chunks
     virtual int64_t
     num_chunk() const = 0;
@@ -180,15 +394,35 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual int64_t
     get_active_count(Timestamp ts) const = 0;
 
+    // number of deletes with a timestamp not after `ts`
+    virtual int64_t
+    get_delete_barrier(Timestamp ts) const = 0;
+
     virtual std::vector<SegOffset>
     search_ids(const BitsetType& view, Timestamp timestamp) const = 0;
 
     virtual std::vector<SegOffset>
     search_ids(const BitsetView& view, Timestamp timestamp) const = 0;
 
+    // takes a batch of ascending offsets
+    using OffsetBatchConsumer =
+        std::function<void(const int64_t* offsets, int64_t count)>;
+
+    // same as above, the offsets are handed to `consume` in batches as
+    // they are found, so they can be gathered in order without collecting
+    // them first
+    virtual void
+    search_ids(const BitsetView& view,
+               Timestamp timestamp,
+               const OffsetBatchConsumer& consume) const = 0;
+
     virtual std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
     search_ids(const IdArray& id_array, Timestamp timestamp) const = 0;
 
+    // offsets of the rows holding `pks`, looked up in the pk offset map
+    virtual std::vector<SegOffset>
+    search_pks(const std::vector<PkType>& pks, Timestamp timestamp) const = 0;
+
  protected:
     // internal API: return chunk_data in span
     virtual SpanBase
@@ -198,6 +432,18 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual const index::IndexBase*
     chunk_index_impl(FieldId field_id, int64_t chunk_id) const = 0;
 
+    // internal API: return zone map of chunk, monostate if there is none
+    virtual AnyZoneMap
+    chunk_zone_map_impl(FieldId field_id, int64_t chunk_id) const {
+        return {};
+    }
+
+    // internal API: return dictionary of a string chunk, null if none
+    virtual const StringDictionary*
+    chunk_string_dictionary_impl(FieldId field_id, int64_t chunk_id) const {
+        return nullptr;
+    }
+
     // calculate output[i] = Vec[seg_offsets[i]}, where Vec binds to system_type
     virtual void
     bulk_subscript(SystemFieldType system_type,
@@ -214,8 +460,104 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual void
     check_search(const query::Plan* plan) const = 0;
 
+    // rows of the first `active_count` matching the predicate of a search
+    // or retrieve, `key` is its serialized form, empty if it isn't known;
+    // the evaluation is profiled into `profile` unless it's nullptr
+    virtual BitsetType
+    exec_predicate(query::Expr& expr,
+                   const std::string& key,
+                   int64_t active_count,
+                   Timestamp timestamp,
+                   QueryProfile* profile) const;
+
+    // keep at most group_size_ hits per group in the topk of each nq, the
+    // dropped slots become invalid, fills results.group_by_values_
+    void
+    GroupSearchResult(const SearchInfo& search_info,
+                      SearchResult& results) const;
+
+    // the rows older than it are expired at `timestamp`, 0 if none is
+    Timestamp
+    expire_timestamp(Timestamp timestamp) const {
+        return ttl_ == nullptr ? 0 : ttl_->expire_timestamp(timestamp);
+    }
+
+    // the DeleteBuffer::barrier of the attached delete buffer
+    std::pair<int64_t, int64_t>
+    get_delete_buffer_barrier(Timestamp timestamp) const {
+        if (delete_buffer_ == nullptr) {
+            return {-1, 0};
+        }
+        return delete_buffer_->barrier(timestamp);
+    }
+
+    // the part of mask_with_delete of the attached delete buffer
+    template <bool is_sealed>
+    void
+    mask_with_delete_buffer(BitsetType& bitset,
+                            int64_t ins_barrier,
+                            Timestamp timestamp,
+                            const InsertRecord<is_sealed>& record) const {
+        if (delete_buffer_ != nullptr) {
+            delete_buffer_bitmap_.mask(
+                *delete_buffer_, record, bitset, ins_barrier, timestamp);
+        }
+    }
+
+ private:
+    // the rows visible to the query are masked at `timestamp`, or taken
+    // from `snapshot` unless it's nullptr
+    std::unique_ptr<SearchResult>
+    SearchAt(const query::Plan* plan,
+             const query::PlaceholderGroup* placeholder_group,
+             Timestamp timestamp,
+             const SegmentSnapshot* snapshot) const;
+
+    std::unique_ptr<proto::segcore::RetrieveResults>
+    RetrieveAt(const query::RetrievePlan* plan,
+               Timestamp timestamp,
+               const SegmentSnapshot* snapshot) const;
+
+    // FillRetrieveFields within the lock of the caller
+    void
+    FillRetrieveFieldsImpl(const query::RetrievePlan* plan,
+                           const int64_t* offsets,
+                           int64_t size,
+                           proto::segcore::RetrieveResults& results) const;
+
  protected:
+    // released after every other member, so the arena is purged only once
+    // the data of the segment is freed, null without an arena
+    std::shared_ptr<SegmentArena> arena_;
     mutable std::shared_mutex mutex_;
+    // every query is a read section of it, the data a load or drop
+    // replaces stays valid until the queries already running are done
+    mutable RcuDomain rcu_;
+    DeleteBufferPtr delete_buffer_;
+    mutable DeleteBufferBitmap delete_buffer_bitmap_;
+    CollectionTtlPtr ttl_;
+    std::atomic<int64_t> cpu_group_{-1};
+
+ private:
+    // snapshots handed out by AcquireSnapshot, an entry expires with the
+    // last handle and is dropped by a later acquire
+    mutable std::mutex snapshot_mutex_;
+    mutable std::unordered_map<Timestamp, std::weak_ptr<const SegmentSnapshot>>
+        snapshots_;
 };
 
+// search `segments` with one plan and placeholder group, the segments are
+// searched concurrently on the shared pool, or on the pool of the NUMA node
+// they are placed on, and results[i] belongs to segments[i]. Distances of
+// metrics where smaller is closer are negated, as the reduce expects larger
+// to be better. `on_result`, if set, is called with every result on the
+// thread which searched its segment, as soon as it is ready.
+std::vector<std::unique_ptr<SearchResult>>
+SearchSegments(
+    const std::vector<const SegmentInterface*>& segments,
+    const query::Plan* plan,
+    const query::PlaceholderGroup* placeholder_group,
+    Timestamp timestamp,
+    const std::function<void(SearchResult*)>& on_result = nullptr);
+
 }  // namespace milvus::segcore
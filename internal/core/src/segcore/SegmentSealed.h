@@ -12,10 +12,13 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "common/LoadInfo.h"
 #include "pb/segcore.pb.h"
+#include "segcore/SegmentGrowing.h"
 #include "segcore/SegmentInterface.h"
 #include "segcore/Types.h"
 
@@ -30,9 +33,52 @@ class SegmentSealed : public SegmentInternalInterface {
     virtual void
     LoadFieldData(const LoadFieldDataInfo& info) = 0;
     virtual void
+    LoadFieldData(const FieldDataInfo& info) = 0;
+    // loads the fields, the system fields among them, decoding and
+    // building them in parallel with at most `memory_budget` bytes of
+    // binlogs in flight, 0 for no limit
+    virtual void
+    LoadFieldDatas(const std::vector<FieldBinlogsInfo>& infos,
+                   int64_t memory_budget) = 0;
+    // loads the deletes of the delta logs at `paths`, decoded in parallel,
+    // and applies them to the loaded pks in one pass
+    virtual void
+    LoadDeletedRecordFromBinlogs(
+        const std::vector<std::string>& paths,
+        storage::RemoteChunkManager* chunk_manager) = 0;
+    // takes the pk range and filter from the stats log of the segment, the
+    // pks loaded afterwards don't build them
+    virtual void
+    LoadPkStats(const uint8_t* data, int64_t size) = 0;
+    // takes the rows, pk stats and deletes of a growing segment of the same
+    // schema, as if its binlogs were loaded, without fetching them
+    virtual void
+    LoadFromGrowing(const SegmentGrowing& growing) = 0;
+    // the field is fetched from its binlogs on first access
+    virtual void
+    LoadFieldDataLazily(const LazyFieldDataInfo& info) = 0;
+    // keeps the raw vectors of a float vector field searched by a quantized
+    // index, in memory or mapped, to rerank the hits of searches with a
+    // refine factor; the field stays searched by its index
+    virtual void
+    LoadRefineData(const FieldDataInfo& info) = 0;
+    // drops the least recently used lazily loaded fields until at most
+    // `memory_budget` bytes of them are resident, returns the freed bytes
+    virtual int64_t
+    EvictLazyFieldData(int64_t memory_budget) = 0;
+    // extracts the values of the json pointers from the loaded json field,
+    // so filters on them don't parse the json of every row
+    virtual void
+    LoadJsonKeyIndex(FieldId field_id,
+                     const std::vector<std::string>& pointers) = 0;
+    virtual void
     DropIndex(const FieldId field_id) = 0;
     virtual void
     DropFieldData(const FieldId field_id) = 0;
+    // the NUMA node the data loaded from now on is placed on, -1 for the
+    // nodes of the loading threads
+    virtual void
+    set_numa_node(int node) = 0;
 
     SegmentType
     type() const override {
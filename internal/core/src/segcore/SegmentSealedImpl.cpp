@@ -14,22 +14,47 @@
 #include <fcntl.h>
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <vector>
 
+#include "FieldDataColumn.h"
+#include "Gather.h"
+#include "SegcoreConfig.h"
+#include "SegmentGrowingImpl.h"
 #include "Utils.h"
 #include "Types.h"
+#include "common/Cancellation.h"
 #include "common/Column.h"
+#include "common/ColumnCache.h"
 #include "common/Consts.h"
 #include "common/FieldMeta.h"
+#include "common/Metrics.h"
+#include "common/Numa.h"
 #include "common/Types.h"
 #include "log/Log.h"
+#include "query/BlockedBruteForce.h"
 #include "query/ScalarIndex.h"
 #include "query/SearchBruteForce.h"
 #include "query/SearchOnSealed.h"
+#include "query/SketchBruteForce.h"
+#include "index/Meta.h"
 #include "index/Utils.h"
+#include "index/VectorIndex.h"
+#include "storage/ChunkManager.h"
+#include "storage/DataCodec.h"
+#include "storage/FieldDataFactory.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::segcore {
 
@@ -48,6 +73,165 @@ get_bit(const BitsetType& bitset, FieldId field_id) {
     return bitset[pos];
 }
 
+template <typename T>
+static AnyZoneMap
+build_zone_map(const SpanBase& span) {
+    ZoneMapOf<T> zone_map;
+    zone_map.Update(static_cast<const T*>(span.data()), span.row_count());
+    return zone_map;
+}
+
+static AnyZoneMap
+build_zone_map(DataType data_type, const SpanBase& span) {
+    switch (data_type) {
+        case DataType::INT8:
+            return build_zone_map<int8_t>(span);
+        case DataType::INT16:
+            return build_zone_map<int16_t>(span);
+        case DataType::INT32:
+            return build_zone_map<int32_t>(span);
+        case DataType::INT64:
+            return build_zone_map<int64_t>(span);
+        case DataType::FLOAT:
+            return build_zone_map<float>(span);
+        case DataType::DOUBLE:
+            return build_zone_map<double>(span);
+        case DataType::STRING:
+        case DataType::VARCHAR:
+            return build_zone_map<std::string_view>(span);
+        default:
+            return {};
+    }
+}
+
+template <typename T>
+static bool
+is_sorted_span(const SpanBase& span) {
+    auto data = static_cast<const T*>(span.data());
+    return std::is_sorted(data, data + span.row_count());
+}
+
+// whether the rows are ascending by the column, as a segment clustered by
+// the field is written
+static bool
+is_sorted_column(DataType data_type, const SpanBase& span) {
+    switch (data_type) {
+        case DataType::INT8:
+            return is_sorted_span<int8_t>(span);
+        case DataType::INT16:
+            return is_sorted_span<int16_t>(span);
+        case DataType::INT32:
+            return is_sorted_span<int32_t>(span);
+        case DataType::INT64:
+            return is_sorted_span<int64_t>(span);
+        case DataType::STRING:
+        case DataType::VARCHAR:
+            return is_sorted_span<std::string_view>(span);
+        default:
+            return false;
+    }
+}
+
+// squared norms of the rows of a float vector column for the brute force
+// search, empty for other columns
+static std::vector<float>
+build_vector_norms(const FieldMeta& field_meta, const SpanBase& span) {
+    std::vector<float> norms;
+    if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+        norms.resize(span.row_count());
+        query::BlockedBruteForce::SquaredNorms(
+            static_cast<const float*>(span.data()),
+            span.row_count(),
+            field_meta.get_dim(),
+            norms.data());
+    }
+    return norms;
+}
+
+// sign sketches of the rows of a float vector column for the brute force
+// search, empty for other columns or without a brute force sketch factor
+static std::vector<uint8_t>
+build_vector_sketches(const FieldMeta& field_meta, const SpanBase& span) {
+    std::vector<uint8_t> sketches;
+    if (field_meta.get_data_type() == DataType::VECTOR_FLOAT &&
+        SegcoreConfig::default_config().get_brute_force_sketch_factor() > 0) {
+        auto dim = field_meta.get_dim();
+        sketches.resize(span.row_count() *
+                        query::SketchBruteForce::CodeSize(dim));
+        query::SketchBruteForce::Encode(static_cast<const float*>(span.data()),
+                                        span.row_count(),
+                                        dim,
+                                        sketches.data());
+    }
+    return sketches;
+}
+
+static std::unique_ptr<PartitionKeyStats>
+build_partition_key_stats(DataType data_type, const SpanBase& span) {
+    switch (data_type) {
+        case DataType::INT64:
+            return PartitionKeyStats::Build(
+                static_cast<const int64_t*>(span.data()), span.row_count());
+        case DataType::STRING:
+        case DataType::VARCHAR:
+            return PartitionKeyStats::Build(
+                static_cast<const std::string_view*>(span.data()),
+                span.row_count());
+        default:
+            return nullptr;
+    }
+}
+
+static FieldSketchPtr
+build_field_sketch(DataType data_type, const SpanBase& span) {
+    if (!SegcoreConfig::default_config().get_enable_field_sketch()) {
+        return nullptr;
+    }
+    auto build = [&](auto* values) -> FieldSketchPtr {
+        return FieldSketch::Build(values, span.row_count());
+    };
+    switch (data_type) {
+        case DataType::BOOL:
+            return build(static_cast<const bool*>(span.data()));
+        case DataType::INT8:
+            return build(static_cast<const int8_t*>(span.data()));
+        case DataType::INT16:
+            return build(static_cast<const int16_t*>(span.data()));
+        case DataType::INT32:
+            return build(static_cast<const int32_t*>(span.data()));
+        case DataType::INT64:
+            return build(static_cast<const int64_t*>(span.data()));
+        case DataType::FLOAT:
+            return build(static_cast<const float*>(span.data()));
+        case DataType::DOUBLE:
+            return build(static_cast<const double*>(span.data()));
+        case DataType::STRING:
+        case DataType::VARCHAR:
+            return build(static_cast<const std::string_view*>(span.data()));
+        default:
+            return nullptr;
+    }
+}
+
+static std::vector<std::unique_ptr<index::JsonKeyIndex>>
+build_json_key_indexes(const VariableColumn<Json>& column,
+                       const std::vector<std::string>& pointers) {
+    std::vector<std::unique_ptr<index::JsonKeyIndex>> indexes;
+    auto& rows = column.views();
+    for (auto& pointer : pointers) {
+        indexes.push_back(std::make_unique<index::JsonKeyIndex>(
+            pointer, rows.data(), rows.size()));
+    }
+    return indexes;
+}
+
+static std::unique_ptr<VariableColumn<std::string>>
+encode_string_column(std::unique_ptr<VariableColumn<std::string>> column) {
+    column->EncodeDictionary(
+        SegcoreConfig::default_config().get_dictionary_max_values());
+    return column;
+}
+
 int64_t
 SegmentSealedImpl::PreDelete(int64_t size) {
     auto reserved_begin = deleted_record_.reserved.fetch_add(size);
@@ -56,6 +240,8 @@ SegmentSealedImpl::PreDelete(int64_t size) {
 
 void
 SegmentSealedImpl::LoadIndex(const LoadIndexInfo& info) {
+    SearchCacheInvalidator invalidator(*this);
+    auto begin = std::chrono::steady_clock::now();
     // print(info);
     // NOTE: lock only when data is ready to avoid starvation
     auto field_id = FieldId(info.field_id);
@@ -66,6 +252,73 @@ SegmentSealedImpl::LoadIndex(const LoadIndexInfo& info) {
     } else {
         LoadScalarIndex(info);
     }
+    monitor::load_index_latency.ObserveSince(begin);
+}
+
+// Searches a freshly loaded vector index with queries sampled from its own
+// vectors, or random ones if it keeps none, so the pages of mapped and disk
+// indexes are faulted in before the first real query. A failed warmup only
+// leaves the index cold.
+static void
+warmup_vec_index(index::VectorIndex& index,
+                 const FieldMeta& field_meta,
+                 const std::string& metric_type,
+                 int64_t num_queries,
+                 int64_t segment_id) {
+    auto begin = std::chrono::steady_clock::now();
+    try {
+        auto count = index.Count();
+        num_queries = std::min(num_queries, count);
+        std::default_random_engine er(segment_id);
+        std::vector<uint8_t> queries;
+        if (index.HasRawData()) {
+            std::vector<int64_t> offsets(num_queries);
+            std::uniform_int_distribution<int64_t> dist(0, count - 1);
+            for (auto& offset : offsets) {
+                offset = dist(er);
+            }
+            queries = index.GetVector(
+                GenIdsDataset(offsets.size(), offsets.data()));
+        } else if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+            queries.resize(num_queries * field_meta.get_sizeof());
+            auto floats = reinterpret_cast<float*>(queries.data());
+            std::uniform_real_distribution<float> dist(-1, 1);
+            for (int64_t i = 0; i < num_queries * field_meta.get_dim(); ++i) {
+                floats[i] = dist(er);
+            }
+        } else {
+            queries.resize(num_queries * field_meta.get_sizeof());
+            std::uniform_int_distribution<int> dist(0, 255);
+            for (auto& byte : queries) {
+                byte = dist(er);
+            }
+        }
+
+        SearchInfo search_info;
+        search_info.topk_ = 10;
+        search_info.round_decimal_ = -1;
+        search_info.field_id_ = field_meta.get_id();
+        search_info.metric_type_ = metric_type;
+        auto dataset =
+            knowhere::GenDataSet(num_queries, index.GetDim(), queries.data());
+        index.Query(dataset, search_info, nullptr);
+    } catch (std::exception& e) {
+        LOG_SEGCORE_WARNING_ << "failed to warm up the index of field "
+                             << field_meta.get_id().get() << " of segment "
+                             << segment_id << ": " << e.what();
+    }
+    auto duration = std::chrono::steady_clock::now() - begin;
+    monitor::index_warmup_latency.Observe(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+            .count());
+    LOG_SEGCORE_INFO_ << "warmed up the index of field "
+                      << field_meta.get_id().get() << " of segment "
+                      << segment_id << " with " << num_queries
+                      << " queries in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(
+                             duration)
+                             .count()
+                      << "ms";
 }
 
 void
@@ -80,31 +333,49 @@ SegmentSealedImpl::LoadVecIndex(const LoadIndexInfo& info) {
     auto row_count = info.index->Count();
     AssertInfo(row_count > 0, "Index count is 0");
 
-    std::unique_lock lck(mutex_);
-    // Don't allow vector raw data and index exist at the same time
-    AssertInfo(!get_bit(field_data_ready_bitset_, field_id),
-               "vector index can't be loaded when raw data exists at field " +
-                   std::to_string(field_id.get()));
-    AssertInfo(
-        !get_bit(index_ready_bitset_, field_id),
-        "vector index has been exist at " + std::to_string(field_id.get()));
-    if (row_count_opt_.has_value()) {
-        AssertInfo(row_count_opt_.value() == row_count,
-                   "field (" + std::to_string(field_id.get()) +
-                       ") data has different row count (" +
-                       std::to_string(row_count) +
-                       ") than other column's row count (" +
-                       std::to_string(row_count_opt_.value()) + ")");
-    }
-    AssertInfo(!vector_indexings_.is_ready(field_id), "vec index is not ready");
-    vector_indexings_.append_field_indexing(
-        field_id,
-        metric_type,
-        std::move(const_cast<LoadIndexInfo&>(info).index));
-
-    set_bit(index_ready_bitset_, field_id, true);
-    update_row_count(row_count);
-    lck.unlock();
+    // warmed up before the index is visible to searches
+    auto warmup_queries =
+        SegcoreConfig::default_config().get_index_warmup_queries();
+    if (auto it = info.index_params.find(index::WARMUP_QUERIES);
+        it != info.index_params.end()) {
+        warmup_queries = std::stoll(it->second);
+    }
+    if (warmup_queries > 0) {
+        auto vec_index = dynamic_cast<index::VectorIndex*>(info.index.get());
+        AssertInfo(vec_index != nullptr, "vector index expected");
+        warmup_vec_index(
+            *vec_index, field_meta, metric_type, warmup_queries, id_);
+    }
+
+    update_fields([&](Fields& fields) {
+        // Don't allow vector raw data and index exist at the same time
+        AssertInfo(
+            !get_bit(fields.field_data_ready_bitset_, field_id),
+            "vector index can't be loaded when raw data exists at field " +
+                std::to_string(field_id.get()));
+        AssertInfo(!get_bit(fields.index_ready_bitset_, field_id),
+                   "vector index has been exist at " +
+                       std::to_string(field_id.get()));
+        if (fields.row_count_opt_.has_value()) {
+            AssertInfo(fields.row_count_opt_.value() == row_count,
+                       "field (" + std::to_string(field_id.get()) +
+                           ") data has different row count (" +
+                           std::to_string(row_count) +
+                           ") than other column's row count (" +
+                           std::to_string(fields.row_count_opt_.value()) +
+                           ")");
+        }
+        AssertInfo(!fields.vector_indexings_.is_ready(field_id),
+                   "vec index is not ready");
+        fields.vector_indexings_.append_field_indexing(
+            field_id,
+            metric_type,
+            std::move(const_cast<LoadIndexInfo&>(info).index),
+            info.index_params);
+
+        set_bit(fields.index_ready_bitset_, field_id, true);
+        fields.row_count_opt_ = row_count;
+    });
 }
 
 void
@@ -116,77 +387,86 @@ SegmentSealedImpl::LoadScalarIndex(const LoadIndexInfo& info) {
     auto row_count = info.index->Count();
     AssertInfo(row_count > 0, "Index count is 0");
 
-    std::unique_lock lck(mutex_);
-    // Don't allow scalar raw data and index exist at the same time
-    AssertInfo(!get_bit(field_data_ready_bitset_, field_id),
-               "scalar index can't be loaded when raw data exists at field " +
-                   std::to_string(field_id.get()));
-    AssertInfo(
-        !get_bit(index_ready_bitset_, field_id),
-        "scalar index has been exist at " + std::to_string(field_id.get()));
-    if (row_count_opt_.has_value()) {
-        AssertInfo(row_count_opt_.value() == row_count,
-                   "field (" + std::to_string(field_id.get()) +
-                       ") data has different row count (" +
-                       std::to_string(row_count) +
-                       ") than other column's row count (" +
-                       std::to_string(row_count_opt_.value()) + ")");
-    }
-
-    scalar_indexings_[field_id] =
+    std::shared_ptr<index::IndexBase> scalar_index =
         std::move(const_cast<LoadIndexInfo&>(info).index);
-    // reverse pk from scalar index and set pks to offset
-    if (schema_->get_primary_field_id() == field_id) {
-        AssertInfo(field_id.get() != -1, "Primary key is -1");
-        AssertInfo(insert_record_.empty_pks(), "already exists");
-        switch (field_meta.get_data_type()) {
-            case DataType::INT64: {
-                auto int64_index = dynamic_cast<index::ScalarIndex<int64_t>*>(
-                    scalar_indexings_[field_id].get());
-                for (int i = 0; i < row_count; ++i) {
-                    insert_record_.insert_pk(int64_index->Reverse_Lookup(i), i);
+    update_fields([&](Fields& fields) {
+        // Don't allow scalar raw data and index exist at the same time
+        AssertInfo(
+            !get_bit(fields.field_data_ready_bitset_, field_id),
+            "scalar index can't be loaded when raw data exists at field " +
+                std::to_string(field_id.get()));
+        AssertInfo(!get_bit(fields.index_ready_bitset_, field_id),
+                   "scalar index has been exist at " +
+                       std::to_string(field_id.get()));
+        if (fields.row_count_opt_.has_value()) {
+            AssertInfo(fields.row_count_opt_.value() == row_count,
+                       "field (" + std::to_string(field_id.get()) +
+                           ") data has different row count (" +
+                           std::to_string(row_count) +
+                           ") than other column's row count (" +
+                           std::to_string(fields.row_count_opt_.value()) +
+                           ")");
+        }
+
+        // reverse pk from scalar index and set pks to offset
+        if (schema_->get_primary_field_id() == field_id) {
+            AssertInfo(field_id.get() != -1, "Primary key is -1");
+            AssertInfo(insert_record_.empty_pks(), "already exists");
+            switch (field_meta.get_data_type()) {
+                case DataType::INT64: {
+                    auto int64_index =
+                        dynamic_cast<index::ScalarIndex<int64_t>*>(
+                            scalar_index.get());
+                    for (int i = 0; i < row_count; ++i) {
+                        insert_record_.insert_pk(
+                            int64_index->Reverse_Lookup(i), i);
+                    }
+                    insert_record_.seal_pks();
+                    break;
                 }
-                insert_record_.seal_pks();
-                break;
-            }
-            case DataType::VARCHAR: {
-                auto string_index =
-                    dynamic_cast<index::ScalarIndex<std::string>*>(
-                        scalar_indexings_[field_id].get());
-                for (int i = 0; i < row_count; ++i) {
-                    insert_record_.insert_pk(string_index->Reverse_Lookup(i),
-                                             i);
+                case DataType::VARCHAR: {
+                    auto string_index =
+                        dynamic_cast<index::ScalarIndex<std::string>*>(
+                            scalar_index.get());
+                    for (int i = 0; i < row_count; ++i) {
+                        insert_record_.insert_pk(
+                            string_index->Reverse_Lookup(i), i);
+                    }
+                    insert_record_.seal_pks();
+                    break;
+                }
+                default: {
+                    PanicInfo("unsupported primary key type");
                 }
-                insert_record_.seal_pks();
-                break;
-            }
-            default: {
-                PanicInfo("unsupported primary key type");
             }
         }
-    }
 
-    set_bit(index_ready_bitset_, field_id, true);
-    update_row_count(row_count);
-    lck.unlock();
+        fields.scalar_indexings_[field_id] = scalar_index;
+        set_bit(fields.index_ready_bitset_, field_id, true);
+        fields.row_count_opt_ = row_count;
+    });
 }
 
 void
 SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& info) {
+    SearchCacheInvalidator invalidator(*this);
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
+    auto begin = std::chrono::steady_clock::now();
     // print(info);
-    // NOTE: lock only when data is ready to avoid starvation
+    // NOTE: publish only when data is ready, queries never wait on it
     AssertInfo(info.row_count > 0, "The row count of field data is 0");
     auto field_id = FieldId(info.field_id);
     AssertInfo(info.field_data != nullptr, "Field info blob is null");
     auto size = info.row_count;
-    if (row_count_opt_.has_value()) {
+    if (auto row_count_opt = loaded_row_count(); row_count_opt.has_value()) {
         AssertInfo(
-            row_count_opt_.value() == size,
+            row_count_opt.value() == size,
             fmt::format(
                 "field {} has different row count {} to other column's {}",
                 field_id.get(),
                 size,
-                row_count_opt_.value()));
+                row_count_opt.value()));
     }
 
     if (SystemProperty::Instance().IsSystem(field_id)) {
@@ -201,27 +481,24 @@ SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& info) {
             auto meta = GenerateFakeSlices(timestamps, size, min_slice_length);
             index.set_length_meta(std::move(meta));
             index.build_with(timestamps, size);
+            PackedTimestamps packed;
+            packed.build(timestamps, size);
 
             // use special index
             std::unique_lock lck(mutex_);
-            AssertInfo(insert_record_.timestamps_.empty(), "already exists");
-            insert_record_.timestamps_.fill_chunk_data(timestamps, size);
+            AssertInfo(insert_record_.packed_timestamps_.empty(),
+                       "already exists");
+            insert_record_.packed_timestamps_ = std::move(packed);
             insert_record_.timestamp_index_ = std::move(index);
-            AssertInfo(insert_record_.timestamps_.num_chunk() == 1,
-                       "num chunk not equal to 1 for sealed segment");
         } else {
             AssertInfo(system_field_type == SystemFieldType::RowId,
                        "System field type of id column is not RowId");
-            auto row_ids = reinterpret_cast<const idx_t*>(
-                FIELD_DATA(info.field_data, long).data());
-            // write data under lock
-            std::unique_lock lck(mutex_);
-            AssertInfo(insert_record_.row_ids_.empty(), "already exists");
-            insert_record_.row_ids_.fill_chunk_data(row_ids, size);
-            AssertInfo(insert_record_.row_ids_.num_chunk() == 1,
-                       "num chunk not equal to 1 for sealed segment");
+            load_row_ids(std::make_shared<Column>(
+                get_segment_id(), FieldMeta::RowIdMeta, info));
         }
         ++system_ready_count_;
+        update_fields(
+            [&](Fields& fields) { fields.row_count_opt_ = info.row_count; });
     } else {
         // prepare data
         auto& field_meta = (*schema_)[field_id];
@@ -230,35 +507,51 @@ SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& info) {
                    "field type of load data is inconsistent with the schema");
 
         // Don't allow raw data and index exist at the same time
-        AssertInfo(!get_bit(index_ready_bitset_, field_id),
+        AssertInfo(!HasIndex(field_id),
                    "field data can't be loaded when indexing exists");
 
-        size_t size = 0;
+        std::shared_ptr<Column> fixed_column;
+        std::shared_ptr<ColumnBase> variable_column;
+        std::vector<std::unique_ptr<index::JsonKeyIndex>> json_key_indexes;
         if (datatype_is_variable(data_type)) {
-            std::unique_ptr<ColumnBase> column{};
             switch (data_type) {
                 case milvus::DataType::STRING:
                 case milvus::DataType::VARCHAR: {
-                    column = std::make_unique<VariableColumn<std::string>>(
-                        get_segment_id(), field_meta, info);
+                    variable_column = encode_string_column(
+                        std::make_unique<VariableColumn<std::string>>(
+                            get_segment_id(), field_meta, info));
                     break;
                 }
                 case milvus::DataType::JSON: {
-                    column = std::make_unique<VariableColumn<Json>>(
+                    auto json_column = std::make_unique<VariableColumn<Json>>(
                         get_segment_id(), field_meta, info);
+                    if (SegcoreConfig::default_config()
+                            .get_enable_json_binary()) {
+                        json_column->EncodeBinaryJson();
+                    }
+                    json_key_indexes = build_json_key_indexes(
+                        *json_column, field_meta.get_json_key_paths());
+                    variable_column = std::move(json_column);
+                    break;
                 }
                 default: {
                 }
             }
-            size = column->size();
-            std::unique_lock lck(mutex_);
-            variable_fields_.emplace(field_id, std::move(column));
         } else {
-            auto column = Column(get_segment_id(), field_meta, info);
-            size = column.size();
-            std::unique_lock lck(mutex_);
-            fixed_fields_.emplace(field_id, std::move(column));
+            fixed_column =
+                std::make_shared<Column>(get_segment_id(), field_meta, info);
         }
+        const ColumnBase& column =
+            fixed_column != nullptr ? *fixed_column : *variable_column;
+        auto zone_map = build_zone_map(data_type, column.span());
+        auto sorted = is_sorted_column(data_type, column.span());
+        std::shared_ptr<PartitionKeyStats> key_stats;
+        if (schema_->get_partition_key_field_id() == field_id) {
+            key_stats = build_partition_key_stats(data_type, column.span());
+        }
+        auto field_sketch = build_field_sketch(data_type, column.span());
+        auto norms = build_vector_norms(field_meta, column.span());
+        auto sketches = build_vector_sketches(field_meta, column.span());
 
         // set pks to offset
         if (schema_->get_primary_field_id() == field_id) {
@@ -272,15 +565,560 @@ SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& info) {
             }
             insert_record_.seal_pks();
         }
-        std::unique_lock lck(mutex_);
-        set_bit(field_data_ready_bitset_, field_id, true);
+
+        update_fields([&](Fields& fields) {
+            if (fixed_column != nullptr) {
+                fields.fixed_fields_.emplace(field_id, fixed_column);
+            } else {
+                fields.variable_fields_.emplace(field_id, variable_column);
+            }
+            fields.zone_maps_[field_id] = std::move(zone_map);
+            if (!norms.empty()) {
+                fields.vector_norms_[field_id] =
+                    std::make_shared<std::vector<float>>(std::move(norms));
+            }
+            if (!sketches.empty()) {
+                fields.vector_sketches_[field_id] =
+                    std::make_shared<std::vector<uint8_t>>(
+                        std::move(sketches));
+            }
+            if (sorted) {
+                fields.sorted_fields_.insert(field_id);
+            }
+            if (key_stats) {
+                fields.partition_key_stats_[field_id] = key_stats;
+            }
+            if (field_sketch) {
+                fields.field_sketches_[field_id] = field_sketch;
+            }
+            add_json_key_indexes(
+                fields, field_id, std::move(json_key_indexes));
+            set_bit(fields.field_data_ready_bitset_, field_id, true);
+            fields.row_count_opt_ = info.row_count;
+        });
     }
-    std::unique_lock lck(mutex_);
-    update_row_count(info.row_count);
+    monitor::load_field_build_latency.ObserveSince(begin);
+}
+
+void
+SegmentSealedImpl::LoadFieldData(const FieldDataInfo& info) {
+    SearchCacheInvalidator invalidator(*this);
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
+    auto load_begin = std::chrono::steady_clock::now();
+    // NOTE: publish only when data is ready, queries never wait on it
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    auto field_id = FieldId(info.field_id);
+    auto size = info.row_count;
+    int64_t num_rows = 0;
+    for (auto& data : info.datas) {
+        num_rows += data->get_num_rows();
+    }
+    AssertInfo(num_rows == size,
+               fmt::format("field {} has {} rows in field datas, expected {}",
+                           field_id.get(),
+                           num_rows,
+                           size));
+    if (auto row_count_opt = loaded_row_count(); row_count_opt.has_value()) {
+        AssertInfo(
+            row_count_opt.value() == size,
+            fmt::format(
+                "field {} has different row count {} to other column's {}",
+                field_id.get(),
+                size,
+                row_count_opt.value()));
+    }
+
+    if (SystemProperty::Instance().IsSystem(field_id)) {
+        auto system_field_type =
+            SystemProperty::Instance().GetSystemFieldType(field_id);
+        if (system_field_type == SystemFieldType::Timestamp) {
+            // timestamps are small, concat them into one chunk
+            std::vector<Timestamp> values;
+            values.reserve(size);
+            for (auto& data : info.datas) {
+                auto begin = static_cast<const Timestamp*>(data->Data());
+                values.insert(
+                    values.end(), begin, begin + data->get_num_rows());
+            }
+            auto timestamps = values.data();
+
+            TimestampIndex index;
+            auto min_slice_length = size < 4096 ? 1 : 4096;
+            auto meta = GenerateFakeSlices(timestamps, size, min_slice_length);
+            index.set_length_meta(std::move(meta));
+            index.build_with(timestamps, size);
+            PackedTimestamps packed;
+            packed.build(timestamps, size);
+
+            // use special index
+            std::unique_lock lck(mutex_);
+            AssertInfo(insert_record_.packed_timestamps_.empty(),
+                       "already exists");
+            insert_record_.packed_timestamps_ = std::move(packed);
+            insert_record_.timestamp_index_ = std::move(index);
+        } else {
+            AssertInfo(system_field_type == SystemFieldType::RowId,
+                       "System field type of id column is not RowId");
+            load_row_ids(
+                MakeColumn(get_segment_id(), FieldMeta::RowIdMeta, info));
+        }
+        ++system_ready_count_;
+        update_fields(
+            [&](Fields& fields) { fields.row_count_opt_ = info.row_count; });
+    } else {
+        // prepare data
+        auto& field_meta = (*schema_)[field_id];
+        auto data_type = field_meta.get_data_type();
+        for (auto& data : info.datas) {
+            AssertInfo(
+                data_type == data->get_data_type(),
+                "field type of load data is inconsistent with the schema");
+        }
+
+        // Don't allow raw data and index exist at the same time
+        AssertInfo(!HasIndex(field_id),
+                   "field data can't be loaded when indexing exists");
+
+        std::shared_ptr<Column> fixed_column;
+        std::shared_ptr<ColumnBase> variable_column;
+        std::vector<std::unique_ptr<index::JsonKeyIndex>> json_key_indexes;
+        if (datatype_is_variable(data_type)) {
+            switch (data_type) {
+                case milvus::DataType::STRING:
+                case milvus::DataType::VARCHAR: {
+                    variable_column = encode_string_column(
+                        MakeVariableColumn<std::string>(
+                            get_segment_id(), field_meta, info));
+                    break;
+                }
+                case milvus::DataType::JSON: {
+                    auto json_column = MakeVariableColumn<Json>(
+                        get_segment_id(), field_meta, info);
+                    if (SegcoreConfig::default_config()
+                            .get_enable_json_binary()) {
+                        json_column->EncodeBinaryJson();
+                    }
+                    json_key_indexes = build_json_key_indexes(
+                        *json_column, field_meta.get_json_key_paths());
+                    variable_column = std::move(json_column);
+                    break;
+                }
+                default: {
+                    PanicInfo(fmt::format("unsupported data type {}",
+                                          datatype_name(data_type)));
+                }
+            }
+        } else {
+            fixed_column = MakeColumn(get_segment_id(), field_meta, info);
+        }
+        const ColumnBase& column =
+            fixed_column != nullptr ? *fixed_column : *variable_column;
+        auto zone_map = build_zone_map(data_type, column.span());
+        auto sorted = is_sorted_column(data_type, column.span());
+        std::shared_ptr<PartitionKeyStats> key_stats;
+        if (schema_->get_partition_key_field_id() == field_id) {
+            key_stats = build_partition_key_stats(data_type, column.span());
+        }
+        auto field_sketch = build_field_sketch(data_type, column.span());
+        auto norms = build_vector_norms(field_meta, column.span());
+        auto sketches = build_vector_sketches(field_meta, column.span());
+
+        // set pks to offset
+        if (schema_->get_primary_field_id() == field_id) {
+            AssertInfo(field_id.get() != -1, "Primary key is -1");
+            AssertInfo(insert_record_.empty_pks(), "already exists");
+            int64_t offset = 0;
+            for (auto& data : info.datas) {
+                for (ssize_t i = 0; i < data->get_num_rows(); ++i) {
+                    if (data_type == DataType::INT64) {
+                        insert_record_.insert_pk(
+                            *static_cast<const int64_t*>(data->RawValue(i)),
+                            offset++);
+                    } else {
+                        insert_record_.insert_pk(
+                            std::string(
+                                static_cast<const char*>(data->RawValue(i)),
+                                data->get_element_size(i)),
+                            offset++);
+                    }
+                }
+            }
+            insert_record_.seal_pks();
+        }
+
+        update_fields([&](Fields& fields) {
+            if (fixed_column != nullptr) {
+                fields.fixed_fields_.emplace(field_id, fixed_column);
+            } else {
+                fields.variable_fields_.emplace(field_id, variable_column);
+            }
+            fields.zone_maps_[field_id] = std::move(zone_map);
+            if (!norms.empty()) {
+                fields.vector_norms_[field_id] =
+                    std::make_shared<std::vector<float>>(std::move(norms));
+            }
+            if (!sketches.empty()) {
+                fields.vector_sketches_[field_id] =
+                    std::make_shared<std::vector<uint8_t>>(
+                        std::move(sketches));
+            }
+            if (sorted) {
+                fields.sorted_fields_.insert(field_id);
+            }
+            if (key_stats) {
+                fields.partition_key_stats_[field_id] = key_stats;
+            }
+            if (field_sketch) {
+                fields.field_sketches_[field_id] = field_sketch;
+            }
+            add_json_key_indexes(
+                fields, field_id, std::move(json_key_indexes));
+            set_bit(fields.field_data_ready_bitset_, field_id, true);
+            fields.row_count_opt_ = info.row_count;
+        });
+    }
+    monitor::load_field_build_latency.ObserveSince(load_begin);
+}
+
+void
+SegmentSealedImpl::load_row_ids(std::shared_ptr<Column> column) {
+    update_fields([&](Fields& fields) {
+        AssertInfo(fields.row_ids_ == nullptr, "already exists");
+        fields.row_ids_ = std::move(column);
+    });
+}
+
+void
+SegmentSealedImpl::LoadFieldDatas(const std::vector<FieldBinlogsInfo>& infos,
+                                  int64_t memory_budget) {
+    std::vector<int64_t> field_bytes(infos.size());
+    std::vector<size_t> order(infos.size());
+    for (size_t i = 0; i < infos.size(); ++i) {
+        auto& info = infos[i];
+        AssertInfo(info.binlogs.size() == info.binlog_sizes.size(),
+                   fmt::format("field {} has {} binlogs but {} sizes",
+                               info.field_id,
+                               info.binlogs.size(),
+                               info.binlog_sizes.size()));
+        AssertInfo(info.row_count == infos[0].row_count,
+                   fmt::format("field {} has different row count {} to "
+                               "field {}'s {}",
+                               info.field_id,
+                               info.row_count,
+                               infos[0].field_id,
+                               infos[0].row_count));
+        field_bytes[i] = std::accumulate(
+            info.binlog_sizes.begin(), info.binlog_sizes.end(), int64_t(0));
+        order[i] = i;
+    }
+    // the largest fields first, the small ones fill the gaps at the end
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return field_bytes[a] > field_bytes[b];
+    });
+
+    // a field waits for the ones in flight while it would exceed the
+    // budget, the first one always goes
+    std::mutex budget_mutex;
+    std::condition_variable budget_released;
+    int64_t in_flight = 0;
+    auto& pool = ThreadPool::GetInstance();
+    pool.ParallelFor(infos.size(), pool.GetThreadNum(), [&](int64_t i) {
+        auto& info = infos[order[i]];
+        auto bytes = field_bytes[order[i]];
+        {
+            std::unique_lock lck(budget_mutex);
+            budget_released.wait(lck, [&] {
+                return memory_budget <= 0 || in_flight == 0 ||
+                       in_flight + bytes <= memory_budget;
+            });
+            in_flight += bytes;
+        }
+        auto release = [&] {
+            {
+                std::lock_guard lck(budget_mutex);
+                in_flight -= bytes;
+            }
+            budget_released.notify_all();
+        };
+        try {
+            auto begin = std::chrono::steady_clock::now();
+            FieldDataInfo load_info{
+                info.field_id, {}, info.row_count, info.mmap_dir_path};
+            for (size_t j = 0; j < info.binlogs.size(); ++j) {
+                // the binlog is owned by the caller, decode it without a copy
+                auto binlog = std::shared_ptr<uint8_t[]>(
+                    const_cast<uint8_t*>(info.binlogs[j]), [](uint8_t*) {});
+                auto codec =
+                    storage::DeserializeFileData(binlog, info.binlog_sizes[j]);
+                load_info.datas.push_back(codec->GetFieldData());
+            }
+            monitor::load_field_decode_latency.ObserveSince(begin);
+            LoadFieldData(load_info);
+            // the column has its own copy, the decoded buffers go back to
+            // the field data pool before the budget is released
+            load_info.datas.clear();
+        } catch (...) {
+            release();
+            throw;
+        }
+        release();
+    });
+}
+
+void
+SegmentSealedImpl::LoadRefineData(const FieldDataInfo& info) {
+    SearchCacheInvalidator invalidator(*this);
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    auto field_id = FieldId(info.field_id);
+    auto& field_meta = (*schema_)[field_id];
+    AssertInfo(field_meta.get_data_type() == DataType::VECTOR_FLOAT,
+               fmt::format("field {} isn't a float vector field to refine",
+                           field_id.get()));
+    if (auto row_count_opt = loaded_row_count(); row_count_opt.has_value()) {
+        AssertInfo(
+            row_count_opt.value() == info.row_count,
+            fmt::format(
+                "field {} has different row count {} to other column's {}",
+                field_id.get(),
+                info.row_count,
+                row_count_opt.value()));
+    }
+
+    std::shared_ptr<Column> column =
+        MakeColumn(get_segment_id(), field_meta, info);
+    update_fields(
+        [&](Fields& fields) { fields.refine_columns_[field_id] = column; });
+}
+
+void
+SegmentSealedImpl::LoadFieldDataLazily(const LazyFieldDataInfo& info) {
+    SearchCacheInvalidator invalidator(*this);
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    AssertInfo(info.chunk_manager != nullptr, "remote chunk manager is null");
+    auto field_id = FieldId(info.field_id);
+    AssertInfo(!SystemProperty::Instance().IsSystem(field_id),
+               "system field can't be loaded lazily");
+    // pks are indexed at load time
+    AssertInfo(schema_->get_primary_field_id() != field_id,
+               "primary key field can't be loaded lazily");
+    auto& field_meta = (*schema_)[field_id];
+    auto data_type = field_meta.get_data_type();
+    AssertInfo(!datatype_is_variable(data_type) || datatype_is_string(data_type),
+               fmt::format("unsupported data type {}", datatype_name(data_type)));
+
+    update_fields([&](Fields& fields) {
+        if (fields.row_count_opt_.has_value()) {
+            AssertInfo(
+                fields.row_count_opt_.value() == info.row_count,
+                fmt::format(
+                    "field {} has different row count {} to other column's {}",
+                    field_id.get(),
+                    info.row_count,
+                    fields.row_count_opt_.value()));
+        }
+        // Don't allow raw data and index exist at the same time
+        AssertInfo(!get_bit(fields.index_ready_bitset_, field_id),
+                   "field data can't be loaded when indexing exists");
+        AssertInfo(!get_bit(fields.field_data_ready_bitset_, field_id),
+                   "field data has been loaded at " +
+                       std::to_string(field_id.get()));
+
+        {
+            std::lock_guard lazy_lck(lazy_mutex_);
+            auto& field = lazy_fields_[field_id];
+            field.info = info;
+            field.load_mutex = std::make_shared<std::mutex>();
+        }
+        set_bit(fields.field_data_ready_bitset_, field_id, true);
+        fields.row_count_opt_ = info.row_count;
+    });
+}
+
+int64_t
+SegmentSealedImpl::EvictLazyFieldData(int64_t memory_budget) {
+    // the spans of an evicted column may still be in use by the queries
+    // running, it's retired rather than freed
+    std::lock_guard lazy_lck(lazy_mutex_);
+    std::vector<LazyField*> resident;
+    int64_t resident_bytes = 0;
+    for (auto& [field_id, field] : lazy_fields_) {
+        if (field.column != nullptr) {
+            resident.push_back(&field);
+            resident_bytes += field.column->size();
+        }
+    }
+    std::sort(resident.begin(), resident.end(), [](auto a, auto b) {
+        return a->last_access < b->last_access;
+    });
+
+    int64_t freed_bytes = 0;
+    for (auto field : resident) {
+        if (resident_bytes - freed_bytes <= memory_budget) {
+            break;
+        }
+        freed_bytes += field->column->size();
+        rcu_.Retire(std::move(field->column));
+        field->zone_map = AnyZoneMap{};
+    }
+    return freed_bytes;
+}
+
+void
+SegmentSealedImpl::LoadJsonKeyIndex(FieldId field_id,
+                                    const std::vector<std::string>& pointers) {
+    SearchCacheInvalidator invalidator(*this);
+    auto& field_meta = (*schema_)[field_id];
+    AssertInfo(field_meta.get_data_type() == DataType::JSON,
+               "json key index can only be built on json field");
+    AssertInfo(HasFieldData(field_id),
+               "json field data must be loaded before its key index");
+
+    std::vector<std::unique_ptr<index::JsonKeyIndex>> indexes;
+    {
+        auto guard = rcu_.Read();
+        auto column =
+            dynamic_cast<const VariableColumn<Json>*>(get_column(field_id));
+        AssertInfo(column != nullptr, "json field isn't loaded as json column");
+        indexes = build_json_key_indexes(*column, pointers);
+    }
+
+    update_fields([&](Fields& fields) {
+        add_json_key_indexes(fields, field_id, std::move(indexes));
+    });
+}
+
+void
+SegmentSealedImpl::add_json_key_indexes(
+    Fields& fields,
+    FieldId field_id,
+    std::vector<std::unique_ptr<index::JsonKeyIndex>> indexes) {
+    if (indexes.empty()) {
+        return;
+    }
+    auto& field_indexes = fields.json_key_indexes_[field_id];
+    for (auto& index : indexes) {
+        auto pointer = index->pointer();
+        field_indexes[pointer] = std::move(index);
+    }
+}
+
+const index::JsonKeyIndex*
+SegmentSealedImpl::json_key_index(FieldId field_id,
+                                  const std::string& pointer) const {
+    auto guard = rcu_.Read();
+    auto& json_key_indexes = fields().json_key_indexes_;
+    auto it = json_key_indexes.find(field_id);
+    if (it == json_key_indexes.end()) {
+        return nullptr;
+    }
+    auto index = it->second.find(pointer);
+    return index == it->second.end() ? nullptr : index->second.get();
+}
+
+std::unique_ptr<ColumnBase>
+SegmentSealedImpl::fetch_lazy_column(const LazyFieldDataInfo& info) const {
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
+    auto& field_meta = (*schema_)[FieldId(info.field_id)];
+    auto is_variable = datatype_is_variable(field_meta.get_data_type());
+    FieldDataInfo data_info{info.field_id, {}, info.row_count};
+    auto& cache = ColumnCache::GetInstance();
+    // variable length columns need the element sizes of the binlogs
+    if (!is_variable && cache.Enabled()) {
+        data_info.cache_key = ColumnCache::Key(info.binlog_paths);
+        auto policy = DefaultMmapPolicy(field_meta);
+        auto size = field_meta.get_sizeof() * info.row_count;
+        auto map = cache.Map(data_info.cache_key, size, policy.populate);
+        if (map != nullptr) {
+            AdviseMap(map, size, policy);
+            return std::make_unique<Column>(
+                field_meta, map, info.row_count, true);
+        }
+    }
+
+    int64_t num_rows = 0;
+    for (auto& binlog_path : info.binlog_paths) {
+        auto codec = storage::DeserializeRemoteFileData(
+            info.chunk_manager.get(), binlog_path);
+        num_rows += codec->GetFieldData()->get_num_rows();
+        data_info.datas.push_back(codec->GetFieldData());
+    }
+    AssertInfo(num_rows == info.row_count,
+               fmt::format("field {} has {} rows in binlogs, expected {}",
+                           info.field_id,
+                           num_rows,
+                           info.row_count));
+    if (is_variable) {
+        return encode_string_column(MakeVariableColumn<std::string>(
+            get_segment_id(), field_meta, data_info));
+    }
+    return MakeColumn(get_segment_id(), field_meta, data_info);
+}
+
+const ColumnBase*
+SegmentSealedImpl::get_lazy_column(FieldId field_id) const {
+    std::unique_lock lck(lazy_mutex_);
+    auto it = lazy_fields_.find(field_id);
+    if (it == lazy_fields_.end()) {
+        return nullptr;
+    }
+    it->second.last_access = ++lazy_access_clock_;
+    if (it->second.column == nullptr) {
+        // fetch without blocking the accesses to other lazy fields, the
+        // field may be dropped meanwhile
+        auto load_mutex = it->second.load_mutex;
+        auto info = it->second.info;
+        auto registered = [&] {
+            it = lazy_fields_.find(field_id);
+            return it != lazy_fields_.end() &&
+                   it->second.load_mutex == load_mutex;
+        };
+        lck.unlock();
+        std::lock_guard load_lck(*load_mutex);
+        lck.lock();
+        if (!registered()) {
+            return nullptr;
+        }
+        if (it->second.column == nullptr) {
+            lck.unlock();
+            auto column = fetch_lazy_column(info);
+            auto zone_map = build_zone_map(
+                schema_->operator[](field_id).get_data_type(), column->span());
+            lck.lock();
+            if (!registered()) {
+                return nullptr;
+            }
+            it->second.column = std::move(column);
+            it->second.zone_map = std::move(zone_map);
+        }
+    }
+    return it->second.column.get();
+}
+
+const ColumnBase*
+SegmentSealedImpl::get_column(FieldId field_id) const {
+    auto& fields = this->fields();
+    if (auto it = fields.fixed_fields_.find(field_id);
+        it != fields.fixed_fields_.end()) {
+        return it->second.get();
+    }
+    if (auto it = fields.variable_fields_.find(field_id);
+        it != fields.variable_fields_.end()) {
+        return it->second.get();
+    }
+    auto column = get_lazy_column(field_id);
+    AssertInfo(column != nullptr,
+               "Field Data is not loaded: " + std::to_string(field_id.get()));
+    return column;
 }
 
 void
 SegmentSealedImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
     AssertInfo(info.row_count > 0, "The row count of deleted record is 0");
     AssertInfo(info.primary_keys, "Deleted primary keys is null");
     AssertInfo(info.timestamps, "Deleted timestamps is null");
@@ -294,11 +1132,10 @@ SegmentSealedImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
     auto timestamps = reinterpret_cast<const Timestamp*>(info.timestamps);
 
     // step 2: fill pks and timestamps
-    ssize_t n = deleted_record_.ack_responder_.GetAck();
     ssize_t divide_point = 0;
     // Truncate the overlapping prefix
-    if (n > 0) {
-        auto last = deleted_record_.timestamps_[n - 1];
+    if (deleted_record_.ack_responder_.GetAck() > 0) {
+        auto last = deleted_record_.last_timestamp();
         divide_point =
             std::lower_bound(timestamps, timestamps + size, last + 1) -
             timestamps;
@@ -311,28 +1148,251 @@ SegmentSealedImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
 
     size -= divide_point;
     auto reserved_begin = deleted_record_.reserved.fetch_add(size);
-    deleted_record_.pks_.set_data_raw(
-        reserved_begin, pks.data() + divide_point, size);
-    deleted_record_.timestamps_.set_data_raw(
-        reserved_begin, timestamps + divide_point, size);
-    deleted_record_.ack_responder_.AddSegment(reserved_begin,
-                                              reserved_begin + size);
+    deleted_record_.push(reserved_begin,
+                         pks.data() + divide_point,
+                         timestamps + divide_point,
+                         size);
+}
+
+void
+SegmentSealedImpl::LoadPkStats(const uint8_t* data, int64_t size) {
+    auto stats = DeserializePkStats(data, size);
+    auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
+    AssertInfo(field_id.get() != -1, "Primary key is -1");
+    if (stats.min_pk.has_value()) {
+        auto is_int64 = std::holds_alternative<int64_t>(*stats.min_pk);
+        AssertInfo(is_int64 == (schema_->operator[](field_id).get_data_type() ==
+                                DataType::INT64),
+                   "the pk stats are of another pk type");
+    }
+    insert_record_.load_pk_stats(std::move(stats));
+}
+
+void
+SegmentSealedImpl::LoadDeletedRecordFromBinlogs(
+    const std::vector<std::string>& paths,
+    storage::RemoteChunkManager* chunk_manager) {
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
+    AssertInfo(chunk_manager != nullptr, "chunk manager is null");
+    auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
+    AssertInfo(field_id.get() != -1, "Primary key is -1");
+    auto data_type = schema_->operator[](field_id).get_data_type();
+
+    // step 1: decode the delta logs in parallel
+    std::vector<std::vector<PkType>> log_pks(paths.size());
+    std::vector<std::vector<Timestamp>> log_timestamps(paths.size());
+    auto& pool = ThreadPool::GetInstance();
+    pool.ParallelFor(paths.size(), pool.GetThreadNum(), [&](int64_t i) {
+        auto codec =
+            storage::DeserializeRemoteFileData(chunk_manager, paths[i]);
+        ParseDeleteLogs(
+            log_pks[i], log_timestamps[i], data_type, *codec->GetFieldData());
+    });
+    std::vector<PkType> all_pks;
+    std::vector<Timestamp> all_timestamps;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        std::move(log_pks[i].begin(),
+                  log_pks[i].end(),
+                  std::back_inserter(all_pks));
+        all_timestamps.insert(all_timestamps.end(),
+                              log_timestamps[i].begin(),
+                              log_timestamps[i].end());
+        log_pks[i] = {};
+    }
+
+    // step 2: order them by timestamp, the ones loaded before are dropped
+    auto last = deleted_record_.ack_responder_.GetAck() > 0
+                    ? deleted_record_.last_timestamp()
+                    : Timestamp(0);
+    std::vector<int64_t> order;
+    order.reserve(all_timestamps.size());
+    for (int64_t i = 0; i < int64_t(all_timestamps.size()); ++i) {
+        if (last == 0 || all_timestamps[i] > last) {
+            order.push_back(i);
+        }
+    }
+    if (order.empty()) {
+        return;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return all_timestamps[a] < all_timestamps[b];
+    });
+    int64_t size = order.size();
+    std::vector<PkType> pks(size);
+    std::vector<Timestamp> timestamps(size);
+    for (int64_t i = 0; i < size; ++i) {
+        pks[i] = std::move(all_pks[order[i]]);
+        timestamps[i] = all_timestamps[order[i]];
+    }
+    all_pks = {};
+    all_timestamps = {};
+
+    auto reserved_begin = deleted_record_.reserved.fetch_add(size);
+    deleted_record_.push(
+        reserved_begin, pks.data(), timestamps.data(), size);
+
+    // step 3: fill the bitmap of all the deletes at once, if the cached one
+    // is of all the deletes before them, so queries at a newer timestamp
+    // don't look them up one by one
+    auto row_count = get_row_count();
+    if (!is_system_field_ready() || insert_record_.empty_pks() ||
+        deleted_record_.ack_responder_.GetAck() != reserved_begin + size) {
+        return;
+    }
+    int64_t old_del_barrier = 0;
+    bool hit_cache = false;
+    auto entry = deleted_record_.clone_lru_entry(
+        row_count, reserved_begin + size, old_del_barrier, hit_cache);
+    if (hit_cache || old_del_barrier != reserved_begin) {
+        return;
+    }
+    // the latest delete of every pk, sorted by pk for the merge with the
+    // sorted pks of the segment
+    std::vector<int64_t> latest(size);
+    std::iota(latest.begin(), latest.end(), 0);
+    std::sort(latest.begin(), latest.end(), [&](int64_t a, int64_t b) {
+        return pks[a] < pks[b] || (pks[a] == pks[b] && a > b);
+    });
+    latest.erase(std::unique(latest.begin(),
+                             latest.end(),
+                             [&](int64_t a, int64_t b) {
+                                 return pks[a] == pks[b];
+                             }),
+                 latest.end());
+    std::vector<PkType> probes(latest.size());
+    for (size_t i = 0; i < latest.size(); ++i) {
+        probes[i] = std::move(pks[latest[i]]);
+    }
+    std::vector<OffsetMap::PkOffset> pk_offsets;
+    insert_record_.search_pks(
+        probes.data(), probes.size(), row_count, pk_offsets);
+    auto& bitmap = entry->bitmap;
+    for (auto& [pk_index, offset] : pk_offsets) {
+        // an insert after the delete of its pk is not deleted
+        if (insert_record_.timestamp_at(offset) >=
+            timestamps[latest[pk_index]]) {
+            bitmap.reset(offset);
+        } else {
+            bitmap.set(offset);
+        }
+    }
+    deleted_record_.insert_lru_entry(std::move(entry));
+}
+
+void
+SegmentSealedImpl::LoadFromGrowing(const SegmentGrowing& growing) {
+    numa::ScopedMemoryPolicy numa_policy(numa_node_);
+    SegmentArena::Scope arena_scope(arena_.get());
+    auto source = dynamic_cast<const SegmentGrowingImpl*>(&growing);
+    AssertInfo(source != nullptr, "can't load from this growing segment");
+    AssertInfo(get_row_count() == 0 && deleted_record_.reserved.load() == 0,
+               "load from a growing segment into a loaded segment");
+    auto& insert_record = source->get_insert_record();
+    auto& schema = source->get_schema();
+    // the rows acked so far, the ones inserted meanwhile are left out
+    auto row_count = source->get_row_count();
+    AssertInfo(row_count > 0, "The row count of the growing segment is 0");
+
+    // the pks loaded below don't rebuild the stats
+    auto stats = insert_record.serialize_pk_stats(row_count);
+    LoadPkStats(stats.data(), stats.size());
+
+    std::vector<FieldId> field_ids{RowFieldID, TimestampFieldID};
+    for (auto& [field_id, field_meta] : schema.get_fields()) {
+        field_ids.push_back(field_id);
+    }
+    // the chunks are copied into the columns, growing chunks are smaller
+    // and kept apart, they can't be taken as the chunk of a column
+    auto& pool = ThreadPool::GetInstance();
+    pool.ParallelFor(field_ids.size(), pool.GetThreadNum(), [&](int64_t i) {
+        auto field_id = field_ids[i];
+        const VectorBase* vec = nullptr;
+        auto data_type = DataType::INT64;
+        int64_t dim = 1;
+        // the values of a row in the chunk data
+        int64_t row_elements = 1;
+        if (field_id == RowFieldID) {
+            vec = &insert_record.row_ids_;
+        } else if (field_id == TimestampFieldID) {
+            vec = &insert_record.timestamps_;
+        } else {
+            auto& field_meta = schema[field_id];
+            data_type = field_meta.get_data_type();
+            if (field_meta.is_vector()) {
+                dim = field_meta.get_dim();
+                row_elements =
+                    data_type == DataType::VECTOR_BINARY ? dim / 8 : dim;
+            }
+            vec = insert_record.get_field_data_base(field_id);
+            AssertInfo(
+                dynamic_cast<const ConcurrentFloat16Vector*>(vec) == nullptr,
+                fmt::format("the vectors of field {} are kept as float16, "
+                            "they can't be loaded as they were inserted",
+                            field_id.get()));
+        }
+        std::vector<storage::FieldDataPtr> datas;
+        auto size_per_chunk = vec->get_size_per_chunk();
+        for (int64_t begin = 0; begin < row_count; begin += size_per_chunk) {
+            auto rows = std::min(size_per_chunk, row_count - begin);
+            auto data =
+                storage::FieldDataFactory::GetInstance().CreateFieldData(
+                    data_type, dim);
+            auto chunk = vec->get_chunk_data(begin / size_per_chunk);
+            if (data_type == DataType::VARCHAR ||
+                data_type == DataType::STRING) {
+                // growing chunks keep views of the strings
+                auto views = static_cast<const std::string_view*>(chunk);
+                std::vector<std::string> strs(views, views + rows);
+                data->FillFieldData(strs.data(), rows);
+            } else if (data_type == DataType::JSON) {
+                // and of the json documents, loaded from their bytes
+                auto jsons = static_cast<const Json*>(chunk);
+                std::vector<std::string> docs;
+                docs.reserve(rows);
+                for (int64_t j = 0; j < rows; ++j) {
+                    docs.emplace_back(jsons[j].data());
+                }
+                data->FillFieldData(docs.data(), rows);
+            } else {
+                data->FillFieldData(chunk, rows * row_elements);
+            }
+            datas.push_back(std::move(data));
+        }
+        LoadFieldData(FieldDataInfo{field_id.get(), datas, row_count});
+    });
+
+    deleted_record_.copy_from(source->get_deleted_record());
+}
+
+int64_t
+SegmentSealedImpl::CompactDeletedRecord(Timestamp oldest_query_ts) {
+    // the deletes can't be resolved before the pks are loaded
+    auto row_count = get_row_count();
+    if (!is_system_field_ready() || insert_record_.empty_pks()) {
+        return deleted_record_.compacted_count();
+    }
+    return compact_deleted_record(
+        deleted_record_, insert_record_, row_count, oldest_query_ts);
 }
 
 // internal API: support scalar index only
 int64_t
 SegmentSealedImpl::num_chunk_index(FieldId field_id) const {
+    auto guard = rcu_.Read();
     auto& field_meta = schema_->operator[](field_id);
+    auto& fields = this->fields();
     if (field_meta.is_vector()) {
-        return int64_t(vector_indexings_.is_ready(field_id));
+        return int64_t(fields.vector_indexings_.is_ready(field_id));
     }
 
-    return scalar_indexings_.count(field_id);
+    return fields.scalar_indexings_.count(field_id);
 }
 
 int64_t
 SegmentSealedImpl::num_chunk_data(FieldId field_id) const {
-    return get_bit(field_data_ready_bitset_, field_id) ? 1 : 0;
+    auto guard = rcu_.Read();
+    return get_bit(fields().field_data_ready_bitset_, field_id) ? 1 : 0;
 }
 
 int64_t
@@ -347,47 +1407,177 @@ SegmentSealedImpl::size_per_chunk() const {
 
 SpanBase
 SegmentSealedImpl::chunk_data_impl(FieldId field_id, int64_t chunk_id) const {
-    std::shared_lock lck(mutex_);
-    AssertInfo(get_bit(field_data_ready_bitset_, field_id),
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    AssertInfo(get_bit(fields.field_data_ready_bitset_, field_id),
                "Can't get bitset element at " + std::to_string(field_id.get()));
-    auto& field_meta = schema_->operator[](field_id);
-    auto element_sizeof = field_meta.get_sizeof();
-    if (auto it = fixed_fields_.find(field_id); it != fixed_fields_.end()) {
-        auto& field_data = it->second;
-        return field_data.span();
+    if (auto it = fields.fixed_fields_.find(field_id);
+        it != fields.fixed_fields_.end()) {
+        return it->second->span();
+    }
+    if (auto it = fields.variable_fields_.find(field_id);
+        it != fields.variable_fields_.end()) {
+        return it->second->span();
+    }
+    auto column = get_lazy_column(field_id);
+    AssertInfo(column != nullptr,
+               "Field Data is not loaded: " + std::to_string(field_id.get()));
+    return column->span();
+}
+
+AnyZoneMap
+SegmentSealedImpl::chunk_zone_map_impl(FieldId field_id,
+                                       int64_t chunk_id) const {
+    auto guard = rcu_.Read();
+    auto& zone_maps = fields().zone_maps_;
+    if (auto it = zone_maps.find(field_id); it != zone_maps.end()) {
+        return it->second;
     }
-    if (auto it = variable_fields_.find(field_id);
-        it != variable_fields_.end()) {
-        auto& field = it->second;
-        return field->span();
+    // a lazy field which isn't fetched yet has no zone map
+    std::lock_guard lazy_lck(lazy_mutex_);
+    if (auto it = lazy_fields_.find(field_id); it != lazy_fields_.end()) {
+        return it->second.zone_map;
     }
-    auto field_data = insert_record_.get_field_data_base(field_id);
-    AssertInfo(field_data->num_chunk() == 1,
-               "num chunk not equal to 1 for sealed segment");
-    return field_data->get_span_base(0);
+    return {};
+}
+
+const PartitionKeyStats*
+SegmentSealedImpl::partition_key_stats(FieldId field_id) const {
+    auto guard = rcu_.Read();
+    auto& partition_key_stats = fields().partition_key_stats_;
+    auto it = partition_key_stats.find(field_id);
+    return it == partition_key_stats.end() ? nullptr : it->second.get();
+}
+
+FieldSketchPtr
+SegmentSealedImpl::field_sketch(FieldId field_id) const {
+    auto guard = rcu_.Read();
+    auto& field_sketches = fields().field_sketches_;
+    auto it = field_sketches.find(field_id);
+    return it == field_sketches.end() ? nullptr : it->second;
+}
+
+bool
+SegmentSealedImpl::is_sorted_by(FieldId field_id) const {
+    auto guard = rcu_.Read();
+    return fields().sorted_fields_.count(field_id) > 0;
+}
+
+const StringDictionary*
+SegmentSealedImpl::chunk_string_dictionary_impl(FieldId field_id,
+                                                int64_t chunk_id) const {
+    // lazy fields may be evicted, only the loaded columns are encoded
+    auto guard = rcu_.Read();
+    auto& variable_fields = fields().variable_fields_;
+    if (auto it = variable_fields.find(field_id);
+        it != variable_fields.end()) {
+        if (auto column = dynamic_cast<const VariableColumn<std::string>*>(
+                it->second.get())) {
+            return column->dictionary();
+        }
+    }
+    return nullptr;
 }
 
 const index::IndexBase*
 SegmentSealedImpl::chunk_index_impl(FieldId field_id, int64_t chunk_id) const {
-    AssertInfo(scalar_indexings_.find(field_id) != scalar_indexings_.end(),
+    auto guard = rcu_.Read();
+    auto& scalar_indexings = fields().scalar_indexings_;
+    AssertInfo(scalar_indexings.find(field_id) != scalar_indexings.end(),
                "Cannot find scalar_indexing with field_id: " +
                    std::to_string(field_id.get()));
-    auto ptr = scalar_indexings_.at(field_id).get();
+    auto ptr = scalar_indexings.at(field_id).get();
     return ptr;
 }
 
 int64_t
 SegmentSealedImpl::GetMemoryUsageInBytes() const {
-    // TODO: add estimate for index
-    std::shared_lock lck(mutex_);
-    auto row_count = row_count_opt_.value_or(0);
-    return schema_->get_total_sizeof() * row_count;
+    return GetMemoryUsage().resident_bytes();
+}
+
+MemoryUsage
+SegmentSealedImpl::GetMemoryUsage() const {
+    MemoryUsage usage;
+    auto add_column = [&](FieldId field_id, const ColumnBase& column) {
+        auto& field = usage.fields[field_id.get()];
+        field.raw += column.resident_bytes();
+        field.mmap_file += column.file_bytes();
+    };
+    // an index which can't tell its size is estimated from its raw data
+    auto index_bytes = [&](FieldId field_id, index::IndexBase& index) {
+        auto bytes = index.ByteSize();
+        return bytes > 0 ? bytes
+                         : index.Count() * (*schema_)[field_id].get_sizeof();
+    };
+
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    for (auto& [field_id, column] : fields.fixed_fields_) {
+        add_column(field_id, *column);
+    }
+    for (auto& [field_id, column] : fields.variable_fields_) {
+        add_column(field_id, *column);
+    }
+    for (auto& [field_id, column] : fields.refine_columns_) {
+        add_column(field_id, *column);
+    }
+    if (fields.row_ids_ != nullptr) {
+        add_column(RowFieldID, *fields.row_ids_);
+    }
+    {
+        std::lock_guard lazy_lck(lazy_mutex_);
+        for (auto& [field_id, field] : lazy_fields_) {
+            if (field.column != nullptr) {
+                add_column(field_id, *field.column);
+            }
+        }
+    }
+    for (auto& [field_id, index] : fields.scalar_indexings_) {
+        usage.fields[field_id.get()].index += index_bytes(field_id, *index);
+    }
+    auto& vector_indexings = fields.vector_indexings_;
+    for (auto& [field_id, field_meta] : *schema_) {
+        if (field_meta.is_vector() && vector_indexings.is_ready(field_id)) {
+            auto& index =
+                *vector_indexings.get_field_indexing(field_id)->indexing_;
+            usage.fields[field_id.get()].index += index_bytes(field_id, index);
+        }
+    }
+    for (auto& [field_id, zone_map] : fields.zone_maps_) {
+        usage.fields[field_id.get()].stats += sizeof(zone_map);
+    }
+    for (auto& [field_id, norms] : fields.vector_norms_) {
+        usage.fields[field_id.get()].stats += norms->size() * sizeof(float);
+    }
+    for (auto& [field_id, sketches] : fields.vector_sketches_) {
+        usage.fields[field_id.get()].stats += sketches->size();
+    }
+    for (auto& [field_id, stats] : fields.partition_key_stats_) {
+        usage.fields[field_id.get()].stats += stats->memory_bytes();
+    }
+    for (auto& [field_id, sketch] : fields.field_sketches_) {
+        usage.fields[field_id.get()].stats += sketch->memory_bytes();
+    }
+    for (auto& [field_id, indexes] : fields.json_key_indexes_) {
+        for (auto& [pointer, index] : indexes) {
+            usage.fields[field_id.get()].stats += index->Size();
+        }
+    }
+
+    usage.system = insert_record_.packed_timestamps_.memory_bytes() +
+                   insert_record_.timestamp_index_.memory_bytes();
+    usage.pk_map = insert_record_.pk_memory_bytes();
+    usage.deletes = deleted_record_.memory_bytes();
+    usage.caches = expr_result_cache_.CachedBytes();
+    if (arena_ != nullptr) {
+        usage.arena = arena_->allocated_bytes();
+    }
+    return usage;
 }
 
 int64_t
 SegmentSealedImpl::get_row_count() const {
-    std::shared_lock lck(mutex_);
-    return row_count_opt_.value_or(0);
+    return loaded_row_count().value_or(0);
 }
 
 int64_t
@@ -401,10 +1591,45 @@ SegmentSealedImpl::get_schema() const {
     return *schema_;
 }
 
+BitsetType
+SegmentSealedImpl::exec_predicate(query::Expr& expr,
+                                  const std::string& key,
+                                  int64_t active_count,
+                                  Timestamp timestamp,
+                                  QueryProfile* profile) const {
+    auto& config = SegcoreConfig::default_config();
+    auto capacity = config.get_expr_result_cache_size();
+    if (capacity <= 0 || key.empty()) {
+        return SegmentInternalInterface::exec_predicate(
+            expr, key, active_count, timestamp, profile);
+    }
+    // a cached result is shared by the queries of any timestamp, so it's
+    // evaluated at the latest one: a pk term would drop the rows newer than
+    // the query, the timestamp and delete masks are applied per query
+    auto generation = search_cache_generation_.load();
+    if (auto cached = expr_result_cache_.Get(generation, key, active_count)) {
+        if (profile != nullptr) {
+            profile->predicate_cached = true;
+        }
+        return std::move(cached.value());
+    }
+    auto begin = std::chrono::steady_clock::now();
+    auto result = SegmentInternalInterface::exec_predicate(
+        expr, key, active_count, MAX_TIMESTAMP, profile);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+    if (elapsed >= config.get_expr_result_cache_min_eval_us()) {
+        expr_result_cache_.Put(generation, key, result, capacity);
+    }
+    return result;
+}
+
 void
 SegmentSealedImpl::mask_with_delete(BitsetType& bitset,
                                     int64_t ins_barrier,
                                     Timestamp timestamp) const {
+    mask_with_delete_buffer(bitset, ins_barrier, timestamp, insert_record_);
     auto del_barrier = get_barrier(get_deleted_record(), timestamp);
     if (del_barrier == 0) {
         return;
@@ -412,13 +1637,10 @@ SegmentSealedImpl::mask_with_delete(BitsetType& bitset,
 
     auto bitmap_holder = get_deleted_bitmap(
         del_barrier, ins_barrier, deleted_record_, insert_record_, timestamp);
-    if (!bitmap_holder || !bitmap_holder->bitmap_ptr) {
+    if (!bitmap_holder) {
         return;
     }
-    auto& delete_bitset = *bitmap_holder->bitmap_ptr;
-    AssertInfo(delete_bitset.size() == bitset.size(),
-               "Deleted bitmap size not equal to filtered bitmap size");
-    bitset |= delete_bitset;
+    bitmap_holder->bitmap.or_to(bitset);
 }
 
 void
@@ -434,12 +1656,20 @@ SegmentSealedImpl::vector_search(SearchInfo& search_info,
 
     AssertInfo(field_meta.is_vector(),
                "The meta type of vector field is not vector type");
-    if (get_bit(index_ready_bitset_, field_id)) {
-        AssertInfo(vector_indexings_.is_ready(field_id),
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    if (get_bit(fields.index_ready_bitset_, field_id) &&
+        !small_gpu_search(field_id, query_count)) {
+        AssertInfo(fields.vector_indexings_.is_ready(field_id),
                    "vector indexes isn't ready for field " +
                        std::to_string(field_id.get()));
+        if (search_info.refine_factor_ > 1 &&
+            refine_search(
+                search_info, query_data, query_count, bitset, output)) {
+            return;
+        }
         query::SearchOnSealedIndex(*schema_,
-                                   vector_indexings_,
+                                   fields.vector_indexings_,
                                    search_info,
                                    query_data,
                                    query_count,
@@ -447,13 +1677,22 @@ SegmentSealedImpl::vector_search(SearchInfo& search_info,
                                    output);
     } else {
         AssertInfo(
-            get_bit(field_data_ready_bitset_, field_id),
+            get_bit(fields.field_data_ready_bitset_, field_id),
             "Field Data is not loaded: " + std::to_string(field_id.get()));
-        AssertInfo(row_count_opt_.has_value(), "Can't get row count value");
-        auto row_count = row_count_opt_.value();
-        auto& vec_data = fixed_fields_.at(field_id);
+        AssertInfo(fields.row_count_opt_.has_value(),
+                   "Can't get row count value");
+        auto row_count = fields.row_count_opt_.value();
+        auto vec_data = get_column(field_id);
+        auto norms = fields.vector_norms_.find(field_id);
+        auto sketches = fields.vector_sketches_.find(field_id);
         query::SearchOnSealed(*schema_,
-                              vec_data.data(),
+                              vec_data->data(),
+                              norms == fields.vector_norms_.end()
+                                  ? nullptr
+                                  : norms->second->data(),
+                              sketches == fields.vector_sketches_.end()
+                                  ? nullptr
+                                  : sketches->second->data(),
                               search_info,
                               query_data,
                               query_count,
@@ -463,6 +1702,145 @@ SegmentSealedImpl::vector_search(SearchInfo& search_info,
     }
 }
 
+bool
+SegmentSealedImpl::small_gpu_search(FieldId field_id,
+                                    int64_t query_count) const {
+    auto min_nq = SegcoreConfig::default_config().get_gpu_search_min_nq();
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    if (query_count >= min_nq ||
+        !get_bit(fields.field_data_ready_bitset_, field_id)) {
+        return false;
+    }
+    auto field_indexing = fields.vector_indexings_.get_field_indexing(field_id);
+    auto vec_index =
+        dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
+    return vec_index != nullptr &&
+           index::is_in_gpu_list(vec_index->GetIndexType());
+}
+
+bool
+SegmentSealedImpl::refine_search(const SearchInfo& search_info,
+                                 const void* query_data,
+                                 int64_t query_count,
+                                 const BitsetView& bitset,
+                                 SearchResult& output) const {
+    auto field_id = search_info.field_id_;
+    auto& field_meta = (*schema_)[field_id];
+    if (field_meta.get_data_type() != DataType::VECTOR_FLOAT ||
+        GetSearchParams(search_info)->is_range_search()) {
+        return false;
+    }
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    auto refine_column = fields.refine_columns_.find(field_id);
+    auto field_indexing = fields.vector_indexings_.get_field_indexing(field_id);
+    auto vec_index =
+        dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
+    if (refine_column == fields.refine_columns_.end() &&
+        !vec_index->HasRawData()) {
+        return false;
+    }
+
+    SearchInfo fetch_info = search_info;
+    fetch_info.topk_ = search_info.topk_ * search_info.refine_factor_;
+    fetch_info.parsed_params_ = search_info.refine_params_;
+    fetch_info.refine_factor_ = 1;
+    query::SearchOnSealedIndex(*schema_,
+                               fields.vector_indexings_,
+                               fetch_info,
+                               query_data,
+                               query_count,
+                               bitset,
+                               output);
+
+    CheckCancelled();
+    // the invalid hits gather the first row, the rerank skips them
+    std::vector<int64_t> seg_offsets(output.seg_offsets_);
+    for (auto& offset : seg_offsets) {
+        if (offset == INVALID_SEG_OFFSET) {
+            offset = 0;
+        }
+    }
+    auto count = static_cast<int64_t>(seg_offsets.size());
+    std::vector<uint8_t> gathered;
+    if (refine_column != fields.refine_columns_.end()) {
+        gathered.resize(count * field_meta.get_sizeof());
+        bulk_subscript_impl(field_meta.get_sizeof(),
+                            refine_column->second.get(),
+                            seg_offsets.data(),
+                            count,
+                            gathered.data());
+    } else {
+        gathered =
+            vec_index->GetVector(GenIdsDataset(count, seg_offsets.data()));
+    }
+    query::RefineSearchResult(*schema_,
+                              search_info,
+                              query_data,
+                              query_count,
+                              gathered.data(),
+                              output);
+    return true;
+}
+
+bool
+SegmentSealedImpl::vector_search_offsets(
+    SearchInfo& search_info,
+    const void* query_data,
+    int64_t query_count,
+    const std::vector<int64_t>& seg_offsets,
+    SearchResult& output) const {
+    AssertInfo(is_system_field_ready(), "System field is not ready");
+    auto field_id = search_info.field_id_;
+    auto& field_meta = schema_->operator[](field_id);
+    auto count = static_cast<int64_t>(seg_offsets.size());
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    bool has_index = get_bit(fields.index_ready_bitset_, field_id);
+    // the filtered search of an index pays off until its bitset gets very
+    // sparse, graph indexes like hnsw and diskann degrade the most
+    auto& config = SegcoreConfig::default_config();
+    auto row_count = fields.row_count_opt_.value_or(0);
+    if (has_index && count > config.get_brute_force_threshold() &&
+        count > config.get_brute_force_density() * row_count) {
+        return false;
+    }
+
+    std::vector<uint8_t> gathered;
+    if (get_bit(fields.field_data_ready_bitset_, field_id)) {
+        gathered.resize(count * field_meta.get_sizeof());
+        bulk_subscript_impl(field_meta.get_sizeof(),
+                            get_column(field_id),
+                            seg_offsets.data(),
+                            count,
+                            gathered.data());
+    } else {
+        // the raw data is dropped once the index is loaded, the vectors come
+        // from the index if it keeps them
+        AssertInfo(has_index && fields.vector_indexings_.is_ready(field_id),
+                   "vector index is not ready");
+        auto field_indexing =
+            fields.vector_indexings_.get_field_indexing(field_id);
+        auto vec_index =
+            dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
+        if (!vec_index->HasRawData()) {
+            return false;
+        }
+        gathered =
+            vec_index->GetVector(GenIdsDataset(count, seg_offsets.data()));
+    }
+    query::SearchOnOffsets(*schema_,
+                           gathered.data(),
+                           seg_offsets.data(),
+                           count,
+                           search_info,
+                           query_data,
+                           query_count,
+                           output);
+    return true;
+}
+
 std::unique_ptr<DataArray>
 SegmentSealedImpl::get_vector(FieldId field_id,
                               const int64_t* ids,
@@ -470,10 +1848,13 @@ SegmentSealedImpl::get_vector(FieldId field_id,
     auto& filed_meta = schema_->operator[](field_id);
     AssertInfo(filed_meta.is_vector(), "vector field is not vector type");
 
-    if (get_bit(index_ready_bitset_, field_id)) {
-        AssertInfo(vector_indexings_.is_ready(field_id),
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    if (get_bit(fields.index_ready_bitset_, field_id)) {
+        AssertInfo(fields.vector_indexings_.is_ready(field_id),
                    "vector index is not ready");
-        auto field_indexing = vector_indexings_.get_field_indexing(field_id);
+        auto field_indexing =
+            fields.vector_indexings_.get_field_indexing(field_id);
         auto vec_index =
             dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
 
@@ -494,29 +1875,48 @@ SegmentSealedImpl::get_vector(FieldId field_id,
 
 void
 SegmentSealedImpl::DropFieldData(const FieldId field_id) {
+    SearchCacheInvalidator invalidator(*this);
     if (SystemProperty::Instance().IsSystem(field_id)) {
         auto system_field_type =
             SystemProperty::Instance().GetSystemFieldType(field_id);
 
         std::unique_lock lck(mutex_);
         --system_ready_count_;
-        if (system_field_type == SystemFieldType::RowId) {
-            insert_record_.row_ids_.clear();
-        } else if (system_field_type == SystemFieldType::Timestamp) {
-            insert_record_.timestamps_.clear();
+        if (system_field_type == SystemFieldType::Timestamp) {
+            insert_record_.packed_timestamps_.clear();
         }
         lck.unlock();
+        if (system_field_type == SystemFieldType::RowId) {
+            update_fields([&](Fields& fields) { fields.row_ids_ = nullptr; });
+        }
     } else {
-        auto& field_meta = schema_->operator[](field_id);
-        std::unique_lock lck(mutex_);
-        set_bit(field_data_ready_bitset_, field_id, false);
-        insert_record_.drop_field_data(field_id);
-        lck.unlock();
+        update_fields([&](Fields& fields) {
+            set_bit(fields.field_data_ready_bitset_, field_id, false);
+            fields.fixed_fields_.erase(field_id);
+            fields.variable_fields_.erase(field_id);
+            fields.zone_maps_.erase(field_id);
+            fields.vector_norms_.erase(field_id);
+            fields.vector_sketches_.erase(field_id);
+            fields.refine_columns_.erase(field_id);
+            fields.partition_key_stats_.erase(field_id);
+            fields.field_sketches_.erase(field_id);
+            fields.sorted_fields_.erase(field_id);
+            fields.json_key_indexes_.erase(field_id);
+            std::lock_guard lazy_lck(lazy_mutex_);
+            if (auto it = lazy_fields_.find(field_id);
+                it != lazy_fields_.end()) {
+                if (it->second.column != nullptr) {
+                    rcu_.Retire(std::move(it->second.column));
+                }
+                lazy_fields_.erase(it);
+            }
+        });
     }
 }
 
 void
 SegmentSealedImpl::DropIndex(const FieldId field_id) {
+    SearchCacheInvalidator invalidator(*this);
     AssertInfo(!SystemProperty::Instance().IsSystem(field_id),
                "Field id:" + std::to_string(field_id.get()) +
                    " isn't one of system type when drop index");
@@ -525,9 +1925,10 @@ SegmentSealedImpl::DropIndex(const FieldId field_id) {
                "Field meta of offset:" + std::to_string(field_id.get()) +
                    " is not vector type");
 
-    std::unique_lock lck(mutex_);
-    vector_indexings_.drop_field_indexing(field_id);
-    set_bit(index_ready_bitset_, field_id, false);
+    update_fields([&](Fields& fields) {
+        fields.vector_indexings_.drop_field_indexing(field_id);
+        set_bit(fields.index_ready_bitset_, field_id, false);
+    });
 }
 
 void
@@ -544,7 +1945,10 @@ SegmentSealedImpl::check_search(const query::Plan* plan) const {
     }
 
     auto& request_fields = plan->extra_info_opt_.value().involved_fields_;
-    auto field_ready_bitset = field_data_ready_bitset_ | index_ready_bitset_;
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
+    auto field_ready_bitset =
+        fields.field_data_ready_bitset_ | fields.index_ready_bitset_;
     AssertInfo(request_fields.size() == field_ready_bitset.size(),
                "Request fields size not equal to field ready bitset size when "
                "check search");
@@ -561,11 +1965,97 @@ SegmentSealedImpl::check_search(const query::Plan* plan) const {
 
 SegmentSealedImpl::SegmentSealedImpl(SchemaPtr schema, int64_t segment_id)
     : schema_(schema),
-      insert_record_(*schema, MAX_ROW_COUNT),
-      field_data_ready_bitset_(schema->size()),
-      index_ready_bitset_(schema->size()),
-      scalar_indexings_(schema->size()),
+      insert_record_(*schema,
+                     MAX_ROW_COUNT,
+                     nullptr,
+                     SegcoreConfig::default_config().get_enable_pk_filter()),
       id_(segment_id) {
+    auto fields = std::make_unique<Fields>();
+    fields->field_data_ready_bitset_ = BitsetType(schema->size());
+    fields->index_ready_bitset_ = BitsetType(schema->size());
+    fields_ = fields.release();
+    if (SegcoreConfig::default_config().get_segment_arena()) {
+        arena_ = SegmentArena::Create();
+    }
+    // spread the segments over the nodes, the C API may move it before
+    // loading
+    auto num_nodes = numa::NumNodes();
+    if (SegcoreConfig::default_config().get_numa_aware() && num_nodes > 1 &&
+        segment_id >= 0) {
+        numa_node_ = segment_id % num_nodes;
+    }
+}
+
+void
+SegmentSealedImpl::set_numa_node(int node) {
+    AssertInfo(node >= -1 && node < numa::NumNodes(),
+               fmt::format("invalid numa node {}, the host has {} nodes",
+                           node,
+                           numa::NumNodes()));
+    numa_node_ = node;
+}
+
+SegmentSealedImpl::~SegmentSealedImpl() {
+    auto& cache = SearchResultCache::GetInstance();
+    if (cache.Enabled()) {
+        cache.Erase(search_cache_uid_);
+    }
+    delete fields_.load();
+}
+
+void
+SegmentSealedImpl::update_fields(const std::function<void(Fields&)>& update) {
+    std::lock_guard lck(load_mutex_);
+    auto updated = std::make_unique<Fields>(fields());
+    update(*updated);
+    std::shared_ptr<const Fields> replaced(fields_.exchange(updated.release()));
+    rcu_.Retire(std::move(replaced));
+}
+
+std::unique_ptr<SearchResult>
+SegmentSealedImpl::Search(const query::Plan* plan,
+                          const query::PlaceholderGroup* placeholder_group,
+                          Timestamp timestamp) const {
+    auto& cache = SearchResultCache::GetInstance();
+    // a profile is of the search which ran
+    if (!cache.Enabled() || plan->plan_node_->search_info_.profile_) {
+        return SegmentInternalInterface::Search(
+            plan, placeholder_group, timestamp);
+    }
+    // read before searching, a load done meanwhile bumps it only after it
+    // changed the segment, so a stale result never gets the new generation
+    SearchResultCache::Key key{
+        search_cache_uid_, search_cache_generation_.load(), 0, -1, 0, {}};
+    {
+        std::shared_lock lck(mutex_);
+        auto guard = rcu_.Read();
+        // a query which doesn't see all the rows depends on its timestamp,
+        // be they newer than it or expired by the ttl
+        auto row_count = fields().row_count_opt_.value_or(0);
+        auto& timestamp_index = insert_record_.timestamp_index_;
+        if (is_system_field_ready() && row_count > 0 &&
+            timestamp_index.get_active_range(timestamp) ==
+                std::pair<int64_t, int64_t>(row_count, row_count) &&
+            expire_timestamp(timestamp) <= timestamp_index.min_timestamp()) {
+            key.request =
+                SearchResultCache::RequestKey(plan, placeholder_group);
+            key.del_barrier = get_barrier(deleted_record_, timestamp);
+            std::tie(key.buffer_epoch, key.buffer_barrier) =
+                get_delete_buffer_barrier(timestamp);
+        }
+    }
+    if (key.request.empty()) {
+        return SegmentInternalInterface::Search(
+            plan, placeholder_group, timestamp);
+    }
+    if (auto cached = cache.Get(key)) {
+        cached->segment_ = (void*)this;
+        return cached;
+    }
+    auto results =
+        SegmentInternalInterface::Search(plan, placeholder_group, timestamp);
+    cache.Put(std::move(key), *results);
+    return results;
 }
 
 void
@@ -577,81 +2067,98 @@ SegmentSealedImpl::bulk_subscript(SystemFieldType system_type,
                "System field isn't ready when do bulk_insert");
     switch (system_type) {
         case SystemFieldType::Timestamp:
-            AssertInfo(
-                insert_record_.timestamps_.num_chunk() == 1,
-                "num chunk of timestamp not equal to 1 for sealed segment");
-            bulk_subscript_impl<Timestamp>(
-                this->insert_record_.timestamps_.get_chunk_data(0),
-                seg_offsets,
-                count,
-                output);
+            insert_record_.packed_timestamps_.gather(
+                seg_offsets, count, static_cast<Timestamp*>(output));
             break;
-        case SystemFieldType::RowId:
-            AssertInfo(insert_record_.row_ids_.num_chunk() == 1,
-                       "num chunk of rowID not equal to 1 for sealed segment");
+        case SystemFieldType::RowId: {
+            auto guard = rcu_.Read();
+            auto& row_ids = fields().row_ids_;
+            AssertInfo(row_ids != nullptr, "row ids aren't loaded");
             bulk_subscript_impl<int64_t>(
-                this->insert_record_.row_ids_.get_chunk_data(0),
-                seg_offsets,
-                count,
-                output);
+                row_ids.get(), seg_offsets, count, output);
             break;
+        }
         default:
             PanicInfo("unknown subscript fields");
     }
 }
 
-template <typename T>
+// whether a gather of `count` rows of the column reads their pages ahead
+// in a batch, see GatherMappedRows
+static bool
+use_mapped_gather(const ColumnBase* column, int64_t count) {
+    auto min_rows =
+        SegcoreConfig::default_config().get_mmap_gather_willneed_min_rows();
+    return column->mapped_file() && min_rows > 0 && count >= min_rows;
+}
+
+template <typename S, typename T>
 void
-SegmentSealedImpl::bulk_subscript_impl(const void* src_raw,
+SegmentSealedImpl::bulk_subscript_impl(const ColumnBase* column,
                                        const int64_t* seg_offsets,
                                        int64_t count,
                                        void* dst_raw) {
-    static_assert(IsScalar<T>);
-    auto src = reinterpret_cast<const T*>(src_raw);
+    static_assert(IsScalar<S>);
+    auto src = reinterpret_cast<const S*>(column->data());
     auto dst = reinterpret_cast<T*>(dst_raw);
-    for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        if (offset != INVALID_SEG_OFFSET) {
-            dst[i] = src[offset];
-        }
+    if (use_mapped_gather(column, count)) {
+        GatherMappedRows(src, seg_offsets, count, dst);
+    } else {
+        GatherRows(src, seg_offsets, count, dst);
     }
 }
 
-template <typename S, typename T>
+template <typename S>
 void
-SegmentSealedImpl::bulk_subscript_impl(const ColumnBase* column,
-                                       const int64_t* seg_offsets,
-                                       int64_t count,
-                                       void* dst_raw) {
+SegmentSealedImpl::bulk_subscript_impl(
+    const ColumnBase* column,
+    const int64_t* seg_offsets,
+    int64_t count,
+    google::protobuf::RepeatedPtrField<std::string>* dst) {
     auto field = reinterpret_cast<const VariableColumn<S>*>(column);
-    auto dst = reinterpret_cast<T*>(dst_raw);
-    for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        if (offset != INVALID_SEG_OFFSET) {
-            dst[i] = std::move(T(field->raw_at(offset)));
+    if (!use_mapped_gather(column, count)) {
+        for (int64_t i = 0; i < count; ++i) {
+            auto offset = seg_offsets[i];
+            if (offset != INVALID_SEG_OFFSET) {
+                auto value = field->raw_at(offset);
+                dst->Mutable(i)->assign(value.data(), value.size());
+            }
+        }
+        return;
+    }
+
+    // the values of a dictionary encoded column are in memory
+    auto rows = SortedGatherRows(seg_offsets, count);
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    ranges.reserve(rows.size());
+    auto map = column->data();
+    for (auto [offset, i] : rows) {
+        auto value = field->raw_at(offset);
+        if (value.data() >= map && value.data() < map + column->size()) {
+            auto begin = value.data() - map;
+            ranges.emplace_back(begin, begin + value.size());
         }
     }
+    AdviseWillNeed(map, ranges);
+    for (auto [offset, i] : rows) {
+        auto value = field->raw_at(offset);
+        dst->Mutable(i)->assign(value.data(), value.size());
+    }
 }
 
 // for vector
 void
 SegmentSealedImpl::bulk_subscript_impl(int64_t element_sizeof,
-                                       const void* src_raw,
+                                       const ColumnBase* column,
                                        const int64_t* seg_offsets,
                                        int64_t count,
                                        void* dst_raw) {
-    auto src_vec = reinterpret_cast<const char*>(src_raw);
-    auto dst_vec = reinterpret_cast<char*>(dst_raw);
-    for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        auto dst = dst_vec + i * element_sizeof;
-        const char* src = (offset == INVALID_SEG_OFFSET
-                               ? nullptr
-                               : (src_vec + element_sizeof * offset));
-        if (!src) {
-            continue;
-        }
-        memcpy(dst, src, element_sizeof);
+    auto dst = reinterpret_cast<char*>(dst_raw);
+    if (use_mapped_gather(column, count)) {
+        GatherMappedRows(
+            column->data(), element_sizeof, seg_offsets, count, dst);
+    } else {
+        GatherRows(column->data(), element_sizeof, seg_offsets, count, dst);
     }
 }
 
@@ -668,6 +2175,7 @@ std::unique_ptr<DataArray>
 SegmentSealedImpl::bulk_subscript(FieldId field_id,
                                   const int64_t* seg_offsets,
                                   int64_t count) const {
+    auto guard = rcu_.Read();
     auto& field_meta = schema_->operator[](field_id);
     // if count == 0, return empty data array
     if (count == 0) {
@@ -686,31 +2194,30 @@ SegmentSealedImpl::bulk_subscript(FieldId field_id,
         return get_vector(field_id, seg_offsets, count);
     }
 
-    Assert(get_bit(field_data_ready_bitset_, field_id));
+    Assert(get_bit(fields().field_data_ready_bitset_, field_id));
 
+    // rows are gathered into the preallocated data of the result
     if (datatype_is_variable(field_meta.get_data_type())) {
+        auto data_array = CreateScalarDataArray(count, field_meta);
+        auto scalars = data_array->mutable_scalars();
         switch (field_meta.get_data_type()) {
             case DataType::VARCHAR:
             case DataType::STRING: {
-                FixedVector<std::string> output(count);
                 bulk_subscript_impl<std::string>(
-                    variable_fields_.at(field_id).get(),
+                    get_column(field_id),
                     seg_offsets,
                     count,
-                    output.data());
-                return CreateScalarDataArrayFrom(
-                    output.data(), count, field_meta);
+                    scalars->mutable_string_data()->mutable_data());
+                return data_array;
             }
 
             case DataType::JSON: {
-                FixedVector<std::string> output(count);
-                bulk_subscript_impl<Json, std::string>(
-                    variable_fields_.at(field_id).get(),
+                bulk_subscript_impl<Json>(
+                    get_column(field_id),
                     seg_offsets,
                     count,
-                    output.data());
-                return CreateScalarDataArrayFrom(
-                    output.data(), count, field_meta);
+                    scalars->mutable_json_data()->mutable_data());
+                return data_array;
             }
 
             default:
@@ -720,94 +2227,111 @@ SegmentSealedImpl::bulk_subscript(FieldId field_id,
         }
     }
 
-    auto src_vec = fixed_fields_.at(field_id).data();
+    auto column = get_column(field_id);
+    if (datatype_is_vector(field_meta.get_data_type())) {
+        auto data_array = CreateVectorDataArray(count, field_meta);
+        bulk_subscript_impl(field_meta.get_sizeof(),
+                            column,
+                            seg_offsets,
+                            count,
+                            GetMutableVectorData(data_array.get(), field_meta));
+        return data_array;
+    }
+
+    auto data_array = CreateScalarDataArray(count, field_meta);
+    auto scalars = data_array->mutable_scalars();
     switch (field_meta.get_data_type()) {
         case DataType::BOOL: {
-            FixedVector<bool> output(count);
             bulk_subscript_impl<bool>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_bool_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT8: {
-            FixedVector<int8_t> output(count);
-            bulk_subscript_impl<int8_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            bulk_subscript_impl<int8_t, int32_t>(
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_int_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT16: {
-            FixedVector<int16_t> output(count);
-            bulk_subscript_impl<int16_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            bulk_subscript_impl<int16_t, int32_t>(
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_int_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT32: {
-            FixedVector<int32_t> output(count);
             bulk_subscript_impl<int32_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_int_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::INT64: {
-            FixedVector<int64_t> output(count);
             bulk_subscript_impl<int64_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_long_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::FLOAT: {
-            FixedVector<float> output(count);
             bulk_subscript_impl<float>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_float_data()->mutable_data()->mutable_data());
+            break;
         }
         case DataType::DOUBLE: {
-            FixedVector<double> output(count);
             bulk_subscript_impl<double>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
-        }
-
-        case DataType::VECTOR_FLOAT:
-        case DataType::VECTOR_BINARY: {
-            aligned_vector<char> output(field_meta.get_sizeof() * count);
-            bulk_subscript_impl(field_meta.get_sizeof(),
-                                src_vec,
-                                seg_offsets,
-                                count,
-                                output.data());
-            return CreateVectorDataArrayFrom(output.data(), count, field_meta);
+                column,
+                seg_offsets,
+                count,
+                scalars->mutable_double_data()->mutable_data()->mutable_data());
+            break;
         }
-
         default: {
             PanicInfo("unsupported");
         }
     }
+    return data_array;
 }
 
 bool
 SegmentSealedImpl::HasIndex(FieldId field_id) const {
-    std::shared_lock lck(mutex_);
-    return get_bit(index_ready_bitset_, field_id);
+    auto guard = rcu_.Read();
+    return get_bit(fields().index_ready_bitset_, field_id);
 }
 
 bool
 SegmentSealedImpl::HasFieldData(FieldId field_id) const {
-    std::shared_lock lck(mutex_);
+    auto guard = rcu_.Read();
     if (SystemProperty::Instance().IsSystem(field_id)) {
         return is_system_field_ready();
     } else {
-        return get_bit(field_data_ready_bitset_, field_id);
+        return get_bit(fields().field_data_ready_bitset_, field_id);
     }
 }
 
 bool
 SegmentSealedImpl::HasRawData(int64_t field_id) const {
-    std::shared_lock lck(mutex_);
+    auto guard = rcu_.Read();
+    auto& fields = this->fields();
     auto fieldID = FieldId(field_id);
     const auto& field_meta = schema_->operator[](fieldID);
     if (datatype_is_vector(field_meta.get_data_type())) {
-        if (get_bit(index_ready_bitset_, fieldID)) {
-            AssertInfo(vector_indexings_.is_ready(fieldID),
+        if (get_bit(fields.index_ready_bitset_, fieldID)) {
+            AssertInfo(fields.vector_indexings_.is_ready(fieldID),
                        "vector index is not ready");
-            auto field_indexing = vector_indexings_.get_field_indexing(fieldID);
+            auto field_indexing =
+                fields.vector_indexings_.get_field_indexing(fieldID);
             auto vec_index = dynamic_cast<index::VectorIndex*>(
                 field_indexing->indexing_.get());
             return vec_index->HasRawData();
@@ -816,6 +2340,19 @@ SegmentSealedImpl::HasRawData(int64_t field_id) const {
     return true;
 }
 
+std::vector<SegOffset>
+SegmentSealedImpl::search_pks(const std::vector<PkType>& pks,
+                              Timestamp timestamp) const {
+    std::vector<OffsetMap::PkOffset> pk_offsets;
+    insert_record_.search_pks(pks.data(), pks.size(), timestamp, pk_offsets);
+    std::vector<SegOffset> res_offsets;
+    res_offsets.reserve(pk_offsets.size());
+    for (auto& [pk_index, offset] : pk_offsets) {
+        res_offsets.emplace_back(offset);
+    }
+    return res_offsets;
+}
+
 std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
 SegmentSealedImpl::search_ids(const IdArray& id_array,
                               Timestamp timestamp) const {
@@ -830,26 +2367,26 @@ SegmentSealedImpl::search_ids(const IdArray& id_array,
 
     auto res_id_arr = std::make_unique<IdArray>();
     std::vector<SegOffset> res_offsets;
-    for (auto pk : pks) {
-        auto segOffsets = insert_record_.search_pk(pk, timestamp);
-        for (auto offset : segOffsets) {
-            switch (data_type) {
-                case DataType::INT64: {
-                    res_id_arr->mutable_int_id()->add_data(
-                        std::get<int64_t>(pk));
-                    break;
-                }
-                case DataType::VARCHAR: {
-                    res_id_arr->mutable_str_id()->add_data(
-                        std::get<std::string>(pk));
-                    break;
-                }
-                default: {
-                    PanicInfo("unsupported type");
-                }
+    std::vector<OffsetMap::PkOffset> pk_offsets;
+    insert_record_.search_pks(pks.data(), pks.size(), timestamp, pk_offsets);
+    res_offsets.reserve(pk_offsets.size());
+    for (auto& [pk_index, offset] : pk_offsets) {
+        auto& pk = pks[pk_index];
+        switch (data_type) {
+            case DataType::INT64: {
+                res_id_arr->mutable_int_id()->add_data(std::get<int64_t>(pk));
+                break;
+            }
+            case DataType::VARCHAR: {
+                res_id_arr->mutable_str_id()->add_data(
+                    std::get<std::string>(pk));
+                break;
+            }
+            default: {
+                PanicInfo("unsupported type");
             }
-            res_offsets.push_back(offset);
         }
+        res_offsets.emplace_back(offset);
     }
     return {std::move(res_id_arr), std::move(res_offsets)};
 }
@@ -879,11 +2416,8 @@ SegmentSealedImpl::Delete(int64_t reserved_offset,
         sort_timestamps[i] = t;
         sort_pks[i] = pk;
     }
-    deleted_record_.timestamps_.set_data_raw(
-        reserved_offset, sort_timestamps.data(), size);
-    deleted_record_.pks_.set_data_raw(reserved_offset, sort_pks.data(), size);
-    deleted_record_.ack_responder_.AddSegment(reserved_offset,
-                                              reserved_offset + size);
+    deleted_record_.push(
+        reserved_offset, sort_pks.data(), sort_timestamps.data(), size);
     return Status::OK();
 }
 
@@ -891,14 +2425,15 @@ std::vector<SegOffset>
 SegmentSealedImpl::search_ids(const BitsetType& bitset,
                               Timestamp timestamp) const {
     std::vector<SegOffset> dst_offset;
-    for (int i = 0; i < bitset.size(); i++) {
-        if (bitset[i]) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                dst_offset.push_back(offset);
+    search_visible_ids<true>(
+        reinterpret_cast<const uint8_t*>(boost_ext::get_data(bitset)),
+        bitset.size(),
+        timestamp,
+        [&](const int64_t* offsets, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                dst_offset.emplace_back(offsets[i]);
             }
-        }
-    }
+        });
     return dst_offset;
 }
 
@@ -906,17 +2441,50 @@ std::vector<SegOffset>
 SegmentSealedImpl::search_ids(const BitsetView& bitset,
                               Timestamp timestamp) const {
     std::vector<SegOffset> dst_offset;
-    for (int i = 0; i < bitset.size(); i++) {
-        if (!bitset.test(i)) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                dst_offset.push_back(offset);
-            }
+    search_ids(bitset, timestamp, [&](const int64_t* offsets, int64_t count) {
+        for (int64_t i = 0; i < count; ++i) {
+            dst_offset.emplace_back(offsets[i]);
         }
-    }
+    });
     return dst_offset;
 }
 
+void
+SegmentSealedImpl::search_ids(const BitsetView& bitset,
+                              Timestamp timestamp,
+                              const OffsetBatchConsumer& consume) const {
+    search_visible_ids<false>(bitset.data(), bitset.size(), timestamp, consume);
+}
+
+template <bool value>
+void
+SegmentSealedImpl::search_visible_ids(
+    const uint8_t* data,
+    int64_t num_bits,
+    Timestamp timestamp,
+    const OffsetBatchConsumer& consume) const {
+    // the active range of the timestamp index leaves only the rows in
+    // [beg, end) to be compared
+    auto [beg, end] =
+        insert_record_.timestamp_index_.get_active_range(timestamp);
+    auto& timestamps = insert_record_.packed_timestamps_;
+    int64_t visible[kBitBatchSize];
+    ForEachBitBatch<value>(
+        data, num_bits, [&](const int64_t* offsets, int64_t count) {
+            int64_t num_visible = 0;
+            for (int64_t i = 0; i < count; ++i) {
+                auto offset = offsets[i];
+                if (offset < beg ||
+                    (offset < end && timestamps[offset] <= timestamp)) {
+                    visible[num_visible++] = offset;
+                }
+            }
+            if (num_visible > 0) {
+                consume(visible, num_visible);
+            }
+        });
+}
+
 std::string
 SegmentSealedImpl::debug() const {
     std::string log_str;
@@ -928,6 +2496,7 @@ SegmentSealedImpl::debug() const {
 void
 SegmentSealedImpl::LoadSegmentMeta(
     const proto::segcore::LoadSegmentMeta& segment_meta) {
+    SearchCacheInvalidator invalidator(*this);
     std::unique_lock lck(mutex_);
     std::vector<int64_t> slice_lengths;
     for (auto& info : segment_meta.metas()) {
@@ -946,18 +2515,20 @@ SegmentSealedImpl::get_active_count(Timestamp ts) const {
 void
 SegmentSealedImpl::mask_with_timestamps(BitsetType& bitset_chunk,
                                         Timestamp timestamp) const {
-    // TODO change the
-    AssertInfo(insert_record_.timestamps_.num_chunk() == 1,
-               "num chunk not equal to 1 for sealed segment");
-    const auto& timestamps_data = insert_record_.timestamps_.get_chunk(0);
-    AssertInfo(timestamps_data.size() == get_row_count(),
+    const auto& timestamps = insert_record_.packed_timestamps_;
+    AssertInfo(timestamps.size() == get_row_count(),
                "Timestamp size not equal to row count");
+    // the rows the ttl expired, whole blocks but the straddling ones
+    if (auto expire = expire_timestamp(timestamp); expire != 0) {
+        insert_record_.timestamp_index_.mask_expired_rows(
+            expire, timestamps, bitset_chunk);
+    }
     auto range = insert_record_.timestamp_index_.get_active_range(timestamp);
 
-    // range == (size_, size_) and size_ is this->timestamps_.size().
+    // range == (size_, size_) and size_ is timestamps.size().
     // it means these data are all useful, we don't need to update bitset_chunk.
     // It can be thought of as an OR operation with another bitmask that is all 0s, but it is not necessary to do so.
-    if (range.first == range.second && range.first == timestamps_data.size()) {
+    if (range.first == range.second && range.first == timestamps.size()) {
         // just skip
         return;
     }
@@ -967,9 +2538,16 @@ SegmentSealedImpl::mask_with_timestamps(BitsetType& bitset_chunk,
         bitset_chunk.set();
         return;
     }
-    auto mask = TimestampIndex::GenerateBitset(
-        timestamp, range, timestamps_data.data(), timestamps_data.size());
-    bitset_chunk |= mask;
+    // only the blocks straddling the timestamp are decoded
+    insert_record_.timestamp_index_.mask_newer_rows(
+        timestamp, timestamps, bitset_chunk);
+}
+
+bool
+SegmentSealedImpl::is_expired(Timestamp timestamp) const {
+    auto expire = expire_timestamp(timestamp);
+    return expire != 0 && get_row_count() > 0 &&
+           insert_record_.timestamp_index_.max_timestamp() < expire;
 }
 
 }  // namespace milvus::segcore
@@ -14,11 +14,16 @@
 #include <tbb/concurrent_priority_queue.h>
 #include <tbb/concurrent_vector.h>
 
+#include <atomic>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -26,6 +31,9 @@
 #include "DeletedRecord.h"
 #include "ScalarIndex.h"
 #include "SealedIndexingRecord.h"
+#include "ExprResultCache.h"
+#include "PartitionKeyStats.h"
+#include "SearchResultCache.h"
 #include "SegmentSealed.h"
 #include "TimestampIndex.h"
 #include "common/Column.h"
@@ -37,14 +45,39 @@ namespace milvus::segcore {
 class SegmentSealedImpl : public SegmentSealed {
  public:
     explicit SegmentSealedImpl(SchemaPtr schema, int64_t segment_id);
-    ~SegmentSealedImpl() override = default;
+    ~SegmentSealedImpl() override;
     void
     LoadIndex(const LoadIndexInfo& info) override;
     void
     LoadFieldData(const LoadFieldDataInfo& info) override;
     void
+    LoadFieldData(const FieldDataInfo& info) override;
+    void
+    LoadFieldDatas(const std::vector<FieldBinlogsInfo>& infos,
+                   int64_t memory_budget) override;
+    void
+    LoadFieldDataLazily(const LazyFieldDataInfo& info) override;
+    void
+    LoadRefineData(const FieldDataInfo& info) override;
+    int64_t
+    EvictLazyFieldData(int64_t memory_budget) override;
+    void
+    LoadJsonKeyIndex(FieldId field_id,
+                     const std::vector<std::string>& pointers) override;
+    void
     LoadDeletedRecord(const LoadDeletedRecordInfo& info) override;
     void
+    LoadPkStats(const uint8_t* data, int64_t size) override;
+    void
+    LoadDeletedRecordFromBinlogs(
+        const std::vector<std::string>& paths,
+        storage::RemoteChunkManager* chunk_manager) override;
+    void
+    LoadFromGrowing(const SegmentGrowing& growing) override;
+
+    int64_t
+    CompactDeletedRecord(Timestamp oldest_query_ts) override;
+    void
     LoadSegmentMeta(
         const milvus::proto::segcore::LoadSegmentMeta& segment_meta) override;
     void
@@ -61,13 +94,32 @@ class SegmentSealedImpl : public SegmentSealed {
         return id_;
     }
 
+    void
+    set_numa_node(int node) override;
+
+    int
+    get_numa_node() const override {
+        return numa_node_;
+    }
+
     bool
     HasRawData(int64_t field_id) const override;
 
+    using SegmentInternalInterface::Search;
+
+    // serves repeated searches from the SearchResultCache when it's enabled
+    std::unique_ptr<SearchResult>
+    Search(const query::Plan* plan,
+           const query::PlaceholderGroup* placeholder_group,
+           Timestamp timestamp) const override;
+
  public:
     int64_t
     GetMemoryUsageInBytes() const override;
 
+    MemoryUsage
+    GetMemoryUsage() const override;
+
     int64_t
     get_row_count() const override;
 
@@ -88,6 +140,9 @@ class SegmentSealedImpl : public SegmentSealed {
     int64_t
     num_chunk_data(FieldId field_id) const override;
 
+    const index::JsonKeyIndex*
+    json_key_index(FieldId field_id, const std::string& pointer) const override;
+
     int64_t
     num_chunk() const override;
 
@@ -107,6 +162,20 @@ class SegmentSealedImpl : public SegmentSealed {
            const IdArray* pks,
            const Timestamp* timestamps) override;
 
+    bool
+    may_contain_pks(const PkType* pks, int64_t n) const override {
+        return insert_record_.may_contain_any_pk(pks, n);
+    }
+
+    const PartitionKeyStats*
+    partition_key_stats(FieldId field_id) const override;
+
+    FieldSketchPtr
+    field_sketch(FieldId field_id) const override;
+
+    bool
+    is_sorted_by(FieldId field_id) const override;
+
  protected:
     // blob and row_count
     SpanBase
@@ -115,6 +184,13 @@ class SegmentSealedImpl : public SegmentSealed {
     const index::IndexBase*
     chunk_index_impl(FieldId field_id, int64_t chunk_id) const override;
 
+    AnyZoneMap
+    chunk_zone_map_impl(FieldId field_id, int64_t chunk_id) const override;
+
+    const StringDictionary*
+    chunk_string_dictionary_impl(FieldId field_id,
+                                 int64_t chunk_id) const override;
+
     // Calculate: output[i] = Vec[seg_offset[i]],
     // where Vec is determined from field_offset
     void
@@ -136,24 +212,29 @@ class SegmentSealedImpl : public SegmentSealed {
     int64_t
     get_active_count(Timestamp ts) const override;
 
+    int64_t
+    get_delete_barrier(Timestamp ts) const override {
+        return get_barrier(deleted_record_, ts);
+    }
+
  private:
-    template <typename T>
+    template <typename S, typename T = S>
     static void
-    bulk_subscript_impl(const void* src_raw,
+    bulk_subscript_impl(const ColumnBase* column,
                         const int64_t* seg_offsets,
                         int64_t count,
                         void* dst_raw);
 
-    template <typename S, typename T = S>
+    template <typename S>
     static void
     bulk_subscript_impl(const ColumnBase* field,
                         const int64_t* seg_offsets,
                         int64_t count,
-                        void* dst_raw);
+                        google::protobuf::RepeatedPtrField<std::string>* dst);
 
     static void
     bulk_subscript_impl(int64_t element_sizeof,
-                        const void* src_raw,
+                        const ColumnBase* column,
                         const int64_t* seg_offsets,
                         int64_t count,
                         void* dst_raw);
@@ -161,19 +242,13 @@ class SegmentSealedImpl : public SegmentSealed {
     std::unique_ptr<DataArray>
     fill_with_empty(FieldId field_id, int64_t count) const;
 
-    void
-    update_row_count(int64_t row_count) {
-        // if (row_count_opt_.has_value()) {
-        //     AssertInfo(row_count_opt_.value() == row_count, "load data has different row count from other columns");
-        // } else {
-        row_count_opt_ = row_count;
-        // }
-    }
-
     void
     mask_with_timestamps(BitsetType& bitset_chunk,
                          Timestamp timestamp) const override;
 
+    bool
+    is_expired(Timestamp timestamp) const override;
+
     void
     vector_search(SearchInfo& search_info,
                   const void* query_data,
@@ -182,11 +257,39 @@ class SegmentSealedImpl : public SegmentSealed {
                   const BitsetView& bitset,
                   SearchResult& output) const override;
 
+    bool
+    vector_search_offsets(SearchInfo& search_info,
+                          const void* query_data,
+                          int64_t query_count,
+                          const std::vector<int64_t>& seg_offsets,
+                          SearchResult& output) const override;
+
+    // searches the index of the field for refine_factor_ x topk hits and
+    // reranks them by the raw vectors, false if they aren't at hand
+    bool
+    refine_search(const SearchInfo& search_info,
+                  const void* query_data,
+                  int64_t query_count,
+                  const BitsetView& bitset,
+                  SearchResult& output) const;
+
+    // a search of the field with too few queries for its gpu index, done
+    // by brute force of the loaded raw vectors instead
+    bool
+    small_gpu_search(FieldId field_id, int64_t query_count) const;
+
     void
     mask_with_delete(BitsetType& bitset,
                      int64_t ins_barrier,
                      Timestamp timestamp) const override;
 
+    BitsetType
+    exec_predicate(query::Expr& expr,
+                   const std::string& key,
+                   int64_t active_count,
+                   Timestamp timestamp,
+                   QueryProfile* profile) const override;
+
     bool
     is_system_field_ready() const {
         return system_ready_count_ == 2;
@@ -200,32 +303,158 @@ class SegmentSealedImpl : public SegmentSealed {
     std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
     search_ids(const IdArray& id_array, Timestamp timestamp) const override;
 
+    std::vector<SegOffset>
+    search_pks(const std::vector<PkType>& pks,
+               Timestamp timestamp) const override;
+
     std::vector<SegOffset>
     search_ids(const BitsetView& view, Timestamp timestamp) const override;
 
     std::vector<SegOffset>
     search_ids(const BitsetType& view, Timestamp timestamp) const override;
 
+    void
+    search_ids(const BitsetView& view,
+               Timestamp timestamp,
+               const OffsetBatchConsumer& consume) const override;
+
     void
     LoadVecIndex(const LoadIndexInfo& info);
 
     void
     LoadScalarIndex(const LoadIndexInfo& info);
 
+    // raw data of a loaded field, a lazy field is fetched on first access
+    const ColumnBase*
+    get_column(FieldId field_id) const;
+
+    const ColumnBase*
+    get_lazy_column(FieldId field_id) const;
+
+    struct Fields;
+
+    static void
+    add_json_key_indexes(
+        Fields& fields,
+        FieldId field_id,
+        std::vector<std::unique_ptr<index::JsonKeyIndex>> indexes);
+
+    std::unique_ptr<ColumnBase>
+    fetch_lazy_column(const LazyFieldDataInfo& info) const;
+
  private:
-    // segment loading state
-    BitsetType field_data_ready_bitset_;
-    BitsetType index_ready_bitset_;
-    std::atomic<int> system_ready_count_ = 0;
-    // segment data
+    // the offsets of the bits of `data` equal to `value` whose rows are
+    // visible at `timestamp`
+    template <bool value>
+    void
+    search_visible_ids(const uint8_t* data,
+                       int64_t num_bits,
+                       Timestamp timestamp,
+                       const OffsetBatchConsumer& consume) const;
+
+    struct LazyField {
+        LazyFieldDataInfo info;
+        // serializes the fetches of the field
+        std::shared_ptr<std::mutex> load_mutex;
+        std::shared_ptr<ColumnBase> column;
+        AnyZoneMap zone_map;
+        uint64_t last_access = 0;
+    };
+
+    // held by the loads and drops, the cached search and predicate results
+    // of the segment turn stale once it's released, after the change is made
+    class SearchCacheInvalidator {
+     public:
+        explicit SearchCacheInvalidator(SegmentSealedImpl& segment)
+            : segment_(segment) {
+        }
+
+        ~SearchCacheInvalidator() {
+            auto generation = ++segment_.search_cache_generation_;
+            segment_.expr_result_cache_.Clear(generation);
+            auto& cache = SearchResultCache::GetInstance();
+            if (cache.Enabled()) {
+                cache.Erase(segment_.search_cache_uid_);
+            }
+        }
+
+     private:
+        SegmentSealedImpl& segment_;
+    };
+
+    // the loaded data of the user fields, see fields()
+    struct Fields {
+        // segment loading state
+        BitsetType field_data_ready_bitset_;
+        BitsetType index_ready_bitset_;
+
+        // TODO: generate index for scalar
+        std::optional<int64_t> row_count_opt_;
+
+        // scalar field index
+        std::unordered_map<FieldId, std::shared_ptr<index::IndexBase>>
+            scalar_indexings_;
+        // vector field index
+        SealedIndexingRecord vector_indexings_;
+
+        std::unordered_map<FieldId, std::shared_ptr<Column>> fixed_fields_;
+        std::unordered_map<FieldId, std::shared_ptr<ColumnBase>>
+            variable_fields_;
+        // min/max of the loaded raw data
+        std::unordered_map<FieldId, AnyZoneMap> zone_maps_;
+        // squared norms of the rows of the loaded float vector fields
+        std::unordered_map<FieldId, std::shared_ptr<std::vector<float>>>
+            vector_norms_;
+        // sign sketches of their rows, with a brute force sketch factor
+        std::unordered_map<FieldId, std::shared_ptr<std::vector<uint8_t>>>
+            vector_sketches_;
+        // read only by the retrieves asking for them, a mapped file with a
+        // mmap dir, so they don't take memory
+        std::shared_ptr<Column> row_ids_;
+        // raw vectors of indexed fields, see LoadRefineData
+        std::unordered_map<FieldId, std::shared_ptr<Column>> refine_columns_;
+        // offset ranges of the partition key values
+        std::unordered_map<FieldId, std::shared_ptr<PartitionKeyStats>>
+            partition_key_stats_;
+        // distinct counts and quantiles of the loaded scalar raw data
+        std::unordered_map<FieldId, FieldSketchPtr> field_sketches_;
+        // fields whose raw data is ascending
+        std::unordered_set<FieldId> sorted_fields_;
+        // json field -> pointer -> the values of the pointer
+        std::unordered_map<
+            FieldId,
+            std::unordered_map<std::string,
+                               std::shared_ptr<index::JsonKeyIndex>>>
+            json_key_indexes_;
+    };
+
+    // The published fields, read without a lock. A load or drop builds
+    // its data first, then publishes a copy of them with its change, see
+    // update_fields, the one replaced is released once the queries which
+    // may still read it are done. The columns and indexes are shared by
+    // the copies.
+    const Fields&
+    fields() const {
+        return *fields_.load(std::memory_order_acquire);
+    }
+
+    // the row count of the published fields, nullopt before the first
+    // load, read within a read section of its own
+    std::optional<int64_t>
+    loaded_row_count() const {
+        auto guard = rcu_.Read();
+        return fields().row_count_opt_;
+    }
 
-    // TODO: generate index for scalar
-    std::optional<int64_t> row_count_opt_;
+    // publishes the fields `update` makes of a copy of the published
+    // ones, nothing is published if it throws
+    void
+    update_fields(const std::function<void(Fields&)>& update);
+
+    void
+    load_row_ids(std::shared_ptr<Column> column);
 
-    // scalar field index
-    std::unordered_map<FieldId, index::IndexBasePtr> scalar_indexings_;
-    // vector field index
-    SealedIndexingRecord vector_indexings_;
+    std::atomic<int> system_ready_count_ = 0;
 
     // inserted fields data and row_ids, timestamps
     InsertRecord<true> insert_record_;
@@ -235,8 +464,22 @@ class SegmentSealedImpl : public SegmentSealed {
 
     SchemaPtr schema_;
     int64_t id_;
-    std::unordered_map<FieldId, Column> fixed_fields_;
-    std::unordered_map<FieldId, std::unique_ptr<ColumnBase>> variable_fields_;
+    // the NUMA node loaded data is placed on, -1 for none
+    std::atomic<int> numa_node_{-1};
+    // serializes the loads and drops of the user fields, no query takes it
+    std::mutex load_mutex_;
+    std::atomic<const Fields*> fields_;
+
+    // fields registered by LoadFieldDataLazily, columns are fetched under
+    // lazy_mutex_ during queries, an evicted or dropped one is retired to
+    // rcu_, so the spans handed out stay valid
+    mutable std::mutex lazy_mutex_;
+    mutable std::unordered_map<FieldId, LazyField> lazy_fields_;
+    mutable uint64_t lazy_access_clock_ = 0;
+
+    const int64_t search_cache_uid_ = SearchResultCache::NewSegmentUid();
+    std::atomic<int64_t> search_cache_generation_ = 0;
+    mutable ExprResultCache expr_result_cache_;
 };
 
 inline SegmentSealedPtr
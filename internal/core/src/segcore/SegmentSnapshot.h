@@ -0,0 +1,81 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// The rows of a segment visible at a timestamp: inserted at or before it
+// and not deleted by then. Built once by AcquireSnapshot and shared by the
+// searches and retrieves at that timestamp, it is released with the last
+// handle to it.
+class SegmentSnapshot {
+ public:
+    SegmentSnapshot(Timestamp timestamp,
+                    int64_t active_count,
+                    int64_t del_barrier,
+                    std::pair<int64_t, int64_t> buffer_barrier,
+                    BitsetType invisible)
+        : timestamp_(timestamp),
+          active_count_(active_count),
+          del_barrier_(del_barrier),
+          buffer_barrier_(buffer_barrier),
+          invisible_(std::move(invisible)) {
+    }
+
+    Timestamp
+    timestamp() const {
+        return timestamp_;
+    }
+
+    // rows a query at the timestamp ranges over
+    int64_t
+    active_count() const {
+        return active_count_;
+    }
+
+    // deletes up to the timestamp when the snapshot was built, a snapshot
+    // is stale once more of them arrive
+    int64_t
+    del_barrier() const {
+        return del_barrier_;
+    }
+
+    // the same for the deletes of the collection delete buffer
+    std::pair<int64_t, int64_t>
+    buffer_barrier() const {
+        return buffer_barrier_;
+    }
+
+    // set for the first active_count rows which are inserted later or
+    // deleted, the same as mask_with_timestamps and mask_with_delete give
+    const BitsetType&
+    invisible() const {
+        return invisible_;
+    }
+
+ private:
+    const Timestamp timestamp_;
+    const int64_t active_count_;
+    const int64_t del_barrier_;
+    const std::pair<int64_t, int64_t> buffer_barrier_;
+    const BitsetType invisible_;
+};
+
+using SegmentSnapshotPtr = std::shared_ptr<const SegmentSnapshot>;
+
+}  // namespace milvus::segcore
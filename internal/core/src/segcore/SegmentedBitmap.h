@@ -0,0 +1,180 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost_ext/dynamic_bitset_ext.hpp>
+
+#include "common/BitsetOps.h"
+#include "common/Types.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::segcore {
+
+// A bitmap split into fixed size blocks which are shared between copies.
+// Copying only copies the block pointers, and a copy clones a block the
+// first time it modifies it, so a new version costs O(blocks touched).
+// A copy which is published to readers must not be modified anymore.
+class SegmentedBitmap {
+ public:
+    // must be a multiple of the bitset block width
+    static constexpr int64_t BLOCK_BITS = 64 * 1024;
+
+    SegmentedBitmap() = default;
+
+    SegmentedBitmap(const SegmentedBitmap& other)
+        : blocks_(other.blocks_),
+          owned_(other.blocks_.size(), false),
+          size_(other.size_) {
+    }
+
+    SegmentedBitmap&
+    operator=(const SegmentedBitmap& other) {
+        if (this != &other) {
+            blocks_ = other.blocks_;
+            owned_.assign(other.blocks_.size(), false);
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SegmentedBitmap(SegmentedBitmap&&) = default;
+
+    SegmentedBitmap&
+    operator=(SegmentedBitmap&&) = default;
+
+    int64_t
+    size() const {
+        return size_;
+    }
+
+    // new bits are zero
+    void
+    resize(int64_t size) {
+        AssertInfo(size >= 0, "invalid bitmap size");
+        if (size == size_) {
+            return;
+        }
+        auto num_blocks = (size + BLOCK_BITS - 1) / BLOCK_BITS;
+        blocks_.resize(num_blocks);
+        owned_.resize(num_blocks, false);
+        for (int64_t i = 0; i < num_blocks; ++i) {
+            auto block_size = std::min(BLOCK_BITS, size - i * BLOCK_BITS);
+            if (blocks_[i] == nullptr) {
+                blocks_[i] = std::make_shared<BitsetType>(block_size);
+                owned_[i] = true;
+            } else if (int64_t(blocks_[i]->size()) != block_size) {
+                mutable_block(i).resize(block_size, false);
+            }
+        }
+        size_ = size;
+    }
+
+    bool
+    test(int64_t pos) const {
+        return blocks_[pos / BLOCK_BITS]->test(pos % BLOCK_BITS);
+    }
+
+    void
+    set(int64_t pos) {
+        if (!test(pos)) {
+            mutable_block(pos / BLOCK_BITS).set(pos % BLOCK_BITS);
+        }
+    }
+
+    void
+    reset(int64_t pos) {
+        if (test(pos)) {
+            mutable_block(pos / BLOCK_BITS).reset(pos % BLOCK_BITS);
+        }
+    }
+
+    // bytes of the bits, blocks shared with other copies included
+    int64_t
+    memory_bytes() const {
+        return (size_ + 7) / 8 +
+               blocks_.capacity() * sizeof(std::shared_ptr<BitsetType>);
+    }
+
+    int64_t
+    count() const {
+        int64_t cnt = 0;
+        for (auto& block : blocks_) {
+            cnt += BitsetCount(*block);
+        }
+        return cnt;
+    }
+
+    // dst |= the first dst.size() bits of *this, block by block without
+    // building a flat copy
+    void
+    or_to(BitsetType& dst) const {
+        auto dst_size = int64_t(dst.size());
+        AssertInfo(dst_size <= size_,
+                   "Filtered bitmap size larger than deleted bitmap size");
+        using Block = BitsetType::block_type;
+        constexpr int64_t bits_per_block = BitsetType::bits_per_block;
+        static_assert(BLOCK_BITS % bits_per_block == 0);
+        auto dst_data = reinterpret_cast<Block*>(boost_ext::get_data(dst));
+        for (int64_t i = 0; i * BLOCK_BITS < dst_size; ++i) {
+            auto& block = *blocks_[i];
+            auto src = reinterpret_cast<const Block*>(
+                boost_ext::get_data(block));
+            auto dst_block = dst_data + i * (BLOCK_BITS / bits_per_block);
+            auto bits = std::min(BLOCK_BITS, dst_size - i * BLOCK_BITS);
+            auto words = (bits + bits_per_block - 1) / bits_per_block;
+            simd::BitwiseWords(simd::BitwiseOp::OR,
+                               reinterpret_cast<uint64_t*>(dst_block),
+                               reinterpret_cast<const uint64_t*>(src),
+                               words);
+        }
+        // the bits past the end of dst must stay zero
+        if (dst_size < size_ && dst_size % bits_per_block != 0) {
+            dst_data[dst_size / bits_per_block] &=
+                (Block(1) << (dst_size % bits_per_block)) - 1;
+        }
+    }
+
+    BitsetType
+    to_bitset() const {
+        BitsetType res(size_);
+        or_to(res);
+        return res;
+    }
+
+ private:
+    BitsetType&
+    mutable_block(int64_t index) {
+        if (!owned_[index]) {
+            blocks_[index] = std::make_shared<BitsetType>(*blocks_[index]);
+            owned_[index] = true;
+        }
+        return *blocks_[index];
+    }
+
+ private:
+    std::vector<std::shared_ptr<BitsetType>> blocks_;
+    // blocks which were cloned or created by this copy
+    std::vector<bool> owned_;
+    int64_t size_ = 0;
+};
+
+}  // namespace milvus::segcore
@@ -11,6 +11,11 @@
 
 #include "TimestampIndex.h"
 
+#include <algorithm>
+
+#include "boost_ext/dynamic_bitset_ext.hpp"
+#include "simd/hook.h"
+
 namespace milvus::segcore {
 
 void
@@ -43,11 +48,25 @@ TimestampIndex::build_with(const Timestamp* timestamps, int64_t size) {
     Assert(offset == size);
     auto min_ts = timestamp_barriers[0];
 
+    auto num_blocks = (size + kBlockSize - 1) / kBlockSize;
+    std::vector<Timestamp> block_min_timestamps(num_blocks);
+    std::vector<Timestamp> block_max_timestamps(num_blocks);
+    for (int64_t block_id = 0; block_id < num_blocks; ++block_id) {
+        auto block_beg = block_id * kBlockSize;
+        auto block_end = std::min(size, block_beg + kBlockSize);
+        auto [min_v, max_v] = std::minmax_element(timestamps + block_beg,
+                                                  timestamps + block_end);
+        block_min_timestamps[block_id] = *min_v;
+        block_max_timestamps[block_id] = *max_v;
+    }
+
     this->size_ = size;
     this->start_locs_ = std::move(prefix_sums);
     this->min_timestamp_ = min_ts;
     this->max_timestamp_ = last_max_v;
     this->timestamp_barriers_ = std::move(timestamp_barriers);
+    this->block_min_timestamps_ = std::move(block_min_timestamps);
+    this->block_max_timestamps_ = std::move(block_max_timestamps);
 }
 
 std::pair<int64_t, int64_t>
@@ -67,6 +86,67 @@ TimestampIndex::get_active_range(Timestamp query_timestamp) const {
     return {start_locs_[block_id], start_locs_[block_id + 1]};
 }
 
+template <typename MaskBlock>
+void
+TimestampIndex::mask_newer_blocks(Timestamp query_timestamp,
+                                  BitsetType& bitset,
+                                  MaskBlock mask_block) const {
+    auto size = int64_t(bitset.size());
+    Assert(size <= size_);
+    auto [beg, end] = get_active_range(query_timestamp);
+    beg = std::min(beg, size);
+    end = std::min(end, size);
+    if (end < size) {
+        bitset.set(end, size - end, true);
+    }
+    for (auto block_id = beg / kBlockSize; block_id * kBlockSize < end;
+         ++block_id) {
+        auto block_beg = std::max(beg, block_id * kBlockSize);
+        auto block_end = std::min(end, (block_id + 1) * kBlockSize);
+        if (block_max_timestamps_[block_id] <= query_timestamp) {
+            continue;
+        }
+        if (block_min_timestamps_[block_id] > query_timestamp) {
+            bitset.set(block_beg, block_end - block_beg, true);
+            continue;
+        }
+        mask_block(block_beg, block_end);
+    }
+}
+
+void
+TimestampIndex::mask_newer_rows(Timestamp query_timestamp,
+                                const Timestamp* timestamps,
+                                BitsetType& bitset) const {
+    mask_newer_blocks(
+        query_timestamp, bitset, [&](int64_t block_beg, int64_t block_end) {
+            MaskNewerTimestamps(query_timestamp,
+                                timestamps + block_beg,
+                                block_beg,
+                                block_end,
+                                bitset);
+        });
+}
+
+void
+TimestampIndex::mask_newer_rows(Timestamp query_timestamp,
+                                const PackedTimestamps& timestamps,
+                                BitsetType& bitset) const {
+    static_assert(PackedTimestamps::kBlockSize == kBlockSize);
+    Assert(timestamps.size() == size_);
+    std::vector<Timestamp> decoded;
+    mask_newer_blocks(
+        query_timestamp, bitset, [&](int64_t block_beg, int64_t block_end) {
+            decoded.resize(block_end - block_beg);
+            timestamps.decode(block_beg, block_end, decoded.data());
+            MaskNewerTimestamps(query_timestamp,
+                                decoded.data(),
+                                block_beg,
+                                block_end,
+                                bitset);
+        });
+}
+
 BitsetType
 TimestampIndex::GenerateBitset(Timestamp query_timestamp,
                                std::pair<int64_t, int64_t> active_range,
@@ -76,14 +156,94 @@ TimestampIndex::GenerateBitset(Timestamp query_timestamp,
     Assert(beg < end);
     BitsetType bitset;
     bitset.reserve(size);
-    bitset.resize(beg, false);
+    bitset.resize(end, false);
     bitset.resize(size, true);
-    for (int64_t i = beg; i < end; ++i) {
-        bitset[i] = timestamps[i] > query_timestamp;
-    }
+    MaskNewerTimestamps(
+        query_timestamp, timestamps + beg, beg, end, bitset);
     return bitset;
 }
 
+void
+TimestampIndex::mask_expired_rows(Timestamp expire_timestamp,
+                                  const PackedTimestamps& timestamps,
+                                  BitsetType& bitset) const {
+    static_assert(PackedTimestamps::kBlockSize == kBlockSize);
+    auto size = int64_t(bitset.size());
+    Assert(size <= size_);
+    if (size == 0 || min_timestamp_ >= expire_timestamp) {
+        return;
+    }
+    if (max_timestamp_ < expire_timestamp) {
+        bitset.set();
+        return;
+    }
+    std::vector<Timestamp> decoded;
+    for (int64_t block_id = 0; block_id * kBlockSize < size; ++block_id) {
+        auto block_beg = block_id * kBlockSize;
+        auto block_end = std::min(size, block_beg + kBlockSize);
+        if (block_min_timestamps_[block_id] >= expire_timestamp) {
+            continue;
+        }
+        if (block_max_timestamps_[block_id] < expire_timestamp) {
+            bitset.set(block_beg, block_end - block_beg, true);
+            continue;
+        }
+        decoded.resize(block_end - block_beg);
+        timestamps.decode(block_beg, block_end, decoded.data());
+        MaskOlderTimestamps(
+            expire_timestamp, decoded.data(), block_beg, block_end, bitset);
+    }
+}
+
+// compares the timestamps of the rows in [beg, end) with `value` 64 rows
+// per word, then ors the words in at the bit offset beg
+static void
+mask_compared_timestamps(simd::CompareType op,
+                         Timestamp value,
+                         const Timestamp* timestamps,
+                         int64_t beg,
+                         int64_t end,
+                         BitsetType& bitset) {
+    static_assert(sizeof(BitSetBlockType) == sizeof(uint64_t));
+    Assert(0 <= beg && end <= int64_t(bitset.size()));
+    if (beg >= end) {
+        return;
+    }
+    auto size = end - beg;
+    std::vector<uint64_t> buffer(simd::WordCount(size));
+    simd::CompareVal(op, timestamps, size, value, buffer.data());
+    auto words = reinterpret_cast<uint64_t*>(boost_ext::get_data(bitset));
+    auto shift = beg % simd::BITS_PER_WORD;
+    words += beg / simd::BITS_PER_WORD;
+    auto n_words = simd::WordCount(shift + size);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        words[i] |= buffer[i] << shift;
+        if (shift != 0 && i + 1 < n_words) {
+            words[i + 1] |= buffer[i] >> (simd::BITS_PER_WORD - shift);
+        }
+    }
+}
+
+void
+TimestampIndex::MaskNewerTimestamps(Timestamp query_timestamp,
+                                    const Timestamp* timestamps,
+                                    int64_t beg,
+                                    int64_t end,
+                                    BitsetType& bitset) {
+    mask_compared_timestamps(
+        simd::CompareType::GT, query_timestamp, timestamps, beg, end, bitset);
+}
+
+void
+TimestampIndex::MaskOlderTimestamps(Timestamp expire_timestamp,
+                                    const Timestamp* timestamps,
+                                    int64_t beg,
+                                    int64_t end,
+                                    BitsetType& bitset) {
+    mask_compared_timestamps(
+        simd::CompareType::LT, expire_timestamp, timestamps, beg, end, bitset);
+}
+
 std::vector<int64_t>
 GenerateFakeSlices(const Timestamp* timestamps,
                    int64_t size,
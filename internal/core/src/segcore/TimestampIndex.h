@@ -16,11 +16,15 @@
 #include <utility>
 
 #include "common/Schema.h"
+#include "segcore/PackedTimestamps.h"
 
 namespace milvus::segcore {
 
 class TimestampIndex {
  public:
+    // rows summarized by one min/max entry
+    static constexpr int64_t kBlockSize = 4096;
+
     void
     set_length_meta(std::vector<int64_t> lengths);
 
@@ -34,22 +38,98 @@ class TimestampIndex {
     std::pair<int64_t, int64_t>
     get_active_range(Timestamp query_timestamp) const;
 
+    // set the bits of rows newer than query_timestamp, timestamps cover all
+    // the rows the index is built with and bitset the first bitset.size()
+    // of them. Inside the undecided range only the blocks straddling
+    // query_timestamp are compared.
+    void
+    mask_newer_rows(Timestamp query_timestamp,
+                    const Timestamp* timestamps,
+                    BitsetType& bitset) const;
+
+    // the same, only the straddling blocks of the packed timestamps are
+    // decoded
+    void
+    mask_newer_rows(Timestamp query_timestamp,
+                    const PackedTimestamps& timestamps,
+                    BitsetType& bitset) const;
+
+    // set the bits of the rows older than expire_timestamp, the ones the
+    // ttl of the collection expired; the blocks whose bounds leave them
+    // undecided are decoded, the others are decided whole
+    void
+    mask_expired_rows(Timestamp expire_timestamp,
+                      const PackedTimestamps& timestamps,
+                      BitsetType& bitset) const;
+
+    // the oldest and newest timestamps of the rows, 0 before the index is
+    // built
+    Timestamp
+    min_timestamp() const {
+        return size_ > 0 ? min_timestamp_ : 0;
+    }
+
+    Timestamp
+    max_timestamp() const {
+        return size_ > 0 ? max_timestamp_ : 0;
+    }
+
     static BitsetType
     GenerateBitset(Timestamp query_timestamp,
                    std::pair<int64_t, int64_t> active_range,
                    const Timestamp* timestamps,
                    int64_t size);
 
+    // set the bits in [beg, end) of bitset whose timestamps are newer than
+    // query_timestamp, timestamps points at the row beg
+    static void
+    MaskNewerTimestamps(Timestamp query_timestamp,
+                        const Timestamp* timestamps,
+                        int64_t beg,
+                        int64_t end,
+                        BitsetType& bitset);
+
+    // the same for the timestamps older than expire_timestamp
+    static void
+    MaskOlderTimestamps(Timestamp expire_timestamp,
+                        const Timestamp* timestamps,
+                        int64_t beg,
+                        int64_t end,
+                        BitsetType& bitset);
+
+    // bytes of the slices and the block bounds
+    int64_t
+    memory_bytes() const {
+        return (lengths_.capacity() + start_locs_.capacity()) *
+                   sizeof(int64_t) +
+               (timestamp_barriers_.capacity() +
+                block_min_timestamps_.capacity() +
+                block_max_timestamps_.capacity()) *
+                   sizeof(Timestamp);
+    }
+
  private:
+    // calls mask_block(block_beg, block_end) for the rows of the blocks
+    // which are neither all visible nor all newer
+    template <typename MaskBlock>
+    void
+    mask_newer_blocks(Timestamp query_timestamp,
+                      BitsetType& bitset,
+                      MaskBlock mask_block) const;
+
     // numSlice
     std::vector<int64_t> lengths_;
-    int64_t size_;
+    int64_t size_ = 0;
     // numSlice + 1
     std::vector<int64_t> start_locs_;
-    Timestamp min_timestamp_;
-    Timestamp max_timestamp_;
+    Timestamp min_timestamp_ = 0;
+    Timestamp max_timestamp_ = 0;
     // numSlice + 1
     std::vector<Timestamp> timestamp_barriers_;
+    // min/max timestamp of every kBlockSize rows, out of order timestamps
+    // merge into a few huge slices, the blocks keep masking cheap there
+    std::vector<Timestamp> block_min_timestamps_;
+    std::vector<Timestamp> block_max_timestamps_;
 };
 
 std::vector<int64_t>
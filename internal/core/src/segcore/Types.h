@@ -24,6 +24,7 @@
 #include "common/Types.h"
 #include "common/type_c.h"
 #include "index/Index.h"
+#include "segcore/SegmentArena.h"
 #include "storage/Types.h"
 
 namespace milvus::segcore {
@@ -40,6 +41,12 @@ struct LoadIndexInfo {
     int64_t index_version;
     std::map<std::string, std::string> index_params;
     std::vector<std::string> index_files;
+    // memory indexes are mapped from files under it if not empty
+    std::string mmap_dir_path;
+    // the index memory prefers this NUMA node if it isn't -1
+    int numa_node = -1;
+    // the index is allocated from the arena of its segment if not null
+    std::shared_ptr<SegmentArena> arena;
     index::IndexBasePtr index;
     storage::StorageConfig storage_config;
 };
@@ -10,13 +10,49 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include "segcore/Utils.h"
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <type_traits>
 
 #include "common/Utils.h"
 #include "index/ScalarIndex.h"
 
 namespace milvus::segcore {
 
+namespace {
+
+// appends `count` values to `field`, growing it once, values of the width
+// of the field are copied with memcpy
+template <typename Dst, typename Src>
+void
+AppendValues(google::protobuf::RepeatedField<Dst>* field,
+             const Src* src,
+             int64_t count) {
+    if (count == 0) {
+        return;
+    }
+    field->Reserve(field->size() + count);
+    auto dst = field->AddNAlreadyReserved(count);
+    if constexpr (std::is_same_v<Dst, Src>) {
+        memcpy(dst, src, count * sizeof(Dst));
+    } else {
+        std::copy_n(src, count, dst);
+    }
+}
+
+void
+AppendStrings(google::protobuf::RepeatedPtrField<std::string>* field,
+              const std::string* src,
+              int64_t count) {
+    field->Reserve(field->size() + count);
+    for (int64_t i = 0; i < count; ++i) {
+        *field->Add() = src[i];
+    }
+}
+
+}  // namespace
+
 void
 ParsePksFromFieldData(std::vector<PkType>& pks, const DataArray& data) {
     switch (static_cast<DataType>(data.type())) {
@@ -37,6 +73,45 @@ ParsePksFromFieldData(std::vector<PkType>& pks, const DataArray& data) {
     }
 }
 
+void
+ParseGroupByValuesFromFieldData(std::vector<GroupByValueType>& values,
+                                const DataArray& data) {
+    auto& scalars = data.scalars();
+    switch (static_cast<DataType>(data.type())) {
+        case DataType::BOOL: {
+            auto& src_data = scalars.bool_data().data();
+            std::transform(src_data.begin(),
+                           src_data.end(),
+                           values.begin(),
+                           [](auto value) { return int64_t(value); });
+            break;
+        }
+        case DataType::INT8:
+        case DataType::INT16:
+        case DataType::INT32: {
+            auto& src_data = scalars.int_data().data();
+            std::transform(src_data.begin(),
+                           src_data.end(),
+                           values.begin(),
+                           [](auto value) { return int64_t(value); });
+            break;
+        }
+        case DataType::INT64: {
+            auto& src_data = scalars.long_data().data();
+            std::copy(src_data.begin(), src_data.end(), values.begin());
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto& src_data = scalars.string_data().data();
+            std::copy(src_data.begin(), src_data.end(), values.begin());
+            break;
+        }
+        default: {
+            PanicInfo("unsupported group by data type");
+        }
+    }
+}
+
 void
 ParsePksFromIDs(std::vector<PkType>& pks,
                 DataType data_type,
@@ -59,6 +134,44 @@ ParsePksFromIDs(std::vector<PkType>& pks,
     }
 }
 
+void
+ParseDeleteLogs(std::vector<PkType>& pks,
+                std::vector<Timestamp>& timestamps,
+                DataType data_type,
+                const storage::FieldDataBase& payload) {
+    AssertInfo(payload.get_data_type() == DataType::STRING ||
+                   payload.get_data_type() == DataType::VARCHAR,
+               "the payload of a delta log is not a string");
+    AssertInfo(data_type == DataType::INT64 || data_type == DataType::VARCHAR,
+               "unsupported pk type of delta log");
+    auto rows = payload.get_num_rows();
+    pks.reserve(pks.size() + rows);
+    timestamps.reserve(timestamps.size() + rows);
+    for (int64_t i = 0; i < rows; ++i) {
+        auto begin = static_cast<const char*>(payload.RawValue(i));
+        auto end = begin + payload.get_element_size(i);
+        auto log = nlohmann::json::parse(begin, end, nullptr, false);
+        if (!log.is_discarded()) {
+            AssertInfo(log.is_object() && log.contains("pk") &&
+                           log.contains("ts"),
+                       "invalid delta log: " + std::string(begin, end));
+            auto& pk = log["pk"];
+            if (data_type == DataType::INT64) {
+                pks.emplace_back(pk.get<int64_t>());
+            } else {
+                pks.emplace_back(pk.get<std::string>());
+            }
+            timestamps.push_back(log["ts"].get<Timestamp>());
+            continue;
+        }
+        auto comma = std::find(begin, end, ',');
+        AssertInfo(data_type == DataType::INT64 && comma != end,
+                   "invalid delta log: " + std::string(begin, end));
+        pks.emplace_back(std::stoll(std::string(begin, comma)));
+        timestamps.push_back(std::stoull(std::string(comma + 1, end)));
+    }
+}
+
 int64_t
 GetSizeOfIdArray(const IdArray& data) {
     if (data.has_int_id()) {
@@ -177,6 +290,24 @@ CreateVectorDataArray(int64_t count, const FieldMeta& field_meta) {
     return data_array;
 }
 
+char*
+GetMutableVectorData(DataArray* data_array, const FieldMeta& field_meta) {
+    auto vector_array = data_array->mutable_vectors();
+    switch (field_meta.get_data_type()) {
+        case DataType::VECTOR_FLOAT: {
+            return reinterpret_cast<char*>(vector_array->mutable_float_vector()
+                                               ->mutable_data()
+                                               ->mutable_data());
+        }
+        case DataType::VECTOR_BINARY: {
+            return vector_array->mutable_binary_vector()->data();
+        }
+        default: {
+            PanicInfo("unsupported datatype");
+        }
+    }
+}
+
 std::unique_ptr<DataArray>
 CreateScalarDataArrayFrom(const void* data_raw,
                           int64_t count,
@@ -192,59 +323,55 @@ CreateScalarDataArrayFrom(const void* data_raw,
         case DataType::BOOL: {
             auto data = reinterpret_cast<const bool*>(data_raw);
             auto obj = scalar_array->mutable_bool_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::INT8: {
             auto data = reinterpret_cast<const int8_t*>(data_raw);
             auto obj = scalar_array->mutable_int_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::INT16: {
             auto data = reinterpret_cast<const int16_t*>(data_raw);
             auto obj = scalar_array->mutable_int_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::INT32: {
             auto data = reinterpret_cast<const int32_t*>(data_raw);
             auto obj = scalar_array->mutable_int_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::INT64: {
             auto data = reinterpret_cast<const int64_t*>(data_raw);
             auto obj = scalar_array->mutable_long_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::FLOAT: {
             auto data = reinterpret_cast<const float*>(data_raw);
             auto obj = scalar_array->mutable_float_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::DOUBLE: {
             auto data = reinterpret_cast<const double*>(data_raw);
             auto obj = scalar_array->mutable_double_data();
-            obj->mutable_data()->Add(data, data + count);
+            AppendValues(obj->mutable_data(), data, count);
             break;
         }
         case DataType::VARCHAR: {
             auto data = reinterpret_cast<const std::string*>(data_raw);
             auto obj = scalar_array->mutable_string_data();
-            for (auto i = 0; i < count; i++) {
-                *(obj->mutable_data()->Add()) = data[i];
-            }
+            AppendStrings(obj->mutable_data(), data, count);
             break;
         }
         case DataType::JSON: {
             auto data = reinterpret_cast<const std::string*>(data_raw);
             auto obj = scalar_array->mutable_json_data();
-            for (auto i = 0; i < count; i++) {
-                *(obj->mutable_data()->Add()) = data[i];
-            }
+            AppendStrings(obj->mutable_data(), data, count);
             break;
         }
         default: {
@@ -273,7 +400,7 @@ CreateVectorDataArrayFrom(const void* data_raw,
             auto length = count * dim;
             auto data = reinterpret_cast<const float*>(data_raw);
             auto obj = vector_array->mutable_float_vector();
-            obj->mutable_data()->Add(data, data + length);
+            AppendValues(obj->mutable_data(), data, length);
             break;
         }
         case DataType::VECTOR_BINARY: {
@@ -305,102 +432,188 @@ CreateDataArrayFrom(const void* data_raw,
     return CreateVectorDataArrayFrom(data_raw, count, field_meta);
 }
 
-// TODO remove merge dataArray, instead fill target entity when get data slice
+namespace {
+
+// the rows of `result_offsets` in order, each one a source and its row in
+// the field data `get_src` gets of the source
+template <typename Source, typename GetSrc>
 std::unique_ptr<DataArray>
-MergeDataArray(
-    std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
-    const FieldMeta& field_meta) {
+MergeRows(std::vector<std::pair<Source, int64_t>>& result_offsets,
+          const FieldMeta& field_meta,
+          GetSrc get_src_array) {
     auto data_type = field_meta.get_data_type();
     auto data_array = std::make_unique<DataArray>();
     data_array->set_field_id(field_meta.get_id().get());
     data_array->set_type(static_cast<milvus::proto::schema::DataType>(
         field_meta.get_data_type()));
 
-    for (auto& result_pair : result_offsets) {
-        auto src_field_data =
-            result_pair.first->output_fields_data_[field_meta.get_id()].get();
-        auto src_offset = result_pair.second;
-        AssertInfo(data_type == DataType(src_field_data->type()),
-                   "merge field data type not consistent");
-        if (field_meta.is_vector()) {
-            auto vector_array = data_array->mutable_vectors();
-            auto dim = field_meta.get_dim();
-            vector_array->set_dim(dim);
-            if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
-                auto data = VEC_FIELD_DATA(src_field_data, float).data();
-                auto obj = vector_array->mutable_float_vector();
-                obj->mutable_data()->Add(data + src_offset * dim,
-                                         data + (src_offset + 1) * dim);
-            } else if (field_meta.get_data_type() == DataType::VECTOR_BINARY) {
-                AssertInfo(
-                    dim % 8 == 0,
-                    "Binary vector field dimension is not a multiple of 8");
-                auto num_bytes = dim / 8;
-                auto data = VEC_FIELD_DATA(src_field_data, binary);
-                auto obj = vector_array->mutable_binary_vector();
-                obj->assign(data + src_offset * num_bytes, num_bytes);
-            } else {
-                PanicInfo("logical error");
-            }
+    if (result_offsets.empty()) {
+        return data_array;
+    }
+
+    // consecutive rows of the same result are copied as one range
+    struct Run {
+        DataArray* src;
+        int64_t begin;
+        int64_t size;
+    };
+    std::vector<Run> runs;
+    Source last_result = nullptr;
+    for (auto& [result, offset] : result_offsets) {
+        if (result == last_result &&
+            runs.back().begin + runs.back().size == offset) {
+            ++runs.back().size;
             continue;
         }
+        auto src =
+            result == last_result ? runs.back().src : get_src_array(result);
+        AssertInfo(data_type == DataType(src->type()),
+                   "merge field data type not consistent");
+        runs.push_back({src, offset, 1});
+        last_result = result;
+    }
+    auto total = int64_t(result_offsets.size());
 
-        auto scalar_array = data_array->mutable_scalars();
-        switch (data_type) {
-            case DataType::BOOL: {
-                auto data = FIELD_DATA(src_field_data, bool).data();
-                auto obj = scalar_array->mutable_bool_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
-            }
-            case DataType::INT8:
-            case DataType::INT16:
-            case DataType::INT32: {
-                auto data = FIELD_DATA(src_field_data, int).data();
-                auto obj = scalar_array->mutable_int_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
-            }
-            case DataType::INT64: {
-                auto data = FIELD_DATA(src_field_data, long).data();
-                auto obj = scalar_array->mutable_long_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
-            }
-            case DataType::FLOAT: {
-                auto data = FIELD_DATA(src_field_data, float).data();
-                auto obj = scalar_array->mutable_float_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
+    if (field_meta.is_vector()) {
+        auto vector_array = data_array->mutable_vectors();
+        auto dim = field_meta.get_dim();
+        vector_array->set_dim(dim);
+        if (data_type == DataType::VECTOR_FLOAT) {
+            auto obj = vector_array->mutable_float_vector()->mutable_data();
+            obj->Reserve(total * dim);
+            for (auto& run : runs) {
+                AppendValues(obj,
+                             VEC_FIELD_DATA(run.src, float).data() +
+                                 run.begin * dim,
+                             run.size * dim);
             }
-            case DataType::DOUBLE: {
-                auto data = FIELD_DATA(src_field_data, double).data();
-                auto obj = scalar_array->mutable_double_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
-            }
-            case DataType::VARCHAR: {
-                auto& data = FIELD_DATA(src_field_data, string);
-                auto obj = scalar_array->mutable_string_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
-            }
-            case DataType::JSON: {
-                auto& data = FIELD_DATA(src_field_data, json);
-                auto obj = scalar_array->mutable_json_data();
-                *(obj->mutable_data()->Add()) = data[src_offset];
-                break;
+        } else if (data_type == DataType::VECTOR_BINARY) {
+            AssertInfo(dim % 8 == 0,
+                       "Binary vector field dimension is not a multiple of 8");
+            auto num_bytes = dim / 8;
+            auto obj = vector_array->mutable_binary_vector();
+            obj->reserve(total * num_bytes);
+            for (auto& run : runs) {
+                obj->append(VEC_FIELD_DATA(run.src, binary).data() +
+                                run.begin * num_bytes,
+                            run.size * num_bytes);
             }
-            default: {
-                PanicInfo(fmt::format("unsupported data type {}", data_type));
+        } else {
+            PanicInfo("logical error");
+        }
+        return data_array;
+    }
+
+    auto scalar_array = data_array->mutable_scalars();
+    // `get_src` points to the values of a result
+    auto append = [&](auto* obj, auto get_src) {
+        obj->Reserve(total);
+        for (auto& run : runs) {
+            AppendValues(obj, get_src(run.src) + run.begin, run.size);
+        }
+    };
+    // every row goes to one slice once, so the strings are moved out of
+    // the results rather than copied
+    auto move_strings = [&](auto* obj, auto get_src) {
+        obj->Reserve(total);
+        for (auto& run : runs) {
+            auto src = get_src(run.src);
+            for (auto i = run.begin; i < run.begin + run.size; ++i) {
+                obj->Add(std::move(*src->Mutable(i)));
             }
         }
+    };
+    switch (data_type) {
+        case DataType::BOOL: {
+            append(scalar_array->mutable_bool_data()->mutable_data(),
+                   [](DataArray* src) { return FIELD_DATA(src, bool).data(); });
+            break;
+        }
+        case DataType::INT8:
+        case DataType::INT16:
+        case DataType::INT32: {
+            append(scalar_array->mutable_int_data()->mutable_data(),
+                   [](DataArray* src) { return FIELD_DATA(src, int).data(); });
+            break;
+        }
+        case DataType::INT64: {
+            append(scalar_array->mutable_long_data()->mutable_data(),
+                   [](DataArray* src) { return FIELD_DATA(src, long).data(); });
+            break;
+        }
+        case DataType::FLOAT: {
+            append(scalar_array->mutable_float_data()->mutable_data(),
+                   [](DataArray* src) {
+                       return FIELD_DATA(src, float).data();
+                   });
+            break;
+        }
+        case DataType::DOUBLE: {
+            append(scalar_array->mutable_double_data()->mutable_data(),
+                   [](DataArray* src) {
+                       return FIELD_DATA(src, double).data();
+                   });
+            break;
+        }
+        case DataType::VARCHAR: {
+            move_strings(
+                scalar_array->mutable_string_data()->mutable_data(),
+                [](DataArray* src) {
+                    return src->mutable_scalars()
+                        ->mutable_string_data()
+                        ->mutable_data();
+                });
+            break;
+        }
+        case DataType::JSON: {
+            move_strings(scalar_array->mutable_json_data()->mutable_data(),
+                         [](DataArray* src) {
+                             return src->mutable_scalars()
+                                 ->mutable_json_data()
+                                 ->mutable_data();
+                         });
+            break;
+        }
+        default: {
+            PanicInfo(fmt::format("unsupported data type {}", data_type));
+        }
     }
 
     return data_array;
 }
 
+}  // namespace
+
+// TODO remove merge dataArray, instead fill target entity when get data slice
+std::unique_ptr<DataArray>
+MergeDataArray(
+    std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
+    const FieldMeta& field_meta) {
+    return MergeRows(
+        result_offsets, field_meta, [&](milvus::SearchResult* result) {
+            return result->output_fields_data_[field_meta.get_id()].get();
+        });
+}
+
+std::unique_ptr<DataArray>
+MergeDataArray(std::vector<std::pair<DataArray*, int64_t>>& rows,
+               const FieldMeta& field_meta) {
+    return MergeRows(
+        rows, field_meta, [](DataArray* data_array) { return data_array; });
+}
+
 // TODO: split scalar IndexBase with knowhere::Index
+int64_t
+EstimateTargetEntryBytes(const Schema& schema,
+                         const std::vector<FieldId>& fields,
+                         int64_t rows) {
+    int64_t bytes = 0;
+    for (auto field_id : fields) {
+        bytes += rows * int64_t(schema[field_id].get_sizeof());
+    }
+    return bytes;
+}
+
 std::unique_ptr<DataArray>
 ReverseDataFromIndex(const index::IndexBase* index,
                      const int64_t* seg_offsets,
@@ -417,21 +630,17 @@ ReverseDataFromIndex(const index::IndexBase* index,
         case DataType::BOOL: {
             using IndexType = index::ScalarIndex<bool>;
             auto ptr = dynamic_cast<const IndexType*>(index);
-            std::vector<bool> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            std::unique_ptr<bool[]> raw_data(new bool[count]);
+            ptr->ReverseLookup(seg_offsets, count, raw_data.get());
             auto obj = scalar_array->mutable_bool_data();
-            *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
+            *(obj->mutable_data()) = {raw_data.get(), raw_data.get() + count};
             break;
         }
         case DataType::INT8: {
             using IndexType = index::ScalarIndex<int8_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int8_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_int_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -440,9 +649,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<int16_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int16_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_int_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -451,9 +658,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<int32_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int32_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_int_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -462,9 +667,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<int64_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int64_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_long_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -473,9 +676,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<float>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<float> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_float_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -484,9 +685,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<double>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<double> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_double_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -495,11 +694,12 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<std::string>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<std::string> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookup(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_string_data();
-            *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
+            obj->mutable_data()->Reserve(count);
+            for (auto& str : raw_data) {
+                obj->add_data(std::move(str));
+            }
             break;
         }
         default: {
@@ -18,21 +18,36 @@
 #include <utility>
 #include <vector>
 
+#include "common/Metrics.h"
 #include "common/QueryResult.h"
 #include "segcore/DeletedRecord.h"
 #include "segcore/InsertRecord.h"
 #include "index/Index.h"
+#include "storage/FieldData.h"
 
 namespace milvus::segcore {
 
 void
 ParsePksFromFieldData(std::vector<PkType>& pks, const DataArray& data);
 
+void
+ParseGroupByValuesFromFieldData(std::vector<GroupByValueType>& values,
+                                const DataArray& data);
+
 void
 ParsePksFromIDs(std::vector<PkType>& pks,
                 DataType data_type,
                 const IdArray& data);
 
+// appends the deletes of the string payload of a delta log, each one a
+// json {"pk": .., "ts": .., "pkType": ..} or "pk,ts" of an int64 pk as
+// written by older versions
+void
+ParseDeleteLogs(std::vector<PkType>& pks,
+                std::vector<Timestamp>& timestamps,
+                DataType data_type,
+                const storage::FieldDataBase& payload);
+
 int64_t
 GetSizeOfIdArray(const IdArray& data);
 
@@ -44,6 +59,11 @@ CreateScalarDataArray(int64_t count, const FieldMeta& field_meta);
 std::unique_ptr<DataArray>
 CreateVectorDataArray(int64_t count, const FieldMeta& field_meta);
 
+// raw storage of the vectors of a DataArray created by CreateVectorDataArray,
+// so bulk_subscript can gather rows into it without a temporary copy
+char*
+GetMutableVectorData(DataArray* data_array, const FieldMeta& field_meta);
+
 std::unique_ptr<DataArray>
 CreateScalarDataArrayFrom(const void* data_raw,
                           int64_t count,
@@ -65,6 +85,11 @@ MergeDataArray(
     std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
     const FieldMeta& field_meta);
 
+// same as above, each row taken from a field data, whose strings are moved
+std::unique_ptr<DataArray>
+MergeDataArray(std::vector<std::pair<DataArray*, int64_t>>& rows,
+               const FieldMeta& field_meta);
+
 template <bool is_sealed>
 std::shared_ptr<DeletedRecord::TmpBitmap>
 get_deleted_bitmap(int64_t del_barrier,
@@ -75,13 +100,16 @@ get_deleted_bitmap(int64_t del_barrier,
     // if insert_barrier and del_barrier have not changed, use cache data directly
     bool hit_cache = false;
     int64_t old_del_barrier = 0;
+    auto entries_lock = delete_record.lock_entries();
     auto current = delete_record.clone_lru_entry(
         insert_barrier, del_barrier, old_del_barrier, hit_cache);
     if (hit_cache) {
+        monitor::delete_bitmap_cache_hits.Inc();
         return current;
     }
+    monitor::delete_bitmap_cache_misses.Inc();
 
-    auto bitmap = current->bitmap_ptr;
+    auto& bitmap = current->bitmap;
 
     int64_t start, end;
     if (del_barrier < old_del_barrier) {
@@ -101,40 +129,77 @@ get_deleted_bitmap(int64_t del_barrier,
     // Avoid invalid calculations when there are a lot of repeated delete pks
     std::unordered_map<PkType, Timestamp> delete_timestamps;
     for (auto del_index = start; del_index < end; ++del_index) {
-        auto pk = delete_record.pks_[del_index];
-        auto timestamp = delete_record.timestamps_[del_index];
+        auto pk = delete_record.get_pk(del_index);
+        auto timestamp = delete_record.get_timestamp(del_index);
 
         delete_timestamps[pk] = timestamp > delete_timestamps[pk]
                                     ? timestamp
                                     : delete_timestamps[pk];
     }
 
+    // look the pks up in one batch
+    std::vector<PkType> pks;
+    std::vector<Timestamp> timestamps;
+    pks.reserve(delete_timestamps.size());
+    timestamps.reserve(delete_timestamps.size());
     for (auto& [pk, timestamp] : delete_timestamps) {
-        auto segOffsets = insert_record.search_pk(pk, insert_barrier);
-        for (auto offset : segOffsets) {
-            int64_t insert_row_offset = offset.get();
-
-            // The deletion record do not take effect in search/query,
-            // and reset bitmap to 0
-            if (timestamp > query_timestamp) {
-                bitmap->reset(insert_row_offset);
-                continue;
-            }
-            // Insert after delete with same pk, delete will not task effect on this insert record,
-            // and reset bitmap to 0
-            if (insert_record.timestamps_[insert_row_offset] >= timestamp) {
-                bitmap->reset(insert_row_offset);
-                continue;
-            }
-            // insert data corresponding to the insert_row_offset will be ignored in search/query
-            bitmap->set(insert_row_offset);
+        pks.push_back(pk);
+        timestamps.push_back(timestamp);
+    }
+    std::vector<OffsetMap::PkOffset> pk_offsets;
+    insert_record.search_pks(
+        pks.data(), pks.size(), insert_barrier, pk_offsets);
+
+    for (auto& [pk_index, insert_row_offset] : pk_offsets) {
+        auto timestamp = timestamps[pk_index];
+        // The deletion record do not take effect in search/query,
+        // and reset bitmap to 0
+        if (timestamp > query_timestamp) {
+            bitmap.reset(insert_row_offset);
+            continue;
         }
+        // Insert after delete with same pk, delete will not task effect on this insert record,
+        // and reset bitmap to 0
+        if (insert_record.timestamp_at(insert_row_offset) >= timestamp) {
+            bitmap.reset(insert_row_offset);
+            continue;
+        }
+        // insert data corresponding to the insert_row_offset will be ignored in search/query
+        bitmap.set(insert_row_offset);
     }
 
     delete_record.insert_lru_entry(current);
     return current;
 }
 
+// folds the deletes up to `oldest_query_ts` into the final bitmap of the
+// first `insert_barrier` rows, returns the number of entries compacted so
+// far. No query older than `oldest_query_ts` may come afterwards.
+template <bool is_sealed>
+int64_t
+compact_deleted_record(DeletedRecord& delete_record,
+                       const InsertRecord<is_sealed>& insert_record,
+                       int64_t insert_barrier,
+                       Timestamp oldest_query_ts) {
+    auto del_barrier = get_barrier(delete_record, oldest_query_ts);
+    if (del_barrier > delete_record.compacted_count()) {
+        auto bitmap = get_deleted_bitmap(del_barrier,
+                                         insert_barrier,
+                                         delete_record,
+                                         insert_record,
+                                         oldest_query_ts);
+        delete_record.compact(std::move(bitmap));
+    }
+    return delete_record.compacted_count();
+}
+
+// bytes gathered to fill `fields` of `rows` results, strings count at their
+// max length
+int64_t
+EstimateTargetEntryBytes(const Schema& schema,
+                         const std::vector<FieldId>& fields,
+                         int64_t rows);
+
 std::unique_ptr<DataArray>
 ReverseDataFromIndex(const index::IndexBase* index,
                      const int64_t* seg_offsets,
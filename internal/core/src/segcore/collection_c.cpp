@@ -14,8 +14,11 @@
 #endif
 
 #include <iostream>
+#include "common/CGoHelper.h"
+#include "pb/schema.pb.h"
 #include "segcore/collection_c.h"
 #include "segcore/Collection.h"
+#include "segcore/Utils.h"
 
 CCollection
 NewCollection(const char* schema_proto_blob) {
@@ -42,3 +45,46 @@ GetCollectionName(CCollection collection) {
     auto col = (milvus::segcore::Collection*)collection;
     return strdup(col->get_collection_name().data());
 }
+
+CStatus
+AppendCollectionDeletes(CCollection collection,
+                        int64_t size,
+                        const uint8_t* ids,
+                        const uint64_t ids_size,
+                        const uint64_t* timestamps) {
+    try {
+        auto col = (milvus::segcore::Collection*)collection;
+        milvus::proto::schema::IDs id_array;
+        auto suc = id_array.ParseFromArray(ids, ids_size);
+        AssertInfo(suc, "failed to parse pks from ids");
+        auto& schema = *col->get_schema();
+        auto pk_field_id =
+            schema.get_primary_field_id().value_or(milvus::FieldId(-1));
+        AssertInfo(pk_field_id.get() != -1, "Primary key is -1");
+        std::vector<milvus::PkType> pks(size);
+        milvus::segcore::ParsePksFromIDs(
+            pks, schema[pk_field_id].get_data_type(), id_array);
+        col->get_delete_buffer()->push(pks.data(), timestamps, size);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+int64_t
+CompactCollectionDeletes(CCollection collection, uint64_t oldest_query_ts) {
+    auto col = (milvus::segcore::Collection*)collection;
+    return col->get_delete_buffer()->compact(oldest_query_ts);
+}
+
+int64_t
+GetCollectionDeletesMemoryBytes(CCollection collection) {
+    auto col = (milvus::segcore::Collection*)collection;
+    return col->get_delete_buffer()->memory_bytes();
+}
+
+void
+SetCollectionTtl(CCollection collection, int64_t ttl_ms) {
+    auto col = (milvus::segcore::Collection*)collection;
+    col->get_ttl()->set_ttl_ms(ttl_ms);
+}
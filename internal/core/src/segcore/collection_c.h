@@ -11,6 +11,10 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include "common/type_c.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,6 +33,32 @@ DeleteCollection(CCollection collection);
 const char*
 GetCollectionName(CCollection collection);
 
+// deletes of the collection, stored once and masked by every segment
+// created from it rather than passed to each of them with Delete; ids is a
+// serialized IDs of `size` pks deleted at `timestamps`
+CStatus
+AppendCollectionDeletes(CCollection collection,
+                        int64_t size,
+                        const uint8_t* ids,
+                        const uint64_t ids_size,
+                        const uint64_t* timestamps);
+
+// folds the deletes of the collection not after `oldest_query_ts` into the
+// last of each pk, no query may be older afterwards; returns the number of
+// deletes left
+int64_t
+CompactCollectionDeletes(CCollection collection, uint64_t oldest_query_ts);
+
+// bytes of the deletes of the collection
+int64_t
+GetCollectionDeletesMemoryBytes(CCollection collection);
+
+// the rows of the segments created from the collection are expired once
+// they are `ttl_ms` older than the query timestamp, masked until compaction
+// drops them; 0 disables it
+void
+SetCollectionTtl(CCollection collection, int64_t ttl_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,13 +11,22 @@
 
 #include "segcore/load_index_c.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+
 #include "common/CDataType.h"
 #include "common/FieldMeta.h"
+#include "common/Numa.h"
+#include "common/Slice.h"
 #include "common/Utils.h"
 #include "index/IndexFactory.h"
 #include "index/Meta.h"
 #include "index/Utils.h"
+#include "segcore/LoadResource.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/Types.h"
+#include "storage/MinioChunkManager.h"
 #include "storage/Util.h"
 
 CStatus
@@ -152,7 +161,25 @@ appendVecIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
         auto config = milvus::index::ParseConfigFromIndexParams(
             load_index_info->index_params);
         config["index_files"] = load_index_info->index_files;
+        auto warmup_queries = milvus::segcore::SegcoreConfig::default_config()
+                                  .get_index_warmup_queries();
+        if (!config.contains(milvus::index::WARMUP_QUERIES) &&
+            warmup_queries > 0) {
+            config[milvus::index::WARMUP_QUERIES] =
+                std::to_string(warmup_queries);
+        }
+        if (!load_index_info->mmap_dir_path.empty()) {
+            auto filepath =
+                std::filesystem::path(load_index_info->mmap_dir_path) /
+                std::to_string(load_index_info->segment_id) /
+                std::to_string(load_index_info->index_id);
+            config[milvus::index::MMAP_FILE_PATH] = filepath.string();
+        }
 
+        milvus::numa::ScopedMemoryPolicy numa_policy(
+            load_index_info->numa_node);
+        milvus::segcore::SegmentArena::Scope arena_scope(
+            load_index_info->arena.get());
         load_index_info->index =
             milvus::index::IndexFactory::GetInstance().CreateIndex(
                 index_info, file_manager);
@@ -185,7 +212,15 @@ appendScalarIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
         milvus::index::CreateIndexInfo index_info;
         index_info.field_type = milvus::DataType(field_type);
         index_info.index_type = index_params["index_type"];
+        // the index build may have picked a bitmap index on its own
+        if (binary_set->Contains(milvus::index::BITMAP_INDEX_META)) {
+            index_info.index_type = milvus::index::BITMAP_INDEX_TYPE;
+        }
 
+        milvus::numa::ScopedMemoryPolicy numa_policy(
+            load_index_info->numa_node);
+        milvus::segcore::SegmentArena::Scope arena_scope(
+            load_index_info->arena.get());
         load_index_info->index =
             milvus::index::IndexFactory::GetInstance().CreateIndex(index_info,
                                                                    nullptr);
@@ -212,6 +247,97 @@ AppendIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
     return appendScalarIndex(c_load_index_info, c_binary_set);
 }
 
+CStatus
+AppendIndexFromFiles(CLoadIndexInfo c_load_index_info) {
+    try {
+        auto load_index_info =
+            (milvus::segcore::LoadIndexInfo*)c_load_index_info;
+        auto& index_params = load_index_info->index_params;
+        AssertInfo(index_params.find("index_type") != index_params.end(),
+                   "index type is empty");
+        auto& index_type = index_params.at("index_type");
+        std::unique_ptr<milvus::storage::MinioChunkManager> rcm;
+
+        // the load waits until the peak estimated from the sizes of the
+        // index files fits the load budget of the node
+        std::unique_ptr<milvus::segcore::LoadResourceLease> lease;
+        auto& load_resources =
+            milvus::segcore::LoadResourceManager::GetInstance();
+        if (load_resources.HasBudget()) {
+            rcm = std::make_unique<milvus::storage::MinioChunkManager>(
+                load_index_info->storage_config);
+            int64_t index_bytes = 0;
+            for (auto& file : load_index_info->index_files) {
+                index_bytes += rcm->Size(file);
+            }
+            lease = load_resources.Acquire(
+                milvus::segcore::EstimateIndexLoadResource(
+                    index_type,
+                    index_bytes,
+                    !load_index_info->mmap_dir_path.empty()));
+        }
+
+        // disk indexes are cached from the files by their file manager
+        if (milvus::index::is_in_disk_list(index_type)) {
+            knowhere::BinarySet binary_set;
+            return AppendIndex(c_load_index_info, &binary_set);
+        }
+
+        // the slice meta is loaded first to place the slices it describes
+        auto files = load_index_info->index_files;
+        auto key_of = [](const std::string& file) {
+            return std::filesystem::path(file).filename().string();
+        };
+        std::stable_partition(
+            files.begin(), files.end(), [&](const std::string& file) {
+                return key_of(file) == milvus::INDEX_FILE_SLICE_META;
+            });
+        if (rcm == nullptr) {
+            rcm = std::make_unique<milvus::storage::MinioChunkManager>(
+                load_index_info->storage_config);
+        }
+
+        // the binaries alias the decoded payloads of the index files, which
+        // live as long as the binary set, so nothing is copied before the
+        // index loads them; the slices are copied into the binaries they
+        // are of and released as they arrive, so Assemble has nothing left
+        // to do
+        knowhere::BinarySet binary_set;
+        std::optional<milvus::SliceAssembler> assembler;
+        size_t i = 0;
+        milvus::storage::DownloadAndDecodeRemoteFiles(
+            rcm.get(),
+            files,
+            milvus::segcore::SegcoreConfig::default_config()
+                .get_index_load_inflight(),
+            [&](const milvus::storage::FieldDataPtr& field_data) {
+                auto key = key_of(files[i++]);
+                auto bytes = (uint8_t*)field_data->Data();
+                std::shared_ptr<uint8_t[]> data(field_data, bytes);
+                if (key == milvus::INDEX_FILE_SLICE_META) {
+                    auto slice_meta = std::make_shared<knowhere::Binary>();
+                    slice_meta->data = data;
+                    slice_meta->size = field_data->Size();
+                    assembler.emplace(slice_meta);
+                    return;
+                }
+                if (!assembler.has_value() ||
+                    !assembler->Place(key, bytes, field_data->Size())) {
+                    binary_set.Append(key, data, field_data->Size());
+                }
+            });
+        if (assembler.has_value()) {
+            assembler->Finish(binary_set);
+        }
+        return AppendIndex(c_load_index_info, &binary_set);
+    } catch (std::exception& e) {
+        auto status = CStatus();
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+        return status;
+    }
+}
+
 CStatus
 AppendIndexFilePath(CLoadIndexInfo c_load_index_info, const char* c_file_path) {
     try {
@@ -232,6 +358,46 @@ AppendIndexFilePath(CLoadIndexInfo c_load_index_info, const char* c_file_path) {
     }
 }
 
+CStatus
+AppendMMapDirPath(CLoadIndexInfo c_load_index_info, const char* c_dir_path) {
+    try {
+        auto load_index_info =
+            (milvus::segcore::LoadIndexInfo*)c_load_index_info;
+        load_index_info->mmap_dir_path = std::string(c_dir_path);
+
+        auto status = CStatus();
+        status.error_code = Success;
+        status.error_msg = "";
+        return status;
+    } catch (std::exception& e) {
+        auto status = CStatus();
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+        return status;
+    }
+}
+
+CStatus
+AppendNumaNode(CLoadIndexInfo c_load_index_info, int numa_node) {
+    try {
+        auto load_index_info =
+            (milvus::segcore::LoadIndexInfo*)c_load_index_info;
+        AssertInfo(numa_node >= -1 && numa_node < milvus::numa::NumNodes(),
+                   "invalid numa node " + std::to_string(numa_node));
+        load_index_info->numa_node = numa_node;
+
+        auto status = CStatus();
+        status.error_code = Success;
+        status.error_msg = "";
+        return status;
+    } catch (std::exception& e) {
+        auto status = CStatus();
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+        return status;
+    }
+}
+
 CStatus
 AppendIndexInfo(CLoadIndexInfo c_load_index_info,
                 int64_t index_id,
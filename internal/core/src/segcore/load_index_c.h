@@ -52,9 +52,22 @@ AppendIndexInfo(CLoadIndexInfo c_load_index_info,
 CStatus
 AppendIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set);
 
+// downloads the appended index files and loads the index of any type from
+// them, so the index binaries don't pass through the caller
+CStatus
+AppendIndexFromFiles(CLoadIndexInfo c_load_index_info);
+
 CStatus
 AppendIndexFilePath(CLoadIndexInfo c_load_index_info, const char* file_path);
 
+CStatus
+AppendMMapDirPath(CLoadIndexInfo c_load_index_info, const char* dir_path);
+
+// the memory of the index appended after it prefers `numa_node`, usually
+// the node of the segment it's loaded into
+CStatus
+AppendNumaNode(CLoadIndexInfo c_load_index_info, int numa_node);
+
 CStatus
 CleanLoadedIndex(CLoadIndexInfo c_load_index_info);
 
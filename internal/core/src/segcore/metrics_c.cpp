@@ -11,14 +11,20 @@
 
 #include <string>
 
+#include "common/Metrics.h"
 #include "knowhere/prometheus_client.h"
+#include "segcore/PlanCache.h"
 #include "segcore/metrics_c.h"
 
 char*
 GetKnowhereMetrics() {
-    auto str = knowhere::prometheusClient->GetMetrics();
+    // the metrics of segcore follow the ones of knowhere
+    auto str = knowhere::prometheusClient->GetMetrics() +
+               milvus::segcore::PlanCache::GetInstance().Metrics() +
+               milvus::monitor::SerializeSegcoreMetrics();
     auto len = str.length();
     char* res = (char*)malloc(len + 1);
     memcpy(res, str.data(), len);
+    res[len] = 0;
     return res;
 }
@@ -11,8 +11,11 @@
 
 #include "common/CGoHelper.h"
 #include "pb/segcore.pb.h"
+#include "query/Aggregate.h"
+#include "query/OrderBy.h"
 #include "query/Plan.h"
 #include "segcore/Collection.h"
+#include "segcore/PlanCache.h"
 #include "segcore/plan_c.h"
 
 CStatus
@@ -52,13 +55,13 @@ CreateSearchPlanByExpr(CCollection c_col,
     auto col = (milvus::segcore::Collection*)c_col;
 
     try {
-        auto res = milvus::query::CreateSearchPlanByExpr(
-            *col->get_schema(), serialized_expr_plan, size);
+        auto res = milvus::segcore::PlanCache::GetInstance().Acquire(
+            col->get_schema(), serialized_expr_plan, size);
 
         auto status = CStatus();
         status.error_code = Success;
         status.error_msg = "";
-        auto plan = (CSearchPlan)res.release();
+        auto plan = (CSearchPlan)res;
         *res_plan = plan;
         return status;
     } catch (milvus::SegcoreError& e) {
@@ -136,7 +139,9 @@ GetMetricType(CSearchPlan plan) {
 void
 DeleteSearchPlan(CSearchPlan cPlan) {
     auto plan = (milvus::query::Plan*)cPlan;
-    delete plan;
+    if (!milvus::segcore::PlanCache::GetInstance().Release(plan)) {
+        delete plan;
+    }
 }
 
 void
@@ -178,6 +183,54 @@ CreateRetrievePlanByExpr(CCollection c_col,
     }
 }
 
+void
+SetRetrievePlanLimit(CRetrievePlan c_plan, int64_t limit) {
+    auto plan = (milvus::query::RetrievePlan*)c_plan;
+    plan->plan_node_->limit_ = limit;
+}
+
+CStatus
+AddRetrievePlanAggregate(CRetrievePlan c_plan,
+                         CAggregateOp op,
+                         int64_t field_id) {
+    try {
+        auto plan = (milvus::query::RetrievePlan*)c_plan;
+        AssertInfo(op >= AggregateCount && op <= AggregateSum,
+                   "invalid aggregate op " + std::to_string(op));
+        milvus::query::Aggregate aggregate{milvus::query::AggregateOp(op),
+                                           milvus::FieldId(field_id)};
+        if (aggregate.op_ != milvus::query::AggregateOp::Count) {
+            auto& field_meta = plan->schema_[aggregate.field_id_];
+            AssertInfo(milvus::query::IsAggregatable(
+                           aggregate.op_, field_meta.get_data_type()),
+                       "field " + std::to_string(field_id) +
+                           " can't be aggregated");
+        }
+        plan->plan_node_->aggregates_.push_back(aggregate);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SetRetrievePlanOrderBy(CRetrievePlan c_plan,
+                       int64_t field_id,
+                       bool descending) {
+    try {
+        auto plan = (milvus::query::RetrievePlan*)c_plan;
+        auto& field_meta = plan->schema_[milvus::FieldId(field_id)];
+        AssertInfo(milvus::query::IsOrderable(field_meta.get_data_type()),
+                   "field " + std::to_string(field_id) +
+                       " can't order the retrieve");
+        plan->plan_node_->order_by_ =
+            milvus::query::OrderBy{milvus::FieldId(field_id), descending};
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 void
 DeleteRetrievePlan(CRetrievePlan c_plan) {
     auto plan = (milvus::query::RetrievePlan*)c_plan;
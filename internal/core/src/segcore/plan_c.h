@@ -23,6 +23,16 @@ typedef void* CSearchPlan;
 typedef void* CPlaceholderGroup;
 typedef void* CRetrievePlan;
 
+// the values must match milvus::query::AggregateOp
+enum CAggregateOp {
+    AggregateCount = 0,
+    AggregateMin = 1,
+    AggregateMax = 2,
+    AggregateSum = 3,
+};
+
+typedef enum CAggregateOp CAggregateOp;
+
 CStatus
 CreateSearchPlan(CCollection col, const char* dsl, CSearchPlan* res_plan);
 
@@ -63,6 +73,22 @@ CreateRetrievePlanByExpr(CCollection c_col,
                          const int64_t size,
                          CRetrievePlan* res_plan);
 
+// the retrieve stops once `limit` matching rows are found, a limit which
+// isn't positive retrieves them all
+void
+SetRetrievePlanLimit(CRetrievePlan plan, int64_t limit);
+
+// the retrieve returns `op` over `field_id` of the matching rows, after the
+// aggregates added before, instead of the rows. Min, Max and Sum take a
+// numeric field, Count ignores it.
+CStatus
+AddRetrievePlanAggregate(CRetrievePlan plan, CAggregateOp op, int64_t field_id);
+
+// the retrieve returns the first rows of its limit, all of them without
+// one, in the order of `field_id`, a numeric or VARCHAR field
+CStatus
+SetRetrievePlanOrderBy(CRetrievePlan plan, int64_t field_id, bool descending);
+
 void
 DeleteRetrievePlan(CRetrievePlan plan);
 
@@ -0,0 +1,65 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/profiler_c.h"
+
+#include "common/CGoHelper.h"
+#include "exceptions/EasyAssert.h"
+#include "segcore/Profiler.h"
+
+CStatus
+StartCpuProfile(const char* path, int64_t seconds) {
+    try {
+        milvus::segcore::CpuProfiler::GetInstance().Start(path, seconds);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+StopCpuProfile() {
+    try {
+        AssertInfo(milvus::segcore::CpuProfiler::GetInstance().Stop(),
+                   "no cpu profile is running");
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+DumpHeapProfile(const char* path) {
+    try {
+        milvus::segcore::DumpHeapProfile(path);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+GetJemallocStats(CJemallocStats* stats) {
+    try {
+        auto result = milvus::segcore::GetJemallocStats();
+        stats->allocated = result.allocated;
+        stats->active = result.active;
+        stats->resident = result.resident;
+        stats->mapped = result.mapped;
+        stats->retained = result.retained;
+        stats->metadata = result.metadata;
+        stats->narenas = result.narenas;
+        stats->fragmentation = result.fragmentation;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
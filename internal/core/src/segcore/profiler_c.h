@@ -0,0 +1,51 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "common/type_c.h"
+
+typedef struct CJemallocStats {
+    int64_t allocated;
+    int64_t active;
+    int64_t resident;
+    int64_t mapped;
+    int64_t retained;
+    int64_t metadata;
+    int64_t narenas;
+    // the share of the active pages not allocated
+    double fragmentation;
+} CJemallocStats;
+
+// profiles the cpu of the node into `path` for `seconds`, until
+// StopCpuProfile for a non positive duration, needs gperftools loaded
+CStatus
+StartCpuProfile(const char* path, int64_t seconds);
+
+// stops the running cpu profile early and writes it
+CStatus
+StopCpuProfile();
+
+// writes a heap profile of jemalloc running with prof:true to `path`
+CStatus
+DumpHeapProfile(const char* path);
+
+CStatus
+GetJemallocStats(CJemallocStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,12 +9,17 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <memory>
 #include <vector>
 #include "Reduce.h"
 #include "common/CGoHelper.h"
+#include "common/CpuGroup.h"
 #include "common/QueryResult.h"
+#include "common/Tracer.h"
 #include "exceptions/EasyAssert.h"
 #include "query/Plan.h"
+#include "segcore/ReduceRetrieve.h"
+#include "segcore/SegmentInterface.h"
 #include "segcore/reduce_c.h"
 #include "segcore/Utils.h"
 
@@ -39,7 +44,9 @@ ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
 
         auto reduce_helper = milvus::segcore::ReduceHelper(
             search_results, plan, slice_nqs, slice_topKs, num_slices);
+        milvus::CpuGroupScope cpu_group_scope(reduce_helper.cpu_group());
         reduce_helper.Reduce();
+        reduce_helper.FillEntryData();
         reduce_helper.Marshal();
 
         // set final result ptr
@@ -50,6 +57,212 @@ ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
     }
 }
 
+CStatus
+SearchAndReduceSegments(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                        CSegmentInterface* c_segments,
+                        int64_t num_segments,
+                        CSearchPlan c_plan,
+                        CPlaceholderGroup c_placeholder_group,
+                        CTraceContext c_trace,
+                        uint64_t timestamp,
+                        int64_t* slice_nqs,
+                        int64_t* slice_topKs,
+                        int64_t num_slices) {
+    try {
+        auto plan = static_cast<milvus::query::Plan*>(c_plan);
+        AssertInfo(num_segments > 0, "num_segments must be greater than 0");
+        std::vector<const milvus::segcore::SegmentInterface*> segments(
+            num_segments);
+        for (int i = 0; i < num_segments; ++i) {
+            segments[i] = static_cast<const milvus::segcore::SegmentInterface*>(
+                c_segments[i]);
+        }
+        auto phg_ptr = static_cast<const milvus::query::PlaceholderGroup*>(
+            c_placeholder_group);
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreSearchAndReduce", &ctx);
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segments[0]->get_cpu_group()));
+
+        // every result is merged as soon as its segment is searched, the
+        // results are only referenced until the blobs are marshaled
+        auto reduce_helper = milvus::segcore::ReduceHelper(
+            plan, slice_nqs, slice_topKs, num_slices);
+        auto owned_results = milvus::segcore::SearchSegments(
+            segments,
+            plan,
+            phg_ptr,
+            timestamp,
+            [&](SearchResult* result) { reduce_helper.Push(result); });
+        reduce_helper.Finish();
+        reduce_helper.FillEntryData();
+        reduce_helper.Marshal();
+
+        *cSearchResultDataBlobs = reduce_helper.GetSearchResultDataBlobs();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+RetrieveAndReduceSegments(CSegmentInterface* c_segments,
+                          int64_t num_segments,
+                          CRetrievePlan c_plan,
+                          CTraceContext c_trace,
+                          uint64_t timestamp,
+                          CRetrieveResult* result) {
+    try {
+        auto plan = static_cast<const milvus::query::RetrievePlan*>(c_plan);
+        AssertInfo(num_segments > 0, "num_segments must be greater than 0");
+        std::vector<const milvus::segcore::SegmentInterface*> segments(
+            num_segments);
+        for (int i = 0; i < num_segments; ++i) {
+            segments[i] = static_cast<const milvus::segcore::SegmentInterface*>(
+                c_segments[i]);
+        }
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreRetrieveAndReduce",
+                                               &ctx);
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segments[0]->get_cpu_group()));
+
+        auto retrieve_result = milvus::segcore::ReduceRetrieveResults(
+            segments, plan, timestamp);
+        auto size = retrieve_result->ByteSizeLong();
+        void* buffer = malloc(size);
+        retrieve_result->SerializePartialToArray(buffer, size);
+        result->proto_blob = buffer;
+        result->proto_size = size;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+ReduceSearchResults(CReducedSearchResults* cReducedSearchResults,
+                    CSearchPlan c_plan,
+                    CSearchResult* c_search_results,
+                    int64_t num_segments,
+                    int64_t* slice_nqs,
+                    int64_t* slice_topKs,
+                    int64_t num_slices) {
+    try {
+        auto plan = static_cast<milvus::query::Plan*>(c_plan);
+        AssertInfo(num_segments > 0, "num_segments must be greater than 0");
+        std::vector<SearchResult*> search_results(num_segments);
+        for (int i = 0; i < num_segments; ++i) {
+            search_results[i] = static_cast<SearchResult*>(c_search_results[i]);
+        }
+
+        auto reduce_helper = std::make_unique<milvus::segcore::ReduceHelper>(
+            search_results, plan, slice_nqs, slice_topKs, num_slices);
+        milvus::CpuGroupScope cpu_group_scope(reduce_helper->cpu_group());
+        reduce_helper->Reduce();
+
+        *cReducedSearchResults = reduce_helper.release();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        *cReducedSearchResults = nullptr;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+FillReducedSearchResults(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                         CReducedSearchResults cReducedSearchResults) {
+    try {
+        AssertInfo(cReducedSearchResults != nullptr,
+                   "reduced search results must not be null");
+        auto reduce_helper = static_cast<milvus::segcore::ReduceHelper*>(
+            cReducedSearchResults);
+        milvus::CpuGroupScope cpu_group_scope(reduce_helper->cpu_group());
+        reduce_helper->FillEntryData();
+        reduce_helper->Marshal();
+
+        *cSearchResultDataBlobs = reduce_helper->GetSearchResultDataBlobs();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+void
+DeleteReducedSearchResults(CReducedSearchResults cReducedSearchResults) {
+    if (cReducedSearchResults == nullptr) {
+        return;
+    }
+    delete static_cast<milvus::segcore::ReduceHelper*>(cReducedSearchResults);
+}
+
+CStatus
+NewStreamReduce(CStreamReduce* cStreamReduce,
+                CSearchPlan c_plan,
+                int64_t* slice_nqs,
+                int64_t* slice_topKs,
+                int64_t num_slices) {
+    try {
+        auto plan = static_cast<milvus::query::Plan*>(c_plan);
+        *cStreamReduce = new milvus::segcore::ReduceHelper(
+            plan, slice_nqs, slice_topKs, num_slices);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        *cStreamReduce = nullptr;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+StreamReducePush(CStreamReduce cStreamReduce, CSearchResult c_search_result) {
+    try {
+        AssertInfo(cStreamReduce != nullptr, "stream reduce must not be null");
+        auto reduce_helper =
+            static_cast<milvus::segcore::ReduceHelper*>(cStreamReduce);
+        auto search_result = static_cast<SearchResult*>(c_search_result);
+        AssertInfo(search_result != nullptr, "search result must not be null");
+        auto segment =
+            static_cast<const milvus::segcore::SegmentInterface*>(
+                search_result->segment_);
+        milvus::CpuGroupScope cpu_group_scope(
+            segment != nullptr ? milvus::GetCpuGroup(segment->get_cpu_group())
+                               : nullptr);
+        reduce_helper->Push(search_result);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+FinishStreamReduce(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                   CStreamReduce cStreamReduce) {
+    try {
+        AssertInfo(cStreamReduce != nullptr, "stream reduce must not be null");
+        auto reduce_helper =
+            static_cast<milvus::segcore::ReduceHelper*>(cStreamReduce);
+        milvus::CpuGroupScope cpu_group_scope(reduce_helper->cpu_group());
+        reduce_helper->Finish();
+        reduce_helper->FillEntryData();
+        reduce_helper->Marshal();
+
+        *cSearchResultDataBlobs = reduce_helper->GetSearchResultDataBlobs();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+void
+DeleteStreamReduce(CStreamReduce cStreamReduce) {
+    if (cStreamReduce == nullptr) {
+        return;
+    }
+    delete static_cast<milvus::segcore::ReduceHelper*>(cStreamReduce);
+}
+
 CStatus
 GetSearchResultDataBlob(CProto* searchResultDataBlob,
                         CSearchResultDataBlobs cSearchResultDataBlobs,
@@ -58,12 +271,13 @@ GetSearchResultDataBlob(CProto* searchResultDataBlob,
         auto search_result_data_blobs =
             reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(
                 cSearchResultDataBlobs);
-        AssertInfo(blob_index < search_result_data_blobs->blobs.size(),
+        AssertInfo(blob_index >= 0 &&
+                       blob_index < search_result_data_blobs->size(),
                    "blob_index out of range");
         searchResultDataBlob->proto_blob =
-            search_result_data_blobs->blobs[blob_index].data();
+            search_result_data_blobs->blob_data(blob_index);
         searchResultDataBlob->proto_size =
-            search_result_data_blobs->blobs[blob_index].size();
+            search_result_data_blobs->blob_size(blob_index);
         return milvus::SuccessCStatus();
     } catch (std::exception& e) {
         searchResultDataBlob->proto_blob = nullptr;
@@ -28,6 +28,77 @@ ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
                                int64_t* slice_topKs,
                                int64_t num_slices);
 
+// search the segments and reduce their results in one call, the per segment
+// results never cross the C boundary
+CStatus
+SearchAndReduceSegments(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                        CSegmentInterface* c_segments,
+                        int64_t num_segments,
+                        CSearchPlan c_plan,
+                        CPlaceholderGroup c_placeholder_group,
+                        CTraceContext c_trace,
+                        uint64_t timestamp,
+                        int64_t* slice_nqs,
+                        int64_t* slice_topKs,
+                        int64_t num_slices);
+
+// retrieve the segments and merge their rows by pk, each pk once from its
+// latest row and up to the limit of the plan, the output fields are only
+// gathered for the rows kept; `result` is freed by DeleteRetrieveResult
+CStatus
+RetrieveAndReduceSegments(CSegmentInterface* c_segments,
+                          int64_t num_segments,
+                          CRetrievePlan c_plan,
+                          CTraceContext c_trace,
+                          uint64_t timestamp,
+                          CRetrieveResult* result);
+
+// two phase reduce: ReduceSearchResults merges the results on pk and
+// distance only, FillReducedSearchResults then fetches the output fields of
+// the surviving hits and marshals them. The plan, search results and their
+// segments must outlive the CReducedSearchResults.
+typedef void* CReducedSearchResults;
+
+CStatus
+ReduceSearchResults(CReducedSearchResults* cReducedSearchResults,
+                    CSearchPlan c_plan,
+                    CSearchResult* search_results,
+                    int64_t num_segments,
+                    int64_t* slice_nqs,
+                    int64_t* slice_topKs,
+                    int64_t num_slices);
+
+CStatus
+FillReducedSearchResults(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                         CReducedSearchResults cReducedSearchResults);
+
+void
+DeleteReducedSearchResults(CReducedSearchResults cReducedSearchResults);
+
+// streaming reduce: StreamReducePush merges the result of a segment into
+// the running top-k of every nq as soon as it is searched, by any thread,
+// FinishStreamReduce then fetches the output fields of the surviving hits
+// and marshals them. The plan, the pushed results and their segments must
+// outlive the CStreamReduce.
+typedef void* CStreamReduce;
+
+CStatus
+NewStreamReduce(CStreamReduce* cStreamReduce,
+                CSearchPlan c_plan,
+                int64_t* slice_nqs,
+                int64_t* slice_topKs,
+                int64_t num_slices);
+
+CStatus
+StreamReducePush(CStreamReduce cStreamReduce, CSearchResult c_search_result);
+
+CStatus
+FinishStreamReduce(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                   CStreamReduce cStreamReduce);
+
+void
+DeleteStreamReduce(CStreamReduce cStreamReduce);
+
 CStatus
 GetSearchResultDataBlob(CProto* searchResultDataBlob,
                         CSearchResultDataBlobs cSearchResultDataBlobs,
@@ -9,10 +9,20 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include "common/ColumnCache.h"
+#include "common/CpuGroup.h"
 #include "config/ConfigKnowhere.h"
+#include "index/DiskAnnCache.h"
 #include "log/Log.h"
+#include "segcore/LoadResource.h"
+#include "segcore/PlanCache.h"
+#include "segcore/QueryCapture.h"
+#include "segcore/SearchCoalescer.h"
+#include "segcore/SearchResultCache.h"
 #include "segcore/SegcoreConfig.h"
 #include "segcore/segcore_init_c.h"
+#include "simd/hook.h"
+#include "storage/FieldDataPool.h"
 
 namespace milvus::segcore {
 extern "C" void
@@ -35,6 +45,280 @@ SegcoreSetEnableGrowingSegmentIndex(const bool value) {
     config.set_enable_growing_segment_index(value);
 }
 
+extern "C" void
+SegcoreSetEnableChunkArena(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_enable_chunk_arena(value);
+}
+
+extern "C" void
+SegcoreSetChunkArenaHugepage(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_chunk_arena_hugepage(value);
+}
+
+extern "C" void
+SegcoreSetEnablePkFilter(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_enable_pk_filter(value);
+}
+
+extern "C" void
+SegcoreSetEnableExprPipeline(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_enable_expr_pipeline(value);
+}
+
+extern "C" void
+SegcoreSetBruteForceThreshold(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_brute_force_threshold(value);
+}
+
+extern "C" void
+SegcoreSetBruteForceDensity(const double value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_brute_force_density(value);
+}
+
+extern "C" void
+SegcoreSetPostFilterDensity(const double value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_post_filter_density(value);
+}
+
+extern "C" void
+SegcoreSetDictionaryMaxValues(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_dictionary_max_values(value);
+}
+
+extern "C" void
+SegcoreSetEnableJsonBinary(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_enable_json_binary(value);
+}
+
+extern "C" void
+SegcoreSetEnableGrowingFp16Vector(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_enable_growing_fp16_vector(value);
+}
+
+extern "C" void
+SegcoreSetInterimIndexType(const char* value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_interim_index_type(value);
+}
+
+extern "C" void
+SegcoreSetGrowingMmapDirPath(const char* value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_mmap_dir_path(value);
+}
+
+extern "C" void
+SegcoreSetColumnCache(const char* dir, const int64_t disk_budget) {
+    milvus::ColumnCache::GetInstance().Init(dir, disk_budget);
+}
+
+extern "C" void
+SegcoreSetLoadResourceBudget(const int64_t memory_budget,
+                             const int64_t disk_budget) {
+    milvus::segcore::LoadResourceManager::GetInstance().SetBudget(
+        memory_budget, disk_budget);
+}
+
+extern "C" void
+SegcoreGetLoadResourceStats(int64_t* memory_bytes,
+                            int64_t* disk_bytes,
+                            int64_t* num_loads) {
+    auto& manager = milvus::segcore::LoadResourceManager::GetInstance();
+    *memory_bytes = manager.InFlightMemoryBytes();
+    *disk_bytes = manager.InFlightDiskBytes();
+    *num_loads = manager.NumLoads();
+}
+
+extern "C" void
+SegcoreSetSearchResultCacheSize(const int64_t capacity) {
+    milvus::segcore::SearchResultCache::GetInstance().SetCapacity(capacity);
+}
+
+extern "C" void
+SegcoreSetPlanCacheSize(const int64_t capacity) {
+    milvus::segcore::PlanCache::GetInstance().SetCapacity(capacity);
+}
+
+extern "C" void
+SegcoreSetFieldDataPoolSize(const int64_t capacity) {
+    milvus::storage::FieldDataPool::GetInstance().SetCapacity(capacity);
+}
+
+extern "C" void
+SegcoreSetSearchCoalesceWindow(const int64_t window_us, const int64_t max_nq) {
+    milvus::segcore::SearchCoalescer::GetInstance().SetWindow(window_us,
+                                                              max_nq);
+}
+
+extern "C" void
+SegcoreSetDiskAnnCacheBudget(const int64_t budget,
+                             const int64_t rebalance_interval_ms) {
+    milvus::index::DiskAnnCacheManager::GetInstance().SetBudget(
+        budget, rebalance_interval_ms);
+}
+
+extern "C" void
+SegcoreGetDiskAnnCacheStats(int64_t* granted_bytes, int64_t* num_indexes) {
+    auto& manager = milvus::index::DiskAnnCacheManager::GetInstance();
+    *granted_bytes = manager.GrantedBytes();
+    *num_indexes = manager.NumIndexes();
+}
+
+extern "C" void
+SegcoreSetCpuGroupWeight(const int64_t group, const uint32_t weight) {
+    auto cpu_group = milvus::GetCpuGroup(group);
+    if (cpu_group != nullptr) {
+        cpu_group->set_weight(weight);
+    }
+}
+
+extern "C" void
+SegcoreGetCpuGroupStats(const int64_t group,
+                        int64_t* cpu_nanos,
+                        int64_t* tasks,
+                        int64_t* wait_nanos) {
+    auto cpu_group = milvus::GetCpuGroup(group);
+    *cpu_nanos = cpu_group != nullptr ? cpu_group->cpu_nanos() : 0;
+    *tasks = cpu_group != nullptr ? cpu_group->tasks() : 0;
+    *wait_nanos = cpu_group != nullptr ? cpu_group->wait_nanos() : 0;
+}
+
+extern "C" void
+SegcoreSetQueryCapture(const char* path, const int64_t sample_every) {
+    milvus::segcore::QueryCapture::GetInstance().Start(
+        path == nullptr ? "" : path, sample_every);
+}
+
+extern "C" void
+SegcoreSetExprResultCache(const int64_t capacity, const int64_t min_eval_us) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_expr_result_cache_size(capacity);
+    config.set_expr_result_cache_min_eval_us(min_eval_us);
+}
+
+extern "C" void
+SegcoreSetIndexWarmupQueries(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_index_warmup_queries(value);
+}
+
+extern "C" void
+SegcoreSetGrowingChunkFreezeMs(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_chunk_freeze_ms(value);
+}
+
+extern "C" void
+SegcoreSetGrowingChunkIndexMinFilters(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_chunk_index_min_filters(value);
+}
+
+extern "C" void
+SegcoreSetGrowingIndexAsyncBuild(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_index_async_build(value);
+}
+
+extern "C" void
+SegcoreSetVectorChunkBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_vector_chunk_bytes(value);
+}
+
+extern "C" void
+SegcoreSetIndexLoadInflight(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_index_load_inflight(value);
+}
+
+extern "C" void
+SegcoreSetExprParallelism(const int64_t parallelism,
+                          const int64_t morsel_rows) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_expr_parallelism(parallelism);
+    config.set_expr_morsel_rows(morsel_rows);
+}
+
+extern "C" void
+SegcoreSetGrowingSearchParallelism(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_search_parallelism(value);
+}
+
+extern "C" void
+SegcoreSetNumaAware(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_numa_aware(value);
+}
+
+extern "C" void
+SegcoreSetSegmentArena(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_segment_arena(value);
+}
+
+extern "C" void
+SegcoreSetGpuSearchMinNq(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_gpu_search_min_nq(value);
+}
+
+extern "C" void
+SegcoreSetBruteForceSketchFactor(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_brute_force_sketch_factor(value);
+}
+
+extern "C" void
+SegcoreSetEnableFieldSketch(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_enable_field_sketch(value);
+}
+
+extern "C" void
+SegcoreSetMmapGatherWillNeedMinRows(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_mmap_gather_willneed_min_rows(value);
+}
+
 extern "C" void
 SegcoreSetNlist(const int64_t value) {
     milvus::segcore::SegcoreConfig& config =
@@ -59,6 +343,18 @@ extern "C" char*
 SegcoreSetSimdType(const char* value) {
     LOG_SEGCORE_DEBUG_ << "set config simd_type: " << value;
     auto real_type = milvus::config::KnowhereSetSimdType(value);
+    // keep the filter kernels of segcore on the same instruction set
+    auto simd_type = milvus::simd::SimdType::AUTO;
+    if (strcmp(value, "avx512") == 0) {
+        simd_type = milvus::simd::SimdType::AVX512;
+    } else if (strcmp(value, "avx2") == 0) {
+        simd_type = milvus::simd::SimdType::AVX2;
+    } else if (strcmp(value, "avx") == 0 || strcmp(value, "sse4_2") == 0) {
+        simd_type = milvus::simd::SimdType::REF;
+    }
+    auto segcore_simd_type = milvus::simd::SetSimdType(simd_type);
+    LOG_SEGCORE_INFO_ << "segcore simd kernels: "
+                      << milvus::simd::SimdTypeName(segcore_simd_type);
     char* ret = reinterpret_cast<char*>(malloc(real_type.length() + 1));
     memcpy(ret, real_type.c_str(), real_type.length());
     ret[real_type.length()] = 0;
@@ -24,6 +24,180 @@ SegcoreSetChunkRows(const int64_t);
 void
 SegcoreSetEnableGrowingSegmentIndex(const bool);
 
+void
+SegcoreSetEnableChunkArena(const bool);
+
+void
+SegcoreSetChunkArenaHugepage(const bool);
+
+void
+SegcoreSetEnablePkFilter(const bool);
+
+void
+SegcoreSetEnableExprPipeline(const bool);
+
+void
+SegcoreSetBruteForceThreshold(const int64_t);
+
+void
+SegcoreSetBruteForceDensity(const double);
+
+void
+SegcoreSetPostFilterDensity(const double);
+
+void
+SegcoreSetDictionaryMaxValues(const int64_t);
+
+void
+SegcoreSetEnableJsonBinary(const bool);
+
+void
+SegcoreSetEnableGrowingFp16Vector(const bool);
+
+// IVF_FLAT_CC or IVF_SQ8
+void
+SegcoreSetInterimIndexType(const char*);
+
+// maps the vector chunks of growing segments from files in
+// {dir}/{segment_id} instead of anonymous memory, an empty dir disables it
+void
+SegcoreSetGrowingMmapDirPath(const char* dir);
+
+// keeps the mmap files of sealed columns in `dir` across loads, up to
+// `disk_budget` bytes, a zero budget disables it
+void
+SegcoreSetColumnCache(const char* dir, const int64_t disk_budget);
+
+// shares `budget` bytes of cache among the DiskANN indexes of the node in
+// proportion to their searches, apportioned again at most once every
+// `rebalance_interval_ms`; a zero budget grants every index what its load
+// config asks for
+void
+SegcoreSetDiskAnnCacheBudget(const int64_t budget,
+                             const int64_t rebalance_interval_ms);
+
+// the bytes of cache granted to the loaded DiskANN indexes and their number
+void
+SegcoreGetDiskAnnCacheStats(int64_t* granted_bytes, int64_t* num_indexes);
+
+// loads of sealed segments wait until their estimated peak fits next to
+// the loads running in `memory_budget` bytes of memory and `disk_budget`
+// bytes of local disk, zero budgets admit every load at once
+void
+SegcoreSetLoadResourceBudget(const int64_t memory_budget,
+                             const int64_t disk_budget);
+
+// the estimated peak bytes of the loads running and their number
+void
+SegcoreGetLoadResourceStats(int64_t* memory_bytes,
+                            int64_t* disk_bytes,
+                            int64_t* num_loads);
+
+// caches the search results of sealed segments for repeated searches, up
+// to `capacity` bytes, a zero capacity disables it
+void
+SegcoreSetSearchResultCacheSize(const int64_t capacity);
+
+// the search plans of at most `capacity` serialized plans are shared by the
+// searches creating them, a zero capacity disables it
+void
+SegcoreSetPlanCacheSize(const int64_t capacity);
+
+// the buffers of decoded field datas freed are kept for the next binlogs,
+// up to `capacity` bytes, a zero capacity keeps none
+void
+SegcoreSetFieldDataPoolSize(const int64_t capacity);
+
+// concurrent searches of a segment with the same plan at the same timestamp
+// within `window_us` microseconds of the first are run as one, up to
+// `max_nq` queries, a zero window disables it
+void
+SegcoreSetSearchCoalesceWindow(const int64_t window_us, const int64_t max_nq);
+
+// the workers take the queued tasks of the searches, retrieves and reduces
+// of cpu group `group`, a collection or a resource group, in proportion to
+// `weight` over the weights of the other groups with tasks queued
+void
+SegcoreSetCpuGroupWeight(const int64_t group, const uint32_t weight);
+
+// the cpu time in nanoseconds the threads ran for `group`, the tasks of it
+// the thread pool ran and the nanoseconds they waited to run
+void
+SegcoreGetCpuGroupStats(const int64_t group,
+                        int64_t* cpu_nanos,
+                        int64_t* tasks,
+                        int64_t* wait_nanos);
+
+// writes one in `sample_every` searches and retrieves of segments to the
+// file at `path` for them to be replayed offline, an empty path stops it
+void
+SegcoreSetQueryCapture(const char* path, const int64_t sample_every);
+
+// each sealed segment keeps the results of its predicates which took at
+// least `min_eval_us` to evaluate, up to `capacity` bytes, a zero capacity
+// disables it
+void
+SegcoreSetExprResultCache(const int64_t capacity, const int64_t min_eval_us);
+
+// searches every loaded vector index with this many queries before it
+// serves any, 0 to disable
+void
+SegcoreSetIndexWarmupQueries(const int64_t);
+
+// full chunks of growing segments get scalar indexes once they have been
+// full for this many milliseconds, negative to disable
+void
+SegcoreSetGrowingChunkFreezeMs(const int64_t);
+
+// indexes the frozen chunks of only the fields read by this many filters, 0
+// for all the scalar fields
+void
+SegcoreSetGrowingChunkIndexMinFilters(const int64_t);
+
+// builds the interim indexes of growing segments in the background
+void
+SegcoreSetGrowingIndexAsyncBuild(const bool);
+
+// sizes the chunks of the vector fields of growing segments to about this
+// many bytes, 0 to keep the chunk rows
+void
+SegcoreSetVectorChunkBytes(const int64_t);
+
+// downloads and decodes this many index files of an index load at a time
+void
+SegcoreSetIndexLoadInflight(const int64_t);
+
+// evaluates a filter over a chunk with up to this many threads, in morsels
+// of `morsel_rows` rows
+void
+SegcoreSetExprParallelism(const int64_t parallelism, const int64_t morsel_rows);
+
+// brute force searches the chunks of a growing segment with up to this
+// many threads
+void
+SegcoreSetGrowingSearchParallelism(const int64_t);
+
+// places the data of every sealed segment on one NUMA node
+void
+SegcoreSetNumaAware(const bool);
+
+// loads every sealed segment into a jemalloc arena of its own, purged as
+// soon as the segment is deleted, needs jemalloc in the process
+void
+SegcoreSetSegmentArena(const bool);
+
+void
+SegcoreSetGpuSearchMinNq(const int64_t);
+
+void
+SegcoreSetBruteForceSketchFactor(const int64_t);
+
+void
+SegcoreSetEnableFieldSketch(const bool);
+
+void
+SegcoreSetMmapGatherWillNeedMinRows(const int64_t);
+
 void
 SegcoreSetNlist(const int64_t);
 
@@ -11,18 +11,103 @@
 
 #include "segcore/segment_c.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
 #include "common/CGoHelper.h"
+#include "common/Cancellation.h"
+#include "common/Consts.h"
+#include "common/CpuGroup.h"
+#include "common/FieldSketch.h"
 #include "common/LoadInfo.h"
+#include "common/Metrics.h"
 #include "common/Types.h"
 #include "common/Tracer.h"
 #include "common/type_c.h"
 #include "google/protobuf/text_format.h"
 #include "index/IndexInfo.h"
+#include "index/Meta.h"
+#include "index/Utils.h"
 #include "log/Log.h"
 #include "segcore/Collection.h"
+#include "segcore/Flush.h"
+#include "segcore/GrowingSnapshot.h"
+#include "segcore/LoadResource.h"
+#include "segcore/QueryCapture.h"
+#include "segcore/SearchIterator.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "segcore/SegmentSealedImpl.h"
+#include "segcore/SegmentSnapshot.h"
 #include "segcore/SegcoreConfig.h"
+#include "storage/DataCodec.h"
+#include "storage/FieldData.h"
+#include "storage/MinioChunkManager.h"
+
+namespace {
+
+milvus::storage::StorageConfig
+ToStorageConfig(const CStorageConfig& c_storage_config) {
+    milvus::storage::StorageConfig storage_config;
+    storage_config.address = std::string(c_storage_config.address);
+    storage_config.bucket_name = std::string(c_storage_config.bucket_name);
+    storage_config.access_key_id = std::string(c_storage_config.access_key_id);
+    storage_config.access_key_value =
+        std::string(c_storage_config.access_key_value);
+    storage_config.remote_root_path =
+        std::string(c_storage_config.remote_root_path);
+    storage_config.storage_type = std::string(c_storage_config.storage_type);
+    storage_config.iam_endpoint = std::string(c_storage_config.iam_endpoint);
+    storage_config.useSSL = c_storage_config.useSSL;
+    storage_config.useIAM = c_storage_config.useIAM;
+    return storage_config;
+}
+
+// `sketch` gets a copy of the serialized sketch, freed with free()
+void
+CopyFieldSketch(const std::string& serialized, CProto* sketch) {
+    auto size = serialized.size();
+    auto buffer = std::malloc(std::max<size_t>(size, 1));
+    AssertInfo(buffer != nullptr, "failed to allocate the field sketch");
+    std::memcpy(buffer, serialized.data(), size);
+    sketch->proto_blob = buffer;
+    sketch->proto_size = size;
+}
+
+milvus::segcore::FieldLoadResourceInfo
+ToFieldLoadResourceInfo(int64_t field_id,
+                        int64_t row_count,
+                        const int64_t* binlog_sizes,
+                        int64_t num_binlogs,
+                        const char* mmap_dir_path) {
+    milvus::segcore::FieldLoadResourceInfo info;
+    info.field_id = field_id;
+    info.row_count = row_count;
+    info.binlog_bytes =
+        std::accumulate(binlog_sizes, binlog_sizes + num_binlogs, int64_t(0));
+    info.mmap = mmap_dir_path != nullptr && mmap_dir_path[0] != '\0';
+    return info;
+}
+
+// holds the estimated peak of a load against the load budget of the node
+// until the load ends, null without a budget
+std::unique_ptr<milvus::segcore::LoadResourceLease>
+AcquireLoadResource(
+    const milvus::segcore::SegmentSealed& segment,
+    const std::vector<milvus::segcore::FieldLoadResourceInfo>& infos) {
+    auto& manager = milvus::segcore::LoadResourceManager::GetInstance();
+    if (!manager.HasBudget()) {
+        return nullptr;
+    }
+    return manager.Acquire(
+        milvus::segcore::EstimateLoadResource(segment.get_schema(), infos));
+}
+
+}  // namespace
 
 //////////////////////////////    common interfaces    //////////////////////////////
 CSegmentInterface
@@ -47,6 +132,12 @@ NewSegment(CCollection collection, SegmentType seg_type, int64_t segment_id) {
                                << static_cast<int32_t>(seg_type);
             break;
     }
+    if (segment != nullptr) {
+        auto internal = static_cast<milvus::segcore::SegmentInternalInterface*>(
+            segment.get());
+        internal->set_delete_buffer(col->get_delete_buffer());
+        internal->set_ttl(col->get_ttl());
+    }
 
     return segment.release();
 }
@@ -63,6 +154,29 @@ DeleteSearchResult(CSearchResult search_result) {
     delete res;
 }
 
+char*
+GetSearchResultProfile(CSearchResult search_result) {
+    auto res = static_cast<milvus::SearchResult*>(search_result);
+    if (res->profile_ == nullptr) {
+        return nullptr;
+    }
+    auto str = res->profile_->ToJson();
+    auto len = str.length();
+    char* profile = (char*)malloc(len + 1);
+    memcpy(profile, str.data(), len);
+    profile[len] = 0;
+    return profile;
+}
+
+char*
+GetSearchResultEffectiveParams(CSearchResult search_result) {
+    auto res = static_cast<milvus::SearchResult*>(search_result);
+    if (res->effective_search_params_.empty()) {
+        return nullptr;
+    }
+    return strdup(res->effective_search_params_.c_str());
+}
+
 CStatus
 Search(CSegmentInterface c_segment,
        CSearchPlan c_plan,
@@ -70,6 +184,38 @@ Search(CSegmentInterface c_segment,
        CTraceContext c_trace,
        uint64_t timestamp,
        CSearchResult* result) {
+    return SearchWithCancellation(c_segment,
+                                  c_plan,
+                                  c_placeholder_group,
+                                  c_trace,
+                                  timestamp,
+                                  nullptr,
+                                  result);
+}
+
+CCancellationToken
+NewCancellationToken(int64_t deadline_ms) {
+    return new milvus::CancellationToken(deadline_ms);
+}
+
+void
+CancelQuery(CCancellationToken c_token) {
+    static_cast<milvus::CancellationToken*>(c_token)->Cancel();
+}
+
+void
+DeleteCancellationToken(CCancellationToken c_token) {
+    delete static_cast<milvus::CancellationToken*>(c_token);
+}
+
+CStatus
+SearchWithCancellation(CSegmentInterface c_segment,
+                       CSearchPlan c_plan,
+                       CPlaceholderGroup c_placeholder_group,
+                       CTraceContext c_trace,
+                       uint64_t timestamp,
+                       CCancellationToken c_token,
+                       CSearchResult* result) {
     try {
         auto segment = (milvus::segcore::SegmentInterface*)c_segment;
         auto plan = (milvus::query::Plan*)c_plan;
@@ -78,9 +224,26 @@ Search(CSegmentInterface c_segment,
         auto ctx = milvus::tracer::TraceContext{
             c_trace.traceID, c_trace.spanID, c_trace.flag};
 
-        auto span = milvus::tracer::StartSpan("SegcoreSearch", &ctx);
+        milvus::tracer::TraceScope trace_scope("SegcoreSearch", &ctx);
+        milvus::CancellationScope cancellation_scope(
+            static_cast<const milvus::CancellationToken*>(c_token));
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+        milvus::CheckCancelled();
 
+        auto& capture = milvus::segcore::QueryCapture::GetInstance();
+        auto begin = std::chrono::steady_clock::now();
         auto search_result = segment->Search(plan, phg_ptr, timestamp);
+        if (capture.Enabled()) {
+            capture.CaptureSearch(
+                segment->get_segment_id(),
+                plan,
+                phg_ptr,
+                timestamp,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count());
+        }
         if (!milvus::PositivelyRelated(
                 plan->plan_node_->search_info_.metric_type_)) {
             for (auto& dis : search_result->distances_) {
@@ -88,14 +251,176 @@ Search(CSegmentInterface c_segment,
             }
         }
         *result = search_result.release();
+        return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(
+            static_cast<ErrorCode>(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
 
-        span->End();
+CStatus
+MultiVectorSearch(CSegmentInterface c_segment,
+                  const CSearchPlan* c_plans,
+                  const CPlaceholderGroup* c_placeholder_groups,
+                  int64_t num_plans,
+                  int32_t fusion_type,
+                  int64_t rrf_k,
+                  const float* weights,
+                  uint64_t timestamp,
+                  CSearchResult* result) {
+    try {
+        auto segment =
+            dynamic_cast<const milvus::segcore::SegmentInternalInterface*>(
+                static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        std::vector<const milvus::query::Plan*> plans;
+        std::vector<const milvus::query::PlaceholderGroup*> groups;
+        for (int64_t i = 0; i < num_plans; ++i) {
+            plans.push_back(
+                static_cast<const milvus::query::Plan*>(c_plans[i]));
+            groups.push_back(
+                static_cast<const milvus::query::PlaceholderGroup*>(
+                    c_placeholder_groups[i]));
+        }
+        AssertInfo(fusion_type == 0 || fusion_type == 1,
+                   "unknown fusion type " + std::to_string(fusion_type));
+        milvus::query::FusionInfo fusion;
+        fusion.type_ = static_cast<milvus::query::FusionType>(fusion_type);
+        fusion.rrf_k_ = rrf_k;
+        if (weights != nullptr) {
+            fusion.weights_.assign(weights, weights + num_plans);
+        }
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+        auto search_result =
+            segment->MultiVectorSearch(plans, groups, fusion, timestamp);
+        *result = search_result.release();
+        return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(
+            static_cast<ErrorCode>(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SearchOnNumaNode(CSegmentInterface c_segment,
+                 CSearchPlan c_plan,
+                 CPlaceholderGroup c_placeholder_group,
+                 CTraceContext c_trace,
+                 uint64_t timestamp,
+                 CSearchResult* result) {
+    try {
+        auto segment =
+            static_cast<const milvus::segcore::SegmentInterface*>(c_segment);
+        auto plan = static_cast<const milvus::query::Plan*>(c_plan);
+        auto phg_ptr = static_cast<const milvus::query::PlaceholderGroup*>(
+            c_placeholder_group);
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreSearch", &ctx);
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+
+        auto search_results = milvus::segcore::SearchSegments(
+            {segment}, plan, phg_ptr, timestamp);
+        *result = search_results[0].release();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SearchSegments(CSegmentInterface* c_segments,
+               int64_t num_segments,
+               CSearchPlan c_plan,
+               CPlaceholderGroup c_placeholder_group,
+               CTraceContext c_trace,
+               uint64_t timestamp,
+               CSearchResult* results) {
+    try {
+        AssertInfo(num_segments > 0, "num_segments must be greater than 0");
+        std::vector<const milvus::segcore::SegmentInterface*> segments(
+            num_segments);
+        for (int64_t i = 0; i < num_segments; ++i) {
+            segments[i] = static_cast<const milvus::segcore::SegmentInterface*>(
+                c_segments[i]);
+        }
+        auto plan = static_cast<const milvus::query::Plan*>(c_plan);
+        auto phg_ptr = static_cast<const milvus::query::PlaceholderGroup*>(
+            c_placeholder_group);
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreSearchSegments", &ctx);
+        // the segments of a search are of the same collection
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segments[0]->get_cpu_group()));
+
+        auto search_results = milvus::segcore::SearchSegments(
+            segments, plan, phg_ptr, timestamp);
+        for (int64_t i = 0; i < num_segments; ++i) {
+            results[i] = search_results[i].release();
+        }
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+NewSearchIterator(CSegmentInterface c_segment,
+                  CSearchPlan c_plan,
+                  CPlaceholderGroup c_placeholder_group,
+                  uint64_t timestamp,
+                  CSearchIterator* iterator) {
+    try {
+        auto segment = (milvus::segcore::SegmentInterface*)c_segment;
+        auto plan = (milvus::query::Plan*)c_plan;
+        auto phg_ptr = reinterpret_cast<const milvus::query::PlaceholderGroup*>(
+            c_placeholder_group);
+        *iterator = new milvus::segcore::SearchIterator(
+            *segment, *plan, *phg_ptr, timestamp);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SearchIteratorNext(CSearchIterator c_iterator,
+                   CTraceContext c_trace,
+                   int64_t page_size,
+                   CSearchResult* result) {
+    try {
+        auto iterator = (milvus::segcore::SearchIterator*)c_iterator;
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreSearchIteratorNext",
+                                               &ctx);
+
+        auto search_result = iterator->Next(page_size);
+        if (!iterator->PositivelyRelated()) {
+            for (auto& dis : search_result->distances_) {
+                dis *= -1;
+            }
+        }
+        *result = search_result.release();
         return milvus::SuccessCStatus();
     } catch (std::exception& e) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
     }
 }
 
+void
+DeleteSearchIterator(CSearchIterator c_iterator) {
+    auto iterator = (milvus::segcore::SearchIterator*)c_iterator;
+    delete iterator;
+}
+
 void
 DeleteRetrieveResult(CRetrieveResult* retrieve_result) {
     std::free(const_cast<void*>(retrieve_result->proto_blob));
@@ -107,6 +432,17 @@ Retrieve(CSegmentInterface c_segment,
          CTraceContext c_trace,
          uint64_t timestamp,
          CRetrieveResult* result) {
+    return RetrieveWithCancellation(
+        c_segment, c_plan, c_trace, timestamp, nullptr, result);
+}
+
+CStatus
+RetrieveWithCancellation(CSegmentInterface c_segment,
+                         CRetrievePlan c_plan,
+                         CTraceContext c_trace,
+                         uint64_t timestamp,
+                         CCancellationToken c_token,
+                         CRetrieveResult* result) {
     try {
         auto segment =
             static_cast<const milvus::segcore::SegmentInterface*>(c_segment);
@@ -114,9 +450,25 @@ Retrieve(CSegmentInterface c_segment,
 
         auto ctx = milvus::tracer::TraceContext{
             c_trace.traceID, c_trace.spanID, c_trace.flag};
-        auto span = milvus::tracer::StartSpan("SegcoreRetrieve", &ctx);
+        milvus::tracer::TraceScope trace_scope("SegcoreRetrieve", &ctx);
+        milvus::CancellationScope cancellation_scope(
+            static_cast<const milvus::CancellationToken*>(c_token));
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+        milvus::CheckCancelled();
 
+        auto& capture = milvus::segcore::QueryCapture::GetInstance();
+        auto begin = std::chrono::steady_clock::now();
         auto retrieve_result = segment->Retrieve(plan, timestamp);
+        if (capture.Enabled()) {
+            capture.CaptureRetrieve(
+                segment->get_segment_id(),
+                plan,
+                timestamp,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count());
+        }
 
         auto size = retrieve_result->ByteSizeLong();
         void* buffer = malloc(size);
@@ -124,8 +476,97 @@ Retrieve(CSegmentInterface c_segment,
 
         result->proto_blob = buffer;
         result->proto_size = size;
+        return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(
+            static_cast<ErrorCode>(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
 
-        span->End();
+CStatus
+AcquireSegmentSnapshot(CSegmentInterface c_segment,
+                       uint64_t timestamp,
+                       CSegmentSnapshot* snapshot) {
+    try {
+        auto segment =
+            static_cast<const milvus::segcore::SegmentInterface*>(c_segment);
+        // the handle holds a reference, released with it
+        *snapshot = new milvus::segcore::SegmentSnapshotPtr(
+            segment->AcquireSnapshot(timestamp));
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+void
+ReleaseSegmentSnapshot(CSegmentSnapshot c_snapshot) {
+    delete static_cast<milvus::segcore::SegmentSnapshotPtr*>(c_snapshot);
+}
+
+CStatus
+SearchWithSnapshot(CSegmentInterface c_segment,
+                   CSearchPlan c_plan,
+                   CPlaceholderGroup c_placeholder_group,
+                   CTraceContext c_trace,
+                   CSegmentSnapshot c_snapshot,
+                   CSearchResult* result) {
+    try {
+        auto segment =
+            static_cast<const milvus::segcore::SegmentInterface*>(c_segment);
+        auto plan = static_cast<const milvus::query::Plan*>(c_plan);
+        auto phg_ptr = static_cast<const milvus::query::PlaceholderGroup*>(
+            c_placeholder_group);
+        auto& snapshot =
+            **static_cast<milvus::segcore::SegmentSnapshotPtr*>(c_snapshot);
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreSearch", &ctx);
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+
+        auto search_result = segment->Search(plan, phg_ptr, snapshot);
+        if (!milvus::PositivelyRelated(
+                plan->plan_node_->search_info_.metric_type_)) {
+            for (auto& dis : search_result->distances_) {
+                dis *= -1;
+            }
+        }
+        *result = search_result.release();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+RetrieveWithSnapshot(CSegmentInterface c_segment,
+                     CRetrievePlan c_plan,
+                     CTraceContext c_trace,
+                     CSegmentSnapshot c_snapshot,
+                     CRetrieveResult* result) {
+    try {
+        auto segment =
+            static_cast<const milvus::segcore::SegmentInterface*>(c_segment);
+        auto plan = static_cast<const milvus::query::RetrievePlan*>(c_plan);
+        auto& snapshot =
+            **static_cast<milvus::segcore::SegmentSnapshotPtr*>(c_snapshot);
+        auto ctx = milvus::tracer::TraceContext{
+            c_trace.traceID, c_trace.spanID, c_trace.flag};
+        milvus::tracer::TraceScope trace_scope("SegcoreRetrieve", &ctx);
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+
+        auto retrieve_result = segment->Retrieve(plan, snapshot);
+
+        auto size = retrieve_result->ByteSizeLong();
+        void* buffer = malloc(size);
+        retrieve_result->SerializePartialToArray(buffer, size);
+
+        result->proto_blob = buffer;
+        result->proto_size = size;
         return milvus::SuccessCStatus();
     } catch (std::exception& e) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
@@ -139,6 +580,50 @@ GetMemoryUsageInBytes(CSegmentInterface c_segment) {
     return mem_size;
 }
 
+char*
+GetMemoryUsageDetail(CSegmentInterface c_segment) {
+    auto segment = static_cast<milvus::segcore::SegmentInterface*>(c_segment);
+    auto str = segment->GetMemoryUsage().ToJson();
+    auto len = str.length();
+    char* detail = (char*)malloc(len + 1);
+    memcpy(detail, str.data(), len);
+    detail[len] = 0;
+    return detail;
+}
+
+int
+GetSegmentNumaNode(CSegmentInterface c_segment) {
+    auto segment =
+        static_cast<const milvus::segcore::SegmentInterface*>(c_segment);
+    return segment->get_numa_node();
+}
+
+CStatus
+SetSegmentNumaNode(CSegmentInterface c_segment, int numa_node) {
+    try {
+        auto segment = dynamic_cast<milvus::segcore::SegmentSealed*>(
+            static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        segment->set_numa_node(numa_node);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SetSegmentCpuGroup(CSegmentInterface c_segment, int64_t cpu_group) {
+    try {
+        auto segment = dynamic_cast<milvus::segcore::SegmentInternalInterface*>(
+            static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        segment->set_cpu_group(cpu_group);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 int64_t
 GetRowCount(CSegmentInterface c_segment) {
     auto segment = static_cast<milvus::segcore::SegmentInterface*>(c_segment);
@@ -171,6 +656,158 @@ HasRawData(CSegmentInterface c_segment, int64_t field_id) {
     return segment->HasRawData(field_id);
 }
 
+CStatus
+CanMatchSearch(CSegmentInterface c_segment,
+               CSearchPlan c_plan,
+               bool* can_match) {
+    try {
+        auto segment =
+            dynamic_cast<const milvus::segcore::SegmentInternalInterface*>(
+                static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto plan = static_cast<const milvus::query::Plan*>(c_plan);
+        *can_match = segment->CanMatch(plan);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+CanMatchRetrieve(CSegmentInterface c_segment,
+                 CRetrievePlan c_plan,
+                 bool* can_match) {
+    try {
+        auto segment =
+            dynamic_cast<const milvus::segcore::SegmentInternalInterface*>(
+                static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto plan = static_cast<const milvus::query::RetrievePlan*>(c_plan);
+        *can_match = segment->CanMatch(plan);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+IsSegmentExpired(CSegmentInterface c_segment,
+                 uint64_t timestamp,
+                 bool* expired) {
+    try {
+        auto segment =
+            dynamic_cast<const milvus::segcore::SegmentInternalInterface*>(
+                static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        *expired = segment->IsExpired(timestamp);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+GetFieldSketch(CSegmentInterface c_segment,
+               int64_t field_id,
+               CProto* sketch) {
+    try {
+        auto segment =
+            dynamic_cast<const milvus::segcore::SegmentInternalInterface*>(
+                static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto field_sketch = segment->field_sketch(milvus::FieldId(field_id));
+        CopyFieldSketch(
+            field_sketch == nullptr ? std::string() : field_sketch->Serialize(),
+            sketch);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+MergeFieldSketches(const CProto* sketches,
+                   int64_t num_sketches,
+                   CProto* merged) {
+    try {
+        AssertInfo(num_sketches > 0, "no field sketch to merge");
+        auto result = milvus::FieldSketch::Deserialize(
+            sketches[0].proto_blob, sketches[0].proto_size);
+        for (int64_t i = 1; i < num_sketches; ++i) {
+            result.Merge(milvus::FieldSketch::Deserialize(
+                sketches[i].proto_blob, sketches[i].proto_size));
+        }
+        CopyFieldSketch(result.Serialize(), merged);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+GetFieldSketchCounts(const void* sketch,
+                     int64_t sketch_size,
+                     int64_t* row_count,
+                     int64_t* distinct_count) {
+    try {
+        auto field_sketch =
+            milvus::FieldSketch::Deserialize(sketch, sketch_size);
+        *row_count = field_sketch.row_count();
+        *distinct_count = field_sketch.distinct_count();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+GetFieldSketchQuantiles(const void* sketch,
+                        int64_t sketch_size,
+                        const double* quantiles,
+                        int64_t num_quantiles,
+                        double* values) {
+    try {
+        auto field_sketch =
+            milvus::FieldSketch::Deserialize(sketch, sketch_size);
+        auto quantile_sketch = field_sketch.quantiles();
+        AssertInfo(quantile_sketch != nullptr,
+                   "the field sketch has no quantiles");
+        AssertInfo(quantile_sketch->count() > 0 || num_quantiles == 0,
+                   "the field sketch has no values");
+        for (int64_t i = 0; i < num_quantiles; ++i) {
+            values[i] = quantile_sketch->Quantile(quantiles[i]);
+        }
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+RecommendScalarIndexType(const void* sketch,
+                         int64_t sketch_size,
+                         CDataType data_type,
+                         const char** index_type) {
+    try {
+        auto field_sketch =
+            milvus::FieldSketch::Deserialize(sketch, sketch_size);
+        auto recommended = milvus::index::RecommendScalarIndexType(
+            milvus::DataType(data_type), field_sketch);
+        for (auto type : {milvus::index::BITMAP_INDEX_TYPE,
+                          milvus::index::ASCENDING_SORT,
+                          milvus::index::INVERTED_INDEX_TYPE,
+                          milvus::index::MARISA_TRIE}) {
+            if (recommended == type) {
+                *index_type = type;
+                return milvus::SuccessCStatus();
+            }
+        }
+        PanicInfo("unknown index type " + recommended);
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 //////////////////////////////    interfaces for growing segment    //////////////////////////////
 CStatus
 Insert(CSegmentInterface c_segment,
@@ -194,6 +831,32 @@ Insert(CSegmentInterface c_segment,
     }
 }
 
+CStatus
+InsertColumns(CSegmentInterface c_segment,
+              int64_t reserved_offset,
+              int64_t size,
+              const int64_t* row_ids,
+              const uint64_t* timestamps,
+              int64_t num_columns,
+              const int64_t* field_ids,
+              const void* const* column_data,
+              const int64_t* const* column_offsets) {
+    try {
+        auto segment = static_cast<milvus::segcore::SegmentGrowing*>(c_segment);
+        std::vector<milvus::segcore::InsertColumn> columns(num_columns);
+        for (int64_t i = 0; i < num_columns; ++i) {
+            columns[i].field_id = milvus::FieldId(field_ids[i]);
+            columns[i].data = column_data[i];
+            columns[i].offsets = column_offsets[i];
+        }
+        segment->InsertColumns(
+            reserved_offset, size, row_ids, timestamps, columns);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 PreInsert(CSegmentInterface c_segment, int64_t size, int64_t* offset) {
     try {
@@ -205,6 +868,28 @@ PreInsert(CSegmentInterface c_segment, int64_t size, int64_t* offset) {
     }
 }
 
+CStatus
+Upsert(CSegmentInterface c_segment,
+       int64_t reserved_offset,
+       int64_t size,
+       const int64_t* row_ids,
+       const uint64_t* timestamps,
+       const uint8_t* data_info,
+       const uint64_t data_info_len) {
+    try {
+        auto segment = static_cast<milvus::segcore::SegmentGrowing*>(c_segment);
+        auto insert_data = std::make_unique<milvus::InsertData>();
+        auto suc = insert_data->ParseFromArray(data_info, data_info_len);
+        AssertInfo(suc, "failed to parse insert data from records");
+
+        segment->Upsert(
+            reserved_offset, size, row_ids, timestamps, insert_data.get());
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 Delete(CSegmentInterface c_segment,
        int64_t reserved_offset,
@@ -242,6 +927,8 @@ LoadFieldData(CSegmentInterface c_segment,
         auto segment =
             dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
         AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
         auto field_data = std::make_unique<milvus::DataArray>();
         auto suc = field_data->ParseFromArray(load_field_data_info.blob,
                                               load_field_data_info.blob_size);
@@ -257,6 +944,125 @@ LoadFieldData(CSegmentInterface c_segment,
     }
 }
 
+CStatus
+LoadFieldDataFromBinlogs(CSegmentInterface c_segment,
+                         int64_t field_id,
+                         int64_t row_count,
+                         const uint8_t* const* binlogs,
+                         const int64_t* binlog_sizes,
+                         int64_t num_binlogs,
+                         const char* mmap_dir_path) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+        auto lease = AcquireLoadResource(
+            *segment,
+            {ToFieldLoadResourceInfo(field_id,
+                                     row_count,
+                                     binlog_sizes,
+                                     num_binlogs,
+                                     mmap_dir_path)});
+        auto begin = std::chrono::steady_clock::now();
+        FieldDataInfo load_info{field_id, {}, row_count, mmap_dir_path};
+        for (int64_t i = 0; i < num_binlogs; ++i) {
+            // the binlog is owned by the caller, decode it without a copy
+            auto binlog = std::shared_ptr<uint8_t[]>(
+                const_cast<uint8_t*>(binlogs[i]), [](uint8_t*) {});
+            auto codec =
+                milvus::storage::DeserializeFileData(binlog, binlog_sizes[i]);
+            load_info.datas.push_back(codec->GetFieldData());
+        }
+        milvus::monitor::load_field_decode_latency.ObserveSince(begin);
+        segment->LoadFieldData(load_info);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadFieldDatasFromBinlogs(CSegmentInterface c_segment,
+                          const CFieldBinlogs* fields,
+                          int64_t num_fields,
+                          const char* mmap_dir_path,
+                          int64_t memory_budget) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::CpuGroupScope cpu_group_scope(
+            milvus::GetCpuGroup(segment->get_cpu_group()));
+        std::vector<milvus::FieldBinlogsInfo> infos(num_fields);
+        std::vector<milvus::segcore::FieldLoadResourceInfo> resources;
+        for (int64_t i = 0; i < num_fields; ++i) {
+            auto& field = fields[i];
+            auto& info = infos[i];
+            info.field_id = field.field_id;
+            info.row_count = field.row_count;
+            info.binlogs.assign(field.binlogs,
+                                field.binlogs + field.num_binlogs);
+            info.binlog_sizes.assign(field.binlog_sizes,
+                                     field.binlog_sizes + field.num_binlogs);
+            // the timestamps are read by every query and never mapped, the
+            // row ids are mapped as the other fields are
+            if (milvus::FieldId(field.field_id) != milvus::TimestampFieldID) {
+                info.mmap_dir_path = mmap_dir_path;
+            }
+            resources.push_back(ToFieldLoadResourceInfo(field.field_id,
+                                                        field.row_count,
+                                                        field.binlog_sizes,
+                                                        field.num_binlogs,
+                                                        info.mmap_dir_path));
+        }
+        auto lease = AcquireLoadResource(*segment, resources);
+        segment->LoadFieldDatas(infos, memory_budget);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+EstimateLoadResource(CCollection collection,
+                     const CFieldLoadResource* fields,
+                     int64_t num_fields,
+                     CLoadResource* resource) {
+    try {
+        auto col = static_cast<milvus::segcore::Collection*>(collection);
+        std::vector<milvus::segcore::FieldLoadResourceInfo> infos(num_fields);
+        for (int64_t i = 0; i < num_fields; ++i) {
+            auto& field = fields[i];
+            auto& info = infos[i];
+            info.field_id = field.field_id;
+            info.row_count = field.row_count;
+            info.binlog_bytes = field.binlog_bytes;
+            info.raw_bytes = field.raw_bytes;
+            info.mmap = field.mmap;
+            if (field.index_type != nullptr) {
+                info.index_type = field.index_type;
+            }
+            info.index_bytes = field.index_bytes;
+            info.index_mmap = field.index_mmap;
+        }
+        auto estimate =
+            milvus::segcore::EstimateLoadResource(*col->get_schema(), infos);
+        resource->peak_memory_bytes = estimate.peak_memory_bytes;
+        resource->steady_memory_bytes = estimate.steady_memory_bytes;
+        resource->peak_disk_bytes = estimate.peak_disk_bytes;
+        resource->steady_disk_bytes = estimate.steady_disk_bytes;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 LoadDeletedRecord(CSegmentInterface c_segment,
                   CLoadDeletedRecordInfo deleted_record_info) {
@@ -278,6 +1084,233 @@ LoadDeletedRecord(CSegmentInterface c_segment,
     }
 }
 
+CStatus
+LoadPkStats(CSegmentInterface c_segment,
+            const uint8_t* stats_log,
+            int64_t stats_log_size) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        segment->LoadPkStats(stats_log, stats_log_size);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+AppendSegmentArena(CLoadIndexInfo c_load_index_info,
+                   CSegmentInterface c_segment) {
+    try {
+        auto load_index_info =
+            static_cast<milvus::segcore::LoadIndexInfo*>(c_load_index_info);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentInternalInterface*>(
+                static_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        load_index_info->arena = segment->get_arena();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadFromGrowingSegment(CSegmentInterface c_segment,
+                       CSegmentInterface c_growing) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto growing = dynamic_cast<milvus::segcore::SegmentGrowing*>(
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_growing));
+        AssertInfo(growing != nullptr, "growing segment conversion failed");
+        segment->LoadFromGrowing(*growing);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadDeletedRecordFromBinlogs(CSegmentInterface c_segment,
+                             CStorageConfig c_storage_config,
+                             const char* const* paths,
+                             int64_t num_paths) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::storage::MinioChunkManager chunk_manager(
+            ToStorageConfig(c_storage_config));
+        std::vector<std::string> files(paths, paths + num_paths);
+        segment->LoadDeletedRecordFromBinlogs(files, &chunk_manager);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadFieldDataLazily(CSegmentInterface c_segment,
+                    CStorageConfig c_storage_config,
+                    int64_t field_id,
+                    int64_t row_count,
+                    const char* const* paths,
+                    int64_t num_paths) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        LazyFieldDataInfo info;
+        info.field_id = field_id;
+        info.binlog_paths.assign(paths, paths + num_paths);
+        info.row_count = row_count;
+        // the segment fetches through it until the field is dropped
+        info.chunk_manager =
+            std::make_shared<milvus::storage::MinioChunkManager>(
+                ToStorageConfig(c_storage_config));
+        segment->LoadFieldDataLazily(info);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+EvictLazyFieldData(CSegmentInterface c_segment,
+                   int64_t memory_budget,
+                   int64_t* evicted_bytes) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        *evicted_bytes = segment->EvictLazyFieldData(memory_budget);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+FlushGrowingSegment(CSegmentInterface c_segment,
+                    CStorageConfig c_storage_config,
+                    int64_t collection_id,
+                    int64_t partition_id,
+                    int64_t row_count,
+                    const int64_t* field_ids,
+                    const char* const* paths,
+                    int64_t num_fields,
+                    const char* stats_path,
+                    CFlushedBinlog* binlogs,
+                    int64_t* stats_log_size) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment = dynamic_cast<milvus::segcore::SegmentGrowingImpl*>(
+            segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::segcore::FlushInfo info;
+        info.collection_id = collection_id;
+        info.partition_id = partition_id;
+        info.row_count = row_count;
+        for (int64_t i = 0; i < num_fields; ++i) {
+            info.fields.push_back(
+                {milvus::FieldId(field_ids[i]), std::string(paths[i])});
+        }
+        if (stats_path != nullptr) {
+            info.stats_path = stats_path;
+        }
+        milvus::storage::MinioChunkManager chunk_manager(
+            ToStorageConfig(c_storage_config));
+        auto flushed = milvus::segcore::FlushGrowingSegment(
+            *segment, info, &chunk_manager);
+        for (int64_t i = 0; i < num_fields; ++i) {
+            auto& binlog = flushed.binlogs[i];
+            binlogs[i] = CFlushedBinlog{binlog.field_id.get(),
+                                        binlog.rows,
+                                        binlog.log_size,
+                                        binlog.memory_size,
+                                        binlog.timestamp_from,
+                                        binlog.timestamp_to};
+        }
+        *stats_log_size = flushed.stats_log_size;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SaveGrowingSegmentSnapshot(CSegmentInterface c_segment,
+                           const char* dir,
+                           const void* position,
+                           int64_t position_size,
+                           int64_t* row_count,
+                           int64_t* delete_count) {
+    try {
+        auto segment = dynamic_cast<milvus::segcore::SegmentGrowingImpl*>(
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto info = milvus::segcore::SaveGrowingSnapshot(
+            *segment,
+            dir,
+            std::string(static_cast<const char*>(position), position_size));
+        *row_count = info.row_count;
+        *delete_count = info.delete_count;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+RestoreGrowingSegmentSnapshot(CSegmentInterface c_segment,
+                              const char* dir,
+                              CProto* position) {
+    try {
+        auto segment = dynamic_cast<milvus::segcore::SegmentGrowingImpl*>(
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto info = milvus::segcore::RestoreGrowingSnapshot(*segment, dir);
+        auto size = info.position.size();
+        auto buffer = std::malloc(std::max<size_t>(size, 1));
+        AssertInfo(buffer != nullptr, "failed to allocate the position");
+        std::memcpy(buffer, info.position.data(), size);
+        position->proto_blob = buffer;
+        position->proto_size = size;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+CompactDeletedRecord(CSegmentInterface c_segment,
+                     uint64_t oldest_query_ts,
+                     int64_t* compacted) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        AssertInfo(segment_interface != nullptr, "segment conversion failed");
+        *compacted = segment_interface->CompactDeletedRecord(oldest_query_ts);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 UpdateSealedSegmentIndex(CSegmentInterface c_segment,
                          CLoadIndexInfo c_load_index_info) {
@@ -296,6 +1329,26 @@ UpdateSealedSegmentIndex(CSegmentInterface c_segment,
     }
 }
 
+CStatus
+LoadJsonKeyIndex(CSegmentInterface c_segment,
+                 int64_t field_id,
+                 const char* const* pointers,
+                 int64_t num_pointers) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        std::vector<std::string> json_pointers(pointers,
+                                               pointers + num_pointers);
+        segment->LoadJsonKeyIndex(milvus::FieldId(field_id), json_pointers);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 DropFieldData(CSegmentInterface c_segment, int64_t field_id) {
     try {
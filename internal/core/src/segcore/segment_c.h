@@ -25,6 +25,9 @@ extern "C" {
 
 typedef void* CSegmentInterface;
 typedef void* CSearchResult;
+typedef void* CSearchIterator;
+typedef void* CSegmentSnapshot;
+typedef void* CCancellationToken;
 typedef CProto CRetrieveResult;
 
 //////////////////////////////    common interfaces    //////////////////////////////
@@ -37,6 +40,17 @@ DeleteSegment(CSegmentInterface c_segment);
 void
 DeleteSearchResult(CSearchResult search_result);
 
+// the execution profile of a search result as json, nullptr unless the
+// search params of its plan set "profile"; the caller frees the string
+char*
+GetSearchResultProfile(CSearchResult search_result);
+
+// the search params segcore picked for the index search of a result as
+// json, nullptr unless the search params of its plan set "adaptive_recall";
+// the caller frees the string
+char*
+GetSearchResultEffectiveParams(CSearchResult search_result);
+
 CStatus
 Search(CSegmentInterface c_segment,
        CSearchPlan c_plan,
@@ -45,6 +59,91 @@ Search(CSegmentInterface c_segment,
        uint64_t timestamp,
        CSearchResult* result);
 
+// a token stopping the searches and retrieves it is passed to once
+// CancelQuery is called on it or at `deadline_ms`, in milliseconds since the
+// unix epoch and 0 for none; they fail with QueryCancelled then
+CCancellationToken
+NewCancellationToken(int64_t deadline_ms);
+
+// may be called while the queries passed the token are running
+void
+CancelQuery(CCancellationToken c_token);
+
+// the queries passed the token must have returned
+void
+DeleteCancellationToken(CCancellationToken c_token);
+
+// same as Search, but stopped between its chunks and knowhere calls when
+// c_token, which may be null, is cancelled
+CStatus
+SearchWithCancellation(CSegmentInterface c_segment,
+                       CSearchPlan c_plan,
+                       CPlaceholderGroup c_placeholder_group,
+                       CTraceContext c_trace,
+                       uint64_t timestamp,
+                       CCancellationToken c_token,
+                       CSearchResult* result);
+
+// searches the `num_plans` plans, each on the vector field it names with
+// the queries of its placeholder group, and fuses their results into one
+// top-k per query of the topk of the first plan. fusion_type 0 sums
+// weight / (rrf_k + rank), 1 sums weight * the distance normalized into
+// [0, 1]; `weights`, one per plan, may be null for all 1. The plans must
+// share the filter, it's evaluated once; the distances of the result are
+// the fused scores, higher is better.
+CStatus
+MultiVectorSearch(CSegmentInterface c_segment,
+                  const CSearchPlan* c_plans,
+                  const CPlaceholderGroup* c_placeholder_groups,
+                  int64_t num_plans,
+                  int32_t fusion_type,
+                  int64_t rrf_k,
+                  const float* weights,
+                  uint64_t timestamp,
+                  CSearchResult* result);
+
+// same as Search, but a segment placed on a NUMA node is searched by a
+// worker pinned to that node, the caller waits for it
+CStatus
+SearchOnNumaNode(CSegmentInterface c_segment,
+                 CSearchPlan c_plan,
+                 CPlaceholderGroup c_placeholder_group,
+                 CTraceContext c_trace,
+                 uint64_t timestamp,
+                 CSearchResult* result);
+
+// search the segments with one plan and placeholder group in a single call,
+// the segments are searched concurrently and results[i] is the result of
+// c_segments[i]; nothing is returned on failure
+CStatus
+SearchSegments(CSegmentInterface* c_segments,
+               int64_t num_segments,
+               CSearchPlan c_plan,
+               CPlaceholderGroup c_placeholder_group,
+               CTraceContext c_trace,
+               uint64_t timestamp,
+               CSearchResult* results);
+
+// iterate over the results of a single query page by page, best first;
+// the plan must be created from a serialized plan, the plan and the
+// placeholder group are copied, the segment must outlive the iterator
+CStatus
+NewSearchIterator(CSegmentInterface c_segment,
+                  CSearchPlan c_plan,
+                  CPlaceholderGroup c_placeholder_group,
+                  uint64_t timestamp,
+                  CSearchIterator* iterator);
+
+// the next page_size results, fewer when the segment has no more
+CStatus
+SearchIteratorNext(CSearchIterator c_iterator,
+                   CTraceContext c_trace,
+                   int64_t page_size,
+                   CSearchResult* result);
+
+void
+DeleteSearchIterator(CSearchIterator c_iterator);
+
 void
 DeleteRetrieveResult(CRetrieveResult* retrieve_result);
 
@@ -55,9 +154,66 @@ Retrieve(CSegmentInterface c_segment,
          uint64_t timestamp,
          CRetrieveResult* result);
 
+// same as Retrieve, but stopped between its chunks when c_token, which may
+// be null, is cancelled
+CStatus
+RetrieveWithCancellation(CSegmentInterface c_segment,
+                         CRetrievePlan c_plan,
+                         CTraceContext c_trace,
+                         uint64_t timestamp,
+                         CCancellationToken c_token,
+                         CRetrieveResult* result);
+
+// the rows of the segment visible at `timestamp`, masked once for all the
+// searches and retrieves at that timestamp which pass the snapshot; every
+// acquired snapshot is released, the segment must outlive it
+CStatus
+AcquireSegmentSnapshot(CSegmentInterface c_segment,
+                       uint64_t timestamp,
+                       CSegmentSnapshot* snapshot);
+
+void
+ReleaseSegmentSnapshot(CSegmentSnapshot c_snapshot);
+
+// same as Search at the timestamp of the snapshot
+CStatus
+SearchWithSnapshot(CSegmentInterface c_segment,
+                   CSearchPlan c_plan,
+                   CPlaceholderGroup c_placeholder_group,
+                   CTraceContext c_trace,
+                   CSegmentSnapshot c_snapshot,
+                   CSearchResult* result);
+
+// same as Retrieve at the timestamp of the snapshot
+CStatus
+RetrieveWithSnapshot(CSegmentInterface c_segment,
+                     CRetrievePlan c_plan,
+                     CTraceContext c_trace,
+                     CSegmentSnapshot c_snapshot,
+                     CRetrieveResult* result);
+
 int64_t
 GetMemoryUsageInBytes(CSegmentInterface c_segment);
 
+// the memory usage of the segment by field and structure as json, the
+// caller frees the string
+char*
+GetMemoryUsageDetail(CSegmentInterface c_segment);
+
+// the NUMA node the segment's data is placed on, -1 for none
+int
+GetSegmentNumaNode(CSegmentInterface c_segment);
+
+// places the data the sealed segment loads from now on on `numa_node`, -1
+// for the nodes of the loading threads
+CStatus
+SetSegmentNumaNode(CSegmentInterface c_segment, int numa_node);
+
+// the searches, retrieves and loads of the segment run for cpu group
+// `cpu_group` from now on, -1 for none
+CStatus
+SetSegmentCpuGroup(CSegmentInterface c_segment, int64_t cpu_group);
+
 int64_t
 GetRowCount(CSegmentInterface c_segment);
 
@@ -70,6 +226,65 @@ GetRealCount(CSegmentInterface c_segment);
 bool
 HasRawData(CSegmentInterface c_segment, int64_t field_id);
 
+// sets can_match to false only if the min/max, index and key statistics of
+// the segment prove that no row matches the filter of the plan, so the
+// segment can be left out of the search or the retrieve
+CStatus
+CanMatchSearch(CSegmentInterface c_segment,
+               CSearchPlan c_plan,
+               bool* can_match);
+
+CStatus
+CanMatchRetrieve(CSegmentInterface c_segment,
+                 CRetrievePlan c_plan,
+                 bool* can_match);
+
+// sets expired if the ttl of the collection expired every row of the
+// segment at `timestamp`, which can be left out of the queries at it then
+CStatus
+IsSegmentExpired(CSegmentInterface c_segment,
+                 uint64_t timestamp,
+                 bool* expired);
+
+// serialized sketches of the distinct count and the quantiles of a scalar
+// field of a sealed segment, freed by the caller with free(); empty if the
+// field has none. The sketches of any segments of a field merge.
+CStatus
+GetFieldSketch(CSegmentInterface c_segment,
+               int64_t field_id,
+               CProto* sketch);
+
+// merges `num_sketches` serialized field sketches into `merged`, freed by
+// the caller with free()
+CStatus
+MergeFieldSketches(const CProto* sketches,
+                   int64_t num_sketches,
+                   CProto* merged);
+
+// the rows and the estimated distinct values of a serialized field sketch
+CStatus
+GetFieldSketchCounts(const void* sketch,
+                     int64_t sketch_size,
+                     int64_t* row_count,
+                     int64_t* distinct_count);
+
+// `values` gets the value of each of the `num_quantiles` quantiles in
+// [0, 1], fails for the sketch of a string field
+CStatus
+GetFieldSketchQuantiles(const void* sketch,
+                        int64_t sketch_size,
+                        const double* quantiles,
+                        int64_t num_quantiles,
+                        double* values);
+
+// `index_type` gets the scalar index recommended for the field of the
+// sketch, a static string
+CStatus
+RecommendScalarIndexType(const void* sketch,
+                         int64_t sketch_size,
+                         CDataType data_type,
+                         const char** index_type);
+
 //////////////////////////////    interfaces for growing segment    //////////////////////////////
 CStatus
 Insert(CSegmentInterface c_segment,
@@ -80,18 +295,174 @@ Insert(CSegmentInterface c_segment,
        const uint8_t* data_info,
        const uint64_t data_info_len);
 
+// same as Insert, from a raw column of every field, with no protobuf to
+// decode: column i of field_ids[i] is column_data[i],
+// fixed width values or vector rows packed, or the bytes of varchar and
+// json rows, row j is [column_offsets[i][j], column_offsets[i][j + 1]),
+// column_offsets[i] is NULL for the other types
+CStatus
+InsertColumns(CSegmentInterface c_segment,
+              int64_t reserved_offset,
+              int64_t size,
+              const int64_t* row_ids,
+              const uint64_t* timestamps,
+              int64_t num_columns,
+              const int64_t* field_ids,
+              const void* const* column_data,
+              const int64_t* const* column_offsets);
+
 CStatus
 PreInsert(CSegmentInterface c_segment, int64_t size, int64_t* offset);
 
+// same as Insert, and the older rows of the pks of the records are deleted
+// at the timestamps of the new ones, with no Delete to call; the rows are
+// reserved by PreInsert, the delete entries by the segment
+CStatus
+Upsert(CSegmentInterface c_segment,
+       int64_t reserved_offset,
+       int64_t size,
+       const int64_t* row_ids,
+       const uint64_t* timestamps,
+       const uint8_t* data_info,
+       const uint64_t data_info_len);
+
 //////////////////////////////    interfaces for sealed segment    //////////////////////////////
 CStatus
 LoadFieldData(CSegmentInterface c_segment,
               CLoadFieldDataInfo load_field_data_info);
 
+// load field data from the serialized binlog files of the field directly
+CStatus
+LoadFieldDataFromBinlogs(CSegmentInterface c_segment,
+                         int64_t field_id,
+                         int64_t row_count,
+                         const uint8_t* const* binlogs,
+                         const int64_t* binlog_sizes,
+                         int64_t num_binlogs,
+                         const char* mmap_dir_path);
+
+// load the fields of a segment, its row ids and timestamps among them, in
+// one call, the fields are decoded and built in parallel with at most
+// `memory_budget` bytes of binlogs in flight, 0 for no limit
+CStatus
+LoadFieldDatasFromBinlogs(CSegmentInterface c_segment,
+                          const CFieldBinlogs* fields,
+                          int64_t num_fields,
+                          const char* mmap_dir_path,
+                          int64_t memory_budget);
+
+// estimates the resources loading `fields` into a sealed segment of
+// `collection` takes before anything is downloaded
+CStatus
+EstimateLoadResource(CCollection collection,
+                     const CFieldLoadResource* fields,
+                     int64_t num_fields,
+                     CLoadResource* resource);
+
+// extract the values of the json pointers of a loaded json field, so filters
+// on them don't parse the json of every row
+CStatus
+LoadJsonKeyIndex(CSegmentInterface c_segment,
+                 int64_t field_id,
+                 const char* const* pointers,
+                 int64_t num_pointers);
+
 CStatus
 LoadDeletedRecord(CSegmentInterface c_segment,
                   CLoadDeletedRecordInfo deleted_record_info);
 
+// takes the pk range and bloom filter of a sealed segment from the pk stats
+// log written when it was flushed, instead of building them from its pks
+CStatus
+LoadPkStats(CSegmentInterface c_segment,
+            const uint8_t* stats_log,
+            int64_t stats_log_size);
+
+// the index appended after it is allocated from the jemalloc arena of the
+// segment it's loaded into, if the segment has one
+CStatus
+AppendSegmentArena(CLoadIndexInfo c_load_index_info,
+                   CSegmentInterface c_segment);
+
+// loads the rows, pk stats and deletes of the growing segment `c_growing`
+// of the same collection into the sealed segment, in memory, instead of
+// loading its binlogs once it has been flushed
+CStatus
+LoadFromGrowingSegment(CSegmentInterface c_segment,
+                       CSegmentInterface c_growing);
+
+// loads the deletes of the delta logs at `paths` of the storage of
+// `c_storage_config`, they are read and decoded in parallel
+CStatus
+LoadDeletedRecordFromBinlogs(CSegmentInterface c_segment,
+                             CStorageConfig c_storage_config,
+                             const char* const* paths,
+                             int64_t num_paths);
+
+// registers the binlogs at `paths` of the storage of `c_storage_config` as
+// the data of the field, which is fetched on its first access
+CStatus
+LoadFieldDataLazily(CSegmentInterface c_segment,
+                    CStorageConfig c_storage_config,
+                    int64_t field_id,
+                    int64_t row_count,
+                    const char* const* paths,
+                    int64_t num_paths);
+
+// drops the least recently used lazily loaded fields of the segment until
+// at most `memory_budget` bytes of them are resident, the freed bytes are
+// set to `evicted_bytes`
+CStatus
+EvictLazyFieldData(CSegmentInterface c_segment,
+                   int64_t memory_budget,
+                   int64_t* evicted_bytes);
+
+// writes the first `row_count` rows of each of the `num_fields` fields of
+// a growing segment, its row ids and timestamps among them, to a binlog at
+// `paths[i]` of the storage of `c_storage_config`, the fields are encoded
+// in parallel; `binlogs` gets the binlog of each field. The pk stats log
+// is written to `stats_path` unless it is empty, `stats_log_size` gets its
+// size.
+CStatus
+FlushGrowingSegment(CSegmentInterface c_segment,
+                    CStorageConfig c_storage_config,
+                    int64_t collection_id,
+                    int64_t partition_id,
+                    int64_t row_count,
+                    const int64_t* field_ids,
+                    const char* const* paths,
+                    int64_t num_fields,
+                    const char* stats_path,
+                    CFlushedBinlog* binlogs,
+                    int64_t* stats_log_size);
+
+// writes the acked rows and deletes of a growing segment to the local
+// directory `dir` with the `position_size` bytes of `position`, where the
+// replay of its channel resumes after a restore; `row_count` and
+// `delete_count` get the rows and deletes written
+CStatus
+SaveGrowingSegmentSnapshot(CSegmentInterface c_segment,
+                           const char* dir,
+                           const void* position,
+                           int64_t position_size,
+                           int64_t* row_count,
+                           int64_t* delete_count);
+
+// fills an empty growing segment from the snapshot in `dir`, `position`
+// gets the position it was saved with, freed by the caller with free()
+CStatus
+RestoreGrowingSegmentSnapshot(CSegmentInterface c_segment,
+                              const char* dir,
+                              CProto* position);
+
+// folds the deletes up to `oldest_query_ts` into a bitmap and releases
+// them, the caller must not search or query the segment at an older
+// timestamp afterwards; `compacted` is the number of deletes folded so far
+CStatus
+CompactDeletedRecord(CSegmentInterface c_segment,
+                     uint64_t oldest_query_ts,
+                     int64_t* compacted);
+
 CStatus
 UpdateSealedSegmentIndex(CSegmentInterface c_segment,
                          CLoadIndexInfo c_load_index_info);
@@ -0,0 +1,755 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simd/avx2.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "simd/ref.h"
+
+// This translation unit is compiled with -mavx2, its kernels are only called
+// after the hook has checked that the running CPU supports AVX2.
+namespace milvus::simd {
+
+namespace {
+
+constexpr int
+FloatPredicate(CompareType op) {
+    switch (op) {
+        case CompareType::EQ:
+            return _CMP_EQ_OQ;
+        case CompareType::NE:
+            return _CMP_NEQ_UQ;
+        case CompareType::GT:
+            return _CMP_GT_OQ;
+        case CompareType::GE:
+            return _CMP_GE_OQ;
+        case CompareType::LT:
+            return _CMP_LT_OQ;
+        case CompareType::LE:
+            return _CMP_LE_OQ;
+    }
+    return _CMP_EQ_OQ;
+}
+
+template <typename T>
+struct Avx2Traits;
+
+template <>
+struct Avx2Traits<float> {
+    using V = __m256;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kNativeCmp = true;
+
+    static V
+    set1(float v) {
+        return _mm256_set1_ps(v);
+    }
+
+    static V
+    load(const float* p) {
+        return _mm256_loadu_ps(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr int pred = FloatPredicate(op);
+        return uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(x, v, pred)));
+    }
+};
+
+template <>
+struct Avx2Traits<double> {
+    using V = __m256d;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kNativeCmp = true;
+
+    static V
+    set1(double v) {
+        return _mm256_set1_pd(v);
+    }
+
+    static V
+    load(const double* p) {
+        return _mm256_loadu_pd(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr int pred = FloatPredicate(op);
+        return uint32_t(_mm256_movemask_pd(_mm256_cmp_pd(x, v, pred)));
+    }
+};
+
+// AVX2 only has signed eq/gt for integers, the other predicates are derived
+// from them in Cmp().
+template <>
+struct Avx2Traits<int8_t> {
+    using V = __m256i;
+    static constexpr size_t kLanes = 32;
+    static constexpr bool kNativeCmp = false;
+
+    static V
+    set1(int8_t v) {
+        return _mm256_set1_epi8(v);
+    }
+
+    static V
+    load(const int8_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static uint64_t
+    eq(V x, V v) {
+        return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v)));
+    }
+
+    static uint64_t
+    gt(V x, V v) {
+        return uint32_t(_mm256_movemask_epi8(_mm256_cmpgt_epi8(x, v)));
+    }
+};
+
+// int16 lanes are narrowed to bytes so that one movemask yields 32 bits.
+struct Int16x32 {
+    __m256i lo;
+    __m256i hi;
+};
+
+template <>
+struct Avx2Traits<int16_t> {
+    using V = Int16x32;
+    static constexpr size_t kLanes = 32;
+    static constexpr bool kNativeCmp = false;
+
+    static V
+    set1(int16_t v) {
+        auto x = _mm256_set1_epi16(v);
+        return {x, x};
+    }
+
+    static V
+    load(const int16_t* p) {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16))};
+    }
+
+    static uint64_t
+    narrow(__m256i lo, __m256i hi) {
+        // packs interleaves 128-bit lanes, restore the element order
+        auto packed =
+            _mm256_permute4x64_epi64(_mm256_packs_epi16(lo, hi), 0xD8);
+        return uint32_t(_mm256_movemask_epi8(packed));
+    }
+
+    static uint64_t
+    eq(V x, V v) {
+        return narrow(_mm256_cmpeq_epi16(x.lo, v.lo),
+                      _mm256_cmpeq_epi16(x.hi, v.hi));
+    }
+
+    static uint64_t
+    gt(V x, V v) {
+        return narrow(_mm256_cmpgt_epi16(x.lo, v.lo),
+                      _mm256_cmpgt_epi16(x.hi, v.hi));
+    }
+};
+
+template <>
+struct Avx2Traits<int32_t> {
+    using V = __m256i;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kNativeCmp = false;
+
+    static V
+    set1(int32_t v) {
+        return _mm256_set1_epi32(v);
+    }
+
+    static V
+    load(const int32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static uint64_t
+    eq(V x, V v) {
+        return uint32_t(
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v))));
+    }
+
+    static uint64_t
+    gt(V x, V v) {
+        return uint32_t(
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, v))));
+    }
+};
+
+template <>
+struct Avx2Traits<int64_t> {
+    using V = __m256i;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kNativeCmp = false;
+
+    static V
+    set1(int64_t v) {
+        return _mm256_set1_epi64x(v);
+    }
+
+    static V
+    load(const int64_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static uint64_t
+    eq(V x, V v) {
+        return uint32_t(
+            _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, v))));
+    }
+
+    static uint64_t
+    gt(V x, V v) {
+        return uint32_t(
+            _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, v))));
+    }
+};
+
+// AVX2 has no unsigned compare, flipping the sign bit of both sides maps the
+// unsigned order onto the signed one.
+template <>
+struct Avx2Traits<uint64_t> {
+    using V = __m256i;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kNativeCmp = false;
+    static constexpr uint64_t kSignBit = uint64_t(1) << 63;
+
+    static V
+    set1(uint64_t v) {
+        return _mm256_set1_epi64x(int64_t(v ^ kSignBit));
+    }
+
+    static V
+    load(const uint64_t* p) {
+        return _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+            _mm256_set1_epi64x(int64_t(kSignBit)));
+    }
+
+    static uint64_t
+    eq(V x, V v) {
+        return Avx2Traits<int64_t>::eq(x, v);
+    }
+
+    static uint64_t
+    gt(V x, V v) {
+        return Avx2Traits<int64_t>::gt(x, v);
+    }
+};
+
+template <typename Tr, CompareType op>
+inline uint64_t
+Cmp(typename Tr::V x, typename Tr::V v) {
+    if constexpr (Tr::kNativeCmp) {
+        return Tr::template cmp<op>(x, v);
+    } else {
+        constexpr uint64_t full = (uint64_t(1) << Tr::kLanes) - 1;
+        if constexpr (op == CompareType::EQ) {
+            return Tr::eq(x, v);
+        } else if constexpr (op == CompareType::NE) {
+            return ~Tr::eq(x, v) & full;
+        } else if constexpr (op == CompareType::GT) {
+            return Tr::gt(x, v);
+        } else if constexpr (op == CompareType::LE) {
+            return ~Tr::gt(x, v) & full;
+        } else if constexpr (op == CompareType::LT) {
+            return Tr::gt(v, x);
+        } else {
+            return ~Tr::gt(v, x) & full;
+        }
+    }
+}
+
+// Fill `n_words` whole words, `mask_func` returns the bits of kLanes elements.
+template <typename Tr, typename T, typename MaskFunc>
+inline void
+PackWords(const T* src, size_t n_words, uint64_t* dst, MaskFunc mask_func) {
+    for (size_t w = 0; w < n_words; ++w) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < BITS_PER_WORD; j += Tr::kLanes) {
+            word |= mask_func(src + j) << j;
+        }
+        dst[w] = word;
+        src += BITS_PER_WORD;
+    }
+}
+
+template <typename T, CompareType op>
+void
+CompareValImpl(const T* src, size_t size, T val, uint64_t* dst) {
+    using Tr = Avx2Traits<T>;
+    auto v = Tr::set1(val);
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(src, n_words, dst, [v](const T* p) {
+        return Cmp<Tr, op>(Tr::load(p), v);
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        CompareValRef(op, src + done, size - done, val, dst + n_words);
+    }
+}
+
+template <typename T, CompareType lower_op, CompareType upper_op>
+void
+BetweenValImpl(const T* src, size_t size, T lower, T upper, uint64_t* dst) {
+    using Tr = Avx2Traits<T>;
+    auto lo = Tr::set1(lower);
+    auto hi = Tr::set1(upper);
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(src, n_words, dst, [lo, hi](const T* p) {
+        auto x = Tr::load(p);
+        return Cmp<Tr, lower_op>(x, lo) & Cmp<Tr, upper_op>(x, hi);
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        BetweenValRef(src + done,
+                      size - done,
+                      lower,
+                      lower_op == CompareType::GE,
+                      upper,
+                      upper_op == CompareType::LE,
+                      dst + n_words);
+    }
+}
+
+template <typename T, CompareType op>
+void
+CompareColumnImpl(const T* left, const T* right, size_t size, uint64_t* dst) {
+    using Tr = Avx2Traits<T>;
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(left, n_words, dst, [left, right](const T* p) {
+        return Cmp<Tr, op>(Tr::load(p), Tr::load(right + (p - left)));
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        CompareColumnRef(
+            op, left + done, right + done, size - done, dst + n_words);
+    }
+}
+
+}  // namespace
+
+template <typename T>
+void
+CompareValAVX2(
+    CompareType op, const T* src, size_t size, T val, uint64_t* dst) {
+    switch (op) {
+        case CompareType::EQ:
+            return CompareValImpl<T, CompareType::EQ>(src, size, val, dst);
+        case CompareType::NE:
+            return CompareValImpl<T, CompareType::NE>(src, size, val, dst);
+        case CompareType::GT:
+            return CompareValImpl<T, CompareType::GT>(src, size, val, dst);
+        case CompareType::GE:
+            return CompareValImpl<T, CompareType::GE>(src, size, val, dst);
+        case CompareType::LT:
+            return CompareValImpl<T, CompareType::LT>(src, size, val, dst);
+        case CompareType::LE:
+            return CompareValImpl<T, CompareType::LE>(src, size, val, dst);
+    }
+}
+
+template <typename T>
+void
+BetweenValAVX2(const T* src,
+               size_t size,
+               T lower,
+               bool lower_inclusive,
+               T upper,
+               bool upper_inclusive,
+               uint64_t* dst) {
+    using C = CompareType;
+    if (lower_inclusive && upper_inclusive) {
+        BetweenValImpl<T, C::GE, C::LE>(src, size, lower, upper, dst);
+    } else if (lower_inclusive && !upper_inclusive) {
+        BetweenValImpl<T, C::GE, C::LT>(src, size, lower, upper, dst);
+    } else if (!lower_inclusive && upper_inclusive) {
+        BetweenValImpl<T, C::GT, C::LE>(src, size, lower, upper, dst);
+    } else {
+        BetweenValImpl<T, C::GT, C::LT>(src, size, lower, upper, dst);
+    }
+}
+
+template <typename T>
+void
+CompareColumnAVX2(CompareType op,
+                  const T* left,
+                  const T* right,
+                  size_t size,
+                  uint64_t* dst) {
+    using C = CompareType;
+    switch (op) {
+        case C::EQ:
+            return CompareColumnImpl<T, C::EQ>(left, right, size, dst);
+        case C::NE:
+            return CompareColumnImpl<T, C::NE>(left, right, size, dst);
+        case C::GT:
+            return CompareColumnImpl<T, C::GT>(left, right, size, dst);
+        case C::GE:
+            return CompareColumnImpl<T, C::GE>(left, right, size, dst);
+        case C::LT:
+            return CompareColumnImpl<T, C::LT>(left, right, size, dst);
+        case C::LE:
+            return CompareColumnImpl<T, C::LE>(left, right, size, dst);
+    }
+}
+
+#define INSTANTIATE_AVX2_KERNELS(T)                                       \
+    template void CompareValAVX2<T>(                                      \
+        CompareType, const T*, size_t, T, uint64_t*);                     \
+    template void BetweenValAVX2<T>(                                      \
+        const T*, size_t, T, bool, T, bool, uint64_t*);                   \
+    template void CompareColumnAVX2<T>(                                   \
+        CompareType, const T*, const T*, size_t, uint64_t*);
+
+INSTANTIATE_AVX2_KERNELS(int8_t)
+INSTANTIATE_AVX2_KERNELS(int16_t)
+INSTANTIATE_AVX2_KERNELS(int32_t)
+INSTANTIATE_AVX2_KERNELS(int64_t)
+INSTANTIATE_AVX2_KERNELS(uint64_t)
+INSTANTIATE_AVX2_KERNELS(float)
+INSTANTIATE_AVX2_KERNELS(double)
+
+#undef INSTANTIATE_AVX2_KERNELS
+
+namespace {
+
+constexpr size_t kBinaryQueryTile = 4;
+
+// the bits set in every 64 bit lane of `v`, by looking the nibbles up in a
+// table of their popcounts
+inline __m256i
+Popcount64(__m256i v) {
+    const auto table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4,
+                                        0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4);
+    const auto low_mask = _mm256_set1_epi8(0x0f);
+    auto low = _mm256_and_si256(v, low_mask);
+    auto high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, low),
+                                 _mm256_shuffle_epi8(table, high));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+inline uint64_t
+ReduceAdd64(__m256i v) {
+    auto sum = _mm_add_epi64(_mm256_castsi256_si128(v),
+                             _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+}
+
+// the counts of kQueries queries, `code_size` apart, against one row over
+// its first `body` bytes, a whole number of registers; each register of
+// the row is loaded once for all the queries
+template <BinaryMetric metric, size_t kQueries>
+void
+TileBinaryCounts(const uint8_t* queries,
+                 const uint8_t* row,
+                 size_t code_size,
+                 size_t body,
+                 uint64_t* num,
+                 uint64_t* den) {
+    __m256i num_acc[kQueries], den_acc[kQueries];
+    for (size_t j = 0; j < kQueries; ++j) {
+        num_acc[j] = _mm256_setzero_si256();
+        den_acc[j] = _mm256_setzero_si256();
+    }
+    for (size_t i = 0; i < body; i += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        for (size_t j = 0; j < kQueries; ++j) {
+            auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                queries + j * code_size + i));
+            if constexpr (metric == BinaryMetric::HAMMING) {
+                num_acc[j] = _mm256_add_epi64(
+                    num_acc[j], Popcount64(_mm256_xor_si256(x, y)));
+            } else {
+                num_acc[j] = _mm256_add_epi64(
+                    num_acc[j], Popcount64(_mm256_and_si256(x, y)));
+                den_acc[j] = _mm256_add_epi64(
+                    den_acc[j], Popcount64(_mm256_or_si256(x, y)));
+            }
+        }
+    }
+    for (size_t j = 0; j < kQueries; ++j) {
+        num[j] = ReduceAdd64(num_acc[j]);
+        den[j] = ReduceAdd64(den_acc[j]);
+    }
+}
+
+template <BinaryMetric metric>
+void
+BinaryDistancesImpl(const uint8_t* queries,
+                    size_t nq,
+                    const uint8_t* rows,
+                    size_t nb,
+                    size_t code_size,
+                    float* dst) {
+    auto body = code_size / 32 * 32;
+    uint64_t num[kBinaryQueryTile], den[kBinaryQueryTile];
+    for (size_t r = 0; r < nb; ++r) {
+        auto row = rows + r * code_size;
+        for (size_t q = 0; q < nq;) {
+            auto tile = nq - q >= kBinaryQueryTile ? kBinaryQueryTile : 1;
+            auto tile_queries = queries + q * code_size;
+            if (tile == kBinaryQueryTile) {
+                TileBinaryCounts<metric, kBinaryQueryTile>(
+                    tile_queries, row, code_size, body, num, den);
+            } else {
+                TileBinaryCounts<metric, 1>(
+                    tile_queries, row, code_size, body, num, den);
+            }
+            for (size_t j = 0; j < tile; ++j) {
+                BinaryCountsRef<metric>(tile_queries + j * code_size + body,
+                                        row + body,
+                                        code_size - body,
+                                        num[j],
+                                        den[j]);
+                dst[(q + j) * nb + r] = BinaryDistance<metric>(num[j], den[j]);
+            }
+            q += tile;
+        }
+    }
+}
+
+}  // namespace
+
+void
+BinaryDistancesAVX2(BinaryMetric metric,
+                    const uint8_t* queries,
+                    size_t nq,
+                    const uint8_t* rows,
+                    size_t nb,
+                    size_t code_size,
+                    float* dst) {
+    if (metric == BinaryMetric::HAMMING) {
+        BinaryDistancesImpl<BinaryMetric::HAMMING>(
+            queries, nq, rows, nb, code_size, dst);
+    } else {
+        BinaryDistancesImpl<BinaryMetric::JACCARD>(
+            queries, nq, rows, nb, code_size, dst);
+    }
+}
+
+namespace {
+
+template <BitwiseOp op>
+void
+BitwiseWordsImpl(uint64_t* dst, const uint64_t* src, size_t words) {
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if constexpr (op == BitwiseOp::AND) {
+            d = _mm256_and_si256(d, s);
+        } else if constexpr (op == BitwiseOp::OR) {
+            d = _mm256_or_si256(d, s);
+        } else {
+            d = _mm256_andnot_si256(s, d);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), d);
+    }
+    BitwiseWordsRef(op, dst + i, src + i, words - i);
+}
+
+}  // namespace
+
+void
+BitwiseWordsAVX2(BitwiseOp op,
+                 uint64_t* dst,
+                 const uint64_t* src,
+                 size_t words) {
+    switch (op) {
+        case BitwiseOp::AND:
+            return BitwiseWordsImpl<BitwiseOp::AND>(dst, src, words);
+        case BitwiseOp::OR:
+            return BitwiseWordsImpl<BitwiseOp::OR>(dst, src, words);
+        case BitwiseOp::ANDNOT:
+            return BitwiseWordsImpl<BitwiseOp::ANDNOT>(dst, src, words);
+    }
+}
+
+uint64_t
+PopcountWordsAVX2(const uint64_t* src, size_t words) {
+    auto acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        acc = _mm256_add_epi64(acc, Popcount64(v));
+    }
+    return ReduceAdd64(acc) + PopcountWordsRef(src + i, words - i);
+}
+
+size_t
+FindNonZeroWordAVX2(const uint64_t* src, size_t begin, size_t words) {
+    for (; begin + 4 <= words; begin += 4) {
+        auto v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + begin));
+        if (!_mm256_testz_si256(v, v)) {
+            return FindNonZeroWordRef(src, begin, begin + 4);
+        }
+    }
+    return FindNonZeroWordRef(src, begin, words);
+}
+
+namespace {
+
+// the strings are compared by their first 16 bytes in one register, the
+// bytes after them only on a tie
+constexpr size_t STRING_PREFIX = 16;
+
+// The first min(size, 16) bytes of a string, the others are undefined. A
+// short string is loaded whole when the load can't cross into the next
+// page, it can't fault then.
+inline __m128i
+LoadStringPrefix(const char* data, size_t size) {
+    if (size >= STRING_PREFIX) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    }
+#if !defined(__SANITIZE_ADDRESS__)
+    if (size > 0 &&
+        (reinterpret_cast<uintptr_t>(data) & 4095) <= 4096 - STRING_PREFIX) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    }
+#endif
+    alignas(16) char buffer[STRING_PREFIX] = {};
+    if (size > 0) {
+        std::memcpy(buffer, data, size);
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(buffer));
+}
+
+// the bits of the first min(n, 16) bytes in a byte mask
+inline uint32_t
+PrefixMask(size_t n) {
+    return n >= STRING_PREFIX ? 0xFFFF : (uint32_t(1) << n) - 1;
+}
+
+// the bytes of x equal to the ones of the loaded prefix, as a mask
+inline uint32_t
+EqualBytes(std::string_view x, __m128i prefix) {
+    auto v = LoadStringPrefix(x.data(), x.size());
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, prefix)));
+}
+
+inline bool
+EqualString(std::string_view x, std::string_view val, __m128i val_prefix) {
+    if (x.size() != val.size()) {
+        return false;
+    }
+    auto mask = PrefixMask(x.size());
+    if ((EqualBytes(x, val_prefix) & mask) != mask) {
+        return false;
+    }
+    return x.size() <= STRING_PREFIX ||
+           std::memcmp(x.data() + STRING_PREFIX,
+                       val.data() + STRING_PREFIX,
+                       x.size() - STRING_PREFIX) == 0;
+}
+
+// <0, 0 or >0 as x.compare(val)
+inline int
+CompareString(std::string_view x, std::string_view val, __m128i val_prefix) {
+    auto common = std::min(x.size(), val.size());
+    auto diff = ~EqualBytes(x, val_prefix) & PrefixMask(common);
+    if (diff != 0) {
+        auto i = __builtin_ctz(diff);
+        return int(uint8_t(x[i])) - int(uint8_t(val[i]));
+    }
+    if (common <= STRING_PREFIX) {
+        return x.size() < val.size() ? -1 : int(x.size() > val.size());
+    }
+    return x.substr(STRING_PREFIX).compare(val.substr(STRING_PREFIX));
+}
+
+inline bool
+StartsWith(std::string_view x, std::string_view prefix, __m128i head) {
+    if (x.size() < prefix.size()) {
+        return false;
+    }
+    auto mask = PrefixMask(prefix.size());
+    if ((EqualBytes(x, head) & mask) != mask) {
+        return false;
+    }
+    return prefix.size() <= STRING_PREFIX ||
+           std::memcmp(x.data() + STRING_PREFIX,
+                       prefix.data() + STRING_PREFIX,
+                       prefix.size() - STRING_PREFIX) == 0;
+}
+
+}  // namespace
+
+void
+CompareStringsAVX2(CompareType op,
+                   const std::string_view* src,
+                   size_t size,
+                   std::string_view val,
+                   uint64_t* dst) {
+    using View = std::string_view;
+    auto v = LoadStringPrefix(val.data(), val.size());
+    switch (op) {
+        case CompareType::EQ:
+            return PackBits(src, size, dst, [&](View x) {
+                return EqualString(x, val, v);
+            });
+        case CompareType::NE:
+            return PackBits(src, size, dst, [&](View x) {
+                return !EqualString(x, val, v);
+            });
+        case CompareType::GT:
+            return PackBits(src, size, dst, [&](View x) {
+                return CompareString(x, val, v) > 0;
+            });
+        case CompareType::GE:
+            return PackBits(src, size, dst, [&](View x) {
+                return CompareString(x, val, v) >= 0;
+            });
+        case CompareType::LT:
+            return PackBits(src, size, dst, [&](View x) {
+                return CompareString(x, val, v) < 0;
+            });
+        case CompareType::LE:
+            return PackBits(src, size, dst, [&](View x) {
+                return CompareString(x, val, v) <= 0;
+            });
+    }
+}
+
+void
+PrefixMatchStringsAVX2(const std::string_view* src,
+                       size_t size,
+                       std::string_view prefix,
+                       uint64_t* dst) {
+    auto head = LoadStringPrefix(prefix.data(), prefix.size());
+    PackBits(src, size, dst, [&](std::string_view x) {
+        return StartsWith(x, prefix, head);
+    });
+}
+
+}  // namespace milvus::simd
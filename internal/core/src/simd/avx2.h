@@ -0,0 +1,88 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "simd/common.h"
+
+namespace milvus::simd {
+
+template <typename T>
+void
+CompareValAVX2(
+    CompareType op, const T* src, size_t size, T val, uint64_t* dst);
+
+template <typename T>
+void
+BetweenValAVX2(const T* src,
+               size_t size,
+               T lower,
+               bool lower_inclusive,
+               T upper,
+               bool upper_inclusive,
+               uint64_t* dst);
+
+template <typename T>
+void
+CompareColumnAVX2(CompareType op,
+                  const T* left,
+                  const T* right,
+                  size_t size,
+                  uint64_t* dst);
+
+// the string kernels, see CompareStrings and PrefixMatchStrings
+void
+CompareStringsAVX2(CompareType op,
+                   const std::string_view* src,
+                   size_t size,
+                   std::string_view val,
+                   uint64_t* dst);
+
+void
+PrefixMatchStringsAVX2(const std::string_view* src,
+                       size_t size,
+                       std::string_view prefix,
+                       uint64_t* dst);
+
+// binary distances of `nq` queries to `nb` rows, see BinaryDistances
+void
+BinaryDistancesAVX2(BinaryMetric metric,
+                    const uint8_t* queries,
+                    size_t nq,
+                    const uint8_t* rows,
+                    size_t nb,
+                    size_t code_size,
+                    float* dst);
+
+// the word kernels over packed bits, see BitwiseWords, PopcountWords and
+// FindNextBit
+void
+BitwiseWordsAVX2(BitwiseOp op,
+                 uint64_t* dst,
+                 const uint64_t* src,
+                 size_t words);
+
+uint64_t
+PopcountWordsAVX2(const uint64_t* src, size_t words);
+
+size_t
+FindNonZeroWordAVX2(const uint64_t* src, size_t begin, size_t words);
+
+}  // namespace milvus::simd
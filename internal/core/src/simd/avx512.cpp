@@ -0,0 +1,539 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simd/avx512.h"
+
+#include <immintrin.h>
+
+#include "simd/ref.h"
+
+// This translation unit is compiled with -mavx512f -mavx512bw, its kernels
+// are only called after the hook has checked that the running CPU supports
+// both extensions.
+namespace milvus::simd {
+
+namespace {
+
+constexpr int
+FloatPredicate(CompareType op) {
+    switch (op) {
+        case CompareType::EQ:
+            return _CMP_EQ_OQ;
+        case CompareType::NE:
+            return _CMP_NEQ_UQ;
+        case CompareType::GT:
+            return _CMP_GT_OQ;
+        case CompareType::GE:
+            return _CMP_GE_OQ;
+        case CompareType::LT:
+            return _CMP_LT_OQ;
+        case CompareType::LE:
+            return _CMP_LE_OQ;
+    }
+    return _CMP_EQ_OQ;
+}
+
+constexpr int
+IntPredicate(CompareType op) {
+    switch (op) {
+        case CompareType::EQ:
+            return _MM_CMPINT_EQ;
+        case CompareType::NE:
+            return _MM_CMPINT_NE;
+        case CompareType::GT:
+            return _MM_CMPINT_NLE;
+        case CompareType::GE:
+            return _MM_CMPINT_NLT;
+        case CompareType::LT:
+            return _MM_CMPINT_LT;
+        case CompareType::LE:
+            return _MM_CMPINT_LE;
+    }
+    return _MM_CMPINT_EQ;
+}
+
+template <typename T>
+struct Avx512Traits;
+
+template <>
+struct Avx512Traits<float> {
+    using V = __m512;
+    static constexpr size_t kLanes = 16;
+
+    static V
+    set1(float v) {
+        return _mm512_set1_ps(v);
+    }
+
+    static V
+    load(const float* p) {
+        return _mm512_loadu_ps(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr int pred = FloatPredicate(op);
+        return _mm512_cmp_ps_mask(x, v, pred);
+    }
+};
+
+template <>
+struct Avx512Traits<double> {
+    using V = __m512d;
+    static constexpr size_t kLanes = 8;
+
+    static V
+    set1(double v) {
+        return _mm512_set1_pd(v);
+    }
+
+    static V
+    load(const double* p) {
+        return _mm512_loadu_pd(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr int pred = FloatPredicate(op);
+        return _mm512_cmp_pd_mask(x, v, pred);
+    }
+};
+
+template <>
+struct Avx512Traits<int8_t> {
+    using V = __m512i;
+    static constexpr size_t kLanes = 64;
+
+    static V
+    set1(int8_t v) {
+        return _mm512_set1_epi8(v);
+    }
+
+    static V
+    load(const int8_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr auto pred = IntPredicate(op);
+        return _mm512_cmp_epi8_mask(x, v, pred);
+    }
+};
+
+template <>
+struct Avx512Traits<int16_t> {
+    using V = __m512i;
+    static constexpr size_t kLanes = 32;
+
+    static V
+    set1(int16_t v) {
+        return _mm512_set1_epi16(v);
+    }
+
+    static V
+    load(const int16_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr auto pred = IntPredicate(op);
+        return _mm512_cmp_epi16_mask(x, v, pred);
+    }
+};
+
+template <>
+struct Avx512Traits<int32_t> {
+    using V = __m512i;
+    static constexpr size_t kLanes = 16;
+
+    static V
+    set1(int32_t v) {
+        return _mm512_set1_epi32(v);
+    }
+
+    static V
+    load(const int32_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr auto pred = IntPredicate(op);
+        return _mm512_cmp_epi32_mask(x, v, pred);
+    }
+};
+
+template <>
+struct Avx512Traits<int64_t> {
+    using V = __m512i;
+    static constexpr size_t kLanes = 8;
+
+    static V
+    set1(int64_t v) {
+        return _mm512_set1_epi64(v);
+    }
+
+    static V
+    load(const int64_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr auto pred = IntPredicate(op);
+        return _mm512_cmp_epi64_mask(x, v, pred);
+    }
+};
+
+template <>
+struct Avx512Traits<uint64_t> {
+    using V = __m512i;
+    static constexpr size_t kLanes = 8;
+
+    static V
+    set1(uint64_t v) {
+        return _mm512_set1_epi64(int64_t(v));
+    }
+
+    static V
+    load(const uint64_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+
+    template <CompareType op>
+    static uint64_t
+    cmp(V x, V v) {
+        constexpr auto pred = IntPredicate(op);
+        return _mm512_cmp_epu64_mask(x, v, pred);
+    }
+};
+
+template <typename Tr, typename T, typename MaskFunc>
+inline void
+PackWords(const T* src, size_t n_words, uint64_t* dst, MaskFunc mask_func) {
+    for (size_t w = 0; w < n_words; ++w) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < BITS_PER_WORD; j += Tr::kLanes) {
+            word |= mask_func(src + j) << j;
+        }
+        dst[w] = word;
+        src += BITS_PER_WORD;
+    }
+}
+
+template <typename T, CompareType op>
+void
+CompareValImpl(const T* src, size_t size, T val, uint64_t* dst) {
+    using Tr = Avx512Traits<T>;
+    auto v = Tr::set1(val);
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(src, n_words, dst, [v](const T* p) {
+        return Tr::template cmp<op>(Tr::load(p), v);
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        CompareValRef(op, src + done, size - done, val, dst + n_words);
+    }
+}
+
+template <typename T, CompareType lower_op, CompareType upper_op>
+void
+BetweenValImpl(const T* src, size_t size, T lower, T upper, uint64_t* dst) {
+    using Tr = Avx512Traits<T>;
+    auto lo = Tr::set1(lower);
+    auto hi = Tr::set1(upper);
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(src, n_words, dst, [lo, hi](const T* p) {
+        auto x = Tr::load(p);
+        return Tr::template cmp<lower_op>(x, lo) &
+               Tr::template cmp<upper_op>(x, hi);
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        BetweenValRef(src + done,
+                      size - done,
+                      lower,
+                      lower_op == CompareType::GE,
+                      upper,
+                      upper_op == CompareType::LE,
+                      dst + n_words);
+    }
+}
+
+template <typename T, CompareType op>
+void
+CompareColumnImpl(const T* left, const T* right, size_t size, uint64_t* dst) {
+    using Tr = Avx512Traits<T>;
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(left, n_words, dst, [left, right](const T* p) {
+        return Tr::template cmp<op>(Tr::load(p), Tr::load(right + (p - left)));
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        CompareColumnRef(
+            op, left + done, right + done, size - done, dst + n_words);
+    }
+}
+
+}  // namespace
+
+template <typename T>
+void
+CompareValAVX512(
+    CompareType op, const T* src, size_t size, T val, uint64_t* dst) {
+    switch (op) {
+        case CompareType::EQ:
+            return CompareValImpl<T, CompareType::EQ>(src, size, val, dst);
+        case CompareType::NE:
+            return CompareValImpl<T, CompareType::NE>(src, size, val, dst);
+        case CompareType::GT:
+            return CompareValImpl<T, CompareType::GT>(src, size, val, dst);
+        case CompareType::GE:
+            return CompareValImpl<T, CompareType::GE>(src, size, val, dst);
+        case CompareType::LT:
+            return CompareValImpl<T, CompareType::LT>(src, size, val, dst);
+        case CompareType::LE:
+            return CompareValImpl<T, CompareType::LE>(src, size, val, dst);
+    }
+}
+
+template <typename T>
+void
+BetweenValAVX512(const T* src,
+                 size_t size,
+                 T lower,
+                 bool lower_inclusive,
+                 T upper,
+                 bool upper_inclusive,
+                 uint64_t* dst) {
+    using C = CompareType;
+    if (lower_inclusive && upper_inclusive) {
+        BetweenValImpl<T, C::GE, C::LE>(src, size, lower, upper, dst);
+    } else if (lower_inclusive && !upper_inclusive) {
+        BetweenValImpl<T, C::GE, C::LT>(src, size, lower, upper, dst);
+    } else if (!lower_inclusive && upper_inclusive) {
+        BetweenValImpl<T, C::GT, C::LE>(src, size, lower, upper, dst);
+    } else {
+        BetweenValImpl<T, C::GT, C::LT>(src, size, lower, upper, dst);
+    }
+}
+
+template <typename T>
+void
+CompareColumnAVX512(CompareType op,
+                    const T* left,
+                    const T* right,
+                    size_t size,
+                    uint64_t* dst) {
+    using C = CompareType;
+    switch (op) {
+        case C::EQ:
+            return CompareColumnImpl<T, C::EQ>(left, right, size, dst);
+        case C::NE:
+            return CompareColumnImpl<T, C::NE>(left, right, size, dst);
+        case C::GT:
+            return CompareColumnImpl<T, C::GT>(left, right, size, dst);
+        case C::GE:
+            return CompareColumnImpl<T, C::GE>(left, right, size, dst);
+        case C::LT:
+            return CompareColumnImpl<T, C::LT>(left, right, size, dst);
+        case C::LE:
+            return CompareColumnImpl<T, C::LE>(left, right, size, dst);
+    }
+}
+
+#define INSTANTIATE_AVX512_KERNELS(T)                                     \
+    template void CompareValAVX512<T>(                                    \
+        CompareType, const T*, size_t, T, uint64_t*);                     \
+    template void BetweenValAVX512<T>(                                    \
+        const T*, size_t, T, bool, T, bool, uint64_t*);                   \
+    template void CompareColumnAVX512<T>(                                 \
+        CompareType, const T*, const T*, size_t, uint64_t*);
+
+INSTANTIATE_AVX512_KERNELS(int8_t)
+INSTANTIATE_AVX512_KERNELS(int16_t)
+INSTANTIATE_AVX512_KERNELS(int32_t)
+INSTANTIATE_AVX512_KERNELS(int64_t)
+INSTANTIATE_AVX512_KERNELS(uint64_t)
+INSTANTIATE_AVX512_KERNELS(float)
+INSTANTIATE_AVX512_KERNELS(double)
+
+#undef INSTANTIATE_AVX512_KERNELS
+
+namespace {
+
+constexpr size_t kBinaryQueryTile = 4;
+
+// the counts of kQueries queries, `code_size` apart, against one row over
+// its first `body` bytes, a whole number of registers; each register of
+// the row is loaded once for all the queries
+template <BinaryMetric metric, size_t kQueries>
+__attribute__((target("avx512vpopcntdq"))) void
+TileBinaryCounts(const uint8_t* queries,
+                 const uint8_t* row,
+                 size_t code_size,
+                 size_t body,
+                 uint64_t* num,
+                 uint64_t* den) {
+    __m512i num_acc[kQueries], den_acc[kQueries];
+    for (size_t j = 0; j < kQueries; ++j) {
+        num_acc[j] = _mm512_setzero_si512();
+        den_acc[j] = _mm512_setzero_si512();
+    }
+    for (size_t i = 0; i < body; i += 64) {
+        auto x = _mm512_loadu_si512(row + i);
+        for (size_t j = 0; j < kQueries; ++j) {
+            auto y = _mm512_loadu_si512(queries + j * code_size + i);
+            if constexpr (metric == BinaryMetric::HAMMING) {
+                num_acc[j] = _mm512_add_epi64(
+                    num_acc[j], _mm512_popcnt_epi64(_mm512_xor_si512(x, y)));
+            } else {
+                num_acc[j] = _mm512_add_epi64(
+                    num_acc[j], _mm512_popcnt_epi64(_mm512_and_si512(x, y)));
+                den_acc[j] = _mm512_add_epi64(
+                    den_acc[j], _mm512_popcnt_epi64(_mm512_or_si512(x, y)));
+            }
+        }
+    }
+    for (size_t j = 0; j < kQueries; ++j) {
+        num[j] = _mm512_reduce_add_epi64(num_acc[j]);
+        den[j] = _mm512_reduce_add_epi64(den_acc[j]);
+    }
+}
+
+template <BinaryMetric metric>
+__attribute__((target("avx512vpopcntdq"))) void
+BinaryDistancesImpl(const uint8_t* queries,
+                    size_t nq,
+                    const uint8_t* rows,
+                    size_t nb,
+                    size_t code_size,
+                    float* dst) {
+    auto body = code_size / 64 * 64;
+    uint64_t num[kBinaryQueryTile], den[kBinaryQueryTile];
+    for (size_t r = 0; r < nb; ++r) {
+        auto row = rows + r * code_size;
+        for (size_t q = 0; q < nq;) {
+            auto tile = nq - q >= kBinaryQueryTile ? kBinaryQueryTile : 1;
+            auto tile_queries = queries + q * code_size;
+            if (tile == kBinaryQueryTile) {
+                TileBinaryCounts<metric, kBinaryQueryTile>(
+                    tile_queries, row, code_size, body, num, den);
+            } else {
+                TileBinaryCounts<metric, 1>(
+                    tile_queries, row, code_size, body, num, den);
+            }
+            for (size_t j = 0; j < tile; ++j) {
+                BinaryCountsRef<metric>(tile_queries + j * code_size + body,
+                                        row + body,
+                                        code_size - body,
+                                        num[j],
+                                        den[j]);
+                dst[(q + j) * nb + r] = BinaryDistance<metric>(num[j], den[j]);
+            }
+            q += tile;
+        }
+    }
+}
+
+}  // namespace
+
+void
+BinaryDistancesAVX512(BinaryMetric metric,
+                      const uint8_t* queries,
+                      size_t nq,
+                      const uint8_t* rows,
+                      size_t nb,
+                      size_t code_size,
+                      float* dst) {
+    if (metric == BinaryMetric::HAMMING) {
+        BinaryDistancesImpl<BinaryMetric::HAMMING>(
+            queries, nq, rows, nb, code_size, dst);
+    } else {
+        BinaryDistancesImpl<BinaryMetric::JACCARD>(
+            queries, nq, rows, nb, code_size, dst);
+    }
+}
+
+namespace {
+
+template <BitwiseOp op>
+void
+BitwiseWordsImpl(uint64_t* dst, const uint64_t* src, size_t words) {
+    size_t i = 0;
+    for (; i + 8 <= words; i += 8) {
+        auto d = _mm512_loadu_si512(dst + i);
+        auto s = _mm512_loadu_si512(src + i);
+        if constexpr (op == BitwiseOp::AND) {
+            d = _mm512_and_si512(d, s);
+        } else if constexpr (op == BitwiseOp::OR) {
+            d = _mm512_or_si512(d, s);
+        } else {
+            d = _mm512_andnot_si512(s, d);
+        }
+        _mm512_storeu_si512(dst + i, d);
+    }
+    BitwiseWordsRef(op, dst + i, src + i, words - i);
+}
+
+}  // namespace
+
+void
+BitwiseWordsAVX512(BitwiseOp op,
+                   uint64_t* dst,
+                   const uint64_t* src,
+                   size_t words) {
+    switch (op) {
+        case BitwiseOp::AND:
+            return BitwiseWordsImpl<BitwiseOp::AND>(dst, src, words);
+        case BitwiseOp::OR:
+            return BitwiseWordsImpl<BitwiseOp::OR>(dst, src, words);
+        case BitwiseOp::ANDNOT:
+            return BitwiseWordsImpl<BitwiseOp::ANDNOT>(dst, src, words);
+    }
+}
+
+__attribute__((target("avx512vpopcntdq"))) uint64_t
+PopcountWordsAVX512(const uint64_t* src, size_t words) {
+    auto acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= words; i += 8) {
+        auto v = _mm512_loadu_si512(src + i);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+    return _mm512_reduce_add_epi64(acc) + PopcountWordsRef(src + i, words - i);
+}
+
+size_t
+FindNonZeroWordAVX512(const uint64_t* src, size_t begin, size_t words) {
+    for (; begin + 8 <= words; begin += 8) {
+        auto v = _mm512_loadu_si512(src + begin);
+        if (auto mask = _mm512_test_epi64_mask(v, v); mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return FindNonZeroWordRef(src, begin, words);
+}
+
+}  // namespace milvus::simd
@@ -0,0 +1,64 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace milvus::simd {
+
+// All kernels in this module emit their result as packed bits: bit `i` of
+// the result lives in bit `i % 64` of word `i / 64`, which is the block
+// layout of boost::dynamic_bitset<> on 64-bit platforms. The unused high
+// bits of the last word are always zero.
+constexpr size_t BITS_PER_WORD = 64;
+
+inline size_t
+WordCount(size_t num_bits) {
+    return (num_bits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+enum class CompareType {
+    EQ = 1,
+    NE = 2,
+    GT = 3,
+    GE = 4,
+    LT = 5,
+    LE = 6,
+};
+
+// dst = dst op src, word by word; ANDNOT clears the bits set in src
+enum class BitwiseOp {
+    AND = 1,
+    OR = 2,
+    ANDNOT = 3,
+};
+
+enum class BinaryMetric {
+    HAMMING = 1,
+    JACCARD = 2,
+};
+
+enum class SimdType {
+    REF = 0,
+    AVX2 = 1,
+    AVX512 = 2,
+    NEON = 3,
+    AUTO = 4,
+};
+
+}  // namespace milvus::simd
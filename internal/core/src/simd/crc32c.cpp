@@ -0,0 +1,165 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simd/crc32c.h"
+
+#include <array>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace milvus::simd {
+
+namespace {
+
+// reflected
+constexpr uint32_t crc32c_poly = 0x82f63b78;
+
+// table[k][b] is the state after byte b followed by k zero bytes
+using SliceTables = std::array<std::array<uint32_t, 256>, 8>;
+
+SliceTables
+MakeSliceTables() {
+    SliceTables tables{};
+    for (uint32_t b = 0; b < 256; ++b) {
+        auto crc = b;
+        for (int i = 0; i < 8; ++i) {
+            crc = (crc >> 1) ^ (crc32c_poly & (0 - (crc & 1)));
+        }
+        tables[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; ++b) {
+        for (int k = 1; k < 8; ++k) {
+            auto prev = tables[k - 1][b];
+            tables[k][b] = (prev >> 8) ^ tables[0][prev & 0xff];
+        }
+    }
+    return tables;
+}
+
+const SliceTables slice_tables = MakeSliceTables();
+
+using Crc32cFuncPtr = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+Crc32cFuncPtr
+DetectCrc32c() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Crc32cSSE42;
+    }
+#elif defined(__aarch64__)
+#if defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        return Crc32cARM;
+    }
+#else
+    // every other aarch64 target we build for has the CRC extension
+    return Crc32cARM;
+#endif
+#endif
+    return Crc32cRef;
+}
+
+const Crc32cFuncPtr crc32c_kernel = DetectCrc32c();
+
+uint32_t
+Gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    for (; vec != 0; vec >>= 1, ++mat) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+    }
+    return sum;
+}
+
+void
+Gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; ++n) {
+        square[n] = Gf2MatrixTimes(mat, mat[n]);
+    }
+}
+
+}  // namespace
+
+uint32_t
+Crc32cRef(uint32_t state, const uint8_t* data, size_t size) {
+    auto& t = slice_tables;
+    for (; size >= 8; size -= 8, data += 8) {
+        uint32_t lo = state ^ (uint32_t(data[0]) | uint32_t(data[1]) << 8 |
+                               uint32_t(data[2]) << 16 |
+                               uint32_t(data[3]) << 24);
+        state = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+                t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^ t[3][data[4]] ^
+                t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; size > 0; --size, ++data) {
+        state = (state >> 8) ^ t[0][(state ^ *data) & 0xff];
+    }
+    return state;
+}
+
+uint32_t
+Crc32c(uint32_t crc, const void* data, size_t size) {
+    return ~crc32c_kernel(
+        ~crc, static_cast<const uint8_t*>(data), size);
+}
+
+bool
+Crc32cHardware() {
+    return crc32c_kernel != Crc32cRef;
+}
+
+// shifts crc1 over len2 zero bytes by squaring the operator of one zero
+// bit, as zlib does
+uint32_t
+Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t len2) {
+    if (len2 == 0) {
+        return crc1;
+    }
+    uint32_t even[32];
+    uint32_t odd[32];
+    odd[0] = crc32c_poly;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    // two zero bits, then four
+    Gf2MatrixSquare(even, odd);
+    Gf2MatrixSquare(odd, even);
+    // one zero byte first, doubled on every bit of len2
+    do {
+        Gf2MatrixSquare(even, odd);
+        if (len2 & 1) {
+            crc1 = Gf2MatrixTimes(even, crc1);
+        }
+        len2 >>= 1;
+        if (len2 == 0) {
+            break;
+        }
+        Gf2MatrixSquare(odd, even);
+        if (len2 & 1) {
+            crc1 = Gf2MatrixTimes(odd, crc1);
+        }
+        len2 >>= 1;
+    } while (len2 != 0);
+    return crc1 ^ crc2;
+}
+
+}  // namespace milvus::simd
@@ -0,0 +1,51 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace milvus::simd {
+
+// CRC32C (Castagnoli) of `size` bytes at `data`, continuing `crc`, the
+// checksum of the bytes before them, 0 to start. Runs on the SSE4.2 or the
+// ARMv8 CRC instructions if the CPU has them.
+uint32_t
+Crc32c(uint32_t crc, const void* data, size_t size);
+
+// The checksum of two consecutive blocks from the checksum of each, `len2`
+// the size of the second, e.g. to merge the checksums of the ranges of a
+// file computed in parallel.
+uint32_t
+Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t len2);
+
+// Whether Crc32c runs on hardware instructions.
+bool
+Crc32cHardware();
+
+// The kernels, on the bit-inverted state.
+uint32_t
+Crc32cRef(uint32_t state, const uint8_t* data, size_t size);
+#if defined(__x86_64__)
+uint32_t
+Crc32cSSE42(uint32_t state, const uint8_t* data, size_t size);
+#elif defined(__aarch64__)
+uint32_t
+Crc32cARM(uint32_t state, const uint8_t* data, size_t size);
+#endif
+
+}  // namespace milvus::simd
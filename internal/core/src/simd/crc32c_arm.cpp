@@ -0,0 +1,42 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simd/crc32c.h"
+
+#if defined(__aarch64__)
+
+#include <arm_acle.h>
+
+#include <cstring>
+
+namespace milvus::simd {
+
+uint32_t
+Crc32cARM(uint32_t state, const uint8_t* data, size_t size) {
+    for (; size >= 8; size -= 8, data += 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        state = __crc32cd(state, word);
+    }
+    for (; size > 0; --size, ++data) {
+        state = __crc32cb(state, *data);
+    }
+    return state;
+}
+
+}  // namespace milvus::simd
+
+#endif
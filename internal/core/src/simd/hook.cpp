@@ -0,0 +1,384 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simd/hook.h"
+
+#include <initializer_list>
+
+#include "simd/ref.h"
+#if defined(__x86_64__)
+#include "simd/avx2.h"
+#include "simd/avx512.h"
+#elif defined(__aarch64__)
+#include "simd/neon.h"
+#endif
+
+namespace milvus::simd {
+
+namespace {
+
+template <typename T>
+using CompareValFuncPtr =
+    void (*)(CompareType, const T*, size_t, T, uint64_t*);
+
+template <typename T>
+using BetweenValFuncPtr =
+    void (*)(const T*, size_t, T, bool, T, bool, uint64_t*);
+
+template <typename T>
+using CompareColumnFuncPtr =
+    void (*)(CompareType, const T*, const T*, size_t, uint64_t*);
+
+template <typename T>
+struct KernelTable {
+    CompareValFuncPtr<T> compare_val = CompareValRef<T>;
+    BetweenValFuncPtr<T> between_val = BetweenValRef<T>;
+    CompareColumnFuncPtr<T> compare_column = CompareColumnRef<T>;
+};
+
+template <typename T>
+KernelTable<T> kernels{};
+
+SimdType current_type = SimdType::REF;
+
+bool
+IsSupported(SimdType type) {
+    switch (type) {
+        case SimdType::REF:
+            return true;
+#if defined(__x86_64__)
+        case SimdType::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SimdType::AVX512:
+            // avx512.cpp is built with all of these, the compiler may emit
+            // any of them
+            return __builtin_cpu_supports("avx512f") &&
+                   __builtin_cpu_supports("avx512bw") &&
+                   __builtin_cpu_supports("avx512dq") &&
+                   __builtin_cpu_supports("avx512vl");
+#elif defined(__aarch64__)
+        case SimdType::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+void
+Install(SimdType type) {
+    auto& table = kernels<T>;
+    switch (type) {
+#if defined(__x86_64__)
+        case SimdType::AVX2:
+            table.compare_val = CompareValAVX2<T>;
+            table.between_val = BetweenValAVX2<T>;
+            table.compare_column = CompareColumnAVX2<T>;
+            break;
+        case SimdType::AVX512:
+            table.compare_val = CompareValAVX512<T>;
+            table.between_val = BetweenValAVX512<T>;
+            table.compare_column = CompareColumnAVX512<T>;
+            break;
+#elif defined(__aarch64__)
+        case SimdType::NEON:
+            table.compare_val = CompareValNEON<T>;
+            table.between_val = BetweenValNEON<T>;
+            table.compare_column = CompareColumnNEON<T>;
+            break;
+#endif
+        default:
+            table.compare_val = CompareValRef<T>;
+            table.between_val = BetweenValRef<T>;
+            table.compare_column = CompareColumnRef<T>;
+            break;
+    }
+}
+
+using BinaryDistancesFuncPtr = void (*)(BinaryMetric,
+                                        const uint8_t*,
+                                        size_t,
+                                        const uint8_t*,
+                                        size_t,
+                                        size_t,
+                                        float*);
+
+BinaryDistancesFuncPtr binary_distances = BinaryDistancesRef;
+
+void
+InstallBinary(SimdType type) {
+    switch (type) {
+#if defined(__x86_64__)
+        case SimdType::AVX2:
+            binary_distances = BinaryDistancesAVX2;
+            break;
+        case SimdType::AVX512:
+            // the popcount of whole registers is an extension of its own
+            binary_distances = __builtin_cpu_supports("avx512vpopcntdq")
+                                   ? BinaryDistancesAVX512
+                                   : BinaryDistancesAVX2;
+            break;
+#elif defined(__aarch64__)
+        case SimdType::NEON:
+            binary_distances = BinaryDistancesNEON;
+            break;
+#endif
+        default:
+            binary_distances = BinaryDistancesRef;
+            break;
+    }
+}
+
+struct WordKernels {
+    void (*bitwise)(BitwiseOp, uint64_t*, const uint64_t*, size_t) =
+        BitwiseWordsRef;
+    uint64_t (*popcount)(const uint64_t*, size_t) = PopcountWordsRef;
+    size_t (*find_non_zero)(const uint64_t*, size_t, size_t) =
+        FindNonZeroWordRef;
+};
+
+WordKernels word_kernels{};
+
+void
+InstallWords(SimdType type) {
+    auto& table = word_kernels;
+    switch (type) {
+#if defined(__x86_64__)
+        case SimdType::AVX2:
+            table.bitwise = BitwiseWordsAVX2;
+            table.popcount = PopcountWordsAVX2;
+            table.find_non_zero = FindNonZeroWordAVX2;
+            break;
+        case SimdType::AVX512:
+            table.bitwise = BitwiseWordsAVX512;
+            table.popcount = __builtin_cpu_supports("avx512vpopcntdq")
+                                 ? PopcountWordsAVX512
+                                 : PopcountWordsAVX2;
+            table.find_non_zero = FindNonZeroWordAVX512;
+            break;
+#elif defined(__aarch64__)
+        case SimdType::NEON:
+            table.bitwise = BitwiseWordsNEON;
+            table.popcount = PopcountWordsNEON;
+            table.find_non_zero = FindNonZeroWordNEON;
+            break;
+#endif
+        default:
+            table.bitwise = BitwiseWordsRef;
+            table.popcount = PopcountWordsRef;
+            table.find_non_zero = FindNonZeroWordRef;
+            break;
+    }
+}
+
+struct StringKernels {
+    void (*compare)(CompareType,
+                    const std::string_view*,
+                    size_t,
+                    std::string_view,
+                    uint64_t*) = CompareStringsRef;
+    void (*prefix_match)(const std::string_view*,
+                         size_t,
+                         std::string_view,
+                         uint64_t*) = PrefixMatchStringsRef;
+};
+
+StringKernels string_kernels{};
+
+void
+InstallStrings(SimdType type) {
+    auto& table = string_kernels;
+    switch (type) {
+#if defined(__x86_64__)
+        // the strings are compared 16 bytes at a time, wider registers
+        // wouldn't help the short ones
+        case SimdType::AVX2:
+        case SimdType::AVX512:
+            table.compare = CompareStringsAVX2;
+            table.prefix_match = PrefixMatchStringsAVX2;
+            break;
+#endif
+        default:
+            table.compare = CompareStringsRef;
+            table.prefix_match = PrefixMatchStringsRef;
+            break;
+    }
+}
+
+const bool kernels_initialized = [] {
+    SetSimdType(SimdType::AUTO);
+    return true;
+}();
+
+}  // namespace
+
+#define DEFINE_SIMD_HOOKS(T)                                          \
+    void CompareVal(CompareType op,                                   \
+                    const T* src,                                     \
+                    size_t size,                                      \
+                    T val,                                            \
+                    uint64_t* dst) {                                  \
+        kernels<T>.compare_val(op, src, size, val, dst);              \
+    }                                                                 \
+    void BetweenVal(const T* src,                                     \
+                    size_t size,                                      \
+                    T lower,                                          \
+                    bool lower_inclusive,                             \
+                    T upper,                                          \
+                    bool upper_inclusive,                             \
+                    uint64_t* dst) {                                  \
+        kernels<T>.between_val(                                       \
+            src, size, lower, lower_inclusive, upper, upper_inclusive, \
+            dst);                                                     \
+    }                                                                 \
+    void CompareColumn(CompareType op,                                \
+                       const T* left,                                 \
+                       const T* right,                                \
+                       size_t size,                                   \
+                       uint64_t* dst) {                               \
+        kernels<T>.compare_column(op, left, right, size, dst);        \
+    }
+
+DEFINE_SIMD_HOOKS(int8_t)
+DEFINE_SIMD_HOOKS(int16_t)
+DEFINE_SIMD_HOOKS(int32_t)
+DEFINE_SIMD_HOOKS(int64_t)
+DEFINE_SIMD_HOOKS(uint64_t)
+DEFINE_SIMD_HOOKS(float)
+DEFINE_SIMD_HOOKS(double)
+
+#undef DEFINE_SIMD_HOOKS
+
+void
+PackBool(const bool* src, size_t size, uint64_t* dst) {
+    static_assert(sizeof(bool) == sizeof(int8_t));
+    kernels<int8_t>.compare_val(CompareType::NE,
+                                reinterpret_cast<const int8_t*>(src),
+                                size,
+                                0,
+                                dst);
+}
+
+void
+CompareStrings(CompareType op,
+               const std::string_view* src,
+               size_t size,
+               std::string_view val,
+               uint64_t* dst) {
+    string_kernels.compare(op, src, size, val, dst);
+}
+
+void
+PrefixMatchStrings(const std::string_view* src,
+                   size_t size,
+                   std::string_view prefix,
+                   uint64_t* dst) {
+    string_kernels.prefix_match(src, size, prefix, dst);
+}
+
+void
+BinaryDistances(BinaryMetric metric,
+                const uint8_t* queries,
+                size_t nq,
+                const uint8_t* rows,
+                size_t nb,
+                size_t code_size,
+                float* dst) {
+    binary_distances(metric, queries, nq, rows, nb, code_size, dst);
+}
+
+void
+BitwiseWords(BitwiseOp op, uint64_t* dst, const uint64_t* src, size_t words) {
+    word_kernels.bitwise(op, dst, src, words);
+}
+
+uint64_t
+PopcountWords(const uint64_t* src, size_t words) {
+    return word_kernels.popcount(src, words);
+}
+
+size_t
+FindNextBit(const uint64_t* src, size_t num_bits, size_t pos) {
+    if (pos >= num_bits) {
+        return num_bits;
+    }
+    auto words = WordCount(num_bits);
+    auto word = pos / BITS_PER_WORD;
+    auto first = src[word] & (~uint64_t(0) << (pos % BITS_PER_WORD));
+    if (first == 0) {
+        word = word_kernels.find_non_zero(src, word + 1, words);
+        if (word == words) {
+            return num_bits;
+        }
+        first = src[word];
+    }
+    auto bit = word * BITS_PER_WORD + __builtin_ctzll(first);
+    return bit < num_bits ? bit : num_bits;
+}
+
+SimdType
+DetectSimdType() {
+    for (auto type : {SimdType::AVX512, SimdType::AVX2, SimdType::NEON}) {
+        if (IsSupported(type)) {
+            return type;
+        }
+    }
+    return SimdType::REF;
+}
+
+SimdType
+SetSimdType(SimdType type) {
+    if (type == SimdType::AUTO || !IsSupported(type)) {
+        type = DetectSimdType();
+    }
+    Install<int8_t>(type);
+    Install<int16_t>(type);
+    Install<int32_t>(type);
+    Install<int64_t>(type);
+    Install<uint64_t>(type);
+    Install<float>(type);
+    Install<double>(type);
+    InstallBinary(type);
+    InstallWords(type);
+    InstallStrings(type);
+    current_type = type;
+    return type;
+}
+
+SimdType
+GetSimdType() {
+    return current_type;
+}
+
+const char*
+SimdTypeName(SimdType type) {
+    switch (type) {
+        case SimdType::REF:
+            return "REF";
+        case SimdType::AVX2:
+            return "AVX2";
+        case SimdType::AVX512:
+            return "AVX512";
+        case SimdType::NEON:
+            return "NEON";
+        case SimdType::AUTO:
+            return "AUTO";
+    }
+    return "UNKNOWN";
+}
+
+}  // namespace milvus::simd
@@ -0,0 +1,231 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "simd/common.h"
+
+namespace milvus::simd {
+
+// Evaluate `src[i] op val` for `size` elements, write WordCount(size) words
+// of packed bits to `dst`.
+void
+CompareVal(
+    CompareType op, const int8_t* src, size_t size, int8_t val, uint64_t* dst);
+void
+CompareVal(CompareType op,
+           const int16_t* src,
+           size_t size,
+           int16_t val,
+           uint64_t* dst);
+void
+CompareVal(CompareType op,
+           const int32_t* src,
+           size_t size,
+           int32_t val,
+           uint64_t* dst);
+void
+CompareVal(CompareType op,
+           const int64_t* src,
+           size_t size,
+           int64_t val,
+           uint64_t* dst);
+void
+CompareVal(CompareType op,
+           const uint64_t* src,
+           size_t size,
+           uint64_t val,
+           uint64_t* dst);
+void
+CompareVal(
+    CompareType op, const float* src, size_t size, float val, uint64_t* dst);
+void
+CompareVal(
+    CompareType op, const double* src, size_t size, double val, uint64_t* dst);
+
+// Evaluate `lower <(=) src[i] <(=) upper` for `size` elements, write
+// WordCount(size) words of packed bits to `dst`.
+void
+BetweenVal(const int8_t* src,
+           size_t size,
+           int8_t lower,
+           bool lower_inclusive,
+           int8_t upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+void
+BetweenVal(const int16_t* src,
+           size_t size,
+           int16_t lower,
+           bool lower_inclusive,
+           int16_t upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+void
+BetweenVal(const int32_t* src,
+           size_t size,
+           int32_t lower,
+           bool lower_inclusive,
+           int32_t upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+void
+BetweenVal(const int64_t* src,
+           size_t size,
+           int64_t lower,
+           bool lower_inclusive,
+           int64_t upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+void
+BetweenVal(const uint64_t* src,
+           size_t size,
+           uint64_t lower,
+           bool lower_inclusive,
+           uint64_t upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+void
+BetweenVal(const float* src,
+           size_t size,
+           float lower,
+           bool lower_inclusive,
+           float upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+void
+BetweenVal(const double* src,
+           size_t size,
+           double lower,
+           bool lower_inclusive,
+           double upper,
+           bool upper_inclusive,
+           uint64_t* dst);
+
+// Evaluate `left[i] op right[i]` for `size` elements, write WordCount(size)
+// words of packed bits to `dst`. Columns of different types are expected to
+// be widened to a common type by the caller.
+void
+CompareColumn(CompareType op,
+              const int8_t* left,
+              const int8_t* right,
+              size_t size,
+              uint64_t* dst);
+void
+CompareColumn(CompareType op,
+              const int16_t* left,
+              const int16_t* right,
+              size_t size,
+              uint64_t* dst);
+void
+CompareColumn(CompareType op,
+              const int32_t* left,
+              const int32_t* right,
+              size_t size,
+              uint64_t* dst);
+void
+CompareColumn(CompareType op,
+              const int64_t* left,
+              const int64_t* right,
+              size_t size,
+              uint64_t* dst);
+void
+CompareColumn(CompareType op,
+              const uint64_t* left,
+              const uint64_t* right,
+              size_t size,
+              uint64_t* dst);
+void
+CompareColumn(CompareType op,
+              const float* left,
+              const float* right,
+              size_t size,
+              uint64_t* dst);
+void
+CompareColumn(CompareType op,
+              const double* left,
+              const double* right,
+              size_t size,
+              uint64_t* dst);
+
+// Evaluate `src[i] op val` for `size` strings, e.g. the views of a VARCHAR
+// column, write WordCount(size) words of packed bits to `dst`. The bytes
+// compare as unsigned, the same as std::string_view.
+void
+CompareStrings(CompareType op,
+               const std::string_view* src,
+               size_t size,
+               std::string_view val,
+               uint64_t* dst);
+
+// Same as CompareStrings, whether `src[i]` starts with `prefix`.
+void
+PrefixMatchStrings(const std::string_view* src,
+                   size_t size,
+                   std::string_view prefix,
+                   uint64_t* dst);
+
+// Pack a bool array, e.g. the output of a scalar index, into words.
+void
+PackBool(const bool* src, size_t size, uint64_t* dst);
+
+// Write the distance of each of the `nq` queries to each of the `nb` rows,
+// all codes of `code_size` bytes, to dst[q * nb + r]. HAMMING counts the
+// differing bits, JACCARD is 1 - |q & r| / |q | r|, 0 if both are empty.
+void
+BinaryDistances(BinaryMetric metric,
+                const uint8_t* queries,
+                size_t nq,
+                const uint8_t* rows,
+                size_t nb,
+                size_t code_size,
+                float* dst);
+
+// dst[i] = dst[i] op src[i] for `words` words, e.g. the blocks of two
+// bitsets of the same size.
+void
+BitwiseWords(BitwiseOp op, uint64_t* dst, const uint64_t* src, size_t words);
+
+// The bits set in `words` words.
+uint64_t
+PopcountWords(const uint64_t* src, size_t words);
+
+// The first bit set at or after `pos` among the first `num_bits` bits of
+// `src`, `num_bits` if there is none.
+size_t
+FindNextBit(const uint64_t* src, size_t num_bits, size_t pos);
+
+// The best kernel set the running CPU supports.
+SimdType
+DetectSimdType();
+
+// Install the kernels of `type`, AUTO or a type the CPU does not support
+// falls back to DetectSimdType(). Returns the type actually installed.
+// Not thread safe, expected to be called once during initialization.
+SimdType
+SetSimdType(SimdType type);
+
+SimdType
+GetSimdType();
+
+const char*
+SimdTypeName(SimdType type);
+
+}  // namespace milvus::simd
@@ -0,0 +1,438 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simd/neon.h"
+
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#include "simd/ref.h"
+
+namespace milvus::simd {
+
+namespace {
+
+// Collapse a lane mask into one bit per lane, NEON has no movemask.
+inline uint64_t
+Movemask(uint8x16_t m) {
+    static const uint8_t weights[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    auto bits = vandq_u8(m, vld1q_u8(weights));
+    return uint64_t(vaddv_u8(vget_low_u8(bits))) |
+           (uint64_t(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+
+inline uint64_t
+Movemask(uint16x8_t m) {
+    static const uint16_t weights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    return vaddvq_u16(vandq_u16(m, vld1q_u16(weights)));
+}
+
+inline uint64_t
+Movemask(uint32x4_t m) {
+    static const uint32_t weights[4] = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(m, vld1q_u32(weights)));
+}
+
+inline uint64_t
+Movemask(uint64x2_t m) {
+    static const uint64_t weights[2] = {1, 2};
+    return vaddvq_u64(vandq_u64(m, vld1q_u64(weights)));
+}
+
+inline uint8x16_t
+Not(uint8x16_t m) {
+    return vmvnq_u8(m);
+}
+
+inline uint16x8_t
+Not(uint16x8_t m) {
+    return vmvnq_u16(m);
+}
+
+inline uint32x4_t
+Not(uint32x4_t m) {
+    return vmvnq_u32(m);
+}
+
+inline uint64x2_t
+Not(uint64x2_t m) {
+    return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(m)));
+}
+
+template <typename T>
+struct NeonTraits;
+
+#define DEFINE_NEON_TRAITS(T, VEC, LANES, SUFFIX)             \
+    template <>                                               \
+    struct NeonTraits<T> {                                    \
+        using V = VEC;                                        \
+        static constexpr size_t kLanes = LANES;               \
+                                                              \
+        static V                                              \
+        set1(T v) {                                           \
+            return vdupq_n_##SUFFIX(v);                       \
+        }                                                     \
+                                                              \
+        static V                                              \
+        load(const T* p) {                                    \
+            return vld1q_##SUFFIX(p);                         \
+        }                                                     \
+                                                              \
+        template <CompareType op>                             \
+        static uint64_t                                       \
+        cmp(V x, V v) {                                       \
+            if constexpr (op == CompareType::EQ) {            \
+                return Movemask(vceqq_##SUFFIX(x, v));        \
+            } else if constexpr (op == CompareType::NE) {     \
+                return Movemask(Not(vceqq_##SUFFIX(x, v)));   \
+            } else if constexpr (op == CompareType::GT) {     \
+                return Movemask(vcgtq_##SUFFIX(x, v));        \
+            } else if constexpr (op == CompareType::GE) {     \
+                return Movemask(vcgeq_##SUFFIX(x, v));        \
+            } else if constexpr (op == CompareType::LT) {     \
+                return Movemask(vcltq_##SUFFIX(x, v));        \
+            } else {                                          \
+                return Movemask(vcleq_##SUFFIX(x, v));        \
+            }                                                 \
+        }                                                     \
+    };
+
+DEFINE_NEON_TRAITS(int8_t, int8x16_t, 16, s8)
+DEFINE_NEON_TRAITS(int16_t, int16x8_t, 8, s16)
+DEFINE_NEON_TRAITS(int32_t, int32x4_t, 4, s32)
+DEFINE_NEON_TRAITS(int64_t, int64x2_t, 2, s64)
+DEFINE_NEON_TRAITS(uint64_t, uint64x2_t, 2, u64)
+DEFINE_NEON_TRAITS(float, float32x4_t, 4, f32)
+DEFINE_NEON_TRAITS(double, float64x2_t, 2, f64)
+
+#undef DEFINE_NEON_TRAITS
+
+template <typename Tr, typename T, typename MaskFunc>
+inline void
+PackWords(const T* src, size_t n_words, uint64_t* dst, MaskFunc mask_func) {
+    for (size_t w = 0; w < n_words; ++w) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < BITS_PER_WORD; j += Tr::kLanes) {
+            word |= mask_func(src + j) << j;
+        }
+        dst[w] = word;
+        src += BITS_PER_WORD;
+    }
+}
+
+template <typename T, CompareType op>
+void
+CompareValImpl(const T* src, size_t size, T val, uint64_t* dst) {
+    using Tr = NeonTraits<T>;
+    auto v = Tr::set1(val);
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(src, n_words, dst, [v](const T* p) {
+        return Tr::template cmp<op>(Tr::load(p), v);
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        CompareValRef(op, src + done, size - done, val, dst + n_words);
+    }
+}
+
+template <typename T, CompareType lower_op, CompareType upper_op>
+void
+BetweenValImpl(const T* src, size_t size, T lower, T upper, uint64_t* dst) {
+    using Tr = NeonTraits<T>;
+    auto lo = Tr::set1(lower);
+    auto hi = Tr::set1(upper);
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(src, n_words, dst, [lo, hi](const T* p) {
+        auto x = Tr::load(p);
+        return Tr::template cmp<lower_op>(x, lo) &
+               Tr::template cmp<upper_op>(x, hi);
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        BetweenValRef(src + done,
+                      size - done,
+                      lower,
+                      lower_op == CompareType::GE,
+                      upper,
+                      upper_op == CompareType::LE,
+                      dst + n_words);
+    }
+}
+
+template <typename T, CompareType op>
+void
+CompareColumnImpl(const T* left, const T* right, size_t size, uint64_t* dst) {
+    using Tr = NeonTraits<T>;
+    auto n_words = size / BITS_PER_WORD;
+    PackWords<Tr>(left, n_words, dst, [left, right](const T* p) {
+        return Tr::template cmp<op>(Tr::load(p), Tr::load(right + (p - left)));
+    });
+    auto done = n_words * BITS_PER_WORD;
+    if (done < size) {
+        CompareColumnRef(
+            op, left + done, right + done, size - done, dst + n_words);
+    }
+}
+
+}  // namespace
+
+template <typename T>
+void
+CompareValNEON(
+    CompareType op, const T* src, size_t size, T val, uint64_t* dst) {
+    switch (op) {
+        case CompareType::EQ:
+            return CompareValImpl<T, CompareType::EQ>(src, size, val, dst);
+        case CompareType::NE:
+            return CompareValImpl<T, CompareType::NE>(src, size, val, dst);
+        case CompareType::GT:
+            return CompareValImpl<T, CompareType::GT>(src, size, val, dst);
+        case CompareType::GE:
+            return CompareValImpl<T, CompareType::GE>(src, size, val, dst);
+        case CompareType::LT:
+            return CompareValImpl<T, CompareType::LT>(src, size, val, dst);
+        case CompareType::LE:
+            return CompareValImpl<T, CompareType::LE>(src, size, val, dst);
+    }
+}
+
+template <typename T>
+void
+BetweenValNEON(const T* src,
+               size_t size,
+               T lower,
+               bool lower_inclusive,
+               T upper,
+               bool upper_inclusive,
+               uint64_t* dst) {
+    using C = CompareType;
+    if (lower_inclusive && upper_inclusive) {
+        BetweenValImpl<T, C::GE, C::LE>(src, size, lower, upper, dst);
+    } else if (lower_inclusive && !upper_inclusive) {
+        BetweenValImpl<T, C::GE, C::LT>(src, size, lower, upper, dst);
+    } else if (!lower_inclusive && upper_inclusive) {
+        BetweenValImpl<T, C::GT, C::LE>(src, size, lower, upper, dst);
+    } else {
+        BetweenValImpl<T, C::GT, C::LT>(src, size, lower, upper, dst);
+    }
+}
+
+template <typename T>
+void
+CompareColumnNEON(CompareType op,
+                  const T* left,
+                  const T* right,
+                  size_t size,
+                  uint64_t* dst) {
+    using C = CompareType;
+    switch (op) {
+        case C::EQ:
+            return CompareColumnImpl<T, C::EQ>(left, right, size, dst);
+        case C::NE:
+            return CompareColumnImpl<T, C::NE>(left, right, size, dst);
+        case C::GT:
+            return CompareColumnImpl<T, C::GT>(left, right, size, dst);
+        case C::GE:
+            return CompareColumnImpl<T, C::GE>(left, right, size, dst);
+        case C::LT:
+            return CompareColumnImpl<T, C::LT>(left, right, size, dst);
+        case C::LE:
+            return CompareColumnImpl<T, C::LE>(left, right, size, dst);
+    }
+}
+
+#define INSTANTIATE_NEON_KERNELS(T)                                       \
+    template void CompareValNEON<T>(                                      \
+        CompareType, const T*, size_t, T, uint64_t*);                     \
+    template void BetweenValNEON<T>(                                      \
+        const T*, size_t, T, bool, T, bool, uint64_t*);                   \
+    template void CompareColumnNEON<T>(                                   \
+        CompareType, const T*, const T*, size_t, uint64_t*);
+
+INSTANTIATE_NEON_KERNELS(int8_t)
+INSTANTIATE_NEON_KERNELS(int16_t)
+INSTANTIATE_NEON_KERNELS(int32_t)
+INSTANTIATE_NEON_KERNELS(int64_t)
+INSTANTIATE_NEON_KERNELS(uint64_t)
+INSTANTIATE_NEON_KERNELS(float)
+INSTANTIATE_NEON_KERNELS(double)
+
+#undef INSTANTIATE_NEON_KERNELS
+
+namespace {
+
+constexpr size_t kBinaryQueryTile = 4;
+
+// the counts of kQueries queries, `code_size` apart, against one row over
+// its first `body` bytes, a whole number of registers; each register of
+// the row is loaded once for all the queries. The byte counts are added
+// pairwise into 16 bit lanes, which can't overflow for the codes of at
+// most 65536 bits this is called with.
+template <BinaryMetric metric, size_t kQueries>
+void
+TileBinaryCounts(const uint8_t* queries,
+                 const uint8_t* row,
+                 size_t code_size,
+                 size_t body,
+                 uint64_t* num,
+                 uint64_t* den) {
+    uint16x8_t num_acc[kQueries], den_acc[kQueries];
+    for (size_t j = 0; j < kQueries; ++j) {
+        num_acc[j] = vdupq_n_u16(0);
+        den_acc[j] = vdupq_n_u16(0);
+    }
+    for (size_t i = 0; i < body; i += 16) {
+        auto x = vld1q_u8(row + i);
+        for (size_t j = 0; j < kQueries; ++j) {
+            auto y = vld1q_u8(queries + j * code_size + i);
+            if constexpr (metric == BinaryMetric::HAMMING) {
+                num_acc[j] = vpadalq_u8(num_acc[j], vcntq_u8(veorq_u8(x, y)));
+            } else {
+                num_acc[j] = vpadalq_u8(num_acc[j], vcntq_u8(vandq_u8(x, y)));
+                den_acc[j] = vpadalq_u8(den_acc[j], vcntq_u8(vorrq_u8(x, y)));
+            }
+        }
+    }
+    for (size_t j = 0; j < kQueries; ++j) {
+        num[j] = vaddlvq_u16(num_acc[j]);
+        den[j] = vaddlvq_u16(den_acc[j]);
+    }
+}
+
+template <BinaryMetric metric>
+void
+BinaryDistancesImpl(const uint8_t* queries,
+                    size_t nq,
+                    const uint8_t* rows,
+                    size_t nb,
+                    size_t code_size,
+                    float* dst) {
+    // longer codes take the reference kernel rather than overflow
+    if (code_size > 8192) {
+        return BinaryDistancesRef<metric>(
+            queries, nq, rows, nb, code_size, dst);
+    }
+    auto body = code_size / 16 * 16;
+    uint64_t num[kBinaryQueryTile], den[kBinaryQueryTile];
+    for (size_t r = 0; r < nb; ++r) {
+        auto row = rows + r * code_size;
+        for (size_t q = 0; q < nq;) {
+            auto tile = nq - q >= kBinaryQueryTile ? kBinaryQueryTile : 1;
+            auto tile_queries = queries + q * code_size;
+            if (tile == kBinaryQueryTile) {
+                TileBinaryCounts<metric, kBinaryQueryTile>(
+                    tile_queries, row, code_size, body, num, den);
+            } else {
+                TileBinaryCounts<metric, 1>(
+                    tile_queries, row, code_size, body, num, den);
+            }
+            for (size_t j = 0; j < tile; ++j) {
+                BinaryCountsRef<metric>(tile_queries + j * code_size + body,
+                                        row + body,
+                                        code_size - body,
+                                        num[j],
+                                        den[j]);
+                dst[(q + j) * nb + r] = BinaryDistance<metric>(num[j], den[j]);
+            }
+            q += tile;
+        }
+    }
+}
+
+}  // namespace
+
+void
+BinaryDistancesNEON(BinaryMetric metric,
+                    const uint8_t* queries,
+                    size_t nq,
+                    const uint8_t* rows,
+                    size_t nb,
+                    size_t code_size,
+                    float* dst) {
+    if (metric == BinaryMetric::HAMMING) {
+        BinaryDistancesImpl<BinaryMetric::HAMMING>(
+            queries, nq, rows, nb, code_size, dst);
+    } else {
+        BinaryDistancesImpl<BinaryMetric::JACCARD>(
+            queries, nq, rows, nb, code_size, dst);
+    }
+}
+
+namespace {
+
+template <BitwiseOp op>
+void
+BitwiseWordsImpl(uint64_t* dst, const uint64_t* src, size_t words) {
+    size_t i = 0;
+    for (; i + 2 <= words; i += 2) {
+        auto d = vld1q_u64(dst + i);
+        auto s = vld1q_u64(src + i);
+        if constexpr (op == BitwiseOp::AND) {
+            d = vandq_u64(d, s);
+        } else if constexpr (op == BitwiseOp::OR) {
+            d = vorrq_u64(d, s);
+        } else {
+            d = vbicq_u64(d, s);
+        }
+        vst1q_u64(dst + i, d);
+    }
+    BitwiseWordsRef(op, dst + i, src + i, words - i);
+}
+
+}  // namespace
+
+void
+BitwiseWordsNEON(BitwiseOp op,
+                 uint64_t* dst,
+                 const uint64_t* src,
+                 size_t words) {
+    switch (op) {
+        case BitwiseOp::AND:
+            return BitwiseWordsImpl<BitwiseOp::AND>(dst, src, words);
+        case BitwiseOp::OR:
+            return BitwiseWordsImpl<BitwiseOp::OR>(dst, src, words);
+        case BitwiseOp::ANDNOT:
+            return BitwiseWordsImpl<BitwiseOp::ANDNOT>(dst, src, words);
+    }
+}
+
+uint64_t
+PopcountWordsNEON(const uint64_t* src, size_t words) {
+    uint64_t count = 0;
+    size_t i = 0;
+    for (; i + 2 <= words; i += 2) {
+        auto bytes = vreinterpretq_u8_u64(vld1q_u64(src + i));
+        count += vaddlvq_u8(vcntq_u8(bytes));
+    }
+    return count + PopcountWordsRef(src + i, words - i);
+}
+
+size_t
+FindNonZeroWordNEON(const uint64_t* src, size_t begin, size_t words) {
+    for (; begin + 2 <= words; begin += 2) {
+        auto v = vreinterpretq_u32_u64(vld1q_u64(src + begin));
+        if (vmaxvq_u32(v) != 0) {
+            return FindNonZeroWordRef(src, begin, begin + 2);
+        }
+    }
+    return FindNonZeroWordRef(src, begin, words);
+}
+
+}  // namespace milvus::simd
+
+#endif
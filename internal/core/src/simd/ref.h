@@ -0,0 +1,307 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "simd/common.h"
+
+namespace milvus::simd {
+
+// Portable reference kernels. They are used on platforms without a
+// dedicated implementation and for the tails that do not fill a whole word.
+template <typename T, typename Pred>
+inline void
+PackBits(const T* src, size_t size, uint64_t* dst, Pred pred) {
+    size_t i = 0;
+    for (; i + BITS_PER_WORD <= size; i += BITS_PER_WORD) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < BITS_PER_WORD; ++j) {
+            word |= uint64_t(pred(src[i + j])) << j;
+        }
+        *dst++ = word;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        for (size_t j = 0; i + j < size; ++j) {
+            word |= uint64_t(pred(src[i + j])) << j;
+        }
+        *dst = word;
+    }
+}
+
+// Same as PackBits, `pred` gets the elements of both columns at a row.
+template <typename T, typename Pred>
+inline void
+PackPairBits(
+    const T* left, const T* right, size_t size, uint64_t* dst, Pred pred) {
+    size_t i = 0;
+    for (; i + BITS_PER_WORD <= size; i += BITS_PER_WORD) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < BITS_PER_WORD; ++j) {
+            word |= uint64_t(pred(left[i + j], right[i + j])) << j;
+        }
+        *dst++ = word;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        for (size_t j = 0; i + j < size; ++j) {
+            word |= uint64_t(pred(left[i + j], right[i + j])) << j;
+        }
+        *dst = word;
+    }
+}
+
+template <typename T>
+inline void
+CompareValRef(
+    CompareType op, const T* src, size_t size, T val, uint64_t* dst) {
+    switch (op) {
+        case CompareType::EQ:
+            return PackBits(src, size, dst, [val](T x) { return x == val; });
+        case CompareType::NE:
+            return PackBits(src, size, dst, [val](T x) { return x != val; });
+        case CompareType::GT:
+            return PackBits(src, size, dst, [val](T x) { return x > val; });
+        case CompareType::GE:
+            return PackBits(src, size, dst, [val](T x) { return x >= val; });
+        case CompareType::LT:
+            return PackBits(src, size, dst, [val](T x) { return x < val; });
+        case CompareType::LE:
+            return PackBits(src, size, dst, [val](T x) { return x <= val; });
+    }
+}
+
+template <typename T>
+inline void
+BetweenValRef(const T* src,
+              size_t size,
+              T lower,
+              bool lower_inclusive,
+              T upper,
+              bool upper_inclusive,
+              uint64_t* dst) {
+    if (lower_inclusive && upper_inclusive) {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower <= x && x <= upper;
+        });
+    } else if (lower_inclusive && !upper_inclusive) {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower <= x && x < upper;
+        });
+    } else if (!lower_inclusive && upper_inclusive) {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower < x && x <= upper;
+        });
+    } else {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower < x && x < upper;
+        });
+    }
+}
+
+template <typename T>
+inline void
+CompareColumnRef(CompareType op,
+                 const T* left,
+                 const T* right,
+                 size_t size,
+                 uint64_t* dst) {
+    switch (op) {
+        case CompareType::EQ:
+            return PackPairBits(
+                left, right, size, dst, [](T x, T y) { return x == y; });
+        case CompareType::NE:
+            return PackPairBits(
+                left, right, size, dst, [](T x, T y) { return x != y; });
+        case CompareType::GT:
+            return PackPairBits(
+                left, right, size, dst, [](T x, T y) { return x > y; });
+        case CompareType::GE:
+            return PackPairBits(
+                left, right, size, dst, [](T x, T y) { return x >= y; });
+        case CompareType::LT:
+            return PackPairBits(
+                left, right, size, dst, [](T x, T y) { return x < y; });
+        case CompareType::LE:
+            return PackPairBits(
+                left, right, size, dst, [](T x, T y) { return x <= y; });
+    }
+}
+
+// Adds the bits set in `a ^ b` to `num` for HAMMING, those set in `a & b`
+// to `num` and in `a | b` to `den` for JACCARD, over `size` bytes.
+template <BinaryMetric metric>
+inline void
+BinaryCountsRef(const uint8_t* a,
+                const uint8_t* b,
+                size_t size,
+                uint64_t& num,
+                uint64_t& den) {
+    auto count = [&](uint64_t x, uint64_t y) {
+        if constexpr (metric == BinaryMetric::HAMMING) {
+            num += __builtin_popcountll(x ^ y);
+        } else {
+            num += __builtin_popcountll(x & y);
+            den += __builtin_popcountll(x | y);
+        }
+    };
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t x, y;
+        memcpy(&x, a + i, sizeof(x));
+        memcpy(&y, b + i, sizeof(y));
+        count(x, y);
+    }
+    for (; i < size; ++i) {
+        count(a[i], b[i]);
+    }
+}
+
+template <BinaryMetric metric>
+inline float
+BinaryDistance(uint64_t num, uint64_t den) {
+    if constexpr (metric == BinaryMetric::HAMMING) {
+        return float(num);
+    } else {
+        return den == 0 ? 0.0f : 1.0f - float(num) / float(den);
+    }
+}
+
+template <BinaryMetric metric>
+inline void
+BinaryDistancesRef(const uint8_t* queries,
+                   size_t nq,
+                   const uint8_t* rows,
+                   size_t nb,
+                   size_t code_size,
+                   float* dst) {
+    for (size_t r = 0; r < nb; ++r) {
+        for (size_t q = 0; q < nq; ++q) {
+            uint64_t num = 0, den = 0;
+            BinaryCountsRef<metric>(queries + q * code_size,
+                                    rows + r * code_size,
+                                    code_size,
+                                    num,
+                                    den);
+            dst[q * nb + r] = BinaryDistance<metric>(num, den);
+        }
+    }
+}
+
+inline void
+BinaryDistancesRef(BinaryMetric metric,
+                   const uint8_t* queries,
+                   size_t nq,
+                   const uint8_t* rows,
+                   size_t nb,
+                   size_t code_size,
+                   float* dst) {
+    if (metric == BinaryMetric::HAMMING) {
+        BinaryDistancesRef<BinaryMetric::HAMMING>(
+            queries, nq, rows, nb, code_size, dst);
+    } else {
+        BinaryDistancesRef<BinaryMetric::JACCARD>(
+            queries, nq, rows, nb, code_size, dst);
+    }
+}
+
+// The word kernels over packed bits, see BitwiseWords and PopcountWords.
+inline void
+BitwiseWordsRef(BitwiseOp op,
+                uint64_t* dst,
+                const uint64_t* src,
+                size_t words) {
+    switch (op) {
+        case BitwiseOp::AND:
+            for (size_t i = 0; i < words; ++i) {
+                dst[i] &= src[i];
+            }
+            break;
+        case BitwiseOp::OR:
+            for (size_t i = 0; i < words; ++i) {
+                dst[i] |= src[i];
+            }
+            break;
+        case BitwiseOp::ANDNOT:
+            for (size_t i = 0; i < words; ++i) {
+                dst[i] &= ~src[i];
+            }
+            break;
+    }
+}
+
+inline uint64_t
+PopcountWordsRef(const uint64_t* src, size_t words) {
+    uint64_t count = 0;
+    for (size_t i = 0; i < words; ++i) {
+        count += __builtin_popcountll(src[i]);
+    }
+    return count;
+}
+
+// index of the first word in [begin, words) which is not zero, `words` if
+// there is none
+inline size_t
+FindNonZeroWordRef(const uint64_t* src, size_t begin, size_t words) {
+    for (; begin < words; ++begin) {
+        if (src[begin] != 0) {
+            return begin;
+        }
+    }
+    return words;
+}
+
+// The string kernels, see CompareStrings and PrefixMatchStrings. The bytes
+// compare as unsigned, the same as std::string_view.
+inline void
+CompareStringsRef(CompareType op,
+                  const std::string_view* src,
+                  size_t size,
+                  std::string_view val,
+                  uint64_t* dst) {
+    using View = std::string_view;
+    switch (op) {
+        case CompareType::EQ:
+            return PackBits(src, size, dst, [val](View x) { return x == val; });
+        case CompareType::NE:
+            return PackBits(src, size, dst, [val](View x) { return x != val; });
+        case CompareType::GT:
+            return PackBits(src, size, dst, [val](View x) { return x > val; });
+        case CompareType::GE:
+            return PackBits(src, size, dst, [val](View x) { return x >= val; });
+        case CompareType::LT:
+            return PackBits(src, size, dst, [val](View x) { return x < val; });
+        case CompareType::LE:
+            return PackBits(src, size, dst, [val](View x) { return x <= val; });
+    }
+}
+
+inline void
+PrefixMatchStringsRef(const std::string_view* src,
+                      size_t size,
+                      std::string_view prefix,
+                      uint64_t* dst) {
+    PackBits(src, size, dst, [prefix](std::string_view x) {
+        return x.substr(0, prefix.size()) == prefix;
+    });
+}
+
+}  // namespace milvus::simd
@@ -0,0 +1,102 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "storage/BinlogStreamReader.h"
+
+#include <cstring>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::storage {
+
+BinlogStreamReader::BinlogStreamReader(
+    std::shared_ptr<arrow::io::InputStream> input)
+    : input_(std::move(input)) {
+    EventHeader header;
+    header_size_ = GetEventHeaderSize(header);
+
+    auto magic = ReadExactly(sizeof(MAGIC_NUM), "magic number");
+    int32_t magic_num;
+    memcpy(&magic_num, magic->data(), sizeof(magic_num));
+    AssertInfo(magic_num == MAGIC_NUM, "binlog stream is not a remote binlog");
+
+    auto descriptor_header = ReadHeader();
+    AssertInfo(descriptor_header.has_value() &&
+                   descriptor_header->event_type_ == EventType::DescriptorEvent,
+               "binlog stream has no descriptor event");
+    auto data = ReadExactly(descriptor_header->event_length_ - header_size_,
+                            "descriptor event");
+    auto reader = std::make_shared<BinlogReader>(data->data(), data->size());
+    descriptor_event_.event_header = *descriptor_header;
+    descriptor_event_.event_data = DescriptorEventData(reader);
+}
+
+std::shared_ptr<arrow::Buffer>
+BinlogStreamReader::ReadExactly(int64_t nbytes, const std::string& what) {
+    AssertInfo(nbytes >= 0, "negative length of binlog " + what);
+    auto res = input_->Read(nbytes);
+    AssertInfo(res.ok(), "read binlog " + what + " failed");
+    auto buffer = res.ValueOrDie();
+    AssertInfo(buffer->size() == nbytes, "binlog " + what + " is truncated");
+    return buffer;
+}
+
+std::optional<EventHeader>
+BinlogStreamReader::ReadHeader() {
+    auto res = input_->Read(header_size_);
+    AssertInfo(res.ok(), "read binlog event header failed");
+    auto buffer = res.ValueOrDie();
+    if (buffer->size() == 0) {
+        return std::nullopt;
+    }
+    AssertInfo(buffer->size() == header_size_,
+               "binlog event header is truncated");
+    auto reader =
+        std::make_shared<BinlogReader>(buffer->data(), buffer->size());
+    return EventHeader(reader);
+}
+
+std::optional<BinlogEvent>
+BinlogStreamReader::Next(bool skip_payload) {
+    auto header = ReadHeader();
+    if (!header.has_value()) {
+        return std::nullopt;
+    }
+    AssertInfo(header->event_type_ != EventType::DescriptorEvent,
+               "binlog stream has more than one descriptor event");
+
+    BinlogEvent event;
+    event.header = *header;
+    int64_t fix_part_size = GetEventFixPartSize(header->event_type_);
+    auto data_length = int64_t(header->event_length_) - header_size_;
+    AssertInfo(data_length >= fix_part_size, "binlog event is too short");
+    auto fix_part = ReadExactly(fix_part_size, "event data");
+    memcpy(&event.start_timestamp, fix_part->data(), sizeof(Timestamp));
+    memcpy(&event.end_timestamp,
+           fix_part->data() + sizeof(Timestamp),
+           sizeof(Timestamp));
+
+    auto payload_length = data_length - fix_part_size;
+    if (skip_payload) {
+        auto st = input_->Advance(payload_length);
+        AssertInfo(st.ok(), "skip binlog payload failed");
+    } else {
+        event.payload = ReadExactly(payload_length, "payload");
+    }
+    return event;
+}
+
+}  // namespace milvus::storage
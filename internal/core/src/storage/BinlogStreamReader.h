@@ -0,0 +1,75 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <memory>
+#include <optional>
+
+#include "storage/Event.h"
+
+namespace milvus::storage {
+
+// a data event of a binlog, `payload` is the parquet payload of the event
+struct BinlogEvent {
+    EventHeader header;
+    Timestamp start_timestamp;
+    Timestamp end_timestamp;
+    std::shared_ptr<arrow::Buffer> payload;
+};
+
+/**
+ * @brief BinlogStreamReader parses a remote binlog from a byte stream one
+ * event at a time, only the event being returned is held in memory.
+ * Payloads are read from the stream as arrow buffers, for in memory
+ * streams such as arrow::io::BufferReader they are slices of the stream
+ * memory instead of copies.
+ */
+class BinlogStreamReader {
+ public:
+    explicit BinlogStreamReader(std::shared_ptr<arrow::io::InputStream> input);
+
+    const DescriptorEvent&
+    GetDescriptorEvent() const {
+        return descriptor_event_;
+    }
+
+    DataType
+    GetDataType() const {
+        return DataType(descriptor_event_.event_data.fix_part.data_type);
+    }
+
+    // the next data event, none at the end of the stream; a skipped
+    // payload is passed over without being read into memory
+    std::optional<BinlogEvent>
+    Next(bool skip_payload = false);
+
+ private:
+    std::shared_ptr<arrow::Buffer>
+    ReadExactly(int64_t nbytes, const std::string& what);
+
+    std::optional<EventHeader>
+    ReadHeader();
+
+ private:
+    std::shared_ptr<arrow::io::InputStream> input_;
+    int64_t header_size_;
+    DescriptorEvent descriptor_event_;
+};
+
+}  // namespace milvus::storage
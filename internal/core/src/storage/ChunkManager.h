@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -121,12 +123,43 @@ class ChunkManager {
 
 class RemoteChunkManager : public ChunkManager {
  public:
+    using RangeCallback = std::function<void(uint64_t offset, uint64_t len)>;
+
     virtual ~RemoteChunkManager() {
     }
     virtual std::string
     GetName() const {
         return "RemoteChunkManager";
     }
+
+    /**
+     * @brief Read file to buffer by byte ranges, implementations may fetch
+     * up to max_inflight ranges concurrently
+     * @param filepath
+     * @param buf
+     * @param len
+     * @param range_size
+     * @param max_inflight
+     * @param on_range called with every completed range, possibly from
+     * another thread and out of order
+     * @return uint64_t
+     */
+    virtual uint64_t
+    ReadRanges(const std::string& filepath,
+               void* buf,
+               uint64_t len,
+               uint64_t range_size,
+               int64_t max_inflight,
+               const RangeCallback& on_range = nullptr) {
+        for (uint64_t offset = 0; offset < len; offset += range_size) {
+            auto size = std::min(range_size, len - offset);
+            Read(filepath, offset, static_cast<char*>(buf) + offset, size);
+            if (on_range) {
+                on_range(offset, size);
+            }
+        }
+        return len;
+    }
 };
 
 using RemoteChunkManagerPtr = std::unique_ptr<RemoteChunkManager>;
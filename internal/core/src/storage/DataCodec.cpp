@@ -20,43 +20,102 @@
 #include "storage/InsertData.h"
 #include "storage/IndexData.h"
 #include "storage/BinlogReader.h"
+#include "storage/BinlogStreamReader.h"
+#include "storage/PayloadReader.h"
+#include "storage/PayloadStream.h"
 #include "exceptions/EasyAssert.h"
 #include "common/Consts.h"
+#include "simd/crc32c.h"
+
+#include <algorithm>
+#include <tuple>
 
 namespace milvus::storage {
 
-// deserialize remote insert and index file
+namespace {
+
+// binlogs written before the checksum was added, or by a writer which
+// doesn't add it, aren't verified
+void
+VerifyPayloadChecksum(const DescriptorEvent& descriptor_event,
+                      const arrow::Buffer& payload,
+                      std::optional<uint32_t> payload_checksum) {
+    auto& extras = descriptor_event.event_data.extras;
+    auto it = extras.find(PAYLOAD_CHECKSUM_KEY);
+    if (it == extras.end()) {
+        return;
+    }
+    auto expected = static_cast<uint32_t>(std::stoul(it->second));
+    auto actual = payload_checksum.has_value()
+                      ? *payload_checksum
+                      : simd::Crc32c(0, payload.data(), payload.size());
+    AssertInfo(actual == expected,
+               "binlog payload checksum mismatch, expected " +
+                   std::to_string(expected) + ", got " +
+                   std::to_string(actual));
+}
+
+// the crc32c of the payload of the remote binlog in `data` from the one of
+// the whole file, by taking the header off; nullopt unless the payload of
+// the first data event runs to the end of the file
+std::optional<uint32_t>
+PayloadChecksumOfFile(const std::shared_ptr<uint8_t[]>& data,
+                      int64_t length,
+                      uint32_t file_checksum) {
+    EventHeader header;
+    int64_t header_size = GetEventHeaderSize(header);
+    int64_t data_fix_part_size = GetEventFixPartSize(EventType::InsertEvent);
+    if (length < int64_t(sizeof(MAGIC_NUM)) + header_size) {
+        return std::nullopt;
+    }
+    auto reader = std::make_shared<BinlogReader>(data, length);
+    ReadMediumType(reader);
+    EventHeader descriptor_header(reader);
+    int64_t data_offset = sizeof(MAGIC_NUM) + descriptor_header.event_length_;
+    if (descriptor_header.event_length_ < header_size ||
+        data_offset + header_size > length) {
+        return std::nullopt;
+    }
+    // aliases `data`, nothing is copied
+    auto data_reader = std::make_shared<BinlogReader>(
+        std::shared_ptr<uint8_t[]>(data, data.get() + data_offset),
+        length - data_offset);
+    EventHeader data_header(data_reader);
+    int64_t payload_offset = data_offset + header_size + data_fix_part_size;
+    if (data_offset + data_header.event_length_ != length ||
+        payload_offset > length) {
+        return std::nullopt;
+    }
+    auto head_checksum = simd::Crc32c(0, data.get(), payload_offset);
+    return simd::Crc32cCombine(
+        head_checksum, file_checksum, length - payload_offset);
+}
+
+}  // namespace
+
 std::unique_ptr<DataCodec>
-DeserializeRemoteFileData(BinlogReaderPtr reader) {
-    DescriptorEvent descriptor_event(reader);
-    DataType data_type =
-        DataType(descriptor_event.event_data.fix_part.data_type);
+MakeDataCodec(DescriptorEvent& descriptor_event,
+              EventType event_type,
+              const BaseEventData& event_data) {
     auto descriptor_fix_part = descriptor_event.event_data.fix_part;
     FieldDataMeta data_meta{descriptor_fix_part.collection_id,
                             descriptor_fix_part.partition_id,
                             descriptor_fix_part.segment_id,
                             descriptor_fix_part.field_id};
-    EventHeader header(reader);
-    switch (header.event_type_) {
-        case EventType::InsertEvent: {
-            auto event_data_length =
-                header.event_length_ - header.next_position_;
-            auto insert_event_data =
-                InsertEventData(reader, event_data_length, data_type);
+    switch (event_type) {
+        // a delta log is read as the insert data of its string payload
+        case EventType::InsertEvent:
+        case EventType::DeleteEvent: {
             auto insert_data =
-                std::make_unique<InsertData>(insert_event_data.field_data);
+                std::make_unique<InsertData>(event_data.field_data);
             insert_data->SetFieldDataMeta(data_meta);
-            insert_data->SetTimestamps(insert_event_data.start_timestamp,
-                                       insert_event_data.end_timestamp);
+            insert_data->SetTimestamps(event_data.start_timestamp,
+                                       event_data.end_timestamp);
             return insert_data;
         }
         case EventType::IndexFileEvent: {
-            auto event_data_length =
-                header.event_length_ - header.next_position_;
-            auto index_event_data =
-                IndexEventData(reader, event_data_length, data_type);
             auto index_data =
-                std::make_unique<IndexData>(index_event_data.field_data);
+                std::make_unique<IndexData>(event_data.field_data);
             index_data->SetFieldDataMeta(data_meta);
             IndexMeta index_meta;
             index_meta.segment_id = data_meta.segment_id;
@@ -66,8 +125,8 @@ DeserializeRemoteFileData(BinlogReaderPtr reader) {
                        "index build id not exist");
             index_meta.build_id = std::stol(extras[INDEX_BUILD_ID_KEY]);
             index_data->set_index_meta(index_meta);
-            index_data->SetTimestamps(index_event_data.start_timestamp,
-                                      index_event_data.end_timestamp);
+            index_data->SetTimestamps(event_data.start_timestamp,
+                                      event_data.end_timestamp);
             return index_data;
         }
         default:
@@ -75,6 +134,125 @@ DeserializeRemoteFileData(BinlogReaderPtr reader) {
     }
 }
 
+// deserialize remote insert, delta and index file
+std::unique_ptr<DataCodec>
+DeserializeRemoteFileData(BinlogReaderPtr reader) {
+    DescriptorEvent descriptor_event(reader);
+    DataType data_type =
+        DataType(descriptor_event.event_data.fix_part.data_type);
+    EventHeader header(reader);
+    switch (header.event_type_) {
+        case EventType::InsertEvent:
+        case EventType::DeleteEvent:
+        case EventType::IndexFileEvent: {
+            auto event_data_length =
+                header.event_length_ - header.next_position_;
+            auto event_data =
+                BaseEventData(reader, event_data_length, data_type);
+            return MakeDataCodec(
+                descriptor_event, header.event_type_, event_data);
+        }
+        default:
+            PanicInfo("unsupported event type");
+    }
+}
+
+std::unique_ptr<DataCodec>
+DeserializeRemoteFileData(std::shared_ptr<arrow::io::InputStream> input,
+                          std::optional<uint32_t> payload_checksum) {
+    BinlogStreamReader stream(input);
+    auto event = stream.Next();
+    AssertInfo(event.has_value(), "binlog has no data event");
+    switch (event->header.event_type_) {
+        case EventType::InsertEvent:
+        case EventType::DeleteEvent:
+        case EventType::IndexFileEvent: {
+            auto descriptor_event = stream.GetDescriptorEvent();
+            VerifyPayloadChecksum(
+                descriptor_event, *event->payload, payload_checksum);
+            BaseEventData event_data;
+            event_data.start_timestamp = event->start_timestamp;
+            event_data.end_timestamp = event->end_timestamp;
+            PayloadReader payload_reader(
+                std::make_shared<arrow::io::BufferReader>(event->payload),
+                stream.GetDataType());
+            event_data.field_data = payload_reader.get_field_data();
+            return MakeDataCodec(
+                descriptor_event, event->header.event_type_, event_data);
+        }
+        default:
+            PanicInfo("unsupported event type");
+    }
+}
+
+std::unique_ptr<DataCodec>
+DeserializeRemoteFileData(RemoteChunkManager* chunk_manager,
+                          const std::string& filepath,
+                          const std::vector<int>& row_groups) {
+    auto file_size = int64_t(chunk_manager->Size(filepath));
+    auto read_head = [&](int64_t length) {
+        length = std::min(length, file_size);
+        auto data = std::shared_ptr<uint8_t[]>(new uint8_t[length]);
+        chunk_manager->Read(filepath, 0, data.get(), length);
+        return std::make_pair(data, length);
+    };
+
+    EventHeader header;
+    int64_t header_size = GetEventHeaderSize(header);
+    int64_t data_fix_part_size = GetEventFixPartSize(EventType::InsertEvent);
+
+    // the head of the binlog is the magic number, the descriptor event and
+    // the header of the data event; one read covers it unless the
+    // descriptor extras are large
+    auto [head, head_length] = read_head(REMOTE_BINLOG_HEAD_PREFETCH_SIZE);
+    AssertInfo(head_length >= int64_t(sizeof(MAGIC_NUM)) + header_size,
+               "binlog " + filepath + " is too short");
+    auto reader = std::make_shared<BinlogReader>(head, head_length);
+    AssertInfo(ReadMediumType(reader) == StorageType::Remote,
+               "binlog " + filepath + " is not a remote file");
+    EventHeader descriptor_header(reader);
+    int64_t payload_offset = sizeof(MAGIC_NUM) +
+                             descriptor_header.event_length_ + header_size +
+                             data_fix_part_size;
+    AssertInfo(payload_offset <= file_size,
+               "binlog " + filepath + " is too short");
+    if (payload_offset > head_length) {
+        std::tie(head, head_length) = read_head(payload_offset);
+    }
+
+    reader = std::make_shared<BinlogReader>(head, head_length);
+    ReadMediumType(reader);
+    DescriptorEvent descriptor_event(reader);
+    DataType data_type =
+        DataType(descriptor_event.event_data.fix_part.data_type);
+    header = EventHeader(reader);
+    if (header.event_type_ != EventType::InsertEvent &&
+        header.event_type_ != EventType::DeleteEvent &&
+        header.event_type_ != EventType::IndexFileEvent) {
+        PanicInfo("unsupported event type");
+    }
+    BaseEventData event_data;
+    auto status = reader->Read(sizeof(event_data.start_timestamp),
+                               &event_data.start_timestamp);
+    AssertInfo(status.ok(), "read start timestamp failed");
+    status = reader->Read(sizeof(event_data.end_timestamp),
+                          &event_data.end_timestamp);
+    AssertInfo(status.ok(), "read end timestamp failed");
+
+    int64_t payload_length =
+        header.event_length_ - header.next_position_ - data_fix_part_size;
+    AssertInfo(payload_length >= 0 &&
+                   payload_offset + payload_length <= file_size,
+               "invalid payload length of binlog " + filepath);
+    // only some row groups of the payload are read, so its checksum can't
+    // be verified here
+    auto input = std::make_shared<RemoteInputStream>(
+        chunk_manager, filepath, payload_offset, payload_length);
+    PayloadReader payload_reader(input, data_type, row_groups);
+    event_data.field_data = payload_reader.get_field_data();
+    return MakeDataCodec(descriptor_event, header.event_type_, event_data);
+}
+
 // For now, no file header in file data
 std::unique_ptr<DataCodec>
 DeserializeLocalFileData(BinlogReaderPtr reader) {
@@ -83,12 +261,23 @@ DeserializeLocalFileData(BinlogReaderPtr reader) {
 
 std::unique_ptr<DataCodec>
 DeserializeFileData(const std::shared_ptr<uint8_t[]> input_data,
-                    int64_t length) {
+                    int64_t length,
+                    std::optional<uint32_t> file_checksum) {
     auto binlog_reader = std::make_shared<BinlogReader>(input_data, length);
     auto medium_type = ReadMediumType(binlog_reader);
     switch (medium_type) {
         case StorageType::Remote: {
-            return DeserializeRemoteFileData(binlog_reader);
+            // the payload is decoded out of `input_data` in place
+            auto buffer =
+                std::make_shared<arrow::Buffer>(input_data.get(), length);
+            std::optional<uint32_t> payload_checksum;
+            if (file_checksum.has_value()) {
+                payload_checksum = PayloadChecksumOfFile(
+                    input_data, length, *file_checksum);
+            }
+            return DeserializeRemoteFileData(
+                std::make_shared<arrow::io::BufferReader>(buffer),
+                payload_checksum);
         }
         case StorageType::LocalDisk: {
             return DeserializeLocalFileData(binlog_reader);
@@ -18,12 +18,15 @@
 
 #include <vector>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 
 #include "storage/Types.h"
 #include "storage/FieldData.h"
 #include "storage/PayloadStream.h"
 #include "storage/BinlogReader.h"
+#include "storage/ChunkManager.h"
 
 namespace milvus::storage {
 
@@ -74,13 +77,35 @@ class DataCodec {
     FieldDataPtr field_data_;
 };
 
-// Deserialize the data stream of the file obtained from remote or local
+// Deserialize the data stream of the file obtained from remote or local,
+// `file_checksum` is the crc32c of the whole file if the download computed
+// it, so the payload checksum of a remote binlog is derived from it instead
+// of hashing the payload again
 std::unique_ptr<DataCodec>
-DeserializeFileData(const std::shared_ptr<uint8_t[]> input, int64_t length);
+DeserializeFileData(const std::shared_ptr<uint8_t[]> input,
+                    int64_t length,
+                    std::optional<uint32_t> file_checksum = std::nullopt);
+
+// Deserialize a remote binlog by ranged reads instead of downloading it:
+// the event headers and the parquet footer are fetched first, then only the
+// column chunks of `row_groups` (all row groups if empty)
+std::unique_ptr<DataCodec>
+DeserializeRemoteFileData(RemoteChunkManager* chunk_manager,
+                          const std::string& filepath,
+                          const std::vector<int>& row_groups = {});
 
 std::unique_ptr<DataCodec>
 DeserializeRemoteFileData(BinlogReaderPtr reader);
 
+// Deserialize the first data event of a remote binlog stream, the payload
+// is decoded from the buffer the stream returns for it; it is verified
+// against the checksum of the descriptor extras if the binlog has one,
+// `payload_checksum` is its crc32c if the caller has it already
+std::unique_ptr<DataCodec>
+DeserializeRemoteFileData(
+    std::shared_ptr<arrow::io::InputStream> input,
+    std::optional<uint32_t> payload_checksum = std::nullopt);
+
 std::unique_ptr<DataCodec>
 DeserializeLocalFileData(BinlogReaderPtr reader);
 
@@ -16,13 +16,20 @@
 
 #include <algorithm>
 #include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <fstream>
 #include <mutex>
+#include <unistd.h>
 
 #include "common/Common.h"
 #include "common/Slice.h"
 #include "log/Log.h"
 #include "config/ConfigKnowhere.h"
 #include "storage/DiskFileManagerImpl.h"
+#include "storage/HedgedChunkManager.h"
 #include "storage/LocalChunkManager.h"
 #include "storage/MinioChunkManager.h"
 #include "storage/Exception.h"
@@ -67,7 +74,8 @@ DiskFileManagerImpl::DiskFileManagerImpl(const FieldDataMeta& field_meta,
                                          const StorageConfig& storage_config)
     : field_meta_(field_meta), index_meta_(index_meta) {
     remote_root_path_ = storage_config.remote_root_path;
-    rcm_ = std::make_unique<MinioChunkManager>(storage_config);
+    rcm_ = std::make_unique<HedgedChunkManager>(
+        std::make_unique<MinioChunkManager>(storage_config));
 }
 
 DiskFileManagerImpl::~DiskFileManagerImpl() {
@@ -81,22 +89,48 @@ DiskFileManagerImpl::LoadFile(const std::string& file) noexcept {
     return true;
 }
 
+// reads `size` bytes at `offset` of an opened local file into `buf`
+static void
+ReadIndexSlice(int fd,
+               const std::string& file,
+               int64_t offset,
+               uint8_t* buf,
+               int64_t size) {
+    while (size > 0) {
+        auto n = pread(fd, buf, size, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw ReadFileException("read local file " + file +
+                                    " failed at offset " +
+                                    std::to_string(offset) + ", " +
+                                    strerror(n < 0 ? errno : EIO));
+        }
+        buf += n;
+        offset += n;
+        size -= n;
+    }
+}
+
+// `buf` belongs to the caller and is reused for a later slice once the
+// returned future is ready
 std::pair<std::string, size_t>
 EncodeAndUploadIndexSlice(RemoteChunkManager* remote_chunk_manager,
+                          int fd,
                           const std::string& file,
+                          uint8_t* buf,
                           int64_t offset,
                           int64_t batch_size,
                           IndexMeta index_meta,
                           FieldDataMeta field_meta,
                           std::string object_key) {
-    auto& local_chunk_manager = LocalChunkManager::GetInstance();
-    auto buf = std::unique_ptr<uint8_t[]>(new uint8_t[batch_size]);
-    local_chunk_manager.Read(file, offset, buf.get(), batch_size);
+    ReadIndexSlice(fd, file, offset, buf, batch_size);
 
     auto field_data =
         milvus::storage::FieldDataFactory::GetInstance().CreateFieldData(
             DataType::INT8);
-    field_data->FillFieldData(buf.get(), batch_size);
+    field_data->FillFieldData(buf, batch_size);
     auto indexData = std::make_shared<IndexData>(field_data);
     indexData->set_index_meta(index_meta);
     indexData->SetFieldDataMeta(field_meta);
@@ -121,75 +155,74 @@ DiskFileManagerImpl::AddFile(const std::string& file) noexcept {
     local_paths_.emplace_back(file);
 
     auto fileName = GetFileName(file);
-    auto fileSize = local_chunk_manager.Size(file);
-
-    std::vector<std::string> batch_remote_files;
-    std::vector<int64_t> remote_file_sizes;
-    std::vector<int64_t> local_file_offsets;
-
-    int slice_num = 0;
-    auto parallel_degree = uint64_t(DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT /
-                                    (index_file_slice_size << 20));
-    for (int64_t offset = 0; offset < fileSize; slice_num++) {
-        if (batch_remote_files.size() >= parallel_degree) {
-            AddBatchIndexFiles(file,
-                               local_file_offsets,
-                               batch_remote_files,
-                               remote_file_sizes);
-            batch_remote_files.clear();
-            remote_file_sizes.clear();
-            local_file_offsets.clear();
-        }
+    auto fileSize = int64_t(local_chunk_manager.Size(file));
 
-        auto batch_size =
-            std::min(index_file_slice_size << 20, int64_t(fileSize) - offset);
-        batch_remote_files.emplace_back(
-            GenerateRemoteIndexFile(fileName, slice_num));
-        remote_file_sizes.emplace_back(batch_size);
-        local_file_offsets.emplace_back(offset);
-        offset += batch_size;
+    auto fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw OpenFileException("open local file " + file + " failed, " +
+                                strerror(errno));
     }
-    if (batch_remote_files.size() > 0) {
-        AddBatchIndexFiles(
-            file, local_file_offsets, batch_remote_files, remote_file_sizes);
+
+    // slices are read, encoded and uploaded as a pipeline: a new slice is
+    // submitted as soon as the oldest in flight one is done, so at most
+    // `parallel_degree` slice buffers are alive and reused round robin
+    const int64_t slice_size = index_file_slice_size << 20;
+    auto parallel_degree = std::max<uint64_t>(
+        1, uint64_t(DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT / slice_size));
+    std::vector<std::unique_ptr<uint8_t[]>> buffers(parallel_degree);
+    std::deque<std::future<std::pair<std::string, size_t>>> futures;
+
+    auto wait_oldest = [&]() {
+        auto res = futures.front().get();
+        futures.pop_front();
+        remote_paths_to_size_[res.first] = res.second;
+    };
+
+    try {
+        int slice_num = 0;
+        for (int64_t offset = 0; offset < fileSize; slice_num++) {
+            if (futures.size() >= parallel_degree) {
+                wait_oldest();
+            }
+
+            auto batch_size = std::min(slice_size, fileSize - offset);
+            auto& buf = buffers[slice_num % parallel_degree];
+            if (buf == nullptr) {
+                buf.reset(new uint8_t[slice_size]);
+            }
+            // uploading a built index must not delay index loading of queries
+            futures.push_back(
+                pool.Submit(TaskPriority::LOW,
+                            EncodeAndUploadIndexSlice,
+                            rcm_.get(),
+                            fd,
+                            file,
+                            buf.get(),
+                            offset,
+                            batch_size,
+                            index_meta_,
+                            field_meta_,
+                            GenerateRemoteIndexFile(fileName, slice_num)));
+            offset += batch_size;
+        }
+        while (!futures.empty()) {
+            wait_oldest();
+        }
+    } catch (...) {
+        // the in flight slices still use the fd and the buffers
+        for (auto& future : futures) {
+            future.wait();
+        }
+        close(fd);
+        throw;
     }
+    close(fd);
     FILEMANAGER_CATCH
     FILEMANAGER_END
 
     return true;
 }  // namespace knowhere
 
-void
-DiskFileManagerImpl::AddBatchIndexFiles(
-    const std::string& local_file_name,
-    const std::vector<int64_t>& local_file_offsets,
-    const std::vector<std::string>& remote_files,
-    const std::vector<int64_t>& remote_file_sizes) {
-    auto& pool = ThreadPool::GetInstance();
-
-    std::vector<std::future<std::pair<std::string, size_t>>> futures;
-    AssertInfo(local_file_offsets.size() == remote_files.size(),
-               "inconsistent size of offset slices with file slices");
-    AssertInfo(remote_files.size() == remote_file_sizes.size(),
-               "inconsistent size of file slices with size slices");
-
-    for (int64_t i = 0; i < remote_files.size(); ++i) {
-        futures.push_back(pool.Submit(EncodeAndUploadIndexSlice,
-                                      rcm_.get(),
-                                      local_file_name,
-                                      local_file_offsets[i],
-                                      remote_file_sizes[i],
-                                      index_meta_,
-                                      field_meta_,
-                                      remote_files[i]));
-    }
-
-    for (auto& future : futures) {
-        auto res = future.get();
-        remote_paths_to_size_[res.first] = res.second;
-    }
-}
-
 void
 DiskFileManagerImpl::CacheIndexToDisk(std::vector<std::string> remote_files) {
     auto& local_chunk_manager = LocalChunkManager::GetInstance();
@@ -205,34 +238,55 @@ DiskFileManagerImpl::CacheIndexToDisk(std::vector<std::string> remote_files) {
         std::sort(slices.second.begin(), slices.second.end());
     }
 
-    auto EstimateParallelDegree = [&](const std::string& file) -> uint64_t {
-        auto fileSize = rcm_->Size(file);
-        return uint64_t(DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT / fileSize);
-    };
-
+    auto manifest = GetCacheManifest();
+    auto& cached_files = manifest["files"];
     for (auto& slices : index_slices) {
         auto prefix = slices.first;
-        auto local_index_file_name =
-            GetLocalIndexObjectPrefix() +
-            prefix.substr(prefix.find_last_of("/") + 1);
+        auto file_name = prefix.substr(prefix.find_last_of("/") + 1);
+        auto local_index_file_name = GetLocalIndexObjectPrefix() + file_name;
+        std::vector<std::string> slice_files;
+        for (auto slice_num : slices.second) {
+            slice_files.push_back(prefix + "_" + std::to_string(slice_num));
+        }
+        auto slice_sizes = GetRemoteFileSizes(slice_files);
+
+        // a file cached before the node restarted is valid if it was cached
+        // from the same slices, which still have the same sizes
+        if (cached_files.contains(file_name)) {
+            auto& cached = cached_files[file_name];
+            if (cached.is_object() &&
+                cached.value("slices", Config()) == Config(slice_files) &&
+                cached.value("slice_sizes", Config()) == Config(slice_sizes) &&
+                local_chunk_manager.Exist(local_index_file_name) &&
+                int64_t(local_chunk_manager.Size(local_index_file_name)) ==
+                    cached.value("size", int64_t(-1))) {
+                LOG_SEGCORE_INFO_ << "reuse cached index file "
+                                  << local_index_file_name;
+                local_paths_.emplace_back(local_index_file_name);
+                continue;
+            }
+            // a crash while the file is written must not leave it valid
+            cached_files.erase(file_name);
+            SaveCacheManifest(manifest);
+        }
+
         local_chunk_manager.CreateFile(local_index_file_name);
         int64_t offset = 0;
         std::vector<std::string> batch_remote_files;
         uint64_t max_parallel_degree = INT_MAX;
-        for (auto iter = slices.second.begin(); iter != slices.second.end();
-             iter++) {
+        for (size_t i = 0; i < slice_files.size(); ++i) {
             if (batch_remote_files.size() == max_parallel_degree) {
                 auto next_offset = CacheBatchIndexFilesToDisk(
                     batch_remote_files, local_index_file_name, offset);
                 offset = next_offset;
                 batch_remote_files.clear();
             }
-            auto origin_file = prefix + "_" + std::to_string(*iter);
             if (batch_remote_files.size() == 0) {
                 // Use first file size as average size to estimate
-                max_parallel_degree = EstimateParallelDegree(origin_file);
+                max_parallel_degree = std::max<uint64_t>(
+                    1, DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT / slice_sizes[i]);
             }
-            batch_remote_files.push_back(origin_file);
+            batch_remote_files.push_back(slice_files[i]);
         }
         if (batch_remote_files.size() > 0) {
             auto next_offset = CacheBatchIndexFilesToDisk(
@@ -241,17 +295,117 @@ DiskFileManagerImpl::CacheIndexToDisk(std::vector<std::string> remote_files) {
             batch_remote_files.clear();
         }
         local_paths_.emplace_back(local_index_file_name);
+
+        cached_files[file_name] = {{"size", offset},
+                                   {"slices", slice_files},
+                                   {"slice_sizes", slice_sizes}};
+        SaveCacheManifest(manifest);
     }
 }
 
-std::unique_ptr<DataCodec>
-DownloadAndDecodeRemoteIndexfile(RemoteChunkManager* remote_chunk_manager,
-                                 std::string file) {
-    auto fileSize = remote_chunk_manager->Size(file);
-    auto buf = std::shared_ptr<uint8_t[]>(new uint8_t[fileSize]);
-    remote_chunk_manager->Read(file, buf.get(), fileSize);
+Config
+DiskFileManagerImpl::GetCacheManifest() {
+    Config manifest;
+    std::ifstream file(GetCacheManifestPath());
+    if (file.is_open()) {
+        manifest = Config::parse(file, nullptr, false);
+    }
+    if (manifest.is_discarded() || !manifest.is_object() ||
+        manifest.value("build_id", int64_t(-1)) != index_meta_.build_id ||
+        manifest.value("index_version", int64_t(-1)) !=
+            index_meta_.index_version) {
+        manifest = Config::object();
+    }
+    manifest["build_id"] = index_meta_.build_id;
+    manifest["index_version"] = index_meta_.index_version;
+    if (!manifest.contains("files") || !manifest["files"].is_object()) {
+        manifest["files"] = Config::object();
+    }
+    return manifest;
+}
+
+std::string
+DiskFileManagerImpl::GetCacheManifestPath() {
+    return GetLocalIndexObjectPrefix() + INDEX_CACHE_MANIFEST;
+}
+
+void
+DiskFileManagerImpl::SaveCacheManifest(const Config& manifest) {
+    // written aside and renamed, a reader never sees it half written
+    auto path = GetCacheManifestPath();
+    auto tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        file << manifest.dump();
+        if (!file.good()) {
+            throw WriteFileException("write index cache manifest " +
+                                     tmp_path + " failed");
+        }
+    }
+    boost::filesystem::rename(tmp_path, path);
+}
+
+std::vector<int64_t>
+DiskFileManagerImpl::GetRemoteFileSizes(
+    const std::vector<std::string>& remote_files) {
+    auto& pool = ThreadPool::GetInstance();
+    std::vector<std::future<uint64_t>> futures;
+    futures.reserve(remote_files.size());
+    for (auto& file : remote_files) {
+        futures.push_back(pool.Submit(TaskPriority::HIGH, [&, this]() {
+            return rcm_->Size(file);
+        }));
+    }
+    std::vector<int64_t> sizes;
+    sizes.reserve(futures.size());
+    try {
+        for (auto& future : futures) {
+            sizes.push_back(int64_t(future.get()));
+        }
+    } catch (...) {
+        // the other requests still use the files and the chunk manager
+        for (auto& future : futures) {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+        throw;
+    }
+    return sizes;
+}
 
-    return DeserializeFileData(buf, fileSize);
+// writes a decoded slice at its offset of an opened local file, slices of
+// a file are written concurrently
+static void
+WriteIndexSlice(int fd,
+                const std::string& file,
+                FieldDataPtr index_data,
+                int64_t offset) {
+    auto buf = reinterpret_cast<const uint8_t*>(index_data->Data());
+    int64_t size = index_data->Size();
+    // allocate the range up front so concurrent writes don't fragment it,
+    // file systems without fallocate fall back to plain writes
+    auto err = posix_fallocate(fd, offset, size);
+    if (err != 0 && err != EOPNOTSUPP && err != EINVAL) {
+        throw WriteFileException("allocate local file " + file +
+                                 " failed at offset " + std::to_string(offset) +
+                                 ", " + strerror(err));
+    }
+    while (size > 0) {
+        auto n = pwrite(fd, buf, size, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw WriteFileException("write local file " + file +
+                                     " failed at offset " +
+                                     std::to_string(offset) + ", " +
+                                     strerror(n < 0 ? errno : EIO));
+        }
+        buf += n;
+        offset += n;
+        size -= n;
+    }
 }
 
 uint64_t
@@ -259,28 +413,57 @@ DiskFileManagerImpl::CacheBatchIndexFilesToDisk(
     const std::vector<std::string>& remote_files,
     const std::string& local_file_name,
     uint64_t local_file_init_offfset) {
-    auto& local_chunk_manager = LocalChunkManager::GetInstance();
     auto& pool = ThreadPool::GetInstance();
     int batch_size = remote_files.size();
 
-    std::vector<std::future<std::unique_ptr<DataCodec>>> futures;
-    for (int i = 0; i < batch_size; ++i) {
-        futures.push_back(pool.Submit(
-            DownloadAndDecodeRemoteIndexfile, rcm_.get(), remote_files[i]));
+    auto fd = open(local_file_name.c_str(), O_WRONLY);
+    if (fd < 0) {
+        throw OpenFileException("open local file " + local_file_name +
+                                " failed, " + strerror(errno));
     }
 
+    std::vector<std::future<std::unique_ptr<DataCodec>>> futures;
+    std::vector<std::future<void>> writes;
     uint64_t offset = local_file_init_offfset;
-    for (int i = 0; i < batch_size; ++i) {
-        auto res = futures[i].get();
-        auto index_data = res->GetFieldData();
-        auto index_size = index_data->Size();
-        local_chunk_manager.Write(
-            local_file_name,
-            offset,
-            reinterpret_cast<uint8_t*>(const_cast<void*>(index_data->Data())),
-            index_size);
-        offset += index_size;
+    try {
+        for (int i = 0; i < batch_size; ++i) {
+            futures.push_back(pool.Submit(TaskPriority::HIGH,
+                                          DownloadAndDecodeRemoteFile,
+                                          rcm_.get(),
+                                          remote_files[i]));
+        }
+        // the offset of a slice is known once the slices before it are
+        // decoded, its write then runs along the other downloads and writes
+        for (int i = 0; i < batch_size; ++i) {
+            auto index_data = futures[i].get()->GetFieldData();
+            auto index_size = index_data->Size();
+            writes.push_back(pool.Submit(TaskPriority::HIGH,
+                                         WriteIndexSlice,
+                                         fd,
+                                         local_file_name,
+                                         index_data,
+                                         int64_t(offset)));
+            offset += index_size;
+        }
+        for (auto& write : writes) {
+            write.get();
+        }
+    } catch (...) {
+        // the in flight tasks still use the chunk manager and the fd
+        for (auto& future : futures) {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+        for (auto& write : writes) {
+            if (write.valid()) {
+                write.wait();
+            }
+        }
+        close(fd);
+        throw;
     }
+    close(fd);
 
     return offset;
 }
@@ -293,11 +476,8 @@ DiskFileManagerImpl::GetFileName(const std::string& localfile) {
 
 std::string
 DiskFileManagerImpl::GetRemoteIndexObjectPrefix() const {
-    return remote_root_path_ + "/" + std::string(INDEX_ROOT_PATH) + "/" +
-           std::to_string(index_meta_.build_id) + "/" +
-           std::to_string(index_meta_.index_version) + "/" +
-           std::to_string(field_meta_.partition_id) + "/" +
-           std::to_string(field_meta_.segment_id);
+    return GenRemoteIndexPathPrefix(
+        remote_root_path_, field_meta_, index_meta_);
 }
 
 std::string
@@ -82,20 +82,20 @@ class DiskFileManagerImpl : public FileManagerImpl {
                std::to_string(slice_num);
     }
 
+    // index files cached by an earlier load which still match their remote
+    // slices are reused instead of downloaded again
     void
     CacheIndexToDisk(std::vector<std::string> remote_files);
 
+    // the local index files this index has cached and their remote slices
+    Config
+    GetCacheManifest();
+
     uint64_t
     CacheBatchIndexFilesToDisk(const std::vector<std::string>& remote_files,
                                const std::string& local_file_name,
                                uint64_t local_file_init_offfset);
 
-    void
-    AddBatchIndexFiles(const std::string& local_file_name,
-                       const std::vector<int64_t>& local_file_offsets,
-                       const std::vector<std::string>& remote_files,
-                       const std::vector<int64_t>& remote_file_sizes);
-
     FieldDataMeta
     GetFileDataMeta() const {
         return field_meta_;
@@ -115,6 +115,15 @@ class DiskFileManagerImpl : public FileManagerImpl {
     std::string
     GetFileName(const std::string& localfile);
 
+    std::string
+    GetCacheManifestPath();
+
+    void
+    SaveCacheManifest(const Config& manifest);
+
+    std::vector<int64_t>
+    GetRemoteFileSizes(const std::vector<std::string>& remote_files);
+
  private:
     // collection meta
     FieldDataMeta field_meta_;
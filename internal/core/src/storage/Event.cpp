@@ -23,6 +23,7 @@
 #include "utils/Json.h"
 #include "common/Consts.h"
 #include "common/FieldMeta.h"
+#include "simd/crc32c.h"
 
 namespace milvus::storage {
 
@@ -162,6 +163,9 @@ DescriptorEventData::DescriptorEventData(BinlogReaderPtr reader) {
     if (json.contains(INDEX_BUILD_ID_KEY)) {
         extras[INDEX_BUILD_ID_KEY] = json[INDEX_BUILD_ID_KEY];
     }
+    if (json.contains(PAYLOAD_CHECKSUM_KEY)) {
+        extras[PAYLOAD_CHECKSUM_KEY] = json[PAYLOAD_CHECKSUM_KEY];
+    }
 }
 
 std::vector<uint8_t>
@@ -211,6 +215,19 @@ BaseEventData::BaseEventData(BinlogReaderPtr reader,
 
 std::vector<uint8_t>
 BaseEventData::Serialize() {
+    if (!payload.empty()) {
+        std::vector<uint8_t> res(sizeof(start_timestamp) +
+                                 sizeof(end_timestamp) + payload.size());
+        memcpy(res.data(), &start_timestamp, sizeof(start_timestamp));
+        memcpy(res.data() + sizeof(start_timestamp),
+               &end_timestamp,
+               sizeof(end_timestamp));
+        memcpy(res.data() + sizeof(start_timestamp) + sizeof(end_timestamp),
+               payload.data(),
+               payload.size());
+        payload_checksum = simd::Crc32c(0, payload.data(), payload.size());
+        return res;
+    }
     auto data_type = field_data->get_data_type();
     std::shared_ptr<PayloadWriter> payload_writer;
     if (milvus::datatype_is_vector(data_type)) {
@@ -243,6 +260,8 @@ BaseEventData::Serialize() {
     memcpy(res.data() + offset, &end_timestamp, sizeof(end_timestamp));
     offset += sizeof(end_timestamp);
     memcpy(res.data() + offset, payload_buffer.data(), payload_buffer.size());
+    payload_checksum =
+        simd::Crc32c(0, payload_buffer.data(), payload_buffer.size());
 
     return res;
 }
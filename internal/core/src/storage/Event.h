@@ -78,6 +78,11 @@ struct BaseEventData {
     Timestamp start_timestamp;
     Timestamp end_timestamp;
     FieldDataPtr field_data;
+    // the payload already encoded by a payload writer, serialized instead
+    // of field_data if not empty
+    std::vector<uint8_t> payload;
+    // crc32c of the payload serialized, set by Serialize
+    uint32_t payload_checksum = 0;
 
     BaseEventData() {
     }
@@ -27,7 +27,8 @@ FieldDataImpl<Type, is_scalar>::FillFieldData(const void* source,
         return;
     }
     AssertInfo(field_data_.size() == 0, "no empty field vector");
-    field_data_.resize(element_count);
+    // overwritten right away, no need to zero it first
+    field_data_.resize(element_count, boost::container::default_init);
     std::copy_n(
         static_cast<const Type*>(source), element_count, field_data_.data());
 }
@@ -107,6 +108,17 @@ FieldDataImpl<Type, is_scalar>::FillFieldData(
             }
             return FillFieldData(values.data(), element_count);
         }
+        case DataType::JSON: {
+            AssertInfo(array->type()->id() == arrow::Type::type::BINARY,
+                       "inconsistent data type");
+            auto json_array =
+                std::dynamic_pointer_cast<arrow::BinaryArray>(array);
+            std::vector<std::string> values(element_count);
+            for (size_t index = 0; index < element_count; ++index) {
+                values[index] = json_array->GetString(index);
+            }
+            return FillFieldData(values.data(), element_count);
+        }
         case DataType::VECTOR_FLOAT: {
             AssertInfo(
                 array->type()->id() == arrow::Type::type::FIXED_SIZE_BINARY,
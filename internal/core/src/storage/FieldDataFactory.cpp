@@ -38,6 +38,8 @@ FieldDataFactory::CreateFieldData(const DataType& type, const int64_t dim) {
             return std::make_shared<FieldData<double>>(type);
         case DataType::STRING:
         case DataType::VARCHAR:
+        // the bytes of the json documents
+        case DataType::JSON:
             return std::make_shared<FieldData<std::string>>(type);
         case DataType::VECTOR_FLOAT:
             return std::make_shared<FieldData<FloatVector>>(dim, type);
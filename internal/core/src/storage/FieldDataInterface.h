@@ -20,6 +20,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <type_traits>
 
 #include "arrow/api.h"
 #include "common/FieldMeta.h"
@@ -27,6 +28,7 @@
 #include "common/VectorTrait.h"
 #include "exceptions/EasyAssert.h"
 #include "storage/Exception.h"
+#include "storage/FieldDataPool.h"
 
 namespace milvus::storage {
 
@@ -76,7 +78,11 @@ template <typename Type, bool is_scalar = false>
 class FieldDataImpl : public FieldDataBase {
  public:
     // constants
-    using Chunk = FixedVector<Type>;
+    // the buffers of plain values come from the field data pool
+    using Chunk = std::conditional_t<
+        std::is_trivially_copyable_v<Type>,
+        boost::container::vector<Type, FieldDataAllocator<Type>>,
+        FixedVector<Type>>;
     FieldDataImpl(FieldDataImpl&&) = delete;
     FieldDataImpl(const FieldDataImpl&) = delete;
 
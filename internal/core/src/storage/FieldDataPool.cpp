@@ -0,0 +1,207 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "storage/FieldDataPool.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <new>
+
+#include "common/Metrics.h"
+
+namespace milvus::storage {
+
+namespace {
+
+const size_t page_size = 4096;
+
+void*
+MapSlab(size_t size) {
+    auto align = size >= FieldDataPool::kHugePageSize
+                     ? FieldDataPool::kHugePageSize
+                     : page_size;
+    // mapped with room to align, the head and the tail are unmapped
+    auto mapped_size = size + align - page_size;
+    auto mapped = mmap(nullptr,
+                       mapped_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+    if (mapped == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    auto begin = reinterpret_cast<uintptr_t>(mapped);
+    auto aligned = (begin + align - 1) / align * align;
+    if (aligned > begin) {
+        munmap(mapped, aligned - begin);
+    }
+    auto tail = begin + mapped_size - (aligned + size);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+    auto slab = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (align == FieldDataPool::kHugePageSize) {
+        madvise(slab, size, MADV_HUGEPAGE);
+    }
+#endif
+    return slab;
+}
+
+}  // namespace
+
+FieldDataPool&
+FieldDataPool::GetInstance() {
+    // never destroyed, the field datas of other statics may outlive it
+    static auto* pool = new FieldDataPool();
+    return *pool;
+}
+
+FieldDataPool::FieldDataPool() {
+    for (auto size = kMinPooledSize; size < kMaxPooledSize; size *= 2) {
+        for (size_t quarter = 4; quarter < 8; ++quarter) {
+            class_sizes_.push_back(size / 4 * quarter);
+        }
+    }
+    class_sizes_.push_back(kMaxPooledSize);
+    free_slabs_.resize(class_sizes_.size());
+}
+
+size_t
+FieldDataPool::ClassOf(size_t size) const {
+    return std::lower_bound(class_sizes_.begin(), class_sizes_.end(), size) -
+           class_sizes_.begin();
+}
+
+void*
+FieldDataPool::Allocate(size_t size) {
+    if (size < kMinPooledSize) {
+        return ::operator new(size);
+    }
+    if (size > kMaxPooledSize) {
+        return MapSlab((size + page_size - 1) / page_size * page_size);
+    }
+    auto cls = ClassOf(size);
+    auto class_size = class_sizes_[cls];
+    {
+        std::lock_guard lck(mutex_);
+        stats_.used_bytes += class_size;
+        monitor::field_data_pool_used_bytes.Add(class_size);
+        auto& slabs = free_slabs_[cls];
+        if (!slabs.empty()) {
+            auto slab = slabs.back();
+            slabs.pop_back();
+            stats_.cached_bytes -= class_size;
+            ++stats_.hits;
+            monitor::field_data_pool_cached_bytes.Sub(class_size);
+            monitor::field_data_pool_hits.Inc();
+            return slab;
+        }
+        ++stats_.misses;
+        monitor::field_data_pool_misses.Inc();
+    }
+    try {
+        return MapSlab(class_size);
+    } catch (...) {
+        std::lock_guard lck(mutex_);
+        stats_.used_bytes -= class_size;
+        monitor::field_data_pool_used_bytes.Sub(class_size);
+        throw;
+    }
+}
+
+void
+FieldDataPool::Deallocate(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (size < kMinPooledSize) {
+        ::operator delete(ptr);
+        return;
+    }
+    if (size > kMaxPooledSize) {
+        munmap(ptr, (size + page_size - 1) / page_size * page_size);
+        return;
+    }
+    auto cls = ClassOf(size);
+    auto class_size = class_sizes_[cls];
+    {
+        std::lock_guard lck(mutex_);
+        stats_.used_bytes -= class_size;
+        monitor::field_data_pool_used_bytes.Sub(class_size);
+        if (stats_.cached_bytes + int64_t(class_size) <= capacity_) {
+            free_slabs_[cls].push_back(ptr);
+            stats_.cached_bytes += class_size;
+            monitor::field_data_pool_cached_bytes.Add(class_size);
+            return;
+        }
+    }
+    munmap(ptr, class_size);
+}
+
+void
+FieldDataPool::SetCapacity(int64_t capacity) {
+    capacity = std::max<int64_t>(capacity, 0);
+    {
+        std::lock_guard lck(mutex_);
+        capacity_ = capacity;
+    }
+    Trim(capacity);
+}
+
+int64_t
+FieldDataPool::GetCapacity() const {
+    std::lock_guard lck(mutex_);
+    return capacity_;
+}
+
+FieldDataPool::Stats
+FieldDataPool::GetStats() const {
+    std::lock_guard lck(mutex_);
+    return stats_;
+}
+
+void
+FieldDataPool::Clear() {
+    Trim(0);
+}
+
+// unmaps the kept slabs of the largest classes first until the rest fit
+// `capacity`
+void
+FieldDataPool::Trim(int64_t capacity) {
+    std::vector<std::pair<void*, size_t>> unmapped;
+    {
+        std::lock_guard lck(mutex_);
+        for (auto cls = free_slabs_.size(); cls-- > 0;) {
+            auto& slabs = free_slabs_[cls];
+            auto class_size = class_sizes_[cls];
+            while (!slabs.empty() && stats_.cached_bytes > capacity) {
+                unmapped.emplace_back(slabs.back(), class_size);
+                slabs.pop_back();
+                stats_.cached_bytes -= class_size;
+                monitor::field_data_pool_cached_bytes.Sub(class_size);
+            }
+        }
+    }
+    for (auto [slab, size] : unmapped) {
+        munmap(slab, size);
+    }
+}
+
+}  // namespace milvus::storage
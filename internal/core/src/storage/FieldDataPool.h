@@ -0,0 +1,127 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace milvus::storage {
+
+// Reuses the large buffers of the decoded field datas across binlogs, so a
+// segment load doesn't map and fault in fresh memory for every binlog.
+// Buffers from kMinPooledSize bytes up to kMaxPooledSize are rounded up to
+// a size class, a quarter of a power of two apart, and taken from slabs
+// mapped on their own, aligned to and advised as huge pages from
+// kHugePageSize on. A released slab is kept for the next buffer of its
+// class while the kept ones fit the capacity, unmapped otherwise. Smaller
+// buffers come from the heap, larger ones are mapped for each.
+class FieldDataPool {
+ public:
+    static constexpr size_t kMinPooledSize = size_t(1) << 20;
+    static constexpr size_t kMaxPooledSize = size_t(1) << 30;
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+    struct Stats {
+        // of the slabs kept for reuse
+        int64_t cached_bytes = 0;
+        // of the buffers handed out, as their size class
+        int64_t used_bytes = 0;
+        int64_t hits = 0;
+        int64_t misses = 0;
+    };
+
+    static FieldDataPool&
+    GetInstance();
+
+    void*
+    Allocate(size_t size);
+
+    // `size` as given to Allocate
+    void
+    Deallocate(void* ptr, size_t size);
+
+    // bytes of the slabs kept for reuse at most, 0 keeps none; the slabs
+    // over it are unmapped right away
+    void
+    SetCapacity(int64_t capacity);
+
+    int64_t
+    GetCapacity() const;
+
+    Stats
+    GetStats() const;
+
+    // unmaps all the kept slabs
+    void
+    Clear();
+
+ private:
+    FieldDataPool();
+
+    // the size class of a pooled size
+    size_t
+    ClassOf(size_t size) const;
+
+    void
+    Trim(int64_t capacity);
+
+    std::vector<size_t> class_sizes_;
+    mutable std::mutex mutex_;
+    std::vector<std::vector<void*>> free_slabs_;
+    int64_t capacity_ = 0;
+    Stats stats_;
+};
+
+// The allocator of the buffers of FieldDataImpl, which go through the pool
+template <typename T>
+class FieldDataAllocator {
+ public:
+    using value_type = T;
+
+    FieldDataAllocator() = default;
+
+    template <typename U>
+    FieldDataAllocator(const FieldDataAllocator<U>&) {
+    }
+
+    T*
+    allocate(size_t n) {
+        return static_cast<T*>(
+            FieldDataPool::GetInstance().Allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* ptr, size_t n) {
+        FieldDataPool::GetInstance().Deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool
+    operator==(const FieldDataAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool
+    operator!=(const FieldDataAllocator<U>&) const {
+        return false;
+    }
+};
+
+}  // namespace milvus::storage
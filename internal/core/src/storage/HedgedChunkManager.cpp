@@ -0,0 +1,414 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "storage/HedgedChunkManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+
+#include "common/Consts.h"
+#include "storage/ThreadPool.h"
+
+namespace milvus::storage {
+
+class HedgedChunkManager::Limiter {
+ public:
+    explicit Limiter(int64_t slots) : slots_(std::max<int64_t>(slots, 1)) {
+    }
+
+    void
+    Acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return slots_ > 0; });
+        --slots_;
+    }
+
+    bool
+    TryAcquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slots_ == 0) {
+            return false;
+        }
+        --slots_;
+        return true;
+    }
+
+    void
+    Release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++slots_;
+        }
+        cv_.notify_one();
+    }
+
+ private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int64_t slots_;
+};
+
+class HedgedChunkManager::LatencyRecorder {
+ public:
+    static constexpr size_t WINDOW = 1024;
+
+    void
+    Record(int64_t latency_us) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (samples_.size() < WINDOW) {
+            samples_.push_back(latency_us);
+        } else {
+            samples_[count_ % WINDOW] = latency_us;
+        }
+        ++count_;
+    }
+
+    int64_t
+    Count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    int64_t
+    Percentile(double percentile) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return PercentileLocked(percentile);
+    }
+
+    RemoteOpStats
+    Stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RemoteOpStats stats;
+        stats.count = count_;
+        stats.p50_us = PercentileLocked(0.5);
+        stats.p99_us = PercentileLocked(0.99);
+        stats.max_us = PercentileLocked(1.0);
+        return stats;
+    }
+
+ private:
+    int64_t
+    PercentileLocked(double percentile) const {
+        if (samples_.empty()) {
+            return 0;
+        }
+        auto sorted = samples_;
+        auto k = size_t(percentile * (sorted.size() - 1));
+        std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+        return sorted[k];
+    }
+
+ private:
+    mutable std::mutex mutex_;
+    std::vector<int64_t> samples_;
+    int64_t count_ = 0;
+};
+
+namespace {
+
+// the remote requests run on a pool of their own, a read waiting for its
+// attempts may itself run on a worker of the shared pool
+ThreadPool&
+GetRemoteIOPool() {
+    static ThreadPool pool(DEFAULT_REMOTE_IO_THREAD_CORE_COEFFICIENT);
+    return pool;
+}
+
+// holds a slot of the limiter for a request
+class SlotGuard {
+ public:
+    SlotGuard(std::shared_ptr<HedgedChunkManager::Limiter> limiter,
+              bool acquired = false);
+
+    ~SlotGuard();
+
+ private:
+    std::shared_ptr<HedgedChunkManager::Limiter> limiter_;
+};
+
+// records the latency of a request when it goes out of scope
+class Timer {
+ public:
+    explicit Timer(HedgedChunkManager::LatencyRecorder& recorder)
+        : recorder_(recorder), start_(std::chrono::steady_clock::now()) {
+    }
+
+    ~Timer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        recorder_.Record(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+                .count());
+    }
+
+ private:
+    HedgedChunkManager::LatencyRecorder& recorder_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+const char* const OPERATIONS[] = {
+    "exist", "size", "read", "write", "read_ranges", "list", "remove"};
+
+}  // namespace
+
+SlotGuard::SlotGuard(std::shared_ptr<HedgedChunkManager::Limiter> limiter,
+                     bool acquired)
+    : limiter_(std::move(limiter)) {
+    if (!acquired) {
+        limiter_->Acquire();
+    }
+}
+
+SlotGuard::~SlotGuard() {
+    limiter_->Release();
+}
+
+HedgedChunkManager::HedgedChunkManager(RemoteChunkManagerPtr chunk_manager,
+                                       const HedgedReadConfig& config)
+    : chunk_manager_(std::move(chunk_manager)),
+      config_(config),
+      limiter_(std::make_shared<Limiter>(config.max_inflight)) {
+    for (auto op : OPERATIONS) {
+        recorders_.emplace(op, std::make_shared<LatencyRecorder>());
+    }
+}
+
+std::shared_ptr<HedgedChunkManager::LatencyRecorder>
+HedgedChunkManager::Recorder(const std::string& op) const {
+    return recorders_.at(op);
+}
+
+bool
+HedgedChunkManager::Exist(const std::string& filepath) {
+    SlotGuard slot(limiter_);
+    Timer timer(*Recorder("exist"));
+    return chunk_manager_->Exist(filepath);
+}
+
+uint64_t
+HedgedChunkManager::Size(const std::string& filepath) {
+    SlotGuard slot(limiter_);
+    Timer timer(*Recorder("size"));
+    return chunk_manager_->Size(filepath);
+}
+
+uint64_t
+HedgedChunkManager::Read(const std::string& filepath,
+                         void* buf,
+                         uint64_t len) {
+    return HedgedRead(filepath, true, 0, buf, len);
+}
+
+uint64_t
+HedgedChunkManager::Read(const std::string& filepath,
+                         uint64_t offset,
+                         void* buf,
+                         uint64_t len) {
+    return HedgedRead(filepath, false, offset, buf, len);
+}
+
+void
+HedgedChunkManager::Write(const std::string& filepath,
+                          void* buf,
+                          uint64_t len) {
+    SlotGuard slot(limiter_);
+    Timer timer(*Recorder("write"));
+    chunk_manager_->Write(filepath, buf, len);
+}
+
+void
+HedgedChunkManager::Write(const std::string& filepath,
+                          uint64_t offset,
+                          void* buf,
+                          uint64_t len) {
+    SlotGuard slot(limiter_);
+    Timer timer(*Recorder("write"));
+    chunk_manager_->Write(filepath, offset, buf, len);
+}
+
+uint64_t
+HedgedChunkManager::ReadRanges(const std::string& filepath,
+                               void* buf,
+                               uint64_t len,
+                               uint64_t range_size,
+                               int64_t max_inflight,
+                               const RangeCallback& on_range) {
+    // already fanned out by the wrapped manager, not duplicated
+    Timer timer(*Recorder("read_ranges"));
+    return chunk_manager_->ReadRanges(
+        filepath, buf, len, range_size, max_inflight, on_range);
+}
+
+std::vector<std::string>
+HedgedChunkManager::ListWithPrefix(const std::string& filepath) {
+    SlotGuard slot(limiter_);
+    Timer timer(*Recorder("list"));
+    return chunk_manager_->ListWithPrefix(filepath);
+}
+
+void
+HedgedChunkManager::Remove(const std::string& filepath) {
+    SlotGuard slot(limiter_);
+    Timer timer(*Recorder("remove"));
+    chunk_manager_->Remove(filepath);
+}
+
+uint64_t
+HedgedChunkManager::HedgedRead(const std::string& filepath,
+                               bool whole_object,
+                               uint64_t offset,
+                               void* buf,
+                               uint64_t len) {
+    auto recorder = Recorder("read");
+    auto read = [chunk_manager = chunk_manager_,
+                 filepath,
+                 whole_object,
+                 offset](void* dst, uint64_t size) {
+        return whole_object ? chunk_manager->Read(filepath, dst, size)
+                            : chunk_manager->Read(filepath, offset, dst, size);
+    };
+    if (len > config_.max_hedge_size ||
+        recorder->Count() < config_.min_hedge_samples) {
+        SlotGuard slot(limiter_);
+        Timer timer(*recorder);
+        return read(buf, len);
+    }
+    auto delay_us = std::max(recorder->Percentile(config_.hedge_percentile),
+                             config_.min_hedge_delay_ms * 1000);
+
+    // every attempt reads into a buffer of its own, the one finishing first
+    // hands it over and a later one is dropped
+    struct Attempts {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int64_t running = 0;
+        bool done = false;
+        uint64_t size = 0;
+        std::vector<char> data;
+        std::exception_ptr error;
+    };
+    auto attempts = std::make_shared<Attempts>();
+    auto attempt = [attempts, read, recorder, limiter = limiter_, len]() {
+        SlotGuard slot(limiter, true);
+        std::vector<char> data(len);
+        uint64_t size = 0;
+        std::exception_ptr error;
+        try {
+            Timer timer(*recorder);
+            size = read(data.data(), len);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(attempts->mutex);
+            --attempts->running;
+            if (!attempts->done && !error) {
+                attempts->done = true;
+                attempts->size = size;
+                attempts->data = std::move(data);
+            } else if (!attempts->done && !attempts->error) {
+                attempts->error = error;
+            }
+        }
+        attempts->cv.notify_all();
+    };
+
+    auto& pool = GetRemoteIOPool();
+    limiter_->Acquire();
+    attempts->running = 1;
+    pool.Submit(attempt);
+
+    std::unique_lock<std::mutex> lock(attempts->mutex);
+    auto finished = [&attempts] {
+        return attempts->done || attempts->running == 0;
+    };
+    // a duplicate only takes a free slot, it never queues behind the
+    // requests of other reads
+    if (!attempts->cv.wait_for(
+            lock, std::chrono::microseconds(delay_us), finished) &&
+        limiter_->TryAcquire()) {
+        ++attempts->running;
+        ++hedged_;
+        lock.unlock();
+        pool.Submit(attempt);
+        lock.lock();
+    }
+    attempts->cv.wait(lock, finished);
+    if (!attempts->done) {
+        std::rethrow_exception(attempts->error);
+    }
+    memcpy(buf, attempts->data.data(), attempts->size);
+    return attempts->size;
+}
+
+std::vector<uint64_t>
+HedgedChunkManager::ReadCoalesced(const std::string& filepath,
+                                  const std::vector<RemoteReadRange>& ranges) {
+    std::vector<size_t> order(ranges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&ranges](size_t a, size_t b) {
+        return ranges[a].offset < ranges[b].offset;
+    });
+
+    std::vector<uint64_t> sizes(ranges.size(), 0);
+    size_t i = 0;
+    while (i < order.size()) {
+        auto begin = ranges[order[i]].offset;
+        auto end = begin + ranges[order[i]].len;
+        auto j = i + 1;
+        for (; j < order.size(); ++j) {
+            auto& next = ranges[order[j]];
+            auto next_end = std::max(end, next.offset + next.len);
+            if (next.offset > end + config_.max_coalesce_gap ||
+                next_end - begin > config_.max_coalesce_size) {
+                break;
+            }
+            end = next_end;
+        }
+
+        if (j == i + 1) {
+            auto& range = ranges[order[i]];
+            sizes[order[i]] =
+                HedgedRead(filepath, false, range.offset, range.buf, range.len);
+        } else {
+            std::vector<char> data(end - begin);
+            auto size =
+                HedgedRead(filepath, false, begin, data.data(), data.size());
+            for (auto k = i; k < j; ++k) {
+                auto& range = ranges[order[k]];
+                auto from = range.offset - begin;
+                auto n = from < size ? std::min(range.len, size - from) : 0;
+                memcpy(range.buf, data.data() + from, n);
+                sizes[order[k]] = n;
+            }
+        }
+        i = j;
+    }
+    return sizes;
+}
+
+std::map<std::string, RemoteOpStats>
+HedgedChunkManager::GetStats() const {
+    std::map<std::string, RemoteOpStats> stats;
+    for (auto& [op, recorder] : recorders_) {
+        stats[op] = recorder->Stats();
+    }
+    stats["read"].hedged = hedged_;
+    return stats;
+}
+
+}  // namespace milvus::storage
@@ -0,0 +1,159 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "storage/ChunkManager.h"
+
+namespace milvus::storage {
+
+struct HedgedReadConfig {
+    // a read still running after this percentile of the recent read
+    // latencies gets a duplicate request, the first to return wins
+    double hedge_percentile = 0.95;
+    // reads are never duplicated before this delay
+    int64_t min_hedge_delay_ms = 10;
+    // the percentile is trusted once this many reads are recorded
+    int64_t min_hedge_samples = 32;
+    // larger reads are not duplicated
+    uint64_t max_hedge_size = 4 << 20;
+    // requests in flight to the bucket at a time, duplicates included
+    int64_t max_inflight = 64;
+    // ranges at most this far apart are fetched by one request
+    uint64_t max_coalesce_gap = 64 << 10;
+    // a coalesced request never spans more than this
+    uint64_t max_coalesce_size = 16 << 20;
+};
+
+// a byte range of an object and where to read it
+struct RemoteReadRange {
+    uint64_t offset;
+    uint64_t len;
+    void* buf;
+};
+
+struct RemoteOpStats {
+    int64_t count = 0;
+    // duplicate requests issued, reads only
+    int64_t hedged = 0;
+    // over the recent requests
+    int64_t p50_us = 0;
+    int64_t p99_us = 0;
+    int64_t max_us = 0;
+};
+
+/**
+ * @brief HedgedChunkManager wraps the RemoteChunkManager of a bucket, caps
+ * the requests in flight to it, duplicates the small reads that run longer
+ * than most of the recent ones and records the latency of every operation
+ */
+class HedgedChunkManager : public RemoteChunkManager {
+ public:
+    explicit HedgedChunkManager(RemoteChunkManagerPtr chunk_manager,
+                                const HedgedReadConfig& config = {});
+
+    virtual ~HedgedChunkManager() {
+    }
+
+    virtual bool
+    Exist(const std::string& filepath);
+
+    virtual uint64_t
+    Size(const std::string& filepath);
+
+    virtual uint64_t
+    Read(const std::string& filepath, void* buf, uint64_t len);
+
+    virtual void
+    Write(const std::string& filepath, void* buf, uint64_t len);
+
+    virtual uint64_t
+    Read(const std::string& filepath, uint64_t offset, void* buf, uint64_t len);
+
+    virtual void
+    Write(const std::string& filepath,
+          uint64_t offset,
+          void* buf,
+          uint64_t len);
+
+    virtual uint64_t
+    ReadRanges(const std::string& filepath,
+               void* buf,
+               uint64_t len,
+               uint64_t range_size,
+               int64_t max_inflight,
+               const RangeCallback& on_range = nullptr);
+
+    virtual std::vector<std::string>
+    ListWithPrefix(const std::string& filepath);
+
+    virtual void
+    Remove(const std::string& filepath);
+
+    virtual std::string
+    GetName() const {
+        return "HedgedChunkManager";
+    }
+
+    /**
+     * @brief Read byte ranges of an object, ranges close to each other are
+     * fetched by a single request
+     * @return the bytes read of each range
+     */
+    std::vector<uint64_t>
+    ReadCoalesced(const std::string& filepath,
+                  const std::vector<RemoteReadRange>& ranges);
+
+    /**
+     * @brief Latency of the recent requests of each operation, keyed by
+     * the operation name, e.g. "read"
+     */
+    std::map<std::string, RemoteOpStats>
+    GetStats() const;
+
+    // the attempts of a read share these with the manager, a losing
+    // attempt may outlive both the read and the manager
+    class Limiter;
+    class LatencyRecorder;
+
+ private:
+    uint64_t
+    HedgedRead(const std::string& filepath,
+               bool whole_object,
+               uint64_t offset,
+               void* buf,
+               uint64_t len);
+
+    std::shared_ptr<LatencyRecorder>
+    Recorder(const std::string& op) const;
+
+ private:
+    std::shared_ptr<RemoteChunkManager> chunk_manager_;
+    HedgedReadConfig config_;
+    std::shared_ptr<Limiter> limiter_;
+    std::map<std::string, std::shared_ptr<LatencyRecorder>> recorders_;
+    std::atomic<int64_t> hedged_ = 0;
+};
+
+}  // namespace milvus::storage
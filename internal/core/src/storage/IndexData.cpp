@@ -88,6 +88,14 @@ IndexData::serialize_to_remote_file() {
         std::to_string(field_data_->Size());
     des_event_data.extras[INDEX_BUILD_ID_KEY] =
         std::to_string(index_meta_->build_id);
+    des_event_data.extras[INDEX_VERSION_KEY] =
+        std::to_string(index_meta_->index_version);
+    des_event_data.extras[INDEX_ID_KEY] =
+        std::to_string(index_meta_->index_id);
+    des_event_data.extras[INDEX_NAME_KEY] = index_meta_->index_name;
+    des_event_data.extras[INDEX_FILE_KEY] = index_meta_->key;
+    des_event_data.extras[PAYLOAD_CHECKSUM_KEY] =
+        std::to_string(index_event_data.payload_checksum);
 
     auto& des_event_header = descriptor_event.event_header;
     // TODO :: set timestamp
@@ -15,6 +15,9 @@
 // limitations under the License.
 
 #include "storage/InsertData.h"
+
+#include <utility>
+
 #include "storage/Event.h"
 #include "storage/Util.h"
 #include "utils/Json.h"
@@ -41,18 +44,19 @@ InsertData::Serialize(StorageType medium) {
     }
 }
 
-// TODO :: handle string and bool type
-std::vector<uint8_t>
-InsertData::serialize_to_remote_file() {
-    AssertInfo(field_data_meta_.has_value(), "field data not exist");
-    AssertInfo(field_data_ != nullptr, "empty field data");
+namespace {
 
+// the descriptor event of the field followed by one insert event
+std::vector<uint8_t>
+SerializeRemoteFile(const FieldDataMeta& meta,
+                    DataType data_type,
+                    InsertEventData event_data,
+                    int64_t original_size) {
     // create insert event
     InsertEvent insert_event;
-    auto& insert_event_data = insert_event.event_data;
-    insert_event_data.start_timestamp = time_range_.first;
-    insert_event_data.end_timestamp = time_range_.second;
-    insert_event_data.field_data = field_data_;
+    auto start_timestamp = event_data.start_timestamp;
+    auto end_timestamp = event_data.end_timestamp;
+    insert_event.event_data = std::move(event_data);
 
     auto& insert_event_header = insert_event.event_header;
     // TODO :: set timestamps
@@ -61,18 +65,17 @@ InsertData::serialize_to_remote_file() {
 
     // serialize insert event
     auto insert_event_bytes = insert_event.Serialize();
-    DataType data_type = field_data_->get_data_type();
 
     // create descriptor event
     DescriptorEvent descriptor_event;
     auto& des_event_data = descriptor_event.event_data;
     auto& des_fix_part = des_event_data.fix_part;
-    des_fix_part.collection_id = field_data_meta_->collection_id;
-    des_fix_part.partition_id = field_data_meta_->partition_id;
-    des_fix_part.segment_id = field_data_meta_->segment_id;
-    des_fix_part.field_id = field_data_meta_->field_id;
-    des_fix_part.start_timestamp = time_range_.first;
-    des_fix_part.end_timestamp = time_range_.second;
+    des_fix_part.collection_id = meta.collection_id;
+    des_fix_part.partition_id = meta.partition_id;
+    des_fix_part.segment_id = meta.segment_id;
+    des_fix_part.field_id = meta.field_id;
+    des_fix_part.start_timestamp = start_timestamp;
+    des_fix_part.end_timestamp = end_timestamp;
     des_fix_part.data_type = milvus::proto::schema::DataType(data_type);
     for (auto i = int8_t(EventType::DescriptorEvent);
          i < int8_t(EventType::EventTypeEnd);
@@ -80,8 +83,9 @@ InsertData::serialize_to_remote_file() {
         des_event_data.post_header_lengths.push_back(
             GetEventFixPartSize(EventType(i)));
     }
-    des_event_data.extras[ORIGIN_SIZE_KEY] =
-        std::to_string(field_data_->Size());
+    des_event_data.extras[ORIGIN_SIZE_KEY] = std::to_string(original_size);
+    des_event_data.extras[PAYLOAD_CHECKSUM_KEY] =
+        std::to_string(insert_event.event_data.payload_checksum);
 
     auto& des_event_header = descriptor_event.event_header;
     // TODO :: set timestamp
@@ -97,6 +101,40 @@ InsertData::serialize_to_remote_file() {
     return des_event_bytes;
 }
 
+}  // namespace
+
+// TODO :: handle string and bool type
+std::vector<uint8_t>
+InsertData::serialize_to_remote_file() {
+    AssertInfo(field_data_meta_.has_value(), "field data not exist");
+    AssertInfo(field_data_ != nullptr, "empty field data");
+
+    InsertEventData event_data;
+    event_data.start_timestamp = time_range_.first;
+    event_data.end_timestamp = time_range_.second;
+    event_data.field_data = field_data_;
+    return SerializeRemoteFile(*field_data_meta_,
+                               field_data_->get_data_type(),
+                               std::move(event_data),
+                               field_data_->Size());
+}
+
+std::vector<uint8_t>
+SerializeRemoteInsertFile(const FieldDataMeta& meta,
+                          DataType data_type,
+                          Timestamp start_timestamp,
+                          Timestamp end_timestamp,
+                          std::vector<uint8_t> payload,
+                          int64_t original_size) {
+    AssertInfo(!payload.empty(), "empty payload");
+    InsertEventData event_data;
+    event_data.start_timestamp = start_timestamp;
+    event_data.end_timestamp = end_timestamp;
+    event_data.payload = std::move(payload);
+    return SerializeRemoteFile(
+        meta, data_type, std::move(event_data), original_size);
+}
+
 // local insert file format
 // -------------------------------------------
 // | Rows(int) | Dimension(int) | InsertData |
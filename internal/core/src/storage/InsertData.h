@@ -46,4 +46,14 @@ class InsertData : public DataCodec {
     std::optional<FieldDataMeta> field_data_meta_;
 };
 
+// a remote insert binlog of the payload of a column of `data_type`, as
+// encoded by a finished payload writer, of `original_size` bytes of values
+std::vector<uint8_t>
+SerializeRemoteInsertFile(const FieldDataMeta& meta,
+                          DataType data_type,
+                          Timestamp start_timestamp,
+                          Timestamp end_timestamp,
+                          std::vector<uint8_t> payload,
+                          int64_t original_size);
+
 }  // namespace milvus::storage
@@ -18,10 +18,16 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/system/error_code.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
 #include <sstream>
+#include <unistd.h>
 
 #include "Exception.h"
+#include "common/Consts.h"
+#include "storage/ThreadPool.h"
 
 #define THROWLOCALERROR(FUNCTION)                                 \
     do {                                                          \
@@ -60,6 +66,7 @@ LocalChunkManager::Size(const std::string& filepath) {
 
 void
 LocalChunkManager::Remove(const std::string& filepath) {
+    EvictFiles(filepath);
     boost::filesystem::path absPath(filepath);
     boost::system::error_code err;
     boost::filesystem::remove(absPath, err);
@@ -68,55 +75,152 @@ LocalChunkManager::Remove(const std::string& filepath) {
     }
 }
 
+namespace {
+
+// reads until `size` bytes or the end of the file, returns the bytes read
 uint64_t
-LocalChunkManager::Read(const std::string& filepath, void* buf, uint64_t size) {
-    return Read(filepath, 0, buf, size);
+PreadFull(int fd,
+          const std::string& filepath,
+          uint64_t offset,
+          void* buf,
+          uint64_t size) {
+    auto dst = reinterpret_cast<char*>(buf);
+    uint64_t total = 0;
+    while (total < size) {
+        auto n = pread(fd, dst + total, size - total, offset + total);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            std::stringstream err_msg;
+            err_msg << "Error: read local file '" << filepath << " failed, "
+                    << strerror(errno);
+            throw ReadFileException(err_msg.str());
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    return total;
 }
 
-uint64_t
-LocalChunkManager::Read(const std::string& filepath,
-                        uint64_t offset,
-                        void* buf,
-                        uint64_t size) {
-    std::ifstream infile;
-    infile.open(filepath.data(), std::ios_base::binary);
-    if (infile.fail()) {
+void
+PwriteFull(int fd,
+           const std::string& filepath,
+           uint64_t offset,
+           const void* buf,
+           uint64_t size) {
+    auto src = reinterpret_cast<const char*>(buf);
+    uint64_t total = 0;
+    while (total < size) {
+        auto n = pwrite(fd, src + total, size - total, offset + total);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            std::stringstream err_msg;
+            err_msg << "Error: write local file '" << filepath << " failed, "
+                    << strerror(n < 0 ? errno : EIO);
+            throw WriteFileException(err_msg.str());
+        }
+        total += n;
+    }
+}
+
+}  // namespace
+
+LocalChunkManager::FileHandle::~FileHandle() {
+    close(fd);
+}
+
+LocalChunkManager::FileHandlePtr
+LocalChunkManager::AcquireFile(const std::string& filepath, bool write) {
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    auto it = file_index_.find(filepath);
+    if (it != file_index_.end()) {
+        if (!write || it->second->second->writable) {
+            files_.splice(files_.begin(), files_, it->second);
+            return files_.front().second;
+        }
+        files_.erase(it->second);
+        file_index_.erase(it);
+    }
+
+    bool writable = true;
+    auto fd = open(filepath.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0 && errno == EACCES && !write) {
+        writable = false;
+        fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0) {
         std::stringstream err_msg;
         err_msg << "Error: open local file '" << filepath << " failed, "
                 << strerror(errno);
         throw OpenFileException(err_msg.str());
     }
 
-    infile.seekg(offset, std::ios::beg);
-    if (!infile.read(reinterpret_cast<char*>(buf), size)) {
-        if (!infile.eof()) {
-            std::stringstream err_msg;
-            err_msg << "Error: read local file '" << filepath << " failed, "
-                    << strerror(errno);
-            throw ReadFileException(err_msg.str());
+    files_.emplace_front(filepath, std::make_shared<FileHandle>(fd, writable));
+    file_index_[filepath] = files_.begin();
+    if (int64_t(files_.size()) > DEFAULT_LOCAL_FILE_HANDLE_CACHE_SIZE) {
+        file_index_.erase(files_.back().first);
+        files_.pop_back();
+    }
+    return files_.front().second;
+}
+
+void
+LocalChunkManager::EvictFiles(const std::string& path) {
+    if (path.empty()) {
+        return;
+    }
+    auto dir = path.back() == '/' ? path : path + "/";
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    for (auto it = files_.begin(); it != files_.end();) {
+        auto& name = it->first;
+        if (name == path || name.compare(0, dir.size(), dir) == 0) {
+            file_index_.erase(name);
+            it = files_.erase(it);
+        } else {
+            ++it;
         }
     }
-    return infile.gcount();
+}
+
+uint64_t
+LocalChunkManager::Read(const std::string& filepath, void* buf, uint64_t size) {
+    return Read(filepath, 0, buf, size);
+}
+
+uint64_t
+LocalChunkManager::Read(const std::string& filepath,
+                        uint64_t offset,
+                        void* buf,
+                        uint64_t size) {
+    auto file = AcquireFile(filepath, false);
+    return PreadFull(file->fd, filepath, offset, buf, size);
 }
 
 void
 LocalChunkManager::Write(const std::string& absPathStr,
                          void* buf,
                          uint64_t size) {
-    std::ofstream outfile;
-    outfile.open(absPathStr.data(), std::ios_base::binary);
-    if (outfile.fail()) {
+    EvictFiles(absPathStr);
+    auto flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    auto fd = open(absPathStr.c_str(), flags, 0644);
+    if (fd < 0) {
         std::stringstream err_msg;
         err_msg << "Error: open local file '" << absPathStr << " failed, "
                 << strerror(errno);
         throw OpenFileException(err_msg.str());
     }
-    if (!outfile.write(reinterpret_cast<char*>(buf), size)) {
-        std::stringstream err_msg;
-        err_msg << "Error: write local file '" << absPathStr << " failed, "
-                << strerror(errno);
-        throw WriteFileException(err_msg.str());
+    try {
+        PwriteFull(fd, absPathStr, 0, buf, size);
+    } catch (...) {
+        close(fd);
+        throw;
     }
+    close(fd);
 }
 
 void
@@ -124,23 +228,84 @@ LocalChunkManager::Write(const std::string& absPathStr,
                          uint64_t offset,
                          void* buf,
                          uint64_t size) {
-    std::ofstream outfile;
-    outfile.open(
-        absPathStr.data(),
-        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
-    if (outfile.fail()) {
-        std::stringstream err_msg;
-        err_msg << "Error: open local file '" << absPathStr << " failed, "
-                << strerror(errno);
-        throw OpenFileException(err_msg.str());
+    auto file = AcquireFile(absPathStr, true);
+    PwriteFull(file->fd, absPathStr, offset, buf, size);
+}
+
+std::future<uint64_t>
+LocalChunkManager::ReadAsync(const std::string& filepath,
+                             uint64_t offset,
+                             void* buf,
+                             uint64_t len) {
+    auto& pool = ThreadPool::GetInstance();
+    return pool.Submit(TaskPriority::HIGH, [=]() {
+        return Read(filepath, offset, buf, len);
+    });
+}
+
+std::future<void>
+LocalChunkManager::WriteAsync(const std::string& filepath,
+                              uint64_t offset,
+                              void* buf,
+                              uint64_t len) {
+    auto& pool = ThreadPool::GetInstance();
+    return pool.Submit(TaskPriority::HIGH, [=]() {
+        Write(filepath, offset, buf, len);
+    });
+}
+
+std::vector<uint64_t>
+LocalChunkManager::ReadBatch(const std::string& filepath,
+                             const std::vector<LocalFileRange>& ranges) {
+    // opened once here, the tasks then share the handle of the table
+    AcquireFile(filepath, false);
+    std::vector<std::future<uint64_t>> futures;
+    futures.reserve(ranges.size());
+    for (auto& range : ranges) {
+        futures.push_back(
+            ReadAsync(filepath, range.offset, range.buf, range.len));
     }
 
-    outfile.seekp(offset, std::ios::beg);
-    if (!outfile.write(reinterpret_cast<char*>(buf), size)) {
-        std::stringstream err_msg;
-        err_msg << "Error: write local file '" << absPathStr << " failed, "
-                << strerror(errno);
-        throw WriteFileException(err_msg.str());
+    std::vector<uint64_t> sizes;
+    sizes.reserve(ranges.size());
+    try {
+        for (auto& future : futures) {
+            sizes.push_back(future.get());
+        }
+    } catch (...) {
+        // the buffers belong to the caller, don't leave tasks behind
+        for (auto& future : futures) {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+        throw;
+    }
+    return sizes;
+}
+
+void
+LocalChunkManager::WriteBatch(const std::string& filepath,
+                              const std::vector<LocalFileRange>& ranges) {
+    AcquireFile(filepath, true);
+    std::vector<std::future<void>> futures;
+    futures.reserve(ranges.size());
+    for (auto& range : ranges) {
+        futures.push_back(
+            WriteAsync(filepath, range.offset, range.buf, range.len));
+    }
+
+    try {
+        for (auto& future : futures) {
+            future.get();
+        }
+    } catch (...) {
+        for (auto& future : futures) {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+        throw;
     }
 }
 
@@ -152,6 +317,7 @@ LocalChunkManager::ListWithPrefix(const std::string& filepath) {
 
 bool
 LocalChunkManager::CreateFile(const std::string& filepath) {
+    EvictFiles(filepath);
     boost::filesystem::path absPath(filepath);
     // if filepath not exists, will create this file automatically
     // ensure upper directory exist firstly
@@ -195,6 +361,7 @@ LocalChunkManager::CreateDir(const std::string& dir) {
 
 void
 LocalChunkManager::RemoveDir(const std::string& dir) {
+    EvictFiles(dir);
     boost::filesystem::path dirPath(dir);
     boost::system::error_code err;
     boost::filesystem::remove_all(dirPath, err);
@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "storage/ChunkManager.h"
@@ -25,9 +29,19 @@
 
 namespace milvus::storage {
 
+// a range of a local file read or written by a batch
+struct LocalFileRange {
+    uint64_t offset;
+    void* buf;
+    uint64_t len;
+};
+
 /**
  * @brief LocalChunkManager is responsible for read and write local file
  * that inherited from ChunkManager
+ * positional reads and writes go through pread/pwrite on a small table of
+ * open files, which only stays coherent for files removed and recreated
+ * through this manager
  */
 class LocalChunkManager : public ChunkManager {
  private:
@@ -94,6 +108,34 @@ class LocalChunkManager : public ChunkManager {
           void* buf,
           uint64_t len);
 
+    /**
+     * @brief Read/Write a range of a file on the shared thread pool,
+     *  `buf` must stay valid until the returned future is ready
+     */
+    std::future<uint64_t>
+    ReadAsync(const std::string& filepath,
+              uint64_t offset,
+              void* buf,
+              uint64_t len);
+
+    std::future<void>
+    WriteAsync(const std::string& filepath,
+               uint64_t offset,
+               void* buf,
+               uint64_t len);
+
+    /**
+     * @brief Read/Write the ranges of a file concurrently and wait for
+     *  all of them, returns the bytes read of each range
+     */
+    std::vector<uint64_t>
+    ReadBatch(const std::string& filepath,
+              const std::vector<LocalFileRange>& ranges);
+
+    void
+    WriteBatch(const std::string& filepath,
+               const std::vector<LocalFileRange>& ranges);
+
     virtual std::vector<std::string>
     ListWithPrefix(const std::string& filepath);
 
@@ -147,8 +189,34 @@ class LocalChunkManager : public ChunkManager {
     int64_t
     GetSizeOfDir(const std::string& dir);
 
+ private:
+    struct FileHandle {
+        FileHandle(int fd, bool writable) : fd(fd), writable(writable) {
+        }
+        ~FileHandle();
+
+        int fd;
+        bool writable;
+    };
+    using FileHandlePtr = std::shared_ptr<FileHandle>;
+    using FileList = std::list<std::pair<std::string, FileHandlePtr>>;
+
+    // an open file of the table, reopened for writing if it was opened read
+    // only, the handle stays valid for the caller if it gets evicted
+    FileHandlePtr
+    AcquireFile(const std::string& filepath, bool write);
+
+    // drops the open files of a path, or of the files under a dir
+    void
+    EvictFiles(const std::string& path);
+
  private:
     std::string path_prefix_;
+
+    std::mutex files_mutex_;
+    // most recently used first
+    FileList files_;
+    std::unordered_map<std::string, FileList::iterator> file_index_;
 };
 
 using LocalChunkManagerSPtr =
@@ -19,6 +19,7 @@
 #include <aws/core/auth/AWSCredentials.h>
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/core/auth/STSCredentialsProvider.h>
+#include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/s3/model/CreateBucketRequest.h>
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
@@ -32,6 +33,9 @@
 
 #include "storage/AliyunSTSClient.h"
 #include "storage/AliyunCredentialsProvider.h"
+#include "storage/ThreadPool.h"
+#include "common/Consts.h"
+#include "config/ConfigChunkManager.h"
 #include "exceptions/EasyAssert.h"
 #include "log/Log.h"
 
@@ -47,6 +51,7 @@
 #define S3NoSuchBucket "NoSuchBucket"
 namespace milvus::storage {
 
+Aws::SDKOptions MinioChunkManager::sdk_options_;
 std::atomic<size_t> MinioChunkManager::init_count_(0);
 std::mutex MinioChunkManager::client_mutex_;
 
@@ -202,13 +207,20 @@ MinioChunkManager::MinioChunkManager(const StorageConfig& storage_config)
         config.verifySSL = false;
     }
 
-    if (storageType == RemoteStorageType::S3) {
-        BuildS3Client(storage_config, config);
-    } else if (storageType == RemoteStorageType::ALIYUN_CLOUD) {
-        BuildAliyunCloudClient(storage_config, config);
-    } else if (storageType == RemoteStorageType::GOOGLE_CLOUD) {
-        BuildGoogleCloudClient(storage_config, config);
-    }
+    client_ = S3ClientRegistry::GetInstance().GetOrCreate(
+        storage_config,
+        storageType,
+        config,
+        [&](const Aws::Client::ClientConfiguration& client_config) {
+            if (storageType == RemoteStorageType::S3) {
+                BuildS3Client(storage_config, client_config);
+            } else if (storageType == RemoteStorageType::ALIYUN_CLOUD) {
+                BuildAliyunCloudClient(storage_config, client_config);
+            } else if (storageType == RemoteStorageType::GOOGLE_CLOUD) {
+                BuildGoogleCloudClient(storage_config, client_config);
+            }
+            return client_;
+        });
 
     LOG_SEGCORE_INFO_ << "init MinioChunkManager with parameter[endpoint: '"
                       << storage_config.address << "', default_bucket_name:'"
@@ -216,6 +228,65 @@ MinioChunkManager::MinioChunkManager(const StorageConfig& storage_config)
                       << std::boolalpha << storage_config.useSSL << "']";
 }
 
+std::string
+S3ClientRegistry::Key(const StorageConfig& storage_config) {
+    std::stringstream key;
+    key << storage_config.address << '\n'
+        << storage_config.bucket_name << '\n'
+        << storage_config.access_key_id << '\n'
+        << storage_config.access_key_value << '\n'
+        << storage_config.iam_endpoint << '\n'
+        << storage_config.useSSL << storage_config.useIAM;
+    return key.str();
+}
+
+S3ClientRegistry::ClientPtr
+S3ClientRegistry::GetOrCreate(const StorageConfig& storage_config,
+                              RemoteStorageType type,
+                              Aws::Client::ClientConfiguration config,
+                              const ClientBuilder& build) {
+    auto key = Key(storage_config);
+    // the client is built under the lock, the credentials of a key are
+    // fetched once however many managers of it are created together
+    std::lock_guard lck(mutex_);
+    auto it = clients_.find(key);
+    if (it != clients_.end()) {
+        return it->second;
+    }
+
+    config.maxConnections = ChunkMangerConfig::GetRemoteMaxConnections();
+    auto keep_alive_ms = ChunkMangerConfig::GetRemoteKeepAliveMs();
+    config.enableTcpKeepAlive = keep_alive_ms > 0;
+    if (keep_alive_ms > 0) {
+        config.tcpKeepAliveIntervalMs = keep_alive_ms;
+    }
+    auto client = build(config);
+    if (clients_.empty()) {
+        MinioChunkManager::InitSDKAPI(type);
+    }
+    clients_.emplace(key, client);
+    return client;
+}
+
+size_t
+S3ClientRegistry::Size() {
+    std::lock_guard lck(mutex_);
+    return clients_.size();
+}
+
+void
+S3ClientRegistry::Clear() {
+    std::unordered_map<std::string, ClientPtr> clients;
+    {
+        std::lock_guard lck(mutex_);
+        clients.swap(clients_);
+    }
+    if (!clients.empty()) {
+        clients.clear();
+        MinioChunkManager::ShutdownSDKAPI();
+    }
+}
+
 MinioChunkManager::~MinioChunkManager() {
     client_.reset();
     ShutdownSDKAPI();
@@ -249,9 +320,101 @@ MinioChunkManager::Read(const std::string& filepath, void* buf, uint64_t size) {
                 << "') not exists";
         throw ObjectNotExistException(err_msg.str());
     }
+    // large objects are fetched by concurrent ranged GETs, a single stream
+    // can't saturate the network
+    if (size >= 2 * DEFAULT_REMOTE_READ_RANGE_SIZE) {
+        return ReadRanges(filepath,
+                          buf,
+                          size,
+                          DEFAULT_REMOTE_READ_RANGE_SIZE,
+                          DEFAULT_REMOTE_READ_MAX_INFLIGHT);
+    }
     return GetObjectBuffer(default_bucket_name_, filepath, buf, size);
 }
 
+uint64_t
+MinioChunkManager::Read(const std::string& filepath,
+                        uint64_t offset,
+                        void* buf,
+                        uint64_t size) {
+    return GetObjectBuffer(default_bucket_name_, filepath, offset, buf, size);
+}
+
+uint64_t
+MinioChunkManager::ReadRanges(const std::string& filepath,
+                              void* buf,
+                              uint64_t size,
+                              uint64_t range_size,
+                              int64_t max_inflight,
+                              const RangeCallback& on_range) {
+    AssertInfo(range_size > 0, "range size must be positive");
+    auto num_ranges = int64_t((size + range_size - 1) / range_size);
+    std::atomic<int64_t> next_range = 0;
+    std::atomic<bool> failed = false;
+    auto fetch = [&]() {
+        while (!failed) {
+            auto range = next_range.fetch_add(1);
+            if (range >= num_ranges) {
+                break;
+            }
+            auto offset = range * range_size;
+            auto len = std::min(range_size, size - offset);
+            try {
+                auto received =
+                    GetObjectBuffer(default_bucket_name_,
+                                    filepath,
+                                    offset,
+                                    static_cast<char*>(buf) + offset,
+                                    len);
+                // a short response leaves a part of the buffer unfilled
+                if (received != len) {
+                    std::stringstream err_msg;
+                    err_msg << "ranged read of object('"
+                            << default_bucket_name_ << "', " << filepath
+                            << ") at " << offset << " got " << received
+                            << " bytes, expected " << len;
+                    throw S3ErrorException(err_msg.str());
+                }
+                if (on_range) {
+                    on_range(offset, len);
+                }
+            } catch (...) {
+                failed = true;
+                throw;
+            }
+        }
+    };
+
+    // the calling thread fetches ranges as well, so the read makes progress
+    // even when all the workers of the pool are busy
+    auto& pool = ThreadPool::GetInstance();
+    auto num_workers = std::min<int64_t>(max_inflight, num_ranges) - 1;
+    std::vector<std::future<void>> futures;
+    for (int64_t i = 0; i < num_workers; ++i) {
+        futures.push_back(pool.Submit(fetch));
+    }
+    std::exception_ptr error;
+    try {
+        fetch();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // wait all the workers before leaving, they reference the buffer
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return size;
+}
+
 void
 MinioChunkManager::Write(const std::string& filepath,
                          void* buf,
@@ -398,10 +561,12 @@ MinioChunkManager::PutObjectBuffer(const std::string& bucket_name,
     request.SetBucket(bucket_name.c_str());
     request.SetKey(object_name.c_str());
 
+    // the body streams straight from the caller's buffer instead of a
+    // copy of it, `buf` outlives the request since PutObject is blocking
+    Aws::Utils::Stream::PreallocatedStreamBuf stream_buf(
+        reinterpret_cast<unsigned char*>(buf), size);
     const std::shared_ptr<Aws::IOStream> input_data =
-        Aws::MakeShared<Aws::StringStream>("");
-
-    input_data->write(reinterpret_cast<char*>(buf), size);
+        Aws::MakeShared<Aws::IOStream>("", &stream_buf);
     request.SetBody(input_data);
 
     auto outcome = client_->PutObject(request);
@@ -435,6 +600,36 @@ MinioChunkManager::GetObjectBuffer(const std::string& bucket_name,
     return size;
 }
 
+uint64_t
+MinioChunkManager::GetObjectBuffer(const std::string& bucket_name,
+                                   const std::string& object_name,
+                                   uint64_t offset,
+                                   void* buf,
+                                   uint64_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    Aws::S3::Model::GetObjectRequest request;
+    request.SetBucket(bucket_name.c_str());
+    request.SetKey(object_name.c_str());
+    request.SetRange(("bytes=" + std::to_string(offset) + "-" +
+                      std::to_string(offset + size - 1))
+                         .c_str());
+
+    request.SetResponseStreamFactory([buf, size]() {
+        std::unique_ptr<Aws::StringStream> stream(
+            Aws::New<Aws::StringStream>(""));
+        stream->rdbuf()->pubsetbuf(static_cast<char*>(buf), size);
+        return stream.release();
+    });
+    auto outcome = client_->GetObject(request);
+
+    if (!outcome.IsSuccess()) {
+        THROWS3ERROR(GetObjectBuffer);
+    }
+    return outcome.GetResult().GetContentLength();
+}
+
 std::vector<std::string>
 MinioChunkManager::ListObjects(const char* bucket_name, const char* prefix) {
     std::vector<std::string> objects_vec;
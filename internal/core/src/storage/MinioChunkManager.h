@@ -30,9 +30,12 @@
 #include <google/cloud/storage/oauth2/compute_engine_credentials.h>
 #include <google/cloud/storage/oauth2/google_credentials.h>
 #include <google/cloud/status_or.h>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "config/ConfigChunkManager.h"
@@ -68,10 +71,7 @@ class MinioChunkManager : public RemoteChunkManager {
     Read(const std::string& filepath,
          uint64_t offset,
          void* buf,
-         uint64_t len) {
-        throw NotImplementedException(GetName() +
-                                      "Read with offset not implement");
-    }
+         uint64_t len);
 
     virtual void
     Write(const std::string& filepath,
@@ -88,6 +88,14 @@ class MinioChunkManager : public RemoteChunkManager {
     virtual void
     Write(const std::string& filepath, void* buf, uint64_t len);
 
+    virtual uint64_t
+    ReadRanges(const std::string& filepath,
+               void* buf,
+               uint64_t len,
+               uint64_t range_size,
+               int64_t max_inflight,
+               const RangeCallback& on_range = nullptr);
+
     virtual std::vector<std::string>
     ListWithPrefix(const std::string& filepath);
 
@@ -141,11 +149,18 @@ class MinioChunkManager : public RemoteChunkManager {
                     const std::string& object_name,
                     void* buf,
                     uint64_t size);
+    // ranged GET of [offset, offset + size)
+    uint64_t
+    GetObjectBuffer(const std::string& bucket_name,
+                    const std::string& object_name,
+                    uint64_t offset,
+                    void* buf,
+                    uint64_t size);
     std::vector<std::string>
     ListObjects(const char* bucket_name, const char* prefix = nullptr);
-    void
+    static void
     InitSDKAPI(RemoteStorageType type);
-    void
+    static void
     ShutdownSDKAPI();
     void
     BuildS3Client(const StorageConfig& storage_config,
@@ -158,7 +173,7 @@ class MinioChunkManager : public RemoteChunkManager {
                            const Aws::Client::ClientConfiguration& config);
 
  private:
-    Aws::SDKOptions sdk_options_;
+    static Aws::SDKOptions sdk_options_;
     static std::atomic<size_t> init_count_;
     static std::mutex client_mutex_;
     std::shared_ptr<Aws::S3::S3Client> client_;
@@ -167,6 +182,50 @@ class MinioChunkManager : public RemoteChunkManager {
 
 using MinioChunkManagerPtr = std::unique_ptr<MinioChunkManager>;
 
+/**
+ * @brief Process wide S3 clients, shared by the MinioChunkManagers of the
+ * same endpoint, bucket and credentials, so short lived managers reuse the
+ * connection pool of the client, and the credentials its IAM or STS
+ * provider already fetched, instead of building their own. The registry
+ * keeps the SDK initialized as long as it holds a client.
+ */
+class S3ClientRegistry {
+ public:
+    using ClientPtr = std::shared_ptr<Aws::S3::S3Client>;
+    using ClientBuilder =
+        std::function<ClientPtr(const Aws::Client::ClientConfiguration&)>;
+
+    static S3ClientRegistry&
+    GetInstance() {
+        static S3ClientRegistry instance;
+        return instance;
+    }
+
+    // the client of `storage_config`, built by `build` with the connection
+    // options of ChunkMangerConfig if there is none
+    ClientPtr
+    GetOrCreate(const StorageConfig& storage_config,
+                RemoteStorageType type,
+                Aws::Client::ClientConfiguration config,
+                const ClientBuilder& build);
+
+    size_t
+    Size();
+
+    // drops the clients, those still used by managers live with them
+    void
+    Clear();
+
+ private:
+    S3ClientRegistry() = default;
+
+    static std::string
+    Key(const StorageConfig& storage_config);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, ClientPtr> clients_;
+};
+
 static const char* GOOGLE_CLIENT_FACTORY_ALLOCATION_TAG =
     "GoogleHttpClientFactory";
 
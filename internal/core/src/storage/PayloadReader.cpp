@@ -15,15 +15,26 @@
 // limitations under the License.
 
 #include "storage/PayloadReader.h"
+
+#include <arrow/array/concatenate.h>
+#include <parquet/file_reader.h>
+#include <cstring>
+#include <future>
+#include <string>
+
+#include "common/Consts.h"
+#include "common/FieldMeta.h"
 #include "exceptions/EasyAssert.h"
 #include "storage/FieldDataFactory.h"
+#include "storage/ThreadPool.h"
 #include "storage/Util.h"
 
 namespace milvus::storage {
-PayloadReader::PayloadReader(std::shared_ptr<PayloadInputStream> input,
-                             DataType data_type)
+PayloadReader::PayloadReader(std::shared_ptr<arrow::io::RandomAccessFile> input,
+                             DataType data_type,
+                             const std::vector<int>& row_groups)
     : column_type_(data_type) {
-    init(input);
+    init(input, row_groups);
 }
 
 PayloadReader::PayloadReader(const uint8_t* data,
@@ -35,20 +46,35 @@ PayloadReader::PayloadReader(const uint8_t* data,
 }
 
 void
-PayloadReader::init(std::shared_ptr<PayloadInputStream> input) {
+PayloadReader::init(std::shared_ptr<arrow::io::RandomAccessFile> input,
+                    const std::vector<int>& row_groups) {
     auto mem_pool = arrow::default_memory_pool();
-    // TODO :: Stream read file data, avoid copying
     std::unique_ptr<parquet::arrow::FileReader> reader;
     auto st = parquet::arrow::OpenFile(input, mem_pool, &reader);
     AssertInfo(st.ok(), "failed to get arrow file reader");
     std::shared_ptr<arrow::Table> table;
-    st = reader->ReadTable(&table);
+    if (row_groups.empty()) {
+        st = reader->ReadTable(&table);
+    } else {
+        for (auto row_group : row_groups) {
+            AssertInfo(row_group >= 0 && row_group < reader->num_row_groups(),
+                       "row group " + std::to_string(row_group) +
+                           " out of range");
+        }
+        // a payload has a single column
+        st = reader->ReadRowGroups(row_groups, {0}, &table);
+    }
     AssertInfo(st.ok(), "failed to get reader data to arrow table");
     auto column = table->column(0);
     AssertInfo(column != nullptr, "returned arrow column is null");
-    AssertInfo(column->chunks().size() == 1,
-               "arrow chunk size in arrow column should be 1");
-    auto array = column->chunk(0);
+    std::shared_ptr<arrow::Array> array;
+    if (column->num_chunks() == 1) {
+        array = column->chunk(0);
+    } else {
+        auto res = arrow::Concatenate(column->chunks(), mem_pool);
+        AssertInfo(res.ok(), "failed to concatenate arrow chunks");
+        array = res.ValueOrDie();
+    }
     AssertInfo(array != nullptr, "empty arrow array of PayloadReader");
     dim_ = datatype_is_vector(column_type_)
                ? GetDimensionFromArrowArray(array, column_type_)
@@ -58,4 +84,178 @@ PayloadReader::init(std::shared_ptr<PayloadInputStream> input) {
     field_data_->FillFieldData(array);
 }
 
+namespace {
+
+// reads `rows` values of a column straight into `dst`, the physical type
+// of the column matches T
+template <typename ColumnReader, typename T>
+void
+ReadValuesInto(parquet::ColumnReader* column, int64_t rows, T* dst) {
+    auto reader = static_cast<ColumnReader*>(column);
+    // payload columns are nullable in the schema, but never hold nulls
+    std::vector<int16_t> def_levels(
+        std::min(rows, PAYLOAD_DECODE_BATCH_ROWS));
+    int64_t read = 0;
+    while (read < rows && reader->HasNext()) {
+        int64_t values_read = 0;
+        auto levels = reader->ReadBatch(
+            std::min<int64_t>(rows - read, def_levels.size()),
+            def_levels.data(),
+            nullptr,
+            dst + read,
+            &values_read);
+        AssertInfo(values_read == levels, "null values in a payload");
+        read += values_read;
+    }
+    AssertInfo(read == rows, "payload has less rows than its metadata");
+}
+
+void
+ReadFixedWidthInto(parquet::ColumnReader* column,
+                   int64_t rows,
+                   int64_t row_bytes,
+                   uint8_t* dst) {
+    auto reader = static_cast<parquet::FixedLenByteArrayReader*>(column);
+    auto batch_rows = std::min(rows, PAYLOAD_DECODE_BATCH_ROWS);
+    std::vector<int16_t> def_levels(batch_rows);
+    std::vector<parquet::FixedLenByteArray> values(batch_rows);
+    int64_t read = 0;
+    while (read < rows && reader->HasNext()) {
+        int64_t values_read = 0;
+        auto levels = reader->ReadBatch(std::min(rows - read, batch_rows),
+                                        def_levels.data(),
+                                        nullptr,
+                                        values.data(),
+                                        &values_read);
+        AssertInfo(values_read == levels, "null values in a payload");
+        // the values point into the decoded page
+        for (int64_t i = 0; i < values_read; ++i) {
+            memcpy(dst + (read + i) * row_bytes, values[i].ptr, row_bytes);
+        }
+        read += values_read;
+    }
+    AssertInfo(read == rows, "payload has less rows than its metadata");
+}
+
+void
+ReadPayloadInto(parquet::ParquetFileReader* reader,
+                DataType data_type,
+                int64_t row_bytes,
+                uint8_t* dst) {
+    for (int i = 0; i < reader->metadata()->num_row_groups(); ++i) {
+        auto row_group = reader->RowGroup(i);
+        auto rows = row_group->metadata()->num_rows();
+        auto column = row_group->Column(0);
+        switch (data_type) {
+            case DataType::INT32:
+                ReadValuesInto<parquet::Int32Reader>(
+                    column.get(), rows, reinterpret_cast<int32_t*>(dst));
+                break;
+            case DataType::INT64:
+                ReadValuesInto<parquet::Int64Reader>(
+                    column.get(), rows, reinterpret_cast<int64_t*>(dst));
+                break;
+            case DataType::FLOAT:
+                ReadValuesInto<parquet::FloatReader>(
+                    column.get(), rows, reinterpret_cast<float*>(dst));
+                break;
+            case DataType::DOUBLE:
+                ReadValuesInto<parquet::DoubleReader>(
+                    column.get(), rows, reinterpret_cast<double*>(dst));
+                break;
+            case DataType::VECTOR_FLOAT:
+            case DataType::VECTOR_BINARY:
+                ReadFixedWidthInto(column.get(), rows, row_bytes, dst);
+                break;
+            default:
+                PanicInfo("payload of " + datatype_name(data_type) +
+                          " can't be decoded in place");
+        }
+        dst += rows * row_bytes;
+    }
+}
+
+}  // namespace
+
+int64_t
+GetPayloadRows(std::shared_ptr<arrow::io::RandomAccessFile> input) {
+    return parquet::ParquetFileReader::Open(input)->metadata()->num_rows();
+}
+
+int64_t
+ReadPayloadsInto(
+    const std::vector<std::shared_ptr<arrow::io::RandomAccessFile>>& inputs,
+    DataType data_type,
+    int dim,
+    void* dst,
+    int64_t capacity) {
+    switch (data_type) {
+        case DataType::INT32:
+        case DataType::INT64:
+        case DataType::FLOAT:
+        case DataType::DOUBLE:
+        case DataType::VECTOR_FLOAT:
+        case DataType::VECTOR_BINARY:
+            break;
+        default:
+            PanicInfo("payload of " + datatype_name(data_type) +
+                      " can't be decoded in place");
+    }
+    int64_t row_bytes = datatype_sizeof(data_type, dim);
+
+    // the footers come first, the offset of a payload depends on the rows
+    // of the ones before it
+    auto& pool = ThreadPool::GetInstance();
+    std::vector<std::future<std::unique_ptr<parquet::ParquetFileReader>>>
+        opens;
+    std::vector<std::unique_ptr<parquet::ParquetFileReader>> readers;
+    std::vector<std::future<void>> decodes;
+    int64_t rows = 0;
+    try {
+        for (auto& input : inputs) {
+            opens.push_back(pool.Submit(
+                TaskPriority::HIGH,
+                [](std::shared_ptr<arrow::io::RandomAccessFile> input) {
+                    return parquet::ParquetFileReader::Open(input);
+                },
+                input));
+        }
+        for (auto& open : opens) {
+            readers.push_back(open.get());
+        }
+
+        auto begin = static_cast<uint8_t*>(dst);
+        for (auto& reader : readers) {
+            auto payload_rows = reader->metadata()->num_rows();
+            AssertInfo(rows + payload_rows <= capacity,
+                       "payloads have more than " + std::to_string(capacity) +
+                           " rows");
+            decodes.push_back(pool.Submit(TaskPriority::HIGH,
+                                          ReadPayloadInto,
+                                          reader.get(),
+                                          data_type,
+                                          row_bytes,
+                                          begin + rows * row_bytes));
+            rows += payload_rows;
+        }
+        for (auto& decode : decodes) {
+            decode.get();
+        }
+    } catch (...) {
+        // the tasks still use the readers and the destination
+        for (auto& open : opens) {
+            if (open.valid()) {
+                open.wait();
+            }
+        }
+        for (auto& decode : decodes) {
+            if (decode.valid()) {
+                decode.wait();
+            }
+        }
+        throw;
+    }
+    return rows;
+}
+
 }  // namespace milvus::storage
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <parquet/arrow/reader.h>
 
 #include "storage/PayloadStream.h"
@@ -26,15 +27,20 @@ namespace milvus::storage {
 
 class PayloadReader {
  public:
-    explicit PayloadReader(std::shared_ptr<PayloadInputStream> input,
-                           DataType data_type);
+    // `row_groups` selects the parquet row groups to decode, all of them if
+    // empty; with a RemoteInputStream only the footer and the column chunks
+    // of the selected row groups are fetched
+    explicit PayloadReader(std::shared_ptr<arrow::io::RandomAccessFile> input,
+                           DataType data_type,
+                           const std::vector<int>& row_groups = {});
 
     explicit PayloadReader(const uint8_t* data, int length, DataType data_type);
 
     ~PayloadReader() = default;
 
     void
-    init(std::shared_ptr<PayloadInputStream> input);
+    init(std::shared_ptr<arrow::io::RandomAccessFile> input,
+         const std::vector<int>& row_groups = {});
 
     const FieldDataPtr
     get_field_data() const {
@@ -47,4 +53,20 @@ class PayloadReader {
     FieldDataPtr field_data_;
 };
 
+// rows of a payload, only its footer is decoded
+int64_t
+GetPayloadRows(std::shared_ptr<arrow::io::RandomAccessFile> input);
+
+// decodes the payloads of one fixed width field concurrently on the shared
+// pool straight into `dst`, without building arrow arrays or field data.
+// The rows of a payload follow the rows of the payloads before it, `dst`
+// has room for `capacity` rows. Returns the rows decoded.
+int64_t
+ReadPayloadsInto(
+    const std::vector<std::shared_ptr<arrow::io::RandomAccessFile>>& inputs,
+    DataType data_type,
+    int dim,
+    void* dst,
+    int64_t capacity);
+
 }  // namespace milvus::storage
@@ -121,4 +121,99 @@ PayloadInputStream::GetSize() {
     return arrow::Result<int64_t>(size_);
 }
 
+RemoteInputStream::RemoteInputStream(RemoteChunkManager* chunk_manager,
+                                     const std::string& filepath,
+                                     int64_t offset,
+                                     int64_t size)
+    : chunk_manager_(chunk_manager),
+      filepath_(filepath),
+      offset_(offset),
+      size_(size),
+      tell_(0),
+      closed_(false) {
+    AssertInfo(chunk_manager_ != nullptr, "null remote chunk manager");
+    AssertInfo(offset_ >= 0 && size_ >= 0, "invalid remote range");
+}
+
+RemoteInputStream::~RemoteInputStream() noexcept {
+}
+
+arrow::Status
+RemoteInputStream::Close() {
+    closed_ = true;
+    return arrow::Status::OK();
+}
+
+bool
+RemoteInputStream::closed() const {
+    return closed_;
+}
+
+arrow::Result<int64_t>
+RemoteInputStream::Tell() const {
+    return arrow::Result<int64_t>(tell_);
+}
+
+arrow::Status
+RemoteInputStream::Seek(int64_t position) {
+    if (position < 0 || position > size_)
+        return arrow::Status::IOError("invalid position");
+    tell_ = position;
+    return arrow::Status::OK();
+}
+
+arrow::Result<int64_t>
+RemoteInputStream::Read(int64_t nbytes, void* out) {
+    auto res = ReadAt(tell_, nbytes, out);
+    if (res.ok()) {
+        tell_ += res.ValueUnsafe();
+    }
+    return res;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+RemoteInputStream::Read(int64_t nbytes) {
+    auto res = ReadAt(tell_, nbytes);
+    if (res.ok()) {
+        tell_ += res.ValueUnsafe()->size();
+    }
+    return res;
+}
+
+arrow::Result<int64_t>
+RemoteInputStream::ReadAt(int64_t position, int64_t nbytes, void* out) {
+    if (closed_)
+        return arrow::Status::IOError("read from closed stream");
+    if (position < 0 || position > size_)
+        return arrow::Status::IOError("invalid position");
+    nbytes = std::min(nbytes, size_ - position);
+    if (nbytes <= 0)
+        return arrow::Result<int64_t>(0);
+    try {
+        chunk_manager_->Read(filepath_, offset_ + position, out, nbytes);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError("read remote file ",
+                                      filepath_,
+                                      " failed, ",
+                                      e.what());
+    }
+    return arrow::Result<int64_t>(nbytes);
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+RemoteInputStream::ReadAt(int64_t position, int64_t nbytes) {
+    if (position >= 0 && position <= size_)
+        nbytes = std::min(nbytes, size_ - position);
+    ARROW_ASSIGN_OR_RAISE(auto buf,
+                          arrow::AllocateBuffer(std::max<int64_t>(nbytes, 0)));
+    ARROW_ASSIGN_OR_RAISE(auto n, ReadAt(position, nbytes, buf->mutable_data()));
+    AssertInfo(n == buf->size(), "short read of remote file");
+    return std::shared_ptr<arrow::Buffer>(std::move(buf));
+}
+
+arrow::Result<int64_t>
+RemoteInputStream::GetSize() {
+    return arrow::Result<int64_t>(size_);
+}
+
 }  // namespace milvus::storage
@@ -18,10 +18,12 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 #include <arrow/api.h>
 #include <arrow/io/api.h>
 
+#include "storage/ChunkManager.h"
 #include "storage/Types.h"
 
 namespace milvus::storage {
@@ -88,4 +90,43 @@ class PayloadInputStream : public arrow::io::RandomAccessFile {
     bool closed_;
 };
 
+// Random access to [offset, offset + size) of a remote object, every read
+// is a ranged read of the chunk manager, so parquet only fetches the footer
+// and the column chunks it decodes instead of the whole object
+class RemoteInputStream : public arrow::io::RandomAccessFile {
+ public:
+    RemoteInputStream(RemoteChunkManager* chunk_manager,
+                      const std::string& filepath,
+                      int64_t offset,
+                      int64_t size);
+    ~RemoteInputStream() noexcept;
+
+    arrow::Status
+    Close() override;
+    arrow::Result<int64_t>
+    Tell() const override;
+    bool
+    closed() const override;
+    arrow::Status
+    Seek(int64_t position) override;
+    arrow::Result<int64_t>
+    Read(int64_t nbytes, void* out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>>
+    Read(int64_t nbytes) override;
+    arrow::Result<int64_t>
+    ReadAt(int64_t position, int64_t nbytes, void* out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>>
+    ReadAt(int64_t position, int64_t nbytes) override;
+    arrow::Result<int64_t>
+    GetSize() override;
+
+ private:
+    RemoteChunkManager* chunk_manager_;
+    const std::string filepath_;
+    const int64_t offset_;
+    const int64_t size_;
+    int64_t tell_;
+    bool closed_;
+};
+
 }  // namespace milvus::storage
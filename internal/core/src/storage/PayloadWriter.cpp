@@ -15,12 +15,62 @@
 // limitations under the License.
 
 #include "storage/PayloadWriter.h"
+
+#include <algorithm>
+
 #include "exceptions/EasyAssert.h"
 #include "common/FieldMeta.h"
 #include "storage/Util.h"
 
 namespace milvus::storage {
 
+namespace {
+
+template <typename ArrayType>
+bool
+IsSorted(const arrow::Array& array) {
+    auto& values = static_cast<const ArrayType&>(array);
+    auto begin = values.raw_values();
+    return values.null_count() == 0 &&
+           std::is_sorted(begin, begin + values.length());
+}
+
+}  // namespace
+
+PayloadEncodingPolicy
+GetDefaultEncodingPolicy(DataType column_type, const arrow::Array& array) {
+    PayloadEncodingPolicy policy;
+    switch (column_type) {
+        case DataType::INT32:
+        case DataType::INT64: {
+            auto sorted = column_type == DataType::INT32
+                              ? IsSorted<arrow::Int32Array>(array)
+                              : IsSorted<arrow::Int64Array>(array);
+            if (sorted) {
+                policy.dictionary = false;
+                policy.encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+            }
+            break;
+        }
+        case DataType::ARRAY:
+        case DataType::JSON: {
+            // rarely repeated, a dictionary is only built to be dropped
+            policy.dictionary = false;
+            break;
+        }
+        case DataType::VECTOR_FLOAT:
+        case DataType::VECTOR_BINARY: {
+            // next to incompressible, compressing only slows down decoding
+            policy.dictionary = false;
+            policy.compression = arrow::Compression::UNCOMPRESSED;
+            break;
+        }
+        default:
+            break;
+    }
+    return policy;
+}
+
 // create payload writer for numeric data type
 PayloadWriter::PayloadWriter(const DataType column_type)
     : column_type_(column_type) {
@@ -77,6 +127,12 @@ PayloadWriter::add_payload(const Payload& raw_data) {
     rows_.fetch_add(raw_data.rows);
 }
 
+void
+PayloadWriter::set_encoding_policy(const PayloadEncodingPolicy& policy) {
+    AssertInfo(output_ == nullptr, "payload writer has been finished");
+    encoding_policy_ = policy;
+}
+
 void
 PayloadWriter::finish() {
     AssertInfo(output_ == nullptr, "payload writer has been finished");
@@ -84,17 +140,23 @@ PayloadWriter::finish() {
     auto ast = builder_->Finish(&array);
     AssertInfo(ast.ok(), ast.ToString());
 
+    auto policy = encoding_policy_.value_or(
+        GetDefaultEncodingPolicy(column_type_, *array));
+    parquet::WriterProperties::Builder properties;
+    properties.compression(policy.compression);
+    if (policy.compression != arrow::Compression::UNCOMPRESSED) {
+        properties.compression_level(policy.compression_level);
+    }
+    if (!policy.dictionary) {
+        properties.disable_dictionary();
+        properties.encoding(policy.encoding);
+    }
+
     auto table = arrow::Table::Make(schema_, {array});
     output_ = std::make_shared<storage::PayloadOutputStream>();
     auto mem_pool = arrow::default_memory_pool();
-    ast = parquet::arrow::WriteTable(*table,
-                                     mem_pool,
-                                     output_,
-                                     1024 * 1024 * 1024,
-                                     parquet::WriterProperties::Builder()
-                                         .compression(arrow::Compression::ZSTD)
-                                         ->compression_level(3)
-                                         ->build());
+    ast = parquet::arrow::WriteTable(
+        *table, mem_pool, output_, 1024 * 1024 * 1024, properties.build());
     AssertInfo(ast.ok(), ast.ToString());
 }
 
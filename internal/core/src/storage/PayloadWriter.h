@@ -23,6 +23,23 @@
 #include <parquet/arrow/writer.h>
 
 namespace milvus::storage {
+
+// how the column of a payload is encoded and compressed
+struct PayloadEncodingPolicy {
+    arrow::Compression::type compression = arrow::Compression::ZSTD;
+    int compression_level = 3;
+    // a dictionary falls back to plain encoding once it grows too large,
+    // `encoding` only applies without one
+    bool dictionary = true;
+    parquet::Encoding::type encoding = parquet::Encoding::PLAIN;
+};
+
+// the policy a payload writer uses unless told otherwise, `array` is the
+// column to write, sorted int columns such as timestamps and auto ids are
+// delta encoded
+PayloadEncodingPolicy
+GetDefaultEncodingPolicy(DataType column_type, const arrow::Array& array);
+
 class PayloadWriter {
  public:
     explicit PayloadWriter(const DataType column_type);
@@ -38,6 +55,10 @@ class PayloadWriter {
     void
     add_one_binary_payload(const uint8_t* data, int length);
 
+    // replaces the default policy of the column type, before finish
+    void
+    set_encoding_policy(const PayloadEncodingPolicy& policy);
+
     void
     finish();
 
@@ -63,5 +84,6 @@ class PayloadWriter {
     std::shared_ptr<PayloadOutputStream> output_;
     std::atomic<int> rows_ = 0;
     std::optional<int> dimension_;  // binary vector, float vector
+    std::optional<PayloadEncodingPolicy> encoding_policy_;
 };
 }  // namespace milvus::storage
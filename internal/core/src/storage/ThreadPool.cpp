@@ -14,25 +14,207 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #include "ThreadPool.h"
 
+#include <algorithm>
+
+#include "common/Metrics.h"
+#include "common/Numa.h"
+#include "exceptions/EasyAssert.h"
+
 namespace milvus {
 
+namespace {
+// the pool and the queue of the worker running on this thread
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+}  // namespace
+
 void
-ThreadPool::Init() {
-    for (int i = 0; i < threads_.size(); i++) {
-        threads_[i] = std::thread(Worker(this, i));
+ThreadPool::Init(int64_t thread_num) {
+    thread_num = std::max<int64_t>(thread_num, 1);
+    for (int64_t i = 0; i < thread_num; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (auto& injected : injected_) {
+        injected = std::make_unique<MpmcQueue<Task>>(INJECT_QUEUE_CAPACITY);
+    }
+    for (int64_t i = 0; i < thread_num; ++i) {
+        threads_.emplace_back([this, i]() { Run(i); });
     }
 }
 
+ThreadPool&
+ThreadPool::GetNodeInstance(int node) {
+    static std::mutex mutex;
+    static std::vector<std::unique_ptr<ThreadPool>> pools(numa::NumNodes());
+    AssertInfo(node >= 0 && node < int(pools.size()),
+               "invalid numa node " + std::to_string(node));
+    std::lock_guard lck(mutex);
+    auto& pool = pools[node];
+    if (pool == nullptr) {
+        pool = std::make_unique<ThreadPool>(numa::NodeCpus(node).size(), node);
+    }
+    return *pool;
+}
+
 void
 ThreadPool::ShutDown() {
     shutdown_ = true;
-    condition_lock_.notify_all();
-    for (int i = 0; i < threads_.size(); i++) {
-        if (threads_[i].joinable()) {
-            threads_[i].join();
+    idle_.NotifyAll();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void
+ThreadPool::Push(TaskPriority priority, Task task) {
+    auto p = static_cast<int>(priority);
+    if (current_pool == this || !injected_[p]->TryPush(std::move(task))) {
+        auto queue_id =
+            current_pool == this
+                ? current_worker
+                : next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                      queues_.size();
+        auto& queue = *queues_[queue_id];
+        std::lock_guard lck(queue.mutex);
+        queue.tasks[p].push_back(std::move(task));
+    }
+    // pairs with the PrepareWait in Run: either the worker sees the task or
+    // we see the worker and wake it up
+    pending_.fetch_add(1);
+    monitor::thread_pool_queued_tasks.Add(1);
+    idle_.NotifyOne();
+}
+
+void
+ThreadPool::Schedule(TaskPriority priority, Task task) {
+    auto group = GetActiveCpuGroup();
+    if (priority != TaskPriority::HIGH || group == nullptr) {
+        Push(priority, std::move(task));
+        return;
+    }
+    {
+        std::lock_guard lck(fair_mutex_);
+        auto& fair = fair_groups_[group];
+        if (fair.tasks.empty()) {
+            fair.vtime = std::max(fair.vtime, fair_vtime_);
+            backlogged_.emplace(fair.vtime, group);
+        }
+        fair.tasks.push_back(
+            FairTask{std::move(task), std::chrono::steady_clock::now()});
+    }
+    Push(priority, Task([this]() { RunFair(); }));
+}
+
+void
+ThreadPool::RunFair() {
+    CpuGroup* group = nullptr;
+    FairTask fair_task;
+    double charged = 0;
+    {
+        std::lock_guard lck(fair_mutex_);
+        // every pushed RunFair pairs with a queued task
+        AssertInfo(!backlogged_.empty(), "no fair task is queued");
+        group = backlogged_.begin()->second;
+        backlogged_.erase(backlogged_.begin());
+        auto& fair = fair_groups_.at(group);
+        fair_task = std::move(fair.tasks.front());
+        fair.tasks.pop_front();
+        fair_vtime_ = fair.vtime;
+        // charged ahead, the concurrent tasks of a group don't all start
+        // at the same virtual time
+        charged = fair.cost;
+        fair.vtime += charged / group->weight();
+        if (!fair.tasks.empty()) {
+            backlogged_.emplace(fair.vtime, group);
         }
     }
+    group->AddTask(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - fair_task.queued)
+                       .count());
+
+    auto begin = ThreadCpuNanos();
+    {
+        CpuGroupScope cpu_group_scope(group);
+        fair_task.task();
+    }
+    double cost = ThreadCpuNanos() - begin;
+
+    std::lock_guard lck(fair_mutex_);
+    auto& fair = fair_groups_.at(group);
+    auto queued = !fair.tasks.empty();
+    if (queued) {
+        backlogged_.erase({fair.vtime, group});
+    }
+    fair.vtime += (cost - charged) / group->weight();
+    fair.cost += (cost - fair.cost) / 8;
+    if (queued) {
+        backlogged_.emplace(fair.vtime, group);
+    }
 }
-};  // namespace milvus
+
+bool
+ThreadPool::Pop(size_t worker_id, Task& task) {
+    auto taken = [&]() {
+        pending_.fetch_sub(1);
+        monitor::thread_pool_queued_tasks.Sub(1);
+        return true;
+    };
+    auto num_queues = queues_.size();
+    for (int priority = 0; priority < NUM_PRIORITIES; ++priority) {
+        for (size_t i = 0; i < num_queues; ++i) {
+            auto own = i == 0;
+            // the shared queue after the own deque, before stealing
+            if (i == 1 && injected_[priority]->TryPop(task)) {
+                return taken();
+            }
+            auto& queue = *queues_[(worker_id + i) % num_queues];
+            std::lock_guard lck(queue.mutex);
+            auto& tasks = queue.tasks[priority];
+            if (tasks.empty()) {
+                continue;
+            }
+            if (own) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            } else {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            return taken();
+        }
+        if (num_queues == 1 && injected_[priority]->TryPop(task)) {
+            return taken();
+        }
+    }
+    return false;
+}
+
+void
+ThreadPool::Run(size_t worker_id) {
+    current_pool = this;
+    current_worker = worker_id;
+    if (numa_node_ >= 0) {
+        numa::PinCurrentThread(numa_node_);
+    }
+    Task task;
+    while (!shutdown_.load()) {
+        if (Pop(worker_id, task)) {
+            task();
+            task = Task();
+            continue;
+        }
+        auto key = idle_.PrepareWait();
+        if (pending_.load() > 0 || shutdown_.load()) {
+            idle_.CancelWait();
+            continue;
+        }
+        idle_.Wait(key);
+    }
+}
+
+}  // namespace milvus
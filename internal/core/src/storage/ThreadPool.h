@@ -14,30 +14,176 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
-#include <mutex>
 #include <memory>
-#include <queue>
+#include <mutex>
+#include <new>
+#include <set>
 #include <thread>
-#include <vector>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
-#include "SafeQueue.h"
+#include "common/Cancellation.h"
 #include "common/Common.h"
+#include "common/CpuGroup.h"
+#include "common/EventCount.h"
+#include "common/MpmcQueue.h"
 #include "log/Log.h"
 
 namespace milvus {
 
+enum class TaskPriority {
+    // work a query is waiting for, e.g. loading index files
+    HIGH = 0,
+    // background work, e.g. uploading built index files
+    LOW = 1,
+};
+
+// A move-only void() callable. Callables up to INLINE_SIZE bytes are stored
+// inline, so wrapping the task of a submission does not allocate.
+class Task {
+ public:
+    static constexpr size_t INLINE_SIZE = 6 * sizeof(void*);
+
+    Task() = default;
+
+    template <typename F,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<F>, Task>>>
+    explicit Task(F&& f) {
+        using Fn = std::decay_t<F>;
+        if constexpr (IsInline<Fn>) {
+            new (&storage_) Fn(std::forward<F>(f));
+            ops_ = &inline_ops<Fn>;
+        } else {
+            *reinterpret_cast<Fn**>(&storage_) = new Fn(std::forward<F>(f));
+            ops_ = &heap_ops<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept : ops_(other.ops_) {
+        if (ops_ != nullptr) {
+            ops_->move(&storage_, &other.storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    Task&
+    operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ops_ = other.ops_;
+            if (ops_ != nullptr) {
+                ops_->move(&storage_, &other.storage_);
+                other.ops_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task&
+    operator=(const Task&) = delete;
+
+    ~Task() {
+        reset();
+    }
+
+    void
+    operator()() {
+        ops_->invoke(&storage_);
+    }
+
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+ private:
+    struct Ops {
+        void (*invoke)(void*);
+        // move constructs into dst and destroys src
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template <typename Fn>
+    static constexpr bool IsInline =
+        sizeof(Fn) <= INLINE_SIZE &&
+        alignof(Fn) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<Fn>;
+
+    template <typename Fn>
+    static constexpr Ops inline_ops = {
+        [](void* self) { (*static_cast<Fn*>(self))(); },
+        [](void* dst, void* src) {
+            new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* self) { static_cast<Fn*>(self)->~Fn(); },
+    };
+
+    template <typename Fn>
+    static constexpr Ops heap_ops = {
+        [](void* self) { (**static_cast<Fn**>(self))(); },
+        [](void* dst, void* src) {
+            *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+        },
+        [](void* self) { delete *static_cast<Fn**>(self); },
+    };
+
+    void
+    reset() {
+        if (ops_ != nullptr) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+ private:
+    std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> storage_;
+    const Ops* ops_ = nullptr;
+};
+
+// A work-stealing thread pool. Every worker owns a deque per priority,
+// tasks submitted from a worker go to its own deques and tasks submitted
+// from other threads go to a lock-free queue per priority shared by the
+// workers, spread over the worker deques round robin only while it is
+// full. An idle worker takes high priority tasks before low priority ones,
+// first from its own deques, then from the shared queue and then stealing
+// from the other workers, and parks on a futex when there is none.
+//
+// The high priority tasks submitted for a cpu group are queued per group,
+// a worker runs the queued task of the group with the least virtual time,
+// which advances by the cpu time of its tasks over its weight. A heavy
+// group so gets its share of the workers rather than all of them while
+// the others have work queued.
 class ThreadPool {
  public:
-    explicit ThreadPool(const int thread_core_coefficient) : shutdown_(false) {
+    explicit ThreadPool(const int thread_core_coefficient) {
         auto thread_num = cpu_num * thread_core_coefficient;
         LOG_SEGCORE_INFO_ << "Thread pool's worker num:" << thread_num;
-        threads_ = std::vector<std::thread>(thread_num);
-        Init();
+        Init(thread_num);
+    }
+
+    // thread_num workers pinned to the cpus of numa_node
+    ThreadPool(int64_t thread_num, int numa_node) : numa_node_(numa_node) {
+        LOG_SEGCORE_INFO_ << "Thread pool of numa node " << numa_node
+                          << "'s worker num:" << thread_num;
+        Init(thread_num);
     }
 
     ~ThreadPool() {
@@ -50,6 +196,11 @@ class ThreadPool {
         return pool;
     }
 
+    // a pool with a worker per cpu of numa node `node`, for the work on
+    // the data placed on it, created on the first use
+    static ThreadPool&
+    GetNodeInstance(int node);
+
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool(ThreadPool&&) = delete;
     ThreadPool&
@@ -57,63 +208,177 @@ class ThreadPool {
     ThreadPool&
     operator=(ThreadPool&&) = delete;
 
-    void
-    Init();
-
     void
     ShutDown();
 
+    int64_t
+    GetThreadNum() const {
+        return threads_.size();
+    }
+
     template <typename F, typename... Args>
     auto
-    // Submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))>;
-    Submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))> {
-        std::function<decltype(f(args...))()> func =
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-        auto task_ptr =
-            std::make_shared<std::packaged_task<decltype(f(args...))()>>(func);
+    Submit(F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>&,
+                                             std::decay_t<Args>&...>> {
+        return Submit(TaskPriority::HIGH,
+                      std::forward<F>(f),
+                      std::forward<Args>(args)...);
+    }
 
-        std::function<void()> wrap_func = [task_ptr]() { (*task_ptr)(); };
+    template <typename F, typename... Args>
+    auto
+    Submit(TaskPriority priority, F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>&,
+                                             std::decay_t<Args>&...>> {
+        using R =
+            std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>;
+        // the shared state of the future is the only allocation
+        std::packaged_task<R()> task(
+            [f = std::forward<F>(f),
+             args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(f, args);
+            });
+        auto future = task.get_future();
+        Schedule(priority,
+                 Task([task = std::move(task)]() mutable { task(); }));
+        return future;
+    }
 
-        work_queue_.enqueue(wrap_func);
+    // calls fn(i) for every i in [0, n) on the calling thread and at most
+    // `max_helpers` workers, which claim the indexes one at a time. The call
+    // only waits for the indexes a worker has claimed, so it can't deadlock
+    // when all the workers are waiting in a ParallelFor of their own. The
+    // first exception thrown stops the claims and is rethrown. The helpers
+    // poll the cancellation token of the caller and run for its cpu group.
+    template <typename F>
+    void
+    ParallelFor(int64_t n, int64_t max_helpers, F&& fn) {
+        struct State {
+            int64_t n;
+            std::function<void(int64_t)> fn;
+            std::atomic<int64_t> next{0};
+            // helpers between claiming an index and finishing it
+            std::atomic<int64_t> active{0};
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<State>();
+        state->n = n;
+        // fn is only called on a claimed index, before this call returns
+        state->fn = [&fn](int64_t i) { fn(i); };
+        auto token = GetActiveCancellation();
+        auto run = [](State& state, bool helper) {
+            while (true) {
+                if (helper) {
+                    state.active.fetch_add(1);
+                }
+                auto i = state.next.fetch_add(1);
+                if (i < state.n) {
+                    try {
+                        state.fn(i);
+                    } catch (...) {
+                        std::lock_guard lck(state.mutex);
+                        if (!state.error) {
+                            state.error = std::current_exception();
+                        }
+                        state.next.store(state.n);
+                    }
+                }
+                if (helper && state.active.fetch_sub(1) == 1) {
+                    std::lock_guard lck(state.mutex);
+                    state.done.notify_all();
+                }
+                if (i >= state.n) {
+                    return;
+                }
+            }
+        };
+        auto helpers = std::min(max_helpers, n - 1);
+        for (int64_t i = 0; i < helpers; ++i) {
+            Schedule(TaskPriority::HIGH,
+                     Task([state, run, token]() {
+                         CancellationScope cancellation_scope(token);
+                         run(*state, true);
+                     }));
+        }
+        run(*state, false);
+        std::unique_lock lck(state->mutex);
+        state->done.wait(lck, [&]() { return state->active.load() == 0; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
 
-        condition_lock_.notify_one();
+ private:
+    static constexpr int NUM_PRIORITIES = 2;
+    // tasks of a priority submitted from outside and not taken yet, the
+    // ones over it wait in the worker deques
+    static constexpr size_t INJECT_QUEUE_CAPACITY = 4096;
 
-        return task_ptr->get_future();
-    }
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks[NUM_PRIORITIES];
+    };
 
- public:
-    bool shutdown_;
-    SafeQueue<std::function<void()>> work_queue_;
-    std::vector<std::thread> threads_;
-    std::mutex mutex_;
-    std::condition_variable condition_lock_;
-};
+    struct FairTask {
+        Task task;
+        std::chrono::steady_clock::time_point queued;
+    };
 
-class Worker {
- private:
-    int id_;
-    ThreadPool* pool_;
+    struct FairGroup {
+        std::deque<FairTask> tasks;
+        // in cpu nanoseconds over the weight
+        double vtime = 0;
+        // the moving average of the cpu time of its tasks, charged when
+        // one starts and corrected once it is done
+        double cost = 0;
+    };
 
- public:
-    Worker(ThreadPool* pool, const int id) : pool_(pool), id_(id) {
-    }
+    void
+    Init(int64_t thread_num);
 
     void
-    operator()() {
-        std::function<void()> func;
-        bool dequeue;
-        while (!pool_->shutdown_) {
-            std::unique_lock<std::mutex> lock(pool_->mutex_);
-            if (pool_->work_queue_.empty()) {
-                pool_->condition_lock_.wait(lock);
-            }
-            dequeue = pool_->work_queue_.dequeue(func);
-            lock.unlock();
-            if (dequeue) {
-                func();
-            }
-        }
-    }
+    Push(TaskPriority priority, Task task);
+
+    // queues a high priority task submitted for the active cpu group of
+    // the caller for its group, pushing a task which runs the next fair
+    // one in its place, and pushes any other task as it is
+    void
+    Schedule(TaskPriority priority, Task task);
+
+    void
+    RunFair();
+
+    // pops from the front of the own deque or steals from the back of the
+    // others, high priority first
+    bool
+    Pop(size_t worker_id, Task& task);
+
+    void
+    Run(size_t worker_id);
+
+ private:
+    // the node the workers are pinned to, -1 for none
+    int numa_node_ = -1;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::unique_ptr<MpmcQueue<Task>> injected_[NUM_PRIORITIES];
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> next_queue_{0};
+
+    // tasks pushed and not taken yet
+    std::atomic<int64_t> pending_{0};
+    std::atomic<bool> shutdown_{false};
+    EventCount idle_;
+
+    std::mutex fair_mutex_;
+    std::unordered_map<CpuGroup*, FairGroup> fair_groups_;
+    // the groups with queued tasks by their virtual time
+    std::set<std::pair<double, CpuGroup*>> backlogged_;
+    // the virtual time of the task run last, a group queuing its first
+    // task starts from it rather than from the time it was idle at
+    double fair_vtime_ = 0;
 };
 
 }  // namespace milvus
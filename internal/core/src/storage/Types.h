@@ -78,7 +78,10 @@ struct IndexMeta {
     int64_t field_id;
     int64_t build_id;
     int64_t index_version;
+    // the binary an index file holds
     std::string key;
+    int64_t index_id = 0;
+    std::string index_name;
 };
 
 struct StorageConfig {
@@ -15,12 +15,25 @@
 // limitations under the License.
 
 #include "storage/Util.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <deque>
+#include <fstream>
+#include <future>
+
 #include "arrow/array/builder_binary.h"
 #include "arrow/type_fwd.h"
 #include "exceptions/EasyAssert.h"
+#include "common/Common.h"
 #include "common/Consts.h"
+#include "common/Slice.h"
 #include "config/ConfigChunkManager.h"
+#include "simd/crc32c.h"
 #include "storage/parquet_c.h"
+#include "storage/FieldDataFactory.h"
+#include "storage/IndexData.h"
+#include "storage/ThreadPool.h"
 
 #ifdef BUILD_DISK_ANN
 #include "storage/DiskFileManagerImpl.h"
@@ -318,6 +331,36 @@ GenFieldRawDataPathPrefix(int64_t segment_id, int64_t field_id) {
            "/" + std::to_string(field_id) + "/";
 }
 
+Config
+GetIndexCacheManifests() {
+    namespace fs = boost::filesystem;
+    auto manifests = Config::array();
+    fs::path root(milvus::ChunkMangerConfig::GetLocalRootPath());
+    root /= INDEX_ROOT_PATH;
+    boost::system::error_code err;
+    if (!fs::is_directory(root, err)) {
+        return manifests;
+    }
+    // index_files/{build_id}/{index_version}/
+    for (auto& build : fs::directory_iterator(root, err)) {
+        if (!fs::is_directory(build.path(), err)) {
+            continue;
+        }
+        for (auto& version : fs::directory_iterator(build.path(), err)) {
+            auto path = version.path() / INDEX_CACHE_MANIFEST;
+            std::ifstream file(path.string());
+            if (!file.is_open()) {
+                continue;
+            }
+            auto manifest = Config::parse(file, nullptr, false);
+            if (!manifest.is_discarded()) {
+                manifests.push_back(std::move(manifest));
+            }
+        }
+    }
+    return manifests;
+}
+
 std::string
 GetSegmentRawDataPathPrefix(int64_t segment_id) {
     return milvus::ChunkMangerConfig::GetLocalRootPath() + "/" +
@@ -337,6 +380,213 @@ is_in_disk_list(const IndexType& index_type) {
     return is_in_list<IndexType>(index_type, DISK_LIST);
 }
 
+std::unique_ptr<DataCodec>
+DownloadAndDecodeRemoteFile(RemoteChunkManager* remote_chunk_manager,
+                            const std::string& file) {
+    auto fileSize = remote_chunk_manager->Size(file);
+    auto buf = std::shared_ptr<uint8_t[]>(new uint8_t[fileSize]);
+    if (fileSize < 2 * DEFAULT_REMOTE_READ_RANGE_SIZE) {
+        remote_chunk_manager->Read(file, buf.get(), fileSize);
+        return DeserializeFileData(buf, fileSize);
+    }
+
+    // the checksum of every range is computed on the thread which fetched
+    // it while the others are still downloading, then they are combined
+    auto range_size = DEFAULT_REMOTE_READ_RANGE_SIZE;
+    std::vector<uint32_t> range_checksums(
+        (fileSize + range_size - 1) / range_size);
+    remote_chunk_manager->ReadRanges(
+        file,
+        buf.get(),
+        fileSize,
+        range_size,
+        DEFAULT_REMOTE_READ_MAX_INFLIGHT,
+        [&](uint64_t offset, uint64_t len) {
+            range_checksums[offset / range_size] =
+                simd::Crc32c(0, buf.get() + offset, len);
+        });
+    auto file_checksum = range_checksums[0];
+    for (size_t i = 1; i < range_checksums.size(); ++i) {
+        auto len = std::min(range_size, fileSize - i * range_size);
+        file_checksum =
+            simd::Crc32cCombine(file_checksum, range_checksums[i], len);
+    }
+    return DeserializeFileData(buf, fileSize, file_checksum);
+}
+
+void
+DownloadAndDecodeRemoteFiles(
+    RemoteChunkManager* remote_chunk_manager,
+    const std::vector<std::string>& remote_files,
+    int64_t max_inflight,
+    const std::function<void(const FieldDataPtr&)>& consume) {
+    auto& pool = ThreadPool::GetInstance();
+    max_inflight = std::max<int64_t>(1, max_inflight);
+    std::deque<std::future<std::unique_ptr<DataCodec>>> futures;
+    auto consume_oldest = [&]() {
+        auto codec = futures.front().get();
+        futures.pop_front();
+        consume(codec->GetFieldData());
+    };
+
+    try {
+        for (auto& file : remote_files) {
+            if (int64_t(futures.size()) >= max_inflight) {
+                consume_oldest();
+            }
+            futures.push_back(pool.Submit(TaskPriority::HIGH,
+                                          DownloadAndDecodeRemoteFile,
+                                          remote_chunk_manager,
+                                          file));
+        }
+        while (!futures.empty()) {
+            consume_oldest();
+        }
+    } catch (...) {
+        // the in flight downloads still use the chunk manager
+        for (auto& future : futures) {
+            future.wait();
+        }
+        throw;
+    }
+}
+
+std::string
+GenRemoteIndexPathPrefix(const std::string& remote_root_path,
+                         const FieldDataMeta& field_meta,
+                         const IndexMeta& index_meta) {
+    return remote_root_path + "/" + std::string(INDEX_ROOT_PATH) + "/" +
+           std::to_string(index_meta.build_id) + "/" +
+           std::to_string(index_meta.index_version) + "/" +
+           std::to_string(field_meta.partition_id) + "/" +
+           std::to_string(field_meta.segment_id);
+}
+
+namespace {
+
+std::pair<std::string, int64_t>
+EncodeAndUploadIndexBinary(RemoteChunkManager* remote_chunk_manager,
+                           const uint8_t* data,
+                           int64_t size,
+                           const FieldDataMeta& field_meta,
+                           IndexMeta index_meta,
+                           const std::string& object_key) {
+    auto field_data =
+        FieldDataFactory::GetInstance().CreateFieldData(DataType::INT8);
+    field_data->FillFieldData(data, size);
+    auto index_data = std::make_shared<IndexData>(field_data);
+    index_data->set_index_meta(index_meta);
+    index_data->SetFieldDataMeta(field_meta);
+    auto serialized = index_data->serialize_to_remote_file();
+    remote_chunk_manager->Write(
+        object_key, serialized.data(), serialized.size());
+    return {object_key, int64_t(serialized.size())};
+}
+
+}  // namespace
+
+std::map<std::string, int64_t>
+PutIndexData(RemoteChunkManager* remote_chunk_manager,
+             BinarySet& binary_set,
+             const std::string& remote_prefix,
+             const FieldDataMeta& field_meta,
+             const IndexMeta& index_meta,
+             int64_t max_inflight) {
+    auto& pool = ThreadPool::GetInstance();
+    max_inflight = std::max<int64_t>(1, max_inflight);
+    const int64_t slice_size = index_file_slice_size << 20;
+
+    // a binary sliced by an earlier Disassemble keeps its slices
+    Config meta_info;
+    auto slice_meta = EraseSliceMeta(binary_set);
+    if (slice_meta != nullptr) {
+        auto last_meta_data = Config::parse(
+            std::string(reinterpret_cast<char*>(slice_meta->data.get()),
+                        slice_meta->size));
+        for (auto& item : last_meta_data["meta"]) {
+            meta_info["meta"].emplace_back(item);
+        }
+    }
+
+    // every file in flight holds the binary it's a slice of
+    struct Upload {
+        std::future<std::pair<std::string, int64_t>> future;
+        BinaryPtr binary;
+    };
+    std::deque<Upload> uploads;
+    std::map<std::string, int64_t> remote_paths_to_size;
+    auto wait_oldest = [&]() {
+        auto [path, size] = uploads.front().future.get();
+        uploads.pop_front();
+        remote_paths_to_size[path] = size;
+    };
+    auto submit = [&](const BinaryPtr& binary,
+                      const std::string& key,
+                      int64_t offset,
+                      int64_t size) {
+        if (int64_t(uploads.size()) >= max_inflight) {
+            wait_oldest();
+        }
+        auto meta = index_meta;
+        meta.key = key;
+        uploads.push_back(
+            {pool.Submit(TaskPriority::LOW,
+                         EncodeAndUploadIndexBinary,
+                         remote_chunk_manager,
+                         binary->data.get() + offset,
+                         size,
+                         field_meta,
+                         meta,
+                         remote_prefix + "/" + key),
+             binary});
+    };
+
+    try {
+        std::vector<std::string> keys;
+        for (auto& [key, binary] : binary_set.binary_map_) {
+            keys.push_back(key);
+        }
+        for (auto& key : keys) {
+            auto binary = binary_set.Erase(key);
+            if (binary->size <= slice_size) {
+                submit(binary, key, 0, binary->size);
+                continue;
+            }
+            int64_t slice_num = 0;
+            for (int64_t offset = 0; offset < binary->size; ++slice_num) {
+                auto size = std::min(slice_size, binary->size - offset);
+                submit(binary,
+                       key + "_" + std::to_string(slice_num),
+                       offset,
+                       size);
+                offset += size;
+            }
+            Config slice_info;
+            slice_info["name"] = key;
+            slice_info["slice_num"] = slice_num;
+            slice_info["total_len"] = binary->size;
+            meta_info["meta"].emplace_back(slice_info);
+        }
+        if (!meta_info.is_null()) {
+            BinarySet meta_set;
+            AppendSliceMeta(meta_set, meta_info);
+            for (auto& [key, binary] : meta_set.binary_map_) {
+                submit(binary, key, 0, binary->size);
+            }
+        }
+        while (!uploads.empty()) {
+            wait_oldest();
+        }
+    } catch (...) {
+        // the in flight files still use the chunk manager
+        for (auto& upload : uploads) {
+            upload.future.wait();
+        }
+        throw;
+    }
+    return remote_paths_to_size;
+}
+
 FileManagerImplPtr
 CreateFileManager(IndexType index_type,
                   const FieldDataMeta& field_meta,
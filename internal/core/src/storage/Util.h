@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,6 +25,7 @@
 #include "storage/PayloadStream.h"
 #include "storage/FileManager.h"
 #include "storage/BinlogReader.h"
+#include "storage/DataCodec.h"
 #include "knowhere/comp/index_param.h"
 
 namespace milvus::storage {
@@ -68,6 +71,11 @@ GenLocalIndexPathPrefix(int64_t build_id, int64_t index_version);
 std::string
 GenFieldRawDataPathPrefix(int64_t segment_id, int64_t field_id);
 
+// cache manifests of the disk index files kept in the local index dirs, so
+// loads can be scheduled to the nodes which already hold the files
+Config
+GetIndexCacheManifests();
+
 std::string
 GetSegmentRawDataPathPrefix(int64_t segment_id);
 
@@ -81,6 +89,42 @@ is_in_list(const T& t, std::function<std::vector<T>()> list_func) {
 bool
 is_in_disk_list(const IndexType& index_type);
 
+// download a remote binlog and decode its payload
+std::unique_ptr<DataCodec>
+DownloadAndDecodeRemoteFile(RemoteChunkManager* remote_chunk_manager,
+                            const std::string& file);
+
+// download and decode the remote binlogs in parallel, `consume` gets their
+// field data in the order of `remote_files`. At most `max_inflight` binlogs
+// are being downloaded or waiting to be consumed at a time.
+void
+DownloadAndDecodeRemoteFiles(
+    RemoteChunkManager* remote_chunk_manager,
+    const std::vector<std::string>& remote_files,
+    int64_t max_inflight,
+    const std::function<void(const FieldDataPtr&)>& consume);
+
+// the remote dir of the files of an index, the one the go side saves them
+// in as well
+std::string
+GenRemoteIndexPathPrefix(const std::string& remote_root_path,
+                         const FieldDataMeta& field_meta,
+                         const IndexMeta& index_meta);
+
+// encodes the binaries of an index as index files under `remote_prefix`
+// and writes them, the ones above index_file_slice_size in slices named
+// and described the way Disassemble slices them. At most `max_inflight`
+// files are encoded or being written at a time, and the binaries are
+// taken out of `binary_set` so each is released once written. Returns the
+// remote paths of the files and their sizes.
+std::map<std::string, int64_t>
+PutIndexData(RemoteChunkManager* remote_chunk_manager,
+             BinarySet& binary_set,
+             const std::string& remote_prefix,
+             const FieldDataMeta& field_meta,
+             const IndexMeta& index_meta,
+             int64_t max_inflight);
+
 FileManagerImplPtr
 CreateFileManager(IndexType index_type,
                   const FieldDataMeta& field_meta,
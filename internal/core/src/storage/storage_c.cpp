@@ -15,8 +15,12 @@
 // limitations under the License.
 
 #include "storage/storage_c.h"
+
+#include <cstring>
+
 #include "config/ConfigChunkManager.h"
 #include "common/CGoHelper.h"
+#include "storage/Util.h"
 
 #ifdef BUILD_DISK_ANN
 #include "storage/LocalChunkManager.h"
@@ -40,3 +44,14 @@ GetLocalUsedSize(int64_t* size) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
     }
 }
+
+CStatus
+GetIndexCacheManifests(char** manifests) {
+    try {
+        auto dump = milvus::storage::GetIndexCacheManifests().dump();
+        *manifests = strdup(dump.c_str());
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
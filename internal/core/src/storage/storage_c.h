@@ -24,6 +24,11 @@ extern "C" {
 CStatus
 GetLocalUsedSize(int64_t* size);
 
+// json array of the cache manifests of the disk indexes held by this node,
+// the caller frees *manifests
+CStatus
+GetIndexCacheManifests(char** manifests);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,281 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <boost/format.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "query/Plan.h"
+#include "query/PlanImpl.h"
+#include "query/generated/ExecExprVisitor.h"
+#include "segcore/SegmentGrowingImpl.h"
+#include "segcore/SegmentSealed.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+// the segments the expressions are evaluated on
+enum SegmentKind : int64_t {
+    GrowingSegment = 0,
+    SealedSegment = 1,
+    // sealed with a sort index on the int32 field, growing segments never
+    // hold scalar indexes
+    IndexedSealedSegment = 2,
+};
+
+const auto schema = []() {
+    auto schema = std::make_shared<Schema>();
+    // 0..N-1
+    auto i64_fid = schema->AddDebugField("int64", DataType::INT64);
+    // uniform in [0, 2N)
+    schema->AddDebugField("int32", DataType::INT32);
+    // {"int": uniform in [1, 2^31 - 1), ...}
+    schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(i64_fid);
+    return schema;
+}();
+
+const auto int64_fid = schema->get_field_id(FieldName("int64"));
+const auto int32_fid = schema->get_field_id(FieldName("int32"));
+const auto json_fid = schema->get_field_id(FieldName("json"));
+
+constexpr int64_t JSON_INT_MAX = (int64_t(1) << 31) - 1;
+
+static SegmentInternalInterface&
+GetSegment(SegmentKind kind, int64_t N) {
+    static std::map<std::pair<int64_t, int64_t>,
+                    std::unique_ptr<SegmentInternalInterface>>
+        segments;
+    auto& segment = segments[{kind, N}];
+    if (segment != nullptr) {
+        return *segment;
+    }
+
+    auto dataset = DataGen(schema, N);
+    if (kind == GrowingSegment) {
+        auto growing = CreateGrowingSegment(schema, empty_index_meta);
+        growing->PreInsert(N);
+        growing->Insert(0,
+                        N,
+                        dataset.row_ids_.data(),
+                        dataset.timestamps_.data(),
+                        dataset.raw_);
+        segment = std::move(growing);
+        return *segment;
+    }
+
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *sealed);
+    if (kind == IndexedSealedSegment) {
+        LoadIndexInfo info;
+        info.field_id = int32_fid.get();
+        info.field_type = DataType::INT32;
+        info.index_params["index_type"] = "sort";
+        auto data = dataset.get_col<int32_t>(int32_fid);
+        info.index = GenScalarIndexing<int32_t>(N, data.data());
+        sealed->LoadIndex(info);
+    }
+    segment = std::move(sealed);
+    return *segment;
+}
+
+// parses the text format of an Expr proto
+static std::unique_ptr<RetrievePlan>
+CreateFilter(const std::string& expr) {
+    auto text = "query: < predicates: < " + expr + " > >";
+    auto binary_plan = translate_text_plan_to_binary_plan(text.c_str());
+    return CreateRetrievePlanByExpr(
+        *schema, binary_plan.data(), binary_plan.size());
+}
+
+static std::string
+Column(FieldId field_id, DataType type, const std::string& path = "") {
+    auto column = boost::format("field_id: %1% data_type: %2%") %
+                  field_id.get() %
+                  proto::schema::DataType_Name(
+                      static_cast<proto::schema::DataType>(type));
+    if (!path.empty()) {
+        return column.str() + " nested_path: \"" + path + "\"";
+    }
+    return column.str();
+}
+
+static std::string
+UnaryRange(const std::string& column, const std::string& op, int64_t value) {
+    return (boost::format(
+                "unary_range_expr: < column_info: < %1% > op: %2% "
+                "value: < int64_val: %3% > >") %
+            column % op % value)
+        .str();
+}
+
+// evaluates `expr` until the benchmark is done, the reported items are the
+// rows filtered
+static void
+RunFilter(benchmark::State& state,
+          SegmentKind kind,
+          int64_t N,
+          const std::string& expr) {
+    auto& segment = GetSegment(kind, N);
+    auto plan = CreateFilter(expr);
+    auto& predicate = *plan->plan_node_->predicate_.value();
+    int64_t selected = 0;
+    for (auto _ : state) {
+        ExecExprVisitor visitor(segment, N, MAX_TIMESTAMP);
+        auto bitset = visitor.call_child(predicate);
+        selected = bitset.count();
+        benchmark::DoNotOptimize(bitset);
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+    state.counters["selectivity"] = double(selected) / N;
+}
+
+// int32 < 2N * selectivity
+static void
+Expr_UnaryRange(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto percent = state.range(2);
+    auto expr = UnaryRange(Column(int32_fid, DataType::INT32),
+                           "LessThan",
+                           2 * N * percent / 100);
+    RunFilter(state, kind, N, expr);
+}
+
+// N <= int32 < N + 2N * selectivity
+static void
+Expr_BinaryRange(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto percent = state.range(2);
+    auto expr =
+        boost::format(
+            "binary_range_expr: < column_info: < %1% > lower_inclusive: true "
+            "upper_inclusive: false lower_value: < int64_val: %2% > "
+            "upper_value: < int64_val: %3% > >") %
+        Column(int32_fid, DataType::INT32) % N % (N + 2 * N * percent / 100);
+    RunFilter(state, kind, N, expr.str());
+}
+
+// int32 in a list of `state.range(2)` values
+static void
+Expr_Term(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto size = state.range(2);
+    auto expr = "term_expr: < column_info: < " +
+                Column(int32_fid, DataType::INT32) + " > ";
+    auto step = 2 * N / size;
+    for (int64_t i = 0; i < size; ++i) {
+        expr += "values: < int64_val: " + std::to_string(i * step) + " > ";
+    }
+    expr += ">";
+    RunFilter(state, kind, N, expr);
+}
+
+// int32 < int64, a quarter of the rows
+static void
+Expr_Compare(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto expr = boost::format(
+                    "compare_expr: < left_column_info: < %1% > "
+                    "right_column_info: < %2% > op: LessThan >") %
+                Column(int32_fid, DataType::INT32) %
+                Column(int64_fid, DataType::INT64);
+    RunFilter(state, kind, N, expr.str());
+}
+
+// int32 % 100 < selectivity
+static void
+Expr_Arith(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto percent = state.range(2);
+    auto expr = boost::format(
+                    "binary_arith_op_eval_range_expr: < column_info: < %1% > "
+                    "arith_op: Mod right_operand: < int64_val: 100 > "
+                    "op: LessThan value: < int64_val: %2% > >") %
+                Column(int32_fid, DataType::INT32) % percent;
+    RunFilter(state, kind, N, expr.str());
+}
+
+// json["int"] < 2^31 * selectivity
+static void
+Expr_JsonPath(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto percent = state.range(2);
+    auto expr = UnaryRange(Column(json_fid, DataType::JSON, "int"),
+                           "LessThan",
+                           JSON_INT_MAX / 100 * percent);
+    RunFilter(state, kind, N, expr);
+}
+
+// (int32 < 2N * selectivity and int32 % 2 == 0) or json["int"] < 2^31 / 100
+static void
+Expr_Logical(benchmark::State& state) {
+    auto kind = SegmentKind(state.range(0));
+    auto N = state.range(1);
+    auto percent = state.range(2);
+    auto range = UnaryRange(Column(int32_fid, DataType::INT32),
+                            "LessThan",
+                            2 * N * percent / 100);
+    auto even = boost::format(
+                    "binary_arith_op_eval_range_expr: < column_info: < %1% > "
+                    "arith_op: Mod right_operand: < int64_val: 2 > "
+                    "op: Equal value: < int64_val: 0 > >") %
+                Column(int32_fid, DataType::INT32);
+    auto json = UnaryRange(Column(json_fid, DataType::JSON, "int"),
+                           "LessThan",
+                           JSON_INT_MAX / 100);
+    auto expr = boost::format(
+                    "binary_expr: < op: LogicalOr "
+                    "left: < binary_expr: < op: LogicalAnd "
+                    "left: < %1% > right: < %2% > > > "
+                    "right: < %3% > >") %
+                range % even % json;
+    RunFilter(state, kind, N, expr.str());
+}
+
+constexpr int64_t M = 1000 * 1000;
+
+const std::vector<int64_t> segment_kinds = {
+    GrowingSegment, SealedSegment, IndexedSealedSegment};
+
+#define BENCH_SELECTIVITY(func)                                       \
+    BENCHMARK(func)                                                   \
+        ->ArgNames({"segment", "rows", "selectivity%"})               \
+        ->ArgsProduct({segment_kinds, {1 * M, 10 * M}, {1, 10, 50}}) \
+        ->Unit(benchmark::kMillisecond)
+
+BENCH_SELECTIVITY(Expr_UnaryRange);
+BENCH_SELECTIVITY(Expr_BinaryRange);
+BENCH_SELECTIVITY(Expr_Arith);
+BENCH_SELECTIVITY(Expr_JsonPath);
+BENCH_SELECTIVITY(Expr_Logical);
+
+BENCHMARK(Expr_Term)
+    ->ArgNames({"segment", "rows", "values"})
+    ->ArgsProduct({segment_kinds, {1 * M, 10 * M}, {8, 1024}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(Expr_Compare)
+    ->ArgNames({"segment", "rows"})
+    ->ArgsProduct({segment_kinds, {1 * M, 10 * M}})
+    ->Unit(benchmark::kMillisecond);
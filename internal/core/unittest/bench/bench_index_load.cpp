@@ -0,0 +1,282 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/Slice.h"
+#include "common/binary_set_c.h"
+#include "index/IndexFactory.h"
+#include "index/Meta.h"
+#include "segcore/SegmentSealed.h"
+#include "segcore/Types.h"
+#include "storage/LocalChunkManager.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::segcore;
+
+// Measures loading the index of a vector field into a sealed segment the
+// way UpdateSealedSegmentIndex is fed: reading the sliced index files
+// through a ChunkManager, copying them into a binary set as
+// AppendIndexBinary does, assembling the slices, loading the index into
+// memory or mapped from a file, handing it to the segment, and the first
+// query on the segment after it. The indexes are built and written once
+// per type and size.
+
+namespace {
+
+constexpr int index_dim = 128;
+constexpr int64_t num_queries = 10;
+const char* local_index_dir = "/tmp/milvus/bench_index_load";
+const char* mmap_dir = "./data/mmap-bench";
+
+// {index type, build params, search params}
+const std::vector<std::tuple<std::string, Config, std::string>>
+    index_types = {
+        {knowhere::IndexEnum::INDEX_FAISS_IVFFLAT,
+         {{knowhere::indexparam::NLIST, "1024"}},
+         R"({"nprobe": 16})"},
+        {knowhere::IndexEnum::INDEX_FAISS_IVFSQ8,
+         {{knowhere::indexparam::NLIST, "1024"}},
+         R"({"nprobe": 16})"},
+        {knowhere::IndexEnum::INDEX_HNSW,
+         {{knowhere::indexparam::HNSW_M, "16"},
+          {knowhere::indexparam::EFCONSTRUCTION, "200"}},
+         R"({"ef": 64})"},
+};
+
+const auto index_schema = []() {
+    auto schema = std::make_shared<Schema>();
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->AddDebugField(
+        "vec", DataType::VECTOR_FLOAT, index_dim, knowhere::metric::L2);
+    schema->set_primary_field_id(pk_fid);
+    return schema;
+}();
+
+const auto vec_field_id = index_schema->get_field_id(FieldName("vec"));
+
+const GeneratedData&
+GetDataset(int64_t rows) {
+    static std::map<int64_t, GeneratedData> datasets;
+    auto it = datasets.find(rows);
+    if (it == datasets.end()) {
+        it = datasets.emplace(rows, DataGen(index_schema, rows)).first;
+    }
+    return it->second;
+}
+
+// builds index `type` of `rows` rows and writes its sliced binaries to the
+// local chunk manager once, returns the paths of the files
+const std::vector<std::string>&
+GetIndexFiles(int64_t type, int64_t rows) {
+    static std::map<std::pair<int64_t, int64_t>, std::vector<std::string>>
+        files;
+    auto& paths = files[{type, rows}];
+    if (!paths.empty()) {
+        return paths;
+    }
+    auto& [index_type, build_params, search_params] = index_types[type];
+    auto vectors = GetDataset(rows).get_col<float>(vec_field_id);
+    index::CreateIndexInfo create_index_info;
+    create_index_info.index_type = index_type;
+    create_index_info.metric_type = knowhere::metric::L2;
+    create_index_info.field_type = DataType::VECTOR_FLOAT;
+    auto index = index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr);
+    auto build_conf = build_params;
+    build_conf[knowhere::meta::METRIC_TYPE] = knowhere::metric::L2;
+    build_conf[knowhere::meta::DIM] = std::to_string(index_dim);
+    index->BuildWithDataset(
+        knowhere::GenDataSet(rows, index_dim, vectors.data()), build_conf);
+    auto binary_set = index->Serialize(Config{});
+    Disassemble(binary_set);
+
+    auto& local = storage::LocalChunkManager::GetInstance();
+    auto dir = std::string(local_index_dir) + "/" + index_type + "/" +
+               std::to_string(rows);
+    if (!local.DirExist(dir)) {
+        local.CreateDir(dir);
+    }
+    for (auto& [key, binary] : binary_set.binary_map_) {
+        auto path = dir + "/" + key;
+        local.Write(path, binary->data.get(), binary->size);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+std::unique_ptr<query::Plan>
+CreateIndexPlan(const std::string& search_params) {
+    auto dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "vec": {
+                        "metric_type": "L2",
+                        "params": )" +
+               search_params + R"(,
+                        "query": "$0",
+                        "topk": 10,
+                        "round_decimal": -1
+                    }
+                }
+            }
+            ]
+        }
+    })";
+    return query::CreatePlan(*index_schema, dsl);
+}
+
+double
+Seconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+int64_t
+PeakRssBytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    // kilobytes on linux
+    return usage.ru_maxrss * 1024;
+}
+
+// loads index `state.range(0)` of `index_types` over range(1) rows into a
+// sealed segment, into memory (0) or mapped (1); the peak rss is the
+// process wide high water mark so far
+void
+Load_Index(benchmark::State& state) {
+    auto& [index_type, build_params, search_params] =
+        index_types[state.range(0)];
+    auto rows = state.range(1);
+    auto mmap = state.range(2) != 0;
+    auto& dataset = GetDataset(rows);
+    auto& paths = GetIndexFiles(state.range(0), rows);
+    auto& chunk_manager = storage::LocalChunkManager::GetInstance();
+    auto plan = CreateIndexPlan(search_params);
+    auto ph_group_raw = CreatePlaceholderGroup(num_queries, index_dim, 1024);
+    auto ph_group =
+        query::ParsePlaceholderGroup(plan.get(),
+                                     ph_group_raw.SerializeAsString());
+
+    std::chrono::steady_clock::duration read_time{}, append_time{},
+        assemble_time{}, load_time{}, update_time{}, query_time{};
+    int64_t index_bytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto segment = CreateSealedSegment(index_schema);
+        SealedLoadFieldData(dataset, *segment, {vec_field_id.get()});
+        index_bytes = 0;
+        state.ResumeTiming();
+
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::pair<std::unique_ptr<uint8_t[]>, int64_t>> files;
+        for (auto& path : paths) {
+            auto size = chunk_manager.Size(path);
+            auto buf = std::make_unique<uint8_t[]>(size);
+            chunk_manager.Read(path, buf.get(), size);
+            files.emplace_back(std::move(buf), size);
+            index_bytes += size;
+        }
+        auto read_end = std::chrono::steady_clock::now();
+
+        knowhere::BinarySet binary_set;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto key = std::filesystem::path(paths[i]).filename().string();
+            auto& [buf, size] = files[i];
+            auto status = AppendIndexBinary(
+                &binary_set, buf.get(), size, key.c_str());
+            AssertInfo(status.error_code == Success, status.error_msg);
+        }
+        files.clear();
+        auto append_end = std::chrono::steady_clock::now();
+
+        Assemble(binary_set);
+        auto assemble_end = std::chrono::steady_clock::now();
+
+        LoadIndexInfo load_info;
+        load_info.segment_id = segment->get_segment_id();
+        load_info.field_id = vec_field_id.get();
+        load_info.field_type = DataType::VECTOR_FLOAT;
+        load_info.index_id = 0;
+        load_info.index_params = {{"index_type", index_type},
+                                  {"metric_type", knowhere::metric::L2}};
+        index::CreateIndexInfo create_index_info;
+        create_index_info.index_type = index_type;
+        create_index_info.metric_type = knowhere::metric::L2;
+        create_index_info.field_type = DataType::VECTOR_FLOAT;
+        load_info.index = index::IndexFactory::GetInstance().CreateIndex(
+            create_index_info, nullptr);
+        Config load_conf;
+        if (mmap) {
+            load_conf[index::MMAP_FILE_PATH] =
+                (std::filesystem::path(mmap_dir) / index_type /
+                 std::to_string(rows))
+                    .string();
+        }
+        load_info.index->Load(binary_set, load_conf);
+        binary_set.binary_map_.clear();
+        auto load_end = std::chrono::steady_clock::now();
+
+        segment->LoadIndex(load_info);
+        auto update_end = std::chrono::steady_clock::now();
+
+        auto result =
+            segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+        benchmark::DoNotOptimize(result);
+        auto query_end = std::chrono::steady_clock::now();
+
+        read_time += read_end - begin;
+        append_time += append_end - read_end;
+        assemble_time += assemble_end - append_end;
+        load_time += load_end - assemble_end;
+        update_time += update_end - load_end;
+        query_time += query_end - update_end;
+
+        state.PauseTiming();
+        result.reset();
+        load_info.index.reset();
+        segment.reset();
+        state.ResumeTiming();
+    }
+
+    auto iterations = static_cast<double>(state.iterations());
+    state.counters["read_ms"] = Seconds(read_time) * 1e3 / iterations;
+    state.counters["append_ms"] = Seconds(append_time) * 1e3 / iterations;
+    state.counters["assemble_ms"] =
+        Seconds(assemble_time) * 1e3 / iterations;
+    state.counters["load_ms"] = Seconds(load_time) * 1e3 / iterations;
+    state.counters["update_ms"] = Seconds(update_time) * 1e3 / iterations;
+    state.counters["first_query_ms"] =
+        Seconds(query_time) * 1e3 / iterations;
+    state.counters["index_MB"] = index_bytes / 1e6;
+    state.counters["peak_rss_MB"] = PeakRssBytes() / 1e6;
+    state.SetBytesProcessed(state.iterations() * index_bytes);
+}
+
+}  // namespace
+
+BENCHMARK(Load_Index)
+    ->ArgNames({"index", "rows", "mmap"})
+    ->ArgsProduct({{0, 1, 2}, {100 * 1000, 1000 * 1000}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
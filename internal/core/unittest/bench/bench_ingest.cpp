@@ -0,0 +1,230 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <boost/format.hpp>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "query/Plan.h"
+#include "segcore/SegmentGrowingImpl.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+namespace {
+
+constexpr int ingest_dim = 128;
+// rows ingested by every iteration
+constexpr int64_t ingest_rows = 128 * 1024;
+// the part of every inserted batch deleted right after it
+constexpr int64_t delete_ratio = 10;
+
+const auto ingest_schema = []() {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, ingest_dim, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    return schema;
+}();
+
+const auto vec_fid = ingest_schema->get_field_id(FieldName("fakevec"));
+const auto pk_fid = ingest_schema->get_field_id(FieldName("pk"));
+
+const auto ingest_plan = []() {
+    auto text_plan = boost::format(R"(vector_anns: <
+                                        field_id: %1%
+                                        query_info: <
+                                            topk: 10
+                                            metric_type: "L2"
+                                            search_params: "{\"nprobe\": 16}"
+                                        >
+                                        placeholder_tag: "$0">)") %
+                     vec_fid.get();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(text_plan.str().c_str());
+    return CreateSearchPlanByExpr(
+        *ingest_schema, binary_plan.data(), binary_plan.size());
+}();
+
+const auto ingest_ph_group = []() {
+    auto raw_group = CreatePlaceholderGroup(1, ingest_dim, 1024);
+    return ParsePlaceholderGroup(ingest_plan.get(),
+                                 raw_group.SerializeAsString());
+}();
+
+// a batch of rows with globally unique row ids, pks and timestamps, and
+// the pks deleted after it
+struct Batch {
+    GeneratedData data;
+    std::shared_ptr<IdArray> deleted_pks;
+    std::vector<Timestamp> delete_tss;
+};
+
+const std::vector<Batch>&
+GetBatches(int64_t batch_size) {
+    static std::map<int64_t, std::vector<Batch>> batches;
+    auto& result = batches[batch_size];
+    if (!result.empty()) {
+        return result;
+    }
+    for (int64_t begin = 0; begin < ingest_rows; begin += batch_size) {
+        auto size = std::min(batch_size, ingest_rows - begin);
+        auto data = DataGen(ingest_schema, size, begin, begin);
+        std::iota(data.row_ids_.begin(), data.row_ids_.end(), begin);
+        for (auto& field_data : *data.raw_->mutable_fields_data()) {
+            if (field_data.field_id() != pk_fid.get()) {
+                continue;
+            }
+            auto pks = field_data.mutable_scalars()->mutable_long_data();
+            for (int64_t i = 0; i < size; ++i) {
+                pks->set_data(i, begin + i);
+            }
+        }
+        auto deleted = size / delete_ratio;
+        result.push_back({std::move(data),
+                          GenPKs(deleted, begin),
+                          GenTss(deleted, begin + size)});
+    }
+    return result;
+}
+
+double
+Percentile(std::vector<double>& latencies, double p) {
+    if (latencies.empty()) {
+        return 0;
+    }
+    auto pos = static_cast<size_t>(p * (latencies.size() - 1));
+    std::nth_element(
+        latencies.begin(), latencies.begin() + pos, latencies.end());
+    return latencies[pos];
+}
+
+// `writers` threads PreInsert+Insert the batches and delete a part of each
+// after inserting it while `searchers` threads search the rows visible so
+// far, an iteration ingests `ingest_rows` rows into a new segment
+void
+Ingest_Concurrent(benchmark::State& state) {
+    auto writers = state.range(0);
+    auto batch_size = state.range(1);
+    auto searchers = state.range(2);
+    auto chunk_rows = state.range(3) * 1024;
+    auto growing_index = state.range(4) != 0;
+
+    auto segconf = SegcoreConfig::default_config();
+    segconf.set_chunk_rows(chunk_rows);
+    segconf.set_enable_growing_segment_index(growing_index);
+    std::map<std::string, std::string> index_params = {
+        {"index_type", "IVF_FLAT"}, {"metric_type", "L2"}, {"nlist", "128"}};
+    std::map<std::string, std::string> type_params = {
+        {"dim", std::to_string(ingest_dim)}};
+    std::map<FieldId, FieldIndexMeta> field_map = {
+        {vec_fid,
+         FieldIndexMeta(
+             vec_fid, std::move(index_params), std::move(type_params))}};
+    auto index_meta = std::make_shared<CollectionIndexMeta>(
+        ingest_rows, std::move(field_map));
+
+    auto& batches = GetBatches(batch_size);
+    std::vector<double> latencies;
+    int64_t bytes_per_row = 0;
+    for (auto _ : state) {
+        auto segment =
+            CreateGrowingSegment(ingest_schema, index_meta, -1, segconf);
+        std::atomic<size_t> next_batch = 0;
+        std::atomic<int64_t> finished_writers = 0;
+        // the newest timestamp written, the searches read at it
+        std::atomic<Timestamp> visible_ts = 0;
+
+        std::vector<std::thread> threads;
+        for (int64_t w = 0; w < writers; ++w) {
+            threads.emplace_back([&] {
+                for (auto b = next_batch++; b < batches.size();
+                     b = next_batch++) {
+                    auto& batch = batches[b];
+                    auto size = batch.data.row_ids_.size();
+                    auto offset = segment->PreInsert(size);
+                    segment->Insert(offset,
+                                    size,
+                                    batch.data.row_ids_.data(),
+                                    batch.data.timestamps_.data(),
+                                    batch.data.raw_);
+                    auto deleted = batch.delete_tss.size();
+                    auto del_offset = segment->PreDelete(deleted);
+                    segment->Delete(del_offset,
+                                    deleted,
+                                    batch.deleted_pks.get(),
+                                    batch.delete_tss.data());
+                    auto ts = batch.delete_tss.empty()
+                                  ? batch.data.timestamps_.back()
+                                  : batch.delete_tss.back();
+                    auto current = visible_ts.load();
+                    while (current < ts &&
+                           !visible_ts.compare_exchange_weak(current, ts)) {
+                    }
+                }
+                finished_writers++;
+            });
+        }
+        std::vector<std::vector<double>> searcher_latencies(searchers);
+        for (int64_t s = 0; s < searchers; ++s) {
+            threads.emplace_back([&, s] {
+                while (finished_writers.load() < writers) {
+                    auto start = std::chrono::steady_clock::now();
+                    segment->Search(ingest_plan.get(),
+                                    ingest_ph_group.get(),
+                                    visible_ts.load());
+                    auto end = std::chrono::steady_clock::now();
+                    searcher_latencies[s].push_back(
+                        std::chrono::duration<double, std::micro>(end - start)
+                            .count());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        state.PauseTiming();
+        for (auto& l : searcher_latencies) {
+            latencies.insert(latencies.end(), l.begin(), l.end());
+        }
+        bytes_per_row = segment->GetMemoryUsageInBytes() / ingest_rows;
+        segment.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ingest_rows);
+    state.counters["bytes/row"] = bytes_per_row;
+    state.counters["searches"] = latencies.size();
+    state.counters["search_p50_us"] = Percentile(latencies, 0.5);
+    state.counters["search_p99_us"] = Percentile(latencies, 0.99);
+}
+
+}  // namespace
+
+BENCHMARK(Ingest_Concurrent)
+    ->ArgNames(
+        {"writers", "batch", "searchers", "chunk_rows_k", "growing_index"})
+    ->ArgsProduct({{1, 4}, {1000, 10000}, {0, 2}, {8, 32}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,237 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/LoadInfo.h"
+#include "segcore/SegmentSealed.h"
+#include "storage/DataCodec.h"
+#include "storage/FieldDataFactory.h"
+#include "storage/InsertData.h"
+#include "storage/LocalChunkManager.h"
+#include "test_utils/DataGen.h"
+#include "test_utils/MemChunkManager.h"
+
+using namespace milvus;
+using namespace milvus::segcore;
+
+// Measures loading a field of a sealed segment from its binlogs: reading
+// them through a ChunkManager, decoding them into FieldData with the
+// payload reader, and LoadFieldData building the column, in memory or
+// mapped from `mmap_dir_path`. The arguments are fixed, so the reported
+// GB/s of each phase can be compared between runs to gate regressions.
+
+namespace {
+
+constexpr int load_dim = 128;
+constexpr int64_t load_rows = 1000 * 1000;
+// rows of every binlog
+constexpr int64_t binlog_rows = 128 * 1024;
+const char* local_binlog_dir = "/tmp/milvus/bench_load";
+const char* mmap_dir = "./data/mmap-bench";
+
+const auto load_schema = []() {
+    auto schema = std::make_shared<Schema>();
+    auto pk_fid = schema->AddDebugField("int64", DataType::INT64);
+    schema->AddDebugField("double", DataType::DOUBLE);
+    schema->AddDebugField("varchar", DataType::VARCHAR);
+    schema->AddDebugField(
+        "vec", DataType::VECTOR_FLOAT, load_dim, knowhere::metric::L2);
+    schema->set_primary_field_id(pk_fid);
+    return schema;
+}();
+
+const std::vector<std::string> load_fields = {
+    "int64", "double", "varchar", "vec"};
+
+storage::MemChunkManager&
+GetMemChunkManager() {
+    static storage::MemChunkManager chunk_manager;
+    return chunk_manager;
+}
+
+storage::ChunkManager&
+GetChunkManager(bool local) {
+    if (local) {
+        return storage::LocalChunkManager::GetInstance();
+    }
+    return GetMemChunkManager();
+}
+
+// the field data of the rows [begin, begin + size) of `field_id`
+storage::FieldDataPtr
+SliceFieldData(const GeneratedData& dataset,
+               FieldId field_id,
+               int64_t begin,
+               int64_t size) {
+    auto& field_meta = (*load_schema)[field_id];
+    auto data_type = field_meta.get_data_type();
+    auto field_data = storage::FieldDataFactory::GetInstance().CreateFieldData(
+        data_type, datatype_is_vector(data_type) ? field_meta.get_dim() : 1);
+    switch (data_type) {
+        case DataType::INT64: {
+            auto col = dataset.get_col<int64_t>(field_id);
+            field_data->FillFieldData(col.data() + begin, size);
+            break;
+        }
+        case DataType::DOUBLE: {
+            auto col = dataset.get_col<double>(field_id);
+            field_data->FillFieldData(col.data() + begin, size);
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto col = dataset.get_col<std::string>(field_id);
+            field_data->FillFieldData(col.data() + begin, size);
+            break;
+        }
+        case DataType::VECTOR_FLOAT: {
+            auto col = dataset.get_col<float>(field_id);
+            field_data->FillFieldData(col.data() + begin * load_dim,
+                                      size * load_dim);
+            break;
+        }
+        default:
+            PanicInfo("unsupported data type");
+    }
+    return field_data;
+}
+
+// writes the binlogs of every field to both chunk managers once, returns
+// the paths of the binlogs of each field
+const std::map<std::string, std::vector<std::string>>&
+GetBinlogs() {
+    static std::map<std::string, std::vector<std::string>> binlogs;
+    if (!binlogs.empty()) {
+        return binlogs;
+    }
+    auto dataset = DataGen(load_schema, load_rows);
+    auto& local = storage::LocalChunkManager::GetInstance();
+    for (auto& name : load_fields) {
+        auto field_id = load_schema->get_field_id(FieldName(name));
+        auto dir = std::string(local_binlog_dir) + "/" + name;
+        if (!local.DirExist(dir)) {
+            local.CreateDir(dir);
+        }
+        for (int64_t begin = 0; begin < load_rows; begin += binlog_rows) {
+            auto size = std::min(binlog_rows, load_rows - begin);
+            storage::InsertData insert_data(
+                SliceFieldData(dataset, field_id, begin, size));
+            insert_data.SetFieldDataMeta({1, 2, 3, field_id.get()});
+            insert_data.SetTimestamps(0, 100);
+            auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+            auto path = dir + "/" + std::to_string(begin);
+            local.Write(path, bytes.data(), bytes.size());
+            GetMemChunkManager().Write(path, bytes.data(), bytes.size());
+            binlogs[name].push_back(path);
+        }
+    }
+    return binlogs;
+}
+
+double
+Seconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+int64_t
+PeakRssBytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    // kilobytes on linux
+    return usage.ru_maxrss * 1024;
+}
+
+// loads field `state.range(0)` of `load_fields` from the binlogs kept by
+// the in memory (0) or local file (1) chunk manager, into memory (0) or
+// mapped (1); the peak rss is the process wide high water mark so far
+void
+Load_Field(benchmark::State& state) {
+    auto& name = load_fields[state.range(0)];
+    auto& chunk_manager = GetChunkManager(state.range(1) != 0);
+    auto mmap = state.range(2) != 0;
+    auto field_id = load_schema->get_field_id(FieldName(name));
+    auto& paths = GetBinlogs().at(name);
+
+    std::chrono::steady_clock::duration read_time{}, decode_time{},
+        load_time{};
+    int64_t binlog_bytes = 0;
+    int64_t field_bytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto segment = CreateSealedSegment(load_schema);
+        binlog_bytes = 0;
+        field_bytes = 0;
+        state.ResumeTiming();
+
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::pair<std::shared_ptr<uint8_t[]>, int64_t>> binlogs;
+        for (auto& path : paths) {
+            auto size = chunk_manager.Size(path);
+            auto buf = std::shared_ptr<uint8_t[]>(new uint8_t[size]);
+            chunk_manager.Read(path, buf.get(), size);
+            binlogs.emplace_back(std::move(buf), size);
+            binlog_bytes += size;
+        }
+        auto read_end = std::chrono::steady_clock::now();
+
+        FieldDataInfo info{field_id.get(), {}, load_rows};
+        if (mmap) {
+            info.mmap_dir_path = mmap_dir;
+        }
+        for (auto& [buf, size] : binlogs) {
+            auto codec = storage::DeserializeFileData(buf, size);
+            info.datas.push_back(codec->GetFieldData());
+            field_bytes += info.datas.back()->Size();
+        }
+        binlogs.clear();
+        auto decode_end = std::chrono::steady_clock::now();
+
+        segment->LoadFieldData(info);
+        auto load_end = std::chrono::steady_clock::now();
+
+        read_time += read_end - begin;
+        decode_time += decode_end - read_end;
+        load_time += load_end - decode_end;
+
+        state.PauseTiming();
+        info.datas.clear();
+        segment.reset();
+        state.ResumeTiming();
+    }
+
+    auto iterations = static_cast<double>(state.iterations());
+    state.counters["read_GB/s"] =
+        binlog_bytes * iterations / Seconds(read_time) / 1e9;
+    state.counters["decode_GB/s"] =
+        field_bytes * iterations / Seconds(decode_time) / 1e9;
+    state.counters["load_GB/s"] =
+        field_bytes * iterations / Seconds(load_time) / 1e9;
+    state.counters["binlog_MB"] = binlog_bytes / 1e6;
+    state.counters["peak_rss_MB"] = PeakRssBytes() / 1e6;
+    state.SetBytesProcessed(state.iterations() * field_bytes);
+}
+
+}  // namespace
+
+BENCHMARK(Load_Field)
+    ->ArgNames({"field", "local_chunk_manager", "mmap"})
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 1}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
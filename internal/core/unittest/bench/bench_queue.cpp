@@ -0,0 +1,116 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "common/MpmcQueue.h"
+#include "storage/ThreadPool.h"
+
+using namespace milvus;
+
+namespace {
+
+// the mutex guarded queue the thread pool was built on before
+template <typename T>
+class SafeQueue {
+ public:
+    void
+    Push(T&& value) {
+        std::lock_guard lck(mutex_);
+        queue_.push(std::move(value));
+    }
+
+    bool
+    TryPop(T& value) {
+        std::lock_guard lck(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+        value = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
+ private:
+    std::mutex mutex_;
+    std::queue<T> queue_;
+};
+
+// big enough for all the threads to push before they pop
+constexpr size_t queue_capacity = 1 << 16;
+constexpr int64_t batch = 64;
+
+}  // namespace
+
+// every thread pushes a batch of tasks and pops as many, the tasks it pops
+// may be the ones of the others
+static void
+Queue_SafeQueue(benchmark::State& state) {
+    static SafeQueue<Task> queue;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < batch; ++i) {
+            queue.Push(Task([] {}));
+        }
+        Task task;
+        for (int64_t i = 0; i < batch; ++i) {
+            while (!queue.TryPop(task)) {
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+static void
+Queue_MpmcQueue(benchmark::State& state) {
+    static MpmcQueue<Task> queue(queue_capacity);
+    for (auto _ : state) {
+        for (int64_t i = 0; i < batch; ++i) {
+            Task task([] {});
+            while (!queue.TryPush(std::move(task))) {
+            }
+        }
+        Task task;
+        for (int64_t i = 0; i < batch; ++i) {
+            while (!queue.TryPop(task)) {
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(Queue_SafeQueue)->Threads(1)->Threads(4)->Threads(16);
+BENCHMARK(Queue_MpmcQueue)->Threads(1)->Threads(4)->Threads(16);
+
+// small tasks submitted from outside the pool, as the uploads and the
+// downloads of a load are
+static void
+ThreadPool_SubmitSmall(benchmark::State& state) {
+    auto& pool = ThreadPool::GetInstance();
+    std::vector<std::future<void>> futures(batch);
+    for (auto _ : state) {
+        for (auto& future : futures) {
+            future = pool.Submit([] {});
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(ThreadPool_SubmitSmall)->Threads(1)->Threads(4)->Threads(16);
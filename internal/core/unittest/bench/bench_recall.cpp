@@ -0,0 +1,429 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "index/VectorMemIndex.h"
+#include "index/VectorMemNMIndex.h"
+#include "segcore/SegmentSealed.h"
+#include "segcore/Utils.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+// Recall against latency of searching a sealed segment loaded with a real
+// dataset in the fvecs/ivecs format of SIFT, GIST and Deep:
+// <dir>/<name>_base.fvecs, <name>_query.fvecs and, optionally,
+// <name>_groundtruth.ivecs, where <dir> is $MILVUS_BENCH_DATASET_DIR and
+// <name> is $MILVUS_BENCH_DATASET, "sift" by default. The base can be cut
+// to its first $MILVUS_BENCH_BASE_ROWS rows and the queries to the first
+// $MILVUS_BENCH_QUERY_ROWS, 1000 by default.
+//
+// The arguments are the index type, the search param of it (nprobe of
+// IVF_FLAT, ef of HNSW, unused by FLAT), and the percent of the rows the
+// filter lets through; every run is repeated for a number of threads.
+// Every iteration searches one query, and recall@k, QPS and the p99
+// latency are reported as counters. The exact answers are those of the
+// ground truth file for the unfiltered full base, and those of a brute
+// force search of the segment otherwise. Without the dataset the runs are
+// skipped.
+
+namespace {
+
+constexpr int64_t recall_topk = 10;
+// rows of the filter field take the values [0, 100) in turn
+constexpr int64_t tag_values = 100;
+
+enum RecallIndexType : int64_t {
+    RECALL_FLAT = 0,
+    RECALL_IVF_FLAT = 1,
+    RECALL_HNSW = 2,
+};
+
+const char*
+GetEnv(const char* name, const char* default_value) {
+    auto value = std::getenv(name);
+    return value == nullptr ? default_value : value;
+}
+
+// the rows of a fvecs or ivecs file, up to `max_rows` of them, every row
+// being its dimension as an int32 followed by its values
+template <typename T>
+std::vector<T>
+ReadVecs(const std::string& path, int64_t max_rows, int64_t& dim) {
+    std::vector<T> data;
+    std::ifstream in(path, std::ios::binary);
+    dim = 0;
+    if (!in) {
+        return data;
+    }
+    int32_t row_dim = 0;
+    for (int64_t row = 0; row < max_rows; ++row) {
+        if (!in.read(reinterpret_cast<char*>(&row_dim), sizeof(row_dim))) {
+            break;
+        }
+        AssertInfo(dim == 0 || dim == row_dim,
+                   "rows of different dimensions in " + path);
+        dim = row_dim;
+        auto size = data.size();
+        data.resize(size + row_dim);
+        in.read(reinterpret_cast<char*>(data.data() + size),
+                row_dim * sizeof(T));
+        AssertInfo(in.good(), "truncated row in " + path);
+    }
+    return data;
+}
+
+struct RecallDataset {
+    int64_t dim = 0;
+    int64_t base_rows = 0;
+    int64_t query_rows = 0;
+    std::vector<float> base;
+    std::vector<float> queries;
+    // the ids of the nearest rows of every query, of `truth_dim` each,
+    // empty if there is no file or the base is cut
+    int64_t truth_dim = 0;
+    std::vector<int32_t> truth;
+    SchemaPtr schema;
+    FieldId vec_fid;
+    FieldId tag_fid;
+    // a placeholder group of one query for every query
+    std::vector<std::unique_ptr<PlaceholderGroup>> ph_groups;
+
+    bool
+    loaded() const {
+        return base_rows > 0 && query_rows > 0;
+    }
+};
+
+const RecallDataset&
+GetDataset() {
+    static const RecallDataset dataset = [] {
+        RecallDataset dataset;
+        std::string dir = GetEnv("MILVUS_BENCH_DATASET_DIR", "");
+        if (dir.empty()) {
+            return dataset;
+        }
+        auto prefix = dir + "/" + GetEnv("MILVUS_BENCH_DATASET", "sift");
+        auto max_base = std::atoll(GetEnv("MILVUS_BENCH_BASE_ROWS", "0"));
+        auto max_query =
+            std::atoll(GetEnv("MILVUS_BENCH_QUERY_ROWS", "1000"));
+        if (max_base <= 0) {
+            max_base = INT64_MAX;
+        }
+
+        int64_t query_dim = 0;
+        dataset.base =
+            ReadVecs<float>(prefix + "_base.fvecs", max_base, dataset.dim);
+        dataset.queries =
+            ReadVecs<float>(prefix + "_query.fvecs", max_query, query_dim);
+        if (dataset.base.empty() || dataset.queries.empty()) {
+            return dataset;
+        }
+        AssertInfo(dataset.dim == query_dim,
+                   "base and queries of different dimensions");
+        dataset.base_rows = dataset.base.size() / dataset.dim;
+        dataset.query_rows = dataset.queries.size() / dataset.dim;
+
+        // the ground truth is of the full base
+        int64_t base_total = 0;
+        std::ifstream base_file(prefix + "_base.fvecs",
+                                std::ios::binary | std::ios::ate);
+        base_total = static_cast<int64_t>(base_file.tellg()) /
+                     (sizeof(int32_t) + dataset.dim * sizeof(float));
+        if (base_total == dataset.base_rows) {
+            dataset.truth = ReadVecs<int32_t>(prefix + "_groundtruth.ivecs",
+                                              dataset.query_rows,
+                                              dataset.truth_dim);
+            if (dataset.truth_dim < recall_topk ||
+                static_cast<int64_t>(dataset.truth.size()) /
+                        dataset.truth_dim !=
+                    dataset.query_rows) {
+                dataset.truth.clear();
+            }
+        }
+
+        auto schema = std::make_shared<Schema>();
+        auto pk_fid = schema->AddDebugField("id", DataType::INT64);
+        dataset.tag_fid = schema->AddDebugField("tag", DataType::INT64);
+        dataset.vec_fid = schema->AddDebugField(
+            "vec", DataType::VECTOR_FLOAT, dataset.dim, knowhere::metric::L2);
+        schema->set_primary_field_id(pk_fid);
+        dataset.schema = schema;
+
+        // placeholder groups are parsed against a plan of the field
+        auto plan = CreatePlan(*schema, R"({
+            "bool": {
+                "must": [
+                {
+                    "vector": {
+                        "vec": {
+                            "metric_type": "L2",
+                            "params": {},
+                            "query": "$0",
+                            "topk": 1,
+                            "round_decimal": -1
+                        }
+                    }
+                }
+                ]
+            }
+        })");
+        for (int64_t i = 0; i < dataset.query_rows; ++i) {
+            auto raw = CreatePlaceholderGroupFromBlob(
+                1, dataset.dim, dataset.queries.data() + i * dataset.dim);
+            dataset.ph_groups.push_back(
+                ParsePlaceholderGroup(plan.get(), raw.SerializeAsString()));
+        }
+        return dataset;
+    }();
+    return dataset;
+}
+
+void
+LoadScalarField(SegmentSealed& segment,
+                const FieldMeta& field_meta,
+                const std::vector<int64_t>& values) {
+    auto array = CreateScalarDataArrayFrom(
+        values.data(), values.size(), field_meta);
+    LoadFieldDataInfo info;
+    info.field_id = field_meta.get_id().get();
+    info.row_count = values.size();
+    info.field_data = array.get();
+    segment.LoadFieldData(info);
+}
+
+std::unique_ptr<index::VectorIndex>
+BuildIndex(const RecallDataset& dataset, int64_t index_type) {
+    auto conf =
+        knowhere::Json{{knowhere::meta::METRIC_TYPE, knowhere::metric::L2},
+                       {knowhere::meta::DIM, std::to_string(dataset.dim)}};
+    std::unique_ptr<index::VectorIndex> index;
+    if (index_type == RECALL_IVF_FLAT) {
+        // ~4 * sqrt(rows) lists
+        auto nlist = std::max<int64_t>(
+            16, 4 * static_cast<int64_t>(std::sqrt(dataset.base_rows)));
+        conf[knowhere::indexparam::NLIST] = std::to_string(nlist);
+        index = std::make_unique<index::VectorMemNMIndex>(
+            knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, knowhere::metric::L2);
+    } else {
+        conf[knowhere::indexparam::HNSW_M] = "16";
+        conf[knowhere::indexparam::EFCONSTRUCTION] = "200";
+        index = std::make_unique<index::VectorMemIndex>(
+            knowhere::IndexEnum::INDEX_HNSW, knowhere::metric::L2);
+    }
+    auto base = knowhere::GenDataSet(
+        dataset.base_rows, dataset.dim, dataset.base.data());
+    index->BuildWithDataset(base, conf);
+    return index;
+}
+
+// the sealed segment of the dataset searched with the index type, FLAT
+// being a brute force search of the raw vectors
+SegmentSealed&
+GetSegment(int64_t index_type) {
+    static std::mutex mutex;
+    static std::map<int64_t, std::unique_ptr<SegmentSealed>> segments;
+    std::lock_guard lck(mutex);
+    auto& segment = segments[index_type];
+    if (segment != nullptr) {
+        return *segment;
+    }
+
+    auto& dataset = GetDataset();
+    auto rows = dataset.base_rows;
+    segment = CreateSealedSegment(dataset.schema);
+    std::vector<int64_t> values(rows);
+    for (int64_t i = 0; i < rows; ++i) {
+        values[i] = i;
+    }
+    LoadScalarField(
+        *segment, FieldMeta(FieldName("RowID"), RowFieldID, DataType::INT64),
+        values);
+    LoadScalarField(*segment,
+                    FieldMeta(FieldName("Timestamp"),
+                              TimestampFieldID,
+                              DataType::INT64),
+                    std::vector<int64_t>(rows, 1));
+    // the pk of a row is its offset
+    LoadScalarField(*segment, (*dataset.schema)[FieldName("id")], values);
+    for (int64_t i = 0; i < rows; ++i) {
+        values[i] = i % tag_values;
+    }
+    LoadScalarField(*segment, (*dataset.schema)[FieldName("tag")], values);
+
+    if (index_type == RECALL_FLAT) {
+        auto& field_meta = (*dataset.schema)[dataset.vec_fid];
+        auto array =
+            CreateVectorDataArrayFrom(dataset.base.data(), rows, field_meta);
+        LoadFieldDataInfo info;
+        info.field_id = dataset.vec_fid.get();
+        info.row_count = rows;
+        info.field_data = array.get();
+        segment->LoadFieldData(info);
+    } else {
+        LoadIndexInfo info;
+        info.index = BuildIndex(dataset, index_type);
+        info.field_id = dataset.vec_fid.get();
+        info.index_params["index_type"] = index_type == RECALL_IVF_FLAT
+                                              ? "IVF_FLAT"
+                                              : "HNSW";
+        info.index_params["metric_type"] = knowhere::metric::L2;
+        segment->LoadIndex(info);
+    }
+    return *segment;
+}
+
+std::unique_ptr<Plan>
+CreateRecallPlan(const Schema& schema,
+                 int64_t index_type,
+                 int64_t search_param,
+                 int64_t selectivity,
+                 int64_t topk) {
+    std::string params;
+    if (index_type == RECALL_IVF_FLAT) {
+        params = R"("nprobe": )" + std::to_string(search_param);
+    } else if (index_type == RECALL_HNSW) {
+        params = R"("ef": )" + std::to_string(std::max(search_param, topk));
+    }
+    std::string filter;
+    if (selectivity < tag_values) {
+        filter = R"({"range": {"tag": {"LT": )" +
+                 std::to_string(selectivity) + "}}},";
+    }
+    auto dsl = R"({"bool": {"must": [)" + filter +
+               R"({"vector": {"vec": {"metric_type": "L2", "params": {)" +
+               params + R"(}, "query": "$0", "topk": )" +
+               std::to_string(topk) + R"(, "round_decimal": -1}}}]}})";
+    return CreatePlan(schema, dsl);
+}
+
+// the ids of the `recall_topk` nearest rows of every query passing the
+// filter letting `selectivity` percent of the rows through
+const std::vector<int64_t>&
+GetTruth(int64_t selectivity) {
+    static std::mutex mutex;
+    static std::map<int64_t, std::vector<int64_t>> truths;
+    std::lock_guard lck(mutex);
+    auto& truth = truths[selectivity];
+    if (!truth.empty()) {
+        return truth;
+    }
+
+    auto& dataset = GetDataset();
+    truth.resize(dataset.query_rows * recall_topk);
+    if (selectivity >= tag_values && !dataset.truth.empty()) {
+        for (int64_t i = 0; i < dataset.query_rows; ++i) {
+            std::copy_n(dataset.truth.begin() + i * dataset.truth_dim,
+                        recall_topk,
+                        truth.begin() + i * recall_topk);
+        }
+        return truth;
+    }
+
+    auto& segment = GetSegment(RECALL_FLAT);
+    auto plan = CreateRecallPlan(
+        *dataset.schema, RECALL_FLAT, 0, selectivity, recall_topk);
+    for (int64_t i = 0; i < dataset.query_rows; ++i) {
+        auto result = segment.Search(
+            plan.get(), dataset.ph_groups[i].get(), MAX_TIMESTAMP);
+        std::copy_n(result->seg_offsets_.begin(),
+                    recall_topk,
+                    truth.begin() + i * recall_topk);
+    }
+    return truth;
+}
+
+}  // namespace
+
+static void
+Search_Recall(benchmark::State& state) {
+    auto index_type = state.range(0);
+    auto search_param = state.range(1);
+    auto selectivity = state.range(2);
+    auto& dataset = GetDataset();
+    if (!dataset.loaded()) {
+        state.SkipWithError("no dataset in $MILVUS_BENCH_DATASET_DIR");
+        return;
+    }
+    auto& segment = GetSegment(index_type);
+    auto& truth = GetTruth(selectivity);
+    auto plan = CreateRecallPlan(*dataset.schema,
+                                 index_type,
+                                 search_param,
+                                 selectivity,
+                                 recall_topk);
+
+    // the threads take the queries in turn
+    auto query = state.thread_index() % dataset.query_rows;
+    int64_t hits = 0;
+    int64_t expected = 0;
+    std::vector<double> latencies;
+    for (auto _ : state) {
+        auto begin = std::chrono::steady_clock::now();
+        auto result = segment.Search(
+            plan.get(), dataset.ph_groups[query].get(), MAX_TIMESTAMP);
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(
+            std::chrono::duration<double, std::micro>(end - begin).count());
+
+        std::unordered_set<int64_t> nearest;
+        for (int64_t k = 0; k < recall_topk; ++k) {
+            auto id = truth[query * recall_topk + k];
+            if (id >= 0) {
+                nearest.insert(id);
+            }
+        }
+        for (auto offset : result->seg_offsets_) {
+            hits += nearest.count(offset);
+        }
+        expected += nearest.size();
+        query = (query + state.threads()) % dataset.query_rows;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto p99 = latencies.empty()
+                   ? 0.0
+                   : latencies[(latencies.size() - 1) * 99 / 100];
+    state.counters["recall"] = benchmark::Counter(
+        expected == 0 ? 1.0 : static_cast<double>(hits) / expected,
+        benchmark::Counter::kAvgThreads);
+    state.counters["qps"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    // of every thread, averaged over them
+    state.counters["p99_us"] =
+        benchmark::Counter(p99, benchmark::Counter::kAvgThreads);
+}
+
+BENCHMARK(Search_Recall)
+    ->ArgNames({"index", "param", "selectivity"})
+    ->ArgsProduct({{RECALL_FLAT}, {0}, {100, 10, 1}})
+    ->ArgsProduct({{RECALL_IVF_FLAT}, {1, 8, 32, 128}, {100, 10, 1}})
+    ->ArgsProduct({{RECALL_HNSW}, {16, 64, 256}, {100, 10, 1}})
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime()
+    ->MinTime(5);
@@ -0,0 +1,237 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <boost/format.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/Consts.h"
+#include "query/Plan.h"
+#include "segcore/Reduce.h"
+#include "segcore/SegmentSealed.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+namespace {
+
+constexpr int reduce_dim = 32;
+// rows of the segment every search result refers to
+constexpr int64_t reduce_rows = 1000 * 1000;
+// the hits of all segment results of one reduce are capped, so the sweep
+// stays within memory
+constexpr int64_t max_reduce_hits = 16 * 1000 * 1000;
+
+struct ReduceSegment {
+    SchemaPtr schema;
+    FieldId vec_fid;
+    FieldId int32_fid;
+    std::unique_ptr<SegmentSealed> segment;
+};
+
+// a sealed segment with a float vector, a pk of `pk_type` and an int32
+// field, the search results of every segment of a reduce point to it
+ReduceSegment&
+GetSegment(DataType pk_type) {
+    static std::map<DataType, ReduceSegment> segments;
+    auto& result = segments[pk_type];
+    if (result.segment != nullptr) {
+        return result;
+    }
+    result.schema = std::make_shared<Schema>();
+    result.vec_fid = result.schema->AddDebugField(
+        "vec", DataType::VECTOR_FLOAT, reduce_dim, knowhere::metric::L2);
+    auto pk_fid = result.schema->AddDebugField("pk", pk_type);
+    result.int32_fid = result.schema->AddDebugField("int32", DataType::INT32);
+    result.schema->set_primary_field_id(pk_fid);
+    auto dataset = DataGen(result.schema, reduce_rows);
+    result.segment = CreateSealedSegment(result.schema);
+    SealedLoadFieldData(dataset, *result.segment);
+    return result;
+}
+
+std::unique_ptr<Plan>
+CreateReducePlan(const ReduceSegment& segment,
+                 int64_t topk,
+                 bool output_fields) {
+    auto text_plan = boost::format(R"(vector_anns: <
+                                        field_id: %1%
+                                        query_info: <
+                                            topk: %2%
+                                            metric_type: "L2"
+                                            search_params: "{\"nprobe\": 16}"
+                                        >
+                                        placeholder_tag: "$0">)") %
+                     segment.vec_fid.get() % topk;
+    auto text = text_plan.str();
+    if (output_fields) {
+        text += " output_field_ids: " + std::to_string(segment.vec_fid.get()) +
+                " output_field_ids: " +
+                std::to_string(segment.int32_fid.get());
+    }
+    auto binary_plan = translate_text_plan_to_binary_plan(text.c_str());
+    return CreateSearchPlanByExpr(
+        *segment.schema, binary_plan.data(), binary_plan.size());
+}
+
+// offsets and distances of the search result of every segment, a
+// `dup_percent` part of the hits of each segment repeats the hits of the
+// first one, and the last twentieth of every topk is invalid
+struct ResultTemplate {
+    std::vector<std::vector<int64_t>> seg_offsets;
+    std::vector<std::vector<float>> distances;
+};
+
+ResultTemplate
+GenResults(int64_t segments, int64_t nq, int64_t topk, int64_t dup_percent) {
+    ResultTemplate results;
+    std::default_random_engine er(42);
+    std::uniform_int_distribution<int64_t> offset_dist(0, reduce_rows - 1);
+    std::uniform_real_distribution<float> distance_dist(0, 1);
+    std::uniform_int_distribution<int64_t> percent_dist(0, 99);
+    auto valid = topk - topk / 20;
+    for (int64_t s = 0; s < segments; ++s) {
+        std::vector<int64_t> offsets(nq * topk, INVALID_SEG_OFFSET);
+        std::vector<float> distances(nq * topk, 0);
+        for (int64_t q = 0; q < nq; ++q) {
+            auto begin = q * topk;
+            for (int64_t j = 0; j < valid; ++j) {
+                if (s > 0 && percent_dist(er) < dup_percent) {
+                    offsets[begin + j] = results.seg_offsets[0][begin + j];
+                    distances[begin + j] = results.distances[0][begin + j];
+                } else {
+                    offsets[begin + j] = offset_dist(er);
+                    distances[begin + j] = distance_dist(er);
+                }
+            }
+            std::sort(distances.begin() + begin,
+                      distances.begin() + begin + valid,
+                      std::greater<float>());
+        }
+        results.seg_offsets.push_back(std::move(offsets));
+        results.distances.push_back(std::move(distances));
+    }
+    return results;
+}
+
+// reduces the search results of `segments` segments with ReduceHelper,
+// each phase is reported as its average time per reduce in microseconds
+void
+Reduce_Segments(benchmark::State& state) {
+    auto segments = state.range(0);
+    auto nq = state.range(1);
+    auto topk = state.range(2);
+    auto pk_type = state.range(3) == 0 ? DataType::INT64 : DataType::VARCHAR;
+    auto dup_percent = state.range(4);
+    auto output_fields = state.range(5) != 0;
+
+    auto& segment = GetSegment(pk_type);
+    auto plan = CreateReducePlan(segment, topk, output_fields);
+    auto templates = GenResults(segments, nq, topk, dup_percent);
+
+    ReduceHelper::PhaseTimes total;
+    int64_t blob_bytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<SearchResult>> results;
+        std::vector<SearchResult*> result_ptrs;
+        for (int64_t s = 0; s < segments; ++s) {
+            auto result = std::make_unique<SearchResult>();
+            result->total_nq_ = nq;
+            result->unity_topK_ = topk;
+            result->segment_ =
+                static_cast<SegmentInterface*>(segment.segment.get());
+            result->seg_offsets_ = templates.seg_offsets[s];
+            result->distances_ = templates.distances[s];
+            result_ptrs.push_back(result.get());
+            results.push_back(std::move(result));
+        }
+        int64_t slice_nqs[] = {nq};
+        int64_t slice_topks[] = {topk};
+        state.ResumeTiming();
+
+        ReduceHelper reduce_helper(
+            result_ptrs, plan.get(), slice_nqs, slice_topks, 1);
+        reduce_helper.Reduce();
+        reduce_helper.FillEntryData();
+        reduce_helper.Marshal();
+        std::unique_ptr<SearchResultDataBlobs> blobs(
+            static_cast<SearchResultDataBlobs*>(
+                reduce_helper.GetSearchResultDataBlobs()));
+
+        state.PauseTiming();
+        auto& times = reduce_helper.phase_times();
+        total.filter_invalid_search_result +=
+            times.filter_invalid_search_result;
+        total.fill_primary_key += times.fill_primary_key;
+        total.reduce_result_data += times.reduce_result_data;
+        total.fill_entry_data += times.fill_entry_data;
+        total.marshal += times.marshal;
+        blob_bytes = blobs->offsets.back();
+        blobs.reset();
+        results.clear();
+        state.ResumeTiming();
+    }
+
+    auto average_us = [&](int64_t nanos) {
+        return benchmark::Counter(nanos / 1e3,
+                                  benchmark::Counter::kAvgIterations);
+    };
+    state.counters["filter_us"] =
+        average_us(total.filter_invalid_search_result);
+    state.counters["fill_pk_us"] = average_us(total.fill_primary_key);
+    state.counters["reduce_us"] = average_us(total.reduce_result_data);
+    state.counters["fill_entry_us"] = average_us(total.fill_entry_data);
+    state.counters["marshal_us"] = average_us(total.marshal);
+    state.counters["blob_bytes"] = blob_bytes;
+    state.SetItemsProcessed(state.iterations() * segments * nq * topk);
+}
+
+void
+ReduceArgs(benchmark::internal::Benchmark* bench) {
+    for (auto segments : {1, 10, 50, 200}) {
+        for (auto nq : {1, 100, 10000}) {
+            for (auto topk : {10, 100, 1000, 16384}) {
+                if (int64_t(segments) * nq * topk > max_reduce_hits) {
+                    continue;
+                }
+                for (auto pk_type : {0, 1}) {
+                    for (auto dup_percent : {0, 50}) {
+                        for (auto output_fields : {0, 1}) {
+                            bench->Args({segments,
+                                         nq,
+                                         topk,
+                                         pk_type,
+                                         dup_percent,
+                                         output_fields});
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(Reduce_Segments)
+    ->ArgNames({"segments", "nq", "topk", "varchar_pk", "dup%", "output"})
+    ->Apply(ReduceArgs)
+    ->Unit(benchmark::kMillisecond);
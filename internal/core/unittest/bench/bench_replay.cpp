@@ -0,0 +1,296 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/LoadInfo.h"
+#include "exceptions/EasyAssert.h"
+#include "query/Plan.h"
+#include "segcore/Collection.h"
+#include "segcore/QueryCapture.h"
+#include "segcore/SegmentSealed.h"
+#include "storage/DataCodec.h"
+
+using namespace milvus;
+using namespace milvus::segcore;
+
+// Replays the queries captured by SegcoreSetQueryCapture against sealed
+// segments loaded from their binlogs, and prints the latency distribution
+// of the searches and the retrieves next to the one they were captured
+// with:
+//
+//   replay_bench --schema <file> --segments <file> --capture <file>
+//                [--concurrency <threads>] [--repeat <times>]
+//
+// The schema is the CollectionSchema in the text format given to
+// NewCollection. Every line of the segments file is the binlogs of a field
+// of a segment, `<segment id> <field id> <row count> <path>...`, for the
+// row ids (field 0), the timestamps (field 1) and every other field; the
+// vector fields are searched without their index, and the deletes aren't
+// loaded. The queries of the segments which aren't loaded are skipped.
+
+namespace {
+
+struct ReplayOptions {
+    std::string schema_path;
+    std::string segments_path;
+    std::string capture_path;
+    int64_t concurrency = 1;
+    int64_t repeat = 1;
+};
+
+[[noreturn]] void
+Usage(const char* error) {
+    std::cerr << error << "\n"
+              << "usage: replay_bench --schema <file> --segments <file> "
+                 "--capture <file> [--concurrency <threads>] "
+                 "[--repeat <times>]"
+              << std::endl;
+    std::exit(1);
+}
+
+ReplayOptions
+ParseOptions(int argc, char** argv) {
+    ReplayOptions options;
+    for (int i = 1; i < argc; i += 2) {
+        std::string name = argv[i];
+        if (i + 1 >= argc) {
+            Usage(("no value of " + name).c_str());
+        }
+        std::string value = argv[i + 1];
+        if (name == "--schema") {
+            options.schema_path = value;
+        } else if (name == "--segments") {
+            options.segments_path = value;
+        } else if (name == "--capture") {
+            options.capture_path = value;
+        } else if (name == "--concurrency") {
+            options.concurrency = std::atoll(value.c_str());
+        } else if (name == "--repeat") {
+            options.repeat = std::atoll(value.c_str());
+        } else {
+            Usage(("unknown option " + name).c_str());
+        }
+    }
+    if (options.schema_path.empty() || options.segments_path.empty() ||
+        options.capture_path.empty()) {
+        Usage("--schema, --segments and --capture are required");
+    }
+    if (options.concurrency < 1 || options.repeat < 1) {
+        Usage("--concurrency and --repeat must be positive");
+    }
+    return options;
+}
+
+std::string
+ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    AssertInfo(in.is_open(), "failed to open " + path);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+std::map<int64_t, std::unique_ptr<SegmentSealed>>
+LoadSegments(const std::string& path, const SchemaPtr& schema) {
+    // the binlogs of every field of every segment, in the order of the file
+    std::map<int64_t, std::vector<FieldDataInfo>> fields;
+    std::ifstream in(path);
+    AssertInfo(in.is_open(), "failed to open " + path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream words(line);
+        int64_t segment_id = 0;
+        FieldDataInfo info{};
+        AssertInfo(
+            static_cast<bool>(words >> segment_id >> info.field_id >>
+                              info.row_count),
+            "invalid line of " + path + ": " + line);
+        std::string binlog_path;
+        while (words >> binlog_path) {
+            auto content = ReadFile(binlog_path);
+            auto size = static_cast<int64_t>(content.size());
+            auto binlog = std::shared_ptr<uint8_t[]>(new uint8_t[size]);
+            std::copy(content.begin(), content.end(), binlog.get());
+            auto codec = storage::DeserializeFileData(binlog, size);
+            info.datas.push_back(codec->GetFieldData());
+        }
+        fields[segment_id].push_back(std::move(info));
+    }
+
+    std::map<int64_t, std::unique_ptr<SegmentSealed>> segments;
+    for (auto& [segment_id, infos] : fields) {
+        auto segment = CreateSealedSegment(schema, segment_id);
+        for (auto& info : infos) {
+            segment->LoadFieldData(info);
+        }
+        std::cout << "loaded segment " << segment_id << " of "
+                  << segment->get_row_count() << " rows" << std::endl;
+        segments[segment_id] = std::move(segment);
+    }
+    return segments;
+}
+
+struct Latencies {
+    std::vector<int64_t> replayed_us;
+    std::vector<int64_t> captured_us;
+};
+
+int64_t
+Percentile(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto rank = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[rank];
+}
+
+void
+Report(const char* kind, Latencies& latencies, double seconds) {
+    auto& replayed = latencies.replayed_us;
+    auto& captured = latencies.captured_us;
+    if (replayed.empty()) {
+        return;
+    }
+    std::sort(replayed.begin(), replayed.end());
+    std::sort(captured.begin(), captured.end());
+    std::cout << kind << ": " << replayed.size() << " queries, "
+              << replayed.size() / seconds << " qps\n";
+    std::cout << "  latency us     p50     p90     p99   p99.9     max\n";
+    auto print = [](const char* name, const std::vector<int64_t>& sorted) {
+        std::cout << name;
+        for (auto p : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+            std::cout << " " << std::setw(7) << Percentile(sorted, p);
+        }
+        std::cout << "\n";
+    };
+    print("  replayed", replayed);
+    print("  captured", captured);
+    std::cout << std::flush;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+    auto options = ParseOptions(argc, argv);
+    Collection collection(ReadFile(options.schema_path));
+    auto& schema = collection.get_schema();
+    auto segments = LoadSegments(options.segments_path, schema);
+
+    // the plans are created once, before the replay
+    auto captured = QueryCapture::Read(options.capture_path);
+    struct Query {
+        const CapturedQuery* captured;
+        const SegmentSealed* segment;
+        std::unique_ptr<query::Plan> plan;
+        std::unique_ptr<query::RetrievePlan> retrieve_plan;
+    };
+    std::vector<Query> queries;
+    int64_t skipped = 0;
+    for (auto& query : captured) {
+        auto it = segments.find(query.segment_id);
+        if (it == segments.end()) {
+            ++skipped;
+            continue;
+        }
+        Query replayed{&query, it->second.get(), nullptr, nullptr};
+        if (query.kind == CapturedQuery::Search) {
+            replayed.plan = query::CreateSearchPlanByExpr(
+                *schema, query.plan.data(), query.plan.size());
+        } else {
+            replayed.retrieve_plan = query::CreateRetrievePlanByExpr(
+                *schema, query.plan.data(), query.plan.size());
+        }
+        queries.push_back(std::move(replayed));
+    }
+    std::cout << "replaying " << queries.size() << " of "
+              << captured.size() << " queries, " << skipped
+              << " of segments not loaded, with " << options.concurrency
+              << " threads" << std::endl;
+    if (queries.empty()) {
+        return 0;
+    }
+
+    // the threads take the queries in the order they were captured
+    auto total = static_cast<int64_t>(queries.size()) * options.repeat;
+    std::atomic<int64_t> next = 0;
+    std::vector<Latencies> searches(options.concurrency);
+    std::vector<Latencies> retrieves(options.concurrency);
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < options.concurrency; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = next.fetch_add(1); i < total;
+                 i = next.fetch_add(1)) {
+                auto& query = queries[i % queries.size()];
+                auto& capture = *query.captured;
+                auto start = std::chrono::steady_clock::now();
+                if (query.plan != nullptr) {
+                    query.segment->Search(query.plan.get(),
+                                          &capture.placeholder_group,
+                                          capture.timestamp);
+                } else {
+                    query.segment->Retrieve(query.retrieve_plan.get(),
+                                            capture.timestamp);
+                }
+                auto latency =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+                auto& latencies =
+                    query.plan != nullptr ? searches[t] : retrieves[t];
+                latencies.replayed_us.push_back(latency);
+                latencies.captured_us.push_back(capture.latency_us);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+
+    auto merge = [](const std::vector<Latencies>& per_thread) {
+        Latencies merged;
+        for (auto& latencies : per_thread) {
+            merged.replayed_us.insert(merged.replayed_us.end(),
+                                      latencies.replayed_us.begin(),
+                                      latencies.replayed_us.end());
+            merged.captured_us.insert(merged.captured_us.end(),
+                                      latencies.captured_us.begin(),
+                                      latencies.captured_us.end());
+        }
+        return merged;
+    };
+    auto merged_searches = merge(searches);
+    auto merged_retrieves = merge(retrieves);
+    Report("search", merged_searches, seconds);
+    Report("retrieve", merged_retrieves, seconds);
+    return 0;
+}
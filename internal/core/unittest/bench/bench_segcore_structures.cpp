@@ -0,0 +1,408 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "common/Column.h"
+#include "common/Types.h"
+#include "segcore/AckResponder.h"
+#include "segcore/ConcurrentVector.h"
+#include "segcore/DeletedRecord.h"
+#include "segcore/FieldDataColumn.h"
+#include "segcore/InsertRecord.h"
+#include "storage/FieldDataFactory.h"
+
+using namespace milvus;
+using namespace milvus::segcore;
+
+namespace {
+
+// the cache misses of the calling thread, counted only where the kernel
+// lets perf_event_open measure the thread, e.g. perf_event_paranoid <= 2
+class CacheMisses {
+ public:
+    CacheMisses() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    ~CacheMisses() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    CacheMisses(const CacheMisses&) = delete;
+    CacheMisses&
+    operator=(const CacheMisses&) = delete;
+
+    // sets the cache_misses counter of `state` per iteration, nothing if
+    // the counter couldn't be opened
+    void
+    Report(benchmark::State& state) {
+#ifdef __linux__
+        if (fd_ < 0) {
+            return;
+        }
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t count = 0;
+        if (read(fd_, &count, sizeof(count)) == sizeof(count)) {
+            state.counters["cache_misses"] = benchmark::Counter(
+                double(count), benchmark::Counter::kAvgIterations);
+        }
+#endif
+    }
+
+ private:
+    int fd_ = -1;
+};
+
+// rows a batch of writes or lookups touches, so the loop costs little
+constexpr int64_t batch = 64;
+constexpr int64_t size_per_chunk = 32 * 1024;
+// the rows of the shared structures, a few times the last level cache
+constexpr int64_t num_rows = 1 << 22;
+
+std::vector<int64_t>
+RandomRows(int64_t n, uint64_t seed) {
+    std::vector<int64_t> rows(n);
+    std::mt19937_64 rng(seed);
+    for (auto& row : rows) {
+        row = int64_t(rng() >> 1);
+    }
+    return rows;
+}
+
+}  // namespace
+
+// a single writer appends batches to a growing column, the chunks it
+// allocates on the way included
+static void
+ConcurrentVector_Append(benchmark::State& state) {
+    auto rows = RandomRows(batch, 0);
+    CacheMisses misses;
+    for (auto _ : state) {
+        ConcurrentVector<int64_t> vec(state.range(0));
+        for (int64_t offset = 0; offset < num_rows; offset += batch) {
+            vec.set_data_raw(offset, rows.data(), batch);
+        }
+        benchmark::DoNotOptimize(vec.num_chunk());
+    }
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations() * num_rows);
+}
+
+// thread 0 appends batches while the others look up random acked rows, the
+// writer wraps to overwrite rows once the column is full
+static void
+ConcurrentVector_AppendRead(benchmark::State& state) {
+    static std::unique_ptr<ConcurrentVector<int64_t>> vec;
+    static std::atomic<int64_t> acked;
+    auto rows = RandomRows(batch, state.thread_index());
+    if (state.thread_index() == 0) {
+        vec = std::make_unique<ConcurrentVector<int64_t>>(size_per_chunk);
+        vec->set_data_raw(0, rows.data(), batch);
+        acked.store(batch);
+    }
+    std::mt19937_64 rng(state.thread_index());
+    int64_t next = batch;
+    int64_t sum = 0;
+    CacheMisses misses;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            vec->set_data_raw(next, rows.data(), batch);
+            next = (next + batch) % num_rows;
+            if (acked.load(std::memory_order_relaxed) < num_rows) {
+                acked.fetch_add(batch, std::memory_order_release);
+            }
+            continue;
+        }
+        auto size = acked.load(std::memory_order_acquire);
+        for (int64_t i = 0; i < batch; ++i) {
+            sum += (*vec)[rng() % size];
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations() * batch);
+    state.SetLabel(state.thread_index() == 0 ? "writer" : "reader");
+    if (state.thread_index() == 0) {
+        vec.reset();
+    }
+}
+
+// every thread grows the shared vector by one element and reads a random
+// one, the growth takes the lock until the vector reaches its capacity
+static void
+ThreadSafeVector_EmplaceRead(benchmark::State& state) {
+    static std::unique_ptr<ThreadSafeVector<int64_t>> vec;
+    static std::atomic<int64_t> next;
+    if (state.thread_index() == 0) {
+        vec = std::make_unique<ThreadSafeVector<int64_t>>();
+        vec->emplace_to_at_least(1, 0);
+        next.store(1);
+    }
+    std::mt19937_64 rng(state.thread_index());
+    int64_t sum = 0;
+    CacheMisses misses;
+    for (auto _ : state) {
+        auto size = std::min(next.fetch_add(1) + 1, num_rows);
+        vec->emplace_to_at_least(size, size);
+        sum += (*vec)[rng() % vec->size()];
+    }
+    benchmark::DoNotOptimize(sum);
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        vec.reset();
+    }
+}
+
+// every thread takes the next batch of offsets, acks it and reads the ack,
+// the batches of the threads are acked out of order
+static void
+AckResponder_AddSegment(benchmark::State& state) {
+    static std::unique_ptr<AckResponder> ack;
+    static std::atomic<int64_t> reserved;
+    if (state.thread_index() == 0) {
+        ack = std::make_unique<AckResponder>();
+        reserved.store(0);
+    }
+    int64_t sum = 0;
+    CacheMisses misses;
+    for (auto _ : state) {
+        auto begin = reserved.fetch_add(batch);
+        ack->AddSegment(begin, begin + batch);
+        sum += ack->GetAck();
+    }
+    benchmark::DoNotOptimize(sum);
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        ack.reset();
+    }
+}
+
+// batched lookups of random existing int64 pks, in the hash map of growing
+// segments (0) and the sorted index of sealed ones (1)
+static void
+OffsetMap_FindMany(benchmark::State& state) {
+    static std::unique_ptr<OffsetMap> map;
+    static std::vector<PkType> pks;
+    if (state.thread_index() == 0) {
+        if (state.range(0) == 0) {
+            map = std::make_unique<OffsetHashMap<int64_t>>();
+        } else {
+            map = std::make_unique<OffsetSortedIndex<int64_t>>();
+        }
+        auto rows = RandomRows(num_rows, 42);
+        pks.assign(rows.begin(), rows.end());
+        for (int64_t i = 0; i < num_rows; ++i) {
+            map->insert(pks[i], i);
+        }
+        map->seal();
+    }
+    std::mt19937_64 rng(state.thread_index());
+    std::vector<PkType> probes(batch);
+    std::vector<OffsetMap::PkOffset> result;
+    CacheMisses misses;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (auto& probe : probes) {
+            probe = pks[rng() % num_rows];
+        }
+        result.clear();
+        state.ResumeTiming();
+        map->find_many(probes.data(), batch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations() * batch);
+    if (state.thread_index() == 0) {
+        map.reset();
+        pks.clear();
+    }
+}
+
+// every thread clones the deleted bitmap of a segment of range(0) rows the
+// way a search snapshots it, then applies a batch of new deletes, which
+// copies only the blocks they fall in
+static void
+DeletedRecord_CloneBitmap(benchmark::State& state) {
+    static std::unique_ptr<DeletedRecord::TmpBitmap> bitmap;
+    auto rows = state.range(0);
+    if (state.thread_index() == 0) {
+        bitmap = std::make_unique<DeletedRecord::TmpBitmap>();
+        bitmap->bitmap.resize(rows);
+        for (int64_t i = 0; i < rows; i += 97) {
+            bitmap->bitmap.set(i);
+        }
+    }
+    std::mt19937_64 rng(state.thread_index());
+    CacheMisses misses;
+    for (auto _ : state) {
+        auto clone = bitmap->clone(rows + batch);
+        for (int64_t i = 0; i < batch; ++i) {
+            clone->bitmap.set(rng() % (rows + batch));
+        }
+        benchmark::DoNotOptimize(clone.get());
+    }
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        bitmap.reset();
+    }
+}
+
+// reads of a sealed int64 column in anonymous memory (0) or mapped from a
+// file (1), batches of random rows (0) or a sequential window (1)
+static void
+Column_Read(benchmark::State& state) {
+    static std::unique_ptr<Column> column;
+    auto mmap = state.range(0) != 0;
+    auto sequential = state.range(1) != 0;
+    if (state.thread_index() == 0) {
+        FieldMeta field_meta(
+            FieldName("pk"), FieldId(100), DataType::INT64);
+        auto rows = RandomRows(num_rows, 7);
+        auto field_data = storage::FieldDataFactory::GetInstance()
+                              .CreateFieldData(DataType::INT64);
+        field_data->FillFieldData(rows.data(), num_rows);
+        FieldDataInfo info{100, {field_data}, num_rows};
+        if (mmap) {
+            info.mmap_dir_path = "./data/mmap-bench";
+        }
+        column = MakeColumn(0, field_meta, info);
+    }
+    auto data = static_cast<const int64_t*>(column->span().data());
+    constexpr int64_t window = 4096;
+    std::mt19937_64 rng(state.thread_index());
+    int64_t sum = 0;
+    CacheMisses misses;
+    for (auto _ : state) {
+        if (sequential) {
+            auto begin = rng() % (num_rows - window);
+            for (int64_t i = 0; i < window; ++i) {
+                sum += data[begin + i];
+            }
+        } else {
+            for (int64_t i = 0; i < window; ++i) {
+                sum += data[rng() % num_rows];
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations() * window);
+    if (state.thread_index() == 0) {
+        column.reset();
+    }
+}
+
+// the ops filters and delete masks combine bitsets of range(0) rows with:
+// and (0), or (1), count (2), flip (3)
+static void
+Bitset_Op(benchmark::State& state) {
+    auto rows = state.range(0);
+    auto op = state.range(1);
+    BitsetType left(rows);
+    BitsetType right(rows);
+    std::mt19937_64 rng(state.thread_index());
+    for (int64_t i = 0; i < rows; ++i) {
+        left[i] = rng() & 1;
+        right[i] = rng() & 1;
+    }
+    size_t sum = 0;
+    CacheMisses misses;
+    for (auto _ : state) {
+        switch (op) {
+            case 0:
+                left &= right;
+                break;
+            case 1:
+                left |= right;
+                break;
+            case 2:
+                sum += left.count();
+                break;
+            default:
+                left.flip();
+                break;
+        }
+        benchmark::DoNotOptimize(left);
+    }
+    benchmark::DoNotOptimize(sum);
+    misses.Report(state);
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+BENCHMARK(ConcurrentVector_Append)
+    ->ArgName("size_per_chunk")
+    ->Arg(1024)
+    ->Arg(size_per_chunk)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(ConcurrentVector_AppendRead)->Threads(2)->Threads(4)->Threads(16);
+BENCHMARK(ThreadSafeVector_EmplaceRead)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
+BENCHMARK(AckResponder_AddSegment)->Threads(1)->Threads(4)->Threads(16);
+BENCHMARK(OffsetMap_FindMany)
+    ->ArgName("sealed")
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
+BENCHMARK(DeletedRecord_CloneBitmap)
+    ->ArgName("rows")
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
+BENCHMARK(Column_Read)
+    ->ArgNames({"mmap", "sequential"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
+BENCHMARK(Bitset_Op)
+    ->ArgNames({"rows", "op"})
+    ->ArgsProduct({{1 << 16, 1 << 20}, {0, 1, 2, 3}})
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
@@ -10,11 +10,17 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <utility>
 
 #include "common/Utils.h"
 
+#include "query/BinaryBruteForce.h"
+#include "query/BlockedBruteForce.h"
 #include "query/SearchBruteForce.h"
+#include "query/SketchBruteForce.h"
 #include "test_utils/Distance.h"
 #include "test_utils/DataGen.h"
 
@@ -130,8 +136,9 @@ class TestFloatSearchBruteForce : public ::testing::Test {
             // ASSERT_ANY_THROW(BruteForceSearch(dataset, base.data(), nb, bitset_view));
             return;
         }
-        auto result = BruteForceSearch(
-            dataset, base.data(), nb, knowhere::Json(), bitset_view);
+        auto params = ParseSearchParams(knowhere::Json(), topk, metric_type);
+        auto result =
+            BruteForceSearch(dataset, base.data(), nb, *params, bitset_view);
         for (int i = 0; i < nq; i++) {
             auto ref = Ref(base.data(),
                            query.data() + i * dim,
@@ -143,6 +150,67 @@ class TestFloatSearchBruteForce : public ::testing::Test {
             AssertMatch(ref, ans);
         }
     }
+
+    // the blocked search over two chunks matches knowhere over the whole
+    // base, with every third row filtered out, given the norms of the rows
+    // or computing them
+    void
+    RunBlocked(int nb,
+               int nq,
+               int topk,
+               int dim,
+               const knowhere::MetricType& metric_type,
+               bool with_norms = false) {
+        BitsetType bitset(nb);
+        for (int i = 0; i < nb; i += 3) {
+            bitset.set(i);
+        }
+        BitsetView bitset_view(bitset);
+
+        auto base = GenFloatVecs(dim, nb, metric_type);
+        auto query = GenFloatVecs(dim, nq, metric_type, 43);
+
+        dataset::SearchDataset dataset{
+            metric_type, nq, topk, -1, dim, query.data()};
+        auto params = ParseSearchParams(knowhere::Json(), topk, metric_type);
+        auto expected =
+            BruteForceSearch(dataset, base.data(), nb, *params, bitset_view);
+
+        std::vector<float> norms;
+        if (with_norms) {
+            norms.resize(nb);
+            BlockedBruteForce::SquaredNorms(base.data(), nb, dim, norms.data());
+        }
+        auto norms_at = [&](int offset) {
+            return with_norms ? norms.data() + offset : nullptr;
+        };
+
+        BlockedBruteForce brute_force(query.data(), nq, dim, topk, metric_type);
+        auto first = nb / 3;
+        brute_force.Add(base.data(),
+                        first,
+                        0,
+                        bitset_view.subview(0, first),
+                        norms_at(0));
+        brute_force.Add(base.data() + first * dim,
+                        nb - first,
+                        first,
+                        bitset_view.subview(first, nb - first),
+                        norms_at(first));
+        SubSearchResult result(nq, topk, metric_type, -1);
+        brute_force.Finish(result);
+        for (int i = 0; i < nq * topk; i++) {
+            ASSERT_EQ(result.get_seg_offsets()[i],
+                      expected.get_seg_offsets()[i]);
+            if (expected.get_seg_offsets()[i] == INVALID_SEG_OFFSET) {
+                continue;
+            }
+            auto distance = expected.get_distances()[i];
+            ASSERT_NEAR(result.get_distances()[i],
+                        distance,
+                        1e-3 * std::abs(distance) + 1e-4);
+        }
+    }
 };
 
 TEST_F(TestFloatSearchBruteForce, L2) {
@@ -158,3 +226,162 @@ TEST_F(TestFloatSearchBruteForce, IP) {
 TEST_F(TestFloatSearchBruteForce, NotSupported) {
     Run(100, 10, 5, 128, "aaaaaaaaaaaa");
 }
+
+TEST_F(TestFloatSearchBruteForce, Blocked) {
+    // query counts off the tile size, more valid rows than topk and fewer
+    RunBlocked(1000, 13, 10, 128, "L2");
+    RunBlocked(1000, 1, 10, 16, "IP");
+    RunBlocked(20, 9, 20, 7, "L2");
+    RunBlocked(1000, 13, 10, 128, "COSINE");
+}
+
+TEST_F(TestFloatSearchBruteForce, BlockedWithNorms) {
+    RunBlocked(1000, 13, 10, 128, "L2", true);
+    RunBlocked(1000, 5, 10, 16, "COSINE", true);
+    RunBlocked(20, 9, 20, 7, "IP", true);
+}
+
+TEST(BinaryBruteForce, MatchesNaive) {
+    // more valid rows than topk and fewer, and a dim off the registers
+    struct Case {
+        int nb, nq, topk, dim;
+    };
+    for (auto [nb, nq, topk, dim] : {Case{1000, 5, 10, 512},
+                                     Case{600, 3, 10, 136},
+                                     Case{20, 2, 30, 64}}) {
+        for (knowhere::MetricType metric :
+             {knowhere::metric::HAMMING, knowhere::metric::JACCARD}) {
+            auto code_size = dim / 8;
+            std::default_random_engine er(42);
+            std::uniform_int_distribution<int> dist(0, 255);
+            std::vector<uint8_t> base(nb * code_size), query(nq * code_size);
+            for (auto& v : base) {
+                v = dist(er);
+            }
+            for (auto& v : query) {
+                v = dist(er);
+            }
+            BitsetType bitset(nb);
+            for (int i = 0; i < nb; i += 3) {
+                bitset.set(i);
+            }
+            BitsetView bitset_view(bitset);
+
+            BinaryBruteForce brute_force(query.data(), nq, dim, topk, metric);
+            auto first = nb / 3;
+            brute_force.Add(
+                base.data(), first, 0, bitset_view.subview(0, first));
+            brute_force.Add(base.data() + first * code_size,
+                            nb - first,
+                            first,
+                            bitset_view.subview(first, nb - first));
+            SubSearchResult result(nq, topk, metric, -1);
+            brute_force.Finish(result);
+
+            for (int q = 0; q < nq; ++q) {
+                std::vector<std::pair<float, int64_t>> naive;
+                for (int r = 0; r < nb; ++r) {
+                    if (bitset[r]) {
+                        continue;
+                    }
+                    int num = 0, den = 0;
+                    for (int i = 0; i < code_size; ++i) {
+                        auto a = query[q * code_size + i];
+                        auto b = base[r * code_size + i];
+                        if (metric == knowhere::metric::HAMMING) {
+                            num += __builtin_popcount(a ^ b);
+                        } else {
+                            num += __builtin_popcount(a & b);
+                            den += __builtin_popcount(a | b);
+                        }
+                    }
+                    auto distance = metric == knowhere::metric::HAMMING
+                                        ? float(num)
+                                        : 1.0f - float(num) / float(den);
+                    naive.emplace_back(distance, r);
+                }
+                std::sort(naive.begin(), naive.end());
+                for (int k = 0; k < topk; ++k) {
+                    auto i = q * topk + k;
+                    if (k >= int(naive.size())) {
+                        ASSERT_EQ(result.get_seg_offsets()[i],
+                                  INVALID_SEG_OFFSET);
+                        continue;
+                    }
+                    ASSERT_EQ(result.get_seg_offsets()[i], naive[k].second);
+                    ASSERT_FLOAT_EQ(result.get_distances()[i], naive[k].first);
+                }
+            }
+        }
+    }
+}
+
+TEST(SketchBruteForce, Encode) {
+    std::vector<float> rows{1, -1, 0, 2, -3, 4, 5, -6, 7, 1, -2, -1};
+    std::vector<uint8_t> sketches(2 * SketchBruteForce::CodeSize(6));
+    SketchBruteForce::Encode(rows.data(), 2, 6, sketches.data());
+    ASSERT_EQ(sketches, std::vector<uint8_t>({0b101001, 0b001101}));
+}
+
+TEST(SketchBruteForce, MatchesBlocked) {
+    int nb = 1000, nq = 5, dim = 32, topk = 10;
+    BitsetType bitset(nb);
+    for (int i = 0; i < nb; i += 3) {
+        bitset.set(i);
+    }
+    BitsetView bitset_view(bitset);
+    auto base = GenFloatVecs(dim, nb, "L2");
+    std::vector<uint8_t> sketches(nb * SketchBruteForce::CodeSize(dim));
+    SketchBruteForce::Encode(base.data(), nb, dim, sketches.data());
+    auto row = [&](int64_t offset) { return base.data() + offset * dim; };
+
+    for (knowhere::MetricType metric : {"L2", "IP", "COSINE"}) {
+        // queries on the rows themselves, each among its own candidates
+        std::vector<float> query;
+        for (int q = 0; q < nq; ++q) {
+            auto r = row(q * 3 + 1);
+            query.insert(query.end(), r, r + dim);
+        }
+        BlockedBruteForce blocked(query.data(), nq, dim, topk, metric);
+        blocked.Add(base.data(), nb, 0, bitset_view);
+        SubSearchResult expected(nq, topk, metric, -1);
+        blocked.Finish(expected);
+
+        // with every row a candidate the search is exact
+        SketchBruteForce exact(query.data(), nq, dim, topk, metric, nb);
+        exact.AddSketches(sketches.data(), nb, 0, bitset_view);
+        SubSearchResult result(nq, topk, metric, -1);
+        exact.Finish(result, row);
+        for (int i = 0; i < nq * topk; i++) {
+            ASSERT_EQ(result.get_seg_offsets()[i],
+                      expected.get_seg_offsets()[i]);
+            auto distance = expected.get_distances()[i];
+            ASSERT_NEAR(result.get_distances()[i],
+                        distance,
+                        1e-3 * std::abs(distance) + 1e-4);
+        }
+
+        auto code_size = SketchBruteForce::CodeSize(dim);
+        SketchBruteForce sketched(
+            query.data(), nq, dim, topk, metric, 4 * topk);
+        auto first = nb / 3;
+        sketched.AddSketches(
+            sketches.data(), first, 0, bitset_view.subview(0, first));
+        sketched.AddSketches(sketches.data() + first * code_size,
+                             nb - first,
+                             first,
+                             bitset_view.subview(first, nb - first));
+        SubSearchResult approx(nq, topk, metric, -1);
+        sketched.Finish(approx, row);
+        for (int q = 0; q < nq; ++q) {
+            if (metric != "IP") {
+                ASSERT_EQ(approx.get_seg_offsets()[q * topk], q * 3 + 1);
+            }
+            for (int k = 0; k < topk; ++k) {
+                auto offset = approx.get_seg_offsets()[q * topk + k];
+                ASSERT_NE(offset, INVALID_SEG_OFFSET);
+                ASSERT_FALSE(bitset[offset]);
+            }
+        }
+    }
+}
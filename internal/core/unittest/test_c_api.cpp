@@ -13,20 +13,38 @@
 #include <gtest/gtest.h>
 
 #include <boost/format.hpp>
+#include <dlfcn.h>
+#include <fmt/core.h>
+#include <unistd.h>
 #include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <numeric>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
+#include "common/Common.h"
 #include "common/LoadInfo.h"
+#include "common/Numa.h"
 #include "index/IndexFactory.h"
+#include "index/Meta.h"
 #include "knowhere/comp/index_param.h"
 #include "pb/plan.pb.h"
 #include "query/ExprImpl.h"
 #include "segcore/Collection.h"
+#include "segcore/PlanCache.h"
+#include "segcore/QueryCapture.h"
 #include "segcore/Reduce.h"
+#include "segcore/SearchCoalescer.h"
+#include "segcore/profiler_c.h"
 #include "segcore/reduce_c.h"
+#include "segcore/segcore_init_c.h"
+#include "storage/FieldDataFactory.h"
+#include "storage/IndexData.h"
+#include "storage/MinioChunkManager.h"
 #include "test_utils/DataGen.h"
 #include "test_utils/PbHelper.h"
 #include "test_utils/indexbuilder_test_utils.h"
@@ -1079,6 +1097,95 @@ TEST(CApiTest, SearchTest) {
     DeleteSegment(segment);
 }
 
+TEST(CApiTest, SearchWithCancellation) {
+    auto c_collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(c_collection, Growing, -1);
+    auto col = (milvus::segcore::Collection*)c_collection;
+
+    int N = 10000;
+    auto dataset = DataGen(col->get_schema(), N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment,
+                          offset,
+                          N,
+                          dataset.row_ids_.data(),
+                          dataset.timestamps_.data(),
+                          insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    const char* dsl_string = R"(
+    {
+        "bool": {
+            "vector": {
+                "fakevec": {
+                    "metric_type": "L2",
+                    "params": {
+                        "nprobe": 10
+                    },
+                    "query": "$0",
+                    "topk": 10,
+                    "round_decimal": 3
+                }
+            }
+        }
+    })";
+
+    int num_queries = 10;
+    auto blob = generate_query_data(num_queries);
+    void* plan = nullptr;
+    auto status = CreateSearchPlan(c_collection, dsl_string, &plan);
+    ASSERT_EQ(status.error_code, Success);
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(
+        plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    auto search = [&](CCancellationToken token) {
+        CSearchResult search_result = nullptr;
+        auto res = SearchWithCancellation(segment,
+                                          plan,
+                                          placeholderGroup,
+                                          {},
+                                          N + 1000,
+                                          token,
+                                          &search_result);
+        if (res.error_code == Success) {
+            DeleteSearchResult(search_result);
+        } else {
+            free(const_cast<char*>(res.error_msg));
+        }
+        return res.error_code;
+    };
+
+    // without a token, and with one neither cancelled nor past its deadline
+    ASSERT_EQ(search(nullptr), Success);
+    auto token = NewCancellationToken(0);
+    ASSERT_EQ(search(token), Success);
+
+    CancelQuery(token);
+    ASSERT_EQ(search(token), QueryCancelled);
+    DeleteCancellationToken(token);
+
+    auto past_deadline = NewCancellationToken(1);
+    ASSERT_EQ(search(past_deadline), QueryCancelled);
+    DeleteCancellationToken(past_deadline);
+
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    auto future_deadline = NewCancellationToken(now_ms + 3600 * 1000);
+    ASSERT_EQ(search(future_deadline), Success);
+    DeleteCancellationToken(future_deadline);
+
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteCollection(c_collection);
+    DeleteSegment(segment);
+}
+
 TEST(CApiTest, SearchTestWithExpr) {
     auto c_collection = NewCollection(get_default_schema_config());
     auto segment = NewSegment(c_collection, Growing, -1);
@@ -1195,9 +1302,9 @@ TEST(CApiTest, GetMemoryUsageInBytesTest) {
     auto collection = NewCollection(get_default_schema_config());
     auto segment = NewSegment(collection, Growing, -1);
 
+    // the pk map preallocates its slots, so an empty segment isn't free
     auto old_memory_usage_size = GetMemoryUsageInBytes(segment);
-    // std::cout << "old_memory_usage_size = " << old_memory_usage_size << std::endl;
-    ASSERT_EQ(old_memory_usage_size, 0);
+    ASSERT_GE(old_memory_usage_size, 0);
 
     auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
     int N = 10000;
@@ -1216,6 +1323,22 @@ TEST(CApiTest, GetMemoryUsageInBytesTest) {
                       insert_data.size());
     ASSERT_EQ(res.error_code, Success);
 
+    // a 16 dim float vector, an int64 pk, a row id and a timestamp per row
+    auto memory_usage_size = GetMemoryUsageInBytes(segment);
+    ASSERT_GE(memory_usage_size - old_memory_usage_size,
+              int64_t(N * (16 * sizeof(float) + 3 * sizeof(int64_t))));
+
+    auto detail_str = GetMemoryUsageDetail(segment);
+    ASSERT_NE(detail_str, nullptr);
+    auto detail = nlohmann::json::parse(detail_str);
+    free(detail_str);
+    ASSERT_EQ(detail["resident_bytes"].get<int64_t>(), memory_usage_size);
+    ASSERT_GE(detail["fields"]["100"]["raw"].get<int64_t>(),
+              int64_t(N * 16 * sizeof(float)));
+    ASSERT_GE(detail["fields"]["101"]["raw"].get<int64_t>(),
+              int64_t(N * sizeof(int64_t)));
+    ASSERT_GT(detail["pk_map"].get<int64_t>(), 0);
+
     DeleteCollection(collection);
     DeleteSegment(segment);
 }
@@ -1352,7 +1475,7 @@ CheckSearchResultDuplicate(const std::vector<CSearchResult>& results) {
             auto topk_end = search_result->topk_per_nq_prefix_sum_[qi + 1];
             for (int ki = topk_beg; ki < topk_end; ki++) {
                 ASSERT_NE(search_result->seg_offsets_[ki], INVALID_SEG_OFFSET);
-                auto ret = pk_set.insert(search_result->primary_keys_[ki]);
+                auto ret = pk_set.insert(search_result->get_primary_key(ki));
                 ASSERT_TRUE(ret.second);
             }
         }
@@ -1566,32 +1689,634 @@ TEST(CApiTest, ReduceRemoveDuplicates) {
         // TODO:: insert no duplicate pks and check reduce results
         CheckSearchResultDuplicate(results);
 
-        DeleteSearchResult(res1);
-        DeleteSearchResult(res2);
-        DeleteSearchResult(res3);
-        DeleteSearchResultDataBlobs(cSearchResultData);
-    }
+        DeleteSearchResult(res1);
+        DeleteSearchResult(res2);
+        DeleteSearchResult(res3);
+        DeleteSearchResultDataBlobs(cSearchResultData);
+    }
+
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
+void
+testReduceSearchWithExpr(int N, int topK, int num_queries) {
+    std::cerr << "testReduceSearchWithExpr(" << N << ", " << topK << ", "
+              << num_queries << ")" << std::endl;
+
+    auto collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(collection, Growing, -1);
+
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    auto dataset = DataGen(schema, N);
+
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment,
+                          offset,
+                          N,
+                          dataset.row_ids_.data(),
+                          dataset.timestamps_.data(),
+                          insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: 100
+                                            query_info: <
+                                                topk: %1%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: 100)") %
+               topK;
+
+    auto serialized_expr_plan = fmt.str();
+    auto blob = generate_query_data(num_queries);
+
+    void* plan = nullptr;
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(
+        plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    std::vector<CPlaceholderGroup> placeholderGroups;
+    placeholderGroups.push_back(placeholderGroup);
+    dataset.timestamps_.clear();
+    dataset.timestamps_.push_back(1);
+
+    std::vector<CSearchResult> results;
+    CSearchResult res1;
+    CSearchResult res2;
+    auto res = Search(
+        segment, plan, placeholderGroup, {}, dataset.timestamps_[N - 1], &res1);
+    ASSERT_EQ(res.error_code, Success);
+    res = Search(
+        segment, plan, placeholderGroup, {}, dataset.timestamps_[N - 1], &res2);
+    ASSERT_EQ(res.error_code, Success);
+    results.push_back(res1);
+    results.push_back(res2);
+
+    auto slice_nqs = std::vector<int64_t>{num_queries / 2, num_queries / 2};
+    if (num_queries == 1) {
+        slice_nqs = std::vector<int64_t>{num_queries};
+    }
+    auto slice_topKs = std::vector<int64_t>{topK / 2, topK};
+    if (topK == 1) {
+        slice_topKs = std::vector<int64_t>{topK, topK};
+    }
+
+    // 1. reduce
+    CSearchResultDataBlobs cSearchResultData;
+    status = ReduceSearchResultsAndFillData(&cSearchResultData,
+                                            plan,
+                                            results.data(),
+                                            results.size(),
+                                            slice_nqs.data(),
+                                            slice_topKs.data(),
+                                            slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+
+    auto search_result_data_blobs =
+        reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(
+            cSearchResultData);
+
+    // check result
+    ASSERT_EQ(search_result_data_blobs->size(), slice_nqs.size());
+    for (int i = 0; i < slice_nqs.size(); i++) {
+        CProto blob;
+        status = GetSearchResultDataBlob(&blob, cSearchResultData, i);
+        ASSERT_EQ(status.error_code, Success);
+        // slices are laid out back to back in one buffer
+        ASSERT_EQ(blob.proto_blob, search_result_data_blobs->blob_data(i));
+        if (i > 0) {
+            ASSERT_EQ(search_result_data_blobs->blob_data(i),
+                      search_result_data_blobs->blob_data(i - 1) +
+                          search_result_data_blobs->blob_size(i - 1));
+        }
+        milvus::proto::schema::SearchResultData search_result_data;
+        auto suc =
+            search_result_data.ParseFromArray(blob.proto_blob, blob.proto_size);
+        ASSERT_TRUE(suc);
+        ASSERT_EQ(search_result_data.num_queries(), slice_nqs[i]);
+        ASSERT_EQ(search_result_data.top_k(), slice_topKs[i]);
+        ASSERT_EQ(search_result_data.ids().int_id().data_size(),
+                  search_result_data.topks().at(0) * slice_nqs[i]);
+        ASSERT_EQ(search_result_data.scores().size(),
+                  search_result_data.topks().at(0) * slice_nqs[i]);
+
+        // check real topks
+        ASSERT_EQ(search_result_data.topks().size(), slice_nqs[i]);
+        for (auto real_topk : search_result_data.topks()) {
+            ASSERT_LE(real_topk, slice_topKs[i]);
+        }
+    }
+
+    DeleteSearchResultDataBlobs(cSearchResultData);
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteSearchResult(res1);
+    DeleteSearchResult(res2);
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
+TEST(CApiTest, ReduceSearchWithExpr) {
+    testReduceSearchWithExpr(2, 1, 1);
+    testReduceSearchWithExpr(2, 10, 10);
+    testReduceSearchWithExpr(100, 1, 1);
+    testReduceSearchWithExpr(100, 10, 10);
+    testReduceSearchWithExpr(10000, 1, 1);
+    testReduceSearchWithExpr(10000, 10, 10);
+}
+
+TEST(CApiTest, ParallelReduceSearchWithExpr) {
+    auto cpu_num = milvus::cpu_num;
+    milvus::SetCpuNum(4);
+    testReduceSearchWithExpr(10000, 10, 1000);
+    testReduceSearchWithExpr(10000, 1, 1000);
+    milvus::SetCpuNum(cpu_num);
+}
+
+TEST(CApiTest, TwoPhaseReduceSearch) {
+    int N = 1000;
+    int topK = 10;
+    int num_queries = 10;
+    auto collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(collection, Growing, -1);
+
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    auto dataset = DataGen(schema, N);
+
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment,
+                          offset,
+                          N,
+                          dataset.row_ids_.data(),
+                          dataset.timestamps_.data(),
+                          insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: 100
+                                            query_info: <
+                                                topk: %1%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: 100)") %
+               topK;
+
+    auto serialized_expr_plan = fmt.str();
+    auto blob = generate_query_data(num_queries);
+
+    void* plan = nullptr;
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(
+        plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    // the same two segment results, reduced in one and in two phases
+    std::vector<CSearchResult> results(4);
+    for (auto& result : results) {
+        auto res = Search(segment,
+                          plan,
+                          placeholderGroup,
+                          {},
+                          dataset.timestamps_[N - 1],
+                          &result);
+        ASSERT_EQ(res.error_code, Success);
+    }
+    auto slice_nqs = std::vector<int64_t>{num_queries / 2, num_queries / 2};
+    auto slice_topKs = std::vector<int64_t>{topK / 2, topK};
+
+    CSearchResultDataBlobs expected;
+    status = ReduceSearchResultsAndFillData(&expected,
+                                            plan,
+                                            results.data(),
+                                            2,
+                                            slice_nqs.data(),
+                                            slice_topKs.data(),
+                                            slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+
+    CReducedSearchResults reduced;
+    status = ReduceSearchResults(&reduced,
+                                 plan,
+                                 results.data() + 2,
+                                 2,
+                                 slice_nqs.data(),
+                                 slice_topKs.data(),
+                                 slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+    // no output field is fetched before the losers are dropped
+    for (int i = 2; i < 4; i++) {
+        auto result = static_cast<milvus::SearchResult*>(results[i]);
+        ASSERT_TRUE(result->output_fields_data_.empty());
+    }
+
+    CSearchResultDataBlobs actual;
+    status = FillReducedSearchResults(&actual, reduced);
+    ASSERT_EQ(status.error_code, Success);
+    for (int i = 2; i < 4; i++) {
+        auto result = static_cast<milvus::SearchResult*>(results[i]);
+        auto& field_data = result->output_fields_data_.at(FieldId(100));
+        ASSERT_EQ(field_data->vectors().float_vector().data_size(),
+                  result->seg_offsets_.size() * 16);
+    }
+
+    for (int i = 0; i < slice_nqs.size(); i++) {
+        CProto expected_blob;
+        CProto actual_blob;
+        status = GetSearchResultDataBlob(&expected_blob, expected, i);
+        ASSERT_EQ(status.error_code, Success);
+        status = GetSearchResultDataBlob(&actual_blob, actual, i);
+        ASSERT_EQ(status.error_code, Success);
+        ASSERT_EQ(expected_blob.proto_size, actual_blob.proto_size);
+        ASSERT_EQ(memcmp(expected_blob.proto_blob,
+                         actual_blob.proto_blob,
+                         actual_blob.proto_size),
+                  0);
+    }
+
+    DeleteSearchResultDataBlobs(expected);
+    DeleteSearchResultDataBlobs(actual);
+    DeleteReducedSearchResults(reduced);
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    for (auto result : results) {
+        DeleteSearchResult(result);
+    }
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
+TEST(CApiTest, SearchAndReduceSegments) {
+    int N = 1000;
+    int topK = 10;
+    int num_queries = 10;
+    auto collection = NewCollection(get_default_schema_config());
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+
+    std::vector<CSegmentInterface> segments;
+    Timestamp timestamp = 0;
+    for (int i = 0; i < 3; i++) {
+        auto segment = NewSegment(collection, Growing, i);
+        auto dataset = DataGen(schema, N, 42 + i);
+        int64_t offset;
+        PreInsert(segment, N, &offset);
+        auto insert_data = serialize(dataset.raw_);
+        auto ins_res = Insert(segment,
+                              offset,
+                              N,
+                              dataset.row_ids_.data(),
+                              dataset.timestamps_.data(),
+                              insert_data.data(),
+                              insert_data.size());
+        ASSERT_EQ(ins_res.error_code, Success);
+        timestamp = std::max(timestamp, dataset.timestamps_[N - 1]);
+        segments.push_back(segment);
+    }
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: 100
+                                            query_info: <
+                                                topk: %1%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: 100)") %
+               topK;
+    auto serialized_expr_plan = fmt.str();
+    auto blob = generate_query_data(num_queries);
+
+    void* plan = nullptr;
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(
+        plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    // one search per segment is what the batched calls must reproduce
+    std::vector<CSearchResult> results(segments.size());
+    for (int i = 0; i < segments.size(); i++) {
+        status = Search(
+            segments[i], plan, placeholderGroup, {}, timestamp, &results[i]);
+        ASSERT_EQ(status.error_code, Success);
+    }
+    std::vector<CSearchResult> batched_results(segments.size());
+    status = SearchSegments(segments.data(),
+                            segments.size(),
+                            plan,
+                            placeholderGroup,
+                            {},
+                            timestamp,
+                            batched_results.data());
+    ASSERT_EQ(status.error_code, Success);
+    for (int i = 0; i < segments.size(); i++) {
+        auto result = static_cast<milvus::SearchResult*>(results[i]);
+        auto batched = static_cast<milvus::SearchResult*>(batched_results[i]);
+        ASSERT_EQ(result->seg_offsets_, batched->seg_offsets_);
+        ASSERT_EQ(result->distances_, batched->distances_);
+    }
+
+    auto slice_nqs = std::vector<int64_t>{num_queries / 2, num_queries / 2};
+    auto slice_topKs = std::vector<int64_t>{topK / 2, topK};
+    CSearchResultDataBlobs expected;
+    status = ReduceSearchResultsAndFillData(&expected,
+                                            plan,
+                                            results.data(),
+                                            results.size(),
+                                            slice_nqs.data(),
+                                            slice_topKs.data(),
+                                            slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+    CSearchResultDataBlobs actual;
+    status = SearchAndReduceSegments(&actual,
+                                     segments.data(),
+                                     segments.size(),
+                                     plan,
+                                     placeholderGroup,
+                                     {},
+                                     timestamp,
+                                     slice_nqs.data(),
+                                     slice_topKs.data(),
+                                     slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+
+    for (int i = 0; i < slice_nqs.size(); i++) {
+        CProto expected_blob;
+        CProto actual_blob;
+        status = GetSearchResultDataBlob(&expected_blob, expected, i);
+        ASSERT_EQ(status.error_code, Success);
+        status = GetSearchResultDataBlob(&actual_blob, actual, i);
+        ASSERT_EQ(status.error_code, Success);
+        ASSERT_EQ(expected_blob.proto_size, actual_blob.proto_size);
+        ASSERT_EQ(memcmp(expected_blob.proto_blob,
+                         actual_blob.proto_blob,
+                         actual_blob.proto_size),
+                  0);
+    }
+
+    DeleteSearchResultDataBlobs(expected);
+    DeleteSearchResultDataBlobs(actual);
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    for (auto result : results) {
+        DeleteSearchResult(result);
+    }
+    for (auto result : batched_results) {
+        DeleteSearchResult(result);
+    }
+    for (auto segment : segments) {
+        DeleteSegment(segment);
+    }
+    DeleteCollection(collection);
+}
+
+TEST(CApiTest, StreamReduce) {
+    int N = 1000;
+    int topK = 10;
+    int num_queries = 10;
+    auto collection = NewCollection(get_default_schema_config());
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+
+    std::vector<CSegmentInterface> segments;
+    Timestamp timestamp = 0;
+    for (int i = 0; i < 3; i++) {
+        auto segment = NewSegment(collection, Growing, i);
+        auto dataset = DataGen(schema, N, 42 + i);
+        int64_t offset;
+        PreInsert(segment, N, &offset);
+        auto insert_data = serialize(dataset.raw_);
+        auto ins_res = Insert(segment,
+                              offset,
+                              N,
+                              dataset.row_ids_.data(),
+                              dataset.timestamps_.data(),
+                              insert_data.data(),
+                              insert_data.size());
+        ASSERT_EQ(ins_res.error_code, Success);
+        timestamp = std::max(timestamp, dataset.timestamps_[N - 1]);
+        segments.push_back(segment);
+    }
+    // the first segment twice, its hits are all duplicates
+    segments.push_back(segments[0]);
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: 100
+                                            query_info: <
+                                                topk: %1%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: 100)") %
+               topK;
+    auto serialized_expr_plan = fmt.str();
+    auto blob = generate_query_data(num_queries);
+
+    void* plan = nullptr;
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(
+        plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    std::vector<CSearchResult> results(segments.size());
+    std::vector<CSearchResult> streamed(segments.size());
+    for (int i = 0; i < segments.size(); i++) {
+        status = Search(
+            segments[i], plan, placeholderGroup, {}, timestamp, &results[i]);
+        ASSERT_EQ(status.error_code, Success);
+        status = Search(
+            segments[i], plan, placeholderGroup, {}, timestamp, &streamed[i]);
+        ASSERT_EQ(status.error_code, Success);
+    }
+
+    auto slice_nqs = std::vector<int64_t>{num_queries / 2, num_queries / 2};
+    auto slice_topKs = std::vector<int64_t>{topK / 2, topK};
+    CSearchResultDataBlobs expected;
+    status = ReduceSearchResultsAndFillData(&expected,
+                                            plan,
+                                            results.data(),
+                                            results.size(),
+                                            slice_nqs.data(),
+                                            slice_topKs.data(),
+                                            slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+
+    // pushed from a thread each, in any order
+    CStreamReduce stream;
+    status = NewStreamReduce(&stream,
+                             plan,
+                             slice_nqs.data(),
+                             slice_topKs.data(),
+                             slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+    std::vector<std::thread> threads;
+    std::vector<CStatus> push_status(streamed.size());
+    for (int i = streamed.size() - 1; i >= 0; i--) {
+        threads.emplace_back([&, i]() {
+            push_status[i] = StreamReducePush(stream, streamed[i]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& push : push_status) {
+        ASSERT_EQ(push.error_code, Success);
+    }
+    CSearchResultDataBlobs actual;
+    status = FinishStreamReduce(&actual, stream);
+    ASSERT_EQ(status.error_code, Success);
+
+    for (int i = 0; i < slice_nqs.size(); i++) {
+        CProto expected_blob;
+        CProto actual_blob;
+        status = GetSearchResultDataBlob(&expected_blob, expected, i);
+        ASSERT_EQ(status.error_code, Success);
+        status = GetSearchResultDataBlob(&actual_blob, actual, i);
+        ASSERT_EQ(status.error_code, Success);
+        ASSERT_EQ(expected_blob.proto_size, actual_blob.proto_size);
+        ASSERT_EQ(memcmp(expected_blob.proto_blob,
+                         actual_blob.proto_blob,
+                         actual_blob.proto_size),
+                  0);
+    }
+
+    DeleteSearchResultDataBlobs(expected);
+    DeleteSearchResultDataBlobs(actual);
+    DeleteStreamReduce(stream);
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    for (auto result : results) {
+        DeleteSearchResult(result);
+    }
+    for (auto result : streamed) {
+        DeleteSearchResult(result);
+    }
+    segments.pop_back();
+    for (auto segment : segments) {
+        DeleteSegment(segment);
+    }
+    DeleteCollection(collection);
+}
+
+TEST(CApiTest, SearchOnNumaNode) {
+    int N = 1000;
+    int topK = 10;
+    int num_queries = 10;
+    auto collection = NewCollection(get_default_schema_config());
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+
+    auto segment = NewSegment(collection, Sealed, 1);
+    auto dataset = DataGen(schema, N);
+    auto sealed = dynamic_cast<milvus::segcore::SegmentSealed*>(
+        static_cast<milvus::segcore::SegmentInterface*>(segment));
+    SealedLoadFieldData(dataset, *sealed);
+    // not numa aware by default
+    ASSERT_EQ(GetSegmentNumaNode(segment), -1);
+    auto status = SetSegmentNumaNode(segment, milvus::numa::NumNodes());
+    ASSERT_NE(status.error_code, Success);
+    free((char*)status.error_msg);
+    status = SetSegmentNumaNode(segment, 0);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_EQ(GetSegmentNumaNode(segment), 0);
+
+    auto growing = NewSegment(collection, Growing, 2);
+    ASSERT_EQ(GetSegmentNumaNode(growing), -1);
+    status = SetSegmentNumaNode(growing, 0);
+    ASSERT_NE(status.error_code, Success);
+    free((char*)status.error_msg);
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: 100
+                                            query_info: <
+                                                topk: %1%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               topK;
+    auto serialized_expr_plan = fmt.str();
+    auto blob = generate_query_data(num_queries);
+
+    void* plan = nullptr;
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(
+        plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    CSearchResult result;
+    status = Search(segment, plan, placeholderGroup, {}, MAX_TIMESTAMP, &result);
+    ASSERT_EQ(status.error_code, Success);
+    CSearchResult numa_result;
+    status = SearchOnNumaNode(
+        segment, plan, placeholderGroup, {}, MAX_TIMESTAMP, &numa_result);
+    ASSERT_EQ(status.error_code, Success);
+    auto expected = static_cast<milvus::SearchResult*>(result);
+    auto actual = static_cast<milvus::SearchResult*>(numa_result);
+    ASSERT_EQ(expected->seg_offsets_, actual->seg_offsets_);
+    ASSERT_EQ(expected->distances_, actual->distances_);
 
     DeleteSearchPlan(plan);
     DeletePlaceholderGroup(placeholderGroup);
-    DeleteCollection(collection);
+    DeleteSearchResult(result);
+    DeleteSearchResult(numa_result);
+    DeleteSegment(growing);
     DeleteSegment(segment);
+    DeleteCollection(collection);
 }
 
-void
-testReduceSearchWithExpr(int N, int topK, int num_queries) {
-    std::cerr << "testReduceSearchWithExpr(" << N << ", " << topK << ", "
-              << num_queries << ")" << std::endl;
-
+TEST(CApiTest, SearchIterator) {
+    int N = 1000;
+    int topK = 100;
     auto collection = NewCollection(get_default_schema_config());
-    auto segment = NewSegment(collection, Growing, -1);
-
     auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    auto segment = NewSegment(collection, Growing, -1);
     auto dataset = DataGen(schema, N);
-
     int64_t offset;
     PreInsert(segment, N, &offset);
-
     auto insert_data = serialize(dataset.raw_);
     auto ins_res = Insert(segment,
                           offset,
@@ -1601,6 +2326,7 @@ testReduceSearchWithExpr(int N, int topK, int num_queries) {
                           insert_data.data(),
                           insert_data.size());
     ASSERT_EQ(ins_res.error_code, Success);
+    auto timestamp = dataset.timestamps_[N - 1];
 
     auto fmt = boost::format(R"(vector_anns: <
                                             field_id: 100
@@ -1612,9 +2338,8 @@ testReduceSearchWithExpr(int N, int topK, int num_queries) {
                                             placeholder_tag: "$0">
                                             output_field_ids: 100)") %
                topK;
-
     auto serialized_expr_plan = fmt.str();
-    auto blob = generate_query_data(num_queries);
+    auto blob = generate_query_data(1);
 
     void* plan = nullptr;
     auto binary_plan =
@@ -1622,90 +2347,371 @@ testReduceSearchWithExpr(int N, int topK, int num_queries) {
     auto status = CreateSearchPlanByExpr(
         collection, binary_plan.data(), binary_plan.size(), &plan);
     ASSERT_EQ(status.error_code, Success);
-
     void* placeholderGroup = nullptr;
     status = ParsePlaceholderGroup(
         plan, blob.data(), blob.length(), &placeholderGroup);
     ASSERT_EQ(status.error_code, Success);
 
-    std::vector<CPlaceholderGroup> placeholderGroups;
-    placeholderGroups.push_back(placeholderGroup);
-    dataset.timestamps_.clear();
-    dataset.timestamps_.push_back(1);
-
-    std::vector<CSearchResult> results;
-    CSearchResult res1;
-    CSearchResult res2;
-    auto res = Search(
-        segment, plan, placeholderGroup, {}, dataset.timestamps_[N - 1], &res1);
-    ASSERT_EQ(res.error_code, Success);
-    res = Search(
-        segment, plan, placeholderGroup, {}, dataset.timestamps_[N - 1], &res2);
-    ASSERT_EQ(res.error_code, Success);
-    results.push_back(res1);
-    results.push_back(res2);
+    CSearchResult expected;
+    status = Search(segment, plan, placeholderGroup, {}, timestamp, &expected);
+    ASSERT_EQ(status.error_code, Success);
 
-    auto slice_nqs = std::vector<int64_t>{num_queries / 2, num_queries / 2};
-    if (num_queries == 1) {
-        slice_nqs = std::vector<int64_t>{num_queries};
-    }
-    auto slice_topKs = std::vector<int64_t>{topK / 2, topK};
-    if (topK == 1) {
-        slice_topKs = std::vector<int64_t>{topK, topK};
+    CSearchIterator iterator;
+    status = NewSearchIterator(
+        segment, plan, placeholderGroup, timestamp, &iterator);
+    ASSERT_EQ(status.error_code, Success);
+    std::vector<int64_t> offsets;
+    std::vector<float> distances;
+    while (true) {
+        CSearchResult page;
+        status = SearchIteratorNext(iterator, {}, 7, &page);
+        ASSERT_EQ(status.error_code, Success);
+        auto result = static_cast<milvus::SearchResult*>(page);
+        auto size = result->seg_offsets_.size();
+        offsets.insert(offsets.end(),
+                       result->seg_offsets_.begin(),
+                       result->seg_offsets_.end());
+        distances.insert(distances.end(),
+                         result->distances_.begin(),
+                         result->distances_.end());
+        DeleteSearchResult(page);
+        if (size < 7) {
+            break;
+        }
     }
 
-    // 1. reduce
-    CSearchResultDataBlobs cSearchResultData;
-    status = ReduceSearchResultsAndFillData(&cSearchResultData,
-                                            plan,
-                                            results.data(),
-                                            results.size(),
-                                            slice_nqs.data(),
-                                            slice_topKs.data(),
-                                            slice_nqs.size());
+    // every row once, the first pages as one search for them
+    ASSERT_EQ(offsets.size(), N);
+    ASSERT_EQ(std::set<int64_t>(offsets.begin(), offsets.end()).size(), N);
+    ASSERT_TRUE(std::is_sorted(distances.rbegin(), distances.rend()));
+    auto result = static_cast<milvus::SearchResult*>(expected);
+    ASSERT_EQ(std::vector<int64_t>(offsets.begin(), offsets.begin() + topK),
+              result->seg_offsets_);
+
+    DeleteSearchIterator(iterator);
+    DeleteSearchResult(expected);
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteSegment(segment);
+    DeleteCollection(collection);
+}
+
+TEST(CApiTest, PlanCache) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto& cache = milvus::segcore::PlanCache::GetInstance();
+    cache.SetCapacity(2);
+
+    const char* raw_plan = R"(vector_anns: <
+                                    field_id: 100
+                                    query_info: <
+                                        topk: 10
+                                        metric_type: "L2"
+                                        search_params: "{\"nprobe\": 10}"
+                                    >
+                                    placeholder_tag: "$0">)";
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    auto hits = cache.Hits();
+    auto misses = cache.Misses();
+
+    // the searches on two segments share one plan
+    void* plan1 = nullptr;
+    void* plan2 = nullptr;
+    auto status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan1);
     ASSERT_EQ(status.error_code, Success);
+    status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan2);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_EQ(plan1, plan2);
+    ASSERT_EQ(cache.Misses(), misses + 1);
+    ASSERT_EQ(cache.Hits(), hits + 1);
+    ASSERT_EQ(GetTopK(plan2), 10);
+    DeleteSearchPlan(plan1);
+    DeleteSearchPlan(plan2);
+
+    // a disabled cache creates a plan per call
+    cache.SetCapacity(0);
+    status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan1);
+    ASSERT_EQ(status.error_code, Success);
+    status = CreateSearchPlanByExpr(
+        collection, binary_plan.data(), binary_plan.size(), &plan2);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_NE(plan1, plan2);
+    DeleteSearchPlan(plan1);
+    DeleteSearchPlan(plan2);
+    DeleteCollection(collection);
+}
 
-    auto search_result_data_blobs =
-        reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(
-            cSearchResultData);
+TEST(CApiTest, SearchCoalescing) {
+    auto c_collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(c_collection, Growing, -1);
+    auto col = (milvus::segcore::Collection*)c_collection;
 
-    // check result
-    for (int i = 0; i < slice_nqs.size(); i++) {
-        milvus::proto::schema::SearchResultData search_result_data;
-        auto suc = search_result_data.ParseFromArray(
-            search_result_data_blobs->blobs[i].data(),
-            search_result_data_blobs->blobs[i].size());
-        ASSERT_TRUE(suc);
-        ASSERT_EQ(search_result_data.num_queries(), slice_nqs[i]);
-        ASSERT_EQ(search_result_data.top_k(), slice_topKs[i]);
-        ASSERT_EQ(search_result_data.ids().int_id().data_size(),
-                  search_result_data.topks().at(0) * slice_nqs[i]);
-        ASSERT_EQ(search_result_data.scores().size(),
-                  search_result_data.topks().at(0) * slice_nqs[i]);
+    int N = 10000;
+    auto dataset = DataGen(col->get_schema(), N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment,
+                          offset,
+                          N,
+                          dataset.row_ids_.data(),
+                          dataset.timestamps_.data(),
+                          insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
 
-        // check real topks
-        ASSERT_EQ(search_result_data.topks().size(), slice_nqs[i]);
-        for (auto real_topk : search_result_data.topks()) {
-            ASSERT_LE(real_topk, slice_topKs[i]);
+    const char* raw_plan = R"(vector_anns: <
+                                    field_id: 100
+                                    predicates: <
+                                      unary_range_expr: <
+                                        column_info: <
+                                          field_id: 101
+                                          data_type: Int64
+                                        >
+                                        op: GreaterEqual
+                                        value: <
+                                          int64_val: 100
+                                        >
+                                      >
+                                    >
+                                    query_info: <
+                                        topk: 10
+                                        metric_type: "L2"
+                                        search_params: "{\"nprobe\": 10}"
+                                    >
+                                    placeholder_tag: "$0">)";
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    void* plan = nullptr;
+    auto status = CreateSearchPlanByExpr(
+        c_collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+
+    // searches of 1 to 4 queries
+    int num_searches = 4;
+    std::vector<void*> groups(num_searches);
+    for (int i = 0; i < num_searches; ++i) {
+        auto blob = generate_query_data(i + 1);
+        status = ParsePlaceholderGroup(
+            plan, blob.data(), blob.length(), &groups[i]);
+        ASSERT_EQ(status.error_code, Success);
+    }
+    auto search = [&](int i) {
+        CSearchResult result;
+        auto status =
+            Search(segment, plan, groups[i], {}, N + 1000, &result);
+        EXPECT_EQ(status.error_code, Success);
+        return (SearchResult*)result;
+    };
+
+    std::vector<SearchResult*> expected(num_searches);
+    for (int i = 0; i < num_searches; ++i) {
+        expected[i] = search(i);
+    }
+
+    // started together they wait for each other and run as one
+    auto& coalescer = milvus::segcore::SearchCoalescer::GetInstance();
+    auto merged = coalescer.Merged();
+    coalescer.SetWindow(200 * 1000, 64);
+    std::vector<SearchResult*> results(num_searches);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_searches; ++i) {
+        threads.emplace_back([&, i] { results[i] = search(i); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    coalescer.SetWindow(0, 64);
+    ASSERT_GT(coalescer.Merged(), merged);
+
+    for (int i = 0; i < num_searches; ++i) {
+        ASSERT_EQ(results[i]->total_nq_, i + 1);
+        ASSERT_EQ(results[i]->unity_topK_, 10);
+        ASSERT_EQ(results[i]->seg_offsets_, expected[i]->seg_offsets_);
+        ASSERT_EQ(results[i]->distances_, expected[i]->distances_);
+        for (auto offset : results[i]->seg_offsets_) {
+            ASSERT_GE(offset, 100);
         }
+        DeleteSearchResult(results[i]);
+        DeleteSearchResult(expected[i]);
+        DeletePlaceholderGroup(groups[i]);
     }
+    DeleteSearchPlan(plan);
+    DeleteCollection(c_collection);
+    DeleteSegment(segment);
+}
 
-    DeleteSearchResultDataBlobs(cSearchResultData);
+TEST(CApiTest, QueryCapture) {
+    auto c_collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(c_collection, Growing, 7);
+    auto col = (milvus::segcore::Collection*)c_collection;
+
+    int N = 1000;
+    auto dataset = DataGen(col->get_schema(), N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment,
+                          offset,
+                          N,
+                          dataset.row_ids_.data(),
+                          dataset.timestamps_.data(),
+                          insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    const char* raw_plan = R"(vector_anns: <
+                                    field_id: 100
+                                    query_info: <
+                                        topk: 10
+                                        metric_type: "L2"
+                                        search_params: "{\"nprobe\": 10}"
+                                    >
+                                    placeholder_tag: "$0">)";
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    void* plan = nullptr;
+    auto status = CreateSearchPlanByExpr(
+        c_collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+    auto blob = generate_query_data(2);
+    void* group = nullptr;
+    status = ParsePlaceholderGroup(plan, blob.data(), blob.length(), &group);
+    ASSERT_EQ(status.error_code, Success);
+
+    // one in two searches is written
+    auto path = "/tmp/milvus/query_capture_test";
+    std::filesystem::create_directories("/tmp/milvus");
+    SegcoreSetQueryCapture(path, 2);
+    for (int i = 0; i < 4; ++i) {
+        CSearchResult result;
+        status = Search(segment, plan, group, {}, N + i, &result);
+        ASSERT_EQ(status.error_code, Success);
+        DeleteSearchResult(result);
+    }
+    SegcoreSetQueryCapture("", 0);
+    ASSERT_EQ(QueryCapture::GetInstance().Captured(), 2);
+
+    auto queries = QueryCapture::Read(path);
+    ASSERT_EQ(queries.size(), 2);
+    auto& phg = *static_cast<const milvus::query::PlaceholderGroup*>(group);
+    for (int i = 0; i < 2; ++i) {
+        auto& query = queries[i];
+        ASSERT_EQ(query.kind, CapturedQuery::Search);
+        ASSERT_EQ(query.segment_id, 7);
+        ASSERT_EQ(query.timestamp, N + 2 * i);
+        ASSERT_EQ(query.plan,
+                  std::string(binary_plan.begin(), binary_plan.end()));
+        ASSERT_EQ(query.placeholder_group.size(), 1);
+        ASSERT_EQ(query.placeholder_group[0].tag_, phg[0].tag_);
+        ASSERT_EQ(query.placeholder_group[0].num_of_queries_, 2);
+        ASSERT_EQ(query.placeholder_group[0].blob_, phg[0].blob_);
+        ASSERT_GE(query.latency_us, 0);
+    }
+    ASSERT_LE(queries[0].arrival_us, queries[1].arrival_us);
+
+    // a replayed search is the same as the captured one
+    auto replayed_plan = milvus::query::CreateSearchPlanByExpr(
+        *col->get_schema(), queries[0].plan.data(), queries[0].plan.size());
+    auto segment_interface = (milvus::segcore::SegmentInterface*)segment;
+    auto replayed = segment_interface->Search(replayed_plan.get(),
+                                              &queries[0].placeholder_group,
+                                              queries[0].timestamp);
+    auto expected = segment_interface->Search(
+        (milvus::query::Plan*)plan, &phg, queries[0].timestamp);
+    ASSERT_EQ(replayed->seg_offsets_, expected->seg_offsets_);
+    ASSERT_EQ(replayed->distances_, expected->distances_);
+
+    std::filesystem::remove(path);
+    DeletePlaceholderGroup(group);
     DeleteSearchPlan(plan);
-    DeletePlaceholderGroup(placeholderGroup);
-    DeleteSearchResult(res1);
-    DeleteSearchResult(res2);
-    DeleteCollection(collection);
+    DeleteCollection(c_collection);
     DeleteSegment(segment);
 }
 
-TEST(CApiTest, ReduceSearchWithExpr) {
-    testReduceSearchWithExpr(2, 1, 1);
-    testReduceSearchWithExpr(2, 10, 10);
-    testReduceSearchWithExpr(100, 1, 1);
-    testReduceSearchWithExpr(100, 10, 10);
-    testReduceSearchWithExpr(10000, 1, 1);
-    testReduceSearchWithExpr(10000, 10, 10);
+TEST(CApiTest, SearchProfile) {
+    auto c_collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(c_collection, Growing, -1);
+    auto col = (milvus::segcore::Collection*)c_collection;
+
+    int N = 10000;
+    auto dataset = DataGen(col->get_schema(), N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment,
+                          offset,
+                          N,
+                          dataset.row_ids_.data(),
+                          dataset.timestamps_.data(),
+                          insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    auto search = [&](const char* search_params) {
+        auto raw_plan = boost::format(R"(vector_anns: <
+                                    field_id: 100
+                                    predicates: <
+                                      unary_range_expr: <
+                                        column_info: <
+                                          field_id: 101
+                                          data_type: Int64
+                                        >
+                                        op: GreaterEqual
+                                        value: <
+                                          int64_val: 0
+                                        >
+                                      >
+                                    >
+                                    query_info: <
+                                        topk: 10
+                                        metric_type: "L2"
+                                        search_params: "%1%"
+                                    >
+                                    placeholder_tag: "$0">)") %
+                        search_params;
+        auto binary_plan =
+            translate_text_plan_to_binary_plan(raw_plan.str().c_str());
+        void* plan = nullptr;
+        auto status = CreateSearchPlanByExpr(
+            c_collection, binary_plan.data(), binary_plan.size(), &plan);
+        EXPECT_EQ(status.error_code, Success);
+        auto blob = generate_query_data(10);
+        void* placeholderGroup = nullptr;
+        status = ParsePlaceholderGroup(
+            plan, blob.data(), blob.length(), &placeholderGroup);
+        EXPECT_EQ(status.error_code, Success);
+        CSearchResult search_result;
+        status = Search(
+            segment, plan, placeholderGroup, {}, N + 1000, &search_result);
+        EXPECT_EQ(status.error_code, Success);
+        DeleteSearchPlan(plan);
+        DeletePlaceholderGroup(placeholderGroup);
+        return search_result;
+    };
+
+    auto result = search(R"({\"nprobe\": 10})");
+    ASSERT_EQ(GetSearchResultProfile(result), nullptr);
+    DeleteSearchResult(result);
+
+    result = search(R"({\"nprobe\": 10, \"profile\": true})");
+    auto& profile = ((SearchResult*)result)->profile_;
+    ASSERT_NE(profile, nullptr);
+    ASSERT_EQ(profile->active_count, N);
+    ASSERT_EQ(profile->search_path, "vector_search");
+    ASSERT_FALSE(profile->exprs.empty());
+    ASSERT_EQ(profile->exprs[0].rows_matched, N);
+    ASSERT_DOUBLE_EQ(profile->bitset_density, 1);
+    auto json = GetSearchResultProfile(result);
+    ASSERT_NE(json, nullptr);
+    auto parsed = nlohmann::json::parse(json);
+    ASSERT_EQ(parsed["search_path"], "vector_search");
+    ASSERT_EQ(parsed["exprs"].size(), profile->exprs.size());
+    free(json);
+    DeleteSearchResult(result);
+
+    DeleteCollection(c_collection);
+    DeleteSegment(segment);
 }
 
 TEST(CApiTest, LoadIndexInfo) {
@@ -1753,6 +2759,116 @@ TEST(CApiTest, LoadIndexInfo) {
     DeleteLoadIndexInfo(c_load_index_info);
 }
 
+// writes every binary of `binary_set` to an index file named by its key
+std::vector<std::string>
+WriteIndexFiles(milvus::storage::ChunkManager& chunk_manager,
+                const std::string& dir,
+                const knowhere::BinarySet& binary_set) {
+    std::vector<std::string> index_files;
+    for (auto& [key, binary] : binary_set.binary_map_) {
+        auto field_data =
+            milvus::storage::FieldDataFactory::GetInstance().CreateFieldData(
+                milvus::storage::DataType::INT8);
+        field_data->FillFieldData(binary->data.get(), binary->size);
+        milvus::storage::IndexData index_data(field_data);
+        index_data.SetFieldDataMeta({0, 0, 0, 0});
+        index_data.set_index_meta({0, 0, 1, 1});
+        auto bytes = index_data.Serialize(milvus::storage::StorageType::Remote);
+        auto path = dir + "/" + key;
+        chunk_manager.Write(path, bytes.data(), bytes.size());
+        index_files.push_back(path);
+    }
+    return index_files;
+}
+
+TEST(CApiTest, LoadIndexFromFiles) {
+    auto N = 1024 * 10;
+    auto [raw_data, timestamps, uids] = generate_data(N);
+    auto indexing = knowhere::IndexFactory::Instance().Create(
+        knowhere::IndexEnum::INDEX_FAISS_IVFSQ8);
+    auto conf =
+        knowhere::Json{{knowhere::meta::METRIC_TYPE, knowhere::metric::L2},
+                       {knowhere::meta::DIM, DIM},
+                       {knowhere::indexparam::NLIST, 100}};
+    auto database = knowhere::GenDataSet(N, DIM, raw_data.data());
+    indexing.Train(*database, conf);
+    indexing.Add(*database, conf);
+    knowhere::BinarySet binary_set;
+    indexing.Serialize(binary_set);
+
+    auto storage_config = get_default_storage_config();
+    auto rcm = std::make_unique<milvus::storage::MinioChunkManager>(
+        storage_config);
+    auto index_files = WriteIndexFiles(
+        *rcm, storage_config.remote_root_path + "/load_vec_index", binary_set);
+
+    void* c_load_index_info = nullptr;
+    auto status = NewLoadIndexInfo(&c_load_index_info, c_storage_config);
+    ASSERT_EQ(status.error_code, Success);
+    status = AppendIndexParam(c_load_index_info,
+                              "index_type",
+                              knowhere::IndexEnum::INDEX_FAISS_IVFSQ8);
+    ASSERT_EQ(status.error_code, Success);
+    status = AppendIndexParam(
+        c_load_index_info, knowhere::meta::METRIC_TYPE, knowhere::metric::L2);
+    ASSERT_EQ(status.error_code, Success);
+    status =
+        AppendFieldInfo(c_load_index_info, 0, 0, 0, 0, CDataType::FloatVector);
+    ASSERT_EQ(status.error_code, Success);
+    for (auto& path : index_files) {
+        status = AppendIndexFilePath(c_load_index_info, path.c_str());
+        ASSERT_EQ(status.error_code, Success);
+    }
+    status = AppendIndexFromFiles(c_load_index_info);
+    ASSERT_EQ(status.error_code, Success);
+    auto load_index_info = (LoadIndexInfo*)c_load_index_info;
+    ASSERT_EQ(load_index_info->index->Count(), N);
+
+    DeleteLoadIndexInfo(c_load_index_info);
+    for (auto& path : index_files) {
+        rcm->Remove(path);
+    }
+}
+
+TEST(CApiTest, LoadScalarIndexFromFiles) {
+    constexpr int64_t N = 10000;
+    std::vector<int64_t> data(N);
+    std::iota(data.begin(), data.end(), 0);
+    auto index = milvus::index::CreateScalarIndexSort<int64_t>();
+    index->Build(N, data.data());
+    auto binary_set = index->Serialize({});
+
+    auto storage_config = get_default_storage_config();
+    auto rcm = std::make_unique<milvus::storage::MinioChunkManager>(
+        storage_config);
+    auto index_files =
+        WriteIndexFiles(*rcm,
+                        storage_config.remote_root_path + "/load_scalar_index",
+                        binary_set);
+
+    void* c_load_index_info = nullptr;
+    auto status = NewLoadIndexInfo(&c_load_index_info, c_storage_config);
+    ASSERT_EQ(status.error_code, Success);
+    status = AppendIndexParam(
+        c_load_index_info, "index_type", milvus::index::ASCENDING_SORT);
+    ASSERT_EQ(status.error_code, Success);
+    status = AppendFieldInfo(c_load_index_info, 0, 0, 0, 0, CDataType::Int64);
+    ASSERT_EQ(status.error_code, Success);
+    for (auto& path : index_files) {
+        status = AppendIndexFilePath(c_load_index_info, path.c_str());
+        ASSERT_EQ(status.error_code, Success);
+    }
+    status = AppendIndexFromFiles(c_load_index_info);
+    ASSERT_EQ(status.error_code, Success);
+    auto load_index_info = (LoadIndexInfo*)c_load_index_info;
+    ASSERT_EQ(load_index_info->index->Count(), N);
+
+    DeleteLoadIndexInfo(c_load_index_info);
+    for (auto& path : index_files) {
+        rcm->Remove(path);
+    }
+}
+
 TEST(CApiTest, LoadIndex_Search) {
     // generator index
     constexpr auto TOPK = 10;
@@ -4458,3 +5574,68 @@ TEST(CApiTest, AssembeChunkTest) {
         ASSERT_EQ(result[index++], chunk[i]) << i;
     }
 }
+
+TEST(CApiTest, ChunkResultAssemblerTest) {
+    // chunk sizes which don't line up with the bitset blocks
+    std::vector<int64_t> sizes{1000, 934, 62, 105, 1};
+    auto row_count = std::accumulate(sizes.begin(), sizes.end(), int64_t(0));
+    milvus::query::ChunkResultAssembler assembler(row_count);
+    std::vector<bool> expected;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (i % 2 == 1) {
+            assembler.append(sizes[i], i % 4 == 1);
+            expected.insert(expected.end(), sizes[i], i % 4 == 1);
+            continue;
+        }
+        auto& chunk = assembler.scratch(sizes[i]);
+        ASSERT_EQ(chunk.size(), sizes[i]);
+        for (int64_t j = 0; j < sizes[i]; ++j) {
+            // the scratch buffer comes back cleared
+            ASSERT_FALSE(chunk[j]);
+            chunk[j] = (j + i) % 3 == 0;
+            expected.push_back(chunk[j]);
+        }
+        assembler.append(chunk);
+    }
+    auto result = assembler.finish();
+    ASSERT_EQ(result.size(), row_count);
+    for (int64_t i = 0; i < row_count; ++i) {
+        ASSERT_EQ(result[i], expected[i]) << i;
+    }
+}
+
+TEST(CApiTest, ProfilerTest) {
+    // the libraries are used only if the process has them
+    auto has_profiler = dlsym(RTLD_DEFAULT, "ProfilerStart") != nullptr;
+    auto status = StopCpuProfile();
+    ASSERT_NE(status.error_code, Success);
+    free((char*)status.error_msg);
+    if (has_profiler) {
+        auto path = fmt::format("/tmp/cpu_profile_{}", getpid());
+        status = StartCpuProfile(path.c_str(), 0);
+        ASSERT_EQ(status.error_code, Success);
+        status = StartCpuProfile(path.c_str(), 0);
+        ASSERT_NE(status.error_code, Success);
+        free((char*)status.error_msg);
+        status = StopCpuProfile();
+        ASSERT_EQ(status.error_code, Success);
+        std::remove(path.c_str());
+    } else {
+        status = StartCpuProfile("/tmp/cpu_profile", 1);
+        ASSERT_NE(status.error_code, Success);
+        free((char*)status.error_msg);
+    }
+
+    CJemallocStats stats;
+    status = GetJemallocStats(&stats);
+    if (dlsym(RTLD_DEFAULT, "mallctl") != nullptr) {
+        ASSERT_EQ(status.error_code, Success);
+        ASSERT_GT(stats.allocated, 0);
+        ASSERT_GE(stats.active, stats.allocated);
+        ASSERT_GE(stats.fragmentation, 0);
+        ASSERT_LT(stats.fragmentation, 1);
+    } else {
+        ASSERT_NE(status.error_code, Success);
+        free((char*)status.error_msg);
+    }
+}
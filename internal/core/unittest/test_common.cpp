@@ -10,7 +10,14 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <thread>
+#include <vector>
 #include <segcore/ConcurrentVector.h>
+#include "common/BitsetOps.h"
+#include "common/BitsetView.h"
+#include "common/Float16.h"
+#include "common/Metrics.h"
 #include "common/Types.h"
 #include "common/Span.h"
 #include "common/VectorTrait.h"
@@ -29,3 +36,136 @@ TEST(Common, Span) {
     ASSERT_EQ(r2.row_count(), 10);
     ASSERT_EQ(r2.element_sizeof(), 16 * sizeof(float));
 }
+
+TEST(Common, Float16) {
+    using namespace milvus;
+
+    // every half float survives a round trip through float
+    for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        auto value = Float16ToFloat(bits);
+        if (std::isnan(value)) {
+            ASSERT_TRUE(std::isnan(Float16ToFloat(FloatToFloat16(value))));
+            continue;
+        }
+        ASSERT_EQ(FloatToFloat16(value), bits);
+    }
+
+    ASSERT_EQ(FloatToFloat16(1.0f), 0x3c00);
+    ASSERT_EQ(FloatToFloat16(-2.0f), 0xc000);
+    ASSERT_EQ(Float16ToFloat(FloatToFloat16(65519.0f)), 65504.0f);
+    ASSERT_TRUE(std::isinf(Float16ToFloat(FloatToFloat16(65520.0f))));
+    // ties round to even
+    ASSERT_EQ(FloatToFloat16(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+    ASSERT_EQ(FloatToFloat16(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+    // subnormals
+    ASSERT_EQ(FloatToFloat16(std::ldexp(1.0f, -24)), 0x0001);
+    ASSERT_EQ(FloatToFloat16(std::ldexp(1.0f, -25)), 0x0000);
+}
+
+TEST(Common, Metrics) {
+    using namespace milvus::monitor;
+
+    // the updates of all threads are merged on scrape
+    Counter counter("test_counter_total", "a counter");
+    Histogram histogram("test_seconds", "a histogram");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2 * kMetricShards; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                counter.Inc();
+                // 1us and 2s
+                histogram.Observe(i % 2 == 0 ? 1000 : 2'000'000'000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(counter.Value(), 2 * kMetricShards * 1000);
+    ASSERT_EQ(histogram.Count(), 2 * kMetricShards * 1000);
+
+    std::string out;
+    counter.Serialize(out);
+    ASSERT_NE(out.find("# TYPE test_counter_total counter\n"),
+              std::string::npos);
+    ASSERT_NE(out.find("test_counter_total 32000\n"), std::string::npos);
+
+    out.clear();
+    histogram.Serialize(out);
+    ASSERT_NE(out.find("test_seconds_bucket{le=\"0.000100\"} 16000\n"),
+              std::string::npos);
+    ASSERT_NE(out.find("test_seconds_bucket{le=\"1.000000\"} 16000\n"),
+              std::string::npos);
+    ASSERT_NE(out.find("test_seconds_bucket{le=\"5.000000\"} 32000\n"),
+              std::string::npos);
+    ASSERT_NE(out.find("test_seconds_bucket{le=\"+Inf\"} 32000\n"),
+              std::string::npos);
+    ASSERT_NE(out.find("test_seconds_count 32000\n"), std::string::npos);
+
+    Gauge gauge("test_gauge", "a gauge");
+    gauge.Add(5);
+    gauge.Sub(2);
+    ASSERT_EQ(gauge.Value(), 3);
+    ASSERT_NE(SerializeSegcoreMetrics().find(
+                  "# TYPE milvus_segcore_expr_eval_seconds histogram"),
+              std::string::npos);
+}
+
+TEST(Common, ForEachBitBatch) {
+    for (int64_t num_bits : {0, 1, 63, 64, 65, 1000, 5000}) {
+        std::vector<uint8_t> data((num_bits + 7) / 8);
+        for (int64_t i = 0; i < num_bits; ++i) {
+            if (i % 3 == 0 || i % 7 == 0) {
+                data[i / 8] |= 1 << (i % 8);
+            }
+        }
+        std::vector<int64_t> set, unset;
+        for (int64_t i = 0; i < num_bits; ++i) {
+            auto bit = (data[i / 8] >> (i % 8)) & 1;
+            (bit ? set : unset).push_back(i);
+        }
+
+        std::vector<int64_t> got;
+        auto collect = [&](const int64_t* offsets, int64_t count) {
+            ASSERT_GT(count, 0);
+            ASSERT_LE(count, milvus::kBitBatchSize);
+            got.insert(got.end(), offsets, offsets + count);
+        };
+        milvus::ForEachBitBatch<true>(data.data(), num_bits, collect);
+        ASSERT_EQ(got, set);
+        got.clear();
+        milvus::ForEachBitBatch<false>(data.data(), num_bits, collect);
+        ASSERT_EQ(got, unset);
+    }
+}
+
+TEST(Common, BitsetOps) {
+    using milvus::BitsetType;
+    for (int64_t num_bits : {0, 1, 63, 64, 65, 1000, 4099}) {
+        BitsetType left(num_bits), right(num_bits);
+        for (int64_t i = 0; i < num_bits; ++i) {
+            left[i] = (i % 3 == 0);
+            right[i] = (i % 5 < 2);
+        }
+        auto res = left;
+        milvus::BitsetAnd(res, right);
+        ASSERT_EQ(res, left & right);
+        res = left;
+        milvus::BitsetOr(res, right);
+        ASSERT_EQ(res, left | right);
+        res = left;
+        milvus::BitsetAndNot(res, right);
+        ASSERT_EQ(res, left - right);
+        ASSERT_EQ(milvus::BitsetCount(left), int64_t(left.count()));
+
+        for (int64_t pos = 0; pos <= num_bits; pos += 7) {
+            auto next =
+                pos == 0 ? left.find_first() : left.find_next(pos - 1);
+            auto expect =
+                next == BitsetType::npos ? num_bits : int64_t(next);
+            ASSERT_EQ(milvus::BitsetFindNext(left, pos), expect);
+        }
+    }
+    BitsetType a(10), b(11);
+    ASSERT_ANY_THROW(milvus::BitsetAnd(a, b));
+}
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "segcore/ConcurrentVector.h"
+#include "segcore/Gather.h"
 #include "segcore/SegmentGrowing.h"
 #include "segcore/AckResponder.h"
 
@@ -94,6 +95,176 @@ TEST(ConcurrentVector, TestMultithreads) {
     }
 }
 
+TEST(ConcurrentVector, TestThreadSafeVectorReadWhileGrow) {
+    ThreadSafeVector<FixedVector<int64_t>> vec;
+    constexpr int64_t total_size = 10000;
+    std::atomic<bool> finished = false;
+
+    auto writer = [&] {
+        for (int64_t i = 1; i <= total_size; ++i) {
+            vec.emplace_to_at_least(i, 4);
+            vec[i - 1][0] = i - 1;
+        }
+        finished = true;
+    };
+    auto reader = [&] {
+        while (!finished) {
+            auto size = vec.size();
+            for (int64_t i = 0; i < size; i += 7) {
+                ASSERT_EQ(vec[i].size(), 4);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.emplace_back(writer);
+    for (int i = 0; i < 4; ++i) {
+        pool.emplace_back(reader);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    ASSERT_EQ(vec.size(), total_size);
+    for (int64_t i = 0; i < total_size; ++i) {
+        ASSERT_EQ(vec[i][0], i);
+    }
+    // elements never move once constructed
+    auto first = &vec[0];
+    vec.emplace_to_at_least(total_size * 4, 4);
+    ASSERT_EQ(first, &vec[0]);
+    vec.clear();
+    ASSERT_EQ(vec.size(), 0);
+}
+
+TEST(ConcurrentVector, TestChunkArena) {
+    auto arena = std::make_shared<ChunkArena>(false, 4 << 20);
+    {
+        auto dim = 16;
+        ConcurrentVector<FloatVector> vec(dim, 1024, arena);
+        ConcurrentVector<int64_t> pks(1024, arena);
+        int64_t total_count = 10 * 1024 + 7;
+        std::vector<float> data(total_count * dim);
+        std::vector<int64_t> pk_data(total_count);
+        for (int64_t i = 0; i < total_count; ++i) {
+            pk_data[i] = i;
+            for (int j = 0; j < dim; ++j) {
+                data[i * dim + j] = i * dim + j;
+            }
+        }
+        vec.set_data_raw(0, data.data(), total_count);
+        pks.set_data_raw(0, pk_data.data(), total_count);
+
+        ASSERT_EQ(vec.num_chunk(), 11);
+        ASSERT_EQ(arena->allocated_bytes(),
+                  11 * 1024 * (dim * sizeof(float) + sizeof(int64_t)));
+        ASSERT_EQ(arena->reserved_bytes(), 4 << 20);
+        for (int64_t i = 0; i < total_count; ++i) {
+            ASSERT_EQ(pks[i], i);
+            ASSERT_EQ(vec.get_element(i)[dim - 1], i * dim + dim - 1);
+        }
+
+        // chunks larger than half a slab are mapped on their own
+        ConcurrentVector<FloatVector> large(dim, 64 * 1024, arena);
+        large.grow_to_at_least(1);
+        ASSERT_EQ(arena->reserved_bytes(), 8 << 20);
+        // and do not break the slab being bumped
+        pks.grow_to_at_least(total_count + 1024);
+        ASSERT_EQ(pks[total_count - 1], total_count - 1);
+    }
+    // the chunks are gone, the arena keeps the memory until released
+    ASSERT_EQ(arena.use_count(), 1);
+}
+
+TEST(ConcurrentVector, TestGatherChunkedRows) {
+    auto dim = 4;
+    ConcurrentVector<FloatVector> vec(dim, 100);
+    ConcurrentVector<int16_t> scalars(100);
+    ConcurrentVector<std::string> strings(100);
+    int64_t total_count = 1000 + 7;
+    std::vector<float> data(total_count * dim);
+    std::vector<int16_t> scalar_data(total_count);
+    std::vector<std::string> string_data(total_count);
+    for (int64_t i = 0; i < total_count; ++i) {
+        scalar_data[i] = i;
+        string_data[i] = std::to_string(i);
+        for (int j = 0; j < dim; ++j) {
+            data[i * dim + j] = i * dim + j;
+        }
+    }
+    vec.set_data_raw(0, data.data(), total_count);
+    scalars.set_data_raw(0, scalar_data.data(), total_count);
+    strings.set_data_raw(0, string_data.data(), total_count);
+
+    std::default_random_engine er(42);
+    std::vector<int64_t> offsets;
+    for (int i = 0; i < 500; ++i) {
+        offsets.push_back(i % 10 == 0 ? INVALID_SEG_OFFSET
+                                      : er() % total_count);
+    }
+    auto count = int64_t(offsets.size());
+    std::vector<float> rows(count * dim, -1);
+    std::vector<int32_t> values(count, -1);
+    std::vector<std::string> texts(count);
+    GatherChunkedRows(vec,
+                      dim * sizeof(float),
+                      offsets.data(),
+                      count,
+                      reinterpret_cast<char*>(rows.data()));
+    GatherChunkedRows<int16_t>(scalars, offsets.data(), count, values.data());
+    GatherChunkedRows<std::string_view>(
+        strings, offsets.data(), count, texts);
+    // rows at invalid offsets are left as they are
+    for (int64_t i = 0; i < count; ++i) {
+        auto offset = offsets[i];
+        if (offset == INVALID_SEG_OFFSET) {
+            ASSERT_EQ(values[i], -1);
+            ASSERT_EQ(rows[i * dim], -1);
+            ASSERT_TRUE(texts[i].empty());
+            continue;
+        }
+        ASSERT_EQ(values[i], offset);
+        ASSERT_EQ(texts[i], std::to_string(offset));
+        for (int j = 0; j < dim; ++j) {
+            ASSERT_EQ(rows[i * dim + j], offset * dim + j);
+        }
+    }
+}
+
+TEST(ConcurrentVector, TestFloat16Vector) {
+    auto dim = 4;
+    ConcurrentFloat16Vector vec(dim, 100);
+    int64_t total_count = 1000 + 7;
+    std::vector<float> data(total_count * dim);
+    for (int64_t i = 0; i < total_count; ++i) {
+        for (int j = 0; j < dim; ++j) {
+            // exact in half precision
+            data[i * dim + j] = (i % 256) + j * 0.5f;
+        }
+    }
+    // writes crossing the chunks
+    vec.set_data_raw(0, data.data(), 150);
+    vec.set_data_raw(150, data.data() + 150 * dim, total_count - 150);
+    ASSERT_EQ(vec.num_chunk(), 11);
+
+    std::vector<float> rows(100 * dim);
+    vec.decode_rows(300, 100, rows.data());
+    for (int64_t i = 0; i < 100 * dim; ++i) {
+        ASSERT_EQ(rows[i], data[300 * dim + i]);
+    }
+
+    std::vector<int64_t> offsets{5, INVALID_SEG_OFFSET, 999, 1006};
+    std::vector<float> gathered(offsets.size() * dim, -1);
+    vec.gather_rows(offsets.data(), offsets.size(), gathered.data());
+    for (int64_t i = 0; i < int64_t(offsets.size()); ++i) {
+        for (int j = 0; j < dim; ++j) {
+            auto expected = offsets[i] == INVALID_SEG_OFFSET
+                                ? -1
+                                : data[offsets[i] * dim + j];
+            ASSERT_EQ(gathered[i * dim + j], expected);
+        }
+    }
+}
+
 TEST(ConcurrentVector, TestAckSingle) {
     std::vector<std::tuple<int64_t, int64_t, int64_t>> raw_data;
     std::default_random_engine e(42);
@@ -112,3 +283,95 @@ TEST(ConcurrentVector, TestAckSingle) {
     }
     EXPECT_EQ(ack.GetAck(), N);
 }
+
+TEST(ConcurrentVector, TestAckMultithreads) {
+    AckResponder ack;
+    std::atomic<int64_t> reserved = 0;
+    int64_t total = 1 << 20;
+    auto worker = [&](int seed) {
+        std::default_random_engine e(seed);
+        while (true) {
+            auto size = int64_t(e() % 64 + 1);
+            auto begin = reserved.fetch_add(size);
+            if (begin >= total) {
+                break;
+            }
+            auto end = std::min(begin + size, total);
+            ack.AddSegment(begin, end);
+            // everything before an acked offset has been added, reserved
+            // is read after the ack, as it only grows
+            auto acked = ack.GetAck();
+            ASSERT_GE(acked, 0);
+            ASSERT_LE(acked, reserved.load());
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(ack.GetAck(), total);
+}
+
+TEST(ConcurrentVector, TestAckInterleaved) {
+    // neighbouring segments are added by different threads at about the
+    // same time, so a publish often races the ack moving up to it
+    constexpr int threads = 4;
+    constexpr int64_t window = 64;
+    for (int round = 0; round < 20; ++round) {
+        AckResponder ack;
+        int64_t total = 1 << 16;
+        auto worker = [&](int thread_id) {
+            for (int64_t base = 0; base < total; base += window) {
+                // later segments of a window first
+                for (int64_t i = base + window - 1; i >= base; --i) {
+                    if (i % threads == thread_id) {
+                        ack.AddSegment(i, i + 1);
+                    }
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(worker, i);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        ASSERT_EQ(ack.GetAck(), total);
+    }
+}
+
+TEST(ConcurrentVector, TestAckSlotCollision) {
+    AckResponder ack;
+    // out of order segments, many of them share a slot of the ring
+    int64_t n = 10000;
+    for (int64_t i = n - 1; i > 0; --i) {
+        ack.AddSegment(i, i + 1);
+        ASSERT_EQ(ack.GetAck(), 0);
+    }
+    ack.AddSegment(0, 1);
+    ASSERT_EQ(ack.GetAck(), n);
+}
+
+TEST(ConcurrentVector, VariableRows) {
+    ConcurrentVector<std::string> strings(4);
+    std::vector<std::string> string_data{"", "a", "bc", "def", "ghij", "k"};
+    strings.set_data_raw(0, string_data.data(), string_data.size());
+    ASSERT_EQ(strings.num_chunk(), 2);
+    for (size_t i = 0; i < string_data.size(); ++i) {
+        ASSERT_EQ(strings[i], string_data[i]);
+    }
+    // the rows of a write share one block
+    ASSERT_GE(strings.memory_size(),
+              int64_t(ConcurrentVector<std::string>::BLOCK_SIZE));
+
+    ConcurrentVector<Json> jsons(4);
+    std::vector<std::string_view> docs{R"({"a": 1})", R"({"a": 22})"};
+    jsons.set_rows(3, docs.data(), docs.size());
+    ASSERT_EQ(jsons[3].at<int64_t>("/a").value(), 1);
+    ASSERT_EQ(jsons[4].at<int64_t>("/a").value(), 22);
+    ASSERT_EQ(std::string_view(jsons[4]), docs[1]);
+}
@@ -15,13 +15,20 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <numeric>
+#include <random>
 
+#include "storage/BinlogStreamReader.h"
 #include "storage/DataCodec.h"
+#include "storage/PayloadReader.h"
 #include "storage/InsertData.h"
 #include "storage/IndexData.h"
 #include "storage/FieldDataFactory.h"
+#include "storage/FieldDataPool.h"
 #include "common/Consts.h"
+#include "simd/crc32c.h"
 #include "utils/Json.h"
+#include "test_utils/MemChunkManager.h"
 
 using namespace milvus;
 
@@ -342,3 +349,184 @@ TEST(storage, IndexData) {
     memcpy(new_data.data(), new_field_data->Data(), new_field_data->Size());
     ASSERT_EQ(data, new_data);
 }
+
+TEST(storage, DeserializeRemoteFileData) {
+    // random values, so the payload is much larger than the parquet footer
+    std::mt19937_64 rng(42);
+    std::vector<int64_t> data(100000);
+    for (auto& value : data) {
+        value = rng();
+    }
+    auto field_data =
+        milvus::storage::FieldDataFactory::GetInstance().CreateFieldData(
+            storage::DataType::INT64);
+    field_data->FillFieldData(data.data(), data.size());
+
+    storage::InsertData insert_data(field_data);
+    storage::FieldDataMeta field_data_meta{100, 101, 102, 103};
+    insert_data.SetFieldDataMeta(field_data_meta);
+    insert_data.SetTimestamps(0, 100);
+    auto serialized_bytes = insert_data.Serialize(storage::StorageType::Remote);
+
+    storage::MemChunkManager chunk_manager;
+    chunk_manager.Write(
+        "binlog", serialized_bytes.data(), serialized_bytes.size());
+    auto new_insert_data =
+        storage::DeserializeRemoteFileData(&chunk_manager, "binlog");
+    ASSERT_EQ(new_insert_data->GetCodecType(), storage::InsertDataType);
+    ASSERT_EQ(new_insert_data->GetTimeRage(),
+              std::make_pair(Timestamp(0), Timestamp(100)));
+    auto new_payload = new_insert_data->GetFieldData();
+    ASSERT_EQ(new_payload->get_data_type(), storage::DataType::INT64);
+    ASSERT_EQ(new_payload->get_num_rows(), data.size());
+    std::vector<int64_t> new_data(data.size());
+    memcpy(new_data.data(), new_payload->Data(), new_payload->Size());
+    ASSERT_EQ(data, new_data);
+
+    // a row group out of range is rejected after reading only the footer
+    chunk_manager.read_bytes_ = 0;
+    ASSERT_ANY_THROW(
+        storage::DeserializeRemoteFileData(&chunk_manager, "binlog", {1}));
+    ASSERT_LT(chunk_manager.read_bytes_, serialized_bytes.size());
+}
+
+TEST(storage, BinlogStreamReader) {
+    FixedVector<int64_t> data = {1, 2, 3, 4, 5};
+    auto field_data =
+        milvus::storage::FieldDataFactory::GetInstance().CreateFieldData(
+            storage::DataType::INT64);
+    field_data->FillFieldData(data.data(), data.size());
+
+    storage::InsertData insert_data(field_data);
+    storage::FieldDataMeta field_data_meta{100, 101, 102, 103};
+    insert_data.SetFieldDataMeta(field_data_meta);
+    insert_data.SetTimestamps(0, 100);
+    auto serialized_bytes = insert_data.Serialize(storage::StorageType::Remote);
+
+    // a second event after the one of the insert data
+    storage::BaseEvent event;
+    event.event_header.event_type_ = storage::EventType::InsertEvent;
+    event.event_header.timestamp_ = 200;
+    event.event_data.start_timestamp = 100;
+    event.event_data.end_timestamp = 200;
+    event.event_data.field_data = field_data;
+    auto event_bytes = event.Serialize();
+    serialized_bytes.insert(
+        serialized_bytes.end(), event_bytes.begin(), event_bytes.end());
+
+    auto buffer = std::make_shared<arrow::Buffer>(serialized_bytes.data(),
+                                                  serialized_bytes.size());
+    storage::BinlogStreamReader stream(
+        std::make_shared<arrow::io::BufferReader>(buffer));
+    ASSERT_EQ(stream.GetDataType(), storage::DataType::INT64);
+    ASSERT_EQ(stream.GetDescriptorEvent().event_data.fix_part.field_id, 103);
+
+    auto first = stream.Next(true);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_EQ(first->end_timestamp, 100);
+    ASSERT_EQ(first->payload, nullptr);
+
+    auto second = stream.Next();
+    ASSERT_TRUE(second.has_value());
+    ASSERT_EQ(second->start_timestamp, 100);
+    ASSERT_EQ(second->end_timestamp, 200);
+    // the payload is a slice of the binlog buffer
+    ASSERT_GE(second->payload->data(), serialized_bytes.data());
+    ASSERT_LE(second->payload->data() + second->payload->size(),
+              serialized_bytes.data() + serialized_bytes.size());
+    storage::PayloadReader payload_reader(
+        std::make_shared<arrow::io::BufferReader>(second->payload),
+        storage::DataType::INT64);
+    auto new_payload = payload_reader.get_field_data();
+    ASSERT_EQ(new_payload->get_num_rows(), data.size());
+    FixedVector<int64_t> new_data(data.size());
+    memcpy(new_data.data(), new_payload->Data(), new_payload->Size());
+    ASSERT_EQ(data, new_data);
+
+    ASSERT_FALSE(stream.Next().has_value());
+}
+
+TEST(storage, PayloadChecksum) {
+    const char check[] = "123456789";
+    ASSERT_EQ(simd::Crc32c(0, check, 9), 0xe3069283);
+    ASSERT_EQ(simd::Crc32c(simd::Crc32c(0, check, 4), check + 4, 5),
+              0xe3069283);
+    ASSERT_EQ(simd::Crc32cCombine(simd::Crc32c(0, check, 4),
+                                  simd::Crc32c(0, check + 4, 5),
+                                  5),
+              0xe3069283);
+
+    FixedVector<int64_t> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    auto field_data =
+        milvus::storage::FieldDataFactory::GetInstance().CreateFieldData(
+            storage::DataType::INT64);
+    field_data->FillFieldData(data.data(), data.size());
+    storage::InsertData insert_data(field_data);
+    insert_data.SetFieldDataMeta({100, 101, 102, 103});
+    insert_data.SetTimestamps(0, 100);
+    auto serialized_bytes = insert_data.Serialize(storage::StorageType::Remote);
+    auto size = int64_t(serialized_bytes.size());
+    std::shared_ptr<uint8_t[]> serialized_data_ptr(serialized_bytes.data(),
+                                                   [&](uint8_t*) {});
+
+    // from the payload, or from the checksum of the whole file
+    auto file_checksum = simd::Crc32c(0, serialized_bytes.data(), size);
+    for (auto checksum :
+         std::vector<std::optional<uint32_t>>{std::nullopt, file_checksum}) {
+        auto codec =
+            storage::DeserializeFileData(serialized_data_ptr, size, checksum);
+        ASSERT_EQ(codec->GetFieldData()->get_num_rows(), data.size());
+    }
+
+    // a byte flipped in the payload, at the end of the binlog
+    serialized_bytes[size - 10] ^= 0x1;
+    ASSERT_ANY_THROW(
+        storage::DeserializeFileData(serialized_data_ptr, size));
+    file_checksum = simd::Crc32c(0, serialized_bytes.data(), size);
+    ASSERT_ANY_THROW(storage::DeserializeFileData(
+        serialized_data_ptr, size, file_checksum));
+}
+
+TEST(storage, FieldDataPool) {
+    auto& pool = storage::FieldDataPool::GetInstance();
+    auto capacity = pool.GetCapacity();
+    pool.Clear();
+    pool.SetCapacity(64 << 20);
+
+    // 1M floats, a buffer of 4MB
+    FixedVector<float> data(1 << 20);
+    std::iota(data.begin(), data.end(), 0);
+    auto fill = [&] {
+        auto field_data =
+            storage::FieldDataFactory::GetInstance().CreateFieldData(
+                storage::DataType::FLOAT);
+        field_data->FillFieldData(data.data(), data.size());
+        return field_data;
+    };
+    auto before = pool.GetStats();
+    {
+        auto field_data = fill();
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(field_data->Data()) %
+                      storage::FieldDataPool::kHugePageSize,
+                  size_t(0));
+        ASSERT_EQ(pool.GetStats().used_bytes - before.used_bytes, 4 << 20);
+    }
+    // the buffer went back to the pool and is reused
+    ASSERT_EQ(pool.GetStats().cached_bytes, 4 << 20);
+    {
+        auto field_data = fill();
+        auto stats = pool.GetStats();
+        ASSERT_EQ(stats.hits - before.hits, 1);
+        ASSERT_EQ(stats.cached_bytes, 0);
+        ASSERT_EQ(memcmp(field_data->Data(), data.data(), data.size() * 4),
+                  0);
+    }
+
+    // nothing is kept over the capacity
+    pool.SetCapacity(0);
+    ASSERT_EQ(pool.GetStats().cached_bytes, 0);
+    fill();
+    ASSERT_EQ(pool.GetStats().cached_bytes, 0);
+    pool.SetCapacity(capacity);
+}
@@ -9,12 +9,23 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstring>
+#include <future>
 #include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unistd.h>
 
+#include "common/Common.h"
+#include "common/CpuGroup.h"
+#include "common/MpmcQueue.h"
 #include "common/Slice.h"
 #include "storage/Event.h"
 #include "storage/LocalChunkManager.h"
@@ -22,6 +33,8 @@
 #include "storage/DiskFileManagerImpl.h"
 #include "storage/ThreadPool.h"
 #include "storage/FieldDataFactory.h"
+#include "storage/IndexData.h"
+#include "storage/Util.h"
 #include "config/ConfigChunkManager.h"
 #include "test_utils/indexbuilder_test_utils.h"
 
@@ -179,6 +192,181 @@ TEST_F(DiskAnnFileManagerTest, AddFilePositiveParallel) {
     EXPECT_EQ(ok, true);
 }
 
+TEST_F(DiskAnnFileManagerTest, ReuseCachedIndexFiles) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    string testBucketName = "test-diskann";
+    storage_config_.bucket_name = testBucketName;
+    auto rcm = std::make_unique<MinioChunkManager>(storage_config_);
+    if (!rcm->BucketExists(testBucketName)) {
+        rcm->CreateBucket(testBucketName);
+    }
+
+    std::string indexFilePath = "/tmp/diskann/index_files/1001/index";
+    uint64_t index_size = 10 << 20;
+    lcm.CreateFile(indexFilePath);
+    std::vector<uint8_t> data(index_size, 1);
+    lcm.Write(indexFilePath, data.data(), index_size);
+
+    FieldDataMeta filed_data_meta = {1, 2, 3, 100};
+    IndexMeta index_meta = {3, 100, 1001, 1, "index"};
+    auto diskAnnFileManager = std::make_shared<DiskFileManagerImpl>(
+        filed_data_meta, index_meta, storage_config_);
+    auto ok = diskAnnFileManager->AddFile(indexFilePath);
+    EXPECT_EQ(ok, true);
+    std::vector<std::string> remote_files;
+    for (auto& file2size : diskAnnFileManager->GetRemotePathsToFileSize()) {
+        remote_files.emplace_back(file2size.first);
+    }
+    diskAnnFileManager->CacheIndexToDisk(remote_files);
+    auto local_file = diskAnnFileManager->GetLocalFilePaths().back();
+    auto manifest = diskAnnFileManager->GetCacheManifest();
+    EXPECT_EQ(manifest["files"]["index"]["size"], index_size);
+    auto manifests = GetIndexCacheManifests();
+    EXPECT_TRUE(std::any_of(
+        manifests.begin(), manifests.end(), [](const Config& manifest) {
+            return manifest["build_id"] == 1001;
+        }));
+
+    // a valid cached file is kept as is, as after a restart of the node
+    uint8_t marker = 7;
+    lcm.Write(local_file, 0, &marker, sizeof(marker));
+    auto reload_manager = std::make_shared<DiskFileManagerImpl>(
+        filed_data_meta, index_meta, storage_config_);
+    reload_manager->CacheIndexToDisk(remote_files);
+    uint8_t first = 0;
+    lcm.Read(local_file, 0, &first, sizeof(first));
+    EXPECT_EQ(first, marker);
+
+    // a cached file of another size is downloaded again
+    lcm.Write(local_file, index_size, &marker, sizeof(marker));
+    reload_manager->CacheIndexToDisk(remote_files);
+    EXPECT_EQ(lcm.Size(local_file), index_size);
+    lcm.Read(local_file, 0, &first, sizeof(first));
+    EXPECT_EQ(first, 1);
+
+    auto objects =
+        rcm->ListWithPrefix(diskAnnFileManager->GetRemoteIndexObjectPrefix());
+    for (auto obj : objects) {
+        rcm->Remove(obj);
+    }
+    ok = rcm->DeleteBucket(testBucketName);
+    EXPECT_EQ(ok, true);
+}
+
+TEST_F(DiskAnnFileManagerTest, AddFileManySlices) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    string testBucketName = "test-diskann";
+    storage_config_.bucket_name = testBucketName;
+    auto rcm = std::make_unique<MinioChunkManager>(storage_config_);
+    if (!rcm->BucketExists(testBucketName)) {
+        rcm->CreateBucket(testBucketName);
+    }
+
+    // more slices than buffers, so the buffers are reused, and a short last
+    // slice
+    auto slice_size_mb = milvus::index_file_slice_size;
+    milvus::SetIndexSliceSize(1);
+    int64_t slice_size = 1 << 20;
+    auto num_buffers = DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT / slice_size;
+    int64_t index_size = (num_buffers + 3) * slice_size + 12345;
+    std::string indexFilePath = "/tmp/diskann/index_files/1002/index";
+    lcm.CreateFile(indexFilePath);
+    std::vector<uint8_t> data(index_size);
+    for (int64_t i = 0; i < index_size; ++i) {
+        // differs between slices at the same offset
+        data[i] = uint8_t(i * 31 + i / slice_size);
+    }
+    lcm.Write(indexFilePath, data.data(), index_size);
+
+    FieldDataMeta filed_data_meta = {1, 2, 3, 100};
+    IndexMeta index_meta = {3, 100, 1002, 1, "index"};
+    auto diskAnnFileManager = std::make_shared<DiskFileManagerImpl>(
+        filed_data_meta, index_meta, storage_config_);
+    auto ok = diskAnnFileManager->AddFile(indexFilePath);
+    milvus::SetIndexSliceSize(slice_size_mb);
+    EXPECT_EQ(ok, true);
+
+    auto num_slices = (index_size + slice_size - 1) / slice_size;
+    auto remote_files_to_size = diskAnnFileManager->GetRemotePathsToFileSize();
+    ASSERT_EQ(remote_files_to_size.size(), num_slices);
+    std::vector<std::string> remote_files;
+    for (int64_t i = 0; i < num_slices; ++i) {
+        remote_files.push_back(
+            diskAnnFileManager->GenerateRemoteIndexFile("index", i));
+        ASSERT_EQ(remote_files_to_size.count(remote_files.back()), 1);
+    }
+    std::vector<uint8_t> uploaded;
+    DownloadAndDecodeRemoteFiles(
+        rcm.get(), remote_files, 4, [&](const FieldDataPtr& field_data) {
+            auto begin = static_cast<const uint8_t*>(field_data->Data());
+            uploaded.insert(uploaded.end(), begin, begin + field_data->Size());
+        });
+    EXPECT_EQ(uploaded, data);
+
+    for (auto& path : remote_files) {
+        rcm->Remove(path);
+    }
+    ok = rcm->DeleteBucket(testBucketName);
+    EXPECT_EQ(ok, true);
+}
+
+TEST_F(DiskAnnFileManagerTest, CacheUnevenSlices) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    string testBucketName = "test-diskann";
+    storage_config_.bucket_name = testBucketName;
+    auto rcm = std::make_unique<MinioChunkManager>(storage_config_);
+    if (!rcm->BucketExists(testBucketName)) {
+        rcm->CreateBucket(testBucketName);
+    }
+
+    FieldDataMeta filed_data_meta = {1, 2, 3, 100};
+    IndexMeta index_meta = {3, 100, 1003, 1, "index"};
+    auto diskAnnFileManager = std::make_shared<DiskFileManagerImpl>(
+        filed_data_meta, index_meta, storage_config_);
+
+    // the first slice allows batches of 3, so the offsets carry over batches
+    std::vector<int64_t> slice_sizes = {(20 << 20) + 1,
+                                        (3 << 20) + 5,
+                                        17,
+                                        (7 << 20) + 3,
+                                        1 << 20,
+                                        (20 << 20) - 9,
+                                        1};
+    std::vector<uint8_t> data;
+    std::vector<std::string> remote_files;
+    for (size_t i = 0; i < slice_sizes.size(); ++i) {
+        std::vector<uint8_t> slice(slice_sizes[i]);
+        for (size_t j = 0; j < slice.size(); ++j) {
+            slice[j] = uint8_t(j * 31 + i);
+        }
+        data.insert(data.end(), slice.begin(), slice.end());
+
+        auto field_data = FieldDataFactory::GetInstance().CreateFieldData(
+            storage::DataType::INT8);
+        field_data->FillFieldData(slice.data(), slice.size());
+        auto index_data = std::make_shared<IndexData>(field_data);
+        index_data->set_index_meta(index_meta);
+        index_data->SetFieldDataMeta(filed_data_meta);
+        auto serialized = index_data->serialize_to_remote_file();
+        remote_files.push_back(
+            diskAnnFileManager->GenerateRemoteIndexFile("index", i));
+        rcm->Write(remote_files.back(), serialized.data(), serialized.size());
+    }
+
+    diskAnnFileManager->CacheIndexToDisk(remote_files);
+    auto local_file = diskAnnFileManager->GetLocalFilePaths().back();
+    ASSERT_EQ(lcm.Size(local_file), data.size());
+    std::vector<uint8_t> cached(data.size());
+    lcm.Read(local_file, cached.data(), cached.size());
+    EXPECT_EQ(cached, data);
+
+    for (auto& path : remote_files) {
+        rcm->Remove(path);
+    }
+    auto ok = rcm->DeleteBucket(testBucketName);
+    EXPECT_EQ(ok, true);
+}
+
 int
 test_worker(string s) {
     std::cout << s << std::endl;
@@ -205,6 +393,155 @@ TEST_F(DiskAnnFileManagerTest, TestThreadPool) {
     EXPECT_LT(second, 4 * 100);
 }
 
+TEST_F(DiskAnnFileManagerTest, TestThreadPoolNestedSubmit) {
+    auto thread_pool = std::make_unique<milvus::ThreadPool>(2);
+    // tasks submitted by workers go to their own deques and can be stolen
+    auto sum = thread_pool->Submit([&]() {
+        std::vector<std::future<int>> futures;
+        for (int i = 0; i < 100; i++) {
+            futures.push_back(thread_pool->Submit(
+                milvus::TaskPriority::LOW, [i]() { return i; }));
+        }
+        int sum = 0;
+        for (auto& future : futures) {
+            sum += future.get();
+        }
+        return sum;
+    });
+    EXPECT_EQ(sum.get(), 4950);
+}
+
+TEST_F(DiskAnnFileManagerTest, TestThreadPoolExternalSubmit) {
+    auto thread_pool = std::make_unique<milvus::ThreadPool>(1);
+    // more tasks than the shared queue holds, the rest go to the deques
+    constexpr int num_submitters = 4;
+    constexpr int num_tasks = 4000;
+    std::atomic<int64_t> sum = 0;
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < num_submitters; t++) {
+        submitters.emplace_back([&]() {
+            std::vector<std::future<void>> futures;
+            for (int i = 0; i < num_tasks; i++) {
+                futures.push_back(
+                    thread_pool->Submit([&sum, i]() { sum += i; }));
+            }
+            for (auto& future : futures) {
+                future.get();
+            }
+        });
+    }
+    for (auto& submitter : submitters) {
+        submitter.join();
+    }
+    EXPECT_EQ(sum.load(),
+              int64_t(num_submitters) * num_tasks * (num_tasks - 1) / 2);
+}
+
+TEST(MpmcQueue, PushPop) {
+    milvus::MpmcQueue<std::unique_ptr<int>> queue(3);
+    ASSERT_EQ(queue.Capacity(), size_t(4));
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPush(std::make_unique<int>(i)));
+    }
+    auto full = std::make_unique<int>(4);
+    ASSERT_FALSE(queue.TryPush(std::move(full)));
+    ASSERT_NE(full, nullptr);
+    std::unique_ptr<int> value;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(*value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+}
+
+TEST_F(DiskAnnFileManagerTest, TestThreadPoolParallelFor) {
+    auto thread_pool = std::make_unique<milvus::ThreadPool>(2);
+    // every worker waits in a ParallelFor of its own, the callers finish
+    // the indexes no worker got to
+    std::vector<std::future<int64_t>> sums;
+    for (int i = 0; i < 4; i++) {
+        sums.push_back(thread_pool->Submit([&]() {
+            std::vector<int64_t> values(1000);
+            thread_pool->ParallelFor(
+                1000, 8, [&](int64_t j) { values[j] = j; });
+            return std::accumulate(values.begin(), values.end(), int64_t(0));
+        }));
+    }
+    for (auto& sum : sums) {
+        EXPECT_EQ(sum.get(), 499500);
+    }
+    auto throw_at_60 = [](int64_t j) {
+        if (j == 60) {
+            throw std::runtime_error("run time error");
+        }
+    };
+    EXPECT_THROW(thread_pool->ParallelFor(100, 4, throw_at_60),
+                 std::runtime_error);
+}
+
+namespace {
+void
+SpinCpu(int64_t nanos) {
+    auto begin = milvus::ThreadCpuNanos();
+    while (milvus::ThreadCpuNanos() - begin < nanos) {
+    }
+}
+}  // namespace
+
+TEST(ThreadPool, CpuGroups) {
+    milvus::ThreadPool thread_pool(int64_t(1), -1);
+    auto heavy = milvus::GetCpuGroup(1001);
+    auto light = milvus::GetCpuGroup(1002);
+    light->set_weight(3);
+
+    // the only worker is held until both groups have queued their tasks
+    std::promise<void> gate;
+    auto held = thread_pool.Submit(
+        [opened = gate.get_future().share()]() { opened.wait(); });
+    constexpr int num_tasks = 40;
+    std::mutex mutex;
+    std::vector<int64_t> order;
+    std::vector<std::future<void>> futures;
+    for (auto group : {heavy, light}) {
+        milvus::CpuGroupScope cpu_group_scope(group);
+        for (int i = 0; i < num_tasks; i++) {
+            futures.push_back(thread_pool.Submit([&, group]() {
+                SpinCpu(1'000'000);
+                std::lock_guard lck(mutex);
+                order.push_back(group->id());
+            }));
+        }
+    }
+    auto heavy_nanos = heavy->cpu_nanos();
+    gate.set_value();
+    held.get();
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    // queued all before the light ones, the heavy tasks get a quarter of
+    // the worker while both have tasks queued
+    auto light_runs = std::count(order.begin(), order.begin() + 20, 1002);
+    EXPECT_GE(light_runs, 13);
+    EXPECT_LE(light_runs, 17);
+    EXPECT_EQ(heavy->tasks(), num_tasks);
+    EXPECT_GE(heavy->cpu_nanos() - heavy_nanos, num_tasks * 1'000'000);
+
+    // a nested scope charges its own group only
+    auto outer = milvus::GetCpuGroup(1003);
+    auto inner = milvus::GetCpuGroup(1004);
+    {
+        milvus::CpuGroupScope outer_scope(outer);
+        SpinCpu(2'000'000);
+        milvus::CpuGroupScope inner_scope(inner);
+        SpinCpu(4'000'000);
+    }
+    EXPECT_GE(outer->cpu_nanos(), 2'000'000);
+    EXPECT_LT(outer->cpu_nanos(), 4'000'000);
+    EXPECT_GE(inner->cpu_nanos(), 4'000'000);
+    EXPECT_EQ(milvus::GetActiveCpuGroup(), nullptr);
+}
+
 int
 test_exception(string s) {
     if (s == "test_id60") {
@@ -227,4 +564,62 @@ TEST_F(DiskAnnFileManagerTest, TestThreadPoolException) {
     } catch (std::exception& e) {
         EXPECT_EQ(std::string(e.what()), "run time error");
     }
-}
\ No newline at end of file
+}
+TEST_F(DiskAnnFileManagerTest, PutIndexData) {
+    string testBucketName = "test-put-index-data";
+    storage_config_.bucket_name = testBucketName;
+    auto rcm = std::make_unique<MinioChunkManager>(storage_config_);
+    if (!rcm->BucketExists(testBucketName)) {
+        rcm->CreateBucket(testBucketName);
+    }
+
+    auto slice_size_mb = milvus::index_file_slice_size;
+    milvus::SetIndexSliceSize(1);
+    int64_t big_size = (5 << 20) / 2;
+    std::shared_ptr<uint8_t[]> big(new uint8_t[big_size]);
+    std::iota(big.get(), big.get() + big_size, 0);
+    std::shared_ptr<uint8_t[]> small(new uint8_t[10]);
+    std::iota(small.get(), small.get() + 10, 7);
+    BinarySet binary_set;
+    binary_set.Append("big", big, big_size);
+    binary_set.Append("small", small, 10);
+
+    FieldDataMeta field_data_meta = {1, 2, 3, 100};
+    IndexMeta index_meta = {3, 100, 1001, 1};
+    auto prefix = GenRemoteIndexPathPrefix(
+        storage_config_.remote_root_path, field_data_meta, index_meta);
+    auto remote_paths_to_size = PutIndexData(
+        rcm.get(), binary_set, prefix, field_data_meta, index_meta, 2);
+    milvus::SetIndexSliceSize(slice_size_mb);
+    // 3 slices of the big one, the small one and the slice meta
+    ASSERT_EQ(remote_paths_to_size.size(), 5);
+    ASSERT_TRUE(binary_set.binary_map_.empty());
+
+    std::vector<std::string> remote_files;
+    for (auto& [path, size] : remote_paths_to_size) {
+        ASSERT_EQ(path.rfind(prefix + "/", 0), 0);
+        ASSERT_EQ(rcm->Size(path), size);
+        remote_files.push_back(path);
+    }
+    BinarySet loaded;
+    size_t i = 0;
+    DownloadAndDecodeRemoteFiles(
+        rcm.get(), remote_files, 2, [&](const FieldDataPtr& field_data) {
+            auto key = boost::filesystem::path(remote_files[i++]).filename();
+            std::shared_ptr<uint8_t[]> data(new uint8_t[field_data->Size()]);
+            memcpy(data.get(), field_data->Data(), field_data->Size());
+            loaded.Append(key.string(), data, field_data->Size());
+        });
+    milvus::Assemble(loaded);
+    ASSERT_EQ(loaded.binary_map_.size(), 2);
+    ASSERT_EQ(loaded.GetByName("big")->size, big_size);
+    ASSERT_EQ(memcmp(loaded.GetByName("big")->data.get(), big.get(), big_size),
+              0);
+    ASSERT_EQ(memcmp(loaded.GetByName("small")->data.get(), small.get(), 10),
+              0);
+
+    for (auto& path : remote_files) {
+        rcm->Remove(path);
+    }
+    rcm->DeleteBucket(testBucketName);
+}
@@ -11,21 +11,28 @@
 
 #include <boost/format.hpp>
 #include <gtest/gtest.h>
+#include <cmath>
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <regex>
+#include <set>
 #include <vector>
 #include <chrono>
 
 #include "common/Json.h"
 #include "common/Types.h"
 #include "pb/plan.pb.h"
+#include "query/CanMatch.h"
 #include "query/Expr.h"
+#include "query/ExprCost.h"
 #include "query/ExprImpl.h"
 #include "query/Plan.h"
+#include "query/PlanImpl.h"
 #include "query/PlanNode.h"
 #include "query/generated/ShowPlanNodeVisitor.h"
 #include "query/generated/ExecExprVisitor.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "simdjson/padded_string.h"
 #include "segcore/segment_c.h"
@@ -353,6 +360,282 @@ TEST(Expr, TestRange) {
     }
 }
 
+TEST(Expr, TestRangeUnalignedChunk) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(i64_fid);
+
+    // chunk rows not divisible by 64, chunks are written at unaligned offsets
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto seg = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    int N = 4321;
+    auto raw_data = DataGen(schema, N);
+    auto age_col = raw_data.get_col<int32_t>(i32_fid);
+    seg->PreInsert(N);
+    seg->Insert(0,
+                N,
+                raw_data.row_ids_.data(),
+                raw_data.timestamps_.data(),
+                raw_data.raw_);
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(
+        *seg_promote, seg_promote->get_row_count(), MAX_TIMESTAMP);
+    auto column = ColumnInfo(i32_fid, DataType::INT32);
+    auto check = [&](Expr& expr, std::function<bool(int32_t)> ref_func) {
+        auto final = visitor.call_child(expr);
+        ASSERT_EQ(final.size(), N);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(final[i], ref_func(age_col[i])) << i;
+        }
+    };
+    {
+        UnaryRangeExprImpl<int32_t> expr(
+            column,
+            OpType::GreaterEqual,
+            N,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+        check(expr, [&](int32_t v) { return v >= N; });
+    }
+    {
+        UnaryRangeExprImpl<int32_t> expr(
+            column,
+            OpType::NotEqual,
+            age_col[7],
+            proto::plan::GenericValue::ValCase::kInt64Val);
+        check(expr, [&](int32_t v) { return v != age_col[7]; });
+    }
+    {
+        BinaryRangeExprImpl<int32_t> expr(
+            column,
+            proto::plan::GenericValue::ValCase::kInt64Val,
+            false,
+            true,
+            N / 2,
+            N);
+        check(expr, [&](int32_t v) { return N / 2 < v && v <= N; });
+    }
+}
+
+TEST(Expr, TestRangeZoneMap) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(i64_fid);
+
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto seg = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    // ids are generated in order, so every chunk covers its own range
+    int N = 4321;
+    auto raw_data = DataGen(schema, N);
+    auto id_col = raw_data.get_col<int64_t>(i64_fid);
+    seg->PreInsert(N);
+    seg->Insert(0,
+                N,
+                raw_data.row_ids_.data(),
+                raw_data.timestamps_.data(),
+                raw_data.raw_);
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(raw_data, *sealed);
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    auto zone_map = seg_promote->chunk_zone_map<int64_t>(i64_fid, 1);
+    ASSERT_TRUE(zone_map.has_value());
+    ASSERT_EQ(zone_map->min(), 1000);
+    ASSERT_EQ(zone_map->max(), 1999);
+    ASSERT_TRUE(seg_promote->chunk_zone_map<std::string>(str_fid, 0));
+    auto sealed_zone_map = sealed->chunk_zone_map<int64_t>(i64_fid, 0);
+    ASSERT_TRUE(sealed_zone_map.has_value());
+    ASSERT_EQ(sealed_zone_map->min(), 0);
+    ASSERT_EQ(sealed_zone_map->max(), N - 1);
+    ASSERT_TRUE(sealed->chunk_zone_map<std::string_view>(str_fid, 0));
+
+    auto column = ColumnInfo(i64_fid, DataType::INT64);
+    auto check = [&](const SegmentInternalInterface& segment,
+                     Expr& expr,
+                     std::function<bool(int64_t)> ref_func) {
+        ExecExprVisitor visitor(segment, N, MAX_TIMESTAMP);
+        auto final = visitor.call_child(expr);
+        ASSERT_EQ(final.size(), N);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(final[i], ref_func(id_col[i])) << i;
+        }
+    };
+    for (auto segment : std::vector<const SegmentInternalInterface*>{
+             seg_promote, sealed.get()}) {
+        {
+            UnaryRangeExprImpl<int64_t> expr(
+                column,
+                OpType::GreaterEqual,
+                2500,
+                proto::plan::GenericValue::ValCase::kInt64Val);
+            check(*segment, expr, [&](int64_t v) { return v >= 2500; });
+        }
+        {
+            UnaryRangeExprImpl<int64_t> expr(
+                column,
+                OpType::LessThan,
+                0,
+                proto::plan::GenericValue::ValCase::kInt64Val);
+            check(*segment, expr, [&](int64_t v) { return v < 0; });
+        }
+        {
+            UnaryRangeExprImpl<int64_t> expr(
+                column,
+                OpType::NotEqual,
+                N,
+                proto::plan::GenericValue::ValCase::kInt64Val);
+            check(*segment, expr, [&](int64_t v) { return v != N; });
+        }
+        {
+            BinaryRangeExprImpl<int64_t> expr(
+                column,
+                proto::plan::GenericValue::ValCase::kInt64Val,
+                true,
+                false,
+                1000,
+                3000);
+            check(*segment, expr, [&](int64_t v) {
+                return 1000 <= v && v < 3000;
+            });
+        }
+    }
+}
+
+TEST(Expr, ZoneMapMatch) {
+    ZoneMapOf<float> zone_map;
+    ASSERT_TRUE(zone_map.empty());
+    std::vector<float> data{3, 1, 2};
+    zone_map.Update(data.data(), data.size());
+    ASSERT_EQ(zone_map.min(), 1);
+    ASSERT_EQ(zone_map.max(), 3);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::GreaterThan, 3.0f),
+              ZoneMatch::None);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::GreaterEqual, 1.0f),
+              ZoneMatch::All);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::LessThan, 2.0f),
+              ZoneMatch::Some);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::Equal, 4.0f), ZoneMatch::None);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::NotEqual, 4.0f),
+              ZoneMatch::All);
+    ASSERT_EQ(zone_map.MatchBinaryRange(1.0f, false, 3.0f, true),
+              ZoneMatch::Some);
+    ASSERT_EQ(zone_map.MatchBinaryRange(0.0f, true, 3.0f, true),
+              ZoneMatch::All);
+    ASSERT_EQ(zone_map.MatchBinaryRange(3.0f, false, 5.0f, true),
+              ZoneMatch::None);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::LessThan, std::nanf("")),
+              ZoneMatch::Some);
+
+    // a NaN never matches, so no chunk holding one matches all
+    float nan = std::nanf("");
+    zone_map.Update(&nan, 1);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::GreaterEqual, 1.0f),
+              ZoneMatch::Some);
+    ASSERT_EQ(zone_map.MatchUnaryRange(OpType::GreaterThan, 3.0f),
+              ZoneMatch::None);
+
+    ZoneMapOf<std::string_view> str_zone_map;
+    std::vector<std::string_view> strs{"b", "d", "c"};
+    str_zone_map.Update(strs.data(), strs.size());
+    ASSERT_EQ(str_zone_map.MatchUnaryRange(OpType::LessThan, std::string("b")),
+              ZoneMatch::None);
+    ASSERT_EQ(str_zone_map.MatchUnaryRange(OpType::LessEqual, std::string("d")),
+              ZoneMatch::All);
+}
+
+TEST(Expr, MatchSegment) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(i64_fid);
+
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto seg = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    // the ids are 0 to N - 1
+    int N = 4321;
+    auto raw_data = DataGen(schema, N);
+    seg->PreInsert(N);
+    seg->Insert(0,
+                N,
+                raw_data.row_ids_.data(),
+                raw_data.timestamps_.data(),
+                raw_data.raw_);
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(raw_data, *sealed);
+
+    auto column = ColumnInfo(i64_fid, DataType::INT64);
+    auto val_case = proto::plan::GenericValue::ValCase::kInt64Val;
+    auto unary = [&](OpType op, int64_t value) -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            column, op, value, val_case);
+    };
+    using LogicalOp = LogicalBinaryExpr::OpType;
+    auto logical = [](LogicalOp op, ExprPtr left, ExprPtr right) {
+        return LogicalBinaryExpr(op, left, right);
+    };
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    for (auto segment : std::vector<const SegmentInternalInterface*>{
+             seg_promote, sealed.get()}) {
+        ASSERT_EQ(MatchSegment(*unary(OpType::GreaterEqual, N), *segment),
+                  ZoneMatch::None);
+        ASSERT_EQ(MatchSegment(*unary(OpType::GreaterEqual, 0), *segment),
+                  ZoneMatch::All);
+        ASSERT_EQ(MatchSegment(*unary(OpType::LessThan, 2500), *segment),
+                  ZoneMatch::Some);
+        auto child = unary(OpType::GreaterEqual, N);
+        LogicalUnaryExpr not_expr(LogicalUnaryExpr::OpType::LogicalNot,
+                                  child);
+        ASSERT_EQ(MatchSegment(not_expr, *segment), ZoneMatch::All);
+        ASSERT_EQ(MatchSegment(logical(LogicalOp::LogicalAnd,
+                                       unary(OpType::GreaterEqual, N),
+                                       unary(OpType::LessThan, 10)),
+                               *segment),
+                  ZoneMatch::None);
+        ASSERT_EQ(MatchSegment(logical(LogicalOp::LogicalOr,
+                                       unary(OpType::GreaterEqual, N),
+                                       unary(OpType::LessThan, 10)),
+                               *segment),
+                  ZoneMatch::Some);
+        ASSERT_EQ(MatchSegment(logical(LogicalOp::LogicalXor,
+                                       unary(OpType::GreaterEqual, 0),
+                                       unary(OpType::GreaterEqual, N)),
+                               *segment),
+                  ZoneMatch::All);
+        TermExprImpl<int64_t> outside(column, {-3, N + 5}, val_case);
+        ASSERT_EQ(MatchSegment(outside, *segment), ZoneMatch::None);
+        TermExprImpl<int64_t> empty(column, {}, val_case);
+        ASSERT_EQ(MatchSegment(empty, *segment), ZoneMatch::None);
+        TermExprImpl<int64_t> inside(column, {5, N + 5}, val_case);
+        ASSERT_EQ(MatchSegment(inside, *segment), ZoneMatch::Some);
+
+        // a filter no row can match is answered without evaluating it
+        RetrievePlan plan(*schema);
+        plan.plan_node_ = std::make_unique<RetrievePlanNode>();
+        plan.plan_node_->is_count = true;
+        auto count = [&]() {
+            auto result = segment->Retrieve(&plan, MAX_TIMESTAMP);
+            return result->fields_data(0).scalars().long_data().data(0);
+        };
+        plan.plan_node_->predicate_ = unary(OpType::GreaterEqual, N);
+        ASSERT_FALSE(segment->CanMatch(&plan));
+        ASSERT_EQ(count(), 0);
+        plan.plan_node_->predicate_ = unary(OpType::LessThan, 10);
+        ASSERT_TRUE(segment->CanMatch(&plan));
+        ASSERT_EQ(count(), 10);
+    }
+}
+
 TEST(Expr, TestBinaryRangeJSON) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -693,6 +976,585 @@ TEST(Expr, TestTermJson) {
     }
 }
 
+TEST(Expr, TestJsonKeyIndex) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto json_fid = schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(i64_fid);
+
+    // rows of every kind of value the key index distinguishes
+    int N = 1400;
+    auto raw_data = DataGen(schema, N);
+    for (auto& field_data : *raw_data.raw_->mutable_fields_data()) {
+        if (field_data.field_id() != json_fid.get()) {
+            continue;
+        }
+        auto json_data = field_data.mutable_scalars()->mutable_json_data();
+        for (int i = 0; i < N; ++i) {
+            std::string row;
+            switch (i % 7) {
+                case 0:
+                    row = fmt::format(R"({{"a": {}}})", i % 100);
+                    break;
+                case 1:
+                    row = fmt::format(R"({{"a": {}.5}})", i % 100);
+                    break;
+                case 2:
+                    row = fmt::format(R"({{"a": "s{}"}})", i % 100);
+                    break;
+                case 3:
+                    row = fmt::format(R"({{"a": {}}})", i % 2 == 0);
+                    break;
+                case 4:
+                    row = R"({"a": null})";
+                    break;
+                case 5:
+                    row = R"({"a": [1, 2]})";
+                    break;
+                default:
+                    row = R"({"b": 1})";
+            }
+            json_data->set_data(i, row);
+        }
+    }
+
+    auto segment = SealedCreator(schema, raw_data);
+    auto indexed_segment = SealedCreator(schema, raw_data);
+    indexed_segment->LoadJsonKeyIndex(json_fid, {"/a"});
+    ASSERT_NE(indexed_segment->json_key_index(json_fid, "/a"), nullptr);
+    ASSERT_EQ(indexed_segment->json_key_index(json_fid, "/b"), nullptr);
+
+    ColumnInfo column(json_fid, DataType::JSON, {"a"});
+    std::vector<std::unique_ptr<Expr>> exprs;
+    for (auto op : {OpType::Equal,
+                    OpType::NotEqual,
+                    OpType::GreaterThan,
+                    OpType::GreaterEqual,
+                    OpType::LessThan,
+                    OpType::LessEqual}) {
+        exprs.push_back(std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            column, op, 50, proto::plan::GenericValue::ValCase::kInt64Val));
+        exprs.push_back(std::make_unique<UnaryRangeExprImpl<double>>(
+            column, op, 50.5, proto::plan::GenericValue::ValCase::kFloatVal));
+    }
+    exprs.push_back(std::make_unique<UnaryRangeExprImpl<std::string>>(
+        column,
+        OpType::Equal,
+        "s9",
+        proto::plan::GenericValue::ValCase::kStringVal));
+    exprs.push_back(std::make_unique<UnaryRangeExprImpl<std::string>>(
+        column,
+        OpType::PrefixMatch,
+        "s9",
+        proto::plan::GenericValue::ValCase::kStringVal));
+    exprs.push_back(std::make_unique<UnaryRangeExprImpl<bool>>(
+        column,
+        OpType::Equal,
+        true,
+        proto::plan::GenericValue::ValCase::kBoolVal));
+    exprs.push_back(std::make_unique<BinaryRangeExprImpl<int64_t>>(
+        column,
+        proto::plan::GenericValue::ValCase::kInt64Val,
+        true,
+        false,
+        10,
+        60));
+    exprs.push_back(std::make_unique<BinaryRangeExprImpl<double>>(
+        column,
+        proto::plan::GenericValue::ValCase::kFloatVal,
+        false,
+        true,
+        10.5,
+        60.5));
+    exprs.push_back(std::make_unique<TermExprImpl<int64_t>>(
+        column,
+        std::vector<int64_t>{7, 14, 21},
+        proto::plan::GenericValue::ValCase::kInt64Val));
+    exprs.push_back(std::make_unique<TermExprImpl<double>>(
+        column,
+        std::vector<double>{7, 8.5},
+        proto::plan::GenericValue::ValCase::kFloatVal));
+    exprs.push_back(std::make_unique<ExistsExprImpl>(column));
+
+    ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+    ExecExprVisitor indexed_visitor(*indexed_segment, N, MAX_TIMESTAMP);
+    for (auto& expr : exprs) {
+        auto expected = visitor.call_child(*expr);
+        auto final = indexed_visitor.call_child(*expr);
+        ASSERT_EQ(final.size(), N);
+        ASSERT_EQ(final, expected);
+    }
+
+    indexed_segment->DropFieldData(json_fid);
+    ASSERT_EQ(indexed_segment->json_key_index(json_fid, "/a"), nullptr);
+}
+
+TEST(Expr, TestJsonBinary) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    using LogicalOp = LogicalBinaryExpr::OpType;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto json_fid = schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(i64_fid);
+
+    // nested and escaped keys, arrays, and a row which isn't json
+    int N = 1000;
+    auto raw_data = DataGen(schema, N);
+    for (auto& field_data : *raw_data.raw_->mutable_fields_data()) {
+        if (field_data.field_id() != json_fid.get()) {
+            continue;
+        }
+        auto json_data = field_data.mutable_scalars()->mutable_json_data();
+        for (int i = 0; i < N; ++i) {
+            std::string row;
+            switch (i % 6) {
+                case 0:
+                    row = fmt::format(
+                        R"({{"z": 0, "a": {}, "b": {{"c": "s{}"}}}})",
+                        i % 100,
+                        i % 10);
+                    break;
+                case 1:
+                    row = fmt::format(R"({{"a": {}.5, "a/b": {}}})",
+                                      i % 100,
+                                      i % 2 == 0);
+                    break;
+                case 2:
+                    row = fmt::format(R"({{"arr": [{}, "x", [1]], "a": 1}})",
+                                      i % 50);
+                    break;
+                case 3:
+                    row = R"({"a": 18446744073709551615, "a~b": null})";
+                    break;
+                case 4:
+                    row = R"({"b": {"c": "s\"1"}, "a": "s1", "a": 2})";
+                    break;
+                default:
+                    row = fmt::format(R"({{"a": {})", i);
+            }
+            json_data->set_data(i, row);
+        }
+    }
+
+    auto& config = SegcoreConfig::default_config();
+    auto segment = SealedCreator(schema, raw_data);
+    config.set_enable_json_binary(true);
+    auto binary_segment = SealedCreator(schema, raw_data);
+    config.set_enable_json_binary(false);
+
+    auto column = [&](std::vector<std::string> path) {
+        return ColumnInfo(json_fid, DataType::JSON, path);
+    };
+    std::vector<ExprPtr> exprs;
+    for (auto op : {OpType::Equal, OpType::NotEqual, OpType::LessThan}) {
+        exprs.push_back(std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            column({"a"}),
+            op,
+            50,
+            proto::plan::GenericValue::ValCase::kInt64Val));
+        exprs.push_back(std::make_unique<UnaryRangeExprImpl<double>>(
+            column({"a"}),
+            op,
+            50.5,
+            proto::plan::GenericValue::ValCase::kFloatVal));
+        exprs.push_back(std::make_unique<UnaryRangeExprImpl<std::string>>(
+            column({"b", "c"}),
+            op,
+            "s1",
+            proto::plan::GenericValue::ValCase::kStringVal));
+        exprs.push_back(std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            column({"arr", "0"}),
+            op,
+            20,
+            proto::plan::GenericValue::ValCase::kInt64Val));
+    }
+    exprs.push_back(std::make_unique<UnaryRangeExprImpl<bool>>(
+        column({"a/b"}),
+        OpType::Equal,
+        true,
+        proto::plan::GenericValue::ValCase::kBoolVal));
+    exprs.push_back(std::make_unique<TermExprImpl<int64_t>>(
+        column({"a"}),
+        std::vector<int64_t>{1, 2, 7},
+        proto::plan::GenericValue::ValCase::kInt64Val));
+    for (auto path : std::vector<std::vector<std::string>>{
+             {"a~b"}, {"arr", "2", "0"}, {"arr", "3"}, {"b", "c", "d"}}) {
+        exprs.push_back(std::make_unique<ExistsExprImpl>(column(path)));
+    }
+    ExprPtr a_range = std::make_unique<BinaryRangeExprImpl<int64_t>>(
+        column({"a"}),
+        proto::plan::GenericValue::ValCase::kInt64Val,
+        true,
+        false,
+        10,
+        60);
+    ExprPtr z_equal = std::make_unique<UnaryRangeExprImpl<int64_t>>(
+        column({"z"}),
+        OpType::Equal,
+        0,
+        proto::plan::GenericValue::ValCase::kInt64Val);
+    exprs.push_back(std::make_unique<LogicalBinaryExpr>(
+        LogicalOp::LogicalAnd, a_range, z_equal));
+
+    ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+    ExecExprVisitor binary_visitor(*binary_segment, N, MAX_TIMESTAMP);
+    for (auto& expr : exprs) {
+        auto expected = visitor.call_child(*expr);
+        auto final = binary_visitor.call_child(*expr);
+        ASSERT_EQ(final.size(), N);
+        ASSERT_EQ(final, expected);
+    }
+
+    // the values read from the encoding are those simdjson reads
+    auto text = simdjson::padded_string(
+        std::string(R"({"k": [1, 2.5, "v\n", true, null, {"": -3}]})"));
+    std::vector<char> binary;
+    ASSERT_TRUE(milvus::BinaryJson::Encode(text, binary));
+    milvus::Json json(text.data(), text.size());
+    milvus::Json binary_json(text.data(),
+                             text.size(),
+                             std::string_view(binary.data(), binary.size()));
+    ASSERT_EQ(binary_json.at<int64_t>("/k/0").value(), 1);
+    ASSERT_EQ(binary_json.at<double>("/k/0").value(), 1.0);
+    ASSERT_EQ(binary_json.at<double>("/k/1").value(), 2.5);
+    ASSERT_TRUE(binary_json.at<int64_t>("/k/1").error());
+    ASSERT_EQ(binary_json.at<std::string_view>("/k/2").value(), "v\n");
+    ASSERT_EQ(binary_json.at<bool>("/k/3").value(), true);
+    ASSERT_TRUE(binary_json.exist("/k/4"));
+    ASSERT_EQ(binary_json.at<int64_t>("/k/5/").value(), -3);
+    for (auto pointer : {"/k/6", "/k/01", "/k/-", "/j", "/k/0/x"}) {
+        ASSERT_EQ(binary_json.exist(pointer), json.exist(pointer));
+    }
+    auto size = binary.size();
+    ASSERT_FALSE(milvus::BinaryJson::Encode(
+        simdjson::padded_string(std::string(R"({"k": )")), binary));
+    ASSERT_EQ(binary.size(), size);
+}
+
+TEST(Expr, TestJsonKeyPathsHint) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    milvus::proto::schema::CollectionSchema schema_proto;
+    auto pk_field = schema_proto.add_fields();
+    pk_field->set_fieldid(100);
+    pk_field->set_name("id");
+    pk_field->set_data_type(milvus::proto::schema::DataType::Int64);
+    pk_field->set_is_primary_key(true);
+    auto json_field = schema_proto.add_fields();
+    json_field->set_fieldid(101);
+    json_field->set_name("json");
+    json_field->set_data_type(milvus::proto::schema::DataType::JSON);
+    auto type_param = json_field->add_type_params();
+    type_param->set_key(JSON_KEY_PATHS);
+    type_param->set_value("/int,/string");
+
+    auto schema = Schema::ParseFrom(schema_proto);
+    auto json_fid = FieldId(101);
+    ASSERT_EQ((*schema)[json_fid].get_json_key_paths(),
+              std::vector<std::string>({"/int", "/string"}));
+
+    int N = 1000;
+    auto raw_data = DataGen(schema, N);
+    auto json_col = raw_data.get_col<std::string>(json_fid);
+    auto segment = SealedCreator(schema, raw_data);
+    ASSERT_NE(segment->json_key_index(json_fid, "/int"), nullptr);
+    ASSERT_NE(segment->json_key_index(json_fid, "/string"), nullptr);
+    ASSERT_EQ(segment->json_key_index(json_fid, "/double"), nullptr);
+
+    ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+    UnaryRangeExprImpl<int64_t> range_expr(
+        ColumnInfo(json_fid, DataType::JSON, {"int"}),
+        OpType::GreaterThan,
+        20,
+        proto::plan::GenericValue::ValCase::kInt64Val);
+    auto range_res = visitor.call_child(range_expr);
+    ExistsExprImpl exists_expr(
+        ColumnInfo(json_fid, DataType::JSON, {"string"}));
+    auto exists_res = visitor.call_child(exists_expr);
+    ASSERT_EQ(range_res.size(), N);
+    ASSERT_EQ(exists_res.size(), N);
+    for (int i = 0; i < N; ++i) {
+        auto json = milvus::Json(simdjson::padded_string(json_col[i]));
+        ASSERT_EQ(range_res[i], json.at<int64_t>("/int").value() > 20);
+        ASSERT_TRUE(exists_res[i]);
+    }
+}
+
+TEST(Expr, TestJsonPredicates) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    using LogicalOp = LogicalBinaryExpr::OpType;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto json_fid = schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(i64_fid);
+
+    int N = 10000;
+    auto raw_data = DataGen(schema, N);
+    auto json_col = raw_data.get_col<std::string>(json_fid);
+    auto seg = CreateGrowingSegment(schema, empty_index_meta);
+    seg->PreInsert(N);
+    seg->Insert(0,
+                N,
+                raw_data.row_ids_.data(),
+                raw_data.timestamps_.data(),
+                raw_data.raw_);
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, N, MAX_TIMESTAMP);
+
+    constexpr int64_t int_bound = 1LL << 31;
+    constexpr double double_bound = 1LL << 30;
+    auto first = milvus::Json(simdjson::padded_string(json_col[0]));
+    auto first_string =
+        std::string(first.at<std::string_view>("/string").value());
+    auto int_range = [&]() -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            ColumnInfo(json_fid, DataType::JSON, {"int"}),
+            OpType::LessThan,
+            int_bound,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+    };
+    auto double_range = [&]() -> ExprPtr {
+        return std::make_unique<BinaryRangeExprImpl<double>>(
+            ColumnInfo(json_fid, DataType::JSON, {"double"}),
+            proto::plan::GenericValue::ValCase::kFloatVal,
+            true,
+            false,
+            double_bound,
+            double(int_bound));
+    };
+    auto string_equal = [&]() -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<std::string>>(
+            ColumnInfo(json_fid, DataType::JSON, {"string"}),
+            OpType::Equal,
+            first_string,
+            proto::plan::GenericValue::ValCase::kStringVal);
+    };
+    // every row misses the key
+    auto missing_not_equal = [&]() -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            ColumnInfo(json_fid, DataType::JSON, {"missing"}),
+            OpType::NotEqual,
+            1,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+    };
+    auto logical = [](LogicalOp op, ExprPtr left, ExprPtr right) -> ExprPtr {
+        return std::make_unique<LogicalBinaryExpr>(op, left, right);
+    };
+
+    auto and_expr =
+        logical(LogicalOp::LogicalAnd,
+                logical(LogicalOp::LogicalAnd, int_range(), double_range()),
+                missing_not_equal());
+    auto or_expr =
+        logical(LogicalOp::LogicalOr, int_range(), string_equal());
+    auto and_res = visitor.call_child(*and_expr);
+    auto or_res = visitor.call_child(*or_expr);
+    ASSERT_EQ(and_res.size(), N);
+    ASSERT_EQ(or_res.size(), N);
+    for (int i = 0; i < N; ++i) {
+        auto json = milvus::Json(simdjson::padded_string(json_col[i]));
+        auto int_val = json.at<int64_t>("/int").value();
+        auto double_val = json.at<double>("/double").value();
+        auto string_val = json.at<std::string_view>("/string").value();
+        ASSERT_EQ(and_res[i],
+                  int_val < int_bound && double_bound <= double_val &&
+                      double_val < double(int_bound));
+        ASSERT_EQ(or_res[i], int_val < int_bound || string_val == first_string);
+    }
+    ASSERT_TRUE(or_res[0]);
+}
+
+TEST(Expr, TestLogicalPipeline) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    using LogicalOp = LogicalBinaryExpr::OpType;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("a", DataType::INT32);
+    auto json_fid = schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(i64_fid);
+
+    int N = 10000;
+    auto raw_data = DataGen(schema, N);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    raw_data.row_ids_.data(),
+                    raw_data.timestamps_.data(),
+                    raw_data.raw_);
+    auto sealed = SealedCreator(schema, raw_data);
+
+    auto logical = [](LogicalOp op, ExprPtr left, ExprPtr right) -> ExprPtr {
+        return std::make_unique<LogicalBinaryExpr>(op, left, right);
+    };
+    auto negate = [](ExprPtr child) -> ExprPtr {
+        return std::make_unique<LogicalUnaryExpr>(
+            LogicalUnaryExpr::OpType::LogicalNot, child);
+    };
+    auto id_range = [&](OpType op, int64_t val) -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            ColumnInfo(i64_fid, DataType::INT64),
+            op,
+            val,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+    };
+    auto a_range = [&](OpType op, int32_t val) -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<int32_t>>(
+            ColumnInfo(i32_fid, DataType::INT32),
+            op,
+            val,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+    };
+    auto json_range = [&](OpType op, int64_t val) -> ExprPtr {
+        return std::make_unique<UnaryRangeExprImpl<int64_t>>(
+            ColumnInfo(json_fid, DataType::JSON, {"int"}),
+            op,
+            val,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+    };
+    auto compare = [&](OpType op) -> ExprPtr {
+        auto expr = std::make_unique<CompareExpr>();
+        expr->op_type_ = op;
+        expr->left_field_id_ = i64_fid;
+        expr->left_data_type_ = DataType::INT64;
+        expr->right_field_id_ = i32_fid;
+        expr->right_data_type_ = DataType::INT32;
+        return expr;
+    };
+
+    std::vector<ExprPtr> exprs;
+    exprs.push_back(
+        logical(LogicalOp::LogicalAnd,
+                json_range(OpType::LessThan, 1L << 31),
+                negate(id_range(OpType::GreaterEqual, N / 2))));
+    exprs.push_back(logical(
+        LogicalOp::LogicalOr,
+        logical(LogicalOp::LogicalAnd,
+                a_range(OpType::LessThan, N),
+                id_range(OpType::GreaterEqual, N / 4)),
+        std::make_unique<ExistsExprImpl>(
+            ColumnInfo(json_fid, DataType::JSON, {"missing"}))));
+    exprs.push_back(logical(
+        LogicalOp::LogicalMinus,
+        a_range(OpType::GreaterThan, N / 2),
+        std::make_unique<TermExprImpl<int32_t>>(
+            ColumnInfo(i32_fid, DataType::INT32),
+            std::vector<int32_t>{1, 2, 3, 5, 8, 13, 21, 34, 55, 89},
+            proto::plan::GenericValue::ValCase::kInt64Val)));
+    exprs.push_back(logical(
+        LogicalOp::LogicalAnd,
+        compare(OpType::LessThan),
+        logical(LogicalOp::LogicalOr,
+                json_range(OpType::GreaterThan, 3L << 30),
+                negate(a_range(OpType::LessEqual, N / 3)))));
+    exprs.push_back(logical(LogicalOp::LogicalXor,
+                            id_range(OpType::LessThan, N / 3),
+                            json_range(OpType::LessThan, 1L << 30)));
+    // nothing survives the first child
+    exprs.push_back(logical(LogicalOp::LogicalAnd,
+                            id_range(OpType::LessThan, 0),
+                            json_range(OpType::LessThan, 1L << 31)));
+
+    auto& config = SegcoreConfig::default_config();
+    for (SegmentInternalInterface* segment :
+         std::vector<SegmentInternalInterface*>{growing.get(), sealed.get()}) {
+        ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+        for (auto& expr : exprs) {
+            config.set_enable_expr_pipeline(false);
+            auto expected = visitor.call_child(*expr);
+            config.set_enable_expr_pipeline(true);
+            auto final = visitor.call_child(*expr);
+            ASSERT_EQ(final.size(), N);
+            ASSERT_EQ(final, expected);
+        }
+    }
+}
+
+TEST(Expr, TestParallelMorsels) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("a", DataType::INT32);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(i64_fid);
+
+    int N = 10000;
+    auto raw_data = DataGen(schema, N);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    raw_data.row_ids_.data(),
+                    raw_data.timestamps_.data(),
+                    raw_data.raw_);
+    auto sealed = SealedCreator(schema, raw_data);
+
+    std::vector<ExprPtr> exprs;
+    exprs.push_back(std::make_unique<UnaryRangeExprImpl<int32_t>>(
+        ColumnInfo(i32_fid, DataType::INT32),
+        OpType::LessThan,
+        N / 3,
+        proto::plan::GenericValue::ValCase::kInt64Val));
+    exprs.push_back(std::make_unique<BinaryRangeExprImpl<int64_t>>(
+        ColumnInfo(i64_fid, DataType::INT64),
+        proto::plan::GenericValue::ValCase::kInt64Val,
+        true,
+        false,
+        N / 4,
+        N / 2));
+    std::vector<int32_t> terms(500);
+    std::iota(terms.begin(), terms.end(), 0);
+    exprs.push_back(std::make_unique<TermExprImpl<int32_t>>(
+        ColumnInfo(i32_fid, DataType::INT32),
+        terms,
+        proto::plan::GenericValue::ValCase::kInt64Val));
+    exprs.push_back(std::make_unique<BinaryArithOpEvalRangeExprImpl<int64_t>>(
+        ColumnInfo(i64_fid, DataType::INT64),
+        proto::plan::GenericValue::ValCase::kInt64Val,
+        ArithOpType::Mod,
+        7,
+        OpType::Equal,
+        3));
+    exprs.push_back(std::make_unique<UnaryRangeExprImpl<std::string>>(
+        ColumnInfo(str_fid, DataType::VARCHAR),
+        OpType::PrefixMatch,
+        "1",
+        proto::plan::GenericValue::ValCase::kStringVal));
+
+    auto& config = SegcoreConfig::default_config();
+    auto parallelism = config.get_expr_parallelism();
+    auto morsel_rows = config.get_expr_morsel_rows();
+    for (SegmentInternalInterface* segment :
+         std::vector<SegmentInternalInterface*>{growing.get(), sealed.get()}) {
+        ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+        for (auto& expr : exprs) {
+            config.set_expr_parallelism(1);
+            auto expected = visitor.call_child(*expr);
+            // morsels of 64 rows, the 100 is rounded down to whole words
+            config.set_expr_parallelism(4);
+            config.set_expr_morsel_rows(100);
+            auto final = visitor.call_child(*expr);
+            config.set_expr_morsel_rows(morsel_rows);
+            ASSERT_EQ(final.size(), N);
+            ASSERT_EQ(final, expected);
+            ASSERT_TRUE(final.any());
+        }
+    }
+    config.set_expr_parallelism(parallelism);
+}
+
 TEST(Expr, TestTerm) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -782,6 +1644,93 @@ TEST(Expr, TestTerm) {
     }
 }
 
+TEST(Expr, TestTermProbe) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto pk_fid = schema->AddDebugField("pk", DataType::VARCHAR);
+    auto i32_fid = schema->AddDebugField("a", DataType::INT32);
+    auto double_fid = schema->AddDebugField("d", DataType::DOUBLE);
+    schema->set_primary_field_id(pk_fid);
+
+    int N = 10000;
+    auto raw_data = DataGen(schema, N);
+    auto pk_col = raw_data.get_col<std::string>(pk_fid);
+    auto i32_col = raw_data.get_col<int32_t>(i32_fid);
+    auto double_col = raw_data.get_col<double>(double_fid);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    raw_data.row_ids_.data(),
+                    raw_data.timestamps_.data(),
+                    raw_data.raw_);
+    auto sealed = SealedCreator(schema, raw_data);
+
+    // terms half taken from the column, so lists of every size have hits,
+    // and half missing from it
+    auto make_terms = [&](const auto& col, size_t size, auto missing) {
+        std::vector<std::decay_t<decltype(col[0])>> terms;
+        for (size_t i = 0; i < size; ++i) {
+            terms.push_back(i % 2 == 0 ? col[(i * 7919) % N] : missing(i));
+        }
+        return terms;
+    };
+    auto check = [&](const SegmentInternalInterface& segment,
+                     const Expr& expr,
+                     const auto& col,
+                     const auto& terms) {
+        std::set<std::decay_t<decltype(col[0])>> term_set;
+        for (auto& term : terms) {
+            // NaN can't be ordered in a set, it matches nothing anyway
+            if (term == term) {
+                term_set.insert(term);
+            }
+        }
+        ExecExprVisitor visitor(segment, N, MAX_TIMESTAMP);
+        auto res = visitor.call_child(const_cast<Expr&>(expr));
+        ASSERT_EQ(res.size(), N);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(res[i], term_set.count(col[i]) > 0)
+                << "row " << i << ", " << terms.size() << " terms";
+        }
+    };
+
+    std::vector<const SegmentInternalInterface*> segments{growing.get(),
+                                                          sealed.get()};
+    for (size_t size : {0, 1, 3, 8, 9, 100, 256, 257, 5000}) {
+        auto i32_terms = make_terms(
+            i32_col, size, [&](size_t i) { return int32_t(2 * N + i); });
+        // NaN matches nothing, -0.0 matches 0.0
+        auto double_terms = make_terms(double_col, size, [](size_t i) {
+            return i % 3 == 0   ? std::nan("")
+                   : i % 3 == 1 ? -0.0
+                                : 1e9 + i;
+        });
+        auto pk_terms = make_terms(pk_col, size, [](size_t i) {
+            return "missing_" + std::to_string(i);
+        });
+        TermExprImpl<int32_t> i32_expr(
+            ColumnInfo(i32_fid, DataType::INT32),
+            i32_terms,
+            proto::plan::GenericValue::ValCase::kInt64Val);
+        TermExprImpl<double> double_expr(
+            ColumnInfo(double_fid, DataType::DOUBLE),
+            double_terms,
+            proto::plan::GenericValue::ValCase::kFloatVal);
+        TermExprImpl<std::string> pk_expr(
+            ColumnInfo(pk_fid, DataType::VARCHAR),
+            pk_terms,
+            proto::plan::GenericValue::ValCase::kStringVal);
+        for (auto segment : segments) {
+            check(*segment, i32_expr, i32_col, i32_terms);
+            check(*segment, double_expr, double_col, double_terms);
+            check(*segment, pk_expr, pk_col, pk_terms);
+        }
+    }
+}
+
 TEST(Expr, TestSimpleDsl) {
     using namespace milvus::segcore;
 
@@ -1080,6 +2029,102 @@ TEST(Expr, TestCompareWithScalarIndex) {
     }
 }
 
+TEST(Expr, TestCompareMixedTypes) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i8_fid = schema->AddDebugField("i8", DataType::INT8);
+    auto i16_fid = schema->AddDebugField("i16", DataType::INT16);
+    auto i32_fid = schema->AddDebugField("i32", DataType::INT32);
+    auto i64_fid = schema->AddDebugField("i64", DataType::INT64);
+    auto float_fid = schema->AddDebugField("f", DataType::FLOAT);
+    auto double_fid = schema->AddDebugField("d", DataType::DOUBLE);
+    schema->set_primary_field_id(i64_fid);
+
+    int N = 4321;
+    auto raw_data = DataGen(schema, N);
+    auto i8_col = raw_data.get_col<int8_t>(i8_fid);
+    auto i16_col = raw_data.get_col<int16_t>(i16_fid);
+    auto i32_col = raw_data.get_col<int32_t>(i32_fid);
+    auto i64_col = raw_data.get_col<int64_t>(i64_fid);
+    auto float_col = raw_data.get_col<float>(float_fid);
+    auto double_col = raw_data.get_col<double>(double_fid);
+
+    // chunk rows not divisible by 64, chunks are written at unaligned offsets
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    raw_data.row_ids_.data(),
+                    raw_data.timestamps_.data(),
+                    raw_data.raw_);
+    auto sealed = SealedCreator(schema, raw_data);
+    // the int32 field only has its scalar index loaded
+    auto indexed = CreateSealedSegment(schema);
+    SealedLoadFieldData(raw_data, *indexed, {i32_fid.get()});
+    segcore::LoadIndexInfo load_index_info;
+    auto i32_index = milvus::index::CreateScalarIndexSort<int32_t>();
+    i32_index->Build(N, i32_col.data());
+    load_index_info.field_id = i32_fid.get();
+    load_index_info.field_type = DataType::INT32;
+    load_index_info.index = std::move(i32_index);
+    indexed->LoadIndex(load_index_info);
+
+    std::vector<const SegmentInternalInterface*> segments{
+        growing.get(), sealed.get(), indexed.get()};
+    auto check = [&](FieldId left_fid,
+                     DataType left_type,
+                     const auto& left_col,
+                     FieldId right_fid,
+                     DataType right_type,
+                     const auto& right_col) {
+        std::vector<std::pair<OpType, std::function<bool(int)>>> testcases{
+            {OpType::Equal,
+             [&](int i) { return left_col[i] == right_col[i]; }},
+            {OpType::NotEqual,
+             [&](int i) { return left_col[i] != right_col[i]; }},
+            {OpType::GreaterThan,
+             [&](int i) { return left_col[i] > right_col[i]; }},
+            {OpType::GreaterEqual,
+             [&](int i) { return left_col[i] >= right_col[i]; }},
+            {OpType::LessThan,
+             [&](int i) { return left_col[i] < right_col[i]; }},
+            {OpType::LessEqual,
+             [&](int i) { return left_col[i] <= right_col[i]; }},
+        };
+        for (auto& [op, ref_func] : testcases) {
+            CompareExpr expr;
+            expr.op_type_ = op;
+            expr.left_field_id_ = left_fid;
+            expr.left_data_type_ = left_type;
+            expr.right_field_id_ = right_fid;
+            expr.right_data_type_ = right_type;
+            for (auto segment : segments) {
+                ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+                auto final = visitor.call_child(expr);
+                ASSERT_EQ(final.size(), N);
+                for (int i = 0; i < N; ++i) {
+                    ASSERT_EQ(final[i], ref_func(i))
+                        << int(left_type) << " " << int(op) << " "
+                        << int(right_type) << "@" << i;
+                }
+            }
+        }
+    };
+    using DT = DataType;
+    check(i8_fid, DT::INT8, i8_col, i16_fid, DT::INT16, i16_col);
+    check(i16_fid, DT::INT16, i16_col, i64_fid, DT::INT64, i64_col);
+    check(i32_fid, DT::INT32, i32_col, i32_fid, DT::INT32, i32_col);
+    check(i32_fid, DT::INT32, i32_col, float_fid, DT::FLOAT, float_col);
+    check(i64_fid, DT::INT64, i64_col, i32_fid, DT::INT32, i32_col);
+    check(i64_fid, DT::INT64, i64_col, float_fid, DT::FLOAT, float_col);
+    check(float_fid, DT::FLOAT, float_col, double_fid, DT::DOUBLE, double_col);
+    check(double_fid, DT::DOUBLE, double_col, i8_fid, DT::INT8, i8_col);
+}
+
 TEST(Expr, TestCompareExpr) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -2372,6 +3417,139 @@ TEST(Expr, TestBinaryArithOpEvalRangeWithScalarSortIndex) {
     }
 }
 
+TEST(Expr, TestBinaryArithOpEvalRangeKernels) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i8_fid = schema->AddDebugField("i8", DataType::INT8);
+    auto i32_fid = schema->AddDebugField("i32", DataType::INT32);
+    auto i64_fid = schema->AddDebugField("i64", DataType::INT64);
+    auto float_fid = schema->AddDebugField("f", DataType::FLOAT);
+    auto double_fid = schema->AddDebugField("d", DataType::DOUBLE);
+    schema->set_primary_field_id(i64_fid);
+
+    int N = 4321;
+    auto raw_data = DataGen(schema, N);
+    auto i8_col = raw_data.get_col<int8_t>(i8_fid);
+    auto i32_col = raw_data.get_col<int32_t>(i32_fid);
+    auto i64_col = raw_data.get_col<int64_t>(i64_fid);
+    auto float_col = raw_data.get_col<float>(float_fid);
+    auto double_col = raw_data.get_col<double>(double_fid);
+
+    // chunk rows not divisible by 64, chunks are written at unaligned offsets
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    raw_data.row_ids_.data(),
+                    raw_data.timestamps_.data(),
+                    raw_data.raw_);
+    auto sealed = SealedCreator(schema, raw_data);
+    // the int32 and float fields only have their scalar index loaded
+    auto indexed = CreateSealedSegment(schema);
+    SealedLoadFieldData(raw_data, *indexed, {i32_fid.get(), float_fid.get()});
+    segcore::LoadIndexInfo i32_index_info;
+    auto i32_index = milvus::index::CreateScalarIndexSort<int32_t>();
+    i32_index->Build(N, i32_col.data());
+    i32_index_info.field_id = i32_fid.get();
+    i32_index_info.field_type = DataType::INT32;
+    i32_index_info.index = std::move(i32_index);
+    indexed->LoadIndex(i32_index_info);
+    segcore::LoadIndexInfo float_index_info;
+    auto float_index = milvus::index::CreateScalarIndexSort<float>();
+    float_index->Build(N, float_col.data());
+    float_index_info.field_id = float_fid.get();
+    float_index_info.field_type = DataType::FLOAT;
+    float_index_info.index = std::move(float_index);
+    indexed->LoadIndex(float_index_info);
+
+    std::vector<const SegmentInternalInterface*> segments{
+        growing.get(), sealed.get(), indexed.get()};
+    auto check = [&](FieldId fid, DataType type, const auto& col) {
+        using T = typename std::decay_t<decltype(col)>::value_type;
+        auto val_case = std::is_integral_v<T>
+                            ? proto::plan::GenericValue::kInt64Val
+                            : proto::plan::GenericValue::kFloatVal;
+        // the arithmetic the row by row path evaluates
+        auto ref_func = [](ArithOpType arith_op, T x, T operand, T value) {
+            switch (arith_op) {
+                case ArithOpType::Add:
+                    return (x + operand) == value;
+                case ArithOpType::Sub:
+                    return (x - operand) == value;
+                case ArithOpType::Mul:
+                    return (x * operand) == value;
+                case ArithOpType::Div:
+                    return (x / operand) == value;
+                default:
+                    return static_cast<T>(fmod(x, operand)) == value;
+            }
+        };
+        std::vector<std::tuple<ArithOpType, T, T>> testcases{
+            {ArithOpType::Add, 3, 10},
+            {ArithOpType::Add, 100, 127},
+            {ArithOpType::Sub, 5, -2},
+            {ArithOpType::Mul, 3, 9},
+            {ArithOpType::Mul, 3, 10},
+            {ArithOpType::Mul, -2, 8},
+            {ArithOpType::Mul, 0, 0},
+            {ArithOpType::Mul, 0, 1},
+            {ArithOpType::Div, 4, 2},
+            {ArithOpType::Div, -3, 1},
+            {ArithOpType::Div, 7, 0},
+            {ArithOpType::Mod, 7, 3},
+            {ArithOpType::Mod, -5, 2},
+            {ArithOpType::Mod, 1, 0},
+        };
+        // values which some rows hit
+        for (auto arith_op : {ArithOpType::Add,
+                              ArithOpType::Sub,
+                              ArithOpType::Mul,
+                              ArithOpType::Div,
+                              ArithOpType::Mod}) {
+            T operand = 3;
+            T x = col[N / 2];
+            T value = arith_op == ArithOpType::Add   ? T(x + operand)
+                      : arith_op == ArithOpType::Sub ? T(x - operand)
+                      : arith_op == ArithOpType::Mul ? T(x * operand)
+                      : arith_op == ArithOpType::Div
+                          ? T(x / operand)
+                          : static_cast<T>(fmod(x, operand));
+            testcases.emplace_back(arith_op, operand, value);
+        }
+        for (auto& [arith_op, operand, value] : testcases) {
+            for (auto op : {OpType::Equal, OpType::NotEqual}) {
+                BinaryArithOpEvalRangeExprImpl<T> expr(ColumnInfo(fid, type),
+                                                       val_case,
+                                                       arith_op,
+                                                       operand,
+                                                       op,
+                                                       value);
+                for (auto segment : segments) {
+                    ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+                    auto final = visitor.call_child(expr);
+                    ASSERT_EQ(final.size(), N);
+                    for (int i = 0; i < N; ++i) {
+                        auto ref = ref_func(arith_op, col[i], operand, value);
+                        ASSERT_EQ(final[i], op == OpType::Equal ? ref : !ref)
+                            << int(type) << " " << int(arith_op) << " "
+                            << double(operand) << " " << double(value) << "@"
+                            << i;
+                    }
+                }
+            }
+        }
+    };
+    check(i8_fid, DataType::INT8, i8_col);
+    check(i32_fid, DataType::INT32, i32_col);
+    check(i64_fid, DataType::INT64, i64_col);
+    check(float_fid, DataType::FLOAT, float_col);
+    check(double_fid, DataType::DOUBLE, double_col);
+}
+
 TEST(Expr, TestUnaryRangeWithJSON) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -2899,3 +4077,49 @@ TEST(Expr, TestExistsWithJSON) {
         }
     }
 }
+
+TEST(Expr, SketchSelectivity) {
+    using namespace milvus::query;
+    auto N = 10000;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto int32_id = schema->AddDebugField("int32", DataType::INT32);
+    schema->set_primary_field_id(counter_id);
+    auto raw_data = DataGen(schema, N);
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(raw_data, *sealed);
+
+    auto selectivity = [&](const Expr& expr) {
+        return EstimateExprCost(expr, *sealed, N).selectivity;
+    };
+    auto int32_column = ColumnInfo(int32_id, DataType::INT32);
+    auto int32_value = proto::plan::GenericValue::kInt64Val;
+    // the int32s are N draws of [0, 2N), taking fewer distinct values
+    // than the width of their range
+    auto int32s = raw_data.get_col<int32_t>(int32_id);
+    auto distinct = std::set<int32_t>(int32s.begin(), int32s.end()).size();
+    auto equal = UnaryRangeExprImpl<int32_t>(
+        int32_column, OpType::Equal, int32s[0], int32_value);
+    ASSERT_NEAR(selectivity(equal), 1.0 / distinct, 0.05 / distinct);
+    auto out_of_range = UnaryRangeExprImpl<int32_t>(
+        int32_column, OpType::Equal, 2 * N, int32_value);
+    ASSERT_EQ(selectivity(out_of_range), 0);
+    auto terms = TermExprImpl<int32_t>(
+        int32_column, {int32s[0], int32s[1]}, int32_value);
+    ASSERT_NEAR(selectivity(terms), 2.0 / distinct, 0.1 / distinct);
+
+    // the counters are 0..N-1
+    auto counter_column = ColumnInfo(counter_id, DataType::INT64);
+    auto counter_value = proto::plan::GenericValue::kInt64Val;
+    auto less = UnaryRangeExprImpl<int64_t>(
+        counter_column, OpType::LessThan, N / 4, counter_value);
+    ASSERT_NEAR(selectivity(less), 0.25, 0.02);
+    auto greater = UnaryRangeExprImpl<int64_t>(
+        counter_column, OpType::GreaterEqual, N / 4, counter_value);
+    ASSERT_NEAR(selectivity(greater), 0.75, 0.02);
+    auto between = BinaryRangeExprImpl<int64_t>(
+        counter_column, counter_value, true, false, N / 4, N / 2);
+    ASSERT_NEAR(selectivity(between), 0.25, 0.02);
+}
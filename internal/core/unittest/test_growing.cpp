@@ -10,11 +10,26 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <boost/format.hpp>
+#include <chrono>
+#include <filesystem>
+#include <numeric>
+#include <thread>
 
+#include "index/BitmapIndex.h"
+#include "query/Expr.h"
+#include "query/Plan.h"
+#include "query/generated/ExecExprVisitor.h"
+#include "segcore/Flush.h"
+#include "segcore/GrowingSnapshot.h"
+#include "segcore/Reduce.h"
 #include "segcore/SegmentGrowing.h"
 #include "segcore/SegmentGrowingImpl.h"
+#include "segcore/Utils.h"
 #include "pb/schema.pb.h"
+#include "storage/DataCodec.h"
 #include "test_utils/DataGen.h"
+#include "test_utils/MemChunkManager.h"
 
 using namespace milvus::segcore;
 using namespace milvus;
@@ -40,6 +55,560 @@ TEST(Growing, DeleteCount) {
     ASSERT_EQ(cnt, c);
 }
 
+TEST(Growing, MaskWithTimestamps) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+
+    int64_t c = 4321;
+    auto offset = segment->PreInsert(c);
+    auto dataset = DataGen(schema, c);
+    auto& tss = dataset.timestamps_;
+    std::iota(tss.begin(), tss.end(), 0);
+    // a few rows out of order, their chunks have to be compared row by row
+    tss[1500] = 5000;
+    tss[1600] = 3;
+    segment->Insert(offset,
+                    c,
+                    dataset.row_ids_.data(),
+                    tss.data(),
+                    dataset.raw_);
+
+    Timestamp query_ts = 2500;
+    BitsetType bitset(c);
+    segment->mask_with_timestamps(bitset, query_ts);
+    for (int64_t i = 0; i < c; ++i) {
+        ASSERT_EQ(bitset[i], tss[i] > query_ts) << "row " << i;
+    }
+}
+
+TEST(Growing, TtlExpiration) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    auto ttl = std::make_shared<CollectionTtl>();
+    ttl->set_ttl_ms(500);
+    segment->set_ttl(ttl);
+
+    // the rows are inserted a millisecond apart from 1000 on
+    auto ts_of = [](int64_t physical) {
+        return Timestamp(physical) << CollectionTtl::kLogicalBits;
+    };
+    int64_t c = 4321;
+    auto offset = segment->PreInsert(c);
+    auto dataset = DataGen(schema, c);
+    auto& tss = dataset.timestamps_;
+    for (int64_t i = 0; i < c; ++i) {
+        tss[i] = ts_of(1000 + i);
+    }
+    // an old row in a chunk otherwise not expired
+    tss[2700] = ts_of(10);
+    segment->Insert(offset,
+                    c,
+                    dataset.row_ids_.data(),
+                    tss.data(),
+                    dataset.raw_);
+
+    // the rows older than 2500 are expired at 3000, the ones after 3000
+    // aren't visible yet
+    auto query_ts = ts_of(3000);
+    auto expire_ts = ttl->expire_timestamp(query_ts);
+    ASSERT_EQ(expire_ts, ts_of(2500));
+    BitsetType bitset(c);
+    segment->mask_with_timestamps(bitset, query_ts);
+    for (int64_t i = 0; i < c; ++i) {
+        ASSERT_EQ(bitset[i], tss[i] > query_ts || tss[i] < expire_ts)
+            << "row " << i;
+    }
+    ASSERT_FALSE(segment->is_expired(query_ts));
+    ASSERT_TRUE(segment->is_expired(ts_of(1000 + c + 500)));
+
+    // no row is expired without a ttl
+    ttl->set_ttl_ms(0);
+    ASSERT_EQ(ttl->expire_timestamp(query_ts), 0);
+    ASSERT_FALSE(segment->is_expired(ts_of(1000 + c + 500)));
+    BitsetType visible(c);
+    segment->mask_with_timestamps(visible, query_ts);
+    for (int64_t i = 0; i < c; ++i) {
+        ASSERT_EQ(visible[i], tss[i] > query_ts) << "row " << i;
+    }
+}
+
+TEST(Growing, FreezeChunks) {
+    using namespace milvus::query;
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("age", DataType::INT32);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    conf.set_growing_chunk_freeze_ms(0);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+
+    int64_t N = 4321;
+    auto dataset = DataGen(schema, N);
+    auto& tss = dataset.timestamps_;
+    std::iota(tss.begin(), tss.end(), 0);
+    segment->PreInsert(N);
+    segment->Insert(0, N, dataset.row_ids_.data(), tss.data(), dataset.raw_);
+
+    // the full chunks are frozen in the background
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (segment->num_chunk_index(i32_fid) < N / 1000 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(segment->num_chunk_index(i32_fid), N / 1000);
+    ASSERT_EQ(segment->num_chunk_index(str_fid), N / 1000);
+    ASSERT_GT(segment->GetMemoryUsage().fields.at(i32_fid.get()).index, 0);
+
+    auto ages = dataset.get_col<int32_t>(i32_fid);
+    auto strs = dataset.get_col<std::string>(str_fid);
+    // an older query sees only part of the frozen chunks
+    for (int64_t row_count : {N, int64_t(2500)}) {
+        ExecExprVisitor visitor(*segment, row_count, MAX_TIMESTAMP);
+        UnaryRangeExprImpl<int32_t> age_expr(
+            ColumnInfo(i32_fid, DataType::INT32),
+            OpType::GreaterEqual,
+            ages[7],
+            proto::plan::GenericValue::ValCase::kInt64Val);
+        auto result = visitor.call_child(age_expr);
+        ASSERT_EQ(result.size(), row_count);
+        for (int64_t i = 0; i < row_count; ++i) {
+            ASSERT_EQ(result[i], ages[i] >= ages[7]) << i;
+        }
+
+        UnaryRangeExprImpl<std::string> str_expr(
+            ColumnInfo(str_fid, DataType::VARCHAR),
+            OpType::Equal,
+            strs[1234],
+            proto::plan::GenericValue::ValCase::kStringVal);
+        result = visitor.call_child(str_expr);
+        ASSERT_EQ(result.size(), row_count);
+        for (int64_t i = 0; i < row_count; ++i) {
+            ASSERT_EQ(result[i], strs[i] == strs[1234]) << i;
+        }
+    }
+}
+
+TEST(Growing, HotChunkIndex) {
+    using namespace milvus::query;
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("age", DataType::INT32);
+    auto bool_fid = schema->AddDebugField("flag", DataType::BOOL);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    conf.set_growing_chunk_freeze_ms(0);
+    conf.set_growing_chunk_index_min_filters(1);
+    auto segment_growing =
+        CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    auto segment = dynamic_cast<SegmentGrowingImpl*>(segment_growing.get());
+    auto& indexing_record = segment->get_indexing_record();
+
+    auto insert = [&](int64_t n, int64_t seed) {
+        auto dataset = DataGen(schema, n, seed);
+        auto offset = segment->PreInsert(n);
+        segment->Insert(offset,
+                        n,
+                        dataset.row_ids_.data(),
+                        dataset.timestamps_.data(),
+                        dataset.raw_);
+        return dataset.get_col<bool>(bool_fid);
+    };
+    auto wait_frozen = [&](int64_t full_chunks) {
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (indexing_record.FreezePending(full_chunks) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    // no filter has read a field yet, the frozen chunks get no index
+    auto flags = insert(2500, 42);
+    wait_frozen(2);
+    ASSERT_EQ(indexing_record.num_frozen_chunks(i32_fid), 0);
+    ASSERT_EQ(indexing_record.num_frozen_chunks(bool_fid), 0);
+
+    UnaryRangeExprImpl<bool> flag_expr(
+        ColumnInfo(bool_fid, DataType::BOOL),
+        OpType::Equal,
+        true,
+        proto::plan::GenericValue::ValCase::kBoolVal);
+    {
+        ExecExprVisitor visitor(*segment, 2500, MAX_TIMESTAMP);
+        visitor.call_child(flag_expr);
+    }
+
+    // the next insert indexes the chunks of the field read by the filter,
+    // a bitmap of its two values
+    auto more_flags = insert(1500, 43);
+    flags.insert(flags.end(), more_flags.begin(), more_flags.end());
+    wait_frozen(4);
+    ASSERT_EQ(indexing_record.num_frozen_chunks(bool_fid), 4);
+    ASSERT_EQ(indexing_record.num_frozen_chunks(i32_fid), 0);
+    auto& chunk_index = segment->chunk_scalar_index<bool>(bool_fid, 0);
+    ASSERT_NE(dynamic_cast<const index::BitmapIndex<bool>*>(&chunk_index),
+              nullptr);
+
+    ExecExprVisitor visitor(*segment, 4000, MAX_TIMESTAMP);
+    auto result = visitor.call_child(flag_expr);
+    ASSERT_EQ(result.size(), 4000);
+    for (int64_t i = 0; i < 4000; ++i) {
+        ASSERT_EQ(result[i], flags[i]) << i;
+    }
+}
+
+TEST(Growing, MmapVectorChunks) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto dir = std::filesystem::path("/tmp/milvus/growing_mmap_test");
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    conf.set_growing_mmap_dir_path(dir.string());
+    {
+        auto segment = CreateGrowingSegment(schema, empty_index_meta, 7, conf);
+        ASSERT_TRUE(std::filesystem::exists(dir / "7"));
+
+        int64_t N = 500;
+        auto dataset = DataGen(schema, N);
+        segment->PreInsert(N);
+        segment->Insert(0,
+                        N,
+                        dataset.row_ids_.data(),
+                        dataset.timestamps_.data(),
+                        dataset.raw_);
+        auto raw = dataset.get_col<float>(vec_fid);
+        auto span = segment->chunk_data<FloatVector>(vec_fid, 0);
+        for (int64_t i = 0; i < N * 16; ++i) {
+            ASSERT_EQ(span.data()[i], raw[i]);
+        }
+
+        // the vector chunks are counted as mapped from files, the pks stay
+        // resident
+        auto usage = segment->GetMemoryUsage();
+        ASSERT_GT(usage.fields.at(vec_fid.get()).mmap_file, 0);
+        ASSERT_GT(usage.fields.at(pk.get()).raw, 0);
+        ASSERT_EQ(usage.fields.at(pk.get()).mmap_file, 0);
+        ASSERT_EQ(usage.mmap_file_bytes(),
+                  usage.fields.at(vec_fid.get()).mmap_file);
+    }
+    ASSERT_FALSE(std::filesystem::exists(dir / "7"));
+}
+
+TEST(Growing, Fp16VectorSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(300);
+    conf.set_enable_growing_fp16_vector(true);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    auto raw = dataset.get_col<float>(vec_fid);
+
+    auto topk = 5;
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: %2%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: %1%)") %
+               vec_fid.get() % topk;
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan = query::CreateSearchPlanByExpr(
+        *schema, binary_plan.data(), binary_plan.size());
+
+    // the rows of the segment near each chunk boundary are the queries
+    std::vector<int64_t> targets{0, 299, 300, 601, 999};
+    std::vector<float> queries;
+    for (auto target : targets) {
+        queries.insert(queries.end(),
+                       raw.begin() + target * 16,
+                       raw.begin() + (target + 1) * 16);
+    }
+    auto ph_group_raw = CreatePlaceholderGroup(targets.size(), 16, queries);
+    auto ph_group = query::ParsePlaceholderGroup(
+        plan.get(), ph_group_raw.SerializeAsString());
+    auto sr = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    for (int64_t i = 0; i < int64_t(targets.size()); i++) {
+        ASSERT_EQ(sr->seg_offsets_[i * topk], targets[i]);
+        ASSERT_LT(sr->distances_[i * topk], 1e-3);
+    }
+
+    // output vectors are decoded from the half floats
+    segment->FillTargetEntry(plan.get(), *sr);
+    auto& vectors =
+        sr->output_fields_data_.at(vec_fid)->vectors().float_vector().data();
+    ASSERT_EQ(vectors.size(), sr->seg_offsets_.size() * 16);
+    for (int64_t i = 0; i < int64_t(sr->seg_offsets_.size()); i++) {
+        auto offset = sr->seg_offsets_[i];
+        for (int j = 0; j < 16; j++) {
+            auto expected = raw[offset * 16 + j];
+            ASSERT_NEAR(vectors[i * 16 + j],
+                        expected,
+                        std::abs(expected) / 1024 + 1e-4);
+        }
+    }
+}
+
+TEST(Growing, ParallelBruteForce) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+
+    // enough distances for 4 threads over the 40 chunks
+    int64_t N = 40000;
+    int64_t nq = 100;
+    auto dataset = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+
+    auto topk = 10;
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: %2%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               vec_fid.get() % topk;
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan = query::CreateSearchPlanByExpr(
+        *schema, binary_plan.data(), binary_plan.size());
+    auto ph_group_raw = CreatePlaceholderGroup(nq, 16, 1024);
+    auto ph_group = query::ParsePlaceholderGroup(
+        plan.get(), ph_group_raw.SerializeAsString());
+
+    auto& config = SegcoreConfig::default_config();
+    auto parallelism = config.get_growing_search_parallelism();
+    config.set_growing_search_parallelism(1);
+    auto expected = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_growing_search_parallelism(4);
+    auto sr = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_growing_search_parallelism(parallelism);
+    ASSERT_EQ(sr->seg_offsets_, expected->seg_offsets_);
+    ASSERT_EQ(sr->distances_, expected->distances_);
+    ASSERT_EQ(sr->seg_offsets_.size(), nq * topk);
+}
+
+TEST(Growing, VectorChunkBytes) {
+    ASSERT_EQ(VectorChunkRows(64, 1000, 0), 1000);
+    ASSERT_EQ(VectorChunkRows(64, 1000, 6400), 64);
+    ASSERT_EQ(VectorChunkRows(64, 1000, 64 * 1000), 1000);
+    ASSERT_EQ(VectorChunkRows(64, 1000, 10), 1);
+
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    conf.set_vector_chunk_bytes(16 * sizeof(float) * 100);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    auto raw = dataset.get_col<float>(vec_fid);
+
+    // the vectors are split into chunks of 64 rows, the pks keep one chunk
+    auto& record =
+        dynamic_cast<SegmentGrowingImpl*>(segment.get())->get_insert_record();
+    ASSERT_EQ(record.get_field_data_base(vec_fid)->get_size_per_chunk(), 64);
+    ASSERT_EQ(record.get_field_data_base(pk)->get_size_per_chunk(), 1000);
+    ASSERT_EQ(segment->num_chunk_data(vec_fid), 16);
+    ASSERT_EQ(segment->num_chunk_data(pk), 1);
+
+    // the squared norms of the vectors are kept in chunks of the same rows
+    auto norms = record.get_vector_norms(vec_fid);
+    ASSERT_NE(norms, nullptr);
+    ASSERT_EQ(norms->get_size_per_chunk(), 64);
+    ASSERT_EQ(record.get_vector_norms(pk), nullptr);
+    for (int64_t i = 0; i < N; i++) {
+        float norm = 0;
+        for (int j = 0; j < 16; j++) {
+            norm += raw[i * 16 + j] * raw[i * 16 + j];
+        }
+        ASSERT_NEAR((*norms)[i], norm, 1e-4 * norm);
+    }
+
+    auto topk = 5;
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: %2%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: %1%)") %
+               vec_fid.get() % topk;
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan = query::CreateSearchPlanByExpr(
+        *schema, binary_plan.data(), binary_plan.size());
+
+    std::vector<int64_t> targets{0, 63, 64, 640, 999};
+    std::vector<float> queries;
+    for (auto target : targets) {
+        queries.insert(queries.end(),
+                       raw.begin() + target * 16,
+                       raw.begin() + (target + 1) * 16);
+    }
+    auto ph_group_raw = CreatePlaceholderGroup(targets.size(), 16, queries);
+    auto ph_group = query::ParsePlaceholderGroup(
+        plan.get(), ph_group_raw.SerializeAsString());
+    auto sr = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    for (int64_t i = 0; i < int64_t(targets.size()); i++) {
+        ASSERT_EQ(sr->seg_offsets_[i * topk], targets[i]);
+    }
+
+    segment->FillTargetEntry(plan.get(), *sr);
+    auto& vectors =
+        sr->output_fields_data_.at(vec_fid)->vectors().float_vector().data();
+    ASSERT_EQ(vectors.size(), sr->seg_offsets_.size() * 16);
+    for (int64_t i = 0; i < int64_t(sr->seg_offsets_.size()); i++) {
+        auto offset = sr->seg_offsets_[i];
+        for (int j = 0; j < 16; j++) {
+            ASSERT_EQ(vectors[i * 16 + j], raw[offset * 16 + j]);
+        }
+    }
+}
+
+TEST(Growing, GroupBySearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto bool_fid = schema->AddDebugField("flag", DataType::BOOL);
+    schema->set_primary_field_id(pk);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+
+    auto topk = 20;
+    auto group_size = 2;
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: %2%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10, \"group_by_field\": %3%, \"group_size\": %4%}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               vec_fid.get() % topk % bool_fid.get() % group_size;
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan = query::CreateSearchPlanByExpr(
+        *schema, binary_plan.data(), binary_plan.size());
+    auto& search_info = plan->plan_node_->search_info_;
+    ASSERT_EQ(search_info.group_by_field_id_, bool_fid);
+    ASSERT_EQ(search_info.group_size_, group_size);
+    ASSERT_FALSE(search_info.search_params_.contains(GROUP_BY_FIELD));
+
+    auto num_queries = 5;
+    auto ph_group_raw = CreatePlaceholderGroup(num_queries, 16, 1024);
+    auto ph_group = query::ParsePlaceholderGroup(
+        plan.get(), ph_group_raw.SerializeAsString());
+
+    // the bool field has two groups, a segment keeps group_size hits of each
+    auto sr1 = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    auto sr2 = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    for (int64_t i = 0; i < num_queries; i++) {
+        std::map<GroupByValueType, int64_t> group_counts;
+        for (int64_t j = i * topk; j < (i + 1) * topk; j++) {
+            if (sr1->seg_offsets_[j] == INVALID_SEG_OFFSET) {
+                ASSERT_EQ(sr1->group_by_values_[j], GroupByValueType{});
+                continue;
+            }
+            auto flag = sr1->seg_offsets_[j] % 2 == 0;
+            ASSERT_EQ(sr1->group_by_values_[j], GroupByValueType{int64_t(flag)});
+            group_counts[sr1->group_by_values_[j]]++;
+        }
+        ASSERT_EQ(group_counts.size(), 2);
+        for (auto& [value, count] : group_counts) {
+            ASSERT_EQ(count, group_size);
+        }
+    }
+
+    std::vector<SearchResult*> results{sr1.get(), sr2.get()};
+    std::vector<int64_t> slice_nqs{num_queries};
+    std::vector<int64_t> slice_topks{topk};
+    ReduceHelper reduce_helper(
+        results, plan.get(), slice_nqs.data(), slice_topks.data(), 1);
+    reduce_helper.Reduce();
+    for (int64_t i = 0; i < num_queries; i++) {
+        std::map<GroupByValueType, int64_t> group_counts;
+        for (auto result : results) {
+            auto& prefix_sum = result->topk_per_nq_prefix_sum_;
+            for (auto j = prefix_sum[i]; j < prefix_sum[i + 1]; j++) {
+                group_counts[result->group_by_values_[j]]++;
+            }
+        }
+        ASSERT_EQ(group_counts.size(), 2);
+        for (auto& [value, count] : group_counts) {
+            ASSERT_EQ(count, group_size);
+        }
+    }
+}
+
 TEST(Growing, RealCount) {
     auto schema = std::make_shared<Schema>();
     auto pk = schema->AddDebugField("pk", DataType::INT64);
@@ -89,3 +658,460 @@ TEST(Growing, RealCount) {
     ASSERT_TRUE(status.ok());
     ASSERT_EQ(0, segment->get_real_count());
 }
+
+TEST(Growing, Upsert) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(pk);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+
+    int64_t c = 10;
+    auto dataset = DataGen(schema, c);
+    auto offset = segment->PreInsert(c);
+    segment->Insert(offset,
+                    c,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+
+    // the first half of the pks again, after the rows they replace
+    auto half = c / 2;
+    auto upserted = DataGen(schema, half, 43, c);
+    offset = segment->PreInsert(half);
+    ASSERT_EQ(offset, c);
+    segment->Upsert(offset,
+                    half,
+                    upserted.row_ids_.data(),
+                    upserted.timestamps_.data(),
+                    upserted.raw_);
+    ASSERT_EQ(segment->get_row_count(), c + half);
+    ASSERT_EQ(segment->get_deleted_count(), half);
+    ASSERT_EQ(segment->get_real_count(), c);
+
+    // deletes reserved by the segment follow those of the caller
+    ASSERT_EQ(segment->PreDelete(1), half);
+}
+
+TEST(Growing, DeleteBuffer) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto buffer = std::make_shared<DeleteBuffer>();
+
+    int64_t c = 10;
+    std::vector<SegmentGrowingPtr> segments;
+    for (int i = 0; i < 2; ++i) {
+        auto segment = CreateGrowingSegment(schema, empty_index_meta);
+        segment->set_delete_buffer(buffer);
+        auto dataset = DataGen(schema, c);
+        auto offset = segment->PreInsert(c);
+        segment->Insert(offset,
+                        c,
+                        dataset.row_ids_.data(),
+                        dataset.timestamps_.data(),
+                        dataset.raw_);
+        segments.push_back(std::move(segment));
+    }
+
+    // stored once, masked by both segments
+    auto half = c / 2;
+    std::vector<PkType> pks;
+    for (int64_t i = 0; i < half; ++i) {
+        pks.emplace_back(i);
+    }
+    auto tss = GenTss(half, c);
+    buffer->push(pks.data(), tss.data(), half);
+    for (auto& segment : segments) {
+        ASSERT_EQ(segment->get_deleted_count(), 0);
+        ASSERT_EQ(segment->get_real_count(), c - half);
+    }
+
+    // deleted again later, folded into the last delete of each pk
+    auto later = GenTss(half, c + half);
+    buffer->push(pks.data(), later.data(), half);
+    ASSERT_EQ(buffer->size(), c);
+    ASSERT_EQ(buffer->compact(MAX_TIMESTAMP), half);
+    for (auto& segment : segments) {
+        ASSERT_EQ(segment->get_real_count(), c - half);
+    }
+}
+
+TEST(Growing, InsertColumns) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto i8_fid = schema->AddDebugField("i8", DataType::INT8);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    int64_t dim = 16;
+    auto vec_fid = schema->AddDebugField(
+        "vec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    schema->set_primary_field_id(pk);
+
+    // large enough for the fields to be filled concurrently
+    int64_t N = 5000;
+    auto dataset = DataGen(schema, N);
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto i32s = dataset.get_col<int32_t>(i8_fid);
+    std::vector<int8_t> i8s(i32s.begin(), i32s.end());
+    auto vecs = dataset.get_col<float>(vec_fid);
+    auto strs = dataset.get_col<std::string>(str_fid);
+    std::string str_bytes;
+    std::vector<int64_t> str_offsets{0};
+    for (auto& str : strs) {
+        str_bytes += str;
+        str_offsets.push_back(str_bytes.size());
+    }
+    std::vector<InsertColumn> columns{
+        {pk, pks.data()},
+        {i8_fid, i8s.data()},
+        {str_fid, str_bytes.data(), str_offsets.data()},
+        {vec_fid, vecs.data()},
+    };
+
+    auto expected = CreateGrowingSegment(schema, empty_index_meta);
+    expected->PreInsert(N);
+    expected->Insert(0,
+                     N,
+                     dataset.row_ids_.data(),
+                     dataset.timestamps_.data(),
+                     dataset.raw_);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+    segment->PreInsert(N);
+    segment->InsertColumns(0,
+                           N,
+                           dataset.row_ids_.data(),
+                           dataset.timestamps_.data(),
+                           columns);
+    ASSERT_EQ(segment->get_row_count(), N);
+
+    auto& expected_record =
+        dynamic_cast<SegmentGrowingImpl*>(expected.get())->get_insert_record();
+    auto& record =
+        dynamic_cast<SegmentGrowingImpl*>(segment.get())->get_insert_record();
+    auto expected_i8 = expected_record.get_field_data<int8_t>(i8_fid);
+    auto expected_str = expected_record.get_field_data<std::string>(str_fid);
+    auto expected_vec = expected_record.get_field_data<FloatVector>(vec_fid);
+    auto i8_data = record.get_field_data<int8_t>(i8_fid);
+    auto str_data = record.get_field_data<std::string>(str_fid);
+    auto vec_data = record.get_field_data<FloatVector>(vec_fid);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ((*i8_data)[i], (*expected_i8)[i]) << i;
+        ASSERT_EQ((*str_data)[i], (*expected_str)[i]) << i;
+        ASSERT_TRUE(std::equal(vec_data->get_element(i),
+                               vec_data->get_element(i) + dim,
+                               expected_vec->get_element(i)))
+            << i;
+    }
+
+    // the pks are looked up as well
+    auto ids = GenPKs(pks.begin(), pks.begin() + 100);
+    auto [found, offsets] = segment->search_ids(*ids, MAX_TIMESTAMP);
+    auto [expected_found, expected_offsets] =
+        expected->search_ids(*ids, MAX_TIMESTAMP);
+    ASSERT_EQ(offsets.size(), expected_offsets.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        ASSERT_EQ(offsets[i].get(), expected_offsets[i].get());
+    }
+}
+
+TEST(Growing, Snapshot) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto& tss = dataset.timestamps_;
+    std::iota(tss.begin(), tss.end(), 0);
+    segment->PreInsert(N);
+    segment->Insert(0, N, dataset.row_ids_.data(), tss.data(), dataset.raw_);
+    auto pks = dataset.get_col<int64_t>(pk);
+
+    auto del_offset = segment->PreDelete(10);
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + 10);
+    auto del_tss = GenTss(10, 600);
+    auto status =
+        segment->Delete(del_offset, 10, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+
+    auto plan = std::make_unique<query::RetrievePlan>(*schema);
+    plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+    plan->plan_node_->is_count = true;
+    auto count = [](const auto& result) {
+        return result->fields_data(0).scalars().long_data().data(0);
+    };
+
+    Timestamp ts = 700;
+    auto snapshot = segment->AcquireSnapshot(ts);
+    ASSERT_EQ(snapshot->timestamp(), ts);
+    ASSERT_EQ(snapshot->active_count(), int64_t(ts) + 1);
+    ASSERT_EQ(count(segment->Retrieve(plan.get(), *snapshot)),
+              count(segment->Retrieve(plan.get(), ts)));
+    ASSERT_LT(count(segment->Retrieve(plan.get(), *snapshot)),
+              snapshot->active_count());
+    // shared while it is held
+    ASSERT_EQ(segment->AcquireSnapshot(ts), snapshot);
+
+    // a delete up to the timestamp makes it stale
+    del_offset = segment->PreDelete(1);
+    del_ids = GenPKs(pks.begin() + 10, pks.begin() + 11);
+    del_tss = GenTss(1, ts);
+    status = segment->Delete(del_offset, 1, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    auto fresh = segment->AcquireSnapshot(ts);
+    ASSERT_NE(fresh, snapshot);
+
+    // one after the timestamp leaves it valid
+    del_offset = segment->PreDelete(1);
+    del_ids = GenPKs(pks.begin() + 20, pks.begin() + 21);
+    del_tss = GenTss(1, 800);
+    status = segment->Delete(del_offset, 1, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->AcquireSnapshot(ts), fresh);
+    ASSERT_EQ(count(segment->Retrieve(plan.get(), *fresh)),
+              count(segment->Retrieve(plan.get(), ts)));
+}
+
+TEST(Growing, SnapshotRestore) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    int64_t dim = 16;
+    auto vec_fid = schema->AddDebugField(
+        "vec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    auto json_fid = schema->AddDebugField("json", DataType::JSON);
+    schema->set_primary_field_id(pk);
+    auto dir = std::string("/tmp/milvus/growing_snapshot_test");
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+
+    int64_t N = 2500;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, 3, conf);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto del_offset = segment->PreDelete(10);
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + 10);
+    auto del_tss = GenTss(10, N);
+    auto status =
+        segment->Delete(del_offset, 10, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+
+    // the position is opaque bytes
+    auto position = std::string("channel\0offset", 14);
+    auto& source = dynamic_cast<SegmentGrowingImpl&>(*segment);
+    auto saved = SaveGrowingSnapshot(source, dir, position);
+    ASSERT_EQ(saved.row_count, N);
+    ASSERT_EQ(saved.delete_count, 10);
+
+    auto restored = CreateGrowingSegment(schema, empty_index_meta, 3, conf);
+    auto& target = dynamic_cast<SegmentGrowingImpl&>(*restored);
+    auto info = RestoreGrowingSnapshot(target, dir);
+    ASSERT_EQ(info.segment_id, 3);
+    ASSERT_EQ(info.row_count, N);
+    ASSERT_EQ(info.delete_count, 10);
+    ASSERT_EQ(info.position, position);
+    ASSERT_EQ(restored->get_row_count(), N);
+    ASSERT_EQ(restored->get_deleted_count(), 10);
+    ASSERT_EQ(restored->get_real_count(), segment->get_real_count());
+
+    auto& expected = source.get_insert_record();
+    auto& record = target.get_insert_record();
+    auto expected_vec = expected.get_field_data<FloatVector>(vec_fid);
+    auto expected_str = expected.get_field_data<std::string>(str_fid);
+    auto expected_json = expected.get_field_data<Json>(json_fid);
+    auto vec_data = record.get_field_data<FloatVector>(vec_fid);
+    auto str_data = record.get_field_data<std::string>(str_fid);
+    auto json_data = record.get_field_data<Json>(json_fid);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_TRUE(std::equal(vec_data->get_element(i),
+                               vec_data->get_element(i) + dim,
+                               expected_vec->get_element(i)))
+            << i;
+        ASSERT_EQ((*str_data)[i], (*expected_str)[i]) << i;
+        ASSERT_EQ((*json_data)[i].data(), (*expected_json)[i].data()) << i;
+    }
+
+    // only an empty segment of the same id is restored
+    ASSERT_ANY_THROW(RestoreGrowingSnapshot(target, dir));
+    auto other = CreateGrowingSegment(schema, empty_index_meta, 4, conf);
+    ASSERT_ANY_THROW(
+        RestoreGrowingSnapshot(dynamic_cast<SegmentGrowingImpl&>(*other), dir));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(Growing, FillManyOutputFields) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 256;
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto double_fid = schema->AddDebugField("score", DataType::DOUBLE);
+    schema->set_primary_field_id(pk);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+
+    // enough rows for the fields to be gathered in parallel
+    auto topk = 100;
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: %2%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">
+                                            output_field_ids: %1%
+                                            output_field_ids: %3%
+                                            output_field_ids: %4%)") %
+               vec_fid.get() % topk % pk.get() % double_fid.get();
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan = query::CreateSearchPlanByExpr(
+        *schema, binary_plan.data(), binary_plan.size());
+    auto rows = 10 * topk;
+    ASSERT_GE(EstimateTargetEntryBytes(*schema, plan->target_entries_, rows),
+              2 * MIN_FILL_TARGET_ENTRY_BYTES_PER_TASK);
+
+    auto ph_group_raw = CreatePlaceholderGroup(10, dim, 1024);
+    auto ph_group = query::ParsePlaceholderGroup(
+        plan.get(), ph_group_raw.SerializeAsString());
+    auto sr = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(sr->seg_offsets_.size(), rows);
+    segment->FillTargetEntry(plan.get(), *sr);
+
+    auto raw_vectors = dataset.get_col<float>(vec_fid);
+    auto raw_pks = dataset.get_col<int64_t>(pk);
+    auto raw_scores = dataset.get_col<double>(double_fid);
+    auto& vectors =
+        sr->output_fields_data_.at(vec_fid)->vectors().float_vector().data();
+    auto& pks = sr->output_fields_data_.at(pk)->scalars().long_data().data();
+    auto& scores =
+        sr->output_fields_data_.at(double_fid)->scalars().double_data().data();
+    ASSERT_EQ(vectors.size(), rows * dim);
+    ASSERT_EQ(pks.size(), rows);
+    ASSERT_EQ(scores.size(), rows);
+    for (int64_t i = 0; i < rows; i++) {
+        auto offset = sr->seg_offsets_[i];
+        ASSERT_EQ(pks[i], raw_pks[offset]);
+        ASSERT_EQ(scores[i], raw_scores[offset]);
+        for (int j = 0; j < dim; j++) {
+            ASSERT_EQ(vectors[i * dim + j], raw_vectors[offset * dim + j]);
+        }
+    }
+}
+
+TEST(Growing, FlushToBinlogs) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    auto double_fid = schema->AddDebugField("double", DataType::DOUBLE);
+    schema->set_primary_field_id(pk_fid);
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(100);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, 7, conf);
+
+    int64_t N = 250;
+    auto dataset = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+
+    // the rows of the last, partial chunks are left out
+    int64_t rows = 230;
+    FlushInfo info{1, 2, rows, {}};
+    for (auto field_id :
+         {RowFieldID, TimestampFieldID, vec_fid, pk_fid, str_fid, double_fid}) {
+        info.fields.push_back(
+            {field_id, "insert_log/" + std::to_string(field_id.get())});
+    }
+    info.stats_path = "stats_log/0";
+    auto chunk_manager = std::make_shared<storage::MemChunkManager>();
+    auto& growing = dynamic_cast<SegmentGrowingImpl&>(*segment);
+    auto result = FlushGrowingSegment(growing, info, chunk_manager.get());
+    auto& binlogs = result.binlogs;
+    ASSERT_EQ(binlogs.size(), info.fields.size());
+
+    auto read = [&](int64_t i) {
+        auto& binlog = binlogs[i];
+        EXPECT_EQ(binlog.field_id, info.fields[i].field_id);
+        EXPECT_EQ(binlog.rows, rows);
+        EXPECT_EQ(binlog.log_size,
+                  int64_t(chunk_manager->Size(info.fields[i].path)));
+        EXPECT_EQ(binlog.timestamp_from, dataset.timestamps_[0]);
+        auto codec = storage::DeserializeRemoteFileData(
+            chunk_manager.get(), info.fields[i].path);
+        EXPECT_EQ(codec->GetTimeRage(),
+                  std::make_pair(binlog.timestamp_from, binlog.timestamp_to));
+        auto field_data = codec->GetFieldData();
+        EXPECT_EQ(field_data->get_num_rows(), rows);
+        return field_data;
+    };
+    auto row_ids = read(0);
+    auto tss = read(1);
+    auto vecs = read(2);
+    auto pks = read(3);
+    auto strs = read(4);
+    auto doubles = read(5);
+    auto raw_vecs = dataset.get_col<float>(vec_fid);
+    auto raw_pks = dataset.get_col<int64_t>(pk_fid);
+    auto raw_strs = dataset.get_col<std::string>(str_fid);
+    auto raw_doubles = dataset.get_col<double>(double_fid);
+    ASSERT_EQ(binlogs[2].memory_size, int64_t(rows * 16 * sizeof(float)));
+    for (int64_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(static_cast<const int64_t*>(row_ids->Data())[i],
+                  dataset.row_ids_[i]);
+        ASSERT_EQ(static_cast<const int64_t*>(tss->Data())[i],
+                  dataset.timestamps_[i]);
+        ASSERT_EQ(static_cast<const int64_t*>(pks->Data())[i], raw_pks[i]);
+        ASSERT_EQ(static_cast<const double*>(doubles->Data())[i],
+                  raw_doubles[i]);
+        ASSERT_EQ(std::string(static_cast<const char*>(strs->RawValue(i)),
+                              strs->get_element_size(i)),
+                  raw_strs[i]);
+        for (int64_t j = 0; j < 16; ++j) {
+            ASSERT_EQ(static_cast<const float*>(vecs->Data())[i * 16 + j],
+                      raw_vecs[i * 16 + j]);
+        }
+    }
+
+
+    // the pk stats cover every inserted row
+    auto stats_size = chunk_manager->Size(info.stats_path);
+    ASSERT_EQ(result.stats_log_size, int64_t(stats_size));
+    std::vector<uint8_t> stats_log(stats_size);
+    chunk_manager->Read(info.stats_path, stats_log.data(), stats_size);
+    auto stats = DeserializePkStats(stats_log.data(), stats_log.size());
+    ASSERT_EQ(stats.num_rows, rows);
+    ASSERT_EQ(*stats.min_pk,
+              PkType(*std::min_element(raw_pks.begin(), raw_pks.end())));
+    ASSERT_EQ(*stats.max_pk,
+              PkType(*std::max_element(raw_pks.begin(), raw_pks.end())));
+    ASSERT_NE(stats.filter, nullptr);
+    for (auto pk : raw_pks) {
+        ASSERT_TRUE(stats.filter->may_contain(pk));
+    }
+
+    ASSERT_ANY_THROW(FlushGrowingSegment(
+        growing, FlushInfo{1, 2, N + 1, info.fields}, chunk_manager.get()));
+}
@@ -10,6 +10,8 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
 
 #include "segcore/SegmentGrowing.h"
 #include "segcore/SegmentGrowingImpl.h"
@@ -139,3 +141,155 @@ TEST(GrowingIndex, GetVector) {
         }
     }
 }
+
+TEST(GrowingIndex, Sq8InterimIndex) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto vec = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 128, knowhere::metric::L2);
+    schema->set_primary_field_id(pk);
+
+    std::map<std::string, std::string> index_params = {
+        {"index_type", "IVF_FLAT"}, {"metric_type", "L2"}, {"nlist", "128"}};
+    std::map<std::string, std::string> type_params = {{"dim", "128"}};
+    FieldIndexMeta fieldIndexMeta(
+        vec, std::move(index_params), std::move(type_params));
+    auto& config = SegcoreConfig::default_config();
+    config.set_chunk_rows(1024);
+    config.set_enable_growing_segment_index(true);
+    config.set_interim_index_type("IVF_SQ8");
+    std::map<FieldId, FieldIndexMeta> filedMap = {{vec, fieldIndexMeta}};
+    IndexMetaPtr metaPtr =
+        std::make_shared<CollectionIndexMeta>(100000, std::move(filedMap));
+    auto segment_growing = CreateGrowingSegment(schema, metaPtr);
+    auto segment = dynamic_cast<SegmentGrowingImpl*>(segment_growing.get());
+
+    const char* raw_plan = R"(vector_anns: <
+                                    field_id: 101
+                                    query_info: <
+                                        topk: 5
+                                        round_decimal: 3
+                                        metric_type: "L2"
+                                        search_params: "{\"nprobe\": 16}"
+                                    >
+                                    placeholder_tag: "$0"
+     >)";
+    auto plan_str = translate_text_plan_to_binary_plan(raw_plan);
+    auto plan = milvus::query::CreateSearchPlanByExpr(
+        *schema, plan_str.data(), plan_str.size());
+
+    int64_t per_batch = 5000;
+    int64_t n_batch = 4;
+    int64_t dim = 128;
+    for (int64_t i = 0; i < n_batch; i++) {
+        auto dataset = DataGen(schema, per_batch);
+        auto fakevec = dataset.get_col<float>(vec);
+        auto offset = segment->PreInsert(per_batch);
+        segment->Insert(offset,
+                        per_batch,
+                        dataset.row_ids_.data(),
+                        dataset.timestamps_.data(),
+                        dataset.raw_);
+
+        auto num_queries = 5;
+        auto ph_group_raw = CreatePlaceholderGroup(num_queries, dim, 1024);
+        auto ph_group =
+            ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+        auto sr = segment->Search(plan.get(), ph_group.get(), 1000000);
+        EXPECT_EQ(sr->total_nq_, num_queries);
+        EXPECT_EQ(sr->seg_offsets_.size(), num_queries * 5);
+
+        // the quantized index keeps no raw data, vectors come from the chunks
+        auto num_inserted = (i + 1) * per_batch;
+        auto ids_ds = GenRandomIds(num_inserted);
+        auto result =
+            segment->bulk_subscript(vec, ids_ds->GetIds(), num_inserted);
+        auto vector = result.get()->mutable_vectors()->float_vector().data();
+        ASSERT_EQ(vector.size(), num_inserted * dim);
+        for (int64_t j = 0; j < num_inserted; ++j) {
+            auto id = ids_ds->GetIds()[j];
+            for (int64_t k = 0; k < dim; ++k) {
+                ASSERT_EQ(vector[j * dim + k],
+                          fakevec[(id % per_batch) * dim + k]);
+            }
+        }
+    }
+    config.set_interim_index_type("");
+}
+
+TEST(GrowingIndex, AsyncBuild) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto vec = schema->AddDebugField(
+        "embeddings", DataType::VECTOR_FLOAT, 128, knowhere::metric::L2);
+    schema->set_primary_field_id(pk);
+
+    std::map<std::string, std::string> index_params = {
+        {"index_type", "IVF_FLAT"}, {"metric_type", "L2"}, {"nlist", "128"}};
+    std::map<std::string, std::string> type_params = {{"dim", "128"}};
+    FieldIndexMeta fieldIndexMeta(
+        vec, std::move(index_params), std::move(type_params));
+    auto& config = SegcoreConfig::default_config();
+    config.set_chunk_rows(1024);
+    config.set_enable_growing_segment_index(true);
+    config.set_growing_index_async_build(true);
+    std::map<FieldId, FieldIndexMeta> filedMap = {{vec, fieldIndexMeta}};
+    IndexMetaPtr metaPtr =
+        std::make_shared<CollectionIndexMeta>(100000, std::move(filedMap));
+    auto segment_growing = CreateGrowingSegment(schema, metaPtr);
+    auto segment = dynamic_cast<SegmentGrowingImpl*>(segment_growing.get());
+
+    const char* raw_plan = R"(vector_anns: <
+                                    field_id: 101
+                                    query_info: <
+                                        topk: 1
+                                        metric_type: "L2"
+                                        search_params: "{\"nprobe\": 16}"
+                                    >
+                                    placeholder_tag: "$0"
+     >)";
+    auto plan_str = translate_text_plan_to_binary_plan(raw_plan);
+    auto plan = milvus::query::CreateSearchPlanByExpr(
+        *schema, plan_str.data(), plan_str.size());
+
+    int64_t per_batch = 5000;
+    int64_t n_batch = 4;
+    int64_t dim = 128;
+    auto& indexing_record = segment->get_indexing_record();
+    for (int64_t i = 0; i < n_batch; i++) {
+        auto dataset = DataGen(schema, per_batch, 42 + i);
+        auto fakevec = dataset.get_col<float>(vec);
+        auto offset = segment->PreInsert(per_batch);
+        segment->Insert(offset,
+                        per_batch,
+                        dataset.row_ids_.data(),
+                        dataset.timestamps_.data(),
+                        dataset.raw_);
+
+        // the rows the index has not taken yet are searched by brute force
+        std::vector<int64_t> targets{0, per_batch - 1};
+        std::vector<float> queries;
+        for (auto target : targets) {
+            queries.insert(queries.end(),
+                           fakevec.begin() + target * dim,
+                           fakevec.begin() + (target + 1) * dim);
+        }
+        auto ph_group_raw =
+            CreatePlaceholderGroup(targets.size(), dim, queries);
+        auto ph_group =
+            ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+        auto sr = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+        for (int64_t j = 0; j < int64_t(targets.size()); ++j) {
+            ASSERT_EQ(sr->seg_offsets_[j], offset + targets[j]);
+        }
+    }
+
+    // the background build catches up without further inserts
+    auto inserted = n_batch * per_batch;
+    for (int i = 0; i < 1000 && indexing_record.IndexBehind(inserted); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto& field_indexing = indexing_record.get_vec_field_indexing(vec);
+    ASSERT_GT(field_indexing.get_index_cursor(), 0);
+    ASSERT_FALSE(indexing_record.HasRawData(vec));
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/HedgedChunkManager.h"
+#include "test_utils/MemChunkManager.h"
+
+using namespace std;
+using namespace milvus;
+using namespace milvus::storage;
+
+namespace {
+
+// every `slow_every`th read stalls
+class SlowChunkManager : public MemChunkManager {
+ public:
+    using MemChunkManager::Read;
+
+    uint64_t
+    Read(const string& filepath,
+         uint64_t offset,
+         void* buf,
+         uint64_t len) override {
+        auto n = ++reads;
+        if (slow_every > 0 && n % slow_every == 0) {
+            this_thread::sleep_for(chrono::milliseconds(500));
+        }
+        return MemChunkManager::Read(filepath, offset, buf, len);
+    }
+
+    atomic<int64_t> reads = 0;
+    atomic<int64_t> slow_every = 0;
+};
+
+}  // namespace
+
+class HedgedChunkManagerTest : public testing::Test {
+ protected:
+    void
+    SetUp() override {
+        auto memory = make_unique<SlowChunkManager>();
+        memory_ = memory.get();
+        string data;
+        for (int i = 0; i < 10000; ++i) {
+            data.push_back(char(i % 251));
+        }
+        memory_->Write("file", data.data(), data.size());
+        HedgedReadConfig config;
+        config.min_hedge_samples = 8;
+        config.min_hedge_delay_ms = 5;
+        config.max_coalesce_gap = 1000;
+        hcm_ = make_unique<HedgedChunkManager>(move(memory), config);
+    }
+
+    SlowChunkManager* memory_;
+    unique_ptr<HedgedChunkManager> hcm_;
+};
+
+TEST_F(HedgedChunkManagerTest, HedgeSlowRead) {
+    char buf[100];
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(hcm_->Read("file", i * 100, buf, 100), 100);
+    }
+
+    // the next read stalls, its duplicate doesn't
+    memory_->slow_every = 9;
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(hcm_->Read("file", 200, buf, 100), 100);
+    auto elapsed = chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, chrono::milliseconds(400));
+    EXPECT_EQ(buf[0], char(200));
+    memory_->slow_every = 0;
+
+    auto stats = hcm_->GetStats();
+    EXPECT_EQ(stats["read"].hedged, 1);
+    EXPECT_EQ(stats["read"].count, 9);
+    // the request left behind finishes on its own
+    this_thread::sleep_for(chrono::milliseconds(600));
+    EXPECT_EQ(hcm_->GetStats()["read"].count, 10);
+}
+
+TEST_F(HedgedChunkManagerTest, CoalesceRanges) {
+    char a[10], b[10], c[10];
+    vector<RemoteReadRange> ranges = {{5000, 10, a}, {100, 10, b}, {120, 10, c}};
+    auto sizes = hcm_->ReadCoalesced("file", ranges);
+    // the two close ranges are fetched together
+    EXPECT_EQ(memory_->reads, 2);
+    EXPECT_EQ(sizes, vector<uint64_t>({10, 10, 10}));
+    EXPECT_EQ(a[0], char(5000 % 251));
+    EXPECT_EQ(b[0], char(100));
+    EXPECT_EQ(c[9], char(129));
+
+    // a range running past the end of the object is cut short
+    sizes = hcm_->ReadCoalesced("file", {{9995, 10, a}});
+    EXPECT_EQ(sizes[0], 5);
+}
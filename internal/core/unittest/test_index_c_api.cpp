@@ -11,10 +11,18 @@
 
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 #include <tuple>
 #include "pb/index_cgo_msg.pb.h"
 
+#include "indexbuilder/BuildScheduler.h"
 #include "indexbuilder/index_c.h"
+#include "indexbuilder/init_c.h"
+#include "index/Meta.h"
+#include "storage/FieldDataFactory.h"
+#include "storage/InsertData.h"
+#include "storage/MinioChunkManager.h"
 #include "test_utils/indexbuilder_test_utils.h"
 #include "indexbuilder/ScalarIndexCreator.h"
 #include "common/type_c.h"
@@ -85,6 +93,143 @@ TEST(FloatVecIndex, All) {
     { DeleteBinarySet(binary_set); }
 }
 
+TEST(FloatVecIndex, StreamBuild) {
+    constexpr int64_t stream_nb = 1000;
+    constexpr int64_t batch_rows = 250;
+    auto index_type = knowhere::IndexEnum::INDEX_FAISS_IVFSQ8;
+    auto metric_type = knowhere::metric::L2;
+    indexcgo::TypeParams type_params;
+    indexcgo::IndexParams index_params;
+    std::tie(type_params, index_params) =
+        generate_params(index_type, metric_type);
+    // trained on the first two batches, the last two are added
+    auto param = index_params.add_params();
+    param->set_key(milvus::index::STREAM_BUILD_TRAIN_ROWS);
+    param->set_value(std::to_string(2 * batch_rows));
+    std::string type_params_str, index_params_str;
+    bool ok;
+    ok = google::protobuf::TextFormat::PrintToString(type_params,
+                                                     &type_params_str);
+    assert(ok);
+    ok = google::protobuf::TextFormat::PrintToString(index_params,
+                                                     &index_params_str);
+    assert(ok);
+    auto dataset = GenDataset(stream_nb, metric_type, false);
+    auto xb_data = dataset.get_col<float>(milvus::FieldId(100));
+
+    CDataType dtype = FloatVector;
+    CIndex index;
+    CStatus status;
+    CBinarySet binary_set;
+    CIndex copy_index;
+
+    status = CreateIndex(dtype,
+                         type_params_str.c_str(),
+                         index_params_str.c_str(),
+                         &index,
+                         c_storage_config);
+    ASSERT_EQ(Success, status.error_code);
+
+    // nothing to build on yet
+    status = FinishVecIndexBuild(index);
+    ASSERT_NE(Success, status.error_code);
+
+    for (int64_t i = 0; i < stream_nb; i += batch_rows) {
+        status = AppendFloatVecIndexData(
+            index, batch_rows * DIM, xb_data.data() + i * DIM);
+        ASSERT_EQ(Success, status.error_code);
+    }
+    status = FinishVecIndexBuild(index);
+    ASSERT_EQ(Success, status.error_code);
+
+    status = SerializeIndexToBinarySet(index, &binary_set);
+    ASSERT_EQ(Success, status.error_code);
+    status = CreateIndex(dtype,
+                         type_params_str.c_str(),
+                         index_params_str.c_str(),
+                         &copy_index,
+                         c_storage_config);
+    ASSERT_EQ(Success, status.error_code);
+    status = LoadIndexFromBinarySet(copy_index, binary_set);
+    ASSERT_EQ(Success, status.error_code);
+
+    status = DeleteIndex(index);
+    ASSERT_EQ(Success, status.error_code);
+    status = DeleteIndex(copy_index);
+    ASSERT_EQ(Success, status.error_code);
+    DeleteBinarySet(binary_set);
+}
+
+TEST(FloatVecIndex, BuildWithBinlogs) {
+    constexpr int64_t binlog_rows = 250;
+    constexpr int num_binlogs = 4;
+    auto index_type = knowhere::IndexEnum::INDEX_FAISS_IVFSQ8;
+    auto metric_type = knowhere::metric::L2;
+    indexcgo::TypeParams type_params;
+    indexcgo::IndexParams index_params;
+    std::tie(type_params, index_params) =
+        generate_params(index_type, metric_type);
+    std::string type_params_str, index_params_str;
+    bool ok;
+    ok = google::protobuf::TextFormat::PrintToString(type_params,
+                                                     &type_params_str);
+    assert(ok);
+    ok = google::protobuf::TextFormat::PrintToString(index_params,
+                                                     &index_params_str);
+    assert(ok);
+    auto dataset = GenDataset(binlog_rows * num_binlogs, metric_type, false);
+    auto xb_data = dataset.get_col<float>(milvus::FieldId(100));
+
+    auto storage_config = get_default_storage_config();
+    auto rcm = std::make_unique<milvus::storage::MinioChunkManager>(
+        storage_config);
+    std::vector<std::string> binlog_paths;
+    for (int i = 0; i < num_binlogs; ++i) {
+        auto field_data =
+            milvus::storage::FieldDataFactory::GetInstance().CreateFieldData(
+                milvus::storage::DataType::VECTOR_FLOAT, DIM);
+        field_data->FillFieldData(xb_data.data() + i * binlog_rows * DIM,
+                                  binlog_rows * DIM);
+        milvus::storage::InsertData insert_data(field_data);
+        insert_data.SetFieldDataMeta({1, 2, 3, 100});
+        insert_data.SetTimestamps(0, 100);
+        auto bytes =
+            insert_data.Serialize(milvus::storage::StorageType::Remote);
+        auto path = storage_config.remote_root_path +
+                    "/build_with_binlogs/" + std::to_string(i);
+        rcm->Write(path, bytes.data(), bytes.size());
+        binlog_paths.push_back(path);
+    }
+    std::vector<const char*> c_binlog_paths;
+    for (auto& path : binlog_paths) {
+        c_binlog_paths.push_back(path.c_str());
+    }
+
+    CDataType dtype = FloatVector;
+    CIndex index;
+    CStatus status;
+    CBinarySet binary_set;
+
+    status = CreateIndex(dtype,
+                         type_params_str.c_str(),
+                         index_params_str.c_str(),
+                         &index,
+                         c_storage_config);
+    ASSERT_EQ(Success, status.error_code);
+    status = BuildVecIndexWithBinlogs(
+        index, c_binlog_paths.data(), c_binlog_paths.size());
+    ASSERT_EQ(Success, status.error_code);
+    status = SerializeIndexToBinarySet(index, &binary_set);
+    ASSERT_EQ(Success, status.error_code);
+
+    status = DeleteIndex(index);
+    ASSERT_EQ(Success, status.error_code);
+    DeleteBinarySet(binary_set);
+    for (auto& path : binlog_paths) {
+        rcm->Remove(path);
+    }
+}
+
 TEST(BinaryVecIndex, All) {
     auto index_type = knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT;
     auto metric_type = knowhere::metric::JACCARD;
@@ -148,6 +293,74 @@ TEST(BinaryVecIndex, All) {
     { DeleteBinarySet(binary_set); }
 }
 
+TEST(FloatVecIndex, BuildMemoryBudget) {
+    auto metric_type = knowhere::metric::L2;
+    auto [type_params, index_params] =
+        generate_params(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, metric_type);
+    std::string type_params_str, index_params_str;
+    google::protobuf::TextFormat::PrintToString(type_params, &type_params_str);
+    google::protobuf::TextFormat::PrintToString(index_params,
+                                                &index_params_str);
+    auto dataset = GenDataset(NB, metric_type, false);
+    auto xb_data = dataset.get_col<float>(milvus::FieldId(100));
+
+    CIndex index;
+    auto status = CreateIndex(FloatVector,
+                              type_params_str.c_str(),
+                              index_params_str.c_str(),
+                              &index,
+                              c_storage_config);
+    ASSERT_EQ(Success, status.error_code);
+    int64_t small = 0;
+    int64_t large = 0;
+    status = EstimateVecIndexBuildMemory(index, NB, &small);
+    ASSERT_EQ(Success, status.error_code);
+    status = EstimateVecIndexBuildMemory(index, NB * 1000, &large);
+    ASSERT_EQ(Success, status.error_code);
+    // the raw vectors of the caller and the copy of the index at least
+    ASSERT_GE(large, 2 * NB * 1000 * DIM * int64_t(sizeof(float)));
+    ASSERT_GT(large, small);
+
+    // a build over the whole budget runs alone
+    IndexBuilderSetMemoryBudget(1);
+    status = BuildFloatVecIndex(index, NB * DIM, xb_data.data());
+    ASSERT_EQ(Success, status.error_code);
+    int64_t used = -1;
+    int64_t queued = -1;
+    status = GetIndexBuildQueue(&used, &queued);
+    ASSERT_EQ(Success, status.error_code);
+    ASSERT_EQ(used, 0);
+    ASSERT_EQ(queued, 0);
+    IndexBuilderSetMemoryBudget(0);
+    status = DeleteIndex(index);
+    ASSERT_EQ(Success, status.error_code);
+}
+
+TEST(FloatVecIndex, BuildScheduler) {
+    auto& scheduler = milvus::indexbuilder::BuildScheduler::GetInstance();
+    scheduler.SetBudget(100);
+    std::atomic<bool> admitted = false;
+    std::thread waiting;
+    {
+        auto first = scheduler.Admit(60);
+        auto second = scheduler.Admit(40);
+        ASSERT_EQ(scheduler.Used(), 100);
+        waiting = std::thread([&] {
+            auto third = scheduler.Admit(50);
+            admitted = true;
+        });
+        while (scheduler.Queued() == 0) {
+            std::this_thread::yield();
+        }
+        ASSERT_FALSE(admitted);
+    }
+    waiting.join();
+    ASSERT_TRUE(admitted);
+    ASSERT_EQ(scheduler.Used(), 0);
+    ASSERT_EQ(scheduler.Queued(), 0);
+    scheduler.SetBudget(0);
+}
+
 TEST(CBoolIndexTest, All) {
     schemapb::BoolArray half;
     knowhere::DataSetPtr half_ds;
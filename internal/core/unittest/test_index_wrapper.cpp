@@ -162,3 +162,31 @@ TEST_P(IndexWrapperTest, BuildAndQuery) {
         EXPECT_EQ(result->seg_offsets_[0], query_offset);
     }
 }
+
+TEST(IndexWrapper, BuildDevice) {
+    auto storage_config = get_default_storage_config();
+    auto create = [&](const std::string& build_device) {
+        auto [type_params, index_params] = generate_params(
+            knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, knowhere::metric::L2);
+        auto param = index_params.add_params();
+        param->set_key(milvus::index::BUILD_DEVICE);
+        param->set_value(build_device);
+        std::string type_params_str, index_params_str;
+        google::protobuf::TextFormat::PrintToString(type_params,
+                                                    &type_params_str);
+        google::protobuf::TextFormat::PrintToString(index_params,
+                                                    &index_params_str);
+        return milvus::indexbuilder::IndexFactory::GetInstance().CreateIndex(
+            CDataType::FloatVector,
+            type_params_str.c_str(),
+            index_params_str.c_str(),
+            storage_config);
+    };
+    ASSERT_NO_THROW(create("cpu"));
+    ASSERT_ANY_THROW(create("tpu"));
+#ifndef MILVUS_GPU_VERSION
+    ASSERT_ANY_THROW(create("gpu"));
+#else
+    ASSERT_NO_THROW(create("gpu"));
+#endif
+}
@@ -11,6 +11,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
 #include <random>
 #include <string>
@@ -18,7 +20,10 @@
 
 #include "query/SearchBruteForce.h"
 #include "segcore/Reduce.h"
+#include "index/DiskAnnCache.h"
 #include "index/IndexFactory.h"
+#include "index/Meta.h"
+#include "index/Utils.h"
 #include "common/QueryResult.h"
 #include "test_utils/indexbuilder_test_utils.h"
 #include "test_utils/DataGen.h"
@@ -164,8 +169,9 @@ TEST(Indexing, BinaryBruteForce) {
         query_data  //
     };
 
+    auto params = ParseSearchParams(knowhere::Json(), topk, metric_type);
     auto sub_result = query::BruteForceSearch(
-        search_dataset, bin_vec.data(), N, knowhere::Json(), nullptr);
+        search_dataset, bin_vec.data(), N, *params, nullptr);
 
     SearchResult sr;
     sr.total_nq_ = num_queries;
@@ -449,6 +455,45 @@ TEST_P(IndexTest, BuildAndQuery) {
     vec_index->Query(xq_dataset, search_info, nullptr);
 }
 
+TEST_P(IndexTest, LoadWithMmap) {
+    if (index_type == knowhere::IndexEnum::INDEX_DISKANN) {
+        return;
+    }
+    milvus::index::CreateIndexInfo create_index_info;
+    create_index_info.index_type = index_type;
+    create_index_info.metric_type = metric_type;
+    create_index_info.field_type = vec_field_data_type;
+    auto index = milvus::index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr);
+    ASSERT_NO_THROW(index->BuildWithDataset(xb_dataset, build_conf));
+    auto binary_set = index->Serialize(milvus::Config{});
+    index.reset();
+
+    auto new_index = milvus::index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr);
+    auto vec_index = dynamic_cast<milvus::index::VectorIndex*>(new_index.get());
+    auto mmap_dir = std::filesystem::temp_directory_path() / "test_mmap_index";
+    auto filepath = mmap_dir / index_type;
+    load_conf[milvus::index::MMAP_FILE_PATH] = filepath.string();
+    vec_index->Load(binary_set, load_conf);
+    // the file is unlinked once it is mapped
+    EXPECT_FALSE(std::filesystem::exists(filepath));
+    std::filesystem::remove_all(mmap_dir);
+    EXPECT_EQ(vec_index->GetDim(), DIM);
+    EXPECT_EQ(vec_index->Count(), NB);
+
+    milvus::SearchInfo search_info;
+    search_info.topk_ = K;
+    search_info.metric_type_ = metric_type;
+    search_info.search_params_ = search_conf;
+    auto result = vec_index->Query(xq_dataset, search_info, nullptr);
+    EXPECT_EQ(result->total_nq_, NQ);
+    EXPECT_EQ(result->seg_offsets_.size(), NQ * K);
+    if (!is_binary) {
+        EXPECT_EQ(result->seg_offsets_[0], query_offset);
+    }
+}
+
 TEST_P(IndexTest, GetVector) {
     milvus::index::CreateIndexInfo create_index_info;
     create_index_info.index_type = index_type;
@@ -604,3 +649,97 @@ TEST_P(IndexTest, GetVector) {
 //     // vec_index->Query(xq_dataset, search_info, nullptr);
 // }
 // #endif
+
+TEST(Indexing, NMIndexRawData) {
+    int64_t N = 5000;
+    int64_t dim = 16;
+    auto conf =
+        knowhere::Json{{knowhere::meta::METRIC_TYPE, knowhere::metric::L2},
+                       {knowhere::meta::DIM, std::to_string(dim)},
+                       {knowhere::indexparam::NLIST, "16"},
+                       {knowhere::meta::DEVICE_ID, 0}};
+    std::vector<float> raw(N * dim);
+    std::default_random_engine e(42);
+    std::normal_distribution<float> dis(0, 1);
+    std::generate(raw.begin(), raw.end(), [&] { return dis(e); });
+
+    auto check_vectors = [&](const milvus::index::VectorIndex& index) {
+        ASSERT_TRUE(index.HasRawData());
+        auto ids_ds = GenRandomIds(N);
+        auto vectors = index.GetVector(ids_ds);
+        ASSERT_EQ(vectors.size(), N * dim * sizeof(float));
+        auto data = reinterpret_cast<const float*>(vectors.data());
+        for (int64_t i = 0; i < N; ++i) {
+            auto id = ids_ds->GetIds()[i];
+            ASSERT_EQ(memcmp(data + i * dim,
+                             raw.data() + id * dim,
+                             dim * sizeof(float)),
+                      0);
+        }
+    };
+
+    // the built index reads the vectors of the caller
+    milvus::index::VectorMemNMIndex index(
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, knowhere::metric::L2);
+    index.BuildWithBorrowedDataset(knowhere::GenDataSet(N, dim, raw.data()),
+                                   conf);
+    check_vectors(index);
+
+    // the loaded one the raw data binary
+    auto binary_set = index.Serialize(conf);
+    milvus::index::VectorMemNMIndex loaded(
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, knowhere::metric::L2);
+    loaded.Load(binary_set, conf);
+    check_vectors(loaded);
+}
+
+TEST(Indexing, GpuIndexTypes) {
+    ASSERT_TRUE(milvus::index::is_in_gpu_list("GPU_IVF_FLAT"));
+    ASSERT_TRUE(milvus::index::is_in_gpu_list("GPU_IVF_PQ"));
+    ASSERT_FALSE(milvus::index::is_in_gpu_list(
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT));
+
+#ifndef MILVUS_GPU_VERSION
+    milvus::index::CreateIndexInfo create_index_info;
+    create_index_info.field_type = DataType::VECTOR_FLOAT;
+    create_index_info.metric_type = knowhere::metric::L2;
+    create_index_info.index_type = "GPU_IVF_FLAT";
+    ASSERT_ANY_THROW(milvus::index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr));
+#endif
+}
+
+TEST(Indexing, DiskAnnCacheBudget) {
+    auto& manager = milvus::index::DiskAnnCacheManager::GetInstance();
+    manager.SetBudget(1000, 3600 * 1000);
+    {
+        // both fit the budget until the second asks for more than is left
+        auto cold = manager.Acquire(300);
+        auto hot = manager.Acquire(800);
+        ASSERT_EQ(300, cold->granted());
+        ASSERT_EQ(700, hot->granted());
+        ASSERT_EQ(1000, manager.GrantedBytes());
+
+        // the searched index gets most of the budget, capped by what it
+        // asks for, the cold one what's left
+        hot->RecordSearch(1000);
+        manager.Rebalance();
+        ASSERT_EQ(800, hot->target());
+        ASSERT_EQ(200, cold->target());
+        ASSERT_EQ(700, hot->granted());
+
+        // a new index is granted only what the loaded ones leave
+        auto late = manager.Acquire(500);
+        ASSERT_EQ(0, late->granted());
+        ASSERT_GT(late->target(), 0);
+        cold.reset();
+        ASSERT_EQ(700, manager.GrantedBytes());
+        ASSERT_EQ(2, manager.NumIndexes());
+    }
+    ASSERT_EQ(0, manager.GrantedBytes());
+
+    // without a budget every index is granted what it asks for
+    manager.SetBudget(0, 0);
+    auto index = manager.Acquire(1 << 20);
+    ASSERT_EQ(1 << 20, index->granted());
+}
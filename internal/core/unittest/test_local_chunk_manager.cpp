@@ -250,3 +250,51 @@ TEST_F(LocalChunkManagerTest, GetSizeOfDir) {
     exist = lcm.DirExist(test_dir);
     EXPECT_EQ(exist, false);
 }
+
+TEST_F(LocalChunkManagerTest, BatchReadWrite) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    string test_dir = lcm.GetPathPrefix() + "/local-test-dir";
+
+    string file = test_dir + "/test-batch-read-write";
+    lcm.CreateFile(file);
+
+    const int slices = 16;
+    const int slice_size = 1000;
+    vector<uint8_t> data(slices * slice_size);
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = i % 251;
+    }
+    vector<LocalFileRange> ranges;
+    for (int i = 0; i < slices; ++i) {
+        ranges.push_back({uint64_t(i * slice_size),
+                          data.data() + i * slice_size,
+                          uint64_t(slice_size)});
+    }
+    lcm.WriteBatch(file, ranges);
+    EXPECT_EQ(lcm.Size(file), data.size());
+
+    vector<uint8_t> read_data(data.size());
+    for (int i = 0; i < slices; ++i) {
+        ranges[i].buf = read_data.data() + i * slice_size;
+    }
+    // a range past the end of the file reads nothing
+    uint8_t tail[10];
+    ranges.push_back({uint64_t(data.size()), tail, sizeof(tail)});
+    auto sizes = lcm.ReadBatch(file, ranges);
+    for (int i = 0; i < slices; ++i) {
+        EXPECT_EQ(sizes[i], slice_size);
+    }
+    EXPECT_EQ(sizes.back(), 0);
+    EXPECT_EQ(read_data, data);
+
+    // a recreated file isn't served from the open file of the removed one
+    lcm.Remove(file);
+    lcm.CreateFile(file);
+    lcm.WriteAsync(file, 0, data.data(), 5).get();
+    EXPECT_EQ(lcm.ReadAsync(file, 0, read_data.data(), 10).get(), 5);
+    EXPECT_EQ(lcm.Size(file), 5);
+
+    lcm.RemoveDir(test_dir);
+    auto exist = lcm.DirExist(test_dir);
+    EXPECT_EQ(exist, false);
+}
@@ -0,0 +1,109 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "log/Log.h"
+
+using namespace milvus::log;
+
+namespace {
+
+// keeps the segcore messages glog writes
+class CaptureSink : public google::LogSink {
+ public:
+    void
+    send(google::LogSeverity severity,
+         const char* full_filename,
+         const char* base_filename,
+         int line,
+         const struct ::tm* tm_time,
+         const char* message,
+         size_t message_len) override {
+        std::string text(message, message_len);
+        if (text.find("[SEGCORE]") == std::string::npos) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.emplace_back(severity, std::move(text));
+    }
+
+    std::vector<std::pair<google::LogSeverity, std::string>>
+    messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+ private:
+    std::mutex mutex_;
+    std::vector<std::pair<google::LogSeverity, std::string>> messages_;
+};
+
+}  // namespace
+
+TEST(AsyncLog, WritesThroughGlog) {
+    CaptureSink sink;
+    google::AddLogSink(&sink);
+    LOG_SEGCORE_WARNING_ << "async warning " << 42;
+    if (true)
+        LOG_SEGCORE_ERROR_ << "async error";
+    else
+        LOG_SEGCORE_ERROR_ << "never";
+    AsyncLogger::GetInstance().Flush();
+    google::RemoveLogSink(&sink);
+
+    auto messages = sink.messages();
+    ASSERT_EQ(messages.size(), 2);
+    ASSERT_EQ(messages[0].first, google::GLOG_WARNING);
+    ASSERT_NE(messages[0].second.find("[TestBody]"), std::string::npos);
+    ASSERT_NE(messages[0].second.find("async warning 42"), std::string::npos);
+    ASSERT_EQ(messages[1].first, google::GLOG_ERROR);
+    ASSERT_NE(messages[1].second.find("async error"), std::string::npos);
+}
+
+TEST(AsyncLog, SiteRateLimit) {
+    auto origin = GetSiteRateLimit();
+    SetSiteRateLimit(3);
+    LogSite site;
+    int admitted = 0;
+    for (int i = 0; i < 20; ++i) {
+        admitted += site.Admit(Level::WARNING);
+    }
+    // the loop may cross into another second
+    ASSERT_GE(admitted, 3);
+    ASSERT_LE(admitted, 6);
+    ASSERT_EQ(site.TakeSuppressed(), 20 - admitted);
+    ASSERT_EQ(site.TakeSuppressed(), 0);
+    ASSERT_TRUE(site.Admit(Level::FATAL));
+
+    SetSiteRateLimit(0);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(site.Admit(Level::WARNING));
+    }
+    SetSiteRateLimit(origin);
+}
+
+TEST(AsyncLog, TruncatesLongMessages) {
+    CaptureSink sink;
+    google::AddLogSink(&sink);
+    LOG_SEGCORE_WARNING_ << std::string(AsyncLogger::kMaxMessageSize * 2, 'x');
+    AsyncLogger::GetInstance().Flush();
+    google::RemoveLogSink(&sink);
+
+    auto messages = sink.messages();
+    ASSERT_EQ(messages.size(), 1);
+    ASSERT_LE(messages[0].second.size(), AsyncLogger::kMaxMessageSize);
+}
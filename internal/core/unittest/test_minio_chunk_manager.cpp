@@ -10,6 +10,7 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -221,6 +222,56 @@ TEST_F(MinioChunkManagerTest, ReadPositive) {
     chunk_manager_->DeleteBucket(testBucketName);
 }
 
+TEST_F(MinioChunkManagerTest, ReadRangesPositive) {
+    string testBucketName = "test-read-ranges";
+    chunk_manager_->SetBucketName(testBucketName);
+    EXPECT_EQ(chunk_manager_->GetBucketName(), testBucketName);
+
+    if (!chunk_manager_->BucketExists(testBucketName)) {
+        chunk_manager_->CreateBucket(testBucketName);
+    }
+    std::vector<uint8_t> data(1000 * 1000 + 7);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 31);
+    }
+    string path = "1/4/7";
+    chunk_manager_->Write(path, data.data(), data.size());
+
+    uint8_t readdata[5] = {0};
+    auto size = chunk_manager_->Read(path, 3, readdata, sizeof(readdata));
+    EXPECT_EQ(size, sizeof(readdata));
+    for (size_t i = 0; i < sizeof(readdata); ++i) {
+        EXPECT_EQ(readdata[i], data[3 + i]);
+    }
+
+    std::vector<uint8_t> buffer(data.size());
+    std::atomic<uint64_t> received = 0;
+    std::atomic<int64_t> num_ranges = 0;
+    size = chunk_manager_->ReadRanges(
+        path,
+        buffer.data(),
+        buffer.size(),
+        64 * 1024,
+        4,
+        [&](uint64_t offset, uint64_t len) {
+            received += len;
+            num_ranges++;
+        });
+    EXPECT_EQ(size, data.size());
+    EXPECT_EQ(received, data.size());
+    EXPECT_EQ(num_ranges, (data.size() + 64 * 1024 - 1) / (64 * 1024));
+    EXPECT_EQ(buffer, data);
+
+    // the last range runs past the end of the object, its response is short
+    buffer.resize(data.size() + 100);
+    EXPECT_THROW(chunk_manager_->ReadRanges(
+                     path, buffer.data(), buffer.size(), 64 * 1024, 4),
+                 S3ErrorException);
+
+    chunk_manager_->Remove(path);
+    chunk_manager_->DeleteBucket(testBucketName);
+}
+
 TEST_F(MinioChunkManagerTest, RemovePositive) {
     string testBucketName = "test-remove";
     chunk_manager_->SetBucketName(testBucketName);
@@ -324,3 +375,25 @@ TEST_F(AliyunChunkManagerTest, ReadPositive) {
 
     chunk_manager_->Remove(path);
 }
+
+TEST_F(MinioChunkManagerTest, SharedClient) {
+    // the manager of the test registered the client of its config
+    auto& registry = S3ClientRegistry::GetInstance();
+    auto size = registry.Size();
+    ASSERT_GE(size, 1);
+
+    auto storage_config = get_default_storage_config();
+    MinioChunkManager same(storage_config);
+    ASSERT_EQ(registry.Size(), size);
+    storage_config.bucket_name = "another-bucket";
+    MinioChunkManager other(storage_config);
+    ASSERT_EQ(registry.Size(), size + 1);
+
+    // managers keep their clients once the registry is cleared
+    registry.Clear();
+    ASSERT_EQ(registry.Size(), 0);
+    MinioChunkManager again(get_default_storage_config());
+    ASSERT_EQ(registry.Size(), 1);
+    ASSERT_EQ(same.BucketExists(same.GetBucketName()),
+              again.BucketExists(again.GetBucketName()));
+}
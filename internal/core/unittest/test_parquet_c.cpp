@@ -15,7 +15,10 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
+#include <numeric>
+#include <parquet/file_reader.h>
 
 #include "storage/parquet_c.h"
 #include "storage/PayloadReader.h"
@@ -422,3 +425,112 @@ TEST(storage, int8_2) {
     ASSERT_EQ(bool_array->Value(2), -100);
     ASSERT_EQ(bool_array->Value(3), 100);
 }
+
+static std::vector<parquet::Encoding::type>
+GetColumnEncodings(const std::vector<uint8_t>& payload) {
+    auto buffer = std::make_shared<arrow::io::BufferReader>(
+        payload.data(), int64_t(payload.size()));
+    auto reader = parquet::ParquetFileReader::Open(buffer);
+    return reader->metadata()->RowGroup(0)->ColumnChunk(0)->encodings();
+}
+
+TEST(storage, encoding_policy) {
+    auto has_encoding = [](const std::vector<parquet::Encoding::type>& all,
+                           parquet::Encoding::type encoding) {
+        return std::find(all.begin(), all.end(), encoding) != all.end();
+    };
+
+    // sorted int64 such as timestamps are delta encoded
+    std::vector<int64_t> timestamps(1000);
+    std::iota(timestamps.begin(), timestamps.end(), 1000);
+    wrapper::PayloadWriter sorted_writer(milvus::DataType::INT64);
+    sorted_writer.add_payload(
+        {milvus::DataType::INT64,
+         reinterpret_cast<const uint8_t*>(timestamps.data()),
+         int(timestamps.size())});
+    sorted_writer.finish();
+    auto encodings = GetColumnEncodings(sorted_writer.get_payload_buffer());
+    ASSERT_TRUE(
+        has_encoding(encodings, parquet::Encoding::DELTA_BINARY_PACKED));
+
+    auto& buffer = sorted_writer.get_payload_buffer();
+    wrapper::PayloadReader reader(
+        buffer.data(), int(buffer.size()), milvus::DataType::INT64);
+    auto field_data = reader.get_field_data();
+    ASSERT_EQ(field_data->get_num_rows(), timestamps.size());
+    for (int i = 0; i < timestamps.size(); ++i) {
+        ASSERT_EQ(*static_cast<const int64_t*>(field_data->RawValue(i)),
+                  timestamps[i]);
+    }
+
+    // unsorted ones keep the dictionary
+    std::reverse(timestamps.begin(), timestamps.end());
+    wrapper::PayloadWriter unsorted_writer(milvus::DataType::INT64);
+    unsorted_writer.add_payload(
+        {milvus::DataType::INT64,
+         reinterpret_cast<const uint8_t*>(timestamps.data()),
+         int(timestamps.size())});
+    unsorted_writer.finish();
+    encodings = GetColumnEncodings(unsorted_writer.get_payload_buffer());
+    ASSERT_FALSE(
+        has_encoding(encodings, parquet::Encoding::DELTA_BINARY_PACKED));
+
+    // a policy set by the caller replaces the default one
+    std::vector<float> values(1000);
+    std::iota(values.begin(), values.end(), 0.5f);
+    wrapper::PayloadWriter float_writer(milvus::DataType::FLOAT);
+    wrapper::PayloadEncodingPolicy policy;
+    policy.dictionary = false;
+    policy.encoding = parquet::Encoding::BYTE_STREAM_SPLIT;
+    float_writer.set_encoding_policy(policy);
+    float_writer.add_payload({milvus::DataType::FLOAT,
+                              reinterpret_cast<const uint8_t*>(values.data()),
+                              int(values.size())});
+    float_writer.finish();
+    encodings = GetColumnEncodings(float_writer.get_payload_buffer());
+    ASSERT_TRUE(has_encoding(encodings, parquet::Encoding::BYTE_STREAM_SPLIT));
+}
+
+TEST(storage, read_payloads_into) {
+    const int dim = 4;
+    const int payloads = 3;
+    const int rows = 1000;
+    std::vector<float> vectors(payloads * rows * dim);
+    std::iota(vectors.begin(), vectors.end(), 0.0f);
+
+    std::vector<std::unique_ptr<wrapper::PayloadWriter>> writers;
+    std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> inputs;
+    for (int i = 0; i < payloads; ++i) {
+        auto writer = std::make_unique<wrapper::PayloadWriter>(
+            milvus::DataType::VECTOR_FLOAT, dim);
+        writer->add_payload(
+            {milvus::DataType::VECTOR_FLOAT,
+             reinterpret_cast<const uint8_t*>(vectors.data() +
+                                              i * rows * dim),
+             rows,
+             dim});
+        writer->finish();
+        auto& buffer = writer->get_payload_buffer();
+        inputs.push_back(std::make_shared<wrapper::PayloadInputStream>(
+            buffer.data(), buffer.size()));
+        writers.push_back(std::move(writer));
+    }
+    ASSERT_EQ(wrapper::GetPayloadRows(inputs[0]), rows);
+
+    std::vector<float> decoded(vectors.size());
+    auto decoded_rows =
+        wrapper::ReadPayloadsInto(inputs,
+                                  milvus::DataType::VECTOR_FLOAT,
+                                  dim,
+                                  decoded.data(),
+                                  payloads * rows);
+    ASSERT_EQ(decoded_rows, payloads * rows);
+    ASSERT_EQ(decoded, vectors);
+
+    // a destination too small for the payloads is refused
+    ASSERT_ANY_THROW(wrapper::ReadPayloadsInto(inputs,
+                                               milvus::DataType::VECTOR_FLOAT,
+                                               dim,
+                                               decoded.data(),
+                                               rows));
+}
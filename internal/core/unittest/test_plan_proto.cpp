@@ -12,6 +12,7 @@
 #include <boost/format.hpp>
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
+#include <numeric>
 #include <queue>
 #include <random>
 #include <vector>
@@ -688,3 +689,149 @@ TEST(PlanProtoTest, Predicates) {
     ASSERT_TRUE(plan->plan_node_->predicate_.has_value());
     ASSERT_FALSE(plan->plan_node_->is_count);
 }
+
+TEST(PlanProtoTest, ParsePlaceholderGroup) {
+    auto schema = getStandardSchema();
+    auto vec_fid = schema->get_field_id(FieldName("FloatVectorField"));
+    auto plan_text = boost::str(boost::format(R"(vector_anns: <
+        field_id: %1%
+        query_info: <
+            topk: 10
+            metric_type: "L2"
+            search_params: "{\"nprobe\": 10}"
+        >
+        placeholder_tag: "$0"
+    >)") % vec_fid.get());
+    planpb::PlanNode plan_node;
+    ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(plan_text,
+                                                              &plan_node));
+    auto binary_plan = plan_node.SerializeAsString();
+    auto plan =
+        CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+
+    int64_t num_queries = 10;
+    proto::common::PlaceholderGroup raw_group;
+    auto value = raw_group.add_placeholders();
+    value->set_tag("$0");
+    value->set_type(proto::common::PlaceholderType::FloatVector);
+    std::vector<float> vectors(num_queries * 16);
+    std::iota(vectors.begin(), vectors.end(), 0);
+    for (int64_t i = 0; i < num_queries; ++i) {
+        value->add_values(vectors.data() + i * 16, 16 * sizeof(float));
+    }
+    auto blob = raw_group.SerializeAsString();
+
+    auto group = ParsePlaceholderGroup(plan.get(), blob);
+    ASSERT_EQ(group->size(), 1);
+    auto& placeholder = group->at(0);
+    ASSERT_EQ(placeholder.tag_, "$0");
+    ASSERT_EQ(placeholder.num_of_queries_, num_queries);
+    ASSERT_EQ(placeholder.line_sizeof_, 16 * sizeof(float));
+    ASSERT_EQ(std::vector<float>(
+                  placeholder.get_blob<float>(),
+                  placeholder.get_blob<float>() + vectors.size()),
+              vectors);
+
+    // vectors of the wrong dimension and truncated blobs are rejected
+    value->add_values(vectors.data(), 8 * sizeof(float));
+    ASSERT_ANY_THROW(
+        ParsePlaceholderGroup(plan.get(), raw_group.SerializeAsString()));
+    ASSERT_ANY_THROW(ParsePlaceholderGroup(
+        plan.get(), std::string_view(blob.data(), blob.size() - 1)));
+}
+
+TEST(PlanProtoTest, ParseSearchParams) {
+    auto schema = getStandardSchema();
+    auto vec_fid = schema->get_field_id(FieldName("FloatVectorField"));
+    auto make_plan = [&](const std::string& search_params) {
+        auto plan_text = boost::str(boost::format(R"(vector_anns: <
+            field_id: %1%
+            query_info: <
+                topk: 10
+                metric_type: "L2"
+                search_params: "%2%"
+            >
+            placeholder_tag: "$0"
+        >)") % vec_fid.get() % search_params);
+        planpb::PlanNode plan_node;
+        auto parsed = google::protobuf::TextFormat::ParseFromString(
+            plan_text, &plan_node);
+        AssertInfo(parsed, "invalid plan text");
+        auto binary_plan = plan_node.SerializeAsString();
+        return CreateSearchPlanByExpr(
+            *schema, binary_plan.data(), binary_plan.size());
+    };
+
+    // parsed once with the plan, with the topk and the metric type
+    auto plan = make_plan(
+        R"({\"nprobe\": 10, \"radius\": 5, \"range_filter\": 1})");
+    auto& params = plan->plan_node_->search_info_.parsed_params_;
+    ASSERT_NE(params, nullptr);
+    ASSERT_TRUE(params->is_range_search());
+    ASSERT_EQ(params->radius_.value(), 5);
+    ASSERT_EQ(params->range_filter_.value(), 1);
+    ASSERT_EQ(params->search_conf_["nprobe"], 10);
+    ASSERT_EQ(params->search_conf_[knowhere::meta::TOPK], 10);
+    ASSERT_EQ(params->search_conf_[knowhere::meta::METRIC_TYPE], "L2");
+    ASSERT_FALSE(params->brute_force_conf_.contains("nprobe"));
+    ASSERT_EQ(params->brute_force_conf_[RADIUS], 5);
+    ASSERT_EQ(GetSearchParams(plan->plan_node_->search_info_), params);
+
+    plan = make_plan(R"({\"nprobe\": 10})");
+    ASSERT_FALSE(
+        plan->plan_node_->search_info_.parsed_params_->is_range_search());
+
+    // invalid params fail the plan instead of every search
+    ASSERT_ANY_THROW(make_plan(R"({\"radius\": \"far\"})"));
+    ASSERT_ANY_THROW(make_plan(R"({\"radius\": 1, \"range_filter\": 5})"));
+}
+
+TEST(PlanProtoTest, ParseAdaptive) {
+    auto schema = getStandardSchema();
+    auto vec_fid = schema->get_field_id(FieldName("FloatVectorField"));
+    auto make_plan = [&](const std::string& search_params) {
+        auto plan_text = boost::str(boost::format(R"(vector_anns: <
+            field_id: %1%
+            query_info: <
+                topk: 10
+                metric_type: "L2"
+                search_params: "%2%"
+            >
+            placeholder_tag: "$0"
+        >)") % vec_fid.get() % search_params);
+        planpb::PlanNode plan_node;
+        auto parsed = google::protobuf::TextFormat::ParseFromString(
+            plan_text, &plan_node);
+        AssertInfo(parsed, "invalid plan text");
+        auto binary_plan = plan_node.SerializeAsString();
+        return CreateSearchPlanByExpr(
+            *schema, binary_plan.data(), binary_plan.size());
+    };
+
+    auto plan = make_plan(R"({\"nprobe\": 10})");
+    ASSERT_FALSE(plan->plan_node_->search_info_.adaptive_.has_value());
+
+    // the target is moved out of the params the index sees
+    plan = make_plan(
+        R"({\"nprobe\": 10, \"adaptive_recall\": \"high\", )"
+        R"(\"latency_budget_ms\": 5})");
+    auto& search_info = plan->plan_node_->search_info_;
+    ASSERT_TRUE(search_info.adaptive_.has_value());
+    ASSERT_EQ(search_info.adaptive_->recall_tier_, RecallTier::HIGH);
+    ASSERT_EQ(search_info.adaptive_->latency_budget_ms_, 5);
+    ASSERT_FALSE(search_info.search_params_.contains(ADAPTIVE_RECALL));
+    ASSERT_FALSE(search_info.search_params_.contains(LATENCY_BUDGET_MS));
+    ASSERT_FALSE(
+        search_info.parsed_params_->search_conf_.contains(ADAPTIVE_RECALL));
+
+    plan = make_plan(R"({\"adaptive_recall\": \"low\"})");
+    ASSERT_EQ(plan->plan_node_->search_info_.adaptive_->recall_tier_,
+              RecallTier::LOW);
+    ASSERT_EQ(plan->plan_node_->search_info_.adaptive_->latency_budget_ms_, 0);
+
+    ASSERT_ANY_THROW(make_plan(R"({\"adaptive_recall\": \"best\"})"));
+    ASSERT_ANY_THROW(make_plan(R"({\"adaptive_recall\": 1})"));
+    ASSERT_ANY_THROW(make_plan(
+        R"({\"adaptive_recall\": \"low\", \"latency_budget_ms\": -1})"));
+    ASSERT_ANY_THROW(make_plan(R"({\"latency_budget_ms\": 5})"));
+}
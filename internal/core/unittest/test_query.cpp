@@ -10,11 +10,15 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <boost/format.hpp>
+#include <algorithm>
 
 #include "pb/schema.pb.h"
 #include "query/Expr.h"
+#include "query/Fusion.h"
 #include "query/PlanImpl.h"
 #include "query/PlanNode.h"
+#include "query/Selection.h"
 #include "query/generated/ExecPlanNodeVisitor.h"
 #include "query/generated/ExprVisitor.h"
 #include "query/generated/ShowPlanNodeVisitor.h"
@@ -788,7 +792,7 @@ TEST(Query, FillSegment) {
         ASSERT_EQ(output_i32_field_data.size(), topk * num_queries);
 
         for (int i = 0; i < topk * num_queries; i++) {
-            int64_t val = std::get<int64_t>(result->primary_keys_[i]);
+            int64_t val = result->int64_pks_[i];
 
             auto internal_offset = result->seg_offsets_[i];
             auto std_val = std_vec[internal_offset];
@@ -878,3 +882,259 @@ TEST(Query, ExecWithPredicateBinary) {
     std::cout << json.dump(2);
     // ASSERT_EQ(json.dump(2), ref.dump(2));
 }
+
+TEST(Query, Selection) {
+    int64_t N = 1000;
+    BitsetType filtered(N);
+    filtered.set();
+    std::vector<int64_t> survivors{0, 63, 64, 500, 999};
+    for (auto offset : survivors) {
+        filtered.reset(offset);
+    }
+    Selection sparse{BitsetType(filtered)};
+    ASSERT_TRUE(sparse.is_sparse());
+    ASSERT_EQ(sparse.size(), N);
+    ASSERT_EQ(sparse.count(), int64_t(survivors.size()));
+    ASSERT_EQ(sparse.offsets(), survivors);
+    ASSERT_EQ(sparse.bitset(), filtered);
+
+    filtered.reset();
+    Selection dense{BitsetType(filtered)};
+    ASSERT_FALSE(dense.is_sparse());
+    ASSERT_EQ(dense.count(), N);
+    ASSERT_EQ(dense.bitset(), filtered);
+}
+
+TEST(Query, ExecWithSparseFilter) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto vec_fid = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+
+    int64_t N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(vec_fid);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    auto sealed = SealedCreator(schema, dataset);
+
+    auto num_queries = 3;
+    auto topk = 5;
+    auto query_ptr = vec_col.data() + 4200 * dim;
+    // the filters leave far fewer rows than the 1/64 of the sparse limit,
+    // the last one fewer than topk
+    for (auto [lower, upper] : std::vector<std::pair<int, int>>{
+             {4200, 4230}, {4200, 4203}}) {
+        auto dsl = boost::format(R"({
+            "bool": {
+                "must": [
+                {
+                    "range": {
+                        "counter": {
+                            "GE": %1%,
+                            "LT": %2%
+                        }
+                    }
+                },
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": %3%,
+                            "round_decimal": -1
+                        }
+                    }
+                }
+                ]
+            }
+        })") % lower % upper % topk;
+        auto plan = CreatePlan(*schema, dsl.str());
+        auto ph_group_raw =
+            CreatePlaceholderGroupFromBlob(num_queries, dim, query_ptr);
+        auto ph_group =
+            ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+        std::vector<const SegmentInternalInterface*> segments{growing.get(),
+                                                             sealed.get()};
+        for (auto segment : segments) {
+            auto sr =
+                segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+            ASSERT_EQ(sr->seg_offsets_.size(), num_queries * topk);
+            for (int q = 0; q < num_queries; ++q) {
+                std::vector<std::pair<float, int64_t>> expected;
+                for (int64_t offset = lower; offset < upper; ++offset) {
+                    float distance = 0;
+                    for (int d = 0; d < dim; ++d) {
+                        auto diff = query_ptr[q * dim + d] -
+                                    vec_col[offset * dim + d];
+                        distance += diff * diff;
+                    }
+                    expected.emplace_back(distance, offset);
+                }
+                std::sort(expected.begin(), expected.end());
+                for (int k = 0; k < topk; ++k) {
+                    auto offset = sr->seg_offsets_[q * topk + k];
+                    if (k >= static_cast<int>(expected.size())) {
+                        ASSERT_EQ(offset, INVALID_SEG_OFFSET);
+                        continue;
+                    }
+                    ASSERT_EQ(offset, expected[k].second);
+                    ASSERT_NEAR(sr->distances_[q * topk + k],
+                                expected[k].first,
+                                1e-3);
+                }
+            }
+        }
+    }
+}
+
+TEST(Query, FuseSearchResults) {
+    auto make_result = [](std::vector<int64_t> offsets,
+                          std::vector<float> distances) {
+        SearchResult result;
+        result.total_nq_ = 1;
+        result.unity_topK_ = offsets.size();
+        result.seg_offsets_ = std::move(offsets);
+        result.distances_ = std::move(distances);
+        return result;
+    };
+    std::vector<SearchResult> results;
+    results.push_back(make_result({1, 2, 3}, {0.1, 0.2, 0.3}));
+    results.push_back(make_result({3, 4, INVALID_SEG_OFFSET}, {0.9, 0.8, 0}));
+    std::vector<MetricType> metric_types{knowhere::metric::L2,
+                                         knowhere::metric::IP};
+
+    // 3 is ranked by both, the ties are broken by offset
+    FusionInfo fusion;
+    fusion.topk_ = 4;
+    fusion.rrf_k_ = 1;
+    auto fused = FuseSearchResults(results, metric_types, fusion);
+    ASSERT_EQ(fused.seg_offsets_, std::vector<int64_t>({3, 1, 2, 4}));
+    ASSERT_FLOAT_EQ(fused.distances_[0], 1.0f / 4 + 1.0f / 2);
+    ASSERT_FLOAT_EQ(fused.distances_[1], 1.0f / 2);
+
+    // the weights of the second field put its rows first
+    fusion.type_ = FusionType::Weighted;
+    fusion.weights_ = {0.1, 1};
+    fusion.topk_ = 5;
+    fused = FuseSearchResults(results, metric_types, fusion);
+    ASSERT_EQ(fused.seg_offsets_,
+              std::vector<int64_t>({3, 4, 1, 2, INVALID_SEG_OFFSET}));
+    ASSERT_FLOAT_EQ(
+        fused.distances_[1],
+        NormalizeDistance(0.8, knowhere::metric::IP));
+}
+
+TEST(Query, MultiVectorSearch) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    schema->AddDebugField(
+        "fakevec2", DataType::VECTOR_FLOAT, 8, knowhere::metric::L2);
+    schema->AddDebugField("age", DataType::FLOAT);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    auto dsl = [](const std::string& field) {
+        return boost::str(boost::format(R"({
+            "bool": {
+                "must": [
+                {
+                    "range": {
+                        "age": {
+                            "GE": -1,
+                            "LT": 1
+                        }
+                    }
+                },
+                {
+                    "vector": {
+                        "%1%": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": 10
+                        }
+                    }
+                }
+                ]
+            }
+        })") % field);
+    };
+    int64_t N = 10000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+
+    auto num_queries = 3;
+    auto plan = CreatePlan(*schema, dsl("fakevec"));
+    auto plan2 = CreatePlan(*schema, dsl("fakevec2"));
+    auto raw_group = CreatePlaceholderGroup(num_queries, 16, 1024);
+    auto raw_group2 = CreatePlaceholderGroup(num_queries, 8, 2048);
+    auto group =
+        ParsePlaceholderGroup(plan.get(), raw_group.SerializeAsString());
+    auto group2 =
+        ParsePlaceholderGroup(plan2.get(), raw_group2.SerializeAsString());
+    Timestamp time = 1000000;
+
+    // the same as fusing the searches of each field
+    std::vector<SearchResult> results;
+    results.push_back(
+        std::move(*segment->Search(plan.get(), group.get(), time)));
+    results.push_back(
+        std::move(*segment->Search(plan2.get(), group2.get(), time)));
+    FusionInfo fusion;
+    auto expected = FuseSearchResults(
+        results, {knowhere::metric::L2, knowhere::metric::L2}, fusion);
+
+    auto internal = dynamic_cast<SegmentInternalInterface*>(segment.get());
+    auto fused = internal->MultiVectorSearch(
+        {plan.get(), plan2.get()}, {group.get(), group2.get()}, fusion, time);
+    ASSERT_EQ(fused->total_nq_, num_queries);
+    ASSERT_EQ(fused->unity_topK_, 10);
+    ASSERT_EQ(fused->seg_offsets_, expected.seg_offsets_);
+    ASSERT_EQ(fused->distances_, expected.distances_);
+    ASSERT_EQ(fused->segment_, (void*)internal);
+
+    // both fields must be filtered alike
+    auto unfiltered = CreatePlan(*schema, R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "fakevec2": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 10
+                    }
+                }
+            }
+            ]
+        }
+    })");
+    ASSERT_ANY_THROW(
+        internal->MultiVectorSearch({plan.get(), unfiltered.get()},
+                                    {group.get(), group2.get()},
+                                    fusion,
+                                    time));
+}
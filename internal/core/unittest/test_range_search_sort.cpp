@@ -180,3 +180,16 @@ TEST_P(RangeSearchSortTest, CheckRangeSearchSort) {
     delete[] p_id;
     delete[] p_dist;
 }
+
+TEST_P(RangeSearchSortTest, CheckRangeSearchSortParallel) {
+    // enough results for the queries to be sorted in parallel
+    int64_t nq = 1000;
+    auto large = GenRangeSearchResult(
+        nullptr, nullptr, nullptr, nq, id_min, id_max, dist_min, dist_max);
+    auto res = milvus::SortRangeSearchResult(large, TOPK, nq, metric_type);
+    auto [real_num, p_id, p_dist] =
+        RangeSearchSortResultBF(large, TOPK, nq, metric_type);
+    CheckRangeSearchSortResult(p_id, p_dist, res, real_num);
+    delete[] p_id;
+    delete[] p_dist;
+}
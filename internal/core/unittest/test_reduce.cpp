@@ -16,6 +16,7 @@
 
 #include "knowhere/comp/index_param.h"
 #include "query/SubSearchResult.h"
+#include "segcore/ReduceStructure.h"
 
 using namespace milvus;
 using namespace milvus::query;
@@ -133,3 +134,122 @@ TEST(Reduce, SubSearchResult) {
     TestSubSearchResultMerge<queue_type_ip>(knowhere::metric::IP, 4, 16, 1);
     TestSubSearchResultMerge<queue_type_ip>(knowhere::metric::IP, 4, 16, 10);
 }
+
+template <class queue_type>
+void
+TestSubSearchResultMergeMany(const knowhere::MetricType& metric_type,
+                             const int64_t iteration,
+                             const int64_t nq,
+                             const int64_t topk) {
+    const int64_t round_decimal = 3;
+
+    std::vector<queue_type> result_ref(nq);
+
+    SubSearchResult final_result(nq, topk, metric_type, round_decimal);
+    SubSearchResult chained_result(nq, topk, metric_type, round_decimal);
+    std::vector<SubSearchResult> sub_results;
+    for (int i = 0; i < iteration; ++i) {
+        SubSearchResultUniq sub_result =
+            GenSubSearchResult(nq, topk, metric_type, round_decimal);
+        auto ids = sub_result->get_ids();
+        for (int n = 0; n < nq; ++n) {
+            for (int k = 0; k < topk; ++k) {
+                int64_t x = ids[n * topk + k];
+                result_ref[n].push(x);
+                if (result_ref[n].size() > topk) {
+                    result_ref[n].pop();
+                }
+            }
+        }
+        chained_result.merge(*sub_result);
+        sub_results.push_back(std::move(*sub_result));
+    }
+    final_result.merge_many(sub_results);
+    ASSERT_EQ(final_result.mutable_seg_offsets(),
+              chained_result.mutable_seg_offsets());
+    ASSERT_EQ(final_result.mutable_distances(),
+              chained_result.mutable_distances());
+    CheckSubSearchResult<queue_type>(nq, topk, final_result, result_ref);
+}
+
+TEST(Reduce, SubSearchResultMergeMany) {
+    using queue_type_l2 =
+        std::priority_queue<int64_t, std::vector<int64_t>, std::less<int64_t>>;
+    using queue_type_ip = std::
+        priority_queue<int64_t, std::vector<int64_t>, std::greater<int64_t>>;
+
+    TestSubSearchResultMergeMany<queue_type_l2>(knowhere::metric::L2, 1, 1, 1);
+    TestSubSearchResultMergeMany<queue_type_l2>(knowhere::metric::L2, 4, 16, 10);
+    TestSubSearchResultMergeMany<queue_type_l2>(knowhere::metric::L2, 9, 16, 10);
+
+    TestSubSearchResultMergeMany<queue_type_ip>(knowhere::metric::IP, 1, 1, 1);
+    TestSubSearchResultMergeMany<queue_type_ip>(knowhere::metric::IP, 4, 16, 10);
+    TestSubSearchResultMergeMany<queue_type_ip>(knowhere::metric::IP, 9, 16, 10);
+
+    // results shorter than topk keep the invalid tail
+    SubSearchResult final_result(1, 4, knowhere::metric::L2, -1);
+    std::vector<SubSearchResult> sub_results;
+    for (int i = 0; i < 2; ++i) {
+        sub_results.emplace_back(1, 4, knowhere::metric::L2, -1);
+        sub_results.back().mutable_seg_offsets()[0] = i;
+        sub_results.back().mutable_distances()[0] = 1.0f;
+    }
+    final_result.merge_many(sub_results);
+    std::vector<int64_t> expected_ids{0, 1, -1, -1};
+    ASSERT_EQ(final_result.mutable_seg_offsets(), expected_ids);
+}
+
+TEST(Reduce, LoserTree) {
+    constexpr int64_t num_segments = 37;
+    constexpr int64_t topk = 20;
+    std::vector<SearchResult> results(num_segments);
+    std::vector<float> all_distances;
+    for (int64_t i = 0; i < num_segments; i++) {
+        auto& result = results[i];
+        result.pk_type_ = DataType::INT64;
+        // some segments have no result
+        auto size = int64_t(e() % (topk + 1));
+        for (int64_t k = 0; k < size; ++k) {
+            result.distances_.push_back(float(e() % 1000));
+        }
+        std::sort(result.distances_.begin(),
+                  result.distances_.end(),
+                  std::greater<float>());
+        for (int64_t k = 0; k < size; ++k) {
+            result.int64_pks_.push_back(i * topk + k);
+        }
+        all_distances.insert(all_distances.end(),
+                             result.distances_.begin(),
+                             result.distances_.end());
+    }
+    std::sort(
+        all_distances.begin(), all_distances.end(), std::greater<float>());
+
+    std::vector<SearchResultPair<int64_t>> pairs;
+    for (int64_t i = 0; i < num_segments; i++) {
+        auto& result = results[i];
+        if (result.distances_.empty()) {
+            continue;
+        }
+        pairs.emplace_back(result.int64_pks_[0],
+                           result.distances_[0],
+                           &result,
+                           i,
+                           0,
+                           int64_t(result.distances_.size()));
+    }
+
+    SearchResultLoserTree<SearchResultPair<int64_t>> tree;
+    tree.Build(pairs);
+    std::vector<float> merged;
+    while (auto pilot = tree.Top()) {
+        merged.push_back(pilot->distance_);
+        pilot->advance();
+        tree.Replay();
+    }
+    ASSERT_EQ(merged, all_distances);
+
+    std::vector<SearchResultPair<int64_t>> empty;
+    tree.Build(empty);
+    ASSERT_EQ(tree.Top(), nullptr);
+}
@@ -11,25 +11,24 @@
 
 #include <gtest/gtest.h>
 
-#include "common/Consts.h"
 #include "segcore/ReduceStructure.h"
 
 TEST(SearchResultPair, Greater) {
-    auto pair1 = SearchResultPair(0, 1.0, nullptr, 0, 0, 1);
-    auto pair2 = SearchResultPair(1, 2.0, nullptr, 1, 0, 1);
+    auto pair1 = SearchResultPair<int64_t>(0, 1.0, nullptr, 0, 0, 1);
+    auto pair2 = SearchResultPair<int64_t>(1, 2.0, nullptr, 1, 0, 1);
     ASSERT_EQ(pair1 > pair2, false);
 
     pair2.advance();
     ASSERT_EQ(pair1 > pair2, true);
-    ASSERT_EQ(pair2.primary_key_, INVALID_PK);
+    ASSERT_TRUE(pair2.exhausted());
 }
 
 TEST(SearchResultPair, SameDistance) {
-    auto pair1 = SearchResultPair(0, 1.0, nullptr, 0, 0, 1);
-    auto pair2 = SearchResultPair(1, 1.0, nullptr, 1, 0, 1);
+    auto pair1 = SearchResultPair<int64_t>(0, 1.0, nullptr, 0, 0, 1);
+    auto pair2 = SearchResultPair<int64_t>(1, 1.0, nullptr, 1, 0, 1);
     ASSERT_EQ(pair1 > pair2, true);
 
     pair1.advance();
     ASSERT_EQ(pair2 > pair1, true);
-    ASSERT_EQ(pair1.primary_key_, INVALID_PK);
+    ASSERT_TRUE(pair1.exhausted());
 }
@@ -11,9 +11,13 @@
 
 #include <gtest/gtest.h>
 
+#include <optional>
+
 #include "query/Expr.h"
 #include "query/ExprImpl.h"
+#include "segcore/ReduceRetrieve.h"
 #include "segcore/ScalarIndex.h"
+#include "segcore/SegmentGrowingImpl.h"
 #include "test_utils/DataGen.h"
 
 using namespace milvus;
@@ -415,3 +419,345 @@ TEST(Retrieve, Delete) {
         ASSERT_EQ(field2_data.data_size(), DIM * size);
     }
 }
+
+TEST(Retrieve, Limit) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    schema->AddDebugField(
+        "vector_64", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    // over a few windows the predicate is evaluated over
+    int64_t N = 200000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    int64_t num_deleted = 100;
+    auto del_offset = segment->PreDelete(num_deleted);
+    auto del_pks = GenPKs(num_deleted, 1000);
+    std::vector<Timestamp> del_tss(num_deleted, N);
+    segment->Delete(del_offset, num_deleted, del_pks.get(), del_tss.data());
+
+    auto plan = std::make_unique<query::RetrievePlan>(*schema);
+    plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+    plan->plan_node_->predicate_ =
+        std::make_unique<query::UnaryRangeExprImpl<int64_t>>(
+            query::ColumnInfo(
+                fid_64, DataType::INT64, std::vector<std::string>()),
+            proto::plan::OpType::GreaterEqual,
+            500,
+            proto::plan::GenericValue::kInt64Val);
+    plan->field_ids_ = {fid_64};
+
+    auto retrieve = [&](Timestamp timestamp, int64_t limit) {
+        plan->plan_node_->limit_ = limit;
+        auto results = segment->Retrieve(plan.get(), timestamp);
+        return std::vector<int64_t>(results->offset().begin(),
+                                    results->offset().end());
+    };
+    for (Timestamp timestamp : {Timestamp(N / 3), Timestamp(N + 1)}) {
+        auto all = retrieve(timestamp, -1);
+        for (int64_t limit : {1, 10, 1000, 100000, 1000000}) {
+            auto limited = retrieve(timestamp, limit);
+            auto expected_size = std::min<int64_t>(limit, all.size());
+            ASSERT_EQ(limited,
+                      std::vector<int64_t>(all.begin(),
+                                           all.begin() + expected_size));
+        }
+    }
+}
+
+TEST(Retrieve, Aggregate) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto fid_32 = schema->AddDebugField("i32", DataType::INT32);
+    auto fid_double = schema->AddDebugField("double", DataType::DOUBLE);
+    schema->AddDebugField(
+        "vector_64", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    // the zone maps of the chunks answer when no row is excluded
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto segment = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    int64_t N = 3500;
+    auto dataset = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    int64_t num_deleted = 100;
+    bool deleted = false;
+    auto i32_col = dataset.get_col<int32_t>(fid_32);
+    auto double_col = dataset.get_col<double>(fid_double);
+
+    auto plan = std::make_unique<query::RetrievePlan>(*schema);
+    plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+    plan->plan_node_->is_count = false;
+    using query::AggregateOp;
+    plan->plan_node_->aggregates_ = {{AggregateOp::Count, FieldId(0)},
+                                     {AggregateOp::Min, fid_32},
+                                     {AggregateOp::Max, fid_32},
+                                     {AggregateOp::Sum, fid_32},
+                                     {AggregateOp::Min, fid_double},
+                                     {AggregateOp::Max, fid_double},
+                                     {AggregateOp::Sum, fid_double}};
+    auto set_predicate = [&](proto::plan::OpType op, int64_t value) {
+        plan->plan_node_->predicate_ =
+            std::make_unique<query::UnaryRangeExprImpl<int64_t>>(
+                query::ColumnInfo(
+                    fid_64, DataType::INT64, std::vector<std::string>()),
+                op,
+                value,
+                proto::plan::GenericValue::kInt64Val);
+    };
+
+    // the pk of a row is its offset and its timestamp
+    auto check = [&](Timestamp timestamp, auto included) {
+        int64_t count = 0;
+        int64_t i32_sum = 0;
+        double double_sum = 0;
+        std::optional<int64_t> i32_min, i32_max;
+        std::optional<double> double_min, double_max;
+        auto last = timestamp < Timestamp(N) ? int64_t(timestamp) : N - 1;
+        for (int64_t i = 0; i <= last; ++i) {
+            if (!included(i) ||
+                (deleted && i >= 600 && i < 600 + num_deleted &&
+                 timestamp >= 1000)) {
+                continue;
+            }
+            ++count;
+            i32_sum += i32_col[i];
+            double_sum += double_col[i];
+            i32_min = std::min<int64_t>(i32_min.value_or(i32_col[i]),
+                                        i32_col[i]);
+            i32_max = std::max<int64_t>(i32_max.value_or(i32_col[i]),
+                                        i32_col[i]);
+            double_min = std::min(double_min.value_or(double_col[i]),
+                                  double_col[i]);
+            double_max = std::max(double_max.value_or(double_col[i]),
+                                  double_col[i]);
+        }
+
+        auto results = segment->Retrieve(plan.get(), timestamp);
+        ASSERT_EQ(results->fields_data_size(), 7);
+        auto longs = [&](int i) {
+            auto& data = results->fields_data(i).scalars().long_data().data();
+            return std::vector<int64_t>(data.begin(), data.end());
+        };
+        auto doubles = [&](int i) {
+            auto& data =
+                results->fields_data(i).scalars().double_data().data();
+            return std::vector<double>(data.begin(), data.end());
+        };
+        auto optional_vector = [](auto value) {
+            using T = typename decltype(value)::value_type;
+            return value.has_value() ? std::vector<T>{value.value()}
+                                     : std::vector<T>{};
+        };
+        ASSERT_EQ(longs(0), std::vector<int64_t>{count});
+        ASSERT_EQ(longs(1), optional_vector(i32_min));
+        ASSERT_EQ(longs(2), optional_vector(i32_max));
+        ASSERT_EQ(longs(3), std::vector<int64_t>{i32_sum});
+        ASSERT_EQ(doubles(4), optional_vector(double_min));
+        ASSERT_EQ(doubles(5), optional_vector(double_max));
+        ASSERT_EQ(doubles(6).size(), 1);
+        ASSERT_NEAR(doubles(6)[0], double_sum, 1e-6);
+    };
+
+    check(MAX_TIMESTAMP, [](int64_t) { return true; });
+    auto del_offset = segment->PreDelete(num_deleted);
+    auto del_pks = GenPKs(num_deleted, 600);
+    std::vector<Timestamp> del_tss(num_deleted, 1000);
+    segment->Delete(del_offset, num_deleted, del_pks.get(), del_tss.data());
+    deleted = true;
+    check(MAX_TIMESTAMP, [](int64_t) { return true; });
+    check(N / 2, [](int64_t) { return true; });
+    set_predicate(proto::plan::OpType::GreaterEqual, 500);
+    check(1750, [](int64_t i) { return i >= 500; });
+    set_predicate(proto::plan::OpType::LessThan, 0);
+    check(MAX_TIMESTAMP, [](int64_t) { return false; });
+}
+
+TEST(Retrieve, OrderBy) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto fid_32 = schema->AddDebugField("i32", DataType::INT32);
+    auto fid_str = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->AddDebugField(
+        "vector_64", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    int64_t N = 2500;
+    auto dataset = DataGen(schema, N);
+    auto i32_col = dataset.get_col<int32_t>(fid_32);
+    auto str_col = dataset.get_col<std::string>(fid_str);
+
+    auto conf = SegcoreConfig::default_config();
+    conf.set_chunk_rows(1000);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta, -1, conf);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    // the sorted index of i32 is walked in its order
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *sealed);
+    LoadIndexInfo i32_index;
+    i32_index.field_id = fid_32.get();
+    i32_index.field_type = DataType::INT32;
+    i32_index.index_params["index_type"] = "sort";
+    i32_index.index = GenScalarIndexing<int32_t>(N, i32_col.data());
+    sealed->LoadIndex(i32_index);
+
+    int64_t num_deleted = 100;
+    auto del_pks = GenPKs(num_deleted, 100);
+    std::vector<Timestamp> del_tss(num_deleted, N);
+    for (SegmentInternalInterface* segment :
+         std::vector<SegmentInternalInterface*>{growing.get(),
+                                                sealed.get()}) {
+        auto del_offset = segment->PreDelete(num_deleted);
+        segment->Delete(
+            del_offset, num_deleted, del_pks.get(), del_tss.data());
+    }
+
+    auto plan = std::make_unique<query::RetrievePlan>(*schema);
+    plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+    plan->plan_node_->predicate_ =
+        std::make_unique<query::UnaryRangeExprImpl<int64_t>>(
+            query::ColumnInfo(
+                fid_64, DataType::INT64, std::vector<std::string>()),
+            proto::plan::OpType::GreaterEqual,
+            50,
+            proto::plan::GenericValue::kInt64Val);
+    plan->field_ids_ = {fid_64};
+
+    auto expected_offsets = [&](auto& col, bool descending, int64_t limit) {
+        std::vector<int64_t> offsets;
+        for (int64_t i = 50; i < N; ++i) {
+            if (i < 100 || i >= 100 + num_deleted) {
+                offsets.push_back(i);
+            }
+        }
+        std::stable_sort(
+            offsets.begin(), offsets.end(), [&](int64_t a, int64_t b) {
+                return descending ? col[b] < col[a] : col[a] < col[b];
+            });
+        offsets.resize(std::min<int64_t>(limit, offsets.size()));
+        return offsets;
+    };
+    for (SegmentInternalInterface* segment :
+         std::vector<SegmentInternalInterface*>{growing.get(),
+                                                sealed.get()}) {
+        for (bool descending : {false, true}) {
+            for (int64_t limit : {1, 10, 3000}) {
+                plan->plan_node_->limit_ = limit;
+                auto retrieve = [&](FieldId field_id) {
+                    plan->plan_node_->order_by_ =
+                        query::OrderBy{field_id, descending};
+                    auto results =
+                        segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+                    return std::vector<int64_t>(results->offset().begin(),
+                                                results->offset().end());
+                };
+                ASSERT_EQ(retrieve(fid_32),
+                          expected_offsets(i32_col, descending, limit));
+                ASSERT_EQ(retrieve(fid_str),
+                          expected_offsets(str_col, descending, limit));
+            }
+        }
+    }
+}
+
+TEST(Retrieve, ReduceRetrieveResults) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto fid_float = schema->AddDebugField("float", DataType::FLOAT);
+    int64_t dim = 16;
+    auto fid_vec = schema->AddDebugField(
+        "vector_64", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    // pks 0..99 at timestamps 0..99
+    int64_t N = 100;
+    auto dataset = DataGen(schema, N);
+    auto older = CreateGrowingSegment(schema, empty_index_meta);
+    older->PreInsert(N);
+    older->Insert(0,
+                  N,
+                  dataset.row_ids_.data(),
+                  dataset.timestamps_.data(),
+                  dataset.raw_);
+    auto floats = dataset.get_col<float>(fid_float);
+
+    // pks 0..49 again, descending and later
+    int64_t M = 50;
+    std::vector<int64_t> pks(M);
+    std::vector<float> newer_floats(M);
+    std::vector<float> vecs(M * dim, 1);
+    std::vector<idx_t> row_ids(M);
+    std::vector<Timestamp> tss(M, 1000);
+    for (int64_t i = 0; i < M; ++i) {
+        pks[i] = M - 1 - i;
+        newer_floats[i] = 1000 + pks[i];
+        row_ids[i] = N + i;
+    }
+    std::vector<InsertColumn> columns{
+        {fid_64, pks.data()},
+        {fid_float, newer_floats.data()},
+        {fid_vec, vecs.data()},
+    };
+    auto newer = CreateGrowingSegment(schema, empty_index_meta);
+    newer->PreInsert(M);
+    newer->InsertColumns(0, M, row_ids.data(), tss.data(), columns);
+
+    auto plan = std::make_unique<query::RetrievePlan>(*schema);
+    plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+    plan->plan_node_->predicate_ =
+        std::make_unique<query::UnaryRangeExprImpl<int64_t>>(
+            query::ColumnInfo(
+                fid_64, DataType::INT64, std::vector<std::string>()),
+            proto::plan::OpType::GreaterEqual,
+            0,
+            proto::plan::GenericValue::kInt64Val);
+    plan->field_ids_ = {fid_float, fid_64, fid_vec};
+
+    std::vector<const SegmentInterface*> segments{older.get(), newer.get()};
+    for (int64_t limit : {-1, 30}) {
+        plan->plan_node_->limit_ = limit;
+        auto results = ReduceRetrieveResults(segments, plan.get(), 2000);
+        auto size = limit > 0 ? limit : N;
+        // ascending pks, each from its latest row
+        auto& ids = results->ids().int_id().data();
+        ASSERT_EQ(ids.size(), size);
+        ASSERT_EQ(results->fields_data_size(), 3);
+        auto& float_data = results->fields_data(0).scalars().float_data();
+        auto& pk_data = results->fields_data(1).scalars().long_data();
+        auto& vec_data = results->fields_data(2).vectors().float_vector();
+        ASSERT_EQ(vec_data.data_size(), size * dim);
+        for (int64_t i = 0; i < size; ++i) {
+            ASSERT_EQ(ids[i], i);
+            ASSERT_EQ(pk_data.data(i), i);
+            auto expected = i < M ? 1000 + i : floats[i];
+            ASSERT_EQ(float_data.data(i), expected) << i;
+        }
+    }
+
+    // the newer rows aren't visible yet
+    plan->plan_node_->limit_ = -1;
+    auto results = ReduceRetrieveResults(segments, plan.get(), 500);
+    auto& float_data = results->fields_data(0).scalars().float_data();
+    ASSERT_EQ(float_data.data_size(), N);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(float_data.data(i), floats[i]);
+    }
+}
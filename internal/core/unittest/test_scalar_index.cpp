@@ -10,9 +10,15 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
 
+#include "index/BitmapIndex.h"
 #include "index/IndexFactory.h"
+#include "index/Meta.h"
+#include "index/ScalarIndexSort.h"
 #include "common/CDataType.h"
+#include "common/Common.h"
 #include "test_utils/indexbuilder_test_utils.h"
 #include "test_utils/AssertUtils.h"
 
@@ -131,6 +137,44 @@ TYPED_TEST_P(TypedScalarIndexTest, Reverse) {
     }
 }
 
+TYPED_TEST_P(TypedScalarIndexTest, BatchedReverse) {
+    using T = TypeParam;
+    auto dtype = milvus::GetDType<T>();
+    auto index_types = GetIndexTypes<T>();
+    // shuffled offsets with duplicates, twice the rows, so the second
+    // lookup decodes the rows
+    std::vector<int64_t> offsets;
+    for (int64_t i = 0; i < nb; ++i) {
+        offsets.push_back((i * 37) % nb);
+        offsets.push_back((i * 11) % nb);
+    }
+    milvus::SetReverseLookupCacheFactor(3);
+    for (const auto& index_type : index_types) {
+        milvus::index::CreateIndexInfo create_index_info;
+        create_index_info.field_type = milvus::DataType(dtype);
+        create_index_info.index_type = index_type;
+        auto index =
+            milvus::index::IndexFactory::GetInstance().CreateScalarIndex(
+                create_index_info);
+        auto scalar_index =
+            dynamic_cast<milvus::index::ScalarIndex<T>*>(index.get());
+        auto arr = GenArr<T>(nb);
+        scalar_index->Build(nb, arr.data());
+        for (int round = 0; round < 2; ++round) {
+            std::vector<T> values(offsets.size());
+            scalar_index->ReverseLookup(
+                offsets.data(), offsets.size(), values.data());
+            for (size_t i = 0; i < offsets.size(); ++i) {
+                ASSERT_EQ(arr[offsets[i]], values[i]);
+            }
+        }
+        int64_t out_of_range = nb;
+        T value;
+        ASSERT_ANY_THROW(scalar_index->ReverseLookup(&out_of_range, 1, &value));
+    }
+    milvus::SetReverseLookupCacheFactor(DEFAULT_REVERSE_LOOKUP_CACHE_FACTOR);
+}
+
 TYPED_TEST_P(TypedScalarIndexTest, Range) {
     using T = TypeParam;
     auto dtype = milvus::GetDType<T>();
@@ -150,6 +194,95 @@ TYPED_TEST_P(TypedScalarIndexTest, Range) {
     }
 }
 
+TYPED_TEST_P(TypedScalarIndexTest, CountRange) {
+    using T = TypeParam;
+    auto dtype = milvus::GetDType<T>();
+    auto index_types = GetIndexTypes<T>();
+    for (const auto& index_type : index_types) {
+        milvus::index::CreateIndexInfo create_index_info;
+        create_index_info.field_type = milvus::DataType(dtype);
+        create_index_info.index_type = index_type;
+        auto index =
+            milvus::index::IndexFactory::GetInstance().CreateScalarIndex(
+                create_index_info);
+        auto scalar_index =
+            dynamic_cast<milvus::index::ScalarIndex<T>*>(index.get());
+        auto arr = GenArr<T>(nb);
+        scalar_index->Build(nb, arr.data());
+
+        auto count = [](const milvus::TargetBitmap& bitmap) {
+            return std::count(bitmap.begin(), bitmap.end(), true);
+        };
+        std::vector<T> values{arr[0], arr[nb / 2], arr[0]};
+        ASSERT_EQ(scalar_index->CountIn(values.size(), values.data()),
+                  count(scalar_index->In(values.size(), values.data())));
+        auto value = arr[nb / 2];
+        for (auto op : {milvus::OpType::LessThan,
+                        milvus::OpType::LessEqual,
+                        milvus::OpType::GreaterThan,
+                        milvus::OpType::GreaterEqual}) {
+            ASSERT_EQ(scalar_index->CountRange(value, op),
+                      count(scalar_index->Range(value, op)));
+        }
+        auto lower = std::min(arr[0], arr[nb - 1]);
+        auto upper = std::max(arr[0], arr[nb - 1]);
+        for (auto lb_inclusive : {false, true}) {
+            for (auto ub_inclusive : {false, true}) {
+                ASSERT_EQ(
+                    scalar_index->CountRange(
+                        lower, lb_inclusive, upper, ub_inclusive),
+                    count(scalar_index->Range(
+                        lower, lb_inclusive, upper, ub_inclusive)));
+            }
+        }
+    }
+}
+
+TYPED_TEST_P(TypedScalarIndexTest, PackedBits) {
+    using T = TypeParam;
+    auto dtype = milvus::GetDType<T>();
+    auto index_types = GetIndexTypes<T>();
+    auto assert_same = [](const milvus::TargetBitmap& expected,
+                          const milvus::BitsetType& bits) {
+        ASSERT_EQ(expected.size(), bits.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i], bits[i]);
+        }
+    };
+    for (const auto& index_type : index_types) {
+        milvus::index::CreateIndexInfo create_index_info;
+        create_index_info.field_type = milvus::DataType(dtype);
+        create_index_info.index_type = index_type;
+        auto index =
+            milvus::index::IndexFactory::GetInstance().CreateScalarIndex(
+                create_index_info);
+        auto scalar_index =
+            dynamic_cast<milvus::index::ScalarIndex<T>*>(index.get());
+        auto arr = GenArr<T>(nb);
+        scalar_index->Build(nb, arr.data());
+        for (auto i : {size_t(0), arr.size() / 3, arr.size() - 1}) {
+            auto val = arr[i];
+            assert_same(scalar_index->In(1, &val),
+                        scalar_index->InBits(1, &val));
+            assert_same(scalar_index->NotIn(1, &val),
+                        scalar_index->NotInBits(1, &val));
+            for (auto op : {milvus::OpType::LessThan,
+                            milvus::OpType::LessEqual,
+                            milvus::OpType::GreaterThan,
+                            milvus::OpType::GreaterEqual}) {
+                assert_same(scalar_index->Range(val, op),
+                            scalar_index->RangeBits(val, op));
+            }
+            for (auto inclusive : {true, false}) {
+                assert_same(
+                    scalar_index->Range(arr[0], inclusive, val, !inclusive),
+                    scalar_index->RangeBits(
+                        arr[0], inclusive, val, !inclusive));
+            }
+        }
+    }
+}
+
 TYPED_TEST_P(TypedScalarIndexTest, Codec) {
     using T = TypeParam;
     auto dtype = milvus::GetDType<T>();
@@ -181,6 +314,136 @@ TYPED_TEST_P(TypedScalarIndexTest, Codec) {
     }
 }
 
+TEST(ScalarIndexSort, ParallelBuild) {
+    milvus::SetIndexBuildParallelism(4);
+    // more rows than the tasks take, with duplicates and negative values
+    int64_t n = MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK * 5 + 7;
+    std::vector<int64_t> arr(n);
+    for (int64_t i = 0; i < n; ++i) {
+        arr[i] = (i * 7919) % 10007 - 5000;
+    }
+    milvus::index::ScalarIndexSort<int64_t> index;
+    index.Build(n, arr.data());
+    ASSERT_EQ(n, index.Count());
+
+    auto& data = index.GetData();
+    for (int64_t i = 1; i < n; ++i) {
+        ASSERT_LE(data[i - 1].a_, data[i].a_);
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQ(arr[i], index.Reverse_Lookup(i));
+    }
+    auto bitset = index.Range(0, milvus::OpType::GreaterEqual);
+    for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQ(arr[i] >= 0, bitset[i]);
+    }
+    milvus::SetIndexBuildParallelism(DEFAULT_INDEX_BUILD_PARALLELISM);
+}
+
+TEST(ScalarIndexSort, ExtremeOffset) {
+    std::vector<int64_t> arr{3, -1, 7, 7, 2, 5};
+    milvus::index::ScalarIndexSort<int64_t> index;
+    index.Build(arr.size(), arr.data());
+
+    milvus::BitsetType excluded(arr.size());
+    ASSERT_EQ(1, index.ExtremeOffset(excluded, false));
+    ASSERT_EQ(7, arr[index.ExtremeOffset(excluded, true)]);
+    excluded.set(1);
+    excluded.set(2);
+    excluded.set(3);
+    ASSERT_EQ(4, index.ExtremeOffset(excluded, false));
+    ASSERT_EQ(5, index.ExtremeOffset(excluded, true));
+    // the rows past the bitset aren't considered
+    excluded.resize(2);
+    ASSERT_EQ(0, index.ExtremeOffset(excluded, true));
+    excluded.set(0);
+    ASSERT_EQ(-1, index.ExtremeOffset(excluded, false));
+}
+
+TEST(ScalarIndexSort, CompactFormat) {
+    int64_t n = 10000;
+    std::vector<int64_t> arr(n);
+    for (int64_t i = 0; i < n; ++i) {
+        arr[i] = 1700000000000 + (i * 7919) % 100000;
+    }
+    milvus::index::ScalarIndexSort<int64_t> index;
+    index.Build(n, arr.data());
+    auto binary_set = index.Serialize({});
+    // 17 bits per value and 32 bits per row id instead of 16 bytes a row
+    auto size = binary_set.GetByName(milvus::index::SORTED_INDEX_DATA)->size;
+    ASSERT_LT(size, n * 8);
+
+    milvus::index::ScalarIndexSort<int64_t> copy_index;
+    copy_index.Load(binary_set);
+    ASSERT_EQ(n, copy_index.Count());
+    for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQ(arr[i], copy_index.Reverse_Lookup(i));
+    }
+}
+
+TEST(ScalarIndexSort, LoadLegacyFormat) {
+    int64_t n = 100;
+    std::vector<milvus::index::IndexStructure<int32_t>> data;
+    for (int64_t i = 0; i < n; ++i) {
+        data.emplace_back(int32_t(i / 2), n - 1 - i);
+    }
+    auto data_size = n * sizeof(milvus::index::IndexStructure<int32_t>);
+    std::shared_ptr<uint8_t[]> index_data(new uint8_t[data_size]);
+    memcpy(index_data.get(), data.data(), data_size);
+    std::shared_ptr<uint8_t[]> index_length(new uint8_t[sizeof(size_t)]);
+    size_t length = n;
+    memcpy(index_length.get(), &length, sizeof(size_t));
+    milvus::BinarySet binary_set;
+    binary_set.Append("index_data", index_data, data_size);
+    binary_set.Append("index_length", index_length, sizeof(size_t));
+
+    milvus::index::ScalarIndexSort<int32_t> index;
+    index.Load(binary_set);
+    ASSERT_EQ(n, index.Count());
+    for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQ((n - 1 - i) / 2, index.Reverse_Lookup(i));
+    }
+}
+
+TEST(BitmapIndex, LowCardinality) {
+    int64_t n = 10000;
+    std::vector<int32_t> arr(n);
+    for (int64_t i = 0; i < n; ++i) {
+        // a value with a sparse posting besides the dense ones
+        arr[i] = i % 100 == 0 ? -1 : int32_t(i % 3);
+    }
+    milvus::index::BitmapIndex<int32_t> index;
+    index.Build(n, arr.data());
+    ASSERT_EQ(n, index.Count());
+    ASSERT_EQ(4, index.Cardinality());
+
+    auto binary_set = index.Serialize({});
+    auto size = binary_set.GetByName(milvus::index::BITMAP_INDEX_DATA)->size;
+    ASSERT_LT(size, n);
+
+    milvus::index::BitmapIndex<int32_t> copy_index;
+    copy_index.Load(binary_set);
+    ASSERT_EQ(n, copy_index.Count());
+    std::vector<int32_t> values{-1, 2, 5};
+    auto in = copy_index.In(values.size(), values.data());
+    auto range = copy_index.Range(0, milvus::OpType::GreaterThan);
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQ(arr[i], copy_index.Reverse_Lookup(i));
+        ASSERT_EQ(arr[i] == -1 || arr[i] == 2, in[i]);
+        ASSERT_EQ(arr[i] > 0, range[i]);
+        count += in[i];
+    }
+    ASSERT_EQ(count, copy_index.CountIn(values.size(), values.data()));
+}
+
+TEST(BitmapIndex, TooManyValues) {
+    std::vector<int64_t> arr(BITMAP_INDEX_MAX_CARDINALITY + 1);
+    std::iota(arr.begin(), arr.end(), 0);
+    milvus::index::BitmapIndex<int64_t> index;
+    ASSERT_ANY_THROW(index.Build(arr.size(), arr.data()));
+}
+
 // TODO: it's easy to overflow for int8_t. Design more reasonable ut.
 using ScalarT =
     ::testing::Types<int8_t, int16_t, int32_t, int64_t, float, double>;
@@ -193,6 +456,9 @@ REGISTER_TYPED_TEST_CASE_P(TypedScalarIndexTest,
                            NotIn,
                            Range,
                            Codec,
-                           Reverse);
+                           Reverse,
+                           BatchedReverse,
+                           CountRange,
+                           PackedBits);
 
 INSTANTIATE_TYPED_TEST_CASE_P(ArithmeticCheck, TypedScalarIndexTest, ScalarT);
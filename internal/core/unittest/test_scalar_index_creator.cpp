@@ -132,6 +132,43 @@ TYPED_TEST_P(TypedScalarIndexCreatorTest, Codec) {
     }
 }
 
+TEST(ScalarIndexCreator, BitmapAutoSelect) {
+    auto build = [](const std::vector<int64_t>& arr, const MapParams& params) {
+        auto type_params = generate_type_params(MapParams());
+        auto index_params = generate_index_params(params);
+        auto creator = milvus::indexbuilder::CreateScalarIndex(
+            milvus::DataType::INT64, type_params.c_str(), index_params.c_str());
+        build_index<int64_t>(creator, arr);
+        auto binary_set = creator->Serialize();
+
+        auto copy_creator = milvus::indexbuilder::CreateScalarIndex(
+            milvus::DataType::INT64, type_params.c_str(), index_params.c_str());
+        copy_creator->Load(binary_set);
+        auto index = dynamic_cast<milvus::index::ScalarIndex<int64_t>*>(
+            copy_creator->index_.get());
+        for (size_t i = 0; i < arr.size(); ++i) {
+            EXPECT_EQ(arr[i], index->Reverse_Lookup(i));
+        }
+        return binary_set.Contains(milvus::index::BITMAP_INDEX_META);
+    };
+
+    std::vector<int64_t> low(nb);
+    std::vector<int64_t> high(nb);
+    for (int64_t i = 0; i < nb; ++i) {
+        low[i] = i % 5;
+        high[i] = i;
+    }
+    MapParams sort_params{{"index_type", milvus::index::ASCENDING_SORT}};
+    ASSERT_TRUE(build(low, sort_params));
+    ASSERT_FALSE(build(high, sort_params));
+    ASSERT_FALSE(build(low,
+                       {{"index_type", milvus::index::ASCENDING_SORT},
+                        {milvus::index::BITMAP_CARDINALITY_LIMIT, "0"}}));
+    ASSERT_FALSE(build(low, {{"index_type", "inverted_index"}}));
+    ASSERT_TRUE(
+        build(high, {{"index_type", milvus::index::BITMAP_INDEX_TYPE}}));
+}
+
 REGISTER_TYPED_TEST_CASE_P(TypedScalarIndexCreatorTest,
                            Dummy,
                            Constructor,
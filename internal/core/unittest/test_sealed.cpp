@@ -11,11 +11,40 @@
 
 #include <gtest/gtest.h>
 #include <boost/format.hpp>
-
+#include <fmt/core.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+
+#include "common/ColumnCache.h"
+#include "common/FieldSketch.h"
+#include "common/Metrics.h"
 #include "common/Types.h"
+#include "segcore/LoadResource.h"
+#include "segcore/PkStats.h"
+#include "segcore/Profiler.h"
+#include "segcore/RcuDomain.h"
+#include "segcore/SearchResultCache.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/SegmentSealedImpl.h"
+#include "segcore/segment_c.h"
+#include "storage/FieldData.h"
+#include "storage/FieldDataFactory.h"
+#include "storage/InsertData.h"
 #include "test_utils/DataGen.h"
+#include "test_utils/MemChunkManager.h"
 #include "index/IndexFactory.h"
+#include "index/Meta.h"
+#include "index/Utils.h"
+#include "query/AdaptiveSearch.h"
 
 using namespace milvus;
 using namespace milvus::query;
@@ -250,6 +279,214 @@ TEST(Sealed, with_predicate) {
     }
 }
 
+TEST(Sealed, SearchTinyFilterOnIndex) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto topK = 5;
+    auto fake_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "range": {
+                    "counter": {
+                        "GE": 4200,
+                        "LT": 4300
+                    }
+                }
+            },
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": -1
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fake_id);
+    auto query_ptr = vec_col.data() + BIAS * dim;
+    auto plan = CreatePlan(*schema, dsl);
+    auto num_queries = 5;
+    auto ph_group_raw =
+        CreatePlaceholderGroupFromBlob(num_queries, 16, query_ptr);
+    auto ph_group =
+        ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    milvus::index::CreateIndexInfo create_index_info;
+    create_index_info.field_type = DataType::VECTOR_FLOAT;
+    create_index_info.metric_type = knowhere::metric::L2;
+    create_index_info.index_type = knowhere::IndexEnum::INDEX_FAISS_IVFFLAT;
+    auto indexing = milvus::index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr);
+    auto build_conf =
+        knowhere::Json{{knowhere::meta::METRIC_TYPE, knowhere::metric::L2},
+                       {knowhere::meta::DIM, std::to_string(dim)},
+                       {knowhere::indexparam::NLIST, "100"}};
+    auto database = knowhere::GenDataSet(N, dim, vec_col.data());
+    indexing->BuildWithDataset(database, build_conf);
+
+    LoadIndexInfo load_info;
+    load_info.field_id = fake_id.get();
+    load_info.index = std::move(indexing);
+    load_info.index_params["metric_type"] = "L2";
+
+    // the raw vectors are dropped, the 100 rows left by the filter are
+    // gathered from the index
+    auto sealed_segment = SealedCreator(schema, dataset);
+    sealed_segment->DropFieldData(fake_id);
+    sealed_segment->LoadIndex(load_info);
+
+    auto& config = SegcoreConfig::default_config();
+    auto threshold = config.get_brute_force_threshold();
+    ASSERT_GE(threshold, 100);
+    auto sr =
+        sealed_segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    for (int i = 0; i < num_queries; ++i) {
+        std::vector<std::pair<float, int64_t>> expected;
+        for (int64_t offset = 4200; offset < 4300; ++offset) {
+            float distance = 0;
+            for (int d = 0; d < dim; ++d) {
+                auto diff =
+                    query_ptr[i * dim + d] - vec_col[offset * dim + d];
+                distance += diff * diff;
+            }
+            expected.emplace_back(distance, offset);
+        }
+        std::sort(expected.begin(), expected.end());
+        for (int k = 0; k < topK; ++k) {
+            ASSERT_EQ(sr->seg_offsets_[i * topK + k], expected[k].second);
+            ASSERT_NEAR(sr->distances_[i * topK + k], expected[k].first, 1e-3);
+        }
+    }
+
+    // above the threshold the filtered index search runs
+    auto density = config.get_brute_force_density();
+    config.set_brute_force_threshold(0);
+    config.set_brute_force_density(0);
+    sr = sealed_segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_brute_force_threshold(threshold);
+    config.set_brute_force_density(density);
+    for (int i = 0; i < num_queries; ++i) {
+        auto offset = i * topK;
+        ASSERT_EQ(sr->seg_offsets_[offset], BIAS + i);
+        ASSERT_EQ(sr->distances_[offset], 0.0);
+    }
+}
+TEST(Sealed, SearchDenseFilterOnIndex) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto topK = 5;
+    auto fake_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    // leaves 99% of the rows
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "range": {
+                    "counter": {
+                        "GE": 100
+                    }
+                }
+            },
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 100
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": -1
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fake_id);
+    auto plan = CreatePlan(*schema, dsl);
+    plan->plan_node_->search_info_.profile_ = true;
+    // the queries are rows filtered out, and rows left by the filter
+    auto num_queries = 4;
+    std::vector<float> queries(vec_col.begin() + 50 * dim,
+                               vec_col.begin() + 52 * dim);
+    queries.insert(queries.end(),
+                   vec_col.begin() + BIAS * dim,
+                   vec_col.begin() + (BIAS + 2) * dim);
+    auto ph_group_raw =
+        CreatePlaceholderGroupFromBlob(num_queries, dim, queries.data());
+    auto ph_group =
+        ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    milvus::index::CreateIndexInfo create_index_info;
+    create_index_info.field_type = DataType::VECTOR_FLOAT;
+    create_index_info.metric_type = knowhere::metric::L2;
+    create_index_info.index_type = knowhere::IndexEnum::INDEX_FAISS_IVFFLAT;
+    auto indexing = milvus::index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr);
+    auto build_conf =
+        knowhere::Json{{knowhere::meta::METRIC_TYPE, knowhere::metric::L2},
+                       {knowhere::meta::DIM, std::to_string(dim)},
+                       {knowhere::indexparam::NLIST, "100"}};
+    indexing->BuildWithDataset(knowhere::GenDataSet(N, dim, vec_col.data()),
+                               build_conf);
+    LoadIndexInfo load_info;
+    load_info.field_id = fake_id.get();
+    load_info.index = std::move(indexing);
+    load_info.index_params["metric_type"] = "L2";
+    auto sealed_segment = SealedCreator(schema, dataset);
+    sealed_segment->DropFieldData(fake_id);
+    sealed_segment->LoadIndex(load_info);
+
+    // the index is searched without the filter, the hits filtered out are
+    // dropped
+    auto& config = SegcoreConfig::default_config();
+    ASSERT_LE(config.get_post_filter_density(), 0.99);
+    auto sr =
+        sealed_segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_NE(sr->profile_, nullptr);
+    ASSERT_EQ(sr->profile_->search_path, "post_filter");
+    ASSERT_EQ(sr->seg_offsets_.size(), num_queries * topK);
+    for (auto offset : sr->seg_offsets_) {
+        ASSERT_GE(offset, 100);
+    }
+    ASSERT_EQ(sr->seg_offsets_[2 * topK], BIAS);
+    ASSERT_EQ(sr->seg_offsets_[3 * topK], BIAS + 1);
+
+    // the same hits as the filtered search of the index
+    auto density = config.get_post_filter_density();
+    config.set_post_filter_density(2);
+    auto filtered =
+        sealed_segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_post_filter_density(density);
+    ASSERT_EQ(filtered->profile_->search_path, "vector_search");
+    ASSERT_EQ(filtered->seg_offsets_, sr->seg_offsets_);
+    for (int i = 0; i < num_queries * topK; ++i) {
+        ASSERT_NEAR(filtered->distances_[i], sr->distances_[i], 1e-3);
+    }
+}
+
 TEST(Sealed, with_predicate_filter_all) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -467,6 +704,388 @@ TEST(Sealed, LoadFieldData) {
     ASSERT_ANY_THROW(segment->Search(plan.get(), ph_group.get(), time));
 }
 
+TEST(Sealed, LoadFieldDataFromFieldDatas) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto metric_type = knowhere::metric::L2;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, metric_type);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    auto counters = dataset.get_col<int64_t>(counter_id);
+    auto doubles = dataset.get_col<double>(double_id);
+    auto str_data = dataset.get_col(str_id)->scalars().string_data().data();
+    std::vector<std::string> strs(str_data.begin(), str_data.end());
+
+    // every field is split into two field datas, like two binlogs
+    auto half = N / 2;
+    auto split = [&](auto create, const auto* data, int64_t width) {
+        auto first = create();
+        first->FillFieldData(data, half * width);
+        auto second = create();
+        second->FillFieldData(data + half * width, (N - half) * width);
+        return std::vector<storage::FieldDataPtr>{first, second};
+    };
+    auto load = [&](SegmentSealed& segment,
+                    FieldId field_id,
+                    std::vector<storage::FieldDataPtr> datas,
+                    const char* mmap_dir_path) {
+        FieldDataInfo info{field_id.get(), std::move(datas), N, mmap_dir_path};
+        segment.LoadFieldData(info);
+    };
+
+    for (auto mmap_dir_path : {(const char*)nullptr, "./data/mmap-test"}) {
+        auto segment = CreateSealedSegment(schema);
+        load(*segment,
+             RowFieldID,
+             split(
+                 [] {
+                     return std::make_shared<storage::FieldData<int64_t>>(
+                         DataType::INT64);
+                 },
+                 dataset.row_ids_.data(),
+                 1),
+             nullptr);
+        load(*segment,
+             TimestampFieldID,
+             split(
+                 [] {
+                     return std::make_shared<storage::FieldData<int64_t>>(
+                         DataType::INT64);
+                 },
+                 reinterpret_cast<const int64_t*>(dataset.timestamps_.data()),
+                 1),
+             nullptr);
+        load(*segment,
+             fakevec_id,
+             split(
+                 [&] {
+                     return std::make_shared<storage::FieldData<FloatVector>>(
+                         dim, DataType::VECTOR_FLOAT);
+                 },
+                 fakevec.data(),
+                 dim),
+             mmap_dir_path);
+        load(*segment,
+             counter_id,
+             split(
+                 [] {
+                     return std::make_shared<storage::FieldData<int64_t>>(
+                         DataType::INT64);
+                 },
+                 counters.data(),
+                 1),
+             mmap_dir_path);
+        load(*segment,
+             double_id,
+             split(
+                 [] {
+                     return std::make_shared<storage::FieldData<double>>(
+                         DataType::DOUBLE);
+                 },
+                 doubles.data(),
+                 1),
+             mmap_dir_path);
+        load(*segment,
+             str_id,
+             split(
+                 [] {
+                     return std::make_shared<storage::FieldData<std::string>>(
+                         DataType::VARCHAR);
+                 },
+                 strs.data(),
+                 1),
+             mmap_dir_path);
+
+        ASSERT_EQ(segment->get_row_count(), N);
+        auto vec_span = segment->chunk_data<FloatVector>(fakevec_id, 0);
+        auto counter_span = segment->chunk_data<int64_t>(counter_id, 0);
+        auto double_span = segment->chunk_data<double>(double_id, 0);
+        auto str_span = segment->chunk_data<std::string_view>(str_id, 0);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(counter_span[i], counters[i]);
+            ASSERT_EQ(double_span[i], doubles[i]);
+            ASSERT_EQ(str_span[i], strs[i]);
+        }
+        ASSERT_EQ(memcmp(vec_span.data(),
+                         fakevec.data(),
+                         sizeof(float) * dim * N),
+                  0);
+
+        // pks are indexed, nothing is deleted
+        ASSERT_EQ(segment->get_real_count(), N);
+    }
+}
+
+TEST(Sealed, LoadFieldDatas) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    schema->set_primary_field_id(counter_id);
+
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    auto counters = dataset.get_col<int64_t>(counter_id);
+    auto doubles = dataset.get_col<double>(double_id);
+
+    // every field is written as two binlogs
+    std::vector<std::vector<uint8_t>> binlogs;
+    std::vector<FieldBinlogsInfo> infos;
+    auto half = N / 2;
+    auto write_binlogs = [&](FieldId field_id,
+                             auto create,
+                             const auto* data,
+                             int64_t width) {
+        FieldBinlogsInfo info{field_id.get()};
+        info.row_count = N;
+        std::vector<std::pair<int64_t, int64_t>> ranges{{0, half}, {half, N}};
+        for (auto [begin, end] : ranges) {
+            auto field_data = create();
+            field_data->FillFieldData(data + begin * width,
+                                      (end - begin) * width);
+            storage::InsertData insert_data(field_data);
+            insert_data.SetFieldDataMeta({100, 101, 102, field_id.get()});
+            insert_data.SetTimestamps(0, 100);
+            binlogs.push_back(
+                insert_data.Serialize(storage::StorageType::Remote));
+        }
+        infos.push_back(std::move(info));
+    };
+    auto int64_data = [] {
+        return std::make_shared<storage::FieldData<int64_t>>(DataType::INT64);
+    };
+    write_binlogs(RowFieldID, int64_data, dataset.row_ids_.data(), 1);
+    write_binlogs(TimestampFieldID,
+                  int64_data,
+                  reinterpret_cast<const int64_t*>(dataset.timestamps_.data()),
+                  1);
+    write_binlogs(counter_id, int64_data, counters.data(), 1);
+    write_binlogs(
+        double_id,
+        [] {
+            return std::make_shared<storage::FieldData<double>>(
+                DataType::DOUBLE);
+        },
+        doubles.data(),
+        1);
+    write_binlogs(
+        fakevec_id,
+        [&] {
+            return std::make_shared<storage::FieldData<FloatVector>>(
+                dim, DataType::VECTOR_FLOAT);
+        },
+        fakevec.data(),
+        dim);
+    for (size_t i = 0; i < binlogs.size(); ++i) {
+        auto& info = infos[i / 2];
+        info.binlogs.push_back(binlogs[i].data());
+        info.binlog_sizes.push_back(binlogs[i].size());
+    }
+
+    // no limit, and a budget which lets one field at a time through
+    for (int64_t memory_budget : {0, 1}) {
+        auto segment = CreateSealedSegment(schema);
+        segment->LoadFieldDatas(infos, memory_budget);
+        ASSERT_EQ(segment->get_row_count(), N);
+        auto counter_span = segment->chunk_data<int64_t>(counter_id, 0);
+        auto double_span = segment->chunk_data<double>(double_id, 0);
+        auto vec_span = segment->chunk_data<FloatVector>(fakevec_id, 0);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(counter_span[i], counters[i]);
+            ASSERT_EQ(double_span[i], doubles[i]);
+        }
+        ASSERT_EQ(memcmp(vec_span.data(),
+                         fakevec.data(),
+                         sizeof(float) * dim * N),
+                  0);
+        // pks are indexed, nothing is deleted
+        ASSERT_EQ(segment->get_real_count(), N);
+    }
+
+    // the fields of a segment have the same row count
+    auto mismatched = infos;
+    mismatched.back().row_count = N - 1;
+    auto segment = CreateSealedSegment(schema);
+    ASSERT_ANY_THROW(segment->LoadFieldDatas(mismatched, 0));
+}
+
+TEST(Sealed, LoadFieldDataLazily) {
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+
+    auto dataset = DataGen(schema, N);
+    auto counters = dataset.get_col<int64_t>(counter_id);
+    auto doubles = dataset.get_col<double>(double_id);
+    auto str_data = dataset.get_col(str_id)->scalars().string_data().data();
+    std::vector<std::string> strs(str_data.begin(), str_data.end());
+
+    auto segment = CreateSealedSegment(schema);
+    auto load = [&](FieldId field_id, storage::FieldDataPtr data) {
+        FieldDataInfo info{field_id.get(), {data}, N};
+        segment->LoadFieldData(info);
+    };
+    auto int64_data = [&](const int64_t* values) {
+        auto data =
+            std::make_shared<storage::FieldData<int64_t>>(DataType::INT64);
+        data->FillFieldData(values, N);
+        return data;
+    };
+    load(RowFieldID, int64_data(dataset.row_ids_.data()));
+    load(TimestampFieldID,
+         int64_data(
+             reinterpret_cast<const int64_t*>(dataset.timestamps_.data())));
+    load(counter_id, int64_data(counters.data()));
+
+    // the other fields are written as two binlogs each
+    auto chunk_manager = std::make_shared<storage::MemChunkManager>();
+    auto half = N / 2;
+    auto write_binlogs = [&](FieldId field_id, auto create, const auto* data) {
+        std::vector<std::string> paths;
+        std::vector<std::pair<int64_t, int64_t>> ranges{{0, half}, {half, N}};
+        for (auto [begin, end] : ranges) {
+            auto field_data = create();
+            field_data->FillFieldData(data + begin, end - begin);
+            storage::InsertData insert_data(field_data);
+            insert_data.SetFieldDataMeta({100, 101, 102, field_id.get()});
+            insert_data.SetTimestamps(0, 100);
+            auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+            auto path = std::to_string(field_id.get()) + "/" +
+                        std::to_string(paths.size());
+            chunk_manager->Write(path, bytes.data(), bytes.size());
+            paths.push_back(path);
+        }
+        segment->LoadFieldDataLazily(
+            LazyFieldDataInfo{field_id.get(), paths, N, chunk_manager});
+    };
+    write_binlogs(
+        double_id,
+        [] {
+            return std::make_shared<storage::FieldData<double>>(
+                DataType::DOUBLE);
+        },
+        doubles.data());
+    write_binlogs(
+        str_id,
+        [] {
+            return std::make_shared<storage::FieldData<std::string>>(
+                DataType::VARCHAR);
+        },
+        strs.data());
+
+    // registered fields are ready but nothing is fetched yet
+    ASSERT_TRUE(segment->HasFieldData(double_id));
+    ASSERT_TRUE(segment->HasFieldData(str_id));
+    ASSERT_EQ(chunk_manager->read_bytes_, 0);
+
+    auto double_span = segment->chunk_data<double>(double_id, 0);
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(double_span[i], doubles[i]);
+    }
+    auto double_read_bytes = chunk_manager->read_bytes_.load();
+    ASSERT_GT(double_read_bytes, 0);
+    // a fetched field is cached
+    segment->chunk_data<double>(double_id, 0);
+    ASSERT_EQ(chunk_manager->read_bytes_, double_read_bytes);
+
+    auto str_span = segment->chunk_data<std::string_view>(str_id, 0);
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(str_span[i], strs[i]);
+    }
+
+    // the least recently used field is evicted first
+    int64_t str_bytes = 0;
+    for (auto& str : strs) {
+        str_bytes += str.size();
+    }
+    ASSERT_EQ(segment->EvictLazyFieldData(str_bytes), N * sizeof(double));
+    ASSERT_EQ(segment->EvictLazyFieldData(0), str_bytes);
+    ASSERT_EQ(segment->EvictLazyFieldData(0), 0);
+
+    // an evicted field is fetched again on access
+    chunk_manager->read_bytes_ = 0;
+    double_span = segment->chunk_data<double>(double_id, 0);
+    ASSERT_EQ(chunk_manager->read_bytes_, double_read_bytes);
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(double_span[i], doubles[i]);
+    }
+
+    // the primary key can't be loaded lazily
+    ASSERT_ANY_THROW(segment->LoadFieldDataLazily(
+        LazyFieldDataInfo{counter_id.get(), {}, N, chunk_manager}));
+}
+
+TEST(Sealed, LoadFieldDataLazilyWithColumnCache) {
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+    auto doubles = dataset.get_col<double>(double_id);
+
+    auto chunk_manager = std::make_shared<storage::MemChunkManager>();
+    auto field_data =
+        std::make_shared<storage::FieldData<double>>(DataType::DOUBLE);
+    field_data->FillFieldData(doubles.data(), N);
+    storage::InsertData insert_data(field_data);
+    insert_data.SetFieldDataMeta({100, 101, 102, double_id.get()});
+    insert_data.SetTimestamps(0, 100);
+    auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+    chunk_manager->Write("double/0", bytes.data(), bytes.size());
+
+    auto cache_dir = "./data/column-cache-test";
+    std::filesystem::remove_all(cache_dir);
+    auto& cache = ColumnCache::GetInstance();
+    cache.Init(cache_dir, 1 << 30);
+
+    auto load_doubles = [&]() {
+        auto segment = CreateSealedSegment(schema);
+        segment->LoadFieldDataLazily(
+            LazyFieldDataInfo{double_id.get(), {"double/0"}, N, chunk_manager});
+        auto span = segment->chunk_data<double>(double_id, 0);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(span[i], doubles[i]);
+        }
+    };
+
+    load_doubles();
+    ASSERT_GT(chunk_manager->read_bytes_, 0);
+    ASSERT_EQ(cache.CachedBytes(), N * sizeof(double));
+
+    // a reload maps the cached file without fetching the binlog
+    chunk_manager->read_bytes_ = 0;
+    load_doubles();
+    ASSERT_EQ(chunk_manager->read_bytes_, 0);
+
+    // the files are adopted after a restart, and evicted over the budget
+    cache.Init(cache_dir, 1 << 30);
+    ASSERT_EQ(cache.CachedBytes(), N * sizeof(double));
+    load_doubles();
+    ASSERT_EQ(chunk_manager->read_bytes_, 0);
+    cache.Init(cache_dir, N);
+    ASSERT_EQ(cache.CachedBytes(), 0);
+    load_doubles();
+    ASSERT_GT(chunk_manager->read_bytes_, 0);
+
+    cache.Init(cache_dir, 0);
+    ASSERT_FALSE(cache.Enabled());
+    std::filesystem::remove_all(cache_dir);
+}
+
 TEST(Sealed, LoadFieldDataMmap) {
     auto dim = 16;
     auto topK = 5;
@@ -564,6 +1183,66 @@ TEST(Sealed, LoadFieldDataMmap) {
     ASSERT_ANY_THROW(segment->Search(plan.get(), ph_group.get(), time));
 }
 
+TEST(Sealed, MmapPolicy) {
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+
+    auto vec_policy = DefaultMmapPolicy((*schema)[fakevec_id]);
+    ASSERT_TRUE(vec_policy.populate);
+    ASSERT_TRUE(vec_policy.hugepage);
+    ASSERT_EQ(vec_policy.access, MmapPolicy::Access::Sequential);
+    auto double_policy = DefaultMmapPolicy((*schema)[double_id]);
+    ASSERT_FALSE(double_policy.populate);
+    ASSERT_EQ(double_policy.access, MmapPolicy::Access::Normal);
+    auto str_policy = DefaultMmapPolicy((*schema)[str_id]);
+    ASSERT_FALSE(str_policy.populate);
+    ASSERT_EQ(str_policy.access, MmapPolicy::Access::Random);
+
+    // every policy only changes how the pages are mapped, not the data
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    MmapPolicy hot;
+    hot.hugepage = true;
+    hot.access = MmapPolicy::Access::Random;
+    hot.lock = true;
+    MmapPolicy cold;
+    cold.populate = false;
+    cold.access = MmapPolicy::Access::Sequential;
+    for (auto& policy : {hot, cold}) {
+        for (auto mmap : {false, true}) {
+            auto segment = CreateSealedSegment(schema);
+            SealedLoadFieldData(
+                dataset, *segment, {double_id.get(), str_id.get()});
+            for (auto& field_data : dataset.raw_->fields_data()) {
+                auto field_id = FieldId(field_data.field_id());
+                if (field_id != double_id && field_id != str_id) {
+                    continue;
+                }
+                LoadFieldDataInfo info;
+                info.field_id = field_id.get();
+                info.row_count = N;
+                info.field_data = &field_data;
+                info.mmap_dir_path = mmap ? "./data/mmap-test" : nullptr;
+                info.mmap_policy = policy;
+                segment->LoadFieldData(info);
+            }
+            auto doubles = segment->chunk_data<double>(double_id, 0);
+            auto strs = segment->chunk_data<std::string_view>(str_id, 0);
+            auto ref_doubles = dataset.get_col<double>(double_id);
+            auto ref_strs = dataset.get_col<std::string>(str_id);
+            for (int i = 0; i < N; ++i) {
+                ASSERT_EQ(doubles[i], ref_doubles[i]);
+                ASSERT_EQ(strs[i], ref_strs[i]);
+            }
+        }
+    }
+}
+
 TEST(Sealed, LoadScalarIndex) {
     auto dim = 16;
     auto N = ROW_COUNT;
@@ -851,34 +1530,262 @@ TEST(Sealed, OverlapDelete) {
         << std::endl;
 }
 
-auto
-GenMaxFloatVecs(int N, int dim) {
-    std::vector<float> vecs;
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < dim; j++) {
-            vecs.push_back(std::numeric_limits<float>::max());
-        }
+TEST(Sealed, CompactDeletedRecord) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::VARCHAR);
+    schema->set_primary_field_id(pk_fid);
+    int64_t N = 100;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto pks = dataset.get_col<std::string>(pk_fid);
+
+    // the first 10 rows are deleted at 1000, the next 10 at 2000
+    int64_t row_count = 20;
+    auto ids = std::make_unique<IdArray>();
+    std::vector<Timestamp> timestamps;
+    for (int64_t i = 0; i < row_count; ++i) {
+        ids->mutable_str_id()->add_data(pks[i]);
+        timestamps.push_back(i < 10 ? 1000 : 2000);
     }
-    return vecs;
-}
+    LoadDeletedRecordInfo info = {timestamps.data(), ids.get(), row_count};
+    segment->LoadDeletedRecord(info);
 
-auto
-GenRandomFloatVecs(int N, int dim) {
-    std::vector<float> vecs;
-    srand(time(NULL));
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < dim; j++) {
-            vecs.push_back(static_cast<float>(rand()) /
-                           static_cast<float>(RAND_MAX));
-        }
+    ASSERT_EQ(segment->CompactDeletedRecord(1500), 10);
+    BitsetType bitset(N, false);
+    segment->mask_with_delete(bitset, N, 1500);
+    ASSERT_EQ(bitset.count(), 10);
+    for (int64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(bitset[i]);
     }
-    return vecs;
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, 3000);
+    ASSERT_EQ(bitset.count(), row_count);
+
+    // the string pks of the compacted deletes are released
+    auto bytes = segment->GetMemoryUsage().deletes;
+    ASSERT_EQ(segment->CompactDeletedRecord(3000), row_count);
+    ASSERT_LT(segment->GetMemoryUsage().deletes, bytes);
+    ASSERT_EQ(segment->get_deleted_count(), row_count);
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, 3000);
+    ASSERT_EQ(bitset.count(), row_count);
+
+    // neither an older timestamp nor reloading the deletes undoes it
+    ASSERT_EQ(segment->CompactDeletedRecord(500), row_count);
+    segment->LoadDeletedRecord(info);
+    ASSERT_EQ(segment->get_deleted_count(), row_count);
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, 3000);
+    ASSERT_EQ(bitset.count(), row_count);
 }
 
-auto
-GenQueryVecs(int N, int dim) {
-    std::vector<float> vecs;
-    for (int i = 0; i < N; i++) {
+TEST(Sealed, LoadDeletedRecordFromBinlogs) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    int64_t N = 100;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto pks = dataset.get_col<int64_t>(pk_fid);
+
+    // the first 10 rows are deleted at 1000, the next 10 at 2000 in the
+    // format of older versions by a log listed first; the go side writes
+    // them as delete events, an insert event of the same payload reads
+    // alike
+    auto chunk_manager = std::make_shared<storage::MemChunkManager>();
+    auto write_log = [&](const std::string& path,
+                         const std::vector<std::string>& logs) {
+        auto field_data =
+            std::make_shared<storage::FieldData<std::string>>(
+                DataType::STRING);
+        field_data->FillFieldData(logs.data(), logs.size());
+        storage::InsertData insert_data(field_data);
+        insert_data.SetFieldDataMeta({100, 101, 102, pk_fid.get()});
+        insert_data.SetTimestamps(1000, 2000);
+        auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+        chunk_manager->Write(path, bytes.data(), bytes.size());
+    };
+    std::vector<std::string> older;
+    std::vector<std::string> newer;
+    for (int64_t i = 0; i < 20; ++i) {
+        if (i < 10) {
+            older.push_back(fmt::format(
+                R"({{"pk":{},"ts":1000,"pkType":5}})", pks[i]));
+        } else {
+            newer.push_back(fmt::format("{},2000", pks[i]));
+        }
+    }
+    write_log("delta/0", newer);
+    write_log("delta/1", older);
+    std::vector<std::string> paths{"delta/0", "delta/1"};
+    segment->LoadDeletedRecordFromBinlogs(paths, chunk_manager.get());
+    ASSERT_EQ(segment->get_deleted_count(), 20);
+
+    BitsetType bitset(N, false);
+    segment->mask_with_delete(bitset, N, 3000);
+    ASSERT_EQ(bitset.count(), 20);
+    for (int64_t i = 0; i < 20; ++i) {
+        ASSERT_TRUE(bitset[i]);
+    }
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, 1500);
+    ASSERT_EQ(bitset.count(), 10);
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, 500);
+    ASSERT_EQ(bitset.count(), 0);
+
+    // the deletes loaded before are skipped
+    segment->LoadDeletedRecordFromBinlogs(paths, chunk_manager.get());
+    ASSERT_EQ(segment->get_deleted_count(), 20);
+
+    write_log("delta/2", {"not a delete"});
+    ASSERT_ANY_THROW(segment->LoadDeletedRecordFromBinlogs(
+        {"delta/2"}, chunk_manager.get()));
+}
+
+TEST(Sealed, LoadPkStats) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    int64_t N = 100;
+    auto dataset = DataGen(schema, N);
+    auto pks = dataset.get_col<int64_t>(pk_fid);
+    auto [min, max] = std::minmax_element(pks.begin(), pks.end());
+
+    // the stats log is taken as it is, pks out of its range aren't looked
+    // up even though they are loaded
+    PkBloomFilter filter;
+    for (auto pk : pks) {
+        filter.add(pk);
+    }
+    auto stats = SerializePkStats(N, PkType(*min), PkType(*min), &filter);
+    auto segment = CreateSealedSegment(schema);
+    segment->LoadPkStats(stats.data(), stats.size());
+    SealedLoadFieldData(dataset, *segment);
+
+    auto ids = std::make_unique<IdArray>();
+    ids->mutable_int_id()->add_data(*min);
+    ids->mutable_int_id()->add_data(*max);
+    auto [found, offsets] = segment->search_ids(*ids, MAX_TIMESTAMP);
+    ASSERT_EQ(offsets.size(), 1);
+    ASSERT_EQ(found->int_id().data(0), *min);
+
+    stats = SerializePkStats(N, PkType(*min), PkType(*max), &filter);
+    segment->LoadPkStats(stats.data(), stats.size());
+    std::tie(found, offsets) = segment->search_ids(*ids, MAX_TIMESTAMP);
+    ASSERT_EQ(offsets.size(), 2);
+
+    // truncated or of another pk type
+    ASSERT_ANY_THROW(segment->LoadPkStats(stats.data(), stats.size() - 1));
+    auto string_stats = SerializePkStats(
+        N, PkType(std::string("a")), PkType(std::string("b")), nullptr);
+    ASSERT_ANY_THROW(
+        segment->LoadPkStats(string_stats.data(), string_stats.size()));
+}
+
+TEST(Sealed, LoadFromGrowing) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    auto json_fid = schema->AddDebugField(
+        "json", DataType::JSON, std::vector<std::string>{"/int"});
+    schema->set_primary_field_id(pk_fid);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto growing = CreateGrowingSegment(schema, empty_index_meta);
+    growing->PreInsert(N);
+    growing->Insert(0,
+                    N,
+                    dataset.row_ids_.data(),
+                    dataset.timestamps_.data(),
+                    dataset.raw_);
+    int64_t c = 10;
+    for (int64_t i = 0; i < 2; ++i) {
+        auto offset = growing->PreDelete(c);
+        auto tss = GenTss(c, 2000 + i * 1000);
+        auto pks = GenPKs(c, i * c);
+        ASSERT_TRUE(growing->Delete(offset, c, pks.get(), tss.data()).ok());
+    }
+    // the deletes folded into the bitmap come along with it
+    ASSERT_EQ(growing->CompactDeletedRecord(2500), c);
+
+    auto segment = CreateSealedSegment(schema);
+    segment->LoadFromGrowing(*growing);
+    ASSERT_EQ(segment->get_row_count(), N);
+    ASSERT_EQ(segment->get_real_count(), N - 2 * c);
+    BitsetType bitset(N, false);
+    segment->mask_with_delete(bitset, N, 2500);
+    ASSERT_EQ(bitset.count(), c);
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, MAX_TIMESTAMP);
+    ASSERT_EQ(bitset.count(), 2 * c);
+
+    auto pks = dataset.get_col<int64_t>(pk_fid);
+    auto ids = std::make_unique<IdArray>();
+    ids->mutable_int_id()->add_data(pks[N / 2]);
+    auto [found, offsets] = segment->search_ids(*ids, MAX_TIMESTAMP);
+    ASSERT_EQ(offsets.size(), 1);
+    ASSERT_EQ(offsets[0].get(), N / 2);
+
+    auto vecs = dataset.get_col<float>(vec_fid);
+    auto strs = dataset.get_col<std::string>(str_fid);
+    auto vec_span = segment->chunk_data<FloatVector>(vec_fid, 0);
+    auto str_span = segment->chunk_data<std::string_view>(str_fid, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(str_span[i], strs[i]);
+    }
+    ASSERT_EQ(
+        memcmp(vec_span.data(), vecs.data(), sizeof(float) * 16 * N), 0);
+    // json rows come with the key indexes of their paths
+    auto jsons = dataset.get_col<std::string>(json_fid);
+    auto json_span = segment->chunk_data<Json>(json_fid, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(json_span[i].data(), jsons[i]);
+    }
+    ASSERT_NE(segment->json_key_index(json_fid, "/int"), nullptr);
+
+    // a loaded segment can't take the rows again
+    ASSERT_ANY_THROW(segment->LoadFromGrowing(*growing));
+}
+
+auto
+GenMaxFloatVecs(int N, int dim) {
+    std::vector<float> vecs;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < dim; j++) {
+            vecs.push_back(std::numeric_limits<float>::max());
+        }
+    }
+    return vecs;
+}
+
+auto
+GenRandomFloatVecs(int N, int dim) {
+    std::vector<float> vecs;
+    srand(time(NULL));
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < dim; j++) {
+            vecs.push_back(static_cast<float>(rand()) /
+                           static_cast<float>(RAND_MAX));
+        }
+    }
+    return vecs;
+}
+
+auto
+GenQueryVecs(int N, int dim) {
+    std::vector<float> vecs;
+    for (int i = 0; i < N; i++) {
         for (int j = 0; j < dim; j++) {
             vecs.push_back(1);
         }
@@ -1022,6 +1929,422 @@ TEST(Sealed, DeleteCount) {
     ASSERT_EQ(cnt, c);
 }
 
+TEST(Sealed, RcuDomain) {
+    RcuDomain rcu;
+    std::weak_ptr<int> weak;
+    {
+        auto guard = rcu.Read();
+        auto data = std::make_shared<int>(1);
+        weak = data;
+        rcu.Retire(std::move(data));
+        // a reader which entered before may still see it
+        ASSERT_FALSE(weak.expired());
+    }
+    ASSERT_TRUE(weak.expired());
+
+    // released right away without readers
+    auto data = std::make_shared<int>(2);
+    weak = data;
+    rcu.Retire(std::move(data));
+    ASSERT_TRUE(weak.expired());
+
+    // the readers which entered after it don't hold it
+    std::optional<RcuDomain::ReadGuard> before(rcu.Read());
+    data = std::make_shared<int>(3);
+    weak = data;
+    rcu.Retire(std::move(data));
+    auto after = rcu.Read();
+    ASSERT_FALSE(weak.expired());
+    before.reset();
+    ASSERT_TRUE(weak.expired());
+}
+
+TEST(Sealed, SearchDuringLoads) {
+    auto dim = 16;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    schema->set_primary_field_id(counter_id);
+
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {double_id.get()});
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: 5
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               fakevec_id.get();
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan =
+        CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+    auto ph_group_raw = CreatePlaceholderGroup(3, dim, 1024);
+    auto ph_group =
+        ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto expected = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+
+    // the searches see the segment as it was or with the field, never a
+    // field half loaded or freed under them
+    std::atomic<bool> stop = false;
+    std::atomic<int> mismatches = 0;
+    std::thread searcher([&] {
+        while (!stop) {
+            auto result =
+                segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+            if (result->seg_offsets_ != expected->seg_offsets_) {
+                ++mismatches;
+            }
+        }
+    });
+    for (auto& field_data : dataset.raw_->fields_data()) {
+        if (field_data.field_id() != double_id.get()) {
+            continue;
+        }
+        for (int i = 0; i < 20; ++i) {
+            LoadFieldDataInfo info;
+            info.field_id = field_data.field_id();
+            info.row_count = N;
+            info.field_data = &field_data;
+            segment->LoadFieldData(info);
+            EXPECT_TRUE(segment->HasFieldData(double_id));
+            segment->DropFieldData(double_id);
+            EXPECT_FALSE(segment->HasFieldData(double_id));
+        }
+    }
+    stop = true;
+    searcher.join();
+    ASSERT_EQ(mismatches, 0);
+}
+
+TEST(Sealed, MemoryUsage) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto usage = segment->GetMemoryUsage();
+    ASSERT_EQ(usage.resident_bytes(), segment->GetMemoryUsageInBytes());
+    ASSERT_EQ(usage.mmap_file_bytes(), 0);
+    ASSERT_GE(usage.fields[fakevec_id.get()].raw,
+              int64_t(N * dim * sizeof(float)));
+    ASSERT_GE(usage.fields[counter_id.get()].raw, int64_t(N * sizeof(int64_t)));
+    ASSERT_GE(usage.fields[double_id.get()].raw, int64_t(N * sizeof(double)));
+    ASSERT_GT(usage.fields[str_id.get()].raw, 0);
+    ASSERT_GE(usage.system, int64_t(N * sizeof(Timestamp)));
+    ASSERT_EQ(usage.fields[RowFieldID.get()].raw, int64_t(N * sizeof(idx_t)));
+    ASSERT_GT(usage.pk_map, 0);
+
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.index = GenVecIndexing(N, dim, fakevec.data());
+    vec_info.index_params["metric_type"] = knowhere::metric::L2;
+    segment->LoadIndex(vec_info);
+    ASSERT_GT(segment->GetMemoryUsage().fields[fakevec_id.get()].index, 0);
+
+    // the mapped raw data is reported apart from the resident bytes
+    auto mmap_segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *mmap_segment, {}, true);
+    auto mmap_usage = mmap_segment->GetMemoryUsage();
+    ASSERT_EQ(mmap_usage.fields[double_id.get()].raw, 0);
+    // so are the row ids, which take no memory then
+    ASSERT_EQ(mmap_usage.fields[RowFieldID.get()].raw, 0);
+    ASSERT_EQ(mmap_usage.fields[RowFieldID.get()].mmap_file,
+              int64_t(N * sizeof(idx_t)));
+    ASSERT_GE(mmap_usage.fields[double_id.get()].mmap_file,
+              int64_t(N * sizeof(double)));
+    ASSERT_LT(mmap_usage.resident_bytes(), usage.resident_bytes());
+}
+
+TEST(Sealed, EstimateLoadResource) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto int64_id = schema->AddDebugField("int64", DataType::INT64);
+    auto double_id = schema->AddDebugField("double", DataType::DOUBLE);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto usage = segment->GetMemoryUsage();
+
+    auto estimate = [&](FieldId field_id, int64_t bytes, bool mmap = false) {
+        FieldLoadResourceInfo info;
+        info.field_id = field_id.get();
+        info.row_count = N;
+        info.binlog_bytes = bytes;
+        info.mmap = mmap;
+        return EstimateFieldLoadResource(*schema, info);
+    };
+    auto vec = estimate(fakevec_id, N * dim * sizeof(float));
+    ASSERT_GE(vec.steady_memory_bytes, usage.fields[fakevec_id.get()].raw);
+    // the decoded binlogs are held next to the column
+    ASSERT_GE(vec.peak_memory_bytes,
+              vec.steady_memory_bytes + int64_t(N * dim * sizeof(float)));
+    auto dbl = estimate(double_id, N * sizeof(double));
+    ASSERT_GE(dbl.steady_memory_bytes, usage.fields[double_id.get()].raw);
+    ASSERT_EQ(dbl.steady_disk_bytes, 0);
+
+    // the pk field keeps the pk map next to its column
+    auto pk = estimate(counter_id, N * sizeof(int64_t));
+    auto int64 = estimate(int64_id, N * sizeof(int64_t));
+    ASSERT_GT(pk.steady_memory_bytes, int64.steady_memory_bytes);
+    ASSERT_GT(pk.peak_memory_bytes, int64.peak_memory_bytes);
+
+    // the strings keep a view a row
+    auto strs = dataset.get_col<std::string>(str_id);
+    int64_t str_bytes = 0;
+    for (auto& str : strs) {
+        str_bytes += str.size();
+    }
+    auto str = estimate(str_id, str_bytes);
+    ASSERT_GE(str.steady_memory_bytes,
+              str_bytes + int64_t(N * sizeof(std::string_view)));
+    ASSERT_GT(str.peak_memory_bytes, str.steady_memory_bytes);
+
+    auto timestamps = estimate(TimestampFieldID, N * sizeof(Timestamp));
+    ASSERT_GE(timestamps.steady_memory_bytes, usage.system);
+
+    // the mapped column takes the disk instead, even the row ids
+    auto dbl_mmap = estimate(double_id, N * sizeof(double), true);
+    ASSERT_EQ(dbl_mmap.steady_memory_bytes, 0);
+    ASSERT_EQ(dbl_mmap.steady_disk_bytes, int64_t(N * sizeof(double)));
+    ASSERT_GE(dbl_mmap.peak_memory_bytes, int64_t(N * sizeof(double)));
+    auto row_ids_mmap = estimate(RowFieldID, N * sizeof(idx_t), true);
+    ASSERT_EQ(row_ids_mmap.steady_disk_bytes, int64_t(N * sizeof(idx_t)));
+    ASSERT_EQ(row_ids_mmap.steady_memory_bytes, 0);
+
+    // nothing to load without binlogs nor index
+    auto none = estimate(double_id, 0);
+    ASSERT_EQ(none.peak_memory_bytes, 0);
+    ASSERT_EQ(none.peak_disk_bytes, 0);
+
+    auto total = EstimateLoadResource(
+        *schema,
+        {{fakevec_id.get(), N, int64_t(N * dim * sizeof(float))},
+         {double_id.get(), N, int64_t(N * sizeof(double))}});
+    ASSERT_EQ(total.peak_memory_bytes,
+              vec.peak_memory_bytes + dbl.peak_memory_bytes);
+    ASSERT_EQ(total.steady_memory_bytes,
+              vec.steady_memory_bytes + dbl.steady_memory_bytes);
+
+    // the index files are held until the index has loaded them
+    auto ivf = EstimateIndexLoadResource(
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, 1000, false);
+    ASSERT_EQ(ivf.peak_memory_bytes, 2000);
+    ASSERT_EQ(ivf.steady_memory_bytes, 1000);
+    auto ivf_mmap = EstimateIndexLoadResource(
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, 1000, true);
+    ASSERT_EQ(ivf_mmap.steady_memory_bytes, 0);
+    ASSERT_EQ(ivf_mmap.steady_disk_bytes, 1000);
+    auto diskann = EstimateIndexLoadResource(
+        knowhere::IndexEnum::INDEX_DISKANN, 1000, false);
+    ASSERT_EQ(diskann.peak_memory_bytes, 0);
+    ASSERT_EQ(diskann.steady_disk_bytes, 1000);
+}
+
+TEST(Sealed, LoadResourceBudget) {
+    auto& manager = LoadResourceManager::GetInstance();
+    manager.SetBudget(100, 0);
+    LoadResource load;
+    load.peak_memory_bytes = 60;
+    load.peak_disk_bytes = 1 << 20;
+
+    // the second load waits for the first to release the budget, the disk
+    // has no budget
+    auto first = manager.Acquire(load);
+    std::atomic<bool> admitted = false;
+    std::thread waiter([&] {
+        auto second = manager.Acquire(load);
+        admitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(admitted);
+    ASSERT_EQ(manager.NumLoads(), 1);
+    ASSERT_EQ(manager.InFlightMemoryBytes(), 60);
+    first.reset();
+    waiter.join();
+    ASSERT_TRUE(admitted);
+    ASSERT_EQ(manager.NumLoads(), 0);
+    ASSERT_EQ(manager.InFlightMemoryBytes(), 0);
+
+    // a load over the budget runs once no other does
+    LoadResource huge;
+    huge.peak_memory_bytes = 1000;
+    {
+        auto lease = manager.Acquire(huge);
+        ASSERT_EQ(manager.InFlightMemoryBytes(), 1000);
+    }
+
+    // without a budget every load runs at once
+    manager.SetBudget(0, 0);
+    ASSERT_FALSE(manager.HasBudget());
+    auto a = manager.Acquire(huge);
+    auto b = manager.Acquire(huge);
+    ASSERT_EQ(manager.NumLoads(), 2);
+}
+
+TEST(Sealed, TtlExpiration) {
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto ts_of = [](int64_t physical) {
+        return Timestamp(physical) << CollectionTtl::kLogicalBits;
+    };
+    for (int64_t i = 0; i < N; ++i) {
+        dataset.timestamps_[i] = ts_of(1000 + i);
+    }
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto ttl = std::make_shared<CollectionTtl>();
+    ttl->set_ttl_ms(N / 2);
+    segment->set_ttl(ttl);
+
+    // the first half of the rows is expired at the last of them
+    auto query_ts = ts_of(1000 + N - 1);
+    BitsetType bitset(N);
+    segment->mask_with_timestamps(bitset, query_ts);
+    ASSERT_EQ(bitset.count(), N / 2 - 1);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(bitset[i], i < N / 2 - 1) << "row " << i;
+    }
+    ASSERT_FALSE(segment->IsExpired(query_ts));
+
+    // every row once the last one is expired, the segment answers no rows
+    auto expired_ts = ts_of(1000 + N + N / 2);
+    ASSERT_TRUE(segment->IsExpired(expired_ts));
+    proto::plan::PlanNode plan_node;
+    auto expr = plan_node.mutable_predicates()->mutable_unary_range_expr();
+    auto column_info = expr->mutable_column_info();
+    column_info->set_data_type(proto::schema::DataType::Int64);
+    column_info->set_field_id(counter_id.get());
+    expr->set_op(proto::plan::OpType::GreaterEqual);
+    expr->mutable_value()->set_int64_val(
+        std::numeric_limits<int64_t>::min());
+    auto binary = plan_node.SerializeAsString();
+    auto plan =
+        CreateRetrievePlanByExpr(*schema, binary.data(), binary.size());
+    plan->field_ids_ = {counter_id};
+    auto retrieved = segment->Retrieve(plan.get(), expired_ts);
+    ASSERT_EQ(retrieved->offset_size(), 0);
+    auto kept = segment->Retrieve(plan.get(), query_ts);
+    ASSERT_EQ(kept->offset_size(), N - (N / 2 - 1));
+
+    // a cached search doesn't serve the rows expired since
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: 5
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               fakevec_id.get();
+    auto search_plan_text = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(search_plan_text.data());
+    auto search_plan =
+        CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+    auto ph_group_raw = CreatePlaceholderGroup(3, 16, 1024);
+    auto ph_group = ParsePlaceholderGroup(search_plan.get(),
+                                          ph_group_raw.SerializeAsString());
+    auto& cache = SearchResultCache::GetInstance();
+    cache.SetCapacity(64 << 20);
+    ttl->set_ttl_ms(2 * N);
+    segment->Search(search_plan.get(), ph_group.get(), query_ts);
+    ASSERT_GT(cache.CachedBytes(), 0);
+    ttl->set_ttl_ms(N / 2);
+    auto result = segment->Search(search_plan.get(), ph_group.get(), query_ts);
+    for (auto offset : result->seg_offsets_) {
+        ASSERT_GE(offset, N / 2 - 1);
+    }
+    segment.reset();
+    cache.SetCapacity(0);
+}
+
+TEST(Sealed, SegmentArena) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, ROW_COUNT);
+
+    auto& config = SegcoreConfig::default_config();
+    config.set_segment_arena(true);
+    auto segment = CreateSealedSegment(schema);
+    config.set_segment_arena(false);
+    auto& arena = segment->get_arena();
+    // the arena is of the jemalloc of the process, if it has one
+    if (JemallocMallctl() == nullptr) {
+        ASSERT_EQ(arena, nullptr);
+        ASSERT_EQ(segment->GetMemoryUsage().arena, -1);
+        return;
+    }
+    ASSERT_NE(arena, nullptr);
+    auto before = arena->allocated_bytes();
+    SealedLoadFieldData(dataset, *segment);
+    ASSERT_GT(segment->GetMemoryUsage().arena, before);
+    ASSERT_EQ(CreateSealedSegment(schema)->get_arena(), nullptr);
+}
+
+TEST(Sealed, IndexWarmup) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {fakevec_id.get()});
+    auto warmups = monitor::index_warmup_latency.Count();
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.index = GenVecIndexing(N, dim, fakevec.data());
+    vec_info.index_params["metric_type"] = knowhere::metric::L2;
+    vec_info.index_params[index::WARMUP_QUERIES] = "16";
+    segment->LoadIndex(vec_info);
+    ASSERT_EQ(monitor::index_warmup_latency.Count(), warmups + 1);
+    ASSERT_TRUE(segment->HasIndex(fakevec_id));
+
+    // off unless configured
+    auto cold = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *cold, {fakevec_id.get()});
+    vec_info.index = GenVecIndexing(N, dim, fakevec.data());
+    vec_info.index_params.erase(index::WARMUP_QUERIES);
+    cold->LoadIndex(vec_info);
+    ASSERT_EQ(monitor::index_warmup_latency.Count(), warmups + 1);
+}
+
 TEST(Sealed, RealCount) {
     auto schema = std::make_shared<Schema>();
     auto pk = schema->AddDebugField("pk", DataType::INT64);
@@ -1116,3 +2439,861 @@ TEST(Sealed, GetVector) {
         }
     }
 }
+
+TEST(Sealed, SearchResultCache) {
+    auto dim = 16;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: 5
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               fakevec_id.get();
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan =
+        CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+    auto ph_group_raw = CreatePlaceholderGroup(3, dim, 1024);
+    auto ph_group =
+        ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    auto& cache = SearchResultCache::GetInstance();
+    cache.SetCapacity(64 << 20);
+    auto expected = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    auto cached_bytes = cache.CachedBytes();
+    ASSERT_GT(cached_bytes, 0);
+
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(cache.CachedBytes(), cached_bytes);
+    ASSERT_EQ(result->segment_, segment.get());
+    ASSERT_EQ(result->seg_offsets_, expected->seg_offsets_);
+    ASSERT_EQ(result->distances_, expected->distances_);
+
+    // a query which doesn't see all the rows isn't cached
+    segment->Search(plan.get(), ph_group.get(), 0);
+    ASSERT_EQ(cache.CachedBytes(), cached_bytes);
+
+    // nor a profiled one, which gets the profile of its own search
+    plan->plan_node_->search_info_.profile_ = true;
+    result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_NE(result->profile_, nullptr);
+    ASSERT_EQ(result->seg_offsets_, expected->seg_offsets_);
+    plan->plan_node_->search_info_.profile_ = false;
+
+    // the nearest row is gone once it's deleted
+    auto deleted_offset = expected->seg_offsets_[0];
+    auto pk = dataset.get_col<int64_t>(counter_id)[deleted_offset];
+    auto ids = std::make_unique<IdArray>();
+    ids->mutable_int_id()->mutable_data()->Add(pk);
+    std::vector<Timestamp> timestamps{Timestamp(N + 10)};
+    LoadDeletedRecordInfo info = {timestamps.data(), ids.get(), 1};
+    segment->LoadDeletedRecord(info);
+    result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_GT(cache.CachedBytes(), cached_bytes);
+    ASSERT_EQ(std::count(result->seg_offsets_.begin(),
+                         result->seg_offsets_.end(),
+                         deleted_offset),
+              0);
+
+    // the params picked for a search come with the cached result
+    SearchResultCache::Key key{-1, 0, 0, -1, 0, "picked"};
+    SearchResult picked;
+    picked.total_nq_ = 1;
+    picked.unity_topK_ = 1;
+    picked.seg_offsets_ = {0};
+    picked.distances_ = {0};
+    picked.effective_search_params_ = R"({"nprobe": 41})";
+    cache.Put(key, picked);
+    ASSERT_EQ(cache.Get(key)->effective_search_params_,
+              picked.effective_search_params_);
+    cache.Erase(-1);
+
+    // a drop invalidates the results of the segment
+    segment->DropFieldData(counter_id);
+    ASSERT_EQ(cache.CachedBytes(), 0);
+
+    segment.reset();
+    cache.SetCapacity(0);
+}
+
+TEST(Sealed, SearchResultCacheWithDeleteBuffer) {
+    auto dim = 16;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto buffer = std::make_shared<DeleteBuffer>();
+    segment->set_delete_buffer(buffer);
+
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            query_info: <
+                                                topk: 5
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               fakevec_id.get();
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan =
+        CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+    auto ph_group_raw = CreatePlaceholderGroup(3, dim, 1024);
+    auto ph_group =
+        ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    auto& cache = SearchResultCache::GetInstance();
+    cache.SetCapacity(64 << 20);
+    auto expected = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    Timestamp ts = N + 20;
+    auto snapshot = segment->AcquireSnapshot(ts);
+
+    // a delete of the collection hides the row from the cached search and
+    // makes the snapshot stale
+    auto deleted_offset = expected->seg_offsets_[0];
+    auto pk_column = dataset.get_col<int64_t>(counter_id);
+    std::vector<PkType> pks{pk_column[deleted_offset]};
+    std::vector<Timestamp> timestamps{Timestamp(N + 10)};
+    buffer->push(pks.data(), timestamps.data(), 1);
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(std::count(result->seg_offsets_.begin(),
+                         result->seg_offsets_.end(),
+                         deleted_offset),
+              0);
+    auto fresh = segment->AcquireSnapshot(ts);
+    ASSERT_NE(fresh, snapshot);
+    ASSERT_TRUE(fresh->invisible()[deleted_offset]);
+    ASSERT_FALSE(snapshot->invisible()[deleted_offset]);
+
+    // one after the timestamp leaves the snapshot valid
+    pks = {pk_column[expected->seg_offsets_[1]]};
+    timestamps = {Timestamp(N + 30)};
+    buffer->push(pks.data(), timestamps.data(), 1);
+    ASSERT_EQ(segment->AcquireSnapshot(ts), fresh);
+
+    segment.reset();
+    cache.SetCapacity(0);
+}
+
+TEST(Sealed, ExprResultCache) {
+    int64_t row_count = 100000;
+    std::mt19937 rng(42);
+    // sparse, almost full and random results are kept in different forms
+    std::vector<BitsetType> results;
+    results.emplace_back(row_count);
+    results.emplace_back(row_count);
+    results.back().set();
+    results.emplace_back(row_count);
+    for (int i = 0; i < 10; ++i) {
+        results[0][rng() % row_count] = true;
+        results[1][rng() % row_count] = false;
+    }
+    for (int64_t i = 0; i < row_count; ++i) {
+        results[2][i] = rng() % 2;
+    }
+
+    ExprResultCache cache;
+    int64_t capacity = 64 << 20;
+    for (size_t i = 0; i < results.size(); ++i) {
+        cache.Put(0, std::to_string(i), results[i], capacity);
+    }
+    // the bitset is only kept when the offsets would be larger
+    ASSERT_LT(cache.CachedBytes(), row_count / 8 * 2);
+    for (size_t i = 0; i < results.size(); ++i) {
+        auto cached = cache.Get(0, std::to_string(i), row_count);
+        ASSERT_TRUE(cached.has_value());
+        ASSERT_EQ(cached.value(), results[i]);
+    }
+    ASSERT_FALSE(cache.Get(0, "0", row_count - 1).has_value());
+    ASSERT_FALSE(cache.Get(1, "0", row_count).has_value());
+
+    // results computed before a load aren't kept after it
+    cache.Clear(1);
+    ASSERT_EQ(cache.CachedBytes(), 0);
+    cache.Put(0, "0", results[0], capacity);
+    ASSERT_FALSE(cache.Get(1, "0", row_count).has_value());
+    cache.Put(1, "0", results[0], capacity);
+    ASSERT_TRUE(cache.Get(1, "0", row_count).has_value());
+
+    // the least recently used result goes first
+    auto sparse_bytes = cache.CachedBytes();
+    cache.Put(1, "1", results[1], sparse_bytes * 2);
+    ASSERT_TRUE(cache.Get(1, "0", row_count).has_value());
+    cache.Put(1, "3", results[0], sparse_bytes * 2);
+    ASSERT_FALSE(cache.Get(1, "1", row_count).has_value());
+    ASSERT_TRUE(cache.Get(1, "0", row_count).has_value());
+    ASSERT_TRUE(cache.Get(1, "3", row_count).has_value());
+}
+
+TEST(Sealed, SearchWithCachedPredicate) {
+    auto dim = 16;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto age_id = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    auto ages = dataset.get_col<int64_t>(age_id);
+    auto median = ages;
+    std::nth_element(median.begin(), median.begin() + N / 2, median.end());
+    auto fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            predicates: <
+                                              unary_range_expr: <
+                                                column_info: <
+                                                  field_id: %2%
+                                                  data_type: Int64
+                                                >
+                                                op: LessThan
+                                                value: <
+                                                  int64_val: %3%
+                                                >
+                                              >
+                                            >
+                                            query_info: <
+                                                topk: 5
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+               fakevec_id.get() % age_id.get() % median[N / 2];
+    auto serialized_expr_plan = fmt.str();
+    auto binary_plan =
+        translate_text_plan_to_binary_plan(serialized_expr_plan.data());
+    auto plan =
+        CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+    auto ph_group_raw = CreatePlaceholderGroup(3, dim, 1024);
+    auto ph_group =
+        ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    auto& config = SegcoreConfig::default_config();
+    config.set_expr_result_cache_size(1 << 20);
+    config.set_expr_result_cache_min_eval_us(0);
+    auto expected = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    for (auto offset : expected->seg_offsets_) {
+        ASSERT_LT(ages[offset], median[N / 2]);
+    }
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(result->seg_offsets_, expected->seg_offsets_);
+    ASSERT_EQ(result->distances_, expected->distances_);
+
+    // deletes are masked on top of the cached predicate
+    auto deleted_offset = expected->seg_offsets_[0];
+    auto pk = dataset.get_col<int64_t>(counter_id)[deleted_offset];
+    auto ids = std::make_unique<IdArray>();
+    ids->mutable_int_id()->mutable_data()->Add(pk);
+    std::vector<Timestamp> timestamps{Timestamp(N + 10)};
+    LoadDeletedRecordInfo info = {timestamps.data(), ids.get(), 1};
+    segment->LoadDeletedRecord(info);
+    result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(std::count(result->seg_offsets_.begin(),
+                         result->seg_offsets_.end(),
+                         deleted_offset),
+              0);
+    for (auto offset : result->seg_offsets_) {
+        ASSERT_LT(ages[offset], median[N / 2]);
+    }
+
+    // a pk term cached by an older query doesn't hide the newer rows
+    auto last_pk = dataset.get_col<int64_t>(counter_id)[N - 1];
+    auto pk_fmt = boost::format(R"(vector_anns: <
+                                            field_id: %1%
+                                            predicates: <
+                                              term_expr: <
+                                                column_info: <
+                                                  field_id: %2%
+                                                  data_type: Int64
+                                                >
+                                                values: <
+                                                  int64_val: %3%
+                                                >
+                                              >
+                                            >
+                                            query_info: <
+                                                topk: 5
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0">)") %
+                  fakevec_id.get() % counter_id.get() % last_pk;
+    auto pk_binary_plan =
+        translate_text_plan_to_binary_plan(pk_fmt.str().data());
+    auto pk_plan = CreateSearchPlanByExpr(
+        *schema, pk_binary_plan.data(), pk_binary_plan.size());
+    auto pk_ph_group =
+        ParsePlaceholderGroup(pk_plan.get(), ph_group_raw.SerializeAsString());
+    result = segment->Search(pk_plan.get(), pk_ph_group.get(), N / 2);
+    ASSERT_EQ(std::count(result->seg_offsets_.begin(),
+                         result->seg_offsets_.end(),
+                         N - 1),
+              0);
+    result = segment->Search(pk_plan.get(), pk_ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(std::count(result->seg_offsets_.begin(),
+                         result->seg_offsets_.end(),
+                         N - 1),
+              3);
+
+    config.set_expr_result_cache_size(0);
+    config.set_expr_result_cache_min_eval_us(100);
+}
+
+TEST(Sealed, PartitionKeyPruning) {
+    auto dim = 16;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto tenant_id = schema->AddDebugField("tenant", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    schema->set_partition_key_field_id(tenant_id);
+
+    // ten tenants, each holding a run of 100 rows
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    for (auto& field_data : *dataset.raw_->mutable_fields_data()) {
+        if (field_data.field_id() != tenant_id.get()) {
+            continue;
+        }
+        auto tenants = field_data.mutable_scalars()->mutable_long_data();
+        for (int i = 0; i < N; ++i) {
+            tenants->set_data(i, i / 100);
+        }
+    }
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    auto retrieve = [&](const std::vector<int64_t>& tenants) {
+        proto::plan::PlanNode plan_node;
+        auto expr = plan_node.mutable_predicates()->mutable_term_expr();
+        auto column_info = expr->mutable_column_info();
+        column_info->set_data_type(proto::schema::DataType::Int64);
+        column_info->set_field_id(tenant_id.get());
+        for (auto tenant : tenants) {
+            expr->add_values()->set_int64_val(tenant);
+        }
+        auto binary = plan_node.SerializeAsString();
+        auto plan =
+            CreateRetrievePlanByExpr(*schema, binary.data(), binary.size());
+        plan->field_ids_ = {counter_id};
+        auto retrieved = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        std::vector<int64_t> offsets(retrieved->offset().begin(),
+                                     retrieved->offset().end());
+        std::sort(offsets.begin(), offsets.end());
+        return offsets;
+    };
+
+    auto offsets = retrieve({3});
+    ASSERT_EQ(offsets.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(offsets[i], 300 + i);
+    }
+    ASSERT_TRUE(retrieve({42}).empty());
+    offsets = retrieve({1, 7, 42});
+    ASSERT_EQ(offsets.size(), 200);
+    ASSERT_EQ(offsets.front(), 100);
+    ASSERT_EQ(offsets.back(), 799);
+
+    // unclustered keys are only kept in a bloom filter
+    std::vector<int64_t> keys(PartitionKeyStats::MAX_VALUES * 2);
+    std::iota(keys.begin(), keys.end(), 0);
+    auto stats = PartitionKeyStats::Build(keys.data(), keys.size());
+    ASSERT_FALSE(stats->has_ranges());
+    ASSERT_TRUE(stats->may_contain(PkType(int64_t(5))));
+    ASSERT_EQ(stats->ranges(PkType(int64_t(5))), nullptr);
+}
+
+TEST(Sealed, SortedFieldRange) {
+    auto dim = 16;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto time_id = schema->AddDebugField("time", DataType::INT64);
+    auto age_id = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(counter_id);
+
+    // rows clustered by time, every value repeated twice
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    for (auto& field_data : *dataset.raw_->mutable_fields_data()) {
+        if (field_data.field_id() != time_id.get()) {
+            continue;
+        }
+        auto times = field_data.mutable_scalars()->mutable_long_data();
+        for (int i = 0; i < N; ++i) {
+            times->set_data(i, i / 2 * 10);
+        }
+    }
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto& sealed = dynamic_cast<SegmentSealedImpl&>(*segment);
+    ASSERT_TRUE(sealed.is_sorted_by(time_id));
+    ASSERT_FALSE(sealed.is_sorted_by(age_id));
+
+    auto retrieve = [&](const proto::plan::PlanNode& plan_node) {
+        auto binary = plan_node.SerializeAsString();
+        auto plan =
+            CreateRetrievePlanByExpr(*schema, binary.data(), binary.size());
+        plan->field_ids_ = {counter_id};
+        auto retrieved = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        std::vector<int64_t> offsets(retrieved->offset().begin(),
+                                     retrieved->offset().end());
+        std::sort(offsets.begin(), offsets.end());
+        return offsets;
+    };
+    auto expected = [&](auto pred) {
+        std::vector<int64_t> offsets;
+        for (int i = 0; i < N; ++i) {
+            if (pred(i / 2 * 10)) {
+                offsets.push_back(i);
+            }
+        }
+        return offsets;
+    };
+
+    // a value of the field and one between two of them
+    std::vector<std::tuple<proto::plan::OpType,
+                           int64_t,
+                           std::function<bool(int64_t)>>>
+        unary_cases = {
+            {proto::plan::Equal, 1230, [](int64_t x) { return x == 1230; }},
+            {proto::plan::Equal, 1235, [](int64_t x) { return x == 1235; }},
+            {proto::plan::GreaterThan,
+             1230,
+             [](int64_t x) { return x > 1230; }},
+            {proto::plan::GreaterEqual,
+             1235,
+             [](int64_t x) { return x >= 1235; }},
+            {proto::plan::LessThan, 1230, [](int64_t x) { return x < 1230; }},
+            {proto::plan::LessEqual, 1230, [](int64_t x) { return x <= 1230; }},
+        };
+    for (auto& [op, value, pred] : unary_cases) {
+        proto::plan::PlanNode plan_node;
+        auto expr = plan_node.mutable_predicates()->mutable_unary_range_expr();
+        expr->set_op(op);
+        auto column_info = expr->mutable_column_info();
+        column_info->set_data_type(proto::schema::DataType::Int64);
+        column_info->set_field_id(time_id.get());
+        expr->mutable_value()->set_int64_val(value);
+        ASSERT_EQ(retrieve(plan_node), expected(pred));
+    }
+
+    for (auto [lower_inclusive, upper_inclusive] :
+         std::vector<std::pair<bool, bool>>{
+             {true, true}, {true, false}, {false, true}, {false, false}}) {
+        proto::plan::PlanNode plan_node;
+        auto expr = plan_node.mutable_predicates()->mutable_binary_range_expr();
+        auto column_info = expr->mutable_column_info();
+        column_info->set_data_type(proto::schema::DataType::Int64);
+        column_info->set_field_id(time_id.get());
+        expr->set_lower_inclusive(lower_inclusive);
+        expr->set_upper_inclusive(upper_inclusive);
+        expr->mutable_lower_value()->set_int64_val(100);
+        expr->mutable_upper_value()->set_int64_val(2000);
+        ASSERT_EQ(retrieve(plan_node), expected([&](int64_t x) {
+                      return (lower_inclusive ? x >= 100 : x > 100) &&
+                             (upper_inclusive ? x <= 2000 : x < 2000);
+                  }));
+    }
+}
+
+TEST(Sealed, RefineSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto topK = 5;
+    auto refine_factor = 4;
+    auto metric_type = knowhere::metric::L2;
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, metric_type);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+
+    milvus::index::CreateIndexInfo create_index_info;
+    create_index_info.field_type = DataType::VECTOR_FLOAT;
+    create_index_info.metric_type = metric_type;
+    create_index_info.index_type = knowhere::IndexEnum::INDEX_FAISS_IVFSQ8;
+    auto indexing = milvus::index::IndexFactory::GetInstance().CreateIndex(
+        create_index_info, nullptr);
+    auto build_conf =
+        knowhere::Json{{knowhere::meta::METRIC_TYPE, metric_type},
+                       {knowhere::meta::DIM, std::to_string(dim)},
+                       {knowhere::indexparam::NLIST, "16"}};
+    indexing->BuildWithDataset(knowhere::GenDataSet(N, dim, fakevec.data()),
+                               build_conf);
+
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {fakevec_id.get()});
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.index = std::move(indexing);
+    vec_info.index_params["metric_type"] = metric_type;
+    segment->LoadIndex(vec_info);
+
+    auto field_data = storage::FieldDataFactory::GetInstance().CreateFieldData(
+        DataType::VECTOR_FLOAT, dim);
+    field_data->FillFieldData(fakevec.data(), N * dim);
+    FieldDataInfo refine_info{fakevec_id.get(), {field_data}, N};
+    segment->LoadRefineData(refine_info);
+
+    // the queries are rows of the segment, their exact nearest neighbors
+    auto num_queries = 10;
+    std::vector<int64_t> targets(num_queries);
+    for (int i = 0; i < num_queries; ++i) {
+        targets[i] = i * 997 % N;
+    }
+    std::vector<float> queries;
+    for (auto target : targets) {
+        queries.insert(queries.end(),
+                       fakevec.begin() + target * dim,
+                       fakevec.begin() + (target + 1) * dim);
+    }
+
+    SearchInfo search_info;
+    search_info.field_id_ = fakevec_id;
+    search_info.topk_ = topK;
+    search_info.metric_type_ = metric_type;
+    search_info.round_decimal_ = -1;
+    search_info.search_params_ = {{knowhere::indexparam::NPROBE, 16}};
+    search_info.refine_factor_ = refine_factor;
+    search_info.refine_params_ = ParseSearchParams(
+        search_info.search_params_, topK * refine_factor, metric_type);
+
+    SearchResult result;
+    segment->vector_search(
+        search_info, queries.data(), num_queries, 1000000, nullptr, result);
+    ASSERT_EQ(result.unity_topK_, topK);
+    ASSERT_EQ(result.seg_offsets_.size(), num_queries * topK);
+    for (int i = 0; i < num_queries; ++i) {
+        EXPECT_EQ(result.seg_offsets_[i * topK], targets[i]);
+        EXPECT_EQ(result.distances_[i * topK], 0);
+        for (int k = 0; k < topK; ++k) {
+            auto offset = result.seg_offsets_[i * topK + k];
+            ASSERT_NE(offset, INVALID_SEG_OFFSET);
+            // the kept distances are the exact ones of the raw vectors
+            float distance = 0;
+            for (int d = 0; d < dim; ++d) {
+                auto diff = queries[i * dim + d] - fakevec[offset * dim + d];
+                distance += diff * diff;
+            }
+            EXPECT_NEAR(result.distances_[i * topK + k], distance, 1e-3);
+            if (k > 0) {
+                EXPECT_LE(result.distances_[i * topK + k - 1],
+                          result.distances_[i * topK + k]);
+            }
+        }
+    }
+}
+
+TEST(Sealed, AdaptiveSearchTuner) {
+    using query::AdaptiveSearchTuner;
+    AdaptiveSearchTuner tuner;
+    SearchInfo search_info;
+    search_info.topk_ = 10;
+    search_info.search_params_ = {{knowhere::indexparam::NPROBE, 1}};
+    std::map<std::string, std::string> ivf_params = {
+        {knowhere::indexparam::NLIST, "100"}};
+    auto ivf = knowhere::IndexEnum::INDEX_FAISS_IVFFLAT;
+    auto nprobe = [&](double pass_ratio) {
+        auto picked =
+            tuner.Pick(ivf, ivf_params, search_info, 10000, pass_ratio, 1);
+        return picked.search_params[knowhere::indexparam::NPROBE]
+            .get<int64_t>();
+    };
+
+    // without a target the params of the plan are kept
+    ASSERT_EQ(nprobe(1), 1);
+
+    search_info.adaptive_ = AdaptiveSearchTarget{RecallTier::LOW};
+    ASSERT_EQ(nprobe(1), 1);
+    search_info.adaptive_ = AdaptiveSearchTarget{RecallTier::MEDIUM};
+    ASSERT_EQ(nprobe(1), 4);
+    search_info.adaptive_ = AdaptiveSearchTarget{RecallTier::HIGH};
+    ASSERT_EQ(nprobe(1), 10);
+    // a selective filter probes more lists, at most all of them
+    ASSERT_EQ(nprobe(0.25), 20);
+    ASSERT_EQ(nprobe(0.0001), 80);
+    ivf_params[knowhere::indexparam::NLIST] = "16";
+    ASSERT_EQ(nprobe(0.0001), 16);
+    ivf_params[knowhere::indexparam::NLIST] = "100";
+
+    // the budget cuts the effort by the latency seen, down to the low tier
+    auto effort =
+        tuner.Pick(ivf, ivf_params, search_info, 10000, 1, 1).effort;
+    ASSERT_EQ(effort, 10 * 10000 / 100);
+    tuner.Observe(ivf, effort, 10);
+    ASSERT_DOUBLE_EQ(tuner.MsPerEffort(ivf), 0.01);
+    search_info.adaptive_->latency_budget_ms_ = 4.5;
+    ASSERT_EQ(nprobe(1), 4);
+    search_info.adaptive_->latency_budget_ms_ = 0.01;
+    ASSERT_EQ(nprobe(1), 1);
+    // the latency is tracked per index type
+    ASSERT_EQ(tuner.MsPerEffort(knowhere::IndexEnum::INDEX_HNSW), 0);
+
+    // graph indexes keep at least topk candidates
+    search_info.adaptive_ = AdaptiveSearchTarget{RecallTier::MEDIUM};
+    search_info.topk_ = 100;
+    auto ef = tuner
+                  .Pick(knowhere::IndexEnum::INDEX_HNSW,
+                        {},
+                        search_info,
+                        10000,
+                        1,
+                        1)
+                  .search_params[knowhere::indexparam::EF]
+                  .get<int64_t>();
+    ASSERT_EQ(ef, 100);
+
+    // other indexes are searched with the params of the plan
+    auto picked = tuner.Pick(knowhere::IndexEnum::INDEX_FAISS_IDMAP,
+                             {},
+                             search_info,
+                             10000,
+                             1,
+                             1);
+    ASSERT_EQ(picked.search_params, search_info.search_params_);
+    ASSERT_EQ(picked.effort, 0);
+}
+
+TEST(Sealed, AdaptiveSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto metric_type = knowhere::metric::L2;
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, metric_type);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {fakevec_id.get()});
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.index = GenVecIndexing(N, dim, fakevec.data());
+    vec_info.index_params["metric_type"] = metric_type;
+    vec_info.index_params[knowhere::indexparam::NLIST] = "1024";
+    segment->LoadIndex(vec_info);
+
+    SearchInfo search_info;
+    search_info.field_id_ = fakevec_id;
+    search_info.topk_ = 5;
+    search_info.metric_type_ = metric_type;
+    search_info.round_decimal_ = -1;
+    search_info.search_params_ = {{knowhere::indexparam::NPROBE, 1}};
+
+    auto num_queries = 5;
+    SearchResult result;
+    segment->vector_search(
+        search_info, fakevec.data(), num_queries, 1000000, nullptr, result);
+    ASSERT_TRUE(result.effective_search_params_.empty());
+
+    // the params picked for the segment come with the result
+    search_info.adaptive_ = AdaptiveSearchTarget{RecallTier::MEDIUM};
+    SearchResult adaptive_result;
+    segment->vector_search(search_info,
+                           fakevec.data(),
+                           num_queries,
+                           1000000,
+                           nullptr,
+                           adaptive_result);
+    auto effective = knowhere::Json::parse(
+        adaptive_result.effective_search_params_);
+    ASSERT_EQ(effective[knowhere::indexparam::NPROBE], 41);
+    ASSERT_EQ(adaptive_result.seg_offsets_.size(), num_queries * 5);
+    for (int i = 0; i < num_queries; ++i) {
+        ASSERT_EQ(adaptive_result.seg_offsets_[i * 5], i);
+    }
+}
+
+TEST(Sealed, FieldSketch) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto int32_id = schema->AddDebugField("int32", DataType::INT32);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    ASSERT_EQ(segment->field_sketch(fakevec_id), nullptr);
+    // the counters are 0..N-1
+    auto counter = segment->field_sketch(counter_id);
+    ASSERT_NE(counter, nullptr);
+    ASSERT_EQ(counter->row_count(), N);
+    ASSERT_NEAR(counter->distinct_count(), N, N * 0.03);
+    auto quantiles = counter->quantiles();
+    ASSERT_NE(quantiles, nullptr);
+    ASSERT_EQ(quantiles->min(), 0);
+    ASSERT_EQ(quantiles->max(), N - 1);
+    ASSERT_NEAR(quantiles->Quantile(0.5), N / 2, N * 0.02);
+    ASSERT_NEAR(quantiles->Rank(N / 4, false), 0.25, 0.02);
+    ASSERT_LT(quantiles->retained(), N / 10);
+
+    auto exact_distinct = [&](auto values) {
+        return int64_t(std::set(values.begin(), values.end()).size());
+    };
+    auto int32s = dataset.get_col<int32_t>(int32_id);
+    auto int32 = segment->field_sketch(int32_id);
+    ASSERT_NE(int32, nullptr);
+    auto int32_distinct = exact_distinct(int32s);
+    ASSERT_NEAR(int32->distinct_count(), int32_distinct, int32_distinct * 0.03);
+    auto strs = dataset.get_col<std::string>(str_id);
+    auto str = segment->field_sketch(str_id);
+    ASSERT_NE(str, nullptr);
+    ASSERT_EQ(str->quantiles(), nullptr);
+    auto str_distinct = exact_distinct(strs);
+    ASSERT_NEAR(str->distinct_count(), str_distinct, str_distinct * 0.03);
+
+    // serialized, merged with itself it counts the rows twice and the
+    // values once
+    auto c_segment = static_cast<CSegmentInterface>(segment.get());
+    CProto sketch;
+    auto status = GetFieldSketch(c_segment, counter_id.get(), &sketch);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_GT(sketch.proto_size, 0);
+    CProto sketches[] = {sketch, sketch};
+    CProto merged;
+    status = MergeFieldSketches(sketches, 2, &merged);
+    ASSERT_EQ(status.error_code, Success);
+    int64_t row_count, distinct_count;
+    status = GetFieldSketchCounts(
+        merged.proto_blob, merged.proto_size, &row_count, &distinct_count);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_EQ(row_count, 2 * N);
+    ASSERT_EQ(distinct_count, counter->distinct_count());
+    double qs[] = {0, 0.5, 1};
+    double values[3];
+    status = GetFieldSketchQuantiles(
+        merged.proto_blob, merged.proto_size, qs, 3, values);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_EQ(values[0], 0);
+    ASSERT_NEAR(values[1], N / 2, N * 0.02);
+    ASSERT_EQ(values[2], N - 1);
+    const char* index_type = nullptr;
+    status = RecommendScalarIndexType(
+        merged.proto_blob, merged.proto_size, CDataType::Int64, &index_type);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_STREQ(index_type, index::ASCENDING_SORT);
+    std::free(const_cast<void*>(merged.proto_blob));
+
+    // a string sketch doesn't merge with a numeric one
+    CProto str_sketch;
+    status = GetFieldSketch(c_segment, str_id.get(), &str_sketch);
+    ASSERT_EQ(status.error_code, Success);
+    CProto mixed[] = {sketch, str_sketch};
+    status = MergeFieldSketches(mixed, 2, &merged);
+    ASSERT_NE(status.error_code, Success);
+    free((char*)status.error_msg);
+    std::free(const_cast<void*>(sketch.proto_blob));
+    std::free(const_cast<void*>(str_sketch.proto_blob));
+
+    segment->DropFieldData(int32_id);
+    ASSERT_EQ(segment->field_sketch(int32_id), nullptr);
+
+    // a few values get a bitmap, strings repeated over many rows an
+    // inverted index
+    std::vector<int64_t> few(N);
+    std::vector<std::string> repeated(N);
+    for (int64_t i = 0; i < N; ++i) {
+        few[i] = i % 10;
+        repeated[i] = std::to_string(i % 100);
+    }
+    auto few_sketch = FieldSketch::Build(few.data(), N);
+    ASSERT_EQ(few_sketch->distinct_count(), 10);
+    ASSERT_EQ(index::RecommendScalarIndexType(DataType::INT64, *few_sketch),
+              index::BITMAP_INDEX_TYPE);
+    auto repeated_sketch = FieldSketch::Build(repeated.data(), N);
+    ASSERT_EQ(
+        index::RecommendScalarIndexType(DataType::VARCHAR, *repeated_sketch),
+        index::INVERTED_INDEX_TYPE);
+    ASSERT_EQ(index::RecommendScalarIndexType(DataType::VARCHAR, *str),
+              index::MARISA_TRIE);
+}
+
+TEST(Sealed, MmapGather) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto int32_id = schema->AddDebugField("int32", DataType::INT32);
+    auto str_id = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {}, true);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    auto counters = dataset.get_col<int64_t>(counter_id);
+    auto int32s = dataset.get_col<int32_t>(int32_id);
+    auto strs = dataset.get_col<std::string>(str_id);
+
+    std::default_random_engine er(42);
+    std::vector<int64_t> offsets;
+    for (int i = 0; i < 500; ++i) {
+        offsets.push_back(i % 10 == 0 ? INVALID_SEG_OFFSET : er() % N);
+    }
+    auto count = int64_t(offsets.size());
+    auto& config = SegcoreConfig::default_config();
+    auto min_rows = config.get_mmap_gather_willneed_min_rows();
+    // gathered in the order of the offsets, or sorted by them with their
+    // pages advised first
+    for (auto willneed_min_rows : {int64_t(0), int64_t(16)}) {
+        config.set_mmap_gather_willneed_min_rows(willneed_min_rows);
+        auto vecs = segment->bulk_subscript(fakevec_id, offsets.data(), count);
+        auto longs = segment->bulk_subscript(counter_id, offsets.data(), count);
+        auto ints = segment->bulk_subscript(int32_id, offsets.data(), count);
+        auto texts = segment->bulk_subscript(str_id, offsets.data(), count);
+        auto& vec_data = vecs->vectors().float_vector().data();
+        for (int64_t i = 0; i < count; ++i) {
+            auto offset = offsets[i];
+            if (offset == INVALID_SEG_OFFSET) {
+                ASSERT_TRUE(texts->scalars().string_data().data(i).empty());
+                continue;
+            }
+            ASSERT_EQ(longs->scalars().long_data().data(i), counters[offset]);
+            ASSERT_EQ(ints->scalars().int_data().data(i), int32s[offset]);
+            ASSERT_EQ(texts->scalars().string_data().data(i), strs[offset]);
+            for (int j = 0; j < dim; ++j) {
+                ASSERT_EQ(vec_data[i * dim + j], fakevec[offset * dim + j]);
+            }
+        }
+    }
+    config.set_mmap_gather_willneed_min_rows(min_rows);
+}
@@ -13,7 +13,9 @@
 #include <random>
 #include <string>
 #include <iostream>
+#include <unordered_map>
 
+#include "segcore/PkBloomFilter.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "test_utils/DataGen.h"
 
@@ -173,4 +175,177 @@ TEST(InsertRecordTest, sealed_string) {
             record.search_pk(std::to_string(i), int64_t(N + 1));
         ASSERT_EQ(offset[0].get(), int64_t(i));
     }
-}
\ No newline at end of file
+}
+TEST(InsertRecordTest, OffsetSortedIndex) {
+    using namespace milvus::segcore;
+    std::default_random_engine er(42);
+
+    // duplicated keys, sparse unique keys and dense unique keys which are
+    // addressed directly
+    std::vector<std::vector<int64_t>> cases(3);
+    for (int64_t i = 0; i < 10000; ++i) {
+        cases[0].push_back(er() % 3000 - 1500);
+        cases[1].push_back(int64_t(er()) * 1000 + i);
+        cases[2].push_back(i * 3 % 10000 - 5000);
+    }
+    for (auto& keys : cases) {
+        OffsetSortedIndex<int64_t> index;
+        std::unordered_map<int64_t, std::vector<int64_t>> expected;
+        for (int64_t i = 0; i < int64_t(keys.size()); ++i) {
+            index.insert(PkType(keys[i]), i);
+            expected[keys[i]].push_back(i);
+        }
+        index.seal();
+
+        std::vector<PkType> probes;
+        for (int64_t i = 0; i < 2000; ++i) {
+            probes.emplace_back(keys[er() % keys.size()]);
+            probes.emplace_back(int64_t(er()));
+        }
+        std::vector<OffsetMap::PkOffset> result;
+        index.find_many(probes.data(), probes.size(), result);
+
+        std::vector<OffsetMap::PkOffset> result_expected;
+        for (int64_t i = 0; i < int64_t(probes.size()); ++i) {
+            auto offsets = index.find(probes[i]);
+            auto key = std::get<int64_t>(probes[i]);
+            auto iter = expected.find(key);
+            if (iter == expected.end()) {
+                ASSERT_TRUE(offsets.empty());
+                continue;
+            }
+            ASSERT_EQ(offsets, iter->second);
+            for (auto offset : offsets) {
+                result_expected.emplace_back(i, offset);
+            }
+        }
+        ASSERT_EQ(result, result_expected);
+    }
+}
+
+TEST(InsertRecordTest, sealed_search_pks) {
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto str_fid = schema->AddDebugField("name", DataType::VARCHAR);
+    schema->set_primary_field_id(str_fid);
+    auto record = milvus::segcore::InsertRecord<true>(*schema, int64_t(32));
+    const int N = 10000;
+
+    // every pk is inserted twice
+    for (int i = 0; i < 2 * N; i++)
+        record.insert_pk(PkType(std::to_string(i % N)), int64_t(i));
+    record.seal_pks();
+
+    std::vector<PkType> pks;
+    for (int i = N + 10; i >= 0; i -= 7) {
+        pks.emplace_back(std::to_string(i));
+    }
+    std::vector<OffsetMap::PkOffset> result;
+    record.search_pks(pks.data(), pks.size(), int64_t(N + N / 2), result);
+
+    std::vector<OffsetMap::PkOffset> expected;
+    for (int64_t i = 0; i < int64_t(pks.size()); ++i) {
+        for (auto offset : record.search_pk(pks[i], int64_t(N + N / 2))) {
+            expected.emplace_back(i, offset.get());
+        }
+    }
+    ASSERT_EQ(result, expected);
+}
+
+TEST(InsertRecordTest, PkBloomFilter) {
+    using namespace milvus::segcore;
+    const int64_t N = 100000;
+    // exact capacity builds one stage, a small one grows in stages
+    for (int64_t capacity : {N, int64_t(1)}) {
+        PkBloomFilter filter(capacity);
+        for (int64_t i = 0; i < N; ++i) {
+            filter.add(PkType(i * 7));
+            filter.add(PkType(std::to_string(i)));
+        }
+        ASSERT_EQ(filter.size(), 2 * N);
+        int64_t false_positives = 0;
+        for (int64_t i = 0; i < N; ++i) {
+            ASSERT_TRUE(filter.may_contain(PkType(i * 7)));
+            ASSERT_TRUE(filter.may_contain(PkType(std::to_string(i))));
+            false_positives += filter.may_contain(PkType(i * 7 + 1));
+            false_positives +=
+                filter.may_contain(PkType("x" + std::to_string(i)));
+        }
+        ASSERT_LT(false_positives, 2 * N * 5 / 100);
+    }
+}
+
+TEST(InsertRecordTest, sealed_pk_filter) {
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField(
+        "fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    auto record = milvus::segcore::InsertRecord<true>(*schema, int64_t(32));
+    const int N = 10000;
+
+    for (int i = 0; i < N; i++)
+        record.insert_pk(PkType(int64_t(i) * 1000), int64_t(i));
+    record.seal_pks();
+    ASSERT_NE(record.pk_filter_, nullptr);
+
+    std::vector<PkType> pks;
+    for (int i = 0; i < 2 * N; i++) {
+        pks.emplace_back(int64_t(i) * 500);
+    }
+    std::vector<OffsetMap::PkOffset> result;
+    record.search_pks(pks.data(), pks.size(), int64_t(N), result);
+    ASSERT_EQ(result.size(), N);
+    for (int i = 0; i < N; i++) {
+        ASSERT_EQ(result[i].first, 2 * i);
+        ASSERT_EQ(result[i].second, i);
+        ASSERT_EQ(record.search_pk(pks[2 * i + 1], int64_t(N)).size(), 0);
+    }
+}
+
+TEST(InsertRecordTest, OffsetHashMap) {
+    using namespace milvus::segcore;
+    std::default_random_engine er(42);
+    const int64_t N = 50000;
+
+    OffsetHashMap<int64_t> int_map;
+    // no arena, the map owns the string copies
+    OffsetHashMap<std::string> string_map;
+    std::unordered_map<int64_t, std::vector<int64_t>> expected;
+    for (int64_t i = 0; i < N; ++i) {
+        // about one pk in ten is duplicated
+        auto key = int64_t(er() % (N * 10 / 11));
+        int_map.insert(PkType(key), i);
+        string_map.insert(PkType(std::to_string(key)), i);
+        expected[key].push_back(i);
+    }
+    ASSERT_FALSE(int_map.empty());
+
+    std::vector<PkType> int_pks;
+    std::vector<PkType> string_pks;
+    for (int64_t key = -10; key < N; ++key) {
+        int_pks.emplace_back(key);
+        string_pks.emplace_back(std::to_string(key));
+    }
+    std::vector<OffsetMap::PkOffset> int_result;
+    std::vector<OffsetMap::PkOffset> string_result;
+    int_map.find_many(int_pks.data(), int_pks.size(), int_result);
+    string_map.find_many(string_pks.data(), string_pks.size(), string_result);
+
+    std::vector<OffsetMap::PkOffset> result_expected;
+    for (int64_t i = 0; i < int64_t(int_pks.size()); ++i) {
+        auto iter = expected.find(std::get<int64_t>(int_pks[i]));
+        auto offsets = iter == expected.end() ? std::vector<int64_t>()
+                                              : iter->second;
+        ASSERT_EQ(int_map.find(int_pks[i]), offsets);
+        ASSERT_EQ(string_map.find(string_pks[i]), offsets);
+        for (auto offset : offsets) {
+            result_expected.emplace_back(i, offset);
+        }
+    }
+    ASSERT_EQ(int_result, result_expected);
+    ASSERT_EQ(string_result, result_expected);
+}
@@ -0,0 +1,332 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simd/hook.h"
+#include "simd/ref.h"
+
+using namespace milvus::simd;
+
+namespace {
+
+const CompareType kCompareTypes[] = {CompareType::EQ,
+                                     CompareType::NE,
+                                     CompareType::GT,
+                                     CompareType::GE,
+                                     CompareType::LT,
+                                     CompareType::LE};
+
+const size_t kSizes[] = {0, 1, 31, 63, 64, 65, 127, 128, 1000, 4096 + 7};
+
+template <typename T>
+std::vector<T>
+GenValues(size_t n, unsigned seed = 42) {
+    // small value domain so that every predicate hits both branches
+    std::default_random_engine er(seed);
+    std::uniform_int_distribution<int> dist(-8, 8);
+    std::vector<T> values(n);
+    for (auto& v : values) {
+        v = static_cast<T>(dist(er));
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        for (size_t i = 3; i < n; i += 17) {
+            values[i] = std::numeric_limits<T>::quiet_NaN();
+        }
+    }
+    return values;
+}
+
+template <typename T>
+void
+CheckKernels() {
+    for (auto size : kSizes) {
+        auto values = GenValues<T>(size);
+        auto n_words = WordCount(size);
+        for (auto op : kCompareTypes) {
+            std::vector<uint64_t> expect(n_words), actual(n_words, ~0ULL);
+            CompareValRef<T>(op, values.data(), size, T(2), expect.data());
+            CompareVal(op, values.data(), size, T(2), actual.data());
+            ASSERT_EQ(expect, actual) << "size=" << size << " op=" << int(op);
+        }
+        auto others = GenValues<T>(size, 7);
+        for (auto op : kCompareTypes) {
+            std::vector<uint64_t> expect(n_words), actual(n_words, ~0ULL);
+            CompareColumnRef<T>(
+                op, values.data(), others.data(), size, expect.data());
+            CompareColumn(
+                op, values.data(), others.data(), size, actual.data());
+            ASSERT_EQ(expect, actual) << "size=" << size << " op=" << int(op);
+        }
+        for (auto lower_inclusive : {true, false}) {
+            for (auto upper_inclusive : {true, false}) {
+                std::vector<uint64_t> expect(n_words), actual(n_words, ~0ULL);
+                BetweenValRef<T>(values.data(),
+                                 size,
+                                 T(-3),
+                                 lower_inclusive,
+                                 T(4),
+                                 upper_inclusive,
+                                 expect.data());
+                BetweenVal(values.data(),
+                           size,
+                           T(-3),
+                           lower_inclusive,
+                           T(4),
+                           upper_inclusive,
+                           actual.data());
+                ASSERT_EQ(expect, actual) << "size=" << size;
+            }
+        }
+    }
+}
+
+void
+CheckAllTypes() {
+    CheckKernels<int8_t>();
+    CheckKernels<int16_t>();
+    CheckKernels<int32_t>();
+    CheckKernels<int64_t>();
+    CheckKernels<uint64_t>();
+    CheckKernels<float>();
+    CheckKernels<double>();
+}
+
+}  // namespace
+
+TEST(Simd, RefPackBits) {
+    std::vector<int32_t> values{1, 5, 3, 5, 5};
+    std::vector<uint64_t> dst(1);
+    CompareValRef<int32_t>(CompareType::EQ, values.data(), 5, 5, dst.data());
+    ASSERT_EQ(dst[0], 0b11010);
+}
+
+TEST(Simd, RefCompareColumn) {
+    std::vector<int64_t> left{1, 5, 3, 5, 7};
+    std::vector<int64_t> right{2, 5, 1, 6, 7};
+    std::vector<uint64_t> dst(1);
+    CompareColumnRef<int64_t>(
+        CompareType::GE, left.data(), right.data(), 5, dst.data());
+    ASSERT_EQ(dst[0], 0b10110);
+}
+
+TEST(Simd, CompareAndBetween) {
+    auto origin = GetSimdType();
+    for (auto type : {SimdType::REF,
+                      SimdType::AVX2,
+                      SimdType::AVX512,
+                      SimdType::NEON}) {
+        auto installed = SetSimdType(type);
+        if (installed != type) {
+            continue;
+        }
+        CheckAllTypes();
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, BinaryDistances) {
+    // code sizes around the register widths, nq off the query tile
+    const size_t code_sizes[] = {1, 8, 13, 16, 32, 64, 65, 128, 200};
+    const size_t nq = 7, nb = 19;
+    std::default_random_engine er(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    auto origin = GetSimdType();
+    for (auto code_size : code_sizes) {
+        std::vector<uint8_t> queries(nq * code_size), rows(nb * code_size);
+        for (auto& v : queries) {
+            v = dist(er);
+        }
+        for (auto& v : rows) {
+            v = dist(er);
+        }
+        // an empty query and row, their jaccard distance is 0
+        std::fill_n(queries.begin(), code_size, 0);
+        std::fill_n(rows.begin(), code_size, 0);
+        for (auto metric : {BinaryMetric::HAMMING, BinaryMetric::JACCARD}) {
+            std::vector<float> expected(nq * nb);
+            BinaryDistancesRef(metric,
+                               queries.data(),
+                               nq,
+                               rows.data(),
+                               nb,
+                               code_size,
+                               expected.data());
+            ASSERT_EQ(expected[0], 0);
+            for (auto type : {SimdType::REF,
+                              SimdType::AVX2,
+                              SimdType::AVX512,
+                              SimdType::NEON}) {
+                if (SetSimdType(type) != type) {
+                    continue;
+                }
+                std::vector<float> dst(nq * nb, -1);
+                BinaryDistances(metric,
+                                queries.data(),
+                                nq,
+                                rows.data(),
+                                nb,
+                                code_size,
+                                dst.data());
+                ASSERT_EQ(dst, expected) << SimdTypeName(type);
+            }
+        }
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, PackBool) {
+    for (auto size : kSizes) {
+        std::vector<uint8_t> raw(size);
+        for (size_t i = 0; i < size; ++i) {
+            raw[i] = (i % 3 == 0);
+        }
+        auto src = reinterpret_cast<const bool*>(raw.data());
+        std::vector<uint64_t> dst(WordCount(size));
+        PackBool(src, size, dst.data());
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(bool((dst[i / 64] >> (i % 64)) & 1), src[i]);
+        }
+    }
+}
+
+TEST(Simd, WordKernels) {
+    // word counts around the register widths
+    const size_t word_counts[] = {0, 1, 2, 3, 4, 7, 8, 9, 16, 33, 100};
+    std::default_random_engine er(42);
+    auto origin = GetSimdType();
+    for (auto words : word_counts) {
+        std::vector<uint64_t> left(words), right(words);
+        for (size_t i = 0; i < words; ++i) {
+            left[i] = (uint64_t(er()) << 32) | er();
+            right[i] = (uint64_t(er()) << 32) | er();
+        }
+        // a run of empty words for FindNextBit to skip
+        std::vector<uint64_t> sparse(words);
+        if (words > 0) {
+            sparse.back() = uint64_t(1) << 63;
+        }
+        for (auto type : {SimdType::REF,
+                          SimdType::AVX2,
+                          SimdType::AVX512,
+                          SimdType::NEON}) {
+            if (SetSimdType(type) != type) {
+                continue;
+            }
+            for (auto op :
+                 {BitwiseOp::AND, BitwiseOp::OR, BitwiseOp::ANDNOT}) {
+                auto expect = left;
+                auto actual = left;
+                BitwiseWordsRef(op, expect.data(), right.data(), words);
+                BitwiseWords(op, actual.data(), right.data(), words);
+                ASSERT_EQ(expect, actual)
+                    << SimdTypeName(type) << " words=" << words;
+            }
+            ASSERT_EQ(PopcountWords(left.data(), words),
+                      PopcountWordsRef(left.data(), words))
+                << SimdTypeName(type) << " words=" << words;
+
+            auto num_bits = words * BITS_PER_WORD;
+            ASSERT_EQ(FindNextBit(sparse.data(), num_bits, 0),
+                      words == 0 ? 0 : num_bits - 1);
+            ASSERT_EQ(FindNextBit(sparse.data(), num_bits, num_bits), num_bits);
+            for (size_t pos = 0; pos < num_bits; pos += 37) {
+                auto expect = pos;
+                while (expect < num_bits &&
+                       !((left[expect / 64] >> (expect % 64)) & 1)) {
+                    ++expect;
+                }
+                ASSERT_EQ(FindNextBit(left.data(), num_bits, pos), expect)
+                    << SimdTypeName(type) << " pos=" << pos;
+            }
+        }
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, StringKernels) {
+    // strings sharing long prefixes, around the 16 bytes compared at once,
+    // and bytes above 0x7f which compare as unsigned
+    std::default_random_engine er(42);
+    const std::string alphabet = "ab\xff";
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string str(er() % 40, 'a');
+        for (size_t j = 12; j < str.size(); ++j) {
+            str[j] = alphabet[er() % alphabet.size()];
+        }
+        strings.push_back(str);
+    }
+    // the views point into one buffer as the ones of a column do
+    std::string buffer;
+    for (auto& str : strings) {
+        buffer += str;
+    }
+    std::vector<std::string_view> views;
+    size_t offset = 0;
+    for (auto& str : strings) {
+        views.emplace_back(buffer.data() + offset, str.size());
+        offset += str.size();
+    }
+    std::vector<std::string> vals = {"",
+                                     "a",
+                                     std::string(15, 'a'),
+                                     std::string(16, 'a'),
+                                     std::string(16, 'a') + "b",
+                                     std::string(14, 'a') + "\xff",
+                                     strings[7],
+                                     strings[42]};
+
+    auto origin = GetSimdType();
+    for (auto type : {SimdType::REF,
+                      SimdType::AVX2,
+                      SimdType::AVX512,
+                      SimdType::NEON}) {
+        if (SetSimdType(type) != type) {
+            continue;
+        }
+        for (auto size : {size_t(0), size_t(63), views.size()}) {
+            std::vector<uint64_t> expect(WordCount(size));
+            std::vector<uint64_t> actual(WordCount(size));
+            for (std::string_view val : vals) {
+                for (auto op : kCompareTypes) {
+                    CompareStringsRef(
+                        op, views.data(), size, val, expect.data());
+                    CompareStrings(op, views.data(), size, val, actual.data());
+                    ASSERT_EQ(expect, actual)
+                        << SimdTypeName(type) << " op=" << int(op);
+                }
+                PrefixMatchStringsRef(views.data(), size, val, expect.data());
+                PrefixMatchStrings(views.data(), size, val, actual.data());
+                ASSERT_EQ(expect, actual) << SimdTypeName(type);
+                for (size_t i = 0; i < size; ++i) {
+                    auto bit = bool((actual[i / 64] >> (i % 64)) & 1);
+                    ASSERT_EQ(views[i].substr(0, val.size()) == val, bit);
+                }
+            }
+        }
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, AutoDetect) {
+    auto origin = GetSimdType();
+    ASSERT_EQ(SetSimdType(SimdType::AUTO), DetectSimdType());
+    SetSimdType(origin);
+}
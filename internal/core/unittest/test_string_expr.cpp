@@ -19,6 +19,7 @@
 #include "query/generated/PlanNodeVisitor.h"
 #include "query/generated/ExecExprVisitor.h"
 #include "segcore/SegmentGrowingImpl.h"
+#include "segcore/SegmentSealedImpl.h"
 #include "test_utils/DataGen.h"
 #include "query/PlanProto.h"
 #include "query/Utils.h"
@@ -526,6 +527,114 @@ TEST(StringExpr, UnaryRange) {
     }
 }
 
+TEST(StringExpr, DictionaryEncodedColumn) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = GenTestSchema();
+    const auto& fvec_meta = schema->operator[](FieldName("fvec"));
+    const auto& str_meta = schema->operator[](FieldName("str"));
+
+    int N = 10000;
+    auto raw_data = DataGen(schema, N);
+    // a few distinct values, the sealed column keeps a dictionary of them
+    std::vector<std::string> str_col(N);
+    for (auto& field_data : *raw_data.raw_->mutable_fields_data()) {
+        if (field_data.field_id() != str_meta.get_id().get()) {
+            continue;
+        }
+        auto data =
+            field_data.mutable_scalars()->mutable_string_data()->mutable_data();
+        for (int i = 0; i < N; ++i) {
+            str_col[i] = "tag_" + std::to_string(i * 7 % 13);
+            *data->Mutable(i) = str_col[i];
+        }
+    }
+    auto seg = SealedCreator(schema, raw_data);
+
+    auto dictionary = seg->chunk_string_dictionary(str_meta.get_id(), 0);
+    ASSERT_NE(dictionary, nullptr);
+    ASSERT_EQ(dictionary->values().size(), 13);
+    ASSERT_TRUE(std::is_sorted(dictionary->values().begin(),
+                               dictionary->values().end()));
+    auto span = seg->chunk_data<std::string_view>(str_meta.get_id(), 0);
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(span[i], str_col[i]);
+    }
+
+    auto gen_unary_range_plan = [&](proto::plan::OpType op,
+                                    std::string value) {
+        auto column_info = GenColumnInfo(str_meta.get_id().get(),
+                                         proto::schema::DataType::VarChar,
+                                         false,
+                                         false);
+        auto unary_range_expr = GenUnaryRangeExpr(op, value);
+        unary_range_expr->set_allocated_column_info(column_info);
+
+        auto expr = GenExpr().release();
+        expr->set_allocated_unary_range_expr(unary_range_expr);
+
+        auto anns =
+            GenAnns(expr,
+                    fvec_meta.get_data_type() == DataType::VECTOR_BINARY,
+                    fvec_meta.get_id().get(),
+                    "$0");
+
+        auto plan_node = std::make_unique<proto::plan::PlanNode>();
+        plan_node->set_allocated_vector_anns(anns);
+        return plan_node;
+    };
+
+    std::vector<std::tuple<proto::plan::OpType,
+                           std::string,
+                           std::function<bool(std::string)>>>
+        testcases{
+            {proto::plan::OpType::Equal,
+             "tag_5",
+             [](std::string val) { return val == "tag_5"; }},
+            {proto::plan::OpType::NotEqual,
+             "tag_5",
+             [](std::string val) { return val != "tag_5"; }},
+            {proto::plan::OpType::GreaterThan,
+             "tag_3",
+             [](std::string val) { return val > "tag_3"; }},
+            {proto::plan::OpType::LessEqual,
+             "tag_11",
+             [](std::string val) { return val <= "tag_11"; }},
+            {proto::plan::OpType::PrefixMatch,
+             "tag_1",
+             [](std::string val) { return PrefixMatch(val, "tag_1"); }},
+        };
+
+    ExecExprVisitor visitor(*seg, seg->get_row_count(), MAX_TIMESTAMP);
+    for (const auto& [op, value, ref_func] : testcases) {
+        auto plan_proto = gen_unary_range_plan(op, value);
+        auto plan = ProtoParser(*schema).CreatePlan(*plan_proto);
+        auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+        EXPECT_EQ(final.size(), N);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(final[i], ref_func(str_col[i]))
+                << "@" << op << "@" << value << "@" << i;
+        }
+    }
+
+    std::vector<std::string> term{"tag_2", "tag_12", "not_exist"};
+    auto plan_proto = GenTermPlan(fvec_meta, str_meta, term);
+    auto plan = ProtoParser(*schema).CreatePlan(*plan_proto);
+    auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+    EXPECT_EQ(final.size(), N);
+    for (int i = 0; i < N; ++i) {
+        auto ref = std::find(term.begin(), term.end(), str_col[i]) != term.end();
+        ASSERT_EQ(final[i], ref) << "@" << i;
+    }
+
+    // unique values are left as they are
+    auto unique_data = DataGen(schema, N);
+    auto unique_seg = SealedCreator(schema, unique_data);
+    ASSERT_EQ(unique_seg->chunk_string_dictionary(str_meta.get_id(), 0),
+              nullptr);
+}
+
 TEST(StringExpr, BinaryRange) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -678,8 +787,10 @@ TEST(AlwaysTrueStringPlan, SearchWithOutputFields) {
         dim,       //
         query_ptr  //
     };
-    auto sub_result = BruteForceSearch(
-        search_dataset, vec_col.data(), N, knowhere::Json(), nullptr);
+    auto params =
+        ParseSearchParams(knowhere::Json(), topk, knowhere::metric::L2);
+    auto sub_result =
+        BruteForceSearch(search_dataset, vec_col.data(), N, *params, nullptr);
 
     auto sr = segment->Search(plan.get(), ph_group.get(), time);
     segment->FillPrimaryKeys(plan.get(), *sr);
@@ -695,7 +806,7 @@ TEST(AlwaysTrueStringPlan, SearchWithOutputFields) {
         for (auto k = 0; k < topk; k++) {
             auto offset = q * topk + k;
             auto seg_offset = sub_result.get_seg_offsets()[offset];
-            ASSERT_EQ(std::get<std::string>(sr->primary_keys_[offset]),
+            ASSERT_EQ(sr->string_pks_[offset],
                       str_col[seg_offset]);
             ASSERT_EQ(retrieved_str_col[offset], str_col[seg_offset]);
         }
@@ -10,13 +10,18 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <unordered_set>
 
 #include "index/Index.h"
 #include "index/ScalarIndex.h"
 
 #define private public
 #include "index/StringIndexMarisa.h"
+#include "index/StringIndexInverted.h"
+#include "index/StringIndexNgram.h"
 
+#include "common/Common.h"
 #include "index/IndexFactory.h"
 #include "test_utils/indexbuilder_test_utils.h"
 #include "test_utils/AssertUtils.h"
@@ -47,6 +52,25 @@ TEST_F(StringIndexMarisaTest, Build) {
     index->Build(strs.size(), strs.data());
 }
 
+TEST_F(StringIndexMarisaTest, ParallelBuild) {
+    milvus::SetIndexBuildParallelism(4);
+    int64_t n = MIN_SCALAR_INDEX_BUILD_ROWS_PER_TASK * 4 + 3;
+    std::vector<std::string> values(n);
+    for (int64_t i = 0; i < n; ++i) {
+        values[i] = std::to_string(i % 1000);
+    }
+    auto index = milvus::index::CreateStringIndexMarisa();
+    index->Build(n, values.data());
+    ASSERT_EQ(n, index->Count());
+    ASSERT_EQ(1000, index->trie_.num_keys());
+    for (int64_t i = 0; i < n; i += 97) {
+        ASSERT_EQ(values[i], index->Reverse_Lookup(i));
+    }
+    auto bitset = index->In(1, values.data());
+    ASSERT_EQ(n / 1000 + 1, bitset.count());
+    milvus::SetIndexBuildParallelism(DEFAULT_INDEX_BUILD_PARALLELISM);
+}
+
 TEST_F(StringIndexMarisaTest, Count) {
     auto index = milvus::index::CreateStringIndexMarisa();
     index->Build(nb, strs.data());
@@ -108,6 +132,54 @@ TEST_F(StringIndexMarisaTest, Range) {
     }
 }
 
+TEST_F(StringIndexMarisaTest, RangeOnKeyOrder) {
+    auto index = milvus::index::CreateStringIndexMarisa();
+    std::vector<std::string> strings(nb);
+    for (int i = 0; i < nb; ++i) {
+        strings[i] = std::to_string(std::rand() % 37);
+    }
+    strings[0] = "";
+    index->Build(nb, strings.data());
+
+    std::vector<std::string> bounds{"", "1", "15", "2", "3a", "9", "99"};
+    for (auto& value : bounds) {
+        auto check = [&](milvus::OpType op, auto pred) {
+            auto bitset = index->Range(value, op);
+            ASSERT_EQ(bitset.size(), nb);
+            for (int i = 0; i < nb; ++i) {
+                ASSERT_EQ(bitset[i], pred(strings[i]))
+                    << "value " << value << " op " << int(op);
+            }
+        };
+        check(milvus::OpType::LessThan,
+              [&](const std::string& s) { return s < value; });
+        check(milvus::OpType::LessEqual,
+              [&](const std::string& s) { return s <= value; });
+        check(milvus::OpType::GreaterThan,
+              [&](const std::string& s) { return s > value; });
+        check(milvus::OpType::GreaterEqual,
+              [&](const std::string& s) { return s >= value; });
+    }
+    for (auto& lower : bounds) {
+        for (auto& upper : bounds) {
+            for (auto lb_inclusive : {true, false}) {
+                for (auto ub_inclusive : {true, false}) {
+                    auto bitset =
+                        index->Range(lower, lb_inclusive, upper, ub_inclusive);
+                    ASSERT_EQ(bitset.size(), nb);
+                    for (int i = 0; i < nb; ++i) {
+                        auto& s = strings[i];
+                        auto expected =
+                            (lb_inclusive ? s >= lower : s > lower) &&
+                            (ub_inclusive ? s <= upper : s < upper);
+                        ASSERT_EQ(bitset[i], expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
 TEST_F(StringIndexMarisaTest, Reverse) {
     auto index_types = GetIndexTypes<std::string>();
     for (const auto& index_type : index_types) {
@@ -118,6 +190,32 @@ TEST_F(StringIndexMarisaTest, Reverse) {
     }
 }
 
+TEST_F(StringIndexMarisaTest, BatchedReverse) {
+    // every key twice, the rows looked up in a shuffled order, the second
+    // lookup decodes them
+    std::vector<std::string> values(strs);
+    values.insert(values.end(), strs.begin(), strs.end());
+    std::vector<int64_t> offsets(values.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        offsets[i] = (i * 37) % values.size();
+    }
+    milvus::SetReverseLookupCacheFactor(2);
+    auto index_types = GetIndexTypes<std::string>();
+    for (const auto& index_type : index_types) {
+        auto index = milvus::index::IndexFactory::GetInstance()
+                         .CreateScalarIndex<std::string>(index_type);
+        index->Build(values.size(), values.data());
+        for (int round = 0; round < 2; ++round) {
+            std::vector<std::string> res(offsets.size());
+            index->ReverseLookup(offsets.data(), offsets.size(), res.data());
+            for (size_t i = 0; i < offsets.size(); ++i) {
+                ASSERT_EQ(values[offsets[i]], res[i]);
+            }
+        }
+    }
+    milvus::SetReverseLookupCacheFactor(DEFAULT_REVERSE_LOOKUP_CACHE_FACTOR);
+}
+
 TEST_F(StringIndexMarisaTest, PrefixMatch) {
     auto index = milvus::index::CreateStringIndexMarisa();
     index->Build(nb, strs.data());
@@ -130,6 +228,23 @@ TEST_F(StringIndexMarisaTest, PrefixMatch) {
     }
 }
 
+TEST_F(StringIndexMarisaTest, CountPrefixMatch) {
+    auto index = milvus::index::CreateStringIndexMarisa();
+    index->Build(nb, strs.data());
+
+    auto count = [](const milvus::TargetBitmap& bitmap) {
+        return std::count(bitmap.begin(), bitmap.end(), true);
+    };
+    for (size_t i = 0; i < strs.size(); i++) {
+        auto prefix = strs[i].substr(0, 1);
+        ASSERT_EQ(index->CountPrefixMatch(prefix),
+                  count(index->PrefixMatch(prefix)));
+    }
+    std::vector<std::string> values{strs[0], strs[1], strs[0], "not_exist"};
+    ASSERT_EQ(index->CountIn(values.size(), values.data()),
+              count(index->In(values.size(), values.data())));
+}
+
 TEST_F(StringIndexMarisaTest, Query) {
     auto index = milvus::index::CreateStringIndexMarisa();
     index->Build(nb, strs.data());
@@ -338,3 +453,121 @@ TEST_F(StringIndexMarisaTest, BaseIndexCodec) {
         }
     }
 }
+
+class StringIndexInvertedTest : public StringIndexBaseTest {};
+
+TEST_F(StringIndexInvertedTest, TermFilter) {
+    // ids of many users with a few rows each
+    int64_t n = 100000;
+    std::vector<std::string> user_ids(n);
+    for (int64_t i = 0; i < n; ++i) {
+        user_ids[i] = "user_" + std::to_string((i * 7919) % 20000);
+    }
+    auto index = milvus::index::CreateStringIndexInverted();
+    index->Build(n, user_ids.data());
+    ASSERT_EQ(n, index->Count());
+
+    std::vector<std::string> terms;
+    for (int64_t i = 0; i < 10000; i += 7) {
+        terms.push_back("user_" + std::to_string(i));
+    }
+    terms.emplace_back("not_exist");
+    std::unordered_set<std::string> term_set(terms.begin(), terms.end());
+    auto bitset = index->In(terms.size(), terms.data());
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        auto expected = term_set.count(user_ids[i]) > 0;
+        ASSERT_EQ(expected, bitset[i]);
+        count += expected;
+    }
+    ASSERT_EQ(count, index->CountIn(terms.size(), terms.data()));
+}
+
+TEST_F(StringIndexInvertedTest, Codec) {
+    auto index = milvus::index::CreateStringIndexInverted();
+    index->Build(nb, strs.data());
+    auto binary_set = index->Serialize({});
+
+    auto copy_index = std::make_unique<milvus::index::StringIndexInverted>();
+    copy_index->Load(binary_set);
+    ASSERT_EQ(nb, copy_index->Count());
+    assert_reverse<std::string>(copy_index.get(), strs);
+    assert_in<std::string>(copy_index.get(), strs);
+    assert_not_in<std::string>(copy_index.get(), strs);
+    for (size_t i = 0; i < strs.size(); i++) {
+        auto prefix = strs[i].substr(0, 1);
+        auto bitset = copy_index->PrefixMatch(prefix);
+        ASSERT_TRUE(bitset[i]);
+        ASSERT_EQ(copy_index->CountPrefixMatch(prefix),
+                  std::count(bitset.begin(), bitset.end(), true));
+    }
+    auto bitset = copy_index->Range("0", milvus::OpType::GreaterEqual);
+    for (size_t i = 0; i < strs.size(); i++) {
+        ASSERT_EQ(strs[i] >= "0", bitset[i]);
+    }
+}
+
+TEST(LikePattern, Match) {
+    using milvus::LikePattern;
+    using milvus::OpType;
+    ASSERT_TRUE(LikePattern(OpType::Match, "%")("anything"));
+    ASSERT_TRUE(LikePattern(OpType::Match, "%")(""));
+    ASSERT_TRUE(LikePattern(OpType::Match, "")(""));
+    ASSERT_FALSE(LikePattern(OpType::Match, "")("a"));
+    ASSERT_TRUE(LikePattern(OpType::Match, "a%a")("aa"));
+    ASSERT_FALSE(LikePattern(OpType::Match, "a%a")("a"));
+    ASSERT_TRUE(LikePattern(OpType::Match, "%ab%cd")("xabyabcd"));
+    ASSERT_FALSE(LikePattern(OpType::Match, "%ab%cd")("xcdab"));
+    ASSERT_TRUE(LikePattern(OpType::Match, "50\\%")("50%"));
+    ASSERT_FALSE(LikePattern(OpType::Match, "50\\%")("500"));
+    ASSERT_TRUE(LikePattern(OpType::PostfixMatch, "cd")("abcd"));
+    ASSERT_FALSE(LikePattern(OpType::PostfixMatch, "cd")("cdab"));
+    ASSERT_TRUE(LikePattern(OpType::PrefixMatch, "ab")("abcd"));
+}
+
+class StringIndexNgramTest : public StringIndexBaseTest {};
+
+TEST_F(StringIndexNgramTest, PatternMatch) {
+    int64_t n = 10000;
+    std::vector<std::string> urls(n);
+    for (int64_t i = 0; i < n; ++i) {
+        urls[i] = "https://host" + std::to_string(i % 97) + ".com/page/" +
+                  std::to_string((i * 7919) % 3000);
+    }
+    auto index = milvus::index::CreateStringIndexNgram();
+    index->Build(n, urls.data());
+    ASSERT_EQ(n, index->Count());
+
+    auto binary_set = index->Serialize({});
+    auto copy_index = std::make_unique<milvus::index::StringIndexNgram>();
+    copy_index->Load(binary_set);
+    ASSERT_EQ(n, copy_index->Count());
+    ASSERT_EQ(dynamic_cast<milvus::index::StringIndexNgram*>(index.get())
+                  ->NumGrams(),
+              copy_index->NumGrams());
+
+    std::vector<std::pair<milvus::OpType, std::string>> patterns = {
+        {milvus::OpType::Match, "%host42.com%"},
+        {milvus::OpType::Match, "%page/12%"},
+        {milvus::OpType::Match, "https://host1%/page/2%5"},
+        {milvus::OpType::Match, "%/1"},
+        {milvus::OpType::Match, "%not_exist%"},
+        {milvus::OpType::Match, "https://host3.com/page/1"},
+        {milvus::OpType::PostfixMatch, "/page/77"},
+    };
+    for (auto& [op, value] : patterns) {
+        milvus::LikePattern pattern(op, value);
+        std::vector<milvus::index::StringIndex*> indexes = {
+            index.get(), copy_index.get()};
+        for (auto* idx : indexes) {
+            auto dataset = std::make_shared<milvus::Dataset>();
+            dataset->Set<milvus::OpType>(milvus::index::OPERATOR_TYPE, op);
+            dataset->Set<std::string>(milvus::index::PATTERN_VALUE, value);
+            auto bitset = idx->Query(dataset);
+            ASSERT_EQ(n, bitset.size());
+            for (int64_t i = 0; i < n; ++i) {
+                ASSERT_EQ(pattern(urls[i]), bitset[i]) << value;
+            }
+        }
+    }
+}
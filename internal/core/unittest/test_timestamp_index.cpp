@@ -10,6 +10,9 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
 #include <vector>
 
 #include "segcore/TimestampIndex.h"
@@ -66,3 +69,174 @@ TEST(TimestampIndex, Naive) {
     ASSERT_EQ(range.first, 8);
     ASSERT_EQ(range.second, 8);
 }
+
+TEST(TimestampIndex, GenerateBitset) {
+    std::default_random_engine e(42);
+    int64_t size = 1000;
+    std::vector<Timestamp> timestamps(size);
+    for (auto& ts : timestamps) {
+        ts = e() % 100;
+    }
+    // the sign bit must not break the unsigned order
+    timestamps[7] = std::numeric_limits<Timestamp>::max();
+
+    std::vector<std::pair<int64_t, int64_t>> ranges{
+        {0, size}, {0, 64}, {3, 5}, {63, 129}, {100, 999}, {640, 1000}};
+    for (Timestamp query_ts : {Timestamp(0), Timestamp(50), Timestamp(99)}) {
+        for (auto [beg, end] : ranges) {
+            auto bitset = TimestampIndex::GenerateBitset(
+                query_ts, {beg, end}, timestamps.data(), size);
+            ASSERT_EQ(bitset.size(), size);
+            for (int64_t i = 0; i < size; ++i) {
+                auto expected =
+                    i >= end || (i >= beg && timestamps[i] > query_ts);
+                ASSERT_EQ(bitset[i], expected)
+                    << "row " << i << " range [" << beg << ", " << end << ")";
+            }
+        }
+    }
+}
+
+TEST(TimestampIndex, MaskNewerTimestamps) {
+    std::vector<Timestamp> timestamps{5, 1, 9, 3, 7};
+    BitsetType bitset(70);
+    bitset.set(0);
+    TimestampIndex::MaskNewerTimestamps(
+        4, timestamps.data(), 62, 67, bitset);
+    ASSERT_EQ(bitset.count(), 4);
+    ASSERT_TRUE(bitset[0]);
+    ASSERT_TRUE(bitset[62]);
+    ASSERT_TRUE(bitset[64]);
+    ASSERT_TRUE(bitset[66]);
+}
+
+TEST(TimestampIndex, MaskNewerRows) {
+    // ordered blocks with a single out of order row near the end, the
+    // fake slices collapse into one huge undecided range
+    int64_t size = 5 * TimestampIndex::kBlockSize + 100;
+    std::vector<Timestamp> timestamps(size);
+    for (int64_t i = 0; i < size; ++i) {
+        timestamps[i] = 10 + i;
+    }
+    timestamps[size - 10] = 1;
+    timestamps[TimestampIndex::kBlockSize * 2 + 17] = 5 + size;
+
+    TimestampIndex index;
+    index.set_length_meta(GenerateFakeSlices(
+        timestamps.data(), size, TimestampIndex::kBlockSize));
+    index.build_with(timestamps.data(), size);
+
+    for (Timestamp query_ts : {Timestamp(0),
+                               Timestamp(100),
+                               Timestamp(TimestampIndex::kBlockSize * 3),
+                               Timestamp(size + 5),
+                               Timestamp(size * 2)}) {
+        BitsetType bitset(size);
+        index.mask_newer_rows(query_ts, timestamps.data(), bitset);
+        for (int64_t i = 0; i < size; ++i) {
+            ASSERT_EQ(bitset[i], timestamps[i] > query_ts)
+                << "row " << i << " query " << query_ts;
+        }
+    }
+
+    PackedTimestamps packed;
+    packed.build(timestamps.data(), size);
+    for (Timestamp query_ts : {Timestamp(100), Timestamp(size + 5)}) {
+        BitsetType expected(size);
+        index.mask_newer_rows(query_ts, timestamps.data(), expected);
+        BitsetType bitset(size);
+        index.mask_newer_rows(query_ts, packed, bitset);
+        ASSERT_EQ(bitset, expected);
+    }
+}
+
+TEST(TimestampIndex, MaskExpiredRows) {
+    std::vector<Timestamp> older{5, 1, 9, 3, 7};
+    BitsetType older_bitset(70);
+    TimestampIndex::MaskOlderTimestamps(
+        4, older.data(), 62, 67, older_bitset);
+    ASSERT_EQ(older_bitset.count(), 2);
+    ASSERT_TRUE(older_bitset[63]);
+    ASSERT_TRUE(older_bitset[65]);
+
+    // ordered blocks with an old row in the last one, the blocks before the
+    // expire timestamp are set whole, the straddling ones row by row
+    int64_t size = 5 * TimestampIndex::kBlockSize + 100;
+    std::vector<Timestamp> timestamps(size);
+    for (int64_t i = 0; i < size; ++i) {
+        timestamps[i] = 10 + i;
+    }
+    timestamps[size - 10] = 1;
+    TimestampIndex index;
+    index.set_length_meta(GenerateFakeSlices(
+        timestamps.data(), size, TimestampIndex::kBlockSize));
+    index.build_with(timestamps.data(), size);
+    ASSERT_EQ(index.max_timestamp(), Timestamp(size + 9));
+    PackedTimestamps packed;
+    packed.build(timestamps.data(), size);
+
+    for (Timestamp expire_ts : {Timestamp(1),
+                                Timestamp(2),
+                                Timestamp(TimestampIndex::kBlockSize * 3),
+                                Timestamp(size * 2)}) {
+        BitsetType bitset(size);
+        index.mask_expired_rows(expire_ts, packed, bitset);
+        for (int64_t i = 0; i < size; ++i) {
+            ASSERT_EQ(bitset[i], timestamps[i] < expire_ts)
+                << "row " << i << " expire " << expire_ts;
+        }
+    }
+    ASSERT_EQ(TimestampIndex().max_timestamp(), 0);
+}
+
+TEST(TimestampIndex, PackedTimestamps) {
+    // a block of equal timestamps, a narrow one, one of full range and a
+    // partial last one
+    int64_t size = 3 * PackedTimestamps::kBlockSize + 77;
+    std::vector<Timestamp> timestamps(size);
+    std::default_random_engine er(42);
+    for (int64_t i = 0; i < size; ++i) {
+        auto block_id = i / PackedTimestamps::kBlockSize;
+        if (block_id == 0) {
+            timestamps[i] = 449900000000000000ULL;
+        } else if (block_id == 1) {
+            timestamps[i] = 449900000000000000ULL + er() % 1000;
+        } else if (block_id == 2) {
+            timestamps[i] = (uint64_t(er()) << 32) ^ er();
+        } else {
+            timestamps[i] = i;
+        }
+    }
+    timestamps[2 * PackedTimestamps::kBlockSize] = 0;
+    timestamps[2 * PackedTimestamps::kBlockSize + 1] =
+        std::numeric_limits<Timestamp>::max();
+
+    PackedTimestamps packed;
+    packed.build(timestamps.data(), size);
+    ASSERT_EQ(packed.size(), size);
+    ASSERT_LT(packed.memory_bytes(), size * sizeof(Timestamp));
+    for (int64_t i = 0; i < size; ++i) {
+        ASSERT_EQ(packed[i], timestamps[i]) << "row " << i;
+    }
+
+    std::vector<Timestamp> decoded(PackedTimestamps::kBlockSize);
+    for (int64_t block_id = 0; block_id < 4; ++block_id) {
+        auto beg = block_id * PackedTimestamps::kBlockSize + 3;
+        auto end = std::min(size, beg - 3 + PackedTimestamps::kBlockSize);
+        packed.decode(beg, end, decoded.data());
+        for (auto i = beg; i < end; ++i) {
+            ASSERT_EQ(decoded[i - beg], timestamps[i]) << "row " << i;
+        }
+    }
+    ASSERT_ANY_THROW(packed.decode(0, size, decoded.data()));
+
+    std::vector<int64_t> offsets{size - 1, 0, 2 * 4096 + 1, 4096 + 5};
+    std::vector<Timestamp> gathered(offsets.size());
+    packed.gather(offsets.data(), offsets.size(), gathered.data());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        ASSERT_EQ(gathered[i], timestamps[offsets[i]]);
+    }
+
+    packed.clear();
+    ASSERT_TRUE(packed.empty());
+}
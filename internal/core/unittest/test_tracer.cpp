@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <random>
+#include <thread>
 
 #include "common/Tracer.h"
 #include "exceptions/EasyAssert.h"
@@ -71,3 +72,51 @@ TEST(Tracer, Span) {
     delete[] ctx->traceID;
     delete[] ctx->spanID;
 }
+
+TEST(Tracer, SampledScopes) {
+    auto config = std::make_shared<TraceConfig>();
+    config->exporter = "stdout";
+    config->nodeID = 1;
+    initTelementry(config.get());
+
+    uint8_t trace_id[16] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                            0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10};
+    uint8_t span_id[8] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef};
+    TraceContext unsampled{trace_id, span_id, 0};
+    TraceContext sampled{trace_id, span_id, kTraceFlagSampled};
+    ASSERT_FALSE(IsSampled(nullptr));
+    ASSERT_FALSE(IsSampled(&unsampled));
+    ASSERT_TRUE(IsSampled(&sampled));
+
+    {
+        TraceScope scope("unsampled", &unsampled);
+        ASSERT_EQ(GetActiveSpan(), nullptr);
+        AutoSpan span("phase");
+        ASSERT_EQ(GetActiveSpan(), nullptr);
+    }
+
+    {
+        TraceScope scope("sampled", &sampled);
+        auto root = GetActiveSpan();
+        ASSERT_NE(root, nullptr);
+        ASSERT_TRUE(root->GetContext().trace_id() ==
+                    trace::TraceId({trace_id, 16}));
+        {
+            AutoSpan span("phase");
+            auto phase = GetActiveSpan();
+            ASSERT_NE(phase, root);
+            ASSERT_TRUE(phase->GetContext().trace_id() ==
+                        root->GetContext().trace_id());
+        }
+        ASSERT_EQ(GetActiveSpan(), root);
+
+        // a worker picks the trace up from the span it is passed
+        std::thread worker([root] {
+            ASSERT_EQ(GetActiveSpan(), nullptr);
+            ActiveSpanScope scope(root);
+            ASSERT_EQ(GetActiveSpan(), root);
+        });
+        worker.join();
+    }
+    ASSERT_EQ(GetActiveSpan(), nullptr);
+}
@@ -12,8 +12,13 @@
 #include <gtest/gtest.h>
 #include <string.h>
 
+#include <numeric>
+
+#include "common/Common.h"
+#include "common/Slice.h"
 #include "common/Utils.h"
 #include "query/Utils.h"
+#include "segcore/SegmentedBitmap.h"
 #include "test_utils/DataGen.h"
 
 TEST(Util, StringMatch) {
@@ -39,6 +44,45 @@ TEST(Util, StringMatch) {
     ASSERT_FALSE(PostfixMatch("dontmatch", "postfix"));
 }
 
+TEST(Util, SliceAssembler) {
+    auto slice_size_mb = milvus::index_file_slice_size;
+    milvus::SetIndexSliceSize(1);
+    int64_t big_size = (5 << 20) / 2;
+    std::shared_ptr<uint8_t[]> big(new uint8_t[big_size]);
+    std::iota(big.get(), big.get() + big_size, 0);
+    milvus::BinarySet binary_set;
+    binary_set.Append("big", big, big_size);
+    milvus::Disassemble(binary_set);
+    milvus::SetIndexSliceSize(slice_size_mb);
+    ASSERT_FALSE(binary_set.Contains("big"));
+    ASSERT_EQ(binary_set.GetByName("big_1")->data.get(),
+              big.get() + (1 << 20));
+
+    // placed in any order, copies of the slices assemble the same binary
+    milvus::BinarySet loaded;
+    for (auto& [key, binary] : binary_set.binary_map_) {
+        std::shared_ptr<uint8_t[]> data(new uint8_t[binary->size]);
+        memcpy(data.get(), binary->data.get(), binary->size);
+        loaded.Append(key, data, binary->size);
+    }
+    milvus::SliceAssembler assembler(milvus::EraseSliceMeta(loaded));
+    for (auto key : {"big_2", "big_0", "big_1"}) {
+        auto slice = loaded.Erase(key);
+        ASSERT_TRUE(assembler.Place(key, slice->data.get(), slice->size));
+    }
+    ASSERT_FALSE(assembler.Place("small", big.get(), 10));
+    assembler.Finish(loaded);
+    auto assembled = loaded.GetByName("big");
+    ASSERT_EQ(assembled->size, big_size);
+    ASSERT_EQ(memcmp(assembled->data.get(), big.get(), big_size), 0);
+
+    // the slices still view the binary, which is assembled without copies
+    milvus::Assemble(binary_set);
+    ASSERT_EQ(binary_set.binary_map_.size(), 1);
+    ASSERT_EQ(binary_set.GetByName("big")->data.get(), big.get());
+    ASSERT_EQ(binary_set.GetByName("big")->size, big_size);
+}
+
 TEST(Util, GetDeleteBitmap) {
     using namespace milvus;
     using namespace milvus::query;
@@ -72,9 +116,7 @@ TEST(Util, GetDeleteBitmap) {
     std::vector<Timestamp> delete_ts = {0};
     std::vector<PkType> delete_pk = {1};
     auto offset = delete_record.reserved.fetch_add(1);
-    delete_record.timestamps_.set_data_raw(offset, delete_ts.data(), 1);
-    delete_record.pks_.set_data_raw(offset, delete_pk.data(), 1);
-    delete_record.ack_responder_.AddSegment(offset, offset + 1);
+    delete_record.push(offset, delete_pk.data(), delete_ts.data(), 1);
 
     auto query_timestamp = tss[N - 1];
     auto del_barrier = get_barrier(delete_record, query_timestamp);
@@ -84,15 +126,13 @@ TEST(Util, GetDeleteBitmap) {
                                          delete_record,
                                          insert_record,
                                          query_timestamp);
-    ASSERT_EQ(res_bitmap->bitmap_ptr->count(), 0);
+    ASSERT_EQ(res_bitmap->bitmap.count(), 0);
 
     // test case insert repeated pk1 (ts = {1 ... N}) -> delete pk1 (ts = N) -> query (ts = N)
     delete_ts = {uint64_t(N)};
     delete_pk = {1};
     offset = delete_record.reserved.fetch_add(1);
-    delete_record.timestamps_.set_data_raw(offset, delete_ts.data(), 1);
-    delete_record.pks_.set_data_raw(offset, delete_pk.data(), 1);
-    delete_record.ack_responder_.AddSegment(offset, offset + 1);
+    delete_record.push(offset, delete_pk.data(), delete_ts.data(), 1);
 
     del_barrier = get_barrier(delete_record, query_timestamp);
     res_bitmap = get_deleted_bitmap(del_barrier,
@@ -100,12 +140,137 @@ TEST(Util, GetDeleteBitmap) {
                                     delete_record,
                                     insert_record,
                                     query_timestamp);
-    ASSERT_EQ(res_bitmap->bitmap_ptr->count(), N - 1);
+    ASSERT_EQ(res_bitmap->bitmap.count(), N - 1);
 
     // test case insert repeated pk1 (ts = {1 ... N}) -> delete pk1 (ts = N) -> query (ts = N/2)
     query_timestamp = tss[N - 1] / 2;
     del_barrier = get_barrier(delete_record, query_timestamp);
     res_bitmap = get_deleted_bitmap(
         del_barrier, N, delete_record, insert_record, query_timestamp);
-    ASSERT_EQ(res_bitmap->bitmap_ptr->count(), 0);
+    ASSERT_EQ(res_bitmap->bitmap.count(), 0);
+}
+
+TEST(Util, SegmentedBitmapCopyOnWrite) {
+    using namespace milvus;
+    using namespace milvus::segcore;
+    constexpr int64_t N = SegmentedBitmap::BLOCK_BITS * 2 + 100;
+
+    SegmentedBitmap base;
+    base.resize(N);
+    base.set(1);
+    base.set(SegmentedBitmap::BLOCK_BITS + 1);
+    ASSERT_EQ(base.count(), 2);
+
+    auto next = base;
+    next.resize(N + SegmentedBitmap::BLOCK_BITS);
+    next.set(N + 1);
+    next.reset(1);
+    next.set(N - 1);
+
+    // the base version is untouched
+    ASSERT_EQ(base.size(), N);
+    ASSERT_EQ(base.count(), 2);
+    ASSERT_TRUE(base.test(1));
+    ASSERT_FALSE(base.test(N - 1));
+
+    ASSERT_EQ(next.count(), 3);
+    ASSERT_FALSE(next.test(1));
+    ASSERT_TRUE(next.test(SegmentedBitmap::BLOCK_BITS + 1));
+    ASSERT_TRUE(next.test(N - 1));
+    ASSERT_TRUE(next.test(N + 1));
+
+    BitsetType bitset(next.size());
+    bitset.set(0);
+    next.or_to(bitset);
+    ASSERT_EQ(bitset.count(), 4);
+    ASSERT_TRUE(bitset[0]);
+    ASSERT_TRUE(bitset[N + 1]);
+    ASSERT_EQ(next.to_bitset().count(), 3);
+
+    next.resize(N - 1);
+    ASSERT_EQ(next.count(), 1);
+    ASSERT_EQ(base.count(), 2);
+}
+
+TEST(Util, MergeDataArray) {
+    using namespace milvus;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto int8_fid = schema->AddDebugField("int8", DataType::INT8);
+    auto int64_fid = schema->AddDebugField("int64", DataType::INT64);
+    auto str_fid = schema->AddDebugField("str", DataType::VARCHAR);
+    auto fvec_fid = schema->AddDebugField(
+        "fvec", DataType::VECTOR_FLOAT, 4, knowhere::metric::L2);
+    auto bvec_fid = schema->AddDebugField(
+        "bvec", DataType::VECTOR_BINARY, 16, knowhere::metric::HAMMING);
+    constexpr int64_t N = 10;
+
+    // result r holds the value r * 100 + i at row i of every field
+    SearchResult results[2];
+    for (int r = 0; r < 2; ++r) {
+        std::vector<int8_t> int8s;
+        std::vector<int64_t> int64s;
+        std::vector<std::string> strs;
+        std::vector<float> fvecs;
+        std::vector<uint8_t> bvecs;
+        for (int i = 0; i < N; ++i) {
+            auto value = r * 100 + i;
+            int8s.push_back(value % 128);
+            int64s.push_back(value);
+            strs.push_back(std::to_string(value));
+            for (int d = 0; d < 4; ++d) {
+                fvecs.push_back(value + d * 0.25f);
+            }
+            bvecs.push_back(value % 256);
+            bvecs.push_back(r);
+        }
+        auto& data = results[r].output_fields_data_;
+        data[int8_fid] =
+            CreateScalarDataArrayFrom(int8s.data(), N, (*schema)[int8_fid]);
+        data[int64_fid] =
+            CreateScalarDataArrayFrom(int64s.data(), N, (*schema)[int64_fid]);
+        data[str_fid] =
+            CreateScalarDataArrayFrom(strs.data(), N, (*schema)[str_fid]);
+        data[fvec_fid] =
+            CreateVectorDataArrayFrom(fvecs.data(), N, (*schema)[fvec_fid]);
+        data[bvec_fid] =
+            CreateVectorDataArrayFrom(bvecs.data(), N, (*schema)[bvec_fid]);
+    }
+
+    // runs of consecutive rows, single rows and rows out of order
+    std::vector<std::pair<int, int64_t>> rows = {
+        {0, 0}, {0, 1}, {0, 2}, {1, 5}, {0, 7}, {1, 6}, {1, 7}, {1, 0}};
+    std::vector<std::pair<SearchResult*, int64_t>> result_offsets;
+    for (auto [r, i] : rows) {
+        result_offsets.emplace_back(&results[r], i);
+    }
+
+    auto int8s = MergeDataArray(result_offsets, (*schema)[int8_fid]);
+    auto int64s = MergeDataArray(result_offsets, (*schema)[int64_fid]);
+    auto strs = MergeDataArray(result_offsets, (*schema)[str_fid]);
+    auto fvecs = MergeDataArray(result_offsets, (*schema)[fvec_fid]);
+    auto bvecs = MergeDataArray(result_offsets, (*schema)[bvec_fid]);
+    ASSERT_EQ(int8s->scalars().int_data().data_size(), rows.size());
+    ASSERT_EQ(strs->scalars().string_data().data_size(), rows.size());
+    ASSERT_EQ(fvecs->vectors().float_vector().data_size(), rows.size() * 4);
+    ASSERT_EQ(bvecs->vectors().binary_vector().size(), rows.size() * 2);
+    for (size_t k = 0; k < rows.size(); ++k) {
+        auto [r, i] = rows[k];
+        auto value = r * 100 + i;
+        ASSERT_EQ(int8s->scalars().int_data().data(k), value % 128);
+        ASSERT_EQ(int64s->scalars().long_data().data(k), value);
+        ASSERT_EQ(strs->scalars().string_data().data(k),
+                  std::to_string(value));
+        for (int d = 0; d < 4; ++d) {
+            ASSERT_EQ(fvecs->vectors().float_vector().data(k * 4 + d),
+                      value + d * 0.25f);
+        }
+        auto& bvec = bvecs->vectors().binary_vector();
+        ASSERT_EQ(uint8_t(bvec[k * 2]), value % 256);
+        ASSERT_EQ(uint8_t(bvec[k * 2 + 1]), r);
+    }
+
+    std::vector<std::pair<SearchResult*, int64_t>> empty;
+    auto none = MergeDataArray(empty, (*schema)[int64_fid]);
+    ASSERT_FALSE(none->has_scalars());
 }
@@ -500,6 +500,9 @@ SealedLoadFieldData(const GeneratedData& dataset,
         info.field_data = array.get();
         info.row_count = dataset.row_ids_.size();
         info.field_id = RowFieldID.get();  // field id for RowId
+        if (with_mmap) {
+            info.mmap_dir_path = "./data/mmap-test";
+        }
         seg.LoadFieldData(info);
     }
     {
@@ -0,0 +1,100 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "exceptions/EasyAssert.h"
+#include "storage/ChunkManager.h"
+
+namespace milvus::storage {
+
+// keeps objects in memory and counts the bytes read by ranged reads, a read
+// running past the end of an object is cut short like a remote one
+class MemChunkManager : public RemoteChunkManager {
+ public:
+    bool
+    Exist(const std::string& filepath) override {
+        return objects_.count(filepath) > 0;
+    }
+
+    uint64_t
+    Size(const std::string& filepath) override {
+        return objects_.at(filepath).size();
+    }
+
+    uint64_t
+    Read(const std::string& filepath, void* buf, uint64_t len) override {
+        return Read(filepath, 0, buf, len);
+    }
+
+    void
+    Write(const std::string& filepath, void* buf, uint64_t len) override {
+        auto data = static_cast<uint8_t*>(buf);
+        objects_[filepath] = std::vector<uint8_t>(data, data + len);
+    }
+
+    uint64_t
+    Read(const std::string& filepath,
+         uint64_t offset,
+         void* buf,
+         uint64_t len) override {
+        auto& object = objects_.at(filepath);
+        if (offset >= object.size()) {
+            return 0;
+        }
+        len = std::min<uint64_t>(len, object.size() - offset);
+        memcpy(buf, object.data() + offset, len);
+        read_bytes_ += len;
+        return len;
+    }
+
+    void
+    Write(const std::string& filepath,
+          uint64_t offset,
+          void* buf,
+          uint64_t len) override {
+        PanicInfo("not implemented");
+    }
+
+    std::vector<std::string>
+    ListWithPrefix(const std::string& filepath) override {
+        return {};
+    }
+
+    void
+    Remove(const std::string& filepath) override {
+        objects_.erase(filepath);
+    }
+
+    std::string
+    GetName() const override {
+        return "MemChunkManager";
+    }
+
+    std::atomic<uint64_t> read_bytes_ = 0;
+
+ private:
+    std::map<std::string, std::vector<uint8_t>> objects_;
+};
+
+}  // namespace milvus::storage
@@ -20,6 +20,7 @@
 #include <yaml-cpp/yaml.h>
 
 #include "DataGen.h"
+#include "index/Meta.h"
 #include "index/ScalarIndex.h"
 #include "index/StringIndex.h"
 #include "index/Utils.h"
@@ -249,6 +250,7 @@ generate_build_conf(const milvus::IndexType& index_type,
             {milvus::index::DISK_ANN_SEARCH_LIST_SIZE, std::to_string(128)},
             {milvus::index::DISK_ANN_PQ_CODE_BUDGET, std::to_string(0.001)},
             {milvus::index::DISK_ANN_BUILD_DRAM_BUDGET, std::to_string(32)},
+            {milvus::index::DISK_ANN_RAW_VECTOR_SIDECAR, "true"},
         };
     }
     return knowhere::Json();
@@ -591,13 +593,15 @@ GenDsFromPB(const google::protobuf::Message& msg) {
 template <typename T>
 inline std::vector<std::string>
 GetIndexTypes() {
-    return std::vector<std::string>{"inverted_index"};
+    return std::vector<std::string>{"inverted_index",
+                                    milvus::index::BITMAP_INDEX_TYPE};
 }
 
 template <>
 inline std::vector<std::string>
 GetIndexTypes<std::string>() {
-    return std::vector<std::string>{"marisa"};
+    return std::vector<std::string>{"marisa",
+                                    milvus::index::INVERTED_INDEX_TYPE};
 }
 
 }  // namespace
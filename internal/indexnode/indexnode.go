@@ -160,6 +160,7 @@ func (i *IndexNode) initKnowhere() {
 
 	localDataRootPath := filepath.Join(Params.LocalStorageCfg.Path.GetValue(), typeutil.IndexNodeRole)
 	initcore.InitLocalStorageConfig(localDataRootPath)
+	initcore.InitRemoteConnectionConfig(Params)
 }
 
 func (i *IndexNode) initSession() error {
@@ -209,6 +209,7 @@ func (node *QueryNode) querySegments(ctx context.Context, req *querypb.QueryRequ
 		return nil, err
 	}
 	defer retrievePlan.Delete()
+	retrievePlan.SetLimit(req.Req.GetLimit())
 
 	var results []*segcorepb.RetrieveResults
 	if req.GetScope() == querypb.DataScope_Historical {
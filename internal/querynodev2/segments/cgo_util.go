@@ -27,6 +27,7 @@ package segments
 import "C"
 
 import (
+	"context"
 	"fmt"
 	"unsafe"
 
@@ -57,6 +58,60 @@ func HandleCStatus(status *C.CStatus, extraInfo string) error {
 	return errors.New(finalMsg)
 }
 
+// HandleQueryCStatus is HandleCStatus for a search or retrieve passed the
+// cancellation token of ctx, which fails with the error of ctx once stopped
+func HandleQueryCStatus(ctx context.Context, status *C.CStatus, extraInfo string) error {
+	if status.error_code != C.QueryCancelled {
+		return HandleCStatus(status, extraInfo)
+	}
+	C.free(unsafe.Pointer(status.error_msg))
+	if err := ctx.Err(); err != nil {
+		return errors.Wrap(err, extraInfo)
+	}
+	// segcore saw the deadline pass first
+	return errors.Wrap(context.DeadlineExceeded, extraInfo)
+}
+
+// cancellationToken stops the C queries it is passed to once its context is
+// done or past its deadline.
+type cancellationToken struct {
+	ptr    C.CCancellationToken
+	done   chan struct{}
+	exited chan struct{}
+}
+
+func newCancellationToken(ctx context.Context) *cancellationToken {
+	var deadlineMs int64
+	if deadline, ok := ctx.Deadline(); ok {
+		deadlineMs = deadline.UnixMilli()
+	}
+	token := &cancellationToken{
+		ptr:    C.NewCancellationToken(C.int64_t(deadlineMs)),
+		done:   make(chan struct{}),
+		exited: make(chan struct{}),
+	}
+	if ctx.Done() == nil {
+		close(token.exited)
+		return token
+	}
+	go func() {
+		defer close(token.exited)
+		select {
+		case <-ctx.Done():
+			C.CancelQuery(token.ptr)
+		case <-token.done:
+		}
+	}()
+	return token
+}
+
+// release frees the token, the queries passed it must have returned
+func (t *cancellationToken) release() {
+	close(t.done)
+	<-t.exited
+	C.DeleteCancellationToken(t.ptr)
+}
+
 // HandleCProto deal with the result proto returned from CGO
 func HandleCProto(cRes *C.CProto, msg proto.Message) error {
 	// Standalone CProto is protobuf created by C side,
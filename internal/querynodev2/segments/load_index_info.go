@@ -103,6 +103,14 @@ func (li *LoadIndexInfo) appendLoadIndexInfo(bytesIndex [][]byte, indexInfo *que
 		return err
 	}
 
+	// memory indexes are loaded through a mapped file if mmap is enabled
+	if mmapDirPath := paramtable.Get().QueryNodeCfg.MmapDirPath.GetValue(); len(mmapDirPath) > 0 {
+		err = li.appendMMapDirPath(mmapDirPath)
+		if err != nil {
+			return err
+		}
+	}
+
 	// some build params also exist in indexParams, which are useless during loading process
 	indexParams := funcutil.KeyValuePair2Map(indexInfo.IndexParams)
 	indexparams.SetDiskIndexLoadParams(paramtable.Get(), indexParams, indexInfo.GetNumRows())
@@ -121,6 +129,11 @@ func (li *LoadIndexInfo) appendLoadIndexInfo(bytesIndex [][]byte, indexInfo *que
 		}
 	}
 
+	// indexes without bytes are loaded by segcore from their files
+	if bytesIndex == nil {
+		return li.appendIndexFromFiles(indexPaths)
+	}
+
 	err = li.appendIndexData(bytesIndex, indexPaths)
 	return err
 }
@@ -157,6 +170,14 @@ func (li *LoadIndexInfo) appendIndexFile(filePath string) error {
 	return HandleCStatus(&status, "AppendIndexIFile failed")
 }
 
+func (li *LoadIndexInfo) appendMMapDirPath(dirPath string) error {
+	cDirPath := C.CString(dirPath)
+	defer C.free(unsafe.Pointer(cDirPath))
+
+	status := C.AppendMMapDirPath(li.cLoadIndexInfo, cDirPath)
+	return HandleCStatus(&status, "AppendMMapDirPath failed")
+}
+
 // appendFieldInfo appends fieldID & fieldType to index
 func (li *LoadIndexInfo) appendFieldInfo(collectionID int64, partitionID int64, segmentID int64, fieldID int64, fieldType schemapb.DataType) error {
 	cColID := C.int64_t(collectionID)
@@ -168,6 +189,20 @@ func (li *LoadIndexInfo) appendFieldInfo(collectionID int64, partitionID int64,
 	return HandleCStatus(&status, "AppendFieldInfo failed")
 }
 
+// appendIndexFromFiles appends the index downloaded from indexPaths to cLoadIndexInfo,
+// the index binaries stay in C++ memory
+func (li *LoadIndexInfo) appendIndexFromFiles(indexPaths []string) error {
+	for _, indexPath := range indexPaths {
+		err := li.appendIndexFile(indexPath)
+		if err != nil {
+			return err
+		}
+	}
+
+	status := C.AppendIndexFromFiles(li.cLoadIndexInfo)
+	return HandleCStatus(&status, "AppendIndexFromFiles failed")
+}
+
 // appendIndexData appends binarySet index to cLoadIndexInfo
 func (li *LoadIndexInfo) appendIndexData(bytesIndex [][]byte, indexKeys []string) error {
 	for _, indexPath := range indexKeys {
@@ -211,6 +211,12 @@ func NewRetrievePlan(col *Collection, expr []byte, timestamp Timestamp, msgID Un
 	return newPlan, nil
 }
 
+// SetLimit stops the retrieve of each segment once limit rows are found,
+// a limit which isn't positive retrieves all of them
+func (plan *RetrievePlan) SetLimit(limit int64) {
+	C.SetRetrievePlanLimit(plan.cRetrievePlan, C.int64_t(limit))
+}
+
 func (plan *RetrievePlan) Delete() {
 	C.DeleteRetrievePlan(plan.cRetrievePlan)
 }
@@ -382,19 +382,22 @@ func (s *LocalSegment) Search(ctx context.Context, searchReq *SearchRequest) (*S
 
 	var searchResult SearchResult
 	var status C.CStatus
+	token := newCancellationToken(ctx)
+	defer token.release()
 	GetPool().Submit(func() (any, error) {
 		tr := timerecord.NewTimeRecorder("cgoSearch")
-		status = C.Search(s.ptr,
+		status = C.SearchWithCancellation(s.ptr,
 			searchReq.plan.cSearchPlan,
 			searchReq.cPlaceholderGroup,
 			traceCtx,
 			C.uint64_t(searchReq.timestamp),
+			token.ptr,
 			&searchResult.cSearchResult,
 		)
 		metrics.QueryNodeSQSegmentLatencyInCore.WithLabelValues(fmt.Sprint(paramtable.GetNodeID()), metrics.SearchLabel).Observe(float64(tr.ElapseSpan().Milliseconds()))
 		return nil, nil
 	}).Await()
-	if err := HandleCStatus(&status, "Search failed"); err != nil {
+	if err := HandleQueryCStatus(ctx, &status, "Search failed"); err != nil {
 		return nil, err
 	}
 	log.Debug("search segment done")
@@ -429,13 +432,16 @@ func (s *LocalSegment) Retrieve(ctx context.Context, plan *RetrievePlan) (*segco
 
 	var retrieveResult RetrieveResult
 	var status C.CStatus
+	token := newCancellationToken(ctx)
+	defer token.release()
 	GetPool().Submit(func() (any, error) {
 		ts := C.uint64_t(plan.Timestamp)
 		tr := timerecord.NewTimeRecorder("cgoRetrieve")
-		status = C.Retrieve(s.ptr,
+		status = C.RetrieveWithCancellation(s.ptr,
 			plan.cRetrievePlan,
 			traceCtx,
 			ts,
+			token.ptr,
 			&retrieveResult.cRetrieveResult,
 		)
 		metrics.QueryNodeSQSegmentLatencyInCore.WithLabelValues(fmt.Sprint(paramtable.GetNodeID()),
@@ -444,7 +450,7 @@ func (s *LocalSegment) Retrieve(ctx context.Context, plan *RetrievePlan) (*segco
 		return nil, nil
 	}).Await()
 
-	if err := HandleCStatus(&status, "Retrieve failed"); err != nil {
+	if err := HandleQueryCStatus(ctx, &status, "Retrieve failed"); err != nil {
 		return nil, err
 	}
 
@@ -687,6 +687,11 @@ func (loader *segmentLoader) loadFieldIndex(ctx context.Context, segment *LocalS
 		return err
 	}
 
+	// segcore loads the indexes of any type from the remote storage itself,
+	// so the index binaries aren't copied through cgo
+	if paramtable.Get().CommonCfg.StorageType.GetValue() != "local" {
+		return segment.LoadIndex(nil, indexInfo, fieldType)
+	}
 	indexParams := funcutil.KeyValuePair2Map(indexInfo.IndexParams)
 	// load on disk index
 	if indexParams[common.IndexTypeKey] == indexparamcheck.IndexDISKANN {
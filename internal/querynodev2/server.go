@@ -197,6 +197,38 @@ func (node *QueryNode) InitSegcore() {
 	nprobe := C.int64_t(paramtable.Get().QueryNodeCfg.GrowingIndexNProbe.GetAsInt64())
 	C.SegcoreSetNprobe(nprobe)
 
+	C.SegcoreSetGrowingChunkFreezeMs(C.int64_t(paramtable.Get().QueryNodeCfg.GrowingChunkFreezeMs.GetAsInt64()))
+	C.SegcoreSetGrowingChunkIndexMinFilters(C.int64_t(paramtable.Get().QueryNodeCfg.GrowingChunkIndexFilters.GetAsInt64()))
+	C.SegcoreSetGrowingIndexAsyncBuild(C.bool(paramtable.Get().QueryNodeCfg.GrowingIndexAsyncBuild.GetAsBool()))
+	C.SegcoreSetVectorChunkBytes(C.int64_t(paramtable.Get().QueryNodeCfg.VectorChunkBytes.GetAsInt64()))
+	C.SegcoreSetIndexLoadInflight(C.int64_t(paramtable.Get().QueryNodeCfg.IndexLoadInflight.GetAsInt64()))
+	C.SegcoreSetExprParallelism(C.int64_t(paramtable.Get().QueryNodeCfg.ExprParallelism.GetAsInt64()),
+		C.int64_t(paramtable.Get().QueryNodeCfg.ExprMorselRows.GetAsInt64()))
+	C.SegcoreSetGrowingSearchParallelism(C.int64_t(paramtable.Get().QueryNodeCfg.GrowingSearchParallelism.GetAsInt64()))
+
+	mmapDirPath := paramtable.Get().QueryNodeCfg.MmapDirPath.GetValue()
+	columnCacheDiskBudget := paramtable.Get().QueryNodeCfg.ColumnCacheDiskBudget.GetAsInt64()
+	if len(mmapDirPath) > 0 && columnCacheDiskBudget > 0 {
+		cColumnCacheDir := C.CString(path.Join(mmapDirPath, "column_cache"))
+		C.SegcoreSetColumnCache(cColumnCacheDir, C.int64_t(columnCacheDiskBudget*1024*1024))
+		C.free(unsafe.Pointer(cColumnCacheDir))
+	}
+
+	searchResultCacheSize := paramtable.Get().QueryNodeCfg.SearchResultCacheSize.GetAsInt64()
+	C.SegcoreSetSearchResultCacheSize(C.int64_t(searchResultCacheSize * 1024 * 1024))
+	C.SegcoreSetPlanCacheSize(C.int64_t(paramtable.Get().QueryNodeCfg.PlanCacheSize.GetAsInt64()))
+	fieldDataPoolSize := paramtable.Get().QueryNodeCfg.FieldDataPoolSize.GetAsInt64()
+	C.SegcoreSetFieldDataPoolSize(C.int64_t(fieldDataPoolSize * 1024 * 1024))
+	C.SegcoreSetNumaAware(C.bool(paramtable.Get().QueryNodeCfg.NumaAware.GetAsBool()))
+	C.SegcoreSetIndexWarmupQueries(C.int64_t(paramtable.Get().QueryNodeCfg.IndexWarmupQueries.GetAsInt64()))
+	C.SegcoreSetSearchCoalesceWindow(C.int64_t(paramtable.Get().QueryNodeCfg.SearchCoalesceWindowUs.GetAsInt64()),
+		C.int64_t(paramtable.Get().QueryNodeCfg.SearchCoalesceMaxNq.GetAsInt64()))
+	if queryCapturePath := paramtable.Get().QueryNodeCfg.QueryCapturePath.GetValue(); len(queryCapturePath) > 0 {
+		cQueryCapturePath := C.CString(queryCapturePath)
+		C.SegcoreSetQueryCapture(cQueryCapturePath, C.int64_t(paramtable.Get().QueryNodeCfg.QueryCaptureSample.GetAsInt64()))
+		C.free(unsafe.Pointer(cQueryCapturePath))
+	}
+
 	// override segcore SIMD type
 	cSimdType := C.CString(paramtable.Get().CommonCfg.SimdType.GetValue())
 	C.SegcoreSetSimdType(cSimdType)
@@ -214,6 +246,7 @@ func (node *QueryNode) InitSegcore() {
 
 	localDataRootPath := filepath.Join(paramtable.Get().LocalStorageCfg.Path.GetValue(), typeutil.QueryNodeRole)
 	initcore.InitLocalStorageConfig(localDataRootPath)
+	initcore.InitRemoteConnectionConfig(paramtable.Get())
 
 	mmapDirPath := paramtable.Get().QueryNodeCfg.MmapDirPath.GetValue()
 	if len(mmapDirPath) > 0 {
@@ -301,6 +301,42 @@ func (index *CgoIndex) GetIndexFileInfo() ([]*IndexFileInfo, error) {
 	return ret, nil
 }
 
+// UploadToRemote writes the index files straight to the remote storage the
+// index was created with and returns their paths and sizes, the index
+// params must hold the ids of the collection, partition, segment, field and
+// build and the index version.
+func (index *CgoIndex) UploadToRemote() ([]*IndexFileInfo, error) {
+	var cBinarySet C.CBinarySet
+
+	status := C.SerializeIndexToRemote(index.indexPtr, &cBinarySet)
+	defer func() {
+		if cBinarySet != nil {
+			C.DeleteBinarySet(cBinarySet)
+		}
+	}()
+	if err := HandleCStatus(&status, "failed to upload index to remote"); err != nil {
+		return nil, err
+	}
+
+	keys, err := GetBinarySetKeys(cBinarySet)
+	if err != nil {
+		return nil, err
+	}
+	ret := make([]*IndexFileInfo, 0, len(keys))
+	for _, key := range keys {
+		size, err := GetBinarySetSize(cBinarySet, key)
+		if err != nil {
+			return nil, err
+		}
+		ret = append(ret, &IndexFileInfo{
+			FileName: key,
+			FileSize: size,
+		})
+	}
+
+	return ret, nil
+}
+
 func (index *CgoIndex) Load(blobs []*Blob) error {
 	var cBinarySet C.CBinarySet
 	status := C.NewBinarySet(&cBinarySet)
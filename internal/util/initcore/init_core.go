@@ -37,6 +37,11 @@ func InitLocalStorageConfig(path string) {
 	C.free(unsafe.Pointer(CLocalRootPath))
 }
 
+func InitRemoteConnectionConfig(params *paramtable.ComponentParam) {
+	C.InitRemoteConnections(C.int64_t(params.MinioCfg.MaxConnections.GetAsInt64()),
+		C.int64_t(params.MinioCfg.KeepAliveMs.GetAsInt64()))
+}
+
 func InitTraceConfig(params *paramtable.ComponentParam) {
 	config := C.CTraceConfig{
 		exporter:       C.CString(params.TraceCfg.Exporter.GetValue()),
@@ -1422,6 +1422,14 @@ type queryNodeConfig struct {
 	EnableGrowingSegmentIndex ParamItem `refreshable:"false"`
 	GrowingIndexNlist         ParamItem `refreshable:"false"`
 	GrowingIndexNProbe        ParamItem `refreshable:"false"`
+	GrowingChunkFreezeMs      ParamItem `refreshable:"false"`
+	GrowingChunkIndexFilters  ParamItem `refreshable:"false"`
+	VectorChunkBytes          ParamItem `refreshable:"false"`
+	GrowingIndexAsyncBuild    ParamItem `refreshable:"false"`
+	IndexLoadInflight         ParamItem `refreshable:"false"`
+	ExprParallelism           ParamItem `refreshable:"false"`
+	ExprMorselRows            ParamItem `refreshable:"false"`
+	GrowingSearchParallelism  ParamItem `refreshable:"false"`
 
 	// memory limit
 	LoadMemoryUsageFactor               ParamItem `refreshable:"true"`
@@ -1436,6 +1444,19 @@ type queryNodeConfig struct {
 	CacheEnabled     ParamItem `refreshable:"false"`
 	CacheMemoryLimit ParamItem `refreshable:"false"`
 	MmapDirPath      ParamItem `refreshable:"false"`
+	// Disk budget of the mmap files kept across segment loads
+	ColumnCacheDiskBudget ParamItem `refreshable:"false"`
+	// Memory budget of the cached search results of sealed segments
+	SearchResultCacheSize ParamItem `refreshable:"false"`
+	PlanCacheSize         ParamItem `refreshable:"false"`
+	FieldDataPoolSize     ParamItem `refreshable:"false"`
+	NumaAware             ParamItem `refreshable:"false"`
+	IndexWarmupQueries    ParamItem `refreshable:"false"`
+	// Micro batching of concurrent searches with the same plan
+	SearchCoalesceWindowUs ParamItem `refreshable:"false"`
+	SearchCoalesceMaxNq    ParamItem `refreshable:"false"`
+	QueryCapturePath       ParamItem `refreshable:"false"`
+	QueryCaptureSample     ParamItem `refreshable:"false"`
 
 	GroupEnabled         ParamItem `refreshable:"true"`
 	MaxReceiveChanSize   ParamItem `refreshable:"false"`
@@ -1565,6 +1586,70 @@ func (p *queryNodeConfig) init(base *BaseTable) {
 	}
 	p.GrowingIndexNProbe.Init(base.mgr)
 
+	p.GrowingChunkFreezeMs = ParamItem{
+		Key:          "queryNode.segcore.growing.chunkFreezeMs",
+		Version:      "2.3.0",
+		DefaultValue: "-1",
+		Doc:          "Milliseconds a full chunk of a growing segment waits before its scalar fields get a chunk index, which filters use instead of the raw data, negative disables it",
+	}
+	p.GrowingChunkFreezeMs.Init(base.mgr)
+
+	p.GrowingChunkIndexFilters = ParamItem{
+		Key:          "queryNode.segcore.growing.chunkIndexMinFilters",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "Only the scalar fields read by this many filters of a growing segment get chunk indexes when its chunks freeze, 0 indexes all of them",
+	}
+	p.GrowingChunkIndexFilters.Init(base.mgr)
+
+	p.VectorChunkBytes = ParamItem{
+		Key:          "queryNode.segcore.growing.vectorChunkBytes",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "Bytes of a chunk of a vector field of a growing segment, its rows are rounded down to a power of two and capped by chunkRows, 0 keeps chunkRows",
+	}
+	p.VectorChunkBytes.Init(base.mgr)
+
+	p.GrowingIndexAsyncBuild = ParamItem{
+		Key:          "queryNode.segcore.growing.asyncIndexBuild",
+		Version:      "2.3.0",
+		DefaultValue: "true",
+		Doc:          "Add the inserted rows to the growing segment index in the background, searches brute force the rows it has not taken yet; the segment then keeps the raw vectors even if the index holds them too",
+	}
+	p.GrowingIndexAsyncBuild.Init(base.mgr)
+
+	p.IndexLoadInflight = ParamItem{
+		Key:          "queryNode.segcore.indexLoadInflight",
+		Version:      "2.3.0",
+		DefaultValue: "16",
+		Doc:          "Index files an index load downloads and decodes at the same time, while the earlier ones are assembled",
+	}
+	p.IndexLoadInflight.Init(base.mgr)
+
+	p.ExprParallelism = ParamItem{
+		Key:          "queryNode.segcore.exprParallelism",
+		Version:      "2.3.0",
+		DefaultValue: "1",
+		Doc:          "Threads, the calling one included, a filter of a query may use to evaluate a chunk of a segment, 1 to evaluate on the calling thread only",
+	}
+	p.ExprParallelism.Init(base.mgr)
+
+	p.ExprMorselRows = ParamItem{
+		Key:          "queryNode.segcore.exprMorselRows",
+		Version:      "2.3.0",
+		DefaultValue: "65536",
+		Doc:          "Rows of every morsel a chunk is split into when a filter is evaluated by several threads",
+	}
+	p.ExprMorselRows.Init(base.mgr)
+
+	p.GrowingSearchParallelism = ParamItem{
+		Key:          "queryNode.segcore.growingSearchParallelism",
+		Version:      "2.3.0",
+		DefaultValue: "4",
+		Doc:          "Threads, the calling one included, a search may use to brute force the chunks of a growing segment, only taken by searches with enough distances to compute",
+	}
+	p.GrowingSearchParallelism.Init(base.mgr)
+
 	p.LoadMemoryUsageFactor = ParamItem{
 		Key:          "queryNode.loadMemoryUsageFactor",
 		Version:      "2.0.0",
@@ -1612,6 +1697,86 @@ func (p *queryNodeConfig) init(base *BaseTable) {
 	}
 	p.MmapDirPath.Init(base.mgr)
 
+	p.ColumnCacheDiskBudget = ParamItem{
+		Key:          "queryNode.columnCacheDiskBudget",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "The disk budget in MB of the mmap files kept under mmapDirPath across segment loads, 0 disables keeping them",
+	}
+	p.ColumnCacheDiskBudget.Init(base.mgr)
+
+	p.SearchResultCacheSize = ParamItem{
+		Key:          "queryNode.searchResultCacheSize",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "The memory budget in MB of the search results of sealed segments kept for repeated searches, 0 disables the cache",
+	}
+	p.SearchResultCacheSize.Init(base.mgr)
+
+	p.PlanCacheSize = ParamItem{
+		Key:          "queryNode.planCacheSize",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "The number of search plans shared by the searches of the same request on different segments, 0 disables the cache",
+	}
+	p.PlanCacheSize.Init(base.mgr)
+
+	p.FieldDataPoolSize = ParamItem{
+		Key:          "queryNode.fieldDataPoolSize",
+		Version:      "2.3.0",
+		DefaultValue: "512",
+		Doc:          "The memory in MB of the freed buffers of decoded binlogs kept for the next ones a segment load decodes, 0 keeps none",
+	}
+	p.FieldDataPoolSize.Init(base.mgr)
+
+	p.NumaAware = ParamItem{
+		Key:          "queryNode.numaAware",
+		Version:      "2.3.0",
+		DefaultValue: "false",
+		Doc:          "Place the data of every sealed segment on one NUMA node and search it on workers pinned to that node",
+	}
+	p.NumaAware.Init(base.mgr)
+
+	p.IndexWarmupQueries = ParamItem{
+		Key:          "queryNode.indexWarmupQueries",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "The number of queries a loaded vector index is searched with before it serves any, to fault its pages in, 0 disables the warmup",
+	}
+	p.IndexWarmupQueries.Init(base.mgr)
+
+	p.SearchCoalesceWindowUs = ParamItem{
+		Key:          "queryNode.searchCoalesceWindowUs",
+		Version:      "2.3.0",
+		DefaultValue: "0",
+		Doc:          "The microseconds a search waits for concurrent searches of the same segment with the same plan and timestamp to run as one, 0 disables the batching",
+	}
+	p.SearchCoalesceWindowUs.Init(base.mgr)
+
+	p.SearchCoalesceMaxNq = ParamItem{
+		Key:          "queryNode.searchCoalesceMaxNq",
+		Version:      "2.3.0",
+		DefaultValue: "64",
+		Doc:          "The most queries of the searches run as one",
+	}
+	p.SearchCoalesceMaxNq.Init(base.mgr)
+
+	p.QueryCapturePath = ParamItem{
+		Key:          "queryNode.queryCapture.path",
+		Version:      "2.3.0",
+		DefaultValue: "",
+		Doc:          "The file the sampled searches and retrieves of segments are written to, for them to be replayed offline, empty disables the capture",
+	}
+	p.QueryCapturePath.Init(base.mgr)
+
+	p.QueryCaptureSample = ParamItem{
+		Key:          "queryNode.queryCapture.sampleEvery",
+		Version:      "2.3.0",
+		DefaultValue: "1000",
+		Doc:          "One in how many searches and retrieves are captured",
+	}
+	p.QueryCaptureSample.Init(base.mgr)
+
 	p.GroupEnabled = ParamItem{
 		Key:          "queryNode.grouping.enabled",
 		Version:      "2.0.0",
@@ -638,6 +638,8 @@ type MinioConfig struct {
 	UseIAM          ParamItem `refreshable:"false"`
 	CloudProvider   ParamItem `refreshable:"false"`
 	IAMEndpoint     ParamItem `refreshable:"false"`
+	MaxConnections  ParamItem `refreshable:"false"`
+	KeepAliveMs     ParamItem `refreshable:"false"`
 }
 
 func (p *MinioConfig) Init(base *BaseTable) {
@@ -754,4 +756,20 @@ Leave it empty if you want to use AWS default endpoint`,
 		Export: true,
 	}
 	p.IAMEndpoint.Init(base.mgr)
+
+	p.MaxConnections = ParamItem{
+		Key:          "minio.maxConnections",
+		DefaultValue: "100",
+		Version:      "2.3.0",
+		Doc:          "The connection pool size of the clients segcore shares among the chunk managers of a MinIO/S3 endpoint",
+	}
+	p.MaxConnections.Init(base.mgr)
+
+	p.KeepAliveMs = ParamItem{
+		Key:          "minio.keepAliveMs",
+		DefaultValue: "30000",
+		Version:      "2.3.0",
+		Doc:          "The interval of the tcp keep alive probes of the connections of segcore to MinIO/S3, 0 disables them",
+	}
+	p.KeepAliveMs.Init(base.mgr)
 }